@@ -35,6 +35,7 @@ set(KATANA_USE_TUNE "intel;generic;auto" CACHE STRING "Semi-colon separated list
   optimizing for the most common processors and then to optimizing for the processor selected by KATANA_USE_ARCH")
 set(KATANA_USE_SANITIZER "" CACHE STRING "Semi-colon separated list of sanitizers to use (Memory, MemoryWithOrigins, Address, Undefined, Thread)")
 set(KATANA_USE_JEMALLOC OFF CACHE BOOL "Use jemalloc")
+set(KATANA_USE_64BIT_NODE_IDS OFF CACHE BOOL "Use 64-bit node IDs to support graphs with 2^32 or more nodes at the cost of 4 more bytes per edge")
 
 # This option is automatically handled by CMake.
 # It makes add_library build a shared lib unless STATIC is explicitly specified.
@@ -36,14 +36,13 @@
 #include "katana/PerThreadStorage.h"
 #include "katana/PtrLock.h"
 #include "katana/SimpleLock.h"
+#include "katana/Threads.h"
 #include "katana/config.h"
 
 // TODO(ddn): Merge with Mem.h. Users should not include this file directly.
 
 namespace katana {
 
-extern unsigned activeThreads;
-
 //! Forces the given block to be paged into physical memory
 KATANA_EXPORT void pageIn(void* buf, size_t len, size_t stride);
 
@@ -444,6 +443,14 @@ class BumpWithMallocHeap : public SourceHeap {
       *o = sizeof(Block);
   }
 
+  void freeFallback() {
+    while (fallbackHead) {
+      Block* B = fallbackHead;
+      fallbackHead = B->next;
+      free(B);
+    }
+  }
+
 public:
   enum { AllocSize = 0 };
 
@@ -457,11 +464,25 @@ public:
       head = B->next;
       SourceHeap::deallocate(B);
     }
-    while (fallbackHead) {
-      Block* B = fallbackHead;
-      fallbackHead = B->next;
-      free(B);
+    freeFallback();
+  }
+
+  /**
+   * Make all memory available for allocation again. Unlike clear, keeps one
+   * block, so a heap that is reset after every use (e.g., once per loop
+   * iteration) only rewinds its offset and does not go back to the source
+   * heap as long as each use fits in a block.
+   */
+  void reset() {
+    if (head) {
+      while (head->next) {
+        Block* B = head->next;
+        head->next = B->next;
+        SourceHeap::deallocate(B);
+      }
+      offset = sizeof(Block);
     }
+    freeFallback();
   }
 
   inline void* allocate(size_t size) {
@@ -641,7 +662,7 @@ public:
   enum { AllocSize = 0 };
 
   void* allocate(size_t size) {
-    auto ptr = largeMallocInterleaved(size + offset, activeThreads);
+    auto ptr = largeMallocInterleaved(size + offset, getActiveThreads());
     LAptr* header = new ((char*)ptr.get()) LAptr{std::move(ptr)};
     return (char*)(header->get()) + offset;
   }
@@ -58,6 +58,8 @@ public:
  * be in the barrier while the main thread reinitializes this
  * barrier to the new number of active threads. If that may
  * happen, use {@link CreateSimpleBarrier()} instead.
+ *
+ * Loops of a ThreadGroup get a barrier of the group.
  */
 KATANA_EXPORT Barrier& GetBarrier(unsigned active_threads);
 
@@ -69,6 +71,19 @@ KATANA_EXPORT std::unique_ptr<Barrier> CreateMCSBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateTopoBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateCountingBarrier(unsigned);
 KATANA_EXPORT std::unique_ptr<Barrier> CreateDisseminationBarrier(unsigned);
+/// A combining tree over the threads of each socket and then the sockets,
+/// whose waiters spin for a while and then sleep
+KATANA_EXPORT std::unique_ptr<Barrier> CreateTreeBarrier(unsigned);
+
+/**
+ * Create the barrier that GetBarrier() returns, as chosen by the environment
+ * variable KATANA_BARRIER: counting, dissemination, mcs, topo or tree, or
+ * measure to time each of those on all threads and take the fastest. If it
+ * is unset or auto, the choice follows the machine: the counting barrier for
+ * a few threads on a single socket, whose single counter is cheapest there,
+ * and the tree barrier otherwise.
+ */
+KATANA_EXPORT std::unique_ptr<Barrier> CreateBarrier(unsigned active_threads);
 
 /**
  * Creates a new simple barrier. This barrier is not designed to be fast but
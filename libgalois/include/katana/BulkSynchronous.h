@@ -20,10 +20,18 @@
 #ifndef KATANA_LIBGALOIS_KATANA_BULKSYNCHRONOUS_H_
 #define KATANA_LIBGALOIS_KATANA_BULKSYNCHRONOUS_H_
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
 
 #include "katana/Barrier.h"
+#include "katana/CacheLineStorage.h"
 #include "katana/Chunk.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Threads.h"
 #include "katana/WLCompileCheck.h"
 #include "katana/config.h"
 
@@ -67,7 +75,7 @@ public:
   typedef T value_type;
 
   BulkSynchronous()
-      : barrier(GetBarrier(activeThreads)), some(false), isEmpty(false) {}
+      : barrier(GetBarrier(getActiveThreads())), some(false), isEmpty(false) {}
 
   void push(const value_type& val) {
     wls[(tlds.getLocal()->round + 1) & 1].push(val);
@@ -117,6 +125,172 @@ public:
 };
 KATANA_WLCOMPILECHECK(BulkSynchronous)
 
+/**
+ * Bulk-synchronous scheduling of integer items, e.g., node ids, less than a
+ * bound given at construction. Instead of going into a container, pushed
+ * items set their bit in a bitset for the next round, so an item pushed many
+ * times in a round runs once in the next round. Each round, threads claim
+ * chunks of ChunkWords words of the round's bitset in ascending order and pop
+ * set bits straight out of them, clearing them as they go, so items run in
+ * roughly ascending order and no pass is needed to compact or sort the next
+ * frontier.
+ *
+ * Prefer this to BulkSynchronous when items are dense integers and many
+ * pushes are duplicates, as in bulk-synchronous BFS or label propagation.
+ * Each round scans the whole bitset, so for rounds with very few items over
+ * a large bound, BulkSynchronous is cheaper.
+ *
+ * \code
+ * katana::for_each(
+ *     katana::iterate({source}), Fn,
+ *     katana::wl<katana::DedupBulkSynchronous<>>(graph.num_nodes()));
+ * \endcode
+ */
+template <
+    typename T = uint32_t, unsigned ChunkWords = 16, bool Concurrent = true>
+class DedupBulkSynchronous : private boost::noncopyable {
+  static_assert(
+      std::is_integral_v<T>, "DedupBulkSynchronous needs integer items");
+  static_assert(ChunkWords > 0, "chunks need at least one word");
+
+public:
+  template <bool _concurrent>
+  using rethread = DedupBulkSynchronous<T, ChunkWords, _concurrent>;
+
+  template <typename _T>
+  using retype = DedupBulkSynchronous<_T, ChunkWords, Concurrent>;
+
+  template <unsigned _chunk_words>
+  using with_chunk_words = DedupBulkSynchronous<T, _chunk_words, Concurrent>;
+
+private:
+  struct TLD {
+    unsigned round{0};
+    //! next word to read and end of the claimed chunk
+    size_t word{0};
+    size_t chunkEnd{0};
+    //! bits of the last word read that are not popped yet
+    uint64_t bits{0};
+    size_t base{0};
+  };
+
+  constexpr static size_t kBitsPerWord = 64;
+
+  //! one bit per item for each of the current and the next round
+  std::unique_ptr<std::atomic<uint64_t>[]> bitsets[2];
+  size_t numItems;
+  size_t numWords;
+  CacheLineStorage<std::atomic<size_t>> cursors[2];
+  PerThreadStorage<TLD> tlds;
+  Barrier& barrier;
+  CacheLineStorage<std::atomic<bool>> some;
+  std::atomic<bool> isEmpty;
+
+  std::optional<T> popRound(TLD& tld) {
+    // no thread pushes to the bitset of the current round, so its words can
+    // be read and cleared without atomic read-modify-writes
+    std::atomic<uint64_t>* words = bitsets[tld.round].get();
+    while (!tld.bits) {
+      if (tld.word == tld.chunkEnd) {
+        size_t begin = cursors[tld.round].get().fetch_add(
+            ChunkWords, std::memory_order_relaxed);
+        if (begin >= numWords) {
+          return std::nullopt;
+        }
+        tld.word = begin;
+        tld.chunkEnd = std::min<size_t>(begin + ChunkWords, numWords);
+      }
+      auto& word = words[tld.word];
+      tld.bits = word.load(std::memory_order_relaxed);
+      if (tld.bits) {
+        word.store(0, std::memory_order_relaxed);
+      }
+      tld.base = tld.word * kBitsPerWord;
+      ++tld.word;
+    }
+    unsigned offset = __builtin_ctzll(tld.bits);
+    tld.bits &= tld.bits - 1;
+    return static_cast<T>(tld.base + offset);
+  }
+
+public:
+  typedef T value_type;
+
+  explicit DedupBulkSynchronous(size_t _numItems)
+      : numItems(_numItems),
+        numWords((_numItems + kBitsPerWord - 1) / kBitsPerWord),
+        barrier(GetBarrier(getActiveThreads())),
+        some(false),
+        isEmpty(false) {
+    for (auto& bitset : bitsets) {
+      bitset = std::make_unique<std::atomic<uint64_t>[]>(numWords);
+      for (size_t i = 0; i < numWords; ++i) {
+        bitset[i].store(0, std::memory_order_relaxed);
+      }
+    }
+    for (auto& cursor : cursors) {
+      cursor.get() = 0;
+    }
+  }
+
+  void push(const value_type& val) {
+    KATANA_LOG_DEBUG_ASSERT(static_cast<size_t>(val) < numItems);
+    std::atomic<uint64_t>& word =
+        bitsets[(tlds.getLocal()->round + 1) & 1][val / kBitsPerWord];
+    uint64_t mask = uint64_t{1} << (val % kBitsPerWord);
+    // skip the read-modify-write for the common case of a duplicate
+    if (!(word.load(std::memory_order_relaxed) & mask)) {
+      word.fetch_or(mask, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename ItTy>
+  void push(ItTy b, ItTy e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+    tlds.getLocal()->round = 1;
+    some.get() = true;
+  }
+
+  std::optional<value_type> pop() {
+    TLD& tld = *tlds.getLocal();
+    std::optional<value_type> r;
+
+    while (true) {
+      if (isEmpty)
+        return r;  // empty
+
+      r = popRound(tld);
+      if (r)
+        return r;
+
+      unsigned finished = tld.round;
+      barrier.Wait();
+      if (ThreadPool::getTID() == 0) {
+        if (!some.get())
+          isEmpty = true;
+        some.get() = false;
+        // every thread is done claiming chunks of the finished round
+        cursors[finished].get() = 0;
+      }
+      tld = TLD{};
+      tld.round = (finished + 1) & 1;
+      barrier.Wait();
+
+      r = popRound(tld);
+      if (r) {
+        some.get() = true;
+        return r;
+      }
+    }
+  }
+};
+
 }  // end namespace katana
 
 #endif
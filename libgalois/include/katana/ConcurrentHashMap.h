@@ -0,0 +1,269 @@
+#ifndef KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+#define KATANA_LIBGALOIS_KATANA_CONCURRENTHASHMAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A hash map that any number of threads can insert into and look up in at
+/// once.
+///
+/// The map is one open addressing table with linear probing, allocated
+/// interleaved across NUMA nodes. Its capacity is fixed when it is made or
+/// Reset, so the number of keys must be bounded up front; inserting more
+/// keys than it was made for is fatal. Keys are never removed.
+///
+/// Every slot has a control word that is empty, busy or holds a
+/// fingerprint of the hash of its key. An insert claims an empty slot with
+/// a compare-and-swap, constructs the key and value in it and then
+/// publishes the fingerprint, so inserts and finds take no locks for any
+/// key type. A find only compares keys whose fingerprint matches, which
+/// keeps probing cheap for keys like strings. It waits on a busy slot only
+/// while another thread is writing a key there.
+///
+/// Values are not synchronized: threads that update the value of the same
+/// key must do so atomically, e.g., with a std::atomic value.
+template <
+    typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap {
+public:
+  using Entry = std::pair<const Key, Value>;
+
+  ConcurrentHashMap() = default;
+  explicit ConcurrentHashMap(size_t max_size) { Reset(max_size); }
+  ~ConcurrentHashMap() { Clear(); }
+
+  ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+  ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+  /// Remove every key and make room for max_size keys. Must not run
+  /// concurrently with anything else.
+  void Reset(size_t max_size) {
+    Clear();
+    // keep the table at most half full so probes stay short
+    size_t capacity = kMinCapacity;
+    while (capacity < 2 * max_size) {
+      capacity *= 2;
+    }
+    if (controls_.size() != capacity) {
+      controls_.deallocate();
+      entries_.deallocate();
+      controls_.allocateInterleaved(capacity);
+      entries_.allocateInterleaved(capacity);
+    }
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity),
+        [this](size_t i) {
+          controls_[i].store(kEmpty, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    for (unsigned t = 0; t < sizes_.size(); ++t) {
+      *sizes_.getRemote(t) = 0;
+    }
+  }
+
+  /// The number of slots, which is the number of keys it could hold
+  size_t capacity() const { return controls_.size(); }
+
+  /// The number of keys. Exact only when no insert is running.
+  size_t size() const {
+    size_t total = 0;
+    for (unsigned t = 0; t < sizes_.size(); ++t) {
+      total += *sizes_.getRemote(t);
+    }
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /// Insert key with the value made of args unless key is there already.
+  ///
+  /// \returns the value of key and whether it was inserted
+  template <typename... Args>
+  std::pair<Value*, bool> Emplace(const Key& key, Args&&... args) {
+    KATANA_LOG_DEBUG_ASSERT(capacity() > 0);
+    uint64_t hash = HashOf(key);
+    uint32_t fingerprint = FingerprintOf(hash);
+    size_t mask = capacity() - 1;
+    for (size_t probe = 0, i = hash & mask; probe < capacity();
+         ++probe, i = (i + 1) & mask) {
+      uint32_t control = controls_[i].load(std::memory_order_acquire);
+      if (control == kEmpty &&
+          controls_[i].compare_exchange_strong(
+              control, kBusy, std::memory_order_acquire)) {
+        new (&entries_[i]) Entry(
+            std::piecewise_construct, std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        controls_[i].store(fingerprint, std::memory_order_release);
+        *sizes_.getLocal() += 1;
+        return {&EntryAt(i).second, true};
+      }
+      // lost the slot to another insert, so look at what it wrote
+      control = WaitWritten(i, control);
+      if (control == fingerprint && KeyEqual{}(EntryAt(i).first, key)) {
+        return {&EntryAt(i).second, false};
+      }
+    }
+    KATANA_LOG_FATAL(
+        "ConcurrentHashMap with capacity {} is full", capacity());
+  }
+
+  /// Insert key with value unless key is there already.
+  ///
+  /// \returns the value of key and whether it was inserted
+  std::pair<Value*, bool> Insert(const Key& key, const Value& value) {
+    return Emplace(key, value);
+  }
+
+  /// \returns the value of key, or nullptr if key is not in the map
+  Value* Find(const Key& key) {
+    return const_cast<Value*>(std::as_const(*this).Find(key));
+  }
+
+  const Value* Find(const Key& key) const {
+    if (capacity() == 0) {
+      return nullptr;
+    }
+    uint64_t hash = HashOf(key);
+    uint32_t fingerprint = FingerprintOf(hash);
+    size_t mask = capacity() - 1;
+    for (size_t probe = 0, i = hash & mask; probe < capacity();
+         ++probe, i = (i + 1) & mask) {
+      uint32_t control =
+          WaitWritten(i, controls_[i].load(std::memory_order_acquire));
+      if (control == kEmpty) {
+        return nullptr;
+      }
+      if (control == fingerprint && KeyEqual{}(EntryAt(i).first, key)) {
+        return &EntryAt(i).second;
+      }
+    }
+    return nullptr;
+  }
+
+  bool Contains(const Key& key) const { return Find(key) != nullptr; }
+
+  /// Insert the key and value that key_value(element) returns for every
+  /// element of range, in parallel. Of several elements with the same key,
+  /// an arbitrary one wins.
+  ///
+  /// \returns the number of keys inserted
+  template <typename Range, typename KeyValue>
+  uint64_t InsertMany(const Range& range, KeyValue key_value) {
+    katana::GAccumulator<uint64_t> inserted;
+    katana::do_all(
+        katana::iterate(range),
+        [&](const auto& element) {
+          auto [key, value] = key_value(element);
+          if (Emplace(key, std::move(value)).second) {
+            inserted += 1;
+          }
+        },
+        katana::steal(), katana::loopname("ConcurrentHashMap-InsertMany"));
+    return inserted.reduce();
+  }
+
+  /// Call fn(key, value) for every key, in slot order. Must not run
+  /// concurrently with an insert.
+  template <typename F>
+  void ForEach(F fn) const {
+    for (size_t i = 0; i < capacity(); ++i) {
+      if (IsFull(controls_[i].load(std::memory_order_relaxed))) {
+        const Entry& entry = EntryAt(i);
+        fn(entry.first, entry.second);
+      }
+    }
+  }
+
+  /// Call fn(key, value) for every key, in parallel. Must not run
+  /// concurrently with an insert.
+  template <typename F>
+  void ParallelForEach(F fn) {
+    katana::do_all(
+        katana::iterate(size_t{0}, capacity()),
+        [&](size_t i) {
+          if (IsFull(controls_[i].load(std::memory_order_relaxed))) {
+            Entry& entry = EntryAt(i);
+            fn(entry.first, entry.second);
+          }
+        },
+        katana::loopname("ConcurrentHashMap-ForEach"));
+  }
+
+private:
+  using Storage = std::aligned_storage_t<sizeof(Entry), alignof(Entry)>;
+
+  static constexpr uint32_t kEmpty = 0;
+  static constexpr uint32_t kBusy = 1;
+  static constexpr size_t kMinCapacity = 16;
+
+  static bool IsFull(uint32_t control) { return control > kBusy; }
+
+  static uint64_t HashOf(const Key& key) {
+    // std::hash of an integer is often the integer itself; mix it so that
+    // runs of keys do not fill runs of slots
+    return katana::SplitMix64(Hash{}(key))();
+  }
+
+  /// The control word of a key with hash, which is never empty or busy
+  static uint32_t FingerprintOf(uint64_t hash) {
+    return static_cast<uint32_t>(hash >> 32) | 2;
+  }
+
+  /// \returns the control word of slot i once no insert is writing to it
+  uint32_t WaitWritten(size_t i, uint32_t control) const {
+    while (control == kBusy) {
+      katana::asmPause();
+      control = controls_[i].load(std::memory_order_acquire);
+    }
+    return control;
+  }
+
+  Entry& EntryAt(size_t i) {
+    return *std::launder(reinterpret_cast<Entry*>(&entries_[i]));
+  }
+
+  const Entry& EntryAt(size_t i) const {
+    return *std::launder(reinterpret_cast<const Entry*>(&entries_[i]));
+  }
+
+  /// Destroy every key and value
+  void Clear() {
+    if constexpr (!std::is_trivially_destructible_v<Entry>) {
+      katana::do_all(
+          katana::iterate(size_t{0}, capacity()),
+          [this](size_t i) {
+            if (IsFull(controls_[i].load(std::memory_order_relaxed))) {
+              EntryAt(i).~Entry();
+              controls_[i].store(kEmpty, std::memory_order_relaxed);
+            }
+          },
+          katana::no_stats());
+    }
+  }
+
+  katana::NUMAArray<std::atomic<uint32_t>> controls_;
+  katana::NUMAArray<Storage> entries_;
+  katana::PerThreadStorage<size_t> sizes_;
+};
+
+}  // namespace katana
+
+#endif
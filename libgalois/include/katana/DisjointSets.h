@@ -0,0 +1,150 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DISJOINTSETS_H_
+#define KATANA_LIBGALOIS_KATANA_DISJOINTSETS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A concurrent union-find over the integers [0, size).
+///
+/// Unlike UnionFindNode, the sets live in an array of parent indices rather
+/// than in the elements, so any dense id, e.g., a graph node, can be an
+/// element. Unite links the root with the larger index below the one with
+/// the smaller index with a compare-and-swap. Parents therefore only ever
+/// decrease, which rules out cycles and makes Find, Unite and UniteMany safe
+/// to call from any number of threads at once. Find halves the path it
+/// walks as it goes.
+///
+/// The representative of a set is its smallest element.
+class DisjointSets {
+public:
+  using Index = uint32_t;
+
+  DisjointSets() = default;
+  explicit DisjointSets(size_t size) { Reset(size); }
+
+  /// Make every element of [0, size) a set of its own
+  void Reset(size_t size) {
+    if (parents_.size() != size) {
+      parents_.destroy();
+      parents_.deallocate();
+      parents_.allocateBlocked(size);
+    }
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [this](size_t i) {
+          parents_[i].store(static_cast<Index>(i), std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  size_t size() const { return parents_.size(); }
+
+  /// \returns the representative of the set of n
+  Index Find(Index n) {
+    Index parent = parents_[n].load(std::memory_order_relaxed);
+    while (parent != n) {
+      Index grandparent = parents_[parent].load(std::memory_order_relaxed);
+      // Only roots are ever linked, and n is no longer one, so its parent
+      // can only have moved up to another ancestor, and so has grandparent.
+      parents_[n].store(grandparent, std::memory_order_relaxed);
+      n = parent;
+      parent = grandparent;
+    }
+    return n;
+  }
+
+  /// \returns the parent of n, which is its representative after Compress
+  Index Parent(Index n) const {
+    return parents_[n].load(std::memory_order_relaxed);
+  }
+
+  bool IsRepresentative(Index n) const { return Parent(n) == n; }
+
+  /// Merge the sets of a and b. \returns true if they were different sets.
+  bool Unite(Index a, Index b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return false;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      Index expected = a;
+      if (parents_[a].compare_exchange_strong(
+              expected, b, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+  }
+
+  /// Unite the endpoints of every edge of edges in parallel, where
+  /// endpoints(edge) returns the pair of elements the edge joins.
+  ///
+  /// \returns the number of unions that merged two sets
+  template <typename Edges, typename Endpoints>
+  uint64_t UniteMany(const Edges& edges, Endpoints endpoints) {
+    katana::GAccumulator<uint64_t> merged;
+    katana::do_all(
+        katana::iterate(edges),
+        [&](const auto& edge) {
+          std::pair<Index, Index> ends = endpoints(edge);
+          if (Unite(ends.first, ends.second)) {
+            merged += 1;
+          }
+        },
+        katana::steal(), katana::loopname("DisjointSets-UniteMany"));
+    return merged.reduce();
+  }
+
+  /// UniteMany over a range of pairs of elements
+  template <typename Edges>
+  uint64_t UniteMany(const Edges& edges) {
+    return UniteMany(edges, [](const auto& edge) {
+      return std::pair<Index, Index>(edge.first, edge.second);
+    });
+  }
+
+  /// Point every element directly at its representative, in parallel, so
+  /// that Parent returns it. Must not run concurrently with Unite.
+  void Compress() {
+    katana::do_all(
+        katana::iterate(size_t{0}, size()),
+        [this](size_t i) {
+          Index n = static_cast<Index>(i);
+          parents_[n].store(Find(n), std::memory_order_relaxed);
+        },
+        katana::steal(), katana::loopname("DisjointSets-Compress"));
+  }
+
+  /// \returns the number of sets
+  uint64_t NumSets() const {
+    katana::GAccumulator<uint64_t> roots;
+    katana::do_all(
+        katana::iterate(size_t{0}, size()),
+        [&](size_t i) {
+          if (IsRepresentative(static_cast<Index>(i))) {
+            roots += 1;
+          }
+        },
+        katana::no_stats());
+    return roots.reduce();
+  }
+
+private:
+  katana::NUMAArray<std::atomic<Index>> parents_;
+};
+
+}  // namespace katana
+
+#endif
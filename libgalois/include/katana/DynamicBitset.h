@@ -335,6 +335,23 @@ public:
    */
   void bitwise_and(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of another
+   * bitset, i.e., unsets the bits that are set in other
+   *
+   * @param other Bitset whose set bits to unset in this bitset
+   */
+  void bitwise_andnot(const DynamicBitset& other);
+
+  /**
+   * Does an IN-PLACE bitwise and of the first passed in bitset and the
+   * complement of the second and saves to this bitset
+   *
+   * @param other1 Bitset to and with the complement of other 2
+   * @param other2 Bitset whose set bits to leave out of other 1
+   */
+  void bitwise_andnot(const DynamicBitset& other1, const DynamicBitset& other2);
+
   /**
    * Does an IN-PLACE bitwise xor of this bitset and another bitset
    *
@@ -369,7 +386,9 @@ public:
 
   /**
    * Returns a vector containing the set bits in this bitset in order
-   * from left to right.
+   * from left to right. Threads count the set bits of a block of words each
+   * and then write their offsets after the prefix sum of the counts, so the
+   * cost is in the number of words plus the number of set bits.
    * Do NOT call in a parallel region as it uses katana::on_each.
    *
    * @returns vector with offsets into set bits
@@ -397,6 +416,12 @@ public:
     return *this;
   }
 
+  DynamicBitset& operator^=(const DynamicBitset& other) {
+    KATANA_LOG_ASSERT(size() == other.size());
+    bitwise_xor(other);
+    return *this;
+  }
+
   bool operator==(const DynamicBitset& other) const { return Equals(other); }
 
   bool operator!=(const DynamicBitset& other) const { return !Equals(other); }
@@ -405,8 +430,9 @@ public:
     if (size() != other.size()) {
       return false;
     }
-    for (size_t i = 0; i < size(); i++) {
-      if (test(i) != other.test(i)) {
+    // the unused bits of the last words are 0 in both
+    for (size_t i = 0; i < bitvec_.size(); i++) {
+      if (bitvec_[i] != other.bitvec_[i]) {
         return false;
       }
     }
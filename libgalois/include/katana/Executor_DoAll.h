@@ -20,15 +20,20 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 
+#include <algorithm>
+
 #include "katana/Barrier.h"
 #include "katana/CompilerSpecific.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
+#include "katana/LoopTrace.h"
+#include "katana/PerfCounters.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -50,6 +55,11 @@ class DoAllStealingExec {
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
 
+  /// Steals from another socket take at least this many chunks so that the
+  /// cost of moving a range across the interconnect is paid for by the work
+  /// in it. Smaller ranges are left to their owner.
+  constexpr static const Diff_ty kRemoteStealChunks = 8;
+
   struct ThreadContext {
     alignas(KATANA_CACHE_LINE_SIZE) SimpleLock work_mutex;
     unsigned id;
@@ -60,6 +70,8 @@ class DoAllStealingExec {
     size_t num_iter;
 
     // Stats
+    size_t local_steals;
+    size_t remote_steals;
 
     ThreadContext()
         : work_mutex(),
@@ -67,7 +79,9 @@ class DoAllStealingExec {
           shared_beg(),
           shared_end(),
           m_size(0),
-          num_iter(0) {
+          num_iter(0),
+          local_steals(0),
+          remote_steals(0) {
       // TODO: fix this initialization problem,
       // see initThread
     }
@@ -78,7 +92,9 @@ class DoAllStealingExec {
           shared_beg(beg),
           shared_end(end),
           m_size(std::distance(beg, end)),
-          num_iter(0) {}
+          num_iter(0),
+          local_steals(0),
+          remote_steals(0) {}
 
     bool doWork(F func, const unsigned chunk_size) {
       Iter beg(shared_beg);
@@ -182,15 +198,15 @@ class DoAllStealingExec {
   public:
     bool stealWork(
         Iter& steal_beg, Iter& steal_end, Diff_ty& steal_size, StealAmt amount,
-        size_t chunk_size) {
+        Diff_ty min_size) {
       bool succ = false;
 
       if (work_mutex.try_lock()) {
         if (hasWorkWeak()) {
           succ = true;
 
-          if (amount == HALF && m_size > (Diff_ty)chunk_size) {
-            steal_size = m_size / 2;
+          if (amount == HALF && m_size > min_size) {
+            steal_size = std::max(m_size / 2, min_size);
           } else {
             steal_size = m_size;
           }
@@ -234,7 +250,8 @@ class DoAllStealingExec {
 
 private:
   KATANA_ATTRIBUTE_NOINLINE bool transferWork(
-      ThreadContext& rich, ThreadContext& poor, StealAmt amount) {
+      ThreadContext& rich, ThreadContext& poor, StealAmt amount,
+      Diff_ty min_size) {
     KATANA_LOG_DEBUG_ASSERT(rich.id != poor.id);
     KATANA_LOG_DEBUG_ASSERT(rich.id < katana::getActiveThreads());
     KATANA_LOG_DEBUG_ASSERT(poor.id < katana::getActiveThreads());
@@ -246,7 +263,7 @@ private:
     Diff_ty steal_size = 0;
 
     bool succ =
-        rich.stealWork(steal_beg, steal_end, steal_size, amount, chunk_size);
+        rich.stealWork(steal_beg, steal_end, steal_size, amount, min_size);
 
     if (succ) {
       KATANA_LOG_DEBUG_ASSERT(steal_beg != steal_end);
@@ -267,25 +284,25 @@ private:
 
     const unsigned maxT = katana::getActiveThreads();
     const unsigned my_pack = ThreadPool::getSocket();
-    const unsigned per_pack = tp.getMaxThreads() / tp.getMaxSockets();
 
-    const unsigned pack_beg = my_pack * per_pack;
-    const unsigned pack_end = (my_pack + 1) * per_pack;
-
-    for (unsigned i = 1; i < pack_end; ++i) {
+    for (unsigned i = 1; i < maxT; ++i) {
       // go around the socket in circle starting from the next thread
-      unsigned t = (poor.id + i) % per_pack + pack_beg;
-      KATANA_LOG_DEBUG_ASSERT((t >= pack_beg) && (t < pack_end));
+      unsigned t = (poor.id + i) % maxT;
+      if (tp.getSocket(t) != my_pack) {
+        continue;
+      }
 
-      if (t < maxT) {
-        if (workers.getRemote(t)->hasWorkWeak()) {
-          sawWork = true;
+      if (workers.getRemote(t)->hasWorkWeak()) {
+        sawWork = true;
 
-          stoleWork = transferWork(*workers.getRemote(t), poor, HALF);
+        stoleWork =
+            transferWork(*workers.getRemote(t), poor, HALF, chunk_size);
 
-          if (stoleWork) {
-            break;
+        if (stoleWork) {
+          if (NEED_STATS) {
+            ++poor.local_steals;
           }
+          break;
         }
       }
     }
@@ -293,29 +310,31 @@ private:
     return sawWork || stoleWork;
   }
 
-  KATANA_ATTRIBUTE_NOINLINE bool stealOutsideSocket(
-      ThreadContext& poor, const StealAmt& amt) {
+  KATANA_ATTRIBUTE_NOINLINE bool stealOutsideSocket(ThreadContext& poor) {
     bool sawWork = false;
     bool stoleWork = false;
 
     auto& tp = GetThreadPool();
     unsigned myPkg = ThreadPool::getSocket();
-    // unsigned maxT = LL::getMaxThreads ();
     unsigned maxT = katana::getActiveThreads();
+    const Diff_ty remote_chunk_size = kRemoteStealChunks * chunk_size;
 
     for (unsigned i = 0; i < maxT; ++i) {
       ThreadContext& rich = *(workers.getRemote((poor.id + i) % maxT));
 
-      if (tp.getSocket(rich.id) != myPkg) {
-        if (rich.hasWorkWeak()) {
-          sawWork = true;
+      // m_size is read without the lock; a stale value only means a wasted
+      // or skipped attempt
+      if (tp.getSocket(rich.id) != myPkg &&
+          rich.m_size >= remote_chunk_size) {
+        sawWork = true;
 
-          stoleWork = transferWork(rich, poor, amt);
-          // stoleWork = transferWork (rich, poor, HALF);
+        stoleWork = transferWork(rich, poor, HALF, remote_chunk_size);
 
-          if (stoleWork) {
-            break;
+        if (stoleWork) {
+          if (NEED_STATS) {
+            ++poor.remote_steals;
           }
+          break;
         }
       }
     }
@@ -334,8 +353,17 @@ private:
 
     asmPause();
 
+    // Only the socket leader goes to other sockets at first; the rest of the
+    // socket then shares what it brought back by stealing locally.
     if (GetThreadPool().isLeader(poor.id)) {
-      ret = stealOutsideSocket(poor, HALF);
+      ret = stealOutsideSocket(poor);
+
+      if (ret) {
+        return true;
+      }
+      asmPause();
+    } else {
+      ret = stealWithinSocket(poor);
 
       if (ret) {
         return true;
@@ -343,7 +371,7 @@ private:
       asmPause();
     }
 
-    ret = stealOutsideSocket(poor, HALF);
+    ret = stealOutsideSocket(poor);
     if (ret) {
       return true;
     }
@@ -374,7 +402,7 @@ public:
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        term(GetTerminationDetection(getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
@@ -411,6 +439,7 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    LoopTraceThread<NEED_STATS> trace;
     totalTime.start();
 
     while (true) {
@@ -456,7 +485,13 @@ public:
 
     if (NEED_STATS) {
       katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+      katana::ReportStatSum(loopname, "LocalSteals", ctx.local_steals);
+      katana::ReportStatSum(loopname, "RemoteSteals", ctx.remote_steals);
     }
+    trace.Set(LoopTrace::kIterations, ctx.num_iter);
+    trace.Set(LoopTrace::kLocalSteals, ctx.local_steals);
+    trace.Set(LoopTrace::kRemoteSteals, ctx.remote_steals);
+    trace.Finish();
   }
 };
 
@@ -468,10 +503,10 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(getActiveThreads());
 
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
+        getActiveThreads(), [&exec]() { exec.initThread(); },
         [&barrier]() { barrier.Wait(); }, std::ref(exec));
   }
 };
@@ -489,6 +524,7 @@ struct ChooseDoAllImpl<false> {
 
           const char* const loopname = katana::internal::getLoopName(argsTuple);
 
+          LoopTraceThread<NEED_STATS> trace;
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
@@ -518,6 +554,8 @@ struct ChooseDoAllImpl<false> {
           if (NEED_STATS) {
             katana::ReportStatSum(loopname, "Iterations", iter);
           }
+          trace.Set(LoopTrace::kIterations, iter);
+          trace.Finish();
         },
         std::make_tuple());
   }
@@ -541,6 +579,8 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
 
   constexpr bool TIME_IT = has_trait<loopname_tag, ArgsT>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(argsT));
+  PerfCounterScope<TIME_IT> counters(katana::internal::getLoopName(argsT));
+  LoopTraceScope<TIME_IT> trace(katana::internal::getLoopName(argsT), "do_all");
 
   timer.start();
 
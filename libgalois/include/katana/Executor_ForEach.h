@@ -31,6 +31,7 @@
 #include "katana/LoopStatistics.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
+#include "katana/PerfCounters.h"
 #include "katana/Range.h"
 #include "katana/Simple.h"
 #include "katana/TerminationDetection.h"
@@ -331,9 +332,11 @@ protected:
         }
 
         // Update node color and prop token
+        tld.termination_round(didWork);
         term.SignalWorked(didWork);
         asmPause();  // Let token propagate
       } while (term.Working() && (!needsBreak || !broke));
+      tld.terminated();
 
       if (checkEmpty(wl, tld, 0)) {
         execTime.stop();
@@ -358,8 +361,8 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)),
+      : term(GetTerminationDetection(getActiveThreads())),
+        barrier(GetBarrier(getActiveThreads())),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
@@ -401,7 +404,7 @@ public:
 
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && getActiveThreads() > 1;
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -450,12 +453,12 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
+  auto& barrier = GetBarrier(getActiveThreads());
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); },
+      getActiveThreads(), [&W, &range]() { W.initThread(range); },
       [&barrier] { barrier.Wait(); }, std::ref(W));
 }
 
@@ -476,6 +479,9 @@ for_each_gen(const RangeTy& r, FunctionTy&& fn, const TupleTy& tpl) {
 
   constexpr bool TIME_IT = has_trait<loopname_tag, decltype(xtpl)>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(xtpl));
+  PerfCounterScope<TIME_IT> counters(katana::internal::getLoopName(xtpl));
+  LoopTraceScope<TIME_IT> trace(
+      katana::internal::getLoopName(xtpl), "for_each");
 
   timer.start();
 
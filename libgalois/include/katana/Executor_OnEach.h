@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 
+#include "katana/LoopTrace.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/ThreadPool.h"
 #include "katana/ThreadTimer.h"
@@ -46,6 +47,7 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   const char* const loopname = katana::internal::getLoopName(argsTuple);
 
   CondStatTimer<NEEDS_STATS> timer(loopname);
+  LoopTraceScope<NEEDS_STATS> trace(loopname, "on_each");
 
   PerThreadTimer<MORE_STATS> execTime(loopname, "Execute");
 
@@ -54,11 +56,13 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))> fn_ref = fn;
 
   auto runFun = [&] {
+    LoopTraceThread<NEEDS_STATS> thread_trace;
     execTime.start();
 
     fn_ref(ThreadPool::getTID(), numT);
 
     execTime.stop();
+    thread_trace.Finish();
   };
 
   timer.start();
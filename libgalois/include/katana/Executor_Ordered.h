@@ -20,33 +20,264 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Context.h"
+#include "katana/LoopsDecl.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Range.h"
+#include "katana/Statistics.h"
+#include "katana/Traits.h"
+#include "katana/UserContextAccess.h"
 #include "katana/config.h"
 
 namespace katana {
 
-// TODO(ddn): Pull in and integrate in executors from exp
+namespace internal {
+
+/// The context of one item of a window of for_each_ordered. While marking,
+/// every lockable that the neighborhood function acquires goes to the item
+/// with the smallest id that asks for it, and any item that loses a
+/// lockable is no longer ready. As in the deterministic executor, a
+/// lockable is stolen by CAS on its owner, so marking takes no locks that
+/// can block.
+class OrderedContext : public SimpleRuntimeContext {
+  uint64_t id_{};
+  std::atomic<bool> ready_{true};
+
+public:
+  OrderedContext() : SimpleRuntimeContext(true) {}
+
+  void Reset(uint64_t id) {
+    id_ = id;
+    ready_.store(true, std::memory_order_relaxed);
+  }
+
+  bool IsReady() const { return ready_.load(std::memory_order_relaxed); }
+
+  void subAcquire(Lockable* lockable, katana::MethodFlag) override {
+    if (this->tryLock(lockable)) {
+      this->addToNhood(lockable);
+    }
+
+    OrderedContext* other;
+    do {
+      other = static_cast<OrderedContext*>(this->getOwner(lockable));
+      if (other == this) {
+        return;
+      }
+      if (other && other->id_ < id_) {
+        ready_.store(false, std::memory_order_relaxed);
+        return;
+      }
+    } while (!this->stealByCAS(lockable, other));
+
+    if (other) {
+      other->ready_.store(false, std::memory_order_relaxed);
+    }
+  }
+};
+
+/// The items that have yet to run: the initial items sorted by priority,
+/// taken from the front, and a heap of the items pushed or retried since
+template <typename T, typename Before>
+class OrderedPending {
+  std::vector<T> initial_;
+  size_t next_{};
+  std::vector<T> heap_;
+  Before before_;
+
+  bool HeapFirst() const {
+    return next_ == initial_.size() ||
+           (!heap_.empty() && before_(heap_.front(), initial_[next_]));
+  }
+
+public:
+  template <typename Iter>
+  OrderedPending(Iter begin, Iter end, const Before& before)
+      : initial_(begin, end), before_(before) {
+    katana::ParallelSTL::sort(initial_.begin(), initial_.end(), before_);
+  }
+
+  bool empty() const { return next_ == initial_.size() && heap_.empty(); }
+
+  size_t size() const { return initial_.size() - next_ + heap_.size(); }
+
+  void Push(const T& item) {
+    heap_.push_back(item);
+    std::push_heap(heap_.begin(), heap_.end(), Later());
+  }
+
+  /// Move the first n items, in priority order, to window
+  void Take(size_t n, std::vector<T>* window) {
+    window->clear();
+    while (window->size() < n && !empty()) {
+      if (HeapFirst()) {
+        std::pop_heap(heap_.begin(), heap_.end(), Later());
+        window->push_back(heap_.back());
+        heap_.pop_back();
+      } else {
+        window->push_back(initial_[next_++]);
+      }
+    }
+  }
+
+private:
+  // the heap functions keep the largest item on top, so the heap compares
+  // by which item is later
+  struct LaterFn {
+    Before before;
+    bool operator()(const T& a, const T& b) const { return before(b, a); }
+  };
+  LaterFn Later() const { return LaterFn{before_}; }
+};
+
+/**
+ * Runs for_each_ordered in rounds over a window of the earliest pending
+ * items, after the kinetic dependence graph (KDG) executor of Hassaan et
+ * al. Each round, the neighborhood function of every item in the window
+ * marks the lockables it acquires with the rank of the item in the window,
+ * smaller ranks winning. Items that hold all of their neighborhood have no
+ * earlier conflicting item in the window and are safe sources, which run
+ * in parallel; the rest go back to the pending items. The earliest item is
+ * always a safe source, so every round makes progress.
+ *
+ * The window halves while many of its items are not sources and doubles
+ * while few are, as speculative_for does for its rounds, so inputs with
+ * little contention run in few large rounds.
+ */
+template <
+    typename Iter, typename Cmp, typename NhFunc, typename OpFunc,
+    typename StableTest>
+void
+RunOrderedWindows(
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const StableTest& stabilityTest,
+    const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+
+  constexpr size_t kMinWindowSize = 64;
+  constexpr size_t kMaxWindowSize = size_t{1} << 20;
+
+  // cmp is "less than or equal to"
+  auto before = [&cmp](const T& a, const T& b) { return !cmp(b, a); };
+  OrderedPending<T, decltype(before)> pending(beg, end, before);
+
+  size_t window_size =
+      std::clamp(pending.size() / 100, kMinWindowSize, kMaxWindowSize);
+  std::vector<T> window;
+  std::vector<uint8_t> retry;
+  std::unique_ptr<OrderedContext[]> contexts;
+  size_t num_contexts = 0;
+  katana::InsertBag<T> pushed;
+  katana::PerThreadStorage<UserContextAccess<T>> user_contexts;
+  bool broke = false;
+  uint64_t num_rounds = 0;
+  uint64_t num_aborts = 0;
+
+  while (!pending.empty() && !broke) {
+    pending.Take(window_size, &window);
+    if (num_contexts < window.size()) {
+      num_contexts = window_size;
+      contexts = std::make_unique<OrderedContext[]>(num_contexts);
+    }
+    retry.resize(window.size());
+
+    katana::do_all(
+        katana::iterate(size_t{0}, window.size()),
+        [&](size_t i) {
+          contexts[i].Reset(i);
+          setThreadContext(&contexts[i]);
+          nhFunc(window[i]);
+          setThreadContext(nullptr);
+        },
+        katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(size_t{0}, window.size()),
+        [&](size_t i) {
+          retry[i] = !contexts[i].IsReady() ||
+                     (i != 0 && !stabilityTest(window[i]));
+          if (!retry[i]) {
+            UserContextAccess<T>& uctx = *user_contexts.getLocal();
+            uctx.setBreakFlag(&broke);
+            opFunc(window[i], uctx.data());
+            for (const T& item : uctx.getPushBuffer()) {
+              pushed.push(item);
+            }
+            uctx.resetPushBuffer();
+            uctx.resetAlloc();
+          }
+          // all marks are in by now, so release them as items finish
+          contexts[i].commitIteration();
+        },
+        katana::no_stats());
+
+    size_t num_retries = 0;
+    for (size_t i = 0; i < window.size(); ++i) {
+      if (retry[i]) {
+        pending.Push(window[i]);
+        ++num_retries;
+      }
+    }
+    for (const T& item : pushed) {
+      pending.Push(item);
+    }
+    pushed.clear();
+
+    ++num_rounds;
+    num_aborts += num_retries;
+    if (num_retries * 5 > window.size()) {
+      window_size = std::max(window_size / 2, kMinWindowSize);
+    } else if (num_retries * 10 < window.size()) {
+      window_size = std::min(window_size * 2, kMaxWindowSize);
+    }
+  }
+
+  if (loopname) {
+    katana::ReportStatSingle(loopname, "Rounds", num_rounds);
+    katana::ReportStatSingle(loopname, "Aborts", num_aborts);
+  }
+}
+
+}  // namespace internal
 
+/// for_each_ordered for stable source algorithms; see
+/// internal::RunOrderedWindows. Items that opFunc pushes run in later
+/// rounds, so they must not precede conflicting items that run in the same
+/// round as the item that pushed them, which is what stable sources
+/// guarantee. opFunc runs only once its neighborhood is known to be free
+/// and so must not call UserContext::abort.
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const char* loopname) {
-  KATANA_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+  internal::RunOrderedWindows(
+      beg, end, cmp, nhFunc, opFunc, [](const T&) { return true; }, loopname);
 }
 
+/// for_each_ordered for unstable source algorithms: a safe source also runs
+/// only if stabilityTest says it is stable, except for the earliest pending
+/// item, which is always stable
 template <
     typename Iter, typename Cmp, typename NhFunc, typename OpFunc,
     typename StableTest>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const StableTest& stabilityTest,
-    [[maybe_unused]] const char* loopname) {
-  KATANA_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const StableTest& stabilityTest,
+    const char* loopname) {
+  internal::RunOrderedWindows(
+      beg, end, cmp, nhFunc, opFunc, stabilityTest, loopname);
 }
 
 }  // end namespace katana
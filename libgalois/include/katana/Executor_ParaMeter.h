@@ -25,7 +25,12 @@
 #include <cstdlib>
 #include <ctime>
 #include <deque>
+#include <iterator>
+#include <mutex>
 #include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "katana/Context.h"
@@ -33,6 +38,7 @@
 #include "katana/Executor_ForEach.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Mem.h"
+#include "katana/OperatorReferenceTypes.h"
 #include "katana/Reduction.h"
 #include "katana/Simple.h"
 #include "katana/Traits.h"
@@ -103,12 +109,84 @@ struct UnorderedStepStats : public StepStatsBase {
   }
 };
 
+enum class SchedType { FIFO, RAND, LIFO };
+
 // Single ParaMeter stats file per run of an app
 // which includes all instances of for_each loops
 // run with ParaMeter Executor
 KATANA_EXPORT FILE* getStatsFile();
 KATANA_EXPORT void closeStatsFile();
 
+/// A JSON report of the available parallelism of loops run under ParaMeter,
+/// enabled by setting the environment variable KATANA_PARAMETER_REPORT to
+/// the file to write. While it is set, every named for_each runs under
+/// ParaMeter, whatever its worklist, and its rounds go to the report
+/// instead of the stats file.
+///
+/// ParaMeter runs a loop in rounds, each of which runs the items the
+/// previous round pushed, so the number of rounds is the critical path of
+/// the loop and the items committed in a round is its available
+/// parallelism. The report has a table per loop name, summed over all runs
+/// of the loop, and is rewritten after every run, so a crashed run still
+/// leaves a complete report.
+class KATANA_EXPORT Report {
+public:
+  struct Round {
+    /// Items committed
+    uint64_t parallelism;
+    uint64_t worklist_size;
+    /// Locks acquired by committed items
+    uint64_t neighborhood_size;
+  };
+
+  /// \returns the report if KATANA_PARAMETER_REPORT is set, nullptr
+  /// otherwise
+  static Report* Get();
+
+  Report(const Report&) = delete;
+  Report(Report&&) = delete;
+  Report& operator=(const Report&) = delete;
+  Report& operator=(Report&&) = delete;
+
+  /// Add a run of the loop named loopname and rewrite the report
+  void AddRun(const char* loopname, const std::vector<Round>& rounds);
+
+private:
+  struct LoopProfile {
+    std::string name;
+    uint64_t runs{0};
+    /// Items committed over all runs
+    uint64_t work{0};
+    /// Rounds over all runs
+    uint64_t critical_path{0};
+    uint64_t longest_critical_path{0};
+    uint64_t max_parallelism{0};
+    /// Round i summed over the runs with at least i + 1 rounds
+    std::vector<Round> rounds;
+  };
+
+  explicit Report(std::string path);
+
+  void Write();
+
+  std::mutex mutex_;
+  std::string path_;
+  std::vector<LoopProfile> loops_;
+  std::unordered_map<std::string, size_t> loop_indices_;
+};
+
+/// The schedule of ParaMeter rounds for worklist WL: the one a ParaMeter
+/// worklist asks for, and FIFO for any other worklist
+template <typename WL, typename = void>
+struct ScheduleOf {
+  constexpr static SchedType value = SchedType::FIFO;
+};
+
+template <typename WL>
+struct ScheduleOf<WL, std::void_t<decltype(WL::SCHEDULE)>> {
+  constexpr static SchedType value = WL::SCHEDULE;
+};
+
 template <typename T>
 class FIFO_WL {
   using PTcont = katana::PerThreadStorage<katana::gstl::Vector<T>>;
@@ -178,8 +256,6 @@ public:
   }
 };
 
-enum class SchedType { FIFO, RAND, LIFO };
-
 template <typename T, SchedType SCHED>
 struct ChooseWL {};
 
@@ -202,7 +278,6 @@ template <class T, class FunctionTy, class ArgsTy>
 class ParaMeterExecutor {
   using value_type = T;
   using GenericWL = typename trait_type<wl_tag, ArgsTy>::type::type;
-  using WorkListTy = typename GenericWL::template retype<T>;
   using dbg = katana::debug<1>;
 
   constexpr static bool needsStats = !has_trait<no_stats_tag, ArgsTy>();
@@ -230,13 +305,13 @@ class ParaMeterExecutor {
     }
   };
 
-  using PWL = typename ChooseWL<IterationContext*, WorkListTy::SCHEDULE>::type;
+  using PWL = typename ChooseWL<
+      IterationContext*, ScheduleOf<GenericWL>::value>::type;
 
 private:
   PWL m_wl;
   FunctionTy m_func;
   const char* loopname;
-  FILE* m_statsFile;
   FixedSizeAllocator<IterationContext> m_iterAlloc;
   katana::GReduceLogicalOr m_broken;
 
@@ -372,6 +447,9 @@ private:
         },
         std::make_tuple());
 
+    Report* report = Report::Get();
+    FILE* stats_file = report ? nullptr : getStatsFile();
+    std::vector<Report::Round> rounds;
     UnorderedStepStats stats;
 
     while (!m_wl.empty()) {
@@ -389,7 +467,13 @@ private:
       KATANA_LOG_DEBUG_VASSERT(
           stats.parallelism.reduce(), "ERROR: No Progress");
 
-      stats.dump(m_statsFile, loopname);
+      if (report) {
+        rounds.emplace_back(Report::Round{
+            stats.parallelism.reduce(), stats.wlSize.reduce(),
+            stats.nhSize.reduce()});
+      } else {
+        stats.dump(stats_file, loopname);
+      }
       stats.nextStep();
 
       if (needsBreak && m_broken.reduce()) {
@@ -398,14 +482,16 @@ private:
 
     }  // end while
 
-    closeStatsFile();
+    if (report) {
+      report->AddRun(loopname, rounds);
+    } else {
+      closeStatsFile();
+    }
   }
 
 public:
   ParaMeterExecutor(const FunctionTy& f, const ArgsTy& args)
-      : m_func(f),
-        loopname(katana::internal::getLoopName(args)),
-        m_statsFile(getStatsFile()) {}
+      : m_func(f), loopname(katana::internal::getLoopName(args)) {}
 
   // called serially once
   template <typename RangeTy>
@@ -450,22 +536,28 @@ struct ForEachExecutor<katana::ParaMeter<T>, FunctionTy, ArgsTy>
   ForEachExecutor(const FunctionTy& f, const ArgsTy& args) : SuperTy(f, args) {}
 };
 
-//! invoke ParaMeter tool to execute a for_each style loop
+//! invoke ParaMeter tool to execute a for_each style loop. A worklist in
+//! argsTuple only picks the schedule of the rounds, see
+//! parameter::ScheduleOf.
 template <typename R, typename F, typename ArgsTuple>
 void
-for_each_ParaMeter(const R& range, const F& func, const ArgsTuple& argsTuple) {
-  using T = typename R::values_type;
+for_each_ParaMeter(const R& range, F&& func, const ArgsTuple& argsTuple) {
+  using T = typename std::iterator_traits<typename R::iterator>::value_type;
 
-  auto tpl = katana::get_default_trait_values(
-      argsTuple, std::make_tuple(wl_tag{}),
-      std::make_tuple(wl<katana::ParaMeter<>>()));
+  auto tpl = std::tuple_cat(
+      argsTuple, typename function_traits<F>::type{},
+      katana::get_default_trait_values(
+          argsTuple, std::make_tuple(wl_tag{}),
+          std::make_tuple(wl<katana::ParaMeter<>>())));
 
   using Tpl_ty = decltype(tpl);
+  using FuncRefType = OperatorReferenceType<decltype(std::forward<F>(func))>;
 
-  using Exec = parameter::ParaMeterExecutor<T, F, Tpl_ty>;
-  Exec exec(func, tpl);
+  using Exec = parameter::ParaMeterExecutor<T, FuncRefType, Tpl_ty>;
+  FuncRefType func_ref = func;
+  Exec exec(func_ref, tpl);
 
-  exec.execute(range);
+  exec.init(range);
 }
 
 }  // end namespace katana
@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_HWTOPO_H_
 #define KATANA_LIBGALOIS_KATANA_HWTOPO_H_
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -27,6 +28,24 @@
 
 namespace katana {
 
+/// Capacity of the fastest cores of a machine. Slower cores have
+/// proportionally less, using the scale of Linux's cpu_capacity.
+constexpr unsigned kMaxCPUCapacity = 1024;
+
+/**
+ * The order in which threads are bound to hardware contexts, set with the
+ * environment variable KATANA_THREAD_AFFINITY. Within a socket, faster cores
+ * always come before slower ones.
+ */
+enum class AffinityPolicy {
+  /// Fill one socket's cores before the next; SMT siblings last ("compact")
+  kCompact,
+  /// Spread cores across sockets round robin; SMT siblings last ("scatter")
+  kScatter,
+  /// Fill each core's SMT contexts before the next core ("compact-smt")
+  kCompactSMT,
+};
+
 struct KATANA_EXPORT ThreadTopoInfo {
   unsigned tid;                  // this thread (galois id)
   unsigned socketLeader;         // first thread id in tid's socket
@@ -35,6 +54,7 @@ struct KATANA_EXPORT ThreadTopoInfo {
   unsigned cumulativeMaxSocket;  // max socket id seen from [0, tid]
   unsigned osContext;            // OS ID to use for thread binding
   unsigned osNumaNode;           // OS ID for numa node
+  unsigned capacity{kMaxCPUCapacity};  // relative speed of the core
 };
 
 struct KATANA_EXPORT MachineTopoInfo {
@@ -42,6 +62,7 @@ struct KATANA_EXPORT MachineTopoInfo {
   unsigned maxCores;
   unsigned maxSockets;
   unsigned maxNumaNodes;
+  bool hybrid{false};  // cores differ in capacity
 };
 
 struct KATANA_EXPORT HWTopoInfo {
@@ -61,6 +82,20 @@ KATANA_EXPORT HWTopoInfo getHWTopo();
  */
 KATANA_EXPORT std::vector<int> parseCPUList(const std::string& in);
 
+/**
+ * parseAffinityPolicy parses a value of KATANA_THREAD_AFFINITY, returning
+ * nothing if it names no policy
+ */
+KATANA_EXPORT std::optional<AffinityPolicy> parseAffinityPolicy(
+    const std::string& in);
+
+/**
+ * parseCPUQuota parses a CPU bandwidth limit in the format of cgroup v2
+ * cpu.max, "$QUOTA $PERIOD", returning the number of CPUs it allows, rounded
+ * up, or 0 if there is no limit or it cannot be parsed
+ */
+KATANA_EXPORT unsigned parseCPUQuota(const std::string& in);
+
 /**
  * bindThreadSelf binds a thread to an osContext as returned by getHWTopo.
  */
@@ -20,6 +20,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 #define KATANA_LIBGALOIS_KATANA_LOOPSTATISTICS_H_
 
+#include <chrono>
+#include <cstdint>
+
+#include "katana/LoopTrace.h"
 #include "katana/Statistics.h"
 #include "katana/config.h"
 
@@ -32,17 +36,33 @@ protected:
   size_t m_iterations;
   size_t m_pushes;
   size_t m_conflicts;
+  //! time spent waiting for termination detection
+  std::chrono::steady_clock::duration m_termination{};
+  //! when the current run of rounds without work started, if in one
+  std::chrono::steady_clock::time_point m_idle_since;
+  bool m_idle{false};
   const char* loopname;
+  LoopTraceThread<true> trace;
 
 public:
   explicit LoopStatistics(const char* ln)
       : m_iterations(0), m_pushes(0), m_conflicts(0), loopname(ln) {}
 
   ~LoopStatistics() {
+    uint64_t termination_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(m_termination)
+            .count();
+    trace.Set(LoopTrace::kIterations, m_iterations);
+    trace.Set(LoopTrace::kPushes, m_pushes);
+    trace.Set(LoopTrace::kConflicts, m_conflicts);
+    trace.Set(LoopTrace::kTerminationUs, termination_us);
+    trace.Finish();
     ReportStatSum(loopname, "Iterations", m_iterations);
     ReportStatSum(loopname, "Commits", (m_iterations - m_conflicts));
     ReportStatSum(loopname, "Pushes", m_pushes);
     ReportStatSum(loopname, "Conflicts", m_conflicts);
+    ReportStatSum(loopname, "TerminationUs", termination_us);
+    ReportStatMax(loopname, "MaxTerminationUs", termination_us);
   }
 
   size_t iterations() const { return m_iterations; }
@@ -54,6 +74,26 @@ public:
   inline void inc_iterations() { ++m_iterations; }
 
   inline void inc_conflicts() { ++m_conflicts; }
+
+  //! Note a round of termination detection in which the thread did work or
+  //! not. The time from the first of the rounds without work that end in
+  //! termination to the termination is the time the thread waited for it.
+  inline void termination_round(bool did_work) {
+    if (did_work) {
+      m_idle = false;
+    } else if (!m_idle) {
+      m_idle = true;
+      m_idle_since = std::chrono::steady_clock::now();
+    }
+  }
+
+  //! Note that termination detection ended the rounds
+  inline void terminated() {
+    if (m_idle) {
+      m_termination += std::chrono::steady_clock::now() - m_idle_since;
+      m_idle = false;
+    }
+  }
 };
 
 template <>
@@ -68,6 +108,8 @@ public:
   inline void inc_iterations() const {}
   inline void inc_pushes(size_t) const {}
   inline void inc_conflicts() const {}
+  inline void termination_round(bool) const {}
+  inline void terminated() const {}
 };
 
 }  // namespace katana
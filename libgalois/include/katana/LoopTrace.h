@@ -0,0 +1,152 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPTRACE_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPTRACE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Writes the begin and end of every named parallel loop, and of each
+/// thread's part in it, to a Chrome trace-event file that chrome://tracing
+/// or Perfetto can open. Tracing is off unless the environment variable
+/// KATANA_LOOP_TRACE names the file to write.
+///
+/// Each loop becomes a complete ("X") event on the row of the thread that
+/// started it, and each thread's share becomes an event on that thread's
+/// row, with its iteration, push, conflict and steal counts and the time
+/// it waited for termination as arguments, so load imbalance shows up as
+/// ragged ends and serial gaps as empty space between loops. Events are
+/// appended as loops finish; the array is left unterminated, which both
+/// viewers accept, so a crashed run still leaves a readable trace.
+class KATANA_EXPORT LoopTrace {
+public:
+  enum Count {
+    kIterations,
+    kPushes,
+    kConflicts,
+    kLocalSteals,
+    kRemoteSteals,
+    kTerminationUs,
+    kNumCounts,
+  };
+
+  /// \returns the trace if KATANA_LOOP_TRACE is set, nullptr otherwise
+  static LoopTrace* Get();
+
+  LoopTrace(const LoopTrace&) = delete;
+  LoopTrace(LoopTrace&&) = delete;
+  LoopTrace& operator=(const LoopTrace&) = delete;
+  LoopTrace& operator=(LoopTrace&&) = delete;
+
+  /// Microseconds since the trace was opened
+  uint64_t NowUs() const;
+
+  /// Start recording a loop; call from outside parallel loops
+  /// \returns the start time to pass to EndLoop
+  uint64_t BeginLoop();
+
+  /// Record the part of the current loop run by the calling thread, which
+  /// started at begin_us. Counts the executor does not keep are omitted.
+  void RecordThread(uint64_t begin_us, const uint64_t* counts, uint32_t mask);
+
+  /// Write the events of a loop named loopname that started at begin_us
+  /// and ran with kind (e.g., "do_all") as its category
+  void EndLoop(const char* loopname, const char* kind, uint64_t begin_us);
+
+private:
+  struct ThreadEvent {
+    uint64_t begin_us;
+    uint64_t end_us;
+    uint64_t counts[kNumCounts];
+    /// Bit i is set if counts[i] was recorded
+    uint32_t mask;
+    bool ran;
+  };
+
+  LoopTrace(std::FILE* out, uint64_t start_us);
+
+  std::mutex mutex_;
+  std::FILE* out_;
+  uint64_t start_us_;
+  int pid_;
+  std::vector<ThreadEvent> threads_;
+  /// Threads whose row has been given a name
+  unsigned named_threads_{0};
+};
+
+/// Trace a loop of the given kind while this object is in scope. Does
+/// nothing unless Enabled and tracing is turned on.
+template <bool Enabled>
+class [[nodiscard]] LoopTraceScope {
+public:
+  LoopTraceScope(const char* loopname, const char* kind)
+      : loopname_(loopname), kind_(kind), trace_(LoopTrace::Get()) {
+    if (trace_) {
+      begin_us_ = trace_->BeginLoop();
+    }
+  }
+
+  LoopTraceScope(const LoopTraceScope&) = delete;
+  LoopTraceScope(LoopTraceScope&&) = delete;
+  LoopTraceScope& operator=(const LoopTraceScope&) = delete;
+  LoopTraceScope& operator=(LoopTraceScope&&) = delete;
+
+  ~LoopTraceScope() {
+    if (trace_) {
+      trace_->EndLoop(loopname_, kind_, begin_us_);
+    }
+  }
+
+private:
+  const char* loopname_;
+  const char* kind_;
+  LoopTrace* trace_;
+  uint64_t begin_us_{0};
+};
+
+template <>
+class [[nodiscard]] LoopTraceScope<false> {
+public:
+  LoopTraceScope(const char*, const char*) {}
+};
+
+/// The part of a traced loop run by one thread; create it when the thread
+/// starts on the loop and call Finish when it is done
+template <bool Enabled>
+class LoopTraceThread {
+public:
+  LoopTraceThread()
+      : trace_(LoopTrace::Get()), begin_us_(trace_ ? trace_->NowUs() : 0) {}
+
+  void Set(LoopTrace::Count count, uint64_t value) {
+    counts_[count] = value;
+    mask_ |= 1U << count;
+  }
+
+  void Finish() {
+    if (trace_) {
+      trace_->RecordThread(begin_us_, counts_, mask_);
+    }
+  }
+
+private:
+  LoopTrace* trace_;
+  uint64_t begin_us_;
+  uint64_t counts_[LoopTrace::kNumCounts]{};
+  uint32_t mask_{0};
+};
+
+template <>
+class LoopTraceThread<false> {
+public:
+  void Set(LoopTrace::Count, uint64_t) {}
+  void Finish() {}
+};
+
+}  // namespace katana
+
+#endif
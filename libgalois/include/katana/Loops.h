@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_LOOPS_H_
 #define KATANA_LIBGALOIS_KATANA_LOOPS_H_
 
+#include <type_traits>
+
 #include "katana/Executor_Deterministic.h"
 #include "katana/Executor_DoAll.h"
 #include "katana/Executor_ForEach.h"
@@ -27,11 +29,41 @@
 #include "katana/Executor_Ordered.h"
 #include "katana/Executor_ParaMeter.h"
 #include "katana/LoopsDecl.h"
+#include "katana/Range.h"
 #include "katana/WorkList.h"
 #include "katana/config.h"
 
 namespace katana {
 
+namespace internal {
+
+template <typename WL>
+struct IsParaMeterProfiledWL : std::true_type {};
+
+template <typename T>
+struct IsParaMeterProfiledWL<Deterministic<T>> : std::false_type {};
+
+template <typename T, parameter::SchedType SCHED>
+struct IsParaMeterProfiledWL<ParaMeter<T, SCHED>> : std::false_type {};
+
+/// Whether for_each runs a loop with arguments ArgsTy under ParaMeter when
+/// the ParaMeter report is on, see parameter::Report: named loops except
+/// those that already use ParaMeter and deterministic ones
+template <typename ArgsTy>
+constexpr bool
+IsParaMeterProfiled() {
+  if constexpr (!has_trait<loopname_tag, ArgsTy>()) {
+    return false;
+  } else if constexpr (!has_trait<wl_tag, ArgsTy>()) {
+    return true;
+  } else {
+    return IsParaMeterProfiledWL<
+        typename trait_type<wl_tag, ArgsTy>::type::type>::value;
+  }
+}
+
+}  // namespace internal
+
 ////////////////////////////////////////////////////////////////////////////////
 // Foreach
 ////////////////////////////////////////////////////////////////////////////////
@@ -42,6 +74,9 @@ namespace katana {
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item.
  *
+ * Named loops run under ParaMeter instead when the ParaMeter report is on,
+ * see parameter::Report.
+ *
  * @param range an iterator range typically returned by @ref katana::iterate
  * @param fn operator
  * @param args optional arguments to loop, e.g., {@see loopname}, {@see wl}
@@ -51,6 +86,12 @@ template <typename Range, typename FunctionTy, typename... Args>
 void
 for_each(const Range& range, FunctionTy&& fn, Args&&... args) {
   auto tpl = std::make_tuple(std::forward<Args>(args)...);
+  if constexpr (internal::IsParaMeterProfiled<decltype(tpl)>()) {
+    if (parameter::Report::Get()) {
+      for_each_ParaMeter(range, std::forward<FunctionTy>(fn), tpl);
+      return;
+    }
+  }
   for_each_gen(range, std::forward<FunctionTy>(fn), tpl);
 }
 
@@ -71,6 +112,31 @@ do_all(const Range& range, FunctionTy&& fn, Args&&... args) {
   do_all_gen(range, std::forward<FunctionTy>(fn), tpl);
 }
 
+/**
+ * Do-all loop over the edges of a CSR graph that balances work by edges
+ * rather than nodes, so that high-degree nodes do not leave one thread with
+ * most of the work. All iterations should be independent.
+ *
+ * Operator should conform to <code>fn(node, edge_begin, edge_end)</code>.
+ * It is called once for each tile a node's edges fall in, possibly from
+ * several threads at once for a high-degree node, and not at all for nodes
+ * without edges.
+ *
+ * @param range tiles of edges typically returned by @ref
+ * katana::edge_balanced_range
+ * @param fn operator
+ * @param args optional arguments to loop, e.g., {@see steal}
+ */
+template <typename Edge, typename Node, typename FunctionTy, typename... Args>
+void
+do_all_edges(
+    const EdgeBalancedRange<Edge, Node>& range, FunctionTy&& fn,
+    Args&&... args) {
+  do_all(
+      range, [&range, &fn](uint64_t tile) { range.ForEachInTile(tile, fn); },
+      std::forward<Args>(args)...);
+}
+
 /**
  * Low-level parallel loop. Operator is applied for each running thread.
  * Operator should confirm to <code>fn(tid, numThreads)</code> where tid is
@@ -32,6 +32,10 @@ public:
   /// Returns the number of bytes freed, which can only be less than goal if the
   /// manager's standby total is less than goal.
   virtual count_t FreeStandbyMemory(count_t goal) = 0;
+
+  /// Called by the MS before it decides how much standby memory to reclaim,
+  /// so that the manager can move memory that became idle to standby.
+  virtual void RefreshStandby() {}
 };
 
 }  // namespace katana
@@ -93,6 +93,24 @@ public:
   bool KillSelfForLackOfMemory(count_t standby) const override;
 };
 
+/// Keep the resident set size below a fixed cap, e.g., to pack several
+/// tenants onto one host.  Standby memory is reclaimed as soon as the RSS
+/// goes over the cap, and pressure is high once it gets within 10% of it.
+/// The cap covers only what can be reclaimed; whether to kill ourselves is
+/// decided from system memory like MemoryPolicyMinimal.
+class KATANA_EXPORT MemoryPolicyRSSCap : public MemoryPolicy {
+public:
+  explicit MemoryPolicyRSSCap(count_t max_rss_bytes);
+  count_t ReclaimForMemoryPressure(count_t standby) const override;
+  bool IsMemoryPressureHigh(count_t standby) const override;
+  bool KillSelfForLackOfMemory(count_t standby) const override;
+
+  count_t max_rss_bytes() const { return max_rss_bytes_; }
+
+private:
+  count_t max_rss_bytes_;
+};
+
 /// Do nothing to ever shed memory.  This will OOM if we occupy too much memory.
 class KATANA_EXPORT MemoryPolicyNull : public MemoryPolicy {
 public:
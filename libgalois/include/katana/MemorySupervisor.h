@@ -1,6 +1,8 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "katana/Cache.h"
@@ -67,11 +69,35 @@ public:
   /// aggressively to deallocate.
   void SetPolicy(std::unique_ptr<MemoryPolicy> policy);
 
+  /// Register a manager created outside of the MS, e.g., by a library that
+  /// sits on top of libgalois.  The MS takes ownership.  Managers must have
+  /// unique names.
+  void RegisterManager(std::unique_ptr<Manager> manager);
+
+  /// Returns the manager registered under \p name, or nullptr if there is none
+  Manager* GetManager(const std::string& name);
+
   /// Provide access to a property manager, which manages the property cache
   PropertyManager* GetPropertyManager();
   CacheStats GetPropertyCacheStats() const;
   void LogMemoryStats(const std::string& message);
 
+  /// Returns where the memory of this process goes, in bytes:
+  ///   rss: the resident set size
+  ///   large_alloc.<category>: live large allocations, e.g., NUMAArrays, by
+  ///     MemoryCategory
+  ///   page_pool: pages of worklists and other runtime structures
+  ///   pages.<kind>: all pages from allocPages, which back the two above, by
+  ///     kind of page
+  ///   arrow: the default Arrow memory pool, which holds properties
+  ///   standby.<manager>: standby memory of each manager
+  /// The parts overlap and do not add up to rss: memory can be mapped but not
+  /// resident, and some memory is not tracked at all.
+  std::map<std::string, count_t> GetMemoryBreakdown() const;
+
+  /// Logs GetMemoryBreakdown() to the active tracing span
+  void LogMemoryBreakdown(const std::string& message) const;
+
   /// Calls sysconf
   static uint64_t GetTotalSystemMemory();
 
@@ -112,6 +138,9 @@ private:
 
   /// Statistics: bytes reclaimed
   count_t bytes_reclaimed_{};
+
+  /// Whether CheckPressure is asking the managers to refresh their standby
+  bool refreshing_standby_{false};
 };
 
 }  // namespace katana
@@ -0,0 +1,236 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/PaddedLock.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Relaxed priority scheduling with a MultiQueue: QueuesPerThread heaps for
+ * each active thread. Pushes go to a random heap; pops look at the best
+ * items of two random heaps and take the better one. No state is shared
+ * beyond the heaps themselves, so unlike \ref OrderedByIntegerMetric there
+ * is no global bucket map to contend on as the number of threads grows;
+ * the price is that pops are only approximately in priority order.
+ *
+ * Indexer has the same meaning as for OrderedByIntegerMetric, except that
+ * its result must be arithmetic. Every item is kept in a heap, so there is
+ * no per-bucket Container to choose.
+ *
+ * \code
+ * typedef katana::MultiQueue<Indexer> WL;
+ * katana::for_each(katana::iterate(items), Fn, katana::wl<WL>());
+ * \endcode
+ *
+ * @tparam Indexer         Indexer class
+ * @tparam QueuesPerThread Heaps per active thread; more heaps mean less
+ *                         contention and looser ordering
+ * @tparam UseDescending   Pop the largest index first instead
+ */
+template <
+    class Indexer = DummyIndexer<int>, unsigned QueuesPerThread = 2,
+    typename T = int, typename Index = int, bool UseDescending = false,
+    bool Concurrent = true>
+class MultiQueue {
+  static_assert(QueuesPerThread > 0, "need at least one queue per thread");
+
+public:
+  template <typename _T>
+  using retype = MultiQueue<
+      Indexer, QueuesPerThread, _T, typename std::result_of<Indexer(_T)>::type,
+      UseDescending, Concurrent>;
+
+  template <bool _b>
+  using rethread =
+      MultiQueue<Indexer, QueuesPerThread, T, Index, UseDescending, _b>;
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef MultiQueue<
+        _indexer, QueuesPerThread, T, Index, UseDescending, Concurrent>
+        type;
+  };
+
+  template <unsigned _queues_per_thread>
+  struct with_queues_per_thread {
+    typedef MultiQueue<
+        Indexer, _queues_per_thread, T, Index, UseDescending, Concurrent>
+        type;
+  };
+
+  template <bool _use_descending>
+  struct with_descending {
+    typedef MultiQueue<
+        Indexer, QueuesPerThread, T, Index, _use_descending, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  static_assert(
+      std::is_arithmetic_v<Index>, "MultiQueue needs an arithmetic index");
+
+  /// The top index of an empty heap; no index is worse
+  constexpr static Index kEmpty = UseDescending
+                                      ? std::numeric_limits<Index>::lowest()
+                                      : std::numeric_limits<Index>::max();
+
+  /// Pops that find heaps locked or empty this many times in a row check
+  /// every heap before reporting that there is no work
+  constexpr static int kPopAttempts = 8;
+
+  typedef std::pair<Index, T> Entry;
+
+  struct Queue {
+    PaddedLock<Concurrent> lock;
+    std::vector<Entry> heap;
+    /// Index of the top of the heap and number of entries, read without the
+    /// lock to pick a heap
+    std::atomic<Index> top{kEmpty};
+    std::atomic<size_t> size{0};
+  };
+
+  struct ThreadData {
+    uint64_t rng;
+  };
+
+  static bool Better(Index a, Index b) {
+    return UseDescending ? a > b : a < b;
+  }
+
+  /// Orders the heaps so that the best entry is on top
+  static bool HeapOrder(const Entry& a, const Entry& b) {
+    return Better(b.first, a.first);
+  }
+
+  size_t RandomQueue() {
+    // xorshift64
+    uint64_t& x = data_.getLocal()->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x % num_queues_;
+  }
+
+  void PushLocked(Queue& q, const value_type& val) {
+    q.heap.emplace_back(indexer_(val), val);
+    std::push_heap(q.heap.begin(), q.heap.end(), HeapOrder);
+    q.top.store(q.heap.front().first, std::memory_order_relaxed);
+    q.size.store(q.heap.size(), std::memory_order_relaxed);
+  }
+
+  std::optional<value_type> PopLocked(Queue& q) {
+    if (q.heap.empty()) {
+      return std::nullopt;
+    }
+    std::pop_heap(q.heap.begin(), q.heap.end(), HeapOrder);
+    value_type val = std::move(q.heap.back().second);
+    q.heap.pop_back();
+    q.top.store(
+        q.heap.empty() ? kEmpty : q.heap.front().first,
+        std::memory_order_relaxed);
+    q.size.store(q.heap.size(), std::memory_order_relaxed);
+    return val;
+  }
+
+  std::optional<value_type> PopAny() {
+    size_t start = RandomQueue();
+    for (size_t i = 0; i < num_queues_; ++i) {
+      Queue& q = queues_[(start + i) % num_queues_];
+      if (q.size.load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      q.lock.lock();
+      std::optional<value_type> ret = PopLocked(q);
+      q.lock.unlock();
+      if (ret) {
+        return ret;
+      }
+    }
+    return std::nullopt;
+  }
+
+  size_t num_queues_;
+  std::unique_ptr<Queue[]> queues_;
+  PerThreadStorage<ThreadData> data_;
+  Indexer indexer_;
+
+public:
+  MultiQueue(const Indexer& x = Indexer())
+      : num_queues_(size_t{QueuesPerThread} * std::max(getActiveThreads(), 1U)),
+        queues_(std::make_unique<Queue[]>(num_queues_)),
+        indexer_(x) {
+    for (unsigned i = 0; i < data_.size(); ++i) {
+      // any nonzero seed works; keep threads on different sequences
+      data_.getRemote(i)->rng = UINT64_C(0x9E3779B97F4A7C15) * (i + 1);
+    }
+  }
+
+  MultiQueue(const MultiQueue&) = delete;
+  MultiQueue& operator=(const MultiQueue&) = delete;
+
+  void push(const value_type& val) {
+    while (true) {
+      Queue& q = queues_[RandomQueue()];
+      if (q.lock.try_lock()) {
+        PushLocked(q, val);
+        q.lock.unlock();
+        return;
+      }
+    }
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    for (int attempt = 0; attempt < kPopAttempts; ++attempt) {
+      size_t a = RandomQueue();
+      size_t b = RandomQueue();
+      Index a_top = queues_[a].top.load(std::memory_order_relaxed);
+      Index b_top = queues_[b].top.load(std::memory_order_relaxed);
+      Queue& q = queues_[Better(b_top, a_top) ? b : a];
+      if (q.size.load(std::memory_order_relaxed) == 0 || !q.lock.try_lock()) {
+        continue;
+      }
+      std::optional<value_type> ret = PopLocked(q);
+      q.lock.unlock();
+      if (ret) {
+        return ret;
+      }
+    }
+    return PopAny();
+  }
+};
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // end namespace katana
+
+#endif
@@ -25,6 +25,7 @@
 #include "katana/Galois.h"
 #include "katana/NumaMem.h"
 #include "katana/ParallelSTL.h"
+#include "katana/Threads.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -43,6 +44,7 @@ namespace katana {
  *
  * If the allocation can be concurrent, check katana::gstl::Vector.
  * If the allocation must be uninitialized and resized, check katana::PODVector.
+ * If it is also large, check katana::ReservedVector.
  * Read CONTRIBUTING.md for a more detailed comparison between these types.
  */
 template <typename T>
@@ -58,10 +60,10 @@ class NUMAArray {
     size_ = n;
     switch (t) {
     case AllocType::Blocked:
-      real_data_ = largeMallocBlocked(n * sizeof(T), activeThreads);
+      real_data_ = largeMallocBlocked(n * sizeof(T), getActiveThreads());
       break;
     case AllocType::Interleaved:
-      real_data_ = largeMallocInterleaved(n * sizeof(T), activeThreads);
+      real_data_ = largeMallocInterleaved(n * sizeof(T), getActiveThreads());
       break;
     case AllocType::Local:
       real_data_ = largeMallocLocal(n * sizeof(T));
@@ -191,8 +193,8 @@ public:
   void allocateSpecified(size_type num, RangeArray& ranges) {
     KATANA_LOG_DEBUG_ASSERT(!data_);
 
-    real_data_ =
-        largeMallocSpecified(num * sizeof(T), activeThreads, ranges, sizeof(T));
+    real_data_ = largeMallocSpecified(
+        num * sizeof(T), getActiveThreads(), ranges, sizeof(T));
 
     size_ = num;
     data_ = reinterpret_cast<T*>(real_data_.get());
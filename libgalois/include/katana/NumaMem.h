@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_NUMAMEM_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -28,9 +29,43 @@
 
 namespace katana {
 
+/// What large allocations are for, so that their memory can be broken down
+/// by use; see MemorySupervisor::GetMemoryBreakdown
+enum class MemoryCategory : uint8_t {
+  kOther = 0,
+  kTopology,
+  kViewCache,
+  kEntityTypeIDs,
+};
+
+constexpr size_t kNumMemoryCategories = 4;
+
+KATANA_EXPORT const char* MemoryCategoryName(MemoryCategory category);
+
+/// Charges the large allocations this thread makes while the scope is alive,
+/// e.g., those of NUMAArrays, to a category. Scopes nest.
+class KATANA_EXPORT MemoryCategoryScope {
+public:
+  explicit MemoryCategoryScope(MemoryCategory category);
+  ~MemoryCategoryScope();
+
+  MemoryCategoryScope(const MemoryCategoryScope&) = delete;
+  MemoryCategoryScope& operator=(const MemoryCategoryScope&) = delete;
+
+  /// The category of the innermost scope of this thread
+  static MemoryCategory Current();
+
+private:
+  MemoryCategory previous_;
+};
+
+/// Returns the bytes of live large allocations charged to \p category
+KATANA_EXPORT int64_t LargeAllocationBytes(MemoryCategory category);
+
 namespace internal {
 struct KATANA_EXPORT largeFreer {
   size_t bytes;
+  MemoryCategory category;
   void operator()(void* ptr) const;
 };
 }  // namespace internal
@@ -51,6 +86,41 @@ KATANA_EXPORT LAptr largeMallocSpecified(
     size_t bytes, uint32_t numThreads, RangeArrayTy& threadRanges,
     size_t elementSize);
 
+/// Address space for a large allocation that grows in place. All of it is
+/// reserved up front, but pages are backed with memory only as Commit asks
+/// for them, so growing never moves or copies the data. Committed bytes are
+/// charged to the category current at construction; see
+/// MemoryCategoryScope.
+class KATANA_EXPORT LargeReservation {
+public:
+  LargeReservation() = default;
+  /// Reserve max_bytes, rounded up to allocSize, without backing them
+  explicit LargeReservation(size_t max_bytes);
+  ~LargeReservation();
+
+  LargeReservation(LargeReservation&& o) noexcept;
+  LargeReservation& operator=(LargeReservation&& o) noexcept;
+  LargeReservation(const LargeReservation&) = delete;
+  LargeReservation& operator=(const LargeReservation&) = delete;
+
+  void* data() const { return data_; }
+  size_t reserved_bytes() const { return reserved_bytes_; }
+  size_t committed_bytes() const { return committed_bytes_; }
+
+  /// Back the first bytes of the reservation, rounded up to allocSize, with
+  /// memory. Like largeMallocInterleaved, numThreads threads fault in the
+  /// new pages round robin, so numThreads must be 1 in parallel loops.
+  void Commit(size_t bytes, unsigned numThreads);
+
+private:
+  void Release();
+
+  void* data_{};
+  size_t reserved_bytes_{};
+  size_t committed_bytes_{};
+  MemoryCategory category_{MemoryCategory::kOther};
+};
+
 }  // namespace katana
 
 #endif
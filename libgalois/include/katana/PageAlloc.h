@@ -35,6 +35,35 @@ KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
 // free page range
 KATANA_EXPORT void freePages(void* ptr, unsigned num);
 
+// reserve address space for num pages without backing it with memory
+KATANA_EXPORT void* reservePages(size_t num);
+
+// back the first num pages of a reservation with memory; pages already
+// backed keep their contents
+KATANA_EXPORT void commitPages(void* ptr, size_t num);
+
+// release a reservation of num pages, backed or not
+KATANA_EXPORT void releasePages(void* ptr, size_t num);
+
+/// Bytes mapped by allocPages and not yet freed, by how they are backed.
+///
+/// allocPages first asks for pages from the hugetlb pool (1GB pages for
+/// multiples of 1GB, 2MB otherwise). When the pool is empty, it maps
+/// huge-page-aligned memory and marks it with madvise(MADV_HUGEPAGE), so the
+/// kernel can back it with transparent huge pages. Setting
+/// KATANA_DISABLE_HUGE_PAGES skips both and maps small pages.
+///
+/// Reservations only count the pages committed so far. They never use the
+/// hugetlb pool, which would have to back the whole reservation up front.
+struct PageAllocStats {
+  size_t hugetlb_bytes;
+  /// Marked for transparent huge pages; the kernel may still use small ones
+  size_t transparent_bytes;
+  size_t small_bytes;
+};
+
+KATANA_EXPORT PageAllocStats GetPageAllocStats();
+
 }  // namespace katana
 
 #endif
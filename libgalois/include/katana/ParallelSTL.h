@@ -20,7 +20,12 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 #define KATANA_LIBGALOIS_KATANA_PARALLELSTL_H_
 
+#include <algorithm>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "katana/Chunk.h"
 #include "katana/LoopsDecl.h"
@@ -274,6 +279,261 @@ sort(RandomAccessIterator first, RandomAccessIterator last) {
           typename std::iterator_traits<RandomAccessIterator>::value_type>());
 }
 
+/// Storage for n elements of T that parallel algorithms move
+/// elements into and back out of
+template <typename T>
+class sort_buffer {
+  static_assert(
+      std::is_default_constructible_v<T>,
+      "parallel radix and sample sort need default constructible values");
+
+public:
+  // new T[n] leaves trivial types uninitialized, so the pages are first
+  // touched by the threads that scatter into them
+  explicit sort_buffer(size_t n) : data_(new T[n]) {}
+
+  T* data() { return data_.get(); }
+
+private:
+  std::unique_ptr<T[]> data_;
+};
+
+/// One pass of a least significant digit radix sort: stably scatter the
+/// size elements at src into dst by the digit of key_fn at shift. \returns
+/// false without moving anything if all elements have the same digit.
+template <
+    unsigned kRadixBits, typename SrcIterator, typename DstIterator,
+    typename KeyFn>
+bool
+radix_sort_pass(
+    SrcIterator src, DstIterator dst, size_t size, unsigned shift,
+    const KeyFn& key_fn, std::vector<size_t>* counts) {
+  constexpr size_t kBuckets = size_t{1} << kRadixBits;
+  constexpr size_t kMask = kBuckets - 1;
+  const unsigned num_threads = getActiveThreads();
+  counts->assign(num_threads * kBuckets, 0);
+
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    size_t* mine = counts->data() + tid * kBuckets;
+    for (size_t i = begin; i < end; ++i) {
+      mine[(key_fn(src[i]) >> shift) & kMask] += 1;
+    }
+  });
+
+  // bucket major offsets keep the scatter stable
+  size_t offset = 0;
+  for (size_t b = 0; b < kBuckets; ++b) {
+    size_t bucket_begin = offset;
+    for (unsigned t = 0; t < num_threads; ++t) {
+      size_t count = (*counts)[t * kBuckets + b];
+      (*counts)[t * kBuckets + b] = offset;
+      offset += count;
+    }
+    if (offset - bucket_begin == size) {
+      return false;
+    }
+  }
+
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    size_t* mine = counts->data() + tid * kBuckets;
+    for (size_t i = begin; i < end; ++i) {
+      dst[mine[(key_fn(src[i]) >> shift) & kMask]++] = std::move(src[i]);
+    }
+  });
+  return true;
+}
+
+/**
+ * Stably sorts [first, last) by the unsigned integer key_fn(element) with a
+ * parallel least significant digit radix sort: each pass histograms the
+ * digit per thread and scatters the elements into a buffer of the same size
+ * as the range. Digits above the largest key and digits that all keys share
+ * cost no scatter, so e.g. node ids stored in 64 bits take as many passes as
+ * their actual width needs.
+ *
+ * This is linear in the number of elements and usually much faster than
+ * sort for integer keys such as node ids, degrees or entity types. Sorting
+ * iota by a key, for instance, orders nodes by the key and then by id.
+ */
+template <class RandomAccessIterator, class KeyFn>
+void
+radix_sort(
+    RandomAccessIterator first, RandomAccessIterator last, KeyFn key_fn) {
+  using VT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  using Key = std::decay_t<std::invoke_result_t<KeyFn&, const VT&>>;
+  static_assert(
+      std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+      "radix_sort keys must be unsigned integers");
+  constexpr unsigned kRadixBits = 8;
+
+  const size_t size = std::distance(first, last);
+  if (size <= 1024) {
+    std::stable_sort(first, last, [&](const VT& a, const VT& b) {
+      return key_fn(a) < key_fn(b);
+    });
+    return;
+  }
+
+  std::vector<Key> thread_max(getActiveThreads(), Key{0});
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(first, last, tid, total);
+    for (; begin != end; ++begin) {
+      thread_max[tid] = std::max<Key>(thread_max[tid], key_fn(*begin));
+    }
+  });
+  Key max_key = *std::max_element(thread_max.begin(), thread_max.end());
+  unsigned key_bits = 0;
+  while (key_bits < std::numeric_limits<Key>::digits &&
+         (max_key >> key_bits) != 0) {
+    key_bits += kRadixBits;
+  }
+
+  sort_buffer<VT> buffer(size);
+  std::vector<size_t> counts;
+  bool in_buffer = false;
+  for (unsigned shift = 0; shift < key_bits; shift += kRadixBits) {
+    bool moved = in_buffer ? radix_sort_pass<kRadixBits>(
+                                 buffer.data(), first, size, shift, key_fn,
+                                 &counts)
+                           : radix_sort_pass<kRadixBits>(
+                                 first, buffer.data(), size, shift, key_fn,
+                                 &counts);
+    if (moved) {
+      in_buffer = !in_buffer;
+    }
+  }
+
+  if (in_buffer) {
+    VT* data = buffer.data();
+    do_all(
+        iterate(size_t{0}, size),
+        [&](size_t i) { first[i] = std::move(data[i]); }, no_stats());
+  }
+}
+
+/// Stably sorts a range of unsigned integers with radix_sort
+template <class RandomAccessIterator>
+void
+radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  using VT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  katana::ParallelSTL::radix_sort(first, last, [](const VT& v) { return v; });
+}
+
+/**
+ * Sorts [first, last) by comp with a parallel sample sort. Splitters chosen
+ * from a regular sample of the range cut it into about eight buckets per
+ * thread; the threads classify their blocks, scatter the elements bucket by
+ * bucket into a buffer, and then sort the buckets independently and move
+ * them back. Elements equal to a splitter get a bucket of their own that
+ * needs no sorting, so heavily duplicated keys do not unbalance the buckets.
+ *
+ * Unlike sort, which partitions around one pivot at a time, every element
+ * moves twice and the comparisons of the final sorts are between elements
+ * of one bucket, which suits large ranges of key-value pairs with an
+ * expensive comparator. The sort is not stable.
+ */
+template <class RandomAccessIterator, class Compare>
+void
+sample_sort(
+    RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+  using VT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  constexpr size_t kOversampling = 16;
+
+  const size_t size = std::distance(first, last);
+  const unsigned num_threads = getActiveThreads();
+  const size_t num_splitters = size_t{num_threads} * 8 - 1;
+  if (size <= 1024 || num_threads == 1 ||
+      size < num_splitters * kOversampling * 4) {
+    katana::ParallelSTL::sort(first, last, comp);
+    return;
+  }
+
+  // a regular sample is deterministic and good enough for unsorted and
+  // presorted input alike
+  std::vector<VT> sample;
+  const size_t sample_size = (num_splitters + 1) * kOversampling;
+  sample.reserve(sample_size);
+  for (size_t i = 0; i < sample_size; ++i) {
+    sample.emplace_back(first[i * (size / sample_size)]);
+  }
+  std::sort(sample.begin(), sample.end(), comp);
+  std::vector<VT> splitters;
+  splitters.reserve(num_splitters);
+  for (size_t i = 1; i <= num_splitters; ++i) {
+    splitters.emplace_back(sample[i * kOversampling]);
+  }
+
+  // element x goes to bucket 2 * j + 1 if it equals splitters[j] and to
+  // bucket 2 * j if it is between splitters[j - 1] and splitters[j]
+  const size_t num_buckets = 2 * num_splitters + 1;
+  auto classify = [&](const VT& v) -> size_t {
+    size_t j =
+        std::lower_bound(splitters.begin(), splitters.end(), v, comp) -
+        splitters.begin();
+    if (j < num_splitters && !comp(v, splitters[j])) {
+      return 2 * j + 1;
+    }
+    return 2 * j;
+  };
+
+  std::unique_ptr<uint32_t[]> bucket_of(new uint32_t[size]);
+  std::vector<size_t> counts(num_threads * num_buckets, 0);
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    size_t* mine = counts.data() + tid * num_buckets;
+    for (size_t i = begin; i < end; ++i) {
+      uint32_t b = classify(first[i]);
+      bucket_of[i] = b;
+      mine[b] += 1;
+    }
+  });
+
+  std::vector<size_t> bucket_begin(num_buckets + 1);
+  size_t offset = 0;
+  for (size_t b = 0; b < num_buckets; ++b) {
+    bucket_begin[b] = offset;
+    for (unsigned t = 0; t < num_threads; ++t) {
+      size_t count = counts[t * num_buckets + b];
+      counts[t * num_buckets + b] = offset;
+      offset += count;
+    }
+  }
+  bucket_begin[num_buckets] = offset;
+
+  sort_buffer<VT> buffer(size);
+  VT* data = buffer.data();
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, size, tid, total);
+    size_t* mine = counts.data() + tid * num_buckets;
+    for (size_t i = begin; i < end; ++i) {
+      data[mine[bucket_of[i]]++] = std::move(first[i]);
+    }
+  });
+
+  do_all(
+      iterate(size_t{0}, num_buckets),
+      [&](size_t b) {
+        VT* begin = data + bucket_begin[b];
+        VT* end = data + bucket_begin[b + 1];
+        if (b % 2 == 0) {
+          std::sort(begin, end, comp);
+        }
+        std::move(begin, end, first + bucket_begin[b]);
+      },
+      steal(), no_stats());
+}
+
+template <class RandomAccessIterator>
+void
+sample_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  katana::ParallelSTL::sample_sort(
+      first, last,
+      std::less<
+          typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
 template <class InputIterator, class T, typename BinaryOperation>
 T
 accumulate(
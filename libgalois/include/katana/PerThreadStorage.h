@@ -179,26 +179,45 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getGroupBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getGroupBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
+  //! Thread ids, like those of ThreadPool::getTID, are relative to the
+  //! ThreadGroup of the calling thread
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getGroupBase() + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
+    void* ditem = b->getRemote(ThreadPool::getGroupBase() + thread, offset);
+    return reinterpret_cast<T*>(ditem);
+  }
+
+  //! Like getRemote() but thread is a thread of the machine, as returned by
+  //! ThreadPool::getMachineTID, rather than of the ThreadGroup of the caller
+  T* getMachineRemote(unsigned int thread) {
+    void* ditem = b->getRemote(thread, offset);
+    return reinterpret_cast<T*>(ditem);
+  }
+
+  const T* getMachineRemote(unsigned int thread) const {
     void* ditem = b->getRemote(thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
-  unsigned size() const { return GetThreadPool().getMaxThreads(); }
+  //! return the number of threads of the ThreadGroup of the calling thread
+  unsigned size() const { return GetThreadPool().getGroupThreads(); }
+
+  //! return the number of threads of the machine, all of which have an
+  //! element, whichever ThreadGroup they are in
+  unsigned machineSize() const { return GetThreadPool().getMaxThreads(); }
 
   iterator begin() { return iterator(*this, 0); }
 
@@ -214,11 +233,14 @@ class PerSocketStorage {
   unsigned offset;
   PerBackend* b;
 
+  // Every thread of a socket shares the storage of the socket, so the
+  // leaders of the machine rather than of a ThreadGroup own the elements.
   void destruct() {
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
-          ->~T();
+    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
+      if (tp.isMachineLeader(n)) {
+        reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
+      }
     }
     b->deallocOffset(offset, sizeof(T));
   }
@@ -234,9 +256,10 @@ public:
 
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
-          T(std::forward<Args>(args)...);
+    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
+      if (tp.isMachineLeader(n)) {
+        new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+      }
     }
   }
 
@@ -267,36 +290,34 @@ public:
 
   //! Like getLocal() but optimized for when you already know the thread id
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getGroupBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    void* ditem = b->getLocal(offset, ThreadPool::getGroupBase() + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getGroupBase() + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    void* ditem = b->getRemote(ThreadPool::getGroupBase() + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemoteByPkg(unsigned int pkg) {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
-    return reinterpret_cast<T*>(ditem);
+    return getRemote(GetThreadPool().getLeaderForSocket(pkg));
   }
 
   const T* getRemoteByPkg(unsigned int pkg) const {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
-    return reinterpret_cast<T*>(ditem);
+    return getRemote(GetThreadPool().getLeaderForSocket(pkg));
   }
 
-  unsigned size() const { return GetThreadPool().getMaxThreads(); }
+  unsigned size() const { return GetThreadPool().getGroupThreads(); }
 };
 
 }  // end namespace katana
@@ -0,0 +1,113 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+#define KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Hardware event counts for the threads of the thread pool, read with
+/// perf_event_open(2). Counting is off unless the environment variable
+/// KATANA_PERF_COUNTERS is set, so that runs where VTune or PAPI cannot be
+/// attached can still tell memory-bound loops from compute-bound ones.
+///
+/// Each thread counts its own user-space events. Events the kernel or
+/// processor does not offer, or that perf_event_paranoid forbids, are left
+/// out; the rest are scaled for the time they were multiplexed out.
+class KATANA_EXPORT PerfCounters {
+public:
+  enum Event {
+    kCycles,
+    kInstructions,
+    kLLCMisses,
+    /// Reads that missed memory local to the socket
+    kRemoteDRAMAccesses,
+    kNumEvents,
+  };
+
+  using Counts = std::array<uint64_t, kNumEvents>;
+
+  /// \returns the counters if KATANA_PERF_COUNTERS is set, nullptr otherwise
+  static PerfCounters* Get();
+
+  /// Name of the statistic an event is reported as, e.g., "LLCMisses"
+  static const char* StatName(Event event);
+
+  /// Name of the tag an event is logged as, e.g., "llc_misses"
+  static const char* TagName(Event event);
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters(PerfCounters&&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  PerfCounters& operator=(PerfCounters&&) = delete;
+
+  /// Read the counts so far of each active thread, opening counters for
+  /// threads that have none. Call from outside parallel loops.
+  void Read(std::vector<Counts>* counts);
+
+  /// Report what each thread counted between two reads as per-thread sums
+  /// under region and, if there is an active ProgressTracer span, log the
+  /// totals to it
+  void Report(
+      const char* region, const std::vector<Counts>& begin,
+      const std::vector<Counts>& end);
+
+  /// \returns true if thread tid counts event
+  bool IsCounting(unsigned tid, Event event) const;
+
+private:
+  PerfCounters() = default;
+
+  void OpenThreads(unsigned num_threads);
+
+  std::mutex mutex_;
+  /// per thread, -1 for events that could not be opened
+  std::vector<std::array<int, kNumEvents>> fds_;
+  bool warned_{false};
+};
+
+/// Count the hardware events of the active threads while this object is in
+/// scope and report them under region. Does nothing unless Enabled and
+/// counting is turned on.
+template <bool Enabled>
+class [[nodiscard]] PerfCounterScope {
+public:
+  explicit PerfCounterScope(const char* region)
+      : region_(region), counters_(PerfCounters::Get()) {
+    if (counters_) {
+      counters_->Read(&begin_);
+    }
+  }
+
+  PerfCounterScope(const PerfCounterScope&) = delete;
+  PerfCounterScope(PerfCounterScope&&) = delete;
+  PerfCounterScope& operator=(const PerfCounterScope&) = delete;
+  PerfCounterScope& operator=(PerfCounterScope&&) = delete;
+
+  ~PerfCounterScope() {
+    if (counters_) {
+      std::vector<PerfCounters::Counts> end;
+      counters_->Read(&end);
+      counters_->Report(region_, begin_, end);
+    }
+  }
+
+private:
+  const char* region_;
+  PerfCounters* counters_;
+  std::vector<PerfCounters::Counts> begin_;
+};
+
+template <>
+class [[nodiscard]] PerfCounterScope<false> {
+public:
+  explicit PerfCounterScope(const char*) {}
+};
+
+}  // namespace katana
+
+#endif
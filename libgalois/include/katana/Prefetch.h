@@ -0,0 +1,104 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PREFETCH_H_
+#define KATANA_LIBGALOIS_KATANA_PREFETCH_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Hint that the cache line holding addr is about to be read
+inline void
+Prefetch(const void* addr) {
+#ifdef __GNUC__
+  __builtin_prefetch(addr, 0, 3);
+#else
+  (void)addr;
+#endif
+}
+
+/// Hint that the cache line holding addr is about to be written
+inline void
+PrefetchForWrite(const void* addr) {
+#ifdef __GNUC__
+  __builtin_prefetch(addr, 1, 3);
+#else
+  (void)addr;
+#endif
+}
+
+/// How many iterations ahead a PrefetchPipeline prefetches by default. About
+/// the number of misses a core can have in flight, so that a loop of
+/// independent random reads runs at memory bandwidth rather than latency.
+constexpr uint64_t kDefaultPrefetchDistance = 16;
+
+/// Software pipelining of a loop whose iterations make one random read
+/// each, like the read of the data of the destination of every edge in a
+/// pull-style kernel: before the iteration of index i, the pipeline
+/// prefetches the address of index i + distance, so that a thread keeps
+/// distance misses in flight instead of stalling on one at a time.
+///
+/// Indices at or past limit are not prefetched. The limit can lie past the
+/// end of the current loop: edges of consecutive nodes are consecutive, so a
+/// do_all over nodes, whose threads visit runs of consecutive nodes, can
+/// pass the number of edges and prefetch on into the edges of the next
+/// nodes.
+///
+///   auto pipeline = katana::MakePrefetchPipeline(
+///       graph.NumEdges(), [&](Edge e) { return &data[graph.OutEdgeDst(e)]; });
+///   katana::do_all(katana::iterate(graph), [&](Node n) {
+///     for (auto e : graph.OutEdges(n)) {
+///       pipeline.Ahead(e);
+///       sum += data[graph.OutEdgeDst(e)];
+///     }
+///   });
+///
+/// Reading address(i + distance) must be cheap and safe for every index
+/// below limit; the reads of the edge destination array it usually makes are
+/// sequential and so left to the hardware prefetcher.
+template <typename Index, typename AddressFn>
+class PrefetchPipeline {
+public:
+  PrefetchPipeline(
+      Index limit, AddressFn address,
+      Index distance = static_cast<Index>(kDefaultPrefetchDistance))
+      : limit_(limit), distance_(distance), address_(std::move(address)) {}
+
+  /// Prefetch for the iteration distance after index i
+  void Ahead(Index i) const {
+    Index ahead = i + distance_;
+    if (ahead < limit_) {
+      Prefetch(address_(ahead));
+    }
+  }
+
+  /// Call body(i) for every index i of [begin, end), prefetching ahead
+  template <typename Body>
+  void Run(Index begin, Index end, Body&& body) const {
+    for (Index i = begin; i < end; ++i) {
+      Ahead(i);
+      body(i);
+    }
+  }
+
+  Index distance() const { return distance_; }
+
+private:
+  Index limit_;
+  Index distance_;
+  AddressFn address_;
+};
+
+template <typename Index, typename AddressFn>
+PrefetchPipeline<Index, AddressFn>
+MakePrefetchPipeline(
+    Index limit, AddressFn address,
+    Index distance = static_cast<Index>(kDefaultPrefetchDistance)) {
+  return PrefetchPipeline<Index, AddressFn>(
+      limit, std::move(address), distance);
+}
+
+}  // namespace katana
+
+#endif
@@ -21,10 +21,16 @@
 #define KATANA_LIBGALOIS_KATANA_PRIORITYQUEUE_H_
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <set>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "katana/CompilerSpecific.h"
+#include "katana/Logging.h"
 #include "katana/Mem.h"
 #include "katana/PaddedLock.h"
 #include "katana/config.h"
@@ -376,6 +382,181 @@ public:
   void reserve(size_type s) { heap.reserve(s); }
 };
 
+/// A serial min heap in which every node has D children rather than two.
+/// Pops sift down through fewer levels, and the children of a node share
+/// cache lines, which makes it faster than MinHeap for small elements like
+/// the (node, distance) requests of Dijkstra's algorithm. D = 4 is usually
+/// best.
+template <typename T, size_t D = 4, typename Cmp = std::less<T>>
+class DAryMinHeap {
+  static_assert(D >= 2, "a heap needs at least two children per node");
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+
+  explicit DAryMinHeap(const Cmp& cmp = Cmp()) : cmp_(cmp) {}
+
+  bool empty() const { return container_.empty(); }
+
+  size_type size() const { return container_.size(); }
+
+  const T& top() const {
+    KATANA_LOG_DEBUG_ASSERT(!container_.empty());
+    return container_.front();
+  }
+
+  void push(const T& x) {
+    size_t i = container_.size();
+    container_.push_back(x);
+    // move the hole up rather than swapping at every level
+    while (i > 0) {
+      size_t parent = (i - 1) / D;
+      if (!cmp_(x, container_[parent])) {
+        break;
+      }
+      container_[i] = std::move(container_[parent]);
+      i = parent;
+    }
+    container_[i] = x;
+  }
+
+  T pop() {
+    KATANA_LOG_DEBUG_ASSERT(!container_.empty());
+    T min = std::move(container_.front());
+    T last = std::move(container_.back());
+    container_.pop_back();
+    size_t size = container_.size();
+    if (size == 0) {
+      return min;
+    }
+
+    size_t i = 0;
+    while (true) {
+      size_t first = i * D + 1;
+      if (first >= size) {
+        break;
+      }
+      size_t end = std::min(first + D, size);
+      size_t least = first;
+      for (size_t c = first + 1; c < end; ++c) {
+        if (cmp_(container_[c], container_[least])) {
+          least = c;
+        }
+      }
+      if (!cmp_(container_[least], last)) {
+        break;
+      }
+      container_[i] = std::move(container_[least]);
+      i = least;
+    }
+    container_[i] = std::move(last);
+    return min;
+  }
+
+  void clear() { container_.clear(); }
+
+  void reserve(size_type s) { container_.reserve(s); }
+
+private:
+  std::vector<T> container_;
+  Cmp cmp_;
+};
+
+/// A serial monotone priority queue of elements with unsigned integer keys,
+/// as in Ahuja et al., "Faster Algorithms for the Shortest Path Problem,"
+/// 1990.
+///
+/// No element may be pushed with a key less than the key of the last
+/// element popped, which holds for the distances of Dijkstra's algorithm
+/// with non-negative weights. Bucket i > 0 holds the keys that first differ
+/// from the last key popped in bit i - 1, so an element moves to a lower
+/// bucket at most once per bit of its key and push and pop take amortized
+/// constant time instead of the logarithmic time of a comparison heap.
+/// Elements with equal keys are popped in no particular order.
+///
+/// KeyFn maps an element to its key.
+template <typename T, typename KeyFn>
+class RadixHeap {
+  using Key = std::invoke_result_t<KeyFn, const T&>;
+  static_assert(
+      std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+      "RadixHeap keys must be unsigned integers");
+  static constexpr size_t kNumBuckets = std::numeric_limits<Key>::digits + 1;
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+
+  explicit RadixHeap(const KeyFn& key_fn = KeyFn()) : key_fn_(key_fn) {}
+
+  bool empty() const { return size_ == 0; }
+
+  size_type size() const { return size_; }
+
+  /// The key of the last element popped, the least key that may be pushed
+  Key last() const { return last_; }
+
+  void push(const T& x) {
+    Key key = key_fn_(x);
+    KATANA_LOG_DEBUG_VASSERT(
+        key >= last_, "key {} is less than the last key popped {}", key,
+        last_);
+    buckets_[BucketOf(key)].push_back(x);
+    ++size_;
+  }
+
+  T pop() {
+    KATANA_LOG_DEBUG_ASSERT(size_ > 0);
+    if (buckets_[0].empty()) {
+      Refill();
+    }
+    T x = std::move(buckets_[0].back());
+    buckets_[0].pop_back();
+    --size_;
+    return x;
+  }
+
+  void clear() {
+    for (auto& bucket : buckets_) {
+      bucket.clear();
+    }
+    size_ = 0;
+    last_ = 0;
+  }
+
+private:
+  size_t BucketOf(Key key) const {
+    uint64_t diff = static_cast<uint64_t>(key ^ last_);
+    return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+  }
+
+  /// Make the least key in the first non-empty bucket the last key and
+  /// spread that bucket over the lower buckets, which puts its least
+  /// elements in bucket 0
+  void Refill() {
+    size_t i = 1;
+    while (buckets_[i].empty()) {
+      ++i;
+    }
+    std::vector<T>& bucket = buckets_[i];
+    Key least = key_fn_(bucket.front());
+    for (const T& x : bucket) {
+      least = std::min(least, key_fn_(x));
+    }
+    last_ = least;
+    for (T& x : bucket) {
+      buckets_[BucketOf(key_fn_(x))].push_back(std::move(x));
+    }
+    bucket.clear();
+  }
+
+  KeyFn key_fn_;
+  std::array<std::vector<T>, kNumBuckets> buckets_;
+  size_t size_{0};
+  Key last_{0};
+};
+
 }  // namespace katana
 
 #endif
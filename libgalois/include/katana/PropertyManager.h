@@ -3,8 +3,8 @@
 #include <cstdint>
 #include <string>
 
-#include "katana/Cache.h"
 #include "katana/Manager.h"
+#include "katana/ShardedCache.h"
 #include "katana/Time.h"
 
 namespace katana {
@@ -50,7 +50,7 @@ public:
 
 private:
   void MakePropertyCache();
-  std::unique_ptr<PropertyCache> cache_;
+  std::unique_ptr<ShardedPropertyCache> cache_;
   Stats stats;
 };
 
@@ -20,12 +20,15 @@
 #ifndef KATANA_LIBGALOIS_KATANA_RANGE_H_
 #define KATANA_LIBGALOIS_KATANA_RANGE_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <type_traits>
 
 #include <boost/iterator/counting_iterator.hpp>
 
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/TwoLevelIterator.h"
 #include "katana/config.h"
 #include "katana/gstl.h"
@@ -99,6 +102,40 @@ block_range(Integer begin, Integer end, unsigned idx, unsigned num) {
   return std::make_pair(*ret.first, *ret.second);
 }
 
+/**
+ * Like block_range, but divides the range among the first num threads of
+ * the thread pool in proportion to the capacity of the cores they run on, so
+ * that on machines with both fast and slow cores threads finish their blocks
+ * at about the same time.
+ */
+template <typename Iterator>
+std::pair<Iterator, Iterator>
+capacity_block_range(Iterator begin, Iterator end, unsigned idx, unsigned num) {
+  if (num == 0 || idx >= num) {
+    return std::make_pair(end, end);
+  }
+
+  const ThreadPool& tp = GetThreadPool();
+  const uint64_t total = tp.getCapacityBefore(num);
+  const uint64_t dist = std::distance(begin, end);
+  // dist * capacity / total without overflowing the product
+  auto offset = [&](unsigned i) -> uint64_t {
+    uint64_t capacity = tp.getCapacityBefore(i);
+    return dist / total * capacity + dist % total * capacity / total;
+  };
+
+  Iterator block_begin = begin;
+  std::advance(block_begin, offset(idx));
+
+  Iterator block_end = end;
+  if (idx + 1 != num) {
+    block_end = block_begin;
+    std::advance(block_end, offset(idx + 1) - offset(idx));
+  }
+
+  return std::make_pair(block_begin, block_end);
+}
+
 /**
  * A LocalRange is a range specialized to containers that have a concept of
  * local ranges (i.e., local_begin and local_end).
@@ -205,8 +242,12 @@ public:
 
 private:
   std::pair<local_iterator, local_iterator> local_pair() const {
+    if (GetThreadPool().isHybrid()) {
+      return katana::capacity_block_range(
+          begin_, end_, ThreadPool::getTID(), katana::getActiveThreads());
+    }
     return katana::block_range(
-        begin_, end_, ThreadPool::getTID(), katana::activeThreads);
+        begin_, end_, ThreadPool::getTID(), katana::getActiveThreads());
   }
 
   Iterator begin_;
@@ -244,7 +285,7 @@ private:
    */
   std::pair<local_iterator, local_iterator> local_pair() const {
     uint32_t my_thread_id = ThreadPool::getTID();
-    uint32_t total_threads = activeThreads;
+    uint32_t total_threads = getActiveThreads();
 
     iterator local_begin = thread_beginnings_[my_thread_id];
     iterator local_end = thread_beginnings_[my_thread_id + 1];
@@ -329,6 +370,114 @@ MakeSpecificRange(
   return SpecificRange<Iterator>(begin, end, thread_ranges);
 }
 
+/**
+ * An EdgeBalancedRange divides the edges of a CSR graph into tiles of about
+ * the same number of edges, regardless of how they are spread over nodes. A
+ * node with more edges than a tile is split across tiles, and a tile may
+ * cover the edges of many small nodes.
+ *
+ * Iterating over the range yields tile ids; ForEachInTile visits the part
+ * of each node's edges that falls in a tile. Nodes without edges are never
+ * visited. See katana::do_all_edges.
+ *
+ * @tparam Edge type of the entries of the edge prefix sum
+ * @tparam Node type of node ids passed to visitors
+ */
+template <typename Edge, typename Node = uint32_t>
+class EdgeBalancedRange {
+public:
+  /// Tiles are at least this many edges so that finding their nodes is
+  /// cheap compared to visiting their edges
+  constexpr static uint64_t kMinTileSize = 1024;
+  /// With the default tile size, each thread gets about this many tiles
+  constexpr static uint64_t kTilesPerThread = 16;
+
+  typedef boost::counting_iterator<uint64_t> iterator;
+  typedef iterator local_iterator;
+  typedef uint64_t value_type;
+
+  /**
+   * @param adj_indices edge prefix sum: adj_indices[n] is one past the last
+   * edge of node n
+   * @param num_nodes number of entries in adj_indices
+   * @param tile_size edges per tile; 0 picks one from the number of edges
+   * and active threads
+   */
+  EdgeBalancedRange(
+      const Edge* adj_indices, size_t num_nodes, uint64_t tile_size = 0)
+      : adj_indices_(adj_indices),
+        num_nodes_(num_nodes),
+        num_edges_(num_nodes > 0 ? adj_indices[num_nodes - 1] : 0),
+        tile_size_(tile_size) {
+    if (tile_size_ == 0) {
+      uint64_t num_tiles = uint64_t{getActiveThreads()} * kTilesPerThread;
+      tile_size_ =
+          std::max(kMinTileSize, (num_edges_ + num_tiles - 1) / num_tiles);
+    }
+  }
+
+  uint64_t tile_size() const { return tile_size_; }
+  uint64_t num_tiles() const {
+    return (num_edges_ + tile_size_ - 1) / tile_size_;
+  }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(num_tiles()); }
+
+  local_iterator local_begin() const { return local_pair().first; }
+  local_iterator local_end() const { return local_pair().second; }
+
+  /**
+   * Calls fn(node, edge_begin, edge_end) for each node with edges in the
+   * tile, where [edge_begin, edge_end) are the node's edges in the tile.
+   */
+  template <typename FunctionTy>
+  void ForEachInTile(uint64_t tile, FunctionTy&& fn) const {
+    uint64_t tile_begin = tile * tile_size_;
+    uint64_t tile_end = std::min(tile_begin + tile_size_, num_edges_);
+
+    // the first node whose edges end after the tile begins
+    size_t node =
+        std::upper_bound(
+            adj_indices_, adj_indices_ + num_nodes_, Edge(tile_begin)) -
+        adj_indices_;
+    for (; node < num_nodes_; ++node) {
+      uint64_t node_begin = node > 0 ? adj_indices_[node - 1] : 0;
+      uint64_t node_end = adj_indices_[node];
+      uint64_t begin = std::max(node_begin, tile_begin);
+      uint64_t end = std::min(node_end, tile_end);
+      if (begin < end) {
+        fn(Node(node), Edge(begin), Edge(end));
+      }
+      if (node_end >= tile_end) {
+        break;
+      }
+    }
+  }
+
+private:
+  std::pair<local_iterator, local_iterator> local_pair() const {
+    return katana::block_range(
+        begin(), end(), ThreadPool::getTID(), katana::getActiveThreads());
+  }
+
+  const Edge* adj_indices_;
+  size_t num_nodes_;
+  uint64_t num_edges_;
+  uint64_t tile_size_;
+};
+
+/**
+ * Creates an EdgeBalancedRange over an edge prefix sum, e.g.,
+ * edge_balanced_range(topology.AdjData(), topology.NumNodes()).
+ */
+template <typename Node = uint32_t, typename Edge>
+EdgeBalancedRange<Edge, Node>
+edge_balanced_range(
+    const Edge* adj_indices, size_t num_nodes, uint64_t tile_size = 0) {
+  return EdgeBalancedRange<Edge, Node>(adj_indices, num_nodes, tile_size);
+}
+
 template <typename T>
 struct has_local_iterator {
   template <typename U>
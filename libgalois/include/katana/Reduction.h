@@ -20,10 +20,20 @@
 #ifndef KATANA_LIBGALOIS_KATANA_REDUCTION_H_
 #define KATANA_LIBGALOIS_KATANA_REDUCTION_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -60,6 +70,10 @@ namespace katana {
  *   T u = ...
  *   r.update(std::move(u));
  *   T& result = r.reduce();
+ *
+ * The values of all threads of the machine are merged, so a Reducible may be
+ * updated by the loops of one ThreadGroup and reduced outside of it, as long
+ * as no loop updates it while it is reduced.
  */
 template <typename T, typename MergeFunc, typename IDFunc>
 class Reducible : public MergeFunc, public IDFunc {
@@ -77,9 +91,7 @@ public:
 
   Reducible(MergeFunc merge_func, IDFunc id_func)
       : MergeFunc(merge_func), IDFunc(id_func) {
-    for (unsigned i = 0; i < data_.size(); ++i) {
-      *(data_.getRemote(i)) = IDFunc::operator()();
-    }
+    reset();
   }
 
   /**
@@ -100,8 +112,67 @@ public:
    */
   T& reduce() {
     T& lhs = *data_.getLocal();
-    for (unsigned int i = 1; i < data_.size(); ++i) {
-      T& rhs = *data_.getRemote(i);
+    unsigned local = ThreadPool::getMachineTID();
+    for (unsigned int i = 0; i < data_.machineSize(); ++i) {
+      if (i == local) {
+        continue;
+      }
+      T& rhs = *data_.getMachineRemote(i);
+      merge(lhs, std::move(rhs));
+      rhs = IDFunc::operator()();
+    }
+
+    return lhs;
+  }
+
+  /**
+   * Like reduce() but first merges, in parallel, the values of the threads
+   * of each socket into the value of the leader of the socket, so that only
+   * one value per socket is read across sockets. This pays off when T is
+   * large, e.g., a vector with many bins. For a given number of threads,
+   * values are merged in the same order on every call. Only valid outside
+   * the parallel region.
+   */
+  T& reduceBySocket() {
+    auto& tp = GetThreadPool();
+    unsigned num_threads = std::min(getActiveThreads(), data_.size());
+
+    // threads of a socket are merged in order of thread id
+    auto merge_socket = [this, &tp](unsigned leader) {
+      T& lhs = *data_.getRemote(leader);
+      for (unsigned i = leader + 1; i < data_.size(); ++i) {
+        if (tp.getLeader(i) == leader) {
+          T& rhs = *data_.getRemote(i);
+          merge(lhs, std::move(rhs));
+          rhs = IDFunc::operator()();
+        }
+      }
+    };
+    tp.run(num_threads, [&merge_socket]() {
+      if (ThreadPool::isLeader()) {
+        merge_socket(ThreadPool::getTID());
+      }
+    });
+
+    T& lhs = *data_.getRemote(0);
+    for (unsigned s = 1; s < tp.getMaxSockets(); ++s) {
+      unsigned leader = tp.getLeaderForSocket(s);
+      // no thread of the socket took part in the run above
+      if (leader >= num_threads) {
+        merge_socket(leader);
+      }
+      T& rhs = *data_.getRemote(leader);
+      merge(lhs, std::move(rhs));
+      rhs = IDFunc::operator()();
+    }
+
+    // threads outside the ThreadGroup of the caller
+    unsigned base = ThreadPool::getGroupBase();
+    for (unsigned i = 0; i < data_.machineSize(); ++i) {
+      if (i >= base && i < base + data_.size()) {
+        continue;
+      }
+      T& rhs = *data_.getMachineRemote(i);
       merge(lhs, std::move(rhs));
       rhs = IDFunc::operator()();
     }
@@ -110,8 +181,8 @@ public:
   }
 
   void reset() {
-    for (unsigned int i = 0; i < data_.size(); ++i) {
-      *data_.getRemote(i) = IDFunc::operator()();
+    for (unsigned int i = 0; i < data_.machineSize(); ++i) {
+      *data_.getMachineRemote(i) = IDFunc::operator()();
     }
   }
 };
@@ -155,9 +226,12 @@ struct identity_value_zero {
   constexpr T operator()() const { return T{0}; }
 };
 
+// lowest, not min: for floating point types, min is the smallest positive
+// value
+
 template <typename T>
 struct identity_value_min {
-  constexpr T operator()() const { return std::numeric_limits<T>::min(); }
+  constexpr T operator()() const { return std::numeric_limits<T>::lowest(); }
 };
 
 template <typename T>
@@ -226,5 +300,274 @@ public:
       : base_type(std::logical_or<bool>(), identity_value<bool, false>()) {}
 };
 
+//! Histogram with a fixed number of bins whose counts have type T
+template <typename T = uint64_t>
+class GHistogram {
+  struct Merge {
+    std::vector<T>& operator()(std::vector<T>& lhs, std::vector<T>&& rhs) {
+      for (size_t i = 0; i < lhs.size(); ++i) {
+        lhs[i] += rhs[i];
+      }
+      return lhs;
+    }
+  };
+
+  struct Identity {
+    size_t num_bins;
+    std::vector<T> operator()() const { return std::vector<T>(num_bins); }
+  };
+
+  size_t num_bins_;
+  Reducible<std::vector<T>, Merge, Identity> counts_;
+
+public:
+  using value_type = std::vector<T>;
+
+  explicit GHistogram(size_t num_bins)
+      : num_bins_(num_bins), counts_(Merge(), Identity{num_bins}) {}
+
+  //! Count one more value in \p bin
+  void update(size_t bin) { counts_.getLocal()[bin] += 1; }
+
+  //! Add \p weight to the count of \p bin
+  void update(size_t bin, const T& weight) {
+    counts_.getLocal()[bin] += weight;
+  }
+
+  size_t num_bins() const { return num_bins_; }
+
+  //! Returns the counts of all bins. Only valid outside the parallel region.
+  std::vector<T>& reduce() { return counts_.reduceBySocket(); }
+
+  void reset() { counts_.reset(); }
+};
+
+//! Element-wise sum of vectors of a fixed size with elements of type T
+template <typename T>
+class GVectorAccumulator {
+  struct Merge {
+    std::vector<T>& operator()(std::vector<T>& lhs, std::vector<T>&& rhs) {
+      for (size_t i = 0; i < lhs.size(); ++i) {
+        lhs[i] += rhs[i];
+      }
+      return lhs;
+    }
+  };
+
+  struct Identity {
+    size_t size;
+    std::vector<T> operator()() const { return std::vector<T>(size); }
+  };
+
+  size_t size_;
+  Reducible<std::vector<T>, Merge, Identity> sums_;
+
+public:
+  using value_type = std::vector<T>;
+
+  explicit GVectorAccumulator(size_t size)
+      : size_(size), sums_(Merge(), Identity{size}) {}
+
+  //! Add \p v to element \p i
+  void update(size_t i, const T& v) { sums_.getLocal()[i] += v; }
+
+  //! Add every element of \p v, which has size() elements, to the
+  //! corresponding element
+  void update(const std::vector<T>& v) {
+    std::vector<T>& local = sums_.getLocal();
+    for (size_t i = 0; i < size_; ++i) {
+      local[i] += v[i];
+    }
+  }
+
+  size_t size() const { return size_; }
+
+  //! Returns the sums of all elements. Only valid outside the parallel
+  //! region.
+  std::vector<T>& reduce() { return sums_.reduceBySocket(); }
+
+  void reset() { sums_.reset(); }
+};
+
+namespace internal {
+
+/// The exact sum of doubles, as a fixed-point number with enough bits to
+/// hold any double and the carries of 2^64 additions. Because no bit is
+/// rounded away, the sum does not depend on the order of the additions.
+class KATANA_EXPORT ExactSum {
+public:
+  void Add(double v) {
+    if (v == 0) {
+      return;
+    }
+    if (!std::isfinite(v)) {
+      special_ += v;
+      return;
+    }
+
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    unsigned exponent = (bits >> 52) & 0x7ff;
+    uint64_t mantissa = bits & ((uint64_t{1} << 52) - 1);
+    if (exponent == 0) {
+      // subnormal
+      exponent = 1;
+    } else {
+      mantissa |= uint64_t{1} << 52;
+    }
+
+    // v is mantissa * 2^(exponent - 1075) and a limb has weight
+    // 2^(32 * limb - 1074)
+    unsigned pos = exponent - 1;
+    unsigned limb = pos / kLimbBits;
+    unsigned shift = pos % kLimbBits;
+    uint64_t lo = mantissa << shift;
+    uint64_t hi = shift ? mantissa >> (64 - shift) : 0;
+    int64_t digits[3] = {
+        static_cast<int64_t>(lo & kLimbMask),
+        static_cast<int64_t>(lo >> kLimbBits), static_cast<int64_t>(hi)};
+    if (bits >> 63) {
+      for (int i = 0; i < 3; ++i) {
+        limbs_[limb + i] -= digits[i];
+      }
+    } else {
+      for (int i = 0; i < 3; ++i) {
+        limbs_[limb + i] += digits[i];
+      }
+    }
+
+    if (++pending_ >= kMaxPending) {
+      Normalize();
+    }
+  }
+
+  ExactSum& Merge(const ExactSum& other);
+
+  /// Returns the sum rounded to a double. Equal exact sums give equal
+  /// doubles.
+  double Value() const;
+
+private:
+  static constexpr unsigned kLimbBits = 32;
+  static constexpr uint64_t kLimbMask = (uint64_t{1} << kLimbBits) - 1;
+  /// bits 0 to 2097 hold a double and 65 more bits hold the carries of 2^64
+  /// additions; the last limb only holds the sign
+  static constexpr unsigned kNumLimbs = 70;
+  /// limbs change by less than 2^32 per addition, so 2^29 additions, or the
+  /// merge of two sums of that many, do not overflow an int64_t
+  static constexpr uint32_t kMaxPending = uint32_t{1} << 29;
+
+  /// Brings every limb but the last into [0, 2^32)
+  void Normalize();
+
+  int64_t limbs_[kNumLimbs]{};
+  /// additions since the last Normalize
+  uint32_t pending_{0};
+  /// sum of the infinities and NaNs
+  double special_{0};
+};
+
+}  // namespace internal
+
+//! Sum of floating point values of type T that does not depend on the order
+//! of the updates, so the result is the same however iterations are spread
+//! over threads. This costs a few integer additions per update.
+template <typename T>
+class GDeterministicAccumulator {
+  static_assert(std::is_floating_point_v<T>);
+
+  struct Merge {
+    internal::ExactSum& operator()(
+        internal::ExactSum& lhs, internal::ExactSum&& rhs) {
+      return lhs.Merge(rhs);
+    }
+  };
+
+  struct Identity {
+    internal::ExactSum operator()() const { return internal::ExactSum(); }
+  };
+
+  Reducible<internal::ExactSum, Merge, Identity> sums_;
+
+public:
+  using value_type = T;
+
+  GDeterministicAccumulator() : sums_(Merge(), Identity()) {}
+
+  GDeterministicAccumulator& operator+=(const T& rhs) {
+    sums_.getLocal().Add(rhs);
+    return *this;
+  }
+
+  GDeterministicAccumulator& operator-=(const T& rhs) {
+    sums_.getLocal().Add(-rhs);
+    return *this;
+  }
+
+  void update(const T& rhs) { sums_.getLocal().Add(rhs); }
+
+  //! Returns the sum. Only valid outside the parallel region.
+  T reduce() { return static_cast<T>(sums_.reduce().Value()); }
+
+  void reset() { sums_.reset(); }
+};
+
+//! Keeps the k largest values of type T, by operator<
+template <typename T>
+class GReduceTopK {
+  // Each thread keeps a min-heap of at most k values, so a new value only
+  // needs to be compared with the smallest value kept.
+  using Greater = std::greater<T>;
+
+  struct Merge {
+    size_t k;
+    std::vector<T>& operator()(std::vector<T>& lhs, std::vector<T>&& rhs) {
+      for (T& v : rhs) {
+        Push(&lhs, k, std::move(v));
+      }
+      return lhs;
+    }
+  };
+
+  struct Identity {
+    std::vector<T> operator()() const { return std::vector<T>(); }
+  };
+
+  size_t k_;
+  Reducible<std::vector<T>, Merge, Identity> heaps_;
+
+  static void Push(std::vector<T>* heap, size_t k, T&& v) {
+    if (heap->size() < k) {
+      heap->emplace_back(std::move(v));
+      std::push_heap(heap->begin(), heap->end(), Greater());
+    } else if (k > 0 && heap->front() < v) {
+      std::pop_heap(heap->begin(), heap->end(), Greater());
+      heap->back() = std::move(v);
+      std::push_heap(heap->begin(), heap->end(), Greater());
+    }
+  }
+
+public:
+  using value_type = std::vector<T>;
+
+  explicit GReduceTopK(size_t k) : k_(k), heaps_(Merge{k}, Identity()) {}
+
+  void update(const T& v) { Push(&heaps_.getLocal(), k_, T(v)); }
+
+  void update(T&& v) { Push(&heaps_.getLocal(), k_, std::move(v)); }
+
+  size_t k() const { return k_; }
+
+  //! Returns the (at most) k largest values, largest first. Only valid
+  //! outside the parallel region.
+  std::vector<T> reduce() {
+    std::vector<T> top = heaps_.reduce();
+    std::sort_heap(top.begin(), top.end(), Greater());
+    return top;
+  }
+
+  void reset() { heaps_.reset(); }
+};
+
 }  // namespace katana
 #endif
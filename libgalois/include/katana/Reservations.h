@@ -0,0 +1,200 @@
+#ifndef KATANA_LIBGALOIS_KATANA_RESERVATIONS_H_
+#define KATANA_LIBGALOIS_KATANA_RESERVATIONS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Range.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+#include "katana/Traits.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Locations that the iterations of a \ref speculative_for loop reserve
+/// before they write them. Each location keeps the smallest id of the
+/// iterations that reserved it in the current round, so which iteration wins
+/// a location depends only on the ids and not on the order threads get to
+/// it.
+class Reservations {
+public:
+  constexpr static uint64_t kFree = std::numeric_limits<uint64_t>::max();
+
+  explicit Reservations(size_t num_locations) {
+    slots_.allocateBlocked(num_locations);
+    katana::do_all(katana::iterate(size_t{0}, num_locations), [&](size_t i) {
+      slots_[i].store(kFree, std::memory_order_relaxed);
+    });
+  }
+
+  /// Ask for loc on behalf of iteration it
+  void Reserve(size_t loc, uint64_t it) { katana::atomicMin(slots_[loc], it); }
+
+  /// \returns true if iteration it won loc
+  bool Holds(size_t loc, uint64_t it) const {
+    return slots_[loc].load(std::memory_order_relaxed) == it;
+  }
+
+  /// Free loc if iteration it holds it. Every iteration must release what it
+  /// holds when it commits or gives up so the next round starts clean.
+  void Release(size_t loc, uint64_t it) {
+    if (Holds(loc, it)) {
+      slots_[loc].store(kFree, std::memory_order_relaxed);
+    }
+  }
+
+  size_t size() const { return slots_.size(); }
+
+private:
+  NUMAArray<std::atomic<uint64_t>> slots_;
+};
+
+namespace internal {
+
+/// Keep the items of window whose flag in keep is set, in order
+inline void
+PackRetries(
+    const std::vector<uint64_t>& window, const std::vector<uint8_t>& keep,
+    std::vector<uint64_t>* retries) {
+  unsigned num_threads = katana::getActiveThreads();
+  std::vector<size_t> offsets(num_threads + 1, 0);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] =
+        katana::block_range(size_t{0}, window.size(), tid, total);
+    offsets[tid + 1] = std::count(keep.begin() + begin, keep.begin() + end, 1);
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  retries->resize(offsets.back());
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] =
+        katana::block_range(size_t{0}, window.size(), tid, total);
+    size_t out = offsets[tid];
+    for (size_t i = begin; i < end; ++i) {
+      if (keep[i]) {
+        (*retries)[out++] = window[i];
+      }
+    }
+  });
+}
+
+}  // namespace internal
+
+/**
+ * Deterministic loop over the iterations [begin, end) with deterministic
+ * reservations. Iterations run in rounds over a window of ids. Each round,
+ * every iteration in the window first calls step.Reserve(it), which reserves
+ * the locations the iteration will write in a \ref Reservations and returns
+ * false if the iteration has nothing left to do. Then step.Commit(it) checks
+ * that the iteration holds its reservations, does its writes if it does,
+ * releases what it holds and returns whether it committed. Iterations that do
+ * not commit are retried in the next round ahead of new ones.
+ *
+ * Because a location goes to the smallest id that asks for it, the result
+ * is that of running the iterations one after another in id order, for any
+ * number of threads. Unlike \ref katana::Deterministic, there are no
+ * neighborhood locks taken through the Context and no per-iteration state
+ * is kept between the two phases beyond what Step keeps itself.
+ *
+ * The window doubles while few iterations are retried and halves while many
+ * are, so rounds stay big on inputs with little contention. Round sizes only
+ * depend on the number of retries, which keeps them deterministic too.
+ *
+ * \code
+ * struct Step {
+ *   bool Reserve(uint64_t it) {
+ *     reservations.Reserve(target[it], it);
+ *     return true;
+ *   }
+ *   bool Commit(uint64_t it) {
+ *     if (!reservations.Holds(target[it], it)) {
+ *       return false;
+ *     }
+ *     apply(it);
+ *     reservations.Release(target[it], it);
+ *     return true;
+ *   }
+ * };
+ * katana::speculative_for(0, n, step, katana::loopname("Apply"));
+ * \endcode
+ *
+ * @param begin first iteration id
+ * @param end one past the last iteration id
+ * @param step object with Reserve and Commit as above
+ * @param args optional arguments to the loop, e.g., {@see loopname}
+ */
+template <typename Step, typename... Args>
+void
+speculative_for(uint64_t begin, uint64_t end, Step& step, Args&&... args) {
+  // independent of the number of threads so that rounds are deterministic
+  constexpr uint64_t kMinRoundSize = 64;
+  constexpr uint64_t kMaxRoundSize = uint64_t{1} << 20;
+
+  auto argsTuple = std::make_tuple(std::forward<Args>(args)...);
+  constexpr bool TIME_IT = has_trait<loopname_tag, decltype(argsTuple)>();
+  const char* loopname = katana::internal::getLoopName(argsTuple);
+  CondStatTimer<TIME_IT> timer(loopname);
+  timer.start();
+
+  uint64_t round_size =
+      std::clamp((end - begin) / 100, kMinRoundSize, kMaxRoundSize);
+  uint64_t next = begin;
+  std::vector<uint64_t> window;
+  std::vector<uint64_t> retries;
+  std::vector<uint8_t> keep;
+  uint64_t num_rounds = 0;
+  uint64_t num_retries = 0;
+
+  while (next < end || !retries.empty()) {
+    // retries have smaller ids than new iterations and so win their
+    // conflicts with them; the smallest id in the window always commits
+    uint64_t num_new =
+        std::min(end - next, round_size - std::min(round_size, retries.size()));
+    window.resize(retries.size() + num_new);
+    std::copy(retries.begin(), retries.end(), window.begin());
+    std::iota(window.begin() + retries.size(), window.end(), next);
+    next += num_new;
+
+    keep.resize(window.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, window.size()),
+        [&](size_t i) { keep[i] = step.Reserve(window[i]); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(size_t{0}, window.size()),
+        [&](size_t i) {
+          if (keep[i]) {
+            keep[i] = !step.Commit(window[i]);
+          }
+        },
+        katana::no_stats());
+
+    internal::PackRetries(window, keep, &retries);
+    ++num_rounds;
+    num_retries += retries.size();
+
+    if (retries.size() * 5 > window.size()) {
+      round_size = std::max(round_size / 2, kMinRoundSize);
+    } else if (retries.size() * 10 < window.size()) {
+      round_size = std::min(round_size * 2, kMaxRoundSize);
+    }
+  }
+
+  timer.stop();
+  if (TIME_IT) {
+    katana::ReportStatSingle(loopname, "Rounds", num_rounds);
+    katana::ReportStatSingle(loopname, "Retries", num_retries);
+  }
+}
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef KATANA_LIBGALOIS_KATANA_RESERVEDVECTOR_H_
+#define KATANA_LIBGALOIS_KATANA_RESERVEDVECTOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Logging.h"
+#include "katana/NumaMem.h"
+#include "katana/Threads.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * A vector of plain-old-datatype (POD) objects that grows in place. Like
+ * katana::PODVector, it does not initialize or destruct its objects, but
+ * instead of reallocating and copying as it grows, it reserves address space
+ * for max_size objects up front and backs it with memory as the vector
+ * grows (see LargeReservation), so the objects never move and growing a
+ * large vector costs no more than the memory it adds.
+ *
+ * reserve and resize fault in the new pages interleaved among the active
+ * threads, as NUMAArray::allocateInterleaved does, and so must be called on
+ * the main thread. push_back and insert fault in the pages they add on the
+ * calling thread, so a vector of a thread may grow in a parallel loop.
+ *
+ * Use this when the final size is large and unknown but bounded, e.g., the
+ * edges of an import. Address space is cheap, so the bound may be loose.
+ */
+template <typename T>
+class ReservedVector {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  LargeReservation reservation_;
+  T* data_{};
+  size_t size_{};
+  size_t capacity_{};
+
+  void Commit(size_t n, unsigned num_threads) {
+    KATANA_LOG_VASSERT(
+        n <= max_size(), "ReservedVector of at most {} objects grown to {}",
+        max_size(), n);
+    reservation_.Commit(n * sizeof(T), num_threads);
+    capacity_ = reservation_.committed_bytes() / sizeof(T);
+  }
+
+public:
+  typedef T value_type;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef pointer iterator;
+  typedef const_pointer const_iterator;
+
+  ReservedVector() = default;
+
+  //! Reserves address space for max_size objects without backing it
+  explicit ReservedVector(size_t max_size)
+      : reservation_(max_size * sizeof(T)),
+        data_(static_cast<T*>(reservation_.data())) {}
+
+  ReservedVector(ReservedVector&& o) noexcept
+      : reservation_(std::move(o.reservation_)),
+        data_(o.data_),
+        size_(o.size_),
+        capacity_(o.capacity_) {
+    o.data_ = nullptr;
+    o.size_ = 0;
+    o.capacity_ = 0;
+  }
+
+  ReservedVector& operator=(ReservedVector&& o) noexcept {
+    auto tmp = std::move(o);
+    swap(tmp);
+    return *this;
+  }
+
+  ReservedVector(const ReservedVector&) = delete;
+  ReservedVector& operator=(const ReservedVector&) = delete;
+
+  iterator begin() { return data_; }
+  const_iterator begin() const { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator end() const { return data_ + size_; }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  //! The objects there is memory for, without committing more
+  size_type capacity() const { return capacity_; }
+  //! The objects there is address space for
+  size_type max_size() const {
+    return reservation_.reserved_bytes() / sizeof(T);
+  }
+
+  void reserve(size_t n) {
+    if (n > capacity_) {
+      Commit(n, getActiveThreads());
+    }
+  }
+
+  void resize(size_t n) {
+    reserve(n);
+    size_ = n;
+  }
+
+  void clear() { size_ = 0; }
+
+  reference operator[](size_type n) { return data_[n]; }
+  const_reference operator[](size_type n) const { return data_[n]; }
+  reference front() { return data_[0]; }
+  const_reference front() const { return data_[0]; }
+  reference back() { return data_[size_ - 1]; }
+  const_reference back() const { return data_[size_ - 1]; }
+
+  pointer data() { return data_; }
+  const_pointer data() const { return data_; }
+
+  void push_back(const T& value) {
+    if (size_ == capacity_) {
+      Commit(size_ + 1, 1);
+    }
+    data_[size_++] = value;
+  }
+
+  template <class InputIterator>
+  void insert(
+      [[maybe_unused]] iterator position, InputIterator first,
+      InputIterator last) {
+    KATANA_LOG_ASSERT(position == end());
+    size_t to_add = last - first;
+    if (size_ + to_add > capacity_) {
+      Commit(size_ + to_add, 1);
+    }
+    std::copy_n(first, to_add, end());
+    size_ += to_add;
+  }
+
+  void swap(ReservedVector& o) {
+    std::swap(reservation_, o.reservation_);
+    std::swap(data_, o.data_);
+    std::swap(size_, o.size_);
+    std::swap(capacity_, o.capacity_);
+  }
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SPILLINGCHUNK_H_
+#define KATANA_LIBGALOIS_KATANA_SPILLINGCHUNK_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
+#include "katana/Chunk.h"
+#include "katana/Mem.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// A temporary file of fixed size records that are read back in the order
+/// they were written. The file is created on the first write, in
+/// KATANA_SPILL_DIR, TMPDIR or /tmp, and unlinked right away, so its storage
+/// goes away with the process. Storage is given back whenever every record
+/// written has been read.
+///
+/// Thread safe. I/O errors are fatal: worklists have no way to report them.
+class KATANA_EXPORT SpillFile {
+public:
+  explicit SpillFile(size_t record_size) : record_size_(record_size) {}
+  ~SpillFile();
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+
+  void Write(const void* record);
+
+  /// Reads the oldest record not read yet into \p record
+  /// \returns false if there is none
+  bool Read(void* record);
+
+  bool empty() const { return num_records_.load() == 0; }
+
+  /// \returns the number of records written but not read yet
+  size_t size() const { return num_records_.load(); }
+
+private:
+  size_t record_size_;
+  std::mutex mutex_;
+  int fd_{-1};
+  uint64_t read_offset_{0};
+  uint64_t write_offset_{0};
+  std::atomic<size_t> num_records_{0};
+};
+
+/// \returns the default memory budget of spilling worklists in bytes, from
+/// KATANA_WORKLIST_SPILL_BUDGET_MB or a quarter of physical memory
+KATANA_EXPORT size_t DefaultSpillBudget();
+
+}  // namespace internal
+
+/**
+ * Chunked bag that moves full chunks to a temporary file when the chunks
+ * held in memory would exceed a memory budget and reads them back when it
+ * runs out of chunks in memory. Items come out in no particular order.
+ *
+ * This is for frontiers that may not fit in memory, e.g., BFS or k-hop
+ * expansion on graphs close to the size of memory. Spilling is slow, so the
+ * budget should leave room for the rest of the computation rather than be
+ * small. As a container of BulkSynchronous, each round is a separate bag
+ * with its own budget:
+ *
+ * \code
+ * katana::for_each(
+ *     katana::iterate(sources), Fn,
+ *     katana::wl<katana::BulkSynchronous<katana::SpillingChunkBag<>>>());
+ * \endcode
+ *
+ * Items are written to the file as raw bytes, so they must be trivial.
+ *
+ * @tparam ChunkSize chunk size
+ */
+template <int ChunkSize = 64, typename T = int, bool Concurrent = true>
+class SpillingChunkBag : private boost::noncopyable {
+  static_assert(
+      std::is_trivial_v<T>, "SpillingChunkBag writes items as raw bytes");
+
+public:
+  template <typename _T>
+  using retype = SpillingChunkBag<ChunkSize, _T, Concurrent>;
+
+  template <int _chunk_size>
+  using with_chunk_size = SpillingChunkBag<_chunk_size, T, Concurrent>;
+
+  template <bool _Concurrent>
+  using rethread = SpillingChunkBag<ChunkSize, T, _Concurrent>;
+
+private:
+  //! The part of a chunk that is written to the spill file
+  struct Items {
+    uint32_t begin{0};
+    uint32_t end{0};
+    T items[ChunkSize];
+  };
+
+  struct Chunk : public ConExtListNode<Chunk> {
+    Items data;
+
+    bool empty() const { return data.begin == data.end; }
+    bool full() const { return data.end == ChunkSize; }
+  };
+
+  struct p {
+    Chunk* cur{nullptr};
+    Chunk* next{nullptr};
+  };
+
+  FixedSizeAllocator<Chunk> alloc;
+  internal::squeue<Concurrent, PerThreadStorage, p> data;
+  ConExtLinkedQueue<Chunk, Concurrent> queue;
+  //! chunks in queue and the most that may be
+  std::atomic<size_t> numQueued{0};
+  size_t maxQueued;
+  internal::SpillFile spill{sizeof(Items)};
+
+  Chunk* mkChunk() {
+    Chunk* ptr = alloc.allocate(1);
+    alloc.construct(ptr);
+    return ptr;
+  }
+
+  void delChunk(Chunk* ptr) {
+    alloc.destroy(ptr);
+    alloc.deallocate(ptr, 1);
+  }
+
+  void pushChunk(Chunk* C) {
+    if (numQueued.fetch_add(1) < maxQueued) {
+      queue.push(C);
+      return;
+    }
+    numQueued.fetch_sub(1);
+    spill.Write(&C->data);
+    delChunk(C);
+  }
+
+  Chunk* popChunk() {
+    if (Chunk* C = queue.pop()) {
+      numQueued.fetch_sub(1);
+      return C;
+    }
+    if (spill.empty()) {
+      return nullptr;
+    }
+    Chunk* C = mkChunk();
+    if (!spill.Read(&C->data)) {
+      delChunk(C);
+      return nullptr;
+    }
+    return C;
+  }
+
+public:
+  typedef T value_type;
+
+  //! \param memory_budget bytes of chunks to keep in memory before spilling
+  explicit SpillingChunkBag(
+      size_t memory_budget = internal::DefaultSpillBudget())
+      : maxQueued(std::max<size_t>(1, memory_budget / sizeof(Chunk))) {}
+
+  //! \returns the number of chunks in the spill file
+  size_t spilled() const { return spill.size(); }
+
+  void push(const value_type& val) {
+    p& n = data.get();
+    if (n.next && n.next->full()) {
+      pushChunk(n.next);
+      n.next = nullptr;
+    }
+    if (!n.next) {
+      n.next = mkChunk();
+    }
+    n.next->data.items[n.next->data.end++] = val;
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    p& n = data.get();
+    if (!n.cur || n.cur->empty()) {
+      if (n.cur)
+        delChunk(n.cur);
+      n.cur = popChunk();
+      if (!n.cur) {
+        n.cur = n.next;
+        n.next = nullptr;
+      }
+      if (!n.cur || n.cur->empty())
+        return std::nullopt;
+    }
+    return n.cur->data.items[n.cur->data.begin++];
+  }
+};
+KATANA_WLCOMPILECHECK(SpillingChunkBag)
+
+}  // end namespace katana
+
+#endif
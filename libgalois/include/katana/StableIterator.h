@@ -22,6 +22,7 @@
 
 #include "katana/Chunk.h"
 #include "katana/Range.h"
+#include "katana/Threads.h"
 #include "katana/config.h"
 #include "katana/gstl.h"
 
@@ -130,7 +131,7 @@ private:
     }
     ++data.nextVictim;
     ++data.numStealFailures;
-    data.nextVictim %= activeThreads;
+    data.nextVictim %= getActiveThreads();
     return std::nullopt;
   }
 
@@ -154,7 +155,7 @@ public:
       return *data.localBegin++;
 
     std::optional<value_type> item;
-    if (Steal && 2 * data.numStealFailures > activeThreads)
+    if (Steal && 2 * data.numStealFailures > getActiveThreads())
       if ((item = pop_steal(data)))
         return item;
     if ((item = inner.pop()))
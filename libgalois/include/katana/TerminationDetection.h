@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_TERMINATIONDETECTION_H_
 
 #include <atomic>
+#include <memory>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/PerThreadStorage.h"
@@ -32,11 +33,19 @@ class TerminationDetection;
 
 /*
  * Returns the termination detection instance. The instance will be reused, but
- * reinitialized to activeThreads.
+ * reinitialized to activeThreads. Loops of a ThreadGroup get the instance of
+ * the group.
  */
 KATANA_EXPORT TerminationDetection& GetTerminationDetection(
     unsigned active_threads);
 
+/*
+ * Creates the kind of termination detection that the environment variable
+ * KATANA_TERMINATION picks: hierarchical (the default), tree or ring.
+ */
+KATANA_EXPORT std::unique_ptr<TerminationDetection>
+CreateTerminationDetection();
+
 /// Termination detection is the process of determining whether multiple
 /// threads can safely stop executing because no worker has done any
 /// work.
@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBGALOIS_KATANA_THREADGROUP_H_
+#define KATANA_LIBGALOIS_KATANA_THREADGROUP_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "katana/Barrier.h"
+#include "katana/Result.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A partition of the ThreadPool whose threads run the parallel loops of one
+/// caller at a time, concurrently with the loops of the rest of the pool and
+/// of other groups. A service can give each of its request threads a group
+/// and answer small queries side by side rather than one after the other.
+///
+///   auto group = KATANA_CHECKED(katana::ThreadGroup::Make(8));
+///   // on a request thread
+///   group->Run([&]() {
+///     katana::do_all(katana::iterate(graph), ...);
+///   });
+///
+/// Within Run, everything that the loops see is relative to the group:
+/// ThreadPool::getTID and the topology of the ThreadPool number the threads
+/// of the group from 0, katana::getActiveThreads counts them, and
+/// PerThreadStorage and GetBarrier have a slot or a barrier per thread of the
+/// group. So per-thread state that is read by thread id must be read inside
+/// the Run that ran the loop. Reductions merge the values of all threads of
+/// the machine and can be reduced inside or outside of the group, but not
+/// while another group updates them.
+///
+/// A group reserves the last threads of the pool that are not reserved yet,
+/// which leaves the others to the pool. With the default compact thread
+/// affinity, the threads of a group that is no larger than a socket are
+/// therefore on one socket, or at most two. The calling thread of Run takes
+/// the place of the first thread of the group, which stays idle. Groups must
+/// be destroyed in reverse order of creation, before the runtime.
+class KATANA_EXPORT ThreadGroup {
+public:
+  /// Reserve num_threads threads of the pool for a new group. num_threads
+  /// must be at least 1 and leave at least one thread to the pool. This
+  /// must not be called during a parallel loop.
+  static Result<std::unique_ptr<ThreadGroup>> Make(unsigned num_threads);
+
+  ~ThreadGroup();
+
+  ThreadGroup(const ThreadGroup&) = delete;
+  ThreadGroup& operator=(const ThreadGroup&) = delete;
+  ThreadGroup(ThreadGroup&&) = delete;
+  ThreadGroup& operator=(ThreadGroup&&) = delete;
+
+  /// Call fn on the calling thread as thread 0 of the group, so that the
+  /// parallel loops fn starts run on the threads of the group. Calls from
+  /// different threads take turns. The calling thread must not be in a
+  /// parallel loop, but it may be in a Run of this group already.
+  void Run(const std::function<void()>& fn);
+
+  /// return the number of threads of the group
+  unsigned size() const { return group_->size; }
+
+  /// return the group whose Run the calling thread is in, or nullptr
+  static ThreadGroup* Current() {
+    return ThreadPool::my_box.group ? ThreadPool::my_box.group->owner
+                                    : nullptr;
+  }
+
+private:
+  friend Barrier& GetBarrier(unsigned);
+  friend TerminationDetection& GetTerminationDetection(unsigned);
+
+  /// what Enter replaces for the calling thread
+  struct Caller {
+    ThreadPool::Group* group;
+    char* pts_base;
+    char* pss_base;
+  };
+
+  explicit ThreadGroup(unsigned num_threads);
+
+  /// Make the calling thread thread 0 of the group, with the per-thread and
+  /// per-socket storage of the first thread of the group
+  Caller Enter();
+  void Leave(const Caller& caller);
+
+  /// the barrier of the group, created in the group on first use
+  Barrier& GetGroupBarrier(unsigned active_threads);
+
+  ThreadPool::Group* group_;
+  std::mutex mutex_;
+  std::unique_ptr<Barrier> barrier_;
+  unsigned barrier_threads_{0};
+  std::unique_ptr<TerminationDetection> term_;
+};
+
+}  // namespace katana
+
+#endif
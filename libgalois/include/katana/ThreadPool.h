@@ -20,9 +20,12 @@
 #ifndef KATANA_LIBGALOIS_KATANA_THREADPOOL_H_
 #define KATANA_LIBGALOIS_KATANA_THREADPOOL_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <thread>
@@ -51,9 +54,12 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace katana {
 
+class ThreadGroup;
+
 class KATANA_EXPORT ThreadPool {
 private:
   friend class GaloisRuntime;
+  friend class ThreadGroup;
 
   struct shutdown_ty {};  //! type for shutting down thread
   struct fastmode_ty {
@@ -63,39 +69,51 @@ private:
     std::function<void(void)> fn;
   };  //! type to switch to dedicated mode
 
+  //! Threads [first, first + size) of the pool, which run the loops started
+  //! by a thread in the group. The pool itself is the group of all its
+  //! threads; a ThreadGroup reserves the threads of another one. Threads of
+  //! a group see ids, sockets and leaders relative to the group.
+  struct Group {
+    unsigned first{0};
+    unsigned size{0};
+    unsigned activeThreads{1};
+    unsigned maxSockets{0};
+    //! topology of every thread of the group, relative to the group
+    std::vector<ThreadTopoInfo> topo;
+    //! capacityPrefix[i] is the sum of the capacities of threads [0, i)
+    std::vector<uint64_t> capacityPrefix;
+    bool running{false};
+    std::function<void(void)> work;
+    //! the ThreadGroup of the threads, or null for the whole pool
+    ThreadGroup* owner{nullptr};
+
+    //! lay out threads [first, first + size) of the machine topology
+    void Init(
+        const std::vector<ThreadTopoInfo>& machine, unsigned first,
+        unsigned size);
+  };
+
   //! Per-thread mailboxes for notification
   struct per_signal {
     std::condition_variable cv;
     std::mutex m;
     unsigned wbegin, wend;
     std::atomic<int> done;
-    std::atomic<int> fastRelease;
+    //! set by wakeup and cleared by a wait that returns
+    std::atomic<int> released;
+    //! whether the thread has stopped spinning and is parked in wait
+    std::atomic<int> parked;
+    //! topology of the thread, relative to group
     ThreadTopoInfo topo;
+    //! group of the last run that the thread took part in
+    Group* group{nullptr};
 
-    void wakeup(bool fastmode) {
-      if (fastmode) {
-        done = 0;
-        fastRelease = 1;
-      } else {
-        std::lock_guard<std::mutex> lg(m);
-        done = 0;
-        cv.notify_one();
-        // start.release();
-      }
-    }
-
-    void wait(bool fastmode) {
-      if (fastmode) {
-        while (!fastRelease.load(std::memory_order_relaxed)) {
-          asmPause();
-        }
-        fastRelease = 0;
-      } else {
-        std::unique_lock<std::mutex> lg(m);
-        cv.wait(lg, [=] { return !done; });
-        // start.acquire();
-      }
-    }
+    //! release a thread blocked in wait
+    void wakeup();
+
+    //! spin for up to spin, or forever if spin is negative, until woken
+    //! and then park until woken
+    void wait(std::chrono::nanoseconds spin);
   };
 
   thread_local static per_signal my_box;
@@ -103,10 +121,17 @@ private:
   MachineTopoInfo mi;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
+  //! the group of all threads of the pool
+  Group root;
   unsigned reserved;
   unsigned masterFastmode;
-  bool running;
-  std::function<void(void)> work;
+  //! nanoseconds that idle threads spin before they park
+  std::atomic<int64_t> spinBeforePark;
+
+  //! the group of the calling thread; threads outside of the pool belong to
+  //! the whole pool
+  Group& group() { return my_box.group ? *my_box.group : root; }
+  const Group& group() const { return my_box.group ? *my_box.group : root; }
 
   //! destroy all threads
   void destroyCommon();
@@ -118,7 +143,7 @@ private:
   void threadLoop(unsigned tid);
 
   //! spin up for run
-  void cascade(bool fastmode);
+  void cascade();
 
   //! spin down after run
   void decascade();
@@ -126,6 +151,16 @@ private:
   //! execute work on num threads
   void runInternal(unsigned num);
 
+  //! reserve the last num usable threads for a group of their own
+  Group* reserveGroup(unsigned num, ThreadGroup* owner);
+
+  //! return the threads of group, the last one reserved, to the pool
+  void releaseGroup(Group* group);
+
+  //! make the calling thread the first thread of group, or of the whole pool
+  //! if group is null, and return the group it was in
+  Group* enterGroup(Group* group);
+
   ThreadPool();
 
 public:
@@ -155,7 +190,10 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
+    Group& g = group();
+    KATANA_LOG_VASSERT(
+        !g.running, "Recursive thread pool execution not supported");
+    g.work = std::ref(lwork);
     // work =
     // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
     KATANA_LOG_DEBUG_ASSERT(num <= getMaxThreads());
@@ -170,37 +208,89 @@ public:
   // experimental: leave busy wait
   void beKind();
 
-  //! return the number of non-reserved threads in the pool
-  unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
+  //! Set how long idle threads spin for new work before they park on a
+  //! futex. Spinning shortens the gap between back-to-back parallel loops;
+  //! parking frees the cores for other processes. Threads in burnPower mode
+  //! spin regardless. The default is the KATANA_THREAD_SPIN_US environment
+  //! variable or 0, i.e., park right away.
+  void SetSpinBeforePark(std::chrono::nanoseconds spin) {
+    spinBeforePark = std::max<std::chrono::nanoseconds>(spin, {}).count();
+  }
+  std::chrono::nanoseconds GetSpinBeforePark() const {
+    return std::chrono::nanoseconds(spinBeforePark.load());
+  }
+
+  //! return the number of threads that loops of the calling thread can use:
+  //! the non-reserved threads of the pool or the threads of its ThreadGroup
+  unsigned getMaxUsableThreads() const {
+    return my_box.group && my_box.group->owner ? my_box.group->size
+                                               : mi.maxThreads - reserved;
+  }
+  //! return the number of threads that loops of the calling thread run on;
+  //! see katana::getActiveThreads
+  unsigned getActiveThreads() const { return group().activeThreads; }
+  //! set the number of threads that loops of the calling thread run on; see
+  //! katana::setActiveThreads
+  void setActiveThreads(unsigned num) { group().activeThreads = num; }
   //! return the number of threads supported by the thread pool on the current
   //! machine
   unsigned getMaxThreads() const { return mi.maxThreads; }
+  //! return the number of threads of the group of the calling thread, which
+  //! is the number of threads of the pool outside of any ThreadGroup
+  unsigned getGroupThreads() const { return group().size; }
   unsigned getMaxCores() const { return mi.maxCores; }
-  unsigned getMaxSockets() const { return mi.maxSockets; }
+  //! return the number of sockets of the group of the calling thread
+  unsigned getMaxSockets() const { return group().maxSockets; }
   unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
+  //! return true if some threads run on slower cores than others
+  bool isHybrid() const { return mi.hybrid; }
 
   unsigned getLeaderForSocket(unsigned pid) const {
-    for (unsigned i = 0; i < getMaxThreads(); ++i)
-      if (getSocket(i) == pid && isLeader(i))
+    const Group& g = group();
+    for (unsigned i = 0; i < g.size; ++i)
+      if (g.topo[i].socket == pid && g.topo[i].socketLeader == i)
         return i;
     abort();
   }
 
+  // The topology of a thread id is that of the thread of the group of the
+  // calling thread.
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return group().topo[tid].socketLeader == tid;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getSocket(unsigned tid) const { return group().topo[tid].socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return group().topo[tid].socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return group().topo[tid].cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return group().topo[tid].numaNode;
+  }
+  unsigned getCapacity(unsigned tid) const {
+    return group().topo[tid].capacity;
+  }
+  //! return the sum of the capacities of threads [0, tid)
+  uint64_t getCapacityBefore(unsigned tid) const {
+    return group().capacityPrefix[tid];
+  }
+  //! return true if machine thread tid is the first thread of its socket
+  bool isMachineLeader(unsigned tid) const {
+    return root.topo[tid].socketLeader == tid;
   }
 
+  //! return the id of the calling thread within its group
   static unsigned getTID() { return my_box.topo.tid; }
+  //! return the id of the first thread of the group of the calling thread
+  //! among all the threads of the pool
+  static unsigned getGroupBase() {
+    return my_box.group ? my_box.group->first : 0;
+  }
+  //! return the id of the calling thread among all the threads of the pool,
+  //! for state that is kept per thread of the machine rather than per thread
+  //! of a loop
+  static unsigned getMachineTID() { return getGroupBase() + getTID(); }
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
   static unsigned getLeader() { return my_box.topo.socketLeader; }
   static unsigned getSocket() { return my_box.topo.socket; }
@@ -28,12 +28,14 @@ namespace katana {
  * Sets the number of threads to use when running any Galois iterator. Returns
  * the actual value of threads used, which could be less than the requested
  * value. System behavior is undefined if this function is called during
- * parallel execution or after the first parallel execution.
+ * parallel execution or after the first parallel execution. Inside
+ * ThreadGroup::Run, this sets the number of threads of the group to use.
  */
 KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
 
 /**
- * Returns the number of threads in use.
+ * Returns the number of threads in use, by the ThreadGroup of the calling
+ * thread if it has one.
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
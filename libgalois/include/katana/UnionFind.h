@@ -27,7 +27,8 @@
 namespace katana {
 /**
  * Intrusive union-find implementation. Users subclass this to get disjoint
- * functionality for the subclass object.
+ * functionality for the subclass object. Sets of dense ids, e.g., graph
+ * nodes, are better served by the array-based DisjointSets.
  */
 template <typename T>
 class UnionFindNode {
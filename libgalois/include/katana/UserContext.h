@@ -54,7 +54,7 @@ protected:
   bool firstPassFlag = false;
   void* localState = nullptr;
 
-  void __resetAlloc() { IterationAllocatorBase.clear(); }
+  void __resetAlloc() { IterationAllocatorBase.reset(); }
 
   void __setFirstPass(void) { firstPassFlag = true; }
 
@@ -78,7 +78,10 @@ public:
   //! untill natural termination
   void breakLoop() { *didBreak = true; }
 
-  //! Acquire a per-iteration allocator
+  //! Acquire a per-iteration allocator. Memory from it is bump allocated
+  //! from a thread-local arena that is rewound after each iteration of a
+  //! loop with the katana::per_iter_alloc() trait, so nothing allocated from
+  //! it may outlive the iteration. Pass it to the gstl::PerIter containers.
   PerIterAllocTy& getPerIterAlloc() { return PerIterationAllocator; }
 
   //! Push new work
@@ -25,11 +25,13 @@
 #include "katana/BulkSynchronous.h"
 #include "katana/Chunk.h"
 #include "katana/LocalQueue.h"
+#include "katana/MultiQueue.h"
 #include "katana/Obim.h"
 #include "katana/OrderedList.h"
 #include "katana/OwnerComputes.h"
 #include "katana/PerThreadChunk.h"
 #include "katana/Simple.h"
+#include "katana/SpillingChunk.h"
 #include "katana/StableIterator.h"
 #include "katana/config.h"
 
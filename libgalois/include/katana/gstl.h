@@ -29,10 +29,12 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "katana/Mem.h"
 #include "katana/PriorityQueue.h"
 #include "katana/config.h"
 
@@ -196,6 +198,53 @@ using UnorderedMap = std::unordered_map<
 using Str =
     std::basic_string<char, std::char_traits<char>, Pow2BlockAllocator<char>>;
 
+//! [STL containers using the per-iteration allocator]
+//! specialize STL containers to allocate from the per-iteration allocator of
+//! a for_each loop, UserContext::getPerIterAlloc(), which must be passed to
+//! their constructors:
+//!
+//! \code
+//! katana::for_each(
+//!     katana::iterate(nodes),
+//!     [&](Node n, auto& ctx) {
+//!       gstl::PerIterMap<uint32_t, double> weights(ctx.getPerIterAlloc());
+//!       ...
+//!     },
+//!     katana::per_iter_alloc(), katana::loopname("Example"));
+//! \endcode
+//!
+//! Allocation bumps a pointer in a thread-local arena and deallocation does
+//! nothing; the executor rewinds the arena after each iteration. This avoids
+//! both the global heap and per-object frees for temporaries that live for
+//! one iteration, but the containers must not outlive the iteration, and
+//! freed memory is not reused within it, so keep containers that grow and
+//! shrink many times per iteration on another allocator.
+template <typename T>
+using PerIterVector = std::vector<T, typename PerIterAllocTy::rebind<T>::other>;
+
+template <typename T>
+using PerIterDeque = std::deque<T, typename PerIterAllocTy::rebind<T>::other>;
+
+template <typename T, typename C = std::less<T>>
+using PerIterSet = std::set<T, C, typename PerIterAllocTy::rebind<T>::other>;
+
+template <typename K, typename V, typename C = std::less<K>>
+using PerIterMap = std::map<
+    K, V, C, typename PerIterAllocTy::rebind<std::pair<const K, V>>::other>;
+
+template <
+    typename T, typename Hash = std::hash<T>,
+    typename KeyEqual = std::equal_to<T>>
+using PerIterUnorderedSet = std::unordered_set<
+    T, Hash, KeyEqual, typename PerIterAllocTy::rebind<T>::other>;
+
+template <
+    typename K, typename V, typename Hash = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>>
+using PerIterUnorderedMap = std::unordered_map<
+    K, V, Hash, KeyEqual,
+    typename PerIterAllocTy::rebind<std::pair<const K, V>>::other>;
+
 template <typename T>
 struct StrMaker {
   Str operator()(const T& x) const {
@@ -19,8 +19,16 @@
 
 #include "katana/Barrier.h"
 
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
+#include "katana/ThreadGroup.h"
 #include "katana/ThreadPool.h"
+#include "katana/Timer.h"
 
 // anchor vtable
 katana::Barrier::~Barrier() = default;
@@ -43,6 +51,9 @@ katana::internal::SetBarrier(katana::Barrier* barrier) {
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
+  if (ThreadGroup* group = ThreadGroup::Current()) {
+    return group->GetGroupBarrier(active_threads);
+  }
   KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
   active_threads =
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
@@ -55,3 +66,81 @@ katana::GetBarrier(unsigned active_threads) {
 
   return *kBarrier;
 }
+
+namespace {
+
+using BarrierFactory = std::unique_ptr<katana::Barrier> (*)(unsigned);
+
+// The simple barrier is left out: it is broken and deadlocks.
+const std::vector<std::pair<std::string, BarrierFactory>> kBarriers{
+    {"counting", katana::CreateCountingBarrier},
+    {"dissemination", katana::CreateDisseminationBarrier},
+    {"mcs", katana::CreateMCSBarrier},
+    {"topo", katana::CreateTopoBarrier},
+    {"tree", katana::CreateTreeBarrier},
+};
+
+/// Up to this many threads on one socket, every thread may as well update
+/// the same counter
+constexpr unsigned kMaxCountingBarrierThreads = 8;
+
+/// Time kRounds rounds of each barrier on all threads and return the fastest
+std::unique_ptr<katana::Barrier>
+MeasureBarriers(unsigned active_threads) {
+  constexpr unsigned kRounds = 256;
+  auto& tp = katana::GetThreadPool();
+
+  std::unique_ptr<katana::Barrier> best;
+  uint64_t best_usec = std::numeric_limits<uint64_t>::max();
+  for (const auto& [name, factory] : kBarriers) {
+    std::unique_ptr<katana::Barrier> barrier = factory(active_threads);
+    katana::Barrier* b = barrier.get();
+    auto rounds = [b]() {
+      for (unsigned i = 0; i < kRounds; ++i) {
+        b->Wait();
+      }
+    };
+    // the first run warms up the threads and the barrier
+    tp.run(active_threads, rounds);
+    katana::Timer timer;
+    timer.start();
+    tp.run(active_threads, rounds);
+    timer.stop();
+    KATANA_LOG_VERBOSE(
+        "barrier {}: {} us for {} rounds on {} threads", name,
+        timer.get_usec(), kRounds, active_threads);
+    if (timer.get_usec() < best_usec) {
+      best_usec = timer.get_usec();
+      best = std::move(barrier);
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+std::unique_ptr<katana::Barrier>
+katana::CreateBarrier(unsigned active_threads) {
+  auto& tp = GetThreadPool();
+  active_threads = std::max(active_threads, 1U);
+
+  std::string choice = "auto";
+  GetEnv("KATANA_BARRIER", &choice);
+  if (choice == "measure") {
+    return MeasureBarriers(active_threads);
+  }
+  for (const auto& [name, factory] : kBarriers) {
+    if (name == choice) {
+      return factory(active_threads);
+    }
+  }
+  if (choice != "auto") {
+    KATANA_LOG_WARN("unknown KATANA_BARRIER {}; using auto", choice);
+  }
+
+  if (active_threads <= kMaxCountingBarrierThreads &&
+      tp.getMaxSockets() == 1) {
+    return CreateCountingBarrier(active_threads);
+  }
+  return CreateTreeBarrier(active_threads);
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <thread>
+#endif
+
+#include "katana/Barrier.h"
+#include "katana/CompilerSpecific.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+/// A combining tree barrier laid out along the sockets of the machine.
+///
+/// Threads arrive at leaves of kFanIn consecutive threads of a socket, whose
+/// last arrival goes on to arrive at the parent; the nodes of a socket are
+/// combined within the socket first and the roots of the sockets last, so
+/// that only the last arrival of each socket touches memory of another.
+/// The last arrival at the root releases everyone by bumping a generation
+/// count. Waiters spin on it for a while and then sleep on a futex, so that
+/// long rounds do not burn cores that other work could use.
+class TreeBarrier : public katana::Barrier {
+  static constexpr unsigned kFanIn = 4;
+  /// pause loop iterations before a waiter goes to sleep
+  static constexpr unsigned kSpins = 1 << 14;
+
+  struct alignas(katana::KATANA_CACHE_LINE_SIZE) Node {
+    std::atomic<unsigned> count{0};
+    unsigned expected{0};
+    Node* parent{nullptr};
+  };
+
+  std::unique_ptr<Node[]> nodes_;
+  /// leaf node of every thread
+  std::vector<Node*> leaves_;
+
+  alignas(katana::KATANA_CACHE_LINE_SIZE) std::atomic<uint32_t> generation_{0};
+  alignas(katana::KATANA_CACHE_LINE_SIZE) std::atomic<unsigned> sleepers_{0};
+
+  void _reinit(unsigned P) {
+    auto& tp = katana::GetThreadPool();
+
+    // threads of each socket, in thread id order
+    std::map<unsigned, std::vector<unsigned>> sockets;
+    for (unsigned tid = 0; tid < P; ++tid) {
+      sockets[tp.getSocket(tid)].emplace_back(tid);
+    }
+
+    // Each node is described by its number of children and the index of its
+    // parent; a level of the tree is combined kFanIn nodes at a time into
+    // the next one until a single node is left.
+    std::vector<unsigned> expected;
+    std::vector<size_t> parents;
+    auto combine = [&](std::vector<size_t> level) {
+      while (level.size() > 1) {
+        std::vector<size_t> next;
+        for (size_t i = 0; i < level.size(); i += kFanIn) {
+          size_t parent = expected.size();
+          size_t end = std::min<size_t>(i + kFanIn, level.size());
+          expected.emplace_back(end - i);
+          parents.emplace_back(SIZE_MAX);
+          for (size_t j = i; j < end; ++j) {
+            parents[level[j]] = parent;
+          }
+          next.emplace_back(parent);
+        }
+        level = std::move(next);
+      }
+      return level.front();
+    };
+
+    std::vector<size_t> leaf_of(P);
+    std::vector<size_t> socket_roots;
+    for (const auto& [socket, tids] : sockets) {
+      std::vector<size_t> leaves;
+      for (size_t i = 0; i < tids.size(); i += kFanIn) {
+        size_t leaf = expected.size();
+        size_t end = std::min<size_t>(i + kFanIn, tids.size());
+        expected.emplace_back(end - i);
+        parents.emplace_back(SIZE_MAX);
+        for (size_t j = i; j < end; ++j) {
+          leaf_of[tids[j]] = leaf;
+        }
+        leaves.emplace_back(leaf);
+      }
+      socket_roots.emplace_back(combine(std::move(leaves)));
+    }
+    combine(std::move(socket_roots));
+
+    nodes_ = std::make_unique<Node[]>(expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      nodes_[i].expected = expected[i];
+      nodes_[i].count = expected[i];
+      nodes_[i].parent = parents[i] == SIZE_MAX ? nullptr : &nodes_[parents[i]];
+    }
+    leaves_.resize(P);
+    for (unsigned tid = 0; tid < P; ++tid) {
+      leaves_[tid] = &nodes_[leaf_of[tid]];
+    }
+  }
+
+  void WaitFor(uint32_t generation) {
+    for (unsigned i = 0; i < kSpins; ++i) {
+      if (generation_.load(std::memory_order_acquire) != generation) {
+        return;
+      }
+      katana::asmPause();
+    }
+
+    // The releaser bumps generation_ before it reads sleepers_, and a
+    // sleeper counts itself before the futex checks generation_, so either
+    // the releaser sees the sleeper or the sleeper sees the new generation.
+    sleepers_.fetch_add(1);
+    while (generation_.load() == generation) {
+#ifdef __linux__
+      syscall(
+          SYS_futex, reinterpret_cast<uint32_t*>(&generation_),
+          FUTEX_WAIT_PRIVATE, generation, nullptr, nullptr, 0);
+#else
+      std::this_thread::yield();
+#endif
+    }
+    sleepers_.fetch_sub(1);
+  }
+
+  void Release(uint32_t generation) {
+    generation_.store(generation + 1);
+    if (sleepers_.load() != 0) {
+#ifdef __linux__
+      syscall(
+          SYS_futex, reinterpret_cast<uint32_t*>(&generation_),
+          FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+  }
+
+public:
+  TreeBarrier(unsigned v) { _reinit(v); }
+
+  // not safe if any thread is in wait
+  void Reinit(unsigned val) override { _reinit(val); }
+
+  void Wait() override {
+    // read before arriving, so that it cannot be the next generation yet
+    uint32_t generation = generation_.load(std::memory_order_acquire);
+    Node* n = leaves_[katana::ThreadPool::getTID()];
+    while (n) {
+      if (n->count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        WaitFor(generation);
+        return;
+      }
+      // the last arrival resets the node for the next round, which no
+      // thread can reach before the release
+      n->count.store(n->expected, std::memory_order_relaxed);
+      n = n->parent;
+    }
+    Release(generation);
+  }
+
+  const char* name() const override { return "TreeBarrier"; }
+};
+
+}  // namespace
+
+std::unique_ptr<katana::Barrier>
+katana::CreateTreeBarrier(unsigned active_threads) {
+  return std::make_unique<TreeBarrier>(active_threads);
+}
@@ -27,6 +27,35 @@
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+namespace {
+
+size_t
+PopCount(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_popcountll(n);
+#else
+  n = n - ((n >> 1) & 0x5555555555555555UL);
+  n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
+  return (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+}
+
+/// \returns the index of the lowest set bit of n, which must not be 0
+size_t
+CountTrailingZeros(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_ctzll(n);
+#else
+  size_t zeros = 0;
+  for (; !(n & 1); n >>= 1) {
+    ++zeros;
+  }
+  return zeros;
+#endif
+}
+
+}  // namespace
+
 void
 katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
@@ -91,22 +120,36 @@ katana::DynamicBitset::bitwise_xor(
       katana::no_stats());
 }
 
+void
+katana::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  const auto& other_bitvec = other.get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, bitvec_.size()),
+      [&](size_t i) { bitvec_[i] &= ~uint64_t{other_bitvec[i]}; },
+      katana::no_stats());
+}
+
+void
+katana::DynamicBitset::bitwise_andnot(
+    const DynamicBitset& other1, const DynamicBitset& other2) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
+  KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
+  const auto& other_bitvec1 = other1.get_vec();
+  const auto& other_bitvec2 = other2.get_vec();
+
+  katana::do_all(
+      katana::iterate(size_t{0}, bitvec_.size()),
+      [&](size_t i) { bitvec_[i] = other_bitvec1[i] & ~other_bitvec2[i]; },
+      katana::no_stats());
+}
+
 size_t
 katana::DynamicBitset::count() const {
   katana::GAccumulator<size_t> ret;
   katana::do_all(
       katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
+      [&](uint64_t n) { ret += PopCount(n); }, katana::no_stats());
   return ret.reduce();
 }
 
@@ -114,13 +157,7 @@ size_t
 katana::DynamicBitset::SerialCount() const {
   size_t ret = 0;
   for (uint64_t n : bitvec_) {
-#ifdef __GNUC__
-    ret += __builtin_popcountll(n);
-#else
-    n = n - ((n >> 1) & 0x5555555555555555UL);
-    n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-    ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
-#endif
+    ret += PopCount(n);
   }
   return ret;
 }
@@ -130,50 +167,47 @@ template <typename Integer>
 void
 ComputeOffsets(
     const katana::DynamicBitset& bitset, std::vector<Integer>* offsets) {
-  // TODO uint32_t is somewhat dangerous; change in the future
-  uint32_t activeThreads = katana::getActiveThreads();
-  std::vector<Integer> tPrefixBitCounts(activeThreads);
+  const auto& words = bitset.get_vec();
+  uint32_t active_threads = katana::getActiveThreads();
+  // prefix_counts[t] is the number of set bits in the words before those of
+  // thread t
+  std::vector<size_t> prefix_counts(active_threads + 1);
 
-  // count how many bits are set on each thread
+  // count how many bits are set in the words of each thread
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+        katana::block_range(size_t{0}, words.size(), tid, nthreads);
 
-    Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
+    size_t count = 0;
+    for (size_t w = start; w < end; ++w) {
+      count += PopCount(words[w]);
     }
-
-    tPrefixBitCounts[tid] = count;
+    prefix_counts[tid + 1] = count;
   });
 
-  // calculate prefix sum of bits per thread
-  for (uint32_t i = 1; i < activeThreads; ++i) {
-    tPrefixBitCounts[i] += tPrefixBitCounts[i - 1];
+  for (uint32_t i = 1; i <= active_threads; ++i) {
+    prefix_counts[i] += prefix_counts[i - 1];
   }
 
-  // total num of set bits
-  Integer bitsetCount = tPrefixBitCounts[activeThreads - 1];
-
-  // calculate the indices of the set bits and save them to the offset
-  // vector
-  if (bitsetCount > 0) {
-    size_t cur_size = offsets->size();
-    offsets->resize(cur_size + bitsetCount);
+  // calculate the indices of the set bits, one set bit of a word at a time,
+  // and save them to the offset vector
+  size_t cur_size = offsets->size();
+  if (prefix_counts[active_threads] > 0) {
+    offsets->resize(cur_size + prefix_counts[active_threads]);
+    Integer* out = offsets->data() + cur_size;
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-      Integer index = cur_size;
-      if (tid != 0) {
-        index += tPrefixBitCounts[tid - 1];
-      }
-
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
-          ++index;
+          katana::block_range(size_t{0}, words.size(), tid, nthreads);
+      size_t index = prefix_counts[tid];
+
+      for (size_t w = start; w < end; ++w) {
+        uint64_t word = words[w];
+        while (word) {
+          out[index++] = static_cast<Integer>(
+              w * katana::DynamicBitset::kNumBitsInUint64 +
+              CountTrailingZeros(word));
+          // clear the lowest set bit
+          word &= word - 1;
         }
       }
     });
@@ -19,9 +19,15 @@
 
 #include "katana/GaloisRuntime.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "katana/Barrier.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
 #include "katana/PagePool.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
@@ -203,11 +209,175 @@ public:
   }
 };
 
+// Dijkstra style 2-pass tree termination detection over a tree laid out
+// along the sockets of the machine: the threads of each socket form a
+// kFanOut-ary tree rooted at the thread of the socket with the smallest id,
+// and the roots of the sockets form another one rooted at thread 0. A wave
+// then crosses sockets only between socket roots, and takes a number of
+// steps logarithmic rather than linear in the number of threads.
+class HierarchicalTerminationDetection : public katana::TerminationDetection {
+  static constexpr unsigned kFanOut = 4;
+  // a socket root has children in its socket and among the socket roots
+  static constexpr unsigned kMaxChildren = 2 * kFanOut;
+  static constexpr long kNoToken = -1;
+
+  struct TokenHolder {
+    // incoming from above
+    std::atomic<long> down_token;
+    // incoming from below: kNoToken, or whether the subtree was black
+    std::atomic<long> up_token[kMaxChildren];
+    // my state
+    long process_is_black;
+    bool has_token;
+    bool last_was_white;  // only used by the master
+    TokenHolder* parent;
+    unsigned parent_offset;
+    unsigned num_children;
+    TokenHolder* child[kMaxChildren];
+  };
+
+  katana::PerThreadStorage<TokenHolder> data_;
+
+  unsigned active_threads_{0};
+  // parents_[tid] is the parent of thread tid and children_[tid] its
+  // children, as laid out for active_threads_
+  std::vector<unsigned> parents_;
+  std::vector<std::vector<unsigned>> children_;
+
+  void Layout(unsigned active_threads) {
+    auto& tp = katana::GetThreadPool();
+    std::map<unsigned, std::vector<unsigned>> sockets;
+    for (unsigned tid = 0; tid < active_threads; ++tid) {
+      sockets[tp.getSocket(tid)].emplace_back(tid);
+    }
+
+    parents_.assign(active_threads, 0);
+    children_.assign(active_threads, {});
+    auto link = [&](const std::vector<unsigned>& members) {
+      for (size_t i = 1; i < members.size(); ++i) {
+        unsigned parent = members[(i - 1) / kFanOut];
+        parents_[members[i]] = parent;
+        children_[parent].emplace_back(members[i]);
+      }
+    };
+
+    std::vector<unsigned> roots;
+    for (const auto& entry : sockets) {
+      link(entry.second);
+      roots.emplace_back(entry.second.front());
+    }
+    // thread 0 has the smallest id of all, so it comes first
+    std::sort(roots.begin(), roots.end());
+    link(roots);
+  }
+
+  void ProcessToken() {
+    TokenHolder& th = *data_.getLocal();
+    // have all up tokens?
+    bool have_all = th.has_token;
+    bool black = th.process_is_black;
+    for (unsigned i = 0; i < th.num_children; ++i) {
+      long up = th.up_token[i].load(std::memory_order_acquire);
+      if (up == kNoToken) {
+        have_all = false;
+      } else {
+        black |= up;
+      }
+    }
+    // Have the tokens, propagate
+    if (have_all) {
+      th.process_is_black = false;
+      th.has_token = false;
+      if (IsSysMaster()) {
+        if (th.last_was_white && !black) {
+          // This was the second success
+          SetTerminated();
+          return;
+        }
+        th.last_was_white = !black;
+        th.down_token.store(true, std::memory_order_relaxed);
+      } else {
+        th.parent->up_token[th.parent_offset].store(
+            black, std::memory_order_release);
+      }
+    }
+
+    // received a down token, propagate
+    if (th.down_token.load(std::memory_order_acquire)) {
+      th.down_token.store(false, std::memory_order_relaxed);
+      th.has_token = true;
+      for (unsigned i = 0; i < th.num_children; ++i) {
+        th.up_token[i].store(kNoToken, std::memory_order_relaxed);
+        th.child[i]->down_token.store(true, std::memory_order_release);
+      }
+    }
+  }
+
+  bool IsSysMaster() const { return katana::ThreadPool::getTID() == 0; }
+
+protected:
+  void Init(unsigned active_threads) override {
+    if (active_threads != active_threads_) {
+      Layout(active_threads);
+      active_threads_ = active_threads;
+    }
+  }
+
+public:
+  void InitializeThread() override {
+    TokenHolder& th = *data_.getLocal();
+    auto tid = katana::ThreadPool::getTID();
+    th.down_token = false;
+    th.process_is_black = true;
+    th.has_token = false;
+    th.last_was_white = false;
+    ResetTerminated();
+    th.parent = tid == 0 ? nullptr : data_.getRemote(parents_[tid]);
+    if (th.parent) {
+      const auto& siblings = children_[parents_[tid]];
+      th.parent_offset =
+          std::find(siblings.begin(), siblings.end(), tid) - siblings.begin();
+    }
+    th.num_children = children_[tid].size();
+    for (unsigned i = 0; i < th.num_children; ++i) {
+      th.up_token[i] = false;
+      th.child[i] = data_.getRemote(children_[tid][i]);
+    }
+    if (IsSysMaster()) {
+      th.down_token = true;
+    }
+  }
+
+  void SignalWorked(bool work_happened) override {
+    KATANA_LOG_DEBUG_ASSERT(!(work_happened && !Working()));
+    TokenHolder& th = *data_.getLocal();
+    th.process_is_black |= work_happened;
+    ProcessToken();
+  }
+};
+
 }  // namespace
 
+std::unique_ptr<katana::TerminationDetection>
+katana::CreateTerminationDetection() {
+  std::string choice = "hierarchical";
+  katana::GetEnv("KATANA_TERMINATION", &choice);
+  if (choice == "ring") {
+    return std::make_unique<LocalTerminationDetection>();
+  }
+  if (choice == "tree") {
+    return std::make_unique<TreeTerminationDetection>();
+  }
+  if (choice != "hierarchical") {
+    KATANA_LOG_WARN(
+        "unknown KATANA_TERMINATION {}; using hierarchical", choice);
+  }
+  return std::make_unique<HierarchicalTerminationDetection>();
+}
+
 struct katana::GaloisRuntime::Impl {
   struct Dependents {
-    LocalTerminationDetection term;
+    std::unique_ptr<TerminationDetection> term;
     std::unique_ptr<Barrier> barrier;
     internal::PageAllocState<> page_pool;
     katana::StatManager stat_manager;
@@ -224,10 +394,11 @@ katana::GaloisRuntime::GaloisRuntime() : impl_(std::make_unique<Impl>()) {
   // may call GetThreadPool() in their constructors
   impl_->deps = std::make_unique<Impl::Dependents>();
   impl_->deps->barrier =
-      katana::CreateTopoBarrier(impl_->thread_pool.getMaxUsableThreads());
+      katana::CreateBarrier(impl_->thread_pool.getMaxUsableThreads());
 
   internal::SetBarrier(impl_->deps->barrier.get());
-  internal::SetTerminationDetection(&impl_->deps->term);
+  impl_->deps->term = CreateTerminationDetection();
+  internal::SetTerminationDetection(impl_->deps->term.get());
   internal::setPagePoolState(&impl_->deps->page_pool);
   katana::internal::setSysStatManager(&impl_->deps->stat_manager);
 }
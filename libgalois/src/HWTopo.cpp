@@ -1,5 +1,7 @@
 #include "katana/HWTopo.h"
 
+#include <cstdint>
+#include <sstream>
 #include <stdexcept>
 
 std::vector<int>
@@ -36,3 +38,38 @@ katana::parseCPUList(const std::string& line) {
 
   return vals;
 }
+
+std::optional<katana::AffinityPolicy>
+katana::parseAffinityPolicy(const std::string& in) {
+  if (in == "compact") {
+    return AffinityPolicy::kCompact;
+  }
+  if (in == "scatter") {
+    return AffinityPolicy::kScatter;
+  }
+  if (in == "compact-smt") {
+    return AffinityPolicy::kCompactSMT;
+  }
+  return std::nullopt;
+}
+
+unsigned
+katana::parseCPUQuota(const std::string& in) {
+  std::istringstream data(in);
+  std::string quota;
+  uint64_t period = 0;
+  if (!(data >> quota >> period) || quota == "max" || period == 0) {
+    return 0;
+  }
+  try {
+    int64_t q = std::stoll(quota);
+    if (q <= 0) {
+      return 0;
+    }
+    return (static_cast<uint64_t>(q) + period - 1) / period;
+  } catch (const std::invalid_argument&) {
+    return 0;
+  } catch (const std::out_of_range&) {
+    return 0;
+  }
+}
@@ -23,13 +23,17 @@
 #include <array>
 #include <cassert>
 #include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <set>
+#include <string>
 
+#include "katana/Env.h"
 #include "katana/HWTopo.h"
 #include "katana/SimpleLock.h"
 #include "katana/gIO.h"
@@ -52,15 +56,14 @@ struct cpuinfo {
   unsigned coreid;
   unsigned cpucores;
   unsigned numaNode;  // from libnuma
+  unsigned capacity;  // from sysfs
   bool valid;         // from cpuset
   bool smt;           // computed
 };
 
+/// Orders the SMT contexts of a core next to each other
 bool
-operator<(const cpuinfo& lhs, const cpuinfo& rhs) {
-  if (lhs.smt != rhs.smt) {
-    return lhs.smt < rhs.smt;
-  }
+byCore(const cpuinfo& lhs, const cpuinfo& rhs) {
   if (lhs.physid != rhs.physid) {
     return lhs.physid < rhs.physid;
   }
@@ -70,6 +73,43 @@ operator<(const cpuinfo& lhs, const cpuinfo& rhs) {
   return lhs.proc < rhs.proc;
 }
 
+/// Orders cores socket by socket, faster cores first, SMT siblings last
+bool
+compact(const cpuinfo& lhs, const cpuinfo& rhs) {
+  if (lhs.smt != rhs.smt) {
+    return lhs.smt < rhs.smt;
+  }
+  if (lhs.physid != rhs.physid) {
+    return lhs.physid < rhs.physid;
+  }
+  if (lhs.capacity != rhs.capacity) {
+    return lhs.capacity > rhs.capacity;
+  }
+  return byCore(lhs, rhs);
+}
+
+/// Orders cores socket by socket, faster cores first, with the SMT
+/// contexts of a core next to each other
+bool
+compactSMT(const cpuinfo& lhs, const cpuinfo& rhs) {
+  if (lhs.physid != rhs.physid) {
+    return lhs.physid < rhs.physid;
+  }
+  if (lhs.capacity != rhs.capacity) {
+    return lhs.capacity > rhs.capacity;
+  }
+  return byCore(lhs, rhs);
+}
+
+//! Returns the first line of a file, or "" if it cannot be read
+std::string
+readLine(const std::string& path) {
+  std::ifstream data(path);
+  std::string line;
+  std::getline(data, line);
+  return line;
+}
+
 #ifdef KATANA_USE_NUMA
 int (*dynamic_numa_available)() = nullptr;
 int (*dynamic_numa_num_configured_nodes)() = nullptr;
@@ -163,6 +203,45 @@ parseCPUInfo() {
   return vals;
 }
 
+//! Efficiency cores of Intel hybrid processors, which do not export
+//! cpu_capacity, count as this much; a rough estimate, as they both clock
+//! lower and retire fewer instructions per cycle than performance cores
+constexpr unsigned kAtomCapacity = 640;
+
+//! Fill in capacity from sysfs: cpu_capacity where the kernel exports it
+//! (e.g., ARM big.LITTLE), otherwise the Intel hybrid list of efficiency
+//! cores
+void
+markCapacity(std::vector<cpuinfo>& info) {
+  auto atoms = katana::parseCPUList(readLine("/sys/devices/cpu_atom/cpus"));
+  std::sort(atoms.begin(), atoms.end());
+
+  unsigned max_capacity = 0;
+  for (auto& c : info) {
+    c.capacity = katana::kMaxCPUCapacity;
+    std::string capacity = readLine(
+        "/sys/devices/system/cpu/cpu" + std::to_string(c.proc) +
+        "/cpu_capacity");
+    if (!capacity.empty()) {
+      try {
+        c.capacity = std::stoul(capacity);
+      } catch (const std::exception&) {
+      }
+    } else if (std::binary_search(atoms.begin(), atoms.end(), c.proc)) {
+      c.capacity = kAtomCapacity;
+    }
+    c.capacity = std::max(c.capacity, 1U);
+    max_capacity = std::max(max_capacity, c.capacity);
+  }
+
+  // rescale so that the fastest cores have kMaxCPUCapacity
+  for (auto& c : info) {
+    uint64_t scaled =
+        uint64_t{c.capacity} * katana::kMaxCPUCapacity / max_capacity;
+    c.capacity = std::max<unsigned>(scaled, 1);
+  }
+}
+
 unsigned
 countSockets(const std::vector<cpuinfo>& info) {
   std::set<unsigned> pkgs;
@@ -249,6 +328,91 @@ markValid(std::vector<cpuinfo>& info) {
       c.valid = std::binary_search(v.begin(), v.end(), c.proc);
     }
   }
+
+  // cores set aside with isolcpus are for threads that ask for them by name
+  auto isolated =
+      katana::parseCPUList(readLine("/sys/devices/system/cpu/isolated"));
+  std::sort(isolated.begin(), isolated.end());
+  for (auto& c : info) {
+    if (std::binary_search(isolated.begin(), isolated.end(), c.proc)) {
+      c.valid = false;
+    }
+  }
+}
+
+//! Returns the number of CPUs the CPU bandwidth limit of our cgroup allows,
+//! or 0 if there is none. Containers see their own cgroup at the root of
+//! /sys/fs/cgroup.
+unsigned
+readCPUQuota() {
+  unsigned quota = katana::parseCPUQuota(readLine("/sys/fs/cgroup/cpu.max"));
+  if (quota) {
+    return quota;
+  }
+  for (std::string dir : {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"}) {
+    std::string us = readLine(dir + "/cpu.cfs_quota_us");
+    std::string period = readLine(dir + "/cpu.cfs_period_us");
+    if (!us.empty() && !period.empty()) {
+      return katana::parseCPUQuota(us + " " + period);
+    }
+  }
+  return 0;
+}
+
+katana::AffinityPolicy
+getAffinityPolicy() {
+  std::string name;
+  if (!katana::GetEnv("KATANA_THREAD_AFFINITY", &name)) {
+    return katana::AffinityPolicy::kCompact;
+  }
+  auto policy = katana::parseAffinityPolicy(name);
+  if (!policy) {
+    KATANA_LOG_WARN(
+        "unknown KATANA_THREAD_AFFINITY {}; using compact; choices are "
+        "compact, scatter and compact-smt",
+        name);
+    return katana::AffinityPolicy::kCompact;
+  }
+  return *policy;
+}
+
+//! Put CPUs in the order that threads should be bound to them
+void
+orderCPUs(std::vector<cpuinfo>& info, katana::AffinityPolicy policy) {
+  switch (policy) {
+  case katana::AffinityPolicy::kCompactSMT:
+    std::sort(info.begin(), info.end(), compactSMT);
+    return;
+  case katana::AffinityPolicy::kScatter: {
+    // take the compact order and deal it out socket by socket
+    std::sort(info.begin(), info.end(), compact);
+    std::vector<unsigned> rank(info.size());
+    for (size_t i = 1; i < info.size(); ++i) {
+      bool same_group = info[i].smt == info[i - 1].smt &&
+                        info[i].physid == info[i - 1].physid;
+      rank[i] = same_group ? rank[i - 1] + 1 : 0;
+    }
+    std::vector<size_t> order(info.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      if (info[a].smt != info[b].smt) {
+        return info[a].smt < info[b].smt;
+      }
+      return rank[a] < rank[b];
+    });
+    std::vector<cpuinfo> scattered;
+    scattered.reserve(info.size());
+    for (size_t i : order) {
+      scattered.push_back(info[i]);
+    }
+    info = std::move(scattered);
+    return;
+  }
+  case katana::AffinityPolicy::kCompact:
+  default:
+    std::sort(info.begin(), info.end(), compact);
+    return;
+  }
 }
 
 katana::HWTopoInfo
@@ -256,8 +420,6 @@ makeHWTopo() {
   katana::MachineTopoInfo retMTI;
 
   auto info = parseCPUInfo();
-  std::sort(info.begin(), info.end());
-  markSMT(info);
   markValid(info);
 
   info.erase(
@@ -265,8 +427,25 @@ makeHWTopo() {
           info.begin(), info.end(), [](const cpuinfo& c) { return c.valid; }),
       info.end());
 
-  std::sort(info.begin(), info.end());
+  std::sort(info.begin(), info.end(), byCore);
   markSMT(info);
+  markCapacity(info);
+  orderCPUs(info, getAffinityPolicy());
+
+  // threads beyond the CPU quota of a container only take turns on the
+  // CPUs it is allowed
+  unsigned quota = readCPUQuota();
+  if (quota && quota < info.size() &&
+      !katana::GetEnv("KATANA_IGNORE_CPU_QUOTA")) {
+    KATANA_LOG_VERBOSE(
+        "limiting threads to the CPU quota of {} of {} CPUs", quota,
+        info.size());
+    info.resize(quota);
+  }
+  retMTI.hybrid = std::any_of(info.begin(), info.end(), [](const cpuinfo& c) {
+    return c.capacity != katana::kMaxCPUCapacity;
+  });
+
   retMTI.maxSockets = countSockets(info);
   retMTI.maxThreads = info.size();
   retMTI.maxCores = countCores(info);
@@ -296,7 +475,7 @@ makeHWTopo() {
         i, leader, repid,
         (unsigned)std::distance(
             numaNodes.begin(), numaNodes.find(info[i].numaNode)),
-        mid, info[i].proc, info[i].numaNode});
+        mid, info[i].proc, info[i].numaNode, info[i].capacity});
   }
 
   return {
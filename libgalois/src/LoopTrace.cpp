@@ -0,0 +1,177 @@
+#include "katana/LoopTrace.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+constexpr const char* kCountNames[] = {
+    "iterations",   "pushes",        "conflicts",
+    "local_steals", "remote_steals", "termination_us",
+};
+
+static_assert(std::size(kCountNames) == katana::LoopTrace::kNumCounts);
+
+/// Quote s as a JSON string
+std::string
+Quote(const char* s) {
+  std::string ret = "\"";
+  for (; *s; ++s) {
+    unsigned char c = *s;
+    if (c == '"' || c == '\\') {
+      ret += '\\';
+      ret += *s;
+    } else if (c < 0x20) {
+      ret += fmt::format("\\u{:04x}", c);
+    } else {
+      ret += *s;
+    }
+  }
+  ret += '"';
+  return ret;
+}
+
+uint64_t
+SteadyUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+katana::LoopTrace::LoopTrace(std::FILE* out, uint64_t start_us)
+    : out_(out),
+      start_us_(start_us),
+      pid_(getpid()),
+      threads_(GetThreadPool().getMaxThreads()) {}
+
+katana::LoopTrace*
+katana::LoopTrace::Get() {
+  // never destroyed: loops may still run while statics are destroyed
+  static LoopTrace* trace = []() -> LoopTrace* {
+    std::string path;
+    if (!katana::GetEnv("KATANA_LOOP_TRACE", &path) || path.empty()) {
+      return nullptr;
+    }
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+      KATANA_LOG_WARN(
+          "cannot open loop trace {}: {}", path, std::strerror(errno));
+      return nullptr;
+    }
+    std::fputs("[\n", out);
+    return new LoopTrace(out, SteadyUs());
+  }();
+  return trace;
+}
+
+uint64_t
+katana::LoopTrace::NowUs() const {
+  return SteadyUs() - start_us_;
+}
+
+uint64_t
+katana::LoopTrace::BeginLoop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (ThreadEvent& event : threads_) {
+    event.ran = false;
+  }
+  return NowUs();
+}
+
+void
+katana::LoopTrace::RecordThread(
+    uint64_t begin_us, const uint64_t* counts, uint32_t mask) {
+  // each thread writes only its own event, and EndLoop reads them after the
+  // thread pool has finished the loop
+  unsigned tid = ThreadPool::getMachineTID();
+  if (tid >= threads_.size()) {
+    return;
+  }
+  ThreadEvent& event = threads_[tid];
+  event.begin_us = begin_us;
+  event.end_us = NowUs();
+  std::copy(counts, counts + kNumCounts, event.counts);
+  event.mask = mask;
+  event.ran = true;
+}
+
+void
+katana::LoopTrace::EndLoop(
+    const char* loopname, const char* kind, uint64_t begin_us) {
+  uint64_t end_us = NowUs();
+  std::string name = Quote(loopname ? loopname : "(NULL)");
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  fmt::memory_buffer buf;
+  unsigned num_ran = 0;
+  uint64_t totals[kNumCounts]{};
+  uint32_t total_mask = 0;
+  for (unsigned tid = 0; tid < threads_.size(); ++tid) {
+    const ThreadEvent& event = threads_[tid];
+    if (!event.ran) {
+      continue;
+    }
+    ++num_ran;
+    if (tid >= named_threads_) {
+      for (unsigned t = named_threads_; t <= tid; ++t) {
+        fmt::format_to(
+            std::back_inserter(buf),
+            R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},)"
+            R"("args":{{"name":"thread {}"}}}},)"
+            "\n",
+            pid_, t, t);
+      }
+      named_threads_ = tid + 1;
+    }
+    fmt::format_to(
+        std::back_inserter(buf),
+        R"({{"name":{},"cat":"{}","ph":"X","ts":{},"dur":{},"pid":{},)"
+        R"("tid":{},"args":{{)",
+        name, kind, event.begin_us, event.end_us - event.begin_us, pid_, tid);
+    const char* sep = "";
+    for (int c = 0; c < kNumCounts; ++c) {
+      if (event.mask & (1U << c)) {
+        fmt::format_to(
+            std::back_inserter(buf), R"({}"{}":{})", sep, kCountNames[c],
+            event.counts[c]);
+        sep = ",";
+        totals[c] += event.counts[c];
+      }
+    }
+    total_mask |= event.mask;
+    fmt::format_to(std::back_inserter(buf), "}}}},\n");
+  }
+
+  // the whole loop goes on the calling thread's row, where it encloses that
+  // thread's own part
+  fmt::format_to(
+      std::back_inserter(buf),
+      R"({{"name":{},"cat":"{}","ph":"X","ts":{},"dur":{},"pid":{},)"
+      R"("tid":{},"args":{{"threads":{})",
+      name, kind, begin_us, end_us - begin_us, pid_,
+      ThreadPool::getMachineTID(), num_ran);
+  for (int c = 0; c < kNumCounts; ++c) {
+    if (total_mask & (1U << c)) {
+      fmt::format_to(
+          std::back_inserter(buf), R"(,"{}":{})", kCountNames[c], totals[c]);
+    }
+  }
+  fmt::format_to(std::back_inserter(buf), "}}}},\n");
+
+  std::fwrite(buf.data(), 1, buf.size(), out_);
+  std::fflush(out_);
+}
@@ -1,5 +1,6 @@
 #include "katana/MemoryPolicy.h"
 
+#include <algorithm>
 #include <fstream>
 #include <regex>
 
@@ -215,6 +216,57 @@ katana::MemoryPolicyMeek::MemoryPolicyMeek()
           .high_pressure_oom_threshold = 1100,
       }) {}
 
+//////////////////////////////////////////////////////////////////////
+// MemoryPolicyRSSCap
+bool
+katana::MemoryPolicyRSSCap::IsMemoryPressureHigh(count_t standby) const {
+  MemInfo mem_info;
+  UpdateMemInfo(&mem_info, standby);
+  if (mem_info.rss_bytes > high_used_ratio_threshold() * max_rss_bytes_) {
+    LogIt("memory pressure high", &mem_info);
+    return true;
+  }
+
+  return false;
+}
+
+count_t
+katana::MemoryPolicyRSSCap::ReclaimForMemoryPressure(count_t standby) const {
+  MemInfo mem_info;
+  UpdateMemInfo(&mem_info, standby);
+
+  if (mem_info.rss_bytes <= max_rss_bytes_) {
+    return 0;
+  }
+  count_t reclaim = std::min(standby, mem_info.rss_bytes - max_rss_bytes_);
+  LogIt(
+      fmt::format("reclaim for rss cap {} GB", katana::ToGB(reclaim)),
+      &mem_info);
+  return reclaim;
+}
+
+bool
+katana::MemoryPolicyRSSCap::KillSelfForLackOfMemory(count_t standby) const {
+  MemInfo mem_info;
+  UpdateMemInfo(&mem_info, standby);
+
+  if (mem_info.oom_score > kill_self_oom_threshold() ||
+      mem_info.used_ratio > kill_used_ratio_threshold()) {
+    LogIt("KILL SELF", &mem_info);
+    return true;
+  }
+  return false;
+}
+
+katana::MemoryPolicyRSSCap::MemoryPolicyRSSCap(count_t max_rss_bytes)
+    : MemoryPolicy({
+          .high_used_ratio_threshold = 0.9,
+          .kill_used_ratio_threshold = 0.95,
+          .kill_self_oom_threshold = 1280,
+          .high_pressure_oom_threshold = 1100,
+      }),
+      max_rss_bytes_(max_rss_bytes) {}
+
 //////////////////////////////////////////////////////////////////////
 // MemoryPolicyNull
 bool
@@ -2,8 +2,13 @@
 
 #include <fstream>
 
+#include <arrow/memory_pool.h>
+
 #include "katana/Cache.h"
 #include "katana/MemoryPolicy.h"
+#include "katana/NumaMem.h"
+#include "katana/PageAlloc.h"
+#include "katana/PagePool.h"
 #include "katana/PropertyManager.h"
 #include "katana/Time.h"
 
@@ -177,6 +182,15 @@ katana::MemorySupervisor::StandbyToActive(
 
 void
 katana::MemorySupervisor::CheckPressure() {
+  // Managers report what they moved to standby, which checks the pressure
+  // again
+  if (!refreshing_standby_) {
+    refreshing_standby_ = true;
+    for (auto& [name, info] : managers_) {
+      info.manager_->RefreshStandby();
+    }
+    refreshing_standby_ = false;
+  }
   count_t try_reclaim = policy_->ReclaimForMemoryPressure(standby_);
   ReclaimMemory(try_reclaim);
 }
@@ -188,6 +202,24 @@ katana::MemorySupervisor::SetPolicy(std::unique_ptr<MemoryPolicy> policy) {
   SanityCheck();
 }
 
+void
+katana::MemorySupervisor::RegisterManager(std::unique_ptr<Manager> manager) {
+  KATANA_LOG_DEBUG_ASSERT(manager);
+  const auto& name = manager->Name();
+  auto& info = managers_[name];
+  KATANA_LOG_VASSERT(!info.manager_, "manager {} already registered", name);
+  info.manager_ = std::move(manager);
+}
+
+katana::Manager*
+katana::MemorySupervisor::GetManager(const std::string& name) {
+  auto it = managers_.find(name);
+  if (it == managers_.end()) {
+    return nullptr;
+  }
+  return it->second.manager_.get();
+}
+
 katana::CacheStats
 katana::MemorySupervisor::GetPropertyCacheStats() const {
   auto name = PropertyManager::name_;
@@ -206,6 +238,38 @@ katana::MemorySupervisor::LogMemoryStats(const std::string& message) {
   policy_->LogMemoryStats(message, standby_);
 }
 
+std::map<std::string, count_t>
+katana::MemorySupervisor::GetMemoryBreakdown() const {
+  std::map<std::string, count_t> breakdown;
+  breakdown["rss"] = katana::ProgressTracer::ParseProcSelfRssBytes();
+  for (size_t i = 0; i < kNumMemoryCategories; ++i) {
+    auto category = static_cast<MemoryCategory>(i);
+    breakdown[fmt::format("large_alloc.{}", MemoryCategoryName(category))] =
+        LargeAllocationBytes(category);
+  }
+  breakdown["page_pool"] =
+      static_cast<count_t>(numPagePoolAllocTotal()) * allocSize();
+  PageAllocStats pages = GetPageAllocStats();
+  breakdown["pages.hugetlb"] = pages.hugetlb_bytes;
+  breakdown["pages.transparent"] = pages.transparent_bytes;
+  breakdown["pages.small"] = pages.small_bytes;
+  breakdown["arrow"] = arrow::default_memory_pool()->bytes_allocated();
+  for (const auto& [name, info] : managers_) {
+    breakdown["standby." + name] = info.standby;
+  }
+  return breakdown;
+}
+
+void
+katana::MemorySupervisor::LogMemoryBreakdown(const std::string& message) const {
+  auto breakdown = GetMemoryBreakdown();
+  katana::Tags tags;
+  for (const auto& [name, bytes] : breakdown) {
+    tags.emplace_back(name + "_gb", katana::ToGB(bytes));
+  }
+  katana::GetTracer().GetActiveSpan().Log(message, tags);
+}
+
 katana::PropertyManager*
 katana::MemorySupervisor::GetPropertyManager() {
   auto name = PropertyManager::name_;
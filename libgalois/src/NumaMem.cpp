@@ -19,8 +19,11 @@
 
 #include "katana/NumaMem.h"
 
+#include <atomic>
 #include <cassert>
+#include <utility>
 
+#include "katana/Logging.h"
 #include "katana/PageAlloc.h"
 #include "katana/ThreadPool.h"
 #include "katana/gIO.h"
@@ -135,6 +138,26 @@ pageInSpecified(
   }
 }
 
+namespace {
+
+thread_local katana::MemoryCategory current_category =
+    katana::MemoryCategory::kOther;
+
+std::atomic<int64_t> category_bytes[katana::kNumMemoryCategories];
+
+/// Charges the allocation \p data of \p bytes to the current category
+katana::LAptr
+MakeLAptr(void* data, size_t bytes) {
+  katana::MemoryCategory category = current_category;
+  // unique_ptr does not call its deleter on nullptr
+  if (data) {
+    category_bytes[static_cast<size_t>(category)] += bytes;
+  }
+  return katana::LAptr{data, katana::internal::largeFreer{bytes, category}};
+}
+
+}  // namespace
+
 static void
 largeFree(void* ptr, size_t bytes) {
   freePages(ptr, bytes / allocSize());
@@ -143,6 +166,41 @@ largeFree(void* ptr, size_t bytes) {
 void
 katana::internal::largeFreer::operator()(void* ptr) const {
   largeFree(ptr, bytes);
+  category_bytes[static_cast<size_t>(category)] -= bytes;
+}
+
+const char*
+katana::MemoryCategoryName(MemoryCategory category) {
+  switch (category) {
+  case MemoryCategory::kOther:
+    return "other";
+  case MemoryCategory::kTopology:
+    return "topology";
+  case MemoryCategory::kViewCache:
+    return "view_cache";
+  case MemoryCategory::kEntityTypeIDs:
+    return "entity_type_ids";
+  }
+  return "unknown";
+}
+
+katana::MemoryCategoryScope::MemoryCategoryScope(MemoryCategory category)
+    : previous_(current_category) {
+  current_category = category;
+}
+
+katana::MemoryCategoryScope::~MemoryCategoryScope() {
+  current_category = previous_;
+}
+
+katana::MemoryCategory
+katana::MemoryCategoryScope::Current() {
+  return current_category;
+}
+
+int64_t
+katana::LargeAllocationBytes(MemoryCategory category) {
+  return category_bytes[static_cast<size_t>(category)];
 }
 
 // round data to a multiple of mult
@@ -174,7 +232,7 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
     // true = round robin paging
     pageIn(data, bytes, allocSize(), numThreads, true);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return MakeLAptr(data, bytes);
 }
 
 LAptr
@@ -182,8 +240,7 @@ katana::largeMallocLocal(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), true), internal::largeFreer{bytes}};
+  return MakeLAptr(allocPages(bytes / allocSize(), true), bytes);
 }
 
 LAptr
@@ -191,8 +248,7 @@ katana::largeMallocFloating(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
+  return MakeLAptr(allocPages(bytes / allocSize(), false), bytes);
 }
 
 LAptr
@@ -204,7 +260,7 @@ katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
-  return LAptr{data, internal::largeFreer{bytes}};
+  return MakeLAptr(data, bytes);
 }
 
 /**
@@ -235,7 +291,7 @@ katana::largeMallocSpecified(
     pageInSpecified(
         data, bytes, allocSize(), numThreads, threadRanges, elementSize);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return MakeLAptr(data, bytes);
 }
 // Explicit template declarations since the template is defined in the .h
 // file
@@ -245,3 +301,64 @@ template LAptr katana::largeMallocSpecified<std::vector<uint32_t>>(
 template LAptr katana::largeMallocSpecified<std::vector<uint64_t>>(
     size_t bytes, uint32_t numThreads, std::vector<uint64_t>& threadRanges,
     size_t elementSize);
+
+katana::LargeReservation::LargeReservation(size_t max_bytes)
+    : reserved_bytes_(roundup(max_bytes, allocSize())),
+      category_(current_category) {
+  data_ = reservePages(reserved_bytes_ / allocSize());
+}
+
+katana::LargeReservation::~LargeReservation() { Release(); }
+
+katana::LargeReservation::LargeReservation(LargeReservation&& o) noexcept
+    : data_(o.data_),
+      reserved_bytes_(o.reserved_bytes_),
+      committed_bytes_(o.committed_bytes_),
+      category_(o.category_) {
+  o.data_ = nullptr;
+  o.reserved_bytes_ = 0;
+  o.committed_bytes_ = 0;
+}
+
+katana::LargeReservation&
+katana::LargeReservation::operator=(LargeReservation&& o) noexcept {
+  if (this != &o) {
+    Release();
+    std::swap(data_, o.data_);
+    std::swap(reserved_bytes_, o.reserved_bytes_);
+    std::swap(committed_bytes_, o.committed_bytes_);
+    std::swap(category_, o.category_);
+  }
+  return *this;
+}
+
+void
+katana::LargeReservation::Commit(size_t bytes, unsigned numThreads) {
+  bytes = roundup(bytes, allocSize());
+  if (bytes <= committed_bytes_) {
+    return;
+  }
+  KATANA_LOG_VASSERT(
+      bytes <= reserved_bytes_, "committing {} bytes of a {} byte reservation",
+      bytes, reserved_bytes_);
+
+  commitPages(data_, bytes / allocSize());
+  // true = round robin paging
+  pageIn(
+      static_cast<char*>(data_) + committed_bytes_, bytes - committed_bytes_,
+      allocSize(), numThreads, true);
+  category_bytes[static_cast<size_t>(category_)] += bytes - committed_bytes_;
+  committed_bytes_ = bytes;
+}
+
+void
+katana::LargeReservation::Release() {
+  if (!data_) {
+    return;
+  }
+  releasePages(data_, reserved_bytes_ / allocSize());
+  category_bytes[static_cast<size_t>(category_)] -= committed_bytes_;
+  data_ = nullptr;
+  reserved_bytes_ = 0;
+  committed_bytes_ = 0;
+}
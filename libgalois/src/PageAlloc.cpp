@@ -19,8 +19,12 @@
 
 #include "katana/PageAlloc.h"
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <unordered_map>
 
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/SimpleLock.h"
 
@@ -31,9 +35,41 @@
 
 // figure this out dynamically
 const size_t hugePageSize = 2 * 1024 * 1024;
+const size_t giganticPageSize = 1024 * 1024 * 1024;
 // protect mmap, munmap since linux has issues
 static katana::SimpleLock allocLock;
 
+namespace {
+
+enum class Backing { kHugetlb, kTransparent, kSmall };
+
+// bytes currently mapped, by backing
+std::atomic<size_t> backing_bytes[3];
+
+void
+CountMapped(Backing backing, size_t bytes) {
+  backing_bytes[static_cast<int>(backing)] += bytes;
+}
+
+void
+CountUnmapped(Backing backing, size_t bytes) {
+  backing_bytes[static_cast<int>(backing)] -= bytes;
+}
+
+// what a reservation is backed with, and how much of it
+struct Reservation {
+  Backing backing;
+  size_t committed_pages;
+};
+
+bool
+HugePagesDisabled() {
+  static bool disabled = katana::GetEnv("KATANA_DISABLE_HUGE_PAGES");
+  return disabled;
+}
+
+}  // namespace
+
 // mmap flags
 #if defined(MAP_ANONYMOUS)
 static const int _MAP_ANON = MAP_ANONYMOUS;
@@ -44,6 +80,11 @@ static_assert(false, "No Anonymous mapping");
 #endif
 
 static const int _MAP = _MAP_ANON | MAP_PRIVATE;
+#ifdef MAP_NORESERVE
+static const int _MAP_RESERVE = MAP_NORESERVE | _MAP;
+#else
+static const int _MAP_RESERVE = _MAP;
+#endif
 #ifdef MAP_POPULATE
 static const int _MAP_POP = MAP_POPULATE | _MAP;
 static const bool doHandMap = false;
@@ -64,6 +105,16 @@ katana::allocSize() {
   return hugePageSize;
 }
 
+katana::PageAllocStats
+katana::GetPageAllocStats() {
+  return PageAllocStats{
+      .hugetlb_bytes = backing_bytes[static_cast<int>(Backing::kHugetlb)],
+      .transparent_bytes =
+          backing_bytes[static_cast<int>(Backing::kTransparent)],
+      .small_bytes = backing_bytes[static_cast<int>(Backing::kSmall)],
+  };
+}
+
 #ifdef KATANA_USE_JEMALLOC
 
 void*
@@ -72,16 +123,21 @@ katana::allocPages(unsigned num, [[maybe_unused]] bool preFault) {
     return nullptr;
   }
   KATANA_DEBUG_WARN_ONCE("not using huge pages due to jemalloc");
+  CountMapped(Backing::kSmall, num * hugePageSize);
   return malloc(num * hugePageSize);
 }
 
 void
 katana::freePages(void* ptr, [[maybe_unused]] unsigned num) {
+  CountUnmapped(Backing::kSmall, num * hugePageSize);
   free(ptr);
 }
 
 #else
 
+// backing of each mapping, to count its bytes out when it is freed
+static std::unordered_map<void*, Backing> mappings;
+
 static void*
 trymmap(size_t size, int flag) {
   std::lock_guard<katana::SimpleLock> lg(allocLock);
@@ -93,29 +149,88 @@ trymmap(size_t size, int flag) {
   return ptr;
 }
 
+//! Map size bytes aligned to hugePageSize and ask for transparent huge
+//! pages. Without the alignment, the kernel can only use huge pages for the
+//! aligned middle of the mapping.
+static void*
+tryTransparentMmap(size_t size) {
+#ifdef MADV_HUGEPAGE
+  char* raw = static_cast<char*>(trymmap(size + hugePageSize, _MAP));
+  if (!raw) {
+    return nullptr;
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+  size_t head = (hugePageSize - addr % hugePageSize) % hugePageSize;
+  size_t tail = hugePageSize - head;
+
+  std::lock_guard<katana::SimpleLock> lg(allocLock);
+  if (head) {
+    munmap(raw, head);
+  }
+  munmap(raw + head + size, tail);
+  void* ptr = raw + head;
+  // not fatal: the pages are merely small
+  if (madvise(ptr, size, MADV_HUGEPAGE) != 0) {
+    KATANA_DEBUG_WARN_ONCE("madvise(MADV_HUGEPAGE) failed: {}", errno);
+  }
+  return ptr;
+#else
+  (void)size;
+  return nullptr;
+#endif
+}
+
 void*
 katana::allocPages(unsigned num, bool preFault) {
   if (num == 0) {
     return nullptr;
   }
 
-  void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  const size_t size = num * hugePageSize;
+  void* ptr = nullptr;
+  Backing backing = Backing::kHugetlb;
+  bool populated = preFault;
+
+  if (!HugePagesDisabled()) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+    if (size % giganticPageSize == 0) {
+      ptr = trymmap(
+          size, (preFault ? _MAP_HUGE_POP : _MAP_HUGE) | MAP_HUGE_1GB);
+    }
+#endif
+    if (!ptr) {
+      ptr = trymmap(size, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    }
+    if (!ptr) {
+      KATANA_DEBUG_WARN_ONCE(
+          "huge page alloc failed, falling back to transparent huge pages");
+      backing = Backing::kTransparent;
+      // fault in after madvise so that faults can take huge pages
+      ptr = tryTransparentMmap(size);
+      populated = false;
+    }
+  }
+
   if (!ptr) {
-    KATANA_DEBUG_WARN_ONCE(
-        "huge page alloc failed, falling back to regular pages");
-    ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+    backing = Backing::kSmall;
+    ptr = trymmap(size, preFault ? _MAP_POP : _MAP);
+    populated = preFault;
   }
 
   if (!ptr) {
     KATANA_LOG_FATAL("failed to allocate: {}", errno);
   }
 
-  if (preFault && doHandMap) {
-    for (size_t x = 0; x < num * hugePageSize; x += 4096) {
+  if (preFault && (doHandMap || !populated)) {
+    for (size_t x = 0; x < size; x += 4096) {
       static_cast<char*>(ptr)[x] = 0;
     }
   }
 
+  CountMapped(backing, size);
+  std::lock_guard<SimpleLock> lg(allocLock);
+  mappings[ptr] = backing;
+
   return ptr;
 }
 
@@ -125,5 +240,80 @@ katana::freePages(void* ptr, unsigned num) {
   if (munmap(ptr, num * hugePageSize) != 0) {
     KATANA_LOG_FATAL("munmap failed: {}", errno);
   }
+  auto it = mappings.find(ptr);
+  if (it != mappings.end()) {
+    CountUnmapped(it->second, num * hugePageSize);
+    mappings.erase(it);
+  }
 }
 #endif
+
+// reservations by address, to find how much of them is committed
+static std::unordered_map<void*, Reservation> reservations;
+
+void*
+katana::reservePages(size_t num) {
+  if (num == 0) {
+    return nullptr;
+  }
+
+  // aligned to hugePageSize, as in tryTransparentMmap, so that committed
+  // pages can be huge
+  const size_t size = num * hugePageSize;
+  std::lock_guard<SimpleLock> lg(allocLock);
+  void* raw = mmap(0, size + hugePageSize, PROT_NONE, _MAP_RESERVE, -1, 0);
+  if (raw == MAP_FAILED) {
+    KATANA_LOG_FATAL("failed to reserve: {}", errno);
+  }
+  char* begin = static_cast<char*>(raw);
+  uintptr_t addr = reinterpret_cast<uintptr_t>(begin);
+  size_t head = (hugePageSize - addr % hugePageSize) % hugePageSize;
+  if (head) {
+    munmap(begin, head);
+  }
+  munmap(begin + head + size, hugePageSize - head);
+  void* ptr = begin + head;
+
+  Backing backing = Backing::kSmall;
+#ifdef MADV_HUGEPAGE
+  if (!HugePagesDisabled() && madvise(ptr, size, MADV_HUGEPAGE) == 0) {
+    backing = Backing::kTransparent;
+  }
+#endif
+  reservations[ptr] = Reservation{backing, 0};
+  return ptr;
+}
+
+void
+katana::commitPages(void* ptr, size_t num) {
+  std::lock_guard<SimpleLock> lg(allocLock);
+  auto it = reservations.find(ptr);
+  KATANA_LOG_ASSERT(it != reservations.end());
+  Reservation& reservation = it->second;
+  if (num <= reservation.committed_pages) {
+    return;
+  }
+
+  char* begin =
+      static_cast<char*>(ptr) + reservation.committed_pages * hugePageSize;
+  const size_t size = (num - reservation.committed_pages) * hugePageSize;
+  if (mprotect(begin, size, PROT_READ | PROT_WRITE) != 0) {
+    KATANA_LOG_FATAL("failed to commit: {}", errno);
+  }
+  CountMapped(reservation.backing, size);
+  reservation.committed_pages = num;
+}
+
+void
+katana::releasePages(void* ptr, size_t num) {
+  std::lock_guard<SimpleLock> lg(allocLock);
+  if (munmap(ptr, num * hugePageSize) != 0) {
+    KATANA_LOG_FATAL("munmap failed: {}", errno);
+  }
+  auto it = reservations.find(ptr);
+  if (it != reservations.end()) {
+    CountUnmapped(
+        it->second.backing, it->second.committed_pages * hugePageSize);
+    reservations.erase(it);
+  }
+}
@@ -31,7 +31,8 @@ katana::internal::setPagePoolState(PageAllocState<>* pa) {
 
 int
 katana::numPagePoolAllocTotal() {
-  return PA->countAll();
+  // There is no pool before the runtime starts
+  return PA ? PA->countAll() : 0;
 }
 
 int
@@ -53,7 +54,7 @@ katana::pagePoolPreAlloc(unsigned num) {
 
 void
 katana::pagePoolEnsurePreallocated(unsigned num) {
-  auto tid = katana::ThreadPool::getTID();
+  auto tid = katana::ThreadPool::getMachineTID();
   while (PA->freeCount(tid) < num) {
     PA->pagePreAlloc();
   }
@@ -17,10 +17,17 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <ctime>
 
+#include <nlohmann/json.hpp>
+
 #include "katana/Env.h"
 #include "katana/Executor_ParaMeter.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
 #include "katana/gIO.h"
 
 struct StatsFileManager {
@@ -98,3 +105,96 @@ void
 katana::parameter::closeStatsFile(void) {
   getStatsFileManager().close();
 }
+
+katana::parameter::Report::Report(std::string path) : path_(std::move(path)) {}
+
+katana::parameter::Report*
+katana::parameter::Report::Get() {
+  // never destroyed: loops may still run while statics are destroyed
+  static Report* report = []() -> Report* {
+    std::string path;
+    if (!katana::GetEnv("KATANA_PARAMETER_REPORT", &path) || path.empty()) {
+      return nullptr;
+    }
+    return new Report(std::move(path));
+  }();
+  return report;
+}
+
+void
+katana::parameter::Report::AddRun(
+    const char* loopname, const std::vector<Round>& rounds) {
+  std::string name = loopname ? loopname : "(NULL)";
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] = loop_indices_.emplace(name, loops_.size());
+  if (inserted) {
+    loops_.emplace_back();
+    loops_.back().name = name;
+  }
+  LoopProfile& loop = loops_[it->second];
+
+  loop.runs += 1;
+  loop.critical_path += rounds.size();
+  loop.longest_critical_path =
+      std::max<uint64_t>(loop.longest_critical_path, rounds.size());
+  if (loop.rounds.size() < rounds.size()) {
+    loop.rounds.resize(rounds.size(), Round{0, 0, 0});
+  }
+  for (size_t i = 0; i < rounds.size(); ++i) {
+    loop.work += rounds[i].parallelism;
+    loop.max_parallelism =
+        std::max(loop.max_parallelism, rounds[i].parallelism);
+    loop.rounds[i].parallelism += rounds[i].parallelism;
+    loop.rounds[i].worklist_size += rounds[i].worklist_size;
+    loop.rounds[i].neighborhood_size += rounds[i].neighborhood_size;
+  }
+
+  Write();
+}
+
+void
+katana::parameter::Report::Write() {
+  nlohmann::ordered_json loops = nlohmann::ordered_json::array();
+  for (const LoopProfile& loop : loops_) {
+    nlohmann::ordered_json rounds = nlohmann::ordered_json::array();
+    for (const Round& round : loop.rounds) {
+      rounds.push_back({
+          {"parallelism", round.parallelism},
+          {"worklist_size", round.worklist_size},
+          {"neighborhood_size", round.neighborhood_size},
+      });
+    }
+    // the work over the critical path is the speedup an ideal machine with
+    // unbounded threads would get
+    double average_parallelism =
+        loop.critical_path == 0
+            ? 0
+            : static_cast<double>(loop.work) / loop.critical_path;
+    loops.push_back({
+        {"name", loop.name},
+        {"runs", loop.runs},
+        {"work", loop.work},
+        {"critical_path", loop.critical_path},
+        {"longest_critical_path", loop.longest_critical_path},
+        {"average_parallelism", average_parallelism},
+        {"max_parallelism", loop.max_parallelism},
+        {"rounds", std::move(rounds)},
+    });
+  }
+
+  auto dump = katana::JsonDump(nlohmann::ordered_json{{"loops", loops}});
+  if (!dump) {
+    KATANA_LOG_WARN("cannot write ParaMeter report: {}", dump.error());
+    return;
+  }
+  std::FILE* out = std::fopen(path_.c_str(), "w");
+  if (!out) {
+    KATANA_LOG_WARN(
+        "cannot open ParaMeter report {}: {}", path_, std::strerror(errno));
+    return;
+  }
+  std::fwrite(dump.value().data(), 1, dump.value().size(), out);
+  std::fputc('\n', out);
+  std::fclose(out);
+}
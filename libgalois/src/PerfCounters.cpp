@@ -0,0 +1,237 @@
+#include "katana/PerfCounters.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#include "katana/Env.h"
+#include "katana/Executor_OnEach.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr const char* kStatNames[] = {
+    "Cycles",
+    "Instructions",
+    "LLCMisses",
+    "RemoteDRAMAccesses",
+};
+
+constexpr const char* kTagNames[] = {
+    "cycles",
+    "instructions",
+    "llc_misses",
+    "remote_dram_accesses",
+};
+
+static_assert(
+    std::size(kStatNames) == katana::PerfCounters::kNumEvents &&
+    std::size(kTagNames) == katana::PerfCounters::kNumEvents);
+
+#ifdef __linux__
+
+/// Open a counter of event for the calling thread
+int
+OpenEvent(katana::PerfCounters::Event event) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  constexpr uint64_t kReadMiss = PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                                 PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+  switch (event) {
+  case katana::PerfCounters::kCycles:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case katana::PerfCounters::kInstructions:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case katana::PerfCounters::kLLCMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_LL | kReadMiss;
+    break;
+  case katana::PerfCounters::kRemoteDRAMAccesses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_NODE | kReadMiss;
+    break;
+  default:
+    return -1;
+  }
+
+  return syscall(
+      __NR_perf_event_open, &attr, /* this thread */ 0, /* any cpu */ -1,
+      /* no group */ -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+/// \returns the count of fd, scaled up for the time the counter was not
+/// scheduled
+uint64_t
+ReadEvent(int fd) {
+  uint64_t buf[3];  // value, time enabled, time running
+  if (read(fd, buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0) {
+    return 0;
+  }
+  if (buf[1] == buf[2]) {
+    return buf[0];
+  }
+  return static_cast<uint64_t>(
+      static_cast<double>(buf[0]) * static_cast<double>(buf[1]) /
+      static_cast<double>(buf[2]));
+}
+
+#else
+
+int
+OpenEvent(katana::PerfCounters::Event) {
+  errno = ENOSYS;
+  return -1;
+}
+
+uint64_t
+ReadEvent(int) {
+  return 0;
+}
+
+#endif
+
+}  // namespace
+
+katana::PerfCounters*
+katana::PerfCounters::Get() {
+  // never destroyed: loops may still run while statics are destroyed
+  static PerfCounters* counters = []() -> PerfCounters* {
+    bool enabled = false;
+    katana::GetEnv("KATANA_PERF_COUNTERS", &enabled);
+    return enabled ? new PerfCounters() : nullptr;
+  }();
+  return counters;
+}
+
+const char*
+katana::PerfCounters::StatName(Event event) {
+  return kStatNames[event];
+}
+
+const char*
+katana::PerfCounters::TagName(Event event) {
+  return kTagNames[event];
+}
+
+void
+katana::PerfCounters::OpenThreads(unsigned num_threads) {
+  unsigned opened = fds_.size();
+  if (opened >= num_threads) {
+    return;
+  }
+  std::array<int, kNumEvents> none;
+  none.fill(-1);
+  fds_.resize(num_threads, none);
+
+  // counters count the thread that opens them
+  std::vector<int> errors(num_threads, 0);
+  on_each_gen(
+      [&](unsigned tid, unsigned) {
+        if (tid < opened) {
+          return;
+        }
+        for (int e = 0; e < kNumEvents; ++e) {
+          int fd = OpenEvent(static_cast<Event>(e));
+          if (fd < 0) {
+            errors[tid] = errno;
+          }
+          fds_[tid][e] = fd;
+        }
+      },
+      std::make_tuple());
+
+  for (unsigned tid = opened; tid < num_threads; ++tid) {
+    if (errors[tid] != 0 && !warned_) {
+      KATANA_LOG_WARN(
+          "some hardware counters are unavailable: {}",
+          std::strerror(errors[tid]));
+      warned_ = true;
+    }
+  }
+}
+
+void
+katana::PerfCounters::Read(std::vector<Counts>* counts) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  unsigned num_threads = katana::getActiveThreads();
+  OpenThreads(num_threads);
+
+  counts->resize(num_threads);
+  for (unsigned tid = 0; tid < num_threads; ++tid) {
+    for (int e = 0; e < kNumEvents; ++e) {
+      int fd = fds_[tid][e];
+      (*counts)[tid][e] = fd >= 0 ? ReadEvent(fd) : 0;
+    }
+  }
+}
+
+void
+katana::PerfCounters::Report(
+    const char* region, const std::vector<Counts>& begin,
+    const std::vector<Counts>& end) {
+  region = region ? region : "(NULL)";
+  unsigned num_threads = std::min(begin.size(), end.size());
+  std::vector<Counts> deltas(num_threads);
+  Counts totals{};
+  for (unsigned tid = 0; tid < num_threads; ++tid) {
+    for (int e = 0; e < kNumEvents; ++e) {
+      // scaled counts can step back slightly
+      uint64_t delta =
+          end[tid][e] > begin[tid][e] ? end[tid][e] - begin[tid][e] : 0;
+      deltas[tid][e] = delta;
+      totals[e] += delta;
+    }
+  }
+
+  // report from each thread so that per-thread values are kept
+  on_each_gen(
+      [&](unsigned tid, unsigned) {
+        if (tid >= num_threads) {
+          return;
+        }
+        for (int e = 0; e < kNumEvents; ++e) {
+          if (IsCounting(tid, static_cast<Event>(e))) {
+            katana::ReportStatSum(region, kStatNames[e], deltas[tid][e]);
+          }
+        }
+      },
+      std::make_tuple());
+
+  ProgressTracer& tracer = ProgressTracer::Get();
+  if (!tracer.HasActiveSpan()) {
+    return;
+  }
+  Tags tags{{"region", region}};
+  for (int e = 0; e < kNumEvents; ++e) {
+    if (IsCounting(0, static_cast<Event>(e))) {
+      tags.emplace_back(kTagNames[e], totals[e]);
+    }
+  }
+  tracer.GetActiveSpan().Log("hardware counters", tags);
+}
+
+bool
+katana::PerfCounters::IsCounting(unsigned tid, Event event) const {
+  return tid < fds_.size() && fds_[tid][event] >= 0;
+}
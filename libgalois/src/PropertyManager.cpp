@@ -15,7 +15,7 @@ katana::PropertyManager::MakePropertyCache() {
   KATANA_LOG_DEBUG_ASSERT(!cache_);
   auto scope = katana::GetTracer().StartActiveSpan("create property cache");
 
-  cache_ = std::make_unique<katana::PropertyCache>(
+  cache_ = std::make_unique<katana::ShardedPropertyCache>(
       [](const std::shared_ptr<arrow::Table>& table) {
         return ApproxTableMemUse(table);
       });
@@ -0,0 +1,81 @@
+#include "katana/Reduction.h"
+
+void
+katana::internal::ExactSum::Normalize() {
+  int64_t carry = 0;
+  for (unsigned i = 0; i + 1 < kNumLimbs; ++i) {
+    int64_t v = limbs_[i] + carry;
+    // arithmetic shift, so negative limbs borrow from the next one
+    carry = v >> kLimbBits;
+    limbs_[i] = v & kLimbMask;
+  }
+  limbs_[kNumLimbs - 1] += carry;
+  pending_ = 0;
+}
+
+katana::internal::ExactSum&
+katana::internal::ExactSum::Merge(const ExactSum& other) {
+  special_ += other.special_;
+  for (unsigned i = 0; i < kNumLimbs; ++i) {
+    limbs_[i] += other.limbs_[i];
+  }
+  // neither sum may be normalized
+  pending_ += other.pending_ + 2;
+  if (pending_ >= kMaxPending) {
+    Normalize();
+  }
+  return *this;
+}
+
+double
+katana::internal::ExactSum::Value() const {
+  if (!std::isfinite(special_)) {
+    return special_;
+  }
+
+  ExactSum sum = *this;
+  sum.Normalize();
+  bool negative = sum.limbs_[kNumLimbs - 1] < 0;
+  if (negative) {
+    for (int64_t& limb : sum.limbs_) {
+      limb = -limb;
+    }
+    sum.Normalize();
+  }
+
+  int high = kNumLimbs - 1;
+  while (high >= 0 && sum.limbs_[high] == 0) {
+    --high;
+  }
+  if (high < 0) {
+    return 0;
+  }
+
+  // Round the top 64 bits of the magnitude to a double, with the bits below
+  // them folded into the lowest bit so that the conversion rounds to nearest.
+  auto limb = [&sum](int i) -> uint64_t {
+    return i >= 0 ? static_cast<uint64_t>(sum.limbs_[i]) : 0;
+  };
+  uint64_t w2 = limb(high);
+  uint64_t w1 = limb(high - 1);
+  uint64_t w0 = limb(high - 2);
+  bool sticky = false;
+  for (int i = 0; i < high - 2; ++i) {
+    sticky |= sum.limbs_[i] != 0;
+  }
+  int lz = __builtin_clzll(w2) - kLimbBits;
+  uint64_t top = ((w2 << kLimbBits) | w1) << lz;
+  if (lz > 0) {
+    top |= w0 >> (kLimbBits - lz);
+    sticky |= (w0 & ((uint64_t{1} << (kLimbBits - lz)) - 1)) != 0;
+  } else {
+    sticky |= w0 != 0;
+  }
+  top |= sticky;
+
+  // top is the magnitude times 2^(lz - 32 - 32 * (high - 2) + 1074)
+  double magnitude = std::ldexp(
+      static_cast<double>(top),
+      static_cast<int>(kLimbBits) * (high - 1) - lz - 1074);
+  return negative ? -magnitude : magnitude;
+}
@@ -0,0 +1,119 @@
+#include "katana/SpillingChunk.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+
+namespace {
+
+std::string
+SpillDir() {
+  std::string dir;
+  if (katana::GetEnv("KATANA_SPILL_DIR", &dir) && !dir.empty()) {
+    return dir;
+  }
+  if (katana::GetEnv("TMPDIR", &dir) && !dir.empty()) {
+    return dir;
+  }
+  return "/tmp";
+}
+
+}  // namespace
+
+katana::internal::SpillFile::~SpillFile() {
+  if (fd_ >= 0 && close(fd_) != 0) {
+    KATANA_LOG_WARN("closing spill file: {}", std::strerror(errno));
+  }
+}
+
+void
+katana::internal::SpillFile::Write(const void* record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ < 0) {
+    std::string path_template = SpillDir() + "/katana-spill-XXXXXX";
+    std::vector<char> path(path_template.begin(), path_template.end());
+    path.emplace_back('\0');
+    fd_ = mkstemp(path.data());
+    if (fd_ < 0) {
+      KATANA_LOG_FATAL(
+          "cannot create spill file {}: {}", path_template,
+          std::strerror(errno));
+    }
+    if (unlink(path.data()) != 0) {
+      KATANA_LOG_WARN(
+          "cannot unlink spill file {}: {}", path.data(), std::strerror(errno));
+    }
+  }
+
+  const char* buf = static_cast<const char*>(record);
+  size_t done = 0;
+  while (done < record_size_) {
+    ssize_t n =
+        pwrite(fd_, buf + done, record_size_ - done, write_offset_ + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      KATANA_LOG_FATAL("writing spill file: {}", std::strerror(errno));
+    }
+    done += n;
+  }
+  write_offset_ += record_size_;
+  num_records_.fetch_add(1);
+}
+
+bool
+katana::internal::SpillFile::Read(void* record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (read_offset_ == write_offset_) {
+    return false;
+  }
+
+  char* buf = static_cast<char*>(record);
+  size_t done = 0;
+  while (done < record_size_) {
+    ssize_t n =
+        pread(fd_, buf + done, record_size_ - done, read_offset_ + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      KATANA_LOG_FATAL(
+          "reading spill file: {}",
+          n == 0 ? "unexpected end of file" : std::strerror(errno));
+    }
+    done += n;
+  }
+  read_offset_ += record_size_;
+  num_records_.fetch_sub(1);
+
+  if (read_offset_ == write_offset_) {
+    // everything written has been read, give the storage back
+    read_offset_ = 0;
+    write_offset_ = 0;
+    if (ftruncate(fd_, 0) != 0) {
+      KATANA_LOG_WARN("truncating spill file: {}", std::strerror(errno));
+    }
+  }
+  return true;
+}
+
+size_t
+katana::internal::DefaultSpillBudget() {
+  int budget_mb = 0;
+  if (katana::GetEnv("KATANA_WORKLIST_SPILL_BUDGET_MB", &budget_mb) &&
+      budget_mb > 0) {
+    return static_cast<size_t>(budget_mb) << 20;
+  }
+  return katana::MemorySupervisor::GetTotalSystemMemory() / 4;
+}
@@ -29,6 +29,7 @@
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Logging.h"
+#include "katana/PageAlloc.h"
 #include "katana/PerThreadStorage.h"
 
 namespace {
@@ -300,6 +301,13 @@ katana::reportPageAlloc(const char* category) {
         ReportStatSum("PageAlloc", category, numPagePoolAllocForThread(tid));
       },
       std::make_tuple());
+
+  PageAllocStats stats = GetPageAllocStats();
+  std::string prefix(category);
+  ReportStatSingle("PageAlloc", prefix + "HugetlbBytes", stats.hugetlb_bytes);
+  ReportStatSingle(
+      "PageAlloc", prefix + "TransparentHugeBytes", stats.transparent_bytes);
+  ReportStatSingle("PageAlloc", prefix + "SmallPageBytes", stats.small_bytes);
 }
 
 void
@@ -0,0 +1,82 @@
+#include "katana/ThreadGroup.h"
+
+#include <algorithm>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+
+katana::Result<std::unique_ptr<katana::ThreadGroup>>
+katana::ThreadGroup::Make(unsigned num_threads) {
+  auto& tp = GetThreadPool();
+  if (Current()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "cannot make a thread group in a group");
+  }
+  if (tp.root.running) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot make a thread group during a parallel loop");
+  }
+  if (num_threads == 0 || num_threads >= tp.getMaxUsableThreads()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "thread group of {} threads needs between 1 and {} threads",
+        num_threads, tp.getMaxUsableThreads() - 1);
+  }
+  return std::unique_ptr<ThreadGroup>(new ThreadGroup(num_threads));
+}
+
+katana::ThreadGroup::ThreadGroup(unsigned num_threads)
+    : group_(GetThreadPool().reserveGroup(num_threads, this)),
+      term_(CreateTerminationDetection()) {}
+
+katana::ThreadGroup::~ThreadGroup() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  GetThreadPool().releaseGroup(group_);
+}
+
+katana::ThreadGroup::Caller
+katana::ThreadGroup::Enter() {
+  Caller caller{GetThreadPool().enterGroup(group_), ptsBase, pssBase};
+  ptsBase = static_cast<char*>(getPTSBackend().getRemote(group_->first, 0));
+  pssBase = static_cast<char*>(getPPSBackend().getRemote(group_->first, 0));
+  return caller;
+}
+
+void
+katana::ThreadGroup::Leave(const Caller& caller) {
+  GetThreadPool().enterGroup(caller.group);
+  ptsBase = caller.pts_base;
+  pssBase = caller.pss_base;
+}
+
+void
+katana::ThreadGroup::Run(const std::function<void()>& fn) {
+  if (Current() == this) {
+    fn();
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  Caller caller = Enter();
+  try {
+    fn();
+  } catch (...) {
+    Leave(caller);
+    throw;
+  }
+  Leave(caller);
+}
+
+katana::Barrier&
+katana::ThreadGroup::GetGroupBarrier(unsigned active_threads) {
+  active_threads = std::clamp(active_threads, 1U, size());
+  if (!barrier_) {
+    barrier_ = CreateBarrier(active_threads);
+    barrier_threads_ = active_threads;
+  } else if (active_threads != barrier_threads_) {
+    barrier_threads_ = active_threads;
+    barrier_->Reinit(barrier_threads_);
+  }
+  return *barrier_;
+}
@@ -20,7 +20,15 @@
 #include "katana/ThreadPool.h"
 
 #include <algorithm>
+#include <climits>
 #include <iostream>
+#include <map>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
@@ -38,12 +46,109 @@ using katana::ThreadPool;
 
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
+namespace {
+
+/// pause loop iterations between reads of the clock while spinning
+constexpr unsigned kSpinsPerClockRead = 64;
+
+std::chrono::nanoseconds
+DefaultSpinBeforePark() {
+  int spin_us = 0;
+  katana::GetEnv("KATANA_THREAD_SPIN_US", &spin_us);
+  return std::chrono::microseconds(std::max(spin_us, 0));
+}
+
+}  // namespace
+
+void
+ThreadPool::Group::Init(
+    const std::vector<ThreadTopoInfo>& machine, unsigned first_thread,
+    unsigned num) {
+  first = first_thread;
+  size = num;
+  activeThreads = std::min(activeThreads, num);
+  topo.resize(num);
+  capacityPrefix.assign(num + 1, 0);
+
+  // sockets are numbered in the order in which the threads of the group
+  // reach them
+  std::map<unsigned, unsigned> sockets;
+  std::vector<unsigned> leaders;
+  unsigned max_socket = 0;
+  for (unsigned i = 0; i < num; ++i) {
+    const ThreadTopoInfo& t = machine[first + i];
+    auto [it, inserted] = sockets.emplace(t.socket, sockets.size());
+    if (inserted) {
+      leaders.emplace_back(i);
+    }
+    max_socket = std::max(max_socket, it->second);
+
+    topo[i] = t;
+    topo[i].tid = i;
+    topo[i].socket = it->second;
+    topo[i].socketLeader = leaders[it->second];
+    topo[i].cumulativeMaxSocket = max_socket;
+    capacityPrefix[i + 1] = capacityPrefix[i] + t.capacity;
+  }
+  maxSockets = sockets.size();
+}
+
+void
+ThreadPool::per_signal::wakeup() {
+  // The waker sets released before it reads parked, and a waiter sets
+  // parked before it reads released for the last time, so either the waker
+  // sees the waiter or the waiter sees the release.
+  done = 0;
+  released.store(1);
+  if (!parked.load()) {
+    return;
+  }
+#ifdef __linux__
+  syscall(
+      SYS_futex, reinterpret_cast<int*>(&released), FUTEX_WAKE_PRIVATE, 1,
+      nullptr, nullptr, 0);
+#else
+  std::lock_guard<std::mutex> lg(m);
+  cv.notify_one();
+#endif
+}
+
+void
+ThreadPool::per_signal::wait(std::chrono::nanoseconds spin) {
+  auto deadline = std::chrono::steady_clock::now() + spin;
+  for (unsigned i = 1;
+       spin.count() != 0 && !released.load(std::memory_order_acquire); ++i) {
+    asmPause();
+    if (spin.count() >= 0 && i % kSpinsPerClockRead == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+  }
+
+  if (!released.load(std::memory_order_acquire)) {
+    parked.store(1);
+#ifdef __linux__
+    while (!released.load()) {
+      syscall(
+          SYS_futex, reinterpret_cast<int*>(&released), FUTEX_WAIT_PRIVATE, 0,
+          nullptr, nullptr, 0);
+    }
+#else
+    std::unique_lock<std::mutex> lg(m);
+    cv.wait(lg, [this] { return released.load() != 0; });
+#endif
+    parked.store(0);
+  }
+  released.store(0, std::memory_order_relaxed);
+}
+
 ThreadPool::ThreadPool()
     : mi(getHWTopo().machineTopoInfo),
       reserved(0),
       masterFastmode(0),
-      running(false) {
+      spinBeforePark(DefaultSpinBeforePark().count()) {
   signals.resize(mi.maxThreads);
+  root.Init(getHWTopo().threadTopoInfo, 0, mi.maxThreads);
   initThread(0);
 
   for (unsigned i = 1; i < mi.maxThreads; ++i) {
@@ -74,6 +179,10 @@ ThreadPool::destroyCommon() {
 
 void
 ThreadPool::burnPower(unsigned num) {
+  // only the threads of the whole pool spin
+  if (group().owner) {
+    return;
+  }
   num = std::min(num, getMaxUsableThreads());
 
   // changing number of threads?  just do a reset
@@ -88,7 +197,7 @@ ThreadPool::burnPower(unsigned num) {
 
 void
 ThreadPool::beKind() {
-  if (masterFastmode) {
+  if (masterFastmode && !group().owner) {
     run(masterFastmode, []() { throw fastmode_ty{false}; });
     masterFastmode = 0;
   }
@@ -129,7 +238,10 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.released = 0;
+  my_box.parked = 0;
+  my_box.topo = root.topo[tid];
+  my_box.group = &root;
   // Initialize
   initPTS(mi.maxThreads);
 
@@ -158,10 +270,11 @@ ThreadPool::threadLoop(unsigned tid) {
   bool fastmode = false;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
-    cascade(fastmode);
+    // threads in fastmode spin until they are woken
+    me.wait(fastmode ? std::chrono::nanoseconds(-1) : GetSpinBeforePark());
+    cascade();
     try {
-      work();
+      me.group->work();
     } catch (const shutdown_ty&) {
       return;
     } catch (const fastmode_ty& fm) {
@@ -186,13 +299,14 @@ ThreadPool::decascade() {
   auto& me = my_box;
   // nothing to wake up
   if (me.wbegin != me.wend) {
+    unsigned first = me.group->first;
     auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
-    auto& c1done = signals[me.wbegin]->done;
+    auto& c1done = signals[first + me.wbegin]->done;
     while (!c1done) {
       asmPause();
     }
     if (midpoint < me.wend) {
-      auto& c2done = signals[midpoint]->done;
+      auto& c2done = signals[first + midpoint]->done;
       while (!c2done) {
         asmPause();
       }
@@ -202,7 +316,7 @@ ThreadPool::decascade() {
 }
 
 void
-ThreadPool::cascade(bool fastmode) {
+ThreadPool::cascade() {
   auto& me = my_box;
   KATANA_LOG_DEBUG_ASSERT(me.wbegin <= me.wend);
 
@@ -211,18 +325,24 @@ ThreadPool::cascade(bool fastmode) {
     return;
   }
 
+  // ids of wbegin and wend are relative to the group
+  Group* g = me.group;
   auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
 
-  auto* child1 = signals[me.wbegin];
+  auto* child1 = signals[g->first + me.wbegin];
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
-  child1->wakeup(fastmode);
+  child1->group = g;
+  child1->topo = g->topo[me.wbegin];
+  child1->wakeup();
 
   if (midpoint < me.wend) {
-    auto* child2 = signals[midpoint];
+    auto* child2 = signals[g->first + midpoint];
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
-    child2->wakeup(fastmode);
+    child2->group = g;
+    child2->topo = g->topo[midpoint];
+    child2->wakeup();
   }
 }
 
@@ -230,22 +350,24 @@ void
 ThreadPool::runInternal(unsigned num) {
   // sanitize num
   // seq write to starting should make work safe
-  KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
-  running = true;
+  Group& g = group();
+  g.running = true;
   num = std::min(std::max(1U, num), getMaxUsableThreads());
   // my_box is tid 0
   auto& me = my_box;
+  // threads outside of the pool run loops of the whole pool as its thread 0
+  me.group = &g;
   me.wbegin = 1;
   me.wend = num;
 
   KATANA_LOG_VASSERT(
-      !masterFastmode || masterFastmode == num,
+      g.owner || !masterFastmode || masterFastmode == num,
       "fastmode threads {} != num threads {}", masterFastmode, num);
   // launch threads
-  cascade(masterFastmode);
+  cascade();
   // Do master thread work
   try {
-    work();
+    g.work();
   } catch (const shutdown_ty&) {
     return;
   } catch (const fastmode_ty& fm) {
@@ -253,30 +375,69 @@ ThreadPool::runInternal(unsigned num) {
   // wait for children
   decascade();
   // Clean up
-  work = nullptr;
-  running = false;
+  g.work = nullptr;
+  g.running = false;
+}
+
+ThreadPool::Group*
+ThreadPool::reserveGroup(unsigned num, ThreadGroup* owner) {
+  KATANA_LOG_VASSERT(
+      !root.running, "Can't reserve threads during parallel section");
+  KATANA_LOG_VASSERT(
+      num > 0 && num < getMaxUsableThreads(), "Too many threads for group");
+  // fastmode threads may be among the reserved ones
+  beKind();
+
+  auto* g = new Group;
+  g->activeThreads = num;
+  g->Init(root.topo, mi.maxThreads - reserved - num, num);
+  g->owner = owner;
+  reserved += num;
+  root.activeThreads = std::min(root.activeThreads, getMaxUsableThreads());
+  return g;
+}
+
+void
+ThreadPool::releaseGroup(Group* g) {
+  KATANA_LOG_VASSERT(!g->running, "Can't release a running group");
+  KATANA_LOG_VASSERT(
+      g->first == mi.maxThreads - reserved,
+      "Thread groups must be released in reverse order of reservation");
+  reserved -= g->size;
+  delete g;
+}
+
+ThreadPool::Group*
+ThreadPool::enterGroup(Group* g) {
+  auto& me = my_box;
+  Group* previous = me.group;
+  KATANA_LOG_VASSERT(
+      !previous || previous == g || !previous->running,
+      "Can't enter a thread group during parallel section");
+  me.topo = g ? g->topo[0] : ThreadTopoInfo{};
+  me.group = g;
+  return previous;
 }
 
 void
 ThreadPool::runDedicated(std::function<void(void)>& f) {
-  // TODO(ddn): update katana::activeThreads to reflect the dedicated
-  // thread but we don't want to depend on katana symbols and too many
-  // clients access katana::activeThreads directly.
   KATANA_LOG_VASSERT(
-      !running, "Can't start dedicated thread during parallel section");
+      !root.running, "Can't start dedicated thread during parallel section");
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
-  work = [&f]() { throw dedicated_ty{f}; };
+  root.work = [&f]() { throw dedicated_ty{f}; };
   auto* child = signals[mi.maxThreads - reserved];
   child->wbegin = 0;
   child->wend = 0;
+  child->group = &root;
   child->done = 0;
-  child->wakeup(masterFastmode);
+  child->wakeup();
   while (!child->done) {
     asmPause();
   }
-  work = nullptr;
+  root.work = nullptr;
+  root.activeThreads = std::min(root.activeThreads, getMaxUsableThreads());
 }
 
 static katana::ThreadPool* TPOOL = nullptr;
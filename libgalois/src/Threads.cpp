@@ -22,23 +22,21 @@
 #include <algorithm>
 
 #include "katana/ThreadPool.h"
-namespace katana {
-KATANA_EXPORT unsigned int activeThreads = 1;
-}  // namespace katana
 
 unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
   // Reset "burn power"/"busy wait" mode since it might be configured for a
   // different number of threads than we have after this call. That can cause
   // crashes.
-  katana::GetThreadPool().beKind();
-  num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
+  auto& tp = katana::GetThreadPool();
+  tp.beKind();
+  num = std::min(num, tp.getMaxUsableThreads());
   num = std::max(num, 1U);
-  katana::activeThreads = num;
+  tp.setActiveThreads(num);
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
-  return katana::activeThreads;
+  return katana::GetThreadPool().getActiveThreads();
 }
@@ -23,6 +23,7 @@
 #include <random>
 
 #include "katana/Galois.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 
 template <typename Gen>
@@ -82,7 +83,8 @@ run_interleaved(size_t seed, size_t mega, bool full) {
   size_t size = mega * 1024 * 1024;
   auto ptr = katana::largeMallocInterleaved(
       size * sizeof(int),
-      full ? katana::GetThreadPool().getMaxThreads() : katana::activeThreads);
+      full ? katana::GetThreadPool().getMaxThreads()
+           : katana::getActiveThreads());
   int* block = (int*)ptr.get();
 
   run_interleaved_helper r(block, seed, size);
@@ -93,6 +93,7 @@ main(int argc, char** argv) {
   test(CreateMCSBarrier(1));
   test(CreateTopoBarrier(1));
   test(CreateDisseminationBarrier(1));
+  test(CreateTreeBarrier(1));
   // TODO(amp): Reenable when SimpleBarrier is fixed. It is broken and deadlocks.
   //test(CreateSimpleBarrier(1));
   return 0;
@@ -0,0 +1,106 @@
+#include "katana/ConcurrentHashMap.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumKeys = 1 << 14;
+constexpr uint32_t kNumInserts = 1 << 20;
+
+void
+TestSerial() {
+  katana::ConcurrentHashMap<std::string, uint32_t> map(4);
+  KATANA_LOG_ASSERT(map.empty());
+  KATANA_LOG_ASSERT(map.capacity() >= 8);
+
+  auto [value, inserted] = map.Insert("a", 1);
+  KATANA_LOG_ASSERT(inserted && *value == 1);
+  std::tie(value, inserted) = map.Insert("a", 2);
+  KATANA_LOG_ASSERT(!inserted && *value == 1);
+  map.Insert("b", 2);
+  KATANA_LOG_ASSERT(map.size() == 2);
+  KATANA_LOG_ASSERT(*map.Find("b") == 2);
+  KATANA_LOG_ASSERT(map.Find("c") == nullptr);
+
+  std::unordered_map<std::string, uint32_t> seen;
+  map.ForEach([&](const std::string& key, uint32_t v) { seen[key] = v; });
+  KATANA_LOG_ASSERT(seen.size() == 2 && seen["a"] == 1 && seen["b"] == 2);
+
+  map.Reset(4);
+  KATANA_LOG_ASSERT(map.empty());
+  KATANA_LOG_ASSERT(!map.Contains("a"));
+}
+
+/// Counting with atomic values from many threads loses no increment
+void
+TestCounts(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+  katana::ConcurrentHashMap<uint32_t, std::atomic<uint64_t>> counts(kNumKeys);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, kNumInserts),
+      [&](uint32_t i) {
+        counts.Emplace(i % kNumKeys, 0)
+            .first->fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_VASSERT(
+      counts.size() == kNumKeys, "threads {}: {} keys", num_threads,
+      counts.size());
+  std::atomic<uint64_t> total{0};
+  counts.ParallelForEach([&](uint32_t key, std::atomic<uint64_t>& count) {
+    KATANA_LOG_VASSERT(
+        count == kNumInserts / kNumKeys, "threads {}: key {} counted {}",
+        num_threads, key, count.load());
+    total += count;
+  });
+  KATANA_LOG_ASSERT(total == kNumInserts);
+  KATANA_LOG_ASSERT(counts.Find(kNumKeys) == nullptr);
+}
+
+/// A bulk build of strings keeps one value for every distinct key
+void
+TestInsertMany(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+  std::vector<uint32_t> ids(kNumKeys * 2);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ids[i] = i % kNumKeys;
+  }
+
+  katana::ConcurrentHashMap<std::string, uint32_t> map(kNumKeys);
+  uint64_t inserted = map.InsertMany(ids, [](uint32_t id) {
+    return std::make_pair("node" + std::to_string(id), id);
+  });
+  KATANA_LOG_VASSERT(
+      inserted == kNumKeys, "threads {}: inserted {}", num_threads, inserted);
+  KATANA_LOG_ASSERT(map.size() == kNumKeys);
+  for (uint32_t id = 0; id < kNumKeys; ++id) {
+    const uint32_t* value = map.Find("node" + std::to_string(id));
+    KATANA_LOG_VASSERT(
+        value != nullptr && *value == id, "threads {}: node{} missing",
+        num_threads, id);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  TestSerial();
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+  for (unsigned num_threads : {1u, 2u, max_threads}) {
+    TestCounts(num_threads);
+    TestInsertMany(num_threads);
+  }
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/BulkSynchronous.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumItems = 1 << 16;
+
+/// Every node of a complete binary tree numbered in breadth-first order
+/// pushes each child twice; duplicates are dropped, so every node runs once
+/// and, with one thread, nodes run in id order
+void
+TestTree(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  std::vector<std::atomic<int>> visits(kNumItems);
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> roots{0};
+  katana::for_each(
+      katana::iterate(roots),
+      [&](uint32_t x, katana::UserContext<uint32_t>& ctx) {
+        visits[x].fetch_add(1, std::memory_order_relaxed);
+        if (num_threads == 1) {
+          order.emplace_back(x);
+        }
+        for (uint32_t child : {2 * x + 1, 2 * x + 2, 2 * x + 1, 2 * x + 2}) {
+          if (child < kNumItems) {
+            ctx.push(child);
+          }
+        }
+      },
+      katana::wl<katana::DedupBulkSynchronous<>>(kNumItems),
+      katana::disable_conflict_detection(),
+      katana::loopname("DedupBulkSynchronous-Tree"));
+
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_VASSERT(
+        visits[i] == 1, "threads {}: item {} visited {} times", num_threads, i,
+        visits[i].load());
+  }
+  if (num_threads == 1) {
+    KATANA_LOG_ASSERT(order.size() == kNumItems);
+    for (uint32_t i = 0; i < kNumItems; ++i) {
+      KATANA_LOG_VASSERT(order[i] == i, "pop {} is {}", i, order[i]);
+    }
+  }
+}
+
+/// Items pushed by every item of a round run once in the next round; an
+/// item may run again in a later round
+void
+TestRounds(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  constexpr uint32_t kWidth = 100;
+  constexpr int kRounds = 10;
+  std::vector<std::atomic<int>> visits(kWidth);
+  std::vector<std::atomic<int>> rounds(kWidth * kRounds);
+  std::vector<uint32_t> initial;
+  for (uint32_t i = 0; i < kWidth; ++i) {
+    initial.emplace_back(i);
+  }
+  katana::for_each(
+      katana::iterate(initial),
+      [&](uint32_t x, katana::UserContext<uint32_t>& ctx) {
+        int round = visits[x].fetch_add(1, std::memory_order_relaxed);
+        rounds[round * kWidth + x].fetch_add(1, std::memory_order_relaxed);
+        if (round + 1 < kRounds) {
+          // every item pushes every item
+          for (uint32_t y = 0; y < kWidth; ++y) {
+            ctx.push(y);
+          }
+        }
+      },
+      katana::wl<katana::DedupBulkSynchronous<>>(kWidth),
+      katana::disable_conflict_detection(),
+      katana::loopname("DedupBulkSynchronous-Rounds"));
+
+  for (uint32_t i = 0; i < kWidth; ++i) {
+    KATANA_LOG_VASSERT(
+        visits[i] == kRounds, "threads {}: item {} visited {} times",
+        num_threads, i, visits[i].load());
+  }
+  for (size_t i = 0; i < rounds.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        rounds[i] == 1, "threads {}: visit {} of item {} happened {} times",
+        num_threads, i / kWidth, i % kWidth, rounds[i].load());
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  for (unsigned threads : {1U, 2U, max_threads}) {
+    TestTree(threads);
+    TestRounds(threads);
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/DisjointSets.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+
+namespace {
+
+using Index = katana::DisjointSets::Index;
+
+constexpr Index kSize = 1 << 18;
+
+/// Serial union-find to check the results against
+class Reference {
+public:
+  explicit Reference(Index size) : parents_(size) {
+    for (Index i = 0; i < size; ++i) {
+      parents_[i] = i;
+    }
+  }
+
+  Index Find(Index n) {
+    while (parents_[n] != n) {
+      n = parents_[n];
+    }
+    return n;
+  }
+
+  void Unite(Index a, Index b) {
+    a = Find(a);
+    b = Find(b);
+    if (a != b) {
+      parents_[std::max(a, b)] = std::min(a, b);
+    }
+  }
+
+private:
+  std::vector<Index> parents_;
+};
+
+std::vector<std::pair<Index, Index>>
+RandomEdges(size_t num_edges) {
+  std::vector<std::pair<Index, Index>> edges;
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<Index> dist(0, kSize - 1);
+  for (size_t i = 0; i < num_edges; ++i) {
+    edges.emplace_back(dist(gen), dist(gen));
+  }
+  return edges;
+}
+
+void
+TestSerial() {
+  katana::DisjointSets sets(8);
+  KATANA_LOG_ASSERT(sets.NumSets() == 8);
+  KATANA_LOG_ASSERT(sets.Unite(5, 3));
+  KATANA_LOG_ASSERT(sets.Unite(3, 7));
+  KATANA_LOG_ASSERT(!sets.Unite(7, 5));
+  KATANA_LOG_ASSERT(sets.Find(7) == 3);
+  KATANA_LOG_ASSERT(sets.Unite(7, 1));
+  KATANA_LOG_ASSERT(sets.Find(5) == 1);
+  KATANA_LOG_ASSERT(sets.Find(0) == 0);
+  KATANA_LOG_ASSERT(sets.NumSets() == 5);
+
+  sets.Reset(8);
+  KATANA_LOG_ASSERT(sets.NumSets() == 8);
+  KATANA_LOG_ASSERT(sets.Find(5) == 5);
+}
+
+/// The sets of a parallel UniteMany are those of uniting the edges one
+/// after the other, and Compress points every element at the smallest
+/// element of its set
+void
+TestUniteMany(unsigned num_threads, size_t num_edges) {
+  katana::setActiveThreads(num_threads);
+  std::vector<std::pair<Index, Index>> edges = RandomEdges(num_edges);
+
+  Reference expected(kSize);
+  uint64_t expected_merges = 0;
+  for (const auto& [a, b] : edges) {
+    if (expected.Find(a) != expected.Find(b)) {
+      ++expected_merges;
+    }
+    expected.Unite(a, b);
+  }
+
+  katana::DisjointSets sets(kSize);
+  uint64_t merges = sets.UniteMany(edges);
+  KATANA_LOG_VASSERT(
+      merges == expected_merges, "threads {}: {} merges, expected {}",
+      num_threads, merges, expected_merges);
+  KATANA_LOG_ASSERT(sets.NumSets() == kSize - merges);
+
+  sets.Compress();
+  for (Index i = 0; i < kSize; ++i) {
+    KATANA_LOG_VASSERT(
+        sets.Parent(i) == expected.Find(i),
+        "threads {}: element {} in set {}, expected {}", num_threads, i,
+        sets.Parent(i), expected.Find(i));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  TestSerial();
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+  for (unsigned num_threads : {1u, 2u, max_threads}) {
+    // below, around and above the number of edges that joins everything
+    TestUniteMany(num_threads, kSize / 4);
+    TestUniteMany(num_threads, kSize);
+    TestUniteMany(num_threads, 4 * kSize);
+  }
+
+  return 0;
+}
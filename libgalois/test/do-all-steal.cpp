@@ -0,0 +1,54 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Iterations near the start of the range are much more expensive, so the
+/// threads that own them have to be stolen from
+void
+TestSkewed(unsigned num_threads, unsigned chunk) {
+  katana::setActiveThreads(num_threads);
+
+  constexpr uint32_t kSize = 100000;
+  std::vector<std::atomic<uint32_t>> visits(kSize);
+  std::atomic<uint64_t> sink{0};
+
+  katana::do_all(
+      katana::iterate(UINT32_C(0), kSize),
+      [&](uint32_t i) {
+        visits[i].fetch_add(1, std::memory_order_relaxed);
+        uint64_t work = i < kSize / 16 ? 2000 : 1;
+        uint64_t acc = i;
+        for (uint64_t j = 0; j < work; ++j) {
+          acc = acc * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        sink.fetch_add(acc & 1, std::memory_order_relaxed);
+      },
+      katana::steal(), katana::chunk_size<16>(chunk),
+      katana::loopname("skewed"));
+
+  for (uint32_t i = 0; i < kSize; ++i) {
+    KATANA_LOG_VASSERT(
+        visits[i] == 1, "threads {} chunk {}: item {} visited {} times",
+        num_threads, chunk, i, visits[i].load());
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  for (unsigned threads : {1U, 2U, max_threads}) {
+    for (unsigned chunk : {1U, 16U}) {
+      TestSkewed(threads, chunk);
+    }
+  }
+
+  return 0;
+}
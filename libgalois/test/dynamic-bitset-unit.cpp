@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include "katana/DynamicBitset.h"
 #include "katana/Result.h"
 
@@ -133,7 +136,99 @@ const Invariant NotValues =
   return katana::ResultSuccess();
 };
 
-const std::vector<Invariant> invariants = {NotAndCount, NotValues};
+// every other bit of test
+katana::DynamicBitset
+Alternating(const katana::DynamicBitset& test) {
+  katana::DynamicBitset other;
+  other.resize(test.size());
+  other.reset();
+  for (size_t i = 0; i < test.size(); i += 2) {
+    other.set(i);
+  }
+  return other;
+}
+
+const Invariant AndNotValues =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  katana::DynamicBitset other = Alternating(*test);
+  katana::DynamicBitset result;
+  result.resize(test->size());
+  result.bitwise_andnot(*test, other);
+
+  for (size_t i = 0, size = test->size(); i < size; ++i) {
+    bool expected = test->test(i) && !other.test(i);
+    if (result.test(i) != expected) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "bitwise_andnot of two bitsets has bit {} {}, expected {}", i,
+          result.test(i), expected);
+    }
+  }
+
+  test->bitwise_andnot(other);
+  if (*test != result) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "in-place bitwise_andnot differs from bitwise_andnot of two bitsets");
+  }
+
+  return katana::ResultSuccess();
+};
+
+const Invariant XorTwiceEquals =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  katana::DynamicBitset other = Alternating(*test);
+  katana::DynamicBitset result;
+  result.resize(test->size());
+  result |= *test;
+  result ^= other;
+  if ((other.count() == 0) != (result == *test)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "bitset xor another bitset should equal the bitset only if the other "
+        "is empty");
+  }
+  result ^= other;
+  if (result != *test) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "bitset xor the same bitset twice differs from bitset");
+  }
+
+  return katana::ResultSuccess();
+};
+
+const Invariant OffsetsValues =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  std::vector<uint32_t> expected;
+  for (size_t i = 0, size = test->size(); i < size; ++i) {
+    if (test->test(i)) {
+      expected.emplace_back(i);
+    }
+  }
+
+  std::vector<uint32_t> offsets = test->GetOffsets<uint32_t>();
+  if (offsets != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "GetOffsets returned {} offsets, expected the {} set bits",
+        offsets.size(), expected.size());
+  }
+
+  std::vector<uint64_t> appended{7};
+  test->AppendOffsets(&appended);
+  if (appended.size() != expected.size() + 1 || appended[0] != 7 ||
+      !std::equal(expected.begin(), expected.end(), appended.begin() + 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "AppendOffsets did not append the set bits");
+  }
+
+  return katana::ResultSuccess();
+};
+
+const std::vector<Invariant> invariants = {
+    NotAndCount, NotValues, AndNotValues, XorTwiceEquals, OffsetsValues};
 
 katana::Result<void>
 TestAll() {
@@ -153,7 +248,11 @@ int
 main() {
   katana::GaloisRuntime Katana_runtime;
 
-  auto res = TestAll();
-  KATANA_LOG_VASSERT(res, "{}", res.error());
+  // offsets are computed in blocks of words per thread
+  for (unsigned num_threads : {1u, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(num_threads);
+    auto res = TestAll();
+    KATANA_LOG_VASSERT(res, "threads {}: {}", num_threads, res.error());
+  }
   return 0;
 }
@@ -0,0 +1,100 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Range.h"
+
+namespace {
+
+/// An edge prefix sum with one node that has most of the edges, runs of
+/// nodes without edges and many small nodes
+std::vector<uint64_t>
+MakeSkewedPrefixSum() {
+  std::vector<uint64_t> degrees{0, 0, 3, 50000, 0, 1};
+  for (uint32_t i = 0; i < 5000; ++i) {
+    degrees.emplace_back(i % 7);
+  }
+  degrees.emplace_back(0);
+
+  std::vector<uint64_t> adj_indices;
+  uint64_t sum = 0;
+  for (uint64_t degree : degrees) {
+    sum += degree;
+    adj_indices.emplace_back(sum);
+  }
+  return adj_indices;
+}
+
+uint32_t
+SourceOf(const std::vector<uint64_t>& adj_indices, uint64_t edge) {
+  uint32_t node = 0;
+  while (adj_indices[node] <= edge) {
+    ++node;
+  }
+  return node;
+}
+
+void
+TestTiles(const std::vector<uint64_t>& adj_indices, uint64_t tile_size) {
+  auto range = katana::edge_balanced_range(
+      adj_indices.data(), adj_indices.size(), tile_size);
+  uint64_t num_edges = adj_indices.back();
+  KATANA_LOG_ASSERT(range.tile_size() >= 1);
+  KATANA_LOG_ASSERT(range.num_tiles() * range.tile_size() >= num_edges);
+
+  std::vector<std::atomic<uint32_t>> visits(num_edges);
+  std::atomic<bool> bad_source{false};
+  katana::do_all_edges(
+      range,
+      [&](uint32_t node, uint64_t begin, uint64_t end) {
+        KATANA_LOG_ASSERT(begin < end);
+        if (end - begin > range.tile_size() ||
+            begin < (node > 0 ? adj_indices[node - 1] : 0) ||
+            end > adj_indices[node]) {
+          bad_source = true;
+        }
+        for (uint64_t e = begin; e < end; ++e) {
+          visits[e].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::loopname("EdgeBalanced"));
+  KATANA_LOG_ASSERT(!bad_source);
+
+  for (uint64_t e = 0; e < num_edges; ++e) {
+    KATANA_LOG_VASSERT(
+        visits[e] == 1, "tile size {}: edge {} of node {} visited {} times",
+        range.tile_size(), e, SourceOf(adj_indices, e), visits[e].load());
+  }
+}
+
+void
+TestEmpty() {
+  std::vector<uint64_t> no_edges(10, 0);
+  auto range = katana::edge_balanced_range(no_edges.data(), no_edges.size());
+  KATANA_LOG_ASSERT(range.num_tiles() == 0);
+  bool visited = false;
+  katana::do_all_edges(
+      range, [&](uint32_t, uint64_t, uint64_t) { visited = true; });
+  KATANA_LOG_ASSERT(!visited);
+
+  auto no_nodes = katana::edge_balanced_range<uint32_t, uint64_t>(nullptr, 0);
+  KATANA_LOG_ASSERT(no_nodes.num_tiles() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  auto adj_indices = MakeSkewedPrefixSum();
+  for (uint64_t tile_size : {0, 1, 2, 7, 1000, 1 << 20}) {
+    TestTiles(adj_indices, tile_size);
+  }
+  TestEmpty();
+
+  return 0;
+}
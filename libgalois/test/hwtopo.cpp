@@ -35,7 +35,8 @@ printMyTopo() {
               << " socket: " << c.socket << " numaNode: " << c.numaNode
               << " cumulativeMaxSocket: " << c.cumulativeMaxSocket
               << " osContext: " << c.osContext
-              << " osNumaNode: " << c.osNumaNode << "\n";
+              << " osNumaNode: " << c.osNumaNode
+              << " capacity: " << c.capacity << "\n";
   }
 }
 
@@ -82,5 +83,19 @@ main() {
       "parse range", parseCPUList("     0-4   \n"),
       std::vector<int>{0, 1, 2, 3, 4});
 
+  test("quota unlimited", {(int)parseCPUQuota("max 100000\n")}, {0});
+  test("quota whole", {(int)parseCPUQuota("400000 100000\n")}, {4});
+  test("quota fraction", {(int)parseCPUQuota("150000 100000")}, {2});
+  test("quota v1 unlimited", {(int)parseCPUQuota("-1 100000")}, {0});
+  test("quota malformed", {(int)parseCPUQuota("100000")}, {0});
+
+  if (parseAffinityPolicy("scatter") != AffinityPolicy::kScatter ||
+      parseAffinityPolicy("compact") != AffinityPolicy::kCompact ||
+      parseAffinityPolicy("compact-smt") != AffinityPolicy::kCompactSMT ||
+      parseAffinityPolicy("spread")) {
+    std::cerr << "test parse affinity policy failed\n";
+    std::abort();
+  }
+
   return 0;
 }
@@ -0,0 +1,112 @@
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/LoopTrace.h"
+
+namespace {
+
+/// \returns the events written so far, closing the array the trace leaves
+/// open
+nlohmann::json
+ReadTrace(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  return nlohmann::json::parse(contents.str() + "{}]");
+}
+
+const nlohmann::json*
+FindLoop(const nlohmann::json& events, const std::string& name) {
+  for (const auto& event : events) {
+    if (event.value("name", "") == name && event["args"].contains("threads")) {
+      return &event;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+int
+main() {
+  char dir[] = "/tmp/loop-trace-XXXXXX";
+  KATANA_LOG_ASSERT(mkdtemp(dir) != nullptr);
+  std::string path = std::string(dir) + "/trace.json";
+  // must be set before the first loop looks the trace up
+  setenv("KATANA_LOOP_TRACE", path.c_str(), 1);
+
+  katana::GaloisRuntime Katana_runtime;
+  unsigned num_threads = katana::GetThreadPool().getMaxUsableThreads();
+  katana::setActiveThreads(num_threads);
+  KATANA_LOG_ASSERT(katana::LoopTrace::Get() != nullptr);
+
+  constexpr uint32_t kSize = 10000;
+  katana::do_all(
+      katana::iterate(UINT32_C(0), kSize), [](uint32_t) {}, katana::steal(),
+      katana::loopname("traced-do-all"));
+  katana::for_each(
+      katana::iterate(UINT32_C(0), kSize),
+      [](uint32_t i, auto& ctx) {
+        if (i % 2 == 0) {
+          ctx.push(i + 1);
+        }
+      },
+      katana::loopname("traced-for-each"));
+  katana::on_each(
+      [](unsigned, unsigned) {}, katana::loopname("traced-on-each"));
+  // unnamed loops are not traced
+  katana::do_all(katana::iterate(UINT32_C(0), kSize), [](uint32_t) {});
+
+  nlohmann::json events = ReadTrace(path);
+
+  const auto* do_all = FindLoop(events, "traced-do-all");
+  KATANA_LOG_ASSERT(do_all != nullptr);
+  KATANA_LOG_ASSERT((*do_all)["cat"] == "do_all");
+  KATANA_LOG_ASSERT((*do_all)["ph"] == "X");
+  KATANA_LOG_VASSERT(
+      (*do_all)["args"]["iterations"] == kSize, "{}", do_all->dump());
+  KATANA_LOG_ASSERT((*do_all)["args"]["threads"] == num_threads);
+  KATANA_LOG_ASSERT((*do_all)["args"].contains("local_steals"));
+
+  const auto* for_each = FindLoop(events, "traced-for-each");
+  KATANA_LOG_ASSERT(for_each != nullptr);
+  KATANA_LOG_ASSERT((*for_each)["cat"] == "for_each");
+  KATANA_LOG_VASSERT(
+      (*for_each)["args"]["iterations"] == kSize + kSize / 2, "{}",
+      for_each->dump());
+  KATANA_LOG_ASSERT((*for_each)["args"]["pushes"] == kSize / 2);
+  KATANA_LOG_ASSERT((*for_each)["args"].contains("termination_us"));
+
+  const auto* on_each = FindLoop(events, "traced-on-each");
+  KATANA_LOG_ASSERT(on_each != nullptr);
+  KATANA_LOG_ASSERT((*on_each)["args"]["threads"] == num_threads);
+
+  // one event per thread per loop, each within its loop
+  size_t per_thread = 0;
+  for (const auto& event : events) {
+    if (event.value("name", "") != "traced-do-all" ||
+        event["args"].contains("threads")) {
+      continue;
+    }
+    ++per_thread;
+    KATANA_LOG_ASSERT(event["ts"] >= (*do_all)["ts"]);
+    KATANA_LOG_ASSERT(
+        event["ts"].get<uint64_t>() + event["dur"].get<uint64_t>() <=
+        (*do_all)["ts"].get<uint64_t>() + (*do_all)["dur"].get<uint64_t>());
+  }
+  KATANA_LOG_ASSERT(per_thread == num_threads);
+
+  std::remove(path.c_str());
+  rmdir(dir);
+
+  return 0;
+}
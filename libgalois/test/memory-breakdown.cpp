@@ -0,0 +1,70 @@
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/NUMAArray.h"
+
+namespace {
+
+void
+TestLargeAllocationCategories() {
+  constexpr size_t kSize = 1 << 22;
+  auto& ms = katana::MemorySupervisor::Get();
+  auto before = ms.GetMemoryBreakdown();
+  KATANA_LOG_ASSERT(before.count("rss") == 1);
+  KATANA_LOG_ASSERT(before.count("arrow") == 1);
+
+  katana::NUMAArray<uint64_t> topology;
+  {
+    katana::MemoryCategoryScope scope(katana::MemoryCategory::kTopology);
+    topology.allocateInterleaved(kSize);
+    {
+      katana::MemoryCategoryScope inner(katana::MemoryCategory::kViewCache);
+      KATANA_LOG_ASSERT(
+          katana::MemoryCategoryScope::Current() ==
+          katana::MemoryCategory::kViewCache);
+    }
+    KATANA_LOG_ASSERT(
+        katana::MemoryCategoryScope::Current() ==
+        katana::MemoryCategory::kTopology);
+  }
+  katana::NUMAArray<uint64_t> other;
+  other.allocateBlocked(kSize);
+
+  auto during = ms.GetMemoryBreakdown();
+  KATANA_LOG_ASSERT(
+      during["large_alloc.topology"] >=
+      before["large_alloc.topology"] +
+          static_cast<katana::count_t>(kSize * sizeof(uint64_t)));
+  KATANA_LOG_ASSERT(
+      during["large_alloc.other"] >=
+      before["large_alloc.other"] +
+          static_cast<katana::count_t>(kSize * sizeof(uint64_t)));
+  KATANA_LOG_ASSERT(
+      during["large_alloc.view_cache"] == before["large_alloc.view_cache"]);
+
+  // a moved array is still charged to the category it was allocated in
+  katana::NUMAArray<uint64_t> moved = std::move(topology);
+  other.deallocate();
+  auto after = ms.GetMemoryBreakdown();
+  KATANA_LOG_ASSERT(
+      after["large_alloc.topology"] == during["large_alloc.topology"]);
+  KATANA_LOG_ASSERT(after["large_alloc.other"] == before["large_alloc.other"]);
+
+  moved.deallocate();
+  KATANA_LOG_ASSERT(
+      ms.GetMemoryBreakdown()["large_alloc.topology"] ==
+      before["large_alloc.topology"]);
+
+  ms.LogMemoryBreakdown("memory breakdown test");
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+
+  TestLargeAllocationCategories();
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MultiQueue.h"
+
+namespace {
+
+struct Identity {
+  int operator()(int x) const { return x; }
+};
+
+/// Depth of a node in a complete binary tree numbered in breadth-first order
+struct Depth {
+  int operator()(int x) const {
+    int depth = 0;
+    for (++x; x > 1; x >>= 1) {
+      ++depth;
+    }
+    return depth;
+  }
+};
+
+std::vector<int>
+Shuffled(int num) {
+  std::vector<int> items(num);
+  for (int i = 0; i < num; ++i) {
+    items[i] = i;
+  }
+  std::mt19937 gen(7);
+  std::shuffle(items.begin(), items.end(), gen);
+  return items;
+}
+
+/// With one thread and one heap, pops are in exact priority order
+template <bool UseDescending>
+void
+TestSerialOrder() {
+  katana::setActiveThreads(1);
+
+  using WL = typename katana::MultiQueue<Identity, 1>::template with_descending<
+      UseDescending>::type;
+  std::vector<int> items = Shuffled(1000);
+  std::vector<int> order;
+  katana::for_each(
+      katana::iterate(items),
+      [&](int x, katana::UserContext<int>&) { order.emplace_back(x); },
+      katana::wl<WL>(), katana::loopname("MultiQueue-Serial"));
+
+  KATANA_LOG_ASSERT(order.size() == items.size());
+  for (size_t i = 1; i < order.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        UseDescending ? order[i - 1] > order[i] : order[i - 1] < order[i],
+        "pop {}: {} after {}", i, order[i], order[i - 1]);
+  }
+}
+
+/// Every item pushed during the loop is processed exactly once
+void
+TestParallelPushes(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  constexpr int kNumItems = 1 << 16;
+  std::vector<std::atomic<int>> visits(kNumItems);
+  std::vector<int> roots{0};
+  katana::for_each(
+      katana::iterate(roots),
+      [&](int x, katana::UserContext<int>& ctx) {
+        visits[x].fetch_add(1, std::memory_order_relaxed);
+        for (int child : {2 * x + 1, 2 * x + 2}) {
+          if (child < kNumItems) {
+            ctx.push(child);
+          }
+        }
+      },
+      katana::wl<katana::MultiQueue<Depth>>(),
+      katana::disable_conflict_detection(),
+      katana::loopname("MultiQueue-Parallel"));
+
+  for (int i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_VASSERT(
+        visits[i] == 1, "threads {}: item {} visited {} times", num_threads, i,
+        visits[i].load());
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  TestSerialOrder<false>();
+  TestSerialOrder<true>();
+
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  for (unsigned threads : {1U, 2U, max_threads}) {
+    TestParallelPushes(threads);
+  }
+
+  return 0;
+}
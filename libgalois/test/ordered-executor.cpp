@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumCells = 1000;
+constexpr uint64_t kNumItems = 20000;
+
+struct Cell : public katana::Lockable {
+  std::vector<uint64_t> log;
+};
+
+struct Item {
+  uint64_t priority;
+  uint32_t a;
+  uint32_t b;
+  bool pushed;
+};
+
+std::vector<Item>
+RandomItems() {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<uint32_t> cell(0, kNumCells - 1);
+  std::vector<uint64_t> priorities(kNumItems);
+  std::iota(priorities.begin(), priorities.end(), 0);
+  std::shuffle(priorities.begin(), priorities.end(), gen);
+
+  std::vector<Item> items;
+  for (uint64_t p : priorities) {
+    items.emplace_back(Item{p, cell(gen), cell(gen), false});
+  }
+  return items;
+}
+
+/// Every item appends its priority to the logs of its two cells, and items
+/// with even priority push an item that logs to a cell of a second set.
+/// Conflicting items ran in priority order exactly when the logs are
+/// sorted.
+template <typename... StableTest>
+void
+TestOrder(unsigned num_threads, const StableTest&... stabilityTest) {
+  katana::setActiveThreads(num_threads);
+
+  std::vector<Item> items = RandomItems();
+  std::vector<Cell> cells(kNumCells);
+  std::vector<Cell> pushed_cells(kNumCells);
+  auto cells_of = [&](const Item& item) {
+    std::vector<Cell>& of = item.pushed ? pushed_cells : cells;
+    return std::make_pair(&of[item.a], &of[item.b]);
+  };
+
+  katana::for_each_ordered(
+      items.begin(), items.end(),
+      [](const Item& x, const Item& y) { return x.priority <= y.priority; },
+      [&](const Item& item) {
+        auto [a, b] = cells_of(item);
+        katana::acquire(a, katana::MethodFlag::WRITE);
+        katana::acquire(b, katana::MethodFlag::WRITE);
+      },
+      [&](const Item& item, katana::UserContext<Item>& ctx) {
+        auto [a, b] = cells_of(item);
+        a->log.push_back(item.priority);
+        if (b != a) {
+          b->log.push_back(item.priority);
+        }
+        if (!item.pushed && item.priority % 2 == 0) {
+          ctx.push(Item{kNumItems + item.priority, item.a, item.a, true});
+        }
+      },
+      stabilityTest..., "OrderedTest");
+
+  size_t num_logged = 0;
+  for (const std::vector<Cell>* of : {&cells, &pushed_cells}) {
+    for (const Cell& cell : *of) {
+      KATANA_LOG_ASSERT(std::is_sorted(cell.log.begin(), cell.log.end()));
+      num_logged += cell.log.size();
+    }
+  }
+  size_t num_expected = kNumItems / 2;
+  for (const Item& item : items) {
+    num_expected += item.a == item.b ? 1 : 2;
+  }
+  KATANA_LOG_VASSERT(
+      num_logged == num_expected, "logged {} want {}", num_logged,
+      num_expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+
+  for (unsigned num_threads : {1U, katana::GetThreadPool().getMaxThreads()}) {
+    TestOrder(num_threads);
+    TestOrder(
+        num_threads, [](const Item& item) { return item.priority % 16 != 0; });
+  }
+
+  return 0;
+}
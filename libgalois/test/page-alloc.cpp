@@ -0,0 +1,51 @@
+#include <cstdint>
+#include <cstring>
+
+#include "katana/Logging.h"
+#include "katana/PageAlloc.h"
+
+namespace {
+
+size_t
+TotalBytes(const katana::PageAllocStats& stats) {
+  return stats.hugetlb_bytes + stats.transparent_bytes + stats.small_bytes;
+}
+
+void
+TestAllocFree(unsigned num, bool pre_fault) {
+  const size_t size = num * katana::allocSize();
+  katana::PageAllocStats before = katana::GetPageAllocStats();
+
+  char* ptr = static_cast<char*>(katana::allocPages(num, pre_fault));
+  KATANA_LOG_ASSERT(ptr != nullptr);
+  std::memset(ptr, 1, size);
+
+  katana::PageAllocStats during = katana::GetPageAllocStats();
+  KATANA_LOG_VASSERT(
+      TotalBytes(during) == TotalBytes(before) + size, "{} != {} + {}",
+      TotalBytes(during), TotalBytes(before), size);
+  if (during.small_bytes == before.small_bytes) {
+    // huge pages of either kind need aligned memory
+    KATANA_LOG_ASSERT(
+        reinterpret_cast<uintptr_t>(ptr) % katana::allocSize() == 0);
+  }
+
+  katana::freePages(ptr, num);
+
+  katana::PageAllocStats after = katana::GetPageAllocStats();
+  KATANA_LOG_ASSERT(after.hugetlb_bytes == before.hugetlb_bytes);
+  KATANA_LOG_ASSERT(after.transparent_bytes == before.transparent_bytes);
+  KATANA_LOG_ASSERT(after.small_bytes == before.small_bytes);
+}
+
+}  // namespace
+
+int
+main() {
+  TestAllocFree(1, true);
+  TestAllocFree(1, false);
+  TestAllocFree(5, true);
+  TestAllocFree(5, false);
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kWidth = 1000;
+constexpr uint32_t kDepth = 5;
+
+nlohmann::json
+ReadReport(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  return nlohmann::json::parse(contents.str());
+}
+
+const nlohmann::json*
+FindLoop(const nlohmann::json& report, const std::string& name) {
+  for (const auto& loop : report["loops"]) {
+    if (loop["name"] == name) {
+      return &loop;
+    }
+  }
+  return nullptr;
+}
+
+/// kWidth chains of kDepth items each, so every round has kWidth items
+void
+RunChains(std::atomic<uint64_t>* visited) {
+  katana::for_each(
+      katana::iterate(UINT32_C(0), kWidth),
+      [&](uint32_t i, auto& ctx) {
+        *visited += 1;
+        if (i + kWidth < kWidth * kDepth) {
+          ctx.push(i + kWidth);
+        }
+      },
+      katana::wl<katana::PerSocketChunkFIFO<16>>(),
+      katana::disable_conflict_detection(), katana::loopname("chains"));
+}
+
+}  // namespace
+
+int
+main() {
+  char dir[] = "/tmp/parameter-report-XXXXXX";
+  KATANA_LOG_ASSERT(mkdtemp(dir) != nullptr);
+  std::string path = std::string(dir) + "/report.json";
+  // must be set before the first loop looks the report up
+  setenv("KATANA_PARAMETER_REPORT", path.c_str(), 1);
+
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+  KATANA_LOG_ASSERT(katana::parameter::Report::Get() != nullptr);
+
+  // the loops still do all their work
+  std::atomic<uint64_t> visited{0};
+  RunChains(&visited);
+  RunChains(&visited);
+  KATANA_LOG_ASSERT(visited == 2 * kWidth * kDepth);
+
+  // neither unnamed loops nor do_all loops are profiled
+  katana::for_each(
+      katana::iterate(UINT32_C(0), kWidth), [](uint32_t, auto&) {},
+      katana::disable_conflict_detection());
+  katana::do_all(
+      katana::iterate(UINT32_C(0), kWidth), [](uint32_t) {},
+      katana::loopname("do-all"));
+
+  nlohmann::json report = ReadReport(path);
+  KATANA_LOG_VASSERT(report["loops"].size() == 1, "{}", report.dump());
+
+  const auto* chains = FindLoop(report, "chains");
+  KATANA_LOG_ASSERT(chains != nullptr);
+  KATANA_LOG_ASSERT((*chains)["runs"] == 2);
+  KATANA_LOG_ASSERT((*chains)["work"] == 2 * kWidth * kDepth);
+  KATANA_LOG_ASSERT((*chains)["critical_path"] == 2 * kDepth);
+  KATANA_LOG_ASSERT((*chains)["longest_critical_path"] == kDepth);
+  KATANA_LOG_ASSERT((*chains)["max_parallelism"] == kWidth);
+  KATANA_LOG_ASSERT((*chains)["average_parallelism"] == kWidth);
+  KATANA_LOG_ASSERT((*chains)["rounds"].size() == kDepth);
+  for (const auto& round : (*chains)["rounds"]) {
+    KATANA_LOG_VASSERT(
+        round["parallelism"] == 2 * kWidth, "{}", chains->dump());
+    KATANA_LOG_ASSERT(round["worklist_size"] == 2 * kWidth);
+  }
+
+  std::remove(path.c_str());
+  rmdir(dir);
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/gstl.h"
+
+namespace {
+
+/// Temporaries built from the per-iteration allocator hold the values the
+/// iteration put in them
+void
+TestContainers(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  constexpr uint32_t kSize = 10000;
+  std::atomic<uint64_t> bad{0};
+  katana::for_each(
+      katana::iterate(UINT32_C(0), kSize),
+      [&](uint32_t i, auto& ctx) {
+        katana::gstl::PerIterVector<uint32_t> digits(ctx.getPerIterAlloc());
+        katana::gstl::PerIterMap<uint32_t, uint32_t> counts(
+            ctx.getPerIterAlloc());
+        katana::gstl::PerIterUnorderedSet<uint32_t> seen(
+            ctx.getPerIterAlloc());
+        for (uint32_t x = i; x; x /= 10) {
+          digits.push_back(x % 10);
+          counts[x % 10] += 1;
+          seen.insert(x % 10);
+        }
+
+        uint32_t number = 0;
+        for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
+          number = number * 10 + *it;
+        }
+        size_t total = 0;
+        for (const auto& [digit, count] : counts) {
+          total += count;
+          if (!seen.count(digit)) {
+            bad.fetch_add(1);
+          }
+        }
+        if (number != i || total != digits.size()) {
+          bad.fetch_add(1);
+        }
+      },
+      katana::per_iter_alloc(), katana::loopname("per-iter-containers"));
+
+  KATANA_LOG_VASSERT(bad == 0, "{} iterations went wrong", bad.load());
+}
+
+/// The arena is rewound after each iteration, so each iteration's first
+/// allocation reuses the same memory
+void
+TestReset() {
+  katana::setActiveThreads(1);
+
+  const void* first = nullptr;
+  bool reused = true;
+  katana::for_each(
+      katana::iterate(0, 100),
+      [&](int i, auto& ctx) {
+        katana::gstl::PerIterVector<int> v(ctx.getPerIterAlloc());
+        v.resize(i + 1);
+        std::iota(v.begin(), v.end(), 0);
+        if (!first) {
+          first = v.data();
+        }
+        reused = reused && v.data() == first;
+      },
+      katana::per_iter_alloc(), katana::loopname("per-iter-reset"));
+
+  KATANA_LOG_ASSERT(reused);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  TestContainers(1);
+  TestContainers(katana::GetThreadPool().getMaxUsableThreads());
+  TestReset();
+
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <cstdlib>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerfCounters.h"
+
+namespace {
+
+void
+TestCountsIncrease() {
+  katana::PerfCounters* counters = katana::PerfCounters::Get();
+  KATANA_LOG_ASSERT(counters != nullptr);
+
+  std::vector<katana::PerfCounters::Counts> begin;
+  counters->Read(&begin);
+  KATANA_LOG_ASSERT(begin.size() == katana::getActiveThreads());
+
+  std::vector<uint64_t> out(1 << 20);
+  katana::do_all(
+      katana::iterate(size_t{0}, out.size()),
+      [&](size_t i) { out[i] = i * i; }, katana::loopname("square"));
+
+  std::vector<katana::PerfCounters::Counts> end;
+  counters->Read(&end);
+  KATANA_LOG_ASSERT(end.size() == begin.size());
+
+  // perf_event_paranoid or a virtual machine may hide the counters
+  if (!counters->IsCounting(0, katana::PerfCounters::kInstructions)) {
+    KATANA_LOG_WARN("instructions are not counted; skipping checks");
+    return;
+  }
+  uint64_t delta = 0;
+  for (size_t tid = 0; tid < end.size(); ++tid) {
+    delta += end[tid][katana::PerfCounters::kInstructions] -
+             begin[tid][katana::PerfCounters::kInstructions];
+  }
+  KATANA_LOG_VASSERT(delta >= out.size(), "counted {} instructions", delta);
+}
+
+}  // namespace
+
+int
+main() {
+  // must be set before the first loop looks the counters up
+  setenv("KATANA_PERF_COUNTERS", "1", 1);
+
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestCountsIncrease();
+
+  return 0;
+}
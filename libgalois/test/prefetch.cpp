@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Prefetch.h"
+
+namespace {
+
+constexpr uint64_t kSize = 1000;
+
+/// The pipeline asks for the address of every index distance ahead of the
+/// iteration, stops at the limit, and runs every iteration exactly once
+void
+TestRun(uint64_t distance, uint64_t limit) {
+  std::vector<uint64_t> data(kSize);
+  std::vector<uint64_t> prefetched;
+  auto pipeline = katana::MakePrefetchPipeline(
+      limit,
+      [&](uint64_t i) {
+        KATANA_LOG_ASSERT(i < limit);
+        prefetched.emplace_back(i);
+        return &data[i];
+      },
+      distance);
+  KATANA_LOG_ASSERT(pipeline.distance() == distance);
+
+  std::vector<uint64_t> visited;
+  pipeline.Run(
+      uint64_t{0}, kSize, [&](uint64_t i) { visited.emplace_back(i); });
+
+  KATANA_LOG_ASSERT(visited.size() == kSize);
+  for (uint64_t i = 0; i < kSize; ++i) {
+    KATANA_LOG_ASSERT(visited[i] == i);
+  }
+  uint64_t expected = distance < limit ? limit - distance : 0;
+  expected = std::min(expected, kSize);
+  KATANA_LOG_VASSERT(
+      prefetched.size() == expected,
+      "distance {} limit {}: {} prefetches, expected {}", distance, limit,
+      prefetched.size(), expected);
+  for (uint64_t i = 0; i < prefetched.size(); ++i) {
+    KATANA_LOG_ASSERT(prefetched[i] == i + distance);
+  }
+}
+
+/// A pipeline shared by the iterations of a do_all over the edges of
+/// consecutive nodes, as in pull-style kernels, computes the same sums
+void
+TestPull() {
+  constexpr uint64_t kDegree = 7;
+  std::vector<uint32_t> dests(kSize * kDegree);
+  for (uint64_t e = 0; e < dests.size(); ++e) {
+    dests[e] = (e * 7919) % kSize;
+  }
+  std::vector<uint64_t> values(kSize);
+  for (uint64_t n = 0; n < kSize; ++n) {
+    values[n] = n * n;
+  }
+
+  auto pipeline = katana::MakePrefetchPipeline(
+      uint64_t{dests.size()}, [&](uint64_t e) { return &values[dests[e]]; });
+  std::vector<uint64_t> sums(kSize);
+  katana::do_all(katana::iterate(uint64_t{0}, kSize), [&](uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t e = n * kDegree; e < (n + 1) * kDegree; ++e) {
+      pipeline.Ahead(e);
+      sum += values[dests[e]];
+    }
+    sums[n] = sum;
+  });
+
+  for (uint64_t n = 0; n < kSize; ++n) {
+    uint64_t sum = 0;
+    for (uint64_t e = n * kDegree; e < (n + 1) * kDegree; ++e) {
+      sum += values[dests[e]];
+    }
+    KATANA_LOG_ASSERT(sums[n] == sum);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  for (uint64_t distance : {0, 1, 16, 2000}) {
+    for (uint64_t limit : {uint64_t{0}, kSize / 2, kSize, 2 * kSize}) {
+      TestRun(distance, limit);
+    }
+  }
+  TestPull();
+
+  return 0;
+}
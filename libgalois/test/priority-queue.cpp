@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PriorityQueue.h"
+#include "katana/Random.h"
+
+namespace {
+
+struct Item {
+  uint32_t key;
+  uint32_t id;
+
+  friend bool operator<(const Item& left, const Item& right) {
+    return left.key == right.key ? left.id < right.id : left.key < right.key;
+  }
+};
+
+struct ItemKey {
+  uint32_t operator()(const Item& item) const { return item.key; }
+};
+
+template <typename Heap>
+void
+TestSorts() {
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<uint32_t> dist(0, 1000);
+  std::vector<Item> items;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    items.emplace_back(Item{dist(gen), i});
+  }
+
+  Heap heap;
+  for (const Item& item : items) {
+    heap.push(item);
+  }
+  KATANA_LOG_ASSERT(heap.size() == items.size());
+
+  std::sort(items.begin(), items.end());
+  for (const Item& item : items) {
+    KATANA_LOG_ASSERT(!heap.empty());
+    KATANA_LOG_ASSERT(heap.pop().key == item.key);
+  }
+  KATANA_LOG_ASSERT(heap.empty());
+}
+
+/// Push and pop like Dijkstra's algorithm does, where pushed keys are never
+/// less than the last key popped, and check the keys come out in order
+template <typename Heap>
+void
+TestMonotone() {
+  auto& gen = katana::GetGenerator();
+  std::uniform_int_distribution<uint32_t> weight(0, 1 << 20);
+  std::uniform_int_distribution<uint32_t> fanout(0, 3);
+
+  Heap heap;
+  heap.push(Item{0, 0});
+  uint32_t last = 0;
+  uint32_t next_id = 1;
+  size_t popped = 0;
+  while (!heap.empty()) {
+    Item item = heap.pop();
+    KATANA_LOG_VASSERT(
+        item.key >= last, "popped {} after {}", item.key, last);
+    last = item.key;
+    ++popped;
+    if (next_id >= 100000) {
+      continue;
+    }
+    for (uint32_t i = fanout(gen); i > 0; --i) {
+      heap.push(Item{item.key + weight(gen), next_id++});
+    }
+  }
+  KATANA_LOG_ASSERT(popped == next_id);
+}
+
+void
+TestDAryTies() {
+  // equal keys come out in the order of the comparison
+  katana::DAryMinHeap<Item, 4> heap;
+  for (uint32_t id : {5, 3, 9, 1}) {
+    heap.push(Item{7, id});
+  }
+  for (uint32_t id : {1, 3, 5, 9}) {
+    KATANA_LOG_ASSERT(heap.top().id == id);
+    KATANA_LOG_ASSERT(heap.pop().id == id);
+  }
+}
+
+void
+TestRadixLast() {
+  katana::RadixHeap<Item, ItemKey> heap;
+  heap.push(Item{10, 0});
+  heap.push(Item{3, 1});
+  heap.push(Item{3, 2});
+  KATANA_LOG_ASSERT(heap.pop().key == 3);
+  KATANA_LOG_ASSERT(heap.last() == 3);
+  heap.push(Item{3, 3});
+  KATANA_LOG_ASSERT(heap.pop().key == 3);
+  KATANA_LOG_ASSERT(heap.pop().key == 3);
+  KATANA_LOG_ASSERT(heap.pop().key == 10);
+  KATANA_LOG_ASSERT(heap.empty());
+
+  heap.clear();
+  KATANA_LOG_ASSERT(heap.last() == 0);
+  heap.push(Item{0, 4});
+  KATANA_LOG_ASSERT(heap.pop().key == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  TestSorts<katana::DAryMinHeap<Item, 2>>();
+  TestSorts<katana::DAryMinHeap<Item, 4>>();
+  TestSorts<katana::DAryMinHeap<Item, 8>>();
+  TestSorts<katana::RadixHeap<Item, ItemKey>>();
+  TestMonotone<katana::DAryMinHeap<Item, 4>>();
+  TestMonotone<katana::RadixHeap<Item, ItemKey>>();
+  TestDAryTies();
+  TestRadixLast();
+  return 0;
+}
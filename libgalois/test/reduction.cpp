@@ -1,8 +1,10 @@
 #include "katana/Reduction.h"
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <iostream>
+#include <vector>
 
 #include "katana/Galois.h"
 
@@ -86,6 +88,117 @@ test_accum() {
   KATANA_LOG_ASSERT(accum.reduce() == num);
 }
 
+void
+test_min_max_floating() {
+  katana::GReduceMax<double> max;
+  katana::GReduceMin<double> min;
+  katana::do_all(katana::iterate(0, 100), [&](int i) {
+    max.update(-1.0 - i);
+    min.update(1.0 + i);
+  });
+
+  KATANA_LOG_ASSERT(max.reduce() == -1.0);
+  KATANA_LOG_ASSERT(min.reduce() == 1.0);
+}
+
+void
+test_histogram() {
+  constexpr int num = 10000;
+  katana::GHistogram<> histogram(7);
+
+  katana::do_all(
+      katana::iterate(0, num), [&](int i) { histogram.update(i % 7); });
+  histogram.update(3, 10);
+
+  std::vector<uint64_t>& counts = histogram.reduce();
+  KATANA_LOG_ASSERT(counts.size() == histogram.num_bins());
+  for (size_t bin = 0; bin < counts.size(); ++bin) {
+    uint64_t expected = num / 7 + (bin < size_t{num % 7}) + (bin == 3 ? 10 : 0);
+    KATANA_LOG_VASSERT(counts[bin] == expected, "bin {}", bin);
+  }
+}
+
+void
+test_vector_accumulator() {
+  constexpr int num = 10000;
+  katana::GVectorAccumulator<double> sums(3);
+
+  katana::do_all(katana::iterate(0, num), [&](int i) {
+    sums.update(i % 3, 0.5);
+    sums.update(std::vector<double>{0.0, 0.0, 1.0});
+  });
+
+  std::vector<double>& result = sums.reduce();
+  KATANA_LOG_ASSERT(result.size() == sums.size());
+  KATANA_LOG_ASSERT(result[0] == 0.5 * (num / 3 + 1));
+  KATANA_LOG_ASSERT(result[1] == 0.5 * (num / 3));
+  KATANA_LOG_ASSERT(result[2] == 0.5 * (num / 3) + num);
+}
+
+void
+test_deterministic_accumulator() {
+  // values whose float sum depends on the order of the additions
+  constexpr int num = 100000;
+  auto value = [](int i) {
+    return (i % 2 ? -1.0 : 1.0) * std::ldexp(1.0 + i, (i * 37) % 200 - 100);
+  };
+
+  katana::GDeterministicAccumulator<double> serial;
+  for (int i = num - 1; i >= 0; --i) {
+    serial += value(i);
+  }
+  double expected = serial.reduce();
+
+  for (unsigned num_threads :
+       {1U, 2U, katana::GetThreadPool().getMaxUsableThreads()}) {
+    unsigned old_threads = katana::getActiveThreads();
+    katana::setActiveThreads(num_threads);
+    katana::GDeterministicAccumulator<double> sum;
+    katana::do_all(
+        katana::iterate(0, num), [&](int i) { sum += value(i); },
+        katana::steal(), katana::chunk_size<16>());
+    KATANA_LOG_VASSERT(
+        sum.reduce() == expected, "{} threads: {} != {}", num_threads,
+        sum.reduce(), expected);
+    katana::setActiveThreads(old_threads);
+  }
+
+  // cancellation that a double sum gets wrong
+  katana::GDeterministicAccumulator<double> cancel;
+  cancel += 1e100;
+  cancel += 1.0;
+  cancel -= 1e100;
+  KATANA_LOG_ASSERT(cancel.reduce() == 1.0);
+  cancel.reset();
+  cancel += -0.75;
+  cancel += std::numeric_limits<double>::denorm_min();
+  KATANA_LOG_ASSERT(cancel.reduce() == -0.75);
+  cancel += std::numeric_limits<double>::infinity();
+  KATANA_LOG_ASSERT(std::isinf(cancel.reduce()));
+
+  katana::GDeterministicAccumulator<float> empty;
+  KATANA_LOG_ASSERT(empty.reduce() == 0.0f);
+}
+
+void
+test_top_k() {
+  constexpr int num = 10000;
+  katana::GReduceTopK<int> top(5);
+
+  // a permutation of [0, num) so that the largest values show up on
+  // different threads
+  katana::do_all(
+      katana::iterate(0, num), [&](int i) { top.update((i * 7919) % num); });
+
+  KATANA_LOG_ASSERT(
+      top.reduce() == std::vector<int>({9999, 9998, 9997, 9996, 9995}));
+
+  katana::GReduceTopK<int> few(5);
+  few.update(1);
+  few.update(2);
+  KATANA_LOG_ASSERT(few.reduce() == std::vector<int>({2, 1}));
+}
+
 int
 main() {
   katana::GaloisRuntime sys;
@@ -99,6 +212,11 @@ main() {
   test_move();
   test_max();
   test_accum();
+  test_min_max_floating();
+  test_histogram();
+  test_vector_accumulator();
+  test_deterministic_accumulator();
+  test_top_k();
 
   return 0;
 }
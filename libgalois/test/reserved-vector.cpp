@@ -0,0 +1,114 @@
+#include "katana/ReservedVector.h"
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/PageAlloc.h"
+
+namespace {
+
+size_t
+TotalBytes(const katana::PageAllocStats& stats) {
+  return stats.hugetlb_bytes + stats.transparent_bytes + stats.small_bytes;
+}
+
+/// Growing commits memory without moving the objects
+void
+TestGrowInPlace() {
+  constexpr size_t kMaxSize = size_t{1} << 30;
+  katana::PageAllocStats before = katana::GetPageAllocStats();
+
+  katana::ReservedVector<uint64_t> vec(kMaxSize);
+  KATANA_LOG_ASSERT(vec.max_size() == kMaxSize);
+  KATANA_LOG_ASSERT(vec.empty() && vec.capacity() == 0);
+  // reserving address space costs no memory
+  KATANA_LOG_ASSERT(
+      TotalBytes(katana::GetPageAllocStats()) == TotalBytes(before));
+
+  const uint64_t* data = vec.data();
+  const size_t num = 3 * katana::allocSize() / sizeof(uint64_t) + 5;
+  for (size_t i = 0; i < num; ++i) {
+    vec.push_back(i);
+  }
+  KATANA_LOG_ASSERT(vec.data() == data);
+  KATANA_LOG_ASSERT(vec.size() == num);
+  KATANA_LOG_ASSERT(vec.capacity() >= num);
+  KATANA_LOG_ASSERT(
+      TotalBytes(katana::GetPageAllocStats()) ==
+      TotalBytes(before) + 4 * katana::allocSize());
+  for (size_t i = 0; i < num; ++i) {
+    KATANA_LOG_ASSERT(vec[i] == i);
+  }
+
+  // resize faults in the new pages on every thread
+  vec.resize(num * 4);
+  KATANA_LOG_ASSERT(vec.data() == data);
+  katana::do_all(katana::iterate(num, vec.size()), [&](size_t i) {
+    vec[i] = i;
+  });
+  KATANA_LOG_ASSERT(vec.back() == num * 4 - 1);
+  KATANA_LOG_ASSERT(vec.front() == 0);
+
+  std::vector<uint64_t> more(100);
+  std::iota(more.begin(), more.end(), num * 4);
+  vec.insert(vec.end(), more.begin(), more.end());
+  KATANA_LOG_ASSERT(vec.size() == num * 4 + 100);
+  for (size_t i = 0; i < vec.size(); ++i) {
+    KATANA_LOG_ASSERT(vec[i] == i);
+  }
+
+  katana::ReservedVector<uint64_t> moved = std::move(vec);
+  KATANA_LOG_ASSERT(moved.data() == data);
+  KATANA_LOG_ASSERT(vec.empty() && vec.max_size() == 0);
+  moved = katana::ReservedVector<uint64_t>();
+
+  katana::PageAllocStats after = katana::GetPageAllocStats();
+  KATANA_LOG_ASSERT(after.transparent_bytes == before.transparent_bytes);
+  KATANA_LOG_ASSERT(after.small_bytes == before.small_bytes);
+}
+
+/// Committed memory is charged to the category of the reservation
+void
+TestCategory() {
+  auto& ms = katana::MemorySupervisor::Get();
+  auto before = ms.GetMemoryBreakdown();
+
+  katana::ReservedVector<uint32_t> vec;
+  {
+    katana::MemoryCategoryScope scope(katana::MemoryCategory::kTopology);
+    vec = katana::ReservedVector<uint32_t>(size_t{1} << 28);
+  }
+  KATANA_LOG_ASSERT(
+      ms.GetMemoryBreakdown()["large_alloc.topology"] ==
+      before["large_alloc.topology"]);
+
+  vec.resize(katana::allocSize());
+  auto during = ms.GetMemoryBreakdown();
+  KATANA_LOG_ASSERT(
+      during["large_alloc.topology"] ==
+      before["large_alloc.topology"] +
+          static_cast<katana::count_t>(
+              katana::allocSize() * sizeof(uint32_t)));
+  KATANA_LOG_ASSERT(during["large_alloc.other"] == before["large_alloc.other"]);
+
+  vec = katana::ReservedVector<uint32_t>();
+  KATANA_LOG_ASSERT(
+      ms.GetMemoryBreakdown()["large_alloc.topology"] ==
+      before["large_alloc.topology"]);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime sys;
+
+  TestGrowInPlace();
+  TestCategory();
+
+  return 0;
+}
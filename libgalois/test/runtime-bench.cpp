@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Bag.h"
+#include "katana/Barrier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Threads.h"
+
+/// Microbenchmarks of the runtime primitives that the analytics pick
+/// between: loop overhead, worklists, barriers, per-thread storage,
+/// reductions and NUMA placement. Every benchmark sweeps the thread count,
+/// its first argument, over powers of two up to the hardware threads.
+
+namespace {
+
+void
+ThreadArguments(benchmark::internal::Benchmark* b) {
+  long max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (long threads = 1; threads < max_threads; threads *= 2) {
+    b->Args({threads});
+  }
+  b->Args({max_threads});
+  b->UseRealTime();
+}
+
+template <long... Sizes>
+void
+ThreadSizeArguments(benchmark::internal::Benchmark* b) {
+  long max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (long size : {Sizes...}) {
+    for (long threads = 1; threads < max_threads; threads *= 2) {
+      b->Args({threads, size});
+    }
+    b->Args({max_threads, size});
+  }
+  b->UseRealTime();
+}
+
+unsigned
+SetThreads(benchmark::State& state) {
+  unsigned threads = katana::setActiveThreads(state.range(0));
+  state.counters["Threads"] = threads;
+  return threads;
+}
+
+/// The cost of a do_all of size empty iterations, i.e., of starting the
+/// threads, handing out the range and the final barrier
+template <bool Steal>
+void
+DoAllOverhead(benchmark::State& state) {
+  SetThreads(state);
+  uint32_t size = state.range(1);
+
+  auto body = [](uint32_t i) { benchmark::DoNotOptimize(i); };
+  for (auto _ : state) {
+    if constexpr (Steal) {
+      katana::do_all(
+          katana::iterate(uint32_t{0}, size), body, katana::steal(),
+          katana::no_stats());
+    } else {
+      katana::do_all(
+          katana::iterate(uint32_t{0}, size), body, katana::no_stats());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Every work item in the worklist benchmarks carries a count of the items
+// that are still to be pushed after it, in its low bits.
+constexpr uint32_t kDepthBits = 5;
+constexpr uint32_t kDepth = 16;
+
+struct DepthIndexer {
+  uint32_t operator()(uint32_t item) const {
+    return item & ((1 << kDepthBits) - 1);
+  }
+};
+
+/// Throughput of a worklist under for_each: every initial item pushes a
+/// chain of kDepth items, one at a time
+template <typename WL>
+void
+WorklistThroughput(benchmark::State& state) {
+  SetThreads(state);
+  uint32_t size = state.range(1);
+  std::vector<uint32_t> initial(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    initial[i] = i << kDepthBits | kDepth;
+  }
+  std::atomic<uint64_t> processed{0};
+
+  for (auto _ : state) {
+    katana::for_each(
+        katana::iterate(initial),
+        [&](uint32_t item, auto& ctx) {
+          processed.fetch_add(1, std::memory_order_relaxed);
+          if (item & ((1 << kDepthBits) - 1)) {
+            ctx.push(item - 1);
+          }
+        },
+        katana::wl<WL>(), katana::disable_conflict_detection(),
+        katana::no_stats());
+  }
+
+  KATANA_LOG_ASSERT(
+      processed ==
+      static_cast<uint64_t>(state.iterations()) * size * (kDepth + 1));
+  state.SetItemsProcessed(processed);
+}
+
+using ChunkFIFO = katana::ChunkFIFO<64>;
+using ChunkLIFO = katana::ChunkLIFO<64>;
+using PerSocketChunkFIFO = katana::PerSocketChunkFIFO<64>;
+using PerSocketChunkLIFO = katana::PerSocketChunkLIFO<64>;
+using PerThreadChunkFIFO = katana::PerThreadChunkFIFO<64>;
+using Obim = katana::OrderedByIntegerMetric<
+    DepthIndexer, katana::PerSocketChunkFIFO<64>>;
+
+/// Concurrent pushes into an InsertBag, as do_all loops that collect
+/// their output do
+void
+InsertBagPush(benchmark::State& state) {
+  SetThreads(state);
+  uint32_t size = state.range(1);
+  katana::InsertBag<uint32_t> bag;
+
+  for (auto _ : state) {
+    bag.clear();
+    katana::do_all(
+        katana::iterate(uint32_t{0}, size), [&](uint32_t i) { bag.push(i); },
+        katana::no_stats());
+  }
+
+  KATANA_LOG_ASSERT(
+      static_cast<uint32_t>(std::distance(bag.begin(), bag.end())) == size);
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+constexpr unsigned kBarrierRounds = 1024;
+
+/// Latency of a barrier: every thread waits kBarrierRounds times
+template <std::unique_ptr<katana::Barrier> (*Create)(unsigned)>
+void
+BarrierWait(benchmark::State& state) {
+  unsigned threads = SetThreads(state);
+  std::unique_ptr<katana::Barrier> barrier = Create(threads);
+  barrier->Reinit(threads);
+  state.SetLabel(barrier->name());
+
+  for (auto _ : state) {
+    katana::on_each([&](unsigned, unsigned) {
+      for (unsigned i = 0; i < kBarrierRounds; ++i) {
+        barrier->Wait();
+      }
+    });
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBarrierRounds);
+}
+
+constexpr unsigned kStorageAccesses = 1 << 16;
+
+/// Accesses of each thread to its own element of a PerThreadStorage or, if
+/// Remote, to the element of the next thread
+template <bool Remote>
+void
+PerThreadStorageAccess(benchmark::State& state) {
+  unsigned threads = SetThreads(state);
+  katana::PerThreadStorage<uint64_t> storage;
+
+  for (auto _ : state) {
+    katana::on_each([&](unsigned tid, unsigned num) {
+      for (unsigned i = 0; i < kStorageAccesses; ++i) {
+        uint64_t* value =
+            Remote ? storage.getRemote((tid + 1) % num) : storage.getLocal();
+        benchmark::DoNotOptimize(*value += i);
+      }
+    });
+  }
+
+  state.SetItemsProcessed(state.iterations() * threads * kStorageAccesses);
+}
+
+/// A sum over a do_all with a reduction, compared against a single atomic
+/// counter that every iteration updates
+template <typename Reducer>
+void
+Reduce(benchmark::State& state) {
+  SetThreads(state);
+  uint32_t size = state.range(1);
+  Reducer reducer;
+
+  for (auto _ : state) {
+    reducer.reset();
+    katana::do_all(
+        katana::iterate(uint32_t{0}, size),
+        [&](uint32_t i) { reducer.update(i); }, katana::no_stats());
+    benchmark::DoNotOptimize(reducer.reduce());
+  }
+
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+/// The atomic counter the reductions are compared against
+class AtomicCounter {
+public:
+  void reset() { value_ = 0; }
+  void update(uint64_t v) { value_.fetch_add(v, std::memory_order_relaxed); }
+  uint64_t reduce() const { return value_; }
+
+private:
+  std::atomic<uint64_t> value_{0};
+};
+
+using GAccumulator = katana::GAccumulator<uint64_t>;
+using GReduceMax = katana::GReduceMax<uint64_t>;
+
+enum Placement { kInterleaved, kBlocked, kLocal, kFloating };
+
+constexpr long kPlacementSize = 1 << 24;
+
+/// Bandwidth of a parallel pass over a NUMAArray, by how its pages are
+/// placed. The floating array is first touched by a parallel pass, so its
+/// pages end up blocked as well, but by the threads of the do_all.
+template <Placement P>
+void
+NUMAPlacement(benchmark::State& state) {
+  SetThreads(state);
+  katana::NUMAArray<uint64_t> array;
+  switch (P) {
+  case kInterleaved:
+    array.allocateInterleaved(kPlacementSize);
+    break;
+  case kBlocked:
+    array.allocateBlocked(kPlacementSize);
+    break;
+  case kLocal:
+    array.allocateLocal(kPlacementSize);
+    break;
+  case kFloating:
+    array.allocateFloating(kPlacementSize);
+    break;
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, array.size()), [&](size_t i) { array[i] = i; },
+      katana::no_stats());
+
+  for (auto _ : state) {
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(
+        katana::iterate(size_t{0}, array.size()),
+        [&](size_t i) { sum += array[i]; }, katana::no_stats());
+    benchmark::DoNotOptimize(sum.reduce());
+  }
+
+  state.SetBytesProcessed(
+      state.iterations() * array.size() * sizeof(uint64_t));
+}
+
+BENCHMARK_TEMPLATE(DoAllOverhead, false)
+    ->Apply(ThreadSizeArguments<0, 1024, 1024 * 1024>);
+BENCHMARK_TEMPLATE(DoAllOverhead, true)
+    ->Apply(ThreadSizeArguments<0, 1024, 1024 * 1024>);
+
+BENCHMARK_TEMPLATE(WorklistThroughput, ChunkFIFO)
+    ->Apply(ThreadSizeArguments<64 * 1024>);
+BENCHMARK_TEMPLATE(WorklistThroughput, ChunkLIFO)
+    ->Apply(ThreadSizeArguments<64 * 1024>);
+BENCHMARK_TEMPLATE(WorklistThroughput, PerSocketChunkFIFO)
+    ->Apply(ThreadSizeArguments<64 * 1024>);
+BENCHMARK_TEMPLATE(WorklistThroughput, PerSocketChunkLIFO)
+    ->Apply(ThreadSizeArguments<64 * 1024>);
+BENCHMARK_TEMPLATE(WorklistThroughput, PerThreadChunkFIFO)
+    ->Apply(ThreadSizeArguments<64 * 1024>);
+BENCHMARK_TEMPLATE(WorklistThroughput, Obim)
+    ->Apply(ThreadSizeArguments<64 * 1024>);
+BENCHMARK(InsertBagPush)->Apply(ThreadSizeArguments<1024 * 1024>);
+
+BENCHMARK_TEMPLATE(BarrierWait, katana::CreateCountingBarrier)
+    ->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(BarrierWait, katana::CreateDisseminationBarrier)
+    ->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(BarrierWait, katana::CreateMCSBarrier)
+    ->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(BarrierWait, katana::CreateTopoBarrier)
+    ->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(BarrierWait, katana::CreateTreeBarrier)
+    ->Apply(ThreadArguments);
+// TODO(amp): Add katana::CreateSimpleBarrier when it is fixed. It is broken
+// and deadlocks (see barriers.cpp).
+
+BENCHMARK_TEMPLATE(PerThreadStorageAccess, false)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(PerThreadStorageAccess, true)->Apply(ThreadArguments);
+
+BENCHMARK_TEMPLATE(Reduce, AtomicCounter)
+    ->Apply(ThreadSizeArguments<1024 * 1024>);
+BENCHMARK_TEMPLATE(Reduce, GAccumulator)
+    ->Apply(ThreadSizeArguments<1024 * 1024>);
+BENCHMARK_TEMPLATE(Reduce, GReduceMax)->Apply(ThreadSizeArguments<1024 * 1024>);
+
+BENCHMARK_TEMPLATE(NUMAPlacement, kInterleaved)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(NUMAPlacement, kBlocked)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(NUMAPlacement, kLocal)->Apply(ThreadArguments);
+BENCHMARK_TEMPLATE(NUMAPlacement, kFloating)->Apply(ThreadArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::GaloisRuntime G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
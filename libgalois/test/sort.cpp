@@ -92,6 +92,87 @@ do_sort() {
   return 0;
 }
 
+int
+do_radix_sort() {
+  unsigned M = katana::GetThreadPool().getMaxThreads();
+  std::cout << "radix_sort:\n";
+
+  while (M) {
+    katana::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    // (key, position) pairs check that equal keys keep their order
+    std::vector<std::pair<uint64_t, uint64_t>> V(vectorSize);
+    for (size_t i = 0; i < V.size(); ++i) {
+      V[i] = std::make_pair(RandomNumber(), i);
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> C = V;
+
+    katana::Timer t;
+    t.start();
+    katana::ParallelSTL::radix_sort(
+        V.begin(), V.end(), [](const auto& p) { return p.first; });
+    t.stop();
+
+    katana::Timer t2;
+    t2.start();
+    std::sort(C.begin(), C.end());
+    t2.stop();
+
+    bool eq = std::equal(C.begin(), C.end(), V.begin());
+
+    std::cout << "Galois: " << t.get() << " STL: " << t2.get()
+              << " Equal: " << eq << "\n";
+    if (!eq) {
+      return 1;
+    }
+
+    M >>= 1;
+  }
+
+  return 0;
+}
+
+int
+do_sample_sort() {
+  unsigned M = katana::GetThreadPool().getMaxThreads();
+  std::cout << "sample_sort:\n";
+
+  while (M) {
+    katana::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    // few distinct keys exercise the buckets of elements equal to splitters
+    std::vector<std::pair<unsigned, unsigned>> V(vectorSize);
+    for (auto& p : V) {
+      p = std::make_pair(RandomNumber() % 16, RandomNumber());
+    }
+    std::vector<std::pair<unsigned, unsigned>> C = V;
+
+    katana::Timer t;
+    t.start();
+    katana::ParallelSTL::sample_sort(V.begin(), V.end(), std::greater<>());
+    t.stop();
+
+    katana::Timer t2;
+    t2.start();
+    std::sort(C.begin(), C.end(), std::greater<>());
+    t2.stop();
+
+    bool eq = std::equal(C.begin(), C.end(), V.begin());
+
+    std::cout << "Galois: " << t.get() << " STL: " << t2.get()
+              << " Equal: " << eq << "\n";
+    if (!eq) {
+      return 1;
+    }
+
+    M >>= 1;
+  }
+
+  return 0;
+}
+
 int
 do_count_if() {
   unsigned M = katana::GetThreadPool().getMaxThreads();
@@ -176,5 +257,7 @@ main(int argc, char** argv) {
   //  ret |= do_sort();
   //  ret |= do_count_if();
   ret |= do_accumulate();
+  ret |= do_radix_sort();
+  ret |= do_sample_sort();
   return ret;
 }
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reservations.h"
+
+namespace {
+
+using Edge = std::pair<uint32_t, uint32_t>;
+
+std::vector<Edge>
+RandomEdges(uint32_t num_nodes, size_t num_edges) {
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  std::vector<Edge> edges;
+  while (edges.size() < num_edges) {
+    uint32_t u = node(gen);
+    uint32_t v = node(gen);
+    if (u != v) {
+      edges.emplace_back(u, v);
+    }
+  }
+  return edges;
+}
+
+/// Greedy maximal matching taking edges in order
+struct MatchingStep {
+  const std::vector<Edge>& edges;
+  katana::Reservations& reservations;
+  std::vector<std::atomic<bool>>& matched;
+  std::vector<std::atomic<bool>>& in_matching;
+
+  bool Reserve(uint64_t it) {
+    auto [u, v] = edges[it];
+    if (matched[u] || matched[v]) {
+      return false;
+    }
+    reservations.Reserve(u, it);
+    reservations.Reserve(v, it);
+    return true;
+  }
+
+  bool Commit(uint64_t it) {
+    auto [u, v] = edges[it];
+    bool won = reservations.Holds(u, it) && reservations.Holds(v, it);
+    if (won) {
+      matched[u] = true;
+      matched[v] = true;
+      in_matching[it] = true;
+    }
+    reservations.Release(u, it);
+    reservations.Release(v, it);
+    return won;
+  }
+};
+
+/// The matching is the one a serial loop over the edges finds
+void
+TestMatching(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  constexpr uint32_t kNumNodes = 10000;
+  std::vector<Edge> edges = RandomEdges(kNumNodes, 50000);
+
+  std::vector<bool> expected_matched(kNumNodes, false);
+  std::vector<bool> expected(edges.size(), false);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    auto [u, v] = edges[i];
+    if (!expected_matched[u] && !expected_matched[v]) {
+      expected_matched[u] = expected_matched[v] = true;
+      expected[i] = true;
+    }
+  }
+
+  katana::Reservations reservations(kNumNodes);
+  std::vector<std::atomic<bool>> matched(kNumNodes);
+  std::vector<std::atomic<bool>> in_matching(edges.size());
+  MatchingStep step{edges, reservations, matched, in_matching};
+  katana::speculative_for(
+      0, edges.size(), step, katana::loopname("SpeculativeFor-Matching"));
+
+  for (size_t i = 0; i < edges.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        in_matching[i] == expected[i], "threads {}: edge {} is {}matched",
+        num_threads, i, in_matching[i] ? "" : "not ");
+  }
+}
+
+/// Iterations that all write one location commit in id order
+void
+TestSerialized(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  constexpr uint64_t kNumIterations = 2000;
+  katana::Reservations reservations(1);
+  std::vector<uint64_t> order;
+
+  struct Step {
+    katana::Reservations& reservations;
+    std::vector<uint64_t>& order;
+
+    bool Reserve(uint64_t it) {
+      reservations.Reserve(0, it);
+      return true;
+    }
+    bool Commit(uint64_t it) {
+      if (!reservations.Holds(0, it)) {
+        return false;
+      }
+      order.emplace_back(it);
+      reservations.Release(0, it);
+      return true;
+    }
+  } step{reservations, order};
+  katana::speculative_for(0, kNumIterations, step);
+
+  KATANA_LOG_ASSERT(order.size() == kNumIterations);
+  for (uint64_t i = 0; i < kNumIterations; ++i) {
+    KATANA_LOG_VASSERT(
+        order[i] == i, "threads {}: commit {} is {}", num_threads, i,
+        order[i]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  for (unsigned threads : {1U, 2U, max_threads}) {
+    TestMatching(threads);
+    TestSerialized(threads);
+  }
+
+  return 0;
+}
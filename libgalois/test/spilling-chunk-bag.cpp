@@ -0,0 +1,90 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SpillingChunk.h"
+
+namespace {
+
+constexpr uint32_t kNumItems = 1 << 20;
+
+/// With a budget of one chunk, almost every chunk goes to the spill file and
+/// still comes back out exactly once
+void
+TestPushPop() {
+  katana::SpillingChunkBag<64, uint32_t> wl(1);
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    wl.push(i);
+  }
+  KATANA_LOG_VASSERT(
+      wl.spilled() > kNumItems / 64 - 4, "only {} chunks spilled",
+      wl.spilled());
+
+  std::vector<int> seen(kNumItems);
+  uint32_t popped = 0;
+  while (std::optional<uint32_t> item = wl.pop()) {
+    KATANA_LOG_ASSERT(*item < kNumItems);
+    ++seen[*item];
+    ++popped;
+    if (popped == kNumItems / 2) {
+      // pushes after pops spill and come back too
+      for (uint32_t i = 0; i < kNumItems; ++i) {
+        wl.push(i);
+      }
+    }
+  }
+  KATANA_LOG_ASSERT(wl.spilled() == 0);
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_VASSERT(seen[i] == 2, "item {} popped {} times", i, seen[i]);
+  }
+}
+
+/// Every node of a complete binary tree pushes its children, in rounds, with
+/// a frontier larger than the budget
+void
+TestBulkSynchronous(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  std::vector<std::atomic<int>> visits(kNumItems);
+  std::vector<uint32_t> roots{0};
+  katana::for_each(
+      katana::iterate(roots),
+      [&](uint32_t x, katana::UserContext<uint32_t>& ctx) {
+        visits[x].fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t child : {2 * x + 1, 2 * x + 2}) {
+          if (child < kNumItems) {
+            ctx.push(child);
+          }
+        }
+      },
+      katana::wl<katana::BulkSynchronous<katana::SpillingChunkBag<>>>(),
+      katana::disable_conflict_detection(),
+      katana::loopname("SpillingChunkBag-Tree"));
+
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_VASSERT(
+        visits[i] == 1, "threads {}: item {} visited {} times", num_threads, i,
+        visits[i].load());
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  // the last round of the tree is 2MB
+  katana::SetEnv("KATANA_WORKLIST_SPILL_BUDGET_MB", "1", true);
+
+  TestPushPop();
+
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  for (unsigned threads : {1U, 2U, max_threads}) {
+    TestBulkSynchronous(threads);
+  }
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ThreadGroup.h"
+
+namespace {
+
+constexpr uint64_t kSize = 1 << 20;
+
+/// Run a do_all and a for_each on the threads of the calling thread and check
+/// that they see num_threads threads numbered from 0
+void
+RunLoops(unsigned num_threads) {
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == num_threads);
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::PerThreadStorage<uint64_t> per_thread;
+  KATANA_LOG_ASSERT(per_thread.size() >= num_threads);
+  std::atomic<bool> bad_tid{false};
+
+  katana::do_all(katana::iterate(uint64_t{0}, kSize), [&](uint64_t i) {
+    if (katana::ThreadPool::getTID() >= num_threads) {
+      bad_tid = true;
+    }
+    sum += i;
+    *per_thread.getLocal() += 1;
+  });
+  KATANA_LOG_ASSERT(!bad_tid);
+  KATANA_LOG_ASSERT(sum.reduce() == kSize * (kSize - 1) / 2);
+
+  uint64_t iterations = 0;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    iterations += *per_thread.getRemote(i);
+  }
+  KATANA_LOG_ASSERT(iterations == kSize);
+
+  katana::GAccumulator<uint64_t> pushed;
+  katana::for_each(
+      katana::iterate({uint64_t{kSize}}),
+      [&](uint64_t n, auto& ctx) {
+        pushed += 1;
+        if (n > 1) {
+          ctx.push(n / 2);
+          ctx.push(n / 2);
+        }
+      },
+      katana::disable_conflict_detection());
+  // kSize is a power of two, so this is a full binary tree
+  KATANA_LOG_ASSERT(pushed.reduce() == 2 * kSize - 1);
+}
+
+void
+TestMake() {
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  KATANA_LOG_ASSERT(!katana::ThreadGroup::Make(0));
+  KATANA_LOG_ASSERT(!katana::ThreadGroup::Make(max_threads));
+  KATANA_LOG_ASSERT(katana::ThreadGroup::Current() == nullptr);
+}
+
+void
+TestConcurrent(unsigned group_threads) {
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+
+  auto group_result = katana::ThreadGroup::Make(group_threads);
+  KATANA_LOG_ASSERT(group_result);
+  auto group = std::move(group_result.value());
+  KATANA_LOG_ASSERT(group->size() == group_threads);
+
+  unsigned pool_threads = max_threads - group_threads;
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == pool_threads);
+
+  std::thread request([&]() {
+    group->Run([&]() {
+      KATANA_LOG_ASSERT(katana::ThreadGroup::Current() == group.get());
+      KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == group_threads);
+      for (int i = 0; i < 4; ++i) {
+        RunLoops(group_threads);
+      }
+    });
+  });
+  for (int i = 0; i < 4; ++i) {
+    RunLoops(pool_threads);
+  }
+  request.join();
+
+  // the pool gets the threads of the group back
+  group.reset();
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == max_threads);
+  RunLoops(max_threads);
+}
+
+/// Reductions see the updates of every thread, whether the group that made
+/// them is that of the caller of reduce or not
+void
+TestReduceAcrossGroups(unsigned group_threads) {
+  auto group_result = katana::ThreadGroup::Make(group_threads);
+  KATANA_LOG_ASSERT(group_result);
+  auto group = std::move(group_result.value());
+
+  // made outside the group, updated in it and reduced outside of it
+  katana::GAccumulator<uint64_t> sum;
+  katana::GReduceMin<uint64_t> min;
+  std::thread request([&]() {
+    group->Run([&]() {
+      katana::do_all(katana::iterate(uint64_t{0}, kSize), [&](uint64_t i) {
+        sum += i;
+        min.update(i + 5);
+      });
+    });
+  });
+  request.join();
+  KATANA_LOG_ASSERT(sum.reduce() == kSize * (kSize - 1) / 2);
+  KATANA_LOG_ASSERT(min.reduce() == 5);
+
+  // updated outside the group and reduced in it
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kSize), [&](uint64_t i) { sum += i; });
+  uint64_t group_sum = 0;
+  std::thread other_request([&]() {
+    group->Run([&]() {
+      group_sum = sum.reduce();
+      sum.reset();
+    });
+  });
+  other_request.join();
+  KATANA_LOG_ASSERT(group_sum == kSize * (kSize - 1) / 2);
+  KATANA_LOG_ASSERT(sum.reduce() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  if (max_threads < 2) {
+    return 0;
+  }
+
+  TestMake();
+  TestConcurrent(1);
+  TestConcurrent(max_threads / 2);
+  TestConcurrent(max_threads - 1);
+  TestReduceAcrossGroups(1);
+  TestReduceAcrossGroups(max_threads - 1);
+
+  return 0;
+}
@@ -41,6 +41,10 @@ static cll::opt<int> trials(
     "trials", cll::desc("number of trials"), cll::init(1));
 static cll::opt<unsigned> threads(
     "threads", cll::desc("number of threads"), cll::init(2));
+static cll::opt<int> spinUs(
+    "spinUs",
+    cll::desc("microseconds idle threads spin before they park for DoAllSpin"),
+    cll::init(100));
 
 void
 runDoAllBurn(int num) {
@@ -64,6 +68,17 @@ runDoAll(int num) {
   }
 }
 
+void
+runDoAllSpin(int num) {
+  auto& tp = katana::GetThreadPool();
+  auto spin = tp.GetSpinBeforePark();
+  tp.SetSpinBeforePark(std::chrono::microseconds(spinUs));
+
+  runDoAll(num);
+
+  tp.SetSpinBeforePark(spin);
+}
+
 void
 runExplicitThread(int num) {
   katana::Barrier& barrier = katana::GetBarrier(katana::getActiveThreads());
@@ -111,6 +126,7 @@ main(int argc, char* argv[]) {
   for (int t = 0; t < trials; ++t) {
     run(runDoAll, "DoAll");
     run(runDoAllBurn, "DoAllBurn");
+    run(runDoAllSpin, "DoAllSpin");
     run(runExplicitThread, "ExplicitThread");
   }
   EXIT = 1;
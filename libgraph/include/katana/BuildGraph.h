@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <utility>
 #include <variant>
@@ -28,7 +29,7 @@ using NullMaps = std::pair<
     std::unordered_map<int, std::shared_ptr<arrow::Array>>,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>>;
 
-enum SourceType { kGraphml, kKatana };
+enum SourceType { kGraphml, kKatana, kCsv };
 enum SourceDatabase { kNone, kNeo4j, kMongodb, kMysql };
 enum ImportDataType {
   kString,
@@ -112,8 +113,12 @@ struct LabelsState {
 };
 
 struct TopologyState {
-  // maps node IDs to node indexes
+  // maps node IDs to node indexes, once the IDs are not dense
   std::unordered_map<std::string, size_t> node_indexes;
+  // while node i has ID std::to_string(i) for every i < num_dense_ids, IDs
+  // are parsed rather than put in node_indexes
+  bool dense_ids{true};
+  size_t num_dense_ids{0};
   // node's start of edge lists
   std::vector<uint64_t> out_indices;
   // edge list of destinations
@@ -125,9 +130,10 @@ struct TopologyState {
 
   // for schema mapping
   std::unordered_set<std::string> edge_ids;
-  // for data ingestion that does not guarantee nodes are imported first
-  std::unordered_map<size_t, std::string> sources_intermediate;
-  std::unordered_map<size_t, std::string> destinations_intermediate;
+  // edge indexes and IDs of the endpoints left to resolve, which are looked
+  // up in parallel once every node is known
+  std::vector<std::pair<size_t, std::string>> sources_intermediate;
+  std::vector<std::pair<size_t, std::string>> destinations_intermediate;
 };
 
 struct WriterProperties {
@@ -227,7 +233,10 @@ public:
   size_t GetEdges();
 
 private:
+  std::optional<size_t> FindNodeIndex(const std::string& id) const;
   void ResolveIntermediateIDs();
+  std::vector<uint32_t> ResolveEndpoints(
+      const std::vector<std::pair<size_t, std::string>>& pending);
   GraphComponent BuildFinalEdges(bool verbose);
 };
 
@@ -0,0 +1,224 @@
+#ifndef KATANA_LIBGRAPH_KATANA_CONCURRENTTOPOLOGYBUILDER_H_
+#define KATANA_LIBGRAPH_KATANA_CONCURRENTTOPOLOGYBUILDER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A topology builder for large graphs, which threads fill concurrently.
+/// Typical usage:
+/// ConcurrentTopologyBuilderImpl<> builder(num_nodes);
+/// katana::do_all(..., [&](...) { builder.AddEdge(src, dst); });
+/// GraphTopology topo = builder.ConvertToCSR();
+///
+/// AddEdge appends to a buffer of the calling thread, and ConvertToCSR
+/// builds the CSR with parallel count, prefix sum and scatter passes. Unlike
+/// TopologyBuilderImpl, which keeps the order edges were added in, the
+/// edges of each node come out sorted by destination, so the result does
+/// not depend on how threads interleaved. Without ALLOW_MULTI_EDGE,
+/// duplicate edges are dropped; with IS_SYMMETRIC, every edge is added in
+/// both directions.
+template <bool IS_SYMMETRIC = false, bool ALLOW_MULTI_EDGE = false>
+class ConcurrentTopologyBuilderImpl : public GraphTopologyTypes {
+  using EdgeBuffer = std::vector<std::pair<Node, Node>>;
+
+  /// Edges per work item of the passes over the buffers, so that a buffer
+  /// filled by a single thread is still processed in parallel
+  constexpr static size_t kBlockSize = size_t{1} << 16;
+
+public:
+  explicit ConcurrentTopologyBuilderImpl(size_t num_nodes = 0)
+      : num_nodes_(num_nodes) {}
+
+  /// Add num nodes without edges; not thread safe
+  void AddNodes(size_t num) noexcept { num_nodes_ += num; }
+
+  /// Add an edge from src to dst, and from dst to src if IS_SYMMETRIC. Safe
+  /// to call concurrently from the threads of katana parallel loops.
+  void AddEdge(Node src, Node dst) noexcept {
+    KATANA_LOG_DEBUG_ASSERT(src < num_nodes_ && dst < num_nodes_);
+    buffers_.getLocal()->emplace_back(src, dst);
+  }
+
+  size_t num_nodes() const noexcept { return num_nodes_; }
+
+  bool empty() const noexcept { return num_nodes() == size_t{0}; }
+
+  /// The number of AddEdge calls since the last ConvertToCSR; not thread
+  /// safe
+  size_t num_added_edges() const noexcept {
+    size_t res = 0;
+    for (unsigned t = 0; t < buffers_.size(); ++t) {
+      res += buffers_.getRemote(t)->size();
+    }
+    return res;
+  }
+
+  /// Build the topology of the nodes and edges added so far. The edge
+  /// buffers are freed as the edges are moved into the topology, so the
+  /// builder has no edges afterwards.
+  GraphTopology ConvertToCSR() {
+    std::vector<Block> blocks = MakeBlocks();
+
+    // count the edges of every node, then turn the counts into the first
+    // edge of every node, which the scatter bumps to the end
+    NUMAArray<std::atomic<Edge>> cursors;
+    cursors.allocateInterleaved(num_nodes_);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes_),
+        [&](size_t n) { cursors[n].store(0, std::memory_order_relaxed); },
+        katana::no_stats());
+    ForEachEdge(blocks, [&](Node src, Node) {
+      cursors[src].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    NUMAArray<Edge> adj_indices;
+    adj_indices.allocateInterleaved(num_nodes_);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes_),
+        [&](size_t n) {
+          adj_indices[n] = cursors[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes_),
+        [&](size_t n) {
+          cursors[n].store(Begin(adj_indices, n), std::memory_order_relaxed);
+        },
+        katana::no_stats());
+
+    const size_t num_edges = num_nodes_ == 0 ? 0 : adj_indices[num_nodes_ - 1];
+    NUMAArray<Node> dests;
+    dests.allocateInterleaved(num_edges);
+    ForEachEdge(blocks, [&](Node src, Node dst) {
+      dests[cursors[src].fetch_add(1, std::memory_order_relaxed)] = dst;
+    });
+    for (unsigned t = 0; t < buffers_.size(); ++t) {
+      EdgeBuffer().swap(*buffers_.getRemote(t));
+    }
+
+    // sort the edges of every node, and with unique edges, count the
+    // distinct ones into cursors
+    katana::GAccumulator<uint64_t> num_distinct;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes_),
+        [&](size_t n) {
+          Node* begin = dests.data() + Begin(adj_indices, n);
+          Node* end = dests.data() + adj_indices[n];
+          std::sort(begin, end);
+          if constexpr (!ALLOW_MULTI_EDGE) {
+            Edge degree = std::unique(begin, end) - begin;
+            cursors[n].store(degree, std::memory_order_relaxed);
+            num_distinct += degree;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    if constexpr (!ALLOW_MULTI_EDGE) {
+      if (num_distinct.reduce() != num_edges) {
+        return Compact(adj_indices, dests, cursors);
+      }
+    }
+    return GraphTopology{std::move(adj_indices), std::move(dests)};
+  }
+
+private:
+  /// Edges [begin, end) of the buffer of thread
+  struct Block {
+    unsigned thread;
+    size_t begin;
+    size_t end;
+  };
+
+  static Edge Begin(const NUMAArray<Edge>& adj_indices, size_t n) {
+    return n == 0 ? 0 : adj_indices[n - 1];
+  }
+
+  std::vector<Block> MakeBlocks() const {
+    std::vector<Block> blocks;
+    for (unsigned t = 0; t < buffers_.size(); ++t) {
+      size_t size = buffers_.getRemote(t)->size();
+      for (size_t begin = 0; begin < size; begin += kBlockSize) {
+        blocks.emplace_back(
+            Block{t, begin, std::min(begin + kBlockSize, size)});
+      }
+    }
+    return blocks;
+  }
+
+  /// Call fn(src, dst) for every edge in the buffers, and for its reverse if
+  /// IS_SYMMETRIC, in parallel
+  template <typename F>
+  void ForEachEdge(const std::vector<Block>& blocks, const F& fn) {
+    katana::do_all(
+        katana::iterate(blocks.begin(), blocks.end()),
+        [&](const Block& block) {
+          const EdgeBuffer& buffer = *buffers_.getRemote(block.thread);
+          for (size_t i = block.begin; i < block.end; ++i) {
+            auto [src, dst] = buffer[i];
+            fn(src, dst);
+            if constexpr (IS_SYMMETRIC) {
+              fn(dst, src);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+  /// Drop the duplicates that sorting moved to the end of the edges of
+  /// every node, where degrees holds the number of distinct edges
+  GraphTopology Compact(
+      const NUMAArray<Edge>& adj_indices, const NUMAArray<Node>& dests,
+      const NUMAArray<std::atomic<Edge>>& degrees) {
+    NUMAArray<Edge> new_adj_indices;
+    new_adj_indices.allocateInterleaved(num_nodes_);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes_),
+        [&](size_t n) {
+          new_adj_indices[n] = degrees[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        new_adj_indices.begin(), new_adj_indices.end(),
+        new_adj_indices.begin());
+
+    NUMAArray<Node> new_dests;
+    new_dests.allocateInterleaved(
+        num_nodes_ == 0 ? 0 : new_adj_indices[num_nodes_ - 1]);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes_),
+        [&](size_t n) {
+          const Node* begin = dests.data() + Begin(adj_indices, n);
+          std::copy(
+              begin, begin + (new_adj_indices[n] - Begin(new_adj_indices, n)),
+              new_dests.data() + Begin(new_adj_indices, n));
+        },
+        katana::steal(), katana::no_stats());
+    return GraphTopology{std::move(new_adj_indices), std::move(new_dests)};
+  }
+
+  size_t num_nodes_;
+  PerThreadStorage<EdgeBuffer> buffers_;
+};
+
+using AsymmetricConcurrentTopologyBuilder =
+    ConcurrentTopologyBuilderImpl<false>;
+using SymmetricConcurrentTopologyBuilder = ConcurrentTopologyBuilderImpl<true>;
+
+}  // namespace katana
+
+#endif
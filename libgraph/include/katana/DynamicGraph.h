@@ -0,0 +1,122 @@
+#ifndef KATANA_LIBGRAPH_KATANA_DYNAMICGRAPH_H_
+#define KATANA_LIBGRAPH_KATANA_DYNAMICGRAPH_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A property graph that takes batches of edge insertions and deletions
+/// without rebuilding its CSR topology for each batch.
+///
+/// The CSR of the graph does not change between merges. Inserted edges are
+/// appended to per-node delta blocks and deleted CSR edges are marked in a
+/// bitset, so a batch costs time in its size rather than in the size of the
+/// graph, and the edges of a node are the live CSR edges followed by its
+/// delta block. Once the updates since the last merge reach merge_fraction
+/// of the edges of the CSR, or on Merge(), they are merged into a new CSR
+/// graph. graph(), and every view and analytic run on it, sees the updates
+/// as of the last merge; OutDegree and ForEachOutNeighbor see them all.
+///
+/// Batches are applied in parallel over their source nodes. Inserted edges
+/// have null properties and the unknown entity type; deleted edges take
+/// their properties with them. Nodes cannot be added or removed.
+class KATANA_EXPORT DynamicGraph {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+  /// (source, destination) pairs
+  using EdgeList = std::vector<std::pair<Node, Node>>;
+
+  static constexpr double kDefaultMergeFraction = 0.1;
+
+  explicit DynamicGraph(
+      std::unique_ptr<PropertyGraph> pg,
+      double merge_fraction = kDefaultMergeFraction);
+
+  DynamicGraph(const DynamicGraph&) = delete;
+  DynamicGraph& operator=(const DynamicGraph&) = delete;
+  DynamicGraph(DynamicGraph&&) = default;
+  DynamicGraph& operator=(DynamicGraph&&) = default;
+
+  /// The graph as of the last merge
+  PropertyGraph* graph() noexcept { return pg_.get(); }
+  const PropertyGraph* graph() const noexcept { return pg_.get(); }
+
+  uint64_t NumNodes() const noexcept { return pg_->NumNodes(); }
+  /// The number of edges including the updates since the last merge
+  uint64_t NumEdges() const noexcept {
+    return pg_->NumEdges() - num_deleted_ + num_inserted_;
+  }
+
+  /// The number of edges inserted and deleted since the last merge
+  uint64_t NumPendingUpdates() const noexcept {
+    return num_inserted_ + num_deleted_;
+  }
+
+  /// Insert \p edges, merging if the pending updates reach the merge
+  /// fraction. Parallel edges are allowed. Fails with InvalidArgument,
+  /// without inserting any edge, if an edge has an end that is not a node.
+  Result<void> InsertEdges(const EdgeList& edges);
+
+  /// Delete one edge from source to destination for every pair in \p
+  /// edges, merging if the pending updates reach the merge fraction. Pairs
+  /// without a matching edge are skipped. Fails with InvalidArgument,
+  /// without deleting any edge, if an edge has an end that is not a node.
+  ///
+  /// \returns the number of edges deleted
+  Result<uint64_t> DeleteEdges(const EdgeList& edges);
+
+  /// Merge the pending updates into a new CSR graph, which replaces
+  /// graph(). Views built on the previous graph must not be used after a
+  /// merge.
+  Result<void> Merge();
+
+  uint64_t OutDegree(Node node) const noexcept {
+    uint64_t degree = inserted_[node].size();
+    for (auto e : pg_->topology().OutEdges(node)) {
+      degree += !deleted_.test(e);
+    }
+    return degree;
+  }
+
+  /// Call fn(destination) for every out-edge of \p node, including the
+  /// updates since the last merge
+  template <typename F>
+  void ForEachOutNeighbor(Node node, F fn) const {
+    const GraphTopology& topo = pg_->topology();
+    for (auto e : topo.OutEdges(node)) {
+      if (!deleted_.test(e)) {
+        fn(topo.OutEdgeDst(e));
+      }
+    }
+    for (Node dst : inserted_[node]) {
+      fn(dst);
+    }
+  }
+
+private:
+  Result<void> CheckEdges(const EdgeList& edges) const;
+  Result<void> MergeIfNeeded();
+  void ResetUpdates();
+
+  std::unique_ptr<PropertyGraph> pg_;
+  double merge_fraction_;
+  /// The delta block of every node: destinations of its inserted edges
+  std::vector<std::vector<Node>> inserted_;
+  /// The deleted edges of the CSR
+  DynamicBitset deleted_;
+  uint64_t num_inserted_{0};
+  uint64_t num_deleted_{0};
+};
+
+}  // namespace katana
+
+#endif
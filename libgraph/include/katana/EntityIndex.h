@@ -1,9 +1,13 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 #define KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 
-#include <set>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
@@ -11,6 +15,8 @@
 #include <boost/iterator/iterator_categories.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/EntityIndexPrimitive.h"
+#include "katana/NUMAArray.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
@@ -21,26 +27,28 @@ namespace katana {
 template <typename node_or_edge>
 class KATANA_EXPORT EntityIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexID {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexID, bool, uint8_t, int64_t, uint64_t, double_t, std::string_view*>;
-
-  // EntityIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
+  // EntityIndex::iterator returns a sequence of node or edge ids in the order
+  // of their property values, with ties in the order of the ids.
+  class iterator : public boost::iterator_facade<
+                       iterator, const node_or_edge,
+                       boost::random_access_traversal_tag> {
   public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    iterator() : base_iterator(0) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexID>(base_iterator::operator*()).id;
+    explicit iterator(const node_or_edge* pos) : pos_(pos) {}
+    iterator() : pos_(nullptr) {}
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const node_or_edge& dereference() const { return *pos_; }
+    bool equal(const iterator& other) const { return pos_ == other.pos_; }
+    void increment() { ++pos_; }
+    void decrement() { --pos_; }
+    void advance(std::ptrdiff_t n) { pos_ += n; }
+    std::ptrdiff_t distance_to(const iterator& other) const {
+      return other.pos_ - pos_;
     }
+
+    const node_or_edge* pos_;
   };
 
   EntityIndex(std::string property_name)
@@ -53,183 +61,231 @@ public:
 
   virtual ~EntityIndex() = default;
 
+  // The id FindMany returns for keys that are null or not in the index.
+  static constexpr node_or_edge kNotFound =
+      std::numeric_limits<node_or_edge>::max();
+
   // The name of the indexed property.
   std::string property_name() { return property_name_; }
 
   virtual iterator begin() = 0;
   virtual iterator end() = 0;
 
+  // Returns, for each of `keys`, the first id in the index with that property
+  // value, or kNotFound. Keys of another type than the property are cast to
+  // its type. Resolving a batch of keys at once spreads the searches over the
+  // threads and overlaps their memory accesses, so it is much faster than
+  // calling Find for each key.
+  virtual Result<NUMAArray<node_or_edge>> FindMany(
+      const arrow::Array& keys) = 0;
+
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Build the index from the sorted ids of a stored index, reading only the
+  // values of the property. Fails if the ids do not match the property.
+  virtual Result<void> BuildFromFile(const EntityIndexPrimitive& primitive) = 0;
 
 private:
   std::string property_name_;
 };
 
 // PrimitiveEntityIndex provides a EntityIndex for primitive types.
+//
+// The index is immutable once built: the ids of the entities with a valid
+// value are kept sorted by value next to a copy of their values, so searches
+// read one contiguous array instead of chasing tree nodes and the Arrow array.
 template <typename node_or_edge, typename c_type>
 class KATANA_EXPORT PrimitiveEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   PrimitiveEntityIndex(
       const std::string& column, size_t num_entities,
       std::shared_ptr<arrow::Array> property)
       : EntityIndex<node_or_edge>(column),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexID>(*it).id) != key) {
-      return end();
-    }
-    return iterator(it);
-  }
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  iterator begin() override { return iterator(ids_.data()); }
+  iterator end() override { return iterator(ids_.data() + ids_.size()); }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(c_type key);
 
-private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
-    }
+  // Returns an iterator to the first element in the index that is greater than
+  // or equal to `key`.
+  iterator LowerBound(c_type key);
 
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        node_or_edge id = std::get<IndexID>(a).id;
-        c_type val = property_->Value(id);
-        return val;
-      }
-      return std::get<c_type>(a);
-    }
+  // Returns an iterator to the first element in the index that is greater than
+  // `key`.
+  iterator UpperBound(c_type key);
 
-    std::shared_ptr<ArrowArrayType> property_;
-  };
+  Result<NUMAArray<node_or_edge>> FindMany(const arrow::Array& keys) override;
 
+protected:
   Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromFile(const EntityIndexPrimitive& primitive) override;
+
+  // Returns the position of the first element at or after position `from`
+  // that is greater than or equal to `key`.
+  size_t LowerBoundFrom(c_type key, size_t from) const;
 
   size_t num_entities_;
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  // keys_[i] is the property value of ids_[i].
+  NUMAArray<c_type> keys_;
+  NUMAArray<node_or_edge> ids_;
 };
 
 // StringEntityIndex provides a EntityIndex for strings.
+//
+// Like PrimitiveEntityIndex, the sorted ids are kept in an array. Next to
+// them are the first bytes of their strings, which decide most comparisons
+// without reading the Arrow array.
 template <typename node_or_edge>
 class KATANA_EXPORT StringEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType =
       typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   StringEntityIndex(
       const std::string& property_name, size_t num_entities,
       const std::shared_ptr<arrow::Array>& property)
       : EntityIndex<node_or_edge>(property_name),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexID>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
-    }
-    return iterator(it);
+        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)) {
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
-  }
+  iterator begin() override { return iterator(ids_.data()); }
+  iterator end() override { return iterator(ids_.data() + ids_.size()); }
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(std::string_view key);
 
-  // Returns an iterator to the first element in the set that is greater than
+  // Returns an iterator to the first element in the index that is greater than
+  // or equal to `key`.
+  iterator LowerBound(std::string_view key);
+
+  // Returns an iterator to the first element in the index that is greater than
   // `key`.
-  iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+  iterator UpperBound(std::string_view key);
+
+  Result<NUMAArray<node_or_edge>> FindMany(const arrow::Array& keys) override;
+
+protected:
+  Result<void> BuildFromProperty() override;
+  Result<void> BuildFromFile(const EntityIndexPrimitive& primitive) override;
+
+  // Returns the position of the first element at or after position `from`
+  // that is greater than or equal to `key`.
+  size_t LowerBoundFrom(std::string_view key, size_t from) const;
+
+  std::string_view GetView(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
   }
 
-private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  size_t num_entities_;
+  std::shared_ptr<arrow::LargeStringArray> property_;
+  // prefixes_[i] holds the first bytes of the value of ids_[i], big-endian so
+  // that integer order is string order.
+  NUMAArray<uint64_t> prefixes_;
+  NUMAArray<node_or_edge> ids_;
+};
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexID>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
-      }
-      return *std::get<std::string_view*>(a);
-    }
+// The ordered EntityIndex over values of c_type, where c_type is
+// std::string_view for strings.
+template <typename node_or_edge, typename c_type>
+using OrderedEntityIndex = std::conditional_t<
+    std::is_same_v<c_type, std::string_view>, StringEntityIndex<node_or_edge>,
+    PrimitiveEntityIndex<node_or_edge, c_type>>;
+
+// HashEntityIndex provides a EntityIndex for point lookups. c_type is
+// std::string_view for strings.
+//
+// The ids are kept in the order of OrderedEntityIndex, so LowerBound and
+// UpperBound still work and both kinds of index have the same stored form.
+// On top of them is a hash table from each distinct value to its run of ids,
+// so Find reads a few cache lines instead of one per step of a binary search.
+// The table uses open addressing over windows of slots that fill a cache
+// line: a lookup compares the hashes of a whole window at once and only moves
+// to the next window if the current one is full.
+template <typename node_or_edge, typename c_type>
+class KATANA_EXPORT HashEntityIndex
+    : public OrderedEntityIndex<node_or_edge, c_type> {
+  using Base = OrderedEntityIndex<node_or_edge, c_type>;
+
+public:
+  using iterator = typename EntityIndex<node_or_edge>::iterator;
+
+  using Base::Base;
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(c_type key) { return EqualRange(key).first; }
+
+  // Returns the range of the elements in the index with their property value
+  // equal to `key`, which is empty and at end() if there are none.
+  std::pair<iterator, iterator> EqualRange(c_type key);
 
-    std::shared_ptr<arrow::LargeStringArray> property_;
+  Result<NUMAArray<node_or_edge>> FindMany(const arrow::Array& keys) override;
+
+private:
+  static constexpr size_t kWindowSize = 4;
+  static constexpr uint64_t kEmptySlot = std::numeric_limits<uint64_t>::max();
+
+  struct alignas(16) Slot {
+    uint64_t hash;
+    // The index in runs_ of the value, or kEmptySlot
+    uint64_t run;
   };
 
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromFile(const EntityIndexPrimitive& primitive) override;
 
-  size_t num_entities_;
-  std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  void BuildTable();
+
+  // Returns the index in runs_ of the value `key` of hash `hash`, or
+  // kEmptySlot.
+  uint64_t FindRun(c_type key, uint64_t hash) const;
+
+  const Slot* Window(uint64_t hash) const {
+    return slots_.data() + (hash & window_mask_) * kWindowSize;
+  }
+
+  c_type KeyAt(size_t pos) const {
+    if constexpr (std::is_same_v<c_type, std::string_view>) {
+      return this->GetView(this->ids_[pos]);
+    } else {
+      return this->keys_[pos];
+    }
+  }
+
+  // runs_[r] is the position of the first id of the r-th distinct value.
+  NUMAArray<uint64_t> runs_;
+  NUMAArray<Slot> slots_;
+  uint64_t window_mask_{0};
+};
+
+// The kinds of index MakeTypedEntityIndex can create.
+enum class EntityIndexKind {
+  // A PrimitiveEntityIndex or StringEntityIndex
+  kOrdered,
+  // A HashEntityIndex
+  kHash,
+};
 
 // Create a EntityIndex with the appropriate type for 'property'. Does not
 // build the index.
 template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>> MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property,
+    EntityIndexKind kind = EntityIndexKind::kOrdered);
 
 }  // namespace katana
 
@@ -0,0 +1,45 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRFILE_H_
+#define KATANA_LIBGRAPH_KATANA_GRFILE_H_
+
+#include <memory>
+#include <string>
+
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Loads the binary .gr files of Galois, so that inputs kept in that format
+/// can be used with PropertyGraph and the analytics on it.
+///
+/// A .gr file is a header of four little endian uint64s (the version, the
+/// size of the data of an edge, the number of nodes and the number of
+/// edges), the end of the edges of every node as uint64s, the destination
+/// of every edge as a uint32 (version 1, padded to a multiple of 8 bytes) or
+/// a uint64 (version 2), and the data of every edge.
+///
+/// Unlike FileGraph::fromFile, which populates the whole mapping of the file
+/// on the calling thread, the file is mapped without populating it and the
+/// topology arrays are allocated interleaved among the NUMA nodes and filled
+/// by every thread, so reading and placing the pages are both parallel. The
+/// file is checked while it is copied: node ends must not decrease and
+/// destinations must be nodes.
+///
+/// \file
+
+/// Load the topology of the .gr file at \p path
+KATANA_EXPORT Result<GraphTopology> LoadGrTopology(const std::string& path);
+
+/// Make a property graph with the topology of the .gr file at \p path. If
+/// \p edge_property_name is not empty, the edge data of the file becomes
+/// the edge property of that name, as uint32s or uint64s depending on its
+/// size; files with edge data of another size are an error then.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> MakePropertyGraphFromGr(
+    const std::string& path, const std::string& edge_property_name,
+    TxnContext* txn_ctx);
+
+}  // namespace katana
+
+#endif
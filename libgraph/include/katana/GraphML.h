@@ -7,19 +7,32 @@
 
 namespace katana {
 
+/// Default size of the pieces a GraphML file is split into for parallel
+/// parsing
+constexpr size_t kDefaultGraphMLParseChunkBytes = 16 << 20;
+
 /// ConvertGraphML converts a GraphML file into katana form
 ///
+/// The body of the graph is split at node and edge boundaries into pieces of
+/// about \p parse_chunk_bytes that are parsed in parallel; nodes and edges are
+/// still added in file order so the result is the same as a serial parse.
+/// Files that cannot be split safely (e.g., ones with a DOCTYPE, comments or
+/// CDATA sections between elements, or nested graphs) are parsed serially.
+///
 /// \param infilename Path to source graphml file
 /// \param chunk_size Chunk size for in memory representations during conversion.
 ///     Generally this term can be ignored, but it can be decreased to reduce
 ///     memory usage when converting large inputs
 /// \param verbose If true, print graph data to the standard out while
 ///     converting.
+/// \param parse_chunk_bytes Approximate size of the pieces parsed in
+///     parallel; 0 parses the file serially
 /// \returns A collection of Arrow tables of node properties/labels, edge
 ///     properties/types, and CSR topology
 KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
     const std::string& infilename, size_t chunk_size = 25000,
-    bool verbose = false);
+    bool verbose = false,
+    size_t parse_chunk_bytes = kDefaultGraphMLParseChunkBytes);
 
 /// ConvertGraphML converts a GraphML file into katana form
 ///
@@ -0,0 +1,137 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHRECORDBATCHES_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHRECORDBATCHES_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arrow/record_batch.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+/// Readers that stream a loaded graph as Arrow record batches, so that it can
+/// be served to other processes, e.g., as an Arrow IPC or Flight stream,
+/// without converting it first, and a builder that makes a graph from such
+/// streams.
+///
+/// Property batches are zero-copy slices of the property columns. A reader
+/// holds references to the columns it streams, so any number of readers can
+/// run at the same time, also on different threads, and a reader does not
+/// see properties added, upserted or removed after it was made.
+///
+/// \file
+
+namespace katana {
+
+constexpr int64_t kDefaultMaxBatchRows = int64_t{1} << 16;
+
+/// \returns a reader over the loaded node properties named in \p properties,
+/// or over all loaded node properties if it is empty. Row i of the stream
+/// holds the properties of node property index i.
+KATANA_EXPORT Result<std::shared_ptr<arrow::RecordBatchReader>>
+MakeNodePropertyBatchReader(
+    const PropertyGraph& pg, const std::vector<std::string>& properties = {},
+    int64_t max_batch_rows = kDefaultMaxBatchRows);
+
+/// \returns a reader over the loaded edge properties named in \p properties,
+/// or over all loaded edge properties if it is empty. Row i of the stream
+/// holds the properties of edge property index i.
+KATANA_EXPORT Result<std::shared_ptr<arrow::RecordBatchReader>>
+MakeEdgePropertyBatchReader(
+    const PropertyGraph& pg, const std::vector<std::string>& properties = {},
+    int64_t max_batch_rows = kDefaultMaxBatchRows);
+
+/// \returns a reader over the edges of \p pg in edge id order, with columns
+/// "source" and "dest". The dest column is a zero-copy view of the topology
+/// and sources are computed a batch at a time. The reader keeps \p pg alive.
+KATANA_EXPORT Result<std::shared_ptr<arrow::RecordBatchReader>>
+MakeEdgeListBatchReader(
+    std::shared_ptr<const PropertyGraph> pg,
+    int64_t max_batch_rows = kDefaultMaxBatchRows);
+
+/// Builds a PropertyGraph from record batches of nodes and edges as they
+/// arrive, e.g., from the part files of a Spark export, without the
+/// intermediate copy of every value that PropertyGraphBuilder makes.
+///
+/// A node batch has an integer id column and any number of property
+/// columns; an edge batch has integer source and dest columns holding node
+/// ids and any number of property columns. The property columns of all
+/// node (edge) batches must match those of the first one. Nodes and edges
+/// may arrive in any order, interleaved, as long as every node an edge
+/// refers to has arrived by the time Finish is called.
+///
+/// Property columns, including the node id column, are kept as zero-copy
+/// chunks of the batches; only the endpoints of edges are copied as they
+/// arrive. Finish builds the CSR from the endpoints with a parallel
+/// counting sort on the source, concatenates the chunks of every node
+/// property and gathers every edge property into edge id order, so each
+/// value is copied once.
+class KATANA_EXPORT RecordBatchGraphBuilder {
+public:
+  struct Options {
+    std::string node_id_column{"id"};
+    std::string source_column{"src"};
+    std::string dest_column{"dst"};
+    /// The ids of the nodes are 0, 1, 2, ... in the order the nodes arrive,
+    /// so edges can refer to nodes without a map from ids to nodes
+    bool dense_node_ids{false};
+  };
+
+  RecordBatchGraphBuilder() : RecordBatchGraphBuilder(Options{}) {}
+  explicit RecordBatchGraphBuilder(Options options)
+      : options_(std::move(options)) {}
+
+  Result<void> AddNodes(const arrow::RecordBatch& batch);
+  Result<void> AddEdges(const arrow::RecordBatch& batch);
+
+  /// Add every batch of \p reader
+  Result<void> AddNodes(arrow::RecordBatchReader* reader);
+  Result<void> AddEdges(arrow::RecordBatchReader* reader);
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return sources_.size(); }
+
+  /// Make the graph of everything added so far. The builder is empty
+  /// afterwards.
+  Result<std::unique_ptr<PropertyGraph>> Finish(TxnContext* txn_ctx);
+
+private:
+  /// The property columns of a kind of entity: the fields, and the chunks
+  /// of every field, one per batch
+  struct Columns {
+    std::shared_ptr<arrow::Schema> schema;
+    std::vector<std::vector<std::shared_ptr<arrow::Array>>> chunks;
+
+    /// Fail if the columns of \p batch but those in \p skip do not match
+    /// the schema
+    Result<void> Check(
+        const arrow::RecordBatch& batch, const std::vector<int>& skip) const;
+    void Append(const arrow::RecordBatch& batch, const std::vector<int>& skip);
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> ToChunkedArrays() const;
+  };
+
+  /// Append the values of the integer column \p column of \p batch to
+  /// \p ids
+  Result<void> ReadIds(
+      const arrow::RecordBatch& batch, const std::string& column,
+      std::vector<int64_t>* ids) const;
+
+  Options options_;
+
+  uint64_t num_nodes_{0};
+  std::unordered_map<int64_t, PropertyGraph::Node> node_index_;
+  Columns node_columns_;
+
+  std::vector<int64_t> sources_;
+  std::vector<int64_t> dests_;
+  Columns edge_columns_;
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef KATANA_LIBGRAPH_KATANA_GRAPHTILEDEXECUTOR_H_
+#define KATANA_LIBGRAPH_KATANA_GRAPHTILEDEXECUTOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PaddedLock.h"
+#include "katana/Range.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The cache a tile of GraphTiledExecutor should fit in by default, the L2
+/// cache of a core
+constexpr size_t kDefaultTileCacheBytes = size_t{1} << 20;
+
+/// Which nodes of a tile a thread has to itself while it runs on the tile.
+/// With kRows, the tiles that run at once have no sources in common, so the
+/// function may update the data of the sources of its edges without atomics;
+/// with kColumns, the same for destinations.
+enum class TileLocking {
+  kNone,
+  kRows,
+  kColumns,
+  kRowsAndColumns,
+};
+
+/// Runs a function over the edges of a graph in 2D tiles of its adjacency
+/// matrix: tile (r, c) has the edges from the sources of row range r to the
+/// destinations of column range c, so a tile whose ranges are small enough,
+/// see TileSideForCache, touches only node data that fits in cache. This is
+/// the blocking of SGD matrix completion, cache blocked SpMM and propagation
+/// blocked PageRank.
+///
+/// The edges are copied once, grouped by tile and ordered by source within
+/// a tile. Graph is any graph or view with NumNodes, OutEdges and
+/// OutEdgeDst, e.g., GraphTopology or PropertyGraphViews::Transposed, whose
+/// tiles are the tiles of the transpose.
+///
+/// ForEachTile runs every tile once. Threads start on different diagonals of
+/// the tile grid, where tiles share neither rows nor columns, and then take
+/// any tile left whose rows and columns (see TileLocking) they can lock, so
+/// there is no barrier between diagonals and idle threads steal the tiles of
+/// busy ones.
+template <typename Graph>
+class GraphTiledExecutor {
+public:
+  using Node = typename Graph::Node;
+  using Edge = typename Graph::Edge;
+
+  struct TileEdge {
+    Node src;
+    Node dst;
+    Edge edge;
+  };
+
+  using TileEdges = katana::StandardRange<const TileEdge*>;
+
+  /// \returns the side of a square tile whose rows and columns have
+  /// bytes_per_node of data each and fit in cache_bytes together
+  static size_t TileSideForCache(
+      size_t bytes_per_node, size_t cache_bytes = kDefaultTileCacheBytes) {
+    return std::max<size_t>(
+        cache_bytes / (2 * std::max<size_t>(bytes_per_node, 1)), 1);
+  }
+
+  GraphTiledExecutor(
+      const Graph& graph, size_t rows_per_tile, size_t columns_per_tile)
+      : num_nodes_(graph.NumNodes()),
+        rows_per_tile_(std::max<size_t>(rows_per_tile, 1)),
+        columns_per_tile_(std::max<size_t>(columns_per_tile, 1)),
+        num_row_tiles_(std::max<size_t>(
+            (num_nodes_ + rows_per_tile_ - 1) / rows_per_tile_, 1)),
+        num_column_tiles_(std::max<size_t>(
+            (num_nodes_ + columns_per_tile_ - 1) / columns_per_tile_, 1)),
+        row_locks_(num_row_tiles_),
+        column_locks_(num_column_tiles_) {
+    Partition(graph);
+  }
+
+  size_t num_row_tiles() const { return num_row_tiles_; }
+  size_t num_column_tiles() const { return num_column_tiles_; }
+  size_t num_tiles() const { return num_row_tiles_ * num_column_tiles_; }
+
+  /// The first row and one past the last row of row tile r
+  std::pair<Node, Node> Rows(size_t r) const {
+    return {Bound(r, rows_per_tile_), Bound(r + 1, rows_per_tile_)};
+  }
+
+  /// The first column and one past the last column of column tile c
+  std::pair<Node, Node> Columns(size_t c) const {
+    return {Bound(c, columns_per_tile_), Bound(c + 1, columns_per_tile_)};
+  }
+
+  /// The edges of tile (r, c), ordered by source
+  TileEdges Edges(size_t r, size_t c) const {
+    size_t tile = r * num_column_tiles_ + c;
+    return katana::MakeStandardRange(
+        edges_.data() + tile_begins_[tile],
+        edges_.data() + tile_begins_[tile + 1]);
+  }
+
+  /// Call fn(r, c, edges) once for every tile (r, c) with edges, in
+  /// parallel. fn has the rows and, or, columns of its tile to itself as
+  /// locking says.
+  template <typename F>
+  void ForEachTile(
+      F fn, TileLocking locking = TileLocking::kRowsAndColumns,
+      const char* loopname = "GraphTiledExecutor") {
+    const size_t num_scheduled = schedule_.size();
+    if (num_scheduled == 0) {
+      return;
+    }
+    katana::NUMAArray<std::atomic<bool>> claimed;
+    claimed.allocateInterleaved(num_scheduled);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_scheduled),
+        [&](size_t i) { claimed[i].store(false, std::memory_order_relaxed); },
+        katana::no_stats());
+    std::atomic<size_t> remaining{num_scheduled};
+    katana::GAccumulator<uint64_t> lock_failures;
+
+    katana::on_each([&](unsigned tid, unsigned num_threads) {
+      // start on a diagonal of its own
+      size_t cursor = num_scheduled * tid / num_threads;
+      while (remaining.load(std::memory_order_relaxed) > 0) {
+        bool ran = false;
+        for (size_t probe = 0; probe < num_scheduled; ++probe) {
+          size_t i = (cursor + probe) % num_scheduled;
+          if (claimed[i].load(std::memory_order_relaxed)) {
+            continue;
+          }
+          size_t tile = schedule_[i];
+          size_t r = tile / num_column_tiles_;
+          size_t c = tile % num_column_tiles_;
+          if (!TryLock(r, c, locking)) {
+            lock_failures += 1;
+            continue;
+          }
+          if (claimed[i].exchange(true, std::memory_order_relaxed)) {
+            Unlock(r, c, locking);
+            continue;
+          }
+          fn(r, c, Edges(r, c));
+          Unlock(r, c, locking);
+          remaining.fetch_sub(1, std::memory_order_relaxed);
+          cursor = i + 1;
+          ran = true;
+          break;
+        }
+        if (!ran) {
+          // the tiles left are locked by other threads
+          katana::asmPause();
+        }
+      }
+    });
+
+    katana::ReportStatSingle(loopname, "LockFailures", lock_failures.reduce());
+  }
+
+  /// Call fn(src, dst, edge) for every edge, one tile at a time. See
+  /// ForEachTile.
+  template <typename F>
+  void ForEachEdge(
+      F fn, TileLocking locking = TileLocking::kRowsAndColumns,
+      const char* loopname = "GraphTiledExecutor") {
+    ForEachTile(
+        [&](size_t, size_t, TileEdges edges) {
+          for (const TileEdge& e : edges) {
+            fn(e.src, e.dst, e.edge);
+          }
+        },
+        locking, loopname);
+  }
+
+private:
+  Node Bound(size_t tile, size_t per_tile) const {
+    return static_cast<Node>(std::min<uint64_t>(tile * per_tile, num_nodes_));
+  }
+
+  /// Group the edges by tile with a counting sort by row tile, and order
+  /// the tiles with edges by diagonal
+  void Partition(const Graph& graph) {
+    const size_t num_column_tiles = num_column_tiles_;
+    tile_begins_.assign(num_tiles() + 1, 0);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_row_tiles_),
+        [&](size_t r) {
+          uint64_t* counts = &tile_begins_[r * num_column_tiles + 1];
+          auto [begin, end] = Rows(r);
+          for (Node n = begin; n < end; ++n) {
+            for (auto e : graph.OutEdges(n)) {
+              counts[graph.OutEdgeDst(e) / columns_per_tile_] += 1;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    std::partial_sum(
+        tile_begins_.begin(), tile_begins_.end(), tile_begins_.begin());
+
+    edges_.allocateInterleaved(tile_begins_.back());
+    katana::do_all(
+        katana::iterate(size_t{0}, num_row_tiles_),
+        [&](size_t r) {
+          std::vector<uint64_t> cursors(
+              tile_begins_.begin() + r * num_column_tiles,
+              tile_begins_.begin() + (r + 1) * num_column_tiles);
+          auto [begin, end] = Rows(r);
+          for (Node n = begin; n < end; ++n) {
+            for (auto e : graph.OutEdges(n)) {
+              Node dst = graph.OutEdgeDst(e);
+              edges_[cursors[dst / columns_per_tile_]++] =
+                  TileEdge{n, dst, static_cast<Edge>(e)};
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    // tiles (r, r + d) for d = 0, 1, ... share no row, and no column while
+    // r < num_column_tiles_
+    for (size_t d = 0; d < num_column_tiles_; ++d) {
+      for (size_t r = 0; r < num_row_tiles_; ++r) {
+        size_t tile = r * num_column_tiles_ + (r + d) % num_column_tiles_;
+        if (tile_begins_[tile] != tile_begins_[tile + 1]) {
+          schedule_.emplace_back(tile);
+        }
+      }
+    }
+  }
+
+  bool TryLock(size_t r, size_t c, TileLocking locking) {
+    switch (locking) {
+    case TileLocking::kNone:
+      return true;
+    case TileLocking::kRows:
+      return row_locks_[r].try_lock();
+    case TileLocking::kColumns:
+      return column_locks_[c].try_lock();
+    case TileLocking::kRowsAndColumns:
+      return std::try_lock(row_locks_[r], column_locks_[c]) < 0;
+    }
+    return false;
+  }
+
+  void Unlock(size_t r, size_t c, TileLocking locking) {
+    if (locking == TileLocking::kRows ||
+        locking == TileLocking::kRowsAndColumns) {
+      row_locks_[r].unlock();
+    }
+    if (locking == TileLocking::kColumns ||
+        locking == TileLocking::kRowsAndColumns) {
+      column_locks_[c].unlock();
+    }
+  }
+
+  uint64_t num_nodes_;
+  size_t rows_per_tile_;
+  size_t columns_per_tile_;
+  size_t num_row_tiles_;
+  size_t num_column_tiles_;
+  std::vector<katana::PaddedLock<true>> row_locks_;
+  std::vector<katana::PaddedLock<true>> column_locks_;
+  /// edges_ of tile (r, c) are [tile_begins_[t], tile_begins_[t + 1]) for
+  /// t = r * num_column_tiles_ + c
+  std::vector<uint64_t> tile_begins_;
+  katana::NUMAArray<TileEdge> edges_;
+  /// The tiles with edges in the order threads look for work
+  std::vector<size_t> schedule_;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,12 +1,23 @@
 #ifndef KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/filter_iterator.hpp>
 
+#include "arrow/type_fwd.h"
 #include "arrow/util/bitmap.h"
 #include "katana/CompileTimeIntrospection.h"
 #include "katana/DynamicBitset.h"
@@ -15,6 +26,7 @@
 #include "katana/NUMAArray.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
+#include "katana/ThreadPool.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -29,7 +41,7 @@ class KATANA_EXPORT PropertyGraph;
 
 /// Types used by all topologies
 struct KATANA_EXPORT GraphTopologyTypes {
-  using Node = uint32_t;
+  using Node = RDGTopology::Node;
   using Edge = uint64_t;
   using PropertyIndex = uint64_t;
   using node_iterator = boost::counting_iterator<Node>;
@@ -47,6 +59,7 @@ struct KATANA_EXPORT GraphTopologyTypes {
 
 class KATANA_EXPORT EdgeShuffleTopology;
 class KATANA_EXPORT EdgeTypeAwareTopology;
+class KATANA_EXPORT CompressedGraphTopology;
 
 /********************/
 /* Topology classes */
@@ -75,6 +88,20 @@ public:
 
   GraphTopology(AdjIndexVec&& adj_indices, EdgeDestVec&& dests) noexcept;
 
+  /// Use the arrays in place without copying them. \p storage owns the
+  /// memory they live in (e.g., a file mapping) and is kept alive as long as
+  /// this topology is.
+  GraphTopology(
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      size_t num_edges, std::shared_ptr<const void> storage) noexcept;
+
+  /// A semi-external topology: \p adj_indices is in memory and \p dests is
+  /// used in place in a file mapping that \p storage owns, so its pages are
+  /// read in from the file as they are used
+  GraphTopology(
+      AdjIndexVec&& adj_indices, const Node* dests, size_t num_edges,
+      std::shared_ptr<const void> storage) noexcept;
+
   GraphTopology(
       AdjIndexVec&& adj_indices, EdgeDestVec&& dests,
       PropIndexVec&& edge_prop_indices,
@@ -176,6 +203,14 @@ public:
 
   PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept;
 
+  /// @returns the bytes taken by the map from edges to edge property indexes:
+  /// none when it is the identity, and 4 per edge when the indexes fit in 32
+  /// bits; see CompactEdgePropertyIndexes
+  size_t EdgePropertyIndexSizeBytes() const noexcept {
+    return narrow_edge_prop_indices_.size() * sizeof(uint32_t) +
+           edge_prop_indices_.size() * sizeof(PropertyIndex);
+  }
+
   // TODO(amber): These two methods are a short term fix. The nature of
   // PropertyIndex is expected to change post grouping of properties.
   Node GetLocalNodeID(const Node& nid) const noexcept {
@@ -203,6 +238,20 @@ public:
     return RDGTopology::EdgeSortKind::kAny;
   }
 
+  /// True if the edge destinations are paged in from a file mapping rather
+  /// than held in memory; see RDGLoadOptions::semi_external_topology
+  bool IsSemiExternal() const noexcept { return semi_external_; }
+
+  /// Hints that the destinations of the out-edges of nodes [\p begin, \p end)
+  /// will be needed soon, so that the OS starts reading them in. Does nothing
+  /// unless IsSemiExternal().
+  void WillNeedOutEdges(Node begin, Node end) const noexcept;
+
+  /// Hints that the destinations of the out-edges of nodes [\p begin, \p end)
+  /// will not be needed for a while, so that their pages are reclaimed first
+  /// under memory pressure. Does nothing unless IsSemiExternal().
+  void DoneWithOutEdges(Node begin, Node end) const noexcept;
+
   void Print() const noexcept;
 
 protected:
@@ -214,19 +263,41 @@ protected:
     return node_prop_indices_.data();
   }
 
+  /// Drops the map from edges to edge property indexes if it is the identity
+  /// and narrows it to 32 bits if the indexes fit, so that a sorted view of
+  /// a large graph does not take 8 bytes per edge for it. Afterwards,
+  /// edge_property_index_data() is null.
+  void CompactEdgePropertyIndexes() noexcept;
+
+  /// Undoes CompactEdgePropertyIndexes(), for code that permutes the map in
+  /// place
+  void ExpandEdgePropertyIndexes() noexcept;
+
+  /// @returns the edge property indexes as a 64-bit array, for the on-disk
+  /// format. If the map is compacted, the array is made and \p storage is set
+  /// to own it.
+  const PropertyIndex* WideEdgePropertyIndexes(
+      std::shared_ptr<const void>* storage) const noexcept;
+
 private:
   // need these friend relationships to construct instances of friend classes below
   // by moving NUMAArrays in this class.
   friend class EdgeShuffleTopology;
   friend class EdgeTypeAwareTopology;
+  friend class CompressedGraphTopology;
 
   NUMAArray<Edge>& GetAdjIndices() noexcept { return adj_indices_; }
   NUMAArray<Node>& GetDests() noexcept { return dests_; }
   PropIndexVec& GetEdgePropIndices() noexcept { return edge_prop_indices_; }
   PropIndexVec& GetNodePropIndices() noexcept { return node_prop_indices_; }
 
+  /// Keeps borrowed arrays valid; declared first so that it is released
+  /// after them
+  std::shared_ptr<const void> storage_;
+
   NUMAArray<Edge> adj_indices_;
   NUMAArray<Node> dests_;
+  bool semi_external_{false};
 
   // TODO(amber): In the future, we may need to keep a copy of edge_type_ids in
   // addition to edge_prop_indices_. Today, we assume that we can use
@@ -235,6 +306,9 @@ private:
   // when this is done, the Write path must also be updated to pass the edge_type_ids index
   // to RDG. For now, we pass nullptr.
   PropIndexVec edge_prop_indices_;
+  /// edge_prop_indices_ when compacted to 32 bits; at most one of the two is
+  /// not empty, and if both are empty, the map is the identity
+  NUMAArray<uint32_t> narrow_edge_prop_indices_;
 
   // TODO(amber): In the future, we may need to keep a copy of node_type_ids in
   // addition to node_prop_indices_. Today, we assume that we can use
@@ -308,6 +382,7 @@ public:
     }
 
     ret->sortEdges(pg, edge_sort_todo);
+    ret->CompactEdgePropertyIndexes();
     return ret;
   }
 
@@ -317,6 +392,27 @@ public:
 
   edge_iterator FindEdge(const Node& src, const Node& dst) const noexcept;
 
+  /// Like FindEdge(src, dst) but only searches the out-edges of src from
+  /// hint on, with exponential search so that a hint close to the edge is
+  /// cheap; e.g., a sequence of increasing dst can pass the edge found for
+  /// the previous one. Edges must be sorted by destination.
+  ///
+  /// @param hint an out-edge of src, or the end of its out-edges
+  /// @returns the first edge from hint on to dst, or the end of the
+  /// out-edges of src if there is none
+  edge_iterator FindEdge(
+      const Node& src, const Node& dst,
+      const edge_iterator& hint) const noexcept;
+
+  /// Find many out-edges of src at once by merging sorted_dsts, which must
+  /// be sorted, with the out-edges of src, which must be sorted by
+  /// destination.
+  ///
+  /// @returns for each of sorted_dsts, an edge from src to it, or the end
+  /// of the out-edges of src if there is none
+  std::vector<edge_iterator> FindEdges(
+      const Node& src, const std::vector<Node>& sorted_dsts) const noexcept;
+
   edges_range FindAllEdges(const Node& src, const Node& dst) const noexcept;
 
   bool HasEdge(const Node& src, const Node& dst) const noexcept {
@@ -334,6 +430,10 @@ protected:
   void sortEdges(
       const PropertyGraph* pg,
       const RDGTopology::EdgeSortKind& edge_sort_todo) noexcept {
+    if (edge_sort_todo != RDGTopology::EdgeSortKind::kAny) {
+      // the sorts permute the edge property indexes along with the edges
+      ExpandEdgePropertyIndexes();
+    }
     switch (edge_sort_todo) {
     case RDGTopology::EdgeSortKind::kAny:
       return;
@@ -407,6 +507,20 @@ public:
   static std::shared_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// Nodes in breadth-first order over out-edges. Each unvisited node with
+  /// the lowest id starts a new search, and the nodes discovered from a node
+  /// are numbered by id.
+  static std::shared_ptr<ShuffleTopology> MakeSortedByBFS(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Nodes in reverse Cuthill-McKee order over out-edges, which clusters the
+  /// nonzeros of the adjacency matrix near its diagonal. Like BFS order, but
+  /// each search starts at an unvisited node of lowest degree, the nodes
+  /// discovered from a node are numbered by increasing degree and the final
+  /// order is reversed.
+  static std::shared_ptr<ShuffleTopology> MakeSortedByRCM(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
   static std::shared_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const RDGTopology::NodeSortKind& node_sort_todo,
@@ -423,11 +537,18 @@ public:
     case RDGTopology::NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case RDGTopology::NodeSortKind::kSortedByBFS:
+      ret = MakeSortedByBFS(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kSortedByRCM:
+      ret = MakeSortedByRCM(pg, seed_topo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
 
     ret->sortEdges(pg, edge_sort_todo);
+    ret->CompactEdgePropertyIndexes();
 
     return ret;
   }
@@ -452,70 +573,34 @@ private:
         new_to_old.begin(), new_to_old.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.NumNodes());
-
-    NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
-
-    PropIndexVec node_prop_indices;
-    node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
-
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // new_to_old.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, new_to_old.size()),
-        [&](auto i) {
-          // new_to_old[i] gives old node id
-          old_to_new_map[new_to_old[i]] = i;
-          degrees[i] = seed_topo.OutDegree(new_to_old[i]);
-          node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
-        },
-        katana::no_stats());
-
-    KATANA_LOG_DEBUG_ASSERT(
-        std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
-
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
-
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
-
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
-
-    katana::do_all(
-        katana::iterate(seed_topo.Nodes()),
-        [&](auto old_src_id) {
-          auto new_srd_id = old_to_new_map[old_src_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
-
-          for (auto e : seed_topo.OutEdges(old_src_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
-            KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
+    return MakeNodePermutedTopo(seed_topo, new_to_old, node_sort_todo);
+  }
 
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+  /// Like MakeNodeSortedTopo, but orders the nodes by the unsigned integer
+  /// key_fn(node) with a stable radix sort, so ties keep the id order
+  template <typename KeyFunc>
+  static std::shared_ptr<ShuffleTopology> MakeNodeSortedTopoByKey(
+      const EdgeShuffleTopology& seed_topo, const KeyFunc& key_fn,
+      const RDGTopology::NodeSortKind& node_sort_todo) {
+    GraphTopology::PropIndexVec new_to_old;
+    new_to_old.allocateInterleaved(seed_topo.NumNodes());
 
-            new_dest_vec[new_edge_id] = new_edge_dest;
+    katana::ParallelSTL::iota(
+        new_to_old.begin(), new_to_old.end(),
+        GraphTopologyTypes::PropertyIndex{0});
 
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] =
-                seed_topo.GetEdgePropertyIndexFromOutEdge(e);
-          }
-          KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
-        },
-        katana::steal(), katana::no_stats());
+    katana::ParallelSTL::radix_sort(
+        new_to_old.begin(), new_to_old.end(), key_fn);
 
-    return std::make_shared<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeNodePermutedTopo(seed_topo, new_to_old, node_sort_todo);
   }
 
+  /// Makes a copy of \p seed_topo with its nodes renumbered so that new node
+  /// i is old node new_to_old[i]. The edges of each node keep their order.
+  static std::shared_ptr<ShuffleTopology> MakeNodePermutedTopo(
+      const EdgeShuffleTopology& seed_topo, const PropIndexVec& new_to_old,
+      const RDGTopology::NodeSortKind& node_sort_todo) noexcept;
+
   ShuffleTopology(
       const RDGTopology::TransposeKind& tpose_todo,
       const RDGTopology::NodeSortKind& node_sort_todo,
@@ -531,6 +616,77 @@ private:
   RDGTopology::NodeSortKind node_sort_state_{RDGTopology::NodeSortKind::kAny};
 };
 
+/// An EdgeShuffleTopology with the out-edges of every node sorted by a
+/// timestamp edge property and the timestamps stored along the edges, so
+/// that the out-edges of a node in a time window are a range found by binary
+/// search. Timestamps are read as int64 from integer, date, time and
+/// timestamp properties; edges with a null timestamp sort last and are in no
+/// window.
+class KATANA_EXPORT TemporalTopology : public EdgeShuffleTopology {
+  using Base = EdgeShuffleTopology;
+
+public:
+  using Timestamp = int64_t;
+  static constexpr Timestamp kNoTimestamp =
+      std::numeric_limits<Timestamp>::max();
+
+  TemporalTopology(TemporalTopology&&) = default;
+  TemporalTopology& operator=(TemporalTopology&&) = default;
+
+  TemporalTopology(const TemporalTopology&) = delete;
+  TemporalTopology& operator=(const TemporalTopology&) = delete;
+
+  ~TemporalTopology() override;
+
+  static Result<std::shared_ptr<TemporalTopology>> MakeFrom(
+      const PropertyGraph* pg, const std::string& timestamp_property,
+      const RDGTopology::TransposeKind& tpose_todo);
+
+  const std::string& timestamp_property() const noexcept {
+    return timestamp_property_;
+  }
+
+  /// @returns true if this topology was sorted by \p timestamps, which may
+  /// have replaced the column it was built from since
+  bool IsSortedBy(
+      const std::shared_ptr<arrow::ChunkedArray>& timestamps) const noexcept {
+    return timestamps_source_.lock() == timestamps;
+  }
+
+  using Base::OutEdges;
+
+  /// Gets the out-edges of \p node with a timestamp in [\p begin, \p end)
+  edges_range OutEdges(
+      const Node& node, Timestamp begin, Timestamp end) const noexcept {
+    auto edges = OutEdges(node);
+    const Timestamp* data = timestamps_.data();
+    const Timestamp* first =
+        std::lower_bound(data + *edges.begin(), data + *edges.end(), begin);
+    const Timestamp* last = std::lower_bound(first, data + *edges.end(), end);
+    return MakeStandardRange<edge_iterator>(
+        Edge(first - data), Edge(last - data));
+  }
+
+  Timestamp OutEdgeTimestamp(const Edge& eid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(eid < timestamps_.size());
+    return timestamps_[eid];
+  }
+
+  size_t TimestampsSizeBytes() const noexcept {
+    return timestamps_.size() * sizeof(Timestamp);
+  }
+
+private:
+  TemporalTopology(
+      EdgeShuffleTopology&& base, std::string timestamp_property) noexcept
+      : Base(std::move(base)),
+        timestamp_property_(std::move(timestamp_property)) {}
+
+  std::string timestamp_property_;
+  std::weak_ptr<arrow::ChunkedArray> timestamps_source_;
+  NUMAArray<Timestamp> timestamps_;
+};
+
 namespace internal {
 // TODO(amber): make private
 template <typename Topo>
@@ -649,6 +805,23 @@ public:
 
   virtual ~EdgeTypeAwareTopology();
 
+  /// Layout of the per-type adjacency index
+  enum class IndexLayout {
+    /// NumNodes() * num_unique_types() prefix sums; O(1) lookup
+    kDense,
+    /// per node, a list of (type index, end edge) pairs for only the edge
+    /// types the node has, sorted by type index; O(log k) lookup where k is
+    /// the number of distinct edge types of the node
+    kSparse,
+  };
+
+  /// The sparse layout is used when it takes at most 1/kSparseLayoutFactor of
+  /// the memory of the dense layout
+  static constexpr size_t kSparseLayoutFactor = 2;
+
+  /// Builds the per-type adjacency index for e_topo. The layout is chosen
+  /// based on how many distinct edge types each node has: graphs with many
+  /// edge types but few types per node get the sparse layout.
   static std::shared_ptr<EdgeTypeAwareTopology> MakeFrom(
       const PropertyGraph* pg,
       std::shared_ptr<const CondensedTypeIDMap> edge_type_index,
@@ -668,10 +841,34 @@ public:
   using Base::OutEdges;
   using Base::transpose_state;
 
+  IndexLayout index_layout() const noexcept { return index_layout_; }
+
+  /// \returns the memory used by the per-type adjacency index and, if built,
+  /// the destination index
+  size_t PerTypeIndexSizeBytes() const noexcept {
+    return per_type_adj_indices_.size() * sizeof(Edge) +
+           sparse_node_offsets_.size() * sizeof(Edge) +
+           sparse_type_indices_.size() * sizeof(uint32_t) +
+           sparse_type_ends_.size() * sizeof(Edge) +
+           sorted_dests_.size() * sizeof(Node);
+  }
+
+  /// Builds a copy of the destinations of the out-edges of each node, sorted
+  /// regardless of edge type, so that the untyped HasEdge(src, dst) is a
+  /// single binary search instead of one per edge type of src. Takes
+  /// sizeof(Node) bytes per edge. Must not be called while the topology is
+  /// in use by other threads.
+  void BuildDestIndex() noexcept;
+
+  bool has_dest_index() const noexcept { return has_dest_index_; }
+
   /// @param N node to get edges for
   /// @param edge_type edge_type to get edges of
   /// @returns Range to edges of node N that have edge type == edge_type
   edges_range OutEdges(Node N, const EntityTypeID& edge_type) const noexcept {
+    if (index_layout_ == IndexLayout::kSparse) {
+      return SparseOutEdges(N, edge_type_index_->GetIndex(edge_type));
+    }
     // per_type_adj_indices_ is expanded so that it stores P prefix sums per node, where
     // P == edge_type_index_->num_unique_types()
     // We pick the prefix sum based on the index of the edge_type provided
@@ -844,20 +1041,61 @@ public:
   /// @param dst destination node of the edge
   /// @returns true iff the edge exists
   bool HasEdge(Node src, Node dst) const {
+    auto edges = Base::OutEdges(src);
     // trivial check; can't be connected if degree is 0
+    if (edges.empty()) {
+      return false;
+    }
 
-    if (OutDegree(src) == 0ul) {
+    if (has_dest_index_) {
+      return std::binary_search(
+          sorted_dests_.begin() + *edges.begin(),
+          sorted_dests_.begin() + *edges.end(), dst);
+    }
+
+    // Walk the runs of same typed edges of src straight from the index rather
+    // than looking each distinct edge type up, so types that src does not
+    // have cost nothing (sparse) or a comparison (dense)
+    internal::EdgeDestComparator<EdgeTypeAwareTopology> comp{this};
+    Edge run_begin = *edges.begin();
+    auto run_has_dst = [&](Edge run_end) {
+      bool found = run_begin != run_end &&
+                   std::binary_search(
+                       edge_iterator{run_begin}, edge_iterator{run_end}, dst,
+                       comp);
+      run_begin = run_end;
+      return found;
+    };
+
+    if (index_layout_ == IndexLayout::kSparse) {
+      const uint64_t first = (src == 0) ? 0 : sparse_node_offsets_[src - 1];
+      for (uint64_t pos = first; pos < sparse_node_offsets_[src]; ++pos) {
+        if (run_has_dst(sparse_type_ends_[pos])) {
+          return true;
+        }
+      }
       return false;
     }
 
-    for (const auto& edge_type : GetDistinctEdgeTypes()) {
-      if (HasEdge(src, dst, edge_type)) {
+    const uint64_t num_types = edge_type_index_->num_unique_types();
+    for (uint64_t i = 0; i < num_types; ++i) {
+      if (run_has_dst(per_type_adj_indices_[src * num_types + i])) {
         return true;
       }
     }
     return false;
   }
 
+  /// Check many (src, dst) pairs at once. The queries are sorted and probed
+  /// in parallel in that order, so that queries with the same source share
+  /// the cached adjacency of the source.
+  ///
+  /// @param queries the (src, dst) pairs to look up
+  /// @returns a bitset whose bit i is set iff queries[i] is an edge of any
+  /// edge_type
+  DynamicBitset HasEdges(
+      const std::vector<std::pair<Node, Node>>& queries) const noexcept;
+
   katana::Result<RDGTopology> ToRDGTopology() const;
 
 private:
@@ -867,12 +1105,26 @@ private:
       const PropertyGraph& pg, const CondensedTypeIDMap& edge_type_index,
       const EdgeShuffleTopology& e_topo) noexcept;
 
+  /// \returns for each node, the number of distinct edge types among its
+  /// out-edges. Must be called on a topology sorted by edge type.
+  static AdjIndexVec CountEdgeTypesPerNode(
+      const PropertyGraph& pg, const EdgeShuffleTopology& e_topo) noexcept;
+
+  /// Builds the sparse index given the prefix sums of the per node type
+  /// counts returned by CountEdgeTypesPerNode(); they become
+  /// sparse_node_offsets_
+  static EdgeTypeAwareTopology MakeSparse(
+      const PropertyGraph& pg,
+      std::shared_ptr<const CondensedTypeIDMap> edge_type_index,
+      EdgeShuffleTopology&& e_topo, AdjIndexVec&& node_offsets) noexcept;
+
   EdgeTypeAwareTopology(
       EdgeShuffleTopology&& e_topo,
       std::shared_ptr<const CondensedTypeIDMap> edge_type_index,
       AdjIndexVec&& per_type_adj_indices) noexcept
       : Base(std::move(e_topo)),
         edge_type_index_(std::move(edge_type_index)),
+        index_layout_(IndexLayout::kDense),
         per_type_adj_indices_(std::move(per_type_adj_indices)) {
     KATANA_LOG_DEBUG_ASSERT(edge_type_index_);
 
@@ -881,136 +1133,687 @@ private:
         NumNodes() * edge_type_index_->num_unique_types());
   }
 
+  EdgeTypeAwareTopology(
+      EdgeShuffleTopology&& e_topo,
+      std::shared_ptr<const CondensedTypeIDMap> edge_type_index,
+      AdjIndexVec&& sparse_node_offsets,
+      NUMAArray<uint32_t>&& sparse_type_indices,
+      AdjIndexVec&& sparse_type_ends) noexcept
+      : Base(std::move(e_topo)),
+        edge_type_index_(std::move(edge_type_index)),
+        index_layout_(IndexLayout::kSparse),
+        sparse_node_offsets_(std::move(sparse_node_offsets)),
+        sparse_type_indices_(std::move(sparse_type_indices)),
+        sparse_type_ends_(std::move(sparse_type_ends)) {
+    KATANA_LOG_DEBUG_ASSERT(edge_type_index_);
+
+    KATANA_LOG_DEBUG_ASSERT(sparse_node_offsets_.size() == NumNodes());
+    KATANA_LOG_DEBUG_ASSERT(
+        sparse_type_indices_.size() == sparse_type_ends_.size());
+    KATANA_LOG_DEBUG_ASSERT(
+        NumNodes() == 0 ||
+        sparse_node_offsets_[NumNodes() - 1] == sparse_type_ends_.size());
+  }
+
+  edges_range SparseOutEdges(Node N, uint32_t type_index) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(N < sparse_node_offsets_.size());
+    const uint64_t first = (N == 0) ? 0 : sparse_node_offsets_[N - 1];
+    const uint64_t last = sparse_node_offsets_[N];
+
+    auto beg = sparse_type_indices_.begin() + first;
+    auto end = sparse_type_indices_.begin() + last;
+    auto it = std::lower_bound(beg, end, type_index);
+    const uint64_t pos = first + std::distance(beg, it);
+
+    // runs of a node are contiguous, so a run starts where the previous run of
+    // the same node ends
+    edge_iterator e_beg{
+        (it == beg) ? *Base::OutEdges(N).begin() : sparse_type_ends_[pos - 1]};
+    if (it == end || *it != type_index) {
+      // return empty range
+      return katana::MakeStandardRange(e_beg, e_beg);
+    }
+    edge_iterator e_end{sparse_type_ends_[pos]};
+
+    return katana::MakeStandardRange(e_beg, e_end);
+  }
+
   std::shared_ptr<const CondensedTypeIDMap> edge_type_index_;
+  IndexLayout index_layout_;
+
+  /// dense layout
   AdjIndexVec per_type_adj_indices_;
-};
 
-/****************************/
-/* Topology wrapper classes */
-/****************************/
+  /// sparse layout: for node N, the pairs in
+  /// [sparse_node_offsets_[N - 1], sparse_node_offsets_[N]) hold the condensed
+  /// type index and the end edge of each run of same typed out-edges
+  AdjIndexVec sparse_node_offsets_;
+  NUMAArray<uint32_t> sparse_type_indices_;
+  AdjIndexVec sparse_type_ends_;
+
+  /// optional destination index: the out-edge destinations of node N, sorted,
+  /// are at the positions of the out-edges of N; see BuildDestIndex()
+  NUMAArray<Node> sorted_dests_;
+  bool has_dest_index_ = false;
+};
 
-template <typename Topo>
-class KATANA_EXPORT BasicTopologyWrapper : public GraphTopologyTypes {
+/// A read-only topology that stores edge destinations compressed.
+///
+/// Edges are grouped into blocks of kBlockSize consecutive edge ids. The first
+/// destination of a block is stored as an unsigned varint and every following
+/// destination is stored as a zigzag varint of its difference to the previous
+/// destination. When edges are sorted by destination, most differences are
+/// small gaps within one adjacency list and take a single byte.
+///
+/// Node ids, edge ids and the adjacency index are the same as in the topology
+/// the compressed topology was built from, so property lookups work unchanged.
+/// The edge property index map is left out if it is the identity and kept as
+/// 32-bit indexes if they fit, so it does not undo the savings.
+///
+/// OutEdgeDst() decodes from the start of the enclosing block, on average
+/// kBlockSize / 2 varints, most of them eight at a time, so random access
+/// costs more than in an uncompressed topology; compressed-topology-bench
+/// measures by how much. Traversals that visit all out-edges
+/// of a node should use ForEachOutEdgeDst() or DecodeOutEdgeDsts(), which
+/// decode each block once.
+class KATANA_EXPORT CompressedGraphTopology : public GraphTopologyTypes {
 public:
-  explicit BasicTopologyWrapper(std::shared_ptr<const Topo> t) noexcept
-      : topo_ptr_(std::move(t)) {
-    KATANA_LOG_DEBUG_ASSERT(topo_ptr_);
+  /// number of edges per independently decodable block
+  static constexpr size_t kBlockSize = 64;
+
+  using ByteVec = NUMAArray<uint8_t>;
+  using BlockOffsetVec = NUMAArray<uint64_t>;
+
+  CompressedGraphTopology() = default;
+  CompressedGraphTopology(CompressedGraphTopology&&) = default;
+  CompressedGraphTopology& operator=(CompressedGraphTopology&&) = default;
+
+  CompressedGraphTopology(const CompressedGraphTopology&) = delete;
+  CompressedGraphTopology& operator=(const CompressedGraphTopology&) = delete;
+
+  virtual ~CompressedGraphTopology();
+
+  /// Compress the destinations of \p seed_topo. Compression works on any edge
+  /// order but is only effective if edges are sorted by destination.
+  static std::shared_ptr<CompressedGraphTopology> MakeFrom(
+      const EdgeShuffleTopology& seed_topo) noexcept;
+
+  static std::shared_ptr<CompressedGraphTopology> Make(RDGTopology* rdg_topo);
+
+  katana::Result<RDGTopology> ToRDGTopology() const;
+
+  uint64_t NumNodes() const noexcept { return adj_indices_.size(); }
+
+  uint64_t NumEdges() const noexcept { return num_edges_; }
+
+  const Edge* AdjData() const noexcept { return adj_indices_.data(); }
+
+  /// @returns number of bytes used to store destinations, including block
+  /// offsets
+  size_t CompressedSizeBytes() const noexcept {
+    return num_data_bytes_ + block_offsets_.size() * sizeof(uint64_t);
   }
 
-  auto NumNodes() const noexcept { return topo().NumNodes(); }
+  /// @returns the bytes taken by the map from edges to edge property
+  /// indexes; see GraphTopology::EdgePropertyIndexSizeBytes
+  size_t EdgePropertyIndexSizeBytes() const noexcept {
+    return narrow_edge_prop_indices_.size() * sizeof(uint32_t) +
+           edge_prop_indices_.size() * sizeof(PropertyIndex);
+  }
 
-  auto NumEdges() const noexcept { return topo().NumEdges(); }
+  edges_range OutEdges() const noexcept {
+    return MakeStandardRange<edge_iterator>(Edge{0}, Edge{NumEdges()});
+  }
 
-  /// Gets all out-edges.
-  auto OutEdges() const noexcept { return topo().OutEdges(); }
+  edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node <= adj_indices_.size());
+    edge_iterator e_beg{node > 0 ? adj_indices_[node - 1] : 0};
+    edge_iterator e_end{adj_indices_[node]};
 
-  /// Gets the edge range of some node.
-  ///
-  /// \param node node to get the edge range of
-  /// \returns iterable edge range for node.
-  auto OutEdges(const Node& N) const noexcept { return topo().OutEdges(N); }
+    return MakeStandardRange(e_beg, e_end);
+  }
 
-  auto OutEdgeDst(const Edge& eid) const noexcept {
-    return topo().OutEdgeDst(eid);
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < NumEdges());
+    Node ret{};
+    DecodeRange(edge_id, edge_id + 1, [&](Edge, Node dst) { ret = dst; });
+    return ret;
   }
 
-  auto GetEdgeSrc(const Edge& eid) const noexcept {
-    return topo().GetEdgeSrc(eid);
+  Node GetEdgeSrc(const Edge& eid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+    auto it = std::upper_bound(adj_indices_.begin(), adj_indices_.end(), eid);
+    KATANA_LOG_DEBUG_ASSERT(it != adj_indices_.end());
+    return static_cast<Node>(std::distance(adj_indices_.begin(), it));
   }
 
-  /// @param node node to get degree for
-  /// @returns Degree of node N
-  auto OutDegree(const Node& node) const noexcept {
-    return topo().OutDegree(node);
+  /// Call \p func(edge, dst) for every out-edge of \p node in edge order.
+  template <typename F>
+  void ForEachOutEdgeDst(Node node, const F& func) const noexcept {
+    auto r = OutEdges(node);
+    DecodeRange(*r.begin(), *r.end(), func);
   }
 
-  auto Nodes() const noexcept { return topo().Nodes(); }
+  /// Decode the destinations of all out-edges of \p node into \p out, which
+  /// must have room for OutDegree(node) elements.
+  void DecodeOutEdgeDsts(Node node, Node* out) const noexcept {
+    auto r = OutEdges(node);
+    Edge first = *r.begin();
+    DecodeRange(
+        first, *r.end(), [&](Edge e, Node dst) { out[e - first] = dst; });
+  }
 
-  // Standard container concepts
+  size_t OutDegree(Node node) const noexcept { return OutEdges(node).size(); }
 
-  auto begin() const noexcept { return topo().begin(); }
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
 
-  auto end() const noexcept { return topo().end(); }
+  node_iterator begin() const noexcept { return node_iterator(0); }
 
-  auto size() const noexcept { return topo().size(); }
+  node_iterator end() const noexcept { return node_iterator(NumNodes()); }
 
-  auto empty() const noexcept { return topo().empty(); }
+  size_t size() const noexcept { return NumNodes(); }
 
-  auto GetEdgePropertyIndexFromOutEdge(const Edge& e) const noexcept {
-    return topo().GetEdgePropertyIndexFromOutEdge(e);
+  bool empty() const noexcept { return NumNodes() == 0; }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& eid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+    if (!narrow_edge_prop_indices_.empty()) {
+      return narrow_edge_prop_indices_[eid];
+    }
+    return edge_prop_indices_.empty() ? eid : edge_prop_indices_[eid];
   }
 
-  auto GetNodePropertyIndex(const Node& nid) const noexcept {
-    return topo().GetNodePropertyIndex(nid);
+  PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(nid < NumNodes() || NumNodes() == 0);
+    return node_prop_indices_.empty() ? nid : node_prop_indices_[nid];
   }
-  auto GetLocalNodeID(const Node& nid) const noexcept {
-    return topo().GetLocalNodeID(nid);
+
+  Node GetLocalNodeID(const Node& nid) const noexcept {
+    return static_cast<Node>(GetNodePropertyIndex(nid));
   }
 
-  auto GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
-    return topo().GetLocalEdgeIDFromOutEdge(eid);
+  Edge GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
+    return GetEdgePropertyIndexFromOutEdge(eid);
   }
-  void Print() const noexcept { topo_ptr_->Print(); }
 
-protected:
-  const Topo& topo() const noexcept { return *topo_ptr_.get(); }
+  bool is_valid() const noexcept { return is_valid_; }
 
-private:
-  std::shared_ptr<const Topo> topo_ptr_;
-};
+  void invalidate() noexcept { is_valid_ = false; }
 
-template <typename OutTopo, typename InTopo>
-class KATANA_EXPORT BasicBiDirTopoWrapper
-    : public BasicTopologyWrapper<OutTopo> {
-  using Base = BasicTopologyWrapper<OutTopo>;
+  bool is_transposed() const noexcept {
+    return tpose_state_ == RDGTopology::TransposeKind::kYes;
+  }
 
-public:
-  BasicBiDirTopoWrapper(
-      std::shared_ptr<const OutTopo> out_topo,
-      std::shared_ptr<const InTopo> in_topo) noexcept
-      : Base(std::move(out_topo)), in_topo_(std::move(in_topo)) {
-    KATANA_LOG_DEBUG_ASSERT(in_topo_);
+  bool has_transpose_state(
+      const RDGTopology::TransposeKind& expected) const noexcept {
+    return tpose_state_ == expected;
+  }
 
-    KATANA_LOG_DEBUG_ASSERT(in_topo_->is_transposed());
+  RDGTopology::TransposeKind transpose_state() const noexcept {
+    return tpose_state_;
+  }
 
-    KATANA_LOG_DEBUG_ASSERT(out().NumNodes() == in_topo_->NumNodes());
-    KATANA_LOG_DEBUG_ASSERT(out().NumEdges() == in_topo_->NumEdges());
+  RDGTopology::EdgeSortKind edge_sort_state() const noexcept {
+    return edge_sort_state_;
   }
 
-  auto InEdges(const GraphTopologyTypes::Node& node) const noexcept {
-    return in().OutEdges(node);
+  void Print() const noexcept;
+
+private:
+  /// Bytes appended to the encoded stream so the word-at-a-time decoder can
+  /// always load 8 bytes
+  static constexpr size_t kDecodePadding = sizeof(uint64_t);
+
+  static size_t VarintSize(uint64_t v) noexcept {
+    size_t n = 1;
+    while (v >= 0x80) {
+      v >>= 7;
+      ++n;
+    }
+    return n;
   }
 
-  auto InDegree(const GraphTopologyTypes::Node& node) const noexcept {
-    return in().OutDegree(node);
+  static uint8_t* EncodeVarint(uint64_t v, uint8_t* p) noexcept {
+    while (v >= 0x80) {
+      *p++ = static_cast<uint8_t>(v | 0x80);
+      v >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(v);
+    return p;
   }
 
-  auto InEdgeSrc(const GraphTopologyTypes::Edge& edge_id) const noexcept {
-    return in().OutEdgeDst(edge_id);
+  static uint64_t DecodeVarint(const uint8_t*& p) noexcept {
+    uint64_t v = 0;
+    unsigned shift = 0;
+    uint8_t b = 0;
+    do {
+      b = *p++;
+      v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    return v;
   }
 
-  // TODO(yan): This will become GetEdgePropertyIndex(InEdgeHandle) once we
-  // introduce new opaque indexing types.
-  auto GetEdgePropertyIndexFromInEdge(
-      const GraphTopologyTypes::Edge& eid) const noexcept {
-    return in().GetEdgePropertyIndexFromOutEdge(eid);
+  static uint64_t ZigZagEncode(int64_t v) noexcept {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
   }
 
-  auto GetLocalEdgeIDFromInEdge(
-      const GraphTopologyTypes::Edge& eid) const noexcept {
-    return in().GetLocalEdgeIDFromOutEdge(eid);
+  static int64_t ZigZagDecode(uint64_t v) noexcept {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
   }
 
-protected:
-  const OutTopo& out() const noexcept { return Base::topo(); }
-  const InTopo& in() const noexcept { return *in_topo_.get(); }
+  /// Decode destinations of edges [beg, end) and call func(edge, dst) on each.
+  template <typename F>
+  void DecodeRange(Edge beg, Edge end, const F& func) const noexcept {
+    constexpr uint64_t kContinuationBits = 0x8080808080808080ULL;
 
-private:
-  std::shared_ptr<const InTopo> in_topo_;
-};
+    Edge e = beg - (beg % kBlockSize);
+    while (e < end) {
+      const Edge block_end =
+          std::min<Edge>(e + kBlockSize, static_cast<Edge>(NumEdges()));
+      const uint8_t* p = data_.data() + block_offsets_[e / kBlockSize];
 
-template <typename OutTopo, typename InTopo>
-class KATANA_EXPORT UndirectedTopologyWrapper : public GraphTopologyTypes {
+      int64_t prev = static_cast<int64_t>(DecodeVarint(p));
+      if (e >= beg) {
+        func(e, static_cast<Node>(prev));
+      }
+      ++e;
+
+      const Edge stop = std::min(block_end, end);
+      while (e < stop) {
+        // Fast path: eight single-byte gaps decoded from one word.
+        if (e + 8 <= stop) {
+          uint64_t word;
+          std::memcpy(&word, p, sizeof(word));
+          if ((word & kContinuationBits) == 0) {
+            for (size_t i = 0; i < 8; ++i, ++e) {
+              prev += ZigZagDecode((word >> (8 * i)) & 0xff);
+              if (e >= beg) {
+                func(e, static_cast<Node>(prev));
+              }
+            }
+            p += 8;
+            continue;
+          }
+        }
+        prev += ZigZagDecode(DecodeVarint(p));
+        if (e >= beg) {
+          func(e, static_cast<Node>(prev));
+        }
+        ++e;
+      }
+    }
+  }
+
+  CompressedGraphTopology(
+      const RDGTopology::TransposeKind& tpose_state,
+      const RDGTopology::EdgeSortKind& edge_sort_state,
+      AdjIndexVec&& adj_indices, uint64_t num_edges,
+      BlockOffsetVec&& block_offsets, ByteVec&& data, size_t num_data_bytes,
+      PropIndexVec&& edge_prop_indices,
+      NUMAArray<uint32_t>&& narrow_edge_prop_indices,
+      PropIndexVec&& node_prop_indices) noexcept
+      : adj_indices_(std::move(adj_indices)),
+        num_edges_(num_edges),
+        block_offsets_(std::move(block_offsets)),
+        data_(std::move(data)),
+        num_data_bytes_(num_data_bytes),
+        edge_prop_indices_(std::move(edge_prop_indices)),
+        narrow_edge_prop_indices_(std::move(narrow_edge_prop_indices)),
+        node_prop_indices_(std::move(node_prop_indices)),
+        tpose_state_(tpose_state),
+        edge_sort_state_(edge_sort_state) {}
+
+  AdjIndexVec adj_indices_;
+  uint64_t num_edges_{0};
+  /// byte offset into data_ of the first destination of every block
+  BlockOffsetVec block_offsets_;
+  /// encoded destinations followed by kDecodePadding zero bytes
+  ByteVec data_;
+  size_t num_data_bytes_{0};
+
+  PropIndexVec edge_prop_indices_;
+  /// edge_prop_indices_ when it fits in 32 bits; at most one of the two is
+  /// not empty, and if both are empty, the map is the identity
+  NUMAArray<uint32_t> narrow_edge_prop_indices_;
+  PropIndexVec node_prop_indices_;
+
+  RDGTopology::TransposeKind tpose_state_{RDGTopology::TransposeKind::kNo};
+  RDGTopology::EdgeSortKind edge_sort_state_{RDGTopology::EdgeSortKind::kAny};
+
+  bool is_valid_ = true;
+};
+
+/// A read-only projection of a topology onto a subset of its nodes and of
+/// the edges between them, which shares the destinations of the topology it
+/// projects instead of copying them.
+///
+/// Projected nodes are numbered in the order of the base topology and are
+/// mapped to and from base nodes through a pair of remap tables. Every
+/// projected node keeps the range of base edges from its first to its last
+/// kept out-edge, and OutEdges() walks that range and skips the edges that
+/// were not kept, so edge ids are base edge ids. A projection costs a pass
+/// over the out-edges of the selected nodes, a bit per base edge and a few
+/// words per projected node.
+///
+/// When few of the edges in the ranges are kept, walking them costs more
+/// than a copy of the kept edges would, so MakeFrom compacts the kept edges
+/// into a CSR of their own if the fraction of kept edges is below a
+/// threshold. Edge ids of a compacted projection are 0..NumEdges().
+class KATANA_EXPORT ProjectedTopology : public GraphTopologyTypes {
+public:
+  /// By default, projections in which less than half of the edges in the
+  /// ranges are kept are compacted
+  static constexpr double kDefaultCompactBelow = 0.5;
+
+  /// The filter of OutEdges(); a null bitset keeps every edge
+  struct IsKeptEdge {
+    const DynamicBitset* kept{nullptr};
+
+    bool operator()(Edge e) const noexcept { return !kept || kept->test(e); }
+  };
+
+  using out_edge_iterator = boost::filter_iterator<IsKeptEdge, edge_iterator>;
+  using out_edges_range = StandardRange<out_edge_iterator>;
+
+  ProjectedTopology() = default;
+  ProjectedTopology(ProjectedTopology&&) = default;
+  ProjectedTopology& operator=(ProjectedTopology&&) = default;
+
+  ProjectedTopology(const ProjectedTopology&) = delete;
+  ProjectedTopology& operator=(const ProjectedTopology&) = delete;
+
+  virtual ~ProjectedTopology();
+
+  /// Project \p base onto the nodes set in \p nodes and the edges between
+  /// them whose type is a subtype of one of \p edge_types, or all of them if
+  /// \p edge_types is not given.
+  ///
+  /// \param compact_below compact if less than this fraction of the edges in
+  ///     the ranges is kept; 0 never compacts and anything above 1 always does
+  static std::shared_ptr<ProjectedTopology> MakeFrom(
+      const PropertyGraph* pg, std::shared_ptr<const GraphTopology> base,
+      const DynamicBitset& nodes,
+      const std::optional<std::vector<EntityTypeID>>& edge_types,
+      double compact_below = kDefaultCompactBelow) noexcept;
+
+  uint64_t NumNodes() const noexcept { return projected_to_original_.size(); }
+
+  uint64_t NumEdges() const noexcept { return num_edges_; }
+
+  /// @returns true if the kept edges were copied into a CSR of their own
+  bool is_compacted() const noexcept { return !kept_edges_; }
+
+  /// Gets all out-edges.
+  out_edges_range OutEdges() const noexcept {
+    Edge end = is_compacted() ? num_edges_ : base_->NumEdges();
+    return MakeOutEdges(Edge{0}, end);
+  }
+
+  out_edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    return MakeOutEdges(range_begins_[node], range_ends_[node]);
+  }
+
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    if (is_compacted()) {
+      return dests_[edge_id];
+    }
+    KATANA_LOG_DEBUG_ASSERT(kept_edges_->test(edge_id));
+    return original_to_projected_[base_->OutEdgeDst(edge_id)];
+  }
+
+  Node GetEdgeSrc(const Edge& eid) const noexcept {
+    if (!is_compacted()) {
+      return original_to_projected_[base_->GetEdgeSrc(eid)];
+    }
+    KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+    auto it = std::upper_bound(range_ends_.begin(), range_ends_.end(), eid);
+    KATANA_LOG_DEBUG_ASSERT(it != range_ends_.end());
+    return static_cast<Node>(std::distance(range_ends_.begin(), it));
+  }
+
+  size_t OutDegree(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    return is_compacted() ? range_ends_[node] - range_begins_[node]
+                          : degrees_[node];
+  }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(NumNodes()));
+  }
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(NumNodes()); }
+
+  size_t size() const noexcept { return NumNodes(); }
+
+  bool empty() const noexcept { return NumNodes() == 0; }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& eid) const noexcept {
+    return is_compacted() ? edge_prop_indices_[eid]
+                          : base_->GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(nid < NumNodes());
+    return base_->GetNodePropertyIndex(projected_to_original_[nid]);
+  }
+
+  Node GetLocalNodeID(const Node& nid) const noexcept {
+    return static_cast<Node>(GetNodePropertyIndex(nid));
+  }
+
+  Edge GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
+    return GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  /// @returns the node of the base topology that \p nid is the projection of
+  Node GetOriginalNodeID(const Node& nid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(nid < NumNodes());
+    return projected_to_original_[nid];
+  }
+
+  /// @returns the projection of node \p nid of the base topology, or
+  /// NumNodes() if \p nid is not in the projection
+  Node GetProjectedNodeID(const Node& nid) const noexcept {
+    return original_to_projected_[nid];
+  }
+
+  void Print() const noexcept;
+
+private:
+  ProjectedTopology(
+      std::shared_ptr<const GraphTopology> base,
+      EdgeDestVec&& projected_to_original, EdgeDestVec&& original_to_projected,
+      AdjIndexVec&& range_begins, AdjIndexVec&& range_ends,
+      AdjIndexVec&& degrees, std::unique_ptr<DynamicBitset>&& kept_edges,
+      EdgeDestVec&& dests, PropIndexVec&& edge_prop_indices,
+      uint64_t num_edges) noexcept
+      : base_(std::move(base)),
+        projected_to_original_(std::move(projected_to_original)),
+        original_to_projected_(std::move(original_to_projected)),
+        range_begins_(std::move(range_begins)),
+        range_ends_(std::move(range_ends)),
+        degrees_(std::move(degrees)),
+        kept_edges_(std::move(kept_edges)),
+        dests_(std::move(dests)),
+        edge_prop_indices_(std::move(edge_prop_indices)),
+        num_edges_(num_edges) {}
+
+  out_edges_range MakeOutEdges(Edge begin, Edge end) const noexcept {
+    IsKeptEdge is_kept{kept_edges_.get()};
+    return MakeStandardRange(
+        out_edge_iterator(is_kept, edge_iterator{begin}, edge_iterator{end}),
+        out_edge_iterator(is_kept, edge_iterator{end}, edge_iterator{end}));
+  }
+
+  std::shared_ptr<const GraphTopology> base_;
+  EdgeDestVec projected_to_original_;
+  EdgeDestVec original_to_projected_;
+
+  /// edge range of every projected node, which is the CSR of the kept edges
+  /// once compacted
+  AdjIndexVec range_begins_;
+  AdjIndexVec range_ends_;
+
+  /// only used before compaction
+  AdjIndexVec degrees_;
+  std::unique_ptr<DynamicBitset> kept_edges_;
+
+  /// only used after compaction
+  EdgeDestVec dests_;
+  PropIndexVec edge_prop_indices_;
+
+  uint64_t num_edges_{0};
+};
+
+/****************************/
+/* Topology wrapper classes */
+/****************************/
+
+template <typename Topo>
+class KATANA_EXPORT BasicTopologyWrapper : public GraphTopologyTypes {
+public:
+  explicit BasicTopologyWrapper(std::shared_ptr<const Topo> t) noexcept
+      : topo_ptr_(std::move(t)) {
+    KATANA_LOG_DEBUG_ASSERT(topo_ptr_);
+  }
+
+  auto NumNodes() const noexcept { return topo().NumNodes(); }
+
+  auto NumEdges() const noexcept { return topo().NumEdges(); }
+
+  /// Gets all out-edges.
+  auto OutEdges() const noexcept { return topo().OutEdges(); }
+
+  /// Gets the edge range of some node.
+  ///
+  /// \param node node to get the edge range of
+  /// \returns iterable edge range for node.
+  auto OutEdges(const Node& N) const noexcept { return topo().OutEdges(N); }
+
+  auto OutEdgeDst(const Edge& eid) const noexcept {
+    return topo().OutEdgeDst(eid);
+  }
+
+  /// Gets the destinations of the out-edges of a node as one contiguous
+  /// array, in the order of OutEdges(node). In views with edges sorted by
+  /// destination, this is a sorted set that can be intersected with
+  /// katana::analytics::CountIntersection.
+  ///
+  /// \param node node to get the destinations of
+  /// \returns range of pointers to the destinations
+  StandardRange<const Node*> OutEdgeDsts(const Node& node) const noexcept {
+    auto edges = topo().OutEdges(node);
+    const Node* dests = topo().DestData();
+    return MakeStandardRange(dests + *edges.begin(), dests + *edges.end());
+  }
+
+  auto GetEdgeSrc(const Edge& eid) const noexcept {
+    return topo().GetEdgeSrc(eid);
+  }
+
+  /// @param node node to get degree for
+  /// @returns Degree of node N
+  auto OutDegree(const Node& node) const noexcept {
+    return topo().OutDegree(node);
+  }
+
+  auto Nodes() const noexcept { return topo().Nodes(); }
+
+  // Standard container concepts
+
+  auto begin() const noexcept { return topo().begin(); }
+
+  auto end() const noexcept { return topo().end(); }
+
+  auto size() const noexcept { return topo().size(); }
+
+  auto empty() const noexcept { return topo().empty(); }
+
+  auto GetEdgePropertyIndexFromOutEdge(const Edge& e) const noexcept {
+    return topo().GetEdgePropertyIndexFromOutEdge(e);
+  }
+
+  auto GetNodePropertyIndex(const Node& nid) const noexcept {
+    return topo().GetNodePropertyIndex(nid);
+  }
+  auto GetLocalNodeID(const Node& nid) const noexcept {
+    return topo().GetLocalNodeID(nid);
+  }
+
+  auto GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
+    return topo().GetLocalEdgeIDFromOutEdge(eid);
+  }
+  void Print() const noexcept { topo_ptr_->Print(); }
+
+protected:
+  const Topo& topo() const noexcept { return *topo_ptr_.get(); }
+
+private:
+  std::shared_ptr<const Topo> topo_ptr_;
+};
+
+template <typename OutTopo, typename InTopo>
+class KATANA_EXPORT BasicBiDirTopoWrapper
+    : public BasicTopologyWrapper<OutTopo> {
+  using Base = BasicTopologyWrapper<OutTopo>;
+
+public:
+  BasicBiDirTopoWrapper(
+      std::shared_ptr<const OutTopo> out_topo,
+      std::shared_ptr<const InTopo> in_topo) noexcept
+      : Base(std::move(out_topo)), in_topo_(std::move(in_topo)) {
+    KATANA_LOG_DEBUG_ASSERT(in_topo_);
+
+    KATANA_LOG_DEBUG_ASSERT(in_topo_->is_transposed());
+
+    KATANA_LOG_DEBUG_ASSERT(out().NumNodes() == in_topo_->NumNodes());
+    KATANA_LOG_DEBUG_ASSERT(out().NumEdges() == in_topo_->NumEdges());
+  }
+
+  auto InEdges(const GraphTopologyTypes::Node& node) const noexcept {
+    return in().OutEdges(node);
+  }
+
+  auto InDegree(const GraphTopologyTypes::Node& node) const noexcept {
+    return in().OutDegree(node);
+  }
+
+  auto InEdgeSrc(const GraphTopologyTypes::Edge& edge_id) const noexcept {
+    return in().OutEdgeDst(edge_id);
+  }
+
+  // TODO(yan): This will become GetEdgePropertyIndex(InEdgeHandle) once we
+  // introduce new opaque indexing types.
+  auto GetEdgePropertyIndexFromInEdge(
+      const GraphTopologyTypes::Edge& eid) const noexcept {
+    return in().GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  auto GetLocalEdgeIDFromInEdge(
+      const GraphTopologyTypes::Edge& eid) const noexcept {
+    return in().GetLocalEdgeIDFromOutEdge(eid);
+  }
+
+protected:
+  const OutTopo& out() const noexcept { return Base::topo(); }
+  const InTopo& in() const noexcept { return *in_topo_.get(); }
+
+private:
+  std::shared_ptr<const InTopo> in_topo_;
+};
+
+template <typename OutTopo, typename InTopo>
+class KATANA_EXPORT UndirectedTopologyWrapper : public GraphTopologyTypes {
   // Important:
   // We assign fake Edge IDs to in_edges to separate them from out edges
   // fake in-edge-ID == real in-edge-ID + out().NumEdges();
@@ -1159,6 +1962,17 @@ public:
     return Base::topo().FindEdge(src, dst);
   }
 
+  auto FindEdge(
+      const Node& src, const Node& dst,
+      const typename Base::edge_iterator& hint) const noexcept {
+    return Base::topo().FindEdge(src, dst, hint);
+  }
+
+  auto FindEdges(
+      const Node& src, const std::vector<Node>& sorted_dsts) const noexcept {
+    return Base::topo().FindEdges(src, sorted_dsts);
+  }
+
   auto HasEdge(const Node& src, const Node& dst) const noexcept {
     return Base::topo().HasEdge(src, dst);
   }
@@ -1168,6 +1982,226 @@ public:
   }
 };
 
+class KATANA_EXPORT CompressedTopologyWrapper
+    : public BasicTopologyWrapper<CompressedGraphTopology> {
+  using Base = BasicTopologyWrapper<CompressedGraphTopology>;
+
+public:
+  explicit CompressedTopologyWrapper(
+      std::shared_ptr<const CompressedGraphTopology> t) noexcept
+      : Base(std::move(t)) {}
+
+  template <typename F>
+  void ForEachOutEdgeDst(const Node& node, const F& func) const noexcept {
+    Base::topo().ForEachOutEdgeDst(node, func);
+  }
+
+  void DecodeOutEdgeDsts(const Node& node, Node* out) const noexcept {
+    Base::topo().DecodeOutEdgeDsts(node, out);
+  }
+
+  size_t CompressedSizeBytes() const noexcept {
+    return Base::topo().CompressedSizeBytes();
+  }
+
+  size_t EdgePropertyIndexSizeBytes() const noexcept {
+    return Base::topo().EdgePropertyIndexSizeBytes();
+  }
+};
+
+class KATANA_EXPORT ProjectedTopologyWrapper
+    : public BasicTopologyWrapper<ProjectedTopology> {
+  using Base = BasicTopologyWrapper<ProjectedTopology>;
+
+public:
+  explicit ProjectedTopologyWrapper(
+      std::shared_ptr<const ProjectedTopology> t) noexcept
+      : Base(std::move(t)) {}
+
+  bool is_compacted() const noexcept { return Base::topo().is_compacted(); }
+
+  auto GetOriginalNodeID(const Node& nid) const noexcept {
+    return Base::topo().GetOriginalNodeID(nid);
+  }
+
+  auto GetProjectedNodeID(const Node& nid) const noexcept {
+    return Base::topo().GetProjectedNodeID(nid);
+  }
+};
+
+/// A TemporalTopology, transposed or not. The transpose kind is a template
+/// parameter so that the two views are different types.
+template <RDGTopology::TransposeKind kTranspose>
+class TemporalTopologyWrapper : public BasicTopologyWrapper<TemporalTopology> {
+  using Base = BasicTopologyWrapper<TemporalTopology>;
+
+public:
+  using Timestamp = TemporalTopology::Timestamp;
+
+  explicit TemporalTopologyWrapper(
+      std::shared_ptr<const TemporalTopology> t) noexcept
+      : Base(std::move(t)) {
+    KATANA_LOG_DEBUG_ASSERT(Base::topo().has_transpose_state(kTranspose));
+  }
+
+  using Base::OutEdges;
+
+  /// Gets the out-edges of \p node with a timestamp in [\p begin, \p end)
+  auto OutEdges(
+      const Node& node, Timestamp begin, Timestamp end) const noexcept {
+    return Base::topo().OutEdges(node, begin, end);
+  }
+
+  auto OutDegree(
+      const Node& node, Timestamp begin, Timestamp end) const noexcept {
+    return OutEdges(node, begin, end).size();
+  }
+
+  using Base::OutDegree;
+
+  Timestamp OutEdgeTimestamp(const Edge& eid) const noexcept {
+    return Base::topo().OutEdgeTimestamp(eid);
+  }
+
+  const std::string& timestamp_property() const noexcept {
+    return Base::topo().timestamp_property();
+  }
+};
+
+/// The default topology together with the source of every edge, i.e., the
+/// topology in coordinate (COO) form as well as CSR. GetEdgeSrc reads the
+/// source of an edge instead of searching the adjacency indices for it, so
+/// loops over edges rather than nodes stream through both arrays.
+class KATANA_EXPORT EdgeSourcesTopologyWrapper
+    : public BasicTopologyWrapper<GraphTopology> {
+  using Base = BasicTopologyWrapper<GraphTopology>;
+
+public:
+  EdgeSourcesTopologyWrapper(
+      std::shared_ptr<const GraphTopology> t,
+      std::shared_ptr<const EdgeDestVec> edge_srcs) noexcept
+      : Base(std::move(t)), edge_srcs_(std::move(edge_srcs)) {
+    KATANA_LOG_DEBUG_ASSERT(edge_srcs_);
+    KATANA_LOG_DEBUG_ASSERT(edge_srcs_->size() == Base::NumEdges());
+  }
+
+  Node GetEdgeSrc(const Edge& eid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(eid < edge_srcs_->size());
+    return (*edge_srcs_)[eid];
+  }
+
+  /// Gets the sources of all edges as one contiguous array indexed by edge
+  const Node* EdgeSrcData() const noexcept { return edge_srcs_->data(); }
+
+  /// Calls func(edge, src, dst) for each edge of \p edges in order, e.g.,
+  /// for a block of OutEdges() in an edge parallel loop
+  template <typename F>
+  void ForEachEdge(const edges_range& edges, const F& func) const noexcept {
+    const Node* srcs = edge_srcs_->data();
+    const Node* dests = Base::topo().DestData();
+    for (Edge e = *edges.begin(), end = *edges.end(); e < end; ++e) {
+      func(e, srcs[e], dests[e]);
+    }
+  }
+
+private:
+  std::shared_ptr<const EdgeDestVec> edge_srcs_;
+};
+
+/// Copies of the adjacency indices and destinations of a topology, one per
+/// socket of the active threads, each with its pages on its socket. Local()
+/// gives the copy of the socket of the calling thread, so that random reads
+/// of the topology do not cross the interconnect, at the cost of one copy of
+/// the topology per socket. With a single socket there are no copies and
+/// Local() is the topology itself.
+class KATANA_EXPORT TopologyReplicas : public GraphTopologyTypes {
+public:
+  /// The arrays of one copy
+  struct Replica {
+    const Edge* adj_indices;
+    const Node* dests;
+  };
+
+  static std::shared_ptr<TopologyReplicas> Make(
+      const std::shared_ptr<const GraphTopology>& topo) noexcept;
+
+  const Replica& Local() const noexcept {
+    unsigned socket = ThreadPool::getSocket();
+    return socket < replicas_.size() ? replicas_[socket] : replicas_[0];
+  }
+
+  /// @returns true if these are the copies of \p topo
+  bool IsReplicaOf(const GraphTopology* topo) const noexcept {
+    return !base_.expired() && base_.lock().get() == topo;
+  }
+
+  /// @returns true if the topology these are copies of is gone
+  bool expired() const noexcept { return base_.expired(); }
+
+  size_t num_copies() const noexcept { return adj_copies_.size(); }
+
+  size_t SizeBytes() const noexcept {
+    return num_copies() *
+           (num_nodes_ * sizeof(Edge) + num_edges_ * sizeof(Node));
+  }
+
+private:
+  TopologyReplicas() = default;
+
+  std::weak_ptr<const GraphTopology> base_;
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+  std::vector<AdjIndexVec> adj_copies_;
+  std::vector<EdgeDestVec> dest_copies_;
+  /// one per socket, or only the topology itself
+  std::vector<Replica> replicas_;
+};
+
+/// A topology wrapper that reads the out-edges of nodes from the copy of the
+/// topology on the socket of the calling thread; see TopologyReplicas. Other
+/// queries, e.g., FindEdge, go to the topology itself.
+template <typename WrapperBase>
+class ReplicatedTopologyWrapper : public WrapperBase {
+public:
+  using typename WrapperBase::Edge;
+  using typename WrapperBase::edge_iterator;
+  using typename WrapperBase::edges_range;
+  using typename WrapperBase::Node;
+
+  template <typename TopoPtr>
+  ReplicatedTopologyWrapper(
+      TopoPtr t, std::shared_ptr<const TopologyReplicas> replicas) noexcept
+      : WrapperBase(std::move(t)), replicas_(std::move(replicas)) {
+    KATANA_LOG_DEBUG_ASSERT(replicas_);
+  }
+
+  using WrapperBase::OutEdges;
+
+  edges_range OutEdges(const Node& node) const noexcept {
+    const Edge* adj_indices = replicas_->Local().adj_indices;
+    return MakeStandardRange<edge_iterator>(
+        node > 0 ? adj_indices[node - 1] : 0, adj_indices[node]);
+  }
+
+  Node OutEdgeDst(const Edge& eid) const noexcept {
+    return replicas_->Local().dests[eid];
+  }
+
+  StandardRange<const Node*> OutEdgeDsts(const Node& node) const noexcept {
+    const TopologyReplicas::Replica& local = replicas_->Local();
+    Edge begin = node > 0 ? local.adj_indices[node - 1] : 0;
+    return MakeStandardRange(
+        local.dests + begin, local.dests + local.adj_indices[node]);
+  }
+
+  size_t OutDegree(const Node& node) const noexcept {
+    return OutEdges(node).size();
+  }
+
+private:
+  std::shared_ptr<const TopologyReplicas> replicas_;
+};
+
 class KATANA_EXPORT EdgeTypeAwareBiDirTopology
     : public BasicBiDirTopoWrapper<
           EdgeTypeAwareTopology, EdgeTypeAwareTopology> {
@@ -1201,6 +2235,24 @@ public:
     return Base::in().OutEdges(N, edge_type);
   }
 
+  using Base::OutEdgeDsts;
+
+  /// Gets the destinations of the out-edges of N with type edge_type as one
+  /// contiguous array. The edges of a type are sorted by destination, so
+  /// this is a sorted set, as OutEdgeDsts(node) is in views with edges sorted
+  /// by destination.
+  StandardRange<const Node*> OutEdgeDsts(
+      Node N, const EntityTypeID& edge_type) const noexcept {
+    return TypedEdgeEnds(Base::out(), N, edge_type);
+  }
+
+  /// Gets the sources of the in-edges of N with type edge_type as one
+  /// contiguous sorted array, as OutEdgeDsts(N, edge_type) does
+  StandardRange<const Node*> InEdgeSrcs(
+      Node N, const EntityTypeID& edge_type) const noexcept {
+    return TypedEdgeEnds(Base::in(), N, edge_type);
+  }
+
   auto OutDegree(Node N, const EntityTypeID& edge_type) const noexcept {
     return Base::out().OutDegree(N, edge_type);
   }
@@ -1341,6 +2393,24 @@ public:
       return Base::in().HasEdge(dst, src);
     }
   }
+
+  /// Check many (src, dst) pairs at once; see EdgeTypeAwareTopology::HasEdges
+  ///
+  /// @param queries the (src, dst) pairs to look up
+  /// @returns a bitset whose bit i is set iff queries[i] is an edge
+  DynamicBitset HasEdges(
+      const std::vector<std::pair<Node, Node>>& queries) const noexcept {
+    return Base::out().HasEdges(queries);
+  }
+
+private:
+  static StandardRange<const Node*> TypedEdgeEnds(
+      const EdgeTypeAwareTopology& topo, Node N,
+      const EntityTypeID& edge_type) noexcept {
+    auto edges = topo.OutEdges(N, edge_type);
+    const Node* dests = topo.DestData();
+    return MakeStandardRange(dests + *edges.begin(), dests + *edges.end());
+  }
 };
 
 template <typename Graph>
@@ -1383,13 +2453,13 @@ class BasicPropGraphViewWrapper : public Topo {
 
 public:
   explicit BasicPropGraphViewWrapper(
-      PropertyGraph* pg, const Topo& topo) noexcept
+      const PropertyGraph* pg, const Topo& topo) noexcept
       : Base(topo), prop_graph_(pg) {}
 
   const PropertyGraph* property_graph() const noexcept { return prop_graph_; }
 
 private:
-  PropertyGraph* prop_graph_;
+  const PropertyGraph* prop_graph_;
 };
 
 namespace internal {
@@ -1411,6 +2481,24 @@ struct PGViewBuilder<PGViewDefault> {
   }
 };
 
+// Edge sources (COO) view
+
+using PGViewEdgeSources = BasicPropGraphViewWrapper<EdgeSourcesTopologyWrapper>;
+
+template <>
+struct PGViewBuilder<PGViewEdgeSources> {
+  template <typename ViewCache>
+  static PGViewEdgeSources BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto edge_srcs = viewCache.BuildOrGetEdgeSources();
+
+    return PGViewEdgeSources{
+        pg,
+        EdgeSourcesTopologyWrapper{
+            viewCache.GetDefaultTopology(), std::move(edge_srcs)}};
+  }
+};
+
 // Transposed view
 
 using TransposedTopology = BasicTopologyWrapper<EdgeShuffleTopology>;
@@ -1450,6 +2538,40 @@ struct PGViewBuilder<PGViewEdgesSortedByDestID> {
   }
 };
 
+// Compressed view, edges sorted by destination
+
+using PGViewCompressed = BasicPropGraphViewWrapper<CompressedTopologyWrapper>;
+
+template <>
+struct PGViewBuilder<PGViewCompressed> {
+  template <typename ViewCache>
+  static PGViewCompressed BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto compressed_topo =
+        viewCache.BuildOrGetCompressedTopo(pg, RDGTopology::TransposeKind::kNo);
+
+    return PGViewCompressed{pg, CompressedTopologyWrapper{compressed_topo}};
+  }
+};
+
+// Projected view, nodes and edges of some types
+
+using PGViewProjected = BasicPropGraphViewWrapper<ProjectedTopologyWrapper>;
+
+template <>
+struct PGViewBuilder<PGViewProjected> {
+  template <typename ViewCache>
+  static PGViewProjected BuildView(
+      const PropertyGraph* pg, const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types,
+      ViewCache& viewCache) noexcept {
+    auto projected_topo =
+        viewCache.BuildProjectedTopo(pg, node_types, edge_types);
+
+    return PGViewProjected{pg, ProjectedTopologyWrapper{projected_topo}};
+  }
+};
+
 // Nodes sorted by degree, edges sorted by destination view
 
 using NodesSortedByDegreeEdgesSortedByDestIDTopology =
@@ -1472,6 +2594,126 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   }
 };
 
+// Views that read out-edges from a copy of the topology on the socket of the
+// calling thread
+
+using ReplicatedDefaultTopology = ReplicatedTopologyWrapper<DefaultPGTopology>;
+using PGViewReplicatedDefault =
+    BasicPropGraphViewWrapper<ReplicatedDefaultTopology>;
+
+template <>
+struct PGViewBuilder<PGViewReplicatedDefault> {
+  template <typename ViewCache>
+  static PGViewReplicatedDefault BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto topo = viewCache.GetDefaultTopology();
+    auto replicas = viewCache.BuildOrGetReplicas(topo);
+
+    return PGViewReplicatedDefault{
+        pg, ReplicatedDefaultTopology{topo, std::move(replicas)}};
+  }
+};
+
+using ReplicatedTransposedTopology =
+    ReplicatedTopologyWrapper<TransposedTopology>;
+using PGViewReplicatedTransposed =
+    BasicPropGraphViewWrapper<ReplicatedTransposedTopology>;
+
+template <>
+struct PGViewBuilder<PGViewReplicatedTransposed> {
+  template <typename ViewCache>
+  static PGViewReplicatedTransposed BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto transposed_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, RDGTopology::TransposeKind::kYes, RDGTopology::EdgeSortKind::kAny);
+    auto replicas = viewCache.BuildOrGetReplicas(transposed_topo);
+
+    return PGViewReplicatedTransposed{
+        pg, ReplicatedTransposedTopology{
+                transposed_topo, std::move(replicas)}};
+  }
+};
+
+using ReplicatedNodesSortedByDegreeEdgesSortedByDestIDTopology =
+    ReplicatedTopologyWrapper<NodesSortedByDegreeEdgesSortedByDestIDTopology>;
+using PGViewReplicatedNodesSortedByDegreeEdgesSortedByDestID =
+    BasicPropGraphViewWrapper<
+        ReplicatedNodesSortedByDegreeEdgesSortedByDestIDTopology>;
+
+template <>
+struct PGViewBuilder<PGViewReplicatedNodesSortedByDegreeEdgesSortedByDestID> {
+  template <typename ViewCache>
+  static PGViewReplicatedNodesSortedByDegreeEdgesSortedByDestID BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo,
+        RDGTopology::NodeSortKind::kSortedByDegree,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+    auto replicas = viewCache.BuildOrGetReplicas(sorted_topo);
+
+    return PGViewReplicatedNodesSortedByDegreeEdgesSortedByDestID{
+        pg, ReplicatedNodesSortedByDegreeEdgesSortedByDestIDTopology{
+                sorted_topo, std::move(replicas)}};
+  }
+};
+
+// Nodes relabeled for locality, edges sorted by destination views. The node
+// order is a template parameter so that views of different orders are
+// different types.
+
+template <RDGTopology::NodeSortKind kNodeSort>
+class NodesOrderedEdgesSortedByDestIDTopology
+    : public SortedTopologyWrapper<ShuffleTopology> {
+  using Base = SortedTopologyWrapper<ShuffleTopology>;
+
+public:
+  explicit NodesOrderedEdgesSortedByDestIDTopology(
+      std::shared_ptr<const ShuffleTopology> t) noexcept
+      : Base(std::move(t)) {
+    KATANA_LOG_DEBUG_ASSERT(Base::topo().has_nodes_sorted_by(kNodeSort));
+  }
+};
+
+template <RDGTopology::NodeSortKind kNodeSort>
+using PGViewNodesOrderedEdgesSortedByDestID = BasicPropGraphViewWrapper<
+    NodesOrderedEdgesSortedByDestIDTopology<kNodeSort>>;
+
+template <RDGTopology::NodeSortKind kNodeSort>
+struct PGViewBuilder<PGViewNodesOrderedEdgesSortedByDestID<kNodeSort>> {
+  template <typename ViewCache>
+  static PGViewNodesOrderedEdgesSortedByDestID<kNodeSort> BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo, kNodeSort,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+
+    return PGViewNodesOrderedEdgesSortedByDestID<kNodeSort>{
+        pg, NodesOrderedEdgesSortedByDestIDTopology<kNodeSort>{sorted_topo}};
+  }
+};
+
+// Views with the edges of every node sorted by a timestamp property. They
+// are built with PropertyGraph::BuildView(timestamp_property), which fails
+// if the property is missing or not a timestamp.
+
+template <RDGTopology::TransposeKind kTranspose>
+using PGViewTemporal =
+    BasicPropGraphViewWrapper<TemporalTopologyWrapper<kTranspose>>;
+
+template <RDGTopology::TransposeKind kTranspose>
+struct PGViewBuilder<PGViewTemporal<kTranspose>> {
+  template <typename ViewCache>
+  static Result<PGViewTemporal<kTranspose>> BuildView(
+      PropertyGraph* pg, const std::string& timestamp_property,
+      ViewCache& viewCache) {
+    auto temporal_topo = KATANA_CHECKED(
+        viewCache.BuildOrGetTemporalTopo(pg, timestamp_property, kTranspose));
+
+    return PGViewTemporal<kTranspose>{
+        pg, TemporalTopologyWrapper<kTranspose>{temporal_topo}};
+  }
+};
+
 // Bidirectional view
 
 using SimpleBiDirTopology =
@@ -1535,39 +2777,115 @@ struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
   }
 };
 
+// Edge type aware bidirectional view whose topologies also have the
+// destination index of EdgeTypeAwareTopology::BuildDestIndex()
+
+class EdgeTypeAwareBiDirDestIndexedTopology
+    : public EdgeTypeAwareBiDirTopology {
+public:
+  using EdgeTypeAwareBiDirTopology::EdgeTypeAwareBiDirTopology;
+};
+
+using PGViewEdgeTypeAwareBiDirDestIndexed =
+    BasicPropGraphViewWrapper<EdgeTypeAwareBiDirDestIndexedTopology>;
+
+template <>
+struct PGViewBuilder<PGViewEdgeTypeAwareBiDirDestIndexed> {
+  template <typename ViewCache>
+  static PGViewEdgeTypeAwareBiDirDestIndexed BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto out_topo = viewCache.BuildOrGetEdgeTypeAwareTopo(
+        pg, RDGTopology::TransposeKind::kNo, /*with_dest_index=*/true);
+    auto in_topo = viewCache.BuildOrGetEdgeTypeAwareTopo(
+        pg, RDGTopology::TransposeKind::kYes, /*with_dest_index=*/true);
+
+    viewCache.ReseatDefaultTopo(out_topo);
+
+    return PGViewEdgeTypeAwareBiDirDestIndexed{
+        pg, EdgeTypeAwareBiDirDestIndexedTopology{out_topo, in_topo}};
+  }
+};
+
 }  // end namespace internal
 
 struct PropertyGraphViews {
   using Default = internal::PGViewDefault;
+  /// Default with the source of every edge stored rather than searched
+  using EdgeSources = internal::PGViewEdgeSources;
   using Transposed = internal::PGViewTransposed;
   using BiDirectional = internal::PGViewBiDirectional;
   using Undirected = internal::PGViewUnDirected;
   using EdgesSortedByDestID = internal::PGViewEdgesSortedByDestID;
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
+  /// EdgeTypeAwareBiDir with faster untyped HasEdge(src, dst) at the cost of
+  /// a copy of the edge destinations
+  using EdgeTypeAwareBiDirDestIndexed =
+      internal::PGViewEdgeTypeAwareBiDirDestIndexed;
+  using Compressed = internal::PGViewCompressed;
+  using Projected = internal::PGViewProjected;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
+  /// Views that read out-edges from a copy of the topology on the socket of
+  /// each thread (see TopologyReplicas), for loops that read the topology at
+  /// random on machines with several sockets
+  using ReplicatedDefault = internal::PGViewReplicatedDefault;
+  using ReplicatedTransposed = internal::PGViewReplicatedTransposed;
+  using ReplicatedNodesSortedByDegreeEdgesSortedByDestID =
+      internal::PGViewReplicatedNodesSortedByDegreeEdgesSortedByDestID;
+  /// Views with nodes relabeled for locality; node properties are reached
+  /// through GetNodePropertyIndex like for the other shuffled views
+  using NodesSortedByBFSEdgesSortedByDestID =
+      internal::PGViewNodesOrderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kSortedByBFS>;
+  using NodesSortedByRCMEdgesSortedByDestID =
+      internal::PGViewNodesOrderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kSortedByRCM>;
+  /// Views with OutEdges(node, begin, end) for the edges of a time window;
+  /// see TemporalTopology
+  using Temporal = internal::PGViewTemporal<RDGTopology::TransposeKind::kNo>;
+  using TransposedTemporal =
+      internal::PGViewTemporal<RDGTopology::TransposeKind::kYes>;
 };
 
 class KATANA_EXPORT PGViewCache {
-  std::shared_ptr<GraphTopology> original_topo_{
+public:
+  using DefaultTopologyLoader = std::function<Result<GraphTopology>()>;
+
+private:
+  // mutable so that a deferred default topology can be loaded by const
+  // accessors; see DeferDefaultTopology
+  mutable std::shared_ptr<GraphTopology> original_topo_{
       std::make_shared<GraphTopology>()};
+  mutable DefaultTopologyLoader default_topo_loader_;
+  mutable std::atomic<bool> default_topo_deferred_{false};
+  mutable std::mutex default_topo_mutex_;
+  uint64_t deferred_num_nodes_{0};
+  uint64_t deferred_num_edges_{0};
 
   std::vector<std::shared_ptr<EdgeShuffleTopology>> edge_shuff_topos_;
   std::vector<std::shared_ptr<ShuffleTopology>> fully_shuff_topos_;
   std::vector<std::shared_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
+  std::vector<std::shared_ptr<CompressedGraphTopology>> compressed_topos_;
   std::shared_ptr<CondensedTypeIDMap> edge_type_id_map_;
   // TODO(amber): define a node_type_id_map_;
+  std::unordered_map<EntityTypeID, std::shared_ptr<const DynamicBitset>>
+      node_type_bitmaps_;
+  std::shared_ptr<GraphTopology::EdgeDestVec> edge_srcs_;
+  std::vector<std::shared_ptr<TopologyReplicas>> replicas_;
+  std::vector<std::shared_ptr<TemporalTopology>> temporal_topos_;
 
   template <typename>
   friend struct internal::PGViewBuilder;
+  friend class TopologyManager;
 
 public:
-  PGViewCache() = default;
-  PGViewCache(GraphTopology&& original_topo)
-      : original_topo_(
-            std::make_shared<GraphTopology>(std::move(original_topo))) {}
-  PGViewCache(PGViewCache&&) = default;
-  PGViewCache& operator=(PGViewCache&&) = default;
+  /// Cached derived topologies are accounted as standby memory with the
+  /// TopologyManager, which may evict them when memory gets tight
+  PGViewCache();
+  PGViewCache(GraphTopology&& original_topo);
+  PGViewCache(PGViewCache&& other) noexcept;
+  PGViewCache& operator=(PGViewCache&& other) noexcept;
+  ~PGViewCache();
 
   PGViewCache(const PGViewCache&) = delete;
   PGViewCache& operator=(const PGViewCache&) = delete;
@@ -1587,21 +2905,93 @@ public:
         pg, node_types, edge_types, *this);
   }
 
+  template <typename PGView>
+  Result<PGView> BuildView(
+      PropertyGraph* pg, const std::string& timestamp_property) {
+    return internal::PGViewBuilder<PGView>::BuildView(
+        pg, timestamp_property, *this);
+  }
+
   // Avoids a copy of the default topology.
   const GraphTopology& GetDefaultTopologyRef() const noexcept;
 
+  /// Makes \p loader the source of the default topology, which has
+  /// \p num_nodes nodes and \p num_edges edges. It is called the first time
+  /// the default topology or a view of it is needed, so graphs that are only
+  /// used for their properties never load their topology. Accessors cannot
+  /// fail, so an error of \p loader there is fatal; call
+  /// LoadDefaultTopology first to handle it instead.
+  void DeferDefaultTopology(
+      uint64_t num_nodes, uint64_t num_edges,
+      DefaultTopologyLoader loader) noexcept;
+
+  /// Loads a deferred default topology if it is not loaded yet
+  Result<void> LoadDefaultTopology() const;
+
+  bool IsDefaultTopologyLoaded() const noexcept {
+    return !default_topo_deferred_.load(std::memory_order_acquire);
+  }
+
+  /// The number of nodes of the default topology, without loading it
+  uint64_t NumDefaultNodes() const noexcept;
+  /// The number of edges of the default topology, without loading it
+  uint64_t NumDefaultEdges() const noexcept;
+
   // Purge cache and construct an empty topology as the default one.
   void DropAllTopologies() noexcept;
 
+  /// Returns the set of nodes of \p pg that have type \p type, which need
+  /// not be the most specific type of a node. The set is built on first use,
+  /// so later filters by \p type are word-parallel scans of a bitmap instead
+  /// of type lookups per node.
+  std::shared_ptr<const DynamicBitset> BuildOrGetNodeTypeBitmap(
+      const PropertyGraph* pg, EntityTypeID type) noexcept;
+
+  /// Drops the bitmaps of BuildOrGetNodeTypeBitmap, to be called when the
+  /// node types change.
+  void DropNodeTypeBitmaps() noexcept { node_type_bitmaps_.clear(); }
+
+  /// Projects the default topology onto the nodes with one of \p node_types
+  /// and the edges between them with one of \p edge_types. An empty list
+  /// selects all types and names that are not types select nothing. See
+  /// ProjectedTopology for \p compact_below.
+  ///
+  /// Projections share the default topology and are not cached, since
+  /// there are as many of them as combinations of types.
+  std::shared_ptr<ProjectedTopology> BuildProjectedTopo(
+      const PropertyGraph* pg, const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types,
+      double compact_below = ProjectedTopology::kDefaultCompactBelow) noexcept;
+
 private:
   std::shared_ptr<GraphTopology> GetDefaultTopology() const noexcept;
 
+  /// Appends \p topo to \p topos and registers it with the TopologyManager
+  template <typename Topo>
+  std::shared_ptr<Topo> AddToCache(
+      std::vector<std::shared_ptr<Topo>>* topos,
+      std::shared_ptr<Topo>&& topo) noexcept;
+
+  /// Called by the TopologyManager to drop \p topo from this cache. Returns
+  /// false if \p topo is still referenced outside of this cache.
+  bool EvictTopology(const void* topo) noexcept;
+
   // Reseat the default topology pointer to a more constrained one.
   bool ReseatDefaultTopo(const std::shared_ptr<GraphTopology>& other) noexcept;
 
   std::shared_ptr<CondensedTypeIDMap> BuildOrGetEdgeTypeIndex(
       const PropertyGraph* pg) noexcept;
 
+  /// The source of every edge of the default topology, indexed by edge. It
+  /// only depends on the adjacency indices, so it stays valid when the
+  /// default topology is reseated to one with its edges sorted.
+  std::shared_ptr<const GraphTopology::EdgeDestVec>
+  BuildOrGetEdgeSources() noexcept;
+
+  /// Per socket copies of \p topo, which is one of the cached topologies
+  std::shared_ptr<const TopologyReplicas> BuildOrGetReplicas(
+      const std::shared_ptr<const GraphTopology>& topo) noexcept;
+
   // The pop flag ensures that the returned topology is not
   // in the edge_shuff_topos_ cache.
   std::shared_ptr<EdgeShuffleTopology> BuildOrGetEdgeShuffTopoImpl(
@@ -1621,8 +3011,21 @@ private:
       const RDGTopology::NodeSortKind& node_sort_todo,
       const RDGTopology::EdgeSortKind& edge_sort_todo) noexcept;
 
+  /// \p with_dest_index asks for a topology with
+  /// EdgeTypeAwareTopology::BuildDestIndex(); a cached topology without it
+  /// gets the index added in place, which leaves the views using it intact
   std::shared_ptr<EdgeTypeAwareTopology> BuildOrGetEdgeTypeAwareTopo(
+      PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_kind,
+      bool with_dest_index = false) noexcept;
+
+  std::shared_ptr<CompressedGraphTopology> BuildOrGetCompressedTopo(
       PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_kind) noexcept;
+
+  /// Rebuilt when the timestamp property has been replaced since it was
+  /// cached
+  Result<std::shared_ptr<TemporalTopology>> BuildOrGetTemporalTopo(
+      PropertyGraph* pg, const std::string& timestamp_property,
+      const RDGTopology::TransposeKind& tpose_kind);
 };
 
 /// Creates a uniform-random CSR GraphTopology instance, where each node as
@@ -1638,6 +3041,8 @@ KATANA_EXPORT GraphTopology CreateUniformRandomTopology(
 /// AddNodes(10); // creates 10 nodes (0..9) with no edges
 /// AddEdge(0, 3); // creates an edge between nodes 0 and 3.
 /// Once done adding edges, call ConvertToCSR() to obtain a GraphTopology instance
+/// For large graphs or edges added from parallel loops, see
+/// ConcurrentTopologyBuilderImpl in ConcurrentTopologyBuilder.h.
 template <bool IS_SYMMETRIC = false, bool ALLOW_MULTI_EDGE = false>
 class KATANA_EXPORT TopologyBuilderImpl : public GraphTopologyTypes {
   using AdjVec = std::vector<Node>;
@@ -20,14 +20,48 @@
 #ifndef KATANA_LIBGRAPH_KATANA_HYPERGRAPH_H_
 #define KATANA_LIBGRAPH_KATANA_HYPERGRAPH_H_
 
+#include <utility>
+
 #include "katana/DynamicBitset.h"
 #include "katana/LC_CSR_Graph.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
 
 namespace katana {
+
+/// A hypergraph in CSR form. Hyperedges and nodes are both nodes of the
+/// graph: the first GetHedges() nodes are the hyperedges, whose edges are
+/// their pins, and the GetHnodes() nodes after them are the nodes of the
+/// hypergraph, which have no edges.
 template <typename NodeTy, bool HasNoLockable = true, bool UseNumaAlloc = true>
 class HyperGraph
     : public katana::LC_CSR_Graph<NodeTy, void, HasNoLockable, UseNumaAlloc> {
+  using Base = katana::LC_CSR_Graph<NodeTy, void, HasNoLockable, UseNumaAlloc>;
+
 public:
+  /// Constructs the hypergraph from its CSR arrays, which are used in place.
+  /// \p prefix_sum holds the end of the pins of each hyperedge and node, so
+  /// the entries of nodes repeat the end of the last hyperedge, and \p pins
+  /// holds the node of each pin. Building these arrays directly avoids a
+  /// list of pins per hyperedge, which takes several times their size.
+  void ConstructFrom(
+      uint32_t num_hedges, uint32_t num_hnodes,
+      NUMAArray<uint64_t>&& prefix_sum, NUMAArray<uint32_t>&& pins) {
+    uint32_t num_nodes = num_hedges + num_hnodes;
+    KATANA_LOG_DEBUG_ASSERT(prefix_sum.size() == num_nodes);
+    KATANA_LOG_DEBUG_ASSERT(
+        num_nodes == 0 || prefix_sum[num_nodes - 1] == pins.size());
+    // Allocates node data for the arrays to go with
+    Base::allocateFrom(num_nodes, 0);
+    this->numEdges = pins.size();
+    this->edgeIndData = std::move(prefix_sum);
+    this->edgeDst = std::move(pins);
+    Base::constructNodes();
+    Base::initializeLocalRanges();
+    SetHedges(num_hedges);
+    SetHnodes(num_hnodes);
+  }
+
   uint32_t GetHedges() const { return hedges_; }
   void SetHedges(uint32_t hedges) { hedges_ = hedges; }
 
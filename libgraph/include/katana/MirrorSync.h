@@ -0,0 +1,195 @@
+#ifndef KATANA_LIBGRAPH_KATANA_MIRRORSYNC_H_
+#define KATANA_LIBGRAPH_KATANA_MIRRORSYNC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/CommBackend.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Keeps the copies of a node field consistent across the hosts of a
+/// partitioned graph.
+///
+/// Each node is owned by one host, where its copy is the master; other
+/// hosts that have edges to it hold a mirror. Algorithms update whichever
+/// copies they touch and mark them in a dirty bitset, then call Reduce to
+/// fold the updated mirrors into their masters and Broadcast to send updated
+/// masters back out to their mirrors. Only dirty nodes are sent.
+///
+/// The node lists come from the partition metadata of an RDG (see
+/// RDGSlice::master_nodes and RDGSlice::mirror_nodes): masters[h] lists the
+/// local nodes owned here that host h mirrors, and mirrors[h] the local
+/// mirrors of nodes owned by host h, in the same order as host h lists them
+/// in its masters[rank].
+class KATANA_EXPORT MirrorSync {
+public:
+  MirrorSync(
+      CommBackend* comm, std::vector<std::vector<uint32_t>> masters,
+      std::vector<std::vector<uint32_t>> mirrors);
+
+  /// Build from the master and mirror arrays of the partition metadata,
+  /// which hold one array of local node ids per host
+  static katana::Result<MirrorSync> Make(
+      CommBackend* comm,
+      const std::vector<std::shared_ptr<arrow::ChunkedArray>>& master_nodes,
+      const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes);
+
+  /// Send every dirty mirror to its master, where reduce(master, mirror)
+  /// becomes the new master value. Sent mirrors are no longer dirty and
+  /// masters that received a value are. Reductions like sums, where folding
+  /// a value in twice is wrong, should reset mirrors after calling this.
+  template <typename T, typename ReduceFn>
+  katana::Result<void> Reduce(
+      T* values, DynamicBitset* dirty, ReduceFn reduce);
+
+  /// Send every dirty master to its mirrors, which take its value and become
+  /// dirty, so that afterwards dirty marks every copy that changed
+  template <typename T>
+  katana::Result<void> Broadcast(T* values, DynamicBitset* dirty);
+
+  /// Combine one value across all hosts, e.g., to decide whether any host
+  /// has work left
+  template <typename T, typename ReduceFn>
+  katana::Result<T> AllReduce(T value, ReduceFn reduce);
+
+  uint64_t num_masters() const;
+  uint64_t num_mirrors() const;
+
+private:
+  /// Send the values of the dirty nodes in send_lists[h] to each host h;
+  /// receivers call apply(node, value) for the matching node of their
+  /// recv_lists[h]. Sent nodes are reset in dirty if clear_sent is true.
+  template <typename T, typename ApplyFn>
+  katana::Result<void> Exchange(
+      const std::vector<std::vector<uint32_t>>& send_lists,
+      const std::vector<std::vector<uint32_t>>& recv_lists, const T* values,
+      DynamicBitset* dirty, bool clear_sent, ApplyFn apply);
+
+  CommBackend* comm_;
+  std::vector<std::vector<uint32_t>> masters_;
+  std::vector<std::vector<uint32_t>> mirrors_;
+};
+
+template <typename T, typename ApplyFn>
+katana::Result<void>
+MirrorSync::Exchange(
+    const std::vector<std::vector<uint32_t>>& send_lists,
+    const std::vector<std::vector<uint32_t>>& recv_lists, const T* values,
+    DynamicBitset* dirty, bool clear_sent, ApplyFn apply) {
+  static_assert(
+      std::is_trivially_copyable_v<T>, "synchronized values are sent as bytes");
+  constexpr size_t kEntrySize = sizeof(uint32_t) + sizeof(T);
+
+  // each message is a sequence of (position in the node list, value)
+  std::vector<std::string> sends(comm_->num());
+  for (size_t host = 0; host < send_lists.size(); ++host) {
+    const auto& nodes = send_lists[host];
+    std::string& msg = sends[host];
+    for (uint32_t pos = 0; pos < nodes.size(); ++pos) {
+      uint32_t node = nodes[pos];
+      if (!dirty->test(node)) {
+        continue;
+      }
+      size_t off = msg.size();
+      msg.resize(off + kEntrySize);
+      std::memcpy(msg.data() + off, &pos, sizeof(pos));
+      std::memcpy(msg.data() + off + sizeof(pos), &values[node], sizeof(T));
+    }
+  }
+  if (clear_sent) {
+    for (const auto& nodes : send_lists) {
+      for (uint32_t node : nodes) {
+        dirty->reset(node);
+      }
+    }
+  }
+
+  auto recvs = KATANA_CHECKED(comm_->AllToAll(std::move(sends)));
+
+  for (size_t host = 0; host < recvs.size(); ++host) {
+    const std::string& msg = recvs[host];
+    if (msg.empty()) {
+      continue;
+    }
+    if (host >= recv_lists.size() || msg.size() % kEntrySize != 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "malformed update from host {}", host);
+    }
+    const auto& nodes = recv_lists[host];
+    for (size_t off = 0; off < msg.size(); off += kEntrySize) {
+      uint32_t pos;
+      T value;
+      std::memcpy(&pos, msg.data() + off, sizeof(pos));
+      std::memcpy(&value, msg.data() + off + sizeof(pos), sizeof(T));
+      if (pos >= nodes.size()) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "host {} updated node {} of {}; are the node lists consistent?",
+            host, pos, nodes.size());
+      }
+      apply(nodes[pos], value);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename T, typename ReduceFn>
+katana::Result<void>
+MirrorSync::Reduce(T* values, DynamicBitset* dirty, ReduceFn reduce) {
+  return Exchange<T>(
+      mirrors_, masters_, values, dirty, true,
+      [values, dirty, &reduce](uint32_t node, const T& value) {
+        values[node] = reduce(values[node], value);
+        dirty->set(node);
+      });
+}
+
+template <typename T>
+katana::Result<void>
+MirrorSync::Broadcast(T* values, DynamicBitset* dirty) {
+  return Exchange<T>(
+      masters_, mirrors_, values, dirty, false,
+      [values, dirty](uint32_t node, const T& value) {
+        values[node] = value;
+        dirty->set(node);
+      });
+}
+
+template <typename T, typename ReduceFn>
+katana::Result<T>
+MirrorSync::AllReduce(T value, ReduceFn reduce) {
+  static_assert(
+      std::is_trivially_copyable_v<T>, "reduced values are sent as bytes");
+  std::string msg(sizeof(T), '\0');
+  std::memcpy(msg.data(), &value, sizeof(T));
+  auto recvs = KATANA_CHECKED(
+      comm_->AllToAll(std::vector<std::string>(comm_->num(), msg)));
+
+  // every host folds in the same order so all get the same result
+  T result{};
+  for (size_t host = 0; host < recvs.size(); ++host) {
+    if (recvs[host].size() != sizeof(T)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "malformed value from host {}", host);
+    }
+    T other;
+    std::memcpy(&other, recvs[host].data(), sizeof(T));
+    result = host == 0 ? other : reduce(result, other);
+  }
+  return result;
+}
+
+}  // namespace katana
+
+#endif
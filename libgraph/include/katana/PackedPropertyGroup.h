@@ -0,0 +1,118 @@
+#ifndef KATANA_LIBGRAPH_KATANA_PACKEDPROPERTYGROUP_H_
+#define KATANA_LIBGRAPH_KATANA_PACKEDPROPERTYGROUP_H_
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Properties.h"
+#include "katana/Traits.h"
+
+namespace katana {
+
+/// A row-wise copy of some POD node properties of a typed graph.
+///
+/// TypedPropertyGraph keeps each property in an array of its own, so a loop
+/// that reads several properties of a node, or one property of many
+/// neighbors next to others, touches a cache line per property. Gathering
+/// the properties of a hot loop into rows of a single array makes that one
+/// line per node. Rows are aligned to the smallest power of two that holds
+/// them, up to a cache line, so that small rows never straddle two lines.
+///
+/// The group is a copy: loops read and update the rows, and Scatter writes
+/// them back to the graph once they are done. Rows are indexed by node, not
+/// by property index.
+///
+///   using Packed = PackedPropertyGroup<CurrentCommunityID, NodeWeight>;
+///   auto packed = Packed::Gather(graph);
+///   ... packed.Get<CurrentCommunityID>(n) ...
+///   packed.Scatter<CurrentCommunityID>(&graph);
+template <typename... Props>
+class PackedPropertyGroup {
+  static_assert(sizeof...(Props) > 0, "a group needs at least one property");
+  static_assert(
+      (std::is_trivially_copyable_v<PropertyValueType<Props>> && ...),
+      "only POD properties can be packed");
+
+  using PropTuple = std::tuple<Props...>;
+  using Values = std::tuple<PropertyValueType<Props>...>;
+
+  static constexpr size_t RowAlignment() {
+    size_t align = alignof(Values);
+    while (align < sizeof(Values) &&
+           align < static_cast<size_t>(KATANA_CACHE_LINE_SIZE)) {
+      align *= 2;
+    }
+    return align;
+  }
+
+public:
+  struct alignas(RowAlignment()) Row {
+    Values values;
+  };
+
+  PackedPropertyGroup() = default;
+  PackedPropertyGroup(PackedPropertyGroup&&) = default;
+  PackedPropertyGroup& operator=(PackedPropertyGroup&&) = default;
+
+  PackedPropertyGroup(const PackedPropertyGroup&) = delete;
+  PackedPropertyGroup& operator=(const PackedPropertyGroup&) = delete;
+
+  /// Copies the properties of every node of \p graph into rows
+  template <typename Graph>
+  static PackedPropertyGroup Gather(const Graph& graph) {
+    PackedPropertyGroup group;
+    group.rows_.allocateInterleaved(graph.NumNodes());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename Graph::Node n) {
+          group.rows_[n].values = Values{graph.template GetData<Props>(n)...};
+        },
+        katana::no_stats(), katana::loopname("GatherPackedProperties"));
+    return group;
+  }
+
+  /// Writes the rows back to \p graph: all properties, or only those in
+  /// Subset if it is given
+  template <typename... Subset, typename Graph>
+  void Scatter(Graph* graph) const {
+    KATANA_LOG_DEBUG_ASSERT(graph->NumNodes() == size());
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](typename Graph::Node n) {
+          if constexpr (sizeof...(Subset) == 0) {
+            ((graph->template GetData<Props>(n) = Get<Props>(n)), ...);
+          } else {
+            ((graph->template GetData<Subset>(n) = Get<Subset>(n)), ...);
+          }
+        },
+        katana::no_stats(), katana::loopname("ScatterPackedProperties"));
+  }
+
+  template <typename Prop>
+  PropertyValueType<Prop>& Get(size_t node) {
+    KATANA_LOG_DEBUG_ASSERT(node < size());
+    return std::get<find_trait<Prop, PropTuple>()>(rows_[node].values);
+  }
+
+  template <typename Prop>
+  const PropertyValueType<Prop>& Get(size_t node) const {
+    KATANA_LOG_DEBUG_ASSERT(node < size());
+    return std::get<find_trait<Prop, PropTuple>()>(rows_[node].values);
+  }
+
+  size_t size() const { return rows_.size(); }
+
+  const Row* data() const { return rows_.data(); }
+
+private:
+  NUMAArray<Row> rows_;
+};
+
+}  // namespace katana
+
+#endif
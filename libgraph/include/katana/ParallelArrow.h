@@ -0,0 +1,51 @@
+#ifndef KATANA_LIBGRAPH_KATANA_PARALLELARROW_H_
+#define KATANA_LIBGRAPH_KATANA_PARALLELARROW_H_
+
+#include <memory>
+
+#include <arrow/api.h>
+
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+/// Versions of arrow's Concatenate and Take that split their copies over the
+/// katana thread pool, and helpers that bring columns into the single chunk
+/// form PropertyGraph properties have.
+///
+/// Fixed width types whose values are whole bytes are copied in parallel
+/// over blocks of rows; other types fall back to arrow's serial kernels.
+///
+/// \file
+
+namespace katana {
+
+/// Whether the values of \p type are fixed width and whole bytes, e.g.,
+/// integers, floats and fixed size binaries but not booleans or
+/// dictionaries. The parallel kernels below apply to such types.
+KATANA_EXPORT bool IsFixedByteWidth(const arrow::DataType& type);
+
+/// Concatenate \p chunks, which must all have the same type, into a new
+/// array.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> ParallelConcatenate(
+    const arrow::ArrayVector& chunks);
+
+/// \returns the only chunk of \p column without copying it, an empty array
+/// if there are no chunks, and the concatenation of the chunks otherwise
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> Unchunk(
+    const std::shared_ptr<arrow::ChunkedArray>& column);
+
+/// \returns \p table if all of its columns have a single chunk, and a table
+/// whose columns are unchunked as by Unchunk otherwise
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> UnchunkTable(
+    const std::shared_ptr<arrow::Table>& table);
+
+/// Gather the rows at \p indices of \p column into a new single chunk
+/// column. Every index must be less than the length of the column.
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> ParallelTake(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const NUMAArray<uint64_t>& indices);
+
+}  // namespace katana
+
+#endif
@@ -2,6 +2,8 @@
 #define KATANA_LIBGRAPH_KATANA_PROPERTIES_H_
 
 #include <cassert>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
 
@@ -494,6 +496,91 @@ private:
   const ArrowArrayType& array_;
 };
 
+/// DictionaryPropertyReadOnlyView provides a read-only property view over
+/// dictionary encoded arrow::Arrays of strings, i.e., arrow::DictionaryArrays
+/// whose dictionary is an arrow::StringArray or arrow::LargeStringArray.
+///
+/// Its values are the integer codes of the strings, so algorithms compare
+/// and hash integers instead of strings. Equal strings have equal codes.
+/// Decode returns the string of a code, e.g., for output.
+///
+/// \tparam IndexT the C type of the codes of the array, e.g., int32_t
+template <typename IndexT>
+class DictionaryPropertyReadOnlyView {
+public:
+  using value_type = IndexT;
+
+  static Result<DictionaryPropertyReadOnlyView> Make(
+      const arrow::DictionaryArray& array) {
+    using IndexArrowType = typename arrow::CTypeTraits<IndexT>::ArrowType;
+    if (array.indices()->type_id() != IndexArrowType::type_id) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "expected {} codes found {}",
+          IndexArrowType::type_name(), array.indices()->type()->ToString());
+    }
+    const auto id = array.dictionary()->type_id();
+    if (id != arrow::Type::STRING && id != arrow::Type::LARGE_STRING) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError,
+          "expected a dictionary of strings found {}",
+          array.dictionary()->type()->ToString());
+    }
+    return DictionaryPropertyReadOnlyView(array);
+  }
+
+  bool IsValid(size_t i) const { return array_.IsValid(i); }
+
+  size_t size() const { return array_.length(); }
+
+  value_type GetValue(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(IsValid(i));
+    return codes_[i];
+  }
+
+  /// \returns the code of row i, or value_type{} if it is null;
+  /// check IsValid to tell the two apart
+  value_type operator[](size_t i) const {
+    if (!IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+  /// The number of distinct codes; every code is less than it
+  size_t num_codes() const { return dictionary_.length(); }
+
+  std::string Decode(value_type code) const {
+    KATANA_LOG_DEBUG_ASSERT(static_cast<size_t>(code) < num_codes());
+    if (dictionary_.type_id() == arrow::Type::STRING) {
+      return static_cast<const arrow::StringArray&>(dictionary_).GetString(
+          code);
+    }
+    return static_cast<const arrow::LargeStringArray&>(dictionary_).GetString(
+        code);
+  }
+
+  /// \returns the code of value, or nullopt if no row has it. This is a
+  /// linear search of the dictionary, so look codes up once, before a loop.
+  std::optional<value_type> Encode(std::string_view value) const {
+    for (size_t code = 0; code < num_codes(); ++code) {
+      if (Decode(code) == value) {
+        return static_cast<value_type>(code);
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  DictionaryPropertyReadOnlyView(const arrow::DictionaryArray& array)
+      : array_(array),
+        dictionary_(*array.dictionary()),
+        codes_(array.indices()->data()->template GetValues<IndexT>(1)) {}
+
+  const arrow::DictionaryArray& array_;
+  const arrow::Array& dictionary_;
+  const IndexT* codes_;
+};
+
 template <typename ArrowT, typename ViewT>
 struct Property {
   using ArrowType = ArrowT;
@@ -558,6 +645,14 @@ struct LargeStringReadOnlyProperty
           arrow::LargeStringType,
           StringPropertyReadOnlyView<arrow::LargeStringArray>> {};
 
+/// A string property that is stored dictionary encoded, viewed as its codes
+///
+/// \tparam IndexT the C type of the codes
+template <typename IndexT = int32_t>
+struct DictionaryStringReadOnlyProperty
+    : public Property<
+          arrow::DictionaryType, DictionaryPropertyReadOnlyView<IndexT>> {};
+
 template <typename T>
 struct StructProperty
     : public Property<arrow::FixedSizeBinaryType, katana::PODPropertyView<T>> {
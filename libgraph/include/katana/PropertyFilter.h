@@ -0,0 +1,65 @@
+#ifndef KATANA_LIBGRAPH_KATANA_PROPERTYFILTER_H_
+#define KATANA_LIBGRAPH_KATANA_PROPERTYFILTER_H_
+
+#include <cstdint>
+
+#include <arrow/compute/exec/expression.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+/// Select the nodes or edges of a graph with an Arrow compute expression
+/// over their properties, e.g.,
+///
+///   namespace cp = arrow::compute;
+///   auto adults = cp::and_(
+///       cp::greater_equal(cp::field_ref("age"), cp::literal(18)),
+///       KATANA_CHECKED(NodeHasType(*pg, person_type)));
+///   DynamicBitset selected = KATANA_CHECKED(FilterNodes(pg, adults));
+///
+/// The expression is evaluated with Arrow's vectorized kernels over blocks
+/// of property rows in parallel. Rows for which it is null count as not
+/// selected, like in SQL.
+///
+/// \file
+
+namespace katana {
+
+/// The field through which a filter expression refers to the entity type id
+/// of a node or edge. Use NodeHasType and EdgeHasType rather than this.
+constexpr const char* kEntityTypeIDField = "katana_entity_type_id";
+
+/// The property rows each task of a filter evaluates the expression on. A
+/// multiple of 64 so that tasks write whole words of the result.
+constexpr int64_t kDefaultFilterBlockRows = int64_t{1} << 16;
+
+/// \returns an expression that selects the nodes of \p pg that have the
+/// type \p type_id, i.e., whose type is \p type_id or one of its subtypes
+KATANA_EXPORT Result<arrow::compute::Expression> NodeHasType(
+    const PropertyGraph& pg, EntityTypeID type_id);
+
+/// \returns an expression that selects the edges of \p pg that have the
+/// type \p type_id. See NodeHasType.
+KATANA_EXPORT Result<arrow::compute::Expression> EdgeHasType(
+    const PropertyGraph& pg, EntityTypeID type_id);
+
+/// \returns the nodes of \p pg that satisfy \p expression, which is a
+/// boolean expression over node properties, referred to by name, and
+/// NodeHasType. The properties it refers to are loaded first.
+KATANA_EXPORT Result<DynamicBitset> FilterNodes(
+    PropertyGraph* pg, const arrow::compute::Expression& expression,
+    int64_t block_rows = kDefaultFilterBlockRows);
+
+/// \returns the edges of \p pg that satisfy \p expression, which is a
+/// boolean expression over edge properties and EdgeHasType. See
+/// FilterNodes.
+KATANA_EXPORT Result<DynamicBitset> FilterEdges(
+    PropertyGraph* pg, const arrow::compute::Expression& expression,
+    int64_t block_rows = kDefaultFilterBlockRows);
+
+}  // namespace katana
+
+#endif
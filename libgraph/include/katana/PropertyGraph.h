@@ -1,7 +1,9 @@
 #ifndef KATANA_LIBGRAPH_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGRAPH_KATANA_PROPERTYGRAPH_H_
 
+#include <future>
 #include <memory>
+#include <shared_mutex>
 #include <utility>
 
 #include <arrow/api.h>
@@ -20,6 +22,7 @@
 #include "katana/Properties.h"
 #include "katana/RDG.h"
 #include "katana/RDGTopology.h"
+#include "katana/ReadGroup.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
@@ -233,6 +236,22 @@ public:
     return pg_view_cache_.BuildView<PGView>(this);
   }
 
+  /// Builds a view of the nodes with one of \p node_types and the edges
+  /// between them with one of \p edge_types; an empty list selects all types
+  template <typename PGView>
+  PGView BuildView(
+      const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) noexcept {
+    return pg_view_cache_.BuildView<PGView>(this, node_types, edge_types);
+  }
+
+  /// Builds a temporal view, e.g., PropertyGraphViews::Temporal, with the
+  /// edges of every node sorted by the edge property \p timestamp_property
+  template <typename PGView>
+  Result<PGView> BuildView(const std::string& timestamp_property) {
+    return pg_view_cache_.BuildView<PGView>(this, timestamp_property);
+  }
+
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
   /// and its underlying resources.
   static Result<std::unique_ptr<PropertyGraph>> Make(
@@ -355,6 +374,16 @@ public:
     return rdg_->WriteRDKSubstructureIndexPrimitive(index);
   }
 
+  Result<std::optional<ReachabilityIndexPrimitive>>
+  LoadReachabilityIndexPrimitive() {
+    return rdg_->LoadReachabilityIndexPrimitive();
+  }
+
+  Result<void> WriteReachabilityIndexPrimitive(
+      ReachabilityIndexPrimitive& index) {
+    return rdg_->WriteReachabilityIndexPrimitive(index);
+  }
+
   const std::string& rdg_dir() const { return rdg_->rdg_dir().string(); }
 
   uint32_t partition_id() const { return rdg_->partition_id(); }
@@ -363,6 +392,18 @@ public:
     return rdg_->part_metadata().policy_id_;
   }
 
+  /// Also write fixed-width properties as raw columns in \p format when this
+  /// graph is written; see RDG::set_raw_column_format
+  void set_raw_column_format(RawColumnFormat format) {
+    rdg_->set_raw_column_format(format);
+  }
+
+  /// Bound the memory held by encoded files while this graph is written; see
+  /// RDG::set_max_outstanding_write_size
+  void set_max_outstanding_write_size(uint64_t size) {
+    rdg_->set_max_outstanding_write_size(size);
+  }
+
   /// \returns the current version of the graph (does not access storage)
   Result<uint64_t> CurrentVersion() {
     if (file_ == nullptr) {
@@ -384,6 +425,15 @@ public:
   /// parts of the original read location of the graph.
   Result<void> Commit(
       const std::string& command_line, katana::TxnContext* txn_ctx);
+
+  /// Like \ref Commit(const std::string&, katana::TxnContext*) but returns
+  /// once the changed state is snapshotted and its writes are started. The
+  /// graph may be changed and committed again right away; the returned future
+  /// is ready when the writes are done, and txn_ctx->Commit() waits for them
+  /// before it publishes the new versions. See katana::RDG::StoreAsync.
+  Result<std::shared_future<CopyableResult<void>>> CommitAsync(
+      const std::string& command_line, katana::TxnContext* txn_ctx);
+
   Result<void> WriteView(
       const std::string& command_line, katana::TxnContext* txn_ctx);
 
@@ -405,21 +455,23 @@ public:
 
   /// get the schema for loaded node properties
   std::shared_ptr<arrow::Schema> loaded_node_schema() const {
-    return rdg_->node_properties()->schema();
+    return LoadedNodeProperties()->schema();
   }
 
   /// get the schema for all node properties (includes unloaded properties)
   std::shared_ptr<arrow::Schema> full_node_schema() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
     return rdg_->full_node_schema();
   }
 
   /// get the schema for loaded edge properties
   std::shared_ptr<arrow::Schema> loaded_edge_schema() const {
-    return rdg_->edge_properties()->schema();
+    return LoadedEdgeProperties()->schema();
   }
 
   /// get the schema for all edge properties (includes unloaded properties)
   std::shared_ptr<arrow::Schema> full_edge_schema() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
     return rdg_->full_edge_schema();
   }
 
@@ -618,18 +670,20 @@ public:
 
   // num_rows() == NumNodes() (all local nodes)
   std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(int i) const {
-    if (i >= rdg_->node_properties()->num_columns()) {
+    std::shared_ptr<arrow::Table> properties = LoadedNodeProperties();
+    if (i >= properties->num_columns()) {
       return nullptr;
     }
-    return rdg_->node_properties()->column(i);
+    return properties->column(i);
   }
 
   // num_rows() == num_edges() (all local edges)
   std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(int i) const {
-    if (i >= rdg_->edge_properties()->num_columns()) {
+    std::shared_ptr<arrow::Table> properties = LoadedEdgeProperties();
+    if (i >= properties->num_columns()) {
       return nullptr;
     }
-    return rdg_->edge_properties()->column(i);
+    return properties->column(i);
   }
 
   /// \returns true if a node property/type with @param name exists
@@ -649,6 +703,13 @@ public:
   Result<std::shared_ptr<arrow::ChunkedArray>> GetNodeProperty(
       const std::string& name) const;
 
+  /// Get a node property by name as of the snapshot of \p txn_ctx. The first
+  /// read of a property adds it to the read set of the transaction; later
+  /// reads return the same column even if another thread upserted the
+  /// property since, until the transaction writes it or commits.
+  Result<std::shared_ptr<arrow::ChunkedArray>> GetNodeProperty(
+      const std::string& name, katana::TxnContext* txn_ctx) const;
+
   Result<URI> GetNodePropertyStorageLocation(const std::string& name) const;
 
   std::string GetNodePropertyName(int32_t i) const {
@@ -658,6 +719,11 @@ public:
   Result<std::shared_ptr<arrow::ChunkedArray>> GetEdgeProperty(
       const std::string& name) const;
 
+  /// Get an edge property by name as of the snapshot of \p txn_ctx; see
+  /// GetNodeProperty(const std::string&, katana::TxnContext*)
+  Result<std::shared_ptr<arrow::ChunkedArray>> GetEdgeProperty(
+      const std::string& name, katana::TxnContext* txn_ctx) const;
+
   std::string GetEdgePropertyName(int32_t i) const {
     return loaded_edge_schema()->field(i)->name();
   }
@@ -723,10 +789,21 @@ public:
     return pg_view_cache_.DropAllTopologies();
   }
 
+  /// A graph made with RDGLoadOptions::defer_topology loads its topology the
+  /// first time it or a view of it is used; loading errors are fatal then.
   const GraphTopology& topology() const noexcept {
     return pg_view_cache_.GetDefaultTopologyRef();
   }
 
+  /// Loads a deferred topology now, so that errors can be handled
+  Result<void> EnsureTopologyLoaded() const {
+    return pg_view_cache_.LoadDefaultTopology();
+  }
+
+  bool IsTopologyLoaded() const noexcept {
+    return pg_view_cache_.IsDefaultTopologyLoaded();
+  }
+
   GraphTopology::PropertyIndex GetEdgePropertyIndexFromOutEdge(
       const Edge& eid) const noexcept;
 
@@ -765,7 +842,11 @@ public:
     return AddEdgeProperties(res_table.value(), txn_ctx);
   }
 
-  /// Add Node properties that do not exist in the current graph
+  /// Add Node properties that do not exist in the current graph.
+  ///
+  /// This and the other property writes below fail with
+  /// ErrorCode::TransactionConflict, without changing anything, while
+  /// another transaction holds one of the properties; see TxnContext.
   Result<void> AddNodeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
   /// Add Edge properties that do not exist in the current graph
@@ -778,6 +859,23 @@ public:
   Result<void> UpsertEdgeProperties(
       const std::shared_ptr<arrow::Table>& props, katana::TxnContext* txn_ctx);
 
+  /// Set node property \p name at the property indexes \p rows, a uint64
+  /// array, to \p values, which has the type of the property; other rows
+  /// keep their values. Unlike UpsertNodeProperties, a patch costs time in
+  /// the number of rows changed: the column is changed in place unless its
+  /// data is shared, e.g., with a column returned by GetNodeProperty or
+  /// with the column an explicit transaction keeps to undo the patch, in
+  /// which case it is copied first. Only fixed-width properties can be
+  /// patched.
+  Result<void> PatchNodeProperty(
+      const std::string& name, const std::shared_ptr<arrow::Array>& rows,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+  /// Set edge property \p name at the property indexes \p rows to
+  /// \p values. See PatchNodeProperty.
+  Result<void> PatchEdgeProperty(
+      const std::string& name, const std::shared_ptr<arrow::Array>& rows,
+      const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx);
+
   Result<void> RemoveNodeProperty(int i, katana::TxnContext* txn_ctx);
   Result<void> RemoveNodeProperty(
       const std::string& prop_name, katana::TxnContext* txn_ctx);
@@ -810,23 +908,74 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// \returns the nodes, in ascending order, whose value of the numeric
+  /// property predicate.property_name satisfies predicate. If the property
+  /// is not loaded, only the row groups whose statistics may satisfy
+  /// predicate are read from storage, and the property stays unloaded.
+  Result<std::vector<Node>> FilterNodes(const PropertyPredicate& predicate);
+
+  /// \returns a table of the nodes that satisfy predicate, in a uint32
+  /// column "node", and their values of the node property name, in a column
+  /// name. The table is not added to the graph. Like FilterNodes, reads only
+  /// the row groups of unloaded properties that may hold matching nodes.
+  Result<std::shared_ptr<arrow::Table>> LoadNodeProperty(
+      const std::string& name, const PropertyPredicate& predicate);
+
+  /// Lets the PropertyUnloadManager unload properties of this graph that have
+  /// not been used for a while when memory runs low. Unloaded properties are
+  /// loaded again by EnsureNodePropertyLoaded and EnsureEdgePropertyLoaded,
+  /// which also make room for them first.
+  void EnablePropertyUnloading();
+
+  /// Keep a property loaded while property unloading is enabled, e.g., while
+  /// a view points into it. Pins nest.
+  void PinNodeProperty(const std::string& name);
+  void UnpinNodeProperty(const std::string& name);
+  void PinEdgeProperty(const std::string& name);
+  void UnpinEdgeProperty(const std::string& name);
+
+  /// Start loading the named node and edge properties from storage in the
+  /// background and return without waiting for them. Properties that are
+  /// already loaded or already being prefetched are skipped.
+  ///
+  /// Prefetched properties become visible once FinishPrefetch() is called.
+  /// Ensure*PropertyLoaded() calls it, so algorithms that load their inputs
+  /// through those functions pick up prefetched properties transparently.
+  Result<void> PrefetchProperties(
+      const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties);
+
+  /// Wait for all outstanding prefetches and add their properties to the
+  /// property tables. Does nothing if there are none.
+  Result<void> FinishPrefetch();
+
   std::vector<std::string> ListFullNodeProperties() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
     return rdg_->ListFullNodeProperties();
   }
   std::vector<std::string> ListLoadedNodeProperties() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
     return rdg_->ListLoadedNodeProperties();
   }
   std::vector<std::string> ListFullEdgeProperties() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
     return rdg_->ListFullEdgeProperties();
   }
   std::vector<std::string> ListLoadedEdgeProperties() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
     return rdg_->ListLoadedEdgeProperties();
   }
 
   /// Remove all node properties
-  void DropNodeProperties() { rdg_->DropNodeProperties(); }
+  void DropNodeProperties() {
+    std::unique_lock<std::shared_mutex> lock(property_mutex());
+    rdg_->DropNodeProperties();
+  }
   /// Remove all edge properties
-  void DropEdgeProperties() { rdg_->DropEdgeProperties(); }
+  void DropEdgeProperties() {
+    std::unique_lock<std::shared_mutex> lock(property_mutex());
+    rdg_->DropEdgeProperties();
+  }
 
   MutablePropertyView NodeMutablePropertyView() {
     return MutablePropertyView{
@@ -917,15 +1066,17 @@ public:
   edges_range OutEdges(Node node) const { return topology().OutEdges(node); }
 
   /// Return the number of local nodes
-  size_t size() const { return topology().size(); }
+  // These do not load a deferred topology; see RDGLoadOptions::defer_topology
+
+  size_t size() const { return NumNodes(); }
 
-  bool empty() const { return topology().empty(); }
+  bool empty() const { return NumNodes() == 0; }
 
   /// Return the number of local nodes
   ///  num_nodes in repartitioner is of type LocalNodeID
-  uint64_t NumNodes() const { return topology().NumNodes(); }
+  uint64_t NumNodes() const { return pg_view_cache_.NumDefaultNodes(); }
   /// Return the number of local edges
-  uint64_t NumEdges() const { return topology().NumEdges(); }
+  uint64_t NumEdges() const { return pg_view_cache_.NumDefaultEdges(); }
 
   /// Gets the destination for an edge.
   ///
@@ -936,14 +1087,22 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
-  Result<void> MakeNodeIndex(const std::string& property_name);
+  // Creates an index over a node property. An index stored with the graph is
+  // loaded instead of building it, if the property did not change since.
+  // Indexes are stored when the graph is written and dropped when their
+  // property is upserted or removed. Both kinds of index are stored the same
+  // way, so either can be loaded from an index stored as the other.
+  Result<void> MakeNodeIndex(
+      const std::string& property_name,
+      EntityIndexKind kind = EntityIndexKind::kOrdered);
 
   // Delete an existing index over a node property.
   Result<void> DeleteNodeIndex(const std::string& property_name);
 
-  // Creates an index over an edge property.
-  Result<void> MakeEdgeIndex(const std::string& property_name);
+  // Creates an index over an edge property, see MakeNodeIndex.
+  Result<void> MakeEdgeIndex(
+      const std::string& property_name,
+      EntityIndexKind kind = EntityIndexKind::kOrdered);
 
   // Delete an existing index over an edge property.
   Result<void> DeleteEdgeIndex(const std::string& property_name);
@@ -1066,15 +1225,27 @@ private:
 
   Result<void> DoWriteTopologies();
 
+  /// Queue the indexes that are not stored with the graph yet for the next
+  /// store of its RDG
+  Result<void> DoWriteEntityIndexes();
+
+  /// Drop the in-memory and stored index over a property that changed
+  void DropNodeIndex(const std::string& property_name);
+  void DropEdgeIndex(const std::string& property_name);
+
+  /// If \p pending is not null, the store is asynchronous and *pending is
+  /// ready when its writes are done
   Result<void> DoWrite(
       katana::RDGHandle handle, const std::string& command_line,
       katana::RDG::RDGVersioningPolicy versioning_action,
-      katana::TxnContext* txn_ctx);
+      katana::TxnContext* txn_ctx,
+      std::shared_future<CopyableResult<void>>* pending = nullptr);
 
   Result<void> ConductWriteOp(
       const std::string& uri, const std::string& command_line,
       katana::RDG::RDGVersioningPolicy versioning_action,
-      katana::TxnContext* txn_ctx);
+      katana::TxnContext* txn_ctx,
+      std::shared_future<CopyableResult<void>>* pending = nullptr);
 
   Result<void> WriteGraph(
       const std::string& uri, const std::string& command_line,
@@ -1096,6 +1267,36 @@ private:
 
   Result<RDGTopology*> LoadTopology(const RDGTopology& shadow);
 
+  /// Serializes swapping the property tables of rdg_ with reading columns
+  /// from them, so property reads can overlap a writer on another thread.
+  /// Not recursive: code holding it uses rdg_ rather than the public
+  /// property methods.
+  std::shared_mutex& property_mutex() const { return rdg_->property_mutex(); }
+
+  /// The current node property table; tables are replaced, not changed, so
+  /// the snapshot stays consistent
+  std::shared_ptr<arrow::Table> LoadedNodeProperties() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
+    return rdg_->node_properties();
+  }
+
+  /// The current edge property table; see LoadedNodeProperties()
+  std::shared_ptr<arrow::Table> LoadedEdgeProperties() const {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
+    return rdg_->edge_properties();
+  }
+
+  /// Claim node properties \p names for a write of \p txn_ctx, keeping
+  /// what an explicit transaction needs to undo the write. Must hold
+  /// property_mutex() exclusively.
+  Result<void> BeginNodePropertyWrites(
+      const std::vector<std::string>& names, TxnContext* txn_ctx);
+
+  /// Claim edge properties \p names for a write of \p txn_ctx; see
+  /// BeginNodePropertyWrites
+  Result<void> BeginEdgePropertyWrites(
+      const std::vector<std::string>& names, TxnContext* txn_ctx);
+
   // Data
   std::shared_ptr<katana::RDG> rdg_{std::make_shared<katana::RDG>()};
   std::shared_ptr<katana::RDGFile> file_;
@@ -1126,6 +1327,14 @@ private:
 
   PGViewCache pg_view_cache_;
 
+  /// Outstanding property reads started by PrefetchProperties()
+  std::unique_ptr<ReadGroup> prefetch_group_;
+  std::vector<std::string> prefetching_node_properties_;
+  std::vector<std::string> prefetching_edge_properties_;
+
+  /// Whether the PropertyUnloadManager watches the properties of this graph
+  bool property_unloading_{false};
+
   // Transformation related data.
   PropertyGraph* parent_{nullptr};
 
@@ -1162,6 +1371,53 @@ KATANA_EXPORT GraphTopology::Edge FindEdgeSortedByDest(
 // TODO(amber): this method should return a new sorted topology
 KATANA_EXPORT Result<void> SortNodesByDegree(PropertyGraph* pg);
 
+/// Creates an in-memory copy of pg with its nodes renumbered so that new
+/// node i is old node new_to_old[i].
+///
+/// The out-edges of each node keep their order. The node and edge entity
+/// types and all loaded node and edge properties are permuted along with the
+/// topology, so writing the result gives a reordered RDG. The permutation is
+/// applied in parallel, including within each property column.
+/// \param pg The original property graph
+/// \param new_to_old A permutation of the nodes of pg
+/// \return The permuted property graph, or an error if new_to_old is not a
+/// permutation of the nodes of pg
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> CreatePermutedGraph(
+    PropertyGraph* pg, const GraphTopology::PropIndexVec& new_to_old);
+
+/// Creates an in-memory copy of pg with the same nodes and the edges of
+/// topology, which must have as many nodes as pg.
+///
+/// Edge i of topology takes the entity type and properties of the edge
+/// whose property index in pg is edge_rows[i]; edges with an edge_rows
+/// entry of at least pg->NumEdges() are new and get the unknown entity type
+/// and null properties. The node types and all loaded node properties are
+/// copied.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> CreateGraphWithEdges(
+    PropertyGraph* pg, GraphTopology&& topology,
+    const NUMAArray<uint64_t>& edge_rows);
+
+/// Creates an in-memory copy of pg without the nodes set in removed_nodes
+/// and their edges, e.g., to delete entities without reloading the graph.
+///
+/// The remaining nodes keep their order and are renumbered 0, 1, ... in
+/// that order, as are the remaining edges. Node and edge entity types and
+/// all loaded node and edge properties are compacted along with the
+/// topology, in parallel, so writing the result gives an RDG without the
+/// removed nodes.
+/// \param pg The original property graph
+/// \param removed_nodes A bitset of the nodes of pg, set for nodes to remove
+/// \return The graph without the removed nodes, or an error if
+/// removed_nodes does not have one bit per node
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> RemoveNodes(
+    PropertyGraph* pg, const DynamicBitset& removed_nodes);
+
+/// Creates an in-memory copy of pg without the edges set in removed_edges,
+/// which is indexed by the out-edges of the topology of pg. The nodes are
+/// unchanged; see RemoveNodes.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> RemoveEdges(
+    PropertyGraph* pg, const DynamicBitset& removed_edges);
+
 /// Creates in-memory symmetric (or undirected) graph.
 ///
 /// This function creates an symmetric or undirected version of the
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "katana/Manager.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class RDG;
+
+/// Manager for the loaded properties of graphs that opted in with
+/// PropertyGraph::EnablePropertyUnloading.
+///
+/// A property that is not pinned, not referenced outside of its graph and not
+/// used for idle_time() is moved to standby memory when the MemorySupervisor
+/// checks for pressure.  When the MemorySupervisor asks for memory back,
+/// standby properties are unloaded, least recently used first, after writing
+/// them to storage if they were modified.  Unloaded properties come back with
+/// PropertyGraph::EnsureNodePropertyLoaded and EnsureEdgePropertyLoaded.
+///
+/// Properties are used when they are looked up by name or ensured loaded.
+/// Views like TypedPropertyGraph point into properties without holding on to
+/// them, so pin their properties while they are in use.
+///
+/// Not thread safe, like the MemorySupervisor.
+class KATANA_EXPORT PropertyUnloadManager : public Manager {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class PropertyKind { kNode, kEdge };
+
+  PropertyUnloadManager() = default;
+  ~PropertyUnloadManager();
+
+  /// Returns the property unload manager, registering it with the
+  /// MemorySupervisor on first use
+  static PropertyUnloadManager& Get();
+
+  static const std::string name_;
+  const std::string& Name() const override { return name_; }
+  count_t FreeStandbyMemory(count_t goal) override;
+  void RefreshStandby() override { MoveIdleToStandby(); }
+
+  /// How long a property must go unused before it can be unloaded
+  Clock::duration idle_time() const { return idle_time_; }
+  void set_idle_time(Clock::duration idle_time) { idle_time_ = idle_time; }
+
+  /// Start managing the loaded properties of \p rdg.  The manager does not
+  /// keep \p rdg alive.
+  void Watch(const std::shared_ptr<RDG>& rdg);
+
+  /// Property \p name of \p rdg was used and its idle time starts over
+  void PropertyUsed(
+      const RDG* rdg, PropertyKind kind, const std::string& name);
+
+  /// Pinned properties are never unloaded.  Pins nest.
+  void Pin(const RDG* rdg, PropertyKind kind, const std::string& name);
+  void Unpin(const RDG* rdg, PropertyKind kind, const std::string& name);
+
+  /// Moves the properties that have been idle for idle_time() to standby
+  void MoveIdleToStandby();
+
+  count_t standby() const { return standby_; }
+
+private:
+  struct Property {
+    Clock::time_point last_use;
+    uint32_t pins{0};
+    /// Bytes accounted as standby, 0 while the property is active
+    count_t standby_bytes{0};
+  };
+  using Properties = std::unordered_map<std::string, Property>;
+
+  struct Graph {
+    std::weak_ptr<RDG> rdg;
+    Properties node_properties;
+    Properties edge_properties;
+
+    Properties& properties(PropertyKind kind) {
+      return kind == PropertyKind::kNode ? node_properties : edge_properties;
+    }
+  };
+
+  /// Returns the state of property \p name of \p rdg, which is created if
+  /// \p create is true, or nullptr if there is none or \p rdg is not watched
+  Property* Find(
+      const RDG* rdg, PropertyKind kind, const std::string& name,
+      bool create);
+
+  /// Makes \p property active again if it is standby
+  void MakeActive(Property* property);
+
+  /// Drops the state of properties that are no longer loaded and of graphs
+  /// that are gone
+  void Prune();
+
+  std::unordered_map<const RDG*, Graph> graphs_;
+  Clock::duration idle_time_{std::chrono::minutes(1)};
+  count_t standby_{};
+};
+
+}  // namespace katana
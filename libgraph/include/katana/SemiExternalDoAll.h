@@ -0,0 +1,67 @@
+#ifndef KATANA_LIBGRAPH_KATANA_SEMIEXTERNALDOALL_H_
+#define KATANA_LIBGRAPH_KATANA_SEMIEXTERNALDOALL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The default number of out-edges per segment of SemiExternalDoAll, 512MB
+/// of edge destinations
+constexpr uint64_t kDefaultSemiExternalSegmentEdges = uint64_t{1} << 27;
+
+/// Splits the nodes of \p topo into consecutive segments of at least one node
+/// and about \p segment_edges out-edges each
+/// \returns the first node of every segment followed by NumNodes()
+KATANA_EXPORT std::vector<GraphTopology::Node> SemiExternalSegments(
+    const GraphTopology& topo, uint64_t segment_edges);
+
+/// do_all over the nodes of \p topo one segment of about \p segment_edges
+/// out-edges at a time, like OCImmutableEdgeGraph does for FileGraphs. While
+/// a segment runs, the edge destinations of the next one are read ahead, and
+/// once it is done, its edge destinations are the first to be evicted. This
+/// keeps the edges that a loop over a semi-external topology (see
+/// RDGLoadOptions::semi_external_topology) needs in memory and the ones it
+/// is done with out of the way, so loops like PageRank and connected
+/// components run when the edges do not fit in memory.
+///
+/// Threads only get work from the current segment, so \p segment_edges
+/// should be large enough to keep every thread busy. For topologies in
+/// memory, this is the same as a do_all over all nodes.
+///
+/// \code
+/// katana::SemiExternalDoAll(
+///     pg->topology(), katana::kDefaultSemiExternalSegmentEdges,
+///     [&](Node n) { ... }, katana::steal(), katana::loopname("Rank"));
+/// \endcode
+template <typename F, typename... Args>
+void
+SemiExternalDoAll(
+    const GraphTopology& topo, uint64_t segment_edges, const F& fn,
+    const Args&... args) {
+  if (!topo.IsSemiExternal()) {
+    katana::do_all(katana::iterate(topo), fn, args...);
+    return;
+  }
+
+  std::vector<GraphTopology::Node> bounds =
+      SemiExternalSegments(topo, segment_edges);
+  if (bounds.size() > 1) {
+    topo.WillNeedOutEdges(bounds[0], bounds[1]);
+  }
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    if (i + 2 < bounds.size()) {
+      topo.WillNeedOutEdges(bounds[i + 1], bounds[i + 2]);
+    }
+    katana::do_all(katana::iterate(bounds[i], bounds[i + 1]), fn, args...);
+    topo.DoneWithOutEdges(bounds[i], bounds[i + 1]);
+  }
+}
+
+}  // namespace katana
+
+#endif
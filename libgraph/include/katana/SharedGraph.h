@@ -0,0 +1,58 @@
+#ifndef KATANA_LIBGRAPH_KATANA_SHAREDGRAPH_H_
+#define KATANA_LIBGRAPH_KATANA_SHAREDGRAPH_H_
+
+#include <memory>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/RDG.h"
+#include "katana/Result.h"
+#include "katana/TxnContext.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Shared graphs let one process load a graph and many processes on the same
+/// host use it without loading copies of their own. The publishing process
+/// writes the graph, with its fixed-width properties as uncompressed raw
+/// columns (see RawColumnFormat), to a directory in shared memory; attaching
+/// processes memory map the topology and raw columns from there (see
+/// RDGLoadOptions::mmap_local_files), so every process reads the same
+/// physical pages. Mappings are copy on write: a process that changes its
+/// graph, e.g., by sorting edges, gets private copies of the pages it writes
+/// and the shared graph does not change.
+///
+/// Properties that cannot be raw columns, e.g., strings, are still read from
+/// Parquet by every process.
+
+/// The directory shared graphs are published in: $KATANA_SHARED_GRAPH_DIR if
+/// it is set and /dev/shm/katana-graphs otherwise. /dev/shm is a tmpfs, whose
+/// pages can be huge pages when it is mounted with huge=advise or
+/// huge=always.
+KATANA_EXPORT std::string SharedGraphDir();
+
+/// \returns the location of the RDG of the shared graph \p name
+KATANA_EXPORT std::string SharedGraphLocation(const std::string& name);
+
+/// Publish \p pg as the shared graph \p name. Fails with AlreadyExists if a
+/// graph of that name is already published.
+///
+/// \returns the location of the published RDG
+KATANA_EXPORT Result<std::string> PublishSharedGraph(
+    PropertyGraph* pg, const std::string& name,
+    const std::string& command_line, TxnContext* txn_ctx);
+
+/// Load the shared graph \p name with its files memory mapped. The other
+/// fields of \p opts, e.g., which properties to load, apply as usual.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> AttachSharedGraph(
+    const std::string& name, TxnContext* txn_ctx,
+    RDGLoadOptions opts = RDGLoadOptions::Defaults());
+
+/// Remove the files of the shared graph \p name. Processes that are attached
+/// to it keep their mappings, and the memory is freed when the last of them
+/// detaches.
+KATANA_EXPORT Result<void> UnpublishSharedGraph(const std::string& name);
+
+}  // namespace katana
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef KATANA_LIBGRAPH_KATANA_SHAREDMEMSYS_H_
 #define KATANA_LIBGRAPH_KATANA_SHAREDMEMSYS_H_
 
+#include <chrono>
 #include <memory>
+#include <optional>
 
 #include "katana/Galois.h"
 #include "katana/TextTracer.h"
@@ -9,6 +11,22 @@
 
 namespace katana {
 
+/// Options of the shared memory system
+struct KATANA_EXPORT SharedMemSysOptions {
+  /// How long idle worker threads spin for the next parallel loop before they
+  /// park on a futex; see ThreadPool::SetSpinBeforePark. Services that idle
+  /// between queries want a short spin, so that the threads do not take CPU
+  /// from the rest of the process, and batch jobs a long one. Unset means
+  /// the default of the thread pool.
+  std::optional<std::chrono::microseconds> thread_spin_before_park;
+  /// Samples per second of CPU time of the sampling profiler, which logs
+  /// folded stacks on the spans of the tracer; see
+  /// katana/SamplingProfiler.h. Unset means the value of the environment
+  /// variable KATANA_SAMPLING_PROFILER_HZ, and no profiling if that is unset
+  /// too.
+  std::optional<uint32_t> sampling_profiler_hz;
+};
+
 /**
  * SharedMemSys initializes the Galois library for shared memory. Most Galois
  * library operations are only valid during the lifetime of a SharedMemSys or a
@@ -24,6 +42,9 @@ class KATANA_EXPORT SharedMemSys {
 
 public:
   SharedMemSys(std::unique_ptr<ProgressTracer> tracer = TextTracer::Make());
+  SharedMemSys(
+      const SharedMemSysOptions& options,
+      std::unique_ptr<ProgressTracer> tracer = TextTracer::Make());
   ~SharedMemSys();
 
   SharedMemSys(const SharedMemSys&) = delete;
@@ -1,9 +1,17 @@
 #ifndef KATANA_LIBGRAPH_KATANA_TOPOLOGYGENERATION_H_
 #define KATANA_LIBGRAPH_KATANA_TOPOLOGYGENERATION_H_
 
+#include <cstdint>
+#include <type_traits>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
 #include <arrow/type_traits.h>
 
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Random.h"
 
 namespace katana {
 
@@ -35,10 +43,130 @@ KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeClique(
 KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeTriangle(
     size_t num_rows) noexcept;
 
+/*************************************************************/
+/* Functions for generating large random graph topologies    */
+/*************************************************************/
+
+// The generators below are parallel and build the CSR directly, without an
+// intermediate edge list. Each draws the random values of an edge (or node)
+// from katana::SplitMix64::ForIndex(seed, id), so that the same options give
+// the same graph whatever the number of threads.
+
+struct RMATOptions {
+  /// The graph has 2^scale nodes
+  uint32_t scale{16};
+  /// The graph has edge_factor * 2^scale edges
+  uint32_t edge_factor{16};
+  /// The probabilities of an edge falling into the top left, top right and
+  /// bottom left quadrant of the adjacency matrix at every level; the bottom
+  /// right one gets the rest. The defaults are those of Graph500.
+  double a{0.57};
+  double b{0.19};
+  double c{0.19};
+  uint64_t seed{0};
+  /// Relabel the nodes with a pseudo random permutation, as Graph500 does,
+  /// so that node ids and degrees are not correlated
+  bool scramble_ids{true};
+};
+
+/// Generates a directed R-MAT graph; with the default options this is the
+/// Graph500 Kronecker generator. Like that one, it keeps the self loops and
+/// parallel edges it draws. The edges of every node are sorted by
+/// destination.
+KATANA_EXPORT Result<GraphTopology> MakeRMATTopology(
+    const RMATOptions& options);
+
+struct BarabasiAlbertOptions {
+  uint64_t num_nodes{uint64_t{1} << 16};
+  /// Out edges of every node but the first
+  uint32_t edges_per_node{8};
+  uint64_t seed{0};
+};
+
+/// Generates a Barabási–Albert preferential attachment graph: every node
+/// after the first has edges_per_node out edges to earlier nodes, each
+/// chosen with probability proportional to its degree at that point.
+///
+/// Edges are drawn as in the Batagelj–Brandes generator, whose edge list
+/// Sanders and Schulz showed can be computed in parallel: each edge copies
+/// an endpoint of a uniformly chosen earlier edge. As there, a few self
+/// loops and parallel edges occur.
+KATANA_EXPORT Result<GraphTopology> MakeBarabasiAlbertTopology(
+    const BarabasiAlbertOptions& options);
+
+struct LFROptions {
+  uint64_t num_nodes{uint64_t{1} << 16};
+  /// Degrees follow a power law with this exponent (tau1 of LFR) between
+  /// min_degree and max_degree
+  uint32_t min_degree{5};
+  uint32_t max_degree{100};
+  double degree_exponent{2.5};
+  /// Community sizes follow a power law with this exponent (tau2 of LFR)
+  /// between min_community and max_community
+  uint32_t min_community{20};
+  uint32_t max_community{1000};
+  double community_exponent{1.5};
+  /// The fraction of the edges of every node that leave its community (mu
+  /// of LFR)
+  double mixing{0.3};
+  uint64_t seed{0};
+};
+
+/// A graph with planted communities: communities[n] is the community of
+/// node n. The nodes of a community are consecutive.
+struct LFRTopology {
+  GraphTopology topology;
+  NUMAArray<uint32_t> communities;
+};
+
+/// Generates a graph with the degree distribution, community size
+/// distribution and mixing of the LFR benchmark of Lancichinetti,
+/// Fortunato and Radicchi.
+///
+/// Rather than rewiring a configuration model until the mixing holds, which
+/// does not parallelize, every node gets its drawn degree as out edges.
+/// (1 - mixing) of them go to nodes of its community and the rest to nodes
+/// of other communities, each target chosen with probability proportional
+/// to its degree (Chung–Lu). So degrees and mixing hold in expectation
+/// rather than exactly, as with LFR.
+KATANA_EXPORT Result<LFRTopology> MakeLFRTopology(const LFROptions& options);
+
 /***********************************************************/
 /* Functions for adding node and edge properties to graphs */
 /***********************************************************/
 
+/// A value function for PropertyGenerator that gives every id a pseudo
+/// random value in [min, max] (or [min, max) for floating point types). The
+/// value of an id only depends on the seed and the id.
+template <typename T>
+class RandomPropertyValues {
+  static_assert(
+      std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+      "RandomPropertyValues only supports numeric types");
+
+public:
+  RandomPropertyValues(uint64_t seed, T min, T max)
+      : seed_(seed), min_(min), max_(max) {}
+
+  T operator()(uint64_t id) const {
+    SplitMix64 random = SplitMix64::ForIndex(seed_, id);
+    if constexpr (std::is_floating_point_v<T>) {
+      return min_ + static_cast<T>(random.NextDouble() * (max_ - min_));
+    } else {
+      // the range is 0 if it is all of uint64_t
+      uint64_t range = static_cast<uint64_t>(max_) -
+                       static_cast<uint64_t>(min_) + uint64_t{1};
+      uint64_t offset = range == 0 ? random() : random.NextBelow(range);
+      return static_cast<T>(static_cast<uint64_t>(min_) + offset);
+    }
+  }
+
+private:
+  uint64_t seed_;
+  T min_;
+  T max_;
+};
+
 template <typename ValueFunc>
 class KATANA_EXPORT PropertyGenerator;
 
@@ -116,6 +244,28 @@ AddGraphProperties(
     // For schema
     fields.emplace_back(generator.MakeField());
 
+    // Numeric values are generated in parallel, straight into the column,
+    // so that properties of large generated graphs are quick to add
+    using ValueType = typename decltype(generator)::ValueType;
+    if constexpr (
+        std::is_arithmetic_v<ValueType> && !std::is_same_v<ValueType, bool>) {
+      using ArrowType = typename decltype(generator)::ArrowType;
+      uint64_t size = is_node ? pg->NumNodes() : pg->NumEdges();
+      std::shared_ptr<arrow::Buffer> buffer =
+          KATANA_CHECKED(arrow::AllocateBuffer(size * sizeof(ValueType)));
+      auto* values = reinterpret_cast<ValueType*>(buffer->mutable_data());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, size),
+          [&](uint64_t i) { values[i] = generator(static_cast<ArgType>(i)); },
+          katana::no_stats());
+      columns.emplace_back(
+          std::make_shared<arrow::ChunkedArray>(arrow::MakeArray(
+              arrow::ArrayData::Make(
+                  std::make_shared<ArrowType>(), size,
+                  {nullptr, std::move(buffer)}))));
+      return katana::ResultSuccess();
+    }
+
     // For property values
     auto builder = generator.MakeBuilder();
     if constexpr (is_node) {
@@ -187,6 +337,8 @@ private:
 
 /// Convenience function to add node properties to pre-constructed property graphs.
 /// It is a variadic function, it will add a node property for every provided PropertyGenerator.
+/// Value functions of numeric properties are called in parallel, so they must
+/// be safe to call concurrently.
 ///
 /// For example:
 ///
@@ -206,6 +358,7 @@ AddNodeProperties(
 
 /// Convenience function to add edge properties to pre-constructed property graphs.
 /// It is a variadic function, it will add an edge property for every passed PropertyGenerator.
+/// As for AddNodeProperties, numeric properties are generated in parallel.
 ///
 /// For example:
 ///
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "katana/Manager.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class PGViewCache;
+
+/// Manager for the derived topologies (sorted, shuffled, edge type aware and
+/// compressed topologies) that PGViewCache instances keep around after a view
+/// was built from them.
+///
+/// A cached topology is standby memory.  When the MemorySupervisor asks for
+/// memory back, topologies are evicted from their caches in least recently
+/// used order, skipping those still referenced by a live view.  An evicted
+/// topology is loaded from storage, if the RDG has it, or regenerated the
+/// next time a view needs it.
+class KATANA_EXPORT TopologyManager : public Manager {
+public:
+  TopologyManager() = default;
+  ~TopologyManager();
+
+  /// Returns the topology manager, registering it with the MemorySupervisor
+  /// on first use
+  static TopologyManager& Get();
+
+  static const std::string name_;
+  const std::string& Name() const override { return name_; }
+  count_t FreeStandbyMemory(count_t goal) override;
+
+  /// \p cache started caching \p topo, which uses about \p bytes of memory
+  void TopologyCached(PGViewCache* cache, const void* topo, count_t bytes);
+
+  /// \p topo was handed out by its cache, make it the most recently used
+  void TopologyUsed(const void* topo);
+
+  /// \p topo was removed from its cache by the cache itself
+  void TopologyDropped(const void* topo);
+
+  /// \p cache is going away or dropped all of its topologies
+  void CacheDropped(PGViewCache* cache);
+
+  /// The topologies of \p from now belong to \p to
+  void CacheMoved(PGViewCache* from, PGViewCache* to);
+
+  count_t standby() const { return standby_; }
+
+private:
+  struct Entry {
+    PGViewCache* cache;
+    const void* topo;
+    count_t bytes;
+  };
+  using LRUList = std::list<Entry>;
+
+  void Drop(LRUList::iterator it);
+
+  /// Most recently used entries are at the front
+  LRUList lru_;
+  std::unordered_map<const void*, LRUList::iterator> entries_;
+  count_t standby_{};
+};
+
+}  // namespace katana
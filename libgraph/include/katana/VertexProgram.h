@@ -0,0 +1,350 @@
+#ifndef KATANA_LIBGRAPH_KATANA_VERTEXPROGRAM_H_
+#define KATANA_LIBGRAPH_KATANA_VERTEXPROGRAM_H_
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+
+/// Vertex programs in the style of Pregel: computation proceeds in
+/// supersteps, and in each superstep every active node runs Compute with
+/// the combination of the messages sent to it in the previous superstep.
+/// Compute may update the value of the node, send messages, contribute to
+/// the aggregate of the superstep and vote to halt. A halted node is
+/// inactive until it receives a message, and the program ends when no node
+/// is active and no message is in flight.
+///
+/// A vertex program derives from VertexProgram<Value, Message> and defines
+///
+///   // associative and commutative; combines messages to the same node
+///   static Message Combine(Message a, Message b);
+///   // identity of Combine
+///   static Message MessageIdentity();
+///   void Compute(
+///       VertexContext<Program>& ctx, Node n, Value& value,
+///       const Message* message);  // nullptr if no message arrived
+///
+/// and may redefine Aggregate, CombineAggregates and AggregateIdentity,
+/// which sum the uint64_t values given to AddToAggregate by default.
+///
+/// Messages sent with SendToNeighbors go to every out-neighbor of the
+/// sender. They are delivered either by pushing them along the out-edges of
+/// the senders or by pulling them along the in-edges of every node, which
+/// needs no atomics; like the direction optimizing BFS, kAuto pushes in
+/// supersteps whose senders have few out-edges and pulls otherwise.
+/// Messages sent with SendTo go to a single node and are buffered in
+/// per-thread InsertBag blocks until they are pushed at the end of the
+/// superstep.
+///
+/// Messages are combined with compare and swap loops, so Message must be
+/// trivially copyable and at most 8 bytes.
+namespace katana {
+
+template <typename ValueTy, typename MessageTy>
+struct VertexProgram {
+  using Node = PropertyGraphViews::Default::Node;
+  using Value = ValueTy;
+  using Message = MessageTy;
+  using Aggregate = uint64_t;
+
+  static Aggregate CombineAggregates(Aggregate a, Aggregate b) {
+    return a + b;
+  }
+  static Aggregate AggregateIdentity() { return 0; }
+};
+
+enum class MessageDelivery {
+  kPush,
+  kPull,
+  /// pull when the senders of a superstep have more than 1 in
+  /// kPullEdgeDivisor of the edges of the graph
+  kAuto,
+};
+
+struct VertexProgramOptions {
+  /// The program stops after this many supersteps even if nodes are active
+  uint32_t max_supersteps{std::numeric_limits<uint32_t>::max()};
+  MessageDelivery delivery{MessageDelivery::kAuto};
+};
+
+struct VertexProgramStatistics {
+  /// Number of supersteps run
+  uint32_t supersteps{0};
+  /// Number of messages sent, counting a SendToNeighbors once per out-edge
+  uint64_t messages{0};
+  /// Whether the program stopped because no node was active
+  bool converged{false};
+};
+
+template <typename Program>
+class VertexContext;
+
+template <typename Program>
+Result<VertexProgramStatistics> RunVertexProgram(
+    PropertyGraph* pg, Program* program,
+    NUMAArray<typename Program::Value>* values,
+    const VertexProgramOptions& options = {});
+
+/// What Compute can do besides updating the value of its node. All member
+/// functions may be called concurrently from the Compute of different
+/// nodes.
+template <typename Program>
+class VertexContext {
+public:
+  using Graph = PropertyGraphViews::Default;
+  using Node = typename Graph::Node;
+  using Message = typename Program::Message;
+  using Aggregate = typename Program::Aggregate;
+
+  /// Edges of the senders of a superstep above which kAuto pulls; the same
+  /// threshold as the direction optimizing BFS (BfsPlan::kDefaultBeta)
+  constexpr static const uint64_t kPullEdgeDivisor = 18;
+
+  uint32_t superstep() const { return superstep_; }
+  const Graph& graph() const { return graph_; }
+  uint64_t NumNodes() const { return graph_.NumNodes(); }
+
+  /// Send message to every out-neighbor of n. Only Compute(n) may call this,
+  /// and several calls in a superstep combine their messages.
+  void SendToNeighbors(Node n, const Message& message) {
+    if (sent_.test(n)) {
+      outbox_[n] = Program::Combine(outbox_[n], message);
+      return;
+    }
+    outbox_[n] = message;
+    sent_.set(n);
+    sender_edges_ += graph_.OutDegree(n);
+  }
+
+  /// Send message to dst
+  void SendTo(Node dst, const Message& message) {
+    direct_.emplace(dst, message);
+    direct_messages_ += 1;
+  }
+
+  /// Deactivate n until it receives a message. Only Compute(n) may call
+  /// this.
+  void VoteToHalt(Node n) { next_active_.reset(n); }
+
+  /// Contribute to the aggregate of this superstep
+  void AddToAggregate(const Aggregate& value) { aggregate_.update(value); }
+
+  /// \returns the aggregate of the previous superstep, or the identity in
+  /// the first superstep
+  const Aggregate& previous_aggregate() const { return previous_aggregate_; }
+
+private:
+  template <typename P>
+  friend Result<VertexProgramStatistics> RunVertexProgram(
+      PropertyGraph* pg, P* program, NUMAArray<typename P::Value>* values,
+      const VertexProgramOptions& options);
+
+  struct MergeAggregates {
+    Aggregate operator()(const Aggregate& a, const Aggregate& b) const {
+      return Program::CombineAggregates(a, b);
+    }
+  };
+  struct IdentityAggregate {
+    Aggregate operator()() const { return Program::AggregateIdentity(); }
+  };
+
+  explicit VertexContext(Graph graph)
+      : graph_(std::move(graph)),
+        aggregate_(MergeAggregates(), IdentityAggregate()),
+        previous_aggregate_(Program::AggregateIdentity()) {
+    uint64_t num_nodes = graph_.NumNodes();
+    active_.resize(num_nodes);
+    next_active_.resize(num_nodes);
+    sent_.resize(num_nodes);
+    received_.resize(num_nodes);
+    outbox_.allocateBlocked(num_nodes);
+    inbox_.allocateBlocked(num_nodes);
+  }
+
+  /// inbox[dst] = Combine(inbox[dst], message) for concurrent senders
+  void Deliver(Node dst, const Message& message) {
+    Message old_message;
+    __atomic_load(&inbox_[dst], &old_message, __ATOMIC_RELAXED);
+    Message new_message = Program::Combine(old_message, message);
+    while (!__atomic_compare_exchange(
+        &inbox_[dst], &old_message, &new_message, true, __ATOMIC_RELAXED,
+        __ATOMIC_RELAXED)) {
+      new_message = Program::Combine(old_message, message);
+    }
+    received_.set(dst);
+  }
+
+  void ClearInbox() {
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const Node& n) { inbox_[n] = Program::MessageIdentity(); },
+        katana::no_stats(), katana::loopname("VertexProgram_ClearInbox"));
+    received_.reset();
+  }
+
+  void PushBroadcasts() {
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const Node& src) {
+          if (!sent_.test(src)) {
+            return;
+          }
+          for (auto e : graph_.OutEdges(src)) {
+            Deliver(graph_.OutEdgeDst(e), outbox_[src]);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("VertexProgram_Push"));
+  }
+
+  template <typename TransposedGraph>
+  void PullBroadcasts(const TransposedGraph& transposed) {
+    katana::do_all(
+        katana::iterate(transposed),
+        [&](const Node& dst) {
+          bool any = false;
+          Message combined = Program::MessageIdentity();
+          for (auto e : transposed.OutEdges(dst)) {
+            Node src = transposed.OutEdgeDst(e);
+            if (sent_.test(src)) {
+              combined = Program::Combine(combined, outbox_[src]);
+              any = true;
+            }
+          }
+          if (any) {
+            inbox_[dst] = combined;
+            received_.set(dst);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("VertexProgram_Pull"));
+  }
+
+  void PushDirect() {
+    katana::do_all(
+        katana::iterate(direct_),
+        [&](const std::pair<Node, Message>& m) { Deliver(m.first, m.second); },
+        katana::no_stats(), katana::loopname("VertexProgram_PushDirect"));
+  }
+
+  Graph graph_;
+  uint32_t superstep_{0};
+  /// nodes that did not vote to halt in the previous superstep
+  katana::DynamicBitset active_;
+  katana::DynamicBitset next_active_;
+  /// nodes that called SendToNeighbors in this superstep
+  katana::DynamicBitset sent_;
+  /// nodes with a message in inbox_
+  katana::DynamicBitset received_;
+  katana::NUMAArray<Message> outbox_;
+  katana::NUMAArray<Message> inbox_;
+  katana::InsertBag<std::pair<Node, Message>> direct_;
+  katana::GAccumulator<uint64_t> sender_edges_;
+  katana::GAccumulator<uint64_t> direct_messages_;
+  katana::Reducible<Aggregate, MergeAggregates, IdentityAggregate> aggregate_;
+  Aggregate previous_aggregate_;
+};
+
+/// Run program on pg until no node is active or options.max_supersteps
+/// supersteps have run. values has an entry per node, the initial value of
+/// the node, and holds the final values on return. Every node is active in
+/// the first superstep.
+template <typename Program>
+Result<VertexProgramStatistics>
+RunVertexProgram(
+    PropertyGraph* pg, Program* program,
+    NUMAArray<typename Program::Value>* values,
+    const VertexProgramOptions& options) {
+  using Context = VertexContext<Program>;
+  using Node = typename Context::Node;
+  using Message = typename Program::Message;
+  static_assert(
+      std::is_trivially_copyable_v<Message> && sizeof(Message) <= 8,
+      "messages are combined with compare and swap");
+
+  if (values->size() != pg->NumNodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} values for {} nodes", values->size(),
+        pg->NumNodes());
+  }
+
+  Context ctx(pg->BuildView<PropertyGraphViews::Default>());
+  std::optional<PropertyGraphViews::Transposed> transposed;
+  if (options.delivery != MessageDelivery::kPush) {
+    transposed = pg->BuildView<PropertyGraphViews::Transposed>();
+  }
+  const uint64_t num_edges = ctx.graph_.NumEdges();
+
+  VertexProgramStatistics stats;
+  katana::do_all(
+      katana::iterate(ctx.graph_), [&](const Node& n) { ctx.active_.set(n); },
+      katana::no_stats(), katana::loopname("VertexProgram_Init"));
+  ctx.ClearInbox();
+
+  for (; ctx.superstep_ < options.max_supersteps; ++ctx.superstep_) {
+    katana::GAccumulator<uint64_t> running;
+    ctx.next_active_.reset();
+    ctx.sent_.reset();
+    ctx.sender_edges_.reset();
+    ctx.direct_messages_.reset();
+    katana::do_all(
+        katana::iterate(ctx.graph_),
+        [&](const Node& n) {
+          bool has_message = ctx.received_.test(n);
+          if (!has_message && !ctx.active_.test(n)) {
+            return;
+          }
+          running += 1;
+          ctx.next_active_.set(n);
+          program->Compute(
+              ctx, n, (*values)[n], has_message ? &ctx.inbox_[n] : nullptr);
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("VertexProgram_Compute"));
+
+    if (running.reduce() == 0) {
+      stats.converged = true;
+      break;
+    }
+    ++stats.supersteps;
+    ctx.previous_aggregate_ = ctx.aggregate_.reduce();
+    ctx.aggregate_.reset();
+
+    // deliver the messages of this superstep for the next one
+    uint64_t sender_edges = ctx.sender_edges_.reduce();
+    uint64_t direct_messages = ctx.direct_messages_.reduce();
+    stats.messages += sender_edges + direct_messages;
+    ctx.ClearInbox();
+    if (sender_edges > 0) {
+      bool pull = options.delivery == MessageDelivery::kPull ||
+                  (options.delivery == MessageDelivery::kAuto &&
+                   sender_edges * Context::kPullEdgeDivisor > num_edges);
+      if (pull) {
+        ctx.PullBroadcasts(*transposed);
+      } else {
+        ctx.PushBroadcasts();
+      }
+    }
+    if (direct_messages > 0) {
+      ctx.PushDirect();
+      ctx.direct_.clear();
+    }
+    std::swap(ctx.active_, ctx.next_active_);
+  }
+
+  return stats;
+}
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CHECKPOINT_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_CHECKPOINT_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/Result.h"
+#include "katana/WriteGroup.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Where and how often an iterative analytic saves its state, so that a run
+/// cut short, e.g., by the loss of its host, can resume from the last state
+/// saved instead of starting over. Checkpoints are off unless location is
+/// set.
+struct KATANA_EXPORT CheckpointOptions {
+  static constexpr uint32_t kDefaultInterval = 10;
+
+  /// The directory, local or remote, the checkpoints are written to
+  std::string location;
+  /// Save the state every this many iterations of the analytic: rounds of
+  /// Pagerank and matrix completion, phases of clustering
+  uint32_t interval{kDefaultInterval};
+  /// Start from the latest checkpoint at location, if there is one
+  bool resume{false};
+
+  bool enabled() const { return !location.empty() && interval > 0; }
+};
+
+/// The state of an analytic after some iterations
+struct KATANA_EXPORT CheckpointState {
+  /// The number of iterations done
+  uint32_t iteration{0};
+  /// The arrays of the state, as columns of the same length
+  std::shared_ptr<arrow::Table> columns;
+};
+
+/// Saves the state of an analytic in the background while it keeps running
+/// and loads it back when the analytic is run again.
+///
+/// Save hands the state to a WriteGroup and returns; the checkpoint becomes
+/// the one to resume from once its files are written, which the next Save
+/// or Finish waits for. Checkpoints alternate between two files, so a write
+/// cut short never damages the last complete checkpoint. Discard removes
+/// them once the analytic is done.
+///
+///   Checkpointer checkpointer(plan.checkpoint(), "pagerank");
+///   if (auto state = KATANA_CHECKED(checkpointer.Resume())) { ... }
+///   while (...) {
+///     ...
+///     if (checkpointer.IsDue(iteration)) {
+///       KATANA_CHECKED(checkpointer.Save({iteration, columns}));
+///     }
+///   }
+///   KATANA_CHECKED(checkpointer.Discard());
+class KATANA_EXPORT Checkpointer {
+public:
+  /// name tells the checkpoints of the analytic apart from those of others
+  /// at the same location
+  Checkpointer(CheckpointOptions options, std::string name)
+      : options_(std::move(options)), name_(std::move(name)) {}
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+
+  /// Waits for the checkpoint being written, if any
+  ~Checkpointer();
+
+  bool enabled() const { return options_.enabled(); }
+
+  /// \returns true if the state after iteration should be saved
+  bool IsDue(uint32_t iteration) const {
+    return enabled() && iteration % options_.interval == 0;
+  }
+
+  /// \returns the latest complete checkpoint if the options ask to resume
+  /// and there is one
+  Result<std::optional<CheckpointState>> Resume();
+
+  /// Start writing state as the latest checkpoint. The columns must not
+  /// change until it is written, so they should be copies, see
+  /// MakeCheckpointColumn.
+  Result<void> Save(CheckpointState state);
+
+  /// Wait for the checkpoint being written, if any, and make it the latest
+  Result<void> Finish();
+
+  /// Wait for the checkpoint being written, if any, and remove the
+  /// checkpoints of this run, including the one it resumed from
+  Result<void> Discard();
+
+private:
+  std::string FileName(uint32_t slot) const;
+  std::string MarkerName() const;
+
+  CheckpointOptions options_;
+  std::string name_;
+  /// The writes of the checkpoint in flight
+  std::unique_ptr<WriteGroup> pending_;
+  uint32_t pending_iteration_{0};
+  uint32_t pending_slot_{0};
+  /// The number of checkpoints saved
+  uint32_t num_saved_{0};
+  std::unordered_set<std::string> written_;
+};
+
+/// \returns a new array of the values value_of(i) for i in [0, size),
+/// copied in parallel
+template <typename T, typename F>
+Result<std::shared_ptr<arrow::Array>>
+MakeCheckpointColumn(size_t size, F value_of) {
+  using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(size * sizeof(T)));
+  T* data = reinterpret_cast<T*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(size_t{0}, size),
+      [&](size_t i) { data[i] = value_of(i); }, katana::no_stats());
+  return std::make_shared<arrow::NumericArray<ArrowType>>(size, buffer);
+}
+
+/// \returns the state after iteration made of the arrays columns, named
+/// names
+KATANA_EXPORT CheckpointState MakeCheckpointState(
+    uint32_t iteration, const std::vector<std::string>& names,
+    const std::vector<std::shared_ptr<arrow::Array>>& columns);
+
+/// \returns the column name of state cast to type, or an error if the
+/// column is missing, holds nulls or has fewer or more than size values
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> GetCheckpointColumn(
+    const CheckpointState& state, const std::string& name, size_t size,
+    const std::shared_ptr<arrow::DataType>& type);
+
+/// Call set(i, value) for every value of the column name of state, in
+/// parallel; see GetCheckpointColumn
+template <typename T, typename F>
+Result<void>
+RestoreCheckpointColumn(
+    const CheckpointState& state, const std::string& name, size_t size,
+    F set) {
+  using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+  std::shared_ptr<arrow::ChunkedArray> column =
+      KATANA_CHECKED(GetCheckpointColumn(
+          state, name, size, arrow::TypeTraits<ArrowType>::type_singleton()));
+  size_t offset = 0;
+  for (const auto& chunk : column->chunks()) {
+    const auto& values =
+        static_cast<const arrow::NumericArray<ArrowType>&>(*chunk);
+    katana::do_all(
+        katana::iterate(int64_t{0}, values.length()),
+        [&](int64_t i) { set(offset + i, values.Value(i)); },
+        katana::no_stats());
+    offset += values.length();
+  }
+  return ResultSuccess();
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <random>
@@ -29,6 +31,9 @@
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
+#include "katana/PackedPropertyGroup.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Random.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -46,9 +51,6 @@ struct LeidenCommunityType {
   std::atomic<uint64_t> size;
   std::atomic<EdgeWeightType> degree_wt;
   std::atomic<uint64_t> node_wt;
-  EdgeWeightType internal_edge_wt;
-  uint64_t num_internal_edges;
-  uint64_t num_sub_communities;
 };
 
 struct PreviousCommunityID : public katana::PODProperty<uint64_t> {};
@@ -64,6 +66,69 @@ using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 struct CurrentSubCommunityID : public katana::PODProperty<uint64_t> {};
 struct NodeWeight : public katana::PODProperty<uint64_t> {};
 
+/// Total edge weight from a node, or a set of nodes, to each neighboring
+/// cluster. Clusters are found through an open-addressing table and their
+/// weights kept in arrays in the order clusters were first added, so that
+/// one map per thread can be reused for node after node without allocating
+/// and the modularity gains of all clusters can be computed in one pass.
+template <typename EdgeWeightType>
+class ClusterWeightMap {
+public:
+  /// Empty the map and make room for max_clusters clusters
+  void Reset(size_t max_clusters) {
+    for (size_t slot : used_slots_) {
+      slots_[slot] = 0;
+    }
+    used_slots_.clear();
+    clusters_.clear();
+    weights_.clear();
+
+    size_t capacity = 16;
+    while (capacity < 2 * max_clusters) {
+      capacity *= 2;
+    }
+    if (slots_.size() < capacity) {
+      slots_.assign(capacity, 0);
+    }
+    mask_ = capacity - 1;
+  }
+
+  /// Add weight to cluster, adding cluster with weight if it is new
+  void Add(uint64_t cluster, EdgeWeightType weight) {
+    size_t slot = FindSlot(cluster);
+    if (slots_[slot] != 0) {
+      weights_[slots_[slot] - 1] += weight;
+      return;
+    }
+    KATANA_LOG_DEBUG_ASSERT(2 * clusters_.size() < mask_ + 1);
+    clusters_.emplace_back(cluster);
+    weights_.emplace_back(weight);
+    slots_[slot] = clusters_.size();
+    used_slots_.emplace_back(slot);
+  }
+
+  size_t size() const { return clusters_.size(); }
+  const std::vector<uint64_t>& clusters() const { return clusters_; }
+  const std::vector<EdgeWeightType>& weights() const { return weights_; }
+
+private:
+  /// \returns the slot of cluster, or the empty slot where it would go
+  size_t FindSlot(uint64_t cluster) const {
+    size_t slot = (cluster * 0x9e3779b97f4a7c15ULL) >> 32 & mask_;
+    while (slots_[slot] != 0 && clusters_[slots_[slot] - 1] != cluster) {
+      slot = (slot + 1) & mask_;
+    }
+    return slot;
+  }
+
+  /// index + 1 into clusters_ and weights_, 0 for empty slots
+  std::vector<uint32_t> slots_;
+  std::vector<size_t> used_slots_;
+  std::vector<uint64_t> clusters_;
+  std::vector<EdgeWeightType> weights_;
+  size_t mask_{0};
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
@@ -82,24 +147,19 @@ struct ClusteringImplementationBase {
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
    *
-   * It updates the mapping of neighboring nodes clusters
-   * in cluster_local_map, total unique cluster edge weights
-   * in counter as well as total weight of self edges in self_loop_wt.
+   * It fills cluster_weights with the total edge weight to each
+   * neighboring cluster, the node's current cluster first, and records the
+   * total weight of self edges in self_loop_wt.
    */
   template <typename EdgeWeightType>
   static void FindNeighboringClusters(
       const Graph& graph, const GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
-    uint64_t num_unique_clusters = 0;
+      ClusterWeightMap<EdgeTy>* cluster_weights, EdgeTy& self_loop_wt) {
+    cluster_weights->Reset(Degree(graph, n) + 1);
 
     // Add the node's current cluster to be considered
     // for movement as well
-    cluster_local_map[graph.template GetData<CurrentCommunityID>(n)] =
-        0;                 // Add n's current cluster
-    counter.push_back(0);  // Initialize the counter to zero (no edges incident
-                           // yet)
-    num_unique_clusters++;
+    cluster_weights->Add(graph.template GetData<CurrentCommunityID>(n), 0);
 
     // Assuming we have grabbed lock on all the neighbors
     for (auto e : Edges(graph, n)) {
@@ -109,20 +169,44 @@ struct ClusteringImplementationBase {
       if (dst == n) {
         self_loop_wt += edge_wt;  // Self loop weights is recorded
       }
-      auto stored_already =
-          cluster_local_map.find(graph.template GetData<CurrentCommunityID>(
-              dst));  // Check if it already exists
-      if (stored_already != cluster_local_map.end()) {
-        counter[stored_already->second] += edge_wt;
-      } else {
-        cluster_local_map[graph.template GetData<CurrentCommunityID>(dst)] =
-            num_unique_clusters;
-        counter.push_back(edge_wt);
-        num_unique_clusters++;
-      }
+      cluster_weights->Add(
+          graph.template GetData<CurrentCommunityID>(dst), edge_wt);
     }  // End edge loop
   }
 
+  /**
+   * Node properties of the hot loop of an algorithm packed into one row per
+   * node, so that reading several of them, or the cluster ids of many
+   * neighbors, costs one cache line per node instead of one per property.
+   * Algorithms opt in by gathering the rows before the loop and scattering
+   * the updated properties back after it.
+   */
+  template <typename... Props>
+  using PackedNodeData = katana::PackedPropertyGroup<Props...>;
+
+  /**
+   * FindNeighboringClusters reading the cluster ids from packed node data
+   * that holds CurrentCommunityID.
+   */
+  template <typename EdgeWeightType, typename Packed>
+  static void FindNeighboringClusters(
+      const Graph& graph, const Packed& packed, const GNode& n,
+      ClusterWeightMap<EdgeTy>* cluster_weights, EdgeTy& self_loop_wt) {
+    cluster_weights->Reset(Degree(graph, n) + 1);
+
+    cluster_weights->Add(packed.template Get<CurrentCommunityID>(n), 0);
+
+    for (auto e : Edges(graph, n)) {
+      auto dst = EdgeDst(graph, e);
+      auto edge_wt = graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+      if (dst == n) {
+        self_loop_wt += edge_wt;
+      }
+      cluster_weights->Add(
+          packed.template Get<CurrentCommunityID>(dst), edge_wt);
+    }
+  }
+
   /**
    * Enables the filtering optimization to remove the
    * node with out-degree 0 (isolated) and 1 before the clustering
@@ -161,6 +245,51 @@ struct ClusteringImplementationBase {
     return isolated_nodes.reduce();
   }
 
+  /**
+   * Puts the nodes in the clusters of an earlier run, given by seed_labels,
+   * to start clustering from there after small changes to the graph.
+   * changed_nodes, their neighbors and nodes without a seed label start in
+   * clusters of their own so that they can move; the other clusters stay
+   * together once the graph is coarsened. Cluster ids are renumbered
+   * contiguously.
+   *
+   * @returns the number of clusters
+   */
+  template <typename CommunityIDType>
+  static uint64_t SeedClusters(
+      Graph* graph, const katana::NUMAArray<uint64_t>& seed_labels,
+      const std::vector<uint32_t>& changed_nodes) {
+    katana::NUMAArray<std::atomic<bool>> freed;
+    freed.allocateBlocked(graph->NumNodes());
+    katana::GReduceMax<uint64_t> max_label;
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      freed[n].store(
+          seed_labels[n] == UNASSIGNED, std::memory_order_relaxed);
+      if (seed_labels[n] != UNASSIGNED) {
+        max_label.update(seed_labels[n]);
+      }
+    });
+    katana::do_all(
+        katana::iterate(changed_nodes.begin(), changed_nodes.end()),
+        [&](GNode n) {
+          freed[n].store(true, std::memory_order_relaxed);
+          for (auto e : Edges(*graph, n)) {
+            freed[EdgeDst(*graph, e)].store(true, std::memory_order_relaxed);
+          }
+        },
+        katana::steal());
+
+    // ids past the largest seed label are free for singletons
+    const uint64_t first_singleton_id = max_label.reduce() + 1;
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      graph->template GetData<CommunityIDType>(n) =
+          freed[n].load(std::memory_order_relaxed) ? first_singleton_id + n
+                                                   : seed_labels[n];
+    });
+
+    return RenumberClustersContiguously<CommunityIDType>(graph);
+  }
+
   /**
    * Sums up the degree weight for all
    * the unique clusters.
@@ -274,46 +403,50 @@ struct ClusteringImplementationBase {
   /**
    * Computes the modularity gain of the current cluster assignment
    * without swapping the cluster assignment.
+   *
+   * The gains of all neighboring clusters are computed in one loop over
+   * arrays, which the compiler vectorizes, before the best is picked. Ties
+   * go to the smaller cluster id, so the result does not depend on the
+   * order of the clusters in cluster_weights.
    */
   static uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+      const ClusterWeightMap<EdgeTy>& cluster_weights, uint64_t self_loop_wt,
       CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
-    double cur_gain = 0;
     double max_gain = 0;
-    double eix = counter[0] - self_loop_wt;
+    double eix = cluster_weights.weights()[0] - self_loop_wt;
     double ax = c_info[sc].degree_wt - degree_wt;
-    double eiy = 0;
-    double ay = 0;
-
-    auto stored_already = cluster_local_map.begin();
-    do {
-      if (sc != stored_already->first) {
-        ay = c_info[stored_already->first].degree_wt;  // Degree wt of cluster y
 
-        if (ay < (ax + degree_wt)) {
-          stored_already++;
-          continue;
-        } else if (ay == (ax + degree_wt) && stored_already->first > sc) {
-          stored_already++;
-          continue;
-        }
-
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
-        cur_gain = 2 * constant * (eiy - eix) +
-                   2 * degree_wt * ((ax - ay) * constant * constant);
+    const std::vector<uint64_t>& clusters = cluster_weights.clusters();
+    const std::vector<EdgeTy>& weights = cluster_weights.weights();
+    size_t num_clusters = clusters.size();
+    thread_local std::vector<double> ay;
+    thread_local std::vector<double> gains;
+    ay.resize(num_clusters);
+    gains.resize(num_clusters);
+    for (size_t i = 0; i < num_clusters; ++i) {
+      ay[i] = c_info[clusters[i]].degree_wt;  // Degree wt of cluster y
+    }
+    for (size_t i = 0; i < num_clusters; ++i) {
+      double eiy = weights[i];  // Total edges incident on cluster y
+      gains[i] = 2 * constant * (eiy - eix) +
+                 2 * degree_wt * ((ax - ay[i]) * constant * constant);
+    }
 
-        if ((cur_gain > max_gain) ||
-            ((cur_gain == max_gain) && (cur_gain != 0) &&
-             (stored_already->first < max_index))) {
-          max_gain = cur_gain;
-          max_index = stored_already->first;
-        }
+    for (size_t i = 0; i < num_clusters; ++i) {
+      uint64_t cluster = clusters[i];
+      if (cluster == sc || ay[i] < (ax + degree_wt) ||
+          (ay[i] == (ax + degree_wt) && cluster > sc)) {
+        continue;
       }
-      stored_already++;  // Explore next cluster
-    } while (stored_already != cluster_local_map.end());
+      double cur_gain = gains[i];
+      if ((cur_gain > max_gain) ||
+          ((cur_gain == max_gain) && (cur_gain != 0) &&
+           (cluster < max_index))) {
+        max_gain = cur_gain;
+        max_index = cluster;
+      }
+    }
 
     if ((c_info[max_index].size == 1 && c_info[sc].size == 1 &&
          max_index > sc)) {
@@ -560,28 +693,92 @@ struct ClusteringImplementationBase {
     TimerGraphBuild.start();
 
     const uint64_t num_nodes_next = num_unique_clusters;
+    using Node = katana::GraphTopology::Node;
+    using Edge = katana::GraphTopology::Edge;
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // TODO(amber): This loop can be parallelized when using a concurrent container
-    // for cluster_bags, but something like katana::InsertBag exhausts the
-    // per-thread-storage memory
-    for (GNode n = 0; n < graph.NumNodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        cluster_bags[n_data_curr_comm_id].push_back(n);
-      }
-    }
+    // Group the nodes by cluster with a counting sort: count the members of
+    // each cluster, scatter them to their cluster's range and sort each
+    // range, so the edges of the coarsened graph do not depend on the
+    // number of threads
+    katana::NUMAArray<std::atomic<uint64_t>> cluster_cursor;
+    cluster_cursor.allocateInterleaved(num_unique_clusters);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters),
+        [&](uint64_t c) { cluster_cursor[c].store(0); }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
+          if (n_data_curr_comm_id != UNASSIGNED) {
+            katana::atomicAdd(
+                cluster_cursor[n_data_curr_comm_id], uint64_t{1});
+          }
+        },
+        katana::no_stats());
 
-    std::vector<katana::gstl::Vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<katana::gstl::Vector<EdgeTy>> edges_data(num_unique_clusters);
+    katana::NUMAArray<uint64_t> member_offsets;
+    member_offsets.allocateInterleaved(num_unique_clusters + 1);
+    member_offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters),
+        [&](uint64_t c) {
+          member_offsets[c + 1] = cluster_cursor[c].load();
+          cluster_cursor[c].store(0);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        member_offsets.begin(), member_offsets.end(), member_offsets.begin());
+
+    katana::NUMAArray<GNode> members;
+    members.allocateInterleaved(member_offsets[num_unique_clusters]);
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
+          if (n_data_curr_comm_id != UNASSIGNED) {
+            uint64_t pos = member_offsets[n_data_curr_comm_id] +
+                           cluster_cursor[n_data_curr_comm_id].fetch_add(1);
+            members[pos] = n;
+          }
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_unique_clusters),
+        [&](uint64_t c) {
+          std::sort(
+              members.begin() + member_offsets[c],
+              members.begin() + member_offsets[c + 1]);
+        },
+        katana::steal(), katana::no_stats());
+
+    // Merge the edges of each cluster into a thread-local buffer and
+    // remember where they went, so the edges are only hashed once and
+    // nothing is allocated per cluster
+    struct MergedEdges {
+      std::vector<Node> dsts;
+      std::vector<EdgeTy> weights;
+    };
+    katana::PerThreadStorage<MergedEdges> merged_edges;
+    katana::PerThreadStorage<ClusterWeightMap<EdgeTy>> cluster_weights;
+    katana::NUMAArray<unsigned> merged_owner;
+    merged_owner.allocateInterleaved(num_unique_clusters);
+    katana::NUMAArray<uint64_t> merged_begin;
+    merged_begin.allocateInterleaved(num_unique_clusters);
+
+    katana::NUMAArray<uint64_t> prefix_edges_count;
+    prefix_edges_count.allocateInterleaved(num_unique_clusters);
 
-    /* First pass to find the number of edges */
     katana::do_all(
         katana::iterate(uint64_t{0}, num_unique_clusters),
         [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto node : cluster_bags[c]) {
+          ClusterWeightMap<EdgeTy>* local_weights = cluster_weights.getLocal();
+          size_t max_clusters = 0;
+          for (uint64_t i = member_offsets[c]; i < member_offsets[c + 1]; ++i) {
+            max_clusters += Degree(graph, members[i]);
+          }
+          local_weights->Reset(max_clusters);
+          for (uint64_t i = member_offsets[c]; i < member_offsets[c + 1]; ++i) {
+            GNode node = members[i];
             KATANA_LOG_DEBUG_ASSERT(
                 graph.template GetData<CommunityIDType>(node) ==
                 c);  // All nodes in this bag must have same cluster id
@@ -591,42 +788,32 @@ struct ClusteringImplementationBase {
               auto dst_data_curr_comm_id =
                   graph.template GetData<CommunityIDType>(dst);
               KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
-                num_unique_clusters++;
-              }
+              local_weights->Add(
+                  dst_data_curr_comm_id,
+                  graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
             }  // End edge loop
           }
+
+          MergedEdges* local_edges = merged_edges.getLocal();
+          merged_owner[c] = katana::ThreadPool::getTID();
+          merged_begin[c] = local_edges->dsts.size();
+          local_edges->dsts.insert(
+              local_edges->dsts.end(), local_weights->clusters().begin(),
+              local_weights->clusters().end());
+          local_edges->weights.insert(
+              local_edges->weights.end(), local_weights->weights().begin(),
+              local_weights->weights().end());
+          prefix_edges_count[c] = local_weights->size();
         },
         katana::steal(), katana::loopname("BuildGraph: Find edges"));
 
-    /* Serial loop to reduce all the edge counts */
-    katana::NUMAArray<uint64_t> prefix_edges_count;
-    prefix_edges_count.allocateInterleaved(num_unique_clusters);
-
-    katana::GAccumulator<uint64_t> num_edges_acc;
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
-
-    const uint64_t num_edges_next = num_edges_acc.reduce();
-
     katana::ParallelSTL::partial_sum(
         prefix_edges_count.begin(), prefix_edges_count.end(),
         prefix_edges_count.begin());
+    const uint64_t num_edges_next =
+        num_unique_clusters == 0 ? 0
+                                 : prefix_edges_count[num_unique_clusters - 1];
 
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
     katana::StatTimer TimerConstructFrom("Timer_Construct_From");
     TimerConstructFrom.start();
 
@@ -646,9 +833,6 @@ struct ClusteringImplementationBase {
       }
     }
 
-    using Node = katana::GraphTopology::Node;
-    using Edge = katana::GraphTopology::Edge;
-
     katana::NUMAArray<Node> out_dests_next;
     out_dests_next.allocateInterleaved(num_edges_next);
 
@@ -656,29 +840,23 @@ struct ClusteringImplementationBase {
     edge_data_next.allocateInterleaved(num_edges_next);
 
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t n) {
-          uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t n) {
           uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
-          for (uint64_t k = 0; k < number_of_edges; ++k) {
-            out_dests_next[start_index + k] = edges_id[n][k];
-            edge_data_next[start_index + k] = edges_data[n][k];
-          }
-        });
+          uint64_t number_of_edges = prefix_edges_count[n] - start_index;
+          const MergedEdges& owner_edges =
+              *merged_edges.getRemote(merged_owner[n]);
+          std::copy_n(
+              owner_edges.dsts.begin() + merged_begin[n], number_of_edges,
+              out_dests_next.begin() + start_index);
+          std::copy_n(
+              owner_edges.weights.begin() + merged_begin[n], number_of_edges,
+              edge_data_next.begin() + start_index);
+        },
+        katana::steal(), katana::no_stats());
 
     TimerConstructFrom.stop();
 
-    // TODO(amber): This is a lame attempt at freeing the memory back to each
-    // thread's pool of free pages and blocks. Due to stealing, the execution of
-    // do_all above that populates these containers may be different from the
-    // do_all below that frees them.
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters), [&](uint64_t c) {
-          edges_id[c] = gstl::Vector<uint32_t>();
-          edges_data[c] = gstl::Vector<EdgeTy>();
-        });
-
     GraphTopology topo_next{
         std::move(prefix_edges_count), std::move(out_dests_next)};
     auto pfg_next_res = katana::PropertyGraph::Make(std::move(topo_next));
@@ -741,334 +919,209 @@ struct ClusteringImplementationBase {
     });
   }
 
-  template <typename ValTy>
-  static double GenerateRandonNumber(ValTy min, ValTy max) {
-    std::random_device
-        rd;  // Will be used to obtain a seed for the random number engine
-    std::mt19937 gen(
-        rd());  // Standard mersenne_twister_engine seeded with rd()
-    std::uniform_real_distribution<> dis(
-        min,
-        max);  // distribution in range [min, max]
-    return dis(gen);
+  /// Per thread buffers of RefinePartition
+  struct RefinementBuffers {
+    ClusterWeightMap<EdgeTy> subcomm_weights;
+    std::vector<double> weights;
+  };
+
+  /**
+   * The random priority of node n in the refinement drawn from seed. Nodes
+   * are refined in the order of their priorities.
+   */
+  static uint32_t RefinementPriority(uint64_t seed, GNode n) {
+    return katana::Philox(seed)(n, 0) >> 32;
   }
 
+  /**
+   * Picks the subcommunity for the singleton node n to join among the
+   * subcommunities of its neighbors in its community, given with the total
+   * edge weight from n to each in subcomm_weights. Only subcommunities
+   * whose quality value increment is not negative are considered. With
+   * randomness 0 the largest increment is picked, ties going to the smaller
+   * id; otherwise a subcommunity is picked with a probability proportional
+   * to exp(increment / randomness), drawn from random.
+   *
+   * @returns the subcommunity, or UNASSIGNED to stay a singleton
+   */
   template <typename EdgeWeightType>
-  static uint64_t GetSubcommunity(
-      const Graph& graph, GNode n, CommunityArray& subcomm_info,
-      uint64_t comm_id, double constant_for_second_term, double resolution,
-      std::vector<GNode>& subcomms, std::vector<EdgeWeightType>* counter) {
-    auto& n_current_subcomm_id =
-        graph.template GetData<CurrentSubCommunityID>(n);
-
-    std::vector<GNode> destinations;
-
-    EdgeTy self_loop_wt = 0;
-
-    for (auto e : Edges(graph, n)) {
-      auto dst = EdgeDst(graph, e);
-      // Self loop weights is recorded
-      EdgeWeightType edge_wt =
-          graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-      auto& n_current_comm = graph.template GetData<CurrentCommunityID>(dst);
-      auto& n_current_subcomm =
-          graph.template GetData<CurrentSubCommunityID>(dst);
-
-      if (n_current_comm == comm_id) {
-        if (dst == n) {
-          self_loop_wt += edge_wt;  // Self loop weights is recorded
-          continue;
-        }
-
-        (*counter)[n_current_subcomm] += edge_wt;
-        destinations.push_back(n_current_subcomm);
-      }
-    }  // End edge loop
-
-    uint64_t best_cluster = n_current_subcomm_id;
-    double max_quality_value_increment = -INFINITY_DOUBLE;
-    double quality_value_increment = 0;
-
-    auto& n_degree_wt = graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
-
-    for (auto subcomm : subcomms) {
-      if (n_current_subcomm_id == subcomm || subcomm_info[subcomm].size == 0) {
-        continue;
+  static uint64_t PickSubcommunity(
+      const CommunityArray& subcomm_info, GNode n, EdgeWeightType n_degree_wt,
+      const ClusterWeightMap<EdgeTy>& subcomm_weights,
+      double constant_for_second_term, double resolution, double randomness,
+      katana::PhiloxStream* random, std::vector<double>* weights) {
+    const auto& subcomms = subcomm_weights.clusters();
+    const auto& edge_wts = subcomm_weights.weights();
+    weights->resize(subcomms.size());
+
+    uint64_t best_subcomm = UNASSIGNED;
+    double max_increment = -INFINITY_DOUBLE;
+    for (size_t i = 0; i < subcomms.size(); ++i) {
+      const uint64_t subcomm = subcomms[i];
+      double increment = -INFINITY_DOUBLE;
+      if (subcomm != n &&
+          subcomm_info[subcomm].size.load(std::memory_order_relaxed) > 0) {
+        increment =
+            static_cast<double>(edge_wts[i]) -
+            static_cast<double>(n_degree_wt) *
+                static_cast<double>(subcomm_info[subcomm].degree_wt.load(
+                    std::memory_order_relaxed)) *
+                constant_for_second_term * resolution;
       }
-
-      double subcomm_degree_wt = subcomm_info[subcomm].degree_wt;
-
-      quality_value_increment =
-          (*counter)[subcomm] - (*counter)[n_current_subcomm_id] -
-          n_degree_wt *
-              (subcomm_degree_wt -
-               subcomm_info[n_current_subcomm_id].degree_wt + n_degree_wt) *
-              constant_for_second_term * resolution;
-
-      if (quality_value_increment > max_quality_value_increment) {
-        best_cluster = subcomm;
-        max_quality_value_increment = quality_value_increment;
+      (*weights)[i] = increment;
+      if (increment >= 0 &&
+          (increment > max_increment ||
+           (increment == max_increment && subcomm < best_subcomm))) {
+        best_subcomm = subcomm;
+        max_increment = increment;
       }
-
-      (*counter)[subcomm] = 0;
     }
-
-    bool is_dest_subcomm = false;
-
-    for (auto subcomm : destinations) {
-      if (n_current_subcomm_id == subcomm || subcomm_info[subcomm].size == 0) {
-        continue;
-      }
-
-      double subcomm_degree_wt = subcomm_info[subcomm].degree_wt;
-
-      quality_value_increment =
-          (*counter)[subcomm] - (*counter)[n_current_subcomm_id] -
-          n_degree_wt *
-              (subcomm_degree_wt -
-               subcomm_info[n_current_subcomm_id].degree_wt + n_degree_wt) *
-              constant_for_second_term * resolution;
-
-      if (quality_value_increment > max_quality_value_increment) {
-        best_cluster = subcomm;
-        max_quality_value_increment = quality_value_increment;
-        is_dest_subcomm = true;
-      }
-
-      (*counter)[subcomm] = 0;
+    if (best_subcomm == UNASSIGNED || randomness <= 0) {
+      return best_subcomm;
     }
 
-    if (is_dest_subcomm) {
-      subcomms.push_back(best_cluster);
+    // relative to the largest increment so that exp does not overflow
+    double total_weight = 0;
+    for (double& weight : *weights) {
+      weight = weight >= 0 ? std::exp((weight - max_increment) / randomness)
+                           : 0.0;
+      total_weight += weight;
     }
-
-    for (GNode node : destinations) {
-      (*counter)[node] = 0;
+    double r = random->NextDouble() * total_weight;
+    for (size_t i = 0; i < subcomms.size(); ++i) {
+      r -= (*weights)[i];
+      if (r < 0 && (*weights)[i] > 0) {
+        return subcomms[i];
+      }
     }
-    return best_cluster;
+    return best_subcomm;
   }
 
   /**
- * Finds a clustering of the nodes in a network using the local merging
- * algorithm.
- *
- * <p>
- * The local merging algorithm starts from a singleton partition. It
- * performs a single iteration over the nodes in a network. Each node
- * belonging to a singleton cluster is considered for merging with another
- * cluster. This cluster is chosen randomly from all clusters that do not
- * result in a decrease in the quality function. The larger the increase in
- * the quality function, the more likely a cluster is to be chosen. The
- * strength of this effect is determined by the randomness parameter. The
- * higher the value of the randomness parameter, the stronger the
- * randomness in the choice of a cluster. The lower the value of the
- * randomness parameter, the more likely the cluster resulting in the
- * largest increase in the quality function is to be chosen. A node is
- * merged with a cluster only if both are sufficiently well connected to
- * the rest of the network.
- * </p>
- *
- * @param
- *
- * @return : Number of unique subcommunities formed
- * DO NOT parallelize as it is called within Galois parallel loops
- *
- */
+   * Moves the singleton node n into subcomm without locking. n leaves its
+   * subcommunity by taking its size from 1 to 0, which fails if another
+   * node joined it meanwhile, and joins subcomm by incrementing its size
+   * only while it is not 0. A node therefore never joins a subcommunity
+   * whose nodes all left nor leaves one that was joined, and every
+   * subcommunity stays connected.
+   *
+   * @returns whether n moved
+   */
   template <typename EdgeWeightType>
-  static void MergeNodesSubset(
-      Graph* graph, std::vector<GNode>& cluster_nodes, uint64_t comm_id,
-      CommunityArray& subcomm_info,
-      katana::NUMAArray<std::atomic<double>>& constant_for_second_term,
-      double resolution) {
-    for (GNode i = 0; i < cluster_nodes.size(); ++i) {
-      GNode n = cluster_nodes[i];
-      const auto& n_degree_wt =
-          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
-      const auto& n_node_wt = graph->template GetData<NodeWeight>(n);
-      /*
-     * Initialize with singleton sub-communities
-     */
-      EdgeWeightType node_edge_weight_within_cluster = 0;
-      uint64_t num_edges_within_cluster = 0;
-
-      for (auto e : Edges(*graph, n)) {
-        auto dst = EdgeDst(*graph, e);
-        EdgeWeightType edge_wt =
-            graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-        /*
-       * Must include the edge weight of all neighbors excluding self loops
-       * belonging to the community comm_id
-       */
-        if (dst != n &&
-            graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
-          node_edge_weight_within_cluster += edge_wt;
-          num_edges_within_cluster++;
-        }
-      }
-
-      uint64_t node_wt = n_node_wt;
-      uint64_t degree_wt = n_degree_wt;
-      /*
-     * Additionally, only nodes that are well connected with
-     * the rest of the network are considered for moving.
-     * (externalEdgeWeightPerCluster[j] >= clusterWeights[j] * (totalNodeWeight
-     * - clusterWeights[j]) * resolution
-     */
-
-      subcomm_info[n].node_wt = node_wt;
-      subcomm_info[n].internal_edge_wt = node_edge_weight_within_cluster;
-      subcomm_info[n].num_internal_edges = num_edges_within_cluster;
-      subcomm_info[n].size = 1;
-      subcomm_info[n].degree_wt = degree_wt;
+  static bool TryJoinSubcommunity(
+      CommunityArray* subcomm_info, GNode n, uint64_t subcomm,
+      uint64_t n_node_wt, EdgeWeightType n_degree_wt) {
+    auto& own_info = (*subcomm_info)[n];
+    uint64_t singleton = 1;
+    if (!own_info.size.compare_exchange_strong(singleton, 0)) {
+      return false;
     }
+    auto& info = (*subcomm_info)[subcomm];
+    uint64_t size = info.size.load();
+    do {
+      if (size == 0) {
+        // nobody joins an empty subcommunity, so n can take its own back
+        own_info.size.store(1);
+        return false;
+      }
+    } while (!info.size.compare_exchange_weak(size, size + 1));
 
-    std::vector<GNode> subcomms;
-
-    std::vector<EdgeWeightType> counter(graph->size(), 0);
-
-    for (GNode n : cluster_nodes) {
-      const auto& n_degree_wt =
-          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
-      const auto& n_node_wt = graph->template GetData<NodeWeight>(n);
-      auto& n_current_subcomm_id =
-          graph->template GetData<CurrentSubCommunityID>(n);
-      /*
-     * Only consider singleton communities
-     */
-      if (subcomm_info[n_current_subcomm_id].size == 1) {
-        uint64_t new_subcomm_ass = GetSubcommunity<EdgeWeightType>(
-            *graph, n, subcomm_info, comm_id, constant_for_second_term[comm_id],
-            resolution, subcomms, &counter);
-        if (new_subcomm_ass != UNASSIGNED &&
-            new_subcomm_ass != n_current_subcomm_id) {
-          /*
-         * Move the currently selected node to its new cluster and
-         * update the clustering statistics.
-         */
-          katana::atomicAdd(subcomm_info[new_subcomm_ass].node_wt, n_node_wt);
-          katana::atomicAdd(subcomm_info[new_subcomm_ass].size, uint64_t{1});
-          katana::atomicAdd(
-              subcomm_info[new_subcomm_ass].degree_wt, n_degree_wt);
-
-          katana::atomicSub(
-              subcomm_info[n_current_subcomm_id].node_wt, n_node_wt);
-          katana::atomicSub(
-              subcomm_info[n_current_subcomm_id].size, uint64_t{1});
-          katana::atomicSub(
-              subcomm_info[n_current_subcomm_id].degree_wt, n_degree_wt);
-
-          for (auto e : Edges(*graph, n)) {
-            auto dst = EdgeDst(*graph, e);
-            auto edge_wt =
-                graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-            if (dst != n &&
-                graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
-              if (graph->template GetData<CurrentSubCommunityID>(dst) ==
-                  new_subcomm_ass) {
-                subcomm_info[new_subcomm_ass].internal_edge_wt -= edge_wt;
-                subcomm_info[new_subcomm_ass].num_internal_edges--;
-              } else {
-                subcomm_info[new_subcomm_ass].internal_edge_wt += edge_wt;
-                subcomm_info[new_subcomm_ass].num_internal_edges++;
-              }
-            }  //end outer if
-
-            if (dst != n &&
-                graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
-              if (graph->template GetData<CurrentSubCommunityID>(dst) ==
-                  n_current_subcomm_id) {
-                subcomm_info[n_current_subcomm_id].internal_edge_wt += edge_wt;
-                subcomm_info[n_current_subcomm_id].num_internal_edges++;
-              } else {
-                subcomm_info[n_current_subcomm_id].internal_edge_wt -= edge_wt;
-                subcomm_info[n_current_subcomm_id].num_internal_edges--;
-              }
-            }  //end outer if
-          }
-        }  //end for
-
-        n_current_subcomm_id = new_subcomm_ass;
-      }  // end outer if
-    }
+    katana::atomicAdd(info.node_wt, n_node_wt);
+    katana::atomicAdd(info.degree_wt, n_degree_wt);
+    katana::atomicSub(own_info.node_wt, n_node_wt);
+    katana::atomicSub(own_info.degree_wt, n_degree_wt);
+    return true;
   }
 
   /*
  * Refine the clustering by iterating over the clusters and by
  * trying to split up each cluster into multiple clusters.
+ *
+ * Every node starts in a singleton subcommunity. The nodes of all clusters
+ * are visited together in parallel, in the order of random priorities
+ * drawn from seed, and a node still alone in its subcommunity joins the one
+ * picked by PickSubcommunity. Subcommunities are only updated with atomics
+ * by TryJoinSubcommunity, so a large cluster is refined by all threads
+ * rather than one. With one thread the result only depends on seed.
  */
   template <typename EdgeWeightType>
-  static void RefinePartition(Graph* graph, double resolution) {
+  static void RefinePartition(
+      Graph* graph, double resolution, double randomness, uint64_t seed) {
     // set singleton subcommunities
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
       graph->template GetData<CurrentSubCommunityID>(n) = n;
     });
 
-    // populate nodes into communities
-    std::vector<std::vector<GNode>> cluster_bags(graph->size());
-    CommunityArray comm_info;
-
-    comm_info.allocateBlocked(graph->size());
-
-    katana::do_all(katana::iterate(size_t{0}, (graph->size())), [&](size_t n) {
-      comm_info[n].node_wt = 0ull;
-      comm_info[n].degree_wt = 0ull;
-    });
-
-    //TODO (gill): Can be parallelized using do_all.
-    for (GNode n : *graph) {
-      const auto& n_current_comm =
-          graph->template GetData<CurrentCommunityID>(n);
-      const auto& n_node_wt = graph->template GetData<NodeWeight>(n);
-      const auto& n_degree_wt =
-          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
-      if (n_current_comm != UNASSIGNED) {
-        cluster_bags[n_current_comm].push_back(n);
-
-        katana::atomicAdd(comm_info[n_current_comm].node_wt, n_node_wt);
-        katana::atomicAdd(comm_info[n_current_comm].degree_wt, n_degree_wt);
-      }
-    }
-
-    uint64_t total = 0;
-    for (size_t n = 0; n < graph->size(); ++n) {
-      total += cluster_bags[n].size();
-    }
-
-    CommunityArray subcomm_info;
-
-    subcomm_info.allocateBlocked(graph->size());
-
     SumVertexDegreeWeightCommunity<EdgeWeightType>(graph);
 
     katana::NUMAArray<std::atomic<double>> comm_constant_term;
-
     comm_constant_term.allocateBlocked(graph->size());
-
     CalConstantForSecondTerm<EdgeWeightType>(*graph, &comm_constant_term);
 
-    // call MergeNodesSubset for each community in parallel
+    CommunityArray subcomm_info;
+    subcomm_info.allocateBlocked(graph->size());
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      const bool assigned =
+          graph->template GetData<CurrentCommunityID>(n) != UNASSIGNED;
+      subcomm_info[n].size = assigned ? 1 : 0;
+      subcomm_info[n].node_wt = graph->template GetData<NodeWeight>(n);
+      subcomm_info[n].degree_wt =
+          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+    });
+
+    katana::NUMAArray<GNode> order;
+    order.allocateBlocked(graph->size());
+    katana::ParallelSTL::iota(order.begin(), order.end(), GNode{0});
+    katana::ParallelSTL::radix_sort(
+        order.begin(), order.end(),
+        [&](GNode n) { return RefinementPriority(seed, n); });
+
+    katana::PerThreadStorage<RefinementBuffers> buffers;
     katana::do_all(
-        katana::iterate(size_t{0}, graph->size()),
-        [&](size_t c) {
+        katana::iterate(order.begin(), order.end()),
+        [&](GNode n) {
+          const uint64_t comm_id =
+              graph->template GetData<CurrentCommunityID>(n);
           /*
-                    * Only nodes belonging to singleton clusters can be moved to
-                    * a different cluster. This guarantees that clusters will
-                    * never be split up.
-                    */
-          comm_info[c].num_sub_communities = 0;
-          if (cluster_bags[c].size() > 1) {
-            MergeNodesSubset<EdgeWeightType>(
-                graph, cluster_bags[c], c, subcomm_info, comm_constant_term,
-                resolution);
+           * Only nodes of singleton subcommunities move. This guarantees
+           * that clusters are never split up.
+           */
+          if (comm_id == UNASSIGNED ||
+              subcomm_info[n].size.load(std::memory_order_relaxed) != 1) {
+            return;
           }
-        },
-        katana::steal());
 
-    subcomm_info.deallocate();
-    subcomm_info.destroy();
+          RefinementBuffers* local = buffers.getLocal();
+          local->subcomm_weights.Reset(Degree(*graph, n));
+          for (auto e : Edges(*graph, n)) {
+            auto dst = EdgeDst(*graph, e);
+            if (dst != n &&
+                graph->template GetData<CurrentCommunityID>(dst) == comm_id) {
+              local->subcomm_weights.Add(
+                  graph->template GetData<CurrentSubCommunityID>(dst),
+                  graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
+            }
+          }
+          if (local->subcomm_weights.size() == 0) {
+            return;
+          }
 
-    comm_constant_term.deallocate();
-    comm_constant_term.destroy();
+          // step 0 of n is its priority
+          katana::PhiloxStream random = katana::Philox(seed).ForNode(n, 1);
+          const auto n_degree_wt =
+              graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+          const uint64_t subcomm = PickSubcommunity<EdgeWeightType>(
+              subcomm_info, n, n_degree_wt, local->subcomm_weights,
+              comm_constant_term[comm_id], resolution, randomness, &random,
+              &local->weights);
+          if (subcomm != UNASSIGNED &&
+              TryJoinSubcommunity<EdgeWeightType>(
+                  &subcomm_info, n, subcomm,
+                  graph->template GetData<NodeWeight>(n), n_degree_wt)) {
+            graph->template GetData<CurrentSubCommunityID>(n) = subcomm;
+          }
+        },
+        katana::steal(), katana::loopname("Leiden_Refine"));
   }
 
   template <typename EdgeWeightType>
@@ -0,0 +1,110 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_HUBBITMAPS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_HUBBITMAPS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/RDGTopology.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Neighborhoods of the highest-degree nodes of a graph as dense bitmaps of
+/// one bit per node, so that intersecting a sorted set with the neighbors of
+/// a hub costs one probe per element of the set, whatever the degree of the
+/// hub. Build one next to a view with OutEdgeDsts, e.g.,
+/// PGViewNodesSortedByDegreeEdgesSortedByDestID, and share it between the
+/// intersections of triangle counting, clustering coefficients or k-truss.
+///
+/// Each hub costs NumNodes() / 8 bytes. Make takes hubs in order of
+/// decreasing degree while they fit in a byte budget, skipping nodes of
+/// degree below kMinHubDegree, for which merging is as fast.
+class KATANA_EXPORT HubBitmaps {
+public:
+  using Node = katana::RDGTopology::Node;
+
+  constexpr static size_t kMinHubDegree = 256;
+
+  HubBitmaps() = default;
+
+  /// Build bitmaps for the hubs of graph that fit in budget_bytes
+  template <typename Graph>
+  static HubBitmaps Make(const Graph& graph, size_t budget_bytes);
+
+  /// \returns the neighbors of node as a bitmap, or nullptr if node is not a
+  /// hub
+  const uint64_t* Find(Node node) const {
+    if (!IsMarked(node)) {
+      return nullptr;
+    }
+    return bits_.data() + FindSlot(node) * words_per_hub_;
+  }
+
+  static bool Contains(const uint64_t* bitmap, Node x) {
+    return bitmap[x / 64] >> (x % 64) & 1;
+  }
+
+  /// \returns the number of elements of b in bitmap
+  static size_t CountIntersection(
+      const uint64_t* bitmap, const Node* b, size_t b_size);
+
+  size_t num_hubs() const { return hubs_.size(); }
+
+  /// Bytes used by the bitmaps and the index of hubs
+  size_t size_bytes() const {
+    return (bits_.size() + marks_.size()) * sizeof(uint64_t) +
+           hubs_.size() * sizeof(Node);
+  }
+
+private:
+  /// Pick the hubs given the degree of every node and size the bitmaps
+  void Allocate(const std::vector<uint64_t>& degrees, size_t budget_bytes);
+
+  bool IsMarked(Node node) const {
+    size_t word = node / 64;
+    return word < marks_.size() && (marks_[word] >> (node % 64) & 1);
+  }
+
+  size_t FindSlot(Node node) const;
+
+  /// hubs in increasing order
+  std::vector<Node> hubs_;
+  /// one bit per node, set for hubs
+  std::vector<uint64_t> marks_;
+  /// words_per_hub_ words for each hub in the order of hubs_
+  std::vector<uint64_t> bits_;
+  size_t words_per_hub_{0};
+};
+
+template <typename Graph>
+HubBitmaps
+HubBitmaps::Make(const Graph& graph, size_t budget_bytes) {
+  HubBitmaps ret;
+  if (budget_bytes == 0 || graph.NumNodes() == 0) {
+    return ret;
+  }
+
+  std::vector<uint64_t> degrees(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) { degrees[n] = graph.OutDegree(n); }, katana::no_stats());
+  ret.Allocate(degrees, budget_bytes);
+
+  // hubs own disjoint rows
+  katana::do_all(
+      katana::iterate(size_t{0}, ret.hubs_.size()),
+      [&](size_t slot) {
+        uint64_t* row = ret.bits_.data() + slot * ret.words_per_hub_;
+        for (Node dst : graph.OutEdgeDsts(ret.hubs_[slot])) {
+          row[dst / 64] |= uint64_t{1} << (dst % 64);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return ret;
+}
+
+}  // namespace katana::analytics
+
+#endif
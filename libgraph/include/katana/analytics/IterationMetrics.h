@@ -0,0 +1,70 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_ITERATIONMETRICS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_ITERATIONMETRICS_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "katana/ProgressTracer.h"
+#include "katana/Time.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// What one iteration of an iterative analytic did
+struct KATANA_EXPORT IterationMetrics {
+  /// The analytic and algorithm, e.g., "pagerank_pull_topological"
+  std::string analytic;
+  /// The number of the iteration, counting from 1
+  uint32_t iteration{0};
+  /// How far the analytic got, in its own terms: the total change of the
+  /// ranks of PageRank, the modularity of clustering, the labels changed by
+  /// CDLP, the nodes removed by k-core and, for SSSP, the distance reached
+  /// or the distances changed
+  double convergence{0};
+  /// The nodes the iteration worked on
+  uint64_t active_nodes{0};
+  /// The work items of the iteration, usually edges visited
+  uint64_t work_items{0};
+  /// The time the iteration took, in microseconds
+  uint64_t time_us{0};
+};
+
+/// Receives the metrics of every iteration as it ends
+using IterationObserver = std::function<void(const IterationMetrics&)>;
+
+/// Pass the metrics of the iterations of every analytic run from now on to
+/// observer, on top of logging them to the progress tracer. An empty
+/// observer removes the current one.
+KATANA_EXPORT void SetIterationObserver(IterationObserver observer);
+
+/// Reports the iterations of one run of an analytic, each as an "iteration"
+/// log of a span named after the analytic and to the IterationObserver, if
+/// one is set. The span is active while the reporter lives.
+///
+///   IterationReporter reporter("cdlp_synchronous");
+///   while (...) {
+///     ...
+///     reporter.Report(iteration, changed, active, edges);
+///   }
+class KATANA_EXPORT IterationReporter {
+public:
+  explicit IterationReporter(std::string analytic);
+  IterationReporter(const IterationReporter&) = delete;
+  IterationReporter& operator=(const IterationReporter&) = delete;
+
+  /// Report the iteration that ended now, and started when the previous
+  /// one ended or the reporter was made
+  void Report(
+      uint32_t iteration, double convergence, uint64_t active_nodes,
+      uint64_t work_items);
+
+private:
+  std::string analytic_;
+  ProgressScope scope_;
+  TimePoint last_;
+};
+
+}  // namespace katana::analytics
+
+#endif
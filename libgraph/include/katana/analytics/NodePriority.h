@@ -0,0 +1,49 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_NODEPRIORITY_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_NODEPRIORITY_H_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+
+namespace katana::analytics {
+
+/// \returns a hash of node id n for breaking ties between nodes of equal
+/// priority. The hash is a bijection, so distinct nodes never share a hash.
+inline uint32_t
+NodePriorityHash(uint32_t n) {
+  n = ((n >> 16) ^ n) * 0x45d9f3b;
+  n = ((n >> 16) ^ n) * 0x45d9f3b;
+  return (n >> 16) ^ n;
+}
+
+/// \returns the largest-degree-first priority of node n of degree degree.
+/// Nodes of larger degree have higher priorities and distinct nodes have
+/// distinct priorities, so of two neighbors exactly one goes first.
+inline uint64_t
+DegreePriority(uint64_t degree, uint32_t n) {
+  uint64_t clamped = std::min<uint64_t>(degree, UINT32_MAX);
+  return clamped << 32 | NodePriorityHash(n);
+}
+
+/// \returns the DegreePriority of every node of graph by out-degree. The
+/// priorities are computed once, so rounds of an algorithm compare them
+/// instead of hashing again.
+template <typename Graph>
+katana::NUMAArray<uint64_t>
+DegreePriorities(const Graph& graph) {
+  katana::NUMAArray<uint64_t> priorities;
+  priorities.allocateBlocked(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](typename Graph::Node n) {
+        priorities[n] = DegreePriority(graph.OutDegree(n), n);
+      },
+      katana::no_stats());
+  return priorities;
+}
+
+}  // namespace katana::analytics
+
+#endif
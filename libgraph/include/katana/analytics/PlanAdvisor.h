@@ -0,0 +1,112 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PLANADVISOR_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PLANADVISOR_H_
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace katana::analytics {
+
+/// Cheap statistics of the topology of a graph that decide which plan of an
+/// analytic runs fastest on it
+struct KATANA_EXPORT GraphProfile {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  double average_degree{0};
+  uint64_t max_degree{0};
+  /// Standard deviation of the out-degrees over their mean; about 1 or less
+  /// for meshes and uniform random graphs, well above for power-law graphs
+  double degree_skew{0};
+  /// See IsApproximateDegreeDistributionPowerLaw
+  bool is_power_law{false};
+  /// Edges over the number of ordered pairs of distinct nodes
+  double density{0};
+  /// A lower bound on the diameter by a double sweep of BFS from the node of
+  /// maximum degree, counted in hops along out-edges
+  uint64_t approximate_diameter{0};
+
+  /// \returns true if the diameter is large for the size of the graph, as in
+  /// meshes and road networks, where traversals take many small rounds
+  bool IsHighDiameter() const;
+
+  /// Print the profile in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Picks the algorithm and parameters of an analytic from the profile of a
+/// graph, instead of the fixed defaults of the plans. The profile is
+/// computed once, by the first call that needs it, and reused by every
+/// later call, so keep one advisor per graph for as long as its topology
+/// does not change. The graph must outlive the advisor.
+///
+///   PlanAdvisor advisor(pg);
+///   KATANA_CHECKED(Bfs(pg, source, "bfs", &txn_ctx, advisor.Bfs()));
+///   KATANA_CHECKED(ConnectedComponents(
+///       pg, "cc", &txn_ctx, true, advisor.ConnectedComponents()));
+class KATANA_EXPORT PlanAdvisor {
+public:
+  /// Graphs with fewer nodes run the serial algorithms, whose setup is
+  /// cheaper than that of the parallel ones
+  constexpr static uint64_t kSerialMaxNodes = 4096;
+  /// The diameter is high if it is above this many times log2 of the nodes
+  constexpr static double kHighDiameterFactor = 2.0;
+  /// Degree skew above which edges, not nodes, are the unit of work
+  constexpr static double kSkewedDegree = 4.0;
+  /// The most bytes of hub bitmaps triangle counting gets
+  constexpr static size_t kMaxHubBitmapBytes = size_t{64} << 20;
+
+  explicit PlanAdvisor(const PropertyGraph* pg) : pg_(pg) {}
+
+  /// \returns the profile of the graph, computing it on the first call
+  const GraphProfile& Profile();
+
+  /// Direction optimization on low-diameter graphs, whose frontiers grow to
+  /// most of the graph in a few rounds; asynchronous tiles on the others,
+  /// whose many small frontiers would each cost a barrier.
+  BfsPlan Bfs();
+
+  /// Serial union-find on tiny graphs, Afforest on the others, with edge
+  /// tiles when a few nodes hold most of the edges. The graph is expected to
+  /// be symmetric.
+  ConnectedComponentsPlan ConnectedComponents();
+
+  /// Ordered counting, with relabeling and hub bitmaps on power-law graphs,
+  /// where sorting by degree bounds the work per edge, and neither on the
+  /// others, where they do not pay for their setup.
+  TriangleCountPlan TriangleCount();
+
+  /// Propagation blocking when the ranks do not fit in the last-level cache,
+  /// otherwise topological pull on low-diameter graphs and asynchronous push
+  /// on the others, where residuals settle locally.
+  PagerankPlan Pagerank(
+      float tolerance = PagerankPlan::kDefaultTolerance,
+      unsigned int max_iterations = PagerankPlan::kDefaultMaxIterations,
+      float alpha = PagerankPlan::kDefaultAlpha);
+
+  /// Delta stepping on power-law graphs and adaptive delta stepping on the
+  /// others, with a step of about the largest weight over the average
+  /// degree. The weights are taken from edge_weight_property_name, which may
+  /// be of any numeric type.
+  Result<SsspPlan> Sssp(const std::string& edge_weight_property_name);
+
+private:
+  /// The edge tile size of the tiled algorithms: enough edges per tile to
+  /// amortize scheduling, and more on denser graphs
+  ptrdiff_t EdgeTileSize();
+
+  const PropertyGraph* pg_;
+  std::optional<GraphProfile> profile_;
+};
+
+}  // namespace katana::analytics
+
+#endif
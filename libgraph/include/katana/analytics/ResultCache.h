@@ -0,0 +1,138 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_RESULTCACHE_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_RESULTCACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/TxnContext.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Everything that determines the result of a call of an analytic besides
+/// the graph: the analytic, the parameters of its plan and its other
+/// arguments, and the properties it reads. Parameters are compared by their
+/// formatted values.
+///
+/// \code
+/// ResultKey key = ResultKey("sssp")
+///                     .Parameter("start", start_node)
+///                     .Parameter("delta", plan.delta())
+///                     .EdgeInput(weight_name);
+/// \endcode
+class KATANA_EXPORT ResultKey {
+public:
+  explicit ResultKey(std::string analytic) : analytic_(std::move(analytic)) {}
+
+  template <typename T>
+  ResultKey& Parameter(const std::string& name, const T& value) {
+    parameters_.emplace_back(fmt::format("{}={}", name, value));
+    return *this;
+  }
+
+  ResultKey& NodeInput(const std::string& name) {
+    node_inputs_.emplace_back(name);
+    return *this;
+  }
+
+  ResultKey& EdgeInput(const std::string& name) {
+    edge_inputs_.emplace_back(name);
+    return *this;
+  }
+
+  const std::vector<std::string>& node_inputs() const { return node_inputs_; }
+  const std::vector<std::string>& edge_inputs() const { return edge_inputs_; }
+
+  /// The whole key as one string, which two keys share only if they are
+  /// the same
+  std::string ToString() const;
+
+private:
+  std::string analytic_;
+  std::vector<std::string> parameters_;
+  std::vector<std::string> node_inputs_;
+  std::vector<std::string> edge_inputs_;
+};
+
+/// An opt-in cache of the node properties that analytics compute, so that
+/// running an analytic again on a graph that did not change reuses the
+/// column it computed before instead of computing it again.
+///
+/// A result is kept for the RDG of the graph at its CurrentVersion(), with
+/// the committed version (see TxnContext::CommittedNodePropertyVersion) of
+/// every input property when it was computed. A transaction that commits a
+/// write to an input thus invalidates the result, as does a new version of
+/// the RDG. Graphs that are not stored in an RDG, and transactions that
+/// wrote an input or the topology themselves, always compute.
+///
+/// Cached columns are shared with the properties they were stored from and
+/// copied into; PropertyGraph copies shared columns before patching them,
+/// so cached results do not change. The least recently used results are
+/// dropped beyond max_entries. Safe to use from several threads; two
+/// threads that miss on the same key both compute.
+///
+/// \code
+/// ResultCache cache;
+/// KATANA_CHECKED(cache.Run(
+///     pg, ResultKey("pagerank").Parameter("tolerance", plan.tolerance()),
+///     "rank", txn_ctx, [&](const std::string& output) {
+///       return Pagerank(pg, output, txn_ctx, plan);
+///     }));
+/// \endcode
+class KATANA_EXPORT ResultCache {
+public:
+  constexpr static size_t kDefaultMaxEntries = 64;
+
+  /// Computes node property output of the graph, which must not exist yet
+  using ComputeFn = std::function<Result<void>(const std::string& output)>;
+
+  explicit ResultCache(size_t max_entries = kDefaultMaxEntries)
+      : max_entries_(max_entries) {}
+
+  /// Add node property \p output to \p pg, with the result cached for
+  /// \p key if there is one and computed by \p compute otherwise
+  Result<void> Run(
+      PropertyGraph* pg, const ResultKey& key, const std::string& output,
+      TxnContext* txn_ctx, const ComputeFn& compute);
+
+  void Clear();
+
+  size_t size() const;
+
+  /// The calls that reused a cached result
+  uint64_t hits() const;
+
+  /// The calls that computed their result, including uncacheable ones
+  uint64_t misses() const;
+
+private:
+  struct Entry {
+    std::string key;
+    std::vector<uint64_t> input_versions;
+    std::shared_ptr<arrow::ChunkedArray> column;
+  };
+  using EntryList = std::list<Entry>;
+
+  mutable std::mutex mutex_;
+  size_t max_entries_;
+  /// most recently used first
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SAMPLING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_SAMPLING_H_
+
+#include <cmath>
+#include <cstdint>
+
+#include "katana/Random.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Standard errors on each side of a two-sided 95% confidence interval
+constexpr double kZ95 = 1.959963984540054;
+
+/// A quantity estimated from a random sample
+struct Estimate {
+  double value{0};
+  /// Standard error of value, 0 when value is exact
+  double std_error{0};
+
+  /// \returns the lower end of the confidence interval of z standard errors
+  double Lower(double z = kZ95) const { return value - z * std_error; }
+  /// \returns the upper end of the confidence interval of z standard errors
+  double Upper(double z = kZ95) const { return value + z * std_error; }
+};
+
+/// \returns a key for SampleUnit drawn from a generator seeded with seed
+inline uint64_t
+SamplingKey(uint32_t seed) {
+  auto [gen, used_seed] = katana::CreateGenerator(katana::Seed{seed});
+  uint64_t hi = gen();
+  return hi << 32 | gen();
+}
+
+/// \returns 64 uniform bits for item i of the sample of key, e.g., the key
+/// of a sample nested in item i. Samples drawn this way depend only on the
+/// key and the item, not on which thread draws them or when, so parallel
+/// sampling stays reproducible.
+inline uint64_t
+SampleBits(uint64_t key, uint64_t i) {
+  // splitmix64 finalizer
+  uint64_t z = key + (i + 1) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/// \returns a uniform number in [0, 1) for item i of the sample of key
+inline double
+SampleUnit(uint64_t key, uint64_t i) {
+  return static_cast<double>(SampleBits(key, i) >> 11) * 0x1.0p-53;
+}
+
+/// \returns the number of samples that bounds the error of an estimated
+/// proportion by max_error at the confidence of z standard errors, whatever
+/// the proportion
+inline uint64_t
+SamplesForError(double max_error, double z = kZ95) {
+  return static_cast<uint64_t>(
+      std::ceil(z * z * 0.25 / (max_error * max_error)));
+}
+
+}  // namespace katana::analytics
+
+#endif
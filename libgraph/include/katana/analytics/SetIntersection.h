@@ -0,0 +1,182 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SETINTERSECTION_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_SETINTERSECTION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/RDGTopology.h"
+#include "katana/Range.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Elements of the sets, node ids of the width chosen at build time
+using SetElement = katana::RDGTopology::Node;
+
+/// Intersections of sorted sets of node ids, such as the out-edge
+/// destinations of a view with edges sorted by destination (see
+/// OutEdgeDsts). Sets must be strictly increasing; with parallel edges,
+/// which duplicates are counted depends on the kernel used.
+///
+/// When one set is at least kGallopRatio times larger than the other, the
+/// elements of the smaller set are searched for in the larger one with
+/// exponential search. Otherwise the sets are merged, 16 or 8 elements at a
+/// time with AVX-512 or AVX2 when the processor has them and node ids are 32
+/// bits.
+constexpr size_t kGallopRatio = 32;
+
+/// \returns the number of elements in both a and b
+KATANA_EXPORT size_t CountIntersection(
+    const SetElement* a, size_t a_size, const SetElement* b, size_t b_size);
+
+inline size_t
+CountIntersection(
+    const katana::StandardRange<const SetElement*>& a,
+    const katana::StandardRange<const SetElement*>& b) {
+  return CountIntersection(
+      a.begin(), a.end() - a.begin(), b.begin(), b.end() - b.begin());
+}
+
+namespace internal {
+
+/// \returns the first position at or after begin of an element of a that is
+/// not less than x
+inline size_t
+GallopTo(const SetElement* a, size_t begin, size_t size, SetElement x) {
+  size_t step = 1;
+  size_t lo = begin;
+  size_t hi = begin;
+  while (hi < size && a[hi] < x) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  if (hi > size) {
+    hi = size;
+  }
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (a[mid] < x) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <typename F>
+bool
+CallForMatch(F& fn, size_t i, size_t j) {
+  using Result = std::invoke_result_t<F&, size_t, size_t>;
+  if constexpr (std::is_same_v<Result, bool>) {
+    return fn(i, j);
+  } else {
+    fn(i, j);
+    return true;
+  }
+}
+
+}  // namespace internal
+
+/// Call fn(i, j) for each pair of positions with a[i] == b[j], in increasing
+/// order. If fn returns bool, stop at the first false.
+template <typename F>
+void
+ForEachIntersection(
+    const SetElement* a, size_t a_size, const SetElement* b, size_t b_size,
+    F fn) {
+  if (a_size == 0 || b_size == 0) {
+    return;
+  }
+  if (b_size / a_size >= kGallopRatio || a_size / b_size >= kGallopRatio) {
+    bool a_smaller = a_size < b_size;
+    const SetElement* small = a_smaller ? a : b;
+    const SetElement* large = a_smaller ? b : a;
+    size_t small_size = a_smaller ? a_size : b_size;
+    size_t large_size = a_smaller ? b_size : a_size;
+    size_t pos = 0;
+    for (size_t s = 0; s < small_size; ++s) {
+      pos = internal::GallopTo(large, pos, large_size, small[s]);
+      if (pos == large_size) {
+        return;
+      }
+      if (large[pos] == small[s]) {
+        bool more = a_smaller ? internal::CallForMatch(fn, s, pos)
+                              : internal::CallForMatch(fn, pos, s);
+        if (!more) {
+          return;
+        }
+        ++pos;
+      }
+    }
+    return;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (!internal::CallForMatch(fn, i, j)) {
+        return;
+      }
+      ++i;
+      ++j;
+    }
+  }
+}
+
+template <typename F>
+void
+ForEachIntersection(
+    const katana::StandardRange<const SetElement*>& a,
+    const katana::StandardRange<const SetElement*>& b, F fn) {
+  ForEachIntersection(
+      a.begin(), a.end() - a.begin(), b.begin(), b.end() - b.begin(),
+      std::move(fn));
+}
+
+/// Membership bitmap of one set, for intersecting the neighbors of a hub
+/// node with many small sets in time proportional to the small sets only
+class KATANA_EXPORT DenseSet {
+public:
+  /// Make the set a; it must be cleared with Clear before the next Assign.
+  /// Bits are allocated for ids up to the largest element.
+  void Assign(const SetElement* a, size_t a_size);
+
+  void Assign(const katana::StandardRange<const SetElement*>& a) {
+    Assign(a.begin(), a.end() - a.begin());
+  }
+
+  /// Empty the set, in time proportional to its size
+  void Clear();
+
+  bool Contains(SetElement x) const {
+    size_t word = x / 64;
+    return word < bits_.size() && (bits_[word] >> (x % 64) & 1);
+  }
+
+  /// \returns the number of elements of b in the set
+  size_t CountIntersection(const SetElement* b, size_t b_size) const;
+
+  size_t CountIntersection(
+      const katana::StandardRange<const SetElement*>& b) const {
+    return CountIntersection(b.begin(), b.end() - b.begin());
+  }
+
+private:
+  std::vector<uint64_t> bits_;
+  const SetElement* elements_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SPMV_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_SPMV_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+/// Sparse matrix times dense vector (SpMV) and dense matrix (SpMM) products
+/// over a graph, in the style of GraphBLAS: the graph is the matrix A, with
+/// A(u, v) the weight of the edge (u, v), and the products are over a
+/// semiring, so the same loops compute sums of weighted neighbor values,
+/// shortest path relaxations or reachability.
+///
+/// A semiring is a type with
+///
+///   using value_type = T;
+///   static T Zero();             // identity of Add, and the value of an
+///                                // empty sum
+///   static T One();              // identity of Multiply, the weight of
+///                                // unweighted edges
+///   static T Add(T a, T b);      // associative and commutative
+///   static T Multiply(T a, T b);
+///
+/// whose functions are inlined into the loops, so a semiring costs the same
+/// as a hand written loop.
+///
+/// Weights are callables that take an edge of the graph and return its
+/// weight, e.g., UnitWeight or a lambda that reads an edge property through
+/// GetEdgePropertyIndexFromOutEdge. Masks are callables that take a node and
+/// return whether its output is computed; outputs of masked out nodes are
+/// left as they are.
+///
+/// PullMxV computes y = A x over the out-edges of each node and needs no
+/// synchronization. PushVxM computes y = x A by scattering along the
+/// out-edges of the nonzero entries of x, which is cheaper when x has few
+/// of them; it is the same product as PullMxV over the transpose of the
+/// graph. VxM picks one of the two given the graph and its transpose, e.g.,
+/// PropertyGraphViews::Default and PropertyGraphViews::Transposed.
+namespace katana::analytics {
+
+/// a + b, a * b
+template <typename T>
+struct PlusTimes {
+  using value_type = T;
+  static constexpr T Zero() { return T{0}; }
+  static constexpr T One() { return T{1}; }
+  static constexpr T Add(T a, T b) { return a + b; }
+  static constexpr T Multiply(T a, T b) { return a * b; }
+};
+
+/// min(a, b), a + b; the semiring of shortest paths. The largest value of T
+/// stands for infinity and stays infinite when added to.
+template <typename T>
+struct MinPlus {
+  using value_type = T;
+  static constexpr T Zero() { return std::numeric_limits<T>::max(); }
+  static constexpr T One() { return T{0}; }
+  static constexpr T Add(T a, T b) { return std::min(a, b); }
+  static constexpr T Multiply(T a, T b) {
+    return (a == Zero() || b == Zero()) ? Zero() : a + b;
+  }
+};
+
+/// max(a, b), a + b; the semiring of longest paths. The lowest value of T
+/// stands for minus infinity.
+template <typename T>
+struct MaxPlus {
+  using value_type = T;
+  static constexpr T Zero() { return std::numeric_limits<T>::lowest(); }
+  static constexpr T One() { return T{0}; }
+  static constexpr T Add(T a, T b) { return std::max(a, b); }
+  static constexpr T Multiply(T a, T b) {
+    return (a == Zero() || b == Zero()) ? Zero() : a + b;
+  }
+};
+
+/// max(a, b), a * b over non-negative values, e.g., most reliable paths
+template <typename T>
+struct MaxTimes {
+  using value_type = T;
+  static constexpr T Zero() { return T{0}; }
+  static constexpr T One() { return T{1}; }
+  static constexpr T Add(T a, T b) { return std::max(a, b); }
+  static constexpr T Multiply(T a, T b) { return a * b; }
+};
+
+/// a | b, a & b over 0 and 1; the semiring of reachability
+struct OrAnd {
+  using value_type = uint8_t;
+  static constexpr uint8_t Zero() { return 0; }
+  static constexpr uint8_t One() { return 1; }
+  static constexpr uint8_t Add(uint8_t a, uint8_t b) { return a | b; }
+  static constexpr uint8_t Multiply(uint8_t a, uint8_t b) { return a & b; }
+};
+
+/// The weight of every edge is One, for products with the adjacency matrix
+template <typename Semiring>
+struct UnitWeight {
+  template <typename Edge>
+  constexpr typename Semiring::value_type operator()(const Edge&) const {
+    return Semiring::One();
+  }
+};
+
+/// Compute the outputs of all nodes
+struct NoMask {
+  template <typename Node>
+  constexpr bool operator()(const Node&) const {
+    return true;
+  }
+};
+
+/// Compute the outputs of the nodes whose bit is set, or with complement,
+/// of the nodes whose bit is not set
+struct BitsetMask {
+  const katana::DynamicBitset& bits;
+  bool complement{false};
+
+  template <typename Node>
+  bool operator()(const Node& n) const {
+    return bits.test(n) != complement;
+  }
+};
+
+enum class SpMVDirection {
+  kPull,
+  kPush,
+  /// push when x has fewer than 1 in kPushDensityDivisor nonzero entries
+  kAuto,
+};
+
+/// Nodes per nonzero entry of x below which VxM pushes; the same threshold as
+/// the direction optimizing BFS (BfsPlan::kDefaultAlpha)
+constexpr static const uint64_t kPushDensityDivisor = 15;
+
+/// Outputs of SpMM can be specialized for a width known at compile time
+constexpr static const size_t kDynamicWidth = 0;
+
+namespace internal {
+
+constexpr static const unsigned kSpMVChunkSize = 64U;
+
+/// y = Add(y, value) with a compare and swap loop, for any semiring
+template <typename Semiring>
+void
+AtomicAccumulate(
+    typename Semiring::value_type* y, typename Semiring::value_type value) {
+  using T = typename Semiring::value_type;
+  T old_value;
+  __atomic_load(y, &old_value, __ATOMIC_RELAXED);
+  T new_value = Semiring::Add(old_value, value);
+  while (new_value != old_value &&
+         !__atomic_compare_exchange(
+             y, &old_value, &new_value, true, __ATOMIC_RELAXED,
+             __ATOMIC_RELAXED)) {
+    new_value = Semiring::Add(old_value, value);
+  }
+}
+
+/// The inner loop of SpMM: row = Add(row, Multiply(weight, x_row)), with the
+/// trip count a constant when kWidth is not kDynamicWidth so that the
+/// compiler unrolls and vectorizes it for the width
+template <typename Semiring, size_t kWidth>
+inline void
+AccumulateRow(
+    typename Semiring::value_type* row, typename Semiring::value_type weight,
+    const typename Semiring::value_type* x_row, size_t width) {
+  const size_t w = kWidth == kDynamicWidth ? width : kWidth;
+  for (size_t j = 0; j < w; ++j) {
+    row[j] = Semiring::Add(row[j], Semiring::Multiply(weight, x_row[j]));
+  }
+}
+
+}  // namespace internal
+
+/// y = A x: y[u] is the sum over the out-edges e = (u, v) of graph of
+/// weight(e) times x[v]. x and y have graph.NumNodes() entries and must not
+/// overlap.
+template <
+    typename Semiring, typename Graph, typename Weight,
+    typename Mask = NoMask>
+void
+PullMxV(
+    const Graph& graph, const Weight& weight,
+    const typename Semiring::value_type* x, typename Semiring::value_type* y,
+    const Mask& mask = Mask()) {
+  using Node = typename Graph::Node;
+  using T = typename Semiring::value_type;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& u) {
+        if (!mask(u)) {
+          return;
+        }
+        T sum = Semiring::Zero();
+        for (auto e : graph.OutEdges(u)) {
+          sum = Semiring::Add(
+              sum, Semiring::Multiply(weight(e), x[graph.OutEdgeDst(e)]));
+        }
+        y[u] = sum;
+      },
+      katana::steal(), katana::chunk_size<internal::kSpMVChunkSize>(),
+      katana::no_stats(), katana::loopname("PullMxV"));
+}
+
+/// y = x A: y[v] is the sum over the out-edges e = (u, v) of graph of x[u]
+/// times weight(e). Only the out-edges of nodes u with a nonzero x[u] are
+/// read. x and y have graph.NumNodes() entries and must not overlap.
+template <
+    typename Semiring, typename Graph, typename Weight,
+    typename Mask = NoMask>
+void
+PushVxM(
+    const Graph& graph, const Weight& weight,
+    const typename Semiring::value_type* x, typename Semiring::value_type* y,
+    const Mask& mask = Mask()) {
+  using Node = typename Graph::Node;
+  using T = typename Semiring::value_type;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& v) {
+        if (mask(v)) {
+          y[v] = Semiring::Zero();
+        }
+      },
+      katana::no_stats(), katana::loopname("PushVxM_Init"));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& u) {
+        T x_u = x[u];
+        if (x_u == Semiring::Zero()) {
+          return;
+        }
+        for (auto e : graph.OutEdges(u)) {
+          Node v = graph.OutEdgeDst(e);
+          if (mask(v)) {
+            internal::AtomicAccumulate<Semiring>(
+                &y[v], Semiring::Multiply(x_u, weight(e)));
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<internal::kSpMVChunkSize>(),
+      katana::no_stats(), katana::loopname("PushVxM"));
+}
+
+/// y = x A, pushing along the out-edges of graph or pulling along those of
+/// transposed, which must be its transpose. weight and transposed_weight
+/// give the weights of the same edge in each. With kAuto, push if x has
+/// few nonzero entries.
+template <
+    typename Semiring, typename Graph, typename TransposedGraph,
+    typename Weight, typename TransposedWeight, typename Mask = NoMask>
+void
+VxM(const Graph& graph, const TransposedGraph& transposed,
+    const Weight& weight, const TransposedWeight& transposed_weight,
+    const typename Semiring::value_type* x, typename Semiring::value_type* y,
+    const Mask& mask = Mask(),
+    SpMVDirection direction = SpMVDirection::kAuto) {
+  using Node = typename Graph::Node;
+  KATANA_LOG_DEBUG_ASSERT(graph.NumNodes() == transposed.NumNodes());
+  if (direction == SpMVDirection::kAuto) {
+    katana::GAccumulator<uint64_t> nonzeros;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const Node& u) {
+          if (x[u] != Semiring::Zero()) {
+            nonzeros += 1;
+          }
+        },
+        katana::no_stats(), katana::loopname("VxM_Density"));
+    direction = nonzeros.reduce() * kPushDensityDivisor < graph.NumNodes()
+                    ? SpMVDirection::kPush
+                    : SpMVDirection::kPull;
+  }
+  if (direction == SpMVDirection::kPush) {
+    PushVxM<Semiring>(graph, weight, x, y, mask);
+  } else {
+    PullMxV<Semiring>(transposed, transposed_weight, x, y, mask);
+  }
+}
+
+/// Y = A X for dense matrices X and Y of graph.NumNodes() rows of width
+/// entries each, stored row after row: row u of Y is the sum over the
+/// out-edges e = (u, v) of graph of weight(e) times row v of X. Give kWidth
+/// when the width is known at compile time to unroll the inner loop over
+/// the row. For Y = X A, use the transpose of the graph.
+template <
+    typename Semiring, size_t kWidth = kDynamicWidth, typename Graph,
+    typename Weight, typename Mask = NoMask>
+void
+PullMxM(
+    const Graph& graph, const Weight& weight,
+    const typename Semiring::value_type* x, typename Semiring::value_type* y,
+    size_t width, const Mask& mask = Mask()) {
+  using Node = typename Graph::Node;
+  using T = typename Semiring::value_type;
+  KATANA_LOG_DEBUG_ASSERT(kWidth == kDynamicWidth || kWidth == width);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& u) {
+        if (!mask(u)) {
+          return;
+        }
+        T* row = y + uint64_t{u} * width;
+        std::fill(row, row + width, Semiring::Zero());
+        for (auto e : graph.OutEdges(u)) {
+          internal::AccumulateRow<Semiring, kWidth>(
+              row, weight(e), x + uint64_t{graph.OutEdgeDst(e)} * width,
+              width);
+        }
+      },
+      katana::steal(), katana::chunk_size<internal::kSpMVChunkSize>(),
+      katana::no_stats(), katana::loopname("PullMxM"));
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_TIMEWINDOW_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_TIMEWINDOW_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "katana/ErrorCode.h"
+#include "katana/GraphTopology.h"
+#include "katana/Result.h"
+
+namespace katana::analytics {
+
+/// The edges of a graph with a timestamp in [begin, end), for analytics that
+/// run on a time window of the graph rather than on a subgraph extracted from
+/// it. The edges are read through PropertyGraphViews::Temporal or
+/// TransposedTemporal, which are built once per timestamp property and shared
+/// by every window.
+struct TimeWindow {
+  using Timestamp = TemporalTopology::Timestamp;
+
+  /// The edge property with the timestamps, see TemporalTopology for the
+  /// types it may have
+  std::string timestamp_property;
+  /// The first timestamp in the window
+  Timestamp begin{std::numeric_limits<Timestamp>::min()};
+  /// The first timestamp after the window
+  Timestamp end{TemporalTopology::kNoTimestamp};
+
+  Result<void> Validate() const {
+    if (timestamp_property.empty()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "time window needs a timestamp property");
+    }
+    if (begin > end) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "time window [{}, {}) ends before it begins", begin, end);
+    }
+    return ResultSuccess();
+  }
+};
+
+}  // namespace katana::analytics
+
+#endif
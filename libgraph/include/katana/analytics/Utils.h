@@ -3,15 +3,19 @@
 
 #include <algorithm>
 #include <random>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <arrow/type.h>
 
 #include "arrow/util/bitmap.h"
 #include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Result.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Checkpoint.h"
 
 namespace katana::analytics {
 
@@ -114,6 +118,63 @@ public:
 KATANA_EXPORT void SplitStringByComma(
     std::string& str, std::vector<std::string>* vec);
 
+/// \returns the edge types of view that have one of the atomic edge types
+/// named in names, or all of them if names is empty. Traversals that follow only these edges iterate
+/// OutEdges(n, type) of an edge type aware view for each of them, so a new
+/// set of names needs no projected topology.
+template <typename View>
+katana::Result<std::vector<katana::EntityTypeID>>
+EdgeTypesToTraverse(
+    const katana::PropertyGraph& pg, const View& view,
+    const std::vector<std::string>& names) {
+  std::vector<katana::EntityTypeID> types;
+  if (names.empty()) {
+    for (const katana::EntityTypeID& type : view.GetDistinctEdgeTypes()) {
+      types.emplace_back(type);
+    }
+    return types;
+  }
+
+  const katana::EntityTypeManager& manager = pg.GetEdgeTypeManager();
+  auto atomic_types = KATANA_CHECKED(manager.GetEntityTypeIDs(names));
+  for (const katana::EntityTypeID& type : view.GetDistinctEdgeTypes()) {
+    for (size_t atomic = 0; atomic < atomic_types.size(); ++atomic) {
+      if (atomic_types.test(atomic) &&
+          manager.IsSubtypeOf(katana::EntityTypeID(atomic), type)) {
+        types.emplace_back(type);
+        break;
+      }
+    }
+  }
+  return types;
+}
+
+/// Communities from an earlier run to start community detection from when
+/// the graph changed little since. The labels are read from the uint64_t node
+/// property property_name. changed_nodes holds the endpoints of the edges
+/// added, removed or reweighted since the labels were computed; only the
+/// nodes around them are revisited.
+struct KATANA_EXPORT CommunitySeed {
+  std::string property_name;
+  std::vector<uint32_t> changed_nodes;
+};
+
+/// \returns the seed labels of every node of pg
+KATANA_EXPORT katana::Result<katana::NUMAArray<uint64_t>> ReadCommunitySeed(
+    katana::PropertyGraph* pg, const CommunitySeed& seed);
+
+/// Save the clusters of the nodes of the original graph after iteration
+/// iterations of clustering. A run resumed from them starts from the
+/// clusters as from a seed without changed nodes.
+KATANA_EXPORT katana::Result<void> SaveClusterCheckpoint(
+    Checkpointer* checkpointer, uint32_t iteration,
+    const katana::NUMAArray<uint64_t>& clusters);
+
+/// \returns the clusters saved by SaveClusterCheckpoint in state, as seed
+/// labels
+KATANA_EXPORT katana::Result<katana::NUMAArray<uint64_t>> ReadClusterCheckpoint(
+    const CheckpointState& state, uint64_t num_nodes);
+
 template <typename EdgeWeightType>
 static katana::Result<void>
 AddDefaultEdgeWeight(
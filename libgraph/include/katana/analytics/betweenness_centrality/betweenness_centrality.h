@@ -18,8 +18,8 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
-    // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
-    // kAsynchronous,
+    kAsynchronous,
+    // TODO(gill): Reinstate auto.
     // kAutomatic,
   };
 
@@ -55,6 +55,13 @@ public:
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Process one source at a time, like Level, but with a single
+  /// asynchronous loop per phase rather than one per level of the shortest
+  /// path DAG, which suits high-diameter graphs
+  static BetweennessCentralityPlan Asynchronous() {
+    return {kCPU, kAsynchronous};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
@@ -86,6 +93,53 @@ KATANA_EXPORT Result<void> BetweennessCentrality(
         kBetweennessCentralityAllNodes,
     BetweennessCentralityPlan plan = {});
 
+/// How ApproximateBetweennessCentrality draws its sources
+struct KATANA_EXPORT BetweennessCentralitySampling {
+  enum Distribution {
+    /// All nodes are equally likely
+    kUniform,
+    /// Nodes are drawn in proportion to their out-degree, which favors the
+    /// sources of most shortest paths in skewed graphs
+    kDegree,
+  };
+
+  Distribution distribution{kUniform};
+  /// Bound on the error of the centrality of every node, as a fraction of
+  /// (n - 1)(n - 2), the largest centrality in a graph of n nodes
+  double max_error{0.01};
+  /// Probability that the error of some node is over max_error
+  double failure_probability{0.1};
+  uint32_t seed{0};
+};
+
+struct KATANA_EXPORT ApproximateBetweennessCentralityStatistics {
+  /// Number of sources drawn, with repetition
+  uint64_t num_sources;
+  /// Bound on the error of every node when sampling stopped, as a fraction
+  /// of (n - 1)(n - 2); at most the max_error of the sampling
+  double max_error;
+};
+
+/// Estimate the betweenness centrality of each node from the shortest paths
+/// of sampled sources, on the scale of BetweennessCentrality. Sampling stops
+/// as soon as an empirical Bernstein bound, checked as the sample doubles,
+/// puts every node within max_error with probability 1 -
+/// failure_probability; a Hoeffding bound caps the number of sources.
+///
+/// If edge_weight_property_name is not empty, paths are shortest for the
+/// weights of that property, which must be positive; otherwise for the
+/// number of edges. Each thread traverses from its own sources, so a batch
+/// of sources is traversed at once.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<ApproximateBetweennessCentralityStatistics>
+ApproximateBetweennessCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx,
+    const BetweennessCentralitySampling& sampling = {},
+    const std::string& edge_weight_property_name = "");
+
 // TODO(gill): It's not clear how to check these results.
 //KATANA_EXPORT Result<void> BetweennessCentralityAssertValid(
 //    PropertyGraph* pg, const std::string& output_property_name);
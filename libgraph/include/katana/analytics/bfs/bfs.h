@@ -2,8 +2,13 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_BFS_BFS_H_
 
 #include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
 
+#include "katana/MirrorSync.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/TimeWindow.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -80,6 +85,63 @@ KATANA_EXPORT Result<void> Bfs(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     BfsPlan algo = {});
 
+/// Compute BFS parents as Bfs does, following only the edges whose type has
+/// one of the atomic edge types named in edge_types, or all edges if
+/// edge_types is empty. The traversal reads the per type edge ranges of the
+/// EdgeTypeAwareBiDir view, which is built once and then serves every set of
+/// edge types, so unlike Bfs on a projected graph it copies no topology.
+/// Nodes that cannot be reached over these edges get a parent of
+/// std::numeric_limits<uint32_t>::max() / 4.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> BfsByEdgeType(
+    PropertyGraph* pg, uint32_t start_node,
+    const std::vector<std::string>& edge_types,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx);
+
+/// The number of sources MultiSourceBfs traverses together
+constexpr size_t kMultiSourceBfsBatchSize = 64;
+
+/// Compute the BFS level (hop distance) of the nodes in the graph pg from
+/// each node in sources. The levels from sources[i] are stored in a uint32_t
+/// property named output_property_names[i]; nodes that cannot be reached get
+/// a level of std::numeric_limits<uint32_t>::max() / 4.
+///
+/// Up to kMultiSourceBfsBatchSize sources share a traversal: every node keeps
+/// one bit per source of the batch, so a batch of sources costs about as much
+/// as a single BFS whose frontiers are the union of theirs.
+/// The properties named in output_property_names are created by this function
+/// and may not exist before the call.
+KATANA_EXPORT Result<void> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names,
+    katana::TxnContext* txn_ctx);
+
+/// The start_node of DistributedBfs on the hosts that do not own the source
+constexpr uint32_t kDistributedBfsNoSource =
+    std::numeric_limits<uint32_t>::max();
+
+/// Compute the BFS level of the nodes of a graph partitioned over the hosts
+/// of sync, like MultiSourceBfs does for a single source. pg is the
+/// partition of this host: its nodes [0, num_owned) are the nodes it owns and
+/// the others are mirrors of nodes owned by other hosts, and it holds the
+/// out-edges of the nodes it owns. sync relates mirrors to their masters.
+/// start_node is the local id of the source on the host that owns it and
+/// kDistributedBfsNoSource on the others. All hosts call this together.
+///
+/// Each round, every host expands the frontier nodes it owns and sends the
+/// levels of the mirrors it reached to their masters, which then form the
+/// next frontier; the rounds end when no host has a frontier left. The
+/// levels are stored in a uint32_t property named output_property_name on
+/// every node of pg, mirrors included; nodes that cannot be reached get a
+/// level of std::numeric_limits<uint32_t>::max() / 4.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> DistributedBfs(
+    PropertyGraph* pg, MirrorSync* sync, uint32_t num_owned,
+    uint32_t start_node, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx);
+
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does do an exhaustive check.
 /// @return a failure if the BFS results do not pass validation or if there is a
@@ -87,6 +149,42 @@ KATANA_EXPORT Result<void> Bfs(
 KATANA_EXPORT Result<void> BfsAssertValid(
     PropertyGraph* pg, uint32_t source, const std::string& property_name);
 
+/// Compute the earliest time at which each node of pg can be reached from
+/// start_node by a time-respecting path: a path whose edges are in window and
+/// have non-decreasing timestamps, leaving start_node at window.begin. The
+/// times are stored in an int64 property named output_property_name, with
+/// TemporalTopology::kNoTimestamp for nodes that cannot be reached.
+///
+/// Each node only follows the out-edges it has not followed yet: the edges of
+/// a node are sorted by time, so when its arrival time improves from a to
+/// a' < a, the new edges are the range [a', a) of the temporal view.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> TemporalReachability(
+    PropertyGraph* pg, uint32_t start_node, const TimeWindow& window,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx);
+
+/// Check that the arrival times in property_name are the earliest arrival
+/// times from start_node in window.
+KATANA_EXPORT Result<void> TemporalReachabilityAssertValid(
+    PropertyGraph* pg, uint32_t start_node, const TimeWindow& window,
+    const std::string& property_name);
+
+struct KATANA_EXPORT TemporalReachabilityStatistics {
+  /// The number of nodes reachable from the source node, including it
+  uint64_t n_reached_nodes;
+  /// The latest arrival time at a reached node
+  int64_t latest_arrival;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  /// Compute the statistics of TemporalReachability results stored in
+  /// property_name.
+  static katana::Result<TemporalReachabilityStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 /// Statistics about a graph that can be extracted from the results of BFS.
 struct KATANA_EXPORT BfsStatistics {
   /// The number of nodes reachable from the source node.
@@ -0,0 +1,90 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for BipartiteMatching, specifying the algorithm and
+/// any parameters associated with it.
+class BipartiteMatchingPlan : public Plan {
+public:
+  enum Algorithm {
+    kPothenFan,
+    kPushRelabel,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  BipartiteMatchingPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  BipartiteMatchingPlan() : BipartiteMatchingPlan(kCPU, kPothenFan) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Parallel Pothen-Fan with lookahead and fairness (Azad et al. 2012).
+  /// After a greedy initial matching, each phase runs a depth-first search
+  /// for an augmenting path from every unmatched left node in parallel, the
+  /// searches claiming right nodes so that the paths are disjoint.
+  /// Lookahead first looks for an unmatched neighbor, and the searches
+  /// alternate the direction in which they scan adjacency lists each phase.
+  static BipartiteMatchingPlan PothenFan() { return {kCPU, kPothenFan}; }
+
+  /// Parallel push-relabel (Langguth et al. 2014). Every unmatched left node
+  /// matches itself to its right neighbor with the smallest label, unmatching
+  /// the previous mate of that neighbor, and raises the label of the
+  /// neighbor above its second smallest. Labels are recomputed by a parallel
+  /// breadth-first search from the unmatched right nodes now and then. A
+  /// final Pothen-Fan phase confirms that the matching is maximum.
+  static BipartiteMatchingPlan PushRelabel() { return {kCPU, kPushRelabel}; }
+};
+
+/// Compute a maximum cardinality matching of the bipartite graph between the
+/// nodes of type left_node_type and the nodes of type right_node_type. Edges
+/// in either direction between a left and a right node are candidates; all
+/// other edges and nodes of neither type are ignored. No node may have both
+/// types.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint8_t and is 1
+/// on the matched edges. Exactly one edge between the nodes of a matched pair
+/// is marked, the one from the left node if there is one.
+KATANA_EXPORT Result<void> BipartiteMatching(
+    PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BipartiteMatchingPlan plan = {});
+
+/// Check that the marked edges are a matching between left and right nodes
+/// and that there is no augmenting path, so the matching is maximum.
+KATANA_EXPORT Result<void> BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT BipartiteMatchingStatistics {
+  /// The number of left nodes.
+  uint64_t num_left_nodes;
+  /// The number of right nodes.
+  uint64_t num_right_nodes;
+  /// The number of matched pairs.
+  uint64_t num_matched;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BipartiteMatchingStatistics> Compute(
+      PropertyGraph* pg, const std::string& left_node_type,
+      const std::string& right_node_type,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -102,6 +102,18 @@ KATANA_EXPORT Result<void> Cdlp(
     size_t max_iterations, katana::TxnContext* txn_ctx,
     const bool& is_symmetric = false, CdlpPlan plan = CdlpPlan());
 
+/// Recompute the communities of pg after a few edge changes, starting from
+/// the labels of seed instead of one label per node. Only the changed nodes
+/// are revisited at first, and after that only the neighbors of nodes whose
+/// label changed. When the seed labels are those the synchronous algorithm
+/// converged to before the changes, the result is the same as that of
+/// running it from scratch. Nodes added since must be in changed_nodes.
+KATANA_EXPORT Result<void> Cdlp(
+    PropertyGraph* pg, const std::string& output_property_name,
+    const CommunitySeed& seed, size_t max_iterations,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
+    CdlpPlan plan = CdlpPlan());
+
 /// TODO (Yasin): This Struct (Compute function) is now being used by louvain,
 /// cc, and cdlp, basically everything which is calculating communities. Explore
 /// possiblity of moving it to some common .h file in libgalois/include/analytics
@@ -2,6 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
 
 #include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -110,7 +113,11 @@ public:
     return {kCPU, kBlockedAsynchronous, 0, 0, 0};
   }
 
-  /// Connected-components using Afforest sampling.
+  /// Connected-components using Afforest sampling. After linking
+  /// neighbor_sample_size neighbors of every node, the component most
+  /// frequent among component_sample_frequency sampled nodes is taken as the
+  /// largest. Its nodes skip the pass over their remaining edges, and so do
+  /// the nodes that join it during that pass.
   /// [1] M. Sutton, T. Ben-Nun and A. Barak, "Optimizing Parallel Graph
   /// Connectivity Computation via Subgraph Sampling," 2018 IEEE International
   /// Parallel and Distributed Processing Symposium (IPDPS), Vancouver, BC, 2018,
@@ -145,7 +152,7 @@ public:
       uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
       uint32_t component_sample_frequency = kDefaultComponentSampleFrequency) {
     return {
-        kCPU, kEdgeAfforest, edge_tile_size, neighbor_sample_size,
+        kCPU, kEdgeTiledAfforest, edge_tile_size, neighbor_sample_size,
         component_sample_frequency};
   }
 };
@@ -156,15 +163,46 @@ public:
 /// parameters can be specified, but have reasonable defaults. Not all parameters
 /// are used by the algorithms.
 /// The property named output_property_name is created by this function and may
-/// not exist before the call.
+/// not exist before the call. It holds dense component ids, from 0 to the
+/// number of components minus one.
 KATANA_EXPORT Result<void> ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
     ConnectedComponentsPlan plan = ConnectedComponentsPlan());
 
+/// Update the connected components of pg after the edges in added_edges,
+/// given as (source, destination) pairs, were added to the graph, instead of
+/// computing them from scratch.
+///
+/// previous_component_property_name holds the dense component ids computed
+/// before the edges were added, by ConnectedComponents or by an earlier
+/// call of this function. The components that each new edge joins are
+/// merged with a concurrent union-find over the component ids, so apart
+/// from one pass over the nodes to relabel them the work is proportional to
+/// the number of added edges rather than to the size of the graph. Edges are
+/// undirected for this purpose, as they are for ConnectedComponents.
+///
+/// Deleting edges can split components, which this function cannot see;
+/// after deletions, recompute the components with ConnectedComponents.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call. It holds dense component ids, in which
+/// components that were not merged keep their relative order.
+KATANA_EXPORT Result<void> ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& previous_component_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& added_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx);
+
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
+/// Count the nodes of each component of the dense component ids in the
+/// property named property_name, as written by ConnectedComponents.
+/// \returns a table of a uint64 column "component" and a uint64 column
+/// "size", with one row per component in the order of the ids
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> ConnectedComponentSizes(
+    PropertyGraph* pg, const std::string& property_name);
+
 struct KATANA_EXPORT ConnectedComponentsStatistics {
   /// Total number of unique components in the graph.
   uint64_t total_components;
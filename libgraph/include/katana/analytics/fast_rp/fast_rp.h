@@ -0,0 +1,140 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_FASTRP_FASTRP_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_FASTRP_FASTRP_H_
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for FastRP node embeddings.
+class FastRPPlan : public Plan {
+public:
+  enum Algorithm {
+    kVerySparseProjection,
+  };
+
+  static const uint32_t kDefaultEmbeddingDimension = 128;
+  /// 0 means the square root of the number of nodes
+  static const uint32_t kDefaultSparsity = 0;
+  static constexpr double kDefaultNormalizationStrength = 0.0;
+  static const uint32_t kDefaultSeed = 0;
+
+  /// Weights of the projections propagated one, two and three hops
+  static std::vector<double> DefaultIterationWeights() {
+    return {0.0, 1.0, 1.0};
+  }
+
+private:
+  Algorithm algorithm_;
+  uint32_t embedding_dimension_;
+  std::vector<double> iteration_weights_;
+  uint32_t sparsity_;
+  double normalization_strength_;
+  uint32_t seed_;
+
+  FastRPPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t embedding_dimension, std::vector<double> iteration_weights,
+      uint32_t sparsity, double normalization_strength, uint32_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        embedding_dimension_(embedding_dimension),
+        iteration_weights_(std::move(iteration_weights)),
+        sparsity_(sparsity),
+        normalization_strength_(normalization_strength),
+        seed_(seed) {}
+
+public:
+  FastRPPlan()
+      : FastRPPlan{
+            kCPU,
+            kVerySparseProjection,
+            kDefaultEmbeddingDimension,
+            DefaultIterationWeights(),
+            kDefaultSparsity,
+            kDefaultNormalizationStrength,
+            kDefaultSeed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Number of floats in the embedding of a node
+  uint32_t embedding_dimension() const { return embedding_dimension_; }
+  /// Weight of the projection propagated i + 1 hops in the embedding; there
+  /// are as many propagations as weights
+  const std::vector<double>& iteration_weights() const {
+    return iteration_weights_;
+  }
+  /// One in sparsity entries of the random projection is nonzero
+  uint32_t sparsity() const { return sparsity_; }
+  /// The random projection of a node is scaled by its degree to this power;
+  /// negative values weaken the influence of high-degree nodes
+  double normalization_strength() const { return normalization_strength_; }
+  /// Seed of the random projection; the same seed gives the same embeddings
+  uint32_t seed() const { return seed_; }
+
+  /**
+   * Project the nodes on a very sparse random matrix and average the
+   * projections over their neighborhoods, normalizing after every hop; the
+   * embedding is the weighted sum of the averages over 1, 2, ... hops:
+   *   Haochen Chen, Syed Fahad Sultan, Yingtao Tian, Muhao Chen, Steven
+   *   Skiena. Fast and Accurate Network Embeddings via Very Sparse Random
+   *   Projection. CIKM 2019.
+   *
+   * @param embedding_dimension Number of floats in the embedding of a node.
+   * @param iteration_weights Weight of the average over each number of hops.
+   * @param sparsity One in sparsity entries of the projection is nonzero.
+   * @param normalization_strength Exponent of the degree scaling.
+   * @param seed Seed of the random projection.
+   */
+  static FastRPPlan VerySparseProjection(
+      uint32_t embedding_dimension = kDefaultEmbeddingDimension,
+      std::vector<double> iteration_weights = DefaultIterationWeights(),
+      uint32_t sparsity = kDefaultSparsity,
+      double normalization_strength = kDefaultNormalizationStrength,
+      uint32_t seed = kDefaultSeed) {
+    return {
+        kCPU,
+        kVerySparseProjection,
+        embedding_dimension,
+        std::move(iteration_weights),
+        sparsity,
+        normalization_strength,
+        seed};
+  }
+};
+
+/// Compute a FastRP embedding of every node of pg over its out-edges; for
+/// undirected embeddings the graph should be symmetric. The embedding of a
+/// node is stored in the property named output_property_name as a
+/// fixed-size binary of embedding_dimension floats, the layout of
+/// FixedSizedBinaryPODArrayProperty<float, embedding_dimension>. The property
+/// is created by this function and may not exist before the call.
+KATANA_EXPORT Result<void> FastRP(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, FastRPPlan plan = {});
+
+KATANA_EXPORT Result<void> FastRPAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT FastRPStatistics {
+  /// Number of floats in the embedding of a node
+  uint32_t embedding_dimension;
+  /// Mean Euclidean norm of the embeddings
+  double mean_norm;
+  /// Number of nodes whose embedding is all zeros, e.g., nodes without
+  /// out-edges with a weight of 0 on the first hop
+  uint64_t zero_embeddings;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<FastRPStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for GraphColoring, specifying the algorithm and
+/// any parameters associated with it.
+class GraphColoringPlan : public Plan {
+public:
+  enum Algorithm {
+    kJonesPlassmann,
+    kSpeculative,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  GraphColoringPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  GraphColoringPlan() : GraphColoringPlan(kCPU, kJonesPlassmann) {}
+
+  GraphColoringPlan& operator=(const GraphColoringPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Color the nodes in order of largest-degree-first priorities: a node takes
+  /// the smallest color its higher priority neighbors do not have once they
+  /// are all colored. Nodes colored in the same round are never neighbors, so
+  /// no coloring is ever undone, and the result does not depend on the number
+  /// of threads. The nodes of color 0 are a maximal independent set.
+  static GraphColoringPlan JonesPlassmann() { return {kCPU, kJonesPlassmann}; }
+
+  /// Let every uncolored node take the smallest color its neighbors do not
+  /// have at once, then uncolor the lower priority node of every edge whose
+  /// ends took the same color and repeat. There are fewer rounds than with
+  /// JonesPlassmann, but the result depends on the order of the threads.
+  static GraphColoringPlan Speculative() { return {kCPU, kSpeculative}; }
+
+  static GraphColoringPlan FromAlgorithm(Algorithm algorithm) {
+    return {kCPU, algorithm};
+  }
+};
+
+/// Color the nodes of the graph so that no edge joins two nodes of the same
+/// color, e.g., to run updates of the nodes of one color at a time in parallel
+/// without locks. The graph must be symmetric. Self loops are ignored.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t and holds
+/// colors from 0 to the number of colors minus one.
+KATANA_EXPORT Result<void> GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, GraphColoringPlan plan = {});
+
+KATANA_EXPORT Result<void> GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT GraphColoringStatistics {
+  /// The number of colors used.
+  uint32_t num_colors;
+  /// The number of nodes of the most common color.
+  uint64_t largest_color_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphColoringStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHPARTITION_GRAPHPARTITION_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_GRAPHPARTITION_GRAPHPARTITION_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for GraphPartition, specifying the algorithm and
+/// any parameters associated with it.
+class GraphPartitionPlan : public Plan {
+public:
+  enum Algorithm {
+    kMultilevel,
+  };
+
+  static constexpr double kDefaultImbalance = 0.05;
+  static const uint32_t kDefaultCoarsenToPerPartition = 20;
+  static const uint32_t kDefaultMaxRefinementIterations = 10;
+
+private:
+  Algorithm algorithm_;
+  double imbalance_;
+  uint32_t coarsen_to_per_partition_;
+  uint32_t max_refinement_iterations_;
+
+  GraphPartitionPlan(
+      Architecture architecture, Algorithm algorithm, double imbalance,
+      uint32_t coarsen_to_per_partition, uint32_t max_refinement_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        imbalance_(imbalance),
+        coarsen_to_per_partition_(coarsen_to_per_partition),
+        max_refinement_iterations_(max_refinement_iterations) {}
+
+public:
+  GraphPartitionPlan()
+      : GraphPartitionPlan(
+            kCPU, kMultilevel, kDefaultImbalance,
+            kDefaultCoarsenToPerPartition, kDefaultMaxRefinementIterations) {}
+
+  GraphPartitionPlan& operator=(const GraphPartitionPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// How much heavier than the average a partition may be, e.g., 0.05 allows
+  /// partitions of up to 105% of the average number of nodes
+  double imbalance() const { return imbalance_; }
+  /// Coarsening stops at this many nodes per partition
+  uint32_t coarsen_to_per_partition() const {
+    return coarsen_to_per_partition_;
+  }
+  /// The most refinement passes to run at each level
+  uint32_t max_refinement_iterations() const {
+    return max_refinement_iterations_;
+  }
+
+  /// Multilevel k-way partitioning in the style of METIS. The graph is
+  /// coarsened by parallel heavy-edge matching until there are about
+  /// coarsen_to_per_partition nodes per partition, the coarsest graph is
+  /// partitioned by greedy graph growing, and the partition is projected back
+  /// level by level with parallel boundary refinement at each level.
+  /// Coarsening does not depend on the number of threads, but concurrent
+  /// refinement moves do, so partitions may differ from run to run.
+  static GraphPartitionPlan Multilevel(
+      double imbalance = kDefaultImbalance,
+      uint32_t coarsen_to_per_partition = kDefaultCoarsenToPerPartition,
+      uint32_t max_refinement_iterations = kDefaultMaxRefinementIterations) {
+    return {
+        kCPU, kMultilevel, imbalance, coarsen_to_per_partition,
+        max_refinement_iterations};
+  }
+};
+
+/// Partition the nodes of the graph into num_partitions parts of about the
+/// same number of nodes with few edges between parts, e.g., to split a graph
+/// across hosts. The graph must be symmetric. Self loops are ignored.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t and holds
+/// partition ids from 0 to num_partitions minus one.
+KATANA_EXPORT Result<void> GraphPartition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    GraphPartitionPlan plan = {});
+
+KATANA_EXPORT Result<void> GraphPartitionAssertValid(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name);
+
+struct KATANA_EXPORT GraphPartitionStatistics {
+  /// The number of partitions that hold at least one node.
+  uint32_t num_partitions;
+  /// The number of edges between nodes of different partitions, counting the
+  /// two directions of an edge of a symmetric graph once.
+  uint64_t edge_cut;
+  /// The number of nodes of the largest partition.
+  uint64_t largest_partition_size;
+  /// The number of nodes of the smallest partition that holds any.
+  uint64_t smallest_partition_size;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphPartitionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
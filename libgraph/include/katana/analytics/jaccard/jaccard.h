@@ -2,6 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_JACCARD_JACCARD_H_
 
 #include <iostream>
+#include <memory>
+
+#include <arrow/api.h>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -65,6 +68,92 @@ KATANA_EXPORT Result<void> Jaccard(
 KATANA_EXPORT Result<void> JaccardAssertValid(
     PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
 
+/// A computational plan for JaccardTopK, specifying how pairs of nodes are
+/// chosen to be scored and any parameters associated with it.
+class JaccardTopKPlan : public Plan {
+public:
+  /// Algorithm selectors for candidate pairs
+  enum Algorithm {
+    /// Score the pairs that agree on a band of their MinHash signatures.
+    /// A pair of similarity s shares a band with probability
+    /// 1 - (1 - s^rows_per_band)^num_bands, so similar pairs are rarely
+    /// missed and dissimilar ones are rarely scored.
+    kMinHash,
+    /// Score every pair that shares a neighbor. This is exact, but its work
+    /// is the number of paths of length two.
+    kExact,
+  };
+
+  /// The similarity of the out-neighbor sets A and B of two nodes
+  enum Measure {
+    /// |A ∩ B| / |A ∪ B|
+    kJaccard,
+    /// |A ∩ B| / min(|A|, |B|)
+    kOverlap,
+    /// |A ∩ B| / sqrt(|A| |B|)
+    kCosine,
+  };
+
+  static const uint32_t kDefaultNumBands = 16;
+  static const uint32_t kDefaultRowsPerBand = 4;
+  static const uint32_t kDefaultMaxBucketSize = 1024;
+
+private:
+  Algorithm algorithm_;
+  uint32_t num_bands_;
+  uint32_t rows_per_band_;
+  uint32_t max_bucket_size_;
+  uint32_t seed_;
+
+  JaccardTopKPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t num_bands,
+      uint32_t rows_per_band, uint32_t max_bucket_size, uint32_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        num_bands_(num_bands),
+        rows_per_band_(rows_per_band),
+        max_bucket_size_(max_bucket_size),
+        seed_(seed) {}
+
+public:
+  JaccardTopKPlan()
+      : JaccardTopKPlan{
+            kCPU, kMinHash, kDefaultNumBands, kDefaultRowsPerBand,
+            kDefaultMaxBucketSize, 0} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of bands of a MinHash signature
+  uint32_t num_bands() const { return num_bands_; }
+  /// The number of hashes in each band
+  uint32_t rows_per_band() const { return rows_per_band_; }
+  /// Buckets of more nodes than this that share a band are not scored, which
+  /// bounds the work spent on nodes with common neighbor sets
+  uint32_t max_bucket_size() const { return max_bucket_size_; }
+  /// The seed of the MinHash functions
+  uint32_t seed() const { return seed_; }
+
+  static JaccardTopKPlan MinHash(
+      uint32_t num_bands = kDefaultNumBands,
+      uint32_t rows_per_band = kDefaultRowsPerBand,
+      uint32_t max_bucket_size = kDefaultMaxBucketSize, uint32_t seed = 0) {
+    return {kCPU, kMinHash, num_bands, rows_per_band, max_bucket_size, seed};
+  }
+
+  static JaccardTopKPlan Exact() { return {kCPU, kExact, 0, 0, 0, 0}; }
+};
+
+/// Find for every node the k other nodes whose out-neighbor sets are the most
+/// similar to its own by measure, e.g., to predict links. Pairs that share
+/// no neighbor have similarity 0 and are never reported, so a node may get
+/// fewer than k.
+/// \returns a table of a uint32 column "src", a uint32 column "dst" and a
+/// double column "similarity", sorted by src and then by decreasing
+/// similarity
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> JaccardTopK(
+    PropertyGraph* pg, uint32_t k,
+    JaccardTopKPlan::Measure measure = JaccardTopKPlan::kJaccard,
+    JaccardTopKPlan plan = {});
+
 struct KATANA_EXPORT JaccardStatistics {
   /// The maximum similarity excluding the comparison node.
   double max_similarity;
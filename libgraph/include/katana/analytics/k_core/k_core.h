@@ -17,7 +17,7 @@ namespace katana::analytics {
 class KCorePlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kSynchronous, kAsynchronous };
+  enum Algorithm { kSynchronous, kAsynchronous, kBucketed };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -40,6 +40,12 @@ public:
 
   /// Asynchronous k-core algorithm.
   static KCorePlan Asynchronous() { return {kCPU, kAsynchronous}; }
+
+  /// Peel nodes in order of degree with lazily updated buckets, which finds
+  /// the coreness of every node in work linear in the size of the graph:
+  ///   Laxman Dhulipala, Guy Blelloch, Julian Shun. Julienne: A Framework for
+  ///   Parallel Graph Algorithms using Work-efficient Bucketing. SPAA 2017.
+  static KCorePlan Bucketed() { return {kCPU, kBucketed}; }
 };
 
 /// Compute the k-core for pg. The pg must be symmetric.
@@ -52,6 +58,14 @@ KATANA_EXPORT Result<void> KCore(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     const bool& is_symmetric = false, KCorePlan plan = KCorePlan());
 
+/// Compute the coreness of every node of pg, the largest k such that the node
+/// is in the k-core, with the kBucketed algorithm. The pg must be symmetric.
+/// The uint32_t property named output_property_name is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> KCoreDecomposition(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false);
+
 KATANA_EXPORT Result<void> KCoreAssertValid(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& property_name);
@@ -68,5 +82,18 @@ struct KATANA_EXPORT KCoreStatistics {
       const std::string& property_name);
 };
 
+struct KATANA_EXPORT KCoreDecompositionStatistics {
+  /// Largest coreness of a node, the largest k with a non-empty k-core.
+  uint32_t degeneracy;
+  /// Number of nodes in the k-core for k equal to the degeneracy.
+  uint64_t number_of_nodes_in_max_core;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KCoreDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
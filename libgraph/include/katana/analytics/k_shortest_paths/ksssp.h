@@ -16,6 +16,7 @@ public:
     kDeltaTile,
     kDeltaStep,
     kDeltaStepBarrier,
+    kYen,
   };
 
   /// Specifices algorithm used for path reachability
@@ -81,6 +82,14 @@ public:
       unsigned delta = kDefaultDelta) {
     return {kCPU, kDeltaStepBarrier, reachability, delta, 0};
   }
+
+  /// Yen's algorithm, which finds loopless paths. Each iteration runs the
+  /// spur path searches from every node of the last path in parallel, and a
+  /// bound shared by the searches ends those that cannot produce one of the
+  /// remaining paths.
+  static KssspPlan Yen(Reachability reachability = kDefaultReach) {
+    return {kCPU, kYen, reachability, 0, 0};
+  }
 };
 
 /// Compute the K Shortest Path for pg starting from start_node.
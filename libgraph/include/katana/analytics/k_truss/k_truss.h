@@ -16,7 +16,7 @@ namespace katana::analytics {
 class KTrussPlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss };
+  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss, kBucketed };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -39,6 +39,11 @@ public:
 
   /// Compute k-1 core and then k-truss algorithm.
   static KTrussPlan BspCoreThenTruss() { return {kCPU, kBspCoreThenTruss}; }
+
+  /// Peel edges in order of support with lazily updated buckets, updating
+  /// the support of the edges of each removed triangle instead of
+  /// recomputing supports every round. Finds the trussness of every edge.
+  static KTrussPlan Bucketed() { return {kCPU, kBucketed}; }
 };
 
 /// Compute the k-truss for pg. The pg is expected to be
@@ -53,6 +58,16 @@ KATANA_EXPORT Result<void> KTruss(
     katana::TxnContext* txn_ctx, PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& output_property_name, KTrussPlan plan = KTrussPlan());
 
+/// Compute the trussness of every edge of pg, the largest k such that the
+/// edge is in the k-truss, with the kBucketed algorithm. Edges in no triangle
+/// have trussness 2 and self loops 0. The pg is expected to be symmetric and
+/// both directions of an edge get the same trussness.
+/// The uint32_t property named output_property_name is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> KTrussDecomposition(
+    katana::TxnContext* txn_ctx, PropertyGraph* pg,
+    const std::string& output_property_name);
+
 KATANA_EXPORT Result<void> KTrussAssertValid(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& property_name);
@@ -69,5 +84,18 @@ struct KATANA_EXPORT KTrussStatistics {
       const std::string& property_name);
 };
 
+struct KATANA_EXPORT KTrussDecompositionStatistics {
+  /// Largest trussness of an edge.
+  uint32_t max_trussness;
+  /// Number of edges in the k-truss for k equal to max_trussness.
+  uint64_t number_of_edges_in_max_truss;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<KTrussDecompositionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
 }  // namespace katana::analytics
 #endif
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/Checkpoint.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -25,6 +26,7 @@ public:
   static const uint32_t kDefaultMinGraphSize = 100;
   static constexpr double kDefaultResolution = 1.0;
   static constexpr double kDefaultRandomness = 0.01;
+  static const uint64_t kDefaultRandomSeed = 0;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -37,12 +39,14 @@ private:
   uint32_t min_graph_size_;
   double resolution_;
   double randomness_;
+  uint64_t random_seed_;
+  CheckpointOptions checkpoint_;
 
   LeidenClusteringPlan(
       Architecture architecture, Algorithm algorithm, bool enable_vf,
       double modularity_threshold_per_round, double modularity_threshold_total,
       uint32_t max_iterations, uint32_t min_graph_size, double resolution,
-      double randomness)
+      double randomness, uint64_t random_seed)
       : Plan(architecture),
         algorithm_(algorithm),
         enable_vf_(enable_vf),
@@ -51,7 +55,8 @@ private:
         max_iterations_(max_iterations),
         min_graph_size_(min_graph_size),
         resolution_(resolution),
-        randomness_(randomness) {}
+        randomness_(randomness),
+        random_seed_(random_seed) {}
 
 public:
   LeidenClusteringPlan()
@@ -64,7 +69,8 @@ public:
             kDefaultMaxIterations,
             kDefaultMinGraphSize,
             kDefaultResolution,
-            kDefaultRandomness} {}
+            kDefaultRandomness,
+            kDefaultRandomSeed} {}
 
   Algorithm algorithm() const { return algorithm_; }
   /// Enable vertex following optimization
@@ -88,6 +94,21 @@ public:
   /// Randomness for picking subcommunities
   double randomness() const { return randomness_; }
 
+  /// Seed of the random choices of the refinement; with one thread, runs
+  /// with the same seed find the same clusters
+  uint64_t random_seed() const { return random_seed_; }
+
+  /// Where and how often the clusters are saved between phases; see
+  /// CheckpointOptions. Off by default.
+  const CheckpointOptions& checkpoint() const { return checkpoint_; }
+
+  /// \returns a copy of this plan that saves checkpoints as checkpoint says
+  LeidenClusteringPlan WithCheckpoint(CheckpointOptions checkpoint) const {
+    LeidenClusteringPlan plan = *this;
+    plan.checkpoint_ = std::move(checkpoint);
+    return plan;
+  }
+
   /// Nondeterministic algorithm for louvain clustering
   /// usign katana do_all
   static LeidenClusteringPlan DoAll(
@@ -98,7 +119,8 @@ public:
       uint32_t max_iterations = kDefaultMaxIterations,
       uint32_t min_graph_size = kDefaultMinGraphSize,
       double resolution = kDefaultResolution,
-      double randomness = kDefaultRandomness) {
+      double randomness = kDefaultRandomness,
+      uint64_t random_seed = kDefaultRandomSeed) {
     return {
         kCPU,
         kDoAll,
@@ -108,7 +130,8 @@ public:
         max_iterations,
         min_graph_size,
         resolution,
-        randomness};
+        randomness,
+        random_seed};
   }
 
   /// Deterministic algorithm for louvain clustering
@@ -121,7 +144,8 @@ public:
       uint32_t max_iterations = kDefaultMaxIterations,
       uint32_t min_graph_size = kDefaultMinGraphSize,
       double resolution = kDefaultResolution,
-      double randomness = kDefaultRandomness) {
+      double randomness = kDefaultRandomness,
+      uint64_t random_seed = kDefaultRandomSeed) {
     return {
         kCPU,
         kDeterministic,
@@ -131,7 +155,8 @@ public:
         max_iterations,
         min_graph_size,
         resolution,
-        randomness};
+        randomness,
+        random_seed};
   }
 };
 
@@ -147,6 +172,17 @@ KATANA_EXPORT Result<void> LeidenClustering(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     const bool& is_symmetric = false, LeidenClusteringPlan plan = {});
 
+/// Recompute the clusters of pg after a few edge changes, starting from the
+/// clusters of seed instead of one cluster per node. The nodes of
+/// seed.changed_nodes and their neighbors start in clusters of their own and
+/// every other seed cluster starts as one node of a coarsened graph, so the
+/// first level only moves the nodes around the changes.
+KATANA_EXPORT Result<void> LeidenClustering(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, const CommunitySeed& seed,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
+    LeidenClusteringPlan plan = {});
+
 KATANA_EXPORT Result<void> LeidenClusteringAssertValid(
     PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name);
@@ -4,6 +4,7 @@
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/Sampling.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -85,6 +86,23 @@ KATANA_EXPORT Result<void> LocalClusteringCoefficient(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, LocalClusteringCoefficientPlan plan = {});
 
+/**
+ * Estimate the global clustering coefficient of the graph, the fraction of
+ * its wedges (paths of two edges) that are closed by a third edge, from a
+ * uniform sample of wedges:
+ *   C. Seshadhri, Ali Pinar, Tamara G. Kolda. Triadic Measures on Graphs:
+ *   The Power of Wedge Sampling. SDM 2013.
+ *
+ * The number of wedges sampled depends only on max_error, not on the size of
+ * the graph. The graph must be symmetric!
+ *
+ * @param pg The graph to process.
+ * @param max_error Half width of the 95% confidence interval to sample for.
+ * @param seed Seed of the sample; the same seed checks the same wedges.
+ */
+KATANA_EXPORT Result<Estimate> EstimateGlobalClusteringCoefficient(
+    PropertyGraph* pg, double max_error = 0.01, uint32_t seed = 0);
+
 }  // namespace katana::analytics
 
 #endif
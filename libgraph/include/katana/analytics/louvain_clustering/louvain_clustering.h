@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/Checkpoint.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -33,6 +34,7 @@ private:
   double modularity_threshold_total_;
   uint32_t max_iterations_;
   uint32_t min_graph_size_;
+  CheckpointOptions checkpoint_;
 
   LouvainClusteringPlan(
       Architecture architecture, Algorithm algorithm, bool enable_vf,
@@ -73,6 +75,17 @@ public:
   /// Minimum coarsened graph size
   uint32_t min_graph_size() const { return min_graph_size_; }
 
+  /// Where and how often the clusters are saved between phases; see
+  /// CheckpointOptions. Off by default.
+  const CheckpointOptions& checkpoint() const { return checkpoint_; }
+
+  /// \returns a copy of this plan that saves checkpoints as checkpoint says
+  LouvainClusteringPlan WithCheckpoint(CheckpointOptions checkpoint) const {
+    LouvainClusteringPlan plan = *this;
+    plan.checkpoint_ = std::move(checkpoint);
+    return plan;
+  }
+
   /// Nondeterministic algorithm for louvain clustering
   /// usign katana do_all
   static LouvainClusteringPlan DoAll(
@@ -124,6 +137,17 @@ KATANA_EXPORT Result<void> LouvainClustering(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     const bool& is_symmetric, LouvainClusteringPlan plan = {});
 
+/// Recompute the clusters of pg after a few edge changes, starting from the
+/// clusters of seed instead of one cluster per node. The nodes of
+/// seed.changed_nodes and their neighbors start in clusters of their own and
+/// every other seed cluster starts as one node of a coarsened graph, so the
+/// first level only moves the nodes around the changes.
+KATANA_EXPORT Result<void> LouvainClustering(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, const CommunitySeed& seed,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric,
+    LouvainClusteringPlan plan = {});
+
 KATANA_EXPORT Result<void> LouvainClusteringAssertValid(
     PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name);
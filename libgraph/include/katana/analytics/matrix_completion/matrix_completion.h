@@ -6,6 +6,7 @@
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/analytics/Checkpoint.h"
 #include "katana/analytics/Plan.h"
 
 namespace katana::analytics {
@@ -16,6 +17,8 @@ class MatrixCompletionPlan : public Plan {
 public:
   enum Algorithm {
     kSGDByItems,
+    kSGDBlocked,
+    kALS,
   };
 
   enum Step { kBold, kBottou, kIntel, kInverse, kPurdue };
@@ -31,6 +34,8 @@ public:
   static constexpr bool kDefaultUseExactError = false;
   static constexpr bool kDefaultUseDetInit = false;
   static constexpr Step kDefaultLearningRateFunction = kBold;
+  /// 0 means one block of items and one of users per thread
+  static constexpr uint32_t kDefaultNumBlocks = 0;
 
 private:
   Algorithm algorithm_;
@@ -45,13 +50,15 @@ private:
   bool use_exact_error_;
   bool use_det_init_;
   Step learning_rate_function_;
+  uint32_t num_blocks_;
+  CheckpointOptions checkpoint_;
 
   MatrixCompletionPlan(
       Architecture architecture, Algorithm algorithm, double learning_rate,
       double decay_rate, double lambda, double tolerance,
       bool use_same_latent_vector, uint32_t max_updates,
       uint32_t updates_per_edge, uint32_t fixed_rounds, bool use_exact_error,
-      bool use_det_init, Step learning_rate_function)
+      bool use_det_init, Step learning_rate_function, uint32_t num_blocks)
       : Plan(architecture),
         algorithm_(algorithm),
         learning_rate_(learning_rate),
@@ -64,7 +71,8 @@ private:
         fixed_rounds_(fixed_rounds),
         use_exact_error_(use_exact_error),
         use_det_init_(use_det_init),
-        learning_rate_function_(learning_rate_function) {}
+        learning_rate_function_(learning_rate_function),
+        num_blocks_(num_blocks) {}
 
 public:
   MatrixCompletionPlan()
@@ -81,7 +89,8 @@ public:
             kDefaultFixedRounds,
             kDefaultUseExactError,
             kDefaultUseDetInit,
-            kDefaultLearningRateFunction} {}
+            kDefaultLearningRateFunction,
+            kDefaultNumBlocks} {}
 
   Algorithm algorithm() const { return algorithm_; }
   double learningRate() const { return learning_rate_; }
@@ -95,7 +104,21 @@ public:
   bool useExactError() const { return use_exact_error_; }
   bool useDetInit() const { return use_det_init_; }
   Step learningRateFunction() const { return learning_rate_function_; }
+  uint32_t numBlocks() const { return num_blocks_; }
 
+  /// Where and how often the latent vectors are saved between rounds; see
+  /// CheckpointOptions. Off by default.
+  const CheckpointOptions& checkpoint() const { return checkpoint_; }
+
+  /// \returns a copy of this plan that saves checkpoints as checkpoint says
+  MatrixCompletionPlan WithCheckpoint(CheckpointOptions checkpoint) const {
+    MatrixCompletionPlan plan = *this;
+    plan.checkpoint_ = std::move(checkpoint);
+    return plan;
+  }
+
+  /// SGD over the ratings of each item in parallel, updating latent vectors
+  /// with atomic adds.
   static MatrixCompletionPlan SGDByItems(
       double learning_rate = kDefaultLearningRate,
       double decay_rate = kDefaultDecayRate, double lambda = kDefaultLambda,
@@ -120,13 +143,75 @@ public:
         fixed_rounds,
         use_exact_error,
         use_det_init,
-        learning_rate_function};
+        learning_rate_function,
+        kDefaultNumBlocks};
+  }
+
+  /// Distributed SGD over a 2D blocking of the rating matrix (Gemulla et al.
+  /// 2011): the items and the users are each cut into num_blocks blocks, and
+  /// each round runs num_blocks sub-epochs over strata of blocks that share
+  /// no item or user, so the blocks of a stratum are updated in parallel
+  /// without atomics and their latent vectors stay in cache.
+  static MatrixCompletionPlan SGDBlocked(
+      double learning_rate = kDefaultLearningRate,
+      double decay_rate = kDefaultDecayRate, double lambda = kDefaultLambda,
+      double tolerance = kDefaultTolerance,
+      bool use_same_latent_vector = kDefaultUseSameLatentVector,
+      uint32_t max_updates = kDefaultMaxUpdates,
+      uint32_t updates_per_edge = kDefaultUpdatesPerEdge,
+      uint32_t fixed_rounds = kDefaultFixedRounds,
+      bool use_exact_error = kDefaultUseExactError,
+      bool use_det_init = kDefaultUseDetInit,
+      Step learning_rate_function = kDefaultLearningRateFunction,
+      uint32_t num_blocks = kDefaultNumBlocks) {
+    return {
+        kCPU,
+        kSGDBlocked,
+        learning_rate,
+        decay_rate,
+        lambda,
+        tolerance,
+        use_same_latent_vector,
+        max_updates,
+        updates_per_edge,
+        fixed_rounds,
+        use_exact_error,
+        use_det_init,
+        learning_rate_function,
+        num_blocks};
+  }
+
+  /// Alternating least squares: each round solves the regularized least
+  /// squares problem of every item with the user vectors fixed, then of
+  /// every user with the item vectors fixed. There is no learning rate.
+  static MatrixCompletionPlan ALS(
+      double lambda = kDefaultLambda, double tolerance = kDefaultTolerance,
+      bool use_same_latent_vector = kDefaultUseSameLatentVector,
+      uint32_t max_updates = kDefaultMaxUpdates,
+      uint32_t fixed_rounds = kDefaultFixedRounds,
+      bool use_exact_error = kDefaultUseExactError,
+      bool use_det_init = kDefaultUseDetInit) {
+    return {
+        kCPU,
+        kALS,
+        kDefaultLearningRate,
+        kDefaultDecayRate,
+        lambda,
+        tolerance,
+        use_same_latent_vector,
+        max_updates,
+        kDefaultUpdatesPerEdge,
+        fixed_rounds,
+        use_exact_error,
+        use_det_init,
+        kDefaultLearningRateFunction,
+        kDefaultNumBlocks};
   }
 };
 
-/// Performs matrix completion using stochastic gradient descent (SGD) algortihm
-/// on a bipartite graph and learns latent vectors for each node that is stored in
-/// an ArrayProperty.
+/// Performs matrix completion using stochastic gradient descent (SGD) or
+/// alternating least squares (ALS) on a bipartite graph and learns latent
+/// vectors for each node that is stored in an ArrayProperty.
 /// The plan controls the algorithm and parameters used to compute the latent vectors.
 KATANA_EXPORT Result<void> MatrixCompletion(
     katana::PropertyGraph* pg, katana::TxnContext* txn_ctx,
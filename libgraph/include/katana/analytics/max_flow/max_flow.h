@@ -0,0 +1,100 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for MaxFlow, specifying the algorithm and any
+/// parameters associated with it.
+class MaxFlowPlan : public Plan {
+public:
+  enum Algorithm {
+    kPushRelabel,
+  };
+
+  static const uint32_t kDefaultGlobalRelabelInterval = 1;
+
+private:
+  Algorithm algorithm_;
+  uint32_t global_relabel_interval_;
+
+  MaxFlowPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t global_relabel_interval)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_interval_(global_relabel_interval) {}
+
+public:
+  MaxFlowPlan()
+      : MaxFlowPlan(kCPU, kPushRelabel, kDefaultGlobalRelabelInterval) {}
+
+  MaxFlowPlan& operator=(const MaxFlowPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Global relabeling runs once there have been this many relabels per node
+  /// since the last one
+  uint32_t global_relabel_interval() const { return global_relabel_interval_; }
+
+  /// Lock-free parallel push-relabel (Hong 2008): every active node pushes
+  /// its excess to its lowest residual neighbor, or relabels itself above
+  /// it, using atomic updates of the flow and excess only. Discharging
+  /// pauses for a global relabeling, a parallel backward breadth-first search
+  /// over the residual graph from the sink, every global_relabel_interval
+  /// relabels per node and whenever a height empties (the gap heuristic).
+  static MaxFlowPlan PushRelabel(
+      uint32_t global_relabel_interval = kDefaultGlobalRelabelInterval) {
+    return {kCPU, kPushRelabel, global_relabel_interval};
+  }
+};
+
+/// Compute a maximum flow from source to sink. The capacities are taken from
+/// the edge property named capacity_property_name, which may be a 32- or
+/// 64-bit sign or unsigned int and may not be negative. Parallel and
+/// antiparallel edges are separate arcs.
+/// The properties named output_flow_property_name and
+/// output_cut_property_name are created by this function and may not exist
+/// before the call. The flow property is an edge property of the same type as
+/// the capacities holding the flow on each edge. The cut property is a uint8_t
+/// node property that is 1 on the source side of a minimum cut, the nodes
+/// that cannot reach the sink in the residual graph, and 0 elsewhere.
+KATANA_EXPORT Result<void> MaxFlow(
+    PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_flow_property_name,
+    const std::string& output_cut_property_name, katana::TxnContext* txn_ctx,
+    MaxFlowPlan plan = {});
+
+/// Check that the flow respects the capacities and is conserved at every node
+/// but source and sink, and that the cut saturates every edge out of the
+/// source side and carries no flow back into it, so the flow is maximum.
+KATANA_EXPORT Result<void> MaxFlowAssertValid(
+    PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& capacity_property_name,
+    const std::string& flow_property_name,
+    const std::string& cut_property_name);
+
+struct KATANA_EXPORT MaxFlowStatistics {
+  /// The value of the flow, i.e., the net flow out of the source.
+  uint64_t flow_value;
+  /// The number of nodes on the source side of the cut.
+  uint64_t source_side_size;
+  /// The number of edges from the source side to the sink side of the cut.
+  uint64_t cut_edges;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MaxFlowStatistics> Compute(
+      PropertyGraph* pg, size_t source, const std::string& flow_property_name,
+      const std::string& cut_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include "katana/Properties.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for MinimumSpanningForest, specifying the
+/// algorithm and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  enum Algorithm {
+    kBoruvka,
+    kFilterKruskal,
+  };
+
+  static const uint64_t kDefaultBaseCaseSize = 1 << 16;
+
+private:
+  Algorithm algorithm_;
+  uint64_t base_case_size_;
+
+  MinimumSpanningForestPlan(
+      Architecture architecture, Algorithm algorithm, uint64_t base_case_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        base_case_size_(base_case_size) {}
+
+public:
+  MinimumSpanningForestPlan()
+      : MinimumSpanningForestPlan(kCPU, kBoruvka, kDefaultBaseCaseSize) {}
+
+  MinimumSpanningForestPlan& operator=(const MinimumSpanningForestPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of edges below which FilterKruskal sorts and runs Kruskal's
+  /// algorithm instead of partitioning the edges further
+  uint64_t base_case_size() const { return base_case_size_; }
+
+  /// Parallel Boruvka. In each round every tree picks its lightest edge to
+  /// another tree, the trees are merged along the picked edges, and the edges
+  /// within a tree are dropped, so the edge list shrinks as the trees grow.
+  static MinimumSpanningForestPlan Boruvka() {
+    return {kCPU, kBoruvka, kDefaultBaseCaseSize};
+  }
+
+  /// Filter-Kruskal (Osipov, Sanders, Singler 2009). The edges are split
+  /// around a pivot weight by a parallel partition; the light half is done
+  /// first, then the heavy edges within a tree are filtered out in parallel
+  /// before the heavy half is done. Edge lists of up to base_case_size
+  /// edges are sorted in parallel and added by Kruskal's algorithm. This does
+  /// well on dense graphs, where most heavy edges are never sorted.
+  static MinimumSpanningForestPlan FilterKruskal(
+      uint64_t base_case_size = kDefaultBaseCaseSize) {
+    return {kCPU, kFilterKruskal, base_case_size};
+  }
+};
+
+/// Compute a minimum spanning forest of the graph, i.e., a minimum spanning
+/// tree of each of its connected components. The graph must be symmetric and
+/// self loops are ignored. The edge weights are taken from the property named
+/// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int, or a float or double). Ties between equal weights are broken by edge
+/// id, so every algorithm computes the same forest.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint8_t and is 1
+/// on the edges of the forest and 0 elsewhere. Of the two directions of a
+/// forest edge only the one from the smaller to the larger node id is marked.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MinimumSpanningForestPlan plan = {});
+
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The number of trees of the forest, counting isolated nodes.
+  uint64_t num_trees;
+  /// The number of edges of the forest.
+  uint64_t num_forest_edges;
+  /// The total weight of the edges of the forest.
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORSAMPLING_NEIGHBORSAMPLING_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// One hop of a sampled mini-batch in CSR form. Row i holds the sampled
+/// neighbors of destination node i: src_indices[indptr[i], indptr[i + 1])
+/// are their positions in src_nodes. The destination nodes are the first
+/// num_dst_nodes entries of src_nodes, so a GNN layer that reads the source
+/// nodes of a block writes the source nodes of the next one.
+struct KATANA_EXPORT SampledBlock {
+  uint64_t num_dst_nodes{0};
+  /// Nodes of the graph this block reads, destination nodes first
+  katana::NUMAArray<uint32_t> src_nodes;
+  /// num_dst_nodes + 1 offsets into src_indices
+  katana::NUMAArray<uint64_t> indptr;
+  katana::NUMAArray<uint32_t> src_indices;
+  /// Property indices of the sampled edges, parallel to src_indices
+  katana::NUMAArray<uint64_t> edge_ids;
+
+  uint64_t num_src_nodes() const { return src_nodes.size(); }
+  uint64_t num_edges() const { return src_indices.size(); }
+};
+
+/// The sampled computation graph of a batch of seed nodes
+struct KATANA_EXPORT NeighborSample {
+  /// One block per hop, from the input layer to the seeds as the layers of a
+  /// GNN consume them: the destination nodes of blocks.back() are the seeds,
+  /// and the destination nodes of blocks[i] are the source nodes of
+  /// blocks[i + 1].
+  std::vector<SampledBlock> blocks;
+  /// The feature properties of the sampler gathered for the source nodes of
+  /// blocks.front(), one row per node in the same order
+  std::shared_ptr<arrow::Table> node_features;
+
+  const katana::NUMAArray<uint32_t>& input_nodes() const {
+    return blocks.front().src_nodes;
+  }
+};
+
+/// Samples the k-hop neighborhoods of seed nodes to feed mini-batch GNN
+/// training. Each hop keeps up to a fanout of the edges of every node it
+/// reaches, chosen uniformly without replacement, either over all edges or
+/// separately for each edge type.
+///
+/// A sampler keeps one entry per node of scratch space and is not safe to use
+/// from several threads at once; use one sampler per data loader worker.
+class KATANA_EXPORT NeighborSampler {
+public:
+  using Node = katana::PropertyGraph::Node;
+
+  /// The edges along which messages reach a node: its in-edges, as in most
+  /// GNNs, or its out-edges
+  enum Direction { kInEdges, kOutEdges };
+
+  /// Number of edges of one type to keep per node at one hop
+  struct TypedFanout {
+    katana::EntityTypeID edge_type;
+    uint32_t fanout;
+  };
+
+  /// Keep up to fanouts[h] edges of each node at hop h, counting hops from the
+  /// seeds. The fixed width node properties named in feature_properties, e.g.,
+  /// FixedSizedBinaryPODArrayProperty columns, are gathered for the input
+  /// nodes of every sample.
+  static Result<std::unique_ptr<NeighborSampler>> Make(
+      katana::PropertyGraph* pg, const std::vector<uint32_t>& fanouts,
+      const std::vector<std::string>& feature_properties = {},
+      Direction direction = kInEdges);
+
+  /// Keep up to fanout edges of each listed type of each node at hop h for
+  /// every TypedFanout of typed_fanouts[h]. Edges of other types are not
+  /// followed at that hop.
+  static Result<std::unique_ptr<NeighborSampler>> Make(
+      katana::PropertyGraph* pg,
+      const std::vector<std::vector<TypedFanout>>& typed_fanouts,
+      const std::vector<std::string>& feature_properties = {},
+      Direction direction = kInEdges);
+
+  /// Sample the neighborhoods of seeds, which must be distinct. The sample
+  /// only depends on the graph, the fanouts, seeds and random_seed.
+  Result<NeighborSample> Sample(
+      const std::vector<Node>& seeds, uint32_t random_seed = 0);
+
+  uint32_t num_hops() const { return typed_fanouts_.size(); }
+
+private:
+  NeighborSampler(
+      katana::PropertyGraph* pg,
+      std::vector<std::vector<TypedFanout>>&& typed_fanouts, bool typed,
+      Direction direction,
+      std::vector<std::shared_ptr<arrow::Array>>&& features,
+      std::vector<std::string>&& feature_names);
+
+  template <typename View>
+  Result<NeighborSample> SampleWithView(
+      const View& view, const std::vector<Node>& seeds, uint32_t random_seed);
+
+  katana::PropertyGraph* pg_;
+  /// The fanouts of every hop; for untyped fanouts a single entry whose edge
+  /// type is ignored
+  std::vector<std::vector<TypedFanout>> typed_fanouts_;
+  bool typed_;
+  Direction direction_;
+  std::vector<std::shared_ptr<arrow::Array>> features_;
+  std::vector<std::string> feature_names_;
+  /// Position of a node in the source nodes of the block being built, or
+  /// kNotSampled
+  katana::NUMAArray<uint32_t> position_;
+};
+
+}  // namespace katana::analytics
+
+#endif
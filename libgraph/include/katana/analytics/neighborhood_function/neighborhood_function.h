@@ -0,0 +1,126 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORHOODFUNCTION_NEIGHBORHOODFUNCTION_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_NEIGHBORHOODFUNCTION_NEIGHBORHOODFUNCTION_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for NeighborhoodFunction.
+class NeighborhoodFunctionPlan : public Plan {
+public:
+  enum Algorithm {
+    kHyperAnf,
+  };
+
+  /// 64 registers per node, a relative standard error of about 13% per node
+  /// and much less on the sums over all nodes
+  static const uint32_t kDefaultLog2Registers = 6;
+  static const uint32_t kDefaultMaxIterations = 1000;
+  static const uint32_t kDefaultSeed = 0;
+
+  static const uint32_t kMinLog2Registers = 4;
+  static const uint32_t kMaxLog2Registers = 12;
+
+private:
+  Algorithm algorithm_;
+  uint32_t log2_registers_;
+  uint32_t max_iterations_;
+  uint32_t seed_;
+
+  NeighborhoodFunctionPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t log2_registers,
+      uint32_t max_iterations, uint32_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        log2_registers_(log2_registers),
+        max_iterations_(max_iterations),
+        seed_(seed) {}
+
+public:
+  NeighborhoodFunctionPlan()
+      : NeighborhoodFunctionPlan{
+            kCPU, kHyperAnf, kDefaultLog2Registers, kDefaultMaxIterations,
+            kDefaultSeed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Each node has 2^log2_registers HyperLogLog registers of one byte
+  uint32_t log2_registers() const { return log2_registers_; }
+  /// The largest distance the neighborhood function is computed for; the
+  /// computation stops earlier once no counter changes
+  uint32_t max_iterations() const { return max_iterations_; }
+  /// Seed of the hash of the nodes; the same seed gives the same estimates
+  uint32_t seed() const { return seed_; }
+
+  /**
+   * Keep a HyperLogLog counter of the nodes every node reaches, and grow
+   * the balls by one hop per round: the counter of a node becomes the
+   * register-wise maximum of its own and those of its out-neighbors. The
+   * sum of the estimates of the counters after t rounds is the number of
+   * pairs at distance at most t:
+   *   Paolo Boldi, Marco Rosa, Sebastiano Vigna. HyperANF: Approximating
+   *   the Neighbourhood Function of Very Large Graphs on a Budget. WWW 2011.
+   *
+   * Only the counters of out-neighbors that changed in the previous round
+   * are merged, so late rounds, which change few counters, are cheap.
+   *
+   * @param log2_registers Log2 of the registers per node, from
+   *     kMinLog2Registers to kMaxLog2Registers; every increment halves the
+   *     variance and doubles the memory, two counters of
+   *     2^log2_registers bytes per node.
+   * @param max_iterations The largest distance computed.
+   * @param seed Seed of the hash of the nodes.
+   */
+  static NeighborhoodFunctionPlan HyperAnf(
+      uint32_t log2_registers = kDefaultLog2Registers,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      uint32_t seed = kDefaultSeed) {
+    return {kCPU, kHyperAnf, log2_registers, max_iterations, seed};
+  }
+};
+
+/// The neighborhood function of a graph and the statistics derived from it
+struct KATANA_EXPORT NeighborhoodFunctionResult {
+  /// Entry t is the estimated number of pairs (u, v), including (u, u), such
+  /// that v is at most t hops from u; entry 0 is the number of nodes. The
+  /// last entry counts all pairs with a path.
+  std::vector<double> neighborhood_function;
+
+  /// \returns the distance within which fraction of the pairs with a path
+  /// are, interpolated between integer distances; 0.9 is the usual choice
+  double EffectiveDiameter(double fraction = 0.9) const;
+
+  /// \returns the mean distance over the pairs (u, v), u != v, with a path
+  double AverageDistance() const;
+
+  /// \returns the number of rounds after which no counter changed, a lower
+  /// bound on the diameter that is usually exact
+  uint64_t diameter_lower_bound() const {
+    return neighborhood_function.empty() ? 0
+                                         : neighborhood_function.size() - 1;
+  }
+
+  /// Print the result in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Estimate the neighborhood function of pg over its out-edges, which is
+/// the basis of distance statistics such as the effective diameter, at the
+/// cost of a few passes over the edges instead of a search per node.
+///
+/// If reach_property_name is not empty, the estimated number of nodes every
+/// node reaches, itself included, is stored as a double in the node
+/// property of that name, which is created by this function and may not
+/// exist before the call.
+KATANA_EXPORT Result<NeighborhoodFunctionResult> NeighborhoodFunction(
+    PropertyGraph* pg, const std::string& reach_property_name,
+    katana::TxnContext* txn_ctx, NeighborhoodFunctionPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -2,10 +2,14 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
+#include "katana/analytics/Checkpoint.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/TimeWindow.h"
 
 namespace katana::analytics {
 
@@ -18,27 +22,33 @@ public:
     kPullResidual,
     kPushSynchronous,
     kPushAsynchronous,
+    kPullBlocked,
   };
 
   static constexpr double kDefaultTolerance = 1.0e-3;
   static const int kDefaultMaxIterations = 1000;
   static constexpr double kDefaultAlpha = 0.85;
+  static const bool kDefaultReplicateTopology = false;
 
 private:
   Algorithm algorithm_;
   float tolerance_;
   unsigned int max_iterations_;
   float alpha_;
+  bool replicate_topology_;
+  CheckpointOptions checkpoint_;
 
 public:
   PagerankPlan(
       Architecture architecture, Algorithm algorithm, float tolerance,
-      unsigned int max_iterations, float alpha)
+      unsigned int max_iterations, float alpha,
+      bool replicate_topology = kDefaultReplicateTopology)
       : Plan(architecture),
         algorithm_(algorithm),
         tolerance_(tolerance),
         max_iterations_(max_iterations),
-        alpha_(alpha) {}
+        alpha_(alpha),
+        replicate_topology_(replicate_topology) {}
 
   constexpr static const unsigned kChunkSize = 16U;
 
@@ -55,25 +65,65 @@ public:
   unsigned int max_iterations() const { return max_iterations_; }
   float alpha() const { return alpha_; }
   float initial_residual() const { return 1 - alpha_; }
+  /// Read the topology from a copy on the socket of each thread (see
+  /// TopologyReplicas); only the pull algorithms other than kPullBlocked
+  /// use it
+  bool replicate_topology() const { return replicate_topology_; }
+
+  /// Where and how often kPullTopological saves the ranks between rounds;
+  /// see CheckpointOptions. Off by default.
+  const CheckpointOptions& checkpoint() const { return checkpoint_; }
+
+  /// \returns a copy of this plan that saves checkpoints as checkpoint says
+  PagerankPlan WithCheckpoint(CheckpointOptions checkpoint) const {
+    PagerankPlan plan = *this;
+    plan.checkpoint_ = std::move(checkpoint);
+    return plan;
+  }
 
   /// Topological pull algorithm
   ///
   /// The graph must be transposed to use this algorithm.
+  /// With replicate_topology, every socket reads the in-edges from its own
+  /// copy of the transpose.
   static PagerankPlan PullTopological(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha,
+      bool replicate_topology = kDefaultReplicateTopology) {
+    return {
+        kCPU, kPullTopological, tolerance, max_iterations, alpha,
+        replicate_topology};
+  }
+
+  /// Topological algorithm with propagation blocking
+  ///
+  /// The same iteration as kPullTopological, but instead of reading the
+  /// ranks of in-neighbors at random, each iteration scans the sources in
+  /// order, writes their contributions to bins by destination block and then
+  /// sums each block's bins into ranks that fit in the last-level cache. It
+  /// is faster when the ranks do not fit in cache, at the cost of 8 bytes of
+  /// bins per edge. It runs on the graph as is, not on its transpose.
+  static PagerankPlan PullBlocked(
       float tolerance = kDefaultTolerance,
       unsigned int max_iterations = kDefaultMaxIterations,
       float alpha = kDefaultAlpha) {
-    return {kCPU, kPullTopological, tolerance, max_iterations, alpha};
+    return {kCPU, kPullBlocked, tolerance, max_iterations, alpha};
   }
 
   /// Delta-residual pull algorithm
   ///
   /// The graph must be transposed to use this algorithm.
+  /// With replicate_topology, every socket reads the in-edges from its own
+  /// copy of the transpose.
   static PagerankPlan PullResidual(
       float tolerance = kDefaultTolerance,
       unsigned int max_iterations = kDefaultMaxIterations,
-      float alpha = kDefaultAlpha) {
-    return {kCPU, kPullResidual, tolerance, max_iterations, alpha};
+      float alpha = kDefaultAlpha,
+      bool replicate_topology = kDefaultReplicateTopology) {
+    return {
+        kCPU, kPullResidual, tolerance, max_iterations, alpha,
+        replicate_topology};
   }
 
   /// Asynchronous push algorithm
@@ -112,6 +162,142 @@ KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, PagerankPlan plan = {});
 
+/// Update the Page Rank of each node after the edges in added_edges, given
+/// as (source, destination) pairs, were added to the graph, instead of
+/// computing it from scratch.
+///
+/// previous_rank_property_name holds the ranks computed before the edges
+/// were added by kPullResidual, kPushSynchronous or kPushAsynchronous with
+/// the same alpha (kPullTopological ranks are scaled differently). The
+/// change the new edges make to each node's residual is derived from the
+/// previous ranks and pushed through the graph as in kPushAsynchronous until
+/// every residual is at most plan.tolerance(); the algorithm of the plan is
+/// ignored.
+///
+/// The residuals left by the previous computation are not known and are
+/// treated as zero. After k incremental updates on top of a full computation,
+/// each residual is thus at most (k + 1) * plan.tolerance() and the L1
+/// distance from the exact ranks is at most
+/// (k + 1) * tolerance * NumNodes / (1 - alpha); a periodic full computation
+/// resets k.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> PagerankIncremental(
+    PropertyGraph* pg, const std::string& previous_rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& added_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PagerankPlan plan = {});
+
+/// Compute the Page Rank of each node over the edges whose timestamp, the
+/// value of the edge property window.timestamp_property, is in
+/// [window.begin, window.end); other edges are treated as absent, including
+/// in the out-degrees. The edges are read through the TransposedTemporal
+/// view, which PGViewCache keeps across calls, so sliding the window over
+/// the same graph does not rebuild it.
+///
+/// The computation is always kPullTopological; the tolerance, maximum
+/// number of iterations and alpha of the plan are used.
+///
+/// The property named output_property_name is created by this function and
+/// may not exist before the call.
+KATANA_EXPORT Result<void> PagerankInTimeWindow(
+    PropertyGraph* pg, const TimeWindow& window,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PagerankPlan plan = {});
+
+/// A computational plan for Personalized PageRank: the probability that a
+/// random walk from the sources, which goes on with probability alpha after
+/// each step, stops at each node. A walk that reaches a node without
+/// out-edges stops there.
+class PersonalizedPagerankPlan : public Plan {
+public:
+  enum Algorithm {
+    kForwardPush,
+    kMonteCarlo,
+  };
+
+  static constexpr double kDefaultTolerance = 1.0e-6;
+  static constexpr double kDefaultAlpha = 0.85;
+  static const uint64_t kDefaultNumWalks = 100000;
+  static const uint32_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  double tolerance_;
+  double alpha_;
+  uint64_t num_walks_;
+  uint32_t seed_;
+
+  PersonalizedPagerankPlan(
+      Architecture architecture, Algorithm algorithm, double tolerance,
+      double alpha, uint64_t num_walks, uint32_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        tolerance_(tolerance),
+        alpha_(alpha),
+        num_walks_(num_walks),
+        seed_(seed) {}
+
+public:
+  PersonalizedPagerankPlan()
+      : PersonalizedPagerankPlan(
+            kCPU, kForwardPush, kDefaultTolerance, kDefaultAlpha,
+            kDefaultNumWalks, kDefaultSeed) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Residual per out-edge left unpushed by kForwardPush
+  double tolerance() const { return tolerance_; }
+  double alpha() const { return alpha_; }
+  /// Walks started by kMonteCarlo, spread evenly over the sources
+  uint64_t num_walks() const { return num_walks_; }
+  uint32_t seed() const { return seed_; }
+
+  /// Forward push (local push) algorithm
+  ///
+  /// Residual probability mass starts on the sources and is pushed along
+  /// out-edges until the residual of each node is at most tolerance times
+  /// its out-degree, so each score is underestimated by at most that much.
+  /// Only nodes that receive mass are touched, and there are at most
+  /// 1 / ((1 - alpha) * tolerance) pushes, whatever the size of the graph.
+  ///
+  /// R. Andersen, F. Chung and K. Lang. Local graph partitioning using
+  /// PageRank vectors. In: FOCS 2006, p. 475-486.
+  static PersonalizedPagerankPlan ForwardPush(
+      double tolerance = kDefaultTolerance, double alpha = kDefaultAlpha) {
+    return {
+        kCPU, kForwardPush, tolerance, alpha, kDefaultNumWalks, kDefaultSeed};
+  }
+
+  /// Monte Carlo algorithm
+  ///
+  /// The score of a node is the fraction of num_walks random walks that
+  /// stop at it, with a standard error of at most 0.5 / sqrt(num_walks).
+  /// The walks, and so the scores, only depend on the seed.
+  static PersonalizedPagerankPlan MonteCarlo(
+      uint64_t num_walks = kDefaultNumWalks, double alpha = kDefaultAlpha,
+      uint32_t seed = kDefaultSeed) {
+    return {kCPU, kMonteCarlo, kDefaultTolerance, alpha, num_walks, seed};
+  }
+};
+
+/// Compute the Personalized PageRank of each node for a walk that starts at
+/// a source picked uniformly from sources. The property named
+/// output_property_name (float) is created by this function and may not
+/// exist before the call.
+KATANA_EXPORT Result<void> PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PersonalizedPagerankPlan plan = {});
+
+/// \returns the k nodes with the highest Personalized PageRank for sources,
+/// with their scores, from the highest score to the lowest. Nothing is
+/// written to pg, and only the nodes that the algorithm reaches are visited.
+KATANA_EXPORT Result<std::vector<std::pair<uint32_t, float>>>
+PersonalizedPagerankTopK(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources, size_t k,
+    PersonalizedPagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
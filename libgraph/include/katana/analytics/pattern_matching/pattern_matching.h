@@ -0,0 +1,150 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_PATTERNMATCHING_PATTERNMATCHING_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_PATTERNMATCHING_PATTERNMATCHING_H_
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A small connected graph whose occurrences are to be found in a property
+/// graph.
+///
+/// A pattern node may be restricted to nodes of a node type and to nodes
+/// accepted by a filter. Pattern edges without an edge type are undirected.
+/// An edge with an edge type is directed, and matches an edge of exactly that
+/// type from the match of its source to the match of its destination.
+///
+/// An induced pattern also requires that there is no edge between the
+/// matches of two pattern nodes that are not adjacent in the pattern.
+class KATANA_EXPORT Pattern {
+public:
+  using Node = GraphTopologyTypes::Node;
+  /// Filters are called concurrently by the matching threads
+  using NodeFilter = std::function<bool(Node)>;
+
+  struct Edge {
+    size_t src;
+    size_t dst;
+    std::optional<EntityTypeID> edge_type;
+  };
+
+  explicit Pattern(bool induced = false) : induced_(induced) {}
+
+  /// Add a node to the pattern
+  ///
+  /// @param node_type the type matched nodes must have, if any
+  /// @param filter a predicate matched nodes must satisfy, if any
+  /// @returns the index of the new pattern node
+  size_t AddNode(
+      std::optional<EntityTypeID> node_type = std::nullopt,
+      NodeFilter filter = nullptr);
+
+  /// Add an edge between the pattern nodes src and dst. There may be at most
+  /// one edge between two pattern nodes.
+  void AddEdge(
+      size_t src, size_t dst,
+      std::optional<EntityTypeID> edge_type = std::nullopt);
+
+  size_t num_nodes() const { return node_types_.size(); }
+  const std::vector<Edge>& edges() const { return edges_; }
+  const std::optional<EntityTypeID>& node_type(size_t node) const {
+    return node_types_[node];
+  }
+  const NodeFilter& node_filter(size_t node) const {
+    return node_filters_[node];
+  }
+  bool induced() const { return induced_; }
+
+  /// The complete graph on size nodes
+  static Pattern Clique(size_t size, bool induced = false);
+  /// The cycle through size nodes; size must be at least 3
+  static Pattern Cycle(size_t size, bool induced = false);
+  /// The path through size nodes
+  static Pattern Path(size_t size, bool induced = false);
+  /// A center node adjacent to size - 1 leaves
+  static Pattern Star(size_t size, bool induced = false);
+
+private:
+  std::vector<std::optional<EntityTypeID>> node_types_;
+  std::vector<NodeFilter> node_filters_;
+  std::vector<Edge> edges_;
+  bool induced_;
+};
+
+/// A computational plan to for pattern matching, specifying the algorithm
+/// and any parameters associated with it.
+class PatternMatchingPlan : public Plan {
+public:
+  enum Algorithm {
+    kGenericJoin,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  PatternMatchingPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  PatternMatchingPlan() : PatternMatchingPlan(kCPU, kGenericJoin) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Worst-case optimal join, one pattern node at a time (Ngo, Ré and
+  /// Rudra. Skew Strikes Back: New Developments in the Theory of Join
+  /// Algorithms. SIGMOD Record 2013). The candidates for a pattern node are
+  /// the intersection of the sorted neighbors of the matches of its
+  /// adjacent, already matched, pattern nodes. Nodes are matched in order of
+  /// their connection to the ones before, and the automorphisms of the
+  /// pattern are broken with ordering conditions on the matches as in
+  /// Grochow and Kellis, so each subgraph is found once. The matches grown
+  /// from different graph nodes are searched in parallel, with work
+  /// stealing.
+  static PatternMatchingPlan GenericJoin() { return {kCPU, kGenericJoin}; }
+};
+
+/// Count the subgraphs of pg that match pattern. A subgraph is counted once
+/// regardless of how many automorphisms of the pattern map onto it. Patterns
+/// may have up to 8 nodes.
+///
+/// The graph must be symmetric and have no self loops or parallel edges.
+///
+/// @param pg The graph to process.
+/// @param pattern The pattern to find.
+/// @param plan
+KATANA_EXPORT Result<uint64_t> CountPatternMatches(
+    PropertyGraph* pg, const Pattern& pattern, PatternMatchingPlan plan = {});
+
+/// Calls fn for each subgraph counted by CountPatternMatches with the matches
+/// of the pattern nodes, in the order of the pattern nodes. fn is called
+/// concurrently by the matching threads.
+KATANA_EXPORT Result<void> ForEachPatternMatch(
+    PropertyGraph* pg, const Pattern& pattern,
+    const std::function<void(const std::vector<GraphTopologyTypes::Node>&)>&
+        fn,
+    PatternMatchingPlan plan = {});
+
+struct KATANA_EXPORT MotifCount {
+  /// An induced pattern for the shape
+  Pattern pattern;
+  /// The number of induced subgraphs with the shape
+  uint64_t count;
+};
+
+/// Count the induced subgraphs of pg with size nodes of each connected
+/// shape, for sizes from 2 to 5. The graph must be symmetric and have no
+/// self loops or parallel edges.
+///
+/// @returns a count for each connected graph with size nodes up to
+/// isomorphism
+KATANA_EXPORT Result<std::vector<MotifCount>> CountMotifs(
+    PropertyGraph* pg, size_t size, PatternMatchingPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -1,11 +1,13 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
+#include <functional>
 #include <iostream>
 
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/NUMAArray.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -140,6 +142,46 @@ public:
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Random walks stored back to back in one preallocated array. Walk i of the
+/// batch is walk first_walk + i of all walks and goes through the nodes
+/// nodes[i * stride, i * stride + lengths[i]). It starts at node
+/// (first_walk + i) % NumNodes(), and is empty if that node has no neighbors.
+struct KATANA_EXPORT RandomWalksBatch {
+  uint64_t first_walk{0};
+  uint64_t num_walks{0};
+  /// walk_length + 1, the most nodes on a walk
+  uint32_t stride{0};
+  katana::NUMAArray<uint32_t> nodes;
+  katana::NUMAArray<uint32_t> lengths;
+
+  const uint32_t* walk_begin(uint64_t i) const {
+    return nodes.data() + i * stride;
+  }
+  const uint32_t* walk_end(uint64_t i) const {
+    return walk_begin(i) + lengths[i];
+  }
+};
+
+/// Node2vec walks of pg, all in one flat array. The pg is expected to be
+/// symmetric. If edge_weight_property_name is not empty, a step follows an
+/// edge with probability proportional to its weight times the second-order
+/// bias of the plan; otherwise all edges weigh the same. The walks only
+/// depend on the graph and the plan.
+KATANA_EXPORT Result<RandomWalksBatch> RandomWalksFlat(
+    PropertyGraph* pg, const std::string& edge_weight_property_name = "",
+    RandomWalksPlan plan = RandomWalksPlan());
+
+using RandomWalksSink = std::function<Result<void>(const RandomWalksBatch&)>;
+
+/// The walks of RandomWalksFlat, handed to sink batch_size walks at a time in
+/// order of first_walk, so that only one batch is in memory. The batch is
+/// reused once sink returns. Stops at the first error of sink. A graph
+/// without nodes gives one empty batch.
+KATANA_EXPORT Result<void> StreamRandomWalks(
+    PropertyGraph* pg, uint64_t batch_size, const RandomWalksSink& sink,
+    const std::string& edge_weight_property_name = "",
+    RandomWalksPlan plan = RandomWalksPlan());
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
@@ -0,0 +1,146 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_REACHABILITY_REACHABILITY_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_REACHABILITY_REACHABILITY_H_
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/PropertyGraph.h"
+#include "katana/ReachabilityIndexPrimitive.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for building a ReachabilityIndex.
+class ReachabilityIndexPlan : public Plan {
+public:
+  enum Algorithm {
+    kGrail,
+  };
+
+  static const uint32_t kDefaultNumTraversals = 5;
+  static const uint32_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  uint32_t num_traversals_;
+  uint32_t seed_;
+
+  ReachabilityIndexPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t num_traversals,
+      uint32_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        num_traversals_(num_traversals),
+        seed_(seed) {}
+
+public:
+  ReachabilityIndexPlan()
+      : ReachabilityIndexPlan{
+            kCPU, kGrail, kDefaultNumTraversals, kDefaultSeed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of randomized traversals that label the components
+  uint32_t num_traversals() const { return num_traversals_; }
+  /// Seed of the traversal orders; the same seed gives the same index
+  uint32_t seed() const { return seed_; }
+
+  /**
+   * Condense the strongly connected components into a DAG and label every
+   * component with its topological level and with the interval of
+   * post-order ranks it reaches in num_traversals randomized depth-first
+   * traversals of the DAG. A component can only reach components of higher
+   * level whose intervals all lie within its own:
+   *   Hilmi Yildirim, Vineet Chaoji, Mohammed J. Zaki. GRAIL: Scalable
+   *   Reachability Index for Large Graphs. VLDB 2010.
+   *
+   * More traversals answer more queries from the labels alone, at the cost
+   * of 8 bytes per component and traversal.
+   *
+   * @param num_traversals The number of labels per component, at least 1.
+   * @param seed Seed of the traversal orders.
+   */
+  static ReachabilityIndexPlan Grail(
+      uint32_t num_traversals = kDefaultNumTraversals,
+      uint32_t seed = kDefaultSeed) {
+    return {kCPU, kGrail, num_traversals, seed};
+  }
+};
+
+/// An index of the graph that answers whether one node can reach another
+/// over directed paths in microseconds, instead of with a search of the
+/// graph per query.
+///
+/// Nodes in the same strongly connected component reach each other, so the
+/// index works on the DAG of the components, which is often much smaller
+/// than the graph. Most queries are answered by comparing the labels of the
+/// two components; the rest search the DAG from the source, skipping the
+/// components whose labels prove that they cannot reach the target.
+///
+/// The index is stored as an optional datastructure of the RDG, next to the
+/// RDKit indexes, so it is built once and loaded by every process that
+/// answers queries on the graph. It does not follow later changes to the
+/// topology and must be built again after them.
+class KATANA_EXPORT ReachabilityIndex {
+public:
+  /// (source, target) pairs
+  using QueryList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+  ReachabilityIndex(const ReachabilityIndex&) = delete;
+  ReachabilityIndex& operator=(const ReachabilityIndex&) = delete;
+  ReachabilityIndex(ReachabilityIndex&&) = default;
+  ReachabilityIndex& operator=(ReachabilityIndex&&) = default;
+
+  /// Build the index of the out-edges of pg in parallel.
+  static Result<ReachabilityIndex> Build(
+      PropertyGraph* pg, ReachabilityIndexPlan plan = {});
+
+  /// Load the index written with pg by Write. Fails with InvalidArgument if
+  /// it was built for a graph with other numbers of nodes or edges.
+  ///
+  /// \returns std::nullopt if no index was written with pg
+  static Result<std::optional<ReachabilityIndex>> Load(PropertyGraph* pg);
+
+  /// Write the index to the storage of pg now, replacing any index written
+  /// before; it is kept by the next store of pg.
+  Result<void> Write(PropertyGraph* pg);
+
+  uint64_t num_nodes() const { return primitive_.num_nodes(); }
+  uint64_t num_components() const { return primitive_.num_components(); }
+
+  /// \returns true if there is a directed path from source to target; every
+  /// node reaches itself. Both must be nodes of the graph.
+  bool CanReach(uint32_t source, uint32_t target) const;
+
+  /// Answer every query of \p queries in parallel.
+  ///
+  /// \returns a bitset whose bit i is set iff the source of queries[i] can
+  /// reach its target; fails with InvalidArgument, without answering any
+  /// query, if a query has an end that is not a node
+  Result<DynamicBitset> CanReach(const QueryList& queries) const;
+
+private:
+  explicit ReachabilityIndex(ReachabilityIndexPrimitive&& primitive);
+
+  uint32_t Level(uint32_t component) const {
+    return labels_[uint64_t{component} * label_width_];
+  }
+  bool SearchDag(uint32_t source, uint32_t target) const;
+  /// false if the labels prove that source cannot reach target
+  bool MayReach(uint32_t source, uint32_t target) const;
+  /// true if the labels prove that source reaches target
+  bool SurelyReaches(uint32_t source, uint32_t target) const;
+
+  ReachabilityIndexPrimitive primitive_;
+  const uint32_t* components_{nullptr};
+  const uint64_t* dag_indices_{nullptr};
+  const uint32_t* dag_dests_{nullptr};
+  const uint32_t* labels_{nullptr};
+  uint32_t label_width_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
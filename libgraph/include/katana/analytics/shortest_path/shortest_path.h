@@ -0,0 +1,115 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SHORTESTPATH_SHORTESTPATH_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_SHORTESTPATH_SHORTESTPATH_H_
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+
+namespace katana::analytics {
+
+/// The distances from a few landmark nodes to every node, which bound the
+/// length of shortest paths from below for ShortestPath: by the triangle
+/// inequality, d(L, v) + d(v, t) >= d(L, t) for every landmark L, so
+/// d(v, t) >= d(L, t) - d(L, v), and likewise d(s, v) >= d(L, v) - d(L, s).
+/// Searches guided by the bounds settle the nodes towards the target first
+/// (A*, landmarks and the triangle inequality, ALT):
+///   Andrew V. Goldberg, Chris Harrelson. Computing the Shortest Path: A*
+///   Search Meets Graph Theory. SODA 2005.
+///
+/// The distances are node properties, one per landmark, as written by
+/// MultiSourceSssp, so an index built once can be stored with the graph and
+/// loaded by every process that answers queries on it. Landmarks at the
+/// periphery of the graph give the tightest bounds.
+class KATANA_EXPORT LandmarkIndex {
+public:
+  /// Compute the distances from each of landmarks over the edge weights in
+  /// the property named edge_weight_property_name, or over unit weights if
+  /// it is empty, into the node properties named property_names, one per
+  /// landmark, and load them. The properties are created by this function
+  /// and may not exist before the call.
+  static Result<LandmarkIndex> Build(
+      PropertyGraph* pg, const std::vector<uint32_t>& landmarks,
+      const std::string& edge_weight_property_name,
+      const std::vector<std::string>& property_names, TxnContext* txn_ctx);
+
+  /// Load the distances in the node properties named property_names, as
+  /// written by Build. Distances of at least the maximum value of their type
+  /// divided by 4 mean unreachable, as Sssp writes them.
+  static Result<LandmarkIndex> Load(
+      PropertyGraph* pg, const std::vector<std::string>& property_names);
+
+  /// \returns the num_landmarks nodes of highest out-degree, a choice that
+  /// needs no search; pass peripheral nodes to Build instead if they are
+  /// known
+  static std::vector<uint32_t> ChooseByDegree(
+      const PropertyGraph* pg, size_t num_landmarks);
+
+  size_t num_landmarks() const { return num_landmarks_; }
+
+  uint64_t num_nodes() const {
+    return num_landmarks_ == 0 ? 0 : distances_.size() / num_landmarks_;
+  }
+
+  /// \returns the distance from landmark i to node n, or infinity if n is not
+  /// reachable from it
+  double Distance(size_t i, uint32_t n) const {
+    return distances_[uint64_t{n} * num_landmarks_ + i];
+  }
+
+private:
+  LandmarkIndex(size_t num_landmarks, katana::NUMAArray<double>&& distances)
+      : num_landmarks_(num_landmarks), distances_(std::move(distances)) {}
+
+  size_t num_landmarks_{0};
+  /// The distances of each node to all landmarks are next to each other, so
+  /// computing the bounds of a node reads one cache line for a few landmarks
+  katana::NUMAArray<double> distances_;
+};
+
+struct KATANA_EXPORT ShortestPathResult {
+  /// The length of the path, or infinity if the target is not reachable
+  double distance{std::numeric_limits<double>::infinity()};
+  /// The nodes of a shortest path from the source to the target, both
+  /// included; empty if the target is not reachable
+  std::vector<uint32_t> path;
+  /// The number of nodes settled by the searches, a measure of the work done
+  uint64_t settled_nodes{0};
+
+  bool reachable() const { return !path.empty(); }
+
+  /// Print the result in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/// Find a shortest path from source to target over the edge weights in the
+/// property named edge_weight_property_name (which may be a 32- or 64-bit
+/// signed or unsigned int, a float or a double, and must not be negative),
+/// or over unit weights if it is empty.
+///
+/// Two Dijkstra searches run towards each other, one forward from the source
+/// over the out-edges and one backward from the target over the in-edges of
+/// PropertyGraphViews::BiDirectional, and stop once no path through their
+/// unsettled nodes can be shorter than the shortest path through a node both
+/// have reached. With landmarks, both searches are A* searches over the
+/// average of the landmark bounds towards the target and from the source,
+/// which keeps them consistent with each other, and skip the nodes that the
+/// landmarks prove to be off every path.
+///
+/// The searches are serial and keep their state in hash maps, so the cost of
+/// a query depends on the nodes it settles rather than on the size of the
+/// graph. The bidirectional view is built by the first query and reused by
+/// later ones, which may then run in parallel.
+KATANA_EXPORT Result<ShortestPathResult> ShortestPath(
+    PropertyGraph* pg, uint32_t source, uint32_t target,
+    const std::string& edge_weight_property_name,
+    const LandmarkIndex* landmarks = nullptr);
+
+}  // namespace katana::analytics
+
+#endif
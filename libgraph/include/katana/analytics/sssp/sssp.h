@@ -2,6 +2,8 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -27,6 +29,7 @@ public:
     kTopological,
     kTopologicalTile,
     kAutomatic,
+    kDeltaStepAdaptive,
   };
 
   static const int kDefaultDelta = 13;
@@ -55,12 +58,16 @@ private:
 public:
   SsspPlan() : SsspPlan{kCPU, kAutomatic, 0, 0} {}
 
+  /// Delta stepping for power-law graphs, whose diameter is small, and
+  /// adaptive delta stepping with fused buckets for the others, e.g., road
+  /// networks, whose many small buckets each cost a barrier otherwise. When
+  /// Sssp runs kAutomatic it also picks delta from the edge weights.
   SsspPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
     bool isPowerLaw = IsApproximateDegreeDistributionPowerLaw(*pg);
     if (isPowerLaw) {
       *this = DeltaStep();
     } else {
-      *this = DeltaStepBarrier();
+      *this = DeltaStepAdaptive();
     }
   }
 
@@ -88,6 +95,13 @@ public:
     return {kCPU, kDeltaStepFusion, delta, 0};
   }
 
+  /// Delta stepping with fused buckets whose step size adapts at runtime.
+  /// delta is the exponent of the finest step; each round settles as many
+  /// consecutive steps as keep the threads busy without redoing much work.
+  static SsspPlan DeltaStepAdaptive(unsigned delta = kDefaultDelta) {
+    return {kCPU, kDeltaStepAdaptive, delta, 0};
+  }
+
   static SsspPlan SerialDeltaTile(
       unsigned delta = kDefaultDelta,
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
@@ -127,6 +141,40 @@ KATANA_EXPORT Result<void> Sssp(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     SsspPlan plan = {});
 
+/// Compute shortest path lengths as Sssp does, over only the edges whose type
+/// has one of the atomic edge types named in edge_types, or all edges if
+/// edge_types is empty. The traversal reads the per type edge ranges of the
+/// EdgeTypeAwareBiDir view, which is built once and then serves every set of
+/// edge types, instead of projecting the graph. Runs delta stepping with the
+/// delta of plan, or SsspPlan::kDefaultDelta for plans without one.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> SsspByEdgeType(
+    PropertyGraph* pg, size_t start_node,
+    const std::vector<std::string>& edge_types,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    SsspPlan plan = {});
+
+/// The number of sources MultiSourceSssp runs together
+constexpr size_t kMultiSourceSsspBatchSize = 64;
+
+/// Compute the shortest path lengths from each node in sources, as Sssp does
+/// for one source. The lengths from sources[i] are stored in the property
+/// named output_property_names[i].
+///
+/// Batches of up to kMultiSourceSsspBatchSize sources run as one delta
+/// stepping computation sharing a worklist, which uses memory for a distance
+/// per node and source of the batch. Only the delta of the plan is used; the
+/// algorithm is always delta stepping.
+/// The properties named in output_property_names are created by this function
+/// and may not exist before the call.
+KATANA_EXPORT Result<void> MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::vector<std::string>& output_property_names,
+    katana::TxnContext* txn_ctx, SsspPlan plan = {});
+
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
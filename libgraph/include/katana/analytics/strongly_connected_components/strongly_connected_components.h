@@ -0,0 +1,89 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan to for StronglyConnectedComponents, specifying the
+/// algorithm and any parameters associated with it.
+class StronglyConnectedComponentsPlan : public Plan {
+public:
+  /// Algorithm selectors for strongly connected components
+  enum Algorithm { kMultistep };
+
+  static const uint32_t kDefaultSerialCutoff = 100000;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint32_t serial_cutoff_;
+
+  StronglyConnectedComponentsPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t serial_cutoff)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        serial_cutoff_(serial_cutoff) {}
+
+public:
+  StronglyConnectedComponentsPlan()
+      : StronglyConnectedComponentsPlan{
+            kCPU, kMultistep, kDefaultSerialCutoff} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// Number of nodes left at which the coloring rounds stop and Tarjan's
+  /// algorithm finds the rest serially
+  uint32_t serial_cutoff() const { return serial_cutoff_; }
+
+  /// Trim nodes without in-edges or out-edges, find the largest component
+  /// with a forward and a backward search from a node of high degree, then
+  /// alternate trimming and coloring until serial_cutoff nodes are left:
+  ///   George M. Slota, Sivasankaran Rajamanickam, Kamesh Madduri. BFS and
+  ///   Coloring-based Parallel Algorithms for Strongly Connected Components
+  ///   and Related Problems. IPDPS 2014.
+  static StronglyConnectedComponentsPlan Multistep(
+      uint32_t serial_cutoff = kDefaultSerialCutoff) {
+    return {kCPU, kMultistep, serial_cutoff};
+  }
+};
+
+/// Compute the strongly connected components of pg, following the direction
+/// of its edges.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. It holds dense component ids, from 0 to the
+/// number of components minus one.
+KATANA_EXPORT Result<void> StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx,
+    StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan());
+
+/// Check that every component in the property named property_name is strongly
+/// connected and that no cycle goes through two components.
+KATANA_EXPORT Result<void> StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT StronglyConnectedComponentsStatistics {
+  /// Total number of unique components in the graph.
+  uint64_t total_components;
+  /// Total number of components with more than 1 node.
+  uint64_t total_non_trivial_components;
+  /// The number of nodes present in the largest component.
+  uint64_t largest_component_size;
+  /// The ratio of nodes present in the largest component.
+  double largest_component_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<StronglyConnectedComponentsStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+#endif
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 
+#include <string>
+#include <vector>
+
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -57,7 +60,51 @@ SubGraphExtraction(
     katana::PropertyGraph* pg,
     const std::vector<katana::PropertyGraph::Node>& node_vec,
     SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+
+/**
+ * Construct a new sub-graph from the original graph and copy the requested
+ * properties into it.
+ *
+ * Node i of the sub-graph is the i-th distinct node of node_vec. The sub-graph
+ * keeps the entity types of its nodes and edges. The new sub-graph is
+ * independent of the original graph.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param node_properties_to_copy Node properties to copy into the sub-graph
+ * @param edge_properties_to_copy Edge properties to copy into the sub-graph
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    SubGraphExtractionPlan plan = {});
+
+/**
+ * Construct a new sub-graph from the nodes and edges of the original graph
+ * that have one of the given entity types, and copy the requested properties
+ * into it.
+ *
+ * An empty list of types selects all nodes or all edges. Only edges between
+ * selected nodes are kept. The nodes of the sub-graph are in the order of the
+ * original graph, and the sub-graph keeps the entity types of its nodes and
+ * edges. The new sub-graph is independent of the original graph.
+ *
+ * @param pg The graph to process.
+ * @param node_types Names of the atomic node types to select
+ * @param edge_types Names of the atomic edge types to select
+ * @param node_properties_to_copy Node properties to copy into the sub-graph
+ * @param edge_properties_to_copy Edge properties to copy into the sub-graph
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtractionByType(
+    katana::PropertyGraph* pg, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types,
+    const std::vector<std::string>& node_properties_to_copy = {},
+    const std::vector<std::string>& edge_properties_to_copy = {});
 
 }  // namespace katana::analytics
 
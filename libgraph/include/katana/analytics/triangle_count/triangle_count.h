@@ -3,6 +3,7 @@
 
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
+#include "katana/analytics/Sampling.h"
 
 // API
 
@@ -15,6 +16,7 @@ public:
     kNodeIteration,
     kEdgeIteration,
     kOrderedCount,
+    kEdgeSampling,
   };
 
   enum Relabeling {
@@ -25,28 +27,53 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgeSorted = false;
+  /// Hub bitmaps are off unless asked for
+  static const size_t kDefaultHubBitmapBudget = 0;
+  static const bool kDefaultReplicateTopology = false;
+  constexpr static double kDefaultSampleRate = 0.01;
+  static const uint32_t kDefaultSeed = 0;
 
 private:
   Algorithm algorithm_;
   Relabeling relabeling_;
   bool edges_sorted_;
+  size_t hub_bitmap_budget_;
+  bool replicate_topology_;
+  double sample_rate_;
+  uint32_t seed_;
 
   TriangleCountPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, size_t hub_bitmap_budget, bool replicate_topology,
+      double sample_rate = 1.0, uint32_t seed = kDefaultSeed)
       : Plan(architecture),
         algorithm_(algorithm),
         relabeling_(relabeling),
-        edges_sorted_(edges_sorted) {}
+        edges_sorted_(edges_sorted),
+        hub_bitmap_budget_(hub_bitmap_budget),
+        replicate_topology_(replicate_topology),
+        sample_rate_(sample_rate),
+        seed_(seed) {}
 
 public:
   TriangleCountPlan()
       : TriangleCountPlan{
-            kCPU, kOrderedCount, kDefaultEdgeSorted, kDefaultRelabeling} {}
+            kCPU, kOrderedCount, kDefaultEdgeSorted, kDefaultRelabeling,
+            kDefaultHubBitmapBudget, kDefaultReplicateTopology} {}
 
   Algorithm algorithm() const { return algorithm_; }
   Relabeling relabeling() const { return relabeling_; }
   bool edges_sorted() const { return edges_sorted_; }
+  /// Bytes to spend on bitmaps of the neighbors of the highest-degree nodes
+  /// (see HubBitmaps); intersections with a hub then probe its bitmap
+  size_t hub_bitmap_budget() const { return hub_bitmap_budget_; }
+  /// Read the topology from a copy on the socket of each thread (see
+  /// TopologyReplicas); costs a copy of the topology per socket
+  bool replicate_topology() const { return replicate_topology_; }
+  /// Fraction of the edges kEdgeSampling counts the triangles of
+  double sample_rate() const { return sample_rate_; }
+  /// Seed of the edge sample; the same seed picks the same edges
+  uint32_t seed() const { return seed_; }
 
   /**
    * The node-iterator algorithm from the following:
@@ -55,11 +82,17 @@ public:
    *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmap_budget Bytes of neighbor bitmaps for high-degree nodes.
+   * @param replicate_topology Copy the topology to every socket.
    */
   static TriangleCountPlan NodeIteration(
       bool edges_sorted = kDefaultEdgeSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kNodeIteration, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      size_t hub_bitmap_budget = kDefaultHubBitmapBudget,
+      bool replicate_topology = kDefaultReplicateTopology) {
+    return {
+        kCPU, kNodeIteration, edges_sorted, relabeling, hub_bitmap_budget,
+        replicate_topology};
   }
 
   /**
@@ -69,11 +102,17 @@ public:
    *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmap_budget Bytes of neighbor bitmaps for high-degree nodes.
+   * @param replicate_topology Copy the topology to every socket.
    */
   static TriangleCountPlan EdgeIteration(
       bool edges_sorted = kDefaultEdgeSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kEdgeIteration, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      size_t hub_bitmap_budget = kDefaultHubBitmapBudget,
+      bool replicate_topology = kDefaultReplicateTopology) {
+    return {
+        kCPU, kEdgeIteration, edges_sorted, relabeling, hub_bitmap_budget,
+        replicate_topology};
   }
 
   /**
@@ -84,11 +123,46 @@ public:
    *
    * @param edges_sorted Are the edges of the graph already sorted.
    * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmap_budget Bytes of neighbor bitmaps for high-degree nodes.
+   * @param replicate_topology Copy the topology to every socket.
    */
   static TriangleCountPlan OrderedCount(
       bool edges_sorted = kDefaultEdgeSorted,
-      Relabeling relabeling = kDefaultRelabeling) {
-    return {kCPU, kOrderedCount, edges_sorted, relabeling};
+      Relabeling relabeling = kDefaultRelabeling,
+      size_t hub_bitmap_budget = kDefaultHubBitmapBudget,
+      bool replicate_topology = kDefaultReplicateTopology) {
+    return {
+        kCPU, kOrderedCount, edges_sorted, relabeling, hub_bitmap_budget,
+        replicate_topology};
+  }
+
+  /**
+   * Estimate the number of triangles from a sample of the edges, after
+   * ordering the nodes by degree as in OrderedCount. Each edge (n, v) with
+   * v < n is kept with probability sample_rate, and the triangles w < v < n
+   * it closes are counted. Every triangle is closed by exactly one such
+   * edge, which makes the count divided by the rate an unbiased estimate:
+   *   Charalampos E. Tsourakakis, U Kang, Gary L. Miller, Christos Faloutsos.
+   *   DOULION: Counting Triangles in Massive Graphs with a Coin. KDD 2009.
+   *
+   * Use EstimateTriangleCount to also get the standard error.
+   *
+   * @param sample_rate Probability of keeping an edge, in (0, 1].
+   * @param seed Seed of the sample.
+   * @param edges_sorted Are the edges of the graph already sorted.
+   * @param relabeling Should the algorithm relabel the nodes.
+   * @param hub_bitmap_budget Bytes of neighbor bitmaps for high-degree nodes.
+   * @param replicate_topology Copy the topology to every socket.
+   */
+  static TriangleCountPlan EdgeSampling(
+      double sample_rate = kDefaultSampleRate, uint32_t seed = kDefaultSeed,
+      bool edges_sorted = kDefaultEdgeSorted,
+      Relabeling relabeling = kDefaultRelabeling,
+      size_t hub_bitmap_budget = kDefaultHubBitmapBudget,
+      bool replicate_topology = kDefaultReplicateTopology) {
+    return {
+        kCPU, kEdgeSampling, edges_sorted, relabeling, hub_bitmap_budget,
+        replicate_topology, sample_rate, seed};
   }
 };
 
@@ -104,6 +178,19 @@ public:
 KATANA_EXPORT katana::Result<uint64_t> TriangleCount(
     PropertyGraph* pg, TriangleCountPlan plan = {});
 
+/**
+ * Count the triangles in the graph with the standard error of the count.
+ * Sampling plans, e.g., TriangleCountPlan::EdgeSampling, return an
+ * estimate; the others return the exact count with an error of 0. The graph
+ * must be symmetric!
+ *
+ * @param pg The graph to process.
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<Estimate> EstimateTriangleCount(
+    PropertyGraph* pg,
+    TriangleCountPlan plan = TriangleCountPlan::EdgeSampling());
+
 }  // namespace katana::analytics
 
 #endif
@@ -1,6 +1,7 @@
 #include "katana/BuildGraph.h"
 
 #include <algorithm>
+#include <charconv>
 #include <cstdint>
 #include <cstdlib>
 #include <deque>
@@ -1210,8 +1211,42 @@ katana::PropertyGraphBuilder::StartNode(const std::string& id) {
 
 void
 katana::PropertyGraphBuilder::AddNodeID(const std::string& id) {
-  topology_builder_.node_indexes.insert(
-      std::pair<std::string, size_t>(id, nodes_));
+  TopologyState* topology = &topology_builder_;
+  if (topology->dense_ids) {
+    if (topology->num_dense_ids == nodes_ && id == std::to_string(nodes_)) {
+      topology->num_dense_ids++;
+      return;
+    }
+    // the IDs so far were never put in the map
+    topology->dense_ids = false;
+    for (size_t i = 0; i < topology->num_dense_ids; ++i) {
+      topology->node_indexes.emplace(std::to_string(i), i);
+    }
+  }
+  topology->node_indexes.insert(std::pair<std::string, size_t>(id, nodes_));
+}
+
+std::optional<size_t>
+katana::PropertyGraphBuilder::FindNodeIndex(const std::string& id) const {
+  const TopologyState& topology = topology_builder_;
+  if (!topology.dense_ids) {
+    auto entry = topology.node_indexes.find(id);
+    if (entry == topology.node_indexes.end()) {
+      return std::nullopt;
+    }
+    return entry->second;
+  }
+  // only the digits of std::to_string(i) name node i
+  if (id.empty() || (id[0] == '0' && id.size() > 1)) {
+    return std::nullopt;
+  }
+  size_t index = 0;
+  auto [end, ec] = std::from_chars(id.data(), id.data() + id.size(), index);
+  if (ec != std::errc() || end != id.data() + id.size() ||
+      index >= topology.num_dense_ids) {
+    return std::nullopt;
+  }
+  return index;
 }
 
 void
@@ -1312,14 +1347,16 @@ katana::PropertyGraphBuilder::AddEdgeSource(const std::string& source) {
   if (!building_edge_) {
     return;
   }
-  auto src_entry = topology_builder_.node_indexes.find(source);
-  if (src_entry != topology_builder_.node_indexes.end()) {
-    topology_builder_.sources.emplace_back(
-        static_cast<uint32_t>(src_entry->second));
-    topology_builder_.out_indices[src_entry->second]++;
+  // dense IDs are resolved right away, all others in parallel at the end
+  std::optional<size_t> src_index;
+  if (topology_builder_.dense_ids) {
+    src_index = FindNodeIndex(source);
+  }
+  if (src_index) {
+    topology_builder_.sources.emplace_back(static_cast<uint32_t>(*src_index));
+    topology_builder_.out_indices[*src_index]++;
   } else {
-    topology_builder_.sources_intermediate.insert(
-        std::pair<size_t, std::string>(edges_, source));
+    topology_builder_.sources_intermediate.emplace_back(edges_, source);
     topology_builder_.sources.emplace_back(
         std::numeric_limits<uint32_t>::max());
   }
@@ -1330,13 +1367,15 @@ katana::PropertyGraphBuilder::AddEdgeTarget(const std::string& target) {
   if (!building_edge_) {
     return;
   }
-  auto dest_entry = topology_builder_.node_indexes.find(target);
-  if (dest_entry != topology_builder_.node_indexes.end()) {
+  std::optional<size_t> dest_index;
+  if (topology_builder_.dense_ids) {
+    dest_index = FindNodeIndex(target);
+  }
+  if (dest_index) {
     topology_builder_.destinations.emplace_back(
-        static_cast<uint32_t>(dest_entry->second));
+        static_cast<uint32_t>(*dest_index));
   } else {
-    topology_builder_.destinations_intermediate.insert(
-        std::pair<size_t, std::string>(edges_, target));
+    topology_builder_.destinations_intermediate.emplace_back(edges_, target);
     topology_builder_.destinations.emplace_back(
         std::numeric_limits<uint32_t>::max());
   }
@@ -1627,37 +1666,64 @@ katana::PropertyGraphBuilder::AddLabel(const std::string& name) {
 /* Functions for building Graphs */
 /*********************************/
 
-// Resolve string node IDs to node indexes, if a node does not exist create an
-// empty node
+// Resolve the node IDs of pending endpoints to node indexes. The lookups run
+// in parallel; IDs of nodes that do not exist become empty nodes, created
+// in edge order.
+std::vector<uint32_t>
+katana::PropertyGraphBuilder::ResolveEndpoints(
+    const std::vector<std::pair<size_t, std::string>>& pending) {
+  constexpr uint32_t kUnresolved = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> indexes(pending.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, pending.size()),
+      [&](size_t i) {
+        std::optional<size_t> index = FindNodeIndex(pending[i].second);
+        indexes[i] = index ? static_cast<uint32_t>(*index) : kUnresolved;
+      },
+      katana::steal(), katana::loopname("ResolveEdgeEndpoints"));
+
+  for (size_t i = 0; i < pending.size(); ++i) {
+    if (indexes[i] != kUnresolved) {
+      continue;
+    }
+    // an earlier endpoint may have created the node already
+    std::optional<size_t> index = FindNodeIndex(pending[i].second);
+    if (!index) {
+      index = nodes_;
+      this->AddNode(pending[i].second);
+    }
+    indexes[i] = static_cast<uint32_t>(*index);
+  }
+  return indexes;
+}
+
 void
 katana::PropertyGraphBuilder::ResolveIntermediateIDs() {
   TopologyState* topology = &topology_builder_;
 
-  for (auto [index, str_id] : topology->destinations_intermediate) {
-    auto dest_index = topology->node_indexes.find(str_id);
-    uint32_t dest;
-    // if node does not exist, create it
-    if (dest_index == topology->node_indexes.end()) {
-      dest = nodes_;
-      this->AddNode(str_id);
-    } else {
-      dest = static_cast<uint32_t>(dest_index->second);
-    }
-    topology->destinations[index] = dest;
-  }
-
-  for (auto [index, str_id] : topology->sources_intermediate) {
-    auto src_index = topology->node_indexes.find(str_id);
-    uint32_t src;
-    if (src_index == topology->node_indexes.end()) {
-      src = nodes_;
-      this->AddNode(str_id);
-    } else {
-      src = static_cast<uint32_t>(src_index->second);
-    }
-    topology->sources[index] = src;
+  std::vector<uint32_t> dests =
+      ResolveEndpoints(topology->destinations_intermediate);
+  katana::do_all(
+      katana::iterate(size_t{0}, dests.size()),
+      [&](size_t i) {
+        topology->destinations[topology->destinations_intermediate[i].first] =
+            dests[i];
+      },
+      katana::no_stats());
+
+  std::vector<uint32_t> srcs = ResolveEndpoints(topology->sources_intermediate);
+  katana::do_all(
+      katana::iterate(size_t{0}, srcs.size()),
+      [&](size_t i) {
+        topology->sources[topology->sources_intermediate[i].first] = srcs[i];
+      },
+      katana::no_stats());
+  for (uint32_t src : srcs) {
     topology->out_indices[src]++;
   }
+
+  topology->destinations_intermediate.clear();
+  topology->sources_intermediate.clear();
 }
 
 // Build CSR format and rearrange edge tables to correspond to the CSR
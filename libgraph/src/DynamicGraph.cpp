@@ -0,0 +1,195 @@
+#include "katana/DynamicGraph.h"
+
+#include <algorithm>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+
+namespace {
+
+using Node = katana::DynamicGraph::Node;
+using EdgeList = katana::DynamicGraph::EdgeList;
+
+/// Sort the edges of a batch by source and call fn(source, begin, end) in
+/// parallel for the edges [begin, end) of every source, so that each node
+/// is updated by one thread
+template <typename F>
+void
+ForEachSource(const EdgeList& edges, F fn) {
+  katana::NUMAArray<std::pair<Node, Node>> sorted;
+  sorted.allocateInterleaved(edges.size());
+  katana::ParallelSTL::copy(edges.begin(), edges.end(), sorted.begin());
+  katana::ParallelSTL::sort(sorted.begin(), sorted.end());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, sorted.size()),
+      [&](size_t i) {
+        Node src = sorted[i].first;
+        if (i > 0 && sorted[i - 1].first == src) {
+          return;
+        }
+        size_t end = i + 1;
+        while (end < sorted.size() && sorted[end].first == src) {
+          ++end;
+        }
+        fn(src, &sorted[i], &sorted[0] + end);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+}  // namespace
+
+katana::DynamicGraph::DynamicGraph(
+    std::unique_ptr<PropertyGraph> pg, double merge_fraction)
+    : pg_(std::move(pg)), merge_fraction_(merge_fraction) {
+  ResetUpdates();
+}
+
+void
+katana::DynamicGraph::ResetUpdates() {
+  inserted_.clear();
+  inserted_.resize(pg_->NumNodes());
+  deleted_.resize(pg_->NumEdges());
+  deleted_.reset();
+  num_inserted_ = 0;
+  num_deleted_ = 0;
+}
+
+katana::Result<void>
+katana::DynamicGraph::CheckEdges(const EdgeList& edges) const {
+  const uint64_t num_nodes = NumNodes();
+  katana::GReduceLogicalOr invalid;
+  katana::do_all(
+      katana::iterate(edges.begin(), edges.end()),
+      [&](const std::pair<Node, Node>& edge) {
+        if (edge.first >= num_nodes || edge.second >= num_nodes) {
+          invalid.update(true);
+        }
+      },
+      katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "an edge has an end that is not one of the {} nodes", num_nodes);
+  }
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::DynamicGraph::InsertEdges(const EdgeList& edges) {
+  KATANA_CHECKED(CheckEdges(edges));
+
+  ForEachSource(edges, [&](Node src, const auto* begin, const auto* end) {
+    std::vector<Node>& block = inserted_[src];
+    block.reserve(block.size() + (end - begin));
+    for (const auto* edge = begin; edge != end; ++edge) {
+      block.emplace_back(edge->second);
+    }
+  });
+  num_inserted_ += edges.size();
+
+  return MergeIfNeeded();
+}
+
+katana::Result<uint64_t>
+katana::DynamicGraph::DeleteEdges(const EdgeList& edges) {
+  KATANA_CHECKED(CheckEdges(edges));
+
+  const GraphTopology& topo = pg_->topology();
+  katana::GAccumulator<uint64_t> deleted_inserted;
+  katana::GAccumulator<uint64_t> deleted_csr;
+  ForEachSource(edges, [&](Node src, const auto* begin, const auto* end) {
+    std::vector<Node>& block = inserted_[src];
+    for (const auto* edge = begin; edge != end; ++edge) {
+      // edges inserted since the last merge go first; the order of a
+      // delta block does not matter
+      auto it = std::find(block.begin(), block.end(), edge->second);
+      if (it != block.end()) {
+        *it = block.back();
+        block.pop_back();
+        deleted_inserted += 1;
+        continue;
+      }
+      for (auto e : topo.OutEdges(src)) {
+        if (topo.OutEdgeDst(e) == edge->second && !deleted_.test(e)) {
+          deleted_.set(e);
+          deleted_csr += 1;
+          break;
+        }
+      }
+    }
+  });
+  num_inserted_ -= deleted_inserted.reduce();
+  num_deleted_ += deleted_csr.reduce();
+
+  KATANA_CHECKED(MergeIfNeeded());
+  return deleted_inserted.reduce() + deleted_csr.reduce();
+}
+
+katana::Result<void>
+katana::DynamicGraph::MergeIfNeeded() {
+  if (NumPendingUpdates() > 0 &&
+      NumPendingUpdates() >= merge_fraction_ * pg_->NumEdges()) {
+    return Merge();
+  }
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::DynamicGraph::Merge() {
+  if (NumPendingUpdates() == 0) {
+    return ResultSuccess();
+  }
+  katana::StatTimer merge_time("DynamicGraphMerge");
+  merge_time.start();
+
+  const GraphTopology& topo = pg_->topology();
+  const uint64_t num_nodes = NumNodes();
+  const uint64_t num_edges = NumEdges();
+  // rows past the CSR are new edges
+  const uint64_t new_row = pg_->NumEdges();
+
+  katana::NUMAArray<Edge> out_indices;
+  out_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { out_indices[n] = OutDegree(n); },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(num_edges);
+  katana::NUMAArray<uint64_t> edge_rows;
+  edge_rows.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t new_edge = n == 0 ? 0 : out_indices[n - 1];
+        for (auto e : topo.OutEdges(n)) {
+          if (!deleted_.test(e)) {
+            out_dests[new_edge] = topo.OutEdgeDst(e);
+            edge_rows[new_edge] = topo.GetEdgePropertyIndexFromOutEdge(e);
+            ++new_edge;
+          }
+        }
+        for (Node dst : inserted_[n]) {
+          out_dests[new_edge] = dst;
+          edge_rows[new_edge] = new_row;
+          ++new_edge;
+        }
+      },
+      katana::steal(), katana::loopname("DynamicGraphMerge"));
+
+  pg_ = KATANA_CHECKED(CreateGraphWithEdges(
+      pg_.get(), GraphTopology{std::move(out_indices), std::move(out_dests)},
+      edge_rows));
+  ResetUpdates();
+
+  merge_time.stop();
+  return ResultSuccess();
+}
@@ -1,41 +1,71 @@
 #include "katana/EntityIndex.h"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <arrow/compute/cast.h>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
 
 namespace katana {
 
+namespace {
+
+template <typename node_or_edge, typename c_type>
+std::unique_ptr<EntityIndex<node_or_edge>>
+MakeIndexOfKind(
+    EntityIndexKind kind, const std::string& property_name,
+    size_t num_entities, const std::shared_ptr<arrow::Array>& property) {
+  if (kind == EntityIndexKind::kHash) {
+    return std::make_unique<HashEntityIndex<node_or_edge, c_type>>(
+        property_name, num_entities, property);
+  }
+  return std::make_unique<OrderedEntityIndex<node_or_edge, c_type>>(
+      property_name, num_entities, property);
+}
+
+}  // namespace
+
 // Switch statement over creation of per-type indexes.
 template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property) {
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind) {
   std::unique_ptr<EntityIndex<node_or_edge>> index;
 
   switch (property->type_id()) {
   case arrow::Type::BOOL:
-    index = std::make_unique<PrimitiveEntityIndex<node_or_edge, bool>>(
-        property_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, bool>(
+        kind, property_name, num_entities, property);
     break;
   case arrow::Type::UINT8:
-    index = std::make_unique<PrimitiveEntityIndex<node_or_edge, uint8_t>>(
-        property_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, uint8_t>(
+        kind, property_name, num_entities, property);
     break;
   case arrow::Type::INT64:
-    index = std::make_unique<PrimitiveEntityIndex<node_or_edge, int64_t>>(
-        property_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, int64_t>(
+        kind, property_name, num_entities, property);
     break;
   case arrow::Type::UINT64:
-    index = std::make_unique<PrimitiveEntityIndex<node_or_edge, uint64_t>>(
-        property_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, uint64_t>(
+        kind, property_name, num_entities, property);
     break;
   case arrow::Type::DOUBLE:
-    index = std::make_unique<PrimitiveEntityIndex<node_or_edge, double_t>>(
-        property_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, double_t>(
+        kind, property_name, num_entities, property);
     break;
   case arrow::Type::LARGE_STRING:
-    index = std::make_unique<StringEntityIndex<node_or_edge>>(
-        property_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, std::string_view>(
+        kind, property_name, num_entities, property);
     break;
   default:
     return KATANA_ERROR(
@@ -47,6 +77,234 @@ MakeTypedEntityIndex(
   return Result<std::unique_ptr<EntityIndex<node_or_edge>>>(std::move(index));
 }
 
+namespace {
+
+// Below this many candidates, searches count the smaller keys with a loop the
+// compiler can vectorize instead of halving the range further.
+constexpr size_t kLinearSearchSize = 16;
+
+// Returns the first position in [0, n) for which less(i) is false, where
+// less is true for a prefix of the positions. The halving step has no
+// branches, and prefetch(i) is called on both positions the next step may
+// read, so the memory latency of large arrays overlaps with the search.
+template <typename Less, typename Prefetch>
+size_t
+PartitionPoint(size_t n, const Less& less, const Prefetch& prefetch) {
+  size_t base = 0;
+  while (n > kLinearSearchSize) {
+    size_t half = n / 2;
+    size_t next_half = (n - half) / 2;
+    prefetch(base + next_half);
+    prefetch(base + half + next_half);
+    base = less(base + half) ? base + half : base;
+    n -= half;
+  }
+  size_t num_less = 0;
+  for (size_t i = 0; i < n; ++i) {
+    num_less += less(base + i);
+  }
+  return base + num_less;
+}
+
+// Returns the first 8 bytes of str as a big-endian integer, padded with
+// zeros, so that comparing prefixes agrees with comparing strings unless the
+// prefixes are equal.
+uint64_t
+StringPrefix(std::string_view str) {
+  uint64_t prefix = 0;
+  size_t len = std::min<size_t>(str.size(), sizeof(prefix));
+  for (size_t i = 0; i < sizeof(prefix); ++i) {
+    prefix <<= 8;
+    if (i < len) {
+      prefix |= static_cast<unsigned char>(str[i]);
+    }
+  }
+  return prefix;
+}
+
+// Returns the positions in [0, n) for which keep is true, in increasing order.
+template <typename T, typename Keep>
+NUMAArray<T>
+Compact(size_t n, const Keep& keep) {
+  // Each thread compacts its block of positions; a prefix sum over the block
+  // counts places the blocks.
+  std::vector<size_t> offsets(getActiveThreads() + 1, 0);
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, n, tid, total);
+    for (size_t i = begin; i < end; ++i) {
+      offsets[tid + 1] += keep(i);
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  NUMAArray<T> positions;
+  positions.allocateBlocked(offsets.back());
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, n, tid, total);
+    size_t out = offsets[tid];
+    for (size_t i = begin; i < end; ++i) {
+      if (keep(i)) {
+        positions[out++] = i;
+      }
+    }
+  });
+  return positions;
+}
+
+// Returns the ids below num_entities with a valid value, in increasing order.
+template <typename node_or_edge>
+NUMAArray<node_or_edge>
+ValidEntities(const arrow::Array& property, size_t num_entities) {
+  if (property.null_count() == 0) {
+    NUMAArray<node_or_edge> ids;
+    ids.allocateBlocked(num_entities);
+    ParallelSTL::iota(ids.begin(), ids.end(), node_or_edge{0});
+    return ids;
+  }
+  return Compact<node_or_edge>(
+      num_entities, [&](size_t i) { return property.IsValid(i); });
+}
+
+// Finalizer of splitmix64. It is a bijection, so distinct keys of up to 64
+// bits never share a hash.
+uint64_t
+MixHash(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+uint64_t
+HashKey(std::string_view key) {
+  return MixHash(std::hash<std::string_view>{}(key));
+}
+
+template <typename c_type>
+uint64_t
+HashKey(c_type key) {
+  if constexpr (std::is_floating_point_v<c_type>) {
+    // -0.0 == 0.0, so they must hash the same
+    double value = key == 0 ? 0.0 : key;
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return MixHash(bits);
+  } else {
+    return MixHash(static_cast<uint64_t>(key));
+  }
+}
+
+// Whether a hash match in a HashEntityIndex over c_type still needs a
+// comparison of the keys. Not for integers, which HashKey maps one-to-one.
+template <typename c_type>
+constexpr bool kHashNeedsKeyCheck = std::is_floating_point_v<c_type> ||
+                                    std::is_same_v<c_type, std::string_view>;
+
+// The number of keys FindMany on a HashEntityIndex hashes and prefetches the
+// windows of before probing any of them.
+constexpr size_t kFindBatchSize = 16;
+
+// Returns keys as an array of type, casting them if they have another type.
+Result<std::shared_ptr<arrow::Array>>
+KeysOfType(
+    const arrow::Array& keys, const std::shared_ptr<arrow::DataType>& type) {
+  if (keys.type()->Equals(*type)) {
+    return arrow::MakeArray(keys.data());
+  }
+  return KATANA_CHECKED_CONTEXT(
+      arrow::compute::Cast(keys, type), "casting keys of type {} to {}",
+      keys.type()->ToString(), type->ToString());
+}
+
+// Returns the i-th value of keys as the key type of an index.
+template <typename ArrayType>
+auto
+KeyOf(const ArrayType& keys, int64_t i) {
+  if constexpr (std::is_same_v<ArrayType, arrow::LargeStringArray>) {
+    arrow::util::string_view view = keys.GetView(i);
+    return std::string_view(view.data(), view.length());
+  } else {
+    return keys.Value(i);
+  }
+}
+
+// Resolves keys against the sorted ids of an ordered index, where
+// lower_bound_from is the LowerBoundFrom of the index and matches(pos, key)
+// tells whether the element at pos has value key. The keys are sorted first,
+// so each thread searches for increasing keys, starting where its last
+// search ended, and the top levels of the search stay in cache.
+template <
+    typename node_or_edge, typename ArrayType, typename LowerBoundFromFn,
+    typename Matches>
+NUMAArray<node_or_edge>
+FindManySorted(
+    const ArrayType& keys, const NUMAArray<node_or_edge>& ids,
+    const LowerBoundFromFn& lower_bound_from, const Matches& matches) {
+  NUMAArray<node_or_edge> found;
+  found.allocateBlocked(keys.length());
+  ParallelSTL::fill(
+      found.begin(), found.end(), EntityIndex<node_or_edge>::kNotFound);
+
+  NUMAArray<uint64_t> order = Compact<uint64_t>(
+      keys.length(), [&](size_t i) { return keys.IsValid(i); });
+  ParallelSTL::sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+    return KeyOf(keys, a) < KeyOf(keys, b);
+  });
+
+  on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = block_range(size_t{0}, order.size(), tid, total);
+    size_t from = 0;
+    for (size_t i = begin; i < end; ++i) {
+      auto key = KeyOf(keys, order[i]);
+      from = lower_bound_from(key, from);
+      if (from < ids.size() && matches(from, key)) {
+        found[order[i]] = ids[from];
+      }
+    }
+  });
+  return found;
+}
+
+// Copies the ids of a stored index, checking that each one names an entity
+// with a valid value.
+template <typename node_or_edge>
+Result<NUMAArray<node_or_edge>>
+StoredEntities(
+    const EntityIndexPrimitive& primitive, const arrow::Array& property,
+    size_t num_entities) {
+  if (primitive.num_entities() != num_entities ||
+      primitive.property_type() != property.type()->ToString()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored index is over {} entities of type {}, not {} of type {}",
+        primitive.num_entities(), primitive.property_type(), num_entities,
+        property.type()->ToString());
+  }
+
+  NUMAArray<node_or_edge> ids;
+  ids.allocateBlocked(primitive.num_ids());
+  const uint64_t* stored = primitive.ids();
+  GReduceLogicalOr bad_id;
+  do_all(
+      iterate(size_t{0}, ids.size()),
+      [&](size_t i) {
+        uint64_t id = stored[i];
+        if (id >= num_entities || !property.IsValid(id)) {
+          bad_id.update(true);
+          return;
+        }
+        ids[i] = id;
+      },
+      no_stats());
+  if (bad_id.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored index has ids of missing entities or values");
+  }
+  return Result<NUMAArray<node_or_edge>>(std::move(ids));
+}
+
+}  // namespace
+
 template <typename node_or_edge, typename c_type>
 Result<void>
 PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
@@ -55,18 +313,120 @@ PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
+  // Sort (value, id) pairs rather than ids so that the sort reads contiguous
+  // memory instead of the Arrow array.
+  NUMAArray<node_or_edge> valid =
+      ValidEntities<node_or_edge>(*property_, num_entities_);
+  NUMAArray<std::pair<c_type, node_or_edge>> entries;
+  entries.allocateBlocked(valid.size());
+  do_all(
+      iterate(size_t{0}, valid.size()),
+      [&](size_t i) { entries[i] = {property_->Value(valid[i]), valid[i]}; },
+      no_stats());
+  valid.destroy();
+  valid.deallocate();
+
+  ParallelSTL::sort(entries.begin(), entries.end());
+
+  keys_.allocateBlocked(entries.size());
+  ids_.allocateBlocked(entries.size());
+  do_all(
+      iterate(size_t{0}, entries.size()),
+      [&](size_t i) {
+        keys_[i] = entries[i].first;
+        ids_[i] = entries[i].second;
+      },
+      no_stats());
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromFile(
+    const EntityIndexPrimitive& primitive) {
+  NUMAArray<node_or_edge> ids = KATANA_CHECKED(
+      StoredEntities<node_or_edge>(primitive, *property_, num_entities_));
+  NUMAArray<c_type> keys;
+  keys.allocateBlocked(ids.size());
+  do_all(
+      iterate(size_t{0}, ids.size()),
+      [&](size_t i) { keys[i] = property_->Value(ids[i]); }, no_stats());
+
+  // The order is checked too, in case the property changed without the
+  // stored index being dropped
+  GReduceLogicalOr unsorted;
+  do_all(
+      iterate(size_t{1}, std::max<size_t>(ids.size(), 1)),
+      [&](size_t i) {
+        if (keys[i] < keys[i - 1] ||
+            (keys[i] == keys[i - 1] && ids[i] <= ids[i - 1])) {
+          unsorted.update(true);
+        }
+      },
+      no_stats());
+  if (unsorted.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "stored index is not sorted by value");
   }
 
+  keys_ = std::move(keys);
+  ids_ = std::move(ids);
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge, typename c_type>
+typename PrimitiveEntityIndex<node_or_edge, c_type>::iterator
+PrimitiveEntityIndex<node_or_edge, c_type>::Find(c_type key) {
+  iterator it = LowerBound(key);
+  if (it == end() || keys_[it - begin()] != key) {
+    return end();
+  }
+  return it;
+}
+
+template <typename node_or_edge, typename c_type>
+size_t
+PrimitiveEntityIndex<node_or_edge, c_type>::LowerBoundFrom(
+    c_type key, size_t from) const {
+  const c_type* keys = keys_.data() + from;
+  return from + PartitionPoint(
+                    keys_.size() - from,
+                    [keys, key](size_t i) {
+                      return std::less<c_type>{}(keys[i], key);
+                    },
+                    [keys](size_t i) { __builtin_prefetch(keys + i); });
+}
+
+template <typename node_or_edge, typename c_type>
+typename PrimitiveEntityIndex<node_or_edge, c_type>::iterator
+PrimitiveEntityIndex<node_or_edge, c_type>::LowerBound(c_type key) {
+  return begin() + LowerBoundFrom(key, 0);
+}
+
+template <typename node_or_edge, typename c_type>
+typename PrimitiveEntityIndex<node_or_edge, c_type>::iterator
+PrimitiveEntityIndex<node_or_edge, c_type>::UpperBound(c_type key) {
+  const c_type* keys = keys_.data();
+  size_t pos = PartitionPoint(
+      keys_.size(),
+      [keys, key](size_t i) { return !std::less<c_type>{}(key, keys[i]); },
+      [keys](size_t i) { __builtin_prefetch(keys + i); });
+  return begin() + pos;
+}
+
+template <typename node_or_edge, typename c_type>
+Result<NUMAArray<node_or_edge>>
+PrimitiveEntityIndex<node_or_edge, c_type>::FindMany(const arrow::Array& keys) {
+  std::shared_ptr<arrow::Array> typed_keys =
+      KATANA_CHECKED(KeysOfType(keys, property_->type()));
+  NUMAArray<node_or_edge> found = FindManySorted(
+      static_cast<const ArrowArrayType&>(*typed_keys), ids_,
+      [this](c_type key, size_t from) { return LowerBoundFrom(key, from); },
+      [this](size_t pos, c_type key) { return keys_[pos] == key; });
+  return Result<NUMAArray<node_or_edge>>(std::move(found));
+}
+
 template <typename node_or_edge>
 Result<void>
 StringEntityIndex<node_or_edge>::BuildFromProperty() {
@@ -75,18 +435,282 @@ StringEntityIndex<node_or_edge>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
+  ids_ = ValidEntities<node_or_edge>(*property_, num_entities_);
+
+  // Prefixes decide most comparisons of the sort as well.
+  NUMAArray<std::pair<uint64_t, node_or_edge>> entries;
+  entries.allocateBlocked(ids_.size());
+  do_all(
+      iterate(size_t{0}, ids_.size()),
+      [&](size_t i) { entries[i] = {StringPrefix(GetView(ids_[i])), ids_[i]}; },
+      no_stats());
+
+  ParallelSTL::sort(
+      entries.begin(), entries.end(),
+      [this](const auto& a, const auto& b) {
+        if (a.first != b.first) {
+          return a.first < b.first;
+        }
+        int cmp = GetView(a.second).compare(GetView(b.second));
+        return cmp < 0 || (cmp == 0 && a.second < b.second);
+      });
+
+  prefixes_.allocateBlocked(entries.size());
+  do_all(
+      iterate(size_t{0}, entries.size()),
+      [&](size_t i) {
+        prefixes_[i] = entries[i].first;
+        ids_[i] = entries[i].second;
+      },
+      no_stats());
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringEntityIndex<node_or_edge>::BuildFromFile(
+    const EntityIndexPrimitive& primitive) {
+  NUMAArray<node_or_edge> ids = KATANA_CHECKED(
+      StoredEntities<node_or_edge>(primitive, *property_, num_entities_));
+  NUMAArray<uint64_t> prefixes;
+  prefixes.allocateBlocked(ids.size());
+  do_all(
+      iterate(size_t{0}, ids.size()),
+      [&](size_t i) { prefixes[i] = StringPrefix(GetView(ids[i])); },
+      no_stats());
+
+  GReduceLogicalOr unsorted;
+  do_all(
+      iterate(size_t{1}, std::max<size_t>(ids.size(), 1)),
+      [&](size_t i) {
+        int cmp = GetView(ids[i - 1]).compare(GetView(ids[i]));
+        if (cmp > 0 || (cmp == 0 && ids[i - 1] >= ids[i])) {
+          unsorted.update(true);
+        }
+      },
+      no_stats());
+  if (unsorted.reduce()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "stored index is not sorted by value");
   }
 
+  prefixes_ = std::move(prefixes);
+  ids_ = std::move(ids);
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge>
+typename StringEntityIndex<node_or_edge>::iterator
+StringEntityIndex<node_or_edge>::Find(std::string_view key) {
+  iterator it = LowerBound(key);
+  if (it == end() || GetView(*it) != key) {
+    return end();
+  }
+  return it;
+}
+
+template <typename node_or_edge>
+size_t
+StringEntityIndex<node_or_edge>::LowerBoundFrom(
+    std::string_view key, size_t from) const {
+  uint64_t key_prefix = StringPrefix(key);
+  const uint64_t* prefixes = prefixes_.data() + from;
+  const node_or_edge* ids = ids_.data() + from;
+  return from + PartitionPoint(
+                    prefixes_.size() - from,
+                    [&](size_t i) {
+                      if (prefixes[i] != key_prefix) {
+                        return prefixes[i] < key_prefix;
+                      }
+                      return GetView(ids[i]) < key;
+                    },
+                    [prefixes](size_t i) { __builtin_prefetch(prefixes + i); });
+}
+
+template <typename node_or_edge>
+typename StringEntityIndex<node_or_edge>::iterator
+StringEntityIndex<node_or_edge>::LowerBound(std::string_view key) {
+  return begin() + LowerBoundFrom(key, 0);
+}
+
+template <typename node_or_edge>
+typename StringEntityIndex<node_or_edge>::iterator
+StringEntityIndex<node_or_edge>::UpperBound(std::string_view key) {
+  uint64_t key_prefix = StringPrefix(key);
+  const uint64_t* prefixes = prefixes_.data();
+  size_t pos = PartitionPoint(
+      prefixes_.size(),
+      [&](size_t i) {
+        if (prefixes[i] != key_prefix) {
+          return prefixes[i] < key_prefix;
+        }
+        return !(key < GetView(ids_[i]));
+      },
+      [prefixes](size_t i) { __builtin_prefetch(prefixes + i); });
+  return begin() + pos;
+}
+
+template <typename node_or_edge>
+Result<NUMAArray<node_or_edge>>
+StringEntityIndex<node_or_edge>::FindMany(const arrow::Array& keys) {
+  std::shared_ptr<arrow::Array> typed_keys =
+      KATANA_CHECKED(KeysOfType(keys, property_->type()));
+  NUMAArray<node_or_edge> found = FindManySorted(
+      static_cast<const ArrowArrayType&>(*typed_keys), ids_,
+      [this](std::string_view key, size_t from) {
+        return LowerBoundFrom(key, from);
+      },
+      [this](size_t pos, std::string_view key) {
+        return GetView(ids_[pos]) == key;
+      });
+  return Result<NUMAArray<node_or_edge>>(std::move(found));
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+HashEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
+  KATANA_CHECKED(Base::BuildFromProperty());
+  BuildTable();
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+HashEntityIndex<node_or_edge, c_type>::BuildFromFile(
+    const EntityIndexPrimitive& primitive) {
+  KATANA_CHECKED(Base::BuildFromFile(primitive));
+  BuildTable();
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+void
+HashEntityIndex<node_or_edge, c_type>::BuildTable() {
+  size_t num_ids = this->ids_.size();
+  runs_ = Compact<uint64_t>(num_ids, [this](size_t i) {
+    return i == 0 || KeyAt(i) != KeyAt(i - 1);
+  });
+
+  // At most half of the slots are taken, which keeps probe sequences short
+  // and guarantees every window sequence reaches an empty slot.
+  size_t num_slots = kWindowSize;
+  while (num_slots < 2 * runs_.size()) {
+    num_slots *= 2;
+  }
+  window_mask_ = num_slots / kWindowSize - 1;
+  slots_.allocateBlocked(num_slots);
+  ParallelSTL::fill(slots_.begin(), slots_.end(), Slot{0, kEmptySlot});
+
+  // Each value goes to the first free slot of the first window of its probe
+  // sequence that has one. Slots only fill, so a window that was full when a
+  // value passed it stays full and lookups pass it too.
+  do_all(
+      iterate(size_t{0}, runs_.size()),
+      [&](size_t run) {
+        uint64_t hash = HashKey(KeyAt(runs_[run]));
+        for (uint64_t window = hash & window_mask_;;
+             window = (window + 1) & window_mask_) {
+          Slot* slots = slots_.data() + window * kWindowSize;
+          for (size_t i = 0; i < kWindowSize; ++i) {
+            if (slots[i].run == kEmptySlot &&
+                __sync_bool_compare_and_swap(&slots[i].run, kEmptySlot, run)) {
+              slots[i].hash = hash;
+              return;
+            }
+          }
+        }
+      },
+      steal(), no_stats());
+}
+
+template <typename node_or_edge, typename c_type>
+uint64_t
+HashEntityIndex<node_or_edge, c_type>::FindRun(
+    c_type key, uint64_t hash) const {
+  for (uint64_t window = hash & window_mask_;;
+       window = (window + 1) & window_mask_) {
+    const Slot* slots = slots_.data() + window * kWindowSize;
+    // Compare the whole window without branches so the compiler can use
+    // vector compares.
+    unsigned matches = 0;
+    unsigned empty = 0;
+    for (size_t i = 0; i < kWindowSize; ++i) {
+      bool taken = slots[i].run != kEmptySlot;
+      matches |= unsigned{taken && slots[i].hash == hash} << i;
+      empty |= unsigned{!taken} << i;
+    }
+    for (; matches != 0; matches &= matches - 1) {
+      uint64_t run = slots[__builtin_ctz(matches)].run;
+      if (!kHashNeedsKeyCheck<c_type> || KeyAt(runs_[run]) == key) {
+        return run;
+      }
+    }
+    if (empty != 0) {
+      return kEmptySlot;
+    }
+  }
+}
+
+template <typename node_or_edge, typename c_type>
+std::pair<
+    typename HashEntityIndex<node_or_edge, c_type>::iterator,
+    typename HashEntityIndex<node_or_edge, c_type>::iterator>
+HashEntityIndex<node_or_edge, c_type>::EqualRange(c_type key) {
+  uint64_t run = FindRun(key, HashKey(key));
+  if (run == kEmptySlot) {
+    return {this->end(), this->end()};
+  }
+  uint64_t end = run + 1 < runs_.size() ? runs_[run + 1] : this->ids_.size();
+  return {this->begin() + runs_[run], this->begin() + end};
+}
+
+template <typename node_or_edge, typename c_type>
+Result<NUMAArray<node_or_edge>>
+HashEntityIndex<node_or_edge, c_type>::FindMany(const arrow::Array& keys) {
+  std::shared_ptr<arrow::Array> typed_keys =
+      KATANA_CHECKED(KeysOfType(keys, this->property_->type()));
+  const auto& key_array =
+      static_cast<const typename Base::ArrowArrayType&>(*typed_keys);
+  size_t num_keys = key_array.length();
+  NUMAArray<node_or_edge> found;
+  found.allocateBlocked(num_keys);
+
+  // A batch prefetches the windows of all of its keys before probing any of
+  // them and their runs before reading any, so its cache misses overlap.
+  do_all(
+      iterate(size_t{0}, (num_keys + kFindBatchSize - 1) / kFindBatchSize),
+      [&](size_t batch) {
+        size_t begin = batch * kFindBatchSize;
+        size_t size = std::min(kFindBatchSize, num_keys - begin);
+        uint64_t hashes[kFindBatchSize];
+        uint64_t runs[kFindBatchSize];
+        for (size_t i = 0; i < size; ++i) {
+          if (key_array.IsValid(begin + i)) {
+            hashes[i] = HashKey(KeyOf(key_array, begin + i));
+            __builtin_prefetch(Window(hashes[i]));
+          }
+        }
+        for (size_t i = 0; i < size; ++i) {
+          runs[i] = kEmptySlot;
+          if (key_array.IsValid(begin + i)) {
+            runs[i] = FindRun(KeyOf(key_array, begin + i), hashes[i]);
+          }
+          if (runs[i] != kEmptySlot) {
+            __builtin_prefetch(runs_.data() + runs[i]);
+          }
+        }
+        for (size_t i = 0; i < size; ++i) {
+          found[begin + i] = runs[i] == kEmptySlot
+                                 ? EntityIndex<node_or_edge>::kNotFound
+                                 : this->ids_[runs_[runs[i]]];
+        }
+      },
+      steal(), no_stats());
+
+  return Result<NUMAArray<node_or_edge>>(std::move(found));
+}
+
 // Forward declare template types to allow implementation in .cpp.
 template class PrimitiveEntityIndex<GraphTopology::Node, bool>;
 template class PrimitiveEntityIndex<GraphTopology::Edge, bool>;
@@ -102,13 +726,26 @@ template class PrimitiveEntityIndex<GraphTopology::Edge, double_t>;
 template class StringEntityIndex<GraphTopology::Node>;
 template class StringEntityIndex<GraphTopology::Edge>;
 
+template class HashEntityIndex<GraphTopology::Node, bool>;
+template class HashEntityIndex<GraphTopology::Edge, bool>;
+template class HashEntityIndex<GraphTopology::Node, uint8_t>;
+template class HashEntityIndex<GraphTopology::Edge, uint8_t>;
+template class HashEntityIndex<GraphTopology::Node, int64_t>;
+template class HashEntityIndex<GraphTopology::Edge, int64_t>;
+template class HashEntityIndex<GraphTopology::Node, uint64_t>;
+template class HashEntityIndex<GraphTopology::Edge, uint64_t>;
+template class HashEntityIndex<GraphTopology::Node, double_t>;
+template class HashEntityIndex<GraphTopology::Edge, double_t>;
+template class HashEntityIndex<GraphTopology::Node, std::string_view>;
+template class HashEntityIndex<GraphTopology::Edge, std::string_view>;
+
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Node>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Edge>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 
 }  // namespace katana
@@ -455,7 +455,7 @@ FileGraph::partFromFile(
 
   // do interleaved numa allocation with current number of threads
   if (numaMap) {
-    unsigned int numThreads = katana::activeThreads;
+    unsigned int numThreads = katana::getActiveThreads();
     const size_t hugePageSize = 2 * 1024 * 1024;  // 2MB
 
     void* ptr;
@@ -0,0 +1,272 @@
+#include "katana/GrFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iomanip>
+#include <limits>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/table.h>
+
+#include "katana/Endian.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using Edge = katana::GraphTopology::Edge;
+using Node = katana::GraphTopology::Node;
+
+constexpr uint64_t kHeaderBytes = 4 * sizeof(uint64_t);
+
+/// A read only mapping of a .gr file and the parts of it
+class GrFile {
+public:
+  GrFile(const GrFile&) = delete;
+  GrFile& operator=(const GrFile&) = delete;
+  ~GrFile() { munmap(data_, size_); }
+
+  static katana::Result<std::unique_ptr<GrFile>> Open(const std::string& path);
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+  uint64_t edge_data_size() const { return edge_data_size_; }
+
+  /// Whether the file holds the edge data its header promises
+  bool HasEdgeData() const {
+    return EdgeDataOffset() + num_edges_ * edge_data_size_ <= size_;
+  }
+
+  /// Copy the end of the edges of node n out of the file
+  Edge NodeEnd(uint64_t n) const {
+    return katana::convert_le64toh(Words()[4 + n]);
+  }
+
+  /// Copy the destination of edge e out of the file
+  uint64_t Dest(uint64_t e) const {
+    const char* dests = Bytes() + DestsOffset();
+    if (version_ == 1) {
+      return katana::convert_le32toh(
+          reinterpret_cast<const uint32_t*>(dests)[e]);
+    }
+    return katana::convert_le64toh(reinterpret_cast<const uint64_t*>(dests)[e]);
+  }
+
+  const char* EdgeData() const { return Bytes() + EdgeDataOffset(); }
+
+private:
+  GrFile(void* data, size_t size) : data_(data), size_(size) {
+    version_ = katana::convert_le64toh(Words()[0]);
+    edge_data_size_ = katana::convert_le64toh(Words()[1]);
+    num_nodes_ = katana::convert_le64toh(Words()[2]);
+    num_edges_ = katana::convert_le64toh(Words()[3]);
+  }
+
+  const char* Bytes() const { return static_cast<const char*>(data_); }
+  const uint64_t* Words() const { return static_cast<const uint64_t*>(data_); }
+
+  uint64_t DestsOffset() const {
+    return kHeaderBytes + num_nodes_ * sizeof(uint64_t);
+  }
+
+  // both versions pad the destinations to an even number of them
+  uint64_t EdgeDataOffset() const {
+    uint64_t dest_size = version_ == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+    return DestsOffset() + (num_edges_ + num_edges_ % 2) * dest_size;
+  }
+
+  void* data_;
+  size_t size_;
+  uint64_t version_;
+  uint64_t edge_data_size_;
+  uint64_t num_nodes_;
+  uint64_t num_edges_;
+};
+
+katana::Result<std::unique_ptr<GrFile>>
+GrFile::Open(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", std::quoted(path));
+  }
+  struct stat buf;
+  if (fstat(fd, &buf) != 0) {
+    auto err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "reading {}", std::quoted(path));
+  }
+  size_t size = buf.st_size;
+  if (size < kHeaderBytes) {
+    close(fd);
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} is too short to be a .gr file: {} bytes", std::quoted(path), size);
+  }
+  // not populated, so that the threads copying the file read it in
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return KATANA_ERROR(katana::ResultErrno(), "mapping {}", std::quoted(path));
+  }
+  std::unique_ptr<GrFile> file(new GrFile(data, size));
+
+  if (file->version_ != 1 && file->version_ != 2) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} has unknown .gr version {}",
+        std::quoted(path), file->version_);
+  }
+  if (file->num_nodes_ > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "{} has {} nodes, more than a topology can hold", std::quoted(path),
+        file->num_nodes_);
+  }
+  // divide rather than multiply so that huge counts cannot overflow
+  if (file->num_nodes_ > (size - kHeaderBytes) / sizeof(uint64_t) ||
+      file->num_edges_ > (size - file->DestsOffset()) / sizeof(uint32_t) ||
+      file->EdgeDataOffset() > size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} is too short for {} nodes and {} edges", std::quoted(path),
+        file->num_nodes_, file->num_edges_);
+  }
+  return katana::MakeResult(std::move(file));
+}
+
+katana::Result<katana::GraphTopology>
+CopyTopology(const GrFile& file, const std::string& path) {
+  const uint64_t num_nodes = file.num_nodes();
+  const uint64_t num_edges = file.num_edges();
+  Edge end = num_nodes == 0 ? 0 : file.NodeEnd(num_nodes - 1);
+  if (end != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the edges of the nodes of {} do not end at its {} edges",
+        std::quoted(path), num_edges);
+  }
+
+  katana::GReduceLogicalOr bad_ends;
+  katana::NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        adj_indices[n] = file.NodeEnd(n);
+        if (n > 0 && adj_indices[n] < file.NodeEnd(n - 1)) {
+          bad_ends.update(true);
+        }
+      },
+      katana::no_stats());
+  if (bad_ends.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the edges of the nodes of {} are out of order", std::quoted(path));
+  }
+
+  katana::GReduceLogicalOr bad_dests;
+  katana::NUMAArray<Node> dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        uint64_t dest = file.Dest(e);
+        if (dest >= num_nodes) {
+          bad_dests.update(true);
+        }
+        dests[e] = static_cast<Node>(dest);
+      },
+      katana::no_stats());
+  if (bad_dests.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} has edges to nodes beyond its {} nodes", std::quoted(path),
+        num_nodes);
+  }
+
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+/// The edge data of file as a table with a column named name
+katana::Result<std::shared_ptr<arrow::Table>>
+CopyEdgeData(
+    const GrFile& file, const std::string& path, const std::string& name) {
+  std::shared_ptr<arrow::DataType> type;
+  switch (file.edge_data_size()) {
+  case sizeof(uint32_t):
+    type = arrow::uint32();
+    break;
+  case sizeof(uint64_t):
+    type = arrow::uint64();
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "the edge data of {} is {} bytes an edge, not 4 or 8",
+        std::quoted(path), file.edge_data_size());
+  }
+  if (!file.HasEdgeData()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} is too short for the data of its edges", std::quoted(path));
+  }
+
+  const int64_t num_edges = file.num_edges();
+  std::shared_ptr<arrow::Buffer> values = KATANA_CHECKED(
+      arrow::AllocateBuffer(num_edges * file.edge_data_size()));
+  if (file.edge_data_size() == sizeof(uint32_t)) {
+    auto* in = reinterpret_cast<const uint32_t*>(file.EdgeData());
+    auto* out = reinterpret_cast<uint32_t*>(values->mutable_data());
+    katana::do_all(
+        katana::iterate(int64_t{0}, num_edges),
+        [&](int64_t e) { out[e] = katana::convert_le32toh(in[e]); },
+        katana::no_stats());
+  } else {
+    auto* in = reinterpret_cast<const uint64_t*>(file.EdgeData());
+    auto* out = reinterpret_cast<uint64_t*>(values->mutable_data());
+    katana::do_all(
+        katana::iterate(int64_t{0}, num_edges),
+        [&](int64_t e) { out[e] = katana::convert_le64toh(in[e]); },
+        katana::no_stats());
+  }
+
+  std::shared_ptr<arrow::Array> column = arrow::MakeArray(
+      arrow::ArrayData::Make(type, num_edges, {nullptr, std::move(values)}));
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, type)}), {column});
+}
+
+}  // namespace
+
+katana::Result<katana::GraphTopology>
+katana::LoadGrTopology(const std::string& path) {
+  std::unique_ptr<GrFile> file = KATANA_CHECKED(GrFile::Open(path));
+  return CopyTopology(*file, path);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::MakePropertyGraphFromGr(
+    const std::string& path, const std::string& edge_property_name,
+    TxnContext* txn_ctx) {
+  std::unique_ptr<GrFile> file = KATANA_CHECKED(GrFile::Open(path));
+  std::shared_ptr<arrow::Table> edge_data;
+  if (!edge_property_name.empty()) {
+    edge_data =
+        KATANA_CHECKED(CopyEdgeData(*file, path, edge_property_name));
+  }
+
+  GraphTopology topo = KATANA_CHECKED(CopyTopology(*file, path));
+  std::unique_ptr<PropertyGraph> pg =
+      KATANA_CHECKED(PropertyGraph::Make(std::move(topo)));
+  if (edge_data) {
+    KATANA_CHECKED_CONTEXT(
+        pg->AddEdgeProperties(edge_data, txn_ctx),
+        "adding edge property {}", std::quoted(edge_property_name));
+  }
+  return MakeResult(std::move(pg));
+}
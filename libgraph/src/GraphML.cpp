@@ -1,11 +1,21 @@
 #include "katana/GraphML.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <string_view>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
@@ -270,6 +280,17 @@ ResolveValue(const std::string& val, ImportDataType type, bool is_list) {
 /* Functions for parsing GraphML files */
 /***************************************/
 
+/// A node or edge as it appears in the GraphML file, parsed but not yet added
+/// to a builder
+struct GraphMLElement {
+  bool is_node{true};
+  std::string id;
+  std::string source;
+  std::string target;
+  std::vector<std::string> labels;
+  std::vector<std::pair<std::string, std::string>> properties;
+};
+
 /*
  * reader should be pointing at the data element before calling
  *
@@ -327,15 +348,15 @@ ProcessData(xmlTextReaderPtr reader) {
  *
  * parses the node from a GraphML file into readable form
  */
-void
-ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+GraphMLElement
+ParseNode(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string id;
-  std::vector<std::string> labels;
+  GraphMLElement node;
+  node.is_node = true;
 
   bool extractedLabels = false;  // neo4j includes these twice so only parse 1
 
@@ -346,7 +367,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
 
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
-        id = std::string((const char*)value);
+        node.id = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
@@ -355,7 +376,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
         if (data.front() == ':') {
           data.erase(0, 1);
         }
-        boost::split(labels, data, boost::is_any_of(":"));
+        boost::split(node.labels, data, boost::is_any_of(":"));
         extractedLabels = true;
       } else {
         KATANA_LOG_ERROR(
@@ -369,11 +390,6 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool validNode = !id.empty();
-  if (validNode) {
-    builder->StartNode(id);
-  }
-
   // parse "data" xml nodes for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </node> reached or an improper read
@@ -397,22 +413,11 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
               if (data.front() == ':') {
                 data.erase(0, 1);
               }
-              boost::split(labels, data, boost::is_any_of(":"));
+              boost::split(node.labels, data, boost::is_any_of(":"));
               extractedLabels = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (validNode) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            node.properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -426,15 +431,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderRead(reader);
   }
 
-  // add labels if they exists
-  if (validNode) {
-    if (!labels.empty()) {
-      for (std::string label : labels) {
-        builder->AddLabel(label);
-      }
-    }
-    builder->FinishNode();
-  }
+  return node;
 }
 
 /*
@@ -442,15 +439,16 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  *
  * parses the edge from a GraphML file into readable form
  */
-void
-ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+GraphMLElement
+ParseEdge(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string source;
-  std::string target;
+  GraphMLElement edge;
+  edge.is_node = false;
+
   std::string type;
   bool extracted_type = false;  // neo4j includes these twice so only parse 1
 
@@ -462,9 +460,9 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     if (name != NULL) {
       if (xmlStrEqual(name, BAD_CAST "id")) {
       } else if (xmlStrEqual(name, BAD_CAST "source")) {
-        source = std::string((const char*)value);
+        edge.source = std::string((const char*)value);
       } else if (xmlStrEqual(name, BAD_CAST "target")) {
-        target = std::string((const char*)value);
+        edge.target = std::string((const char*)value);
       } else if (
           xmlStrEqual(name, BAD_CAST "labels") ||
           xmlStrEqual(name, BAD_CAST "label")) {
@@ -482,11 +480,6 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool valid_edge = !source.empty() && !target.empty();
-  if (valid_edge) {
-    valid_edge = builder->StartEdge(source, target);
-  }
-
   // parse "data" xml edges for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </edge> reached or an improper read
@@ -509,18 +502,7 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
               extracted_type = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (valid_edge) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            edge.properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -533,11 +515,52 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderRead(reader);
   }
 
-  // add type if it exists
-  if (valid_edge) {
-    if (type.length() > 0) {
-      builder->AddLabel(type);
+  // an edge has at most one type
+  if (type.length() > 0) {
+    edge.labels.emplace_back(std::move(type));
+  }
+  return edge;
+}
+
+/*
+ * adds a parsed node or edge to the builder, skipping nodes without an id and
+ * edges the builder does not accept
+ */
+void
+AddElement(
+    const GraphMLElement& element, katana::PropertyGraphBuilder* builder) {
+  if (element.is_node) {
+    if (element.id.empty()) {
+      return;
+    }
+    builder->StartNode(element.id);
+  } else {
+    if (element.source.empty() || element.target.empty() ||
+        !builder->StartEdge(element.source, element.target)) {
+      return;
     }
+  }
+
+  for (const auto& property : element.properties) {
+    const std::string& value = property.second;
+    builder->AddValue(
+        property.first,
+        [&]() {
+          return PropertyKey{property.first, ImportDataType::kString, false};
+        },
+        [&value](ImportDataType type, bool is_list) {
+          return ResolveValue(value, type, is_list);
+        });
+  }
+
+  // add labels if they exists
+  for (const std::string& label : element.labels) {
+    builder->AddLabel(label);
+  }
+
+  if (element.is_node) {
+    builder->FinishNode();
+  } else {
     builder->FinishEdge();
   }
 }
@@ -545,12 +568,12 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
 /*
  * reader should be pointing at the graph element before calling
  *
- * parses the graph structure from a GraphML file into Galois format
+ * parses the graph structure from a GraphML file, handing every node and edge
+ * to element_fn in file order
  */
+template <typename ElementFn>
 void
-ProcessGraph(
-    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
-    bool verbose) {
+ProcessGraph(xmlTextReaderPtr reader, ElementFn element_fn, bool verbose) {
   auto minimum_depth = xmlTextReaderDepth(reader);
   int ret = xmlTextReaderRead(reader);
 
@@ -567,7 +590,7 @@ ProcessGraph(
     if (xmlTextReaderNodeType(reader) == 1) {
       // if elt is a "node" xml node read it in
       if (xmlStrEqual(name, BAD_CAST "node")) {
-        ProcessNode(reader, builder);
+        element_fn(ParseNode(reader));
       } else if (xmlStrEqual(name, BAD_CAST "edge")) {
         if (!finished_nodes) {
           finished_nodes = true;
@@ -576,7 +599,7 @@ ProcessGraph(
           }
         }
         // if elt is an "egde" xml node read it in
-        ProcessEdge(reader, builder);
+        element_fn(ParseEdge(reader));
       } else {
         KATANA_LOG_ERROR(
             "Found element: {}, which was ignored",
@@ -592,11 +615,369 @@ ProcessGraph(
   }
 }
 
+/*
+ * reads "key" xml nodes and adds them to the builder until the first "graph"
+ * xml node is reached
+ *
+ * returns the result of the last read; if it is 1 the reader is pointing at
+ * the graph element
+ */
+int
+ProcessKeys(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+  int ret = 0;
+  while ((ret = xmlTextReaderRead(reader)) == 1) {
+    xmlChar* name = xmlTextReaderName(reader);
+    if (name == NULL) {
+      name = xmlStrdup(BAD_CAST "--");
+    }
+    bool found_graph = false;
+    // if elt is an xml node
+    if (xmlTextReaderNodeType(reader) == 1) {
+      // if elt is a "key" xml node read it in
+      if (xmlStrEqual(name, BAD_CAST "key")) {
+        PropertyKey key = katana::graphml::ProcessKey(reader);
+        if (!key.id.empty() && key.id != std::string("label") &&
+            key.id != std::string("IGNORE")) {
+          if (key.for_node) {
+            builder->AddBuilder(std::move(key));
+          } else if (key.for_edge) {
+            builder->AddBuilder(std::move(key));
+          }
+        }
+      } else if (xmlStrEqual(name, BAD_CAST "graph")) {
+        found_graph = true;
+      }
+    }
+    xmlFree(name);
+    if (found_graph) {
+      break;
+    }
+  }
+  return ret;
+}
+
+/**************************************************/
+/* Functions for parsing GraphML files in parallel */
+/**************************************************/
+
+/// A read only private mapping of a whole file
+class MappedFile {
+public:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+  }
+
+  /// Returns nullptr if \p path cannot be mapped
+  static std::unique_ptr<MappedFile> Make(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return nullptr;
+    }
+    struct stat buf;
+    if (fstat(fd, &buf) != 0 || buf.st_size == 0) {
+      close(fd);
+      return nullptr;
+    }
+    size_t size = buf.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      return nullptr;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    return std::unique_ptr<MappedFile>(new MappedFile(data, size));
+  }
+
+  std::string_view view() const {
+    return std::string_view(static_cast<const char*>(data_), size_);
+  }
+
+private:
+  MappedFile(void* data, size_t size) : data_(data), size_(size) {}
+
+  void* data_;
+  size_t size_;
+};
+
+bool
+IsNameEnd(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '>' ||
+         c == '/';
+}
+
+/// Returns the [begin, end) offsets of the first start tag "<name ...>" in
+/// \p text
+std::optional<std::pair<size_t, size_t>>
+FindStartTag(std::string_view text, const std::string& name) {
+  std::string open = "<" + name;
+  for (size_t pos = text.find(open); pos != std::string_view::npos;
+       pos = text.find(open, pos + 1)) {
+    size_t after = pos + open.size();
+    if (after < text.size() && !IsNameEnd(text[after])) {
+      continue;
+    }
+    char quote = 0;
+    for (size_t i = after; i < text.size(); ++i) {
+      if (quote != 0) {
+        if (text[i] == quote) {
+          quote = 0;
+        }
+      } else if (text[i] == '"' || text[i] == '\'') {
+        quote = text[i];
+      } else if (text[i] == '>') {
+        return std::make_pair(pos, i + 1);
+      }
+    }
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+/// Returns the offset of the first "<node" or "<edge" start tag in
+/// [from, end) of \p text, or end if there is none
+size_t
+FindElementStart(std::string_view text, size_t from, size_t end) {
+  for (size_t pos = text.find('<', from); pos < end;
+       pos = text.find('<', pos + 1)) {
+    if (pos + 5 >= end) {
+      break;
+    }
+    std::string_view tag = text.substr(pos + 1, 4);
+    if ((tag == "node" || tag == "edge") && IsNameEnd(text[pos + 5])) {
+      return pos;
+    }
+  }
+  return end;
+}
+
+/// The document prologue must not declare anything (entities, encodings)
+/// that a chunk parsed on its own would not see
+bool
+IsSplittableHeader(std::string_view header) {
+  if (header.find("<!") != std::string_view::npos) {
+    return false;
+  }
+  size_t decl_end = header.find("?>");
+  size_t encoding = header.find("encoding=");
+  if (encoding != std::string_view::npos && encoding < decl_end) {
+    std::string_view value = header.substr(encoding + 10, 6);
+    return boost::iequals(value.substr(0, 5), std::string_view("UTF-8")) &&
+           (value.back() == '"' || value.back() == '\'');
+  }
+  return true;
+}
+
+/// Chunk boundaries are only found by looking for node and edge start tags, so
+/// anything that can hide a "<node" from that search, or that spans elements,
+/// makes the split unsafe: comments, CDATA sections, processing instructions
+/// and nested graphs
+bool
+IsSplittableChunk(std::string_view chunk) {
+  return chunk.find("<!") == std::string_view::npos &&
+         chunk.find("<?") == std::string_view::npos &&
+         chunk.find("<graph") == std::string_view::npos;
+}
+
+constexpr std::string_view kChunkSuffix = "</graph></graphml>";
+
+/// Feeds libxml a chunk of the graph body wrapped in the original graphml and
+/// graph start tags, straight out of the mapped file
+struct ChunkInput {
+  std::array<std::string_view, 4> parts;
+  size_t part{0};
+  size_t offset{0};
+};
+
+int
+ReadChunkInput(void* context, char* buffer, int len) {
+  auto* input = static_cast<ChunkInput*>(context);
+  size_t written = 0;
+  size_t capacity = len;
+  while (written < capacity && input->part < input->parts.size()) {
+    std::string_view part = input->parts[input->part];
+    size_t n = std::min(capacity - written, part.size() - input->offset);
+    std::memcpy(buffer + written, part.data() + input->offset, n);
+    written += n;
+    input->offset += n;
+    if (input->offset == part.size()) {
+      ++input->part;
+      input->offset = 0;
+    }
+  }
+  return static_cast<int>(written);
+}
+
+struct ParsedChunk {
+  std::vector<GraphMLElement> elements;
+  bool ok{false};
+};
+
+ParsedChunk
+ParseChunk(
+    std::string_view graphml_tag, std::string_view graph_tag,
+    std::string_view chunk) {
+  ParsedChunk parsed;
+  if (!IsSplittableChunk(chunk)) {
+    return parsed;
+  }
+
+  ChunkInput input{{graphml_tag, graph_tag, chunk, kChunkSuffix}};
+  xmlTextReaderPtr reader =
+      xmlReaderForIO(ReadChunkInput, nullptr, &input, nullptr, nullptr, 0);
+  if (reader == NULL) {
+    return parsed;
+  }
+
+  int ret = 0;
+  while ((ret = xmlTextReaderRead(reader)) == 1) {
+    if (xmlTextReaderNodeType(reader) == 1 &&
+        xmlStrEqual(xmlTextReaderConstName(reader), BAD_CAST "graph")) {
+      break;
+    }
+  }
+  if (ret == 1) {
+    ProcessGraph(
+        reader,
+        [&parsed](GraphMLElement&& element) {
+          parsed.elements.emplace_back(std::move(element));
+        },
+        false);
+    // check the rest of the document is well formed
+    while ((ret = xmlTextReaderRead(reader)) == 1) {
+    }
+  }
+  xmlFreeTextReader(reader);
+
+  parsed.ok = ret == 0;
+  return parsed;
+}
+
+/*
+ * splits the body of the graph element at node and edge boundaries and parses
+ * the pieces in parallel; the parsed elements are added to the builder in file
+ * order, a window of chunks at a time, so memory use is bounded by the window
+ * rather than the file
+ *
+ * returns nullopt if the file cannot be split safely, in which case it should
+ * be parsed serially
+ */
+std::optional<katana::Result<katana::GraphComponents>>
+ConvertGraphMLParallel(
+    const std::string& infilename, size_t chunk_size, bool verbose,
+    size_t parse_chunk_bytes) {
+  auto file = MappedFile::Make(infilename);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::string_view text = file->view();
+
+  auto graphml_tag = FindStartTag(text, "graphml");
+  auto graph_tag = FindStartTag(text, "graph");
+  if (!graphml_tag || !graph_tag || graph_tag->first < graphml_tag->second ||
+      text[graph_tag->second - 2] == '/' ||
+      !IsSplittableHeader(text.substr(0, graph_tag->first))) {
+    return std::nullopt;
+  }
+  size_t body_begin = graph_tag->second;
+  size_t body_end = text.rfind("</graph>");
+  if (body_end == std::string_view::npos || body_end < body_begin) {
+    return std::nullopt;
+  }
+
+  katana::PropertyGraphBuilder builder{chunk_size};
+  {
+    xmlTextReaderPtr reader = xmlNewTextReaderFilename(infilename.c_str());
+    if (reader == NULL) {
+      return std::nullopt;
+    }
+    int ret = ProcessKeys(reader, &builder);
+    xmlFreeTextReader(reader);
+    if (ret != 1) {
+      return std::nullopt;
+    }
+  }
+  if (verbose) {
+    std::cout << "Finished processing property headers\n";
+  }
+
+  std::vector<size_t> boundaries{body_begin};
+  while (boundaries.back() < body_end) {
+    size_t next = boundaries.back() + parse_chunk_bytes;
+    if (next < body_end) {
+      next = FindElementStart(text, next, body_end);
+    }
+    boundaries.emplace_back(std::min(next, body_end));
+  }
+  size_t num_chunks = boundaries.size() - 1;
+
+  std::string_view graphml_view = text.substr(
+      graphml_tag->first, graphml_tag->second - graphml_tag->first);
+  std::string_view graph_view =
+      text.substr(graph_tag->first, graph_tag->second - graph_tag->first);
+
+  // libxml needs to be initialized before parsers are created concurrently
+  xmlInitParser();
+
+  auto start = std::chrono::steady_clock::now();
+  size_t window = 2 * katana::getActiveThreads();
+  std::vector<ParsedChunk> parsed(window);
+  for (size_t first = 0; first < num_chunks; first += window) {
+    size_t last = std::min(first + window, num_chunks);
+    katana::do_all(
+        katana::iterate(first, last),
+        [&](size_t c) {
+          parsed[c - first] = ParseChunk(
+              graphml_view, graph_view,
+              text.substr(boundaries[c], boundaries[c + 1] - boundaries[c]));
+        },
+        katana::steal(), katana::no_stats());
+
+    for (size_t c = first; c < last; ++c) {
+      if (!parsed[c - first].ok) {
+        if (verbose) {
+          std::cout << "Unable to split GraphML input, parsing serially\n";
+        }
+        return std::nullopt;
+      }
+    }
+    for (size_t c = first; c < last; ++c) {
+      for (const auto& element : parsed[c - first].elements) {
+        AddElement(element, &builder);
+      }
+      parsed[c - first] = ParsedChunk{};
+    }
+  }
+
+  if (verbose) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    double mbytes = static_cast<double>(text.size()) / (1 << 20);
+    std::cout << fmt::format(
+        "Finished processing graph: {:.1f} MB in {} chunks, {:.1f} MB/s\n",
+        mbytes, num_chunks, mbytes / std::max(elapsed.count(), 1e-9));
+  }
+
+  return builder.Finish(verbose);
+}
+
 }  // end of unnamed namespace
 
 katana::Result<katana::GraphComponents>
 katana::ConvertGraphML(
-    const std::string& infilename, size_t chunk_size, bool verbose) {
+    const std::string& infilename, size_t chunk_size, bool verbose,
+    size_t parse_chunk_bytes) {
+  if (parse_chunk_bytes > 0) {
+    auto res = ConvertGraphMLParallel(
+        infilename, chunk_size, verbose, parse_chunk_bytes);
+    if (res) {
+      return std::move(res.value());
+    }
+  }
+
   xmlTextReaderPtr reader;
 
   reader = xmlNewTextReaderFilename(infilename.c_str());
@@ -611,42 +992,24 @@ katana::ConvertGraphML(
 katana::Result<katana::GraphComponents>
 katana::ConvertGraphML(
     xmlTextReaderPtr reader, size_t chunk_size, bool verbose) {
-  int ret = 0;
-  bool finishedGraph = false;
-
   katana::PropertyGraphBuilder builder{chunk_size};
 
   // procedure:
   // read in "key" xml nodes and add them to nodeKeys and edgeKeys
   // once we reach the first "graph" xml node we parse it using the above keys
   // once we have parsed the first "graph" xml node we exit
-  while ((ret = xmlTextReaderRead(reader)) == 1 && !finishedGraph) {
-    xmlChar* name = xmlTextReaderName(reader);
-    if (name == NULL) {
-      name = xmlStrdup(BAD_CAST "--");
-    }
-    // if elt is an xml node
-    if (xmlTextReaderNodeType(reader) == 1) {
-      // if elt is a "key" xml node read it in
-      if (xmlStrEqual(name, BAD_CAST "key")) {
-        PropertyKey key = katana::graphml::ProcessKey(reader);
-        if (!key.id.empty() && key.id != std::string("label") &&
-            key.id != std::string("IGNORE")) {
-          if (key.for_node) {
-            builder.AddBuilder(std::move(key));
-          } else if (key.for_edge) {
-            builder.AddBuilder(std::move(key));
-          }
-        }
-      } else if (xmlStrEqual(name, BAD_CAST "graph")) {
-        if (verbose) {
-          std::cout << "Finished processing property headers\n";
-        }
-        ProcessGraph(reader, &builder, false);
-        finishedGraph = true;
-      }
+  int ret = ProcessKeys(reader, &builder);
+  if (ret == 1) {
+    if (verbose) {
+      std::cout << "Finished processing property headers\n";
     }
-    xmlFree(name);
+    ProcessGraph(
+        reader,
+        [&builder](GraphMLElement&& element) {
+          AddElement(element, &builder);
+        },
+        false);
+    ret = xmlTextReaderRead(reader);
   }
   if (ret < 0) {
     return KATANA_ERROR(
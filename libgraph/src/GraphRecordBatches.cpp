@@ -0,0 +1,478 @@
+#include "katana/GraphRecordBatches.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <limits>
+#include <utility>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/compute/api_vector.h>
+#include <arrow/compute/cast.h>
+#include <arrow/table.h>
+#include <arrow/type_traits.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelArrow.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// A TableBatchReader that owns its table; TableBatchReader itself only keeps
+/// a reference to it
+class OwningTableBatchReader final : public arrow::RecordBatchReader {
+public:
+  OwningTableBatchReader(
+      std::shared_ptr<arrow::Table> table, int64_t max_batch_rows)
+      : table_(std::move(table)), reader_(*table_) {
+    reader_.set_chunksize(max_batch_rows);
+  }
+
+  std::shared_ptr<arrow::Schema> schema() const override {
+    return table_->schema();
+  }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    return reader_.ReadNext(batch);
+  }
+
+private:
+  std::shared_ptr<arrow::Table> table_;
+  arrow::TableBatchReader reader_;
+};
+
+/// An Arrow buffer over memory that owner keeps alive
+class OwnedBuffer final : public arrow::Buffer {
+public:
+  OwnedBuffer(const void* data, int64_t size, std::shared_ptr<const void> owner)
+      : arrow::Buffer(static_cast<const uint8_t*>(data), size),
+        owner_(std::move(owner)) {}
+
+private:
+  std::shared_ptr<const void> owner_;
+};
+
+class EdgeListBatchReader final : public arrow::RecordBatchReader {
+public:
+  EdgeListBatchReader(
+      std::shared_ptr<const katana::PropertyGraph> pg, int64_t max_batch_rows)
+      : pg_(std::move(pg)), max_batch_rows_(max_batch_rows) {}
+
+  std::shared_ptr<arrow::Schema> schema() const override {
+    auto type = arrow::CTypeTraits<Node>::type_singleton();
+    return arrow::schema(
+        {arrow::field("source", type, false),
+         arrow::field("dest", type, false)});
+  }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    const katana::GraphTopology& topo = pg_->topology();
+    uint64_t begin = next_;
+    uint64_t end = std::min(
+        topo.NumEdges(), begin + static_cast<uint64_t>(max_batch_rows_));
+    if (begin == end) {
+      *batch = nullptr;
+      return arrow::Status::OK();
+    }
+    int64_t size = end - begin;
+
+    ARROW_ASSIGN_OR_RAISE(
+        std::shared_ptr<arrow::Buffer> sources,
+        arrow::AllocateBuffer(size * sizeof(Node)));
+    auto* out = reinterpret_cast<Node*>(sources->mutable_data());
+    const katana::GraphTopology::Edge* adj_indices = topo.AdjData();
+    Node src = topo.GetEdgeSrc(begin);
+    for (uint64_t e = begin; e < end; ++e) {
+      while (adj_indices[src] <= e) {
+        ++src;
+      }
+      out[e - begin] = src;
+    }
+
+    auto dests = std::make_shared<OwnedBuffer>(
+        topo.DestData() + begin, size * sizeof(Node), pg_);
+
+    auto type = arrow::CTypeTraits<Node>::type_singleton();
+    *batch = arrow::RecordBatch::Make(
+        schema(), size,
+        {arrow::MakeArray(
+             arrow::ArrayData::Make(type, size, {nullptr, std::move(sources)})),
+         arrow::MakeArray(
+             arrow::ArrayData::Make(type, size, {nullptr, std::move(dests)}))});
+    next_ = end;
+    return arrow::Status::OK();
+  }
+
+private:
+  std::shared_ptr<const katana::PropertyGraph> pg_;
+  int64_t max_batch_rows_;
+  uint64_t next_{0};
+};
+
+katana::Result<void>
+CheckMaxBatchRows(int64_t max_batch_rows) {
+  if (max_batch_rows <= 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "batches must have at least one row, not {}", max_batch_rows);
+  }
+  return katana::ResultSuccess();
+}
+
+/// \returns the indexes of the columns of batch but those in skip
+std::vector<int>
+PropertyColumns(const arrow::RecordBatch& batch, const std::vector<int>& skip) {
+  std::vector<int> indexes;
+  for (int i = 0; i < batch.num_columns(); ++i) {
+    if (std::find(skip.begin(), skip.end(), i) == skip.end()) {
+      indexes.emplace_back(i);
+    }
+  }
+  return indexes;
+}
+
+/// \returns column as a single chunk, concatenating its chunks if needed
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+SingleChunk(std::shared_ptr<arrow::ChunkedArray> column) {
+  if (column->num_chunks() == 1) {
+    return column;
+  }
+  return std::make_shared<arrow::ChunkedArray>(
+      KATANA_CHECKED(katana::Unchunk(column)));
+}
+
+/// \returns a reader over the columns of the properties of schema named in
+/// properties, or over all of them if it is empty
+template <typename GetColumn>
+katana::Result<std::shared_ptr<arrow::RecordBatchReader>>
+MakePropertyBatchReader(
+    const std::shared_ptr<arrow::Schema>& schema, GetColumn get_column,
+    const std::vector<std::string>& properties, int64_t max_batch_rows) {
+  KATANA_CHECKED(CheckMaxBatchRows(max_batch_rows));
+
+  std::vector<int> indexes;
+  if (properties.empty()) {
+    for (int i = 0; i < schema->num_fields(); ++i) {
+      indexes.emplace_back(i);
+    }
+  }
+  for (const auto& name : properties) {
+    int i = schema->GetFieldIndex(name);
+    if (i == -1) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "property {} is not loaded",
+          std::quoted(name));
+    }
+    indexes.emplace_back(i);
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i : indexes) {
+    fields.emplace_back(schema->field(i));
+    columns.emplace_back(get_column(i));
+  }
+  return std::make_shared<OwningTableBatchReader>(
+      arrow::Table::Make(arrow::schema(fields), columns), max_batch_rows);
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::RecordBatchReader>>
+katana::MakeNodePropertyBatchReader(
+    const PropertyGraph& pg, const std::vector<std::string>& properties,
+    int64_t max_batch_rows) {
+  return MakePropertyBatchReader(
+      pg.loaded_node_schema(), [&pg](int i) { return pg.GetNodeProperty(i); },
+      properties, max_batch_rows);
+}
+
+katana::Result<std::shared_ptr<arrow::RecordBatchReader>>
+katana::MakeEdgePropertyBatchReader(
+    const PropertyGraph& pg, const std::vector<std::string>& properties,
+    int64_t max_batch_rows) {
+  return MakePropertyBatchReader(
+      pg.loaded_edge_schema(), [&pg](int i) { return pg.GetEdgeProperty(i); },
+      properties, max_batch_rows);
+}
+
+katana::Result<std::shared_ptr<arrow::RecordBatchReader>>
+katana::MakeEdgeListBatchReader(
+    std::shared_ptr<const PropertyGraph> pg, int64_t max_batch_rows) {
+  KATANA_CHECKED(CheckMaxBatchRows(max_batch_rows));
+  return std::make_shared<EdgeListBatchReader>(std::move(pg), max_batch_rows);
+}
+
+katana::Result<void>
+katana::RecordBatchGraphBuilder::Columns::Check(
+    const arrow::RecordBatch& batch, const std::vector<int>& skip) const {
+  if (!schema) {
+    return ResultSuccess();
+  }
+  std::vector<int> indexes = PropertyColumns(batch, skip);
+  bool same = static_cast<int>(indexes.size()) == schema->num_fields();
+  for (size_t i = 0; same && i < indexes.size(); ++i) {
+    same = batch.schema()->field(indexes[i])->Equals(schema->field(i));
+  }
+  if (!same) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "batch properties do not match those of the first batch: {} vs {}",
+        batch.schema()->ToString(), schema->ToString());
+  }
+  return ResultSuccess();
+}
+
+void
+katana::RecordBatchGraphBuilder::Columns::Append(
+    const arrow::RecordBatch& batch, const std::vector<int>& skip) {
+  std::vector<int> indexes = PropertyColumns(batch, skip);
+  if (!schema) {
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    for (int i : indexes) {
+      fields.emplace_back(batch.schema()->field(i));
+    }
+    schema = arrow::schema(fields);
+    chunks.resize(fields.size());
+  }
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    chunks[i].emplace_back(batch.column(indexes[i]));
+  }
+}
+
+std::vector<std::shared_ptr<arrow::ChunkedArray>>
+katana::RecordBatchGraphBuilder::Columns::ToChunkedArrays() const {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        chunks[i], schema->field(i)->type()));
+  }
+  return columns;
+}
+
+katana::Result<void>
+katana::RecordBatchGraphBuilder::ReadIds(
+    const arrow::RecordBatch& batch, const std::string& column,
+    std::vector<int64_t>* ids) const {
+  std::shared_ptr<arrow::Array> array = batch.GetColumnByName(column);
+  if (!array) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "batch has no id column {}",
+        std::quoted(column));
+  }
+  if (!arrow::is_integer(array->type_id())) {
+    return KATANA_ERROR(
+        ErrorCode::TypeError, "id column {} has type {}, not an integer",
+        std::quoted(column), array->type()->ToString());
+  }
+  if (array->null_count() != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "id column {} has {} nulls",
+        std::quoted(column), array->null_count());
+  }
+  auto int64s = std::static_pointer_cast<arrow::Int64Array>(
+      KATANA_CHECKED_CONTEXT(
+          arrow::compute::Cast(*array, arrow::int64()),
+          "converting ids of {}", std::quoted(column)));
+  ids->insert(
+      ids->end(), int64s->raw_values(),
+      int64s->raw_values() + int64s->length());
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::RecordBatchGraphBuilder::AddNodes(const arrow::RecordBatch& batch) {
+  std::vector<int64_t> ids;
+  KATANA_CHECKED(ReadIds(batch, options_.node_id_column, &ids));
+  KATANA_CHECKED(node_columns_.Check(batch, {}));
+  if (ids.size() > std::numeric_limits<PropertyGraph::Node>::max() -
+                       num_nodes_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "too many nodes: {} + {}", num_nodes_,
+        ids.size());
+  }
+
+  for (size_t i = 0; i < ids.size(); ++i) {
+    auto node = static_cast<PropertyGraph::Node>(num_nodes_ + i);
+    if (options_.dense_node_ids) {
+      if (ids[i] != static_cast<int64_t>(node)) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "node ids are not dense: node {} has id {}", node, ids[i]);
+      }
+      continue;
+    }
+    if (!node_index_.emplace(ids[i], node).second) {
+      for (size_t j = 0; j < i; ++j) {
+        node_index_.erase(ids[j]);
+      }
+      return KATANA_ERROR(
+          ErrorCode::AlreadyExists, "node id {} appears twice", ids[i]);
+    }
+  }
+
+  node_columns_.Append(batch, {});
+  num_nodes_ += ids.size();
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::RecordBatchGraphBuilder::AddEdges(const arrow::RecordBatch& batch) {
+  std::vector<int64_t> sources;
+  KATANA_CHECKED(ReadIds(batch, options_.source_column, &sources));
+  std::vector<int64_t> dests;
+  KATANA_CHECKED(ReadIds(batch, options_.dest_column, &dests));
+  std::vector<int> skip{
+      batch.schema()->GetFieldIndex(options_.source_column),
+      batch.schema()->GetFieldIndex(options_.dest_column)};
+  KATANA_CHECKED(edge_columns_.Check(batch, skip));
+
+  edge_columns_.Append(batch, skip);
+  sources_.insert(sources_.end(), sources.begin(), sources.end());
+  dests_.insert(dests_.end(), dests.begin(), dests.end());
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::RecordBatchGraphBuilder::AddNodes(arrow::RecordBatchReader* reader) {
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (true) {
+    KATANA_CHECKED(reader->ReadNext(&batch));
+    if (!batch) {
+      return ResultSuccess();
+    }
+    KATANA_CHECKED(AddNodes(*batch));
+  }
+}
+
+katana::Result<void>
+katana::RecordBatchGraphBuilder::AddEdges(arrow::RecordBatchReader* reader) {
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (true) {
+    KATANA_CHECKED(reader->ReadNext(&batch));
+    if (!batch) {
+      return ResultSuccess();
+    }
+    KATANA_CHECKED(AddEdges(*batch));
+  }
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::RecordBatchGraphBuilder::Finish(TxnContext* txn_ctx) {
+  RecordBatchGraphBuilder built(std::move(*this));
+  *this = RecordBatchGraphBuilder(built.options_);
+
+  uint64_t num_nodes = built.num_nodes_;
+  uint64_t num_edges = built.sources_.size();
+
+  // Map the endpoints to nodes, remembering some edge that refers to a node
+  // that never arrived
+  GraphTopology::EdgeDestVec sources;
+  sources.allocateInterleaved(num_edges);
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  std::atomic<uint64_t> missing{num_edges};
+  auto find_node = [&](int64_t id, Node* node) {
+    if (built.options_.dense_node_ids) {
+      *node = static_cast<Node>(id);
+      return id >= 0 && static_cast<uint64_t>(id) < num_nodes;
+    }
+    auto it = built.node_index_.find(id);
+    if (it == built.node_index_.end()) {
+      return false;
+    }
+    *node = it->second;
+    return true;
+  };
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        if (!find_node(built.sources_[e], &sources[e]) ||
+            !find_node(built.dests_[e], &dests[e])) {
+          missing.store(e, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats(), katana::loopname("RecordBatchGraphBuilderNodes"));
+  if (uint64_t e = missing.load(); e != num_edges) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "edge from {} to {} refers to a missing node",
+        built.sources_[e], built.dests_[e]);
+  }
+  built.node_index_.clear();
+  std::vector<int64_t>().swap(built.sources_);
+  std::vector<int64_t>().swap(built.dests_);
+
+  // Count the degrees and scatter the edges to their sources; the sort is
+  // stable, so the edges of a node stay in the order they arrived
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      adj_indices.begin(), adj_indices.end(), GraphTopology::Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { __sync_fetch_and_add(&adj_indices[sources[e]], 1); },
+      katana::no_stats(), katana::loopname("RecordBatchGraphBuilderDegrees"));
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  katana::NUMAArray<uint64_t> order;
+  order.allocateInterleaved(num_edges);
+  katana::ParallelSTL::iota(order.begin(), order.end(), uint64_t{0});
+  katana::ParallelSTL::radix_sort(
+      order.begin(), order.end(),
+      [&sources](uint64_t e) { return sources[e]; });
+
+  GraphTopology::EdgeDestVec out_dests;
+  out_dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { out_dests[e] = dests[order[e]]; }, katana::no_stats(),
+      katana::loopname("RecordBatchGraphBuilderDests"));
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(
+      GraphTopology(std::move(adj_indices), std::move(out_dests))));
+
+  if (built.node_columns_.schema) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (auto& column : built.node_columns_.ToChunkedArrays()) {
+      columns.emplace_back(KATANA_CHECKED(SingleChunk(std::move(column))));
+    }
+    auto table = arrow::Table::Make(built.node_columns_.schema, columns);
+    built.node_columns_ = Columns{};
+    KATANA_CHECKED_CONTEXT(
+        pg->AddNodeProperties(table, txn_ctx), "adding node properties");
+  }
+
+  if (built.edge_columns_.schema) {
+    // The index array does not copy order, which outlives every Take
+    auto index_array = std::make_shared<arrow::UInt64Array>(
+        num_edges, arrow::Buffer::Wrap(order.data(), num_edges));
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns =
+        built.edge_columns_.ToChunkedArrays();
+    std::vector<arrow::Result<arrow::Datum>> taken(columns.size());
+    katana::do_all(
+        katana::iterate(size_t{0}, columns.size()),
+        [&](size_t i) {
+          taken[i] = arrow::compute::Take(columns[i], index_array);
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("RecordBatchGraphBuilderEdgeProperties"));
+    for (size_t i = 0; i < columns.size(); ++i) {
+      arrow::Datum datum = KATANA_CHECKED_CONTEXT(
+          std::move(taken[i]), "taking rows of {}",
+          built.edge_columns_.schema->field(i)->name());
+      columns[i] = KATANA_CHECKED(SingleChunk(datum.chunked_array()));
+    }
+    KATANA_CHECKED_CONTEXT(
+        pg->AddEdgeProperties(
+            arrow::Table::Make(built.edge_columns_.schema, columns), txn_ctx),
+        "adding edge properties");
+  }
+
+  return std::unique_ptr<PropertyGraph>(std::move(pg));
+}
@@ -1,17 +1,380 @@
 #include "katana/GraphTopology.h"
 
 #include <math.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 #include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
 #include "katana/RDGTopology.h"
 #include "katana/Random.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
+#include "katana/TopologyManager.h"
+#include "katana/analytics/SetIntersection.h"
+
+namespace {
+
+/// Gives \p advice about the pages of \p dests [\p begin, \p end). With
+/// \p inward, only the pages entirely within the range are advised so that
+/// neighboring ranges are not affected.
+void
+AdviseDests(
+    const katana::GraphTopology::Node* dests, katana::GraphTopology::Edge begin,
+    katana::GraphTopology::Edge end, int advice, bool inward) {
+  if (begin >= end) {
+    return;
+  }
+  static const uintptr_t page_size = sysconf(_SC_PAGE_SIZE);
+  auto first = reinterpret_cast<uintptr_t>(dests + begin);
+  auto last = reinterpret_cast<uintptr_t>(dests + end);
+  auto round_down = [](uintptr_t p) { return p & ~(page_size - 1); };
+  auto round_up = [](uintptr_t p) {
+    return (p + page_size - 1) & ~(page_size - 1);
+  };
+  if (inward) {
+    first = round_up(first);
+    last = round_down(last);
+  } else {
+    first = round_down(first);
+    last = round_up(last);
+  }
+  if (first >= last) {
+    return;
+  }
+  if (madvise(reinterpret_cast<void*>(first), last - first, advice) != 0) {
+    KATANA_DEBUG_WARN_ONCE("madvise({}) failed: {}", advice, errno);
+  }
+}
+
+/// Sorts the edges of every node of a CSR topology in place, the
+/// destinations and edge property indexes together, by \p less on
+/// (destination, property index) pairs.
+///
+/// The work is balanced by edges rather than nodes: the nodes are cut into
+/// tiles of about the same number of edges, and the thread that takes a
+/// tile sorts the nodes starting in it through a buffer of pairs it reuses
+/// for all of them, which is much cheaper than sorting zip iterators. Nodes
+/// with more edges than a tile are sorted one after the other afterwards,
+/// each with a parallel sample sort through one shared buffer.
+template <typename Less>
+void
+SortEdgesSegmented(
+    const katana::GraphTopology::Edge* adj_indices, uint64_t num_nodes,
+    katana::GraphTopology::Node* dests,
+    katana::GraphTopology::PropertyIndex* edge_prop_indices,
+    const Less& less) {
+  using Node = katana::GraphTopology::Node;
+  using Edge = katana::GraphTopology::Edge;
+  using Entry = std::pair<Node, katana::GraphTopology::PropertyIndex>;
+
+  auto range = katana::edge_balanced_range<Node>(adj_indices, num_nodes);
+  const uint64_t max_light_degree = range.tile_size();
+
+  katana::PerThreadStorage<std::vector<Entry>> buffers;
+  katana::PerThreadStorage<std::vector<Node>> heavy_nodes;
+  katana::do_all_edges(
+      range,
+      [&](Node node, Edge begin, Edge end) {
+        const Edge node_begin = node > 0 ? adj_indices[node - 1] : 0;
+        const Edge node_end = adj_indices[node];
+        if (begin != node_begin) {
+          // sorted in the tile where its edges start
+          return;
+        }
+        if (node_end - node_begin > max_light_degree) {
+          heavy_nodes.getLocal()->emplace_back(node);
+          return;
+        }
+        if (end - begin < 2) {
+          return;
+        }
+        std::vector<Entry>& buffer = *buffers.getLocal();
+        buffer.clear();
+        for (Edge e = node_begin; e < node_end; ++e) {
+          buffer.emplace_back(dests[e], edge_prop_indices[e]);
+        }
+        std::sort(buffer.begin(), buffer.end(), less);
+        for (Edge e = node_begin; e < node_end; ++e) {
+          std::tie(dests[e], edge_prop_indices[e]) = buffer[e - node_begin];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<Node> heavy;
+  for (unsigned t = 0; t < heavy_nodes.size(); ++t) {
+    const std::vector<Node>& nodes = *heavy_nodes.getRemote(t);
+    heavy.insert(heavy.end(), nodes.begin(), nodes.end());
+  }
+  if (heavy.empty()) {
+    return;
+  }
+
+  uint64_t max_heavy_degree = 0;
+  for (Node node : heavy) {
+    const Edge node_begin = node > 0 ? adj_indices[node - 1] : 0;
+    max_heavy_degree =
+        std::max<uint64_t>(max_heavy_degree, adj_indices[node] - node_begin);
+  }
+  katana::NUMAArray<Entry> buffer;
+  buffer.allocateInterleaved(max_heavy_degree);
+  for (Node node : heavy) {
+    const Edge node_begin = node > 0 ? adj_indices[node - 1] : 0;
+    const uint64_t degree = adj_indices[node] - node_begin;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, degree),
+        [&](uint64_t i) {
+          buffer[i] =
+              Entry(dests[node_begin + i], edge_prop_indices[node_begin + i]);
+        },
+        katana::no_stats());
+    katana::ParallelSTL::sample_sort(
+        buffer.begin(), buffer.begin() + degree, less);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, degree),
+        [&](uint64_t i) {
+          std::tie(dests[node_begin + i], edge_prop_indices[node_begin + i]) =
+              buffer[i];
+        },
+        katana::no_stats());
+  }
+}
+
+/// Numbers the nodes of \p topo in breadth-first order over out-edges, one
+/// level at a time, with the nodes of a level found in parallel. A node
+/// belongs to the lowest numbered node of the previous level with an edge to
+/// it. The nodes of a level are numbered by the number of that node, then
+/// by degree if \p by_degree, then by id. Each new search starts at the
+/// unvisited node of lowest degree if \p by_degree, otherwise lowest id.
+/// \returns the old id of each new node
+katana::GraphTopology::PropIndexVec
+ComputeSearchOrder(const katana::EdgeShuffleTopology& topo, bool by_degree) {
+  using Node = katana::GraphTopology::Node;
+  const uint64_t num_nodes = topo.NumNodes();
+
+  katana::GraphTopology::PropIndexVec starts;
+  starts.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::iota(
+      starts.begin(), starts.end(),
+      katana::GraphTopology::PropertyIndex{0});
+  if (by_degree) {
+    // stable, so nodes of the same degree stay in id order
+    katana::ParallelSTL::radix_sort(
+        starts.begin(), starts.end(),
+        [&](uint64_t n) -> uint64_t { return topo.OutDegree(n); });
+  }
+
+  // 0 if unvisited, 1 if a node starts a search and otherwise 2 plus the
+  // number of the node it belongs to
+  katana::NUMAArray<std::atomic<uint64_t>> parent;
+  parent.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { parent[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  katana::GraphTopology::PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  katana::PerThreadStorage<std::vector<Node>> found;
+  uint64_t next = 0;
+  uint64_t next_start = 0;
+  while (next < num_nodes) {
+    while (parent[starts[next_start]].load(std::memory_order_relaxed) != 0) {
+      ++next_start;
+    }
+    Node start = starts[next_start];
+    parent[start].store(1, std::memory_order_relaxed);
+    order[next++] = start;
+    if (topo.OutDegree(start) == 0) {
+      // skip the loop overhead for isolated nodes
+      continue;
+    }
+
+    for (uint64_t level_begin = next - 1; level_begin < next;) {
+      uint64_t level_end = next;
+      katana::do_all(
+          katana::iterate(level_begin, level_end),
+          [&](uint64_t i) {
+            const uint64_t mine = i + 2;
+            for (auto e : topo.OutEdges(order[i])) {
+              std::atomic<uint64_t>& p = parent[topo.OutEdgeDst(e)];
+              uint64_t cur = p.load(std::memory_order_relaxed);
+              if (cur == 0 &&
+                  p.compare_exchange_strong(
+                      cur, mine, std::memory_order_relaxed)) {
+                found.getLocal()->emplace_back(topo.OutEdgeDst(e));
+                continue;
+              }
+              // only nodes found in this level change hands; nodes of
+              // earlier levels have parents before level_begin
+              while (cur >= level_begin + 2 && cur > mine &&
+                     !p.compare_exchange_weak(
+                         cur, mine, std::memory_order_relaxed)) {
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+
+      for (unsigned t = 0; t < found.size(); ++t) {
+        std::vector<Node>& nodes = *found.getRemote(t);
+        for (Node n : nodes) {
+          order[next++] = n;
+        }
+        nodes.clear();
+      }
+      katana::ParallelSTL::sample_sort(
+          order.begin() + level_end, order.begin() + next,
+          [&](uint64_t a, uint64_t b) {
+            uint64_t pa = parent[a].load(std::memory_order_relaxed);
+            uint64_t pb = parent[b].load(std::memory_order_relaxed);
+            if (pa != pb) {
+              return pa < pb;
+            }
+            if (by_degree) {
+              auto da = topo.OutDegree(a);
+              auto db = topo.OutDegree(b);
+              if (da != db) {
+                return da < db;
+              }
+            }
+            return a < b;
+          });
+      level_begin = level_end;
+    }
+  }
+  return order;
+}
+
+/// Sorted adjacencies at most this long are searched linearly
+constexpr size_t kLinearSearchThreshold = 64;
+
+/// \returns the number of \p dests less than \p dst, which is the position
+/// of dst if dests are sorted. The loop has no branch to mispredict and is
+/// vectorized by the compiler.
+size_t
+CountLess(
+    const katana::GraphTopology::Node* dests, size_t size,
+    katana::GraphTopology::Node dst) {
+  size_t count = 0;
+  for (size_t i = 0; i < size; ++i) {
+    count += dests[i] < dst;
+  }
+  return count;
+}
+
+/// Stores the edge property indexes \p from of \p num_edges edges in
+/// \p narrow if they fit in 32 bits, and nowhere if they are the identity.
+/// @returns false if they need 64 bits, in which case \p narrow is left
+/// empty. \p from may be null, which stands for the identity.
+bool
+NarrowPropertyIndexes(
+    const katana::GraphTopology::PropertyIndex* from, uint64_t num_edges,
+    katana::NUMAArray<uint32_t>* narrow) {
+  using Edge = katana::GraphTopology::Edge;
+  if (from == nullptr || num_edges == 0) {
+    return true;
+  }
+
+  katana::GReduceLogicalAnd is_identity;
+  katana::GReduceMax<katana::GraphTopology::PropertyIndex> max_index;
+  katana::do_all(
+      katana::iterate(Edge{0}, Edge{num_edges}),
+      [&](Edge e) {
+        is_identity.update(from[e] == e);
+        max_index.update(from[e]);
+      },
+      katana::no_stats());
+
+  if (is_identity.reduce()) {
+    return true;
+  }
+  if (max_index.reduce() > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  narrow->allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(Edge{0}, Edge{num_edges}),
+      [&](Edge e) { (*narrow)[e] = static_cast<uint32_t>(from[e]); },
+      katana::no_stats());
+  return true;
+}
+
+/// Copies the edge property indexes \p from of \p num_edges edges into as
+/// little room as they need: none if they are the identity, \p narrow if
+/// they fit in 32 bits and \p wide otherwise
+void
+CopyCompactPropertyIndexes(
+    const katana::GraphTopology::PropertyIndex* from, uint64_t num_edges,
+    katana::GraphTopology::PropIndexVec* wide,
+    katana::NUMAArray<uint32_t>* narrow) {
+  if (NarrowPropertyIndexes(from, num_edges, narrow)) {
+    return;
+  }
+  wide->allocateInterleaved(num_edges);
+  katana::ParallelSTL::copy(&from[0], &from[num_edges], wide->begin());
+}
+
+/// @returns the edge property indexes of \p topo as a 64-bit array, which
+/// is \p wide if that is not empty and otherwise made and owned by
+/// \p storage
+template <typename Topology>
+const katana::GraphTopology::PropertyIndex*
+WidePropertyIndexes(
+    const Topology& topo, const katana::GraphTopology::PropIndexVec& wide,
+    std::shared_ptr<const void>* storage) {
+  using Edge = katana::GraphTopology::Edge;
+  if (!wide.empty() || topo.NumEdges() == 0) {
+    return wide.data();
+  }
+
+  auto made = std::make_shared<katana::GraphTopology::PropIndexVec>();
+  made->allocateInterleaved(topo.NumEdges());
+  katana::do_all(
+      katana::iterate(Edge{0}, Edge{topo.NumEdges()}),
+      [&](Edge e) { (*made)[e] = topo.GetEdgePropertyIndexFromOutEdge(e); },
+      katana::no_stats());
+  const katana::GraphTopology::PropertyIndex* data = made->data();
+  *storage = std::move(made);
+  return data;
+}
+
+}  // namespace
 
 katana::GraphTopology::~GraphTopology() = default;
 
+void
+katana::GraphTopology::WillNeedOutEdges(Node begin, Node end) const noexcept {
+  if (!semi_external_ || begin >= end) {
+    return;
+  }
+  AdviseDests(
+      dests_.data(), *OutEdges(begin).begin(), *OutEdges(end - 1).end(),
+      MADV_WILLNEED, false);
+}
+
+void
+katana::GraphTopology::DoneWithOutEdges(
+    [[maybe_unused]] Node begin, [[maybe_unused]] Node end) const noexcept {
+#ifdef MADV_COLD
+  if (!semi_external_ || begin >= end) {
+    return;
+  }
+  // Not MADV_DONTNEED: the mapping is private, so that would drop any
+  // changes made to it
+  AdviseDests(
+      dests_.data(), *OutEdges(begin).begin(), *OutEdges(end - 1).end(),
+      MADV_COLD, true);
+#endif
+}
+
 void
 katana::GraphTopology::Print() const noexcept {
   auto print_array = [](const auto& arr, const auto& name) {
@@ -67,6 +430,21 @@ katana::GraphTopology::GraphTopology(
     AdjIndexVec&& adj_indices, EdgeDestVec&& dests) noexcept
     : adj_indices_(std::move(adj_indices)), dests_(std::move(dests)) {}
 
+katana::GraphTopology::GraphTopology(
+    const Edge* adj_indices, size_t num_nodes, const Node* dests,
+    size_t num_edges, std::shared_ptr<const void> storage) noexcept
+    : storage_(std::move(storage)),
+      adj_indices_(const_cast<Edge*>(adj_indices), num_nodes),
+      dests_(const_cast<Node*>(dests), num_edges) {}
+
+katana::GraphTopology::GraphTopology(
+    AdjIndexVec&& adj_indices, const Node* dests, size_t num_edges,
+    std::shared_ptr<const void> storage) noexcept
+    : storage_(std::move(storage)),
+      adj_indices_(std::move(adj_indices)),
+      dests_(const_cast<Node*>(dests), num_edges),
+      semi_external_(true) {}
+
 katana::GraphTopology::GraphTopology(
     AdjIndexVec&& adj_indices, EdgeDestVec&& dests,
     PropIndexVec&& edge_prop_indices, PropIndexVec&& node_prop_indices) noexcept
@@ -77,10 +455,15 @@ katana::GraphTopology::GraphTopology(
 
 katana::GraphTopology
 katana::GraphTopology::Copy(const GraphTopology& that) noexcept {
+  // a compacted map is copied wide, and an identity map stays absent
+  std::shared_ptr<const void> storage;
+  const PropertyIndex* edge_prop_indices =
+      that.narrow_edge_prop_indices_.empty()
+          ? that.edge_prop_indices_.data()
+          : that.WideEdgePropertyIndexes(&storage);
   return katana::GraphTopology(
       that.adj_indices_.data(), that.adj_indices_.size(), that.dests_.data(),
-      that.dests_.size(), that.edge_prop_indices_.data(),
-      that.node_prop_indices_.data());
+      that.dests_.size(), edge_prop_indices, that.node_prop_indices_.data());
 }
 
 katana::GraphTopology
@@ -95,6 +478,9 @@ katana::GraphTopology::PropertyIndex
 katana::GraphTopology::GetEdgePropertyIndexFromOutEdge(
     const Edge& eid) const noexcept {
   KATANA_LOG_DEBUG_ASSERT(eid < NumEdges());
+  if (!narrow_edge_prop_indices_.empty()) {
+    return narrow_edge_prop_indices_[eid];
+  }
   return edge_prop_indices_.empty() ? eid : edge_prop_indices_[eid];
 }
 
@@ -104,6 +490,40 @@ katana::GraphTopology::GetNodePropertyIndex(const Node& nid) const noexcept {
   return node_prop_indices_.empty() ? nid : node_prop_indices_[nid];
 }
 
+void
+katana::GraphTopology::CompactEdgePropertyIndexes() noexcept {
+  if (edge_prop_indices_.empty()) {
+    return;
+  }
+
+  if (NarrowPropertyIndexes(
+          edge_prop_indices_.data(), NumEdges(), &narrow_edge_prop_indices_)) {
+    edge_prop_indices_.deallocate();
+  }
+}
+
+void
+katana::GraphTopology::ExpandEdgePropertyIndexes() noexcept {
+  if (!edge_prop_indices_.empty()) {
+    return;
+  }
+
+  PropIndexVec wide;
+  wide.allocateInterleaved(NumEdges());
+  katana::do_all(
+      katana::iterate(Edge{0}, Edge{NumEdges()}),
+      [&](Edge e) { wide[e] = GetEdgePropertyIndexFromOutEdge(e); },
+      katana::no_stats());
+  edge_prop_indices_ = std::move(wide);
+  narrow_edge_prop_indices_.deallocate();
+}
+
+const katana::GraphTopology::PropertyIndex*
+katana::GraphTopology::WideEdgePropertyIndexes(
+    std::shared_ptr<const void>* storage) const noexcept {
+  return WidePropertyIndexes(*this, edge_prop_indices_, storage);
+}
+
 katana::ShuffleTopology::~ShuffleTopology() = default;
 
 std::shared_ptr<katana::ShuffleTopology>
@@ -128,57 +548,64 @@ katana::EdgeShuffleTopology::MakeTransposeCopy(
     return std::make_shared<EdgeShuffleTopology>(std::move(et));
   }
 
+  const uint64_t num_nodes = topology.NumNodes();
+  const uint64_t num_edges = topology.NumEdges();
+
   AdjIndexVec out_indices;
   EdgeDestVec out_dests;
-  AdjIndexVec out_dests_offset;
   PropIndexVec edge_prop_indices;
   PropIndexVec node_prop_indices;
 
-  out_indices.allocateInterleaved(topology.NumNodes());
-  out_dests.allocateInterleaved(topology.NumEdges());
-  edge_prop_indices.allocateInterleaved(topology.NumEdges());
-
-  out_dests_offset.allocateInterleaved(topology.NumNodes());
+  out_indices.allocateInterleaved(num_nodes);
+  out_dests.allocateInterleaved(num_edges);
+  edge_prop_indices.allocateInterleaved(num_edges);
 
   katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
 
-  // Keep a copy of old destinaton ids and compute number of
-  // in-coming edges for the new prefix sum of out_indices.
-  katana::do_all(
-      katana::iterate(topology.OutEdges()),
-      [&](Edge e) {
-        // Counting outgoing edges in the tranpose graph by
-        // counting incoming edges in the original graph
-        auto dest = topology.OutEdgeDst(e);
-        __sync_add_and_fetch(&(out_indices[dest]), 1);
+  // A counting sort of the edges by destination. The edges are visited in
+  // tiles of about the same number of edges so that high-degree nodes do
+  // not serialize the passes.
+  auto range = katana::edge_balanced_range<Node>(topology.AdjData(), num_nodes);
+
+  // Counting outgoing edges in the tranpose graph by counting incoming edges
+  // in the original graph
+  katana::do_all_edges(
+      range,
+      [&](Node, Edge begin, Edge end) {
+        for (Edge e = begin; e < end; ++e) {
+          __sync_add_and_fetch(&(out_indices[topology.OutEdgeDst(e)]), 1);
+        }
       },
-      katana::no_stats());
+      katana::steal(), katana::no_stats());
 
   // Prefix sum calculation of the edge index array
   katana::ParallelSTL::partial_sum(
       out_indices.begin(), out_indices.end(), out_indices.begin());
 
-  // temporary buffer for storing the starting point of each node's transpose
-  // adjacency
-  out_dests_offset[0] = 0;
-  katana::do_all(
-      katana::iterate(Edge{1}, Edge{topology.NumNodes()}),
-      [&](Edge n) { out_dests_offset[n] = out_indices[n - 1]; },
-      katana::no_stats());
+  // Shift the ends of the adjacencies to their beginnings in place, so that
+  // out_indices serves as the insertion points and no separate array of
+  // them is needed: each thread remembers the entry before its block before
+  // any entry changes
+  std::vector<Edge> prev_end(katana::getActiveThreads());
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(uint64_t{0}, num_nodes, tid, total);
+    prev_end[tid] = begin > 0 ? out_indices[begin - 1] : 0;
+  });
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(uint64_t{0}, num_nodes, tid, total);
+    for (uint64_t n = end; n > begin; --n) {
+      out_indices[n - 1] = n - 1 > begin ? out_indices[n - 2] : prev_end[tid];
+    }
+  });
 
-  // Update out_dests with the new destination ids
-  // of the transposed graphs
-  katana::do_all(
-      katana::iterate(topology.Nodes()),
-      [&](auto src) {
-        // get all outgoing edges of a particular
-        // node and reverse the edges.
-        for (GraphTopology::Edge e : topology.OutEdges(src)) {
-          // e = start index into edge array for a particular node
-          // Destination node
+  // Each edge takes the next free slot of its destination, which leaves
+  // out_indices[n] one past the last edge of n again
+  katana::do_all_edges(
+      range,
+      [&](Node src, Edge begin, Edge end) {
+        for (Edge e = begin; e < end; ++e) {
           auto dest = topology.OutEdgeDst(e);
-          // Location to save edge
-          auto e_new = __sync_fetch_and_add(&(out_dests_offset[dest]), 1);
+          auto e_new = __sync_fetch_and_add(&(out_indices[dest]), 1);
           // Save src as destination
           out_dests[e_new] = src;
           // remember the original edge ID to look up properties
@@ -193,7 +620,7 @@ katana::EdgeShuffleTopology::MakeTransposeCopy(
   if (from) {
     node_prop_indices.allocateInterleaved(topology.NumNodes());
     katana::ParallelSTL::copy(
-        &from[0], &from[topology.NumNodes()], node_prop_indices.begin());
+        &from[0], &from[num_nodes], node_prop_indices.begin());
   }
 
   return std::make_shared<EdgeShuffleTopology>(EdgeShuffleTopology{
@@ -264,16 +691,19 @@ katana::EdgeShuffleTopology::Make(katana::RDGTopology* rdg_topo) {
           std::move(dests_copy),
           std::move(edge_prop_indices),
           {}});
+  shuffle->CompactEdgePropertyIndexes();
 
   return shuffle;
 }
 
 katana::Result<katana::RDGTopology>
 katana::EdgeShuffleTopology::ToRDGTopology() const {
+  std::shared_ptr<const void> storage;
   katana::RDGTopology topo = KATANA_CHECKED(katana::RDGTopology::Make(
       AdjData(), NumNodes(), DestData(), NumEdges(),
       katana::RDGTopology::TopologyKind::kEdgeShuffleTopology, tpose_state_,
-      edge_sort_state_, edge_prop_indices_.data()));
+      edge_sort_state_, WideEdgePropertyIndexes(&storage)));
+  topo.set_in_memory_storage(std::move(storage));
   return katana::RDGTopology(std::move(topo));
 }
 
@@ -283,29 +713,76 @@ katana::EdgeShuffleTopology::FindEdge(
     const katana::GraphTopologyTypes::Node& dst) const noexcept {
   auto e_range = OutEdges(src);
 
-  constexpr size_t kBinarySearchThreshold = 64;
-
-  if (e_range.size() > kBinarySearchThreshold &&
-      !has_edges_sorted_by(
+  if (!has_edges_sorted_by(
           katana::RDGTopology::EdgeSortKind::kSortedByDestID)) {
-    KATANA_WARN_ONCE(
-        "FindEdge(): expect poor performance. Edges not sorted by Dest ID");
-  }
-
-  if (e_range.size() <= kBinarySearchThreshold) {
-    auto iter = std::find_if(
+    if (e_range.size() > kLinearSearchThreshold) {
+      KATANA_WARN_ONCE(
+          "FindEdge(): expect poor performance. Edges not sorted by Dest ID");
+    }
+    return std::find_if(
         e_range.begin(), e_range.end(),
         [&](const GraphTopology::Edge& e) { return OutEdgeDst(e) == dst; });
+  }
 
-    return iter;
+  return FindEdge(src, dst, e_range.begin());
+}
 
-  } else {
-    auto iter = std::lower_bound(
-        e_range.begin(), e_range.end(), dst,
-        internal::EdgeDestComparator<EdgeShuffleTopology>{this});
+katana::GraphTopologyTypes::edge_iterator
+katana::EdgeShuffleTopology::FindEdge(
+    const katana::GraphTopologyTypes::Node& src,
+    const katana::GraphTopologyTypes::Node& dst,
+    const katana::GraphTopologyTypes::edge_iterator& hint) const noexcept {
+  KATANA_LOG_DEBUG_ASSERT(
+      has_edges_sorted_by(katana::RDGTopology::EdgeSortKind::kSortedByDestID));
+  auto e_range = OutEdges(src);
+  KATANA_LOG_DEBUG_ASSERT(*hint >= *e_range.begin() && *hint <= *e_range.end());
+
+  const Node* dests = DestData() + *e_range.begin();
+  const size_t size = e_range.size();
+  const size_t begin = *hint - *e_range.begin();
+
+  size_t pos = size - begin <= kLinearSearchThreshold
+                   ? begin + CountLess(dests + begin, size - begin, dst)
+                   : katana::analytics::internal::GallopTo(
+                         dests, begin, size, dst);
+  return pos < size && dests[pos] == dst ? e_range.begin() + pos
+                                         : e_range.end();
+}
 
-    return OutEdgeDst(*iter) == dst ? iter : e_range.end();
+std::vector<katana::GraphTopologyTypes::edge_iterator>
+katana::EdgeShuffleTopology::FindEdges(
+    const katana::GraphTopologyTypes::Node& src,
+    const std::vector<katana::GraphTopologyTypes::Node>& sorted_dsts)
+    const noexcept {
+  KATANA_LOG_DEBUG_ASSERT(
+      has_edges_sorted_by(katana::RDGTopology::EdgeSortKind::kSortedByDestID));
+  KATANA_LOG_DEBUG_ASSERT(
+      std::is_sorted(sorted_dsts.begin(), sorted_dsts.end()));
+  auto e_range = OutEdges(src);
+  const Node* dests = DestData() + *e_range.begin();
+  const size_t size = e_range.size();
+
+  // Merge when the lists have similar lengths and gallop through the
+  // adjacency when it is much longer, as CountIntersection does
+  const bool gallop =
+      sorted_dsts.size() * katana::analytics::kGallopRatio <= size;
+
+  std::vector<edge_iterator> found(sorted_dsts.size(), e_range.end());
+  size_t pos = 0;
+  for (size_t i = 0; i < sorted_dsts.size() && pos < size; ++i) {
+    const Node dst = sorted_dsts[i];
+    if (gallop) {
+      pos = katana::analytics::internal::GallopTo(dests, pos, size, dst);
+    } else {
+      while (pos < size && dests[pos] < dst) {
+        ++pos;
+      }
+    }
+    if (pos < size && dests[pos] == dst) {
+      found[i] = e_range.begin() + pos;
+    }
   }
+  return found;
 }
 
 katana::GraphTopologyTypes::edges_range
@@ -339,39 +816,11 @@ katana::EdgeShuffleTopology::FindAllEdges(
 
 void
 katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
-  katana::do_all(
-      katana::iterate(Nodes()),
-      [&](Node node) {
-        // get this node's first and last edge
-        auto e_beg = *OutEdges(node).begin();
-        auto e_end = *OutEdges(node).end();
-
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg, GetDests().begin() + e_beg);
-
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end, GetDests().begin() + e_end);
-
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
-
-        KATANA_LOG_DEBUG_ASSERT(std::is_sorted(
-            GetDests().begin() + e_beg, GetDests().begin() + e_end));
-      },
-      katana::steal(), katana::no_stats());
+  // ties between parallel edges go to the property index so that the order
+  // does not depend on how the edges were built
+  SortEdgesSegmented(
+      AdjData(), NumNodes(), GetDests().data(),
+      edge_prop_indices_.data(), std::less<>());
   // remember to update sort state
   edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByDestID;
 }
@@ -379,52 +828,19 @@ katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
 void
 katana::EdgeShuffleTopology::SortEdgesByTypeThenDest(
     const PropertyGraph* pg) noexcept {
-  katana::do_all(
-      katana::iterate(Nodes()),
-      [&](Node node) {
-        // get this node's first and last edge
-        auto e_beg = *OutEdges(node).begin();
-        auto e_end = *OutEdges(node).end();
-
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg, GetDests().begin() + e_beg);
-
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end, GetDests().begin() + e_end);
-
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              // get edge type and destinations
-              auto e1 = std::get<0>(tup1);
-              auto e2 = std::get<0>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(e1), GraphTopology::PropertyIndex>);
-              static_assert(
-                  std::is_same_v<decltype(e2), GraphTopology::PropertyIndex>);
-
-              katana::EntityTypeID data1 =
-                  pg->GetTypeOfEdgeFromPropertyIndex(e1);
-              katana::EntityTypeID data2 =
-                  pg->GetTypeOfEdgeFromPropertyIndex(e2);
-              if (data1 != data2) {
-                return data1 < data2;
-              }
-
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
-      },
-      katana::steal(), katana::no_stats());
+  using Entry = std::pair<Node, PropertyIndex>;
+  SortEdgesSegmented(
+      AdjData(), NumNodes(), GetDests().data(),
+      edge_prop_indices_.data(), [&](const Entry& a, const Entry& b) {
+        katana::EntityTypeID type_a =
+            pg->GetTypeOfEdgeFromPropertyIndex(a.second);
+        katana::EntityTypeID type_b =
+            pg->GetTypeOfEdgeFromPropertyIndex(b.second);
+        if (type_a != type_b) {
+          return type_a < type_b;
+        }
+        return a < b;
+      });
 
   // remember to update sort state
   edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByEdgeType;
@@ -437,41 +853,233 @@ katana::EdgeShuffleTopology::SortEdgesByDestType(
   KATANA_LOG_FATAL("Not implemented yet");
 }
 
+namespace {
+
+/// The values of the edge property \p name as int64, indexed by property
+/// index, with kNoTimestamp for nulls
+katana::Result<std::pair<
+    std::shared_ptr<arrow::ChunkedArray>,
+    katana::NUMAArray<katana::TemporalTopology::Timestamp>>>
+ReadTimestamps(const katana::PropertyGraph* pg, const std::string& name) {
+  using Timestamp = katana::TemporalTopology::Timestamp;
+  auto property = KATANA_CHECKED(pg->GetEdgeProperty(name));
+
+  auto width = [](arrow::Type::type id) -> int {
+    switch (id) {
+    case arrow::Type::INT64:
+    case arrow::Type::TIMESTAMP:
+    case arrow::Type::DATE64:
+    case arrow::Type::TIME64:
+    case arrow::Type::DURATION:
+      return 64;
+    case arrow::Type::INT32:
+    case arrow::Type::DATE32:
+    case arrow::Type::TIME32:
+      return 32;
+    case arrow::Type::UINT32:
+      return -32;
+    default:
+      return 0;
+    }
+  };
+  const int bits = width(property->type()->id());
+  if (bits == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "edge property {} is a {}, not a timestamp", name,
+        property->type()->ToString());
+  }
+
+  katana::NUMAArray<Timestamp> timestamps;
+  timestamps.allocateInterleaved(property->length());
+  int64_t offset = 0;
+  for (const auto& chunk : property->chunks()) {
+    const auto& data = *chunk->data();
+    katana::do_all(
+        katana::iterate(int64_t{0}, chunk->length()),
+        [&](int64_t i) {
+          Timestamp t = katana::TemporalTopology::kNoTimestamp;
+          if (chunk->IsValid(i)) {
+            if (bits == 64) {
+              t = data.GetValues<int64_t>(1)[i];
+            } else if (bits == 32) {
+              t = data.GetValues<int32_t>(1)[i];
+            } else {
+              t = data.GetValues<uint32_t>(1)[i];
+            }
+          }
+          timestamps[offset + i] = t;
+        },
+        katana::no_stats());
+    offset += chunk->length();
+  }
+  return std::make_pair(std::move(property), std::move(timestamps));
+}
+
+}  // namespace
+
+katana::TemporalTopology::~TemporalTopology() = default;
+
+katana::Result<std::shared_ptr<katana::TemporalTopology>>
+katana::TemporalTopology::MakeFrom(
+    const katana::PropertyGraph* pg, const std::string& timestamp_property,
+    const katana::RDGTopology::TransposeKind& tpose_todo) {
+  auto [source, by_property] = KATANA_CHECKED_CONTEXT(
+      ReadTimestamps(pg, timestamp_property), "reading timestamps of {}",
+      timestamp_property);
+
+  auto copy = tpose_todo == katana::RDGTopology::TransposeKind::kYes
+                  ? MakeTransposeCopy(pg)
+                  : MakeOriginalCopy(pg);
+  std::shared_ptr<TemporalTopology> ret(
+      new TemporalTopology(std::move(*copy), timestamp_property));
+  ret->timestamps_source_ = source;
+
+  // ties go to the destination and then the property index so that the
+  // order does not depend on how the edges were built
+  using Entry = std::pair<Node, PropertyIndex>;
+  const Timestamp* ts = by_property.data();
+  ret->ExpandEdgePropertyIndexes();
+  SortEdgesSegmented(
+      ret->AdjData(), ret->NumNodes(), ret->GetDests().data(),
+      ret->edge_prop_indices_.data(), [ts](const Entry& a, const Entry& b) {
+        if (ts[a.second] != ts[b.second]) {
+          return ts[a.second] < ts[b.second];
+        }
+        return a < b;
+      });
+
+  ret->timestamps_.allocateInterleaved(ret->NumEdges());
+  katana::do_all(
+      katana::iterate(Edge{0}, Edge{ret->NumEdges()}),
+      [&](Edge e) { ret->timestamps_[e] = ts[ret->edge_prop_indices_[e]]; },
+      katana::no_stats());
+  ret->CompactEdgePropertyIndexes();
+  return ret;
+}
+
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::MakeSortedByDegree(
     const PropertyGraph*,
     const katana::EdgeShuffleTopology& seed_topo) noexcept {
-  auto cmp = [&](const auto& i1, const auto& i2) {
-    auto d1 = seed_topo.OutDegree(i1);
-    auto d2 = seed_topo.OutDegree(i2);
-    // TODO(amber): Triangle-Counting needs degrees sorted in descending order. I
-    // need to think of a way to specify in the interface whether degrees should be
-    // sorted in ascending or descending order.
-    // return d1 < d2;
-    return d1 > d2;
+  // TODO(amber): Triangle-Counting needs degrees sorted in descending order.
+  // I need to think of a way to specify in the interface whether degrees
+  // should be sorted in ascending or descending order.
+  katana::GReduceMax<uint64_t> max_reduce;
+  katana::do_all(
+      katana::iterate(seed_topo.Nodes()),
+      [&](Node n) { max_reduce.update(seed_topo.OutDegree(n)); },
+      katana::no_stats());
+  const uint64_t max_degree = max_reduce.reduce();
+  auto key = [&](const auto& i) -> uint64_t {
+    return max_degree - seed_topo.OutDegree(i);
   };
 
-  return MakeNodeSortedTopo(
-      seed_topo, cmp, katana::RDGTopology::NodeSortKind::kSortedByDegree);
+  return MakeNodeSortedTopoByKey(
+      seed_topo, key, katana::RDGTopology::NodeSortKind::kSortedByDegree);
 }
 
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::MakeSortedByNodeType(
     const PropertyGraph* pg,
     const katana::EdgeShuffleTopology& seed_topo) noexcept {
-  auto cmp = [&](const auto& i1, const auto& i2) {
-    auto idx1 = seed_topo.GetNodePropertyIndex(i1);
-    auto idx2 = seed_topo.GetNodePropertyIndex(i2);
-    auto k1 = pg->GetTypeOfNodeFromPropertyIndex(idx1);
-    auto k2 = pg->GetTypeOfNodeFromPropertyIndex(idx2);
-    if (k1 == k2) {
-      return i1 < i2;
-    }
-    return k1 < k2;
+  // the sort is stable, so nodes of the same type stay in id order
+  auto key = [&](const auto& i) -> uint64_t {
+    return pg->GetTypeOfNodeFromPropertyIndex(
+        seed_topo.GetNodePropertyIndex(i));
   };
 
-  return MakeNodeSortedTopo(
-      seed_topo, cmp, katana::RDGTopology::NodeSortKind::kSortedByNodeType);
+  return MakeNodeSortedTopoByKey(
+      seed_topo, key, katana::RDGTopology::NodeSortKind::kSortedByNodeType);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeNodePermutedTopo(
+    const katana::EdgeShuffleTopology& seed_topo,
+    const PropIndexVec& new_to_old,
+    const katana::RDGTopology::NodeSortKind& node_sort_todo) noexcept {
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.NumNodes());
+
+  NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
+
+  PropIndexVec node_prop_indices;
+  node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
+
+  // TODO(amber): given 32-bit node ids, put a check here that
+  // new_to_old.size() < 2^32
+  katana::do_all(
+      katana::iterate(size_t{0}, new_to_old.size()),
+      [&](auto i) {
+        // new_to_old[i] gives old node id
+        old_to_new_map[new_to_old[i]] = i;
+        degrees[i] = seed_topo.OutDegree(new_to_old[i]);
+        node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_DEBUG_ASSERT(
+      node_sort_todo != katana::RDGTopology::NodeSortKind::kSortedByDegree ||
+      std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.Nodes()),
+      [&](auto old_src_id) {
+        auto new_srd_id = old_to_new_map[old_src_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.OutEdges(old_src_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
+          KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] =
+              seed_topo.GetEdgePropertyIndexFromOutEdge(e);
+        }
+        KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_shared<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo,
+      seed_topo.edge_sort_state(), std::move(degrees),
+      std::move(node_prop_indices), std::move(new_dest_vec),
+      std::move(edge_prop_indices)});
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeSortedByBFS(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  return MakeNodePermutedTopo(
+      seed_topo, ComputeSearchOrder(seed_topo, false),
+      katana::RDGTopology::NodeSortKind::kSortedByBFS);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeSortedByRCM(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  auto new_to_old = ComputeSearchOrder(seed_topo, true);
+  std::reverse(new_to_old.begin(), new_to_old.end());
+  return MakeNodePermutedTopo(
+      seed_topo, new_to_old, katana::RDGTopology::NodeSortKind::kSortedByRCM);
 }
 
 std::shared_ptr<katana::ShuffleTopology>
@@ -515,17 +1123,20 @@ katana::ShuffleTopology::Make(katana::RDGTopology* rdg_topo) {
           rdg_topo->edge_sort_state(), std::move(adj_indices_copy),
           std::move(node_prop_indices_copy), std::move(dests_copy),
           std::move(edge_prop_indices_copy)});
+  shuffle->CompactEdgePropertyIndexes();
 
   return shuffle;
 }
 
 katana::Result<katana::RDGTopology>
 katana::ShuffleTopology::ToRDGTopology() const {
+  std::shared_ptr<const void> storage;
   katana::RDGTopology topo = KATANA_CHECKED(katana::RDGTopology::Make(
       AdjData(), NumNodes(), DestData(), NumEdges(),
       katana::RDGTopology::TopologyKind::kShuffleTopology, transpose_state(),
-      edge_sort_state(), node_sort_state(), edge_property_index_data(),
+      edge_sort_state(), node_sort_state(), WideEdgePropertyIndexes(&storage),
       node_property_index_data()));
+  topo.set_in_memory_storage(std::move(storage));
   return katana::RDGTopology(std::move(topo));
 }
 
@@ -549,7 +1160,7 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
 
   // ordered map
   std::set<katana::EntityTypeID> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+  for (uint32_t i = 0; i < katana::getActiveThreads(); ++i) {
     auto& edgeTypesSet = *edgeTypes.getRemote(i);
     for (auto edgeType : edgeTypesSet) {
       mergedSet.insert(edgeType);
@@ -624,6 +1235,76 @@ katana::EdgeTypeAwareTopology::CreatePerEdgeTypeAdjacencyIndex(
   return adj_indices;
 }
 
+katana::EdgeTypeAwareTopology::AdjIndexVec
+katana::EdgeTypeAwareTopology::CountEdgeTypesPerNode(
+    const PropertyGraph& pg, const EdgeShuffleTopology& e_topo) noexcept {
+  AdjIndexVec types_per_node;
+  types_per_node.allocateInterleaved(e_topo.NumNodes());
+
+  katana::do_all(
+      katana::iterate(e_topo.Nodes()),
+      [&](Node N) {
+        uint64_t count = 0;
+        EntityTypeID prev_type{};
+        for (auto e : e_topo.OutEdges(N)) {
+          const auto type = pg.GetTypeOfEdgeFromPropertyIndex(
+              e_topo.GetEdgePropertyIndexFromOutEdge(e));
+          if (count == 0 || type != prev_type) {
+            prev_type = type;
+            ++count;
+          }
+        }
+        types_per_node[N] = count;
+      },
+      katana::no_stats(), katana::steal());
+
+  return types_per_node;
+}
+
+katana::EdgeTypeAwareTopology
+katana::EdgeTypeAwareTopology::MakeSparse(
+    const PropertyGraph& pg,
+    std::shared_ptr<const CondensedTypeIDMap> edge_type_index,
+    EdgeShuffleTopology&& e_topo, AdjIndexVec&& node_offsets) noexcept {
+  const uint64_t num_pairs =
+      node_offsets.empty() ? 0 : node_offsets[node_offsets.size() - 1];
+
+  NUMAArray<uint32_t> type_indices;
+  type_indices.allocateInterleaved(num_pairs);
+  AdjIndexVec type_ends;
+  type_ends.allocateInterleaved(num_pairs);
+
+  katana::do_all(
+      katana::iterate(e_topo.Nodes()),
+      [&](Node N) {
+        uint64_t pos = (N == 0) ? 0 : node_offsets[N - 1];
+        const uint64_t first = pos;
+        EntityTypeID prev_type{};
+        for (auto e : e_topo.OutEdges(N)) {
+          const auto type = pg.GetTypeOfEdgeFromPropertyIndex(
+              e_topo.GetEdgePropertyIndexFromOutEdge(e));
+          if (pos == first || type != prev_type) {
+            if (pos != first) {
+              // close the previous run
+              type_ends[pos - 1] = e;
+            }
+            prev_type = type;
+            type_indices[pos] = edge_type_index->GetIndex(type);
+            ++pos;
+          }
+        }
+        if (pos != first) {
+          type_ends[pos - 1] = *e_topo.OutEdges(N).end();
+        }
+        KATANA_LOG_DEBUG_ASSERT(pos == node_offsets[N]);
+      },
+      katana::no_stats(), katana::steal());
+
+  return EdgeTypeAwareTopology{
+      std::move(e_topo), std::move(edge_type_index), std::move(node_offsets),
+      std::move(type_indices), std::move(type_ends)};
+}
+
 std::shared_ptr<katana::EdgeTypeAwareTopology>
 katana::EdgeTypeAwareTopology::MakeFrom(
     const katana::PropertyGraph* pg,
@@ -634,6 +1315,25 @@ katana::EdgeTypeAwareTopology::MakeFrom(
 
   KATANA_LOG_DEBUG_ASSERT(e_topo.NumEdges() == pg->topology().NumEdges());
 
+  if (!e_topo.empty() && edge_type_index->num_unique_types() > 1) {
+    AdjIndexVec node_offsets = CountEdgeTypesPerNode(*pg, e_topo);
+    katana::ParallelSTL::partial_sum(
+        node_offsets.begin(), node_offsets.end(), node_offsets.begin());
+    const uint64_t num_pairs = node_offsets[node_offsets.size() - 1];
+
+    const size_t dense_bytes = e_topo.NumNodes() *
+                               edge_type_index->num_unique_types() *
+                               sizeof(Edge);
+    const size_t sparse_bytes = e_topo.NumNodes() * sizeof(Edge) +
+                                num_pairs * (sizeof(uint32_t) + sizeof(Edge));
+
+    if (sparse_bytes * kSparseLayoutFactor <= dense_bytes) {
+      return std::make_shared<EdgeTypeAwareTopology>(MakeSparse(
+          *pg, std::move(edge_type_index), std::move(e_topo),
+          std::move(node_offsets)));
+    }
+  }
+
   AdjIndexVec per_type_adj_indices =
       CreatePerEdgeTypeAdjacencyIndex(*pg, *edge_type_index, e_topo);
 
@@ -642,14 +1342,75 @@ katana::EdgeTypeAwareTopology::MakeFrom(
       std::move(per_type_adj_indices)});
 }
 
+void
+katana::EdgeTypeAwareTopology::BuildDestIndex() noexcept {
+  sorted_dests_.allocateInterleaved(NumEdges());
+
+  katana::do_all(
+      katana::iterate(Base::Nodes()),
+      [&](Node N) {
+        auto edges = Base::OutEdges(N);
+        for (auto e : edges) {
+          sorted_dests_[e] = OutEdgeDst(e);
+        }
+        std::sort(
+            sorted_dests_.begin() + *edges.begin(),
+            sorted_dests_.begin() + *edges.end());
+      },
+      katana::no_stats(), katana::steal());
+
+  has_dest_index_ = true;
+}
+
+katana::DynamicBitset
+katana::EdgeTypeAwareTopology::HasEdges(
+    const std::vector<std::pair<Node, Node>>& queries) const noexcept {
+  katana::DynamicBitset found;
+  found.resize(queries.size());
+  if (queries.empty()) {
+    return found;
+  }
+
+  // probe in (src, dst) order so that consecutive queries of a thread hit the
+  // same adjacency lists and parts of the destination arrays
+  katana::NUMAArray<uint64_t> order;
+  order.allocateInterleaved(queries.size());
+  katana::ParallelSTL::iota(order.begin(), order.end(), uint64_t{0});
+  katana::ParallelSTL::sort(
+      order.begin(), order.end(),
+      [&](uint64_t a, uint64_t b) { return queries[a] < queries[b]; });
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, static_cast<uint64_t>(queries.size())),
+      [&](uint64_t i) {
+        const auto& [src, dst] = queries[order[i]];
+        if (HasEdge(src, dst)) {
+          found.set(order[i]);
+        }
+      },
+      katana::no_stats());
+
+  return found;
+}
+
 katana::Result<katana::RDGTopology>
 katana::EdgeTypeAwareTopology::ToRDGTopology() const {
+  if (index_layout_ == IndexLayout::kSparse) {
+    // The on-disk format only knows the dense layout, which is what the sparse
+    // layout avoids materializing. Store the underlying edge type sorted
+    // topology instead; on load it is found by PopEdgeShuffTopo() and only the
+    // sparse index is rebuilt.
+    return Base::ToRDGTopology();
+  }
+
+  std::shared_ptr<const void> storage;
   katana::RDGTopology topo = KATANA_CHECKED(katana::RDGTopology::Make(
       per_type_adj_indices_.data(), NumNodes(), Base::DestData(), NumEdges(),
       katana::RDGTopology::TopologyKind::kEdgeTypeAwareTopology,
-      transpose_state(), edge_sort_state(), Base::edge_property_index_data(),
+      transpose_state(), edge_sort_state(), WideEdgePropertyIndexes(&storage),
       edge_type_index_->num_unique_types(),
       edge_type_index_->index_to_type_map_data()));
+  topo.set_in_memory_storage(std::move(storage));
 
   return katana::RDGTopology(std::move(topo));
 }
@@ -695,22 +1456,564 @@ katana::EdgeTypeAwareTopology::Make(
       std::move(per_type_adj_indices)});
 }
 
+katana::CompressedGraphTopology::~CompressedGraphTopology() = default;
+
+void
+katana::CompressedGraphTopology::Print() const noexcept {
+  std::cout << "adj_indices_: [ ";
+  for (const auto& i : adj_indices_) {
+    std::cout << i << ", ";
+  }
+  std::cout << "]" << std::endl;
+
+  std::cout << "dests_: [ ";
+  DecodeRange(Edge{0}, NumEdges(), [](Edge, Node dst) {
+    std::cout << dst << ", ";
+  });
+  std::cout << "]" << std::endl;
+}
+
+std::shared_ptr<katana::CompressedGraphTopology>
+katana::CompressedGraphTopology::MakeFrom(
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  const uint64_t num_edges = seed_topo.NumEdges();
+  const uint64_t num_blocks = (num_edges + kBlockSize - 1) / kBlockSize;
+
+  auto encoded_value = [&](Edge e) -> uint64_t {
+    if (e % kBlockSize == 0) {
+      return seed_topo.OutEdgeDst(e);
+    }
+    return ZigZagEncode(
+        static_cast<int64_t>(seed_topo.OutEdgeDst(e)) -
+        static_cast<int64_t>(seed_topo.OutEdgeDst(e - 1)));
+  };
+
+  // First pass: size of each block, turned into block start offsets.
+  BlockOffsetVec block_offsets;
+  block_offsets.allocateInterleaved(num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        size_t sz = 0;
+        Edge end = std::min<Edge>((b + 1) * kBlockSize, num_edges);
+        for (Edge e = b * kBlockSize; e < end; ++e) {
+          sz += VarintSize(encoded_value(e));
+        }
+        block_offsets[b] = sz;
+      },
+      katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+  const size_t num_data_bytes =
+      num_blocks > 0 ? block_offsets[num_blocks - 1] : 0;
+
+  // Convert inclusive prefix sums into start offsets.
+  BlockOffsetVec starts;
+  starts.allocateInterleaved(num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) { starts[b] = b > 0 ? block_offsets[b - 1] : 0; },
+      katana::no_stats());
+
+  // Second pass: encode blocks independently.
+  ByteVec data;
+  data.allocateInterleaved(num_data_bytes + kDecodePadding);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t b) {
+        uint8_t* p = data.data() + starts[b];
+        Edge end = std::min<Edge>((b + 1) * kBlockSize, num_edges);
+        for (Edge e = b * kBlockSize; e < end; ++e) {
+          p = EncodeVarint(encoded_value(e), p);
+        }
+        KATANA_LOG_DEBUG_ASSERT(
+            static_cast<size_t>(p - data.data()) == block_offsets[b]);
+      },
+      katana::no_stats());
+  std::memset(data.data() + num_data_bytes, 0, kDecodePadding);
+
+  AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(seed_topo.NumNodes());
+  if (seed_topo.NumNodes() > 0) {
+    katana::ParallelSTL::copy(
+        &seed_topo.AdjData()[0], &seed_topo.AdjData()[seed_topo.NumNodes()],
+        adj_indices.begin());
+  }
+
+  // The map takes no more room than in the seed: none if it is the
+  // identity and 4 bytes per edge if the indexes fit in 32 bits
+  PropIndexVec edge_prop_indices;
+  NUMAArray<uint32_t> narrow_edge_prop_indices;
+  if (!seed_topo.narrow_edge_prop_indices_.empty()) {
+    narrow_edge_prop_indices.allocateInterleaved(num_edges);
+    katana::ParallelSTL::copy(
+        seed_topo.narrow_edge_prop_indices_.begin(),
+        seed_topo.narrow_edge_prop_indices_.end(),
+        narrow_edge_prop_indices.begin());
+  } else {
+    CopyCompactPropertyIndexes(
+        seed_topo.edge_property_index_data(), num_edges, &edge_prop_indices,
+        &narrow_edge_prop_indices);
+  }
+
+  PropIndexVec node_prop_indices;
+  if (const PropertyIndex* from = seed_topo.node_property_index_data()) {
+    node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
+    katana::ParallelSTL::copy(
+        &from[0], &from[seed_topo.NumNodes()], node_prop_indices.begin());
+  }
+
+  return std::make_shared<CompressedGraphTopology>(CompressedGraphTopology{
+      seed_topo.transpose_state(), seed_topo.edge_sort_state(),
+      std::move(adj_indices), num_edges, std::move(starts), std::move(data),
+      num_data_bytes, std::move(edge_prop_indices),
+      std::move(narrow_edge_prop_indices), std::move(node_prop_indices)});
+}
+
+std::shared_ptr<katana::CompressedGraphTopology>
+katana::CompressedGraphTopology::Make(katana::RDGTopology* rdg_topo) {
+  KATANA_LOG_DEBUG_ASSERT(rdg_topo);
+  KATANA_LOG_ASSERT(
+      rdg_topo->topology_state() ==
+      katana::RDGTopology::TopologyKind::kCompressedTopology);
+  KATANA_LOG_ASSERT(
+      rdg_topo->num_compressed_blocks() ==
+      (rdg_topo->num_edges() + kBlockSize - 1) / kBlockSize);
+
+  AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(rdg_topo->num_nodes());
+  BlockOffsetVec block_offsets;
+  block_offsets.allocateInterleaved(rdg_topo->num_compressed_blocks());
+  ByteVec data;
+  data.allocateInterleaved(rdg_topo->num_compressed_bytes() + kDecodePadding);
+  PropIndexVec edge_prop_indices;
+  NUMAArray<uint32_t> narrow_edge_prop_indices;
+
+  if (rdg_topo->num_nodes() > 0) {
+    katana::ParallelSTL::copy(
+        &(rdg_topo->adj_indices()[0]),
+        &(rdg_topo->adj_indices()[rdg_topo->num_nodes()]),
+        adj_indices.begin());
+  }
+  if (rdg_topo->num_edges() > 0) {
+    katana::ParallelSTL::copy(
+        &(rdg_topo->compressed_block_offsets()[0]),
+        &(rdg_topo->compressed_block_offsets()[rdg_topo
+                                                   ->num_compressed_blocks()]),
+        block_offsets.begin());
+    katana::ParallelSTL::copy(
+        &(rdg_topo->compressed_dests()[0]),
+        &(rdg_topo->compressed_dests()[rdg_topo->num_compressed_bytes()]),
+        data.begin());
+    CopyCompactPropertyIndexes(
+        rdg_topo->edge_index_to_property_index_map(), rdg_topo->num_edges(),
+        &edge_prop_indices, &narrow_edge_prop_indices);
+  }
+  std::memset(
+      data.data() + rdg_topo->num_compressed_bytes(), 0, kDecodePadding);
+
+  // Since we copy the data we need out of the RDGTopology into our own arrays,
+  // unbind the RDGTopologys file store to save memory.
+  auto res = rdg_topo->unbind_file_storage();
+  KATANA_LOG_ASSERT(res);
+
+  return std::make_shared<CompressedGraphTopology>(CompressedGraphTopology{
+      rdg_topo->transpose_state(),
+      rdg_topo->edge_sort_state(),
+      std::move(adj_indices),
+      rdg_topo->num_edges(),
+      std::move(block_offsets),
+      std::move(data),
+      rdg_topo->num_compressed_bytes(),
+      std::move(edge_prop_indices),
+      std::move(narrow_edge_prop_indices),
+      {}});
+}
+
+katana::Result<katana::RDGTopology>
+katana::CompressedGraphTopology::ToRDGTopology() const {
+  // the stored map is always 64-bit, like that of other shuffled topologies
+  std::shared_ptr<const void> storage;
+  katana::RDGTopology topo = KATANA_CHECKED(katana::RDGTopology::Make(
+      AdjData(), NumNodes(), NumEdges(), tpose_state_, edge_sort_state_,
+      WidePropertyIndexes(*this, edge_prop_indices_, &storage),
+      block_offsets_.size(), block_offsets_.data(), num_data_bytes_,
+      data_.data()));
+  topo.set_in_memory_storage(std::move(storage));
+  return katana::RDGTopology(std::move(topo));
+}
+
+katana::ProjectedTopology::~ProjectedTopology() = default;
+
+void
+katana::ProjectedTopology::Print() const noexcept {
+  std::cout << "projected_to_original_: [ ";
+  for (const auto& n : projected_to_original_) {
+    std::cout << n << ", ";
+  }
+  std::cout << "]" << std::endl;
+
+  std::cout << "dests_: [ ";
+  for (Node n : Nodes()) {
+    for (Edge e : OutEdges(n)) {
+      std::cout << OutEdgeDst(e) << ", ";
+    }
+  }
+  std::cout << "]" << std::endl;
+}
+
+std::shared_ptr<katana::ProjectedTopology>
+katana::ProjectedTopology::MakeFrom(
+    const katana::PropertyGraph* pg,
+    std::shared_ptr<const katana::GraphTopology> base,
+    const katana::DynamicBitset& nodes,
+    const std::optional<std::vector<katana::EntityTypeID>>& edge_types,
+    double compact_below) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(nodes.size() == base->NumNodes());
+  const uint64_t num_base_nodes = base->NumNodes();
+
+  // Number the selected nodes in the order of the base topology
+  EdgeDestVec original_to_projected;
+  original_to_projected.allocateInterleaved(num_base_nodes);
+  katana::do_all(
+      katana::iterate(base->Nodes()),
+      [&](Node n) { original_to_projected[n] = nodes.test(n); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      original_to_projected.begin(), original_to_projected.end(),
+      original_to_projected.begin());
+  const Node num_nodes =
+      num_base_nodes > 0 ? original_to_projected[num_base_nodes - 1] : 0;
+
+  EdgeDestVec projected_to_original;
+  projected_to_original.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(base->Nodes()),
+      [&](Node n) {
+        if (nodes.test(n)) {
+          original_to_projected[n]--;
+          projected_to_original[original_to_projected[n]] = n;
+        } else {
+          original_to_projected[n] = num_nodes;
+        }
+      },
+      katana::no_stats());
+
+  // Whether each edge entity type is a subtype of one of edge_types, so that
+  // each edge costs a table lookup
+  std::vector<uint8_t> has_edge_type;
+  if (edge_types) {
+    const katana::EntityTypeManager& manager = pg->GetEdgeTypeManager();
+    has_edge_type.resize(manager.GetNumEntityTypes());
+    katana::do_all(
+        katana::iterate(size_t{0}, has_edge_type.size()),
+        [&](size_t t) {
+          for (auto type : edge_types.value()) {
+            if (manager.IsSubtypeOf(type, static_cast<EntityTypeID>(t))) {
+              has_edge_type[t] = 1;
+              break;
+            }
+          }
+        },
+        katana::no_stats());
+  }
+  auto is_kept = [&](Edge e) {
+    if (!nodes.test(base->OutEdgeDst(e))) {
+      return false;
+    }
+    if (!edge_types) {
+      return true;
+    }
+    EntityTypeID t = pg->GetTypeOfEdgeFromPropertyIndex(
+        base->GetEdgePropertyIndexFromOutEdge(e));
+    return t < has_edge_type.size() && has_edge_type[t];
+  };
+
+  // Mark the kept edges and shrink the range of every node to the span of
+  // its kept edges
+  auto kept_edges = std::make_unique<katana::DynamicBitset>();
+  kept_edges->resize(base->NumEdges());
+  AdjIndexVec range_begins;
+  range_begins.allocateInterleaved(num_nodes);
+  AdjIndexVec range_ends;
+  range_ends.allocateInterleaved(num_nodes);
+  AdjIndexVec degrees;
+  degrees.allocateInterleaved(num_nodes);
+
+  katana::GAccumulator<uint64_t> accum_num_edges;
+  katana::GAccumulator<uint64_t> accum_num_spanned;
+  katana::do_all(
+      katana::iterate(Node{0}, num_nodes),
+      [&](Node p) {
+        auto edges = base->OutEdges(projected_to_original[p]);
+        Edge first = *edges.end();
+        Edge last = *edges.end();
+        uint64_t degree = 0;
+        for (Edge e : edges) {
+          if (!is_kept(e)) {
+            continue;
+          }
+          kept_edges->set(e);
+          if (degree == 0) {
+            first = e;
+          }
+          last = e + 1;
+          ++degree;
+        }
+        range_begins[p] = first;
+        range_ends[p] = last;
+        degrees[p] = degree;
+        accum_num_edges += degree;
+        accum_num_spanned += last - first;
+      },
+      katana::steal(), katana::loopname("ProjectEdges"), katana::no_stats());
+  const uint64_t num_edges = accum_num_edges.reduce();
+  const uint64_t num_spanned = accum_num_spanned.reduce();
+
+  EdgeDestVec dests;
+  PropIndexVec edge_prop_indices;
+  if (num_edges < compact_below * num_spanned) {
+    AdjIndexVec adj_ends;
+    adj_ends.allocateInterleaved(num_nodes);
+    katana::ParallelSTL::partial_sum(
+        degrees.begin(), degrees.end(), adj_ends.begin());
+
+    dests.allocateInterleaved(num_edges);
+    edge_prop_indices.allocateInterleaved(num_edges);
+    katana::do_all(
+        katana::iterate(Node{0}, num_nodes),
+        [&](Node p) {
+          Edge out = adj_ends[p] - degrees[p];
+          for (Edge e = range_begins[p]; e < range_ends[p]; ++e) {
+            if (!kept_edges->test(e)) {
+              continue;
+            }
+            dests[out] = original_to_projected[base->OutEdgeDst(e)];
+            edge_prop_indices[out] = base->GetEdgePropertyIndexFromOutEdge(e);
+            ++out;
+          }
+          range_begins[p] = adj_ends[p] - degrees[p];
+          range_ends[p] = adj_ends[p];
+        },
+        katana::steal(), katana::loopname("CompactProjectedEdges"),
+        katana::no_stats());
+
+    degrees = AdjIndexVec{};
+    kept_edges.reset();
+  }
+
+  return std::make_shared<ProjectedTopology>(ProjectedTopology{
+      std::move(base), std::move(projected_to_original),
+      std::move(original_to_projected), std::move(range_begins),
+      std::move(range_ends), std::move(degrees), std::move(kept_edges),
+      std::move(dests), std::move(edge_prop_indices), num_edges});
+}
+
+namespace {
+
+template <typename Topo>
+katana::count_t
+ApproxTopologyMemUse(const Topo& topo) {
+  using katana::GraphTopologyTypes;
+  // adjacency indexes, destinations and property indexes; the node property
+  // index array may be absent, so this is an upper bound
+  return topo.NumNodes() * (sizeof(GraphTopologyTypes::Edge) +
+                            sizeof(GraphTopologyTypes::PropertyIndex)) +
+         topo.NumEdges() * sizeof(GraphTopologyTypes::Node) +
+         topo.EdgePropertyIndexSizeBytes();
+}
+
+katana::count_t
+ApproxTopologyMemUse(const katana::EdgeTypeAwareTopology& topo) {
+  return ApproxTopologyMemUse<katana::EdgeShuffleTopology>(topo) +
+         topo.PerTypeIndexSizeBytes();
+}
+
+katana::count_t
+ApproxTopologyMemUse(const katana::TemporalTopology& topo) {
+  return ApproxTopologyMemUse<katana::EdgeShuffleTopology>(topo) +
+         topo.TimestampsSizeBytes();
+}
+
+katana::count_t
+ApproxTopologyMemUse(const katana::CompressedGraphTopology& topo) {
+  using katana::GraphTopologyTypes;
+  return topo.NumNodes() * sizeof(GraphTopologyTypes::Edge) +
+         topo.EdgePropertyIndexSizeBytes() + topo.CompressedSizeBytes();
+}
+
+}  // namespace
+
+katana::PGViewCache::PGViewCache() {
+  // Make sure the memory supervisor outlives this cache
+  TopologyManager::Get();
+}
+
+katana::PGViewCache::PGViewCache(GraphTopology&& original_topo)
+    : original_topo_(
+          std::make_shared<GraphTopology>(std::move(original_topo))) {
+  TopologyManager::Get();
+}
+
+katana::PGViewCache::PGViewCache(PGViewCache&& other) noexcept
+    : original_topo_(std::move(other.original_topo_)),
+      default_topo_loader_(std::move(other.default_topo_loader_)),
+      default_topo_deferred_(other.default_topo_deferred_.exchange(false)),
+      deferred_num_nodes_(other.deferred_num_nodes_),
+      deferred_num_edges_(other.deferred_num_edges_),
+      edge_shuff_topos_(std::move(other.edge_shuff_topos_)),
+      fully_shuff_topos_(std::move(other.fully_shuff_topos_)),
+      edge_type_aware_topos_(std::move(other.edge_type_aware_topos_)),
+      compressed_topos_(std::move(other.compressed_topos_)),
+      edge_type_id_map_(std::move(other.edge_type_id_map_)),
+      node_type_bitmaps_(std::move(other.node_type_bitmaps_)),
+      edge_srcs_(std::move(other.edge_srcs_)),
+      replicas_(std::move(other.replicas_)),
+      temporal_topos_(std::move(other.temporal_topos_)) {
+  TopologyManager::Get().CacheMoved(&other, this);
+}
+
+katana::PGViewCache&
+katana::PGViewCache::operator=(PGViewCache&& other) noexcept {
+  if (this != &other) {
+    auto& tm = TopologyManager::Get();
+    tm.CacheDropped(this);
+    original_topo_ = std::move(other.original_topo_);
+    default_topo_loader_ = std::move(other.default_topo_loader_);
+    default_topo_deferred_ = other.default_topo_deferred_.exchange(false);
+    deferred_num_nodes_ = other.deferred_num_nodes_;
+    deferred_num_edges_ = other.deferred_num_edges_;
+    edge_shuff_topos_ = std::move(other.edge_shuff_topos_);
+    fully_shuff_topos_ = std::move(other.fully_shuff_topos_);
+    edge_type_aware_topos_ = std::move(other.edge_type_aware_topos_);
+    compressed_topos_ = std::move(other.compressed_topos_);
+    edge_type_id_map_ = std::move(other.edge_type_id_map_);
+    node_type_bitmaps_ = std::move(other.node_type_bitmaps_);
+    edge_srcs_ = std::move(other.edge_srcs_);
+    replicas_ = std::move(other.replicas_);
+    temporal_topos_ = std::move(other.temporal_topos_);
+    tm.CacheMoved(&other, this);
+  }
+  return *this;
+}
+
+katana::PGViewCache::~PGViewCache() {
+  TopologyManager::Get().CacheDropped(this);
+}
+
+template <typename Topo>
+std::shared_ptr<Topo>
+katana::PGViewCache::AddToCache(
+    std::vector<std::shared_ptr<Topo>>* topos,
+    std::shared_ptr<Topo>&& topo) noexcept {
+  topos->emplace_back(topo);
+  // Registering may evict other topologies from this cache, so return our
+  // own reference rather than one into topos; it also keeps topo from being
+  // evicted before the caller gets hold of it
+  TopologyManager::Get().TopologyCached(
+      this, topo.get(), ApproxTopologyMemUse(*topo));
+  return std::move(topo);
+}
+
+bool
+katana::PGViewCache::EvictTopology(const void* topo) noexcept {
+  auto try_evict = [topo](auto& topos) {
+    auto it = std::find_if(topos.begin(), topos.end(), [topo](const auto& t) {
+      return t.get() == topo;
+    });
+    if (it == topos.end() || it->use_count() > 1) {
+      return false;
+    }
+    topos.erase(it);
+    return true;
+  };
+  if (edge_srcs_ && edge_srcs_.get() == topo) {
+    if (edge_srcs_.use_count() > 1) {
+      return false;
+    }
+    edge_srcs_.reset();
+    return true;
+  }
+  return try_evict(edge_shuff_topos_) || try_evict(fully_shuff_topos_) ||
+         try_evict(edge_type_aware_topos_) || try_evict(compressed_topos_) ||
+         try_evict(replicas_) || try_evict(temporal_topos_);
+}
+
 const katana::GraphTopology&
 katana::PGViewCache::GetDefaultTopologyRef() const noexcept {
-  return *original_topo_;
+  return *GetDefaultTopology();
 }
 
 std::shared_ptr<katana::GraphTopology>
 katana::PGViewCache::GetDefaultTopology() const noexcept {
+  if (!IsDefaultTopologyLoaded()) {
+    if (auto res = LoadDefaultTopology(); !res) {
+      KATANA_LOG_FATAL("loading deferred topology: {}", res.error());
+    }
+  }
   return original_topo_;
 }
 
+void
+katana::PGViewCache::DeferDefaultTopology(
+    uint64_t num_nodes, uint64_t num_edges,
+    DefaultTopologyLoader loader) noexcept {
+  std::lock_guard<std::mutex> lock(default_topo_mutex_);
+  original_topo_ = std::make_shared<katana::GraphTopology>();
+  default_topo_loader_ = std::move(loader);
+  deferred_num_nodes_ = num_nodes;
+  deferred_num_edges_ = num_edges;
+  default_topo_deferred_.store(true, std::memory_order_release);
+}
+
+katana::Result<void>
+katana::PGViewCache::LoadDefaultTopology() const {
+  if (IsDefaultTopologyLoaded()) {
+    return katana::ResultSuccess();
+  }
+  std::lock_guard<std::mutex> lock(default_topo_mutex_);
+  // another thread may have loaded it while we waited
+  if (IsDefaultTopologyLoaded()) {
+    return katana::ResultSuccess();
+  }
+
+  katana::MemoryCategoryScope category_scope(katana::MemoryCategory::kTopology);
+  katana::GraphTopology topo = KATANA_CHECKED_CONTEXT(
+      default_topo_loader_(), "loading deferred topology");
+  if (topo.NumNodes() != deferred_num_nodes_ ||
+      topo.NumEdges() != deferred_num_edges_) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "deferred topology has {} nodes and {} edges, expected {} and {}",
+        topo.NumNodes(), topo.NumEdges(), deferred_num_nodes_,
+        deferred_num_edges_);
+  }
+
+  original_topo_ = std::make_shared<katana::GraphTopology>(std::move(topo));
+  default_topo_loader_ = nullptr;
+  default_topo_deferred_.store(false, std::memory_order_release);
+  return katana::ResultSuccess();
+}
+
+uint64_t
+katana::PGViewCache::NumDefaultNodes() const noexcept {
+  return IsDefaultTopologyLoaded() ? original_topo_->NumNodes()
+                                   : deferred_num_nodes_;
+}
+
+uint64_t
+katana::PGViewCache::NumDefaultEdges() const noexcept {
+  return IsDefaultTopologyLoaded() ? original_topo_->NumEdges()
+                                   : deferred_num_edges_;
+}
+
 bool
 katana::PGViewCache::ReseatDefaultTopo(
     const std::shared_ptr<GraphTopology>& other) noexcept {
   // We check for the original sort state to avoid doing this every time a new
   // edge shuffle topo is cached.
-  if (original_topo_->edge_sort_state() !=
+  if (GetDefaultTopology()->edge_sort_state() !=
       katana::RDGTopology::EdgeSortKind::kAny) {
     return false;
   }
@@ -721,17 +2024,27 @@ katana::PGViewCache::ReseatDefaultTopo(
 
 void
 katana::PGViewCache::DropAllTopologies() noexcept {
+  TopologyManager::Get().CacheDropped(this);
   original_topo_ = std::make_shared<katana::GraphTopology>();
+  default_topo_loader_ = nullptr;
+  default_topo_deferred_.store(false, std::memory_order_release);
 
   edge_shuff_topos_.clear();
   fully_shuff_topos_.clear();
   edge_type_aware_topos_.clear();
+  compressed_topos_.clear();
   edge_type_id_map_.reset();
+  node_type_bitmaps_.clear();
+  edge_srcs_.reset();
+  replicas_.clear();
+  temporal_topos_.clear();
 }
 
 std::shared_ptr<katana::CondensedTypeIDMap>
 katana::PGViewCache::BuildOrGetEdgeTypeIndex(
     const katana::PropertyGraph* pg) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
   if (edge_type_id_map_ && edge_type_id_map_->is_valid()) {
     return edge_type_id_map_;
   }
@@ -741,6 +2054,214 @@ katana::PGViewCache::BuildOrGetEdgeTypeIndex(
   return edge_type_id_map_;
 };
 
+std::shared_ptr<const katana::DynamicBitset>
+katana::PGViewCache::BuildOrGetNodeTypeBitmap(
+    const katana::PropertyGraph* pg, katana::EntityTypeID type) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
+  auto it = node_type_bitmaps_.find(type);
+  if (it != node_type_bitmaps_.end() &&
+      it->second->size() == pg->NumNodes()) {
+    return it->second;
+  }
+
+  // Whether each entity type is a subtype of type, so that each node costs
+  // a table lookup instead of a comparison of sets of atomic types
+  const katana::EntityTypeManager& manager = pg->GetNodeTypeManager();
+  std::vector<uint8_t> has_type(manager.GetNumEntityTypes());
+  katana::do_all(
+      katana::iterate(size_t{0}, has_type.size()),
+      [&](size_t t) {
+        has_type[t] = manager.IsSubtypeOf(type, static_cast<EntityTypeID>(t));
+      },
+      katana::no_stats());
+
+  // Each word of the bitmap is built by one thread, so no bit is set
+  // atomically
+  auto bitmap = std::make_shared<katana::DynamicBitset>();
+  bitmap->resize(pg->NumNodes());
+  auto& words = bitmap->get_vec();
+  uint64_t num_nodes = pg->NumNodes();
+  katana::do_all(
+      katana::iterate(size_t{0}, words.size()),
+      [&](size_t w) {
+        uint64_t word = 0;
+        uint64_t begin = w * katana::DynamicBitset::kNumBitsInUint64;
+        uint64_t end = std::min<uint64_t>(
+            begin + katana::DynamicBitset::kNumBitsInUint64, num_nodes);
+        for (uint64_t n = begin; n < end; ++n) {
+          katana::EntityTypeID t = pg->GetTypeOfNode(n);
+          uint64_t bit = t < has_type.size() && has_type[t];
+          word |= bit << (n - begin);
+        }
+        words[w] = word;
+      },
+      katana::loopname("BuildNodeTypeBitmap"), katana::no_stats());
+
+  node_type_bitmaps_[type] = bitmap;
+  return bitmap;
+}
+
+std::shared_ptr<const katana::GraphTopology::EdgeDestVec>
+katana::PGViewCache::BuildOrGetEdgeSources() noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
+  std::shared_ptr<GraphTopology> topo = GetDefaultTopology();
+  if (edge_srcs_) {
+    if (edge_srcs_->size() == topo->NumEdges()) {
+      TopologyManager::Get().TopologyUsed(edge_srcs_.get());
+      return edge_srcs_;
+    }
+    TopologyManager::Get().TopologyDropped(edge_srcs_.get());
+    edge_srcs_.reset();
+  }
+
+  auto edge_srcs = std::make_shared<GraphTopology::EdgeDestVec>();
+  edge_srcs->allocateInterleaved(topo->NumEdges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topo->NumNodes()),
+      [&](uint64_t n) {
+        for (auto e : topo->OutEdges(n)) {
+          (*edge_srcs)[e] = n;
+        }
+      },
+      katana::steal(), katana::loopname("BuildEdgeSources"),
+      katana::no_stats());
+
+  edge_srcs_ = edge_srcs;
+  TopologyManager::Get().TopologyCached(
+      this, edge_srcs.get(),
+      edge_srcs->size() * sizeof(GraphTopologyTypes::Node));
+  return edge_srcs;
+}
+
+std::shared_ptr<katana::TopologyReplicas>
+katana::TopologyReplicas::Make(
+    const std::shared_ptr<const GraphTopology>& topo) noexcept {
+  std::shared_ptr<TopologyReplicas> ret(new TopologyReplicas());
+  ret->base_ = topo;
+  ret->num_nodes_ = topo->NumNodes();
+  ret->num_edges_ = topo->NumEdges();
+  ret->replicas_.emplace_back(Replica{topo->AdjData(), topo->DestData()});
+
+  auto& tp = katana::GetThreadPool();
+  const unsigned num_threads = katana::getActiveThreads();
+  const unsigned num_sockets = tp.getCumulativeMaxSocket(num_threads - 1) + 1;
+  if (num_sockets < 2) {
+    return ret;
+  }
+
+  // Each copy is written, and so placed, by the threads of its socket, each
+  // taking a block according to its rank among them
+  std::vector<unsigned> rank(num_threads);
+  std::vector<unsigned> socket_threads(num_sockets, 0);
+  for (unsigned t = 0; t < num_threads; ++t) {
+    rank[t] = socket_threads[tp.getSocket(t)]++;
+  }
+
+  ret->adj_copies_.resize(num_sockets);
+  ret->dest_copies_.resize(num_sockets);
+  for (unsigned s = 0; s < num_sockets; ++s) {
+    ret->adj_copies_[s].allocateFloating(ret->num_nodes_);
+    ret->dest_copies_[s].allocateFloating(ret->num_edges_);
+  }
+
+  const Edge* adj_indices = topo->AdjData();
+  const Node* dests = topo->DestData();
+  katana::on_each([&](unsigned tid, unsigned) {
+    unsigned socket = katana::ThreadPool::getSocket();
+    auto [node_begin, node_end] = katana::block_range(
+        uint64_t{0}, ret->num_nodes_, rank[tid], socket_threads[socket]);
+    std::copy(
+        adj_indices + node_begin, adj_indices + node_end,
+        ret->adj_copies_[socket].data() + node_begin);
+    auto [edge_begin, edge_end] = katana::block_range(
+        uint64_t{0}, ret->num_edges_, rank[tid], socket_threads[socket]);
+    std::copy(
+        dests + edge_begin, dests + edge_end,
+        ret->dest_copies_[socket].data() + edge_begin);
+  });
+
+  ret->replicas_.clear();
+  for (unsigned s = 0; s < num_sockets; ++s) {
+    ret->replicas_.emplace_back(
+        Replica{ret->adj_copies_[s].data(), ret->dest_copies_[s].data()});
+  }
+  return ret;
+}
+
+std::shared_ptr<const katana::TopologyReplicas>
+katana::PGViewCache::BuildOrGetReplicas(
+    const std::shared_ptr<const GraphTopology>& topo) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
+  for (const auto& replicas : replicas_) {
+    if (replicas->IsReplicaOf(topo.get())) {
+      TopologyManager::Get().TopologyUsed(replicas.get());
+      return replicas;
+    }
+  }
+
+  // copies of topologies that are gone are no use to anyone
+  auto& tm = TopologyManager::Get();
+  replicas_.erase(
+      std::remove_if(
+          replicas_.begin(), replicas_.end(),
+          [&tm](const auto& replicas) {
+            if (!replicas->expired()) {
+              return false;
+            }
+            tm.TopologyDropped(replicas.get());
+            return true;
+          }),
+      replicas_.end());
+
+  auto replicas = TopologyReplicas::Make(topo);
+  replicas_.emplace_back(replicas);
+  TopologyManager::Get().TopologyCached(
+      this, replicas.get(), replicas->SizeBytes());
+  return replicas;
+}
+
+std::shared_ptr<katana::ProjectedTopology>
+katana::PGViewCache::BuildProjectedTopo(
+    const katana::PropertyGraph* pg, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types, double compact_below) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
+  std::shared_ptr<const GraphTopology> base = GetDefaultTopology();
+
+  // The nodes of a type are cached as a bitmap, so the union is an or of
+  // words
+  katana::DynamicBitset nodes;
+  nodes.resize(base->NumNodes());
+  if (node_types.empty()) {
+    nodes.bitwise_not();
+  } else {
+    const katana::EntityTypeManager& manager = pg->GetNodeTypeManager();
+    for (const auto& name : node_types) {
+      if (manager.HasAtomicType(name)) {
+        nodes.bitwise_or(
+            *BuildOrGetNodeTypeBitmap(pg, manager.GetEntityTypeID(name)));
+      }
+    }
+  }
+
+  std::optional<std::vector<EntityTypeID>> edge_type_ids;
+  if (!edge_types.empty()) {
+    const katana::EntityTypeManager& manager = pg->GetEdgeTypeManager();
+    edge_type_ids.emplace();
+    for (const auto& name : edge_types) {
+      if (manager.HasAtomicType(name)) {
+        edge_type_ids->emplace_back(manager.GetEntityTypeID(name));
+      }
+    }
+  }
+
+  return ProjectedTopology::MakeFrom(
+      pg, std::move(base), nodes, edge_type_ids, compact_below);
+}
+
 template <typename Topo>
 [[maybe_unused]] bool
 CheckTopology(const katana::PropertyGraph* pg, const Topo* t) noexcept {
@@ -768,6 +2289,8 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
     katana::PropertyGraph* pg,
     const katana::RDGTopology::TransposeKind& tpose_kind,
     const katana::RDGTopology::EdgeSortKind& sort_kind, bool pop) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
   // Try to find a matching topology in the cache.
   auto pred = [&](const auto& topo_ptr) {
     return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
@@ -781,18 +2304,23 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
     if (pop) {
       auto topo = *it;
       edge_shuff_topos_.erase(it);
+      TopologyManager::Get().TopologyDropped(topo.get());
       return topo;
     } else {
+      TopologyManager::Get().TopologyUsed(it->get());
       return *it;
     }
   }
 
-  // Then in edge type aware topologies. We don't pop from it.
-  if (sort_kind == katana::RDGTopology::EdgeSortKind::kSortedByEdgeType) {
+  // Then in edge type aware topologies. We don't pop from it, and a caller
+  // that pops owns the result, so it gets a topology of its own below.
+  if (!pop &&
+      sort_kind == katana::RDGTopology::EdgeSortKind::kSortedByEdgeType) {
     auto it = std::find_if(
         edge_type_aware_topos_.begin(), edge_type_aware_topos_.end(), pred);
     if (it != edge_type_aware_topos_.end()) {
       KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+      TopologyManager::Get().TopologyUsed(it->get());
       return *it;
     }
   }
@@ -810,8 +2338,7 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
   if (pop) {
     return new_topo;
   } else {
-    edge_shuff_topos_.emplace_back(std::move(new_topo));
-    return edge_shuff_topos_.back();
+    return AddToCache(&edge_shuff_topos_, std::move(new_topo));
   }
 }
 
@@ -821,6 +2348,8 @@ katana::PGViewCache::BuildOrGetShuffTopo(
     const katana::RDGTopology::TransposeKind& tpose_kind,
     const katana::RDGTopology::NodeSortKind& node_sort_todo,
     const katana::RDGTopology::EdgeSortKind& edge_sort_todo) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
   // try to find a matching topology in the cache
   auto pred = [&](const auto& topo_ptr) {
     return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
@@ -833,6 +2362,7 @@ katana::PGViewCache::BuildOrGetShuffTopo(
 
   if (it != fully_shuff_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+    TopologyManager::Get().TopologyUsed(it->get());
     return *it;
   } else {
     // no matching topology in cache, see if we have it in storage
@@ -842,6 +2372,7 @@ katana::PGViewCache::BuildOrGetShuffTopo(
         edge_sort_todo, node_sort_todo);
     auto res = pg->LoadTopology(std::move(shadow));
 
+    std::shared_ptr<ShuffleTopology> new_topo;
     if (!res) {
       // no matching topology in cache or storage, generate it
 
@@ -853,24 +2384,27 @@ katana::PGViewCache::BuildOrGetShuffTopo(
           pg, tpose_kind, katana::RDGTopology::EdgeSortKind::kAny);
       KATANA_LOG_DEBUG_ASSERT(e_topo->has_transpose_state(tpose_kind));
 
-      fully_shuff_topos_.emplace_back(ShuffleTopology::MakeFromTopo(
-          pg, *e_topo, node_sort_todo, edge_sort_todo));
+      new_topo = ShuffleTopology::MakeFromTopo(
+          pg, *e_topo, node_sort_todo, edge_sort_todo);
 
     } else {
       // found matching topology in storage
       katana::RDGTopology* topo = res.value();
-      fully_shuff_topos_.emplace_back(katana::ShuffleTopology::Make(topo));
+      new_topo = katana::ShuffleTopology::Make(topo);
     }
 
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
-    return fully_shuff_topos_.back();
+    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, new_topo.get()));
+    return AddToCache(&fully_shuff_topos_, std::move(new_topo));
   }
 }
 
 std::shared_ptr<katana::EdgeTypeAwareTopology>
 katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
     katana::PropertyGraph* pg,
-    const katana::RDGTopology::TransposeKind& tpose_kind) noexcept {
+    const katana::RDGTopology::TransposeKind& tpose_kind,
+    bool with_dest_index) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
   // try to find a matching topology in the cache
   auto pred = [&](const auto& topo_ptr) {
     return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind);
@@ -880,7 +2414,18 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
 
   if (it != edge_type_aware_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return *it;
+    auto topo = *it;
+    if (with_dest_index && !topo->has_dest_index()) {
+      // The index only adds to the topology, so views that already hold it
+      // are unaffected. Register it again to account for the index.
+      topo->BuildDestIndex();
+      TopologyManager::Get().TopologyDropped(topo.get());
+      TopologyManager::Get().TopologyCached(
+          this, topo.get(), ApproxTopologyMemUse(*topo));
+    } else {
+      TopologyManager::Get().TopologyUsed(topo.get());
+    }
+    return topo;
   } else {
     // no matching topology in cache, see if we have it in storage
     katana::RDGTopology shadow = katana::RDGTopology::MakeShadow(
@@ -901,23 +2446,113 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
     // If it doesn't match, then the EdgeTypeAwareTopology on storage is out of date and cannot be used
     auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
 
+    std::shared_ptr<EdgeTypeAwareTopology> new_topo;
     if (res) {
       // found matching topology in storage
       katana::RDGTopology* rdg_topo = res.value();
 
-      edge_type_aware_topos_.emplace_back(katana::EdgeTypeAwareTopology::Make(
-          rdg_topo, std::move(edge_type_index), std::move(*sorted_topo)));
+      new_topo = katana::EdgeTypeAwareTopology::Make(
+          rdg_topo, std::move(edge_type_index), std::move(*sorted_topo));
     } else {
       // no matching topology in cache or storage, generate it
-      edge_type_aware_topos_.emplace_back(EdgeTypeAwareTopology::MakeFrom(
-          pg, std::move(edge_type_index), std::move(*sorted_topo)));
+      new_topo = EdgeTypeAwareTopology::MakeFrom(
+          pg, std::move(edge_type_index), std::move(*sorted_topo));
     }
 
-    KATANA_LOG_DEBUG_ASSERT(
-        CheckTopology(pg, edge_type_aware_topos_.back().get()));
+    // The destination index is not stored, so it is built either way
+    if (with_dest_index) {
+      new_topo->BuildDestIndex();
+    }
+
+    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, new_topo.get()));
+
+    return AddToCache(&edge_type_aware_topos_, std::move(new_topo));
+  }
+}
+
+std::shared_ptr<katana::CompressedGraphTopology>
+katana::PGViewCache::BuildOrGetCompressedTopo(
+    katana::PropertyGraph* pg,
+    const katana::RDGTopology::TransposeKind& tpose_kind) noexcept {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
+  // try to find a matching topology in the cache
+  auto pred = [&](const auto& topo_ptr) {
+    return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind);
+  };
+  auto it =
+      std::find_if(compressed_topos_.begin(), compressed_topos_.end(), pred);
 
-    return edge_type_aware_topos_.back();
+  if (it != compressed_topos_.end()) {
+    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
+    TopologyManager::Get().TopologyUsed(it->get());
+    return *it;
   }
+
+  // no matching topology in cache, see if we have it in storage
+  katana::RDGTopology shadow = katana::RDGTopology::MakeShadow(
+      katana::RDGTopology::TopologyKind::kCompressedTopology, tpose_kind,
+      katana::RDGTopology::EdgeSortKind::kSortedByDestID,
+      katana::RDGTopology::NodeSortKind::kAny);
+  auto res = pg->LoadTopology(std::move(shadow));
+
+  std::shared_ptr<CompressedGraphTopology> new_topo;
+  if (res) {
+    new_topo = katana::CompressedGraphTopology::Make(res.value());
+  } else {
+    // Compress a sorted topology. If none is cached, build one without caching
+    // it; the point of this topology is to not keep uncompressed dests around.
+    auto sorted_pred = [&](const auto& topo_ptr) {
+      return topo_ptr->is_valid() &&
+             topo_ptr->has_transpose_state(tpose_kind) &&
+             topo_ptr->has_edges_sorted_by(
+                 katana::RDGTopology::EdgeSortKind::kSortedByDestID);
+    };
+    auto sorted_it = std::find_if(
+        edge_shuff_topos_.begin(), edge_shuff_topos_.end(), sorted_pred);
+    auto sorted_topo =
+        (sorted_it != edge_shuff_topos_.end())
+            ? *sorted_it
+            : EdgeShuffleTopology::Make(
+                  pg, tpose_kind,
+                  katana::RDGTopology::EdgeSortKind::kSortedByDestID);
+    new_topo = katana::CompressedGraphTopology::MakeFrom(*sorted_topo);
+  }
+
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, new_topo.get()));
+  return AddToCache(&compressed_topos_, std::move(new_topo));
+}
+
+katana::Result<std::shared_ptr<katana::TemporalTopology>>
+katana::PGViewCache::BuildOrGetTemporalTopo(
+    katana::PropertyGraph* pg, const std::string& timestamp_property,
+    const katana::RDGTopology::TransposeKind& tpose_kind) {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kViewCache);
+  auto timestamps = KATANA_CHECKED(pg->GetEdgeProperty(timestamp_property));
+
+  auto& tm = TopologyManager::Get();
+  for (auto it = temporal_topos_.begin(); it != temporal_topos_.end(); ++it) {
+    const auto& topo = *it;
+    if (topo->timestamp_property() != timestamp_property ||
+        !topo->has_transpose_state(tpose_kind)) {
+      continue;
+    }
+    if (topo->IsSortedBy(timestamps)) {
+      KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+      tm.TopologyUsed(topo.get());
+      return topo;
+    }
+    // the property was replaced since
+    tm.TopologyDropped(topo.get());
+    temporal_topos_.erase(it);
+    break;
+  }
+
+  auto new_topo = KATANA_CHECKED(
+      TemporalTopology::MakeFrom(pg, timestamp_property, tpose_kind));
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, new_topo.get()));
+  return AddToCache(&temporal_topos_, std::move(new_topo));
 }
 
 katana::Result<std::vector<katana::RDGTopology>>
@@ -942,6 +2577,12 @@ katana::PGViewCache::ToRDGTopology() {
     rdg_topos.emplace_back(std::move(topo));
   }
 
+  for (size_t i = 0; i < compressed_topos_.size(); i++) {
+    katana::RDGTopology topo =
+        KATANA_CHECKED(compressed_topos_[i]->ToRDGTopology());
+    rdg_topos.emplace_back(std::move(topo));
+  }
+
   return std::vector<katana::RDGTopology>(std::move(rdg_topos));
 }
 
@@ -0,0 +1,57 @@
+#include "katana/MirrorSync.h"
+
+#include <algorithm>
+
+#include "katana/ArrowInterchange.h"
+
+katana::MirrorSync::MirrorSync(
+    CommBackend* comm, std::vector<std::vector<uint32_t>> masters,
+    std::vector<std::vector<uint32_t>> mirrors)
+    : comm_(comm), masters_(std::move(masters)), mirrors_(std::move(mirrors)) {
+  KATANA_LOG_VASSERT(
+      masters_.size() <= comm_->num() && mirrors_.size() <= comm_->num(),
+      "node lists for {} and {} hosts but only {} hosts", masters_.size(),
+      mirrors_.size(), comm_->num());
+}
+
+katana::Result<katana::MirrorSync>
+katana::MirrorSync::Make(
+    CommBackend* comm,
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& master_nodes,
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& mirror_nodes) {
+  if (master_nodes.size() > comm->num() || mirror_nodes.size() > comm->num()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partition has node lists for {} hosts but there are {} hosts",
+        std::max(master_nodes.size(), mirror_nodes.size()), comm->num());
+  }
+
+  std::vector<std::vector<uint32_t>> masters(master_nodes.size());
+  KATANA_CHECKED_CONTEXT(
+      katana::UnmarshalVectorOfVectors(master_nodes, &masters),
+      "reading master nodes");
+  std::vector<std::vector<uint32_t>> mirrors(mirror_nodes.size());
+  KATANA_CHECKED_CONTEXT(
+      katana::UnmarshalVectorOfVectors(mirror_nodes, &mirrors),
+      "reading mirror nodes");
+
+  return MirrorSync(comm, std::move(masters), std::move(mirrors));
+}
+
+uint64_t
+katana::MirrorSync::num_masters() const {
+  uint64_t num = 0;
+  for (const auto& nodes : masters_) {
+    num += nodes.size();
+  }
+  return num;
+}
+
+uint64_t
+katana::MirrorSync::num_mirrors() const {
+  uint64_t num = 0;
+  for (const auto& nodes : mirrors_) {
+    num += nodes.size();
+  }
+  return num;
+}
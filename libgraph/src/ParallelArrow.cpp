@@ -0,0 +1,203 @@
+#include "katana/ParallelArrow.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <arrow/array/array_dict.h>
+#include <arrow/array/concatenate.h>
+#include <arrow/buffer.h>
+#include <arrow/compute/api_vector.h>
+#include <arrow/util/bit_util.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+
+namespace {
+
+/// Rows are copied in blocks of this many rows. It is a multiple of 8, so
+/// every block owns whole bytes of the validity bitmap.
+constexpr int64_t kBlockRows = int64_t{1} << 16;
+
+int64_t
+NumBlocks(int64_t num_rows) {
+  return (num_rows + kBlockRows - 1) / kBlockRows;
+}
+
+int64_t
+ByteWidth(const arrow::DataType& type) {
+  return static_cast<const arrow::FixedWidthType&>(type).bit_width() / 8;
+}
+
+/// The validity bitmap of data, or nullptr if all of its values are valid
+const uint8_t*
+ValidityOf(const arrow::Array& array) {
+  return array.null_count() == 0 ? nullptr : array.data()->buffers[0]->data();
+}
+
+}  // namespace
+
+bool
+katana::IsFixedByteWidth(const arrow::DataType& type) {
+  const auto* fixed_width = dynamic_cast<const arrow::FixedWidthType*>(&type);
+  return fixed_width && type.id() != arrow::Type::BOOL &&
+         type.id() != arrow::Type::DICTIONARY &&
+         fixed_width->bit_width() % 8 == 0;
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::ParallelConcatenate(const arrow::ArrayVector& chunks) {
+  if (chunks.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "cannot concatenate zero chunks");
+  }
+  const std::shared_ptr<arrow::DataType>& type = chunks[0]->type();
+  if (!IsFixedByteWidth(*type)) {
+    return KATANA_CHECKED(arrow::Concatenate(chunks));
+  }
+
+  // starts[i] is the first row of chunk i in the concatenation
+  std::vector<int64_t> starts(chunks.size() + 1, 0);
+  int64_t null_count = 0;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    if (!chunks[i]->type()->Equals(*type)) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "chunk {} has type {} but chunk 0 has type {}",
+          i, chunks[i]->type()->ToString(), type->ToString());
+    }
+    starts[i + 1] = starts[i] + chunks[i]->length();
+    // also caches the null count of every chunk before the parallel copy
+    null_count += chunks[i]->null_count();
+  }
+  const int64_t num_rows = starts.back();
+  const int64_t width = ByteWidth(*type);
+
+  std::shared_ptr<arrow::Buffer> values =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_rows * width));
+  std::shared_ptr<arrow::Buffer> validity;
+  if (null_count > 0) {
+    validity = KATANA_CHECKED(arrow::AllocateBitmap(num_rows));
+  }
+  uint8_t* out = values->mutable_data();
+  uint8_t* out_validity = validity ? validity->mutable_data() : nullptr;
+
+  katana::do_all(
+      katana::iterate(int64_t{0}, NumBlocks(num_rows)),
+      [&](int64_t block) {
+        const int64_t end = std::min(num_rows, (block + 1) * kBlockRows);
+        int64_t row = block * kBlockRows;
+        size_t c = std::upper_bound(starts.begin(), starts.end(), row) -
+                   starts.begin() - 1;
+        for (; row < end; ++c) {
+          const int64_t n = std::min(end, starts[c + 1]) - row;
+          if (n == 0) {
+            continue;
+          }
+          const arrow::Array& chunk = *chunks[c];
+          const int64_t in_row = chunk.offset() + row - starts[c];
+          std::memcpy(
+              out + row * width,
+              chunk.data()->buffers[1]->data() + in_row * width, n * width);
+          if (out_validity) {
+            const uint8_t* in_validity = ValidityOf(chunk);
+            for (int64_t i = 0; i < n; ++i) {
+              arrow::BitUtil::SetBitTo(
+                  out_validity, row + i,
+                  !in_validity ||
+                      arrow::BitUtil::GetBit(in_validity, in_row + i));
+            }
+          }
+          row += n;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      type, num_rows, {std::move(validity), std::move(values)}, null_count));
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::Unchunk(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  if (column->num_chunks() == 1) {
+    return column->chunk(0);
+  }
+  if (column->num_chunks() == 0) {
+    return KATANA_CHECKED(arrow::MakeArrayOfNull(column->type(), 0));
+  }
+  if (column->type()->id() == arrow::Type::DICTIONARY) {
+    // chunks with different dictionaries must share one to be concatenated
+    std::shared_ptr<arrow::ChunkedArray> unified =
+        KATANA_CHECKED(arrow::DictionaryUnifier::UnifyChunkedArray(column));
+    return ParallelConcatenate(unified->chunks());
+  }
+  return ParallelConcatenate(column->chunks());
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::UnchunkTable(const std::shared_ptr<arrow::Table>& table) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = table->columns();
+  bool changed = false;
+  for (auto& column : columns) {
+    if (column->num_chunks() != 1) {
+      column = std::make_shared<arrow::ChunkedArray>(
+          KATANA_CHECKED(Unchunk(column)));
+      changed = true;
+    }
+  }
+  if (!changed) {
+    return table;
+  }
+  return arrow::Table::Make(table->schema(), columns, table->num_rows());
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::ParallelTake(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const katana::NUMAArray<uint64_t>& indices) {
+  const int64_t num_rows = indices.size();
+  if (!IsFixedByteWidth(*column->type())) {
+    // The indices outlive the Take, so they need not be copied
+    auto index_array = std::make_shared<arrow::UInt64Array>(
+        num_rows, arrow::Buffer::Wrap(indices.data(), indices.size()));
+    arrow::Datum taken =
+        KATANA_CHECKED(arrow::compute::Take(column, index_array));
+    return std::make_shared<arrow::ChunkedArray>(
+        KATANA_CHECKED(Unchunk(taken.chunked_array())));
+  }
+
+  std::shared_ptr<arrow::Array> array = KATANA_CHECKED(Unchunk(column));
+  const int64_t width = ByteWidth(*column->type());
+  const uint8_t* in =
+      array->data()->buffers[1]->data() + array->offset() * width;
+  const uint8_t* in_validity = ValidityOf(*array);
+
+  std::shared_ptr<arrow::Buffer> values =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_rows * width));
+  std::shared_ptr<arrow::Buffer> validity;
+  if (in_validity) {
+    validity = KATANA_CHECKED(arrow::AllocateBitmap(num_rows));
+  }
+  uint8_t* out = values->mutable_data();
+  uint8_t* out_validity = validity ? validity->mutable_data() : nullptr;
+
+  katana::do_all(
+      katana::iterate(int64_t{0}, NumBlocks(num_rows)),
+      [&](int64_t block) {
+        const int64_t end = std::min(num_rows, (block + 1) * kBlockRows);
+        for (int64_t row = block * kBlockRows; row < end; ++row) {
+          const int64_t index = indices[row];
+          std::memcpy(out + row * width, in + index * width, width);
+          if (out_validity) {
+            arrow::BitUtil::SetBitTo(
+                out_validity, row,
+                arrow::BitUtil::GetBit(in_validity, array->offset() + index));
+          }
+        }
+      },
+      katana::no_stats());
+
+  return std::make_shared<arrow::ChunkedArray>(
+      arrow::MakeArray(arrow::ArrayData::Make(
+          column->type(), num_rows, {std::move(validity), std::move(values)},
+          in_validity ? arrow::kUnknownNullCount : 0)));
+}
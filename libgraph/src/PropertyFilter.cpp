@@ -0,0 +1,254 @@
+#include "katana/PropertyFilter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/builder.h>
+#include <arrow/compute/api_scalar.h>
+#include <arrow/compute/exec.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelArrow.h"
+
+namespace {
+
+namespace cp = arrow::compute;
+
+constexpr int64_t kBitsPerWord = 64;
+
+using LoadProperty =
+    std::function<katana::Result<std::shared_ptr<arrow::ChunkedArray>>(
+        const std::string&)>;
+
+/// The property rows of the nodes of pg, which are those of the graph it is
+/// a view of, if it is one
+uint64_t
+NumNodeRows(const katana::PropertyGraph& pg) {
+  return pg.IsTransformed() ? NumNodeRows(*pg.Parent()) : pg.NumNodes();
+}
+
+uint64_t
+NumEdgeRows(const katana::PropertyGraph& pg) {
+  return pg.IsTransformed() ? NumEdgeRows(*pg.Parent()) : pg.NumEdges();
+}
+
+katana::Result<cp::Expression>
+HasType(const katana::EntityTypeManager& types, katana::EntityTypeID type_id) {
+  if (!types.HasEntityType(type_id)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no entity type {}", type_id);
+  }
+  // the types that have type_id are type_id and its subtypes
+  arrow::UInt16Builder builder;
+  for (size_t t = 0; t < types.GetNumEntityTypes(); ++t) {
+    auto other = static_cast<katana::EntityTypeID>(t);
+    if (types.IsSubtypeOf(type_id, other)) {
+      KATANA_CHECKED(builder.Append(other));
+    }
+  }
+  std::shared_ptr<arrow::Array> value_set = KATANA_CHECKED(builder.Finish());
+  return cp::call(
+      "is_in", {cp::field_ref(katana::kEntityTypeIDField)},
+      cp::SetLookupOptions(value_set));
+}
+
+/// Set the bits of rows from begin on to whether the values of selected,
+/// a boolean array or scalar, are true
+void
+SetBlock(
+    const arrow::Datum& selected, int64_t begin, int64_t length,
+    katana::DynamicBitset* rows) {
+  auto& words = rows->get_vec();
+  if (selected.is_scalar()) {
+    const auto& scalar =
+        static_cast<const arrow::BooleanScalar&>(*selected.scalar());
+    uint64_t all = scalar.is_valid && scalar.value ? ~uint64_t{0} : 0;
+    for (int64_t i = 0; i < length; i += kBitsPerWord) {
+      int64_t bits = std::min(kBitsPerWord, length - i);
+      uint64_t word =
+          bits == kBitsPerWord ? all : all & ((uint64_t{1} << bits) - 1);
+      words[(begin + i) / kBitsPerWord].store(word, std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  const auto& values =
+      static_cast<const arrow::BooleanArray&>(*selected.make_array());
+  for (int64_t i = 0; i < length; i += kBitsPerWord) {
+    int64_t bits = std::min(kBitsPerWord, length - i);
+    uint64_t word = 0;
+    for (int64_t j = 0; j < bits; ++j) {
+      if (values.IsValid(i + j) && values.Value(i + j)) {
+        word |= uint64_t{1} << j;
+      }
+    }
+    words[(begin + i) / kBitsPerWord].store(word, std::memory_order_relaxed);
+  }
+}
+
+/// \returns for every one of num_rows property rows whether it satisfies
+/// expression, whose fields are the properties that load_property returns
+/// and the entity types at type_ids
+katana::Result<katana::DynamicBitset>
+SelectRows(
+    const cp::Expression& expression, uint64_t num_rows,
+    const katana::EntityTypeID* type_ids, const LoadProperty& load_property,
+    int64_t block_rows) {
+  if (block_rows <= 0 || block_rows % kBitsPerWord != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "block rows must be a positive multiple of {}, not {}", kBitsPerWord,
+        block_rows);
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  std::unordered_set<std::string> seen;
+  for (const cp::FieldRef& ref : cp::FieldsInExpression(expression)) {
+    const std::string* name = ref.name();
+    if (name == nullptr) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "filters refer to properties by name, not by {}", ref.ToString());
+    }
+    if (!seen.emplace(*name).second) {
+      continue;
+    }
+
+    std::shared_ptr<arrow::Array> column;
+    if (*name == katana::kEntityTypeIDField) {
+      // the type ids are not a property, so view them as one
+      auto buffer = std::make_shared<arrow::Buffer>(
+          reinterpret_cast<const uint8_t*>(type_ids),
+          num_rows * sizeof(katana::EntityTypeID));
+      column = std::make_shared<arrow::UInt16Array>(num_rows, buffer);
+    } else {
+      std::shared_ptr<arrow::ChunkedArray> property = KATANA_CHECKED_CONTEXT(
+          load_property(*name), "filtering on {}", *name);
+      column = KATANA_CHECKED(katana::Unchunk(property));
+    }
+    if (static_cast<uint64_t>(column->length()) != num_rows) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "property {} has {} rows, expected {}", *name, column->length(),
+          num_rows);
+    }
+    fields.emplace_back(arrow::field(*name, column->type()));
+    columns.emplace_back(std::move(column));
+  }
+
+  cp::Expression bound = KATANA_CHECKED_CONTEXT(
+      expression.Bind(arrow::Schema(fields)), "binding filter {}",
+      expression.ToString());
+  if (bound.type()->id() != arrow::Type::BOOL) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "filter {} is of type {}, not boolean",
+        expression.ToString(), bound.type()->ToString());
+  }
+
+  katana::DynamicBitset rows;
+  rows.resize(num_rows);
+  size_t num_blocks = (num_rows + block_rows - 1) / block_rows;
+  std::vector<arrow::Status> statuses(num_blocks);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t i) {
+        int64_t begin = i * block_rows;
+        int64_t length = std::min<int64_t>(block_rows, num_rows - begin);
+        std::vector<arrow::Datum> values;
+        values.reserve(columns.size());
+        for (const auto& column : columns) {
+          values.emplace_back(column->Slice(begin, length));
+        }
+        auto selected = cp::ExecuteScalarExpression(
+            bound, cp::ExecBatch(std::move(values), length));
+        if (!selected.ok()) {
+          statuses[i] = selected.status();
+          return;
+        }
+        SetBlock(*selected, begin, length, &rows);
+      },
+      katana::steal(), katana::loopname("FilterRows"));
+  for (const auto& status : statuses) {
+    KATANA_CHECKED_CONTEXT(status, "evaluating filter {}", bound.ToString());
+  }
+  return rows;
+}
+
+/// \returns for each of size entities whether its row, row_of(entity), is
+/// set in rows
+template <typename RowOf>
+katana::DynamicBitset
+MapRows(const katana::DynamicBitset& rows, uint64_t size, RowOf row_of) {
+  katana::DynamicBitset selected;
+  selected.resize(size);
+  auto& words = selected.get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, words.size()),
+      [&](size_t w) {
+        uint64_t begin = w * kBitsPerWord;
+        uint64_t end = std::min<uint64_t>(size, begin + kBitsPerWord);
+        uint64_t word = 0;
+        for (uint64_t i = begin; i < end; ++i) {
+          if (rows.test(row_of(i))) {
+            word |= uint64_t{1} << (i - begin);
+          }
+        }
+        words[w].store(word, std::memory_order_relaxed);
+      },
+      katana::loopname("FilterMapRows"));
+  return selected;
+}
+
+}  // namespace
+
+katana::Result<arrow::compute::Expression>
+katana::NodeHasType(const PropertyGraph& pg, EntityTypeID type_id) {
+  return HasType(pg.GetNodeTypeManager(), type_id);
+}
+
+katana::Result<arrow::compute::Expression>
+katana::EdgeHasType(const PropertyGraph& pg, EntityTypeID type_id) {
+  return HasType(pg.GetEdgeTypeManager(), type_id);
+}
+
+katana::Result<katana::DynamicBitset>
+katana::FilterNodes(
+    PropertyGraph* pg, const arrow::compute::Expression& expression,
+    int64_t block_rows) {
+  auto load_property = [pg](const std::string& name)
+      -> Result<std::shared_ptr<arrow::ChunkedArray>> {
+    KATANA_CHECKED(pg->EnsureNodePropertyLoaded(name));
+    return pg->GetNodeProperty(name);
+  };
+  DynamicBitset rows = KATANA_CHECKED(SelectRows(
+      expression, NumNodeRows(*pg), pg->node_type_data(), load_property,
+      block_rows));
+  return MapRows(rows, pg->NumNodes(), [pg](uint64_t n) {
+    return pg->GetNodePropertyIndex(n);
+  });
+}
+
+katana::Result<katana::DynamicBitset>
+katana::FilterEdges(
+    PropertyGraph* pg, const arrow::compute::Expression& expression,
+    int64_t block_rows) {
+  auto load_property = [pg](const std::string& name)
+      -> Result<std::shared_ptr<arrow::ChunkedArray>> {
+    KATANA_CHECKED(pg->EnsureEdgePropertyLoaded(name));
+    return pg->GetEdgeProperty(name);
+  };
+  DynamicBitset rows = KATANA_CHECKED(SelectRows(
+      expression, NumEdgeRows(*pg), pg->edge_type_data(), load_property,
+      block_rows));
+  return MapRows(rows, pg->NumEdges(), [pg](uint64_t e) {
+    return pg->GetEdgePropertyIndexFromOutEdge(e);
+  });
+}
@@ -3,28 +3,48 @@
 #include <stdio.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/chunked_array.h>
+#include <arrow/compute/api_vector.h>
+#include <arrow/compute/exec.h>
+#include <arrow/util/bit_util.h>
 
 #include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileFrame.h"
+#include "katana/FileView.h"
 #include "katana/GraphTopology.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
+#include "katana/MemorySupervisor.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelArrow.h"
+#include "katana/ParallelSTL.h"
+#include "katana/ParquetReader.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/PropertyStatistics.h"
+#include "katana/PropertyUnloadManager.h"
 #include "katana/RDG.h"
 #include "katana/RDGManifest.h"
 #include "katana/RDGPrefix.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
 #include "katana/tsuba.h"
 
@@ -33,7 +53,7 @@ namespace {
 [[maybe_unused]] bool
 CheckTopology(
     const uint64_t* out_indices, const uint64_t num_nodes,
-    const uint32_t* out_dests, const uint64_t num_edges) {
+    const katana::GraphTopology::Node* out_dests, const uint64_t num_edges) {
   bool has_bad_adj = false;
 
   katana::do_all(
@@ -67,6 +87,8 @@ MapEntityTypeIDsArray(
     const katana::FileView& file_view, size_t num_entries,
     bool is_headerless_entity_type_id_array) {
   // allocate type IDs array
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kEntityTypeIDs);
   katana::PropertyGraph::EntityTypeIDArray entity_type_id_array;
   entity_type_id_array.allocateInterleaved(num_entries);
 
@@ -95,6 +117,145 @@ MapEntityTypeIDsArray(
   return katana::MakeResult(std::move(entity_type_id_array));
 }
 
+/// The arrays of the topology files read into private memory, shared by
+/// all graphs loaded from the same file, e.g., versions N and N + 1 of an
+/// RDG whose topology did not change between them. A topology file is never
+/// rewritten in place, a changed topology is stored to a new random file
+/// name, so the URI of a file identifies its contents. Like the property
+/// cache of PropertyManager, the cache is keyed by URI, but it does not own
+/// the arrays: they are freed with the last graph that uses them.
+class SharedTopologyCache {
+public:
+  struct Arrays {
+    katana::GraphTopology::AdjIndexVec adj_indices;
+    katana::GraphTopology::EdgeDestVec dests;
+  };
+
+  static SharedTopologyCache& Get() {
+    // never destroyed, as graphs may outlive static destructors
+    static auto* cache = new SharedTopologyCache();
+    return *cache;
+  }
+
+  /// \returns the arrays of the topology file at \p uri, or nullptr if no
+  /// graph uses them
+  std::shared_ptr<const Arrays> Find(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(uri);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    return it->second.lock();
+  }
+
+  /// Share \p arrays as the arrays of the topology file at \p uri.
+  /// \returns the arrays to use, which are those of another graph if it
+  /// inserted them first
+  std::shared_ptr<const Arrays> Insert(
+      const std::string& uri, std::shared_ptr<const Arrays> arrays) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      it = it->second.expired() ? entries_.erase(it) : std::next(it);
+    }
+    auto& entry = entries_[uri];
+    if (auto existing = entry.lock()) {
+      return existing;
+    }
+    entry = arrays;
+    return arrays;
+  }
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<const Arrays>> entries_;
+};
+
+/// A topology that uses \p arrays in place and keeps them alive
+katana::GraphTopology
+MakeSharedTopology(std::shared_ptr<const SharedTopologyCache::Arrays> arrays) {
+  const auto* adj_indices = arrays->adj_indices.data();
+  size_t num_nodes = arrays->adj_indices.size();
+  const auto* dests = arrays->dests.data();
+  size_t num_edges = arrays->dests.size();
+  return katana::GraphTopology(
+      adj_indices, num_nodes, dests, num_edges, std::move(arrays));
+}
+
+/// Maps the default csr topology of \p rdg into a GraphTopology
+katana::Result<katana::GraphTopology>
+LoadCSRTopology(katana::RDG* rdg) {
+  katana::MemoryCategoryScope category_scope(katana::MemoryCategory::kTopology);
+  katana::RDGTopology shadow_csr = katana::RDGTopology::MakeShadowCSR();
+  katana::RDGTopology* csr = KATANA_CHECKED_CONTEXT(
+      rdg->FindTopology(shadow_csr),
+      "unable to find csr topology, must have csr topology to Make a "
+      "PropertyGraph");
+
+  // A semi-external topology must stay in its file mapping
+  std::string cache_key;
+  if (!rdg->semi_external_topology() && !csr->path().empty()) {
+    cache_key = rdg->rdg_dir().Join(csr->path()).string();
+    if (auto arrays = SharedTopologyCache::Get().Find(cache_key)) {
+      KATANA_LOG_DEBUG("sharing the loaded topology file {}", cache_key);
+      return MakeSharedTopology(std::move(arrays));
+    }
+  }
+
+  csr = KATANA_CHECKED_CONTEXT(
+      rdg->GetTopology(shadow_csr), "loading csr topology");
+
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(
+      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges()));
+  katana::GraphTopology topo;
+  // Destinations converted from the width of the file are not in the mapping
+  const bool use_mapping =
+      csr->file_storage().file_backed() && !csr->dests_converted();
+  if (use_mapping && rdg->semi_external_topology()) {
+    // Only the node array is read into memory; edge destinations stay in the
+    // mapping, which the topology takes over
+    katana::GraphTopology::AdjIndexVec adj_indices;
+    adj_indices.allocateInterleaved(csr->num_nodes());
+    katana::ParallelSTL::copy(
+        csr->adj_indices(), csr->adj_indices() + csr->num_nodes(),
+        adj_indices.begin());
+    const auto* dests = csr->dests();
+    auto storage =
+        std::make_shared<katana::FileView>(std::move(csr->file_storage()));
+    topo = katana::GraphTopology(
+        std::move(adj_indices), dests, csr->num_edges(), std::move(storage));
+  } else if (use_mapping) {
+    // Use the mapped file in place; the topology takes over the mapping
+    const auto* adj_indices = csr->adj_indices();
+    const auto* dests = csr->dests();
+    auto storage =
+        std::make_shared<katana::FileView>(std::move(csr->file_storage()));
+    topo = katana::GraphTopology(
+        adj_indices, csr->num_nodes(), dests, csr->num_edges(),
+        std::move(storage));
+  } else if (!cache_key.empty()) {
+    // Copy the arrays out of the file once for all graphs that load it
+    auto arrays = std::make_shared<SharedTopologyCache::Arrays>();
+    arrays->adj_indices.allocateInterleaved(csr->num_nodes());
+    arrays->dests.allocateInterleaved(csr->num_edges());
+    katana::ParallelSTL::copy(
+        csr->adj_indices(), csr->adj_indices() + csr->num_nodes(),
+        arrays->adj_indices.begin());
+    katana::ParallelSTL::copy(
+        csr->dests(), csr->dests() + csr->num_edges(), arrays->dests.begin());
+    topo = MakeSharedTopology(
+        SharedTopologyCache::Get().Insert(cache_key, std::move(arrays)));
+  } else {
+    // The GraphTopology constructor copies all of the required topology data.
+    topo = katana::GraphTopology(
+        csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges());
+  }
+
+  // Clean up the RDGTopologies memory
+  KATANA_CHECKED(csr->unbind_file_storage());
+
+  return katana::MakeResult(std::move(topo));
+}
+
 katana::Result<std::unique_ptr<katana::FileFrame>>
 WriteEntityTypeIDsArray(
     const katana::NUMAArray<katana::EntityTypeID>& entity_type_id_array) {
@@ -116,6 +277,8 @@ WriteEntityTypeIDsArray(
 
 katana::PropertyGraph::EntityTypeIDArray
 MakeDefaultEntityTypeIDArray(size_t vec_sz) {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kEntityTypeIDs);
   katana::PropertyGraph::EntityTypeIDArray type_ids;
   type_ids.allocateInterleaved(vec_sz);
   katana::ParallelSTL::fill(
@@ -149,6 +312,474 @@ FillBitMask(
   });
 }
 
+/// Build an index from the copy stored under stored_name if there is one that
+/// matches the property, and from the property otherwise
+template <typename node_or_edge>
+katana::Result<void>
+BuildEntityIndex(
+    katana::RDG* rdg, const std::string& stored_name,
+    katana::EntityIndex<node_or_edge>* index) {
+  auto stored = rdg->LoadEntityIndexPrimitive(stored_name);
+  if (stored && !stored.value()) {
+    return index->BuildFromProperty();
+  }
+
+  katana::Result<void> res = katana::ResultSuccess();
+  if (!stored) {
+    res = stored.error();
+  } else {
+    res = index->BuildFromFile(stored.value().value());
+  }
+  if (res) {
+    return katana::ResultSuccess();
+  }
+  KATANA_LOG_WARN(
+      "rebuilding index over {}, its stored copy is unusable: {}",
+      index->property_name(), res.error());
+  rdg->RemoveEntityIndexPrimitive(stored_name);
+  return index->BuildFromProperty();
+}
+
+/// The stored form of index, whose property is property over num_entities
+/// nodes or edges
+template <typename node_or_edge>
+katana::EntityIndexPrimitive
+MakeEntityIndexPrimitive(
+    katana::EntityIndex<node_or_edge>* index, const arrow::Array& property,
+    uint64_t num_entities) {
+  std::vector<uint64_t> ids(std::distance(index->begin(), index->end()));
+  katana::ParallelSTL::copy(index->begin(), index->end(), ids.begin());
+
+  katana::EntityIndexPrimitive primitive;
+  primitive.set_property_type(property.type()->ToString());
+  primitive.set_num_entities(num_entities);
+  primitive.set_ids(std::move(ids));
+  return primitive;
+}
+
+/// The references to a property column held by its table and by the caller
+/// of PatchColumn, and to its only chunk held by the column and by
+/// PatchColumn
+constexpr long kExclusiveRefs = 2;
+
+/// Whether the values of \p data can be written without the change being
+/// seen through another array
+bool
+IsExclusivelyOwned(const std::shared_ptr<arrow::ArrayData>& data) {
+  if (data.use_count() > 1 || data->buffers.size() != 2) {
+    return false;
+  }
+  for (const auto& buffer : data->buffers) {
+    if (buffer && (buffer.use_count() > 1 || !buffer->is_mutable())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \returns how to restore property \p name of \p rdg as it is now, from
+/// \p field and \p column, or by removing it if \p field is null. The
+/// restore is a write of its own, so that transactions that read the undone
+/// value fail to commit.
+katana::TxnContext::UndoFn
+MakePropertyUndo(
+    const std::shared_ptr<katana::RDG>& rdg, bool node, const std::string& name,
+    std::shared_ptr<arrow::Field> field,
+    std::shared_ptr<arrow::ChunkedArray> column) {
+  return [rdg = std::weak_ptr<katana::RDG>(rdg), node, name,
+          field = std::move(field),
+          column = std::move(column)]() -> katana::Result<void> {
+    std::shared_ptr<katana::RDG> graph = rdg.lock();
+    if (!graph) {
+      return katana::ResultSuccess();
+    }
+    std::unique_lock<std::shared_mutex> lock(graph->property_mutex());
+    katana::TxnContext txn_ctx;
+    if (field) {
+      std::shared_ptr<arrow::Table> before =
+          arrow::Table::Make(arrow::schema({field}), {column});
+      return node ? graph->UpsertNodeProperties(before, &txn_ctx)
+                  : graph->UpsertEdgeProperties(before, &txn_ctx);
+    }
+    const std::shared_ptr<arrow::Table>& table =
+        node ? graph->node_properties() : graph->edge_properties();
+    int i = table->schema()->GetFieldIndex(name);
+    if (i == -1) {
+      return katana::ResultSuccess();
+    }
+    return node ? graph->RemoveNodeProperty(i, &txn_ctx)
+                : graph->RemoveEdgeProperty(i, &txn_ctx);
+  };
+}
+
+/// Sets the rows of a fixed-width \p column to \p values. The column is
+/// changed in place if nothing else can see its data. Otherwise its buffers
+/// are copied first, so that a patch never shows through a column that
+/// shares them, and later patches of the copy are in place.
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+PatchColumn(
+    std::shared_ptr<arrow::ChunkedArray> column, const arrow::Array& rows,
+    const arrow::Array& values) {
+  if (rows.type_id() != arrow::Type::UINT64 || rows.null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "rows to patch must be uint64 without nulls, found {}",
+        rows.type()->ToString());
+  }
+  if (rows.length() != values.length()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "expected {} values found {}",
+        rows.length(), values.length());
+  }
+  if (!values.type()->Equals(*column->type())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "patch has type {} but the property has type {}",
+        values.type()->ToString(), column->type()->ToString());
+  }
+  const auto* type =
+      dynamic_cast<const arrow::FixedWidthType*>(column->type().get());
+  const bool is_bool = column->type()->id() == arrow::Type::BOOL;
+  if (!type || (!is_bool && type->bit_width() % 8 != 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "only fixed-width properties can be patched, found {}",
+        column->type()->ToString());
+  }
+
+  const auto& row_ids = static_cast<const arrow::UInt64Array&>(rows);
+  const uint64_t num_rows = column->length();
+  for (int64_t i = 0; i < row_ids.length(); ++i) {
+    if (row_ids.Value(i) >= num_rows) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "row {} is out of range for a property of {} rows", row_ids.Value(i),
+          num_rows);
+    }
+  }
+  if (rows.length() == 0) {
+    return column;
+  }
+
+  std::shared_ptr<arrow::Array> array;
+  bool exclusive = false;
+  if (column->num_chunks() == 1) {
+    array = column->chunk(0);
+    exclusive = column.use_count() <= kExclusiveRefs &&
+                array.use_count() <= kExclusiveRefs &&
+                IsExclusivelyOwned(array->data());
+  } else {
+    // a new concatenation is not seen by anyone else
+    array = KATANA_CHECKED(katana::ParallelConcatenate(column->chunks()));
+    exclusive = true;
+  }
+
+  // A shallow copy, so that the null count is computed anew
+  std::shared_ptr<arrow::ArrayData> data = array->data()->Copy();
+  if (!exclusive) {
+    for (auto& buffer : data->buffers) {
+      if (buffer) {
+        buffer = KATANA_CHECKED(buffer->CopySlice(0, buffer->size()));
+      }
+    }
+  }
+  const int64_t offset = data->offset;
+  if (!data->buffers[0] && values.null_count() > 0) {
+    std::shared_ptr<arrow::Buffer> validity =
+        KATANA_CHECKED(arrow::AllocateBitmap(offset + data->length));
+    arrow::BitUtil::SetBitsTo(
+        validity->mutable_data(), 0, offset + data->length, true);
+    data->buffers[0] = std::move(validity);
+  }
+
+  uint8_t* validity =
+      data->buffers[0] ? data->buffers[0]->mutable_data() : nullptr;
+  uint8_t* out = data->buffers[1]->mutable_data();
+  const uint8_t* in = values.data()->buffers[1]->data();
+  const int64_t in_offset = values.offset();
+  const int64_t width = type->bit_width() / 8;
+  // rows are patched in order, so the last value of a repeated row wins
+  for (int64_t i = 0; i < row_ids.length(); ++i) {
+    const int64_t row = static_cast<int64_t>(row_ids.Value(i)) + offset;
+    if (validity) {
+      arrow::BitUtil::SetBitTo(validity, row, values.IsValid(i));
+    }
+    if (is_bool) {
+      arrow::BitUtil::SetBitTo(
+          out, row, arrow::BitUtil::GetBit(in, in_offset + i));
+    } else {
+      std::memcpy(out + row * width, in + (in_offset + i) * width, width);
+    }
+  }
+  data->null_count = arrow::kUnknownNullCount;
+
+  return std::make_shared<arrow::ChunkedArray>(arrow::MakeArray(data));
+}
+
+/// Gather the rows at indices of every column into a table of single chunk
+/// columns. Fixed byte width columns are gathered in parallel over their
+/// rows, the others with one arrow Take each, in parallel over the columns.
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& columns,
+    const katana::NUMAArray<uint64_t>& indices) {
+  // The indices outlive every Take below, so they need not be copied
+  auto index_array = std::make_shared<arrow::UInt64Array>(
+      indices.size(), arrow::Buffer::Wrap(indices.data(), indices.size()));
+
+  std::vector<arrow::Result<arrow::Datum>> taken(columns.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, columns.size()),
+      [&](size_t i) {
+        if (!katana::IsFixedByteWidth(*columns[i]->type())) {
+          taken[i] = arrow::compute::Take(columns[i], index_array);
+        }
+      },
+      katana::steal(), katana::loopname("TakeRows"));
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> taken_columns;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (katana::IsFixedByteWidth(*columns[i]->type())) {
+      taken_columns.emplace_back(
+          KATANA_CHECKED(katana::ParallelTake(columns[i], indices)));
+      continue;
+    }
+    arrow::Datum datum = KATANA_CHECKED_CONTEXT(
+        std::move(taken[i]), "taking rows of {}", schema->field(i)->name());
+    taken_columns.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        KATANA_CHECKED(katana::Unchunk(datum.chunked_array()))));
+  }
+  return arrow::Table::Make(schema, taken_columns, indices.size());
+}
+
+/// Make an in-memory graph with topology whose node n and edge e have the
+/// entity type and loaded properties of the node and edge whose property
+/// indices in pg are node_rows[n] and edge_rows[e]
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeGraphFromRows(
+    katana::PropertyGraph* pg, katana::GraphTopology&& topology,
+    const katana::NUMAArray<uint64_t>& node_rows,
+    const katana::NUMAArray<uint64_t>& edge_rows) {
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(node_rows.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, node_rows.size()),
+      [&](size_t n) {
+        node_types[n] = pg->GetTypeOfNodeFromPropertyIndex(node_rows[n]);
+      },
+      katana::no_stats());
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(edge_rows.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, edge_rows.size()),
+      [&](size_t e) {
+        edge_types[e] = pg->GetTypeOfEdgeFromPropertyIndex(edge_rows[e]);
+      },
+      katana::no_stats());
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> node_columns;
+  for (int32_t i = 0; i < pg->GetNumNodeProperties(); ++i) {
+    node_columns.emplace_back(pg->GetNodeProperty(i));
+  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> edge_columns;
+  for (int32_t i = 0; i < pg->GetNumEdgeProperties(); ++i) {
+    edge_columns.emplace_back(pg->GetEdgeProperty(i));
+  }
+  auto node_table = KATANA_CHECKED(
+      TakeRows(pg->loaded_node_schema(), node_columns, node_rows));
+  auto edge_table = KATANA_CHECKED(
+      TakeRows(pg->loaded_edge_schema(), edge_columns, edge_rows));
+
+  auto result = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(topology), std::move(node_types), std::move(edge_types),
+      katana::EntityTypeManager(pg->GetNodeTypeManager()),
+      katana::EntityTypeManager(pg->GetEdgeTypeManager())));
+
+  katana::TxnContext txn_ctx;
+  if (node_table->num_columns() > 0) {
+    KATANA_CHECKED(result->AddNodeProperties(node_table, &txn_ctx));
+  }
+  if (edge_table->num_columns() > 0) {
+    KATANA_CHECKED(result->AddEdgeProperties(edge_table, &txn_ctx));
+  }
+  return result;
+}
+
+using Slice = katana::ParquetReader::Slice;
+
+/// Rows per work item when evaluating a predicate in parallel
+constexpr int64_t kFilterBlockSize = int64_t{1} << 16;
+
+/// \returns the row groups of stats, or all rows as one range if stats do
+/// not cover the num_rows rows of the property, e.g., because it was
+/// modified since it was written
+std::vector<Slice>
+RowGroups(
+    const std::vector<katana::RowGroupStatistics>& stats, int64_t num_rows) {
+  std::vector<Slice> row_groups;
+  int64_t covered = 0;
+  for (const auto& row_group : stats) {
+    row_groups.emplace_back(Slice{row_group.offset, row_group.num_rows});
+    covered += row_group.num_rows;
+  }
+  if (stats.empty() || covered != num_rows) {
+    return {Slice{0, num_rows}};
+  }
+  return row_groups;
+}
+
+/// \returns the ranges of rows that may satisfy predicate: the row groups
+/// whose statistics match it, with adjacent ones merged
+std::vector<Slice>
+CandidateRanges(
+    const std::vector<katana::RowGroupStatistics>& stats,
+    const katana::PropertyPredicate& predicate, int64_t num_rows) {
+  std::vector<Slice> row_groups = RowGroups(stats, num_rows);
+  if (row_groups.size() != stats.size()) {
+    return row_groups;
+  }
+  std::vector<Slice> ranges;
+  for (size_t i = 0; i < stats.size(); ++i) {
+    if (!stats[i].MayContain(predicate)) {
+      continue;
+    }
+    if (!ranges.empty() &&
+        ranges.back().offset + ranges.back().length == row_groups[i].offset) {
+      ranges.back().length += row_groups[i].length;
+    } else {
+      ranges.emplace_back(row_groups[i]);
+    }
+  }
+  return ranges;
+}
+
+/// \returns the rows of ranges of the node property name, concatenated:
+/// slices of loaded if the property is loaded, and otherwise read from
+/// storage
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+ReadRanges(
+    const katana::RDG& rdg, const std::shared_ptr<arrow::ChunkedArray>& loaded,
+    const std::string& name, const std::vector<Slice>& ranges) {
+  if (!loaded) {
+    std::shared_ptr<arrow::Table> table =
+        KATANA_CHECKED(rdg.ReadNodePropertyRanges(name, ranges));
+    return table->column(0);
+  }
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  for (const auto& range : ranges) {
+    for (const auto& chunk :
+         loaded->Slice(range.offset, range.length)->chunks()) {
+      chunks.emplace_back(chunk);
+    }
+  }
+  return KATANA_CHECKED(
+      arrow::ChunkedArray::Make(std::move(chunks), loaded->type()));
+}
+
+/// \returns for every value whether it satisfies predicate, or null
+arrow::Result<arrow::Datum>
+EvaluatePredicate(
+    const std::shared_ptr<arrow::Array>& values,
+    const katana::PropertyPredicate& predicate) {
+  arrow::Datum mask;
+  if (predicate.lower) {
+    ARROW_ASSIGN_OR_RAISE(
+        mask, arrow::compute::CallFunction(
+                  "greater_equal",
+                  {values, std::make_shared<arrow::DoubleScalar>(
+                               *predicate.lower)}));
+  }
+  if (predicate.upper) {
+    ARROW_ASSIGN_OR_RAISE(
+        arrow::Datum below, arrow::compute::CallFunction(
+                                "less_equal",
+                                {values, std::make_shared<arrow::DoubleScalar>(
+                                             *predicate.upper)}));
+    if (mask.is_value()) {
+      ARROW_ASSIGN_OR_RAISE(
+          mask, arrow::compute::CallFunction("and", {mask, below}));
+    } else {
+      mask = std::move(below);
+    }
+  }
+  if (!mask.is_value()) {
+    ARROW_ASSIGN_OR_RAISE(
+        mask, arrow::compute::CallFunction("is_valid", {values}));
+  }
+  return mask;
+}
+
+/// Append the rows of [position, position + length) of column that satisfy
+/// predicate to matches, numbering them from row
+arrow::Status
+MatchBlock(
+    const arrow::ChunkedArray& column, int64_t position, int64_t length,
+    katana::GraphTopology::Node row, const katana::PropertyPredicate& predicate,
+    std::vector<katana::GraphTopology::Node>* matches) {
+  for (const auto& chunk : column.Slice(position, length)->chunks()) {
+    ARROW_ASSIGN_OR_RAISE(
+        arrow::Datum mask, EvaluatePredicate(chunk, predicate));
+    const auto& selected =
+        static_cast<const arrow::BooleanArray&>(*mask.make_array());
+    for (int64_t i = 0; i < selected.length(); ++i) {
+      if (selected.IsValid(i) && selected.Value(i)) {
+        matches->emplace_back(row + i);
+      }
+    }
+    row += chunk->length();
+  }
+  return arrow::Status::OK();
+}
+
+/// \returns the rows in ranges that satisfy predicate, whose values are the
+/// rows of ranges concatenated in column
+katana::Result<std::vector<katana::GraphTopology::Node>>
+MatchRows(
+    const std::vector<Slice>& ranges, const arrow::ChunkedArray& column,
+    const katana::PropertyPredicate& predicate) {
+  struct Block {
+    int64_t position;
+    int64_t length;
+    int64_t row;
+  };
+  std::vector<Block> blocks;
+  int64_t position = 0;
+  for (const auto& range : ranges) {
+    for (int64_t begin = 0; begin < range.length; begin += kFilterBlockSize) {
+      blocks.emplace_back(Block{
+          position + begin, std::min(kFilterBlockSize, range.length - begin),
+          range.offset + begin});
+    }
+    position += range.length;
+  }
+
+  std::vector<std::vector<katana::GraphTopology::Node>> matches(blocks.size());
+  std::vector<arrow::Status> statuses(blocks.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, blocks.size()),
+      [&](size_t i) {
+        const Block& block = blocks[i];
+        statuses[i] = MatchBlock(
+            column, block.position, block.length, block.row, predicate,
+            &matches[i]);
+      },
+      katana::steal(), katana::loopname("FilterNodes"));
+
+  size_t num_matches = 0;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    KATANA_CHECKED_CONTEXT(
+        statuses[i], "evaluating predicate on {}", predicate.property_name);
+    num_matches += matches[i].size();
+  }
+  std::vector<katana::GraphTopology::Node> nodes;
+  nodes.reserve(num_matches);
+  for (const auto& block_matches : matches) {
+    nodes.insert(nodes.end(), block_matches.begin(), block_matches.end());
+  }
+  return nodes;
+}
+
 }  // namespace
 
 katana::PropertyGraph::~PropertyGraph() = default;
@@ -157,58 +788,81 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<katana::RDGFile> rdg_file, katana::RDG&& rdg,
     katana::TxnContext* txn_ctx) {
-  // find & map the default csr topology
+  // find the default csr topology
   katana::RDGTopology shadow_csr = katana::RDGTopology::MakeShadowCSR();
   katana::RDGTopology* csr = KATANA_CHECKED_CONTEXT(
-      rdg.GetTopology(shadow_csr),
+      rdg.FindTopology(shadow_csr),
       "unable to find csr topology, must have csr topology to Make a "
       "PropertyGraph");
 
-  KATANA_LOG_DEBUG_ASSERT(CheckTopology(
-      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges()));
-  katana::GraphTopology topo = katana::GraphTopology(
-      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges());
-
-  // The GraphTopology constructor copies all of the required topology data.
-  // Clean up the RDGTopologies memory
-  KATANA_CHECKED(csr->unbind_file_storage());
-
-  if (rdg.IsEntityTypeIDsOutsideProperties()) {
+  // Older storage formats do not record the size of a topology in its
+  // metadata, so those topologies are always loaded right away
+  bool defer_topology = rdg.defer_topology() && csr->num_nodes() != 0;
+  katana::GraphTopology topo;
+  if (!defer_topology) {
+    topo = KATANA_CHECKED(LoadCSRTopology(&rdg));
+  }
+  uint64_t num_nodes = defer_topology ? csr->num_nodes() : topo.NumNodes();
+  uint64_t num_edges = defer_topology ? csr->num_edges() : topo.NumEdges();
+
+  EntityTypeIDArray node_type_ids;
+  EntityTypeIDArray edge_type_ids;
+  EntityTypeManager node_type_manager;
+  EntityTypeManager edge_type_manager;
+  bool types_from_properties = !rdg.IsEntityTypeIDsOutsideProperties();
+  if (!types_from_properties) {
     KATANA_LOG_DEBUG("loading EntityType data from outside properties");
 
-    EntityTypeIDArray node_type_ids = KATANA_CHECKED(MapEntityTypeIDsArray(
-        rdg.node_entity_type_id_array_file_storage(), topo.NumNodes(),
+    node_type_ids = KATANA_CHECKED(MapEntityTypeIDsArray(
+        rdg.node_entity_type_id_array_file_storage(), num_nodes,
         rdg.IsHeaderlessEntityTypeIDArray()));
 
-    EntityTypeIDArray edge_type_ids = KATANA_CHECKED(MapEntityTypeIDsArray(
-        rdg.edge_entity_type_id_array_file_storage(), topo.NumEdges(),
+    edge_type_ids = KATANA_CHECKED(MapEntityTypeIDsArray(
+        rdg.edge_entity_type_id_array_file_storage(), num_edges,
         rdg.IsHeaderlessEntityTypeIDArray()));
 
-    KATANA_ASSERT(topo.NumNodes() == node_type_ids.size());
-    KATANA_ASSERT(topo.NumEdges() == edge_type_ids.size());
+    KATANA_ASSERT(num_nodes == node_type_ids.size());
+    KATANA_ASSERT(num_edges == edge_type_ids.size());
 
-    EntityTypeManager node_type_manager =
-        KATANA_CHECKED(rdg.node_entity_type_manager());
-    EntityTypeManager edge_type_manager =
-        KATANA_CHECKED(rdg.edge_entity_type_manager());
+    node_type_manager = KATANA_CHECKED(rdg.node_entity_type_manager());
+    edge_type_manager = KATANA_CHECKED(rdg.edge_entity_type_manager());
+  } else if (!defer_topology) {
+    // we must construct id_arrays and managers from properties
+    node_type_ids = MakeDefaultEntityTypeIDArray(num_nodes);
+    edge_type_ids = MakeDefaultEntityTypeIDArray(num_edges);
+  }
 
-    return std::make_unique<PropertyGraph>(
+  std::unique_ptr<PropertyGraph> pg;
+  if (!defer_topology) {
+    pg = std::make_unique<PropertyGraph>(
         std::move(rdg_file), std::move(rdg), std::move(topo),
         std::move(node_type_ids), std::move(edge_type_ids),
         std::move(node_type_manager), std::move(edge_type_manager));
   } else {
-    // we must construct id_arrays and managers from properties
-
-    auto pg = std::make_unique<PropertyGraph>(
-        std::move(rdg_file), std::move(rdg), std::move(topo),
-        MakeDefaultEntityTypeIDArray(topo.NumNodes()),
-        MakeDefaultEntityTypeIDArray(topo.NumEdges()), EntityTypeManager{},
-        EntityTypeManager{});
+    // The graph is made empty and given its sizes and type IDs afterwards,
+    // once its default topology knows how large it is going to be
+    pg = std::make_unique<PropertyGraph>(
+        std::move(rdg_file), std::move(rdg), katana::GraphTopology{},
+        EntityTypeIDArray{}, EntityTypeIDArray{}, std::move(node_type_manager),
+        std::move(edge_type_manager));
+    pg->pg_view_cache_.DeferDefaultTopology(
+        num_nodes, num_edges,
+        [rdg = pg->rdg_]() { return LoadCSRTopology(rdg.get()); });
+    if (!types_from_properties) {
+      pg->node_entity_type_ids_ =
+          std::make_shared<EntityTypeIDArray>(std::move(node_type_ids));
+      pg->node_entity_data_ = pg->node_entity_type_ids_->data();
+      pg->edge_entity_type_ids_ =
+          std::make_shared<EntityTypeIDArray>(std::move(edge_type_ids));
+      pg->edge_entity_data_ = pg->edge_entity_type_ids_->data();
+    }
+  }
 
+  if (types_from_properties) {
     KATANA_CHECKED(pg->ConstructEntityTypeIDs(txn_ctx));
-
-    return MakeResult(std::move(pg));
   }
+
+  return MakeResult(std::move(pg));
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -406,25 +1060,19 @@ katana::PropertyGraph::MakeProjectedGraph(
       original_to_projected_nodes_mapping[src] = 1;
     });
   } else {
-    katana::ParallelSTL::fill(
-        original_to_projected_nodes_mapping.begin(),
-        original_to_projected_nodes_mapping.end(), Node{0});
-
-    katana::GAccumulator<uint32_t> accum_num_new_nodes;
+    // The nodes of a type are cached as a bitmap, so the union is an or of
+    // words
+    for (auto type : node_types.value()) {
+      bitset_nodes.bitwise_or(
+          *pg.pg_view_cache_.BuildOrGetNodeTypeBitmap(&pg, type));
+    }
+    num_new_nodes = bitset_nodes.count();
 
     katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
-      for (auto type : node_types.value()) {
-        if (pg.DoesNodeHaveType(src, type)) {
-          accum_num_new_nodes += 1;
-          bitset_nodes.set(src);
-          // this sets the corresponding entry in the array to 1
-          // will perform a prefix sum on this array later on
-          original_to_projected_nodes_mapping[src] = 1;
-          return;
-        }
-      }
+      // this sets the corresponding entry in the array to 1
+      // will perform a prefix sum on this array later on
+      original_to_projected_nodes_mapping[src] = bitset_nodes.test(src);
     });
-    num_new_nodes = accum_num_new_nodes.reduce();
 
     if (num_new_nodes == 0) {
       // no nodes selected;
@@ -617,22 +1265,22 @@ katana::PropertyGraph::Validate() {
   //  return ErrorCode::InvalidArgument;
   //}
 
-  uint64_t num_node_rows =
-      static_cast<uint64_t>(rdg_->node_properties()->num_rows());
+  std::shared_ptr<arrow::Table> node_props = LoadedNodeProperties();
+  uint64_t num_node_rows = static_cast<uint64_t>(node_props->num_rows());
   if (num_node_rows == 0) {
-    if ((rdg_->node_properties()->num_columns() != 0) && (NumNodes() != 0)) {
+    if ((node_props->num_columns() != 0) && (NumNodes() != 0)) {
       return KATANA_ERROR(
           ErrorCode::AssertionFailed,
           "number of rows in node properties is 0 but "
           "the number of node properties is {} and the number of nodes is {}",
-          rdg_->node_properties()->num_columns(), NumNodes());
+          node_props->num_columns(), NumNodes());
     }
   } else if (num_node_rows != NumNodes()) {
     return KATANA_ERROR(
         ErrorCode::AssertionFailed,
         "number of rows in node properties {} differs "
         "from the number of nodes {}",
-        rdg_->node_properties()->num_rows(), NumNodes());
+        node_props->num_rows(), NumNodes());
   }
 
   if (NumNodes() != node_entity_type_ids_->size()) {
@@ -651,22 +1299,22 @@ katana::PropertyGraph::Validate() {
         NumEdges(), edge_entity_type_ids_->size());
   }
 
-  uint64_t num_edge_rows =
-      static_cast<uint64_t>(rdg_->edge_properties()->num_rows());
+  std::shared_ptr<arrow::Table> edge_props = LoadedEdgeProperties();
+  uint64_t num_edge_rows = static_cast<uint64_t>(edge_props->num_rows());
   if (num_edge_rows == 0) {
-    if ((rdg_->edge_properties()->num_columns() != 0) && (NumEdges() != 0)) {
+    if ((edge_props->num_columns() != 0) && (NumEdges() != 0)) {
       return KATANA_ERROR(
           ErrorCode::AssertionFailed,
           "number of rows in edge properties is 0 but "
           "the number of edge properties is {} and the number of edges is {}",
-          rdg_->edge_properties()->num_columns(), NumEdges());
+          edge_props->num_columns(), NumEdges());
     }
   } else if (num_edge_rows != NumEdges()) {
     return KATANA_ERROR(
         ErrorCode::AssertionFailed,
         "number of rows in edge properties {} differs "
         "from the number of edges {}",
-        rdg_->edge_properties()->num_rows(), NumEdges());
+        edge_props->num_rows(), NumEdges());
   }
 
   return katana::ResultSuccess();
@@ -676,6 +1324,8 @@ katana::PropertyGraph::Validate() {
 /// Only call this if every uint8/bool property should be considered a type
 katana::Result<void>
 katana::PropertyGraph::ConstructEntityTypeIDs(katana::TxnContext* txn_ctx) {
+  katana::MemoryCategoryScope category_scope(
+      katana::MemoryCategory::kEntityTypeIDs);
   // only relevant to actually construct when EntityTypeIDs are expected in properties
   // when EntityTypeIDs are not expected in properties then we have nothing to do here
   KATANA_LOG_WARN("Loading types from properties.");
@@ -692,9 +1342,10 @@ katana::PropertyGraph::ConstructEntityTypeIDs(katana::TxnContext* txn_ctx) {
   node_entity_type_ids_ = std::make_shared<EntityTypeIDArray>();
   node_entity_type_ids_->allocateInterleaved(NumNodes());
   node_entity_data_ = node_entity_type_ids_->data();
+  pg_view_cache_.DropNodeTypeBitmaps();
   auto node_props_to_remove =
       KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
-          NumNodes(), rdg_->node_properties(), node_entity_type_manager_.get(),
+          NumNodes(), LoadedNodeProperties(), node_entity_type_manager_.get(),
           node_entity_type_ids_.get()));
   for (const auto& node_prop : node_props_to_remove) {
     KATANA_CHECKED(RemoveNodeProperty(node_prop, txn_ctx));
@@ -715,7 +1366,7 @@ katana::PropertyGraph::ConstructEntityTypeIDs(katana::TxnContext* txn_ctx) {
   edge_entity_data_ = edge_entity_type_ids_->data();
   auto edge_props_to_remove =
       KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
-          NumEdges(), rdg_->edge_properties(), edge_entity_type_manager_.get(),
+          NumEdges(), LoadedEdgeProperties(), edge_entity_type_manager_.get(),
           edge_entity_type_ids_.get()));
   for (const auto& edge_prop : edge_props_to_remove) {
     KATANA_CHECKED(RemoveEdgeProperty(edge_prop, txn_ctx));
@@ -763,17 +1414,53 @@ katana::PropertyGraph::DoWriteTopologies() {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::PropertyGraph::DoWriteEntityIndexes() {
+  // Projections share the RDG of their parent but not its ids
+  if (IsTransformed()) {
+    return katana::ResultSuccess();
+  }
+
+  for (const auto& index : node_indexes_) {
+    std::string name =
+        EntityIndexPrimitive::NodeIndexName(index->property_name());
+    if (rdg_->HasEntityIndexPrimitive(name)) {
+      continue;
+    }
+    auto property = KATANA_CHECKED(GetNodeProperty(index->property_name()));
+    EntityIndexPrimitive primitive =
+        MakeEntityIndexPrimitive(index.get(), *property->chunk(0), NumNodes());
+    rdg_->UpsertEntityIndexPrimitive(name, std::move(primitive));
+  }
+
+  for (const auto& index : edge_indexes_) {
+    std::string name =
+        EntityIndexPrimitive::EdgeIndexName(index->property_name());
+    if (rdg_->HasEntityIndexPrimitive(name)) {
+      continue;
+    }
+    auto property = KATANA_CHECKED(GetEdgeProperty(index->property_name()));
+    EntityIndexPrimitive primitive =
+        MakeEntityIndexPrimitive(index.get(), *property->chunk(0), NumEdges());
+    rdg_->UpsertEntityIndexPrimitive(name, std::move(primitive));
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::PropertyGraph::DoWrite(
     katana::RDGHandle handle, const std::string& command_line,
     katana::RDG::RDGVersioningPolicy versioning_action,
-    katana::TxnContext* txn_ctx) {
+    katana::TxnContext* txn_ctx,
+    std::shared_future<CopyableResult<void>>* pending) {
   KATANA_LOG_DEBUG(
       " node array valid: {}, edge array valid: {}",
       rdg_->node_entity_type_id_array_file_storage().Valid(),
       rdg_->edge_entity_type_id_array_file_storage().Valid());
 
   KATANA_CHECKED(DoWriteTopologies());
+  KATANA_CHECKED(DoWriteEntityIndexes());
 
   //TODO(emcginnis): we don't actually have any lifetime tracking for the in memory
   // entity_type_id arrays, which means we don't actually know when the array
@@ -785,18 +1472,29 @@ katana::PropertyGraph::DoWrite(
   std::unique_ptr<katana::FileFrame> edge_entity_type_id_array_res =
       KATANA_CHECKED(WriteEntityTypeIDsArray(*edge_entity_type_ids_));
 
-  return rdg_->Store(
+  // The stored tables are snapshotted here; later changes replace them
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  if (pending == nullptr) {
+    return rdg_->Store(
+        handle, command_line, versioning_action,
+        std::move(node_entity_type_id_array_res),
+        std::move(edge_entity_type_id_array_res), GetNodeTypeManager(),
+        GetEdgeTypeManager(), txn_ctx);
+  }
+  *pending = KATANA_CHECKED(rdg_->StoreAsync(
       handle, command_line, versioning_action,
       std::move(node_entity_type_id_array_res),
       std::move(edge_entity_type_id_array_res), GetNodeTypeManager(),
-      GetEdgeTypeManager(), txn_ctx);
+      GetEdgeTypeManager(), txn_ctx));
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::ConductWriteOp(
     const std::string& uri, const std::string& command_line,
     katana::RDG::RDGVersioningPolicy versioning_action,
-    katana::TxnContext* txn_ctx) {
+    katana::TxnContext* txn_ctx,
+    std::shared_future<CopyableResult<void>>* pending) {
   katana::RDGManifest manifest =
       KATANA_CHECKED(katana::FindManifest(uri, txn_ctx));
 
@@ -804,7 +1502,8 @@ katana::PropertyGraph::ConductWriteOp(
       KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadWrite));
   auto new_file = std::make_unique<katana::RDGFile>(rdg_handle);
 
-  KATANA_CHECKED(DoWrite(*new_file, command_line, versioning_action, txn_ctx));
+  KATANA_CHECKED(DoWrite(
+      *new_file, command_line, versioning_action, txn_ctx, pending));
 
   file_ = std::move(new_file);
 
@@ -848,6 +1547,30 @@ katana::PropertyGraph::Commit(
       txn_ctx);
 }
 
+katana::Result<std::shared_future<katana::CopyableResult<void>>>
+katana::PropertyGraph::CommitAsync(
+    const std::string& command_line, katana::TxnContext* txn_ctx) {
+  if (IsTransformed()) {
+    return parent_->CommitAsync(command_line, txn_ctx);
+  }
+
+  std::shared_future<CopyableResult<void>> writes;
+  if (file_ == nullptr) {
+    if (rdg_->rdg_dir().empty()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "RDG commit but rdg_dir_ is empty");
+    }
+    KATANA_CHECKED(ConductWriteOp(
+        rdg_->rdg_dir().string(), command_line,
+        katana::RDG::RDGVersioningPolicy::IncrementVersion, txn_ctx, &writes));
+  } else {
+    KATANA_CHECKED(DoWrite(
+        *file_, command_line,
+        katana::RDG::RDGVersioningPolicy::IncrementVersion, txn_ctx, &writes));
+  }
+  return MakeResult(std::move(writes));
+}
+
 katana::Result<void>
 katana::PropertyGraph::WriteView(
     const std::string& command_line, katana::TxnContext* txn_ctx) {
@@ -903,10 +1626,12 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
     }
   }
 
-  const auto& node_props = rdg_->node_properties();
-  const auto& edge_props = rdg_->edge_properties();
-  const auto& other_node_props = other->rdg_->node_properties();
-  const auto& other_edge_props = other->rdg_->edge_properties();
+  std::shared_ptr<arrow::Table> node_props = LoadedNodeProperties();
+  std::shared_ptr<arrow::Table> edge_props = LoadedEdgeProperties();
+  std::shared_ptr<arrow::Table> other_node_props =
+      other->LoadedNodeProperties();
+  std::shared_ptr<arrow::Table> other_edge_props =
+      other->LoadedEdgeProperties();
   if (node_props->num_columns() != other_node_props->num_columns()) {
     return false;
   }
@@ -1026,10 +1751,12 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
     fmt::format_to(std::back_inserter(buf), "edge_entity_type_ids Match!\n");
   }
 
-  const auto& node_props = rdg_->node_properties();
-  const auto& edge_props = rdg_->edge_properties();
-  const auto& other_node_props = other->rdg_->node_properties();
-  const auto& other_edge_props = other->rdg_->edge_properties();
+  std::shared_ptr<arrow::Table> node_props = LoadedNodeProperties();
+  std::shared_ptr<arrow::Table> edge_props = LoadedEdgeProperties();
+  std::shared_ptr<arrow::Table> other_node_props =
+      other->LoadedNodeProperties();
+  std::shared_ptr<arrow::Table> other_edge_props =
+      other->LoadedEdgeProperties();
   if (node_props->num_columns() != other_node_props->num_columns()) {
     fmt::format_to(
         std::back_inserter(buf), "Number of node properties differ {} vs. {}\n",
@@ -1094,14 +1821,34 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
 
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
-  auto ret = rdg_->node_properties()->GetColumnByName(name);
+  std::shared_ptr<arrow::ChunkedArray> ret;
+  {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
+    ret = rdg_->node_properties()->GetColumnByName(name);
+  }
   if (ret) {
+    if (property_unloading_) {
+      PropertyUnloadManager::Get().PropertyUsed(
+          rdg_.get(), PropertyUnloadManager::PropertyKind::kNode, name);
+    }
     return MakeResult(std::move(ret));
   }
   return KATANA_ERROR(
       ErrorCode::PropertyNotFound, "node property does not exist: {}", name);
 }
 
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::GetNodeProperty(
+    const std::string& name, katana::TxnContext* txn_ctx) const {
+  const std::string& rdg_dir = rdg_->rdg_dir().string();
+  if (auto snapshot = txn_ctx->NodePropertySnapshot(rdg_dir, name)) {
+    return MakeResult(std::move(snapshot));
+  }
+  auto column = KATANA_CHECKED(GetNodeProperty(name));
+  txn_ctx->InsertNodePropertySnapshot(rdg_dir, name, column);
+  return MakeResult(std::move(column));
+}
+
 katana::Result<katana::URI>
 katana::PropertyGraph::GetNodePropertyStorageLocation(
     const std::string& name) const {
@@ -1110,14 +1857,34 @@ katana::PropertyGraph::GetNodePropertyStorageLocation(
 
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
-  auto ret = rdg_->edge_properties()->GetColumnByName(name);
+  std::shared_ptr<arrow::ChunkedArray> ret;
+  {
+    std::shared_lock<std::shared_mutex> lock(property_mutex());
+    ret = rdg_->edge_properties()->GetColumnByName(name);
+  }
   if (ret) {
+    if (property_unloading_) {
+      PropertyUnloadManager::Get().PropertyUsed(
+          rdg_.get(), PropertyUnloadManager::PropertyKind::kEdge, name);
+    }
     return MakeResult(std::move(ret));
   }
   return KATANA_ERROR(
       ErrorCode::PropertyNotFound, "edge property does not exist: {}", name);
 }
 
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::GetEdgeProperty(
+    const std::string& name, katana::TxnContext* txn_ctx) const {
+  const std::string& rdg_dir = rdg_->rdg_dir().string();
+  if (auto snapshot = txn_ctx->EdgePropertySnapshot(rdg_dir, name)) {
+    return MakeResult(std::move(snapshot));
+  }
+  auto column = KATANA_CHECKED(GetEdgeProperty(name));
+  txn_ctx->InsertEdgePropertySnapshot(rdg_dir, name, column);
+  return MakeResult(std::move(column));
+}
+
 katana::Result<katana::URI>
 katana::PropertyGraph::GetEdgePropertyStorageLocation(
     const std::string& name) const {
@@ -1163,7 +1930,12 @@ katana::PropertyGraph::AddNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalNodes(), props->num_rows());
   }
-  return rdg_->AddNodeProperties(props, txn_ctx);
+  // Properties are single chunk columns, which is what views expect
+  std::shared_ptr<arrow::Table> unchunked =
+      KATANA_CHECKED(katana::UnchunkTable(props));
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  KATANA_CHECKED(BeginNodePropertyWrites(unchunked->ColumnNames(), txn_ctx));
+  return rdg_->AddNodeProperties(unchunked, txn_ctx);
 }
 
 katana::Result<void>
@@ -1178,42 +1950,172 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalNodes(), props->num_rows());
   }
-  return rdg_->UpsertNodeProperties(props, txn_ctx);
+  // Properties are single chunk columns, which is what views expect
+  std::shared_ptr<arrow::Table> unchunked =
+      KATANA_CHECKED(katana::UnchunkTable(props));
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  KATANA_CHECKED(BeginNodePropertyWrites(unchunked->ColumnNames(), txn_ctx));
+  for (const auto& name : unchunked->ColumnNames()) {
+    DropNodeIndex(name);
+  }
+  return rdg_->UpsertNodeProperties(unchunked, txn_ctx);
+}
+
+katana::Result<void>
+katana::PropertyGraph::PatchNodeProperty(
+    const std::string& name, const std::shared_ptr<arrow::Array>& rows,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  // the read, the patch and the upsert are one write
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  std::shared_ptr<arrow::Field> field =
+      rdg_->node_properties()->schema()->GetFieldByName(name);
+  if (!field) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no node property {}", name);
+  }
+  KATANA_CHECKED(BeginNodePropertyWrites({name}, txn_ctx));
+  std::shared_ptr<arrow::ChunkedArray> column =
+      rdg_->node_properties()->GetColumnByName(name);
+  std::shared_ptr<arrow::ChunkedArray> patched = KATANA_CHECKED_CONTEXT(
+      PatchColumn(std::move(column), *rows, *values),
+      "patching node property {}", name);
+  DropNodeIndex(name);
+  return rdg_->UpsertNodeProperties(
+      arrow::Table::Make(arrow::schema({field}), {patched}), txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i, katana::TxnContext* txn_ctx) {
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  if (i >= 0 && i < rdg_->node_properties()->num_columns()) {
+    std::string name = rdg_->node_properties()->field(i)->name();
+    KATANA_CHECKED(BeginNodePropertyWrites({name}, txn_ctx));
+    DropNodeIndex(name);
+  }
   return rdg_->RemoveNodeProperty(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(
     const std::string& prop_name, katana::TxnContext* txn_ctx) {
-  auto col_names = rdg_->node_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_->RemoveNodeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  int i = rdg_->node_properties()->schema()->GetFieldIndex(prop_name);
+  if (i == -1) {
+    return katana::ErrorCode::PropertyNotFound;
   }
-  return katana::ErrorCode::PropertyNotFound;
+  KATANA_CHECKED(BeginNodePropertyWrites({prop_name}, txn_ctx));
+  DropNodeIndex(prop_name);
+  return rdg_->RemoveNodeProperty(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadNodeProperty(const std::string& name, int i) {
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
   return rdg_->LoadNodeProperty(name, i);
 }
 /// Load a node property by name if it is absent and append its column to
 /// the table do nothing otherwise
 katana::Result<void>
 katana::PropertyGraph::EnsureNodePropertyLoaded(const std::string& name) {
+  KATANA_CHECKED(FinishPrefetch());
+  if (property_unloading_) {
+    PropertyUnloadManager::Get().PropertyUsed(
+        rdg_.get(), PropertyUnloadManager::PropertyKind::kNode, name);
+  }
   if (HasNodeProperty(name)) {
     return katana::ResultSuccess();
   }
-  return LoadNodeProperty(name);
+  if (property_unloading_) {
+    // make room for the property before loading it
+    MemorySupervisor::Get().CheckPressure();
+  }
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  if (rdg_->node_properties()->schema()->GetFieldIndex(name) != -1) {
+    // another thread loaded it meanwhile
+    return katana::ResultSuccess();
+  }
+  return rdg_->LoadNodeProperty(name);
+}
+
+katana::Result<std::vector<katana::PropertyGraph::Node>>
+katana::PropertyGraph::FilterNodes(const PropertyPredicate& predicate) {
+  KATANA_CHECKED(FinishPrefetch());
+  const std::string& name = predicate.property_name;
+  std::shared_lock<std::shared_mutex> lock(property_mutex());
+  std::vector<katana::RowGroupStatistics> stats =
+      KATANA_CHECKED(rdg_->GetNodePropertyStatistics(name));
+  std::shared_ptr<arrow::ChunkedArray> loaded =
+      rdg_->node_properties()->GetColumnByName(name);
+  if (loaded) {
+    if (!katana::HasRowGroupStatistics(*loaded->type())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "property {} of type {} is not numeric",
+          name, loaded->type()->ToString());
+    }
+  }
+
+  std::vector<Slice> ranges = CandidateRanges(stats, predicate, NumNodes());
+  std::shared_ptr<arrow::ChunkedArray> values =
+      KATANA_CHECKED(ReadRanges(*rdg_, loaded, name, ranges));
+  if (!katana::HasRowGroupStatistics(*values->type())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "property {} of type {} is not numeric",
+        name, values->type()->ToString());
+  }
+  return MatchRows(ranges, *values, predicate);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::PropertyGraph::LoadNodeProperty(
+    const std::string& name, const PropertyPredicate& predicate) {
+  std::vector<Node> nodes = KATANA_CHECKED(FilterNodes(predicate));
+  std::shared_lock<std::shared_mutex> lock(property_mutex());
+  std::vector<katana::RowGroupStatistics> stats =
+      KATANA_CHECKED(rdg_->GetNodePropertyStatistics(name));
+  std::shared_ptr<arrow::ChunkedArray> loaded =
+      rdg_->node_properties()->GetColumnByName(name);
+
+  // read only the rows of the row groups of name from the first to the last
+  // node they hold, and index the nodes in what is read
+  std::vector<Slice> ranges;
+  katana::NUMAArray<uint64_t> indices;
+  indices.allocateInterleaved(nodes.size());
+  auto node = nodes.begin();
+  uint64_t position = 0;
+  for (const auto& row_group : RowGroups(stats, NumNodes())) {
+    int64_t end = row_group.offset + row_group.length;
+    if (node == nodes.end() || static_cast<int64_t>(*node) >= end) {
+      continue;
+    }
+    Slice range{static_cast<int64_t>(*node), 0};
+    for (; node != nodes.end() && static_cast<int64_t>(*node) < end; ++node) {
+      indices[node - nodes.begin()] = position + (*node - range.offset);
+      range.length = *node - range.offset + 1;
+    }
+    position += range.length;
+    ranges.emplace_back(range);
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> values =
+      KATANA_CHECKED(ReadRanges(*rdg_, loaded, name, ranges));
+  auto schema = arrow::schema({arrow::field(name, values->type())});
+  std::shared_ptr<arrow::Table> taken =
+      KATANA_CHECKED(TakeRows(schema, {values}, indices));
+
+  arrow::UInt32Builder node_builder;
+  KATANA_CHECKED(node_builder.AppendValues(nodes));
+  std::shared_ptr<arrow::Array> node_array =
+      KATANA_CHECKED(node_builder.Finish());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("node", arrow::uint32()), schema->field(0)}),
+      {std::make_shared<arrow::ChunkedArray>(node_array), taken->column(0)},
+      nodes.size());
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadNodeProperty(const std::string& prop_name) {
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
   return rdg_->UnloadNodeProperty(prop_name);
 }
 
@@ -1229,7 +2131,12 @@ katana::PropertyGraph::AddEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalEdges(), props->num_rows());
   }
-  return rdg_->AddEdgeProperties(props, txn_ctx);
+  // Properties are single chunk columns, which is what views expect
+  std::shared_ptr<arrow::Table> unchunked =
+      KATANA_CHECKED(katana::UnchunkTable(props));
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  KATANA_CHECKED(BeginEdgePropertyWrites(unchunked->ColumnNames(), txn_ctx));
+  return rdg_->AddEdgeProperties(unchunked, txn_ctx);
 }
 
 katana::Result<void>
@@ -1244,33 +2151,73 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalEdges(), props->num_rows());
   }
-  return rdg_->UpsertEdgeProperties(props, txn_ctx);
+  // Properties are single chunk columns, which is what views expect
+  std::shared_ptr<arrow::Table> unchunked =
+      KATANA_CHECKED(katana::UnchunkTable(props));
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  KATANA_CHECKED(BeginEdgePropertyWrites(unchunked->ColumnNames(), txn_ctx));
+  for (const auto& name : unchunked->ColumnNames()) {
+    DropEdgeIndex(name);
+  }
+  return rdg_->UpsertEdgeProperties(unchunked, txn_ctx);
+}
+
+katana::Result<void>
+katana::PropertyGraph::PatchEdgeProperty(
+    const std::string& name, const std::shared_ptr<arrow::Array>& rows,
+    const std::shared_ptr<arrow::Array>& values, katana::TxnContext* txn_ctx) {
+  // the read, the patch and the upsert are one write
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  std::shared_ptr<arrow::Field> field =
+      rdg_->edge_properties()->schema()->GetFieldByName(name);
+  if (!field) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}", name);
+  }
+  KATANA_CHECKED(BeginEdgePropertyWrites({name}, txn_ctx));
+  std::shared_ptr<arrow::ChunkedArray> column =
+      rdg_->edge_properties()->GetColumnByName(name);
+  std::shared_ptr<arrow::ChunkedArray> patched = KATANA_CHECKED_CONTEXT(
+      PatchColumn(std::move(column), *rows, *values),
+      "patching edge property {}", name);
+  DropEdgeIndex(name);
+  return rdg_->UpsertEdgeProperties(
+      arrow::Table::Make(arrow::schema({field}), {patched}), txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i, katana::TxnContext* txn_ctx) {
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  if (i >= 0 && i < rdg_->edge_properties()->num_columns()) {
+    std::string name = rdg_->edge_properties()->field(i)->name();
+    KATANA_CHECKED(BeginEdgePropertyWrites({name}, txn_ctx));
+    DropEdgeIndex(name);
+  }
   return rdg_->RemoveEdgeProperty(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(
     const std::string& prop_name, katana::TxnContext* txn_ctx) {
-  auto col_names = rdg_->edge_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_->RemoveEdgeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  int i = rdg_->edge_properties()->schema()->GetFieldIndex(prop_name);
+  if (i == -1) {
+    return katana::ErrorCode::PropertyNotFound;
   }
-  return katana::ErrorCode::PropertyNotFound;
+  KATANA_CHECKED(BeginEdgePropertyWrites({prop_name}, txn_ctx));
+  DropEdgeIndex(prop_name);
+  return rdg_->RemoveEdgeProperty(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadEdgeProperty(const std::string& prop_name) {
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
   return rdg_->UnloadEdgeProperty(prop_name);
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
   return rdg_->LoadEdgeProperty(name, i);
 }
 
@@ -1278,15 +2225,132 @@ katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
 /// the table do nothing otherwise
 katana::Result<void>
 katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
+  KATANA_CHECKED(FinishPrefetch());
+  if (property_unloading_) {
+    PropertyUnloadManager::Get().PropertyUsed(
+        rdg_.get(), PropertyUnloadManager::PropertyKind::kEdge, name);
+  }
   if (HasEdgeProperty(name)) {
     return katana::ResultSuccess();
   }
-  return LoadEdgeProperty(name);
+  if (property_unloading_) {
+    // make room for the property before loading it
+    MemorySupervisor::Get().CheckPressure();
+  }
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  if (rdg_->edge_properties()->schema()->GetFieldIndex(name) != -1) {
+    // another thread loaded it meanwhile
+    return katana::ResultSuccess();
+  }
+  return rdg_->LoadEdgeProperty(name);
+}
+
+void
+katana::PropertyGraph::EnablePropertyUnloading() {
+  PropertyUnloadManager::Get().Watch(rdg_);
+  property_unloading_ = true;
+}
+
+void
+katana::PropertyGraph::PinNodeProperty(const std::string& name) {
+  PropertyUnloadManager::Get().Pin(
+      rdg_.get(), PropertyUnloadManager::PropertyKind::kNode, name);
+}
+
+void
+katana::PropertyGraph::UnpinNodeProperty(const std::string& name) {
+  PropertyUnloadManager::Get().Unpin(
+      rdg_.get(), PropertyUnloadManager::PropertyKind::kNode, name);
+}
+
+void
+katana::PropertyGraph::PinEdgeProperty(const std::string& name) {
+  PropertyUnloadManager::Get().Pin(
+      rdg_.get(), PropertyUnloadManager::PropertyKind::kEdge, name);
+}
+
+void
+katana::PropertyGraph::UnpinEdgeProperty(const std::string& name) {
+  PropertyUnloadManager::Get().Unpin(
+      rdg_.get(), PropertyUnloadManager::PropertyKind::kEdge, name);
+}
+
+katana::Result<void>
+katana::PropertyGraph::PrefetchProperties(
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties) {
+  // the reads add their columns to the property tables when they finish
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  auto not_requested = [](const std::vector<std::string>& pending) {
+    return [&pending](const std::string& name) {
+      return std::find(pending.begin(), pending.end(), name) == pending.end();
+    };
+  };
+
+  std::vector<std::string> node_names;
+  std::copy_if(
+      node_properties.begin(), node_properties.end(),
+      std::back_inserter(node_names),
+      not_requested(prefetching_node_properties_));
+  std::vector<std::string> edge_names;
+  std::copy_if(
+      edge_properties.begin(), edge_properties.end(),
+      std::back_inserter(edge_names),
+      not_requested(prefetching_edge_properties_));
+
+  if (node_names.empty() && edge_names.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  // Reads that were issued but not recorded as pending would be issued again
+  // by a retry, so every name is checked before the first read
+  auto check_stored = [](const std::vector<std::string>& names,
+                         const std::vector<std::string>& stored,
+                         const char* kind) -> katana::Result<void> {
+    for (const auto& name : names) {
+      if (std::find(stored.begin(), stored.end(), name) == stored.end()) {
+        return KATANA_ERROR(
+            ErrorCode::PropertyNotFound, "no {} property named {}", kind,
+            name);
+      }
+    }
+    return katana::ResultSuccess();
+  };
+  KATANA_CHECKED(
+      check_stored(node_names, rdg_->ListFullNodeProperties(), "node"));
+  KATANA_CHECKED(
+      check_stored(edge_names, rdg_->ListFullEdgeProperties(), "edge"));
+
+  if (!prefetch_group_) {
+    prefetch_group_ = KATANA_CHECKED(ReadGroup::Make());
+  }
+  KATANA_CHECKED(
+      rdg_->PrefetchNodeProperties(node_names, prefetch_group_.get()));
+  prefetching_node_properties_.insert(
+      prefetching_node_properties_.end(), node_names.begin(), node_names.end());
+  KATANA_CHECKED(
+      rdg_->PrefetchEdgeProperties(edge_names, prefetch_group_.get()));
+  prefetching_edge_properties_.insert(
+      prefetching_edge_properties_.end(), edge_names.begin(), edge_names.end());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::FinishPrefetch() {
+  std::unique_lock<std::shared_mutex> lock(property_mutex());
+  if (!prefetch_group_) {
+    return katana::ResultSuccess();
+  }
+  std::unique_ptr<ReadGroup> grp = std::move(prefetch_group_);
+  prefetching_node_properties_.clear();
+  prefetching_edge_properties_.clear();
+  return grp->Finish();
 }
 
 // Build an index over nodes.
 katana::Result<void>
-katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
+katana::PropertyGraph::MakeNodeIndex(
+    const std::string& property_name, EntityIndexKind kind) {
   for (const auto& existing_index : node_indexes_) {
     if (existing_index->property_name() == property_name) {
       return KATANA_ERROR(
@@ -1304,9 +2368,15 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
   // Create an index based on the type of the field.
   std::shared_ptr<katana::EntityIndex<GraphTopology::Node>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Node>(
-          property_name, NumNodes(), property));
+          property_name, NumNodes(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  if (IsTransformed()) {
+    KATANA_CHECKED(index->BuildFromProperty());
+  } else {
+    KATANA_CHECKED(BuildEntityIndex(
+        rdg_.get(), EntityIndexPrimitive::NodeIndexName(property_name),
+        index.get()));
+  }
 
   node_indexes_.push_back(std::move(index));
 
@@ -1317,7 +2387,7 @@ katana::Result<void>
 katana::PropertyGraph::DeleteNodeIndex(const std::string& property_name) {
   for (auto it = node_indexes_.begin(); it != node_indexes_.end(); it++) {
     if ((*it)->property_name() == property_name) {
-      node_indexes_.erase(it);
+      DropNodeIndex(property_name);
       return katana::ResultSuccess();
     }
   }
@@ -1331,7 +2401,8 @@ katana::PropertyGraph::DeleteNodeIndex(const std::string& property_name) {
 
 // Build an index over edges.
 katana::Result<void>
-katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
+katana::PropertyGraph::MakeEdgeIndex(
+    const std::string& property_name, EntityIndexKind kind) {
   for (const auto& existing_index : edge_indexes_) {
     if (existing_index->property_name() == property_name) {
       return KATANA_ERROR(
@@ -1349,9 +2420,15 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
   // Create an index based on the type of the field.
   std::unique_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Edge>(
-          property_name, NumEdges(), property));
+          property_name, NumEdges(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  if (IsTransformed()) {
+    KATANA_CHECKED(index->BuildFromProperty());
+  } else {
+    KATANA_CHECKED(BuildEntityIndex(
+        rdg_.get(), EntityIndexPrimitive::EdgeIndexName(property_name),
+        index.get()));
+  }
 
   edge_indexes_.push_back(std::move(index));
 
@@ -1362,13 +2439,91 @@ katana::Result<void>
 katana::PropertyGraph::DeleteEdgeIndex(const std::string& property_name) {
   for (auto it = edge_indexes_.begin(); it != edge_indexes_.end(); it++) {
     if ((*it)->property_name() == property_name) {
-      edge_indexes_.erase(it);
+      DropEdgeIndex(property_name);
       return katana::ResultSuccess();
     }
   }
   return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
 }
 
+katana::Result<void>
+katana::PropertyGraph::BeginNodePropertyWrites(
+    const std::vector<std::string>& names, katana::TxnContext* txn_ctx) {
+  const std::string& rdg_dir = rdg_->rdg_dir().string();
+  for (const auto& name : names) {
+    TxnContext::UndoFn undo;
+    if (!txn_ctx->auto_commit()) {
+      if (!rdg_->node_properties()->GetColumnByName(name) &&
+          rdg_->full_node_schema()->GetFieldIndex(name) != -1) {
+        // the stored values are what an undo restores
+        KATANA_CHECKED(rdg_->LoadNodeProperty(name));
+      }
+      const std::shared_ptr<arrow::Table>& table = rdg_->node_properties();
+      int i = table->schema()->GetFieldIndex(name);
+      undo = MakePropertyUndo(
+          rdg_, true, name, i == -1 ? nullptr : table->field(i),
+          i == -1 ? nullptr : table->column(i));
+    }
+    KATANA_CHECKED(txn_ctx->BeginNodePropertyWrite(
+        rdg_.get(), rdg_dir, name, std::move(undo)));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::BeginEdgePropertyWrites(
+    const std::vector<std::string>& names, katana::TxnContext* txn_ctx) {
+  const std::string& rdg_dir = rdg_->rdg_dir().string();
+  for (const auto& name : names) {
+    TxnContext::UndoFn undo;
+    if (!txn_ctx->auto_commit()) {
+      if (!rdg_->edge_properties()->GetColumnByName(name) &&
+          rdg_->full_edge_schema()->GetFieldIndex(name) != -1) {
+        // the stored values are what an undo restores
+        KATANA_CHECKED(rdg_->LoadEdgeProperty(name));
+      }
+      const std::shared_ptr<arrow::Table>& table = rdg_->edge_properties();
+      int i = table->schema()->GetFieldIndex(name);
+      undo = MakePropertyUndo(
+          rdg_, false, name, i == -1 ? nullptr : table->field(i),
+          i == -1 ? nullptr : table->column(i));
+    }
+    KATANA_CHECKED(txn_ctx->BeginEdgePropertyWrite(
+        rdg_.get(), rdg_dir, name, std::move(undo)));
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::PropertyGraph::DropNodeIndex(const std::string& property_name) {
+  node_indexes_.erase(
+      std::remove_if(
+          node_indexes_.begin(), node_indexes_.end(),
+          [&](const auto& index) {
+            return index->property_name() == property_name;
+          }),
+      node_indexes_.end());
+  if (!IsTransformed()) {
+    rdg_->RemoveEntityIndexPrimitive(
+        EntityIndexPrimitive::NodeIndexName(property_name));
+  }
+}
+
+void
+katana::PropertyGraph::DropEdgeIndex(const std::string& property_name) {
+  edge_indexes_.erase(
+      std::remove_if(
+          edge_indexes_.begin(), edge_indexes_.end(),
+          [&](const auto& index) {
+            return index->property_name() == property_name;
+          }),
+      edge_indexes_.end());
+  if (!IsTransformed()) {
+    rdg_->RemoveEntityIndexPrimitive(
+        EntityIndexPrimitive::EdgeIndexName(property_name));
+  }
+}
+
 katana::Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   // TODO(amber): This function will soon change so that it produces a new sorted
@@ -1455,7 +2610,7 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
   });
 
   // sort by degree (first item)
-  katana::ParallelSTL::sort(
+  katana::ParallelSTL::sample_sort(
       dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
 
   // create mapping, get degrees out to another vector to get prefix sum
@@ -1519,6 +2674,304 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
   return katana::ResultSuccess();
 }
 
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::CreatePermutedGraph(
+    katana::PropertyGraph* pg, const GraphTopology::PropIndexVec& new_to_old) {
+  const GraphTopology& topo = pg->topology();
+  const uint64_t num_nodes = topo.NumNodes();
+  const uint64_t num_edges = topo.NumEdges();
+
+  if (new_to_old.size() != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "permutation has {} entries but the graph has {} nodes",
+        new_to_old.size(), num_nodes);
+  }
+
+  // Every old node is claimed by exactly one new node if new_to_old is a
+  // permutation
+  katana::NUMAArray<std::atomic<GraphTopology::Node>> old_to_new;
+  old_to_new.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      old_to_new.begin(), old_to_new.end(),
+      static_cast<GraphTopology::Node>(num_nodes));
+  katana::GReduceLogicalOr invalid;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t new_id) {
+        uint64_t old_id = new_to_old[new_id];
+        GraphTopology::Node unclaimed = num_nodes;
+        if (old_id >= num_nodes ||
+            !old_to_new[old_id].compare_exchange_strong(
+                unclaimed, new_id, std::memory_order_relaxed)) {
+          invalid.update(true);
+        }
+      },
+      katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node mapping is not a permutation of the {} nodes", num_nodes);
+  }
+
+  katana::NUMAArray<GraphTopology::Edge> out_indices;
+  out_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t new_id) {
+        out_indices[new_id] = topo.OutDegree(new_to_old[new_id]);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+
+  katana::NUMAArray<GraphTopology::Node> out_dests;
+  out_dests.allocateInterleaved(num_edges);
+  katana::NUMAArray<uint64_t> edge_rows;
+  edge_rows.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t new_id) {
+        uint64_t new_edge = new_id == 0 ? 0 : out_indices[new_id - 1];
+        for (auto e : topo.OutEdges(new_to_old[new_id])) {
+          out_dests[new_edge] =
+              old_to_new[topo.OutEdgeDst(e)].load(std::memory_order_relaxed);
+          edge_rows[new_edge] = topo.GetEdgePropertyIndexFromOutEdge(e);
+          ++new_edge;
+        }
+      },
+      katana::steal(), katana::loopname("PermuteEdges"));
+
+  katana::NUMAArray<uint64_t> node_rows;
+  node_rows.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t new_id) {
+        node_rows[new_id] = topo.GetNodePropertyIndex(new_to_old[new_id]);
+      },
+      katana::no_stats());
+
+  return MakeGraphFromRows(
+      pg, GraphTopology{std::move(out_indices), std::move(out_dests)},
+      node_rows, edge_rows);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::CreateGraphWithEdges(
+    katana::PropertyGraph* pg, GraphTopology&& topology,
+    const katana::NUMAArray<uint64_t>& edge_rows) {
+  const GraphTopology& topo = pg->topology();
+  const uint64_t num_nodes = topo.NumNodes();
+  const uint64_t num_edges = topology.NumEdges();
+  const uint64_t num_old_rows = topo.NumEdges();
+
+  if (topology.NumNodes() != num_nodes || edge_rows.size() != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "topology of {} nodes and {} edges with {} edge rows does not fit a "
+        "graph of {} nodes",
+        topology.NumNodes(), num_edges, edge_rows.size(), num_nodes);
+  }
+
+  katana::NUMAArray<uint64_t> node_rows;
+  node_rows.allocateInterleaved(num_nodes);
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        node_rows[n] = topo.GetNodePropertyIndex(n);
+        node_types[n] = pg->GetTypeOfNodeFromPropertyIndex(node_rows[n]);
+      },
+      katana::no_stats());
+
+  // new edges take the null row appended to every edge column
+  katana::NUMAArray<uint64_t> rows;
+  rows.allocateInterleaved(num_edges);
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        if (edge_rows[e] < num_old_rows) {
+          rows[e] = edge_rows[e];
+          edge_types[e] = pg->GetTypeOfEdgeFromPropertyIndex(edge_rows[e]);
+        } else {
+          rows[e] = num_old_rows;
+          edge_types[e] = katana::kUnknownEntityType;
+        }
+      },
+      katana::no_stats());
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> node_columns;
+  for (int32_t i = 0; i < pg->GetNumNodeProperties(); ++i) {
+    node_columns.emplace_back(pg->GetNodeProperty(i));
+  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> edge_columns;
+  for (int32_t i = 0; i < pg->GetNumEdgeProperties(); ++i) {
+    std::shared_ptr<arrow::ChunkedArray> column = pg->GetEdgeProperty(i);
+    arrow::ArrayVector chunks = column->chunks();
+    chunks.emplace_back(
+        KATANA_CHECKED(arrow::MakeArrayOfNull(column->type(), 1)));
+    edge_columns.emplace_back(
+        KATANA_CHECKED(arrow::ChunkedArray::Make(chunks, column->type())));
+  }
+  auto node_table = KATANA_CHECKED(
+      TakeRows(pg->loaded_node_schema(), node_columns, node_rows));
+  auto edge_table =
+      KATANA_CHECKED(TakeRows(pg->loaded_edge_schema(), edge_columns, rows));
+
+  auto result = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(topology), std::move(node_types), std::move(edge_types),
+      katana::EntityTypeManager(pg->GetNodeTypeManager()),
+      katana::EntityTypeManager(pg->GetEdgeTypeManager())));
+
+  katana::TxnContext txn_ctx;
+  if (node_table->num_columns() > 0) {
+    KATANA_CHECKED(result->AddNodeProperties(node_table, &txn_ctx));
+  }
+  if (edge_table->num_columns() > 0) {
+    KATANA_CHECKED(result->AddEdgeProperties(edge_table, &txn_ctx));
+  }
+  return result;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::RemoveNodes(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& removed_nodes) {
+  const GraphTopology& topo = pg->topology();
+  const uint64_t num_nodes = topo.NumNodes();
+  if (removed_nodes.size() != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "bitset of {} nodes does not fit a graph of {} nodes",
+        removed_nodes.size(), num_nodes);
+  }
+
+  // old node n becomes new node old_to_new[n] - 1 if it is kept
+  katana::NUMAArray<uint64_t> old_to_new;
+  old_to_new.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { old_to_new[n] = removed_nodes.test(n) ? 0 : 1; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      old_to_new.begin(), old_to_new.end(), old_to_new.begin());
+  const uint64_t num_new_nodes = num_nodes == 0 ? 0 : old_to_new[num_nodes - 1];
+
+  katana::NUMAArray<GraphTopology::Node> new_to_old;
+  new_to_old.allocateInterleaved(num_new_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (!removed_nodes.test(n)) {
+          new_to_old[old_to_new[n] - 1] = n;
+        }
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<GraphTopology::Edge> out_indices;
+  out_indices.allocateInterleaved(num_new_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_new_nodes),
+      [&](uint64_t new_id) {
+        uint64_t degree = 0;
+        for (auto e : topo.OutEdges(new_to_old[new_id])) {
+          degree += !removed_nodes.test(topo.OutEdgeDst(e));
+        }
+        out_indices[new_id] = degree;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  const uint64_t num_new_edges =
+      num_new_nodes == 0 ? 0 : out_indices[num_new_nodes - 1];
+
+  katana::NUMAArray<GraphTopology::Node> out_dests;
+  out_dests.allocateInterleaved(num_new_edges);
+  katana::NUMAArray<uint64_t> edge_rows;
+  edge_rows.allocateInterleaved(num_new_edges);
+  katana::NUMAArray<uint64_t> node_rows;
+  node_rows.allocateInterleaved(num_new_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_new_nodes),
+      [&](uint64_t new_id) {
+        GraphTopology::Node old_id = new_to_old[new_id];
+        node_rows[new_id] = topo.GetNodePropertyIndex(old_id);
+        uint64_t new_edge = new_id == 0 ? 0 : out_indices[new_id - 1];
+        for (auto e : topo.OutEdges(old_id)) {
+          GraphTopology::Node dst = topo.OutEdgeDst(e);
+          if (removed_nodes.test(dst)) {
+            continue;
+          }
+          out_dests[new_edge] = old_to_new[dst] - 1;
+          edge_rows[new_edge] = topo.GetEdgePropertyIndexFromOutEdge(e);
+          ++new_edge;
+        }
+      },
+      katana::steal(), katana::loopname("RemoveNodes"));
+
+  return MakeGraphFromRows(
+      pg, GraphTopology{std::move(out_indices), std::move(out_dests)},
+      node_rows, edge_rows);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::RemoveEdges(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& removed_edges) {
+  const GraphTopology& topo = pg->topology();
+  const uint64_t num_nodes = topo.NumNodes();
+  if (removed_edges.size() != topo.NumEdges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "bitset of {} edges does not fit a graph of {} edges",
+        removed_edges.size(), topo.NumEdges());
+  }
+
+  katana::NUMAArray<GraphTopology::Edge> out_indices;
+  out_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = 0;
+        for (auto e : topo.OutEdges(n)) {
+          degree += !removed_edges.test(e);
+        }
+        out_indices[n] = degree;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  const uint64_t num_new_edges =
+      num_nodes == 0 ? 0 : out_indices[num_nodes - 1];
+
+  katana::NUMAArray<GraphTopology::Node> out_dests;
+  out_dests.allocateInterleaved(num_new_edges);
+  katana::NUMAArray<uint64_t> edge_rows;
+  edge_rows.allocateInterleaved(num_new_edges);
+  katana::NUMAArray<uint64_t> node_rows;
+  node_rows.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        node_rows[n] = topo.GetNodePropertyIndex(n);
+        uint64_t new_edge = n == 0 ? 0 : out_indices[n - 1];
+        for (auto e : topo.OutEdges(n)) {
+          if (removed_edges.test(e)) {
+            continue;
+          }
+          out_dests[new_edge] = topo.OutEdgeDst(e);
+          edge_rows[new_edge] = topo.GetEdgePropertyIndexFromOutEdge(e);
+          ++new_edge;
+        }
+      },
+      katana::steal(), katana::loopname("RemoveEdges"));
+
+  return MakeGraphFromRows(
+      pg, GraphTopology{std::move(out_indices), std::move(out_dests)},
+      node_rows, edge_rows);
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::CreateSymmetricGraph(katana::PropertyGraph* pg) {
   const GraphTopology& topology = pg->topology();
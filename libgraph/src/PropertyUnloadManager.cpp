@@ -0,0 +1,294 @@
+#include "katana/PropertyUnloadManager.h"
+
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include <arrow/table.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/ProgressTracer.h"
+#include "katana/RDG.h"
+#include "katana/Time.h"
+
+const std::string katana::PropertyUnloadManager::name_ = "loaded property";
+
+namespace {
+
+using PropertyKind = katana::PropertyUnloadManager::PropertyKind;
+
+constexpr PropertyKind kPropertyKinds[] = {
+    PropertyKind::kNode, PropertyKind::kEdge};
+
+const std::shared_ptr<arrow::Table>&
+PropertyTable(const katana::RDG& rdg, PropertyKind kind) {
+  return kind == PropertyKind::kNode ? rdg.node_properties()
+                                     : rdg.edge_properties();
+}
+
+/// Returns the approximate size of property \p name of \p rdg, or 0 if it is
+/// not loaded or is referenced outside of its property table
+katana::count_t
+UnloadableBytes(
+    const katana::RDG& rdg, PropertyKind kind, const std::string& name) {
+  std::shared_ptr<arrow::ChunkedArray> column =
+      PropertyTable(rdg, kind)->GetColumnByName(name);
+  // One reference is the table's and one is ours
+  if (!column || column.use_count() > 2) {
+    return 0;
+  }
+  katana::count_t bytes = 0;
+  for (const auto& chunk : column->chunks()) {
+    bytes += katana::ApproxArrayMemUse(chunk);
+  }
+  return bytes;
+}
+
+}  // namespace
+
+katana::PropertyUnloadManager::~PropertyUnloadManager() = default;
+
+katana::PropertyUnloadManager&
+katana::PropertyUnloadManager::Get() {
+  auto& ms = MemorySupervisor::Get();
+  auto* manager = ms.GetManager(name_);
+  if (manager == nullptr) {
+    auto pum = std::make_unique<PropertyUnloadManager>();
+    manager = pum.get();
+    ms.RegisterManager(std::move(pum));
+  }
+  return *static_cast<PropertyUnloadManager*>(manager);
+}
+
+void
+katana::PropertyUnloadManager::Watch(const std::shared_ptr<RDG>& rdg) {
+  auto it = graphs_.find(rdg.get());
+  if (it != graphs_.end() && it->second.rdg.expired()) {
+    // A graph that is gone left its state behind at the same address
+    Prune();
+  }
+  graphs_[rdg.get()].rdg = rdg;
+}
+
+katana::PropertyUnloadManager::Property*
+katana::PropertyUnloadManager::Find(
+    const RDG* rdg, PropertyKind kind, const std::string& name, bool create) {
+  auto graph_it = graphs_.find(rdg);
+  if (graph_it == graphs_.end() || graph_it->second.rdg.expired()) {
+    return nullptr;
+  }
+  Properties& properties = graph_it->second.properties(kind);
+  auto it = properties.find(name);
+  if (it == properties.end()) {
+    if (!create) {
+      return nullptr;
+    }
+    it = properties.emplace(name, Property{Clock::now()}).first;
+  }
+  return &it->second;
+}
+
+void
+katana::PropertyUnloadManager::MakeActive(Property* property) {
+  count_t bytes = property->standby_bytes;
+  if (bytes == 0) {
+    return;
+  }
+  property->standby_bytes = 0;
+  standby_ -= bytes;
+  // May call back into this manager, so property must not be used after this
+  MemorySupervisor::Get().StandbyToActive(Name(), bytes);
+}
+
+void
+katana::PropertyUnloadManager::PropertyUsed(
+    const RDG* rdg, PropertyKind kind, const std::string& name) {
+  Property* property = Find(rdg, kind, name, true);
+  if (property == nullptr) {
+    return;
+  }
+  property->last_use = Clock::now();
+  MakeActive(property);
+}
+
+void
+katana::PropertyUnloadManager::Pin(
+    const RDG* rdg, PropertyKind kind, const std::string& name) {
+  Property* property = Find(rdg, kind, name, true);
+  if (property == nullptr) {
+    return;
+  }
+  ++property->pins;
+  property->last_use = Clock::now();
+  MakeActive(property);
+}
+
+void
+katana::PropertyUnloadManager::Unpin(
+    const RDG* rdg, PropertyKind kind, const std::string& name) {
+  Property* property = Find(rdg, kind, name, false);
+  if (property == nullptr || property->pins == 0) {
+    return;
+  }
+  --property->pins;
+  property->last_use = Clock::now();
+}
+
+void
+katana::PropertyUnloadManager::Prune() {
+  count_t dropped = 0;
+  for (auto graph_it = graphs_.begin(); graph_it != graphs_.end();) {
+    std::shared_ptr<RDG> rdg = graph_it->second.rdg.lock();
+    // We may be called while the tables are locked for a load that needs
+    // memory, possibly by this thread; busy graphs are pruned next time
+    std::shared_lock<std::shared_mutex> lock;
+    if (rdg) {
+      lock = std::shared_lock<std::shared_mutex>(
+          rdg->property_mutex(), std::try_to_lock);
+      if (!lock.owns_lock()) {
+        ++graph_it;
+        continue;
+      }
+    }
+    for (PropertyKind kind : kPropertyKinds) {
+      Properties& properties = graph_it->second.properties(kind);
+      for (auto it = properties.begin(); it != properties.end();) {
+        if (rdg && PropertyTable(*rdg, kind)->GetColumnByName(it->first)) {
+          ++it;
+          continue;
+        }
+        // Unloaded or removed behind our back; pins of properties that are
+        // not loaded yet are kept
+        dropped += it->second.standby_bytes;
+        it->second.standby_bytes = 0;
+        if (rdg && it->second.pins > 0) {
+          ++it;
+        } else {
+          it = properties.erase(it);
+        }
+      }
+    }
+    graph_it = rdg ? std::next(graph_it) : graphs_.erase(graph_it);
+  }
+
+  if (dropped > 0) {
+    standby_ -= dropped;
+    MemorySupervisor::Get().PutStandby(Name(), dropped);
+  }
+}
+
+void
+katana::PropertyUnloadManager::MoveIdleToStandby() {
+  Prune();
+
+  auto now = Clock::now();
+  count_t moved = 0;
+  for (auto& graph_entry : graphs_) {
+    Graph& graph = graph_entry.second;
+    std::shared_ptr<RDG> rdg = graph.rdg.lock();
+    KATANA_LOG_DEBUG_ASSERT(rdg);
+    std::shared_lock<std::shared_mutex> lock(
+        rdg->property_mutex(), std::try_to_lock);
+    if (!lock.owns_lock()) {
+      continue;
+    }
+    for (PropertyKind kind : kPropertyKinds) {
+      Properties& properties = graph.properties(kind);
+      for (const auto& field : PropertyTable(*rdg, kind)->schema()->fields()) {
+        auto inserted = properties.emplace(field->name(), Property{now});
+        Property& property = inserted.first->second;
+        if (property.pins > 0 || property.standby_bytes > 0 ||
+            now - property.last_use < idle_time_) {
+          continue;
+        }
+        property.standby_bytes = UnloadableBytes(*rdg, kind, field->name());
+        moved += property.standby_bytes;
+      }
+    }
+  }
+
+  if (moved > 0) {
+    standby_ += moved;
+    // May call back into FreeStandbyMemory, our state is consistent by now
+    MemorySupervisor::Get().ActiveToStandby(Name(), moved);
+  }
+}
+
+katana::count_t
+katana::PropertyUnloadManager::FreeStandbyMemory(count_t goal) {
+  auto scope = katana::GetTracer().StartActiveSpan("free standby properties");
+  scope.span().Log(
+      "before", {
+                    {"goal_gb", ToGB(goal)},
+                    {"standby_gb", ToGB(standby_)},
+                });
+
+  struct Candidate {
+    Clock::time_point last_use;
+    const RDG* rdg;
+    PropertyKind kind;
+    std::string name;
+  };
+  std::vector<Candidate> candidates;
+  for (auto& graph_entry : graphs_) {
+    for (PropertyKind kind : kPropertyKinds) {
+      for (const auto& entry : graph_entry.second.properties(kind)) {
+        if (entry.second.standby_bytes > 0 && entry.second.pins == 0) {
+          candidates.emplace_back(Candidate{
+              entry.second.last_use, graph_entry.first, kind, entry.first});
+        }
+      }
+    }
+  }
+  std::sort(
+      candidates.begin(), candidates.end(),
+      [](const Candidate& a, const Candidate& b) {
+        return a.last_use < b.last_use;
+      });
+
+  count_t reclaim = 0;
+  for (const Candidate& candidate : candidates) {
+    if (reclaim >= goal) {
+      break;
+    }
+    Property* property =
+        Find(candidate.rdg, candidate.kind, candidate.name, false);
+    if (property == nullptr || property->standby_bytes == 0) {
+      continue;
+    }
+    std::shared_ptr<RDG> rdg = graphs_[candidate.rdg].rdg.lock();
+    count_t bytes = property->standby_bytes;
+    property->standby_bytes = 0;
+    standby_ -= bytes;
+
+    std::unique_lock<std::shared_mutex> lock(
+        rdg->property_mutex(), std::try_to_lock);
+    if (!lock.owns_lock() ||
+        UnloadableBytes(*rdg, candidate.kind, candidate.name) == 0) {
+      // Someone got hold of the property since it went standby, or is
+      // changing the tables right now
+      property->last_use = Clock::now();
+    } else if (auto res = candidate.kind == PropertyKind::kNode
+                              ? rdg->UnloadNodeProperty(candidate.name)
+                              : rdg->UnloadEdgeProperty(candidate.name);
+               !res) {
+      KATANA_LOG_WARN(
+          "unloading property {}: {}", candidate.name, res.error());
+      property->last_use = Clock::now();
+    } else {
+      reclaim += bytes;
+      graphs_[candidate.rdg].properties(candidate.kind).erase(candidate.name);
+    }
+    MemorySupervisor::Get().PutStandby(Name(), bytes);
+  }
+
+  scope.span().Log(
+      "after", {
+                   {"reclaimed_gb", ToGB(reclaim)},
+                   {"standby_gb", ToGB(standby_)},
+               });
+  return reclaim;
+}
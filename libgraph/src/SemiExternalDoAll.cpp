@@ -0,0 +1,26 @@
+#include "katana/SemiExternalDoAll.h"
+
+#include <algorithm>
+
+std::vector<katana::GraphTopology::Node>
+katana::SemiExternalSegments(
+    const GraphTopology& topo, uint64_t segment_edges) {
+  using Node = GraphTopology::Node;
+
+  const GraphTopology::Edge* adj_begin = topo.AdjData();
+  const GraphTopology::Edge* adj_end = adj_begin + topo.NumNodes();
+  std::vector<Node> bounds{0};
+  Node begin = 0;
+  while (begin < topo.NumNodes()) {
+    // adj_begin[n] is the end of the edges of node n
+    uint64_t first_edge = begin == 0 ? 0 : adj_begin[begin - 1];
+    const GraphTopology::Edge* next = std::lower_bound(
+        adj_begin + begin, adj_end, first_edge + segment_edges);
+    Node end = std::distance(adj_begin, next);
+    // the node whose edges cross the boundary goes in this segment
+    end = std::max<Node>(begin + 1, std::min<Node>(end + 1, topo.NumNodes()));
+    bounds.emplace_back(end);
+    begin = end;
+  }
+  return bounds;
+}
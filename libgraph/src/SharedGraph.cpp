@@ -0,0 +1,87 @@
+#include "katana/SharedGraph.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/RawColumn.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+
+namespace {
+
+constexpr const char* kDefaultSharedGraphDir = "/dev/shm/katana-graphs";
+
+katana::Result<std::vector<std::string>>
+ListSharedGraphFiles(const std::string& location) {
+  std::vector<std::string> files;
+  auto list_fut = katana::FileListAsync(location, &files);
+  KATANA_LOG_ASSERT(list_fut.valid());
+  KATANA_CHECKED_CONTEXT(list_fut.get(), "listing {}", location);
+  return files;
+}
+
+}  // namespace
+
+std::string
+katana::SharedGraphDir() {
+  std::string dir;
+  if (!katana::GetEnv("KATANA_SHARED_GRAPH_DIR", &dir) || dir.empty()) {
+    dir = kDefaultSharedGraphDir;
+  }
+  return dir;
+}
+
+std::string
+katana::SharedGraphLocation(const std::string& name) {
+  return katana::URI::JoinPath(SharedGraphDir(), name);
+}
+
+katana::Result<std::string>
+katana::PublishSharedGraph(
+    PropertyGraph* pg, const std::string& name,
+    const std::string& command_line, TxnContext* txn_ctx) {
+  if (name.empty() || name.find('/') != std::string::npos) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "invalid shared graph name \"{}\"", name);
+  }
+  std::string location = SharedGraphLocation(name);
+  if (!KATANA_CHECKED(ListSharedGraphFiles(location)).empty()) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "shared graph {} is already published at {}",
+        name, location);
+  }
+
+  // raw columns are what attached processes map instead of decoding Parquet
+  pg->set_raw_column_format(RawColumnFormat::kUncompressed);
+  KATANA_CHECKED_CONTEXT(
+      pg->Write(location, command_line, txn_ctx), "publishing {} at {}", name,
+      location);
+  return location;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::AttachSharedGraph(
+    const std::string& name, TxnContext* txn_ctx, RDGLoadOptions opts) {
+  std::string location = SharedGraphLocation(name);
+  opts.mmap_local_files = true;
+  return KATANA_CHECKED_CONTEXT(
+      PropertyGraph::Make(location, txn_ctx, opts),
+      "attaching shared graph {} at {}", name, location);
+}
+
+katana::Result<void>
+katana::UnpublishSharedGraph(const std::string& name) {
+  std::string location = SharedGraphLocation(name);
+  std::vector<std::string> files =
+      KATANA_CHECKED(ListSharedGraphFiles(location));
+  if (files.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "no shared graph {} at {}", name, location);
+  }
+  KATANA_CHECKED(FileDelete(
+      location, std::unordered_set<std::string>(files.begin(), files.end())));
+  // an empty set removes the directory itself
+  return FileDelete(location, {});
+}
@@ -20,14 +20,17 @@
 #include "katana/SharedMemSys.h"
 
 #include "katana/CommBackend.h"
+#include "katana/Env.h"
 #include "katana/Experimental.h"
 #include "katana/FileStorage.h"
 #include "katana/Galois.h"
 #include "katana/GaloisRuntime.h"
 #include "katana/Logging.h"
 #include "katana/Plugin.h"
+#include "katana/SamplingProfiler.h"
 #include "katana/Strings.h"
 #include "katana/TextTracer.h"
+#include "katana/ThreadPool.h"
 #include "katana/tsuba.h"
 
 namespace {
@@ -41,8 +44,29 @@ struct katana::SharedMemSys::Impl {
 };
 
 katana::SharedMemSys::SharedMemSys(std::unique_ptr<ProgressTracer> tracer)
+    : SharedMemSys(SharedMemSysOptions(), std::move(tracer)) {}
+
+katana::SharedMemSys::SharedMemSys(
+    const SharedMemSysOptions& options, std::unique_ptr<ProgressTracer> tracer)
     : impl_(std::make_unique<Impl>()) {
+  if (options.thread_spin_before_park) {
+    katana::GetThreadPool().SetSpinBeforePark(
+        *options.thread_spin_before_park);
+  }
   katana::ProgressTracer::Set(std::move(tracer));
+
+  std::optional<uint32_t> profiler_hz = options.sampling_profiler_hz;
+  int env_hz = 0;
+  if (!profiler_hz && katana::GetEnv("KATANA_SAMPLING_PROFILER_HZ", &env_hz) &&
+      env_hz > 0) {
+    profiler_hz = env_hz;
+  }
+  if (profiler_hz) {
+    if (auto res = katana::StartSamplingProfiler(*profiler_hz); !res) {
+      KATANA_LOG_WARN("sampling profiler not started: {}", res.error());
+    }
+  }
+
   LoadPlugins();
   if (auto init_good = katana::InitTsuba(&comm_backend); !init_good) {
     KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
@@ -69,6 +93,7 @@ katana::SharedMemSys::~SharedMemSys() {
   if (auto fini_good = katana::FiniTsuba(); !fini_good) {
     KATANA_LOG_ERROR("katana::FiniTsuba: {}", fini_good.error());
   }
+  katana::StopSamplingProfiler();
   katana::GetTracer().Finish();
   // This will finalize plugins irreversibly, reinitialization may not work.
   FinalizePlugins();
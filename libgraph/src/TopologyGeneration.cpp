@@ -1,6 +1,107 @@
 #include "katana/TopologyGeneration.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Random.h"
+
 namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// The largest graphs the generators make; node ids must fit in a Node
+constexpr uint64_t kMaxNodes = uint64_t{1} << 31;
+
+/// \returns the seed of the random stream of a generator
+uint64_t
+StreamSeed(uint64_t seed, uint64_t stream) {
+  return katana::SplitMix64::ForIndex(seed, stream)();
+}
+
+/// A bijection of [0, 2^bits) that scatters neighboring ids
+uint64_t
+ScrambleId(uint64_t id, uint32_t bits, uint64_t seed) {
+  uint64_t mask = (uint64_t{1} << bits) - 1;
+  uint32_t shift = bits / 2 + 1;
+  id = (id ^ seed) & mask;
+  id = (id * UINT64_C(0x9e3779b97f4a7c15)) & mask;
+  id ^= id >> shift;
+  id = (id * UINT64_C(0xbf58476d1ce4e5b9)) & mask;
+  id ^= id >> shift;
+  return id;
+}
+
+/// \returns an integer in [min, max] drawn from a power law with exponent
+/// for a uniform u in [0, 1)
+uint64_t
+PowerLaw(double u, uint64_t min, uint64_t max, double exponent) {
+  double lo = static_cast<double>(min);
+  double hi = static_cast<double>(max) + 1.0;
+  double x = 0;
+  if (std::abs(exponent - 1.0) < 1e-9) {
+    x = lo * std::pow(hi / lo, u);
+  } else {
+    double e = 1.0 - exponent;
+    double lo_e = std::pow(lo, e);
+    x = std::pow(lo_e + u * (std::pow(hi, e) - lo_e), 1.0 / e);
+  }
+  return std::clamp(static_cast<uint64_t>(x), min, max);
+}
+
+/// Build the CSR of num_edges edges, edge e going from draw(e).first to
+/// draw(e).second: count the degrees, then draw the edges again to scatter
+/// them, so that no edge list is kept. The edges of a node are sorted by
+/// destination, which also makes the result deterministic.
+template <typename Draw>
+katana::GraphTopology
+MakeCSR(uint64_t num_nodes, uint64_t num_edges, const Draw& draw) {
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(adj_indices.begin(), adj_indices.end(), Edge{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        __sync_fetch_and_add(&adj_indices[draw(e).first], 1);
+      },
+      katana::no_stats(), katana::loopname("GeneratorCountDegrees"));
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  katana::NUMAArray<Edge> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = n == 0 ? 0 : adj_indices[n - 1]; },
+      katana::no_stats());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        auto [src, dst] = draw(e);
+        dests[__sync_fetch_and_add(&cursors[src], 1)] = dst;
+      },
+      katana::no_stats(), katana::loopname("GeneratorScatterEdges"));
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        std::sort(
+            dests.begin() + (n == 0 ? 0 : adj_indices[n - 1]),
+            dests.begin() + adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("GeneratorSortEdges"));
+
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
 template <typename F>
 std::unique_ptr<katana::PropertyGraph>
 MakeTopologyImpl(F builder_fun) {
@@ -176,4 +277,229 @@ MakeTriangle(size_t num_rows) noexcept {
   });
 }
 
+katana::Result<GraphTopology>
+MakeRMATTopology(const RMATOptions& options) {
+  const double a = options.a;
+  const double ab = a + options.b;
+  const double abc = ab + options.c;
+  if (a < 0 || options.b < 0 || options.c < 0 || abc > 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "R-MAT probabilities must be at least 0 and sum to at most 1: "
+        "{}, {}, {}",
+        options.a, options.b, options.c);
+  }
+  if (options.scale > 31) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "scale {} is above 31", options.scale);
+  }
+  const uint64_t num_nodes = uint64_t{1} << options.scale;
+  const uint64_t num_edges = num_nodes * options.edge_factor;
+
+  const uint64_t edge_seed = StreamSeed(options.seed, 0);
+  const uint64_t id_seed = StreamSeed(options.seed, 1);
+  auto draw = [&](uint64_t e) {
+    SplitMix64 random = SplitMix64::ForIndex(edge_seed, e);
+    uint64_t src = 0;
+    uint64_t dst = 0;
+    for (uint32_t level = 0; level < options.scale; ++level) {
+      double u = random.NextDouble();
+      src <<= 1;
+      dst <<= 1;
+      if (u < a) {
+        continue;
+      }
+      if (u < ab) {
+        dst |= 1;
+      } else if (u < abc) {
+        src |= 1;
+      } else {
+        src |= 1;
+        dst |= 1;
+      }
+    }
+    if (options.scramble_ids) {
+      src = ScrambleId(src, options.scale, id_seed);
+      dst = ScrambleId(dst, options.scale, id_seed);
+    }
+    return std::make_pair(static_cast<Node>(src), static_cast<Node>(dst));
+  };
+
+  return MakeCSR(num_nodes, num_edges, draw);
+}
+
+katana::Result<GraphTopology>
+MakeBarabasiAlbertTopology(const BarabasiAlbertOptions& options) {
+  const uint64_t num_nodes = options.num_nodes;
+  const uint64_t m = options.edges_per_node;
+  if (num_nodes > kMaxNodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} nodes are more than {}", num_nodes,
+        kMaxNodes);
+  }
+  if (num_nodes == 0) {
+    return GraphTopology{};
+  }
+
+  // Every node but node 0 has m out edges, edge j being out edge j % m of
+  // node 1 + j / m
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { adj_indices[n] = n * m; }, katana::no_stats());
+  const uint64_t num_edges = (num_nodes - 1) * m;
+
+  // Lay out the endpoints of the edges in slots: slot 0 holds node 0, slot
+  // 2j + 1 the source of edge j and slot 2j + 2 its target, which is a copy
+  // of a uniformly chosen earlier slot. Nodes are in as many slots as
+  // their degree, so this is preferential attachment, and the target of
+  // an edge can be found by following copies back to a source slot.
+  const uint64_t seed = StreamSeed(options.seed, 0);
+  auto copied_slot = [seed](uint64_t j) {
+    return SplitMix64::ForIndex(seed, j).NextBelow(2 * j + 1);
+  };
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t j) {
+        uint64_t slot = copied_slot(j);
+        while (slot != 0 && slot % 2 == 0) {
+          slot = copied_slot((slot - 2) / 2);
+        }
+        dests[j] = slot == 0 ? 0 : static_cast<Node>(1 + (slot - 1) / 2 / m);
+      },
+      katana::no_stats(), katana::loopname("BarabasiAlbertEdges"));
+
+  return GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+katana::Result<LFRTopology>
+MakeLFRTopology(const LFROptions& options) {
+  const uint64_t num_nodes = options.num_nodes;
+  if (num_nodes == 0 || num_nodes > kMaxNodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "number of nodes {} is not in [1, {}]",
+        num_nodes, kMaxNodes);
+  }
+  if (options.min_degree == 0 || options.min_degree > options.max_degree ||
+      options.min_community == 0 ||
+      options.min_community > options.max_community) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "degrees [{}, {}] and community sizes [{}, {}] must be non-empty "
+        "ranges of positive numbers",
+        options.min_degree, options.max_degree, options.min_community,
+        options.max_community);
+  }
+  if (options.mixing < 0 || options.mixing > 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "mixing {} is not in [0, 1]",
+        options.mixing);
+  }
+
+  // Cut the nodes into communities; a remainder too small to be a
+  // community joins the last one
+  const uint64_t community_seed = StreamSeed(options.seed, 0);
+  std::vector<uint64_t> starts{0};
+  while (starts.back() < num_nodes) {
+    uint64_t size = PowerLaw(
+        SplitMix64::ForIndex(community_seed, starts.size()).NextDouble(),
+        options.min_community, options.max_community,
+        options.community_exponent);
+    uint64_t next = std::min(starts.back() + size, num_nodes);
+    if (num_nodes - next < options.min_community) {
+      next = num_nodes;
+    }
+    starts.emplace_back(next);
+  }
+  const uint64_t num_communities = starts.size() - 1;
+
+  NUMAArray<uint32_t> communities;
+  communities.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_communities),
+      [&](uint64_t c) {
+        std::fill(
+            communities.begin() + starts[c],
+            communities.begin() + starts[c + 1], static_cast<uint32_t>(c));
+      },
+      katana::no_stats());
+
+  const uint64_t degree_seed = StreamSeed(options.seed, 1);
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        adj_indices[n] = PowerLaw(
+            SplitMix64::ForIndex(degree_seed, n).NextDouble(),
+            options.min_degree, options.max_degree, options.degree_exponent);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+  const uint64_t num_edges = adj_indices[num_nodes - 1];
+
+  // The prefix sums of the degrees are also the weights of Chung–Lu: a
+  // uniform w in [0, num_edges) falls into the range of node n with
+  // probability proportional to its degree
+  auto weighted_node = [&](uint64_t begin, uint64_t end, SplitMix64* random) {
+    uint64_t lo = begin == 0 ? 0 : adj_indices[begin - 1];
+    uint64_t w = lo + random->NextBelow(adj_indices[end - 1] - lo);
+    return static_cast<uint64_t>(
+        std::upper_bound(
+            adj_indices.begin() + begin, adj_indices.begin() + end, w) -
+        adj_indices.begin());
+  };
+
+  // Give up avoiding a self loop or an edge within the community after so
+  // many draws, which only happens for tiny graphs
+  constexpr int kMaxDraws = 16;
+  const uint64_t edge_seed = StreamSeed(options.seed, 2);
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint32_t c = communities[n];
+        uint64_t begin = starts[c];
+        uint64_t end = starts[c + 1];
+        uint64_t first_edge = n == 0 ? 0 : adj_indices[n - 1];
+        uint64_t degree = adj_indices[n] - first_edge;
+        uint64_t internal = static_cast<uint64_t>(
+            std::llround((1.0 - options.mixing) * degree));
+        if (num_communities == 1) {
+          internal = degree;
+        } else if (end - begin == 1) {
+          internal = 0;
+        }
+
+        SplitMix64 random = SplitMix64::ForIndex(edge_seed, n);
+        for (uint64_t i = 0; i < degree; ++i) {
+          uint64_t dst = n;
+          for (int draw = 0; draw < kMaxDraws; ++draw) {
+            if (i < internal) {
+              dst = weighted_node(begin, end, &random);
+              if (dst != n) {
+                break;
+              }
+            } else {
+              dst = weighted_node(0, num_nodes, &random);
+              if (communities[dst] != c) {
+                break;
+              }
+            }
+          }
+          dests[first_edge + i] = static_cast<Node>(dst);
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("LFREdges"));
+
+  return LFRTopology{
+      GraphTopology(std::move(adj_indices), std::move(dests)),
+      std::move(communities)};
+}
+
 }  // namespace katana
@@ -0,0 +1,119 @@
+#include "katana/TopologyManager.h"
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Time.h"
+
+const std::string katana::TopologyManager::name_ = "topology";
+
+katana::TopologyManager::~TopologyManager() = default;
+
+katana::TopologyManager&
+katana::TopologyManager::Get() {
+  auto& ms = MemorySupervisor::Get();
+  auto* manager = ms.GetManager(name_);
+  if (manager == nullptr) {
+    auto tm = std::make_unique<TopologyManager>();
+    manager = tm.get();
+    ms.RegisterManager(std::move(tm));
+  }
+  return *static_cast<TopologyManager*>(manager);
+}
+
+void
+katana::TopologyManager::TopologyCached(
+    PGViewCache* cache, const void* topo, count_t bytes) {
+  KATANA_LOG_DEBUG_ASSERT(entries_.count(topo) == 0);
+  lru_.push_front(Entry{cache, topo, bytes});
+  entries_[topo] = lru_.begin();
+  standby_ += bytes;
+
+  katana::GetTracer().GetActiveSpan().Log(
+      "topology cache insert", {
+                                   {"approx_size_gb", ToGB(bytes)},
+                                   {"cache_gb", ToGB(standby_)},
+                               });
+  // May call back into FreeStandbyMemory; the caller holds a reference to
+  // topo, so topo itself is not evicted
+  MemorySupervisor::Get().ActiveToStandby(Name(), bytes);
+}
+
+void
+katana::TopologyManager::TopologyUsed(const void* topo) {
+  auto it = entries_.find(topo);
+  if (it == entries_.end()) {
+    return;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+}
+
+void
+katana::TopologyManager::Drop(LRUList::iterator it) {
+  auto bytes = it->bytes;
+  entries_.erase(it->topo);
+  lru_.erase(it);
+  standby_ -= bytes;
+  MemorySupervisor::Get().PutStandby(Name(), bytes);
+}
+
+void
+katana::TopologyManager::TopologyDropped(const void* topo) {
+  auto it = entries_.find(topo);
+  if (it == entries_.end()) {
+    return;
+  }
+  Drop(it->second);
+}
+
+void
+katana::TopologyManager::CacheDropped(PGViewCache* cache) {
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    auto next = std::next(it);
+    if (it->cache == cache) {
+      Drop(it);
+    }
+    it = next;
+  }
+}
+
+void
+katana::TopologyManager::CacheMoved(PGViewCache* from, PGViewCache* to) {
+  for (auto& entry : lru_) {
+    if (entry.cache == from) {
+      entry.cache = to;
+    }
+  }
+}
+
+katana::count_t
+katana::TopologyManager::FreeStandbyMemory(count_t goal) {
+  auto scope = katana::GetTracer().StartActiveSpan("free standby memory");
+  scope.span().Log(
+      "before", {
+                    {"goal_gb", ToGB(goal)},
+                    {"cache_gb", ToGB(standby_)},
+                });
+
+  count_t reclaim = 0;
+  // Walk from the least recently used end; topologies still referenced by a
+  // view refuse eviction and are skipped
+  auto it = lru_.end();
+  while (it != lru_.begin() && reclaim < goal) {
+    auto victim = std::prev(it);
+    if (victim->cache->EvictTopology(victim->topo)) {
+      reclaim += victim->bytes;
+      Drop(victim);
+    } else {
+      it = victim;
+    }
+  }
+
+  scope.span().Log(
+      "after", {
+                   {"reclaimed_gb", ToGB(reclaim)},
+                   {"cache_gb", ToGB(standby_)},
+               });
+  return reclaim;
+}
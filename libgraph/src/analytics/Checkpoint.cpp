@@ -0,0 +1,175 @@
+#include "katana/analytics/Checkpoint.h"
+
+#include <arrow/compute/cast.h>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/ParquetReader.h"
+#include "katana/ParquetWriter.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+
+namespace {
+
+/// The marker names the file of the latest complete checkpoint
+struct Marker {
+  uint32_t iteration{0};
+  std::string file;
+};
+
+void
+to_json(nlohmann::json& j, const Marker& marker) {
+  j = nlohmann::json{{"iteration", marker.iteration}, {"file", marker.file}};
+}
+
+void
+from_json(const nlohmann::json& j, Marker& marker) {
+  j.at("iteration").get_to(marker.iteration);
+  j.at("file").get_to(marker.file);
+}
+
+}  // namespace
+
+katana::analytics::Checkpointer::~Checkpointer() {
+  if (auto res = Finish(); !res) {
+    KATANA_LOG_WARN("checkpoint {} not written: {}", name_, res.error());
+  }
+}
+
+std::string
+katana::analytics::Checkpointer::FileName(uint32_t slot) const {
+  return fmt::format("{}-{}.parquet", name_, slot);
+}
+
+std::string
+katana::analytics::Checkpointer::MarkerName() const {
+  return name_ + ".checkpoint";
+}
+
+katana::Result<std::optional<katana::analytics::CheckpointState>>
+katana::analytics::Checkpointer::Resume() {
+  if (!enabled() || !options_.resume) {
+    return std::nullopt;
+  }
+  std::string marker_path = URI::JoinPath(options_.location, MarkerName());
+  StatBuf stat;
+  if (!FileStat(marker_path, &stat)) {
+    return std::nullopt;
+  }
+
+  FileView fv;
+  KATANA_CHECKED(fv.Bind(marker_path, true));
+  Marker marker;
+  KATANA_CHECKED_CONTEXT(
+      JsonParse<Marker>(fv, &marker), "reading checkpoint marker {}",
+      marker_path);
+
+  URI uri =
+      KATANA_CHECKED(URI::Make(URI::JoinPath(options_.location, marker.file)));
+  std::unique_ptr<ParquetReader> reader = KATANA_CHECKED(ParquetReader::Make());
+  std::shared_ptr<arrow::Table> columns = KATANA_CHECKED_CONTEXT(
+      reader->ReadTable(uri), "reading checkpoint {}", uri);
+  KATANA_LOG_DEBUG(
+      "resuming {} after {} iterations from {}", name_, marker.iteration, uri);
+
+  // the checkpoints of the run cut short are now this run's; keep the one
+  // resumed from until a newer one is complete
+  num_saved_ = marker.file == FileName(0) ? 1 : 0;
+  written_.insert({MarkerName(), FileName(0), FileName(1)});
+  return CheckpointState{marker.iteration, std::move(columns)};
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Save(CheckpointState state) {
+  KATANA_LOG_DEBUG_ASSERT(enabled());
+  KATANA_CHECKED(Finish());
+
+  // never overwrite the file of the latest complete checkpoint
+  uint32_t slot = num_saved_ % 2;
+  URI uri = KATANA_CHECKED(
+      URI::Make(URI::JoinPath(options_.location, FileName(slot))));
+  pending_ = KATANA_CHECKED(WriteGroup::Make());
+  std::unique_ptr<ParquetWriter> writer =
+      KATANA_CHECKED(ParquetWriter::Make(std::move(state.columns)));
+  KATANA_CHECKED_CONTEXT(
+      writer->WriteToUri(uri, pending_.get()), "writing checkpoint {}", uri);
+  pending_iteration_ = state.iteration;
+  pending_slot_ = slot;
+  num_saved_ += 1;
+  written_.emplace(FileName(slot));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Finish() {
+  if (!pending_) {
+    return ResultSuccess();
+  }
+  std::unique_ptr<WriteGroup> pending = std::move(pending_);
+  KATANA_CHECKED_CONTEXT(
+      pending->Finish(), "writing checkpoint {} of {}", pending_iteration_,
+      name_);
+
+  std::string serialized = KATANA_CHECKED(
+      JsonDump(Marker{pending_iteration_, FileName(pending_slot_)}));
+  KATANA_CHECKED(FileStore(
+      URI::JoinPath(options_.location, MarkerName()), serialized.data(),
+      serialized.size()));
+  written_.emplace(MarkerName());
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Discard() {
+  KATANA_CHECKED(Finish());
+  if (written_.empty()) {
+    return ResultSuccess();
+  }
+  KATANA_CHECKED_CONTEXT(
+      FileDelete(options_.location, written_), "removing checkpoints of {}",
+      name_);
+  written_.clear();
+  return ResultSuccess();
+}
+
+katana::analytics::CheckpointState
+katana::analytics::MakeCheckpointState(
+    uint32_t iteration, const std::vector<std::string>& names,
+    const std::vector<std::shared_ptr<arrow::Array>>& columns) {
+  KATANA_LOG_DEBUG_ASSERT(names.size() == columns.size());
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    fields.emplace_back(arrow::field(names[i], columns[i]->type()));
+  }
+  return CheckpointState{
+      iteration, arrow::Table::Make(arrow::schema(fields), columns)};
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::analytics::GetCheckpointColumn(
+    const CheckpointState& state, const std::string& name, size_t size,
+    const std::shared_ptr<arrow::DataType>& type) {
+  std::shared_ptr<arrow::ChunkedArray> column =
+      state.columns->GetColumnByName(name);
+  if (!column) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "checkpoint has no column {}", name);
+  }
+  if (static_cast<size_t>(column->length()) != size ||
+      column->null_count() != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "checkpoint column {} has {} values and {} nulls, expected {} values",
+        name, column->length(), column->null_count(), size);
+  }
+  if (column->type()->Equals(type)) {
+    return column;
+  }
+  arrow::Datum cast = KATANA_CHECKED_CONTEXT(
+      arrow::compute::Cast(column, type), "casting checkpoint column {}",
+      name);
+  return cast.chunked_array();
+}
@@ -0,0 +1,65 @@
+#include "katana/analytics/HubBitmaps.h"
+
+#include <algorithm>
+
+#include "katana/Logging.h"
+
+void
+katana::analytics::HubBitmaps::Allocate(
+    const std::vector<uint64_t>& degrees, size_t budget_bytes) {
+  size_t num_nodes = degrees.size();
+  words_per_hub_ = (num_nodes + 63) / 64;
+
+  // the marks cost as much as one more hub
+  size_t hub_bytes = words_per_hub_ * sizeof(uint64_t) + sizeof(Node);
+  size_t mark_bytes = words_per_hub_ * sizeof(uint64_t);
+  if (budget_bytes < mark_bytes + hub_bytes) {
+    return;
+  }
+  size_t max_hubs = (budget_bytes - mark_bytes) / hub_bytes;
+
+  std::vector<Node> candidates;
+  for (Node n = 0; n < num_nodes; ++n) {
+    if (degrees[n] >= kMinHubDegree) {
+      candidates.emplace_back(n);
+    }
+  }
+  // ties go to the smaller id so that the hubs do not depend on the sort
+  auto by_degree = [&](Node a, Node b) {
+    return degrees[a] > degrees[b] || (degrees[a] == degrees[b] && a < b);
+  };
+  if (candidates.size() > max_hubs) {
+    std::nth_element(
+        candidates.begin(), candidates.begin() + max_hubs, candidates.end(),
+        by_degree);
+    candidates.resize(max_hubs);
+  }
+  if (candidates.empty()) {
+    return;
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  hubs_ = std::move(candidates);
+  marks_.assign(words_per_hub_, 0);
+  for (Node hub : hubs_) {
+    marks_[hub / 64] |= uint64_t{1} << (hub % 64);
+  }
+  bits_.assign(hubs_.size() * words_per_hub_, 0);
+}
+
+size_t
+katana::analytics::HubBitmaps::FindSlot(Node node) const {
+  auto it = std::lower_bound(hubs_.begin(), hubs_.end(), node);
+  KATANA_LOG_DEBUG_ASSERT(it != hubs_.end() && *it == node);
+  return it - hubs_.begin();
+}
+
+size_t
+katana::analytics::HubBitmaps::CountIntersection(
+    const uint64_t* bitmap, const Node* b, size_t b_size) {
+  size_t count = 0;
+  for (size_t i = 0; i < b_size; ++i) {
+    count += Contains(bitmap, b[i]);
+  }
+  return count;
+}
@@ -0,0 +1,48 @@
+#include "katana/analytics/IterationMetrics.h"
+
+#include <mutex>
+
+namespace {
+
+std::mutex observer_mutex;
+katana::analytics::IterationObserver observer;
+
+}  // namespace
+
+void
+katana::analytics::SetIterationObserver(IterationObserver new_observer) {
+  std::lock_guard<std::mutex> lock(observer_mutex);
+  observer = std::move(new_observer);
+}
+
+katana::analytics::IterationReporter::IterationReporter(std::string analytic)
+    : analytic_(std::move(analytic)),
+      scope_(GetTracer().StartActiveSpan(analytic_)),
+      last_(Now()) {}
+
+void
+katana::analytics::IterationReporter::Report(
+    uint32_t iteration, double convergence, uint64_t active_nodes,
+    uint64_t work_items) {
+  TimePoint now = Now();
+  IterationMetrics metrics;
+  metrics.analytic = analytic_;
+  metrics.iteration = iteration;
+  metrics.convergence = convergence;
+  metrics.active_nodes = active_nodes;
+  metrics.work_items = work_items;
+  metrics.time_us = UsBetween(last_, now);
+  last_ = now;
+
+  scope_.span().Log(
+      "iteration", {{"iteration", metrics.iteration},
+                    {"convergence", metrics.convergence},
+                    {"active_nodes", metrics.active_nodes},
+                    {"work_items", metrics.work_items},
+                    {"time_us", metrics.time_us}});
+
+  std::lock_guard<std::mutex> lock(observer_mutex);
+  if (observer) {
+    observer(metrics);
+  }
+}
@@ -0,0 +1,289 @@
+#include "katana/analytics/PlanAdvisor.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <arrow/compute/cast.h>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/HubBitmaps.h"
+
+using katana::analytics::BfsPlan;
+using katana::analytics::ConnectedComponentsPlan;
+using katana::analytics::GraphProfile;
+using katana::analytics::PagerankPlan;
+using katana::analytics::PlanAdvisor;
+using katana::analytics::SsspPlan;
+using katana::analytics::TriangleCountPlan;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Last-level cache size to assume when the system does not report one
+constexpr long kDefaultLLCBytes = 32L << 20;
+/// Bytes of node data the pull iterations of Pagerank read at random per
+/// node: the rank and the out-degree or residual
+constexpr uint64_t kPagerankBytesPerNode = 2 * sizeof(float);
+
+constexpr ptrdiff_t kMinEdgeTileSize = 64;
+constexpr ptrdiff_t kMaxEdgeTileSize = 4096;
+/// Edges per tile per edge of the average node
+constexpr double kEdgesPerTilePerDegree = 8;
+
+long
+LastLevelCacheBytes() {
+  long llc_bytes = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  llc_bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+  if (llc_bytes <= 0) {
+    llc_bytes = kDefaultLLCBytes;
+  }
+  return llc_bytes;
+}
+
+/// Level synchronous BFS along out-edges from source. Returns the farthest
+/// node, the lowest id among the farthest ones, and its distance.
+std::pair<Node, uint64_t>
+FarthestNode(const katana::GraphTopology& topo, Node source) {
+  constexpr uint64_t kUnvisited = std::numeric_limits<uint64_t>::max();
+  katana::NUMAArray<std::atomic<uint64_t>> dist;
+  dist.allocateInterleaved(topo.NumNodes());
+  katana::ParallelSTL::fill(dist.begin(), dist.end(), kUnvisited);
+  dist[source] = 0;
+
+  katana::InsertBag<Node> frontier;
+  frontier.push(source);
+  uint64_t level = 0;
+  Node farthest = source;
+  katana::InsertBag<Node> next;
+  katana::GReduceMin<Node> lowest_next;
+  while (true) {
+    next.clear();
+    lowest_next.reset();
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](Node n) {
+          for (auto e : topo.OutEdges(n)) {
+            Node dst = topo.OutEdgeDst(e);
+            uint64_t expected = kUnvisited;
+            if (dist[dst].compare_exchange_strong(expected, level + 1)) {
+              next.push(dst);
+              lowest_next.update(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (next.empty()) {
+      break;
+    }
+    ++level;
+    farthest = lowest_next.reduce();
+    frontier.swap(next);
+  }
+  return {farthest, level};
+}
+
+GraphProfile
+ComputeProfile(const katana::PropertyGraph& pg) {
+  katana::StatTimer timer("PlanAdvisor_Profile");
+  timer.start();
+
+  const katana::GraphTopology& topo = pg.topology();
+  GraphProfile profile;
+  profile.num_nodes = topo.NumNodes();
+  profile.num_edges = topo.NumEdges();
+  if (profile.num_nodes == 0) {
+    timer.stop();
+    return profile;
+  }
+  profile.average_degree =
+      static_cast<double>(profile.num_edges) / profile.num_nodes;
+  if (profile.num_nodes > 1) {
+    profile.density = static_cast<double>(profile.num_edges) /
+                      (static_cast<double>(profile.num_nodes) *
+                       (profile.num_nodes - 1));
+  }
+
+  katana::GReduceMax<uint64_t> max_degree;
+  katana::GAccumulator<double> squared_deviations;
+  katana::do_all(
+      katana::iterate(topo),
+      [&](Node n) {
+        uint64_t degree = topo.OutDegree(n);
+        max_degree.update(degree);
+        double deviation = degree - profile.average_degree;
+        squared_deviations += deviation * deviation;
+      },
+      katana::no_stats());
+  profile.max_degree = max_degree.reduce();
+  if (profile.num_edges != 0) {
+    profile.degree_skew =
+        std::sqrt(squared_deviations.reduce() / profile.num_nodes) /
+        profile.average_degree;
+  }
+  profile.is_power_law =
+      katana::analytics::IsApproximateDegreeDistributionPowerLaw(pg);
+
+  // the double sweep starts from the lowest node of maximum degree
+  katana::GReduceMin<Node> hub;
+  katana::do_all(
+      katana::iterate(topo),
+      [&](Node n) {
+        if (topo.OutDegree(n) == profile.max_degree) {
+          hub.update(n);
+        }
+      },
+      katana::no_stats());
+  auto [first_far, first_dist] = FarthestNode(topo, hub.reduce());
+  auto second = FarthestNode(topo, first_far);
+  profile.approximate_diameter = std::max(first_dist, second.second);
+
+  timer.stop();
+  return profile;
+}
+
+}  // namespace
+
+bool
+katana::analytics::GraphProfile::IsHighDiameter() const {
+  if (num_nodes < 2) {
+    return false;
+  }
+  return approximate_diameter >
+         PlanAdvisor::kHighDiameterFactor * std::ceil(std::log2(num_nodes));
+}
+
+void
+katana::analytics::GraphProfile::Print(std::ostream& os) const {
+  os << "Nodes = " << num_nodes << std::endl;
+  os << "Edges = " << num_edges << std::endl;
+  os << "Average degree = " << average_degree << std::endl;
+  os << "Max degree = " << max_degree << std::endl;
+  os << "Degree skew = " << degree_skew << std::endl;
+  os << "Power law = " << is_power_law << std::endl;
+  os << "Density = " << density << std::endl;
+  os << "Approximate diameter = " << approximate_diameter << std::endl;
+}
+
+const GraphProfile&
+katana::analytics::PlanAdvisor::Profile() {
+  if (!profile_) {
+    profile_ = ComputeProfile(*pg_);
+  }
+  return profile_.value();
+}
+
+ptrdiff_t
+katana::analytics::PlanAdvisor::EdgeTileSize() {
+  double edges = kEdgesPerTilePerDegree * Profile().average_degree;
+  ptrdiff_t tile_size = kMinEdgeTileSize;
+  while (tile_size < kMaxEdgeTileSize && tile_size < edges) {
+    tile_size *= 2;
+  }
+  return tile_size;
+}
+
+BfsPlan
+katana::analytics::PlanAdvisor::Bfs() {
+  if (Profile().IsHighDiameter()) {
+    return BfsPlan::AsynchronousTile(EdgeTileSize());
+  }
+  return BfsPlan::SynchronousDirectOpt();
+}
+
+ConnectedComponentsPlan
+katana::analytics::PlanAdvisor::ConnectedComponents() {
+  const GraphProfile& profile = Profile();
+  if (profile.num_nodes < kSerialMaxNodes) {
+    return ConnectedComponentsPlan::Serial();
+  }
+  if (profile.degree_skew > kSkewedDegree) {
+    return ConnectedComponentsPlan::EdgeTiledAfforest(EdgeTileSize());
+  }
+  return ConnectedComponentsPlan::Afforest();
+}
+
+TriangleCountPlan
+katana::analytics::PlanAdvisor::TriangleCount() {
+  const GraphProfile& profile = Profile();
+  if (!profile.is_power_law) {
+    return TriangleCountPlan::OrderedCount(
+        TriangleCountPlan::kDefaultEdgeSorted, TriangleCountPlan::kNoRelabel);
+  }
+  size_t hub_bitmap_budget = 0;
+  if (profile.max_degree >= HubBitmaps::kMinHubDegree) {
+    hub_bitmap_budget = kMaxHubBitmapBytes;
+  }
+  return TriangleCountPlan::OrderedCount(
+      TriangleCountPlan::kDefaultEdgeSorted, TriangleCountPlan::kRelabel,
+      hub_bitmap_budget);
+}
+
+PagerankPlan
+katana::analytics::PlanAdvisor::Pagerank(
+    float tolerance, unsigned int max_iterations, float alpha) {
+  const GraphProfile& profile = Profile();
+  uint64_t rank_bytes = profile.num_nodes * kPagerankBytesPerNode;
+  if (rank_bytes > static_cast<uint64_t>(LastLevelCacheBytes())) {
+    return PagerankPlan::PullBlocked(tolerance, max_iterations, alpha);
+  }
+  if (profile.IsHighDiameter()) {
+    return PagerankPlan::PushAsynchronous(tolerance, alpha);
+  }
+  return PagerankPlan::PullTopological(tolerance, max_iterations, alpha);
+}
+
+katana::Result<SsspPlan>
+katana::analytics::PlanAdvisor::Sssp(
+    const std::string& edge_weight_property_name) {
+  std::shared_ptr<arrow::ChunkedArray> weights =
+      KATANA_CHECKED(pg_->GetEdgeProperty(edge_weight_property_name));
+  if (!arrow::is_integer(weights->type()->id()) &&
+      !arrow::is_floating(weights->type()->id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "edge weights of type {} are not numeric",
+        weights->type()->ToString());
+  }
+  arrow::Datum doubles = KATANA_CHECKED_CONTEXT(
+      arrow::compute::Cast(weights, arrow::float64()),
+      "casting edge weights of type {}", weights->type()->ToString());
+
+  double max_weight = 0;
+  for (const auto& chunk : doubles.chunked_array()->chunks()) {
+    const auto& values = static_cast<const arrow::DoubleArray&>(*chunk);
+    katana::GReduceMax<double> chunk_max;
+    katana::do_all(
+        katana::iterate(int64_t{0}, values.length()),
+        [&](int64_t i) {
+          if (values.IsValid(i)) {
+            chunk_max.update(values.Value(i));
+          }
+        },
+        katana::no_stats());
+    max_weight = std::max(max_weight, chunk_max.reduce());
+  }
+
+  // the same step as Sssp picks for kAutomatic: about one new node along
+  // light edges per node per step
+  double delta = max_weight / std::max(Profile().average_degree, 1.0);
+  unsigned shift = 0;
+  while (shift < 30 && std::ldexp(1.0, shift + 1) <= delta) {
+    ++shift;
+  }
+  if (Profile().is_power_law) {
+    return SsspPlan::DeltaStep(shift);
+  }
+  return SsspPlan::DeltaStepAdaptive(shift);
+}
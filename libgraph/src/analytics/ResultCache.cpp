@@ -0,0 +1,163 @@
+#include "katana/analytics/ResultCache.h"
+
+#include <iomanip>
+
+#include <arrow/table.h>
+
+#include "katana/URI.h"
+
+namespace {
+
+/// The committed versions of the inputs of key, node properties first
+std::vector<uint64_t>
+InputVersions(
+    const std::string& rdg_dir, const katana::analytics::ResultKey& key) {
+  std::vector<uint64_t> versions;
+  for (const auto& name : key.node_inputs()) {
+    versions.emplace_back(
+        katana::TxnContext::CommittedNodePropertyVersion(rdg_dir, name));
+  }
+  for (const auto& name : key.edge_inputs()) {
+    versions.emplace_back(
+        katana::TxnContext::CommittedEdgePropertyVersion(rdg_dir, name));
+  }
+  return versions;
+}
+
+/// Whether txn_ctx wrote something that key reads; a result would then
+/// depend on writes that are not committed, so it is neither cached nor
+/// taken from the cache
+bool
+WroteInputs(
+    const katana::TxnContext& txn_ctx, const std::string& rdg_dir,
+    const katana::analytics::ResultKey& key) {
+  if (txn_ctx.AllPropertiesWrite() || txn_ctx.TopologyWrite()) {
+    return true;
+  }
+  for (const auto& name : key.node_inputs()) {
+    if (txn_ctx.NodePropertyWrite().count(katana::URI::JoinPath(
+            rdg_dir, name)) > 0) {
+      return true;
+    }
+  }
+  for (const auto& name : key.edge_inputs()) {
+    if (txn_ctx.EdgePropertyWrite().count(katana::URI::JoinPath(
+            rdg_dir, name)) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+std::string
+katana::analytics::ResultKey::ToString() const {
+  // newlines keep the parts apart, and the counts the kinds of parts
+  std::string res = fmt::format(
+      "{}\n{}\n{}\n{}", analytic_, parameters_.size(), node_inputs_.size(),
+      edge_inputs_.size());
+  for (const auto* parts : {&parameters_, &node_inputs_, &edge_inputs_}) {
+    for (const auto& part : *parts) {
+      res += "\n" + part;
+    }
+  }
+  return res;
+}
+
+katana::Result<void>
+katana::analytics::ResultCache::Run(
+    PropertyGraph* pg, const ResultKey& key, const std::string& output,
+    TxnContext* txn_ctx, const ComputeFn& compute) {
+  auto version = pg->CurrentVersion();
+  std::string rdg_dir = pg->rdg_dir();
+  if (!version || rdg_dir.empty() || WroteInputs(*txn_ctx, rdg_dir, key)) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++misses_;
+    }
+    return compute(output);
+  }
+
+  const std::string entry_key =
+      fmt::format("{}\n{}\n{}", rdg_dir, version.value(), key.ToString());
+  std::vector<uint64_t> input_versions = InputVersions(rdg_dir, key);
+
+  std::shared_ptr<arrow::ChunkedArray> column;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(entry_key);
+    if (it != index_.end()) {
+      if (it->second->input_versions == input_versions) {
+        column = it->second->column;
+        entries_.splice(entries_.begin(), entries_, it->second);
+      } else {
+        entries_.erase(it->second);
+        index_.erase(it);
+      }
+    }
+    if (column) {
+      ++hits_;
+    } else {
+      ++misses_;
+    }
+  }
+
+  if (column) {
+    // the result depends on the inputs as if it were computed again
+    txn_ctx->InsertNodePropertyRead(rdg_dir, key.node_inputs());
+    txn_ctx->InsertEdgePropertyRead(rdg_dir, key.edge_inputs());
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field(output, column->type())}), {column});
+    return pg->AddNodeProperties(table, txn_ctx);
+  }
+
+  KATANA_CHECKED(compute(output));
+  column = KATANA_CHECKED_CONTEXT(
+      pg->GetNodeProperty(output), "{} did not compute its output",
+      std::quoted(output));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(entry_key);
+  if (it != index_.end()) {
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  if (max_entries_ == 0) {
+    return ResultSuccess();
+  }
+  // the versions from before computing, in case an input changed meanwhile
+  entries_.emplace_front(
+      Entry{entry_key, std::move(input_versions), std::move(column)});
+  index_.emplace(entry_key, entries_.begin());
+  while (entries_.size() > max_entries_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  return ResultSuccess();
+}
+
+void
+katana::analytics::ResultCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+}
+
+size_t
+katana::analytics::ResultCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+uint64_t
+katana::analytics::ResultCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t
+katana::analytics::ResultCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
@@ -76,5 +76,58 @@ katana::analytics::SplitStringByComma(
   }
 }
 
+katana::Result<katana::NUMAArray<uint64_t>>
+katana::analytics::ReadCommunitySeed(
+    katana::PropertyGraph* pg, const CommunitySeed& seed) {
+  struct SeedLabel : public katana::PODProperty<uint64_t> {};
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<SeedLabel>, std::tuple<>>;
+
+  if (!pg->HasNodeProperty(seed.property_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Node Property: {} Not found",
+        seed.property_name);
+  }
+  for (uint32_t n : seed.changed_nodes) {
+    if (n >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "changed node {} is not in the graph of {} nodes", n,
+          pg->NumNodes());
+    }
+  }
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {seed.property_name}, {}));
+
+  katana::NUMAArray<uint64_t> labels;
+  labels.allocateBlocked(pg->NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) { labels[n] = graph.GetData<SeedLabel>(n); },
+      katana::no_stats());
+  return std::move(labels);
+}
+
+katana::Result<void>
+katana::analytics::SaveClusterCheckpoint(
+    Checkpointer* checkpointer, uint32_t iteration,
+    const katana::NUMAArray<uint64_t>& clusters) {
+  std::shared_ptr<arrow::Array> column =
+      KATANA_CHECKED(MakeCheckpointColumn<uint64_t>(
+          clusters.size(), [&](size_t n) { return clusters[n]; }));
+  return checkpointer->Save(
+      MakeCheckpointState(iteration, {"cluster"}, {column}));
+}
+
+katana::Result<katana::NUMAArray<uint64_t>>
+katana::analytics::ReadClusterCheckpoint(
+    const CheckpointState& state, uint64_t num_nodes) {
+  katana::NUMAArray<uint64_t> labels;
+  labels.allocateBlocked(num_nodes);
+  KATANA_CHECKED(RestoreCheckpointColumn<uint64_t>(
+      state, "cluster", num_nodes,
+      [&](size_t n, uint64_t cluster) { labels[n] = cluster; }));
+  return std::move(labels);
+}
+
 thread_local int
     katana::analytics::TemporaryPropertyGuard::temporary_property_counter = 0;
@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/NUMAArray.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Sampling.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+/// The dependencies of all nodes on one source, as in Brandes' algorithm.
+/// The scratch arrays span the graph but are only reset where the last
+/// traversal went, so a source costs the size of what it reaches.
+template <typename Graph, typename Dist>
+class SourceDependencies {
+public:
+  using Node = typename Graph::Node;
+  static constexpr Dist kInfinity = std::numeric_limits<Dist>::max();
+
+  void Allocate(size_t num_nodes) {
+    distance_.assign(num_nodes, kInfinity);
+    sigma_.assign(num_nodes, 0);
+    delta_.assign(num_nodes, 0);
+  }
+
+  /// Count the shortest paths from source in number of edges
+  void Bfs(const Graph& graph, Node source) {
+    distance_[source] = 0;
+    sigma_[source] = 1;
+    order_.push_back(source);
+    for (size_t i = 0; i < order_.size(); ++i) {
+      Node n = order_[i];
+      for (auto e : graph.OutEdges(n)) {
+        Node dst = graph.OutEdgeDst(e);
+        if (distance_[dst] == kInfinity) {
+          distance_[dst] = distance_[n] + 1;
+          order_.push_back(dst);
+        }
+        if (distance_[dst] == distance_[n] + 1) {
+          sigma_[dst] += sigma_[n];
+        }
+      }
+    }
+  }
+
+  /// Count the shortest paths from source for positive weights. A node is
+  /// settled after all of its predecessors on shortest paths, so its count
+  /// is final when it is settled.
+  template <typename WeightFn>
+  void Dijkstra(const Graph& graph, Node source, const WeightFn& weight) {
+    using Item = std::pair<Dist, Node>;
+    distance_[source] = 0;
+    sigma_[source] = 1;
+    heap_.clear();
+    heap_.emplace_back(0, source);
+    while (!heap_.empty()) {
+      std::pop_heap(heap_.begin(), heap_.end(), std::greater<Item>());
+      auto [dist, n] = heap_.back();
+      heap_.pop_back();
+      if (dist > distance_[n]) {
+        continue;
+      }
+      order_.push_back(n);
+      for (auto e : graph.OutEdges(n)) {
+        Node dst = graph.OutEdgeDst(e);
+        Dist new_dist = dist + weight(e);
+        if (new_dist < distance_[dst]) {
+          distance_[dst] = new_dist;
+          sigma_[dst] = sigma_[n];
+          heap_.emplace_back(new_dist, dst);
+          std::push_heap(heap_.begin(), heap_.end(), std::greater<Item>());
+        } else if (new_dist == distance_[dst]) {
+          sigma_[dst] += sigma_[n];
+        }
+      }
+    }
+  }
+
+  /// Compute the dependencies in decreasing order of distance and call
+  /// add(n, dependency) for each reached node n but the source. Then reset
+  /// the reached nodes for the next source.
+  template <typename WeightFn, typename AddFn>
+  void Accumulate(const Graph& graph, const WeightFn& weight, AddFn add) {
+    for (size_t i = order_.size(); i-- > 1;) {
+      Node n = order_[i];
+      double delta = 0;
+      for (auto e : graph.OutEdges(n)) {
+        Node dst = graph.OutEdgeDst(e);
+        if (distance_[dst] == distance_[n] + weight(e)) {
+          delta += sigma_[n] / sigma_[dst] * (1 + delta_[dst]);
+        }
+      }
+      delta_[n] = delta;
+      add(n, delta);
+    }
+    for (Node n : order_) {
+      distance_[n] = kInfinity;
+      sigma_[n] = 0;
+      delta_[n] = 0;
+    }
+    order_.clear();
+  }
+
+private:
+  std::vector<Dist> distance_;
+  std::vector<double> sigma_;
+  std::vector<double> delta_;
+  /// reached nodes in order of distance, source first
+  std::vector<Node> order_;
+  std::vector<std::pair<Dist, Node>> heap_;
+};
+
+/// Sample sources of graph until the centrality of every node is within the
+/// bound of sampling, and write the estimates to output_property_name.
+/// weight(e) is the length of edge e; unit lengths are traversed breadth
+/// first.
+template <typename Dist, typename Graph, typename WeightFn>
+katana::Result<ApproximateBetweennessCentralityStatistics>
+SampleSources(
+    katana::PropertyGraph* pg, const Graph& graph,
+    const BetweennessCentralitySampling& sampling, const WeightFn& weight,
+    bool unit_weights, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx) {
+  using Node = typename Graph::Node;
+  using Dependencies = SourceDependencies<Graph, Dist>;
+
+  const uint64_t num_nodes = graph.NumNodes();
+  const uint64_t num_edges = graph.NumEdges();
+
+  katana::NUMAArray<std::atomic<double>> sum;
+  katana::NUMAArray<std::atomic<double>> sum_squares;
+  sum.allocateBlocked(num_nodes);
+  sum_squares.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        sum[n] = 0;
+        sum_squares[n] = 0;
+      },
+      katana::no_stats());
+
+  ApproximateBetweennessCentralityStatistics stats{0, 0};
+  // a sample is the dependencies on a source divided by its probability and
+  // by (n - 1)(n - 2), so that it estimates the normalized centrality; range
+  // bounds its values
+  const double norm = num_nodes < 3 ? 1.0 : (num_nodes - 1.0) * (num_nodes - 2);
+  double range = 0;
+  katana::NUMAArray<uint64_t> degree_prefix;
+  if (sampling.distribution == BetweennessCentralitySampling::kDegree &&
+      num_edges > 0) {
+    degree_prefix.allocateBlocked(num_nodes);
+    katana::GReduceMin<uint64_t> min_degree;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](Node n) {
+          degree_prefix[n] = graph.OutDegree(n);
+          if (degree_prefix[n] > 0) {
+            min_degree.update(degree_prefix[n]);
+          }
+        },
+        katana::no_stats());
+    std::partial_sum(
+        degree_prefix.begin(), degree_prefix.end(), degree_prefix.begin());
+    range = num_edges / (min_degree.reduce() * (num_nodes - 1.0));
+  } else {
+    range = num_nodes / (num_nodes - 1.0);
+  }
+  // 1 / the probability to draw source
+  auto inverse_probability = [&](Node source) -> double {
+    if (degree_prefix.empty()) {
+      return num_nodes;
+    }
+    uint64_t before = source == 0 ? 0 : degree_prefix[source - 1];
+    return static_cast<double>(num_edges) / (degree_prefix[source] - before);
+  };
+  auto draw = [&](double u) -> Node {
+    if (degree_prefix.empty()) {
+      return std::min<uint64_t>(u * num_nodes, num_nodes - 1);
+    }
+    uint64_t target = std::min<uint64_t>(u * num_edges, num_edges - 1);
+    auto it =
+        std::upper_bound(degree_prefix.begin(), degree_prefix.end(), target);
+    return it - degree_prefix.begin();
+  };
+
+  if (num_nodes >= 3 && num_edges > 0) {
+    const double max_error = sampling.max_error;
+    const double failure = sampling.failure_probability;
+    // Hoeffding and a union bound over the nodes, with half of failure
+    const uint64_t max_sources = std::ceil(
+        range * range * std::log(4.0 * num_nodes / failure) /
+        (2 * max_error * max_error));
+    const uint64_t first_check = std::min<uint64_t>(
+        max_sources, std::max<uint64_t>(64, 4 * katana::getActiveThreads()));
+    uint64_t num_checks = 0;
+    for (uint64_t k = first_check; k < max_sources; k *= 2) {
+      ++num_checks;
+    }
+    // empirical Bernstein (Maurer and Pontil) at each check, two-sided, with
+    // the other half of failure split over the checks and the nodes
+    const double log_term =
+        std::log(8.0 * num_nodes * std::max<uint64_t>(num_checks, 1) / failure);
+
+    const uint64_t key = SamplingKey(sampling.seed);
+    katana::PerThreadStorage<Dependencies> dependencies;
+    katana::on_each([&](unsigned, unsigned) {
+      dependencies.getLocal()->Allocate(num_nodes);
+    });
+
+    katana::StatTimer exec_time(
+        "ApproximateLevel", "ApproximateBetweennessCentrality");
+    exec_time.start();
+    uint64_t done = 0;
+    uint64_t target = first_check;
+    while (true) {
+      katana::do_all(
+          katana::iterate(done, target),
+          [&](uint64_t i) {
+            Node source = draw(SampleUnit(key, i));
+            double scale = inverse_probability(source) / norm;
+            Dependencies& local = *dependencies.getLocal();
+            if (unit_weights) {
+              local.Bfs(graph, source);
+            } else {
+              local.Dijkstra(graph, source, weight);
+            }
+            local.Accumulate(graph, weight, [&](Node n, double delta) {
+              double x = delta * scale;
+              katana::atomicAdd(sum[n], x);
+              katana::atomicAdd(sum_squares[n], x * x);
+            });
+          },
+          katana::steal(), katana::loopname("SampledSources"));
+      done = target;
+
+      if (done >= max_sources) {
+        stats.max_error = max_error;
+        break;
+      }
+      katana::GReduceMax<double> worst;
+      katana::do_all(
+          katana::iterate(graph),
+          [&](Node n) {
+            double mean = sum[n] / done;
+            double variance = std::max(
+                0.0, (sum_squares[n] - done * mean * mean) / (done - 1));
+            worst.update(
+                std::sqrt(2 * variance * log_term / done) +
+                7 * range * log_term / (3.0 * (done - 1)));
+          },
+          katana::no_stats());
+      stats.max_error = worst.reduce();
+      if (stats.max_error <= max_error) {
+        break;
+      }
+      target = std::min(2 * done, max_sources);
+    }
+    exec_time.stop();
+    stats.num_sources = done;
+  }
+  katana::ReportStatSingle(
+      "ApproximateBetweennessCentrality", "Sources", stats.num_sources);
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeBC>>(
+      txn_ctx, {output_property_name}));
+  using OutputGraph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<NodeBC>, std::tuple<>>;
+  auto output =
+      KATANA_CHECKED(OutputGraph::Make(pg, {output_property_name}, {}));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        output.template GetData<NodeBC>(n) =
+            stats.num_sources == 0 ? 0 : sum[n] / stats.num_sources * norm;
+      },
+      katana::no_stats(), katana::loopname("ExtractBC"));
+  return stats;
+}
+
+template <typename Weight>
+katana::Result<ApproximateBetweennessCentralityStatistics>
+SampleWeighted(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const BetweennessCentralitySampling& sampling,
+    const std::string& edge_weight_property_name) {
+  using EdgeWeight = katana::PODProperty<Weight>;
+  using Graph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<>,
+      std::tuple<EdgeWeight>>;
+  using Dist =
+      std::conditional_t<std::is_floating_point_v<Weight>, double, uint64_t>;
+
+  Graph graph =
+      KATANA_CHECKED(Graph::Make(pg, {}, {edge_weight_property_name}));
+
+  katana::GAccumulator<uint64_t> non_positive;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](typename Graph::Node n) {
+        for (auto e : graph.OutEdges(n)) {
+          if (!(graph.template GetEdgeData<EdgeWeight>(e) > 0)) {
+            non_positive += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (non_positive.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} edges of {} do not have positive weights", non_positive.reduce(),
+        edge_weight_property_name);
+  }
+
+  auto weight = [&](auto e) -> Dist {
+    return graph.template GetEdgeData<EdgeWeight>(e);
+  };
+  return SampleSources<Dist>(
+      pg, graph, sampling, weight, false, output_property_name, txn_ctx);
+}
+
+}  // namespace
+
+katana::Result<ApproximateBetweennessCentralityStatistics>
+katana::analytics::ApproximateBetweennessCentrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const BetweennessCentralitySampling& sampling,
+    const std::string& edge_weight_property_name) {
+  if (!(sampling.max_error > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "max_error must be positive");
+  }
+  if (!(sampling.failure_probability > 0 &&
+        sampling.failure_probability < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "failure_probability must be in (0, 1)");
+  }
+  katana::ReportPageAllocGuard page_alloc;
+
+  if (edge_weight_property_name.empty()) {
+    using Graph = katana::TypedPropertyGraphView<
+        katana::PropertyGraphViews::Default, std::tuple<>, std::tuple<>>;
+    Graph graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+    auto unit = [](auto) -> uint32_t { return 1; };
+    return SampleSources<uint32_t>(
+        pg, graph, sampling, unit, true, output_property_name, txn_ctx);
+  }
+
+  auto weights = KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name));
+  switch (weights->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return SampleWeighted<uint32_t>(
+        pg, output_property_name, txn_ctx, sampling, edge_weight_property_name);
+  case arrow::Int32Type::type_id:
+    return SampleWeighted<int32_t>(
+        pg, output_property_name, txn_ctx, sampling, edge_weight_property_name);
+  case arrow::UInt64Type::type_id:
+    return SampleWeighted<uint64_t>(
+        pg, output_property_name, txn_ctx, sampling, edge_weight_property_name);
+  case arrow::Int64Type::type_id:
+    return SampleWeighted<int64_t>(
+        pg, output_property_name, txn_ctx, sampling, edge_weight_property_name);
+  case arrow::FloatType::type_id:
+    return SampleWeighted<float>(
+        pg, output_property_name, txn_ctx, sampling, edge_weight_property_name);
+  case arrow::DoubleType::type_id:
+    return SampleWeighted<double>(
+        pg, output_property_name, txn_ctx, sampling, edge_weight_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        weights->type()->ToString());
+  }
+}
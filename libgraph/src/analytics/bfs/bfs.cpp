@@ -19,11 +19,15 @@
 
 #include "katana/analytics/bfs/bfs.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <type_traits>
+#include <vector>
 
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/Prefetch.h"
 #include "katana/Result.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
@@ -116,28 +120,6 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void
-WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
-  katana::do_all(
-      katana::iterate(wl), [&](const GNode& src) { bitset->set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
-}
-
-template <typename G, typename WL>
-void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
-  wl->clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
-        }
-      },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
-}
-
 template <typename T, typename P, typename R>
 void
 AsynchronousAlgo(
@@ -216,107 +198,252 @@ AsynchronousAlgo(
   }
 }
 
+constexpr size_t kBitsPerWord = 64;
+constexpr unsigned kWordChunkSize = kChunkSize / kBitsPerWord;
+
+/// A BFS frontier. Top-down steps push onto a sparse bag of nodes while
+/// bottom-up steps test membership in a dense bitmap; the frontier converts
+/// between the two when the traversal changes direction.
+///
+/// Invariant: the bitmap is all zeros while the frontier is sparse, and the
+/// bag is empty while the frontier is dense.
+class Frontier {
+public:
+  explicit Frontier(size_t num_nodes) { dense_.resize(num_nodes); }
+
+  bool is_dense() const { return is_dense_; }
+
+  bool empty() const { return is_dense_ ? dense_count_ == 0 : sparse_.empty(); }
+
+  katana::InsertBag<GNode>& sparse() {
+    KATANA_LOG_DEBUG_ASSERT(!is_dense_);
+    return sparse_;
+  }
+
+  const katana::DynamicBitset& dense() const {
+    KATANA_LOG_DEBUG_ASSERT(is_dense_);
+    return dense_;
+  }
+
+  /// Bottom-up steps fill the bitmap directly and report how many nodes they
+  /// set
+  katana::DynamicBitset& dense(uint64_t count) {
+    KATANA_LOG_DEBUG_ASSERT(is_dense_);
+    dense_count_ = count;
+    return dense_;
+  }
+
+  void Clear() {
+    if (is_dense_) {
+      dense_.reset();
+      dense_count_ = 0;
+    } else {
+      sparse_.clear();
+    }
+  }
+
+  void ToDense() {
+    if (is_dense_) {
+      return;
+    }
+    katana::GAccumulator<uint64_t> count;
+    katana::do_all(
+        katana::iterate(sparse_),
+        [&](const GNode& src) {
+          dense_.set(src);
+          count += 1;
+        },
+        katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
+    sparse_.clear();
+    dense_count_ = count.reduce();
+    is_dense_ = true;
+  }
+
+  void ToSparse() {
+    if (!is_dense_) {
+      return;
+    }
+    const auto& words = dense_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) {
+          uint64_t word = words[w].load(std::memory_order_relaxed);
+          while (word != 0) {
+            uint64_t bit = __builtin_ctzll(word);
+            word &= word - 1;
+            sparse_.push(static_cast<GNode>(w * kBitsPerWord + bit));
+          }
+        },
+        katana::chunk_size<kWordChunkSize>(), katana::loopname("BitsetToWl"));
+    dense_.reset();
+    dense_count_ = 0;
+    is_dense_ = false;
+  }
+
+private:
+  katana::InsertBag<GNode> sparse_;
+  katana::DynamicBitset dense_;
+  uint64_t dense_count_{0};
+  bool is_dense_{false};
+};
+
+/// One top-down step: the nodes of the sparse \p frontier claim their
+/// unvisited out-neighbors. Returns the number of out-edges of the new
+/// frontier.
+uint64_t
+TopDownStep(
+    const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
+    Frontier* frontier, Frontier* next, katana::DynamicBitset* visited) {
+  katana::GAccumulator<uint64_t> scout_count;
+  auto& next_bag = next->sparse();
+
+  katana::do_all(
+      katana::iterate(frontier->sparse()),
+      [&](const GNode& src) {
+        for (auto e : bidir_view.OutEdges(src)) {
+          auto dst = bidir_view.OutEdgeDst(e);
+          GNode& ddata = (*node_data)[dst];
+          if (ddata == BfsImplementation::kDistanceInfinity) {
+            GNode old_parent = ddata;
+            if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
+              visited->set(dst);
+              next_bag.push(dst);
+              scout_count += bidir_view.OutDegree(dst);
+            }
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(),
+      katana::loopname("SyncDO-push"));
+
+  return scout_count.reduce();
+}
+
+/// One bottom-up step: every unvisited node looks for a parent in the dense
+/// \p frontier among its in-neighbors. Nodes are taken a bitmap word at a
+/// time, so a word of nodes that are all visited costs a single load, and
+/// each word of \p visited and of the new frontier is written by exactly one
+/// thread without atomic read-modify-writes. Returns the number of nodes in
+/// the new frontier.
+uint64_t
+BottomUpStep(
+    const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
+    const Frontier& frontier, Frontier* next, katana::DynamicBitset* visited) {
+  katana::GAccumulator<uint64_t> found;
+  const auto& front_bitset = frontier.dense();
+  auto& next_words = next->dense(0).get_vec();
+  auto& visited_words = visited->get_vec();
+  size_t num_nodes = bidir_view.NumNodes();
+  // the frontier words of the sources are random reads
+  const auto& front_words = front_bitset.get_vec();
+  auto pipeline = katana::MakePrefetchPipeline(
+      bidir_view.NumEdges(), [&](uint64_t e) {
+        return &front_words[bidir_view.InEdgeSrc(e) / kBitsPerWord];
+      });
+
+  katana::do_all(
+      katana::iterate(size_t{0}, visited_words.size()),
+      [&](size_t w) {
+        uint64_t visited_word =
+            visited_words[w].load(std::memory_order_relaxed);
+        uint64_t unvisited = ~visited_word;
+        size_t base = w * kBitsPerWord;
+        if (base + kBitsPerWord > num_nodes) {
+          unvisited &= (uint64_t{1} << (num_nodes - base)) - 1;
+        }
+
+        uint64_t found_word = 0;
+        while (unvisited != 0) {
+          uint64_t bit = __builtin_ctzll(unvisited);
+          unvisited &= unvisited - 1;
+          auto dst = static_cast<GNode>(base + bit);
+          for (auto e : bidir_view.InEdges(dst)) {
+            pipeline.Ahead(e);
+            auto src = bidir_view.InEdgeSrc(e);
+            if (front_bitset.test(src)) {
+              // assign parents on the bfs path.
+              (*node_data)[dst] = src;
+              found_word |= uint64_t{1} << bit;
+              break;
+            }
+          }
+        }
+
+        if (found_word != 0) {
+          next_words[w].store(found_word, std::memory_order_relaxed);
+          visited_words[w].store(
+              visited_word | found_word, std::memory_order_relaxed);
+          found += __builtin_popcountll(found_word);
+        }
+      },
+      katana::steal(), katana::chunk_size<kWordChunkSize>(),
+      katana::loopname("SyncDO-pull"));
+
+  uint64_t num_found = found.reduce();
+  next->dense(num_found);
+  return num_found;
+}
+
+/// Direction optimizing BFS: top-down steps over a sparse frontier while the
+/// frontier is small, bottom-up steps over a dense frontier while it covers a
+/// large part of the graph. The traversal switches to bottom-up when the
+/// out-edges of the frontier exceed 1/alpha of the edges not yet explored,
+/// and back to top-down once the frontier shrinks below 1/beta of the nodes.
 template <typename P>
 void
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
     const GNode source, const P& pushWrap, const uint32_t alpha,
     const uint32_t beta) {
-  using Cont = katana::InsertBag<GNode>;
-  using Loop = katana::DoAll;
-
-  katana::GAccumulator<uint32_t> work_items;
   katana::StatTimer bitset_to_wl_timer("Bitset_To_WL_Timer");
   katana::StatTimer wl_to_bitset_timer("WL_To_Bitset_Timer");
 
-  Loop loop;
-
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
-
   uint32_t num_nodes = bidir_view.NumNodes();
   uint64_t num_edges = bidir_view.NumEdges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
+  katana::DynamicBitset visited;
+  visited.resize(num_nodes);
 
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  auto frontier = std::make_unique<Frontier>(num_nodes);
+  auto next_frontier = std::make_unique<Frontier>(num_nodes);
 
   (*node_data)[source] = source;
+  visited.set(source);
 
-  pushWrap(*next_frontier, source, "parallel");
-
-  work_items += 1;
+  pushWrap(frontier->sparse(), source, "parallel");
 
   int64_t edges_to_check = num_edges;
   int64_t scout_count = bidir_view.OutDegree(source);
-  uint64_t old_num_work_items{0};
-
-  katana::GAccumulator<uint64_t> writes_pull;
-  katana::GAccumulator<uint64_t> writes_push;
 
-  while (!next_frontier->empty()) {
-    std::swap(frontier, next_frontier);
-    next_frontier->clear();
+  while (!frontier->empty()) {
     if (scout_count > edges_to_check / alpha) {
       wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
+      frontier->ToDense();
+      next_frontier->ToDense();
       wl_to_bitset_timer.stop();
+
+      uint64_t num_found = scout_count;
+      uint64_t old_num_found{0};
       do {
-        old_num_work_items = work_items.reduce();
-        work_items.reset();
-
-        loop(
-            katana::iterate(bidir_view),
-            [&](const GNode& dst) {
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                for (auto e : bidir_view.InEdges(dst)) {
-                  auto src = bidir_view.InEdgeSrc(e);
-
-                  if (front_bitset.test(src)) {
-                    // assign parents on the bfs path.
-                    ddata = src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
-                }
-              }
-            },
-            katana::steal(), katana::chunk_size<kChunkSize>(),
-            katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
-      } while (work_items.reduce() >= old_num_work_items ||
-               (work_items.reduce() > num_nodes / beta));
+        old_num_found = num_found;
+        num_found = BottomUpStep(
+            bidir_view, node_data, *frontier, next_frontier.get(), &visited);
+        std::swap(frontier, next_frontier);
+        next_frontier->Clear();
+      } while (num_found >= old_num_found || (num_found > num_nodes / beta));
+
       bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
+      frontier->ToSparse();
+      next_frontier->ToSparse();
       bitset_to_wl_timer.stop();
       scout_count = 1;
     } else {
       edges_to_check -= scout_count;
-      work_items.reset();
-
-      loop(
-          katana::iterate(*frontier),
-          [&](const GNode& src) {
-            for (auto e : bidir_view.OutEdges(src)) {
-              auto dst = bidir_view.OutEdgeDst(e);
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                GNode old_parent = ddata;
-                if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
-                  next_frontier->push(dst);
-                  work_items += bidir_view.OutDegree(dst);
-                }
-              }
-            }
-          },
-          katana::steal(), katana::chunk_size<kChunkSize>(),
-          katana::loopname(std::string("SyncDO-push").c_str()));
-      scout_count = work_items.reduce();
+      scout_count = TopDownStep(
+          bidir_view, node_data, frontier.get(), next_frontier.get(),
+          &visited);
+      std::swap(frontier, next_frontier);
+      next_frontier->Clear();
     }
   }
 }
@@ -474,6 +601,361 @@ katana::analytics::Bfs(
   return BfsImpl(&graph, bidir_view, start_node, algo);
 }
 
+namespace {
+
+using EdgeTypeAwareView = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+
+/// Level synchronous top down BFS over the out-edges of edge_types. A node
+/// takes as its parent the first node of the previous level to claim it.
+void
+BfsByEdgeTypeImpl(
+    const EdgeTypeAwareView& view,
+    const std::vector<katana::EntityTypeID>& edge_types, GNode source,
+    katana::NUMAArray<std::atomic<GNode>>* parent) {
+  constexpr GNode kUnvisited = BfsImplementation::kDistanceInfinity;
+  katana::do_all(
+      katana::iterate(view.Nodes()),
+      [&](const GNode& n) {
+        (*parent)[n].store(kUnvisited, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  (*parent)[source].store(source, std::memory_order_relaxed);
+
+  katana::InsertBag<GNode> frontiers[2];
+  size_t current = 0;
+  frontiers[current].push(source);
+  while (!frontiers[current].empty()) {
+    katana::InsertBag<GNode>& next = frontiers[1 - current];
+    katana::do_all(
+        katana::iterate(frontiers[current]),
+        [&](const GNode& src) {
+          for (const katana::EntityTypeID& type : edge_types) {
+            for (auto e : view.OutEdges(src, type)) {
+              GNode dst = view.OutEdgeDst(e);
+              auto& dst_parent = (*parent)[dst];
+              GNode expected = kUnvisited;
+              if (dst_parent.load(std::memory_order_relaxed) == kUnvisited &&
+                  dst_parent.compare_exchange_strong(
+                      expected, src, std::memory_order_relaxed)) {
+                next.push(dst);
+              }
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("BfsByEdgeType"));
+    frontiers[current].clear();
+    current = 1 - current;
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BfsByEdgeType(
+    PropertyGraph* pg, uint32_t start_node,
+    const std::vector<std::string>& edge_types,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  if (start_node >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "start node {} is not a node",
+        start_node);
+  }
+  auto view = pg->BuildView<EdgeTypeAwareView>();
+  std::vector<katana::EntityTypeID> types =
+      KATANA_CHECKED(EdgeTypesToTraverse(*pg, view, edge_types));
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<BfsNodeParent>>(
+      txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::NUMAArray<std::atomic<GNode>> parent;
+  parent.allocateInterleaved(pg->NumNodes());
+  katana::StatTimer exec_time("BfsByEdgeType");
+  exec_time.start();
+  BfsByEdgeTypeImpl(view, types, start_node, &parent);
+  exec_time.stop();
+
+  katana::do_all(katana::iterate(graph), [&](const GNode& n) {
+    graph.GetData<BfsNodeParent>(n) =
+        parent[n].load(std::memory_order_relaxed);
+  });
+  return katana::ResultSuccess();
+}
+
+namespace {
+
+/// The tag for the output properties of MultiSourceBfs, which hold levels
+/// rather than the parents that Bfs stores.
+struct BfsNodeLevel : public katana::PODProperty<uint32_t> {};
+
+using LevelGraph =
+    katana::TypedPropertyGraph<std::tuple<BfsNodeLevel>, std::tuple<>>;
+
+/// Levels from up to kMultiSourceBfsBatchSize sources at once. Bit i of a
+/// node's words stands for sources[i] and (*levels)[i] receives its levels.
+///
+/// A round pushes the frontier bits of every active node to its
+/// out-neighbors, then turns the bits a node received for the first time
+/// into its next frontier. Nodes adjacent to several sources' frontiers are
+/// visited once per round instead of once per source.
+void
+MultiSourceBfsBatch(
+    const std::vector<GNode>& sources, std::vector<LevelGraph>* levels) {
+  KATANA_LOG_DEBUG_ASSERT(!sources.empty());
+  KATANA_LOG_DEBUG_ASSERT(sources.size() <= kMultiSourceBfsBatchSize);
+  KATANA_LOG_DEBUG_ASSERT(sources.size() == levels->size());
+
+  constexpr auto kUnvisited = BfsImplementation::kDistanceInfinity;
+  const LevelGraph& graph = levels->front();
+  size_t num_nodes = graph.NumNodes();
+
+  katana::NUMAArray<uint64_t> seen;
+  katana::NUMAArray<uint64_t> frontier;
+  katana::NUMAArray<std::atomic<uint64_t>> next;
+  seen.allocateInterleaved(num_nodes);
+  frontier.allocateInterleaved(num_nodes);
+  next.allocateInterleaved(num_nodes);
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        seen[n] = 0;
+        frontier[n] = 0;
+        next[n].store(0, std::memory_order_relaxed);
+        for (auto& output : *levels) {
+          output.GetData<BfsNodeLevel>(n) = kUnvisited;
+        }
+      },
+      katana::no_stats());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    uint64_t bit = uint64_t{1} << i;
+    seen[sources[i]] |= bit;
+    frontier[sources[i]] |= bit;
+    (*levels)[i].GetData<BfsNodeLevel>(sources[i]) = 0;
+  }
+
+  uint32_t level = 0;
+  katana::GReduceLogicalOr changed;
+  do {
+    ++level;
+    changed.reset();
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& src) {
+          uint64_t front = frontier[src];
+          if (front == 0) {
+            return;
+          }
+          for (auto e : graph.OutEdges(src)) {
+            auto dst = graph.OutEdgeDst(e);
+            // seen is only written in the next loop, so reading it is safe
+            uint64_t fresh = front & ~seen[dst];
+            // Skip the atomic when another node already delivered the bits
+            if ((fresh & ~next[dst].load(std::memory_order_relaxed)) != 0) {
+              next[dst].fetch_or(fresh, std::memory_order_relaxed);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("MultiSourceBfs-push"));
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          uint64_t fresh = next[n].load(std::memory_order_relaxed);
+          frontier[n] = fresh;
+          if (fresh == 0) {
+            return;
+          }
+          next[n].store(0, std::memory_order_relaxed);
+          seen[n] |= fresh;
+          changed.update(true);
+          while (fresh != 0) {
+            uint64_t i = __builtin_ctzll(fresh);
+            fresh &= fresh - 1;
+            (*levels)[i].GetData<BfsNodeLevel>(n) = level;
+          }
+        },
+        katana::chunk_size<kChunkSize>(),
+        katana::loopname("MultiSourceBfs-update"));
+  } while (changed.reduce());
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names,
+    katana::TxnContext* txn_ctx) {
+  if (sources.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} output properties", sources.size(),
+        output_property_names.size());
+  }
+  for (auto source : sources) {
+    if (source >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+
+  katana::StatTimer exec_time("MultiSourceBfs");
+  for (size_t begin = 0; begin < sources.size();
+       begin += kMultiSourceBfsBatchSize) {
+    size_t end = std::min(sources.size(), begin + kMultiSourceBfsBatchSize);
+
+    std::vector<GNode> batch;
+    std::vector<LevelGraph> levels;
+    for (size_t i = begin; i < end; ++i) {
+      KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<BfsNodeLevel>>(
+          txn_ctx, {output_property_names[i]}));
+      levels.emplace_back(
+          KATANA_CHECKED(LevelGraph::Make(pg, {output_property_names[i]}, {})));
+      batch.emplace_back(sources[i]);
+    }
+
+    exec_time.start();
+    MultiSourceBfsBatch(batch, &levels);
+    exec_time.stop();
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::DistributedBfs(
+    PropertyGraph* pg, MirrorSync* sync, uint32_t num_owned,
+    uint32_t start_node, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx) {
+  // Check the arguments of all hosts together, so that they all fail or
+  // none does: the low word counts sources and the high word bad arguments
+  bool has_source = start_node != kDistributedBfsNoSource;
+  bool bad = num_owned > pg->NumNodes() ||
+             (has_source && start_node >= num_owned);
+  uint64_t check = KATANA_CHECKED(sync->AllReduce<uint64_t>(
+      uint64_t{has_source} + (uint64_t{bad} << 32),
+      [](uint64_t a, uint64_t b) { return a + b; }));
+  if ((check >> 32) != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} hosts have a source they do not own or more owned nodes than "
+        "nodes",
+        check >> 32);
+  }
+  if (check != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} hosts have a source; exactly one should", check);
+  }
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<BfsNodeLevel>>(
+      txn_ctx, {output_property_name}));
+  LevelGraph graph =
+      KATANA_CHECKED(LevelGraph::Make(pg, {output_property_name}, {}));
+
+  katana::StatTimer exec_time("DistributedBfs");
+  exec_time.start();
+
+  constexpr auto kUnvisited = BfsImplementation::kDistanceInfinity;
+  size_t num_nodes = graph.NumNodes();
+
+  katana::NUMAArray<uint32_t> levels;
+  levels.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(levels.begin(), levels.end(), kUnvisited);
+
+  // frontier holds the owned nodes to expand; reached holds the nodes that
+  // got a level this round and serves as the dirty set of sync
+  katana::DynamicBitset frontier;
+  katana::DynamicBitset reached;
+  frontier.resize(num_nodes);
+  reached.resize(num_nodes);
+  if (has_source) {
+    levels[start_node] = 0;
+    frontier.set(start_node);
+  }
+
+  uint32_t level = 0;
+  for (;;) {
+    ++level;
+
+    // Levels are only read here, so the check for unvisited nodes is safe
+    katana::do_all(
+        katana::iterate(GNode{0}, GNode{num_owned}),
+        [&](const GNode& src) {
+          if (!frontier.test(src)) {
+            return;
+          }
+          for (auto e : graph.OutEdges(src)) {
+            auto dst = graph.OutEdgeDst(e);
+            if (levels[dst] == kUnvisited) {
+              reached.set(dst);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("DistributedBfs-push"));
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          if (reached.test(n)) {
+            levels[n] = level;
+          }
+        },
+        katana::no_stats());
+
+    // Reached mirrors go to their masters, which keep the lowest level;
+    // those that did not have one before are the next frontier
+    KATANA_CHECKED(sync->Reduce(
+        levels.data(), &reached,
+        [](uint32_t a, uint32_t b) { return std::min(a, b); }));
+    katana::GAccumulator<uint64_t> frontier_size;
+    katana::do_all(
+        katana::iterate(GNode{0}, GNode{num_owned}),
+        [&](const GNode& n) {
+          if (reached.test(n) && levels[n] == level) {
+            frontier.set(n);
+            frontier_size += 1;
+          } else {
+            frontier.reset(n);
+          }
+        },
+        katana::no_stats());
+    reached.reset();
+
+    uint64_t total = KATANA_CHECKED(sync->AllReduce<uint64_t>(
+        frontier_size.reduce(),
+        [](uint64_t a, uint64_t b) { return a + b; }));
+    if (total == 0) {
+      break;
+    }
+  }
+
+  // Give mirrors the final levels of their masters
+  katana::do_all(
+      katana::iterate(GNode{0}, GNode{num_owned}),
+      [&](const GNode& n) {
+        if (levels[n] != kUnvisited) {
+          reached.set(n);
+        }
+      },
+      katana::no_stats());
+  KATANA_CHECKED(sync->Broadcast(levels.data(), &reached));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<BfsNodeLevel>(n) = levels[n]; },
+      katana::no_stats());
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
 template <typename LevelVec>
 void
 ComputeLevels(
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Graph = katana::PropertyGraphViews::Temporal;
+using Node = Graph::Node;
+using Timestamp = katana::TemporalTopology::Timestamp;
+
+constexpr Timestamp kUnreached = katana::TemporalTopology::kNoTimestamp;
+constexpr unsigned kChunkSize = 64U;
+
+katana::Result<void>
+CheckArguments(
+    katana::PropertyGraph* pg, uint32_t start_node, const TimeWindow& window) {
+  KATANA_CHECKED(window.Validate());
+  if (start_node >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "start node {} is not a node",
+        start_node);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Rounds of relaxations from a frontier of nodes whose arrival time
+/// improved. done[n] is the arrival time n was last expanded with; its
+/// out-edges from done[n] on were followed then, so only [arrival, done[n])
+/// is left.
+void
+ComputeArrivals(
+    const Graph& graph, Node source, const TimeWindow& window,
+    katana::NUMAArray<std::atomic<Timestamp>>* arrival) {
+  katana::NUMAArray<Timestamp> done;
+  done.allocateBlocked(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        (*arrival)[n].store(kUnreached, std::memory_order_relaxed);
+        done[n] = window.end;
+      },
+      katana::no_stats(), katana::loopname("TemporalReachability_Init"));
+
+  katana::DynamicBitset queued;
+  queued.resize(graph.NumNodes());
+  auto curr = std::make_unique<katana::InsertBag<Node>>();
+  auto next = std::make_unique<katana::InsertBag<Node>>();
+
+  (*arrival)[source] = window.begin;
+  next->push(source);
+  uint32_t rounds = 0;
+  while (!next->empty()) {
+    std::swap(curr, next);
+    next->clear();
+    queued.reset();
+    ++rounds;
+
+    katana::do_all(
+        katana::iterate(*curr),
+        [&](const Node& src) {
+          Timestamp a = (*arrival)[src].load(std::memory_order_relaxed);
+          Timestamp followed = done[src];
+          if (a >= followed) {
+            return;
+          }
+          done[src] = a;
+          for (auto e : graph.OutEdges(src, a, followed)) {
+            Node dst = graph.OutEdgeDst(e);
+            Timestamp t = graph.OutEdgeTimestamp(e);
+            if (katana::atomicMin((*arrival)[dst], t) > t && !queued.set(dst)) {
+              next->push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("TemporalReachability"));
+  }
+  katana::ReportStatSingle("TemporalReachability", "Rounds", rounds);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::TemporalReachability(
+    katana::PropertyGraph* pg, uint32_t start_node, const TimeWindow& window,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(CheckArguments(pg, start_node, window));
+  Graph graph =
+      KATANA_CHECKED(pg->BuildView<Graph>(window.timestamp_property));
+  const uint64_t num_nodes = graph.NumNodes();
+
+  katana::NUMAArray<std::atomic<Timestamp>> arrival;
+  arrival.allocateBlocked(num_nodes);
+
+  katana::StatTimer exec_time("TemporalReachability", "TemporalReachability");
+  exec_time.start();
+  ComputeArrivals(graph, start_node, window, &arrival);
+  exec_time.stop();
+
+  std::shared_ptr<arrow::Buffer> buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(num_nodes * sizeof(Timestamp)));
+  auto* values = reinterpret_cast<Timestamp*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        values[n] = arrival[n].load(std::memory_order_relaxed);
+      },
+      katana::no_stats(), katana::loopname("TemporalReachability_Output"));
+
+  auto array = std::make_shared<arrow::Int64Array>(num_nodes, buffer);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::int64())}),
+      {array});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::TemporalReachabilityAssertValid(
+    katana::PropertyGraph* pg, uint32_t start_node, const TimeWindow& window,
+    const std::string& property_name) {
+  KATANA_CHECKED(CheckArguments(pg, start_node, window));
+  Graph graph =
+      KATANA_CHECKED(pg->BuildView<Graph>(window.timestamp_property));
+  auto arrival =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<int64_t>(property_name));
+
+  if (arrival->Value(start_node) != window.begin) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "start node {} arrives at {}, not at the beginning of the window {}",
+        start_node, arrival->Value(start_node), window.begin);
+  }
+
+  // every usable edge is no earlier than the arrival at its destination, and
+  // every reached node other than the start node is reached by one of them
+  katana::DynamicBitset reached_by_edge;
+  reached_by_edge.resize(graph.NumNodes());
+  katana::GAccumulator<uint64_t> late_nodes;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& src) {
+        Timestamp a = arrival->Value(src);
+        if (a == kUnreached) {
+          return;
+        }
+        for (auto e : graph.OutEdges(src, a, window.end)) {
+          Node dst = graph.OutEdgeDst(e);
+          Timestamp t = graph.OutEdgeTimestamp(e);
+          if (arrival->Value(dst) > t) {
+            late_nodes += 1;
+          } else if (arrival->Value(dst) == t) {
+            reached_by_edge.set(dst);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("TemporalReachability_Check"));
+  if (late_nodes.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} edges reach their destination earlier than its arrival time",
+        late_nodes.reduce());
+  }
+
+  katana::GAccumulator<uint64_t> unsupported;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        if (n != start_node && arrival->Value(n) != kUnreached &&
+            !reached_by_edge.test(n)) {
+          unsupported += 1;
+        }
+      },
+      katana::no_stats(), katana::loopname("TemporalReachability_Support"));
+  if (unsupported.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} nodes have an arrival time that no edge reaches them at",
+        unsupported.reduce());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<TemporalReachabilityStatistics>
+katana::analytics::TemporalReachabilityStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto arrival =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<int64_t>(property_name));
+
+  katana::GAccumulator<uint64_t> reached;
+  katana::GReduceMax<Timestamp> latest;
+  katana::do_all(
+      katana::iterate(int64_t{0}, arrival->length()),
+      [&](int64_t i) {
+        Timestamp a = arrival->Value(i);
+        if (a != kUnreached) {
+          reached += 1;
+          latest.update(a);
+        }
+      },
+      katana::no_stats(), katana::loopname("TemporalReachability_Statistics"));
+
+  return TemporalReachabilityStatistics{reached.reduce(), latest.reduce()};
+}
+
+void
+katana::analytics::TemporalReachabilityStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of reached nodes = " << n_reached_nodes << std::endl;
+  os << "Latest arrival time = " << latest_arrival << std::endl;
+}
@@ -0,0 +1,672 @@
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+struct EdgeMatched : public katana::PODProperty<uint8_t> {};
+
+using EdgeData = std::tuple<EdgeMatched>;
+using Graph = katana::TypedPropertyGraph<std::tuple<>, EdgeData>;
+
+using GNode = katana::GraphTopology::Node;
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+enum Side : uint8_t { kNeither, kLeft, kRight };
+
+/// The bipartite graph between the left and the right nodes: every left or
+/// right node has the list of its neighbors on the other side, whichever way
+/// the edges point
+class Bipartition {
+public:
+  static katana::Result<Bipartition> Make(
+      katana::PropertyGraph* pg, const std::string& left_node_type,
+      const std::string& right_node_type) {
+    if (!pg->HasAtomicNodeType(left_node_type)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "no node type {}", left_node_type);
+    }
+    if (!pg->HasAtomicNodeType(right_node_type)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "no node type {}", right_node_type);
+    }
+    if (left_node_type == right_node_type) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "left and right node types are the same");
+    }
+
+    Bipartition bipartition;
+    KATANA_CHECKED(bipartition.Build(pg, left_node_type, right_node_type));
+    return bipartition;
+  }
+
+  uint32_t num_nodes() const { return side_.size(); }
+  const std::vector<GNode>& left_nodes() const { return left_nodes_; }
+  const std::vector<GNode>& right_nodes() const { return right_nodes_; }
+
+  bool IsLeft(GNode n) const { return side_[n] == kLeft; }
+  bool IsRight(GNode n) const { return side_[n] == kRight; }
+
+  /// The neighbors of n are neighbor(i) for begin(n) <= i < end(n)
+  uint64_t begin(GNode n) const { return n == 0 ? 0 : ends_[n - 1]; }
+  uint64_t end(GNode n) const { return ends_[n]; }
+  GNode neighbor(uint64_t i) const { return neighbors_[i]; }
+
+private:
+  Bipartition() = default;
+
+  /// Call func(v) for every neighbor v of n on the other side
+  template <typename View, typename Func>
+  void ForEachNeighbor(const View& view, GNode n, const Func& func) const {
+    uint8_t other = side_[n] == kLeft ? kRight : kLeft;
+    for (auto e : view.OutEdges(n)) {
+      GNode v = view.OutEdgeDst(e);
+      if (side_[v] == other) {
+        func(v);
+      }
+    }
+    for (auto e : view.InEdges(n)) {
+      GNode v = view.InEdgeSrc(e);
+      if (side_[v] == other) {
+        func(v);
+      }
+    }
+  }
+
+  katana::Result<void> Build(
+      katana::PropertyGraph* pg, const std::string& left_node_type,
+      const std::string& right_node_type) {
+    auto left_id = pg->GetNodeEntityTypeID(left_node_type);
+    auto right_id = pg->GetNodeEntityTypeID(right_node_type);
+    size_t num_nodes = pg->NumNodes();
+
+    side_.allocateBlocked(num_nodes);
+    katana::GReduceLogicalOr both;
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](const GNode& n) {
+          bool left = pg->DoesNodeHaveType(n, left_id);
+          bool right = pg->DoesNodeHaveType(n, right_id);
+          if (left && right) {
+            both.update(true);
+          }
+          side_[n] = left ? kLeft : (right ? kRight : kNeither);
+        },
+        katana::loopname("BipartiteMatching-Sides"), katana::no_stats());
+    if (both.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "a node has both types {} and {}",
+          left_node_type, right_node_type);
+    }
+    for (GNode n = 0; n < num_nodes; ++n) {
+      if (side_[n] == kLeft) {
+        left_nodes_.emplace_back(n);
+      } else if (side_[n] == kRight) {
+        right_nodes_.emplace_back(n);
+      }
+    }
+
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    ends_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](const GNode& n) {
+          uint64_t degree = 0;
+          if (side_[n] != kNeither) {
+            ForEachNeighbor(view, n, [&](GNode) { ++degree; });
+          }
+          ends_[n] = degree;
+        },
+        katana::steal(), katana::loopname("BipartiteMatching-Degrees"));
+    katana::ParallelSTL::partial_sum(ends_.begin(), ends_.end(), ends_.begin());
+
+    neighbors_.allocateBlocked(num_nodes == 0 ? 0 : ends_[num_nodes - 1]);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](const GNode& n) {
+          if (side_[n] == kNeither) {
+            return;
+          }
+          uint64_t next = begin(n);
+          ForEachNeighbor(view, n, [&](GNode v) { neighbors_[next++] = v; });
+        },
+        katana::steal(), katana::loopname("BipartiteMatching-Neighbors"));
+    return katana::ResultSuccess();
+  }
+
+  katana::NUMAArray<uint8_t> side_;
+  std::vector<GNode> left_nodes_;
+  std::vector<GNode> right_nodes_;
+  katana::NUMAArray<uint64_t> ends_;
+  katana::NUMAArray<GNode> neighbors_;
+};
+
+/// A matching of the bipartite graph, as the mate of every node, built up by
+/// the algorithms below
+class Matching {
+public:
+  explicit Matching(const Bipartition& bipartition)
+      : bipartition_(bipartition) {
+    mate_.allocateBlocked(bipartition.num_nodes());
+    katana::ParallelSTL::fill(mate_.begin(), mate_.end(), kNone);
+  }
+
+  GNode mate(GNode n) const { return mate_[n].load(std::memory_order_relaxed); }
+
+  /// Match every left node to its first unmatched neighbor, if any
+  void Greedy() {
+    katana::do_all(
+        katana::iterate(bipartition_.left_nodes()),
+        [&](const GNode& u) {
+          for (uint64_t i = bipartition_.begin(u); i < bipartition_.end(u);
+               ++i) {
+            GNode v = bipartition_.neighbor(i);
+            uint32_t expected = kNone;
+            if (mate(v) == kNone &&
+                mate_[v].compare_exchange_strong(expected, u)) {
+              mate_[u] = v;
+              return;
+            }
+          }
+        },
+        katana::steal(), katana::loopname("BipartiteMatching-Greedy"));
+  }
+
+  /// Augment the matching along disjoint augmenting paths until there are none
+  /// left
+  void PothenFan() {
+    uint32_t num_nodes = bipartition_.num_nodes();
+    lookahead_.allocateBlocked(num_nodes);
+    visited_.allocateBlocked(num_nodes);
+    katana::ParallelSTL::fill(visited_.begin(), visited_.end(), uint32_t{0});
+
+    katana::InsertBag<GNode> unmatched[2];
+    katana::InsertBag<GNode>* current = &unmatched[0];
+    katana::InsertBag<GNode>* next = &unmatched[1];
+    katana::do_all(
+        katana::iterate(bipartition_.left_nodes()),
+        [&](const GNode& u) {
+          lookahead_[u] = bipartition_.begin(u);
+          if (mate(u) == kNone) {
+            current->push(u);
+          }
+        },
+        katana::loopname("BipartiteMatching-PothenFan-Init"));
+
+    katana::PerThreadStorage<std::vector<Frame>> stacks;
+    uint32_t phase = 0;
+    while (!current->empty()) {
+      ++phase;
+      // Fairness: alternate the direction of the searches
+      bool forward = phase % 2 == 1;
+      katana::GAccumulator<uint64_t> augmented;
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const GNode& u) {
+            if (Augment(u, phase, forward, stacks.getLocal())) {
+              augmented += 1;
+            } else {
+              next->push(u);
+            }
+          },
+          katana::steal(), katana::loopname("BipartiteMatching-PothenFan"));
+      current->clear();
+      if (augmented.reduce() == 0) {
+        break;
+      }
+      std::swap(current, next);
+    }
+    katana::ReportStatSingle("BipartiteMatching", "PothenFanPhases", phase);
+  }
+
+  /// Double push and relabel unmatched left nodes until none can be matched,
+  /// then finish with PothenFan
+  void PushRelabel() {
+    uint32_t num_nodes = bipartition_.num_nodes();
+    uint32_t limit = bipartition_.left_nodes().size() +
+                     bipartition_.right_nodes().size();
+    label_.allocateBlocked(num_nodes);
+    uint64_t push_budget =
+        std::max<uint64_t>(bipartition_.left_nodes().size(), 1);
+
+    katana::InsertBag<GNode> active[2];
+    katana::InsertBag<GNode>* current = &active[0];
+    katana::InsertBag<GNode>* pending = &active[1];
+    katana::do_all(
+        katana::iterate(bipartition_.left_nodes()),
+        [&](const GNode& u) {
+          if (mate(u) == kNone) {
+            current->push(u);
+          }
+        },
+        katana::loopname("BipartiteMatching-PushRelabel-Init"));
+
+    uint32_t global_relabels = 0;
+    while (!current->empty()) {
+      GlobalRelabel(limit);
+      ++global_relabels;
+      std::atomic<uint64_t> pushes{0};
+      std::atomic<bool> relabel_requested{false};
+      katana::for_each(
+          katana::iterate(*current),
+          [&](const GNode& u, auto& ctx) {
+            if (relabel_requested.load(std::memory_order_relaxed)) {
+              pending->push(u);
+              return;
+            }
+            GNode displaced = kNone;
+            if (!DoublePush(u, limit, &displaced)) {
+              return;
+            }
+            if (displaced != kNone) {
+              ctx.push(displaced);
+            }
+            if (pushes.fetch_add(1, std::memory_order_relaxed) + 1 >=
+                push_budget) {
+              relabel_requested = true;
+            }
+          },
+          katana::disable_conflict_detection(),
+          katana::loopname("BipartiteMatching-PushRelabel"));
+      current->clear();
+      std::swap(current, pending);
+    }
+    katana::ReportStatSingle(
+        "BipartiteMatching", "GlobalRelabels", global_relabels);
+
+    SyncLeftMates();
+    // Labels only estimate distances while nodes push concurrently, so make
+    // sure no augmenting path is left
+    PothenFan();
+  }
+
+private:
+  struct Frame {
+    GNode node;
+    /// The next neighbor to search, or one past it when searching backward
+    uint64_t next;
+    /// The right node the search went on from
+    GNode chosen;
+  };
+
+  bool Claim(GNode v, uint32_t phase) {
+    return visited_[v].load(std::memory_order_relaxed) != phase &&
+           visited_[v].exchange(phase) != phase;
+  }
+
+  /// Depth-first search for an augmenting path from the unmatched left node
+  /// root, and flip it if one is found. The right nodes claimed in this phase
+  /// are skipped, so the left nodes on the path belong to this search too.
+  bool Augment(
+      GNode root, uint32_t phase, bool forward, std::vector<Frame>* stack) {
+    auto start = [&](GNode u) {
+      return forward ? bipartition_.begin(u) : bipartition_.end(u);
+    };
+    stack->clear();
+    stack->push_back(Frame{root, start(root), kNone});
+    while (!stack->empty()) {
+      Frame& top = stack->back();
+      GNode u = top.node;
+
+      // Lookahead: an unmatched neighbor ends the path right here
+      uint64_t& ahead = lookahead_[u];
+      while (ahead < bipartition_.end(u)) {
+        GNode v = bipartition_.neighbor(ahead++);
+        if (mate(v) == kNone && Claim(v, phase)) {
+          top.chosen = v;
+          Flip(*stack);
+          return true;
+        }
+      }
+
+      GNode next = kNone;
+      while (forward ? top.next < bipartition_.end(u)
+                     : top.next > bipartition_.begin(u)) {
+        GNode v = bipartition_.neighbor(forward ? top.next++ : --top.next);
+        if (!Claim(v, phase)) {
+          continue;
+        }
+        top.chosen = v;
+        next = mate(v);
+        if (next == kNone) {
+          Flip(*stack);
+          return true;
+        }
+        break;
+      }
+      if (next == kNone) {
+        stack->pop_back();
+      } else {
+        stack->push_back(Frame{next, start(next), kNone});
+      }
+    }
+    return false;
+  }
+
+  /// Match every node on the path to the node it chose
+  void Flip(const std::vector<Frame>& path) {
+    for (const Frame& frame : path) {
+      mate_[frame.node].store(frame.chosen, std::memory_order_relaxed);
+      mate_[frame.chosen].store(frame.node, std::memory_order_relaxed);
+    }
+  }
+
+  /// Match u to its neighbor v with the smallest label, unless even that is
+  /// at the limit, and raise the label of v above the second smallest. The
+  /// previous mate of v, if any, is unmatched and returned in displaced.
+  ///
+  /// Only the mates of right nodes are kept up to date while pushing.
+  bool DoublePush(GNode u, uint32_t limit, GNode* displaced) {
+    uint32_t lowest = limit;
+    uint32_t second = limit;
+    GNode lowest_neighbor = kNone;
+    for (uint64_t i = bipartition_.begin(u); i < bipartition_.end(u); ++i) {
+      GNode v = bipartition_.neighbor(i);
+      uint32_t label = label_[v].load(std::memory_order_relaxed);
+      if (label < lowest) {
+        second = lowest;
+        lowest = label;
+        lowest_neighbor = v;
+      } else if (label < second) {
+        second = label;
+      }
+    }
+    if (lowest_neighbor == kNone) {
+      // No augmenting path starts at u
+      return false;
+    }
+
+    uint32_t raised = std::min(second + 2, limit);
+    uint32_t label = label_[lowest_neighbor].load(std::memory_order_relaxed);
+    while (label < raised &&
+           !label_[lowest_neighbor].compare_exchange_weak(label, raised)) {
+    }
+    *displaced = mate_[lowest_neighbor].exchange(u);
+    return true;
+  }
+
+  void SyncLeftMates() {
+    katana::do_all(
+        katana::iterate(bipartition_.left_nodes()),
+        [&](const GNode& u) { mate_[u] = kNone; },
+        katana::loopname("BipartiteMatching-Reset-Left-Mates"));
+    katana::do_all(
+        katana::iterate(bipartition_.right_nodes()),
+        [&](const GNode& v) {
+          GNode u = mate(v);
+          if (u != kNone) {
+            mate_[u] = v;
+          }
+        },
+        katana::loopname("BipartiteMatching-Sync-Left-Mates"));
+  }
+
+  /// Set the label of every right node to its distance to an unmatched right
+  /// node in the alternating graph, or limit if there is no such path
+  void GlobalRelabel(uint32_t limit) {
+    SyncLeftMates();
+    katana::ParallelSTL::fill(label_.begin(), label_.end(), limit);
+
+    katana::InsertBag<GNode> frontiers[2];
+    katana::InsertBag<GNode>* frontier = &frontiers[0];
+    katana::InsertBag<GNode>* next = &frontiers[1];
+    katana::do_all(
+        katana::iterate(bipartition_.right_nodes()),
+        [&](const GNode& v) {
+          if (mate(v) == kNone) {
+            label_[v] = 0;
+            frontier->push(v);
+          }
+        },
+        katana::loopname("BipartiteMatching-Global-Relabel-Init"));
+
+    uint32_t label = 0;
+    while (!frontier->empty()) {
+      label += 2;
+      if (label >= limit) {
+        break;
+      }
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](const GNode& v) {
+            for (uint64_t i = bipartition_.begin(v); i < bipartition_.end(v);
+                 ++i) {
+              GNode r = mate(bipartition_.neighbor(i));
+              if (r == kNone || r == v) {
+                continue;
+              }
+              uint32_t expected = limit;
+              if (label_[r].load(std::memory_order_relaxed) == limit &&
+                  label_[r].compare_exchange_strong(expected, label)) {
+                next->push(r);
+              }
+            }
+          },
+          katana::steal(),
+          katana::loopname("BipartiteMatching-Global-Relabel"));
+      frontier->clear();
+      std::swap(frontier, next);
+    }
+  }
+
+  const Bipartition& bipartition_;
+  katana::NUMAArray<std::atomic<GNode>> mate_;
+
+  /// Pothen-Fan: the next neighbor of each left node to look ahead at
+  katana::NUMAArray<uint64_t> lookahead_;
+  /// Pothen-Fan: the last phase that claimed each right node
+  katana::NUMAArray<std::atomic<uint32_t>> visited_;
+
+  /// Push-relabel: a lower bound on the distance of each right node to an
+  /// unmatched right node in the alternating graph
+  katana::NUMAArray<std::atomic<uint32_t>> label_;
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BipartiteMatching(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BipartiteMatchingPlan plan) {
+  if (plan.algorithm() != BipartiteMatchingPlan::kPothenFan &&
+      plan.algorithm() != BipartiteMatchingPlan::kPushRelabel) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  auto bipartition =
+      KATANA_CHECKED(Bipartition::Make(pg, left_node_type, right_node_type));
+
+  KATANA_CHECKED(
+      pg->ConstructEdgeProperties<EdgeData>(txn_ctx, {output_property_name}));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {output_property_name}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("BipartiteMatching");
+
+  exec_time.start();
+  Matching matching(bipartition);
+  matching.Greedy();
+  switch (plan.algorithm()) {
+  case BipartiteMatchingPlan::kPothenFan:
+    matching.PothenFan();
+    break;
+  case BipartiteMatchingPlan::kPushRelabel:
+    matching.PushRelabel();
+    break;
+  }
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        for (auto e : graph.OutEdges(n)) {
+          graph.GetEdgeData<EdgeMatched>(e) = 0;
+        }
+      },
+      katana::steal(), katana::loopname("BipartiteMatching-Clear-Output"));
+  // Mark one edge between each matched pair, from the left node if possible
+  katana::do_all(
+      katana::iterate(bipartition.left_nodes()),
+      [&](const GNode& u) {
+        GNode v = matching.mate(u);
+        if (v == kNone) {
+          return;
+        }
+        for (auto e : graph.OutEdges(u)) {
+          if (graph.OutEdgeDst(e) == v) {
+            graph.GetEdgeData<EdgeMatched>(e) = 1;
+            return;
+          }
+        }
+        for (auto e : graph.OutEdges(v)) {
+          if (graph.OutEdgeDst(e) == u) {
+            graph.GetEdgeData<EdgeMatched>(e) = 1;
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("BipartiteMatching-Write-Output"));
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::BipartiteMatchingAssertValid(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type,
+    const std::string& output_property_name) {
+  auto bipartition =
+      KATANA_CHECKED(Bipartition::Make(pg, left_node_type, right_node_type));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {output_property_name}));
+
+  katana::NUMAArray<std::atomic<uint32_t>> matched_edges;
+  matched_edges.allocateBlocked(pg->NumNodes());
+  katana::ParallelSTL::fill(
+      matched_edges.begin(), matched_edges.end(), uint32_t{0});
+  katana::NUMAArray<GNode> mate;
+  mate.allocateBlocked(pg->NumNodes());
+  katana::ParallelSTL::fill(mate.begin(), mate.end(), kNone);
+
+  katana::GReduceLogicalOr not_bipartite;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        for (auto e : graph.OutEdges(n)) {
+          if (!graph.GetEdgeData<EdgeMatched>(e)) {
+            continue;
+          }
+          GNode dst = graph.OutEdgeDst(e);
+          if (!(bipartition.IsLeft(n) && bipartition.IsRight(dst)) &&
+              !(bipartition.IsRight(n) && bipartition.IsLeft(dst))) {
+            not_bipartite.update(true);
+            continue;
+          }
+          matched_edges[n].fetch_add(1);
+          matched_edges[dst].fetch_add(1);
+          mate[n] = dst;
+          mate[dst] = n;
+        }
+      },
+      katana::steal(), katana::loopname("BipartiteMatching-Validate"));
+  if (not_bipartite.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "a matched edge does not join a left and a right node");
+  }
+  auto overmatched = katana::ParallelSTL::find_if(
+      matched_edges.begin(), matched_edges.end(),
+      [](const std::atomic<uint32_t>& count) { return count > 1; });
+  if (overmatched != matched_edges.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "node {} is matched more than once",
+        std::distance(matched_edges.begin(), overmatched));
+  }
+
+  // Breadth-first search for an augmenting path from all unmatched left
+  // nodes at once
+  std::vector<bool> visited(pg->NumNodes());
+  std::deque<GNode> queue;
+  for (GNode u : bipartition.left_nodes()) {
+    if (mate[u] == kNone) {
+      visited[u] = true;
+      queue.emplace_back(u);
+    }
+  }
+  while (!queue.empty()) {
+    GNode u = queue.front();
+    queue.pop_front();
+    for (uint64_t i = bipartition.begin(u); i < bipartition.end(u); ++i) {
+      GNode v = bipartition.neighbor(i);
+      if (visited[v]) {
+        continue;
+      }
+      visited[v] = true;
+      GNode w = mate[v];
+      if (w == kNone) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "the matching is not maximum: there is an augmenting path to {}",
+            v);
+      }
+      if (!visited[w]) {
+        visited[w] = true;
+        queue.emplace_back(w);
+      }
+    }
+  }
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::BipartiteMatchingStatistics::Print(std::ostream& os) const {
+  os << "Left nodes = " << num_left_nodes << std::endl;
+  os << "Right nodes = " << num_right_nodes << std::endl;
+  os << "Matched pairs = " << num_matched << std::endl;
+}
+
+katana::Result<BipartiteMatchingStatistics>
+katana::analytics::BipartiteMatchingStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& left_node_type,
+    const std::string& right_node_type,
+    const std::string& output_property_name) {
+  auto bipartition =
+      KATANA_CHECKED(Bipartition::Make(pg, left_node_type, right_node_type));
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {}, {output_property_name}));
+
+  katana::GAccumulator<uint64_t> num_matched;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        for (auto e : graph.OutEdges(n)) {
+          num_matched += graph.GetEdgeData<EdgeMatched>(e);
+        }
+      },
+      katana::loopname("BipartiteMatching-Statistics"), katana::no_stats());
+
+  return BipartiteMatchingStatistics{
+      bipartition.left_nodes().size(), bipartition.right_nodes().size(),
+      num_matched.reduce()};
+}
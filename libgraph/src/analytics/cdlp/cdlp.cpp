@@ -19,10 +19,13 @@
 
 #include "katana/analytics/cdlp/cdlp.h"
 
-#include <boost/unordered_map.hpp>
+#include <algorithm>
+#include <vector>
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/IterationMetrics.h"
 
 using namespace katana::analytics;
 
@@ -30,6 +33,96 @@ namespace {
 
 const unsigned int kMaxIterations = CdlpPlan::kMaxIterations;
 
+/// Finds the most frequent of the labels of the neighbors of a node without
+/// allocating once it has seen a node of every degree. The labels of
+/// low-degree nodes are sorted in a scratch buffer, which is cheaper than
+/// hashing them; the labels of hubs are counted in an open addressing
+/// table. Both are reused for every node, so each thread has its own
+/// counter.
+template <typename Label>
+class LabelCounter {
+public:
+  /// Nodes with more neighbors than this count their labels in the table
+  static constexpr size_t kMaxSortDegree = 256;
+
+  void Clear() { labels_.clear(); }
+
+  void Add(Label label) { labels_.emplace_back(label); }
+
+  /// \returns the most frequent label added since Clear, the smallest of
+  /// them if there are several, or fallback if none were added
+  Label Mode(Label fallback) {
+    if (labels_.empty()) {
+      return fallback;
+    }
+    if (labels_.size() <= kMaxSortDegree) {
+      return SortedMode();
+    }
+    return TableMode();
+  }
+
+private:
+  Label SortedMode() {
+    std::sort(labels_.begin(), labels_.end());
+    Label best = labels_[0];
+    size_t best_count = 0;
+    for (size_t begin = 0, end = 0; begin < labels_.size(); begin = end) {
+      while (end < labels_.size() && labels_[end] == labels_[begin]) {
+        ++end;
+      }
+      // runs are in ascending order, so ties keep the smaller label
+      if (end - begin > best_count) {
+        best = labels_[begin];
+        best_count = end - begin;
+      }
+    }
+    return best;
+  }
+
+  Label TableMode() {
+    size_t capacity = 2 * kMaxSortDegree;
+    while (capacity < 2 * labels_.size()) {
+      capacity *= 2;
+    }
+    if (counts_.size() < capacity) {
+      keys_.resize(capacity);
+      counts_.resize(capacity, 0);
+    }
+    size_t mask = capacity - 1;
+
+    Label best = labels_[0];
+    uint32_t best_count = 0;
+    for (Label label : labels_) {
+      size_t i = ((label * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+      while (counts_[i] != 0 && keys_[i] != label) {
+        i = (i + 1) & mask;
+      }
+      if (counts_[i] == 0) {
+        keys_[i] = label;
+        used_.emplace_back(i);
+      }
+      uint32_t count = ++counts_[i];
+      if (count > best_count || (count == best_count && label < best)) {
+        best = label;
+        best_count = count;
+      }
+    }
+
+    // leave the table empty for the next hub
+    for (size_t i : used_) {
+      counts_[i] = 0;
+    }
+    used_.clear();
+    return best;
+  }
+
+  std::vector<Label> labels_;
+  std::vector<Label> keys_;
+  std::vector<uint32_t> counts_;
+  /// The slots of the table that hold a label
+  std::vector<size_t> used_;
+};
+
 template <typename GraphViewTy>
 struct CdlpAlgo {
   using CommunityType = uint64_t;
@@ -45,7 +138,17 @@ struct CdlpAlgo {
       graph->template GetData<NodeCommunity>(node) = node;
     });
   }
+
+  void Initialize(Graph* graph, const katana::NUMAArray<uint64_t>& labels) {
+    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
+      graph->template GetData<NodeCommunity>(node) = labels[node];
+    });
+  }
+
   virtual void operator()(Graph* graph, size_t max_iterations) = 0;
+  virtual void operator()(
+      Graph* graph, size_t max_iterations,
+      const std::vector<uint32_t>& changed_nodes) = 0;
 };
 
 template <typename GraphViewTy>
@@ -56,6 +159,23 @@ struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy> {
   using NodeCommunity = typename CdlpAlgo<GraphViewTy>::NodeCommunity;
 
   void operator()(Graph* graph, size_t max_iterations = kMaxIterations) {
+    Run(graph, max_iterations, katana::iterate(*graph));
+  }
+
+  /// Only the changed nodes are active in the first iteration. A node keeps
+  /// its label unless the labels of its neighbors change, so starting from
+  /// the labels the synchronous algorithm converged to before the changes,
+  /// this gives the same labels as an iteration over all nodes.
+  void operator()(
+      Graph* graph, size_t max_iterations,
+      const std::vector<uint32_t>& changed_nodes) {
+    Run(graph, max_iterations,
+        katana::iterate(changed_nodes.begin(), changed_nodes.end()));
+  }
+
+private:
+  template <typename Range>
+  void Run(Graph* graph, size_t max_iterations, const Range& first_active) {
     if (max_iterations == 0)
       return;
 
@@ -67,61 +187,105 @@ struct CdlpSynchronousAlgo : CdlpAlgo<GraphViewTy> {
 
     size_t iterations = 0;
     katana::InsertBag<NodeDataPair> apply_bag;
+    katana::GAccumulator<uint64_t> visited;
+    katana::GAccumulator<uint64_t> edges_visited;
+    katana::GAccumulator<uint64_t> changed;
+
+    // A label only changes after one of its neighbors changed, so after the
+    // first iteration only the neighbors of changed nodes are gathered.
+    // scheduled[n] is the last iteration n was added to next_active.
+    katana::InsertBag<GNode> active;
+    katana::InsertBag<GNode> next_active;
+    katana::NUMAArray<std::atomic<uint32_t>> scheduled;
+    scheduled.allocateBlocked(graph->NumNodes());
+    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
+      scheduled[node].store(0, std::memory_order_relaxed);
+    });
 
-    /// TODO (Yasin): in this implementation, in each iteration, all the nodes are active
-    /// for gather phase. If InsertBag does not accept duplicate items then this
-    /// can be improved to have only the affected nodes to be active in next iteration
-    while (iterations < max_iterations) {
-      // Gather Phase
-      katana::do_all(
-          katana::iterate(*graph),
-          [&](const GNode& node) {
-            const auto ndata_current_comm =
-                graph->template GetData<NodeCommunity>(node);
-            using Histogram_type = boost::unordered_map<CommunityType, size_t>;
-            Histogram_type histogram;
-            // Iterate over all neighbors (this is undirected view)
-            for (auto e : Edges(*graph, node)) {
-              auto neighbor = EdgeDst(*graph, e);
-              const auto neighbor_data =
-                  graph->template GetData<NodeCommunity>(neighbor);
-              histogram[neighbor_data]++;
-            }
+    katana::PerThreadStorage<LabelCounter<CommunityType>> counters;
+
+    auto gather = [&](const GNode& node) {
+      visited += 1;
+      const auto ndata_current_comm =
+          graph->template GetData<NodeCommunity>(node);
+      LabelCounter<CommunityType>& counter = *counters.getLocal();
+      counter.Clear();
+      uint64_t degree = 0;
+      // Iterate over all neighbors (this is undirected view)
+      for (auto e : Edges(*graph, node)) {
+        auto neighbor = EdgeDst(*graph, e);
+        counter.Add(graph->template GetData<NodeCommunity>(neighbor));
+        ++degree;
+      }
+      edges_visited += degree;
 
-            // Pick the most frequent community as the new community for node
-            // pick the smallest one if more than one max frequent exist.
-            auto ndata_new_comm = ndata_current_comm;
-            size_t best_freq = 0;
-            for (const auto& [comm, freq] : histogram) {
-              if (freq > best_freq ||
-                  (freq == best_freq && comm < ndata_new_comm)) {
-                ndata_new_comm = comm;
-                best_freq = freq;
-              }
-            }
+      // Pick the most frequent community as the new community for node
+      // pick the smallest one if more than one max frequent exist.
+      auto ndata_new_comm = counter.Mode(ndata_current_comm);
 
-            if (ndata_new_comm != ndata_current_comm)
-              apply_bag.push(NodeDataPair(node, (CommunityType)ndata_new_comm));
-          },
-          katana::loopname("CDLP_Gather"));
+      if (ndata_new_comm != ndata_current_comm) {
+        apply_bag.push(NodeDataPair(node, (CommunityType)ndata_new_comm));
+        changed += 1;
+      }
+    };
+
+    katana::analytics::IterationReporter reporter("cdlp_synchronous");
+    uint64_t visited_before = 0;
+    uint64_t edges_visited_before = 0;
+    // the convergence is the number of labels changed
+    auto report = [&]() {
+      uint64_t visited_now = visited.reduce();
+      uint64_t edges_visited_now = edges_visited.reduce();
+      reporter.Report(
+          iterations + 1, changed.reduce(), visited_now - visited_before,
+          edges_visited_now - edges_visited_before);
+      visited_before = visited_now;
+      edges_visited_before = edges_visited_now;
+      changed.reset();
+    };
+
+    while (iterations < max_iterations) {
+      // Gather Phase
+      if (iterations == 0) {
+        katana::do_all(first_active, gather, katana::loopname("CDLP_Gather"));
+      } else {
+        katana::do_all(
+            katana::iterate(active), gather, katana::loopname("CDLP_Gather"));
+      }
 
       // No change! break!
-      if (apply_bag.empty())
+      if (apply_bag.empty()) {
+        report();
         break;
+      }
 
       // Apply Phase
+      const uint32_t next_iteration = iterations + 1;
       katana::do_all(
           katana::iterate(apply_bag),
           [&](const NodeDataPair node_data) {
             GNode node = node_data.node;
             graph->template GetData<NodeCommunity>(node) = node_data.data;
+            for (auto e : Edges(*graph, node)) {
+              auto neighbor = EdgeDst(*graph, e);
+              if (scheduled[neighbor].exchange(
+                      next_iteration, std::memory_order_relaxed) !=
+                  next_iteration) {
+                next_active.push(neighbor);
+              }
+            }
           },
           katana::loopname("CDLP_Apply"));
 
+      report();
       apply_bag.clear();
+      active.swap(next_active);
+      next_active.clear();
       iterations += 1;
     }
     katana::ReportStatSingle("CDLP_Synchronous", "iterations", iterations);
+    katana::ReportStatSingle(
+        "CDLP_Synchronous", "NodesVisited", visited.reduce());
   }
 };
 
@@ -129,6 +293,7 @@ template <typename GraphViewTy>
 struct CdlpAsynchronousAlgo : CdlpAlgo<GraphViewTy> {
   using Graph = typename CdlpAlgo<GraphViewTy>::Graph;
   void operator()(Graph*, size_t) {}
+  void operator()(Graph*, size_t, const std::vector<uint32_t>&) {}
 };
 
 }  //namespace
@@ -137,7 +302,13 @@ template <typename Algorithm>
 static katana::Result<void>
 CdlpWithWrap(
     katana::PropertyGraph* pg, std::string output_property_name,
-    size_t max_iterations, katana::TxnContext* txn_ctx) {
+    size_t max_iterations, katana::TxnContext* txn_ctx,
+    const CommunitySeed* seed = nullptr) {
+  katana::NUMAArray<uint64_t> seed_labels;
+  if (seed) {
+    seed_labels = KATANA_CHECKED(ReadCommunitySeed(pg, *seed));
+  }
+
   katana::EnsurePreallocated(
       2, pg->topology().NumNodes() * sizeof(typename Algorithm::NodeCommunity));
   katana::ReportPageAllocGuard page_alloc;
@@ -156,32 +327,42 @@ CdlpWithWrap(
 
   Algorithm algo;
 
-  algo.Initialize(&graph);
+  if (seed) {
+    algo.Initialize(&graph, seed_labels);
+  } else {
+    algo.Initialize(&graph);
+  }
 
   katana::StatTimer execTime("CDLP");
 
   execTime.start();
-  algo(&graph, max_iterations);
+  if (seed) {
+    algo(&graph, max_iterations, seed->changed_nodes);
+  } else {
+    algo(&graph, max_iterations);
+  }
   execTime.stop();
 
   return katana::ResultSuccess();
 }
 
+namespace {
+
 katana::Result<void>
-katana::analytics::Cdlp(
-    PropertyGraph* pg, const std::string& output_property_name,
-    size_t max_iterations, katana::TxnContext* txn_ctx,
-    const bool& is_symmetric, CdlpPlan plan) {
+CdlpImpl(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const CommunitySeed* seed, size_t max_iterations,
+    katana::TxnContext* txn_ctx, bool is_symmetric, CdlpPlan plan) {
   switch (plan.algorithm()) {
   case CdlpPlan::kSynchronous:
     if (is_symmetric)
       return CdlpWithWrap<
           CdlpSynchronousAlgo<katana::PropertyGraphViews::Default>>(
-          pg, output_property_name, max_iterations, txn_ctx);
+          pg, output_property_name, max_iterations, txn_ctx, seed);
     else
       return CdlpWithWrap<
           CdlpSynchronousAlgo<katana::PropertyGraphViews::Undirected>>(
-          pg, output_property_name, max_iterations, txn_ctx);
+          pg, output_property_name, max_iterations, txn_ctx, seed);
   /// TODO (Yasin): Asynchronous Algorithm will be implemented later after Synchronous
   /// is done for both shared and distributed versions.
   /*
@@ -190,10 +371,32 @@ katana::analytics::Cdlp(
         pg, output_property_name, max_iterations);
   */
   default:
-    return ErrorCode::InvalidArgument;
+    return katana::ErrorCode::InvalidArgument;
   }
 }
 
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Cdlp(
+    PropertyGraph* pg, const std::string& output_property_name,
+    size_t max_iterations, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, CdlpPlan plan) {
+  return CdlpImpl(
+      pg, output_property_name, nullptr, max_iterations, txn_ctx, is_symmetric,
+      plan);
+}
+
+katana::Result<void>
+katana::analytics::Cdlp(
+    PropertyGraph* pg, const std::string& output_property_name,
+    const CommunitySeed& seed, size_t max_iterations,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric, CdlpPlan plan) {
+  return CdlpImpl(
+      pg, output_property_name, &seed, max_iterations, txn_ctx, is_symmetric,
+      plan);
+}
+
 /// TODO (Yasin): This function is now being used by louvain,
 /// cc, and cdlp, basically everything which is calculating communities. Explore
 /// possiblity of moving it to some common .h file in libgalois/include/analytics
@@ -19,8 +19,14 @@
 
 #include "katana/analytics/connected_components/connected_components.h"
 
+#include <algorithm>
+#include <type_traits>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/DisjointSets.h"
+#include "katana/ParallelSTL.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Sampling.h"
 
 using namespace katana::analytics;
 
@@ -343,6 +349,8 @@ struct ConnectedComponentsEdgeAsynchronousAlgo {
   typedef typename Graph::Node GNode;
   // TODO(amber): 2nd element was Graph::edge_iterator
   using Edge = std::pair<GNode, typename Graph::Edge>;
+  static constexpr bool kHasEdgeSources = std::is_base_of_v<
+      katana::EdgeSourcesTopologyWrapper, GraphViewTy>;
 
   ConnectedComponentsPlan& plan_;
   ConnectedComponentsEdgeAsynchronousAlgo(ConnectedComponentsPlan& plan)
@@ -364,9 +372,10 @@ struct ConnectedComponentsEdgeAsynchronousAlgo {
     });
   }
 
-  void operator()(Graph* graph) {
-    katana::GAccumulator<size_t> empty_merges;
-
+  /// Gathers the edges with the source of each from a loop over nodes, for
+  /// views that would have to search for the sources, and merges them
+  void MergeGatheredEdges(
+      Graph* graph, katana::GAccumulator<size_t>* empty_merges) {
     katana::InsertBag<Edge> works;
 
     katana::do_all(
@@ -391,10 +400,35 @@ struct ConnectedComponentsEdgeAsynchronousAlgo {
             // continue;
             ;
           else if (!sdata->merge(ddata)) {
-            empty_merges += 1;
+            *empty_merges += 1;
           }
         },
         katana::loopname("CC-EdgeAsynchronous"), katana::steal());
+  }
+
+  void operator()(Graph* graph) {
+    katana::GAccumulator<size_t> empty_merges;
+
+    if constexpr (kHasEdgeSources) {
+      // edge sources are stored, so the edges are merged straight from the
+      // topology without gathering them first
+      katana::do_all(
+          katana::iterate(graph->OutEdges()),
+          [&](const typename Graph::Edge& e) {
+            GNode src = graph->GetEdgeSrc(e);
+            auto dest = EdgeDst(*graph, e);
+            if (src < dest) {
+              auto& sdata = graph->template GetData<NodeComponent>(src);
+              auto& ddata = graph->template GetData<NodeComponent>(dest);
+              if (!sdata->merge(ddata)) {
+                empty_merges += 1;
+              }
+            }
+          },
+          katana::loopname("CC-EdgeAsynchronous"), katana::steal());
+    } else {
+      MergeGatheredEdges(graph, &empty_merges);
+    }
 
     katana::do_all(
         katana::iterate(*graph),
@@ -612,68 +646,38 @@ struct ConnectedComponentsEdgeTiledAsynchronousAlgo {
   }
 };
 
-template <typename ComponentType, typename Graph, typename NodeIndex>
-ComponentType
-approxLargestComponent(Graph* graph, uint32_t component_sample_frequency) {
-  using map_type = katana::gstl::UnorderedMap<ComponentType, int>;
-  using pair_type = std::pair<ComponentType, int>;
-
-  map_type comp_freq(component_sample_frequency);
-  std::random_device rd;
-  std::mt19937 rng(rd());
-  std::uniform_int_distribution<uint32_t> dist(0, graph->size() - 1);
-  for (uint32_t i = 0; i < component_sample_frequency; i++) {
-    ComponentType ndata = graph->template GetData<NodeIndex>(dist(rng));
-    comp_freq[ndata->component()]++;
-  }
-
-  KATANA_LOG_DEBUG_ASSERT(!comp_freq.empty());
-  auto most_frequent = std::max_element(
-      comp_freq.begin(), comp_freq.end(),
-      [](const pair_type& a, const pair_type& b) {
-        return a.second < b.second;
-      });
-
-  //katana::gDebug(
-  //    "Approximate largest intermediate component: ", most_frequent->first,
-  //    " (hit rate ",
-  //    100.0 * (most_frequent->second) / component_sample_frequency, "%)");
-
-  return most_frequent->first;
-}
-
-template <
-    typename ComponentType, typename Graph, typename NodeIndex,
-    typename ParentArray>
+/// \returns the most frequent component of component_sample_frequency nodes
+/// sampled with a fixed key, so that runs on a graph skip the same component.
+/// component_of(n) is the component of node n.
+template <typename ComponentType, typename ComponentOf>
 ComponentType
 approxLargestComponent(
-    Graph* graph, ParentArray& parent_array_,
-    uint32_t component_sample_frequency) {
-  using map_type = katana::gstl::UnorderedMap<ComponentType, int>;
-  using pair_type = std::pair<ComponentType, int>;
-
-  map_type comp_freq(component_sample_frequency);
-  std::random_device rd;
-  std::mt19937 rng(rd());
-  std::uniform_int_distribution<uint32_t> dist(0, graph->size() - 1);
-  for (uint32_t i = 0; i < component_sample_frequency; i++) {
-    const auto& ndata = parent_array_[dist(rng)];
-    comp_freq[ndata.component()]++;
+    uint64_t num_nodes, uint32_t component_sample_frequency,
+    const ComponentOf& component_of) {
+  if (num_nodes == 0) {
+    return ComponentType{};
+  }
+  const uint64_t key = katana::analytics::SamplingKey(0);
+  std::vector<ComponentType> samples(std::max(component_sample_frequency, 1U));
+  for (uint32_t i = 0; i < samples.size(); ++i) {
+    uint64_t node = katana::analytics::SampleBits(key, i) % num_nodes;
+    samples[i] = component_of(node);
   }
 
-  KATANA_LOG_DEBUG_ASSERT(!comp_freq.empty());
-  auto most_frequent = std::max_element(
-      comp_freq.cbegin(), comp_freq.cend(),
-      [](const pair_type& a, const pair_type& b) {
-        return a.second < b.second;
-      });
-
-  //katana::gDebug(
-  //    "Approximate largest intermediate component: ", most_frequent->first,
-  //    " (hit rate ",
-  //    100.0 * (most_frequent->second) / component_sample_frequency, "%)");
-
-  return most_frequent->first;
+  // count the samples of each component as a run of the sorted samples
+  std::sort(samples.begin(), samples.end());
+  ComponentType most_frequent = samples[0];
+  size_t most_hits = 0;
+  for (size_t begin = 0, end = 0; begin < samples.size(); begin = end) {
+    while (end < samples.size() && samples[end] == samples[begin]) {
+      ++end;
+    }
+    if (end - begin > most_hits) {
+      most_frequent = samples[begin];
+      most_hits = end - begin;
+    }
+  }
+  return most_frequent;
 }
 
 template <typename GraphViewTy>
@@ -708,8 +712,8 @@ struct ConnectedComponentsAfforestAlgo {
     }
   };
 
-  struct NodeComponent : public katana::PODProperty<
-                             uint64_t, typename NodeAfforest::ComponentType> {};
+  /// The component of a node is the node at the root of its tree
+  struct NodeComponent : public katana::PODProperty<uint64_t> {};
 
   using NodeData = std::tuple<NodeComponent>;
   using EdgeData = std::tuple<>;
@@ -727,20 +731,14 @@ struct ConnectedComponentsAfforestAlgo {
     // parent_array_.allocateInterleaved(graph->size());
 
     katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      auto& snode = graph->template GetData<NodeComponent>(node);
-      new (&snode) NodeAfforest();
       new (&parent_array_[node]) NodeAfforest();
-      //snode = reinterpret_cast<ComponentType>(&snode);
     });
   }
 
   void Deallocate(Graph* graph) {
     katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
       auto& sdata = graph->template GetData<NodeComponent>(node);
-      auto& dataFromArr = parent_array_[node];
-      // auto component_ptr = sdata->component();
-      auto component_ptr = dataFromArr.component();
-      sdata = component_ptr;
+      sdata = parent_array_[node].component() - parent_array_.data();
     });
   }
   using ComponentType = typename NodeAfforest::ComponentType;
@@ -781,9 +779,9 @@ struct ConnectedComponentsAfforestAlgo {
 
     katana::StatTimer StatTimer_Sampling("Afforest-LCS-Sampling");
     StatTimer_Sampling.start();
-    const ComponentType c =
-        approxLargestComponent<ComponentType, Graph, NodeComponent>(
-            graph, parent_array_, plan_.component_sample_frequency());
+    const ComponentType c = approxLargestComponent<ComponentType>(
+        graph->size(), plan_.component_sample_frequency(),
+        [&](GNode n) { return parent_array_[n].component(); });
     StatTimer_Sampling.stop();
 
     katana::do_all(
@@ -803,6 +801,13 @@ struct ConnectedComponentsAfforestAlgo {
             auto& ddata = parent_array_[dest];
             // sdata->link(ddata);
             sdata.link(&ddata);
+            // Once src hangs under c, its other edges can be skipped like
+            // those of the nodes of c: an edge is only left out when both of
+            // its ends have joined c.
+            ComponentType parent = sdata.component();
+            if (parent == c || parent->component() == c) {
+              break;
+            }
           }
         },
         katana::steal(), katana::loopname("Afforest-LCS-Link"));
@@ -918,9 +923,10 @@ struct ConnectedComponentsEdgeAfforestAlgo {
 
     katana::StatTimer StatTimer_Sampling("EdgeAfforest-LCS-Sampling");
     StatTimer_Sampling.start();
-    const ComponentType c =
-        approxLargestComponent<ComponentType, Graph, NodeComponent>(
-            graph, plan_.component_sample_frequency());
+    const ComponentType c = approxLargestComponent<ComponentType>(
+        graph->size(), plan_.component_sample_frequency(), [&](GNode n) {
+          return graph->template GetData<NodeComponent>(n)->component();
+        });
     StatTimer_Sampling.stop();
     const ComponentType c0 = (graph->template GetData<NodeComponent>(0));
 
@@ -1074,9 +1080,10 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
 
     katana::StatTimer StatTimer_Sampling("EdgetiledAfforest-LCS-Sampling");
     StatTimer_Sampling.start();
-    const ComponentType c =
-        approxLargestComponent<ComponentType, Graph, NodeComponent>(
-            graph, plan_.component_sample_frequency());
+    const ComponentType c = approxLargestComponent<ComponentType>(
+        graph->size(), plan_.component_sample_frequency(), [&](GNode n) {
+          return graph->template GetData<NodeComponent>(n)->component();
+        });
     StatTimer_Sampling.stop();
 
     katana::InsertBag<EdgeTile> works;
@@ -1116,6 +1123,11 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
             auto dest = EdgeDst(*graph, *ii);
             auto& ddata = graph->template GetData<NodeComponent>(dest);
             sdata->link(ddata);
+            // as in Afforest, the rest can be skipped once src is under c
+            ComponentType parent = sdata->component();
+            if (parent == c || parent->component() == c) {
+              break;
+            }
           }
         },
         katana::steal(),
@@ -1132,6 +1144,87 @@ struct ConnectedComponentsEdgeTiledAfforestAlgo {
   }
 };
 
+/// Whether the algorithm labels each component with one of its nodes, which
+/// is then labeled with itself
+template <typename Algorithm>
+constexpr bool kLabelsAreNodes = false;
+template <typename GraphViewTy>
+constexpr bool kLabelsAreNodes<ConnectedComponentsLabelPropAlgo<GraphViewTy>> =
+    true;
+template <typename GraphViewTy>
+constexpr bool kLabelsAreNodes<ConnectedComponentsAfforestAlgo<GraphViewTy>> =
+    true;
+
+struct ComponentId : public katana::PODProperty<uint64_t> {};
+using ComponentGraph =
+    katana::TypedPropertyGraph<std::tuple<ComponentId>, std::tuple<>>;
+
+/// Relabel components that are labeled with nodes by the rank of the node
+/// among the labels
+void
+CompactNodeLabels(ComponentGraph* graph) {
+  katana::NUMAArray<uint64_t> rank;
+  rank.allocateBlocked(graph->size());
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t n) { rank[n] = graph->GetData<ComponentId>(n) == n; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t n) {
+        auto& id = graph->GetData<ComponentId>(n);
+        id = rank[id] - 1;
+      },
+      katana::loopname("CC-Compact"));
+}
+
+/// Relabel components with any labels by the rank of their label
+void
+CompactLabels(ComponentGraph* graph) {
+  const size_t num_nodes = graph->size();
+  if (num_nodes == 0) {
+    return;
+  }
+  katana::NUMAArray<uint64_t> sorted;
+  sorted.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t n) { sorted[n] = graph->GetData<ComponentId>(n); },
+      katana::no_stats());
+  katana::ParallelSTL::sort(sorted.begin(), sorted.end());
+
+  auto is_first = [&](size_t i) {
+    return i == 0 || sorted[i] != sorted[i - 1];
+  };
+  katana::NUMAArray<uint64_t> rank;
+  rank.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t i) { rank[i] = is_first(i); }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+
+  katana::NUMAArray<uint64_t> labels;
+  labels.allocateBlocked(rank[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t i) {
+        if (is_first(i)) {
+          labels[rank[i] - 1] = sorted[i];
+        }
+      },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t n) {
+        auto& id = graph->GetData<ComponentId>(n);
+        id = std::lower_bound(labels.begin(), labels.end(), id) -
+             labels.begin();
+      },
+      katana::steal(), katana::loopname("CC-Compact"));
+}
+
 }  //namespace
 
 template <typename Algorithm>
@@ -1167,9 +1260,28 @@ ConnectedComponentsWithWrap(
   execTime.stop();
 
   algo.Deallocate(&graph);
+
+  katana::StatTimer compact_time("ConnectedComponentCompaction");
+  compact_time.start();
+  ComponentGraph ids =
+      KATANA_CHECKED(ComponentGraph::Make(pg, {output_property_name}, {}));
+  if constexpr (kLabelsAreNodes<Algorithm>) {
+    CompactNodeLabels(&ids);
+  } else {
+    CompactLabels(&ids);
+  }
+  compact_time.stop();
   return katana::ResultSuccess();
 }
 
+/// The view for algorithms that loop over edges: the default view with the
+/// source of every edge stored, since searching for it costs a binary search
+/// per edge
+template <typename GraphViewTy>
+using WithEdgeSources = std::conditional_t<
+    std::is_same_v<GraphViewTy, katana::PropertyGraphViews::Default>,
+    katana::PropertyGraphViews::EdgeSources, GraphViewTy>;
+
 template <typename GraphViewTy>
 katana::Result<void>
 ConnectedComponentsSelectAlgorithm(
@@ -1194,7 +1306,7 @@ ConnectedComponentsSelectAlgorithm(
         pg, output_property_name, txn_ctx, plan);
   case ConnectedComponentsPlan::kEdgeAsynchronous:
     return ConnectedComponentsWithWrap<
-        ConnectedComponentsEdgeAsynchronousAlgo<GraphViewTy>>(
+        ConnectedComponentsEdgeAsynchronousAlgo<WithEdgeSources<GraphViewTy>>>(
         pg, output_property_name, txn_ctx, plan);
   case ConnectedComponentsPlan::kEdgeTiledAsynchronous:
     return ConnectedComponentsWithWrap<
@@ -1238,6 +1350,86 @@ katana::analytics::ConnectedComponents(
   }
 }
 
+katana::Result<void>
+katana::analytics::ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& previous_component_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& added_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  struct PreviousComponentId : public katana::PODProperty<uint64_t> {};
+  using Graph = katana::TypedPropertyGraph<
+      std::tuple<PreviousComponentId, ComponentId>, std::tuple<>>;
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<ComponentId>>(
+      txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(
+      pg, {previous_component_property_name, output_property_name}, {}));
+  const uint64_t num_nodes = graph.size();
+
+  katana::GReduceMax<uint64_t> max_id;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) { max_id.update(graph.GetData<PreviousComponentId>(n)); },
+      katana::no_stats());
+  const uint64_t num_components = graph.empty() ? 0 : max_id.reduce() + 1;
+  if (num_components > num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "component ids of {} are not dense: found {} for {} nodes",
+        previous_component_property_name, num_components - 1, num_nodes);
+  }
+  katana::GReduceLogicalOr invalid;
+  katana::do_all(
+      katana::iterate(added_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        if (edge.first >= num_nodes || edge.second >= num_nodes) {
+          invalid.update(true);
+        }
+      },
+      katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "added edges must be between the {} nodes of the graph", num_nodes);
+  }
+
+  katana::StatTimer exec_time("ConnectedComponentsIncremental");
+  exec_time.start();
+
+  // the sets are components, so an edge inside a component costs two Finds
+  katana::DisjointSets components(num_components);
+  uint64_t merged = components.UniteMany(
+      added_edges, [&](const std::pair<uint32_t, uint32_t>& edge) {
+        return std::make_pair(
+            static_cast<katana::DisjointSets::Index>(
+                graph.GetData<PreviousComponentId>(edge.first)),
+            static_cast<katana::DisjointSets::Index>(
+                graph.GetData<PreviousComponentId>(edge.second)));
+      });
+  components.Compress();
+
+  // the merged components are named by their smallest id, so ranking the
+  // representatives keeps the order of the others
+  katana::NUMAArray<uint64_t> rank;
+  rank.allocateBlocked(num_components);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_components),
+      [&](uint64_t c) { rank[c] = components.IsRepresentative(c); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) {
+        uint64_t previous = graph.GetData<PreviousComponentId>(n);
+        graph.GetData<ComponentId>(n) = rank[components.Parent(previous)] - 1;
+      },
+      katana::loopname("CC-Incremental-Relabel"));
+
+  exec_time.stop();
+  katana::ReportStatSingle(
+      "ConnectedComponentsIncremental", "MergedComponents", merged);
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
@@ -1282,6 +1474,66 @@ katana::analytics::ConnectedComponentsAssertValid(
   return katana::ResultSuccess();
 }
 
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::ConnectedComponentSizes(
+    PropertyGraph* pg, const std::string& property_name) {
+  ComponentGraph graph =
+      KATANA_CHECKED(ComponentGraph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<uint64_t> max_id;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) { max_id.update(graph.GetData<ComponentId>(n)); },
+      katana::no_stats());
+  const uint64_t num_components = graph.empty() ? 0 : max_id.reduce() + 1;
+  if (num_components > graph.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "component ids of {} are not dense: found {} for {} nodes",
+        property_name, num_components - 1, graph.size());
+  }
+
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(num_components);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_components),
+      [&](uint64_t c) { sizes[c] = 0; }, katana::no_stats());
+  // Runs of nodes in the same component are counted before adding them up,
+  // so that the threads do not all contend for the largest component
+  const uint64_t num_nodes = graph.size();
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(uint64_t{0}, num_nodes, tid, total);
+    for (uint64_t n = begin; n < end;) {
+      uint64_t id = graph.GetData<ComponentId>(n);
+      uint64_t run = 0;
+      for (; n < end && graph.GetData<ComponentId>(n) == id; ++n) {
+        ++run;
+      }
+      katana::atomicAdd(sizes[id], run);
+    }
+  });
+
+  katana::ArrowRandomAccessBuilder<arrow::UInt64Type> components(
+      num_components);
+  katana::ArrowRandomAccessBuilder<arrow::UInt64Type> counts(num_components);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_components),
+      [&](uint64_t c) {
+        components[c] = c;
+        counts[c] = sizes[c];
+      },
+      katana::no_stats());
+
+  std::shared_ptr<arrow::Array> component_array =
+      KATANA_CHECKED(components.Finalize());
+  std::shared_ptr<arrow::Array> size_array = KATANA_CHECKED(counts.Finalize());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("component", arrow::uint64()),
+           arrow::field("size", arrow::uint64())}),
+      {component_array, size_array});
+}
+
 katana::Result<ConnectedComponentsStatistics>
 katana::analytics::ConnectedComponentsStatistics::Compute(
     katana::PropertyGraph* pg, const std::string& property_name) {
@@ -0,0 +1,286 @@
+#include "katana/analytics/fast_rp/fast_rp.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <arrow/api.h>
+
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/Sampling.h"
+#include "katana/analytics/SpMV.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Graph = katana::PropertyGraphViews::Default;
+using Node = Graph::Node;
+using Semiring = PlusTimes<float>;
+
+/// Scale every row of width entries of m to unit Euclidean norm; rows of
+/// zeros stay zeros
+void
+NormalizeRows(const Graph& graph, float* m, size_t width) {
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        float* row = m + uint64_t{n} * width;
+        float sum_squares = 0;
+        for (size_t j = 0; j < width; ++j) {
+          sum_squares += row[j] * row[j];
+        }
+        if (sum_squares > 0) {
+          float scale = 1 / std::sqrt(sum_squares);
+          for (size_t j = 0; j < width; ++j) {
+            row[j] *= scale;
+          }
+        }
+      },
+      katana::no_stats(), katana::loopname("FastRP_Normalize"));
+}
+
+/// next = current averaged over the out-neighbors of every node. Averaging
+/// and summing differ by a factor per row, which NormalizeRows removes.
+template <size_t kWidth>
+void
+Propagate(
+    const Graph& graph, const float* current, float* next, size_t width) {
+  PullMxM<Semiring, kWidth>(
+      graph, UnitWeight<Semiring>(), current, next, width);
+  NormalizeRows(graph, next, width);
+}
+
+/// Propagate with the inner loops specialized for common widths
+void
+Hop(const Graph& graph, const float* current, float* next, size_t width) {
+  switch (width) {
+  case 32:
+    Propagate<32>(graph, current, next, width);
+    break;
+  case 64:
+    Propagate<64>(graph, current, next, width);
+    break;
+  case 128:
+    Propagate<128>(graph, current, next, width);
+    break;
+  case 256:
+    Propagate<256>(graph, current, next, width);
+    break;
+  default:
+    Propagate<kDynamicWidth>(graph, current, next, width);
+    break;
+  }
+}
+
+/// Fill projection with the very sparse random projection: each entry is
+/// sqrt(s) with probability 1 / 2s, -sqrt(s) with probability 1 / 2s and 0
+/// otherwise, times the degree of the node to the normalization strength
+void
+MakeProjection(
+    const Graph& graph, const FastRPPlan& plan, double sparsity,
+    float* projection) {
+  const size_t width = plan.embedding_dimension();
+  const uint64_t key = SamplingKey(plan.seed());
+  const double half_rate = 0.5 / sparsity;
+  const double magnitude = std::sqrt(sparsity);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        double scale = magnitude;
+        if (plan.normalization_strength() != 0) {
+          scale *= std::pow(
+              std::max<double>(graph.OutDegree(n), 1),
+              plan.normalization_strength());
+        }
+        float* row = projection + uint64_t{n} * width;
+        for (size_t j = 0; j < width; ++j) {
+          // draw by position so that the projection does not depend on the
+          // schedule
+          double unit = SampleUnit(key, uint64_t{n} * width + j);
+          if (unit < half_rate) {
+            row[j] = scale;
+          } else if (unit < 2 * half_rate) {
+            row[j] = -scale;
+          } else {
+            row[j] = 0;
+          }
+        }
+      },
+      katana::no_stats(), katana::loopname("FastRP_Projection"));
+}
+
+katana::Result<void>
+CheckEmbeddingProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& property,
+    const std::string& property_name) {
+  if (property->type()->id() != arrow::Type::FIXED_SIZE_BINARY ||
+      static_cast<const arrow::FixedSizeBinaryType&>(*property->type())
+                  .byte_width() %
+              sizeof(float) !=
+          0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "property {} is a {}, not a fixed-size binary of floats",
+        property_name, property->type()->ToString());
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::FastRP(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, FastRPPlan plan) {
+  if (plan.embedding_dimension() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "embedding dimension must be positive");
+  }
+  if (plan.iteration_weights().empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "there must be at least one iteration weight");
+  }
+
+  Graph graph = pg->BuildView<Graph>();
+  const uint64_t num_nodes = graph.NumNodes();
+  const size_t width = plan.embedding_dimension();
+  double sparsity = plan.sparsity() != 0
+                        ? plan.sparsity()
+                        : std::max(1.0, std::sqrt(double(num_nodes)));
+
+  auto type = KATANA_CHECKED(
+      arrow::FixedSizeBinaryType::Make(width * sizeof(float)));
+  std::shared_ptr<arrow::Buffer> embedding_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(num_nodes * width * sizeof(float)));
+  float* embedding =
+      reinterpret_cast<float*>(embedding_buffer->mutable_data());
+
+  katana::EnsurePreallocated(2, 2 * num_nodes * width * sizeof(float));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::NUMAArray<float> current;
+  current.allocateBlocked(num_nodes * width);
+  katana::NUMAArray<float> next;
+  next.allocateBlocked(num_nodes * width);
+
+  katana::StatTimer exec_time("FastRP", "FastRP");
+  exec_time.start();
+
+  float* current_rows = current.data();
+  float* next_rows = next.data();
+  MakeProjection(graph, plan, sparsity, current_rows);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        std::fill_n(embedding + uint64_t{n} * width, width, 0.0f);
+      },
+      katana::no_stats(), katana::loopname("FastRP_Init"));
+
+  for (double iteration_weight : plan.iteration_weights()) {
+    Hop(graph, current_rows, next_rows, width);
+    auto w = static_cast<float>(iteration_weight);
+    if (w != 0) {
+      katana::do_all(
+          katana::iterate(graph),
+          [&](const Node& n) {
+            const float* row = next_rows + uint64_t{n} * width;
+            float* out = embedding + uint64_t{n} * width;
+            for (size_t j = 0; j < width; ++j) {
+              out[j] += w * row[j];
+            }
+          },
+          katana::no_stats(), katana::loopname("FastRP_Accumulate"));
+    }
+    std::swap(current_rows, next_rows);
+  }
+
+  exec_time.stop();
+
+  auto array = std::make_shared<arrow::FixedSizeBinaryArray>(
+      type, num_nodes, std::move(embedding_buffer));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, type)}), {array});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::FastRPAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property = KATANA_CHECKED(pg->GetNodeProperty(property_name));
+  KATANA_CHECKED(CheckEmbeddingProperty(property, property_name));
+  if (static_cast<uint64_t>(property->length()) != pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "property {} has {} rows for {} nodes", property_name,
+        property->length(), pg->NumNodes());
+  }
+  for (const auto& chunk : property->chunks()) {
+    const auto& embeddings =
+        static_cast<const arrow::FixedSizeBinaryArray&>(*chunk);
+    const auto* values =
+        reinterpret_cast<const float*>(embeddings.raw_values());
+    size_t num_values =
+        embeddings.length() * embeddings.byte_width() / sizeof(float);
+    if (!std::all_of(values, values + num_values, [](float v) {
+          return std::isfinite(v);
+        })) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "property {} has embeddings that are not finite", property_name);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<FastRPStatistics>
+katana::analytics::FastRPStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property = KATANA_CHECKED(pg->GetNodeProperty(property_name));
+  KATANA_CHECKED(CheckEmbeddingProperty(property, property_name));
+  const size_t width =
+      static_cast<const arrow::FixedSizeBinaryType&>(*property->type())
+          .byte_width() /
+      sizeof(float);
+
+  katana::GAccumulator<double> sum_norms;
+  katana::GAccumulator<uint64_t> zero_embeddings;
+  for (const auto& chunk : property->chunks()) {
+    const auto& embeddings =
+        static_cast<const arrow::FixedSizeBinaryArray&>(*chunk);
+    const auto* values =
+        reinterpret_cast<const float*>(embeddings.raw_values());
+    katana::do_all(
+        katana::iterate(int64_t{0}, embeddings.length()),
+        [&](int64_t i) {
+          const float* row = values + i * width;
+          double sum_squares = 0;
+          for (size_t j = 0; j < width; ++j) {
+            sum_squares += double(row[j]) * row[j];
+          }
+          sum_norms += std::sqrt(sum_squares);
+          if (sum_squares == 0) {
+            zero_embeddings += 1;
+          }
+        },
+        katana::no_stats(), katana::loopname("FastRP_Statistics"));
+  }
+
+  FastRPStatistics stats;
+  stats.embedding_dimension = width;
+  stats.mean_norm =
+      pg->NumNodes() == 0 ? 0 : sum_norms.reduce() / pg->NumNodes();
+  stats.zero_embeddings = zero_embeddings.reduce();
+  return stats;
+}
+
+void
+katana::analytics::FastRPStatistics::Print(std::ostream& os) const {
+  os << "Embedding dimension = " << embedding_dimension << std::endl;
+  os << "Mean embedding norm = " << mean_norm << std::endl;
+  os << "Number of zero embeddings = " << zero_embeddings << std::endl;
+}
@@ -0,0 +1,314 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2019, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/NodePriority.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+struct NodeColor : public katana::PODProperty<uint32_t> {};
+
+using NodeData = std::tuple<NodeColor>;
+using EdgeData = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+typedef typename Graph::Node GNode;
+
+constexpr uint32_t kUncolored = std::numeric_limits<uint32_t>::max();
+
+/// Finds the smallest color that is not taken by the neighbors of a node. A
+/// node of degree d always gets a color of at most d, so only the colors up to
+/// d are tracked, and marks are reset by moving to a new epoch.
+class ColorPicker {
+public:
+  void Start(uint64_t degree) {
+    limit_ = degree + 1;
+    if (marks_.size() < limit_) {
+      marks_.resize(limit_, 0);
+    }
+    if (++epoch_ == 0) {
+      std::fill(marks_.begin(), marks_.end(), 0);
+      epoch_ = 1;
+    }
+  }
+
+  void Forbid(uint32_t color) {
+    if (color < limit_) {
+      marks_[color] = epoch_;
+    }
+  }
+
+  uint32_t Pick() const {
+    uint32_t color = 0;
+    while (marks_[color] == epoch_) {
+      ++color;
+    }
+    return color;
+  }
+
+private:
+  std::vector<uint32_t> marks_;
+  uint32_t epoch_{0};
+  uint64_t limit_{0};
+};
+
+struct JonesPlassmannAlgo {
+  void operator()(Graph* graph, const katana::NUMAArray<uint64_t>& priorities) {
+    katana::NUMAArray<std::atomic<uint32_t>> waiting;
+    waiting.allocateBlocked(graph->size());
+    katana::PerThreadStorage<ColorPicker> pickers;
+
+    auto current = std::make_unique<katana::InsertBag<GNode>>();
+    auto next = std::make_unique<katana::InsertBag<GNode>>();
+
+    // Nodes wait for their higher priority neighbors
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          uint32_t higher = 0;
+          for (auto edge : graph->OutEdges(src)) {
+            auto dest = graph->OutEdgeDst(edge);
+            if (dest != src && priorities[dest] > priorities[src]) {
+              ++higher;
+            }
+          }
+          waiting[src] = higher;
+          graph->GetData<NodeColor>(src) = kUncolored;
+          if (higher == 0) {
+            current->push(src);
+          }
+        },
+        katana::loopname("GraphColoring-JP-init"), katana::steal());
+
+    size_t rounds = 0;
+    while (!current->empty()) {
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const GNode& src) {
+            ColorPicker& picker = *pickers.getLocal();
+            picker.Start(graph->OutDegree(src));
+            for (auto edge : graph->OutEdges(src)) {
+              auto dest = graph->OutEdgeDst(edge);
+              if (dest != src && priorities[dest] > priorities[src]) {
+                picker.Forbid(graph->GetData<NodeColor>(dest));
+              }
+            }
+            graph->GetData<NodeColor>(src) = picker.Pick();
+
+            // Lower priority neighbors whose last higher priority neighbor
+            // this was are colored in the next round
+            for (auto edge : graph->OutEdges(src)) {
+              auto dest = graph->OutEdgeDst(edge);
+              if (dest != src && priorities[dest] < priorities[src] &&
+                  katana::atomicSub(waiting[dest], 1U) == 1) {
+                next->push(dest);
+              }
+            }
+          },
+          katana::loopname("GraphColoring-JP-color"), katana::steal());
+
+      current->clear();
+      std::swap(current, next);
+      rounds += 1;
+    }
+
+    katana::ReportStatSingle("GraphColoring-JonesPlassmann", "rounds", rounds);
+  }
+};
+
+struct SpeculativeAlgo {
+  void operator()(Graph* graph, const katana::NUMAArray<uint64_t>& priorities) {
+    katana::PerThreadStorage<ColorPicker> pickers;
+
+    auto current = std::make_unique<katana::InsertBag<GNode>>();
+    auto next = std::make_unique<katana::InsertBag<GNode>>();
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          graph->GetData<NodeColor>(src) = kUncolored;
+          current->push(src);
+        },
+        katana::loopname("GraphColoring-speculative-init"));
+
+    size_t rounds = 0;
+    while (!current->empty()) {
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const GNode& src) {
+            ColorPicker& picker = *pickers.getLocal();
+            picker.Start(graph->OutDegree(src));
+            for (auto edge : graph->OutEdges(src)) {
+              auto dest = graph->OutEdgeDst(edge);
+              if (dest != src) {
+                picker.Forbid(graph->GetData<NodeColor>(dest));
+              }
+            }
+            graph->GetData<NodeColor>(src) = picker.Pick();
+          },
+          katana::loopname("GraphColoring-speculative-color"),
+          katana::steal());
+
+      // Neighbors colored at the same time may have taken the same color;
+      // the lower priority one tries again
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const GNode& src) {
+            uint32_t color = graph->GetData<NodeColor>(src);
+            for (auto edge : graph->OutEdges(src)) {
+              auto dest = graph->OutEdgeDst(edge);
+              if (dest != src && graph->GetData<NodeColor>(dest) == color &&
+                  priorities[dest] > priorities[src]) {
+                next->push(src);
+                return;
+              }
+            }
+          },
+          katana::loopname("GraphColoring-speculative-repair"),
+          katana::steal());
+
+      current->clear();
+      std::swap(current, next);
+      rounds += 1;
+    }
+
+    katana::ReportStatSingle("GraphColoring-Speculative", "rounds", rounds);
+  }
+};
+
+template <typename Algo>
+katana::Result<void>
+Run(katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("GraphColoring");
+
+  exec_time.start();
+  katana::NUMAArray<uint64_t> priorities = DegreePriorities(graph);
+  Algo impl;
+  impl(&graph, priorities);
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphColoring(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, GraphColoringPlan plan) {
+  switch (plan.algorithm()) {
+  case GraphColoringPlan::kJonesPlassmann:
+    return Run<JonesPlassmannAlgo>(pg, output_property_name, txn_ctx);
+  case GraphColoringPlan::kSpeculative:
+    return Run<SpeculativeAlgo>(pg, output_property_name, txn_ctx);
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
+katana::Result<void>
+katana::analytics::GraphColoringAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  auto is_bad = [&graph](const GNode& src) {
+    uint32_t color = graph.GetData<NodeColor>(src);
+    if (color == kUncolored) {
+      return true;
+    }
+    for (auto edge : graph.OutEdges(src)) {
+      auto dest = graph.OutEdgeDst(edge);
+      if (dest != src && graph.GetData<NodeColor>(dest) == color) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad) !=
+      graph.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::GraphColoringStatistics::Print(std::ostream& os) const {
+  os << "Number of colors = " << num_colors << std::endl;
+  os << "Largest color size = " << largest_color_size << std::endl;
+}
+
+katana::Result<GraphColoringStatistics>
+katana::analytics::GraphColoringStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<uint32_t> max_color;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { max_color.update(graph.GetData<NodeColor>(n)); },
+      katana::loopname("GraphColoring-max-color"), katana::no_stats());
+  if (graph.size() == 0) {
+    return GraphColoringStatistics{0, 0};
+  }
+  uint32_t num_colors = max_color.reduce() + 1;
+
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateInterleaved(num_colors);
+  katana::ParallelSTL::fill(sizes.begin(), sizes.end(), 0);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        katana::atomicAdd(sizes[graph.GetData<NodeColor>(n)], uint64_t{1});
+      },
+      katana::loopname("GraphColoring-color-sizes"), katana::no_stats());
+
+  uint64_t largest_color_size = 0;
+  for (uint32_t c = 0; c < num_colors; ++c) {
+    largest_color_size = std::max<uint64_t>(largest_color_size, sizes[c]);
+  }
+  return GraphColoringStatistics{num_colors, largest_color_size};
+}
@@ -0,0 +1,663 @@
+#include "katana/analytics/graph_partition/graph_partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/NodePriority.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+struct NodePartition : public katana::PODProperty<uint32_t> {};
+
+using NodeData = std::tuple<NodePartition>;
+using EdgeData = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+typedef typename Graph::Node GNode;
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr Node kUnmatched = std::numeric_limits<Node>::max();
+constexpr uint32_t kNoPartition = std::numeric_limits<uint32_t>::max();
+
+/// Rounds of proposals per matching
+constexpr uint32_t kMatchingRounds = 4;
+/// Coarsening stops once a level would keep more of the nodes than this
+constexpr double kMaxCoarseningRatio = 0.95;
+
+/// A graph of the multilevel hierarchy. Level 0 is the input graph, whose
+/// nodes and edges all weigh 1. Every node of a coarser level stands for one
+/// or two nodes of the level below and weighs as much as they do together.
+struct Level {
+  const katana::GraphTopology* topology{nullptr};
+  /// The topology of a coarser level, which it owns
+  katana::GraphTopology coarse_topology;
+  /// Empty at level 0
+  katana::NUMAArray<uint64_t> node_weights;
+  katana::NUMAArray<uint64_t> edge_weights;
+  /// The node of the next coarser level each node is in
+  katana::NUMAArray<Node> coarse_nodes;
+  uint64_t total_weight{0};
+
+  uint64_t NumNodes() const { return topology->NumNodes(); }
+
+  uint64_t NodeWeight(Node n) const {
+    return node_weights.empty() ? 1 : node_weights[n];
+  }
+
+  uint64_t EdgeWeight(Edge e) const {
+    return edge_weights.empty() ? 1 : edge_weights[e];
+  }
+};
+
+/// \returns the matching priority of an edge between a and b of weight
+/// weight. Heavier edges go first and ties are broken by a hash of the ends,
+/// so an edge has the same priority seen from either end.
+uint64_t
+EdgePriority(uint64_t weight, Node a, Node b) {
+  uint32_t hash =
+      NodePriorityHash(std::min(a, b) ^ NodePriorityHash(std::max(a, b)));
+  return std::min<uint64_t>(weight, UINT32_MAX) << 32 | hash;
+}
+
+/// Matches nodes along heavy edges by handshaking: every unmatched node
+/// proposes to the unmatched neighbor across its highest priority edge, and
+/// nodes that propose to each other are matched. The highest priority edge
+/// left is always matched, so every round makes progress, and the matching
+/// does not depend on the order nodes are visited in. Nodes without
+/// neighbors are matched with each other. Matched nodes weigh at most
+/// max_node_weight together.
+katana::NUMAArray<Node>
+MatchHeavyEdges(const Level& level, uint64_t max_node_weight) {
+  const katana::GraphTopology& topo = *level.topology;
+  katana::NUMAArray<Node> mates;
+  mates.allocateBlocked(topo.NumNodes());
+  katana::ParallelSTL::fill(mates.begin(), mates.end(), kUnmatched);
+  katana::NUMAArray<Node> proposals;
+  proposals.allocateBlocked(topo.NumNodes());
+
+  for (uint32_t round = 0; round < kMatchingRounds; ++round) {
+    katana::GAccumulator<uint64_t> num_proposals;
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node src) {
+          proposals[src] = kUnmatched;
+          if (mates[src] != kUnmatched) {
+            return;
+          }
+          uint64_t src_weight = level.NodeWeight(src);
+          uint64_t best = 0;
+          for (Edge e : topo.OutEdges(src)) {
+            Node dest = topo.OutEdgeDst(e);
+            if (dest == src || mates[dest] != kUnmatched ||
+                src_weight + level.NodeWeight(dest) > max_node_weight) {
+              continue;
+            }
+            uint64_t priority = EdgePriority(level.EdgeWeight(e), src, dest);
+            if (proposals[src] == kUnmatched || priority > best) {
+              best = priority;
+              proposals[src] = dest;
+            }
+          }
+          if (proposals[src] != kUnmatched) {
+            num_proposals += 1;
+          }
+        },
+        katana::loopname("GraphPartition-propose"), katana::steal());
+
+    if (num_proposals.reduce() == 0) {
+      break;
+    }
+
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node src) {
+          Node dest = proposals[src];
+          if (dest != kUnmatched && proposals[dest] == src) {
+            mates[src] = dest;
+          }
+        },
+        katana::loopname("GraphPartition-match"));
+  }
+
+  katana::InsertBag<Node> loner_bag;
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node src) {
+        if (topo.OutDegree(src) == 0) {
+          loner_bag.push(src);
+        }
+      },
+      katana::no_stats());
+  std::vector<Node> loners(loner_bag.begin(), loner_bag.end());
+  katana::ParallelSTL::sort(loners.begin(), loners.end());
+  katana::do_all(
+      katana::iterate(size_t{0}, loners.size() / 2),
+      [&](size_t i) {
+        Node a = loners[2 * i];
+        Node b = loners[2 * i + 1];
+        if (level.NodeWeight(a) + level.NodeWeight(b) <= max_node_weight) {
+          mates[a] = b;
+          mates[b] = a;
+        }
+      },
+      katana::no_stats());
+
+  return mates;
+}
+
+/// \returns the next coarser level of level, whose nodes are the matches of
+/// mates and the nodes left unmatched. Edges between the same two coarse
+/// nodes become one edge that weighs as much as they do together, and edges
+/// within a coarse node go away. Fills in level->coarse_nodes.
+std::unique_ptr<Level>
+Coarsen(Level* level, const katana::NUMAArray<Node>& mates) {
+  const katana::GraphTopology& topo = *level->topology;
+  uint64_t num_nodes = topo.NumNodes();
+
+  // The lower node of a match leads it, and coarse nodes are numbered in the
+  // order of their leaders
+  auto is_leader = [&](Node n) {
+    return mates[n] == kUnmatched || n < mates[n];
+  };
+  katana::NUMAArray<Node> ranks;
+  ranks.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) { ranks[n] = is_leader(n) ? 1 : 0; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(ranks.begin(), ranks.end(), ranks.begin());
+  uint64_t num_coarse_nodes = num_nodes == 0 ? 0 : ranks[num_nodes - 1];
+
+  auto coarse = std::make_unique<Level>();
+  coarse->total_weight = level->total_weight;
+  coarse->node_weights.allocateBlocked(num_coarse_nodes);
+  katana::NUMAArray<Node> leaders;
+  leaders.allocateBlocked(num_coarse_nodes);
+  level->coarse_nodes.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        Node leader = is_leader(n) ? n : mates[n];
+        Node coarse_node = ranks[leader] - 1;
+        level->coarse_nodes[n] = coarse_node;
+        if (n != leader) {
+          return;
+        }
+        leaders[coarse_node] = n;
+        uint64_t weight = level->NodeWeight(n);
+        if (mates[n] != kUnmatched) {
+          weight += level->NodeWeight(mates[n]);
+        }
+        coarse->node_weights[coarse_node] = weight;
+      },
+      katana::loopname("GraphPartition-coarse-nodes"));
+
+  using WeightedEdge = std::pair<Node, uint64_t>;
+  katana::PerThreadStorage<std::vector<WeightedEdge>> scratch;
+  // Merges the edges of the nodes of coarse node c into the scratch space of
+  // this thread
+  auto merge_edges = [&](Node c) -> const std::vector<WeightedEdge>& {
+    std::vector<WeightedEdge>& edges = *scratch.getLocal();
+    edges.clear();
+    for (Node child : {leaders[c], mates[leaders[c]]}) {
+      if (child == kUnmatched) {
+        continue;
+      }
+      for (Edge e : topo.OutEdges(child)) {
+        Node dest = level->coarse_nodes[topo.OutEdgeDst(e)];
+        if (dest != c) {
+          edges.emplace_back(dest, level->EdgeWeight(e));
+        }
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+    size_t merged = 0;
+    for (const WeightedEdge& edge : edges) {
+      if (merged > 0 && edges[merged - 1].first == edge.first) {
+        edges[merged - 1].second += edge.second;
+      } else {
+        edges[merged++] = edge;
+      }
+    }
+    edges.resize(merged);
+    return edges;
+  };
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateBlocked(num_coarse_nodes);
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(num_coarse_nodes)),
+      [&](Node c) { adj_indices[c] = merge_edges(c).size(); },
+      katana::loopname("GraphPartition-coarse-degrees"), katana::steal());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+  uint64_t num_coarse_edges =
+      num_coarse_nodes == 0 ? 0 : adj_indices[num_coarse_nodes - 1];
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateBlocked(num_coarse_edges);
+  coarse->edge_weights.allocateBlocked(num_coarse_edges);
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(num_coarse_nodes)),
+      [&](Node c) {
+        Edge e = c == 0 ? 0 : adj_indices[c - 1];
+        for (const WeightedEdge& edge : merge_edges(c)) {
+          dests[e] = edge.first;
+          coarse->edge_weights[e] = edge.second;
+          ++e;
+        }
+      },
+      katana::loopname("GraphPartition-coarse-edges"), katana::steal());
+
+  coarse->coarse_topology =
+      katana::GraphTopology(std::move(adj_indices), std::move(dests));
+  coarse->topology = &coarse->coarse_topology;
+  return coarse;
+}
+
+/// Partitions level by greedy graph growing: every partition but the last
+/// grows breadth first from the lowest node that is left until it has its
+/// share of the weight that is left, and the last partition takes the rest.
+/// This only runs on the coarsest level, which is small, so it runs serially.
+katana::NUMAArray<uint32_t>
+GrowPartitions(const Level& level, uint32_t num_partitions) {
+  const katana::GraphTopology& topo = *level.topology;
+  uint64_t num_nodes = topo.NumNodes();
+  katana::NUMAArray<uint32_t> parts;
+  parts.allocateBlocked(num_nodes);
+  std::fill(parts.begin(), parts.end(), kNoPartition);
+
+  uint64_t remaining = level.total_weight;
+  Node next_seed = 0;
+  std::deque<Node> frontier;
+  for (uint32_t p = 0; p + 1 < num_partitions; ++p) {
+    uint64_t target = remaining / (num_partitions - p);
+    uint64_t weight = 0;
+    frontier.clear();
+    while (weight < target) {
+      Node n;
+      if (!frontier.empty()) {
+        n = frontier.front();
+        frontier.pop_front();
+        if (parts[n] != kNoPartition) {
+          continue;
+        }
+      } else {
+        while (next_seed < num_nodes && parts[next_seed] != kNoPartition) {
+          ++next_seed;
+        }
+        if (next_seed == num_nodes) {
+          break;
+        }
+        n = next_seed;
+      }
+      parts[n] = p;
+      weight += level.NodeWeight(n);
+      for (Edge e : topo.OutEdges(n)) {
+        Node dest = topo.OutEdgeDst(e);
+        if (parts[dest] == kNoPartition) {
+          frontier.push_back(dest);
+        }
+      }
+    }
+    remaining -= weight;
+  }
+
+  for (uint32_t& part : parts) {
+    if (part == kNoPartition) {
+      part = num_partitions - 1;
+    }
+  }
+  return parts;
+}
+
+/// Sums the weights of the edges from a node to each partition. Like the
+/// ColorPicker of graph coloring, it is reused across nodes and only resets
+/// the partitions the last node touched.
+class PartitionConnectivity {
+public:
+  void Start(uint32_t num_partitions) {
+    if (weights_.size() < num_partitions) {
+      weights_.resize(num_partitions, 0);
+    }
+    for (uint32_t p : touched_) {
+      weights_[p] = 0;
+    }
+    touched_.clear();
+  }
+
+  void Add(uint32_t p, uint64_t weight) {
+    if (weights_[p] == 0) {
+      touched_.emplace_back(p);
+    }
+    weights_[p] += weight;
+  }
+
+  uint64_t Weight(uint32_t p) const { return weights_[p]; }
+
+  const std::vector<uint32_t>& Touched() const { return touched_; }
+
+private:
+  std::vector<uint64_t> weights_;
+  std::vector<uint32_t> touched_;
+};
+
+/// Moves boundary nodes of level to the neighboring partition they have the
+/// most edge weight to. Passes alternate between moves to higher and to lower
+/// partition ids, so two neighbors never trade places at once on the strength
+/// of each other's old partitions. A move must cut less edge weight, or as
+/// much while evening out the two partitions, and must keep the partition the
+/// node goes to at most max_weight. Nodes of partitions heavier than
+/// max_weight move even if that cuts more, to the lightest partition if none
+/// of their neighbors will do.
+void
+Refine(
+    const Level& level, uint32_t num_partitions, uint64_t max_weight,
+    uint32_t max_iterations, katana::NUMAArray<uint32_t>* parts_ptr) {
+  const katana::GraphTopology& topo = *level.topology;
+  katana::NUMAArray<uint32_t>& parts = *parts_ptr;
+
+  katana::PerThreadStorage<std::vector<uint64_t>> local_weights;
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node n) {
+        std::vector<uint64_t>& local = *local_weights.getLocal();
+        local.resize(num_partitions, 0);
+        local[parts[n]] += level.NodeWeight(n);
+      },
+      katana::no_stats());
+  katana::NUMAArray<std::atomic<uint64_t>> weights;
+  weights.allocateInterleaved(num_partitions);
+  katana::ParallelSTL::fill(weights.begin(), weights.end(), 0);
+  for (unsigned i = 0; i < local_weights.size(); ++i) {
+    const std::vector<uint64_t>& local = *local_weights.getRemote(i);
+    for (size_t p = 0; p < local.size(); ++p) {
+      weights[p] += local[p];
+    }
+  }
+
+  katana::PerThreadStorage<PartitionConnectivity> connectivities;
+  uint32_t idle_passes = 0;
+  for (uint32_t pass = 0; pass < 2 * max_iterations && idle_passes < 2;
+       ++pass) {
+    bool upward = pass % 2 == 0;
+    uint32_t lightest = 0;
+    for (uint32_t p = 1; p < num_partitions; ++p) {
+      if (weights[p] < weights[lightest]) {
+        lightest = p;
+      }
+    }
+
+    katana::GAccumulator<uint64_t> moves;
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node src) {
+          uint32_t from = parts[src];
+          bool overweight = weights[from] > max_weight;
+          PartitionConnectivity& connectivity = *connectivities.getLocal();
+          connectivity.Start(num_partitions);
+          for (Edge e : topo.OutEdges(src)) {
+            Node dest = topo.OutEdgeDst(e);
+            if (dest != src) {
+              connectivity.Add(parts[dest], level.EdgeWeight(e));
+            }
+          }
+          const std::vector<uint32_t>& touched = connectivity.Touched();
+          bool interior = touched.empty() ||
+                          (touched.size() == 1 && touched[0] == from);
+          if (interior && !overweight) {
+            return;
+          }
+
+          uint64_t weight = level.NodeWeight(src);
+          uint32_t best = kNoPartition;
+          int64_t best_gain = 0;
+          auto consider = [&](uint32_t to) {
+            if (to == from || (to > from) != upward ||
+                weights[to] + weight > max_weight) {
+              return;
+            }
+            int64_t gain = static_cast<int64_t>(connectivity.Weight(to)) -
+                           static_cast<int64_t>(connectivity.Weight(from));
+            if (best == kNoPartition || gain > best_gain ||
+                (gain == best_gain && weights[to] < weights[best])) {
+              best = to;
+              best_gain = gain;
+            }
+          };
+          for (uint32_t to : touched) {
+            consider(to);
+          }
+          if (overweight) {
+            consider(lightest);
+          }
+          if (best == kNoPartition) {
+            return;
+          }
+          bool evens_out = weights[best] + weight < weights[from];
+          if (best_gain < 0 && !overweight) {
+            return;
+          }
+          if (best_gain == 0 && !evens_out && !overweight) {
+            return;
+          }
+
+          // Another thread may have filled up best in the meantime
+          if (weights[best].fetch_add(weight) + weight > max_weight) {
+            weights[best].fetch_sub(weight);
+            return;
+          }
+          weights[from].fetch_sub(weight);
+          parts[src] = best;
+          moves += 1;
+        },
+        katana::loopname("GraphPartition-refine"), katana::steal());
+
+    idle_passes = moves.reduce() == 0 ? idle_passes + 1 : 0;
+  }
+}
+
+/// \returns the partitions of the nodes of fine given the partitions of the
+/// nodes of the next coarser level
+katana::NUMAArray<uint32_t>
+Project(const Level& fine, const katana::NUMAArray<uint32_t>& coarse_parts) {
+  katana::NUMAArray<uint32_t> parts;
+  parts.allocateBlocked(fine.NumNodes());
+  katana::do_all(
+      katana::iterate(fine.topology->Nodes()),
+      [&](Node n) { parts[n] = coarse_parts[fine.coarse_nodes[n]]; },
+      katana::loopname("GraphPartition-project"));
+  return parts;
+}
+
+void
+MultilevelPartition(
+    Graph* graph, const katana::GraphTopology& topology,
+    uint32_t num_partitions, const GraphPartitionPlan& plan) {
+  std::vector<std::unique_ptr<Level>> levels;
+  levels.emplace_back(std::make_unique<Level>());
+  levels[0]->topology = &topology;
+  levels[0]->total_weight = topology.NumNodes();
+
+  uint64_t coarsen_to = std::max<uint64_t>(
+      1, uint64_t{plan.coarsen_to_per_partition()} * num_partitions);
+  // As in METIS, coarse nodes are kept light enough that the coarsest level
+  // can still be balanced
+  uint64_t max_node_weight =
+      std::max<uint64_t>(1, 3 * topology.NumNodes() / (2 * coarsen_to));
+  while (levels.back()->NumNodes() > coarsen_to) {
+    Level* fine = levels.back().get();
+    katana::NUMAArray<Node> mates = MatchHeavyEdges(*fine, max_node_weight);
+    std::unique_ptr<Level> coarse = Coarsen(fine, mates);
+    if (coarse->NumNodes() > kMaxCoarseningRatio * fine->NumNodes()) {
+      // Matching has run out of pairs, e.g., around the hub of a star
+      break;
+    }
+    levels.emplace_back(std::move(coarse));
+  }
+  katana::ReportStatSingle("GraphPartition", "levels", levels.size());
+
+  uint64_t average =
+      (topology.NumNodes() + num_partitions - 1) / num_partitions;
+  uint64_t max_weight =
+      average + static_cast<uint64_t>(average * plan.imbalance());
+
+  katana::NUMAArray<uint32_t> parts =
+      GrowPartitions(*levels.back(), num_partitions);
+  while (true) {
+    Refine(
+        *levels.back(), num_partitions, max_weight,
+        plan.max_refinement_iterations(), &parts);
+    if (levels.size() == 1) {
+      break;
+    }
+    levels.pop_back();
+    parts = Project(*levels.back(), parts);
+  }
+
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](Node n) { graph->GetData<NodePartition>(n) = parts[n]; },
+      katana::no_stats());
+}
+
+katana::Result<void>
+Run(katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const GraphPartitionPlan& plan) {
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("GraphPartition");
+
+  exec_time.start();
+  MultilevelPartition(&graph, pg->topology(), num_partitions, plan);
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphPartition(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    GraphPartitionPlan plan) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "number of partitions must be positive");
+  }
+  if (plan.imbalance() < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "imbalance must not be negative");
+  }
+
+  switch (plan.algorithm()) {
+  case GraphPartitionPlan::kMultilevel:
+    return Run(pg, num_partitions, output_property_name, txn_ctx, plan);
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
+katana::Result<void>
+katana::analytics::GraphPartitionAssertValid(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  auto is_bad = [&](const GNode& n) {
+    return graph.GetData<NodePartition>(n) >= num_partitions;
+  };
+
+  if (katana::ParallelSTL::find_if(graph.begin(), graph.end(), is_bad) !=
+      graph.end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::GraphPartitionStatistics::Print(std::ostream& os) const {
+  os << "Number of partitions = " << num_partitions << std::endl;
+  os << "Edge cut = " << edge_cut << std::endl;
+  os << "Largest partition size = " << largest_partition_size << std::endl;
+  os << "Smallest partition size = " << smallest_partition_size << std::endl;
+}
+
+katana::Result<GraphPartitionStatistics>
+katana::analytics::GraphPartitionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  if (graph.size() == 0) {
+    return GraphPartitionStatistics{0, 0, 0, 0};
+  }
+
+  katana::GReduceMax<uint32_t> max_part;
+  katana::GAccumulator<uint64_t> edge_cut;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        uint32_t part = graph.GetData<NodePartition>(n);
+        max_part.update(part);
+        for (auto e : graph.OutEdges(n)) {
+          auto dest = graph.OutEdgeDst(e);
+          if (n < dest && graph.GetData<NodePartition>(dest) != part) {
+            edge_cut += 1;
+          }
+        }
+      },
+      katana::loopname("GraphPartition-edge-cut"), katana::no_stats());
+  uint32_t num_parts = max_part.reduce() + 1;
+
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateInterleaved(num_parts);
+  katana::ParallelSTL::fill(sizes.begin(), sizes.end(), 0);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        katana::atomicAdd(
+            sizes[graph.GetData<NodePartition>(n)], uint64_t{1});
+      },
+      katana::loopname("GraphPartition-partition-sizes"), katana::no_stats());
+
+  GraphPartitionStatistics stats{
+      0, edge_cut.reduce(), 0, std::numeric_limits<uint64_t>::max()};
+  for (uint32_t p = 0; p < num_parts; ++p) {
+    if (sizes[p] == 0) {
+      continue;
+    }
+    stats.num_partitions += 1;
+    stats.largest_partition_size =
+        std::max<uint64_t>(stats.largest_partition_size, sizes[p]);
+    stats.smallest_partition_size =
+        std::min<uint64_t>(stats.smallest_partition_size, sizes[p]);
+  }
+  return stats;
+}
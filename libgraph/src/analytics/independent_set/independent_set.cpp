@@ -31,6 +31,7 @@
 #include "katana/Reduction.h"
 #include "katana/Timer.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/NodePriority.h"
 #include "katana/analytics/Utils.h"
 
 namespace {
@@ -40,13 +41,6 @@ using namespace katana::analytics;
 constexpr int kChunkSize = 64;
 constexpr float kHashScale = 1.0 / std::numeric_limits<unsigned int>::max();
 
-unsigned int
-hash(unsigned int val) {
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  return (val >> 16) ^ val;
-}
-
 enum MatchFlag : char {
   KOtherMatched = false,
   kMatched = true,
@@ -340,7 +334,6 @@ struct PrioAlgo {
   void operator()(Graph* graph) {
     katana::GAccumulator<size_t> rounds;
     katana::GReduceLogicalOr unmatched;
-    katana::PerThreadStorage<std::mt19937*> generator;
 
     float avg_degree = graph->NumEdges() / graph->size();
     uint8_t in = ~1;
@@ -351,7 +344,7 @@ struct PrioAlgo {
         [&](const GNode& src) {
           auto& src_flag = graph->GetData<NodeFlag>(src);
           float degree = graph->OutEdges(src).size();
-          float x = degree - hash(src) * kHashScale;
+          float x = degree - NodePriorityHash(src) * kHashScale;
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 1;
           src_flag = val;
@@ -435,7 +428,6 @@ struct EdgeTiledPrioAlgo {
   void operator()(Graph* graph) {
     katana::GAccumulator<size_t> rounds;
     katana::GReduceLogicalOr unmatched;
-    katana::PerThreadStorage<std::mt19937*> generator;
     katana::InsertBag<EdgeTile> works;
     constexpr int kEdgeTileSize = 64;
 
@@ -452,7 +444,7 @@ struct EdgeTiledPrioAlgo {
           const auto end = rng.end();
 
           float degree = float(graph->OutDegree(src));
-          float x = degree - hash(src) * kHashScale;
+          float x = degree - NodePriorityHash(src) * kHashScale;
           int res = round(scale_avg / (avg_degree + x));
           uint8_t val = (res + res) | 0x03;
 
@@ -19,8 +19,20 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Sampling.h"
+#include "katana/analytics/SetIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -44,27 +56,9 @@ public:
       : base_(base), graph_(graph) {}
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.OutEdges(n2).begin();
-    auto edges_n2_end = graph_.OutEdges(n2).end();
-    auto edges_base_iter = graph_.OutEdges(base_).begin();
-    auto edges_base_end = graph_.OutEdges(base_).end();
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.OutEdgeDst(*edges_n2_iter);
-      auto edge_base_dst = graph_.OutEdgeDst(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
-    }
-    return intersection_size;
+    // Edge lists are assumed to be sorted.
+    return CountIntersection(
+        graph_.OutEdgeDsts(n2), graph_.OutEdgeDsts(base_));
   }
 };
 
@@ -134,6 +128,232 @@ JaccardImpl(Graph& graph, size_t compare_node, JaccardPlan /*plan*/) {
   return katana::ResultSuccess();
 }
 
+using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+
+/// \returns the similarity by measure of the out-neighbor sets of a and b
+double
+Similarity(
+    const SortedView& view, JaccardTopKPlan::Measure measure, GNode a,
+    GNode b) {
+  auto a_dsts = view.OutEdgeDsts(a);
+  auto b_dsts = view.OutEdgeDsts(b);
+  uint64_t intersection_size = CountIntersection(a_dsts, b_dsts);
+  if (intersection_size == 0) {
+    return 0;
+  }
+  uint64_t a_size = a_dsts.end() - a_dsts.begin();
+  uint64_t b_size = b_dsts.end() - b_dsts.begin();
+  switch (measure) {
+  case JaccardTopKPlan::kJaccard:
+    return static_cast<double>(intersection_size) /
+           (a_size + b_size - intersection_size);
+  case JaccardTopKPlan::kOverlap:
+    return static_cast<double>(intersection_size) / std::min(a_size, b_size);
+  case JaccardTopKPlan::kCosine:
+    return intersection_size /
+           std::sqrt(static_cast<double>(a_size) * static_cast<double>(b_size));
+  }
+  return 0;
+}
+
+/// MinHash signatures of the bands of the out-neighbor sets of all nodes.
+/// The nodes are also sorted by their signature in each band, so that the
+/// nodes that agree on a band are adjacent.
+class MinHashBands {
+public:
+  MinHashBands(const SortedView& view, const JaccardTopKPlan& plan)
+      : num_nodes_(view.NumNodes()),
+        num_bands_(plan.num_bands()),
+        max_bucket_size_(plan.max_bucket_size()) {
+    const uint32_t rows = plan.rows_per_band();
+    const uint64_t num_hashes = num_bands_ * rows;
+    std::vector<uint64_t> hash_keys(num_hashes);
+    uint64_t key = SamplingKey(plan.seed());
+    for (uint64_t j = 0; j < num_hashes; ++j) {
+      hash_keys[j] = SampleBits(key, j);
+    }
+
+    signatures_.allocateBlocked(num_nodes_ * num_bands_);
+    katana::PerThreadStorage<std::vector<uint64_t>> minima;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          std::vector<uint64_t>& min_hash = *minima.getLocal();
+          min_hash.assign(num_hashes, std::numeric_limits<uint64_t>::max());
+          for (GNode dst : view.OutEdgeDsts(n)) {
+            for (uint64_t j = 0; j < num_hashes; ++j) {
+              min_hash[j] =
+                  std::min(min_hash[j], SampleBits(hash_keys[j], dst));
+            }
+          }
+          for (uint64_t b = 0; b < num_bands_; ++b) {
+            uint64_t signature = 0;
+            for (uint32_t r = 0; r < rows; ++r) {
+              signature = SampleBits(signature ^ min_hash[b * rows + r], r);
+            }
+            signatures_[n * num_bands_ + b] = signature;
+          }
+        },
+        katana::steal(), katana::loopname("MinHashSignatures"));
+
+    sorted_.allocateBlocked(num_nodes_ * num_bands_);
+    position_.allocateBlocked(num_nodes_ * num_bands_);
+    for (uint64_t b = 0; b < num_bands_; ++b) {
+      uint32_t* band = sorted_.data() + b * num_nodes_;
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes_),
+          [&](uint64_t n) { band[n] = n; }, katana::no_stats());
+      katana::ParallelSTL::sort(
+          band, band + num_nodes_, [&](uint32_t x, uint32_t y) {
+            uint64_t x_signature = signature(x, b);
+            uint64_t y_signature = signature(y, b);
+            return x_signature < y_signature ||
+                   (x_signature == y_signature && x < y);
+          });
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes_),
+          [&](uint64_t i) { position_[b * num_nodes_ + band[i]] = i; },
+          katana::no_stats());
+    }
+  }
+
+  /// Call fn(v) for every node v that agrees with n on a band, n included,
+  /// unless more than max_bucket_size nodes agree on it
+  template <typename F>
+  void ForEachCandidate(GNode n, F fn) const {
+    for (uint64_t b = 0; b < num_bands_; ++b) {
+      const uint32_t* band = sorted_.data() + b * num_nodes_;
+      uint64_t n_signature = signature(n, b);
+      uint64_t begin = position_[b * num_nodes_ + n];
+      uint64_t end = begin + 1;
+      while (begin > 0 && end - begin <= max_bucket_size_ &&
+             signature(band[begin - 1], b) == n_signature) {
+        --begin;
+      }
+      while (end < num_nodes_ && end - begin <= max_bucket_size_ &&
+             signature(band[end], b) == n_signature) {
+        ++end;
+      }
+      if (end - begin > max_bucket_size_) {
+        continue;
+      }
+      for (uint64_t i = begin; i < end; ++i) {
+        fn(band[i]);
+      }
+    }
+  }
+
+private:
+  uint64_t signature(GNode n, uint64_t band) const {
+    return signatures_[n * num_bands_ + band];
+  }
+
+  uint64_t num_nodes_;
+  uint64_t num_bands_;
+  uint64_t max_bucket_size_;
+  /// num_bands_ signatures per node
+  katana::NUMAArray<uint64_t> signatures_;
+  /// The nodes of each band in order of their signatures
+  katana::NUMAArray<uint32_t> sorted_;
+  /// The position of each node in sorted_ for each band
+  katana::NUMAArray<uint64_t> position_;
+};
+
+/// Score the candidates of every node and keep the best k. Each thread
+/// appends the pairs of the nodes it scores to its own list, and the lists
+/// are then copied into the table in node order.
+template <typename Candidates>
+katana::Result<std::shared_ptr<arrow::Table>>
+TopKImpl(
+    const SortedView& view, uint32_t k, JaccardTopKPlan::Measure measure,
+    const Candidates& for_each_candidate) {
+  using Pair = std::pair<double, uint32_t>;
+
+  const uint64_t num_nodes = view.NumNodes();
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateBlocked(num_nodes);
+  katana::NUMAArray<uint64_t> begins;
+  begins.allocateBlocked(num_nodes);
+  katana::NUMAArray<uint16_t> threads;
+  threads.allocateBlocked(num_nodes);
+
+  katana::PerThreadStorage<std::vector<Pair>> found;
+  katana::PerThreadStorage<std::vector<uint32_t>> candidates_storage;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        std::vector<Pair>& pairs = *found.getLocal();
+        threads[n] = katana::ThreadPool::getTID();
+        begins[n] = pairs.size();
+        offsets[n] = 0;
+        if (view.OutDegree(n) == 0) {
+          return;
+        }
+
+        std::vector<uint32_t>& candidates = *candidates_storage.getLocal();
+        candidates.clear();
+        for_each_candidate(n, [&](uint32_t v) {
+          if (v != n) {
+            candidates.emplace_back(v);
+          }
+        });
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(
+            std::unique(candidates.begin(), candidates.end()),
+            candidates.end());
+
+        for (uint32_t v : candidates) {
+          double similarity = Similarity(view, measure, n, v);
+          if (similarity > 0) {
+            pairs.emplace_back(similarity, v);
+          }
+        }
+        auto first = pairs.begin() + begins[n];
+        uint64_t kept = std::min<uint64_t>(k, pairs.end() - first);
+        // most similar first, ties by node id
+        std::partial_sort(
+            first, first + kept, pairs.end(), [](const Pair& a, const Pair& b) {
+              return a.first > b.first ||
+                     (a.first == b.first && a.second < b.second);
+            });
+        pairs.resize(begins[n] + kept);
+        offsets[n] = kept;
+      },
+      katana::steal(), katana::loopname("JaccardTopK"));
+
+  katana::ParallelSTL::partial_sum(
+      offsets.begin(), offsets.end(), offsets.begin());
+  const uint64_t num_pairs = num_nodes == 0 ? 0 : offsets[num_nodes - 1];
+
+  katana::ArrowRandomAccessBuilder<arrow::UInt32Type> srcs(num_pairs);
+  katana::ArrowRandomAccessBuilder<arrow::UInt32Type> dsts(num_pairs);
+  katana::ArrowRandomAccessBuilder<arrow::DoubleType> similarities(num_pairs);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t out = n == 0 ? 0 : offsets[n - 1];
+        const Pair* pairs = found.getRemote(threads[n])->data() + begins[n];
+        for (uint64_t i = 0; out + i < offsets[n]; ++i) {
+          srcs[out + i] = n;
+          dsts[out + i] = pairs[i].second;
+          similarities[out + i] = pairs[i].first;
+        }
+      },
+      katana::no_stats());
+
+  std::shared_ptr<arrow::Array> src_array = KATANA_CHECKED(srcs.Finalize());
+  std::shared_ptr<arrow::Array> dst_array = KATANA_CHECKED(dsts.Finalize());
+  std::shared_ptr<arrow::Array> similarity_array =
+      KATANA_CHECKED(similarities.Finalize());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("src", arrow::uint32()),
+           arrow::field("dst", arrow::uint32()),
+           arrow::field("similarity", arrow::float64())}),
+      {src_array, dst_array, similarity_array});
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -165,6 +385,57 @@ katana::analytics::Jaccard(
   return r;
 }
 
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::JaccardTopK(
+    PropertyGraph* pg, uint32_t k, JaccardTopKPlan::Measure measure,
+    JaccardTopKPlan plan) {
+  if (k == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "k must be positive");
+  }
+
+  katana::StatTimer exec_time("JaccardTopK");
+  exec_time.start();
+
+  auto view = pg->BuildView<SortedView>();
+  std::shared_ptr<arrow::Table> table;
+  switch (plan.algorithm()) {
+  case JaccardTopKPlan::kMinHash: {
+    if (plan.num_bands() == 0 || plan.rows_per_band() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "MinHash needs at least one band of at least one row");
+    }
+    MinHashBands bands(view, plan);
+    table = KATANA_CHECKED(
+        TopKImpl(view, k, measure, [&](GNode n, const auto& fn) {
+          bands.ForEachCandidate(n, fn);
+        }));
+    break;
+  }
+  case JaccardTopKPlan::kExact: {
+    // Nodes that share a neighbor are the sources of the in-edges of the
+    // neighbors
+    auto bidir = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    table = KATANA_CHECKED(
+        TopKImpl(view, k, measure, [&](GNode n, const auto& fn) {
+          for (GNode neighbor : view.OutEdgeDsts(n)) {
+            for (auto e : bidir.InEdges(neighbor)) {
+              fn(bidir.InEdgeSrc(e));
+            }
+          }
+        }));
+    break;
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  exec_time.stop();
+  return table;
+}
+
 constexpr static const double EPSILON = 1e-6;
 
 katana::Result<void>
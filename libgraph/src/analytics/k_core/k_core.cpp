@@ -19,9 +19,15 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <atomic>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/IterationMetrics.h"
 
 using namespace katana::analytics;
 
@@ -36,6 +42,8 @@ struct KCoreNodeCurrentDegree : public katana::AtomicPODProperty<uint32_t> {};
 
 struct KCoreNodeAlive : public katana::PODProperty<uint32_t> {};
 
+struct KCoreNodeCoreness : public katana::PODProperty<uint32_t> {};
+
 using NodeData = std::tuple<KCoreNodeCurrentDegree>;
 using EdgeData = std::tuple<>;
 
@@ -104,16 +112,27 @@ SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
   //! Setup worklist.
   SetupInitialWorklist(*graph, *next, k_core_number);
 
+  // the convergence is the number of nodes that dropped out of the core
+  katana::analytics::IterationReporter reporter("k_core_synchronous");
+  katana::GAccumulator<uint64_t> dead_nodes;
+  katana::GAccumulator<uint64_t> edges_visited;
+  uint32_t round = 0;
+
   while (!next->empty()) {
     //! Make "next" into current.
     std::swap(current, next);
     next->clear();
+    dead_nodes.reset();
+    edges_visited.reset();
 
     katana::do_all(
         katana::iterate(*current),
         [&](const GNode& dead_node) {
+          dead_nodes += 1;
+          uint64_t degree = 0;
           //! Decrement degree of all neighbors.
           for (auto e : Edges(*graph, dead_node)) {
+            ++degree;
             auto dest = EdgeDst(*graph, e);
             auto& dest_current_degree =
                 graph->template GetData<KCoreNodeCurrentDegree>(dest);
@@ -125,9 +144,15 @@ SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
               next->emplace(dest);
             }
           }
+          edges_visited += degree;
         },
         katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
         katana::loopname("KCore Synchronous"));
+
+    round += 1;
+    reporter.Report(
+        round, dead_nodes.reduce(), dead_nodes.reduce(),
+        edges_visited.reduce());
   }
 }
 
@@ -169,6 +194,150 @@ AsyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
       katana::loopname("KCore Asynchronous"));
 }
 
+/// Degrees for which BucketedPeelKCore keeps buckets at a time; nodes of
+/// higher degree wait outside of the buckets until these are used up.
+constexpr static const uint32_t kNumOpenBuckets = 128;
+
+/**
+ * Peel nodes in increasing order of current degree, which leaves the
+ * coreness of every node in its degree field.
+ *
+ * Nodes are kept in buckets by degree for the kNumOpenBuckets degrees
+ * starting at base, and buckets are updated lazily: decrements are batched
+ * for each round and a node whose degree dropped is added once to the
+ * bucket of its new degree after the round, staying in its old bucket where
+ * it is skipped. Degrees do not drop below the k being peeled, so a node is
+ * peeled at its coreness, and when the open buckets run out they are
+ * reopened from the smallest degree left.
+ *
+ * @param graph Graph to operate on
+ * @returns the degeneracy of the graph, the largest coreness
+ */
+template <typename GraphTy>
+uint32_t
+BucketedPeelKCore(GraphTy* graph) {
+  using GNode = typename GraphTy::Node;
+  size_t num_nodes = graph->NumNodes();
+
+  katana::NUMAArray<uint8_t> peeled;
+  katana::NUMAArray<std::atomic<uint8_t>> moved;
+  peeled.allocateBlocked(num_nodes);
+  moved.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t i) {
+        peeled[i] = 0;
+        moved[i].store(0, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  auto degree = [&](const GNode& node) -> auto& {
+    return graph->template GetData<KCoreNodeCurrentDegree>(node);
+  };
+
+  std::vector<katana::InsertBag<GNode>> buckets(kNumOpenBuckets);
+  uint32_t base = 0;
+  auto open_buckets = [&]() {
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          uint32_t d = degree(node).load(std::memory_order_relaxed);
+          if (!peeled[node] && d - base < kNumOpenBuckets) {
+            buckets[d - base].emplace(node);
+          }
+        },
+        katana::no_stats());
+  };
+  open_buckets();
+
+  katana::InsertBag<GNode> frontier;
+  katana::InsertBag<GNode> touched;
+  katana::GAccumulator<uint64_t> num_peeled;
+  uint64_t remaining = num_nodes;
+  uint32_t degeneracy = 0;
+  uint32_t k = base;
+  while (remaining > 0) {
+    if (k - base == kNumOpenBuckets) {
+      katana::GReduceMin<uint32_t> min_degree;
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](const GNode& node) {
+            if (!peeled[node]) {
+              min_degree.update(degree(node).load(std::memory_order_relaxed));
+            }
+          },
+          katana::no_stats());
+      base = min_degree.reduce();
+      k = base;
+      open_buckets();
+    }
+
+    katana::InsertBag<GNode>& bucket = buckets[k - base];
+    if (bucket.empty()) {
+      ++k;
+      continue;
+    }
+
+    // nodes whose degree dropped below k since they were added are in
+    // another bucket as well
+    num_peeled.reset();
+    katana::do_all(
+        katana::iterate(bucket),
+        [&](const GNode& node) {
+          if (!peeled[node] &&
+              degree(node).load(std::memory_order_relaxed) == k) {
+            peeled[node] = 1;
+            frontier.emplace(node);
+            num_peeled += 1;
+          }
+        },
+        katana::no_stats());
+    bucket.clear();
+
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](const GNode& dead_node) {
+          for (auto e : Edges(*graph, dead_node)) {
+            auto dest = EdgeDst(*graph, e);
+            if (peeled[dest]) {
+              continue;
+            }
+            auto& dest_current_degree = degree(dest);
+            uint32_t old_degree =
+                dest_current_degree.load(std::memory_order_relaxed);
+            while (old_degree > k &&
+                   !dest_current_degree.compare_exchange_weak(
+                       old_degree, old_degree - 1, std::memory_order_relaxed)) {
+            }
+            if (old_degree > k &&
+                !moved[dest].exchange(1, std::memory_order_relaxed)) {
+              touched.emplace(dest);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
+        katana::loopname("KCore Bucketed"));
+    frontier.clear();
+
+    katana::do_all(
+        katana::iterate(touched),
+        [&](const GNode& node) {
+          moved[node].store(0, std::memory_order_relaxed);
+          uint32_t d = degree(node).load(std::memory_order_relaxed);
+          if (d - base < kNumOpenBuckets) {
+            buckets[d - base].emplace(node);
+          }
+        },
+        katana::no_stats());
+    touched.clear();
+
+    remaining -= num_peeled.reduce();
+    degeneracy = k;
+  }
+
+  return degeneracy;
+}
+
 /**
  * After computation is finished, the nodes left in the core
  * are marked as alive.
@@ -217,6 +386,11 @@ KCoreImpl(GraphTy* graph, KCorePlan algo, uint32_t k_core_number) {
   case KCorePlan::kAsynchronous:
     AsyncCascadeKCore(graph, k_core_number);
     break;
+  case KCorePlan::kBucketed:
+    // degrees end up as corenesses, which KCoreMarkAliveNodes compares to k
+    // like the degrees left by the other algorithms
+    katana::ReportStatSingle("KCore", "Degeneracy", BucketedPeelKCore(graph));
+    break;
   default:
     return katana::ErrorCode::AssertionFailed;
   }
@@ -265,6 +439,28 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+katana::Result<void>
+katana::analytics::KCoreDecomposition(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric) {
+  // the degrees peeled in place are the output
+  KATANA_CHECKED(pg->ConstructNodeProperties<NodeData>(
+      txn_ctx, {output_property_name}));
+
+  if (is_symmetric) {
+    using Graph = katana::TypedPropertyGraphView<
+        katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+    Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+    return KCoreImpl(&graph, KCorePlan::Bucketed(), 0);
+  }
+  using Graph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Undirected, NodeData, EdgeData>;
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  return KCoreImpl(&graph, KCorePlan::Bucketed(), 0);
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -306,6 +502,36 @@ katana::analytics::KCoreStatistics::Compute(
 
   return KCoreStatistics{alive_nodes.reduce()};
 }
+
+katana::Result<KCoreDecompositionStatistics>
+katana::analytics::KCoreDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<KCoreNodeCoreness>, std::tuple<>>;
+  using GNode = Graph::Node;
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::GReduceMax<uint32_t> max_coreness;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        max_coreness.update(graph.GetData<KCoreNodeCoreness>(node));
+      },
+      katana::loopname("KCore max coreness"), katana::no_stats());
+  uint32_t degeneracy = max_coreness.reduce();
+
+  katana::GAccumulator<uint64_t> max_core_nodes;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        if (graph.GetData<KCoreNodeCoreness>(node) == degeneracy) {
+          max_core_nodes += 1;
+        }
+      },
+      katana::loopname("KCore max core size"), katana::no_stats());
+
+  return KCoreDecompositionStatistics{degeneracy, max_core_nodes.reduce()};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
@@ -313,3 +539,10 @@ katana::analytics::KCoreStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_nodes_in_kcore
      << std::endl;
 }
+
+void
+katana::analytics::KCoreDecompositionStatistics::Print(std::ostream& os) const {
+  os << "Degeneracy = " << degeneracy << std::endl;
+  os << "Number of nodes in the max core = " << number_of_nodes_in_max_core
+     << std::endl;
+}
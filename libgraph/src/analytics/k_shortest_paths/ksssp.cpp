@@ -19,7 +19,17 @@
 
 #include "katana/analytics/k_shortest_paths/ksssp.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
@@ -280,6 +290,274 @@ DeltaStepAlgo(
   }
 }
 
+/// A loopless path from the source to the report node
+template <typename GraphTy, typename Weight>
+struct SimplePath {
+  using GNode = typename GraphTy::Node;
+  using Edge = typename GraphTy::Edge;
+
+  Weight cost;
+  std::vector<GNode> nodes;
+  std::vector<Edge> edges;
+
+  bool operator<(const SimplePath& other) const {
+    return std::tie(cost, edges) < std::tie(other.cost, other.edges);
+  }
+};
+
+/**
+ * Dijkstra state of one thread for the spur searches of Yen's algorithm,
+ * kept across searches so that each search reuses the same distance arrays.
+ * An entry of dist, pred and pred_edge is only valid if its stamp is the
+ * epoch of the current search, so a search never clears the arrays.
+ */
+template <typename GraphTy, typename Weight>
+class SpurSearch {
+public:
+  using GNode = typename GraphTy::Node;
+  using Edge = typename GraphTy::Edge;
+
+  /**
+   * Finds the shortest path from spur to report that avoids blocked nodes
+   * and removed edges
+   *
+   * @param graph typed graph
+   * @param spur Node to start the search from
+   * @param report Final node to look for
+   * @param blocked Nodes the path may not visit
+   * @param num_blocked Number of blocked nodes
+   * @param removed Edges the path may not use
+   * @param root_cost Cost of the path that reaches spur
+   * @param bound Give up once root_cost plus the distance reaches bound
+   * @param path Receives the path from spur to report
+   * @return whether a path was found
+   */
+  bool Run(
+      GraphTy* graph, GNode spur, GNode report, const GNode* blocked,
+      size_t num_blocked, const std::vector<Edge>& removed, Weight root_cost,
+      const std::atomic<Weight>& bound, SimplePath<GraphTy, Weight>* path) {
+    Reset(graph->size());
+
+    // Blocked nodes look settled at distance 0, so no non-negative edge
+    // weight relaxes them
+    for (size_t i = 0; i < num_blocked; ++i) {
+      Visit(blocked[i], 0, spur, Edge{});
+    }
+    Visit(spur, 0, spur, Edge{});
+    heap_.emplace_back(0, spur);
+
+    while (!heap_.empty()) {
+      std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+      auto [dist, node] = heap_.back();
+      heap_.pop_back();
+      if (dist > dist_[node]) {
+        continue;
+      }
+      if (root_cost + dist >= bound.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      if (node == report) {
+        Reconstruct(spur, report, path);
+        path->cost = dist;
+        return true;
+      }
+
+      for (auto edge : Edges(*graph, node)) {
+        if (std::find(removed.begin(), removed.end(), edge) != removed.end()) {
+          continue;
+        }
+        GNode dst = EdgeDst(*graph, edge);
+        const Weight new_dist =
+            dist + graph->template GetEdgeData<EdgeWeight<Weight>>(edge);
+        if (stamp_[dst] != epoch_ || new_dist < dist_[dst]) {
+          Visit(dst, new_dist, node, edge);
+          heap_.emplace_back(new_dist, dst);
+          std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+        }
+      }
+    }
+    return false;
+  }
+
+private:
+  void Reset(size_t num_nodes) {
+    if (stamp_.size() != num_nodes) {
+      dist_.resize(num_nodes);
+      pred_.resize(num_nodes);
+      pred_edge_.resize(num_nodes);
+      stamp_.assign(num_nodes, 0);
+      epoch_ = 0;
+    }
+    if (++epoch_ == 0) {
+      std::fill(stamp_.begin(), stamp_.end(), 0);
+      epoch_ = 1;
+    }
+    heap_.clear();
+  }
+
+  void Visit(GNode node, Weight dist, GNode pred, Edge pred_edge) {
+    stamp_[node] = epoch_;
+    dist_[node] = dist;
+    pred_[node] = pred;
+    pred_edge_[node] = pred_edge;
+  }
+
+  void Reconstruct(
+      GNode spur, GNode report, SimplePath<GraphTy, Weight>* path) const {
+    path->nodes.clear();
+    path->edges.clear();
+    for (GNode node = report; node != spur; node = pred_[node]) {
+      path->nodes.emplace_back(node);
+      path->edges.emplace_back(pred_edge_[node]);
+    }
+    path->nodes.emplace_back(spur);
+    std::reverse(path->nodes.begin(), path->nodes.end());
+    std::reverse(path->edges.begin(), path->edges.end());
+  }
+
+  std::vector<Weight> dist_;
+  std::vector<GNode> pred_;
+  std::vector<Edge> pred_edge_;
+  std::vector<uint32_t> stamp_;
+  uint32_t epoch_{0};
+  std::vector<std::pair<Weight, GNode>> heap_;
+};
+
+/**
+ * Finds the k shortest loopless paths from source to report with Yen's
+ * algorithm. The spur searches of an iteration run in parallel.
+ *
+ * Only the best num_paths minus the number of found paths candidates can
+ * still be chosen, so the candidates are trimmed to that many and the cost
+ * of the worst one bounds every spur search, which stops as soon as its
+ * path cannot beat it. Threads tighten the bound as they add candidates.
+ *
+ * @param graph typed graph
+ * @param source Beginning node in graph
+ * @param report Final node to look for
+ * @param report_paths_bag Total paths (and weights) from source to report
+ * @param path_pointers Pointers for each path
+ * @param path_alloc Allocates paths in graph
+ * @param num_paths Number of paths to look for
+ */
+template <typename GraphTy, typename Weight>
+void
+YenAlgo(
+    GraphTy* graph, const typename GraphTy::Node& source,
+    const typename GraphTy::Node& report,
+    katana::InsertBag<std::pair<Weight, Path*>>* report_paths_bag,
+    katana::InsertBag<Path*>* path_pointers, PathAlloc& path_alloc,
+    size_t num_paths) {
+  using GNode = typename GraphTy::Node;
+  using Edge = typename GraphTy::Edge;
+  using YenPath = SimplePath<GraphTy, Weight>;
+
+  constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+  katana::PerThreadStorage<SpurSearch<GraphTy, Weight>> searches;
+  std::atomic<Weight> bound{kInfinity};
+
+  std::vector<YenPath> found;
+  YenPath first;
+  if (num_paths == 0 || !searches.getLocal()->Run(
+                            graph, source, report, nullptr, 0, {}, 0, bound,
+                            &first)) {
+    return;
+  }
+  found.emplace_back(std::move(first));
+
+  std::set<YenPath> candidates;
+  std::mutex candidates_mutex;
+
+  while (found.size() < num_paths) {
+    const YenPath& last = found.back();
+    const size_t remaining = num_paths - found.size();
+    bound.store(
+        candidates.size() >= remaining ? candidates.rbegin()->cost
+                                       : kInfinity);
+
+    std::vector<Weight> root_costs(last.nodes.size());
+    root_costs[0] = 0;
+    for (size_t i = 0; i < last.edges.size(); ++i) {
+      root_costs[i + 1] = root_costs[i] +
+                          graph->template GetEdgeData<EdgeWeight<Weight>>(
+                              last.edges[i]);
+    }
+
+    katana::do_all(
+        katana::iterate(size_t{0}, last.edges.size()),
+        [&](size_t spur_index) {
+          // Found paths that share the root leave the spur node along edges
+          // the spur path may not take again
+          std::vector<Edge> removed;
+          for (const YenPath& path : found) {
+            if (path.edges.size() > spur_index &&
+                std::equal(
+                    last.edges.begin(), last.edges.begin() + spur_index,
+                    path.edges.begin())) {
+              removed.emplace_back(path.edges[spur_index]);
+            }
+          }
+
+          YenPath spur_path;
+          if (!searches.getLocal()->Run(
+                  graph, last.nodes[spur_index], report, last.nodes.data(),
+                  spur_index, removed, root_costs[spur_index], bound,
+                  &spur_path)) {
+            return;
+          }
+
+          YenPath candidate;
+          candidate.cost = root_costs[spur_index] + spur_path.cost;
+          candidate.nodes.assign(
+              last.nodes.begin(), last.nodes.begin() + spur_index);
+          candidate.nodes.insert(
+              candidate.nodes.end(), spur_path.nodes.begin(),
+              spur_path.nodes.end());
+          candidate.edges.assign(
+              last.edges.begin(), last.edges.begin() + spur_index);
+          candidate.edges.insert(
+              candidate.edges.end(), spur_path.edges.begin(),
+              spur_path.edges.end());
+
+          std::lock_guard<std::mutex> lock(candidates_mutex);
+          if (candidate.cost >= bound.load(std::memory_order_relaxed) ||
+              !candidates.insert(std::move(candidate)).second) {
+            return;
+          }
+          if (candidates.size() > remaining) {
+            candidates.erase(std::prev(candidates.end()));
+          }
+          if (candidates.size() == remaining) {
+            bound.store(candidates.rbegin()->cost, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::loopname("YenSpurPaths"));
+
+    if (candidates.empty()) {
+      break;
+    }
+    found.emplace_back(
+        std::move(candidates.extract(candidates.begin()).value()));
+  }
+
+  // Store the paths as the other algorithms do: a chain of parents that ends
+  // just before report
+  for (const YenPath& path : found) {
+    Path* last = nullptr;
+    for (size_t i = 0; i + 1 < path.nodes.size(); ++i) {
+      Path* step = path_alloc.NewPath();
+      step->parent = path.nodes[i];
+      step->last = last;
+      path_pointers->push(step);
+      last = step;
+    }
+    if (last != nullptr) {
+      report_paths_bag->push(std::make_pair(path.cost, last));
+    }
+  }
+}
+
 /**
  * Prints all paths recursively
  *
@@ -389,6 +667,11 @@ KssspImpl(
           kSSSPOutEdgeRangeFn{&graph}, &paths, &path_pointers, path_alloc,
           num_paths, plan.delta());
       break;
+    case KssspPlan::kYen:
+      YenAlgo<GraphTy, Weight>(
+          &graph, source, report, &paths, &path_pointers, path_alloc,
+          num_paths);
+      break;
 
     default:
       return katana::ErrorCode::InvalidArgument;
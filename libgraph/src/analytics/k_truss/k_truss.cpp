@@ -19,8 +19,16 @@
 
 #include "katana/analytics/k_truss/k_truss.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/SetIntersection.h"
 
 using namespace katana::analytics;
 
@@ -35,6 +43,11 @@ using GNode = typename Graph::Node;
 using SortedGraphView = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::EdgesSortedByDestID, NodeData, EdgeData>;
 
+struct EdgeTrussness : public katana::PODProperty<uint32_t> {};
+using TrussnessGraphView = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::EdgesSortedByDestID, NodeData,
+    std::tuple<EdgeTrussness>>;
+
 using Edge = std::pair<GNode, GNode>;
 using EdgeVec = katana::InsertBag<Edge>;
 using NodeVec = katana::InsertBag<GNode>;
@@ -95,38 +108,22 @@ IsValidDegreeNoLessThanJ(const SortedGraphView& g, GNode n, unsigned int j) {
 bool
 IsSupportNoLessThanJ(
     const SortedGraphView& g, GNode src, GNode dest, unsigned int j) {
-  size_t numValidEqual = 0;
-  auto srcI = g.OutEdges(src).begin(), srcE = g.OutEdges(src).end(),
-       dstI = g.OutEdges(dest).begin(), dstE = g.OutEdges(dest).end();
-
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.GetEdgeData<EdgeFlag>(*srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.GetEdgeData<EdgeFlag>(*dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
-
-    //! Check for intersection.
-    auto sN = g.OutEdgeDst(*srcI), dN = g.OutEdgeDst(*dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
-    }
+  if (j == 0) {
+    return true;
   }
+  size_t numValidEqual = 0;
+  auto srcBegin = *g.OutEdges(src).begin();
+  auto dstBegin = *g.OutEdges(dest).begin();
+
+  ForEachIntersection(
+      g.OutEdgeDsts(src), g.OutEdgeDsts(dest), [&](size_t srcI, size_t dstI) {
+        //! Only count common neighbors reached by valid edges.
+        if (!(g.GetEdgeData<EdgeFlag>(srcBegin + srcI) & removed) &&
+            !(g.GetEdgeData<EdgeFlag>(dstBegin + dstI) & removed)) {
+          numValidEqual += 1;
+        }
+        return numValidEqual < j;
+      });
 
   return numValidEqual >= j;
 }
@@ -344,6 +341,271 @@ BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
   return katana::ResultSuccess();
 }
 
+/// Supports for which TrussDecomposition keeps buckets at a time; edges of
+/// higher support wait outside of the buckets until these are used up.
+constexpr static const uint32_t kNumOpenBuckets = 128;
+
+/**
+ * Compute the trussness of every edge by peeling edges in increasing order
+ * of support, the number of triangles they are in. Each undirected edge is
+ * represented by its direction from the smaller node to the larger.
+ *
+ * Initial supports are intersections of sorted neighbor lists. After that,
+ * supports are only decremented: removing an edge removes its triangles
+ * that are still whole, which lowers the support of their two other edges.
+ * When two edges of a triangle are removed in the same round, only the one
+ * with the smaller id updates the third. Supports do not drop below the
+ * support k being peeled, so an edge is removed with support k and has
+ * trussness k + 2. Edges are kept in lazily updated buckets by support as
+ * in BucketedPeelKCore of k-core.
+ *
+ * @param g Graph to operate on
+ * @param trussness Trussness of every edge of g, indexed like its edges
+ * @returns the largest trussness
+ */
+template <typename GraphTy>
+uint32_t
+TrussDecomposition(const GraphTy& g, katana::NUMAArray<uint32_t>* trussness) {
+  using Node = typename GraphTy::Node;
+  constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+  // edges that are not the representative of an undirected edge, or that
+  // have been removed in an earlier round, are kPeeled
+  enum State : uint8_t { kAlive, kFrontier, kPeeled };
+
+  size_t num_edges = g.NumEdges();
+  katana::NUMAArray<Node> src;
+  katana::NUMAArray<uint64_t> canonical;
+  katana::NUMAArray<std::atomic<uint32_t>> support;
+  katana::NUMAArray<uint8_t> state;
+  katana::NUMAArray<std::atomic<uint8_t>> moved;
+  src.allocateBlocked(num_edges);
+  canonical.allocateBlocked(num_edges);
+  support.allocateBlocked(num_edges);
+  state.allocateBlocked(num_edges);
+  moved.allocateBlocked(num_edges);
+  trussness->allocateBlocked(num_edges);
+
+  katana::do_all(
+      katana::iterate(g),
+      [&](Node n) {
+        uint64_t begin = *g.OutEdges(n).begin();
+        auto dsts = g.OutEdgeDsts(n);
+        for (const Node* d = dsts.begin(); d != dsts.end(); ++d) {
+          uint64_t e = begin + (d - dsts.begin());
+          src[e] = n;
+          moved[e].store(0, std::memory_order_relaxed);
+          support[e].store(0, std::memory_order_relaxed);
+          state[e] = kPeeled;
+          (*trussness)[e] = 0;
+          if (*d == n) {
+            canonical[e] = kNoEdge;
+          } else if (n < *d) {
+            canonical[e] = e;
+          } else {
+            auto back = g.OutEdgeDsts(*d);
+            const Node* it = std::lower_bound(back.begin(), back.end(), n);
+            KATANA_LOG_DEBUG_ASSERT(it != back.end() && *it == n);
+            canonical[e] = *g.OutEdges(*d).begin() + (it - back.begin());
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(g),
+      [&](Node n) {
+        uint64_t begin = *g.OutEdges(n).begin();
+        auto dsts = g.OutEdgeDsts(n);
+        for (const Node* d = dsts.begin(); d != dsts.end(); ++d) {
+          if (n < *d) {
+            uint64_t e = begin + (d - dsts.begin());
+            auto d_dsts = g.OutEdgeDsts(*d);
+            // a self loop at either end makes that end a common neighbor
+            size_t loops =
+                std::binary_search(dsts.begin(), dsts.end(), n) +
+                std::binary_search(d_dsts.begin(), d_dsts.end(), *d);
+            support[e].store(
+                CountIntersection(dsts, d_dsts) - loops,
+                std::memory_order_relaxed);
+            state[e] = kAlive;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("KTruss Initial Support"));
+
+  std::vector<katana::InsertBag<uint64_t>> buckets(kNumOpenBuckets);
+  uint32_t base = 0;
+  auto open_buckets = [&]() {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_edges),
+        [&](size_t e) {
+          uint32_t s = support[e].load(std::memory_order_relaxed);
+          if (state[e] == kAlive && s - base < kNumOpenBuckets) {
+            buckets[s - base].emplace(e);
+          }
+        },
+        katana::no_stats());
+  };
+  open_buckets();
+
+  katana::GAccumulator<uint64_t> num_alive_accum;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) { num_alive_accum += state[e] == kAlive; },
+      katana::no_stats());
+  uint64_t remaining = num_alive_accum.reduce();
+
+  katana::InsertBag<uint64_t> frontier;
+  katana::InsertBag<uint64_t> touched;
+  katana::GAccumulator<uint64_t> num_peeled;
+  uint32_t max_trussness = 0;
+  uint32_t k = base;
+
+  auto decrement = [&](uint64_t e) {
+    uint32_t old_support = support[e].load(std::memory_order_relaxed);
+    while (old_support > k &&
+           !support[e].compare_exchange_weak(
+               old_support, old_support - 1, std::memory_order_relaxed)) {
+    }
+    if (old_support > k && !moved[e].exchange(1, std::memory_order_relaxed)) {
+      touched.emplace(e);
+    }
+  };
+
+  while (remaining > 0) {
+    if (k - base == kNumOpenBuckets) {
+      katana::GReduceMin<uint32_t> min_support;
+      katana::do_all(
+          katana::iterate(size_t{0}, num_edges),
+          [&](size_t e) {
+            if (state[e] == kAlive) {
+              min_support.update(support[e].load(std::memory_order_relaxed));
+            }
+          },
+          katana::no_stats());
+      base = min_support.reduce();
+      k = base;
+      open_buckets();
+    }
+
+    katana::InsertBag<uint64_t>& bucket = buckets[k - base];
+    if (bucket.empty()) {
+      ++k;
+      continue;
+    }
+
+    num_peeled.reset();
+    katana::do_all(
+        katana::iterate(bucket),
+        [&](uint64_t e) {
+          if (state[e] == kAlive &&
+              support[e].load(std::memory_order_relaxed) == k) {
+            state[e] = kFrontier;
+            frontier.emplace(e);
+            num_peeled += 1;
+          }
+        },
+        katana::no_stats());
+    bucket.clear();
+
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](uint64_t e) {
+          Node u = src[e];
+          Node v = g.OutEdgeDst(e);
+          uint64_t u_begin = *g.OutEdges(u).begin();
+          uint64_t v_begin = *g.OutEdges(v).begin();
+          ForEachIntersection(
+              g.OutEdgeDsts(u), g.OutEdgeDsts(v), [&](size_t i, size_t j) {
+                uint64_t f = canonical[u_begin + i];
+                uint64_t h = canonical[v_begin + j];
+                if (f == kNoEdge || h == kNoEdge || state[f] == kPeeled ||
+                    state[h] == kPeeled) {
+                  return;
+                }
+                if (state[f] == kFrontier && state[h] == kFrontier) {
+                  return;
+                }
+                if (state[f] == kFrontier) {
+                  if (e < f) {
+                    decrement(h);
+                  }
+                } else if (state[h] == kFrontier) {
+                  if (e < h) {
+                    decrement(f);
+                  }
+                } else {
+                  decrement(f);
+                  decrement(h);
+                }
+              });
+        },
+        katana::steal(), katana::chunk_size<64>(),
+        katana::loopname("KTruss Bucketed"));
+
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](uint64_t e) {
+          state[e] = kPeeled;
+          (*trussness)[e] = k + 2;
+        },
+        katana::no_stats());
+    frontier.clear();
+
+    katana::do_all(
+        katana::iterate(touched),
+        [&](uint64_t e) {
+          moved[e].store(0, std::memory_order_relaxed);
+          uint32_t s = support[e].load(std::memory_order_relaxed);
+          if (s - base < kNumOpenBuckets) {
+            buckets[s - base].emplace(e);
+          }
+        },
+        katana::no_stats());
+    touched.clear();
+
+    remaining -= num_peeled.reduce();
+    max_trussness = k + 2;
+  }
+
+  // the other direction of each edge takes the trussness of its
+  // representative
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        uint64_t c = canonical[e];
+        if (c != kNoEdge && c != e) {
+          (*trussness)[e] = (*trussness)[c];
+        }
+      },
+      katana::no_stats());
+
+  return max_trussness;
+}
+
+/// BucketedTrussAlgo:
+/// 1. Compute the trussness of every edge.
+/// 2. Remove the edges of trussness less than k.
+katana::Result<void>
+BucketedTrussAlgo(SortedGraphView* g, uint32_t k) {
+  if (k <= 2) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  katana::NUMAArray<uint32_t> trussness;
+  TrussDecomposition(*g, &trussness);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, g->NumEdges()),
+      [&](size_t e) {
+        if (trussness[e] < k) {
+          g->template GetEdgeData<EdgeFlag>(e) = removed;
+        }
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::KTruss(
     katana::TxnContext* txn_ctx, katana::PropertyGraph* pg,
@@ -369,11 +631,41 @@ katana::analytics::KTruss(
     return BSPTrussJacobiAlgo(&graph, k_truss_number);
   case KTrussPlan::kBspCoreThenTruss:
     return BSPCoreThenTrussAlgo(&graph, k_truss_number);
+  case KTrussPlan::kBucketed:
+    return BucketedTrussAlgo(&graph, k_truss_number);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<void>
+katana::analytics::KTrussDecomposition(
+    katana::TxnContext* txn_ctx, katana::PropertyGraph* pg,
+    const std::string& output_property_name) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<EdgeTrussness>>(
+      txn_ctx, {output_property_name}));
+
+  auto graph =
+      KATANA_CHECKED(TrussnessGraphView::Make(pg, {}, {output_property_name}));
+
+  katana::StatTimer exec_time("KTruss");
+  exec_time.start();
+
+  katana::NUMAArray<uint32_t> trussness;
+  uint32_t max_trussness = TrussDecomposition(graph, &trussness);
+  katana::ReportStatSingle("KTruss", "MaxTrussness", max_trussness);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, graph.NumEdges()),
+      [&](size_t e) { graph.GetEdgeData<EdgeTrussness>(e) = trussness[e]; },
+      katana::no_stats());
+
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -410,9 +702,51 @@ katana::analytics::KTrussStatistics::Compute(
 
   return KTrussStatistics{alive_edges.reduce()};
 }
+
+katana::Result<KTrussDecompositionStatistics>
+katana::analytics::KTrussDecompositionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using TrussnessGraph =
+      katana::TypedPropertyGraph<NodeData, std::tuple<EdgeTrussness>>;
+  auto graph = KATANA_CHECKED(TrussnessGraph::Make(pg, {}, {property_name}));
+
+  katana::GReduceMax<uint32_t> max_trussness;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.OutEdges(node)) {
+          max_trussness.update(graph.GetEdgeData<EdgeTrussness>(e));
+        }
+      },
+      katana::loopname("KTruss max trussness"), katana::no_stats());
+  uint32_t max = max_trussness.reduce();
+
+  katana::GAccumulator<uint64_t> max_truss_edges;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        for (auto e : graph.OutEdges(node)) {
+          if (node < graph.OutEdgeDst(e) &&
+              graph.GetEdgeData<EdgeTrussness>(e) == max) {
+            max_truss_edges += 1;
+          }
+        }
+      },
+      katana::loopname("KTruss max truss size"), katana::no_stats());
+
+  return KTrussDecompositionStatistics{max, max_truss_edges.reduce()};
+}
 /// \endcond DO_NOT_DOCUMENT
 
 void
 katana::analytics::KTrussStatistics::Print(std::ostream& os) const {
   os << "Number of nodes in the core = " << number_of_edges_left << std::endl;
 }
+
+void
+katana::analytics::KTrussDecompositionStatistics::Print(
+    std::ostream& os) const {
+  os << "Max trussness = " << max_trussness << std::endl;
+  os << "Number of edges in the max truss = " << number_of_edges_in_max_truss
+     << std::endl;
+}
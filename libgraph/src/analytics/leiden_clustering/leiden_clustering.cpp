@@ -24,6 +24,7 @@
 
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
+#include "katana/analytics/IterationMetrics.h"
 
 using namespace katana::analytics;
 namespace {
@@ -98,6 +99,9 @@ struct LeidenClusteringImplementation
             c_info[n_data_curr_comm_id].degree_wt, n_data_degree_wt);
       });
     }
+    // reused from node to node by each thread
+    katana::PerThreadStorage<ClusterWeightMap<EdgeWeightType>> cluster_weights;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -114,19 +118,14 @@ struct LeidenClusteringImplementation
 
             uint64_t degree = Degree(*graph, n);
             uint64_t local_target = Base::UNASSIGNED;
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  *graph, n, cluster_local_map, counter, self_loop_wt);
+                  *graph, n, cluster_weights.getLocal(), self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
+                  *cluster_weights.getLocal(), self_loop_wt, c_info,
                   n_data_node_wt, n_data_curr_comm_id,
                   constant_for_second_term);
             } else {
@@ -255,6 +254,9 @@ struct LeidenClusteringImplementation
       c_update_subtract[n].node_wt = 0;
     });
 
+    // reused from node to node by each thread
+    katana::PerThreadStorage<ClusterWeightMap<EdgeWeightType>> cluster_weights;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
 
@@ -275,19 +277,14 @@ struct LeidenClusteringImplementation
 
               uint64_t degree = Degree(*graph, n);
 
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
                 Base::template FindNeighboringClusters<EdgeWeightType>(
-                    *graph, n, cluster_local_map, counter, self_loop_wt);
+                    *graph, n, cluster_weights.getLocal(), self_loop_wt);
                 // Find the max gain in modularity
                 local_target[n] = Base::MaxModularityWithoutSwaps(
-                    cluster_local_map, counter, self_loop_wt, c_info,
+                    *cluster_weights.getLocal(), self_loop_wt, c_info,
                     n_data_degree_wt, n_data_curr_comm_id,
                     constant_for_second_term);
 
@@ -388,7 +385,9 @@ public:
       katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
       const std::vector<std::string>& temp_node_property_names,
       katana::NUMAArray<uint64_t>& clusters_orig, LeidenClusteringPlan plan,
-      katana::TxnContext* txn_ctx) {
+      katana::TxnContext* txn_ctx, const CommunitySeed* seed,
+      const katana::NUMAArray<uint64_t>& seed_labels,
+      Checkpointer* checkpointer, uint32_t first_iteration) {
     katana::StatTimer TimerTotal("Timer_Leiden_Total");
     TimerTotal.start();
     TemporaryPropertyGuard temp_edge_property{pg->EdgeMutablePropertyView()};
@@ -405,14 +404,22 @@ public:
         Graph::Make(pg, temp_node_property_names, {edge_weight_property_name}));
 
     /*
-    * Vertex following optimization
+    * Vertex following optimization, or start from the seed clusters
     */
-    if (plan.enable_vf()) {
-      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
-
-      uint64_t num_unique_clusters =
-          Base::template RenumberClustersContiguously<CurrentCommunityID>(
-              &graph_curr);
+    const bool coarsen_first = seed || plan.enable_vf();
+    if (coarsen_first) {
+      uint64_t num_unique_clusters = 0;
+      if (seed) {
+        num_unique_clusters =
+            Base::template SeedClusters<CurrentCommunityID>(
+                &graph_curr, seed_labels, seed->changed_nodes);
+      } else {
+        Base::VertexFollowing(
+            &graph_curr);  // Find nodes that follow other nodes
+        num_unique_clusters =
+            Base::template RenumberClustersContiguously<CurrentCommunityID>(
+                &graph_curr);
+      }
 
       /*
      * Initialize node cluster id.
@@ -458,8 +465,10 @@ public:
     uint32_t phase = 0;
 
     std::unique_ptr<katana::PropertyGraph> pg_curr = std::move(pg_mutable);
-    uint32_t iter = 0;
+    uint32_t iter = first_iteration;
     uint64_t num_nodes_orig = clusters_orig.size();
+    // every phase clusters a coarser graph; the convergence is the modularity
+    IterationReporter reporter("leiden_clustering");
 
     while (true) {
       iter++;
@@ -467,7 +476,7 @@ public:
 
       graph_curr = KATANA_CHECKED(Graph::Make(pg_curr.get()));
 
-      if (iter == 1) {
+      if (phase == 1 && !coarsen_first) {
         /* Initialization each node to its own cluster */
         katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
           graph_curr.template GetData<CurrentCommunityID>(n) = n;
@@ -475,8 +484,28 @@ public:
           clusters_orig[n] = n;
           graph_curr.template GetData<NodeWeight>(n) = 1;
         });
+      } else if (phase == 1) {
+        /* Each node of the coarsened graph weighs as many as it merged */
+        katana::NUMAArray<std::atomic<uint64_t>> merged_nodes;
+        merged_nodes.allocateBlocked(graph_curr.NumNodes());
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          merged_nodes[n] = 0;
+        });
+        katana::do_all(
+            katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
+              if (clusters_orig[n] != Base::UNASSIGNED) {
+                katana::atomicAdd(merged_nodes[clusters_orig[n]], uint64_t{1});
+              }
+            });
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          graph_curr.template GetData<CurrentCommunityID>(n) = n;
+          graph_curr.template GetData<PreviousCommunityID>(n) = n;
+          graph_curr.template GetData<NodeWeight>(n) = merged_nodes[n];
+        });
       }
       if (graph_curr.NumNodes() > plan.min_graph_size()) {
+        katana::StatTimer TimerLocalMoving("Timer_Local_Moving_Total");
+        katana::TimerGuard TimerLocalMovingGuard(TimerLocalMoving);
         switch (plan.algorithm()) {
         case LeidenClusteringPlan::kDoAll: {
           curr_mod = KATANA_CHECKED(LeidenWithoutLockingDoAll(
@@ -498,6 +527,8 @@ public:
       } else {
         break;
       }
+      reporter.Report(
+          iter, curr_mod, graph_curr.NumNodes(), graph_curr.NumEdges());
 
       [[maybe_unused]] uint64_t num_unique_clusters =
           Base::template RenumberClustersContiguously<CurrentCommunityID>(
@@ -505,7 +536,8 @@ public:
       katana::StatTimer TimerRefine("Timer_Refine_Total");
       TimerRefine.start();
       Base::template RefinePartition<EdgeWeightType>(
-          &graph_curr, plan.resolution());
+          &graph_curr, plan.resolution(), plan.randomness(),
+          plan.random_seed());
       TimerRefine.stop();
       uint64_t num_unique_subclusters =
           Base::template RenumberClustersContiguously<CurrentSubCommunityID>(
@@ -513,7 +545,7 @@ public:
 
       if (iter < plan.max_iterations() &&
           (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
-        if (!plan.enable_vf() && phase == 1) {
+        if (!coarsen_first && phase == 1) {
           KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.NumNodes());
           katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
             clusters_orig[n] =
@@ -531,6 +563,10 @@ public:
                 }
               });
         }
+        if (checkpointer->IsDue(phase)) {
+          KATANA_CHECKED(
+              SaveClusterCheckpoint(checkpointer, iter, clusters_orig));
+        }
 
         katana::NUMAArray<uint64_t> original_comm_ass;
         katana::NUMAArray<std::atomic<uint64_t>> cluster_node_wt;
@@ -556,10 +592,13 @@ public:
           katana::atomicAdd(cluster_node_wt[n_curr_sub_comm], n_node_wt);
         });
 
+        katana::StatTimer TimerCoarsening("Timer_Coarsening_Total");
+        TimerCoarsening.start();
         auto coarsened_graph_result = Base::template GraphCoarsening<
             NodeData, EdgeData, EdgeWeightType, CurrentSubCommunityID>(
             graph_curr, pg_curr.get(), num_unique_subclusters,
             temp_node_property_names, temp_edge_property_names, txn_ctx);
+        TimerCoarsening.stop();
         if (!coarsened_graph_result) {
           return coarsened_graph_result.error();
         }
@@ -633,11 +672,28 @@ static katana::Result<void>
 LeidenClusteringWithWrap(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, const bool& is_symmetric,
-    LeidenClusteringPlan plan, katana::TxnContext* txn_ctx) {
+    LeidenClusteringPlan plan, katana::TxnContext* txn_ctx,
+    const CommunitySeed* seed) {
   static_assert(
       std::is_integral_v<EdgeWeightType> ||
       std::is_floating_point_v<EdgeWeightType>);
 
+  katana::NUMAArray<uint64_t> seed_labels;
+  if (seed) {
+    seed_labels = KATANA_CHECKED(ReadCommunitySeed(pg, *seed));
+  }
+
+  Checkpointer checkpointer(plan.checkpoint(), "leiden_clustering");
+  uint32_t first_iteration = 0;
+  // a resumed run starts from the subclusters saved
+  CommunitySeed resumed_seed;
+  if (auto state = KATANA_CHECKED(checkpointer.Resume())) {
+    seed_labels =
+        KATANA_CHECKED(ReadClusterCheckpoint(state.value(), pg->NumNodes()));
+    seed = &resumed_seed;
+    first_iteration = state->iteration;
+  }
+
   std::vector<TemporaryPropertyGuard> temp_node_properties(5);
   std::generate_n(
       temp_node_properties.begin(), temp_node_properties.size(),
@@ -667,7 +723,7 @@ LeidenClusteringWithWrap(
         impl{};
     KATANA_CHECKED(impl.LeidenClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, seed, seed_labels, &checkpointer, first_iteration));
   } else {
     using Impl = LeidenClusteringImplementation<
         EdgeWeightType, katana::PropertyGraphViews::Undirected>;
@@ -679,7 +735,7 @@ LeidenClusteringWithWrap(
         impl{};
     KATANA_CHECKED(impl.LeidenClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, seed, seed_labels, &checkpointer, first_iteration));
   }
 
   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
@@ -696,16 +752,18 @@ LeidenClusteringWithWrap(
       },
       katana::loopname("Add clusterIDs"), katana::no_stats());
 
-  return katana::ResultSuccess();
+  return checkpointer.Discard();
 }
 
 }  // anonymous namespace
 
+namespace {
+
 katana::Result<void>
-katana::analytics::LeidenClustering(
+LeidenClusteringImpl(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
-    const bool& is_symmetric, LeidenClusteringPlan plan) {
+    bool is_symmetric, LeidenClusteringPlan plan, const CommunitySeed* seed) {
   if (!edge_weight_property_name.empty() &&
       !pg->HasEdgeProperty(edge_weight_property_name)) {
     return KATANA_ERROR(
@@ -724,7 +782,7 @@ katana::analytics::LeidenClustering(
 
     return LeidenClusteringWithWrap<int64_t>(
         pg, temporary_edge_property.name(), output_property_name, is_symmetric,
-        plan, txn_ctx);
+        plan, txn_ctx, seed);
   }
 
   switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
@@ -733,27 +791,27 @@ katana::analytics::LeidenClustering(
   case arrow::UInt32Type::type_id:
     return LeidenClusteringWithWrap<uint32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::Int32Type::type_id:
     return LeidenClusteringWithWrap<int32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::UInt64Type::type_id:
     return LeidenClusteringWithWrap<uint64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::Int64Type::type_id:
     return LeidenClusteringWithWrap<int64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::FloatType::type_id:
     return LeidenClusteringWithWrap<float>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::DoubleType::type_id:
     return LeidenClusteringWithWrap<double>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   default:
     return KATANA_ERROR(
         katana::ErrorCode::TypeError, "Unsupported type: {}",
@@ -763,6 +821,29 @@ katana::analytics::LeidenClustering(
   }
 }
 
+}  // namespace
+
+katana::Result<void>
+katana::analytics::LeidenClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, LeidenClusteringPlan plan) {
+  return LeidenClusteringImpl(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, nullptr);
+}
+
+katana::Result<void>
+katana::analytics::LeidenClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, const CommunitySeed& seed,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric,
+    LeidenClusteringPlan plan) {
+  return LeidenClusteringImpl(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, &seed);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::LeidenClusteringAssertValid(
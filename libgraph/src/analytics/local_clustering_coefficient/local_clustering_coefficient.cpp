@@ -19,7 +19,11 @@
 
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/SetIntersection.h"
 
 using namespace katana::analytics;
 
@@ -49,27 +53,22 @@ struct LocalClusteringCoefficientAtomics {
   void OrderedCountFunc(
       const SortedGraphView& graph, Node n, CountVec* count_vec) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.OutEdges(n)) {
-      auto v = graph.OutEdgeDst(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.OutEdges(n).begin();
-
-      for (auto edges_v : graph.OutEdges(v)) {
-        auto dst_v = graph.OutEdgeDst(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.OutEdgeDst(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.OutEdgeDst(*e_it_n)) {
-          __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
-        }
-      }
+    auto n_dsts = graph.OutEdgeDsts(n);
+    const Node* n_end = std::upper_bound(n_dsts.begin(), n_dsts.end(), n);
+    for (const Node* v_it = n_dsts.begin(); v_it != n_end; ++v_it) {
+      Node v = *v_it;
+      auto v_dsts = graph.OutEdgeDsts(v);
+      const Node* v_end = std::upper_bound(v_dsts.begin(), v_dsts.end(), v);
+
+      // neighbors of n up to v against neighbors of v up to v
+      ForEachIntersection(
+          n_dsts.begin(), v_it + 1 - n_dsts.begin(), v_dsts.begin(),
+          v_end - v_dsts.begin(), [&](size_t i, size_t) {
+            Node dst_v = n_dsts.begin()[i];
+            __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
+            __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
+            __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
+          });
     }
   }
 
@@ -134,27 +133,22 @@ struct LocalClusteringCoefficientPerThread {
   void OrderedCountFunc(
       const SortedGraphView& graph, Node n, IterPair per_thread_count_range) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.OutEdges(n)) {
-      auto v = graph.OutEdgeDst(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.OutEdges(n).begin();
-
-      for (auto edges_v : graph.OutEdges(v)) {
-        auto dst_v = graph.OutEdgeDst(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.OutEdgeDst(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.OutEdgeDst(*e_it_n)) {
-          *(per_thread_count_range.first + n) += 1;
-          *(per_thread_count_range.first + v) += 1;
-          *(per_thread_count_range.first + dst_v) += 1;
-        }
-      }
+    auto n_dsts = graph.OutEdgeDsts(n);
+    const Node* n_end = std::upper_bound(n_dsts.begin(), n_dsts.end(), n);
+    for (const Node* v_it = n_dsts.begin(); v_it != n_end; ++v_it) {
+      Node v = *v_it;
+      auto v_dsts = graph.OutEdgeDsts(v);
+      const Node* v_end = std::upper_bound(v_dsts.begin(), v_dsts.end(), v);
+
+      // neighbors of n up to v against neighbors of v up to v
+      ForEachIntersection(
+          n_dsts.begin(), v_it + 1 - n_dsts.begin(), v_dsts.begin(),
+          v_end - v_dsts.begin(), [&](size_t i, size_t) {
+            Node dst_v = n_dsts.begin()[i];
+            *(per_thread_count_range.first + n) += 1;
+            *(per_thread_count_range.first + v) += 1;
+            *(per_thread_count_range.first + dst_v) += 1;
+          });
     }
   }
 
@@ -325,3 +319,69 @@ katana::analytics::LocalClusteringCoefficient(
     return katana::ErrorCode::InvalidArgument;
   }
 }
+
+katana::Result<Estimate>
+katana::analytics::EstimateGlobalClusteringCoefficient(
+    katana::PropertyGraph* pg, double max_error, uint32_t seed) {
+  if (!(max_error > 0 && max_error < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "max error must be in (0, 1), got {}", max_error);
+  }
+
+  auto view = pg->BuildView<SortedPropertyGraphView>();
+  size_t num_nodes = view.NumNodes();
+
+  // wedges centered at each node, then the prefix sums of them
+  katana::NUMAArray<uint64_t> wedges;
+  wedges.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(view),
+      [&](Node n) {
+        uint64_t degree = view.OutDegree(n);
+        wedges[n] = degree * (degree - std::min(degree, uint64_t{1})) / 2;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      wedges.begin(), wedges.end(), wedges.begin());
+  uint64_t total_wedges = num_nodes == 0 ? 0 : wedges[num_nodes - 1];
+  if (total_wedges == 0) {
+    return Estimate{};
+  }
+
+  uint64_t key = SamplingKey(seed);
+  uint64_t num_samples = SamplesForError(max_error);
+  katana::GAccumulator<uint64_t> closed;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_samples),
+      [&](uint64_t i) {
+        // centers in proportion to their wedges, then two distinct
+        // neighbors of the center
+        uint64_t w = std::min(
+            static_cast<uint64_t>(SampleUnit(key, 3 * i) * total_wedges),
+            total_wedges - 1);
+        Node center =
+            std::upper_bound(wedges.begin(), wedges.end(), w) - wedges.begin();
+        auto dsts = view.OutEdgeDsts(center);
+        uint64_t degree = dsts.end() - dsts.begin();
+        uint64_t a = std::min(
+            static_cast<uint64_t>(SampleUnit(key, 3 * i + 1) * degree),
+            degree - 1);
+        uint64_t b = std::min(
+            static_cast<uint64_t>(SampleUnit(key, 3 * i + 2) * (degree - 1)),
+            degree - 2);
+        if (b >= a) {
+          ++b;
+        }
+        auto a_dsts = view.OutEdgeDsts(dsts.begin()[a]);
+        if (std::binary_search(
+                a_dsts.begin(), a_dsts.end(), dsts.begin()[b])) {
+          closed += 1;
+        }
+      },
+      katana::steal(),
+      katana::loopname("EstimateGlobalClusteringCoefficient"));
+
+  double p = static_cast<double>(closed.reduce()) / num_samples;
+  return Estimate{p, std::sqrt(p * (1 - p) / num_samples)};
+}
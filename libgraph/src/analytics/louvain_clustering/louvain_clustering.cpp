@@ -25,6 +25,7 @@
 
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
+#include "katana/analytics/IterationMetrics.h"
 
 using namespace katana::analytics;
 namespace {
@@ -90,6 +91,15 @@ struct LouvainClusteringImplementation
       KATANA_LOG_FATAL("constant_for_second_term is INFINITY\n");
     }
 
+    // reused from node to node by each thread
+    katana::PerThreadStorage<ClusterWeightMap<EdgeWeightType>> cluster_weights;
+
+    // Phase 1 reads the cluster ids of all neighbors next to the degree
+    // weight of each node, so both are packed into rows for the rounds
+    using Packed = typename Base::template PackedNodeData<
+        CurrentCommunityID, DegreeWeight<EdgeWeightType>>;
+    Packed packed = Packed::Gather(*graph);
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -104,26 +114,21 @@ struct LouvainClusteringImplementation
           katana::iterate(*graph),
           [&](GNode n) {
             auto& n_data_curr_comm_id =
-                graph->template GetData<CurrentCommunityID>(n);
+                packed.template Get<CurrentCommunityID>(n);
             auto& n_data_degree_wt =
-                graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+                packed.template Get<DegreeWeight<EdgeWeightType>>(n);
 
             uint64_t degree = Degree(*graph, n);
             uint64_t local_target = Base::UNASSIGNED;
-            // TODO(amber): use scalable allocator with these containers
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  *graph, n, cluster_local_map, counter, self_loop_wt);
+                  *graph, packed, n, cluster_weights.getLocal(),
+                  self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
+                  *cluster_weights.getLocal(), self_loop_wt, c_info,
                   n_data_degree_wt, n_data_curr_comm_id,
                   constant_for_second_term);
 
@@ -146,6 +151,7 @@ struct LouvainClusteringImplementation
             }
           },
           katana::loopname("louvain algo: Phase 1"));
+      packed.template Scatter<CurrentCommunityID>(graph);
 
       /* Calculate the overall modularity */
       double e_xx = 0;
@@ -242,6 +248,9 @@ struct LouvainClusteringImplementation
       c_update_subtract[n].size = 0;
     });
 
+    // reused from node to node by each thread
+    katana::PerThreadStorage<ClusterWeightMap<EdgeWeightType>> cluster_weights;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
 
@@ -261,20 +270,14 @@ struct LouvainClusteringImplementation
 
               uint64_t degree = Degree(*graph, n);
 
-              // TODO(amber): use scalable allocators
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
                 Base::template FindNeighboringClusters<EdgeWeightType>(
-                    *graph, n, cluster_local_map, counter, self_loop_wt);
+                    *graph, n, cluster_weights.getLocal(), self_loop_wt);
                 // Find the max gain in modularity
                 local_target[n] = Base::MaxModularityWithoutSwaps(
-                    cluster_local_map, counter, self_loop_wt, c_info,
+                    *cluster_weights.getLocal(), self_loop_wt, c_info,
                     n_data_degree_wt, n_data_curr_comm_id,
                     constant_for_second_term);
 
@@ -360,7 +363,9 @@ public:
       katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
       const std::vector<std::string>& temp_node_property_names,
       katana::NUMAArray<uint64_t>& clusters_orig, LouvainClusteringPlan plan,
-      katana::TxnContext* txn_ctx) {
+      katana::TxnContext* txn_ctx, const CommunitySeed* seed,
+      const katana::NUMAArray<uint64_t>& seed_labels,
+      Checkpointer* checkpointer, uint32_t first_iteration) {
     TemporaryPropertyGuard temp_edge_property{pg->EdgeMutablePropertyView()};
     std::vector<std::string> temp_edge_property_names = {
         temp_edge_property.name()};
@@ -374,14 +379,22 @@ public:
     Graph graph_curr = KATANA_CHECKED(
         Graph::Make(pg, temp_node_property_names, {edge_weight_property_name}));
     /*
-    * Vertex following optimization
+    * Vertex following optimization, or start from the seed clusters
     */
-    if (plan.enable_vf()) {
-      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
-
-      uint64_t num_unique_clusters =
-          Base::template RenumberClustersContiguously<CurrentCommunityID>(
-              &graph_curr);
+    const bool coarsen_first = seed || plan.enable_vf();
+    if (coarsen_first) {
+      uint64_t num_unique_clusters = 0;
+      if (seed) {
+        num_unique_clusters =
+            Base::template SeedClusters<CurrentCommunityID>(
+                &graph_curr, seed_labels, seed->changed_nodes);
+      } else {
+        Base::VertexFollowing(
+            &graph_curr);  // Find nodes that follow other nodes
+        num_unique_clusters =
+            Base::template RenumberClustersContiguously<CurrentCommunityID>(
+                &graph_curr);
+      }
 
       /*
      * Initialize node cluster id.
@@ -428,8 +441,10 @@ public:
     uint32_t phase = 0;
 
     std::unique_ptr<katana::PropertyGraph> pg_curr = std::move(pg_mutable);
-    uint32_t iter = 0;
+    uint32_t iter = first_iteration;
     uint64_t num_nodes_orig = clusters_orig.size();
+    // every phase clusters a coarser graph; the convergence is the modularity
+    IterationReporter reporter("louvain_clustering");
     while (true) {
       iter++;
       phase++;
@@ -456,6 +471,8 @@ public:
       } else {
         break;
       }
+      reporter.Report(
+          iter, curr_mod, graph_curr.NumNodes(), graph_curr.NumEdges());
 
       uint64_t num_unique_clusters =
           Base::template RenumberClustersContiguously<CurrentCommunityID>(
@@ -463,7 +480,7 @@ public:
 
       if (iter < plan.max_iterations() &&
           (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
-        if (!plan.enable_vf() && phase == 1) {
+        if (!coarsen_first && phase == 1) {
           KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.NumNodes());
           katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
             clusters_orig[n] =
@@ -481,6 +498,10 @@ public:
                 }
               });
         }
+        if (checkpointer->IsDue(phase)) {
+          KATANA_CHECKED(
+              SaveClusterCheckpoint(checkpointer, iter, clusters_orig));
+        }
 
         auto coarsened_graph_result = Base::template GraphCoarsening<
             NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
@@ -506,11 +527,28 @@ static katana::Result<void>
 LouvainClusteringWithWrap(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, const bool& is_symmetric,
-    LouvainClusteringPlan plan, katana::TxnContext* txn_ctx) {
+    LouvainClusteringPlan plan, katana::TxnContext* txn_ctx,
+    const CommunitySeed* seed) {
   static_assert(
       std::is_integral_v<EdgeWeightType> ||
       std::is_floating_point_v<EdgeWeightType>);
 
+  katana::NUMAArray<uint64_t> seed_labels;
+  if (seed) {
+    seed_labels = KATANA_CHECKED(ReadCommunitySeed(pg, *seed));
+  }
+
+  Checkpointer checkpointer(plan.checkpoint(), "louvain_clustering");
+  uint32_t first_iteration = 0;
+  // a resumed run starts from the clusters saved
+  CommunitySeed resumed_seed;
+  if (auto state = KATANA_CHECKED(checkpointer.Resume())) {
+    seed_labels =
+        KATANA_CHECKED(ReadClusterCheckpoint(state.value(), pg->NumNodes()));
+    seed = &resumed_seed;
+    first_iteration = state->iteration;
+  }
+
   std::vector<TemporaryPropertyGuard> temp_node_properties(3);
   std::generate_n(
       temp_node_properties.begin(), temp_node_properties.size(),
@@ -538,7 +576,7 @@ LouvainClusteringWithWrap(
     LouvainClusteringImplementation<EdgeWeightType, GraphViewTy> impl{};
     KATANA_CHECKED(impl.LouvainClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, seed, seed_labels, &checkpointer, first_iteration));
   } else {
     using GraphViewTy = katana::PropertyGraphViews::Undirected;
     using Impl = LouvainClusteringImplementation<EdgeWeightType, GraphViewTy>;
@@ -548,7 +586,7 @@ LouvainClusteringWithWrap(
     LouvainClusteringImplementation<EdgeWeightType, GraphViewTy> impl{};
     KATANA_CHECKED(impl.LouvainClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan, txn_ctx, seed, seed_labels, &checkpointer, first_iteration));
   }
 
   KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
@@ -565,16 +603,18 @@ LouvainClusteringWithWrap(
       },
       katana::loopname("Add clusterIDs"), katana::no_stats());
 
-  return katana::ResultSuccess();
+  return checkpointer.Discard();
 }
 
 }  // anonymous namespace
 
+namespace {
+
 katana::Result<void>
-katana::analytics::LouvainClustering(
+LouvainClusteringImpl(
     katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
-    const bool& is_symmetric, LouvainClusteringPlan plan) {
+    bool is_symmetric, LouvainClusteringPlan plan, const CommunitySeed* seed) {
   if (!edge_weight_property_name.empty() &&
       !pg->HasEdgeProperty(edge_weight_property_name)) {
     return KATANA_ERROR(
@@ -592,7 +632,7 @@ katana::analytics::LouvainClustering(
 
     return LouvainClusteringWithWrap<EdgeWeightType>(
         pg, temporary_edge_property.name(), output_property_name, is_symmetric,
-        plan, txn_ctx);
+        plan, txn_ctx, seed);
   }
 
   switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
@@ -601,27 +641,27 @@ katana::analytics::LouvainClustering(
   case arrow::UInt32Type::type_id:
     return LouvainClusteringWithWrap<uint32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::Int32Type::type_id:
     return LouvainClusteringWithWrap<int32_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::UInt64Type::type_id:
     return LouvainClusteringWithWrap<uint64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::Int64Type::type_id:
     return LouvainClusteringWithWrap<int64_t>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::FloatType::type_id:
     return LouvainClusteringWithWrap<float>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   case arrow::DoubleType::type_id:
     return LouvainClusteringWithWrap<double>(
         pg, edge_weight_property_name, output_property_name, is_symmetric, plan,
-        txn_ctx);
+        txn_ctx, seed);
   default:
     return KATANA_ERROR(
         katana::ErrorCode::TypeError, "Unsupported type: {}",
@@ -631,6 +671,29 @@ katana::analytics::LouvainClustering(
   }
 }
 
+}  // namespace
+
+katana::Result<void>
+katana::analytics::LouvainClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const bool& is_symmetric, LouvainClusteringPlan plan) {
+  return LouvainClusteringImpl(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, nullptr);
+}
+
+katana::Result<void>
+katana::analytics::LouvainClustering(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, const CommunitySeed& seed,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric,
+    LouvainClusteringPlan plan) {
+  return LouvainClusteringImpl(
+      pg, edge_weight_property_name, output_property_name, txn_ctx,
+      is_symmetric, plan, &seed);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::LouvainClusteringAssertValid(
@@ -19,7 +19,13 @@
 
 #include "katana/analytics/matrix_completion/matrix_completion.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -28,6 +34,7 @@
 #include "katana/AtomicWrapper.h"
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
 #include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
@@ -57,6 +64,56 @@ typedef typename Graph::Node GNode;
 size_t kNumItemNodes = 0;
 typedef double LatentValue;
 
+/// A latent vector copied out of the graph. The kernels below work on these
+/// with the length fixed at compile time so that the compiler unrolls and
+/// vectorizes them.
+using LatentArray = std::array<LatentValue, LATENT_VECTOR_SIZE>;
+
+void
+LoadLatent(
+    katana::PropertyReferenceType<NodeLatentVector> vector, LatentArray* out) {
+  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+    (*out)[i] = vector[i].load(std::memory_order_relaxed);
+  }
+}
+
+void
+StoreLatent(
+    const LatentArray& in,
+    katana::PropertyReferenceType<NodeLatentVector> vector) {
+  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+    vector[i].store(in[i], std::memory_order_relaxed);
+  }
+}
+
+/// Inner product with independent partial sums so that it vectorizes
+/// without reassociating floating point additions.
+LatentValue
+Dot(const LatentArray& a, const LatentArray& b) {
+  constexpr int kLanes = 4;
+  static_assert(LATENT_VECTOR_SIZE % kLanes == 0);
+  std::array<LatentValue, kLanes> partial{};
+  for (int i = 0; i < LATENT_VECTOR_SIZE; i += kLanes) {
+    for (int j = 0; j < kLanes; j++) {
+      partial[j] += a[i + j] * b[i + j];
+    }
+  }
+  return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+}
+
+/// The gradient step of DoGradientUpdate on private copies of the vectors.
+void
+GradientStep(
+    LatentValue error, LatentValue lambda, LatentValue step_size,
+    LatentArray* item, LatentArray* user) {
+  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+    LatentValue prev_item = (*item)[i];
+    LatentValue prev_user = (*user)[i];
+    (*item)[i] += step_size * (error * prev_user - lambda * prev_item);
+    (*user)[i] += step_size * (error * prev_item - lambda * prev_user);
+  }
+}
+
 struct MatrixCompletionImplementation
     : public katana::analytics::MatrixCompletionImplementationBase<Graph> {
   double SumSquaredError(Graph& graph) {
@@ -254,12 +311,49 @@ struct MatrixCompletionImplementation
   }
 };
 
+std::string
+LatentColumnName(int i) {
+  return "latent_" + std::to_string(i);
+}
+
+katana::Result<void>
+SaveLatentCheckpoint(Checkpointer* checkpointer, uint32_t round, Graph& graph) {
+  std::vector<std::string> names;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+    names.emplace_back(LatentColumnName(i));
+    columns.emplace_back(KATANA_CHECKED(MakeCheckpointColumn<LatentValue>(
+        graph.size(), [&](size_t n) {
+          return graph.GetData<NodeLatentVector>(n)[i].load(
+              std::memory_order_relaxed);
+        })));
+  }
+  return checkpointer->Save(MakeCheckpointState(round, names, columns));
+}
+
+katana::Result<void>
+RestoreLatentCheckpoint(const CheckpointState& state, Graph& graph) {
+  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+    KATANA_CHECKED(RestoreCheckpointColumn<LatentValue>(
+        state, LatentColumnName(i), graph.size(),
+        [&](size_t n, LatentValue value) {
+          graph.GetData<NodeLatentVector>(n)[i].store(
+              value, std::memory_order_relaxed);
+        }));
+  }
+  return katana::ResultSuccess();
+}
+
 // Common function to execute different algorithms till convergence
+//
+// A run resumed from a checkpoint starts at first_round but, as the last error
+// is not saved, runs at least one more round before it can converge.
 template <typename Fn>
-void
+katana::Result<void>
 ExecuteUntilConverged(
     const MatrixCompletionImplementation::StepFunction& sf, Graph& graph, Fn fn,
-    MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
+    MatrixCompletionPlan plan, MatrixCompletionImplementation impl,
+    Checkpointer* checkpointer, uint32_t first_round) {
   katana::GAccumulator<double> error_accum;
   std::vector<LatentValue> steps(plan.updatesPerEdge());
   LatentValue last = -1.0;
@@ -270,7 +364,7 @@ ExecuteUntilConverged(
   katana::TimeAccumulator elapsed;
   elapsed.start();
 
-  for (unsigned int round = 0;; round += delta_round) {
+  for (unsigned int round = first_round;; round += delta_round) {
     if (plan.fixedRounds() > 0 && round >= plan.fixedRounds())
       break;
     if (plan.fixedRounds() > 0)
@@ -284,6 +378,7 @@ ExecuteUntilConverged(
         steps[i] = sf.StepSize(round + i, plan);
     }
 
+    error_accum.reset();
     executeAlgoTimer.start();
     fn(&steps[0], round + delta_round,
        plan.useExactError() ? &error_accum : NULL, plan, impl);
@@ -309,7 +404,13 @@ ExecuteUntilConverged(
         rate = steps[delta_round - 1] * 1.05;
     }
     last = error;
+
+    if (checkpointer->IsDue(round + delta_round)) {
+      KATANA_CHECKED(
+          SaveLatentCheckpoint(checkpointer, round + delta_round, graph));
+    }
   }
+  return katana::ResultSuccess();
 }
 
 class SGDItemsAlgo {
@@ -342,7 +443,7 @@ private:
 
               edges_visited += 1;
               if (plan.useExactError())
-                *error_accum += error;
+                *error_accum += error * error;
             }
           },
           katana::loopname("sgdItemsAlgo"));
@@ -350,21 +451,419 @@ private:
   };
 
 public:
-  void operator()(
+  katana::Result<void> operator()(
       Graph& graph, const MatrixCompletionImplementation::StepFunction& sf,
-      MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
+      MatrixCompletionPlan plan, MatrixCompletionImplementation impl,
+      Checkpointer* checkpointer, uint32_t first_round) {
     katana::GAccumulator<unsigned> edges_visited;
 
     katana::StatTimer executeTimer("Time");
     executeTimer.start();
 
     Execute fn{graph, edges_visited};
-    ExecuteUntilConverged(sf, graph, fn, plan, impl);
+    KATANA_CHECKED(ExecuteUntilConverged(
+        sf, graph, fn, plan, impl, checkpointer, first_round));
 
     executeTimer.stop();
 
     katana::ReportStatSingle(
         "sgdItemsAlgo", "EdgesVisited", edges_visited.reduce());
+    return katana::ResultSuccess();
+  }
+};
+
+class SGDBlockedAlgo {
+public:
+  bool IsSgd() const { return true; }
+
+  std::string Name() const { return "sgdBlockedAlgo"; }
+
+  size_t NumItems() const { return kNumItemNodes; }
+
+private:
+  struct Rating {
+    GNode item;
+    GNode user;
+    LatentValue rating;
+  };
+
+  static constexpr GNode kNoItem = std::numeric_limits<GNode>::max();
+
+  uint32_t num_blocks_ = 1;
+  /// The ratings sorted by block (item block major) and by item within each
+  /// block, so each block is a contiguous run that streams through memory.
+  katana::NUMAArray<Rating> ratings_;
+  /// ratings_ of block (ib, ub) are [block_begins_[ib * B + ub],
+  /// block_begins_[ib * B + ub + 1])
+  std::vector<uint64_t> block_begins_;
+
+  /// Cut the items and the users into num_blocks_ ranges of ids each and
+  /// copy the ratings into their blocks.
+  void Stratify(Graph& graph) {
+    katana::StatTimer stratify_timer("Stratify");
+    stratify_timer.start();
+
+    const uint64_t num_blocks = num_blocks_;
+    const uint64_t num_items = kNumItemNodes;
+    const uint64_t num_users = std::max<uint64_t>(graph.size() - num_items, 1);
+    const uint64_t items_per_block = (num_items + num_blocks - 1) / num_blocks;
+    const uint64_t users_per_block = (num_users + num_blocks - 1) / num_blocks;
+
+    // Assuming only item nodes have edges and they point to users
+    auto user_block = [&](GNode user) -> uint64_t {
+      return user < num_items ? 0 : (user - num_items) / users_per_block;
+    };
+    auto first_item = [&](uint64_t ib) -> GNode {
+      return std::min(ib * items_per_block, num_items);
+    };
+
+    block_begins_.assign(num_blocks * num_blocks + 1, 0);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks),
+        [&](uint64_t ib) {
+          uint64_t* counts = &block_begins_[ib * num_blocks + 1];
+          for (GNode item = first_item(ib); item < first_item(ib + 1);
+               ++item) {
+            for (auto e : graph.OutEdges(item)) {
+              counts[user_block(graph.OutEdgeDst(e))] += 1;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    std::partial_sum(
+        block_begins_.begin(), block_begins_.end(), block_begins_.begin());
+
+    ratings_.allocateBlocked(block_begins_.back());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks),
+        [&](uint64_t ib) {
+          std::vector<uint64_t> cursors(
+              block_begins_.begin() + ib * num_blocks,
+              block_begins_.begin() + (ib + 1) * num_blocks);
+          for (GNode item = first_item(ib); item < first_item(ib + 1);
+               ++item) {
+            for (auto e : graph.OutEdges(item)) {
+              GNode user = graph.OutEdgeDst(e);
+              ratings_[cursors[user_block(user)]++] =
+                  Rating{item, user, graph.GetEdgeData<EdgeWeight>(e)};
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    stratify_timer.stop();
+  }
+
+  struct Execute {
+    Graph& graph;
+    SGDBlockedAlgo& algo;
+    katana::GAccumulator<unsigned>& edges_visited;
+
+    /// Blocks of one stratum share no item or user, so the latent vectors
+    /// are updated with plain loads and stores instead of atomic adds, and
+    /// the vector of the current item is kept in registers across its run
+    /// of ratings.
+    void UpdateBlock(
+        uint64_t block, LatentValue step_size,
+        katana::GAccumulator<double>* error_accum, MatrixCompletionPlan plan) {
+      const LatentValue lambda = plan.lambda();
+      LatentArray item_vector;
+      LatentArray user_vector;
+      GNode item = kNoItem;
+      for (uint64_t i = algo.block_begins_[block],
+                    end = algo.block_begins_[block + 1];
+           i < end; ++i) {
+        const Rating& rating = algo.ratings_[i];
+        if (rating.item != item) {
+          if (item != kNoItem) {
+            StoreLatent(item_vector, graph.GetData<NodeLatentVector>(item));
+          }
+          item = rating.item;
+          LoadLatent(graph.GetData<NodeLatentVector>(item), &item_vector);
+        }
+        auto user_latent_vector = graph.GetData<NodeLatentVector>(rating.user);
+        LoadLatent(user_latent_vector, &user_vector);
+
+        LatentValue error = rating.rating - Dot(item_vector, user_vector);
+        GradientStep(error, lambda, step_size, &item_vector, &user_vector);
+        StoreLatent(user_vector, user_latent_vector);
+
+        if (error_accum) {
+          *error_accum += error * error;
+        }
+      }
+      if (item != kNoItem) {
+        StoreLatent(item_vector, graph.GetData<NodeLatentVector>(item));
+      }
+      edges_visited +=
+          algo.block_begins_[block + 1] - algo.block_begins_[block];
+    }
+
+    void operator()(
+        LatentValue* steps, int, katana::GAccumulator<double>* error_accum,
+        MatrixCompletionPlan plan, MatrixCompletionImplementation) {
+      const LatentValue step_size = steps[0];
+      const uint64_t num_blocks = algo.num_blocks_;
+      for (uint64_t stratum = 0; stratum < num_blocks; ++stratum) {
+        katana::do_all(
+            katana::iterate(uint64_t{0}, num_blocks),
+            [&](uint64_t ib) {
+              uint64_t ub = (ib + stratum) % num_blocks;
+              UpdateBlock(
+                  ib * num_blocks + ub, step_size, error_accum, plan);
+            },
+            katana::steal(), katana::chunk_size<1>(),
+            katana::loopname("sgdBlockedAlgo"));
+      }
+    }
+  };
+
+public:
+  katana::Result<void> operator()(
+      Graph& graph, const MatrixCompletionImplementation::StepFunction& sf,
+      MatrixCompletionPlan plan, MatrixCompletionImplementation impl,
+      Checkpointer* checkpointer, uint32_t first_round) {
+    katana::GAccumulator<unsigned> edges_visited;
+
+    katana::StatTimer executeTimer("Time");
+    executeTimer.start();
+
+    num_blocks_ = plan.numBlocks() > 0 ? plan.numBlocks()
+                                       : katana::getActiveThreads();
+    Stratify(graph);
+
+    Execute fn{graph, *this, edges_visited};
+    KATANA_CHECKED(ExecuteUntilConverged(
+        sf, graph, fn, plan, impl, checkpointer, first_round));
+
+    executeTimer.stop();
+
+    katana::ReportStatSingle(
+        "sgdBlockedAlgo", "EdgesVisited", edges_visited.reduce());
+    return katana::ResultSuccess();
+  }
+};
+
+class ALSAlgo {
+public:
+  bool IsSgd() const { return false; }
+
+  std::string Name() const { return "alsAlgo"; }
+
+  size_t NumItems() const { return kNumItemNodes; }
+
+private:
+  struct UserRating {
+    GNode item;
+    LatentValue rating;
+  };
+
+  /// The ratings of user u are user_ratings_[user_begins_[u - num_items],
+  /// user_begins_[u - num_items + 1]), sorted by item.
+  katana::NUMAArray<UserRating> user_ratings_;
+  katana::NUMAArray<uint64_t> user_begins_;
+
+  void TransposeRatings(Graph& graph) {
+    katana::StatTimer transpose_timer("TransposeRatings");
+    transpose_timer.start();
+
+    const uint64_t num_items = kNumItemNodes;
+    const uint64_t num_users = graph.size() - num_items;
+
+    katana::NUMAArray<std::atomic<uint64_t>> cursors;
+    cursors.allocateBlocked(num_users + 1);
+    katana::ParallelSTL::fill(cursors.begin(), cursors.end(), 0);
+    // Assuming only item nodes have edges and they point to users
+    katana::do_all(
+        katana::iterate(graph.begin(), graph.begin() + num_items),
+        [&](GNode item) {
+          for (auto e : graph.OutEdges(item)) {
+            cursors[graph.OutEdgeDst(e) - num_items + 1].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    user_begins_.allocateBlocked(num_users + 1);
+    user_begins_[0] = 0;
+    for (uint64_t u = 0; u < num_users; ++u) {
+      user_begins_[u + 1] = user_begins_[u] + cursors[u + 1].load();
+      cursors[u].store(user_begins_[u], std::memory_order_relaxed);
+    }
+
+    user_ratings_.allocateBlocked(user_begins_[num_users]);
+    katana::do_all(
+        katana::iterate(graph.begin(), graph.begin() + num_items),
+        [&](GNode item) {
+          for (auto e : graph.OutEdges(item)) {
+            uint64_t slot = cursors[graph.OutEdgeDst(e) - num_items].fetch_add(
+                1, std::memory_order_relaxed);
+            user_ratings_[slot] =
+                UserRating{item, graph.GetEdgeData<EdgeWeight>(e)};
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    // Fix the order of the sums in the normal equations
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_users),
+        [&](uint64_t u) {
+          std::sort(
+              user_ratings_.data() + user_begins_[u],
+              user_ratings_.data() + user_begins_[u + 1],
+              [](const UserRating& a, const UserRating& b) {
+                return a.item < b.item;
+              });
+        },
+        katana::steal(), katana::no_stats());
+
+    transpose_timer.stop();
+  }
+
+  /// Solve (sum of v v^T + lambda I) x = sum of rating * v over the ratings
+  /// visited by for_each_rating with a Cholesky factorization. x is left
+  /// alone if the system is not positive definite, e.g., when lambda is 0
+  /// and there are too few ratings.
+  template <typename ForEachRating>
+  static void SolveLeastSquares(
+      LatentValue lambda, ForEachRating for_each_rating, LatentArray* x) {
+    constexpr int kSize = LATENT_VECTOR_SIZE;
+    // only the lower triangle of a is used
+    std::array<LatentValue, kSize * kSize> a{};
+    LatentArray b{};
+    for_each_rating([&](const LatentArray& v, LatentValue rating) {
+      for (int i = 0; i < kSize; i++) {
+        for (int j = 0; j <= i; j++) {
+          a[i * kSize + j] += v[i] * v[j];
+        }
+        b[i] += rating * v[i];
+      }
+    });
+    for (int i = 0; i < kSize; i++) {
+      a[i * kSize + i] += lambda;
+    }
+
+    // a = L L^T, L overwrites the lower triangle of a
+    for (int j = 0; j < kSize; j++) {
+      LatentValue d = a[j * kSize + j];
+      for (int k = 0; k < j; k++) {
+        d -= a[j * kSize + k] * a[j * kSize + k];
+      }
+      if (!(d > 0)) {
+        return;
+      }
+      a[j * kSize + j] = std::sqrt(d);
+      for (int i = j + 1; i < kSize; i++) {
+        LatentValue sum = a[i * kSize + j];
+        for (int k = 0; k < j; k++) {
+          sum -= a[i * kSize + k] * a[j * kSize + k];
+        }
+        a[i * kSize + j] = sum / a[j * kSize + j];
+      }
+    }
+
+    // L y = b, then L^T x = y
+    for (int i = 0; i < kSize; i++) {
+      for (int k = 0; k < i; k++) {
+        b[i] -= a[i * kSize + k] * b[k];
+      }
+      b[i] /= a[i * kSize + i];
+    }
+    for (int i = kSize - 1; i >= 0; i--) {
+      for (int k = i + 1; k < kSize; k++) {
+        b[i] -= a[k * kSize + i] * b[k];
+      }
+      b[i] /= a[i * kSize + i];
+    }
+    *x = b;
+  }
+
+  struct Execute {
+    Graph& graph;
+    ALSAlgo& algo;
+    katana::GAccumulator<unsigned>& edges_visited;
+
+    void operator()(
+        LatentValue*, int, katana::GAccumulator<double>* error_accum,
+        MatrixCompletionPlan plan, MatrixCompletionImplementation impl) {
+      const LatentValue lambda = plan.lambda();
+      const uint64_t num_items = kNumItemNodes;
+
+      katana::do_all(
+          katana::iterate(graph.begin(), graph.begin() + num_items),
+          [&](GNode item) {
+            auto item_latent_vector = graph.GetData<NodeLatentVector>(item);
+            LatentArray x;
+            LoadLatent(item_latent_vector, &x);
+            SolveLeastSquares(
+                lambda,
+                [&](auto&& add) {
+                  LatentArray v;
+                  for (auto e : graph.OutEdges(item)) {
+                    LoadLatent(
+                        graph.GetData<NodeLatentVector>(graph.OutEdgeDst(e)),
+                        &v);
+                    add(v, graph.GetEdgeData<EdgeWeight>(e));
+                  }
+                },
+                &x);
+            StoreLatent(x, item_latent_vector);
+          },
+          katana::steal(), katana::loopname("alsItems"));
+
+      katana::do_all(
+          katana::iterate(graph.begin() + num_items, graph.end()),
+          [&](GNode user) {
+            auto user_latent_vector = graph.GetData<NodeLatentVector>(user);
+            LatentArray x;
+            LoadLatent(user_latent_vector, &x);
+            uint64_t begin = algo.user_begins_[user - num_items];
+            uint64_t end = algo.user_begins_[user - num_items + 1];
+            SolveLeastSquares(
+                lambda,
+                [&](auto&& add) {
+                  LatentArray v;
+                  for (uint64_t i = begin; i < end; ++i) {
+                    const UserRating& rating = algo.user_ratings_[i];
+                    LoadLatent(
+                        graph.GetData<NodeLatentVector>(rating.item), &v);
+                    add(v, rating.rating);
+                  }
+                },
+                &x);
+            StoreLatent(x, user_latent_vector);
+          },
+          katana::steal(), katana::loopname("alsUsers"));
+
+      edges_visited += 2 * algo.user_ratings_.size();
+      if (error_accum) {
+        *error_accum += impl.SumSquaredError(graph);
+      }
+    }
+  };
+
+public:
+  katana::Result<void> operator()(
+      Graph& graph, const MatrixCompletionImplementation::StepFunction& sf,
+      MatrixCompletionPlan plan, MatrixCompletionImplementation impl,
+      Checkpointer* checkpointer, uint32_t first_round) {
+    katana::GAccumulator<unsigned> edges_visited;
+
+    katana::StatTimer executeTimer("Time");
+    executeTimer.start();
+
+    TransposeRatings(graph);
+
+    // the step sizes computed from sf are not used
+    Execute fn{graph, *this, edges_visited};
+    KATANA_CHECKED(ExecuteUntilConverged(
+        sf, graph, fn, plan, impl, checkpointer, first_round));
+
+    executeTimer.stop();
+
+    katana::ReportStatSingle(
+        "alsAlgo", "EdgesVisited", edges_visited.reduce());
+    return katana::ResultSuccess();
   }
 };
 
@@ -382,16 +881,23 @@ Run(katana::PropertyGraph* pg, MatrixCompletionPlan plan,
   // initialize latent vectors and get number of item nodes
   kNumItemNodes = impl.InitializeGraphData(graph, plan);
 
+  Checkpointer checkpointer(plan.checkpoint(), "matrix_completion");
+  uint32_t first_round = 0;
+  if (auto state = KATANA_CHECKED(checkpointer.Resume())) {
+    KATANA_CHECKED(RestoreLatentCheckpoint(state.value(), graph));
+    first_round = state->iteration;
+  }
+
   std::unique_ptr<MatrixCompletionImplementation::StepFunction> sf{
       KATANA_CHECKED(impl.NewStepFunction(plan))};
 
   katana::StatTimer execTime("MatrixCompletion");
 
   execTime.start();
-  algo(graph, *sf, plan, impl);
+  KATANA_CHECKED(algo(graph, *sf, plan, impl, &checkpointer, first_round));
   execTime.stop();
 
-  return katana::ResultSuccess();
+  return checkpointer.Discard();
 }
 
 }  // namespace
@@ -403,6 +909,10 @@ katana::analytics::MatrixCompletion(
   switch (plan.algorithm()) {
   case MatrixCompletionPlan::kSGDByItems:
     return Run<SGDItemsAlgo>(pg, plan, txn_ctx);
+  case MatrixCompletionPlan::kSGDBlocked:
+    return Run<SGDBlockedAlgo>(pg, plan, txn_ctx);
+  case MatrixCompletionPlan::kALS:
+    return Run<ALSAlgo>(pg, plan, txn_ctx);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
@@ -0,0 +1,619 @@
+#include "katana/analytics/max_flow/max_flow.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+struct NodeInCut : public katana::PODProperty<uint8_t> {};
+
+template <typename Capacity>
+struct EdgeCapacity : public katana::PODProperty<Capacity> {};
+template <typename Capacity>
+struct EdgeFlow : public katana::PODProperty<Capacity> {};
+
+template <typename Capacity>
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, std::tuple<NodeInCut>,
+    std::tuple<EdgeCapacity<Capacity>, EdgeFlow<Capacity>>>;
+
+using GNode = katana::GraphTopology::Node;
+using PropertyIndex = katana::GraphTopology::Edge;
+
+constexpr uint32_t kUnlabeled = std::numeric_limits<uint32_t>::max();
+
+template <typename Capacity>
+bool
+IsNegative(Capacity value) {
+  if constexpr (std::is_signed_v<Capacity>) {
+    return value < 0;
+  } else {
+    return false;
+  }
+}
+
+/// Call func(neighbor, property index, is out edge) for every edge of node,
+/// out edges and in edges alike, since each edge is an arc of the residual
+/// graph in both directions
+template <typename G, typename Func>
+void
+ForEachNeighbor(const G& graph, GNode node, const Func& func) {
+  for (auto e : graph.OutEdges(node)) {
+    func(graph.OutEdgeDst(e), graph.GetEdgePropertyIndexFromOutEdge(e), true);
+  }
+  for (auto e : graph.InEdges(node)) {
+    func(graph.InEdgeSrc(e), graph.GetEdgePropertyIndexFromInEdge(e), false);
+  }
+}
+
+/// Lock-free parallel push-relabel in the style of Hong (2008). Only the
+/// thread discharging a node lowers its excess and the residual capacities
+/// of the arcs out of it or raises its height; everything else about other
+/// nodes is read or raised atomically.
+///
+/// The flow on each edge is the only residual state: an edge from u to v
+/// with capacity c and flow f leaves c - f to push from u to v and f to push
+/// back from v to u.
+template <typename Capacity>
+class PushRelabel {
+public:
+  PushRelabel(
+      const Graph<Capacity>& graph, GNode source, GNode sink,
+      const MaxFlowPlan& plan)
+      : graph_(graph),
+        source_(source),
+        sink_(sink),
+        num_nodes_(graph.NumNodes()),
+        relabel_budget_(
+            static_cast<uint64_t>(plan.global_relabel_interval()) *
+            graph.NumNodes()) {
+    capacity_.allocateBlocked(graph.NumEdges());
+    flow_.allocateBlocked(graph.NumEdges());
+    excess_.allocateBlocked(num_nodes_);
+    height_.allocateBlocked(num_nodes_);
+    height_count_.allocateBlocked(num_nodes_);
+    queued_.allocateBlocked(num_nodes_);
+  }
+
+  katana::Result<void> Run() {
+    katana::GReduceLogicalOr negative;
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& n) {
+          for (auto e : graph_.OutEdges(n)) {
+            Capacity capacity =
+                graph_.template GetEdgeData<EdgeCapacity<Capacity>>(e);
+            if (IsNegative(capacity)) {
+              negative.update(true);
+            }
+            auto idx = graph_.GetEdgePropertyIndexFromOutEdge(e);
+            capacity_[idx] = capacity;
+            flow_[idx] = 0;
+          }
+          excess_[n] = 0;
+          queued_[n] = false;
+        },
+        katana::steal(), katana::loopname("MaxFlow-Initialize"));
+    if (negative.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "capacities must not be negative");
+    }
+
+    // Saturate the edges out of the source
+    katana::InsertBag<GNode> active;
+    for (auto e : graph_.OutEdges(source_)) {
+      GNode dst = graph_.OutEdgeDst(e);
+      auto idx = graph_.GetEdgePropertyIndexFromOutEdge(e);
+      if (dst == source_ || capacity_[idx] == 0) {
+        continue;
+      }
+      flow_[idx] = capacity_[idx];
+      if (excess_[dst].fetch_add(capacity_[idx]) == 0 && dst != sink_) {
+        queued_[dst] = true;
+        active.push(dst);
+      }
+    }
+
+    GlobalRelabel();
+
+    katana::InsertBag<GNode> pending;
+    katana::InsertBag<GNode>* current = &active;
+    katana::InsertBag<GNode>* next = &pending;
+    uint32_t global_relabels = 1;
+    while (!current->empty()) {
+      relabel_requested_ = false;
+      relabels_ = 0;
+      katana::for_each(
+          katana::iterate(*current),
+          [&](const GNode& n, auto& ctx) { Discharge(n, ctx, next); },
+          katana::disable_conflict_detection(),
+          katana::loopname("MaxFlow-Discharge"));
+      current->clear();
+      std::swap(current, next);
+      if (!current->empty()) {
+        GlobalRelabel();
+        ++global_relabels;
+      }
+    }
+
+    // Label the nodes that can still reach the sink for the cut
+    GlobalRelabel();
+    katana::ReportStatSingle("MaxFlow", "GlobalRelabels", global_relabels);
+    return katana::ResultSuccess();
+  }
+
+  /// Whether node is on the source side of the cut
+  bool InCut(GNode node) const { return height_[node] >= num_nodes_; }
+
+  Capacity Flow(PropertyIndex idx) const { return flow_[idx]; }
+
+private:
+  Capacity Residual(PropertyIndex idx, bool forward) const {
+    Capacity flow = flow_[idx].load(std::memory_order_relaxed);
+    return forward ? capacity_[idx] - flow : flow;
+  }
+
+  /// Push the excess of node to its lowest residual neighbor or relabel it
+  /// above that neighbor until the excess is gone, or until a global
+  /// relabeling is due, in which case node moves to \p pending
+  template <typename Context>
+  void Discharge(GNode node, Context& ctx, katana::InsertBag<GNode>* pending) {
+    while (true) {
+      if (relabel_requested_.load(std::memory_order_relaxed)) {
+        // node stays queued until the next round picks it up
+        pending->push(node);
+        return;
+      }
+      uint64_t excess = excess_[node].load();
+      if (excess == 0) {
+        break;
+      }
+
+      uint32_t lowest = kUnlabeled;
+      GNode lowest_neighbor = node;
+      PropertyIndex lowest_idx = 0;
+      bool lowest_forward = true;
+      ForEachNeighbor(graph_, node, [&](GNode v, PropertyIndex idx, bool fwd) {
+        if (v == node || Residual(idx, fwd) == 0) {
+          return;
+        }
+        uint32_t h = height_[v].load(std::memory_order_relaxed);
+        if (h < lowest) {
+          lowest = h;
+          lowest_neighbor = v;
+          lowest_idx = idx;
+          lowest_forward = fwd;
+        }
+      });
+      if (lowest == kUnlabeled) {
+        // Excess always has a residual path back to the source
+        KATANA_LOG_DEBUG_ASSERT(false);
+        break;
+      }
+
+      uint32_t height = height_[node].load(std::memory_order_relaxed);
+      if (height > lowest) {
+        Capacity delta = static_cast<Capacity>(std::min<uint64_t>(
+            excess, Residual(lowest_idx, lowest_forward)));
+        if (lowest_forward) {
+          flow_[lowest_idx].fetch_add(delta);
+        } else {
+          flow_[lowest_idx].fetch_sub(delta);
+        }
+        excess_[node].fetch_sub(delta);
+        if (excess_[lowest_neighbor].fetch_add(delta) == 0) {
+          Activate(lowest_neighbor, ctx);
+        }
+      } else {
+        Relabel(node, height, lowest + 1);
+      }
+    }
+
+    queued_[node] = false;
+    // A push may have raced with the check above
+    if (excess_[node].load() > 0) {
+      Activate(node, ctx);
+    }
+  }
+
+  template <typename Context>
+  void Activate(GNode node, Context& ctx) {
+    if (node == source_ || node == sink_) {
+      return;
+    }
+    if (!queued_[node].exchange(true)) {
+      ctx.push(node);
+    }
+  }
+
+  void Relabel(GNode node, uint32_t old_height, uint32_t new_height) {
+    height_[node].store(new_height, std::memory_order_relaxed);
+    if (old_height < num_nodes_ &&
+        height_count_[old_height].fetch_sub(1) == 1) {
+      // Gap: the nodes above old_height cannot reach the sink anymore
+      relabel_requested_ = true;
+    }
+    if (new_height < num_nodes_) {
+      height_count_[new_height].fetch_add(1);
+    }
+    if (relabels_.fetch_add(1, std::memory_order_relaxed) + 1 >=
+        relabel_budget_) {
+      relabel_requested_ = true;
+    }
+  }
+
+  /// Level synchronous breadth-first search over the reversed residual graph,
+  /// labeling the unlabeled nodes with their distance plus base_height
+  void LabelFrom(GNode start, uint32_t base_height) {
+    katana::InsertBag<GNode> frontiers[2];
+    katana::InsertBag<GNode>* frontier = &frontiers[0];
+    katana::InsertBag<GNode>* next = &frontiers[1];
+    frontier->push(start);
+    uint32_t height = base_height;
+    while (!frontier->empty()) {
+      ++height;
+      katana::do_all(
+          katana::iterate(*frontier),
+          [&](const GNode& n) {
+            ForEachNeighbor(
+                graph_, n, [&](GNode v, PropertyIndex idx, bool fwd) {
+                  // The arc from v to n is the opposite direction of fwd
+                  if (Residual(idx, !fwd) == 0) {
+                    return;
+                  }
+                  uint32_t expected = kUnlabeled;
+                  if (height_[v].compare_exchange_strong(expected, height)) {
+                    next->push(v);
+                  }
+                });
+          },
+          katana::steal(), katana::loopname("MaxFlow-Global-Relabel"));
+      frontier->clear();
+      std::swap(frontier, next);
+    }
+  }
+
+  /// Set every height to the distance to the sink in the residual graph, or
+  /// for nodes that cannot reach the sink, the number of nodes plus the
+  /// distance to the source
+  void GlobalRelabel() {
+    katana::ParallelSTL::fill(height_.begin(), height_.end(), kUnlabeled);
+    height_[sink_] = 0;
+    height_[source_] = num_nodes_;
+    LabelFrom(sink_, 0);
+    LabelFrom(source_, num_nodes_);
+
+    katana::ParallelSTL::fill(
+        height_count_.begin(), height_count_.end(), uint32_t{0});
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const GNode& n) {
+          uint32_t height = height_[n].load(std::memory_order_relaxed);
+          if (height == kUnlabeled) {
+            // Neither reaches the sink nor has flow back to the source, so it
+            // never gets any excess
+            height_[n] = 2 * num_nodes_;
+          } else if (height < num_nodes_) {
+            height_count_[height].fetch_add(1);
+          }
+        },
+        katana::loopname("MaxFlow-Count-Heights"));
+  }
+
+  const Graph<Capacity>& graph_;
+  GNode source_;
+  GNode sink_;
+  uint32_t num_nodes_;
+  uint64_t relabel_budget_;
+
+  katana::NUMAArray<Capacity> capacity_;
+  katana::NUMAArray<std::atomic<Capacity>> flow_;
+  katana::NUMAArray<std::atomic<uint64_t>> excess_;
+  katana::NUMAArray<std::atomic<uint32_t>> height_;
+  /// The number of nodes of each height below the number of nodes
+  katana::NUMAArray<std::atomic<uint32_t>> height_count_;
+  /// Whether a node is on the worklist or being discharged
+  katana::NUMAArray<std::atomic<bool>> queued_;
+  std::atomic<uint64_t> relabels_{0};
+  std::atomic<bool> relabel_requested_{false};
+};
+
+template <typename Capacity>
+katana::Result<void>
+Run(katana::PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_flow_property_name,
+    const std::string& output_cut_property_name, katana::TxnContext* txn_ctx,
+    const MaxFlowPlan& plan) {
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<EdgeFlow<Capacity>>>(
+      txn_ctx, {output_flow_property_name}));
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeInCut>>(
+      txn_ctx, {output_cut_property_name}));
+
+  auto graph = KATANA_CHECKED(Graph<Capacity>::Make(
+      pg, {output_cut_property_name},
+      {capacity_property_name, output_flow_property_name}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("MaxFlow");
+
+  exec_time.start();
+  PushRelabel<Capacity> algo(graph, source, sink, plan);
+  KATANA_CHECKED(algo.Run());
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.template GetData<NodeInCut>(n) = algo.InCut(n);
+        for (auto e : graph.OutEdges(n)) {
+          graph.template GetEdgeData<EdgeFlow<Capacity>>(e) =
+              algo.Flow(graph.GetEdgePropertyIndexFromOutEdge(e));
+        }
+      },
+      katana::steal(), katana::loopname("MaxFlow-Write-Output"));
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+template <typename Capacity>
+katana::Result<void>
+AssertValid(
+    katana::PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& capacity_property_name,
+    const std::string& flow_property_name,
+    const std::string& cut_property_name) {
+  auto graph = KATANA_CHECKED(Graph<Capacity>::Make(
+      pg, {cut_property_name}, {capacity_property_name, flow_property_name}));
+
+  if (!graph.template GetData<NodeInCut>(source) ||
+      graph.template GetData<NodeInCut>(sink)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the cut does not separate source and sink");
+  }
+
+  // The flow into a node wraps around for unsigned types, but the difference
+  // with the flow out comes out right
+  katana::NUMAArray<std::atomic<Capacity>> net_flow;
+  net_flow.allocateBlocked(graph.NumNodes());
+  katana::ParallelSTL::fill(net_flow.begin(), net_flow.end(), Capacity{0});
+
+  katana::GReduceLogicalOr bad_edge;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        bool n_in_cut = graph.template GetData<NodeInCut>(n);
+        for (auto e : graph.OutEdges(n)) {
+          Capacity flow = graph.template GetEdgeData<EdgeFlow<Capacity>>(e);
+          Capacity capacity =
+              graph.template GetEdgeData<EdgeCapacity<Capacity>>(e);
+          if (IsNegative(flow) || flow > capacity) {
+            bad_edge.update(true);
+          }
+          GNode dst = graph.OutEdgeDst(e);
+          bool dst_in_cut = graph.template GetData<NodeInCut>(dst);
+          if (n_in_cut && !dst_in_cut && flow != capacity) {
+            bad_edge.update(true);
+          }
+          if (!n_in_cut && dst_in_cut && flow != 0) {
+            bad_edge.update(true);
+          }
+          net_flow[n].fetch_sub(flow);
+          net_flow[dst].fetch_add(flow);
+        }
+      },
+      katana::steal(), katana::loopname("MaxFlow-Validate"));
+
+  katana::GReduceLogicalOr bad_node;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (n != source && n != sink && net_flow[n] != 0) {
+          bad_node.update(true);
+        }
+      },
+      katana::loopname("MaxFlow-Validate-Conservation"));
+
+  if (bad_edge.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "an edge is over capacity or crosses the cut with the wrong flow");
+  }
+  if (bad_node.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "flow is not conserved");
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Capacity>
+katana::Result<MaxFlowStatistics>
+ComputeStatistics(
+    katana::PropertyGraph* pg, size_t source,
+    const std::string& flow_property_name,
+    const std::string& cut_property_name) {
+  using FlowGraph = katana::TypedPropertyGraph<
+      std::tuple<NodeInCut>, std::tuple<EdgeFlow<Capacity>>>;
+  auto graph = KATANA_CHECKED(
+      FlowGraph::Make(pg, {cut_property_name}, {flow_property_name}));
+
+  katana::GAccumulator<uint64_t> source_side_size;
+  katana::GAccumulator<uint64_t> cut_edges;
+  katana::GAccumulator<uint64_t> flow_out;
+  katana::GAccumulator<uint64_t> flow_in;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        bool n_in_cut = graph.template GetData<NodeInCut>(n);
+        source_side_size += n_in_cut;
+        for (auto e : graph.OutEdges(n)) {
+          GNode dst = graph.OutEdgeDst(e);
+          Capacity flow = graph.template GetEdgeData<EdgeFlow<Capacity>>(e);
+          if (n == source) {
+            flow_out += flow;
+          }
+          if (dst == source) {
+            flow_in += flow;
+          }
+          if (n_in_cut && !graph.template GetData<NodeInCut>(dst)) {
+            cut_edges += 1;
+          }
+        }
+      },
+      katana::loopname("MaxFlow-Statistics"), katana::no_stats());
+
+  return MaxFlowStatistics{
+      flow_out.reduce() - flow_in.reduce(), source_side_size.reduce(),
+      cut_edges.reduce()};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MaxFlow(
+    katana::PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_flow_property_name,
+    const std::string& output_cut_property_name, katana::TxnContext* txn_ctx,
+    MaxFlowPlan plan) {
+  if (source >= pg->NumNodes() || sink >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source or sink is not a node");
+  }
+  if (source == sink) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source and sink are the same");
+  }
+  if (plan.global_relabel_interval() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "global relabel interval must be positive");
+  }
+  if (plan.algorithm() != MaxFlowPlan::kPushRelabel) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(capacity_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return Run<uint32_t>(
+        pg, source, sink, capacity_property_name, output_flow_property_name,
+        output_cut_property_name, txn_ctx, plan);
+  case arrow::Int32Type::type_id:
+    return Run<int32_t>(
+        pg, source, sink, capacity_property_name, output_flow_property_name,
+        output_cut_property_name, txn_ctx, plan);
+  case arrow::UInt64Type::type_id:
+    return Run<uint64_t>(
+        pg, source, sink, capacity_property_name, output_flow_property_name,
+        output_cut_property_name, txn_ctx, plan);
+  case arrow::Int64Type::type_id:
+    return Run<int64_t>(
+        pg, source, sink, capacity_property_name, output_flow_property_name,
+        output_cut_property_name, txn_ctx, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(capacity_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::MaxFlowAssertValid(
+    katana::PropertyGraph* pg, size_t source, size_t sink,
+    const std::string& capacity_property_name,
+    const std::string& flow_property_name,
+    const std::string& cut_property_name) {
+  if (source >= pg->NumNodes() || sink >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source or sink is not a node");
+  }
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(capacity_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return AssertValid<uint32_t>(
+        pg, source, sink, capacity_property_name, flow_property_name,
+        cut_property_name);
+  case arrow::Int32Type::type_id:
+    return AssertValid<int32_t>(
+        pg, source, sink, capacity_property_name, flow_property_name,
+        cut_property_name);
+  case arrow::UInt64Type::type_id:
+    return AssertValid<uint64_t>(
+        pg, source, sink, capacity_property_name, flow_property_name,
+        cut_property_name);
+  case arrow::Int64Type::type_id:
+    return AssertValid<int64_t>(
+        pg, source, sink, capacity_property_name, flow_property_name,
+        cut_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(capacity_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+void
+katana::analytics::MaxFlowStatistics::Print(std::ostream& os) const {
+  os << "Flow value = " << flow_value << std::endl;
+  os << "Source side size = " << source_side_size << std::endl;
+  os << "Cut edges = " << cut_edges << std::endl;
+}
+
+katana::Result<MaxFlowStatistics>
+katana::analytics::MaxFlowStatistics::Compute(
+    katana::PropertyGraph* pg, size_t source,
+    const std::string& flow_property_name,
+    const std::string& cut_property_name) {
+  if (source >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source is not a node");
+  }
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(flow_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return ComputeStatistics<uint32_t>(
+        pg, source, flow_property_name, cut_property_name);
+  case arrow::Int32Type::type_id:
+    return ComputeStatistics<int32_t>(
+        pg, source, flow_property_name, cut_property_name);
+  case arrow::UInt64Type::type_id:
+    return ComputeStatistics<uint64_t>(
+        pg, source, flow_property_name, cut_property_name);
+  case arrow::Int64Type::type_id:
+    return ComputeStatistics<int64_t>(
+        pg, source, flow_property_name, cut_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(flow_property_name))
+            ->type()
+            ->ToString());
+  }
+}
@@ -0,0 +1,470 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DisjointSets.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+template <typename Weight>
+struct EdgeWeight : public katana::PODProperty<Weight> {};
+struct EdgeInForest : public katana::PODProperty<uint8_t> {};
+
+template <typename Weight>
+using Graph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<EdgeWeight<Weight>, EdgeInForest>>;
+
+constexpr uint64_t kNoEdge = std::numeric_limits<uint64_t>::max();
+
+/// An edge from src to a larger dst with its weight and its id in the graph
+template <typename Weight>
+struct WeightedEdge {
+  Node src;
+  Node dst;
+  Weight weight;
+  Edge id;
+
+  /// The order in which edges join the forest. Breaking ties by id makes the
+  /// order strict, so there is only one minimum spanning forest.
+  bool operator<(const WeightedEdge& other) const {
+    return weight < other.weight || (weight == other.weight && id < other.id);
+  }
+};
+
+template <typename Weight>
+using EdgeList = katana::NUMAArray<WeightedEdge<Weight>>;
+
+/// Gather the edges from smaller to larger node ids, which for a symmetric
+/// graph is every edge once
+template <typename Weight>
+EdgeList<Weight>
+CollectEdges(const Graph<Weight>& graph) {
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateBlocked(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        uint64_t count = 0;
+        for (auto e : graph.OutEdges(n)) {
+          count += graph.OutEdgeDst(e) > n;
+        }
+        offsets[n] = count;
+      },
+      katana::steal(), katana::loopname("MinimumSpanningForest-Count-Edges"));
+  katana::ParallelSTL::partial_sum(
+      offsets.begin(), offsets.end(), offsets.begin());
+
+  EdgeList<Weight> edges;
+  edges.allocateBlocked(graph.NumNodes() == 0 ? 0 : offsets.back());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) {
+        uint64_t next = n == 0 ? 0 : offsets[n - 1];
+        for (auto e : graph.OutEdges(n)) {
+          Node dst = graph.OutEdgeDst(e);
+          if (dst > n) {
+            edges[next++] = {
+                n, dst, graph.template GetEdgeData<EdgeWeight<Weight>>(e), e};
+          }
+        }
+      },
+      katana::steal(), katana::loopname("MinimumSpanningForest-Collect-Edges"));
+  return edges;
+}
+
+/// Parallel Boruvka. Every round, each tree picks its lightest edge to
+/// another tree and the trees are merged along the picked edges. The edges
+/// within the merged trees are then dropped from the edge list, so later
+/// rounds work on the edges of the contracted graph only.
+template <typename Weight>
+void
+Boruvka(
+    EdgeList<Weight>* edges, uint64_t num_nodes,
+    katana::InsertBag<Edge>* forest) {
+  // The root of the tree of each node
+  katana::NUMAArray<Node> trees;
+  // The tree each root is merged into, while the merged trees are linked up
+  katana::NUMAArray<Node> parents;
+  katana::NUMAArray<Node> next_parents;
+  // The index of the lightest edge leaving each root
+  katana::NUMAArray<std::atomic<uint64_t>> lightest;
+  trees.allocateBlocked(num_nodes);
+  parents.allocateBlocked(num_nodes);
+  next_parents.allocateBlocked(num_nodes);
+  lightest.allocateBlocked(num_nodes);
+  katana::ParallelSTL::iota(trees.begin(), trees.end(), Node{0});
+  katana::ParallelSTL::fill(lightest.begin(), lightest.end(), kNoEdge);
+
+  auto propose = [&](Node tree, uint64_t i) {
+    uint64_t current = lightest[tree].load(std::memory_order_relaxed);
+    while ((current == kNoEdge || (*edges)[i] < (*edges)[current]) &&
+           !lightest[tree].compare_exchange_weak(
+               current, i, std::memory_order_relaxed)) {
+    }
+  };
+
+  uint64_t num_live = edges->size();
+  uint32_t rounds = 0;
+  while (num_live > 0) {
+    ++rounds;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_live),
+        [&](uint64_t i) {
+          const WeightedEdge<Weight>& edge = (*edges)[i];
+          propose(trees[edge.src], i);
+          propose(trees[edge.dst], i);
+        },
+        katana::steal(),
+        katana::loopname("MinimumSpanningForest-Find-Lightest"));
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](Node t) {
+          parents[t] = t;
+          uint64_t i = lightest[t].load(std::memory_order_relaxed);
+          if (trees[t] != t || i == kNoEdge) {
+            return;
+          }
+          Node src_tree = trees[(*edges)[i].src];
+          parents[t] = src_tree == t ? trees[(*edges)[i].dst] : src_tree;
+        },
+        katana::loopname("MinimumSpanningForest-Hook"));
+
+    // Two trees that picked each other picked the same edge because the
+    // order is strict. The smaller one stays a root and the other one adds
+    // the edge to the forest; every other pick is a new forest edge.
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](Node t) {
+          uint64_t i = lightest[t].load(std::memory_order_relaxed);
+          lightest[t].store(kNoEdge, std::memory_order_relaxed);
+          Node parent = parents[t];
+          if (parent == t || (parents[parent] == t && t < parent)) {
+            next_parents[t] = t;
+            return;
+          }
+          next_parents[t] = parent;
+          forest->push((*edges)[i].id);
+        },
+        katana::loopname("MinimumSpanningForest-Break-Cycles"));
+
+    // Pointer jumping until every root points to the root of its merged tree
+    katana::NUMAArray<Node>* roots = &next_parents;
+    katana::NUMAArray<Node>* jumped = &parents;
+    bool changed = true;
+    while (changed) {
+      katana::GReduceLogicalOr any_changed;
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes),
+          [&](Node t) {
+            Node parent = (*roots)[t];
+            Node grandparent = (*roots)[parent];
+            (*jumped)[t] = grandparent;
+            if (grandparent != parent) {
+              any_changed.update(true);
+            }
+          },
+          katana::loopname("MinimumSpanningForest-Jump"));
+      changed = any_changed.reduce();
+      std::swap(roots, jumped);
+    }
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](Node n) { trees[n] = (*roots)[trees[n]]; },
+        katana::loopname("MinimumSpanningForest-Relabel"));
+
+    auto live_end = katana::ParallelSTL::partition(
+        edges->begin(), edges->begin() + num_live,
+        [&](const WeightedEdge<Weight>& edge) {
+          return trees[edge.src] != trees[edge.dst];
+        });
+    num_live = live_end - edges->begin();
+  }
+
+  katana::ReportStatSingle("MinimumSpanningForest", "Rounds", rounds);
+}
+
+/// Filter-Kruskal. Kruskal's algorithm only needs the heavy edges that are
+/// not already within a tree once the light edges are done, so the edges are
+/// split around a pivot and the heavy ones filtered before they are sorted.
+template <typename Weight>
+class FilterKruskal {
+public:
+  using Iterator = typename EdgeList<Weight>::iterator;
+
+  FilterKruskal(
+      uint64_t num_nodes, uint64_t base_case_size,
+      katana::InsertBag<Edge>* forest)
+      : trees_(num_nodes), base_case_size_(base_case_size), forest_(forest) {}
+
+  void Run(Iterator begin, Iterator end) {
+    if (static_cast<uint64_t>(end - begin) <= base_case_size_) {
+      Kruskal(begin, end);
+      return;
+    }
+
+    WeightedEdge<Weight> pivot = std::max(
+        std::min(begin[0], begin[(end - begin) / 2]),
+        std::min(std::max(begin[0], begin[(end - begin) / 2]), end[-1]));
+    Iterator middle = katana::ParallelSTL::partition(
+        begin, end,
+        [pivot](const WeightedEdge<Weight>& edge) { return !(pivot < edge); });
+    if (middle == end) {
+      Kruskal(begin, end);
+      return;
+    }
+
+    Run(begin, middle);
+    Iterator heavy_end = katana::ParallelSTL::partition(
+        middle, end, [this](const WeightedEdge<Weight>& edge) {
+          return trees_.Find(edge.src) != trees_.Find(edge.dst);
+        });
+    Run(middle, heavy_end);
+  }
+
+private:
+  void Kruskal(Iterator begin, Iterator end) {
+    katana::ParallelSTL::sort(begin, end);
+    for (Iterator it = begin; it != end; ++it) {
+      if (trees_.Unite(it->src, it->dst)) {
+        forest_->push(it->id);
+      }
+    }
+  }
+
+  katana::DisjointSets trees_;
+  uint64_t base_case_size_;
+  katana::InsertBag<Edge>* forest_;
+};
+
+template <typename Weight>
+katana::Result<void>
+Run(katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    const MinimumSpanningForestPlan& plan) {
+  KATANA_CHECKED(pg->ConstructEdgeProperties<std::tuple<EdgeInForest>>(
+      txn_ctx, {output_property_name}));
+
+  auto graph = KATANA_CHECKED(Graph<Weight>::Make(
+      pg, {}, {edge_weight_property_name, output_property_name}));
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("MinimumSpanningForest");
+
+  exec_time.start();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.NumEdges()),
+      [&](Edge e) { graph.template GetEdgeData<EdgeInForest>(e) = 0; },
+      katana::no_stats());
+
+  EdgeList<Weight> edges = CollectEdges(graph);
+  katana::InsertBag<Edge> forest;
+  switch (plan.algorithm()) {
+  case MinimumSpanningForestPlan::kBoruvka:
+    Boruvka(&edges, graph.NumNodes(), &forest);
+    break;
+  case MinimumSpanningForestPlan::kFilterKruskal:
+    FilterKruskal<Weight>(graph.NumNodes(), plan.base_case_size(), &forest)
+        .Run(edges.begin(), edges.end());
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  katana::do_all(
+      katana::iterate(forest),
+      [&](Edge e) { graph.template GetEdgeData<EdgeInForest>(e) = 1; },
+      katana::no_stats());
+  exec_time.stop();
+  page_alloc.Report();
+
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<void>
+AssertValid(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(
+      Graph<Weight>::Make(pg, {}, {edge_weight_property_name, property_name}));
+
+  // The forest is unique, so it has to be the one Kruskal's algorithm finds
+  EdgeList<Weight> edges = CollectEdges(graph);
+  katana::InsertBag<Edge> forest;
+  FilterKruskal<Weight>(graph.NumNodes(), edges.size(), &forest)
+      .Run(edges.begin(), edges.end());
+
+  katana::NUMAArray<uint8_t> expected;
+  expected.allocateBlocked(graph.NumEdges());
+  katana::ParallelSTL::fill(expected.begin(), expected.end(), uint8_t{0});
+  katana::do_all(
+      katana::iterate(forest), [&](Edge e) { expected[e] = 1; },
+      katana::no_stats());
+
+  katana::GReduceLogicalOr mismatch;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.NumEdges()),
+      [&](Edge e) {
+        if (graph.template GetEdgeData<EdgeInForest>(e) != expected[e]) {
+          mismatch.update(true);
+        }
+      },
+      katana::no_stats());
+  if (mismatch.reduce()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<MinimumSpanningForestStatistics>
+ComputeStatistics(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto graph = KATANA_CHECKED(
+      Graph<Weight>::Make(pg, {}, {edge_weight_property_name, property_name}));
+
+  katana::GAccumulator<uint64_t> num_forest_edges;
+  katana::GAccumulator<double> total_weight;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.NumEdges()),
+      [&](Edge e) {
+        if (graph.template GetEdgeData<EdgeInForest>(e)) {
+          num_forest_edges += 1;
+          total_weight += graph.template GetEdgeData<EdgeWeight<Weight>>(e);
+        }
+      },
+      katana::loopname("MinimumSpanningForest-Statistics"), katana::no_stats());
+
+  // Every edge of a forest joins two trees
+  uint64_t num_edges = num_forest_edges.reduce();
+  return MinimumSpanningForestStatistics{
+      graph.NumNodes() - num_edges, num_edges, total_weight.reduce()};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MinimumSpanningForestPlan plan) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return Run<uint32_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx, plan);
+  case arrow::Int32Type::type_id:
+    return Run<int32_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx, plan);
+  case arrow::UInt64Type::type_id:
+    return Run<uint64_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx, plan);
+  case arrow::Int64Type::type_id:
+    return Run<int64_t>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx, plan);
+  case arrow::FloatType::type_id:
+    return Run<float>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx, plan);
+  case arrow::DoubleType::type_id:
+    return Run<double>(
+        pg, edge_weight_property_name, output_property_name, txn_ctx, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return AssertValid<uint32_t>(pg, edge_weight_property_name, property_name);
+  case arrow::Int32Type::type_id:
+    return AssertValid<int32_t>(pg, edge_weight_property_name, property_name);
+  case arrow::UInt64Type::type_id:
+    return AssertValid<uint64_t>(pg, edge_weight_property_name, property_name);
+  case arrow::Int64Type::type_id:
+    return AssertValid<int64_t>(pg, edge_weight_property_name, property_name);
+  case arrow::FloatType::type_id:
+    return AssertValid<float>(pg, edge_weight_property_name, property_name);
+  case arrow::DoubleType::type_id:
+    return AssertValid<double>(pg, edge_weight_property_name, property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+void
+katana::analytics::MinimumSpanningForestStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of trees = " << num_trees << std::endl;
+  os << "Number of forest edges = " << num_forest_edges << std::endl;
+  os << "Total weight = " << total_weight << std::endl;
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+katana::analytics::MinimumSpanningForestStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return ComputeStatistics<uint32_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::Int32Type::type_id:
+    return ComputeStatistics<int32_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::UInt64Type::type_id:
+    return ComputeStatistics<uint64_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::Int64Type::type_id:
+    return ComputeStatistics<int64_t>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::FloatType::type_id:
+    return ComputeStatistics<float>(
+        pg, edge_weight_property_name, property_name);
+  case arrow::DoubleType::type_id:
+    return ComputeStatistics<double>(
+        pg, edge_weight_property_name, property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
@@ -0,0 +1,339 @@
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "katana/analytics/Sampling.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = NeighborSampler::Node;
+using Edge = katana::GraphTopologyTypes::Edge;
+using TypedFanout = NeighborSampler::TypedFanout;
+
+constexpr uint32_t kNotSampled = std::numeric_limits<uint32_t>::max();
+
+/// Call fn on min(k, n) distinct offsets in [0, n), chosen uniformly with the
+/// draws of key by Floyd's algorithm, in increasing order
+template <typename Fn>
+void
+ChooseOffsets(
+    uint64_t n, uint64_t k, uint64_t key, std::vector<uint64_t>* chosen,
+    const Fn& fn) {
+  if (n <= k) {
+    for (uint64_t o = 0; o < n; ++o) {
+      fn(o);
+    }
+    return;
+  }
+
+  chosen->clear();
+  for (uint64_t j = n - k; j < n; ++j) {
+    uint64_t t = SampleBits(key, j) % (j + 1);
+    auto it = std::lower_bound(chosen->begin(), chosen->end(), t);
+    if (it != chosen->end() && *it == t) {
+      // j is larger than every offset chosen so far
+      chosen->emplace_back(j);
+    } else {
+      chosen->insert(it, t);
+    }
+  }
+  for (uint64_t o : *chosen) {
+    fn(o);
+  }
+}
+
+katana::Result<std::vector<std::shared_ptr<arrow::Array>>>
+FeatureColumns(
+    katana::PropertyGraph* pg, const std::vector<std::string>& names) {
+  std::vector<std::shared_ptr<arrow::Array>> features;
+  for (const auto& name : names) {
+    auto column = KATANA_CHECKED(pg->GetNodeProperty(name));
+    if (column->num_chunks() != 1) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "feature property {} has {} chunks, expected 1", name,
+          column->num_chunks());
+    }
+    const auto* type =
+        dynamic_cast<const arrow::FixedWidthType*>(column->type().get());
+    if (!type || type->bit_width() % 8 != 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError,
+          "feature property {} of type {} does not have a fixed byte width",
+          name, column->type()->ToString());
+    }
+    features.emplace_back(column->chunk(0));
+  }
+  return features;
+}
+
+/// Copy the rows of nodes out of every feature column with one memcpy per
+/// row. Validity bitmaps are not copied.
+template <typename View>
+katana::Result<std::shared_ptr<arrow::Table>>
+GatherFeatures(
+    const View& view, const std::vector<std::string>& names,
+    const std::vector<std::shared_ptr<arrow::Array>>& features,
+    const katana::NUMAArray<uint32_t>& nodes) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (size_t i = 0; i < features.size(); ++i) {
+    const auto& array = features[i];
+    uint64_t width =
+        static_cast<const arrow::FixedWidthType&>(*array->type()).bit_width() /
+        8;
+    std::shared_ptr<arrow::Buffer> buffer =
+        KATANA_CHECKED(arrow::AllocateBuffer(nodes.size() * width));
+    const uint8_t* values =
+        array->data()->buffers[1]->data() + array->offset() * width;
+    uint8_t* out = buffer->mutable_data();
+
+    katana::do_all(
+        katana::iterate(uint64_t(0), uint64_t(nodes.size())),
+        [&](uint64_t n) {
+          std::memcpy(
+              out + n * width,
+              values + view.GetNodePropertyIndex(nodes[n]) * width, width);
+        },
+        katana::loopname("GatherFeatures"));
+
+    columns.emplace_back(arrow::MakeArray(arrow::ArrayData::Make(
+        array->type(), nodes.size(), {nullptr, std::move(buffer)}, 0)));
+    fields.emplace_back(arrow::field(names[i], array->type()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, nodes.size());
+}
+
+}  // namespace
+
+katana::analytics::NeighborSampler::NeighborSampler(
+    katana::PropertyGraph* pg,
+    std::vector<std::vector<TypedFanout>>&& typed_fanouts, bool typed,
+    Direction direction, std::vector<std::shared_ptr<arrow::Array>>&& features,
+    std::vector<std::string>&& feature_names)
+    : pg_(pg),
+      typed_fanouts_(std::move(typed_fanouts)),
+      typed_(typed),
+      direction_(direction),
+      features_(std::move(features)),
+      feature_names_(std::move(feature_names)) {
+  position_.allocateBlocked(pg_->NumNodes());
+  katana::ParallelSTL::fill(position_.begin(), position_.end(), kNotSampled);
+}
+
+katana::Result<std::unique_ptr<NeighborSampler>>
+katana::analytics::NeighborSampler::Make(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& fanouts,
+    const std::vector<std::string>& feature_properties, Direction direction) {
+  std::vector<std::vector<TypedFanout>> typed_fanouts;
+  for (uint32_t fanout : fanouts) {
+    typed_fanouts.push_back({TypedFanout{katana::kUnknownEntityType, fanout}});
+  }
+  if (typed_fanouts.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a sampler needs the fanout of at least one hop");
+  }
+
+  auto features = KATANA_CHECKED(FeatureColumns(pg, feature_properties));
+  return std::unique_ptr<NeighborSampler>(new NeighborSampler(
+      pg, std::move(typed_fanouts), false, direction, std::move(features),
+      std::vector<std::string>(feature_properties)));
+}
+
+katana::Result<std::unique_ptr<NeighborSampler>>
+katana::analytics::NeighborSampler::Make(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<TypedFanout>>& typed_fanouts,
+    const std::vector<std::string>& feature_properties, Direction direction) {
+  if (typed_fanouts.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a sampler needs the fanout of at least one hop");
+  }
+  for (const auto& hop : typed_fanouts) {
+    for (const auto& fanout : hop) {
+      if (!pg->HasEdgeEntityType(fanout.edge_type)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "edge type {} does not exist",
+            fanout.edge_type);
+      }
+    }
+  }
+
+  auto features = KATANA_CHECKED(FeatureColumns(pg, feature_properties));
+  return std::unique_ptr<NeighborSampler>(new NeighborSampler(
+      pg, std::vector<std::vector<TypedFanout>>(typed_fanouts), true,
+      direction, std::move(features),
+      std::vector<std::string>(feature_properties)));
+}
+
+katana::Result<NeighborSample>
+katana::analytics::NeighborSampler::Sample(
+    const std::vector<Node>& seeds, uint32_t random_seed) {
+  if (typed_) {
+    return SampleWithView(
+        pg_->BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>(),
+        seeds, random_seed);
+  }
+  return SampleWithView(
+      pg_->BuildView<katana::PropertyGraphViews::BiDirectional>(), seeds,
+      random_seed);
+}
+
+template <typename View>
+katana::Result<NeighborSample>
+katana::analytics::NeighborSampler::SampleWithView(
+    const View& view, const std::vector<Node>& seeds, uint32_t random_seed) {
+  constexpr bool kTyped =
+      std::is_same_v<View, katana::PropertyGraphViews::EdgeTypeAwareBiDir>;
+  const bool in = direction_ == kInEdges;
+
+  // The edges of node n that fanout samples from, as a range of edge ids
+  auto edge_range = [&](Node n, const TypedFanout& fanout) {
+    auto span = [](const auto& edges) {
+      return std::make_pair(Edge(*edges.begin()), Edge(*edges.end()));
+    };
+    if constexpr (kTyped) {
+      if (!view.DoesEdgeTypeExist(fanout.edge_type)) {
+        return std::make_pair(Edge(0), Edge(0));
+      }
+      return in ? span(view.InEdges(n, fanout.edge_type))
+                : span(view.OutEdges(n, fanout.edge_type));
+    } else {
+      return in ? span(view.InEdges(n)) : span(view.OutEdges(n));
+    }
+  };
+
+  // The first source nodes of a block are its destination nodes, which
+  // position_ already holds for every hop after the first
+  SampledBlock seed_block;
+  seed_block.src_nodes.allocateBlocked(seeds.size());
+  for (size_t i = 0; i < seeds.size(); ++i) {
+    Node n = seeds[i];
+    if (n >= pg_->NumNodes() || position_[n] != kNotSampled) {
+      for (size_t j = 0; j < i; ++j) {
+        position_[seeds[j]] = kNotSampled;
+      }
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "seed {} is not a node or is repeated", n);
+    }
+    position_[n] = i;
+    seed_block.src_nodes[i] = n;
+  }
+
+  uint64_t key = SamplingKey(random_seed);
+  katana::PerThreadStorage<std::vector<uint64_t>> chosen;
+
+  NeighborSample sample;
+  sample.blocks.reserve(num_hops());
+  const katana::NUMAArray<uint32_t>* dst_nodes = &seed_block.src_nodes;
+  for (uint32_t hop = 0; hop < num_hops(); ++hop) {
+    const auto& fanouts = typed_fanouts_[hop];
+    uint64_t hop_key = SampleBits(key, hop);
+    uint64_t num_dst_nodes = dst_nodes->size();
+
+    SampledBlock block;
+    block.num_dst_nodes = num_dst_nodes;
+    block.indptr.allocateBlocked(num_dst_nodes + 1);
+    block.indptr[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t(0), num_dst_nodes),
+        [&](uint64_t i) {
+          uint64_t degree = 0;
+          for (const auto& fanout : fanouts) {
+            auto [begin, end] = edge_range((*dst_nodes)[i], fanout);
+            degree += std::min<uint64_t>(end - begin, fanout.fanout);
+          }
+          block.indptr[i + 1] = degree;
+        },
+        katana::steal(), katana::loopname("CountSampledEdges"));
+    katana::ParallelSTL::partial_sum(
+        block.indptr.begin(), block.indptr.end(), block.indptr.begin());
+    uint64_t num_edges = block.indptr[num_dst_nodes];
+
+    katana::NUMAArray<uint32_t> neighbors;
+    neighbors.allocateBlocked(num_edges);
+    block.edge_ids.allocateBlocked(num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t(0), num_dst_nodes),
+        [&](uint64_t i) {
+          Node n = (*dst_nodes)[i];
+          uint64_t node_key = SampleBits(hop_key, n);
+          uint64_t offset = block.indptr[i];
+          for (size_t f = 0; f < fanouts.size(); ++f) {
+            auto [first, last] = edge_range(n, fanouts[f]);
+            Edge begin = first;
+            ChooseOffsets(
+                last - first, fanouts[f].fanout, SampleBits(node_key, f),
+                chosen.getLocal(), [&](uint64_t o) {
+                  Edge e = begin + o;
+                  neighbors[offset] =
+                      in ? view.InEdgeSrc(e) : view.OutEdgeDst(e);
+                  block.edge_ids[offset] =
+                      in ? view.GetEdgePropertyIndexFromInEdge(e)
+                         : view.GetEdgePropertyIndexFromOutEdge(e);
+                  ++offset;
+                });
+          }
+        },
+        katana::steal(), katana::loopname("SampleEdges"));
+
+    // Number the neighbors that are not sources yet in order of their id,
+    // so that the sample does not depend on the schedule
+    katana::NUMAArray<uint32_t> fresh;
+    fresh.allocateBlocked(num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t(0), num_edges),
+        [&](uint64_t e) {
+          Node n = neighbors[e];
+          fresh[e] = position_[n] == kNotSampled ? n : kNotSampled;
+        },
+        katana::loopname("FindNewSources"));
+    katana::ParallelSTL::sort(fresh.begin(), fresh.end());
+    auto fresh_end = std::unique(
+        fresh.begin(),
+        std::lower_bound(fresh.begin(), fresh.end(), kNotSampled));
+    uint64_t num_fresh = fresh_end - fresh.begin();
+
+    block.src_nodes.allocateBlocked(num_dst_nodes + num_fresh);
+    katana::do_all(
+        katana::iterate(uint64_t(0), num_dst_nodes + num_fresh),
+        [&](uint64_t j) {
+          if (j < num_dst_nodes) {
+            block.src_nodes[j] = (*dst_nodes)[j];
+          } else {
+            block.src_nodes[j] = fresh[j - num_dst_nodes];
+            position_[block.src_nodes[j]] = j;
+          }
+        },
+        katana::loopname("NumberSources"));
+
+    block.src_indices.allocateBlocked(num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t(0), num_edges),
+        [&](uint64_t e) { block.src_indices[e] = position_[neighbors[e]]; },
+        katana::loopname("IndexSources"));
+
+    sample.blocks.emplace_back(std::move(block));
+    dst_nodes = &sample.blocks.back().src_nodes;
+  }
+
+  // The input nodes include every node that was given a position
+  katana::do_all(
+      katana::iterate(uint64_t(0), uint64_t(dst_nodes->size())),
+      [&](uint64_t j) { position_[(*dst_nodes)[j]] = kNotSampled; },
+      katana::loopname("ResetPositions"));
+
+  sample.node_features = KATANA_CHECKED(
+      GatherFeatures(view, feature_names_, features_, *dst_nodes));
+  std::reverse(sample.blocks.begin(), sample.blocks.end());
+  return sample;
+}
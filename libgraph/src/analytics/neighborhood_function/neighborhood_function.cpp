@@ -0,0 +1,301 @@
+#include "katana/analytics/neighborhood_function/neighborhood_function.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <arrow/api.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/Sampling.h"
+
+using katana::analytics::NeighborhoodFunctionPlan;
+using katana::analytics::NeighborhoodFunctionResult;
+
+namespace {
+
+using Graph = katana::PropertyGraphViews::Default;
+using Node = Graph::Node;
+
+/// HyperLogLog counters of kRegisters one-byte registers, one per node,
+/// with the register count known at compile time so that the register-wise
+/// maximum and comparison loops are unrolled and vectorized
+template <size_t kRegisters>
+class HyperAnf {
+public:
+  HyperAnf(const Graph& graph, uint32_t seed)
+      : graph_(graph), key_(katana::analytics::SamplingKey(seed)) {
+    const uint64_t num_nodes = graph_.NumNodes();
+    current_.allocateBlocked(num_nodes * kRegisters);
+    next_.allocateBlocked(num_nodes * kRegisters);
+    estimates_.allocateBlocked(num_nodes);
+    changed_.resize(num_nodes);
+    next_changed_.resize(num_nodes);
+    for (int r = 0; r <= kMaxRank; ++r) {
+      inverse_powers_[r] = std::ldexp(1.0, -r);
+    }
+  }
+
+  std::vector<double> operator()(uint32_t max_iterations) {
+    Init();
+    std::vector<double> neighborhood_function{SumEstimates()};
+    for (uint32_t round = 1; round <= max_iterations; ++round) {
+      if (!Round()) {
+        break;
+      }
+      neighborhood_function.push_back(SumEstimates());
+    }
+    katana::ReportStatSingle(
+        "NeighborhoodFunction", "Rounds", neighborhood_function.size() - 1);
+    return neighborhood_function;
+  }
+
+  double Estimate(Node n) const { return estimates_[n]; }
+
+private:
+  /// The largest rank of a hash: its trailing zeros plus one
+  static constexpr int kMaxRank = 65;
+
+  uint8_t* Counter(katana::NUMAArray<uint8_t>& counters, Node n) {
+    return counters.data() + uint64_t{n} * kRegisters;
+  }
+
+  /// The HyperLogLog estimate of the number of items counted by registers,
+  /// with linear counting for small numbers
+  double EstimateCounter(const uint8_t* registers) const {
+    constexpr double m = kRegisters;
+    double alpha = 0.7213 / (1 + 1.079 / m);
+    if (kRegisters == 16) {
+      alpha = 0.673;
+    } else if (kRegisters == 32) {
+      alpha = 0.697;
+    } else if (kRegisters == 64) {
+      alpha = 0.709;
+    }
+    double sum = 0;
+    size_t zeros = 0;
+    for (size_t j = 0; j < kRegisters; ++j) {
+      sum += inverse_powers_[registers[j]];
+      zeros += registers[j] == 0;
+    }
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros != 0) {
+      return m * std::log(m / zeros);
+    }
+    return estimate;
+  }
+
+  /// Count every node in its own counter
+  void Init() {
+    constexpr uint64_t kIndexMask = kRegisters - 1;
+    constexpr int kIndexBits = __builtin_ctzll(kRegisters);
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const Node& n) {
+          uint8_t* counter = Counter(current_, n);
+          std::fill_n(counter, kRegisters, 0);
+          uint64_t hash = katana::analytics::SampleBits(key_, n);
+          uint64_t rest = hash >> kIndexBits;
+          int rank =
+              rest == 0 ? 64 - kIndexBits + 1 : __builtin_ctzll(rest) + 1;
+          counter[hash & kIndexMask] = static_cast<uint8_t>(rank);
+          std::copy_n(counter, kRegisters, Counter(next_, n));
+          estimates_[n] = EstimateCounter(counter);
+        },
+        katana::no_stats(), katana::loopname("NeighborhoodFunction_Init"));
+    // every counter changed from empty
+    katana::do_all(
+        katana::iterate(graph_), [&](const Node& n) { changed_.set(n); },
+        katana::no_stats());
+  }
+
+  /// Merge into the counter of every node those of its out-neighbors that
+  /// changed in the previous round. Both buffers hold the counters of
+  /// unchanged nodes, so the counters of nodes that changed in the previous
+  /// round and not in this one are copied to keep them so.
+  ///
+  /// \returns true if any counter changed
+  bool Round() {
+    next_changed_.reset();
+    katana::GReduceLogicalOr any_changed;
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](const Node& n) {
+          const uint8_t* own = Counter(current_, n);
+          uint8_t* out = Counter(next_, n);
+          bool merged = false;
+          for (auto e : graph_.OutEdges(n)) {
+            Node dst = graph_.OutEdgeDst(e);
+            if (dst == n || !changed_.test(dst)) {
+              continue;
+            }
+            if (!merged) {
+              std::copy_n(own, kRegisters, out);
+              merged = true;
+            }
+            const uint8_t* neighbor = Counter(current_, dst);
+            for (size_t j = 0; j < kRegisters; ++j) {
+              out[j] = std::max(out[j], neighbor[j]);
+            }
+          }
+          if (merged) {
+            if (std::memcmp(out, own, kRegisters) != 0) {
+              next_changed_.set(n);
+              estimates_[n] = EstimateCounter(out);
+              any_changed.update(true);
+            }
+          } else if (changed_.test(n)) {
+            std::copy_n(own, kRegisters, out);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("NeighborhoodFunction_Round"));
+
+    std::swap(current_, next_);
+    std::swap(changed_, next_changed_);
+    return any_changed.reduce();
+  }
+
+  double SumEstimates() {
+    katana::GAccumulator<double> sum;
+    katana::do_all(
+        katana::iterate(graph_), [&](const Node& n) { sum += estimates_[n]; },
+        katana::no_stats());
+    return sum.reduce();
+  }
+
+  const Graph& graph_;
+  uint64_t key_;
+  katana::NUMAArray<uint8_t> current_;
+  katana::NUMAArray<uint8_t> next_;
+  katana::NUMAArray<double> estimates_;
+  /// The nodes whose counter in current_ changed in the last round
+  katana::DynamicBitset changed_;
+  katana::DynamicBitset next_changed_;
+  double inverse_powers_[kMaxRank + 1];
+};
+
+template <size_t kRegisters>
+katana::Result<NeighborhoodFunctionResult>
+Run(katana::PropertyGraph* pg, const Graph& graph,
+    const std::string& reach_property_name, katana::TxnContext* txn_ctx,
+    const NeighborhoodFunctionPlan& plan) {
+  katana::EnsurePreallocated(
+      2, graph.NumNodes() * (2 * kRegisters + sizeof(double)));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::StatTimer exec_time("NeighborhoodFunction", "NeighborhoodFunction");
+  exec_time.start();
+  HyperAnf<kRegisters> anf(graph, plan.seed());
+  NeighborhoodFunctionResult result;
+  result.neighborhood_function = anf(plan.max_iterations());
+  exec_time.stop();
+
+  if (reach_property_name.empty()) {
+    return result;
+  }
+  const uint64_t num_nodes = graph.NumNodes();
+  std::shared_ptr<arrow::Buffer> reach_buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(double)));
+  double* reach = reinterpret_cast<double*>(reach_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Node& n) { reach[n] = anf.Estimate(n); }, katana::no_stats());
+  auto array = std::make_shared<arrow::DoubleArray>(num_nodes, reach_buffer);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(reach_property_name, arrow::float64())}),
+      {array});
+  KATANA_CHECKED(pg->AddNodeProperties(table, txn_ctx));
+  return result;
+}
+
+}  // namespace
+
+katana::Result<NeighborhoodFunctionResult>
+katana::analytics::NeighborhoodFunction(
+    katana::PropertyGraph* pg, const std::string& reach_property_name,
+    katana::TxnContext* txn_ctx, NeighborhoodFunctionPlan plan) {
+  if (plan.algorithm() != NeighborhoodFunctionPlan::kHyperAnf) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+
+  Graph graph = pg->BuildView<Graph>();
+  switch (plan.log2_registers()) {
+  case 4:
+    return Run<16>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 5:
+    return Run<32>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 6:
+    return Run<64>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 7:
+    return Run<128>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 8:
+    return Run<256>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 9:
+    return Run<512>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 10:
+    return Run<1024>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 11:
+    return Run<2048>(pg, graph, reach_property_name, txn_ctx, plan);
+  case 12:
+    return Run<4096>(pg, graph, reach_property_name, txn_ctx, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "log2 of the registers per node must be from {} to {}, not {}",
+        NeighborhoodFunctionPlan::kMinLog2Registers,
+        NeighborhoodFunctionPlan::kMaxLog2Registers, plan.log2_registers());
+  }
+}
+
+double
+katana::analytics::NeighborhoodFunctionResult::EffectiveDiameter(
+    double fraction) const {
+  const std::vector<double>& nf = neighborhood_function;
+  if (nf.empty()) {
+    return 0;
+  }
+  // the estimates may decrease slightly from one distance to the next, so
+  // search for the first distance that reaches the target
+  double target = fraction * nf.back();
+  size_t t = 0;
+  while (t < nf.size() - 1 && nf[t] < target) {
+    ++t;
+  }
+  if (t == 0) {
+    return 0;
+  }
+  return (t - 1) + (target - nf[t - 1]) / (nf[t] - nf[t - 1]);
+}
+
+double
+katana::analytics::NeighborhoodFunctionResult::AverageDistance() const {
+  const std::vector<double>& nf = neighborhood_function;
+  if (nf.size() < 2 || nf.back() <= nf.front()) {
+    return 0;
+  }
+  double sum = 0;
+  for (size_t t = 1; t < nf.size(); ++t) {
+    sum += t * (nf[t] - nf[t - 1]);
+  }
+  return sum / (nf.back() - nf.front());
+}
+
+void
+katana::analytics::NeighborhoodFunctionResult::Print(std::ostream& os) const {
+  os << "Reachable pairs = "
+     << (neighborhood_function.empty() ? 0 : neighborhood_function.back())
+     << std::endl;
+  os << "Effective diameter = " << EffectiveDiameter() << std::endl;
+  os << "Average distance = " << AverageDistance() << std::endl;
+  os << "Diameter lower bound = " << diameter_lower_bound() << std::endl;
+  os << "Neighborhood function =";
+  for (double pairs : neighborhood_function) {
+    os << " " << pairs;
+  }
+  os << std::endl;
+}
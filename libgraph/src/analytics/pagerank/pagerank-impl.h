@@ -37,6 +37,15 @@ katana::Result<void> PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
 
+katana::Result<void> PagerankPullTopologicalInWindow(
+    katana::PropertyGraph* pg, const katana::analytics::TimeWindow& window,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+
+katana::Result<void> PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+
 katana::Result<void> PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
@@ -49,4 +58,10 @@ katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
 
+katana::Result<void> PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& added_edges,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+
 #endif
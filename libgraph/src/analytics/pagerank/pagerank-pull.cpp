@@ -17,9 +17,16 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include <arrow/type.h>
+#include <boost/iterator/counting_iterator.hpp>
+#include <unistd.h>
 
+#include "katana/Prefetch.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/IterationMetrics.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
 
@@ -42,10 +49,17 @@ using PagerankValueAndOutDegreeArray =
 using NodeData = std::tuple<NodeValue>;
 using EdgeData = std::tuple<>;
 
-using Graph = katana::TypedPropertyGraphView<
+using TransposedGraph = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::Transposed, NodeData, EdgeData>;
+using ReplicatedTransposedGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::ReplicatedTransposed, NodeData, EdgeData>;
+using ForwardGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+using TransposedTemporalGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::TransposedTemporal, NodeData, EdgeData>;
 
 //! Initialize nodes for the topological algorithm.
+template <typename Graph>
 katana::Result<void>
 InitNodeDataTopological(
     const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
@@ -62,6 +76,7 @@ InitNodeDataTopological(
 }
 
 //! Initialize nodes for the residual algorithm.
+template <typename Graph>
 katana::Result<void>
 InitNodeDataResidual(
     Graph* graph, DeltaArray* delta, ResidualArray* residual,
@@ -80,10 +95,32 @@ InitNodeDataResidual(
   return katana::ResultSuccess();
 }
 
+/// The out-edges of a node that the pull algorithms read
+struct AllOutEdges {
+  template <typename Graph>
+  auto operator()(const Graph& graph, typename Graph::Node n) const {
+    return graph.OutEdges(n);
+  }
+};
+
+/// The out-edges of a node of a temporal view stamped within a window
+struct OutEdgesInWindow {
+  katana::TemporalTopology::Timestamp begin;
+  katana::TemporalTopology::Timestamp end;
+
+  template <typename Graph>
+  auto operator()(const Graph& graph, typename Graph::Node n) const {
+    return graph.OutEdges(n, begin, end);
+  }
+};
+
 //! Computing outdegrees in the tranpose graph is equivalent to computing the
 //! indegrees in the original graph.
+template <typename Graph, typename EdgeRange = AllOutEdges>
 katana::Result<void>
-ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
+ComputeOutDeg(
+    const Graph& graph, PagerankValueAndOutDegreeArray* node_data,
+    const EdgeRange& edges = EdgeRange()) {
   using GNode = typename Graph::Node;
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
@@ -99,7 +136,7 @@ ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
   katana::do_all(
       katana::iterate(graph),
       [&](const GNode& src) {
-        for (auto nbr : graph.OutEdges(src)) {
+        for (auto nbr : edges(graph, src)) {
           auto dest = graph.OutEdgeDst(nbr);
           vec[dest].fetch_add(1ul);
         }
@@ -117,6 +154,7 @@ ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
   return katana::ResultSuccess();
 }
 
+template <typename Graph>
 katana::Result<void>
 ComputeOutDeg(const Graph& graph, NodeOutDegreeArray* node_data) {
   using GNode = typename Graph::Node;
@@ -160,6 +198,7 @@ ComputeOutDeg(const Graph& graph, NodeOutDegreeArray* node_data) {
  * the next pagerank.
  */
 //! [scalarreduction]
+template <typename Graph>
 katana::Result<void>
 ComputePRResidual(
     Graph* graph, DeltaArray* delta, ResidualArray* residual,
@@ -170,6 +209,7 @@ ComputePRResidual(
   using GNode = typename Graph::Node;
   unsigned int iterations = 0;
   katana::GAccumulator<unsigned int> accum;
+  katana::analytics::IterationReporter reporter("pagerank_pull_residual");
 
   while (true) {
     katana::do_all(
@@ -193,11 +233,16 @@ ComputePRResidual(
         },
         katana::loopname("PageRank_delta"));
 
+    // the deltas of the destinations are random reads
+    auto pipeline = katana::MakePrefetchPipeline(
+        graph->NumEdges(),
+        [&](uint64_t e) { return &(*delta)[graph->OutEdgeDst(e)]; });
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
           float sum = 0;
           for (auto nbr : graph->OutEdges(src)) {
+            pipeline.Ahead(nbr);
             auto dest = graph->OutEdgeDst(nbr);
             if ((*delta)[dest] > 0) {
               sum += (*delta)[dest];
@@ -211,10 +256,10 @@ ComputePRResidual(
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
         katana::loopname("PageRank"));
 
-#if DEBUG
-    std::cout << "iteration: " << iterations << "\n";
-#endif
     iterations++;
+    // the convergence is the number of nodes whose residual was applied
+    reporter.Report(
+        iterations, accum.reduce(), graph->size(), graph->NumEdges());
     if (iterations >= plan.max_iterations() || !accum.reduce()) {
       break;
     }
@@ -229,25 +274,43 @@ ComputePRResidual(
  * PageRank pull topological.
  * Always calculate the new pagerank for each iteration.
  */
+template <typename Graph, typename EdgeRange = AllOutEdges>
 katana::Result<void>
 ComputePRTopological(
     Graph* graph, katana::analytics::PagerankPlan plan,
-    PagerankValueAndOutDegreeArray* node_data) {
+    PagerankValueAndOutDegreeArray* node_data,
+    const EdgeRange& edges = EdgeRange()) {
   katana::StatTimer exec_time("PagerankPullTopological");
   exec_time.start();
 
   using GNode = typename Graph::Node;
   unsigned int iteration = 0;
-  katana::GAccumulator<float> accum;
+  // the sum decides when to stop, so it must not depend on the schedule
+  katana::GDeterministicAccumulator<float> accum;
+
+  katana::analytics::IterationReporter reporter("pagerank_pull_topological");
+  katana::analytics::Checkpointer checkpointer(
+      plan.checkpoint(), "pagerank_pull_topological");
+  if (auto state = KATANA_CHECKED(checkpointer.Resume())) {
+    KATANA_CHECKED(katana::analytics::RestoreCheckpointColumn<PRTy>(
+        *state, "rank", graph->size(),
+        [&](size_t n, PRTy rank) { (*node_data)[n].value = rank; }));
+    iteration = state->iteration;
+  }
 
   float base_score = (1.0f - plan.alpha());
+  // the values of the destinations are random reads
+  auto pipeline = katana::MakePrefetchPipeline(
+      graph->NumEdges(),
+      [&](uint64_t e) { return &(*node_data)[graph->OutEdgeDst(e)]; });
   while (true) {
     katana::do_all(
         katana::iterate(*graph),
         [&](const GNode& src) {
           float sum = 0.0;
 
-          for (auto jj : graph->OutEdges(src)) {
+          for (auto jj : edges(*graph, src)) {
+            pipeline.Ahead(jj);
             auto dest = graph->OutEdgeDst(jj);
             auto& ddata = (*node_data)[dest];
             sum += ddata.value / ddata.out;
@@ -270,17 +333,24 @@ ComputePRTopological(
         katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
         katana::loopname("Pagerank Topological"));
 
-#if DEBUG
-    std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
-#endif
     iteration += 1;
+    reporter.Report(
+        iteration, accum.reduce(), graph->size(), graph->NumEdges());
     if (accum.reduce() <= plan.tolerance() ||
         iteration >= plan.max_iterations()) {
       break;
     }
     accum.reset();
 
+    if (checkpointer.IsDue(iteration)) {
+      std::shared_ptr<arrow::Array> ranks =
+          KATANA_CHECKED(katana::analytics::MakeCheckpointColumn<PRTy>(
+              graph->size(), [&](size_t n) { return (*node_data)[n].value; }));
+      KATANA_CHECKED(checkpointer.Save(katana::analytics::MakeCheckpointState(
+          iteration, {"rank"}, {ranks})));
+    }
   }  ///< End while(true).
+  KATANA_CHECKED(checkpointer.Discard());
 
   katana::ReportStatSingle("PageRank", "Iterations", iteration);
 
@@ -296,15 +366,212 @@ ComputePRTopological(
   return katana::ResultSuccess();
 }
 
-}  // namespace
+/// Last-level cache size to assume when the system does not report one
+constexpr long kDefaultLLCBytes = 32L << 20;
+constexpr uint32_t kMinBlockShift = 12;
+
+/// \returns log2 of the number of nodes per block: the sums of the blocks
+/// that all threads update at the same time take half the last-level cache
+uint32_t
+BlockShiftForCache() {
+  long llc_bytes = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  llc_bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+  if (llc_bytes <= 0) {
+    llc_bytes = kDefaultLLCBytes;
+  }
+  uint64_t block_nodes =
+      llc_bytes / (2 * sizeof(PRTy) * katana::getActiveThreads());
+  uint32_t shift = kMinBlockShift;
+  while ((uint64_t{2} << shift) <= block_nodes) {
+    ++shift;
+  }
+  return shift;
+}
 
+/// Contributions along the out-edges of the graph, binned by the block of
+/// their destination. Each thread owns a fixed range of sources with about
+/// the same number of edges. Bins are laid out block by block, and thread by
+/// thread within a block, so each block's contributions are contiguous.
+/// The destinations of the bin entries are the same every iteration and
+/// are written once.
+struct ContributionBins {
+  uint32_t block_shift{0};
+  uint32_t num_blocks{0};
+  unsigned num_threads{0};
+  /// first source of each thread, and the number of nodes
+  std::vector<uint32_t> thread_begin;
+  /// start of the bin of thread t for block b at b * num_threads + t
+  std::vector<uint64_t> bin_begin;
+  katana::NUMAArray<uint32_t> dsts;
+  katana::NUMAArray<PRTy> values;
+
+  uint64_t& BinBegin(uint32_t block, unsigned tid) {
+    return bin_begin[block * num_threads + tid];
+  }
+
+  /// \returns where each bin of thread tid starts
+  std::vector<uint64_t> Cursors(unsigned tid) const {
+    std::vector<uint64_t> cursors(num_blocks);
+    for (uint32_t b = 0; b < num_blocks; ++b) {
+      cursors[b] = bin_begin[b * num_threads + tid];
+    }
+    return cursors;
+  }
+};
+
+void
+MakeContributionBins(const ForwardGraph& graph, ContributionBins* bins) {
+  using GNode = typename ForwardGraph::Node;
+  const uint32_t num_nodes = graph.NumNodes();
+  bins->block_shift = BlockShiftForCache();
+  bins->num_blocks =
+      ((uint64_t{num_nodes} + (uint64_t{1} << bins->block_shift) - 1) >>
+       bins->block_shift);
+  bins->num_threads = katana::getActiveThreads();
+
+  bins->thread_begin.resize(bins->num_threads + 1);
+  for (unsigned t = 0; t <= bins->num_threads; ++t) {
+    uint64_t first_edge = graph.NumEdges() * t / bins->num_threads;
+    bins->thread_begin[t] = *std::partition_point(
+        boost::counting_iterator<GNode>(0),
+        boost::counting_iterator<GNode>(num_nodes),
+        [&](GNode n) { return *graph.OutEdges(n).begin() < first_edge; });
+  }
+  bins->thread_begin[bins->num_threads] = num_nodes;
+
+  bins->bin_begin.assign(
+      uint64_t{bins->num_blocks} * bins->num_threads + 1, 0);
+  katana::on_each([&](unsigned tid, unsigned) {
+    std::vector<uint64_t> counts(bins->num_blocks, 0);
+    for (GNode src = bins->thread_begin[tid];
+         src < bins->thread_begin[tid + 1]; ++src) {
+      for (auto e : graph.OutEdges(src)) {
+        ++counts[graph.OutEdgeDst(e) >> bins->block_shift];
+      }
+    }
+    for (uint32_t b = 0; b < bins->num_blocks; ++b) {
+      bins->BinBegin(b, tid) = counts[b];
+    }
+  });
+  uint64_t total = 0;
+  for (uint64_t& begin : bins->bin_begin) {
+    uint64_t count = begin;
+    begin = total;
+    total += count;
+  }
+
+  bins->dsts.allocateInterleaved(total);
+  bins->values.allocateInterleaved(total);
+  katana::on_each([&](unsigned tid, unsigned) {
+    std::vector<uint64_t> cursors = bins->Cursors(tid);
+    for (GNode src = bins->thread_begin[tid];
+         src < bins->thread_begin[tid + 1]; ++src) {
+      for (auto e : graph.OutEdges(src)) {
+        GNode dst = graph.OutEdgeDst(e);
+        bins->dsts[cursors[dst >> bins->block_shift]++] = dst;
+      }
+    }
+  });
+}
+
+/**
+ * PageRank with propagation blocking. The same iteration as the topological
+ * pull, in two phases: every thread scans its sources in order and appends
+ * their contributions to the bins of the destination blocks, and then the
+ * bins of each block are summed into sums that stay in cache.
+ */
 katana::Result<void>
-PagerankPullTopological(
-    katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
-  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeValue>>(
-      txn_ctx, {output_property_name}));
+ComputePRBlocked(ForwardGraph* graph, katana::analytics::PagerankPlan plan) {
+  using GNode = typename ForwardGraph::Node;
+  katana::StatTimer exec_time("PagerankPullBlocked");
+  exec_time.start();
 
+  const uint32_t num_nodes = graph->NumNodes();
+  ContributionBins bins;
+  MakeContributionBins(*graph, &bins);
+  katana::ReportStatSingle(
+      "PageRank", "BlockSize", uint64_t{1} << bins.block_shift);
+  katana::ReportStatSingle("PageRank", "Blocks", bins.num_blocks);
+
+  katana::NUMAArray<PRTy> value;
+  value.allocateInterleaved(num_nodes);
+  katana::NUMAArray<PRTy> sums;
+  sums.allocateInterleaved(num_nodes);
+  PRTy init_value = 1.0f / num_nodes;
+  katana::do_all(
+      katana::iterate(*graph), [&](const GNode& n) { value[n] = init_value; },
+      katana::no_stats());
+
+  unsigned int iteration = 0;
+  // the sum decides when to stop, so it must not depend on the schedule
+  katana::GDeterministicAccumulator<float> accum;
+  float base_score = (1.0f - plan.alpha());
+  katana::analytics::IterationReporter reporter("pagerank_pull_blocked");
+  while (true) {
+    katana::on_each([&](unsigned tid, unsigned) {
+      std::vector<uint64_t> cursors = bins.Cursors(tid);
+      for (GNode src = bins.thread_begin[tid]; src < bins.thread_begin[tid + 1];
+           ++src) {
+        uint64_t degree = graph->OutDegree(src);
+        if (degree == 0) {
+          continue;
+        }
+        PRTy contribution = value[src] / degree;
+        for (auto e : graph->OutEdges(src)) {
+          bins.values[cursors[graph->OutEdgeDst(e) >> bins.block_shift]++] =
+              contribution;
+        }
+      }
+    });
+
+    katana::do_all(
+        katana::iterate(uint32_t{0}, bins.num_blocks),
+        [&](uint32_t b) {
+          GNode first = b << bins.block_shift;
+          GNode last = std::min<uint64_t>(
+              num_nodes, uint64_t{first} + (uint64_t{1} << bins.block_shift));
+          std::fill(sums.begin() + first, sums.begin() + last, 0);
+          uint64_t end = bins.bin_begin[(b + 1) * bins.num_threads];
+          for (uint64_t i = bins.BinBegin(b, 0); i < end; ++i) {
+            sums[bins.dsts[i]] += bins.values[i];
+          }
+          float diff = 0;
+          for (GNode n = first; n < last; ++n) {
+            float new_value = sums[n] * plan.alpha() + base_score;
+            diff += std::fabs(new_value - value[n]);
+            value[n] = new_value;
+          }
+          accum += diff;
+        },
+        katana::steal(), katana::loopname("Pagerank Blocked"));
+
+    iteration += 1;
+    reporter.Report(iteration, accum.reduce(), num_nodes, graph->NumEdges());
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+
+  katana::ReportStatSingle("PageRank", "Iterations", iteration);
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t i) { graph->template GetData<NodeValue>(i) = value[i]; },
+      katana::loopname("Extract pagerank"), katana::no_stats());
+
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
+template <typename Graph>
+katana::Result<void>
+RunPullTopological(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
   Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
 
   katana::EnsurePreallocated(2, 3 * graph.size() * sizeof(NodeData));
@@ -320,13 +587,11 @@ PagerankPullTopological(
   return ComputePRTopological(&graph, plan, &node_data);
 }
 
+template <typename Graph>
 katana::Result<void>
-PagerankPullResidual(
+RunPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
-  KATANA_CHECKED(
-      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
-
+    katana::analytics::PagerankPlan plan) {
   Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
 
   katana::EnsurePreallocated(2, 3 * graph.size() * sizeof(NodeData));
@@ -347,3 +612,78 @@ PagerankPullResidual(
 
   return ComputePRResidual(&graph, &delta, &residual, node_out_degree, plan);
 }
+
+}  // namespace
+
+katana::Result<void>
+PagerankPullTopological(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeValue>>(
+      txn_ctx, {output_property_name}));
+
+  if (plan.replicate_topology()) {
+    return RunPullTopological<ReplicatedTransposedGraph>(
+        pg, output_property_name, plan);
+  }
+  return RunPullTopological<TransposedGraph>(pg, output_property_name, plan);
+}
+
+katana::Result<void>
+PagerankPullTopologicalInWindow(
+    katana::PropertyGraph* pg, const katana::analytics::TimeWindow& window,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(window.Validate());
+  auto view = KATANA_CHECKED(
+      pg->BuildView<katana::PropertyGraphViews::TransposedTemporal>(
+          window.timestamp_property));
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+  TransposedTemporalGraph graph = KATANA_CHECKED(
+      TransposedTemporalGraph::Make(view, {output_property_name}, {}));
+
+  katana::EnsurePreallocated(2, 3 * graph.size() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  PagerankValueAndOutDegreeArray node_data;
+  node_data.allocateInterleaved(graph.size());
+
+  OutEdgesInWindow edges{window.begin, window.end};
+  KATANA_CHECKED(InitNodeDataTopological(graph, &node_data));
+  KATANA_CHECKED(ComputeOutDeg(graph, &node_data, edges));
+
+  return ComputePRTopological(&graph, plan, &node_data, edges);
+}
+
+katana::Result<void>
+PagerankPullResidual(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+
+  if (plan.replicate_topology()) {
+    return RunPullResidual<ReplicatedTransposedGraph>(
+        pg, output_property_name, plan);
+  }
+  return RunPullResidual<TransposedGraph>(pg, output_property_name, plan);
+}
+
+katana::Result<void>
+PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<NodeData>(txn_ctx, {output_property_name}));
+
+  ForwardGraph graph =
+      KATANA_CHECKED(ForwardGraph::Make(pg, {output_property_name}, {}));
+
+  katana::EnsurePreallocated(
+      2, 2 * graph.size() * sizeof(PRTy) +
+             graph.NumEdges() * (sizeof(uint32_t) + sizeof(PRTy)));
+  katana::ReportPageAllocGuard page_alloc;
+
+  return ComputePRBlocked(&graph, plan);
+}
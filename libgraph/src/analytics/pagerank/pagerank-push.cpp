@@ -17,6 +17,8 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <cmath>
+
 #include "katana/AtomicHelpers.h"
 #include "katana/Properties.h"
 #include "katana/TypedPropertyGraph.h"
@@ -50,6 +52,48 @@ InitializeNodeResidual(
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
+/// Push residuals larger than the tolerance to the out-neighbors, starting
+/// from the nodes in \p initial. Residuals may be negative when ranks are
+/// corrected downward, so their magnitude is what is compared against the
+/// tolerance.
+template <typename Range>
+void
+PushResidualsAsynchronous(
+    Graph* graph, const katana::analytics::PagerankPlan& plan,
+    const Range& initial) {
+  typedef katana::PerSocketChunkFIFO<
+      katana::analytics::PagerankPlan::kChunkSize>
+      WL;
+  katana::for_each(
+      katana::iterate(initial),
+      [&](const GNode& src, auto& ctx) {
+        auto& src_residual = graph->GetData<NodeResidual>(src);
+        if (std::fabs(src_residual) > plan.tolerance()) {
+          PRTy old_residual = src_residual.exchange(0.0);
+          auto& src_value = graph->GetData<NodeValue>(src);
+          src_value += old_residual;
+          int src_nout = graph->OutDegree(src);
+          if (src_nout > 0) {
+            PRTy delta = old_residual * plan.alpha() / src_nout;
+            //! For each out-going neighbors.
+            for (const auto& jj : graph->OutEdges(src)) {
+              auto dest = graph->OutEdgeDst(jj);
+              auto& dest_residual = graph->GetData<NodeResidual>(dest);
+              if (delta != 0) {
+                auto old = atomicAdd(dest_residual, delta);
+                if ((std::fabs(old) < plan.tolerance()) &&
+                    (std::fabs(old + delta) >= plan.tolerance())) {
+                  ctx.push(dest);
+                }
+              }
+            }
+          }
+        }
+      },
+      katana::loopname("PushResidualAsynchronous"),
+      katana::disable_conflict_detection(), katana::wl<WL>());
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -73,37 +117,7 @@ PagerankPushAsynchronous(
 
   InitializeNodeResidual(&graph, plan);
 
-  typedef katana::PerSocketChunkFIFO<
-      katana::analytics::PagerankPlan::kChunkSize>
-      WL;
-  katana::for_each(
-      katana::iterate(graph),
-      [&](const GNode& src, auto& ctx) {
-        auto& src_residual = graph.GetData<NodeResidual>(src);
-        if (src_residual > plan.tolerance()) {
-          PRTy old_residual = src_residual.exchange(0.0);
-          auto& src_value = graph.GetData<NodeValue>(src);
-          src_value += old_residual;
-          int src_nout = graph.OutDegree(src);
-          if (src_nout > 0) {
-            PRTy delta = old_residual * plan.alpha() / src_nout;
-            //! For each out-going neighbors.
-            for (const auto& jj : graph.OutEdges(src)) {
-              auto dest = graph.OutEdgeDst(jj);
-              auto& dest_residual = graph.GetData<NodeResidual>(dest);
-              if (delta > 0) {
-                auto old = atomicAdd(dest_residual, delta);
-                if ((old < plan.tolerance()) &&
-                    (old + delta >= plan.tolerance())) {
-                  ctx.push(dest);
-                }
-              }
-            }
-          }
-        }
-      },
-      katana::loopname("PushResidualAsynchronous"),
-      katana::disable_conflict_detection(), katana::wl<WL>());
+  PushResidualsAsynchronous(&graph, plan, graph);
 
   return katana::ResultSuccess();
 }
@@ -209,3 +223,122 @@ PagerankPushSynchronous(
   }
   return katana::ResultSuccess();
 }
+
+katana::Result<void>
+PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& added_edges,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  using PreviousGraph =
+      katana::TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>;
+
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  auto previous = KATANA_CHECKED_CONTEXT(
+      PreviousGraph::Make(pg, {previous_rank_property_name}, {}),
+      "previous ranks {}", previous_rank_property_name);
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<NodeData>(
+      txn_ctx, {output_property_name, temporary_property.name()}));
+
+  Graph graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+
+  size_t num_nodes = graph.size();
+  for (const auto& [src, dst] : added_edges) {
+    if (src >= num_nodes || dst >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "edge ({}, {}) is not in graph",
+          src, dst);
+    }
+  }
+
+  katana::NUMAArray<std::atomic<uint32_t>> num_added;
+  num_added.allocateInterleaved(num_nodes);
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeValue>(n) = previous.GetData<NodeValue>(n);
+        graph.GetData<NodeResidual>(n) = 0;
+        num_added.constructAt(n, 0U);
+      },
+      katana::no_stats(), katana::loopname("Initialize"));
+
+  katana::do_all(
+      katana::iterate(added_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        num_added[edge.first].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  // A node u with new out-edges used to send alpha * rank / old_degree along
+  // each old out-edge and now sends alpha * rank / new_degree along every
+  // out-edge. Charge the difference to the residuals of its neighbors: first
+  // as if all of its edges were old, then correct the new ones.
+  katana::GReduceLogicalOr missing_edges;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& src) {
+        uint32_t added = num_added[src].load(std::memory_order_relaxed);
+        if (added == 0) {
+          return;
+        }
+        size_t new_degree = graph.OutDegree(src);
+        if (new_degree < added) {
+          missing_edges.update(true);
+          return;
+        }
+        size_t old_degree = new_degree - added;
+        PRTy rank = graph.GetData<NodeValue>(src);
+        PRTy change = plan.alpha() * rank / new_degree;
+        if (old_degree > 0) {
+          change -= plan.alpha() * rank / old_degree;
+        }
+        for (const auto& jj : graph.OutEdges(src)) {
+          auto dest = graph.OutEdgeDst(jj);
+          atomicAdd(graph.GetData<NodeResidual>(dest), change);
+        }
+      },
+      katana::steal(),
+      katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+      katana::loopname("IncrementalResidualOutEdges"));
+  if (missing_edges.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "nodes have fewer out-edges than were added");
+  }
+
+  katana::do_all(
+      katana::iterate(added_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        auto [src, dest] = edge;
+        size_t old_degree = graph.OutDegree(src) - num_added[src];
+        if (old_degree > 0) {
+          PRTy rank = graph.GetData<NodeValue>(src);
+          atomicAdd(
+              graph.GetData<NodeResidual>(dest),
+              plan.alpha() * rank / old_degree);
+        }
+      },
+      katana::loopname("IncrementalResidualAddedEdges"));
+
+  katana::InsertBag<GNode> active_nodes;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (std::fabs(graph.GetData<NodeResidual>(n)) > plan.tolerance()) {
+          active_nodes.push(n);
+        }
+      },
+      katana::no_stats());
+
+  PushResidualsAsynchronous(&graph, plan, active_nodes);
+
+  return katana::ResultSuccess();
+}
@@ -29,6 +29,8 @@ katana::analytics::Pagerank(
     return PagerankPullResidual(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPullTopological:
     return PagerankPullTopological(pg, output_property_name, plan, txn_ctx);
+  case PagerankPlan::kPullBlocked:
+    return PagerankPullBlocked(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPushAsynchronous:
     return PagerankPushAsynchronous(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPushSynchronous:
@@ -38,6 +40,26 @@ katana::analytics::Pagerank(
   }
 }
 
+katana::Result<void>
+katana::analytics::PagerankIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& added_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    katana::analytics::PagerankPlan plan) {
+  return PagerankPushIncremental(
+      pg, previous_rank_property_name, added_edges, output_property_name, plan,
+      txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::PagerankInTimeWindow(
+    katana::PropertyGraph* pg, const TimeWindow& window,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    katana::analytics::PagerankPlan plan) {
+  return PagerankPullTopologicalInWindow(
+      pg, window, output_property_name, plan, txn_ctx);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::PagerankAssertValid(
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+
+#include "katana/ConcurrentHashMap.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Sampling.h"
+#include "pagerank-impl.h"
+
+using katana::analytics::PersonalizedPagerankPlan;
+
+namespace {
+
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, std::tuple<>, std::tuple<>>;
+using GNode = typename Graph::Node;
+
+/// Scores of the nodes reached from the sources; the others have 0
+using Scores = std::unordered_map<GNode, double>;
+
+katana::Result<void>
+CheckArguments(
+    const Graph& graph, const std::vector<uint32_t>& sources,
+    const PersonalizedPagerankPlan& plan) {
+  if (sources.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "at least one source is needed");
+  }
+  for (uint32_t source : sources) {
+    if (source >= graph.NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "source {} is not in the graph of {} nodes", source,
+          graph.NumNodes());
+    }
+  }
+  if (!(plan.alpha() >= 0 && plan.alpha() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha must be in [0, 1), not {}",
+        plan.alpha());
+  }
+  if (plan.algorithm() == PersonalizedPagerankPlan::kForwardPush &&
+      !(plan.tolerance() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "tolerance must be positive");
+  }
+  if (plan.algorithm() == PersonalizedPagerankPlan::kMonteCarlo &&
+      plan.num_walks() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "at least one walk is needed");
+  }
+  return katana::ResultSuccess();
+}
+
+Scores
+ForwardPush(
+    const Graph& graph, const std::vector<uint32_t>& sources,
+    const PersonalizedPagerankPlan& plan) {
+  katana::StatTimer exec_time("PersonalizedPagerankForwardPush");
+  exec_time.start();
+
+  Scores scores;
+  Scores residual;
+  auto needs_push = [&](GNode n, double r) {
+    return r > plan.tolerance() * std::max<uint64_t>(graph.OutDegree(n), 1);
+  };
+
+  for (uint32_t source : sources) {
+    residual[source] += 1.0 / sources.size();
+  }
+  // a node is queued once, when its residual goes over the threshold, and
+  // stays over it until it is pushed
+  std::deque<GNode> queue;
+  for (const auto& [n, r] : residual) {
+    if (needs_push(n, r)) {
+      queue.push_back(n);
+    }
+  }
+
+  uint64_t pushes = 0;
+  while (!queue.empty()) {
+    GNode n = queue.front();
+    queue.pop_front();
+    double r = residual[n];
+    residual[n] = 0;
+    ++pushes;
+
+    uint64_t degree = graph.OutDegree(n);
+    if (degree == 0) {
+      scores[n] += r;
+      continue;
+    }
+    scores[n] += (1 - plan.alpha()) * r;
+    double spread = plan.alpha() * r / degree;
+    for (auto e : graph.OutEdges(n)) {
+      GNode dst = graph.OutEdgeDst(e);
+      double& dst_residual = residual[dst];
+      bool queued = needs_push(dst, dst_residual);
+      dst_residual += spread;
+      if (!queued && needs_push(dst, dst_residual)) {
+        queue.push_back(dst);
+      }
+    }
+  }
+
+  katana::ReportStatSingle("PersonalizedPagerank", "Pushes", pushes);
+  exec_time.stop();
+  return scores;
+}
+
+Scores
+MonteCarlo(
+    const Graph& graph, const std::vector<uint32_t>& sources,
+    const PersonalizedPagerankPlan& plan) {
+  katana::StatTimer exec_time("PersonalizedPagerankMonteCarlo");
+  exec_time.start();
+
+  const uint64_t key = katana::analytics::SamplingKey(plan.seed());
+  const double alpha = plan.alpha();
+  // a walk stops at one node, so there are at most num_walks of them
+  katana::ConcurrentHashMap<GNode, std::atomic<uint64_t>> stops(
+      std::min<uint64_t>(plan.num_walks(), graph.NumNodes()));
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, plan.num_walks()),
+      [&](uint64_t walk) {
+        uint64_t walk_key = katana::analytics::SampleBits(key, walk);
+        GNode n = sources[walk % sources.size()];
+        for (uint64_t step = 0;; ++step) {
+          uint64_t degree = graph.OutDegree(n);
+          double u = katana::analytics::SampleUnit(walk_key, step);
+          if (degree == 0 || u >= alpha) {
+            break;
+          }
+          // given u < alpha, u / alpha is uniform in [0, 1)
+          uint64_t index =
+              std::min<uint64_t>(u / alpha * degree, degree - 1);
+          n = graph.OutEdgeDst(*(graph.OutEdges(n).begin() + index));
+        }
+        stops.Emplace(n, 0).first->fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::steal(), katana::loopname("PersonalizedPagerankWalks"));
+
+  Scores scores;
+  scores.reserve(stops.size());
+  stops.ForEach([&](GNode n, const std::atomic<uint64_t>& count) {
+    scores[n] = static_cast<double>(count.load()) / plan.num_walks();
+  });
+
+  exec_time.stop();
+  return scores;
+}
+
+katana::Result<Scores>
+ComputeScores(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const PersonalizedPagerankPlan& plan) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {}, {}));
+  KATANA_CHECKED(CheckArguments(graph, sources, plan));
+
+  switch (plan.algorithm()) {
+  case PersonalizedPagerankPlan::kForwardPush:
+    return ForwardPush(graph, sources, plan);
+  case PersonalizedPagerankPlan::kMonteCarlo:
+    return MonteCarlo(graph, sources, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::PersonalizedPagerank(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PersonalizedPagerankPlan plan) {
+  using OutputGraph =
+      katana::TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>;
+
+  Scores scores = KATANA_CHECKED(ComputeScores(pg, sources, plan));
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeValue>>(
+      txn_ctx, {output_property_name}));
+  OutputGraph graph =
+      KATANA_CHECKED(OutputGraph::Make(pg, {output_property_name}, {}));
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint32_t n) { graph.GetData<NodeValue>(n) = 0; },
+      katana::no_stats());
+  for (const auto& [n, score] : scores) {
+    graph.GetData<NodeValue>(n) = score;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<std::pair<uint32_t, float>>>
+katana::analytics::PersonalizedPagerankTopK(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources, size_t k,
+    PersonalizedPagerankPlan plan) {
+  Scores scores = KATANA_CHECKED(ComputeScores(pg, sources, plan));
+
+  std::vector<std::pair<uint32_t, float>> top(scores.begin(), scores.end());
+  k = std::min(k, top.size());
+  // ties go to the smaller node so that the result is deterministic
+  std::partial_sort(
+      top.begin(), top.begin() + k, top.end(),
+      [](const auto& a, const auto& b) {
+        return a.second > b.second ||
+               (a.second == b.second && a.first < b.first);
+      });
+  top.resize(k);
+  return top;
+}
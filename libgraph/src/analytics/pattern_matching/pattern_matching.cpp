@@ -0,0 +1,647 @@
+#include "katana/analytics/pattern_matching/pattern_matching.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/analytics/SetIntersection.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+using Node = katana::GraphTopologyTypes::Node;
+using NodeRange = katana::StandardRange<const Node*>;
+using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
+using TypedGraphView = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
+
+/// Patterns are small enough to enumerate their automorphisms
+constexpr size_t kMaxPatternNodes = 8;
+constexpr size_t kMaxMotifSize = 5;
+
+constexpr static const unsigned kChunkSize = 16U;
+
+/// How one pattern node is connected to another. Typed edges get one code
+/// per type and direction, so that automorphisms preserve both.
+using EdgeCode = uint32_t;
+constexpr EdgeCode kNoEdge = 0;
+constexpr EdgeCode kUntypedEdge = 1;
+
+EdgeCode
+OutEdgeCode(katana::EntityTypeID edge_type) {
+  return 2 + 2 * EdgeCode{edge_type};
+}
+
+EdgeCode
+InEdgeCode(katana::EntityTypeID edge_type) {
+  return 3 + 2 * EdgeCode{edge_type};
+}
+
+using AdjacencyMatrix = std::vector<std::vector<EdgeCode>>;
+
+katana::Result<AdjacencyMatrix>
+MakeAdjacency(const Pattern& pattern) {
+  const size_t num_nodes = pattern.num_nodes();
+  if (num_nodes == 0 || num_nodes > kMaxPatternNodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "patterns must have between 1 and {} nodes, not {}", kMaxPatternNodes,
+        num_nodes);
+  }
+
+  AdjacencyMatrix adj(num_nodes, std::vector<EdgeCode>(num_nodes, kNoEdge));
+  for (const auto& edge : pattern.edges()) {
+    if (edge.src >= num_nodes || edge.dst >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge ({}, {}) of a pattern with {} nodes", edge.src, edge.dst,
+          num_nodes);
+    }
+    if (edge.src == edge.dst) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "pattern node {} has a self loop", edge.src);
+    }
+    if (adj[edge.src][edge.dst] != kNoEdge) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "pattern nodes {} and {} have more than one edge", edge.src,
+          edge.dst);
+    }
+    if (edge.edge_type) {
+      adj[edge.src][edge.dst] = OutEdgeCode(*edge.edge_type);
+      adj[edge.dst][edge.src] = InEdgeCode(*edge.edge_type);
+    } else {
+      adj[edge.src][edge.dst] = kUntypedEdge;
+      adj[edge.dst][edge.src] = kUntypedEdge;
+    }
+  }
+  return adj;
+}
+
+/// \returns the permutations of the pattern nodes that preserve its edges
+/// and the constraints of its nodes. Nodes with filters are only mapped onto
+/// themselves, since filters cannot be compared.
+std::vector<std::vector<size_t>>
+Automorphisms(const Pattern& pattern, const AdjacencyMatrix& adj) {
+  const size_t num_nodes = pattern.num_nodes();
+  std::vector<std::vector<size_t>> automorphisms;
+  std::vector<size_t> perm(num_nodes);
+  std::iota(perm.begin(), perm.end(), 0);
+  do {
+    bool preserves = true;
+    for (size_t a = 0; a < num_nodes && preserves; ++a) {
+      preserves = pattern.node_type(a) == pattern.node_type(perm[a]) &&
+                  (!pattern.node_filter(a) || perm[a] == a);
+      for (size_t b = 0; b < num_nodes && preserves; ++b) {
+        preserves = adj[a][b] == adj[perm[a]][perm[b]];
+      }
+    }
+    if (preserves) {
+      automorphisms.emplace_back(perm);
+    }
+  } while (std::next_permutation(perm.begin(), perm.end()));
+  return automorphisms;
+}
+
+/// \returns conditions (a, b), meaning that the match of a is less than the
+/// match of b, that exactly one of the images of a match under the
+/// automorphisms meets: each node in turn is made the smallest of its orbit,
+/// and the automorphisms are cut down to those that fix it (Grochow and
+/// Kellis. Network Motif Discovery Using Subgraph Enumeration and
+/// Symmetry-Breaking. RECOMB 2007).
+std::vector<std::pair<size_t, size_t>>
+SymmetryBreakingConditions(std::vector<std::vector<size_t>> automorphisms) {
+  std::vector<std::pair<size_t, size_t>> conditions;
+  const size_t num_nodes = automorphisms.front().size();
+  for (size_t v = 0; v < num_nodes && automorphisms.size() > 1; ++v) {
+    std::vector<bool> in_orbit(num_nodes, false);
+    for (const auto& automorphism : automorphisms) {
+      in_orbit[automorphism[v]] = true;
+    }
+    for (size_t u = 0; u < num_nodes; ++u) {
+      if (u != v && in_orbit[u]) {
+        conditions.emplace_back(v, u);
+      }
+    }
+    automorphisms.erase(
+        std::remove_if(
+            automorphisms.begin(), automorphisms.end(),
+            [v](const std::vector<size_t>& a) { return a[v] != v; }),
+        automorphisms.end());
+  }
+  return conditions;
+}
+
+/// The order in which the pattern nodes are matched and, at each depth of
+/// the search, what the match must satisfy in terms of earlier matches
+struct Schedule {
+  struct BackEdge {
+    /// The depth of the adjacent pattern node
+    size_t depth;
+    EdgeCode code;
+  };
+
+  /// order[d] is the pattern node matched at depth d
+  std::vector<size_t> order;
+  std::vector<std::vector<BackEdge>> back_edges;
+  /// Earlier depths that may not be adjacent, for induced patterns
+  std::vector<std::vector<size_t>> non_adjacent;
+  /// Earlier depths whose matches must be less than the match at d
+  std::vector<std::vector<size_t>> greater_than;
+  /// Earlier depths whose matches must be greater than the match at d
+  std::vector<std::vector<size_t>> less_than;
+  /// Whether the match at d must pass a node type or filter check
+  std::vector<bool> constrained;
+  std::vector<katana::EntityTypeID> edge_types;
+
+  size_t size() const { return order.size(); }
+};
+
+/// Match the node with the most edges first, then always the node with the
+/// most edges to the nodes before, so that candidates are intersections of
+/// as many neighbor lists as possible
+katana::Result<Schedule>
+MakeSchedule(const Pattern& pattern) {
+  AdjacencyMatrix adj = KATANA_CHECKED(MakeAdjacency(pattern));
+  const size_t num_nodes = pattern.num_nodes();
+
+  std::vector<size_t> degree(num_nodes, 0);
+  for (size_t a = 0; a < num_nodes; ++a) {
+    degree[a] = std::count_if(
+        adj[a].begin(), adj[a].end(),
+        [](EdgeCode code) { return code != kNoEdge; });
+  }
+
+  Schedule schedule;
+  std::vector<bool> placed(num_nodes, false);
+  std::vector<size_t> links(num_nodes, 0);
+  for (size_t d = 0; d < num_nodes; ++d) {
+    size_t next = num_nodes;
+    for (size_t a = 0; a < num_nodes; ++a) {
+      if (placed[a]) {
+        continue;
+      }
+      if (next == num_nodes || links[a] > links[next] ||
+          (links[a] == links[next] && degree[a] > degree[next])) {
+        next = a;
+      }
+    }
+    if (d > 0 && links[next] == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "the pattern is not connected");
+    }
+    placed[next] = true;
+    schedule.order.emplace_back(next);
+    for (size_t a = 0; a < num_nodes; ++a) {
+      links[a] += adj[next][a] != kNoEdge;
+    }
+  }
+
+  std::vector<size_t> depth_of(num_nodes);
+  for (size_t d = 0; d < num_nodes; ++d) {
+    depth_of[schedule.order[d]] = d;
+  }
+
+  schedule.back_edges.resize(num_nodes);
+  schedule.non_adjacent.resize(num_nodes);
+  schedule.greater_than.resize(num_nodes);
+  schedule.less_than.resize(num_nodes);
+  for (size_t d = 0; d < num_nodes; ++d) {
+    const size_t node = schedule.order[d];
+    for (size_t j = 0; j < d; ++j) {
+      EdgeCode code = adj[schedule.order[j]][node];
+      if (code != kNoEdge) {
+        schedule.back_edges[d].emplace_back(Schedule::BackEdge{j, code});
+      } else if (pattern.induced()) {
+        schedule.non_adjacent[d].emplace_back(j);
+      }
+    }
+    schedule.constrained.emplace_back(
+        pattern.node_type(node) || pattern.node_filter(node));
+  }
+
+  for (const auto& [a, b] :
+       SymmetryBreakingConditions(Automorphisms(pattern, adj))) {
+    if (depth_of[a] < depth_of[b]) {
+      schedule.greater_than[depth_of[b]].emplace_back(depth_of[a]);
+    } else {
+      schedule.less_than[depth_of[a]].emplace_back(depth_of[b]);
+    }
+  }
+
+  for (const auto& edge : pattern.edges()) {
+    if (edge.edge_type) {
+      schedule.edge_types.emplace_back(*edge.edge_type);
+    }
+  }
+  return schedule;
+}
+
+/// The buffers of one thread's search, indexed by depth
+struct SearchState {
+  std::vector<Node> match;
+  std::vector<std::vector<Node>> candidates;
+  std::vector<NodeRange> lists;
+  std::vector<Node> scratch;
+  /// The match in pattern node order
+  std::vector<Node> output;
+
+  void Resize(size_t size) {
+    match.resize(size);
+    candidates.resize(size);
+    output.resize(size);
+  }
+};
+
+class Matcher {
+public:
+  Matcher(
+      const katana::PropertyGraph& pg, const Pattern& pattern,
+      const Schedule& schedule, const SortedGraphView& sorted,
+      const TypedGraphView* typed)
+      : pg_(pg),
+        pattern_(pattern),
+        schedule_(schedule),
+        sorted_(sorted),
+        typed_(typed) {}
+
+  bool Accepts(size_t depth, Node n) const {
+    if (!schedule_.constrained[depth]) {
+      return true;
+    }
+    const size_t node = schedule_.order[depth];
+    const auto& node_type = pattern_.node_type(node);
+    if (node_type && !pg_.DoesNodeHaveType(n, *node_type)) {
+      return false;
+    }
+    const auto& filter = pattern_.node_filter(node);
+    return !filter || filter(n);
+  }
+
+  /// \returns the number of matches that extend state->match[0, depth),
+  /// calling on_match with each of them if kEnumerate
+  template <bool kEnumerate, typename F>
+  uint64_t Extend(size_t depth, SearchState* state, const F& on_match) const {
+    if (depth == schedule_.size()) {
+      if constexpr (kEnumerate) {
+        for (size_t d = 0; d < depth; ++d) {
+          state->output[schedule_.order[d]] = state->match[d];
+        }
+        on_match(state->output);
+      }
+      return 1;
+    }
+
+    if (!CollectLists(depth, state)) {
+      return 0;
+    }
+    if (!kEnumerate && depth + 1 == schedule_.size() &&
+        !schedule_.constrained[depth] &&
+        schedule_.non_adjacent[depth].empty()) {
+      return CountLast(depth, state);
+    }
+
+    std::vector<Node>& candidates = state->candidates[depth];
+    Intersect(state, state->lists.size(), &candidates);
+    uint64_t num_matches = 0;
+    for (Node c : candidates) {
+      if (IsMatched(depth, *state, c) || !Accepts(depth, c) ||
+          HasForbiddenEdge(depth, *state, c)) {
+        continue;
+      }
+      state->match[depth] = c;
+      num_matches += Extend<kEnumerate>(depth + 1, state, on_match);
+    }
+    return num_matches;
+  }
+
+private:
+  NodeRange Neighbors(Node n, EdgeCode code) const {
+    if (code == kUntypedEdge) {
+      return sorted_.OutEdgeDsts(n);
+    }
+    katana::EntityTypeID edge_type = (code - 2) / 2;
+    return code % 2 == 0 ? typed_->OutEdgeDsts(n, edge_type)
+                         : typed_->InEdgeSrcs(n, edge_type);
+  }
+
+  /// Fill state->lists with the neighbor lists whose intersection holds the
+  /// candidates at depth, cut to the range the symmetry breaking conditions
+  /// leave, shortest first
+  ///
+  /// \returns false if a list is empty
+  bool CollectLists(size_t depth, SearchState* state) const {
+    const std::vector<Node>& match = state->match;
+    Node lo = 0;
+    for (size_t j : schedule_.greater_than[depth]) {
+      lo = std::max<Node>(lo, match[j] + 1);
+    }
+    Node hi = sorted_.NumNodes();
+    for (size_t j : schedule_.less_than[depth]) {
+      hi = std::min(hi, match[j]);
+    }
+    if (lo >= hi) {
+      return false;
+    }
+
+    state->lists.clear();
+    for (const auto& back_edge : schedule_.back_edges[depth]) {
+      NodeRange neighbors = Neighbors(match[back_edge.depth], back_edge.code);
+      const Node* begin =
+          std::lower_bound(neighbors.begin(), neighbors.end(), lo);
+      const Node* end = std::lower_bound(begin, neighbors.end(), hi);
+      if (begin == end) {
+        return false;
+      }
+      state->lists.emplace_back(katana::MakeStandardRange(begin, end));
+    }
+    std::sort(
+        state->lists.begin(), state->lists.end(),
+        [](const NodeRange& a, const NodeRange& b) {
+          return a.size() < b.size();
+        });
+    return true;
+  }
+
+  /// Intersect the first num_lists of state->lists into out
+  void Intersect(
+      SearchState* state, size_t num_lists, std::vector<Node>* out) const {
+    const NodeRange& first = state->lists[0];
+    out->assign(first.begin(), first.end());
+    for (size_t i = 1; i < num_lists && !out->empty(); ++i) {
+      std::vector<Node>& scratch = state->scratch;
+      scratch.clear();
+      ForEachIntersection(
+          out->data(), out->size(), state->lists[i].begin(),
+          state->lists[i].size(),
+          [&](size_t a, size_t) { scratch.emplace_back((*out)[a]); });
+      std::swap(*out, scratch);
+    }
+  }
+
+  /// Count the unconstrained candidates of the last pattern node without
+  /// listing them, then take out those that are matched already
+  uint64_t CountLast(size_t depth, SearchState* state) const {
+    const std::vector<NodeRange>& lists = state->lists;
+    uint64_t count = 0;
+    if (lists.size() == 1) {
+      count = lists[0].size();
+    } else {
+      std::vector<Node>& partial = state->candidates[depth];
+      NodeRange rest = lists[0];
+      if (lists.size() > 2) {
+        Intersect(state, lists.size() - 1, &partial);
+        rest = katana::MakeStandardRange<const Node*>(
+            partial.data(), partial.data() + partial.size());
+      }
+      count = CountIntersection(rest, lists.back());
+    }
+
+    for (size_t j = 0; j < depth; ++j) {
+      Node m = state->match[j];
+      bool in_all = std::all_of(
+          lists.begin(), lists.end(), [m](const NodeRange& list) {
+            return std::binary_search(list.begin(), list.end(), m);
+          });
+      count -= in_all;
+    }
+    return count;
+  }
+
+  static bool IsMatched(size_t depth, const SearchState& state, Node n) {
+    return std::find(state.match.begin(), state.match.begin() + depth, n) !=
+           state.match.begin() + depth;
+  }
+
+  bool Adjacent(Node a, Node b) const {
+    if (sorted_.OutDegree(b) < sorted_.OutDegree(a)) {
+      std::swap(a, b);
+    }
+    NodeRange neighbors = sorted_.OutEdgeDsts(a);
+    return std::binary_search(neighbors.begin(), neighbors.end(), b);
+  }
+
+  bool HasForbiddenEdge(size_t depth, const SearchState& state, Node n) const {
+    for (size_t j : schedule_.non_adjacent[depth]) {
+      if (Adjacent(state.match[j], n)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const katana::PropertyGraph& pg_;
+  const Pattern& pattern_;
+  const Schedule& schedule_;
+  const SortedGraphView& sorted_;
+  const TypedGraphView* typed_;
+};
+
+template <bool kEnumerate, typename F>
+katana::Result<uint64_t>
+Match(
+    katana::PropertyGraph* pg, const Pattern& pattern,
+    const PatternMatchingPlan& plan, const F& on_match) {
+  if (plan.algorithm() != PatternMatchingPlan::kGenericJoin) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  Schedule schedule = KATANA_CHECKED(MakeSchedule(pattern));
+
+  auto sorted = pg->BuildView<SortedGraphView>();
+  std::optional<TypedGraphView> typed;
+  if (!schedule.edge_types.empty()) {
+    typed = pg->BuildView<TypedGraphView>();
+    for (katana::EntityTypeID edge_type : schedule.edge_types) {
+      if (!typed->DoesEdgeTypeExist(edge_type)) {
+        return uint64_t{0};
+      }
+    }
+  }
+
+  Matcher matcher(*pg, pattern, schedule, sorted, typed ? &*typed : nullptr);
+  katana::GAccumulator<uint64_t> num_matches;
+  katana::PerThreadStorage<SearchState> states;
+  katana::do_all(
+      katana::iterate(sorted),
+      [&](const Node& n) {
+        if (!matcher.Accepts(0, n)) {
+          return;
+        }
+        SearchState* state = states.getLocal();
+        state->Resize(schedule.size());
+        state->match[0] = n;
+        num_matches += matcher.Extend<kEnumerate>(1, state, on_match);
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("PatternMatching"));
+
+  return num_matches.reduce();
+}
+
+/// \returns whether the graph on size nodes with the edges of mask, one bit
+/// per pair of nodes in the order of pairs, is connected
+bool
+IsConnected(
+    uint32_t mask, size_t size,
+    const std::vector<std::pair<size_t, size_t>>& pairs) {
+  uint32_t reached = 1;
+  for (size_t round = 1; round < size; ++round) {
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      if (mask >> i & 1) {
+        const auto& [a, b] = pairs[i];
+        if ((reached >> a & 1) || (reached >> b & 1)) {
+          reached |= uint32_t{1} << a | uint32_t{1} << b;
+        }
+      }
+    }
+  }
+  return reached == (uint32_t{1} << size) - 1;
+}
+
+/// \returns an induced pattern for each connected graph on size nodes, up to
+/// isomorphism. A graph is kept if its edge mask is the least among those of
+/// its relabelings.
+std::vector<Pattern>
+ConnectedShapes(size_t size) {
+  std::vector<std::pair<size_t, size_t>> pairs;
+  std::vector<std::vector<size_t>> pair_index(size, std::vector<size_t>(size));
+  for (size_t a = 0; a < size; ++a) {
+    for (size_t b = a + 1; b < size; ++b) {
+      pair_index[a][b] = pair_index[b][a] = pairs.size();
+      pairs.emplace_back(a, b);
+    }
+  }
+
+  std::vector<Pattern> shapes;
+  for (uint32_t mask = 0; mask < (uint32_t{1} << pairs.size()); ++mask) {
+    if (!IsConnected(mask, size, pairs)) {
+      continue;
+    }
+    bool least = true;
+    std::vector<size_t> perm(size);
+    std::iota(perm.begin(), perm.end(), 0);
+    while (least && std::next_permutation(perm.begin(), perm.end())) {
+      uint32_t relabeled = 0;
+      for (size_t i = 0; i < pairs.size(); ++i) {
+        if (mask >> i & 1) {
+          const auto& [a, b] = pairs[i];
+          relabeled |= uint32_t{1} << pair_index[perm[a]][perm[b]];
+        }
+      }
+      least = relabeled >= mask;
+    }
+    if (!least) {
+      continue;
+    }
+
+    Pattern shape(true);
+    for (size_t a = 0; a < size; ++a) {
+      shape.AddNode();
+    }
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      if (mask >> i & 1) {
+        shape.AddEdge(pairs[i].first, pairs[i].second);
+      }
+    }
+    shapes.emplace_back(std::move(shape));
+  }
+  return shapes;
+}
+
+}  // namespace
+
+size_t
+katana::analytics::Pattern::AddNode(
+    std::optional<EntityTypeID> node_type, NodeFilter filter) {
+  node_types_.emplace_back(node_type);
+  node_filters_.emplace_back(std::move(filter));
+  return node_types_.size() - 1;
+}
+
+void
+katana::analytics::Pattern::AddEdge(
+    size_t src, size_t dst, std::optional<EntityTypeID> edge_type) {
+  edges_.emplace_back(Edge{src, dst, edge_type});
+}
+
+katana::analytics::Pattern
+katana::analytics::Pattern::Clique(size_t size, bool induced) {
+  Pattern pattern(induced);
+  for (size_t a = 0; a < size; ++a) {
+    pattern.AddNode();
+    for (size_t b = 0; b < a; ++b) {
+      pattern.AddEdge(b, a);
+    }
+  }
+  return pattern;
+}
+
+katana::analytics::Pattern
+katana::analytics::Pattern::Cycle(size_t size, bool induced) {
+  Pattern pattern = Path(size, induced);
+  pattern.AddEdge(size - 1, 0);
+  return pattern;
+}
+
+katana::analytics::Pattern
+katana::analytics::Pattern::Path(size_t size, bool induced) {
+  Pattern pattern(induced);
+  for (size_t a = 0; a < size; ++a) {
+    pattern.AddNode();
+    if (a > 0) {
+      pattern.AddEdge(a - 1, a);
+    }
+  }
+  return pattern;
+}
+
+katana::analytics::Pattern
+katana::analytics::Pattern::Star(size_t size, bool induced) {
+  Pattern pattern(induced);
+  for (size_t a = 0; a < size; ++a) {
+    pattern.AddNode();
+    if (a > 0) {
+      pattern.AddEdge(0, a);
+    }
+  }
+  return pattern;
+}
+
+katana::Result<uint64_t>
+katana::analytics::CountPatternMatches(
+    PropertyGraph* pg, const Pattern& pattern, PatternMatchingPlan plan) {
+  return Match<false>(pg, pattern, plan, nullptr);
+}
+
+katana::Result<void>
+katana::analytics::ForEachPatternMatch(
+    PropertyGraph* pg, const Pattern& pattern,
+    const std::function<void(const std::vector<GraphTopologyTypes::Node>&)>&
+        fn,
+    PatternMatchingPlan plan) {
+  KATANA_CHECKED(Match<true>(pg, pattern, plan, fn));
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<katana::analytics::MotifCount>>
+katana::analytics::CountMotifs(
+    PropertyGraph* pg, size_t size, PatternMatchingPlan plan) {
+  if (size < 2 || size > kMaxMotifSize) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "motifs must have between 2 and {} nodes, not {}", kMaxMotifSize,
+        size);
+  }
+
+  std::vector<MotifCount> counts;
+  for (Pattern& shape : ConnectedShapes(size)) {
+    uint64_t count = KATANA_CHECKED(CountPatternMatches(pg, shape, plan));
+    counts.emplace_back(MotifCount{std::move(shape), count});
+  }
+  return counts;
+}
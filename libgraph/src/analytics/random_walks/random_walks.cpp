@@ -19,7 +19,10 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Sampling.h"
 
 using namespace katana::analytics;
 
@@ -37,138 +40,204 @@ struct Node2VecAlgo {
       SortedPropertyGraphView, NodeData, EdgeData>;
   using GNode = typename SortedGraphView::Node;
 
+  const SortedGraphView& graph_;
   const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
-
-  GNode FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
-      const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return graph.NumNodes();
-    }
-    double total_wt = degree[n];
 
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.OutEdges(n).begin() + edge_index;
-    return graph.OutEdgeDst(*ei);
+  /// Out-degree of each node, or 0 if the walks stop at the node
+  katana::NUMAArray<uint64_t> degree_;
+  /// Alias tables of the edge weights of each node, indexed by edge. A draw
+  /// picks the slot of an edge uniformly, then keeps the edge with
+  /// probability keep_ or takes the edge of the node at local index alias_.
+  /// Empty when all edges weigh the same.
+  katana::NUMAArray<float> keep_;
+  katana::NUMAArray<uint32_t> alias_;
+
+  const uint64_t key_{katana::analytics::SamplingKey(0)};
+  double prob_forward_;
+  double prob_backward_;
+  /// Bounds of the second-order bias of a step
+  double upper_bound_;
+  double lower_bound_;
+
+  Node2VecAlgo(const SortedGraphView& graph, const RandomWalksPlan& plan)
+      : graph_(graph),
+        plan_(plan),
+        prob_forward_(1.0 / plan.forward_probability()),
+        prob_backward_(1.0 / plan.backward_probability()),
+        upper_bound_(std::max({1.0, prob_forward_, prob_backward_})),
+        lower_bound_(std::min({1.0, prob_forward_, prob_backward_})) {
+    degree_.allocateBlocked(graph.NumNodes());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) { degree_[n] = graph.OutDegree(n); }, katana::no_stats());
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    double lower_bound = 1.0;
-
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+  /// Build the alias tables of the weights of edge_weight_property_name with
+  /// Vose's method, in time linear in the degree of each node. Walks stop at
+  /// nodes whose edges all weigh 0.
+  template <typename EdgeWeightType>
+  katana::Result<void> InitializeWeights(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+    using EdgeWeight = katana::PODProperty<EdgeWeightType>;
+    using WeightedGraphView = katana::TypedPropertyGraphView<
+        SortedPropertyGraphView, NodeData, std::tuple<EdgeWeight>>;
+    auto weighted = KATANA_CHECKED(
+        WeightedGraphView::Make(pg, {}, {edge_weight_property_name}));
+
+    keep_.allocateBlocked(weighted.NumEdges());
+    alias_.allocateBlocked(weighted.NumEdges());
+
+    struct Scratch {
+      std::vector<double> scaled;
+      std::vector<uint32_t> small;
+      std::vector<uint32_t> large;
+    };
+    katana::PerThreadStorage<Scratch> scratch;
+    katana::GAccumulator<uint64_t> negative_weights;
 
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
+        katana::iterate(weighted),
+        [&](GNode n) {
+          auto edges = weighted.OutEdges(n);
+          uint64_t degree = degree_[n];
+          auto first = *edges.begin();
+
+          Scratch& local = *scratch.getLocal();
+          local.scaled.resize(degree);
+          local.small.clear();
+          local.large.clear();
+
+          double total = 0;
+          for (uint64_t i = 0; i < degree; ++i) {
+            double weight =
+                weighted.template GetEdgeData<EdgeWeight>(*(edges.begin() + i));
+            if (!(weight >= 0)) {
+              negative_weights += 1;
+              degree_[n] = 0;
+              return;
+            }
+            local.scaled[i] = weight;
+            total += weight;
+          }
+          if (total == 0) {
+            degree_[n] = 0;
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
-
-          //Assumption: All edges have weight 1
-          auto nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.NumNodes());
-
-          walk.push_back(std::move(nbr));
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
-
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              break;
+          // slot i holds 1 / degree of probability, split between edge i and
+          // its alias
+          for (uint32_t i = 0; i < degree; ++i) {
+            local.scaled[i] *= degree / total;
+            (local.scaled[i] < 1 ? local.small : local.large).push_back(i);
+          }
+          while (!local.small.empty() && !local.large.empty()) {
+            uint32_t s = local.small.back();
+            uint32_t l = local.large.back();
+            local.small.pop_back();
+            keep_[first + s] = local.scaled[s];
+            alias_[first + s] = l;
+            local.scaled[l] -= 1 - local.scaled[s];
+            if (local.scaled[l] < 1) {
+              local.large.pop_back();
+              local.small.push_back(l);
             }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.NumNodes());
+          }
+          // what is left is 1 up to rounding
+          for (uint32_t i : local.small) {
+            keep_[first + i] = 1;
+            alias_[first + i] = i;
+          }
+          for (uint32_t i : local.large) {
+            keep_[first + i] = 1;
+            alias_[first + i] = i;
+          }
+        },
+        katana::steal(), katana::loopname("Node2vec alias tables"));
 
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
+    if (negative_weights.reduce() > 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "{} edges of {} have negative or undefined weights",
+          negative_weights.reduce(), edge_weight_property_name);
+    }
+    return katana::ResultSuccess();
+  }
 
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
-              } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (graph.HasEdge(prev, nbr)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
-              }
-            }
-          }
+  /// \returns the neighbor of n for the uniform number u in [0, 1)
+  GNode SampleNeighbor(GNode n, double u) const {
+    uint64_t degree = degree_[n];
+    double scaled = u * degree;
+    uint64_t slot = std::min<uint64_t>(scaled, degree - 1);
+    auto first = graph_.OutEdges(n).begin();
+    if (!keep_.empty()) {
+      auto e = *(first + slot);
+      // given the slot, the fraction of scaled is uniform in [0, 1) too
+      if (scaled - slot >= keep_[e]) {
+        slot = alias_[e];
+      }
+    }
+    return graph_.OutEdgeDst(*(first + slot));
+  }
 
-          walks->push(std::move(walk));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Node2vec walks"), katana::no_stats());
+  /// Write walk number walk to out, which has room for walk_length + 1
+  /// nodes. \returns the number of nodes written.
+  uint32_t Walk(uint64_t walk, uint32_t* out) const {
+    GNode n = walk % graph_.NumNodes();
+    if (degree_[n] == 0) {
+      return 0;
+    }
+    // the draws of a walk only depend on its number
+    const uint64_t walk_key = katana::analytics::SampleBits(key_, walk);
+    uint64_t draw = 0;
+    auto next_unit = [&]() {
+      return katana::analytics::SampleUnit(walk_key, draw++);
+    };
+
+    out[0] = n;
+    out[1] = SampleNeighbor(n, next_unit());
+    uint32_t length = 2;
+    for (; length <= plan_.walk_length(); ++length) {
+      GNode curr = out[length - 1];
+      GNode prev = out[length - 2];
+      if (degree_[curr] == 0) {
+        break;
+      }
 
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
+      // acceptance-rejection sampling of the second-order bias, proposing
+      // neighbors in proportion to their weights
+      GNode nbr;
+      while (true) {
+        nbr = SampleNeighbor(curr, next_unit());
+        double y = next_unit() * upper_bound_;
+        if (y <= lower_bound_) {
+          break;
+        }
+        double bias;
+        if (nbr == prev) {
+          bias = prob_backward_;
+        } else if (graph_.HasEdge(prev, nbr)) {
+          bias = 1.0;
+        } else {
+          bias = prob_forward_;
+        }
+        if (y <= bias) {
+          break;
+        }
+      }
+      out[length] = nbr;
     }
+    return length;
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  void operator()(RandomWalksBatch* batch) const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, batch->num_walks),
+        [&](uint64_t i) {
+          batch->lengths[i] = Walk(
+              batch->first_walk + i, batch->nodes.data() + i * batch->stride);
+        },
+        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
+        katana::loopname("Node2vec walks"), katana::no_stats());
   }
 };
 
@@ -183,6 +252,7 @@ struct Edge2VecAlgo {
   using GNode = typename SortedGraphView::Node;
 
   const RandomWalksPlan& plan_;
+  const uint64_t key_{katana::analytics::SamplingKey(0)};
   Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
 
   //transition matrix
@@ -212,19 +282,15 @@ struct Edge2VecAlgo {
         graph.OutEdgeDst(*ei), graph.GetEdgeData<EdgeType>(*ei));
   }
 
+  /// Generate the walks of EM iteration iter. The draws of walk idx are the
+  /// steps of node idx of a Philox keyed by iter, and the walks are added
+  /// in the order of idx, so they do not depend on the number of threads.
   void GraphRandomWalk(
-      const SortedGraphView& graph,
+      const SortedGraphView& graph, uint32_t iter,
       katana::InsertBag<std::vector<uint32_t>>* walks,
       katana::InsertBag<std::vector<uint32_t>>* types_walks,
       const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
+    const katana::Philox philox(katana::analytics::SampleBits(key_, iter));
 
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
@@ -235,6 +301,8 @@ struct Edge2VecAlgo {
     upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
 
     uint64_t total_walks = graph.size() * plan_.number_of_walks();
+    std::vector<std::vector<uint32_t>> new_walks(total_walks);
+    std::vector<std::vector<uint32_t>> new_types_walks(total_walks);
 
     katana::do_all(
         katana::iterate(uint64_t(0), total_walks),
@@ -246,8 +314,7 @@ struct Edge2VecAlgo {
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          katana::PhiloxStream random = philox.ForNode(idx);
 
           std::vector<uint32_t> walk;
           std::vector<uint32_t> types_vec;
@@ -255,7 +322,7 @@ struct Edge2VecAlgo {
           walk.push_back(n);
 
           //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          double prob = random.NextDouble();
 
           //Assumption: All edges have weight 1
           auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
@@ -278,7 +345,7 @@ struct Edge2VecAlgo {
             //acceptance-rejection sampling
             while (true) {
               //sample x
-              double prob = (*dist)(*generator.getLocal());
+              double prob = random.NextDouble();
 
               auto nbr_type_pair =
                   FindSampleNeighbor(graph, curr, degree, prob);
@@ -288,7 +355,7 @@ struct Edge2VecAlgo {
               EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
+              double y = random.NextDouble();
               y = y * upper_bound;
 
               //compute transition probability
@@ -315,41 +382,44 @@ struct Edge2VecAlgo {
 
           }  //end for
 
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
+          new_walks[idx] = std::move(walk);
+          new_types_walks[idx] = std::move(types_vec);
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Edge2vec walks"), katana::no_stats());
+
+    for (uint64_t idx = 0; idx < total_walks; ++idx) {
+      if (!new_walks[idx].empty()) {
+        walks->push(std::move(new_walks[idx]));
+        types_walks->push(std::move(new_types_walks[idx]));
+      }
+    }
   }
 
-  //compute the histogram of edge types for each walk
+  //compute the histogram of edge types for each walk, in the order of the
+  //walks so that the sums over them are reproducible
   std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
       const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
-    std::vector<std::vector<uint32_t>> num_edge_types_walks;
+    std::vector<const std::vector<uint32_t>*> types_walks_in_order;
+    for (const std::vector<uint32_t>& types_walk : types_walks) {
+      types_walks_in_order.push_back(&types_walk);
+    }
 
-    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
-        per_thread_num_edge_types_walks;
+    std::vector<std::vector<uint32_t>> num_edge_types_walks(
+        types_walks_in_order.size());
     katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
+        katana::iterate(size_t{0}, types_walks_in_order.size()),
+        [&](size_t i) {
           std::vector<uint32_t> num_edge_types(
               plan_.number_of_edge_types() + 1, 0);
 
-          for (auto type : types_walk) {
+          for (auto type : *types_walks_in_order[i]) {
             num_edge_types[type]++;
           }
 
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
+          num_edge_types_walks[i] = std::move(num_edge_types);
         });
 
-    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
-           *per_thread_num_edge_types_walks.getRemote(j)) {
-        num_edge_types_walks.push_back(std::move(num_edge_types));
-      }
-    }
-
     return num_edge_types_walks;
   }
 
@@ -450,7 +520,7 @@ struct Edge2VecAlgo {
       //E step; generate walks
       katana::InsertBag<std::vector<uint32_t>> types_walks;
 
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      GraphRandomWalk(graph, iter, walks, &types_walks, degree);
 
       //Update transition matrix
       std::vector<std::vector<uint32_t>> num_edge_types_walks =
@@ -503,13 +573,126 @@ RandomWalksWithWrap(
   return walks_in_vector;
 }
 
+/// Generate the node2vec walks of pg batch_size at a time into one reused
+/// batch and pass each batch to consume
+template <typename Consume>
+static katana::Result<void>
+Node2VecBatches(
+    katana::PropertyGraph* pg, uint64_t batch_size,
+    const std::string& edge_weight_property_name, const RandomWalksPlan& plan,
+    Consume consume) {
+  if (plan.algorithm() != RandomWalksPlan::kNode2Vec) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "flat random walks only support node2vec");
+  }
+  if (plan.walk_length() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "walk length must be positive");
+  }
+  if (batch_size == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "batch size must be positive");
+  }
+  katana::ReportPageAllocGuard page_alloc;
+
+  auto graph = KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
+  Node2VecAlgo algo(graph, plan);
+
+  if (!edge_weight_property_name.empty()) {
+    auto weights =
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name));
+    switch (weights->type()->id()) {
+    case arrow::UInt32Type::type_id:
+      KATANA_CHECKED(
+          algo.InitializeWeights<uint32_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::Int32Type::type_id:
+      KATANA_CHECKED(
+          algo.InitializeWeights<int32_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::UInt64Type::type_id:
+      KATANA_CHECKED(
+          algo.InitializeWeights<uint64_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::Int64Type::type_id:
+      KATANA_CHECKED(
+          algo.InitializeWeights<int64_t>(pg, edge_weight_property_name));
+      break;
+    case arrow::FloatType::type_id:
+      KATANA_CHECKED(
+          algo.InitializeWeights<float>(pg, edge_weight_property_name));
+      break;
+    case arrow::DoubleType::type_id:
+      KATANA_CHECKED(
+          algo.InitializeWeights<double>(pg, edge_weight_property_name));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "Unsupported type: {}",
+          weights->type()->ToString());
+    }
+  }
+
+  uint64_t total_walks = graph.NumNodes() * plan.number_of_walks();
+  RandomWalksBatch batch;
+  batch.stride = plan.walk_length() + 1;
+  if (total_walks == 0) {
+    return consume(&batch);
+  }
+  batch_size = std::min(batch_size, total_walks);
+  batch.nodes.allocateBlocked(batch_size * batch.stride);
+  batch.lengths.allocateBlocked(batch_size);
+
+  katana::StatTimer execTime("RandomWalks");
+  for (uint64_t first = 0; first < total_walks; first += batch_size) {
+    batch.first_walk = first;
+    batch.num_walks = std::min(batch_size, total_walks - first);
+    execTime.start();
+    algo(&batch);
+    execTime.stop();
+    KATANA_CHECKED(consume(&batch));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<RandomWalksBatch>
+katana::analytics::RandomWalksFlat(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan) {
+  RandomWalksBatch walks;
+  auto take = [&](RandomWalksBatch* batch) -> katana::Result<void> {
+    walks = std::move(*batch);
+    return katana::ResultSuccess();
+  };
+  uint64_t total_walks = pg->NumNodes() * plan.number_of_walks();
+  KATANA_CHECKED(Node2VecBatches(
+      pg, std::max<uint64_t>(total_walks, 1), edge_weight_property_name, plan,
+      take));
+  return walks;
+}
+
+katana::Result<void>
+katana::analytics::StreamRandomWalks(
+    PropertyGraph* pg, uint64_t batch_size, const RandomWalksSink& sink,
+    const std::string& edge_weight_property_name, RandomWalksPlan plan) {
+  return Node2VecBatches(
+      pg, batch_size, edge_weight_property_name, plan,
+      [&](RandomWalksBatch* batch) { return sink(*batch); });
+}
+
 katana::Result<std::vector<std::vector<uint32_t>>>
 katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
-    auto graph =
-        KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    auto walks = KATANA_CHECKED(RandomWalksFlat(pg, "", plan));
+    std::vector<std::vector<uint32_t>> walks_in_vector;
+    for (uint64_t i = 0; i < walks.num_walks; ++i) {
+      if (walks.lengths[i] > 0) {
+        walks_in_vector.emplace_back(walks.walk_begin(i), walks.walk_end(i));
+      }
+    }
+    return walks_in_vector;
   }
   case RandomWalksPlan::kEdge2Vec: {
     TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
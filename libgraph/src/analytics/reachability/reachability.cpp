@@ -0,0 +1,452 @@
+#include "katana/analytics/reachability/reachability.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <unordered_set>
+
+#include "katana/Bag.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/Sampling.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+using katana::analytics::ReachabilityIndex;
+using katana::analytics::ReachabilityIndexPlan;
+
+namespace {
+
+/// The labels of a component are its level, the first post-order rank of
+/// its subtree in the first traversal, then the lowest rank it reaches and
+/// its own rank in each traversal
+constexpr uint32_t kLevelLabel = 0;
+constexpr uint32_t kTreeLowLabel = 1;
+constexpr uint32_t kFirstIntervalLabel = 2;
+
+uint32_t
+LabelWidth(uint32_t num_traversals) {
+  return kFirstIntervalLabel + 2 * num_traversals;
+}
+
+/// The DAG of the strongly connected components as a CSR, with the end of
+/// the out-edges of every component in indices
+struct Dag {
+  uint32_t num_components{0};
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+
+  uint64_t begin(uint32_t c) const { return c == 0 ? 0 : indices[c - 1]; }
+  uint64_t end(uint32_t c) const { return indices[c]; }
+};
+
+/// \returns the component of every node of pg, with dense ids
+katana::Result<std::vector<uint32_t>>
+ComputeComponents(katana::PropertyGraph* pg, uint32_t* num_components) {
+  katana::analytics::TemporaryPropertyGuard component_property{
+      pg->NodeMutablePropertyView()};
+  katana::TxnContext txn_ctx;
+  KATANA_CHECKED(katana::analytics::StronglyConnectedComponents(
+      pg, component_property.name(), &txn_ctx));
+  auto property = KATANA_CHECKED(
+      pg->GetNodePropertyTyped<uint64_t>(component_property.name()));
+
+  std::vector<uint32_t> components(pg->NumNodes());
+  katana::GReduceMax<uint64_t> max_component;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->NumNodes()),
+      [&](uint64_t n) {
+        components[n] = property->Value(n);
+        max_component.update(property->Value(n));
+      },
+      katana::no_stats(), katana::loopname("Reachability_Components"));
+  *num_components = pg->NumNodes() == 0
+                        ? 0
+                        : static_cast<uint32_t>(max_component.reduce()) + 1;
+  return components;
+}
+
+/// Condense the edges of pg between components into a DAG without parallel
+/// edges
+Dag
+Condense(
+    const katana::PropertyGraph* pg, const std::vector<uint32_t>& components,
+    uint32_t num_components) {
+  const katana::GraphTopology& topo = pg->topology();
+  katana::InsertBag<uint64_t> bag;
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](uint32_t n) {
+        uint64_t src = components[n];
+        for (auto e : topo.OutEdges(n)) {
+          uint64_t dst = components[topo.OutEdgeDst(e)];
+          if (dst != src) {
+            bag.push((src << 32) | dst);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("Reachability_Condense"));
+
+  std::vector<uint64_t> edges(bag.begin(), bag.end());
+  katana::ParallelSTL::radix_sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  Dag dag;
+  dag.num_components = num_components;
+  dag.indices.resize(num_components);
+  dag.dests.resize(edges.size());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_components),
+      [&](uint32_t c) {
+        dag.indices[c] =
+            std::lower_bound(
+                edges.begin(), edges.end(), (uint64_t{c} + 1) << 32) -
+            edges.begin();
+      },
+      katana::no_stats(), katana::loopname("Reachability_DagIndices"));
+  katana::do_all(
+      katana::iterate(size_t{0}, edges.size()),
+      [&](size_t i) { dag.dests[i] = static_cast<uint32_t>(edges[i]); },
+      katana::no_stats(), katana::loopname("Reachability_DagDests"));
+  return dag;
+}
+
+/// Compute the level of every component, the length of the longest path
+/// to it from a component without in-edges, one level at a time
+///
+/// \returns the components without in-edges
+std::vector<uint32_t>
+ComputeLevels(const Dag& dag, std::vector<uint32_t>* levels) {
+  katana::NUMAArray<std::atomic<uint32_t>> in_degree;
+  in_degree.allocateBlocked(dag.num_components);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, dag.num_components),
+      [&](uint32_t c) { in_degree[c].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, dag.dests.size()),
+      [&](size_t i) {
+        in_degree[dag.dests[i]].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats(), katana::loopname("Reachability_InDegree"));
+
+  katana::InsertBag<uint32_t> sources;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, dag.num_components),
+      [&](uint32_t c) {
+        if (in_degree[c].load(std::memory_order_relaxed) == 0) {
+          sources.push(c);
+        }
+      },
+      katana::no_stats());
+  std::vector<uint32_t> roots(sources.begin(), sources.end());
+
+  levels->resize(dag.num_components);
+  auto current = std::make_unique<katana::InsertBag<uint32_t>>();
+  auto next = std::make_unique<katana::InsertBag<uint32_t>>();
+  for (uint32_t root : roots) {
+    current->push(root);
+  }
+  for (uint32_t level = 0; !current->empty(); ++level) {
+    katana::do_all(
+        katana::iterate(*current),
+        [&](uint32_t c) {
+          (*levels)[c] = level;
+          for (uint64_t e = dag.begin(c); e < dag.end(c); ++e) {
+            uint32_t dst = dag.dests[e];
+            // the last in-edge to be removed is on a longest path to dst
+            if (in_degree[dst].fetch_sub(1, std::memory_order_relaxed) == 1) {
+              next->push(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("Reachability_Levels"));
+    current->clear();
+    std::swap(current, next);
+  }
+  return roots;
+}
+
+/// One randomized depth-first traversal of the DAG from its roots, which
+/// ranks the components in post-order and computes the lowest rank every
+/// component reaches. tree_low, if given, gets the first rank of the
+/// subtree of every component in the traversal tree.
+void
+Traverse(
+    const Dag& dag, const std::vector<uint32_t>& roots, uint64_t key,
+    uint32_t* lows, uint32_t* ranks, uint32_t* tree_lows) {
+  struct Frame {
+    uint32_t component;
+    uint32_t first_rank;
+    uint64_t rotation;
+    uint64_t visited;
+  };
+
+  std::vector<uint32_t> order(roots);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return katana::analytics::SampleBits(key, a) <
+           katana::analytics::SampleBits(key, b);
+  });
+
+  // ranks start from 1 so that 0 marks components not visited yet
+  std::fill_n(ranks, dag.num_components, 0);
+  uint32_t next_rank = 1;
+  std::vector<Frame> frames;
+  auto visit = [&](uint32_t c) {
+    uint64_t degree = dag.end(c) - dag.begin(c);
+    uint64_t rotation =
+        degree == 0 ? 0 : katana::analytics::SampleBits(key, c) % degree;
+    // mark the component as visited until it gets its rank
+    ranks[c] = std::numeric_limits<uint32_t>::max();
+    lows[c] = std::numeric_limits<uint32_t>::max();
+    frames.emplace_back(Frame{c, next_rank, rotation, 0});
+  };
+
+  for (uint32_t root : order) {
+    visit(root);
+    while (!frames.empty()) {
+      Frame& frame = frames.back();
+      uint32_t c = frame.component;
+      uint64_t begin = dag.begin(c);
+      uint64_t degree = dag.end(c) - begin;
+      if (frame.visited < degree) {
+        uint32_t child =
+            dag.dests[begin + (frame.rotation + frame.visited) % degree];
+        ++frame.visited;
+        if (ranks[child] == 0) {
+          visit(child);
+        } else {
+          lows[c] = std::min(lows[c], lows[child]);
+        }
+        continue;
+      }
+
+      ranks[c] = next_rank++;
+      lows[c] = std::min(lows[c], ranks[c]);
+      if (tree_lows) {
+        tree_lows[c] = frame.first_rank;
+      }
+      frames.pop_back();
+      if (!frames.empty()) {
+        uint32_t parent = frames.back().component;
+        lows[parent] = std::min(lows[parent], lows[c]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+ReachabilityIndex::ReachabilityIndex(
+    katana::ReachabilityIndexPrimitive&& primitive)
+    : primitive_(std::move(primitive)),
+      components_(primitive_.components()),
+      dag_indices_(primitive_.dag_indices()),
+      dag_dests_(primitive_.dag_dests()),
+      labels_(primitive_.labels()),
+      label_width_(primitive_.label_width()) {}
+
+katana::Result<ReachabilityIndex>
+ReachabilityIndex::Build(
+    katana::PropertyGraph* pg, ReachabilityIndexPlan plan) {
+  if (plan.algorithm() != ReachabilityIndexPlan::kGrail) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  if (plan.num_traversals() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "there must be at least one traversal");
+  }
+  if (pg->NumNodes() > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "graphs of more than 2^32 - 1 nodes are not supported");
+  }
+
+  katana::StatTimer exec_time("ReachabilityIndex", "ReachabilityIndex");
+  exec_time.start();
+
+  uint32_t num_components = 0;
+  std::vector<uint32_t> components =
+      KATANA_CHECKED(ComputeComponents(pg, &num_components));
+  Dag dag = Condense(pg, components, num_components);
+  katana::ReportStatSingle(
+      "ReachabilityIndex", "Components", uint64_t{num_components});
+  katana::ReportStatSingle("ReachabilityIndex", "DagEdges", dag.dests.size());
+
+  std::vector<uint32_t> levels;
+  std::vector<uint32_t> roots = ComputeLevels(dag, &levels);
+
+  // the traversals are serial, so they run in parallel with each other
+  const uint32_t num_traversals = plan.num_traversals();
+  const uint64_t key = katana::analytics::SamplingKey(plan.seed());
+  std::vector<std::vector<uint32_t>> lows(num_traversals);
+  std::vector<std::vector<uint32_t>> ranks(num_traversals);
+  std::vector<uint32_t> tree_lows(num_components);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_traversals),
+      [&](uint32_t t) {
+        lows[t].resize(num_components);
+        ranks[t].resize(num_components);
+        Traverse(
+            dag, roots, katana::analytics::SampleBits(key, t), lows[t].data(),
+            ranks[t].data(), t == 0 ? tree_lows.data() : nullptr);
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats(),
+      katana::loopname("Reachability_Traverse"));
+
+  const uint32_t label_width = LabelWidth(num_traversals);
+  std::vector<uint32_t> labels(uint64_t{num_components} * label_width);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_components),
+      [&](uint32_t c) {
+        uint32_t* label = labels.data() + uint64_t{c} * label_width;
+        label[kLevelLabel] = levels[c];
+        label[kTreeLowLabel] = tree_lows[c];
+        for (uint32_t t = 0; t < num_traversals; ++t) {
+          label[kFirstIntervalLabel + 2 * t] = lows[t][c];
+          label[kFirstIntervalLabel + 2 * t + 1] = ranks[t][c];
+        }
+      },
+      katana::no_stats(), katana::loopname("Reachability_Labels"));
+
+  exec_time.stop();
+
+  katana::ReachabilityIndexPrimitive primitive;
+  primitive.set_num_edges(pg->NumEdges());
+  primitive.set_components(std::move(components));
+  primitive.set_dag(std::move(dag.indices), std::move(dag.dests));
+  primitive.set_labels(std::move(labels), label_width);
+  return ReachabilityIndex(std::move(primitive));
+}
+
+katana::Result<std::optional<ReachabilityIndex>>
+ReachabilityIndex::Load(katana::PropertyGraph* pg) {
+  std::optional<katana::ReachabilityIndexPrimitive> primitive =
+      KATANA_CHECKED(pg->LoadReachabilityIndexPrimitive());
+  if (!primitive) {
+    return std::nullopt;
+  }
+  if (primitive->num_nodes() != pg->NumNodes() ||
+      primitive->num_edges() != pg->NumEdges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "reachability index was built for a graph of {} nodes and {} edges, "
+        "not {} nodes and {} edges",
+        primitive->num_nodes(), primitive->num_edges(), pg->NumNodes(),
+        pg->NumEdges());
+  }
+  if (primitive->label_width() < LabelWidth(1) ||
+      (primitive->label_width() - kFirstIntervalLabel) % 2 != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "reachability index has {} labels per component, which is not 2 per "
+        "traversal plus 2",
+        primitive->label_width());
+  }
+  return ReachabilityIndex(std::move(primitive.value()));
+}
+
+katana::Result<void>
+ReachabilityIndex::Write(katana::PropertyGraph* pg) {
+  KATANA_CHECKED(pg->WriteReachabilityIndexPrimitive(primitive_));
+  return katana::ResultSuccess();
+}
+
+bool
+ReachabilityIndex::MayReach(uint32_t source, uint32_t target) const {
+  if (Level(source) >= Level(target)) {
+    return false;
+  }
+  const uint32_t* s = labels_ + uint64_t{source} * label_width_;
+  const uint32_t* t = labels_ + uint64_t{target} * label_width_;
+  for (uint32_t i = kFirstIntervalLabel; i < label_width_; i += 2) {
+    // the interval of the target must lie within that of the source
+    if (t[i] < s[i] || t[i + 1] > s[i + 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+ReachabilityIndex::SurelyReaches(uint32_t source, uint32_t target) const {
+  const uint32_t* s = labels_ + uint64_t{source} * label_width_;
+  const uint32_t* t = labels_ + uint64_t{target} * label_width_;
+  // the subtree of the source in the first traversal holds the target
+  uint32_t target_rank = t[kFirstIntervalLabel + 1];
+  return s[kTreeLowLabel] <= target_rank &&
+         target_rank <= s[kFirstIntervalLabel + 1];
+}
+
+bool
+ReachabilityIndex::SearchDag(uint32_t source, uint32_t target) const {
+  std::vector<uint32_t> stack{source};
+  std::unordered_set<uint32_t> visited{source};
+  while (!stack.empty()) {
+    uint32_t c = stack.back();
+    stack.pop_back();
+    uint64_t begin = c == 0 ? 0 : dag_indices_[c - 1];
+    for (uint64_t e = begin; e < dag_indices_[c]; ++e) {
+      uint32_t dst = dag_dests_[e];
+      if (dst == target) {
+        return true;
+      }
+      if (!MayReach(dst, target) || !visited.insert(dst).second) {
+        continue;
+      }
+      if (SurelyReaches(dst, target)) {
+        return true;
+      }
+      stack.push_back(dst);
+    }
+  }
+  return false;
+}
+
+bool
+ReachabilityIndex::CanReach(uint32_t source, uint32_t target) const {
+  uint32_t s = components_[source];
+  uint32_t t = components_[target];
+  if (s == t) {
+    return true;
+  }
+  if (!MayReach(s, t)) {
+    return false;
+  }
+  if (SurelyReaches(s, t)) {
+    return true;
+  }
+  return SearchDag(s, t);
+}
+
+katana::Result<katana::DynamicBitset>
+ReachabilityIndex::CanReach(const QueryList& queries) const {
+  for (const auto& [source, target] : queries) {
+    if (source >= num_nodes() || target >= num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "query from {} to {} in a graph of {} nodes", source, target,
+          num_nodes());
+    }
+  }
+
+  katana::DynamicBitset reachable;
+  reachable.resize(queries.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, queries.size()),
+      [&](size_t i) {
+        if (CanReach(queries[i].first, queries[i].second)) {
+          reachable.set(i);
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("Reachability_Queries"));
+  return reachable;
+}
@@ -0,0 +1,410 @@
+#include "katana/analytics/shortest_path/shortest_path.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Graph = katana::PropertyGraphViews::BiDirectional;
+using Node = Graph::Node;
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+/// The weight of every edge is 1
+struct UnitWeight {
+  double operator()(uint64_t) const { return 1; }
+};
+
+/// The weight of an edge is the value of its row of an edge property
+template <typename Weight>
+struct ColumnWeight {
+  const Weight* values;
+  double operator()(uint64_t row) const { return values[row]; }
+};
+
+/// The potential of the searches: the average of the landmark bound on the
+/// distance to the target and minus the bound on the distance from the
+/// source. Forward keys add it and backward keys subtract it, so both
+/// searches see the same nonnegative reduced edge weights and the sum of
+/// their smallest keys bounds the paths they have not found yet. Nodes that
+/// the landmarks prove unreachable from the source, or unable to reach the
+/// target, get an infinite potential.
+class Potential {
+public:
+  Potential(const LandmarkIndex* landmarks, Node source, Node target)
+      : landmarks_(landmarks) {
+    if (landmarks_ == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < landmarks_->num_landmarks(); ++i) {
+      from_source_.emplace_back(landmarks_->Distance(i, source));
+      to_target_.emplace_back(landmarks_->Distance(i, target));
+    }
+  }
+
+  double operator()(Node n) const {
+    if (landmarks_ == nullptr) {
+      return 0;
+    }
+    double to_target = 0;
+    double from_source = 0;
+    for (size_t i = 0; i < from_source_.size(); ++i) {
+      double d = landmarks_->Distance(i, n);
+      if (std::isfinite(d)) {
+        // the landmark reaches n but not the target, so n does not either
+        if (!std::isfinite(to_target_[i])) {
+          return kInfinity;
+        }
+        to_target = std::max(to_target, to_target_[i] - d);
+      }
+      if (std::isfinite(from_source_[i])) {
+        // the landmark reaches the source but not n, so the source does not
+        // either
+        if (!std::isfinite(d)) {
+          return kInfinity;
+        }
+        from_source = std::max(from_source, d - from_source_[i]);
+      }
+    }
+    return (to_target - from_source) / 2;
+  }
+
+private:
+  const LandmarkIndex* landmarks_;
+  std::vector<double> from_source_;
+  std::vector<double> to_target_;
+};
+
+/// The state of one of the two searches
+struct Search {
+  struct Label {
+    double distance;
+    /// The node before this one on the path from the start of the search
+    Node parent;
+    double potential;
+    bool settled;
+  };
+  /// key, distance, node
+  using Entry = std::tuple<double, double, Node>;
+
+  Search(Node start, double start_potential, double sign) : sign(sign) {
+    labels.emplace(start, Label{0, start, start_potential, false});
+    queue.emplace(sign * start_potential, 0, start);
+  }
+
+  double Distance(Node n) const {
+    auto it = labels.find(n);
+    return it == labels.end() ? kInfinity : it->second.distance;
+  }
+
+  /// +1 for the forward search and -1 for the backward search
+  double sign;
+  std::unordered_map<Node, Label> labels;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+};
+
+/// Settle the next node of search, relaxing its edges, and update the best
+/// path found so far through a node the other search has reached
+template <typename Edges, typename Neighbor, typename Row, typename EdgeWeight>
+katana::Result<void>
+Step(
+    Search* search, const Search& other, const Potential& potential,
+    const Edges& edges, const Neighbor& neighbor, const Row& row,
+    const EdgeWeight& weight, double* best, Node* meet,
+    uint64_t* settled_nodes) {
+  auto [key, distance, n] = search->queue.top();
+  search->queue.pop();
+  Search::Label& label = search->labels.at(n);
+  if (label.settled || distance > label.distance) {
+    return katana::ResultSuccess();
+  }
+  label.settled = true;
+  ++*settled_nodes;
+
+  for (auto e : edges(n)) {
+    double w = weight(row(e));
+    if (w < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights must not be negative, found {}", w);
+    }
+    Node m = neighbor(e);
+    double d = distance + w;
+    auto [it, inserted] =
+        search->labels.try_emplace(m, Search::Label{kInfinity, n, 0, false});
+    Search::Label& next = it->second;
+    if (inserted) {
+      next.potential = potential(m);
+    }
+    if (!std::isfinite(next.potential) || d >= next.distance) {
+      continue;
+    }
+    next.distance = d;
+    next.parent = n;
+    search->queue.emplace(d + search->sign * next.potential, d, m);
+    double through = d + other.Distance(m);
+    if (through < *best) {
+      *best = through;
+      *meet = m;
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename EdgeWeight>
+katana::Result<ShortestPathResult>
+BidirectionalSearch(
+    const Graph& graph, Node source, Node target, const EdgeWeight& weight,
+    const LandmarkIndex* landmarks) {
+  ShortestPathResult result;
+  Potential potential(landmarks, source, target);
+  double source_potential = potential(source);
+  double target_potential = potential(target);
+  if (!std::isfinite(source_potential) || !std::isfinite(target_potential)) {
+    return result;
+  }
+  if (source == target) {
+    result.distance = 0;
+    result.path.emplace_back(source);
+    return result;
+  }
+
+  Search forward(source, source_potential, 1);
+  Search backward(target, target_potential, -1);
+  double best = kInfinity;
+  Node meet = source;
+
+  auto out_edges = [&](Node n) { return graph.OutEdges(n); };
+  auto out_dst = [&](auto e) { return graph.OutEdgeDst(e); };
+  auto out_row = [&](auto e) {
+    return graph.GetEdgePropertyIndexFromOutEdge(e);
+  };
+  auto in_edges = [&](Node n) { return graph.InEdges(n); };
+  auto in_src = [&](auto e) { return graph.InEdgeSrc(e); };
+  auto in_row = [&](auto e) {
+    return graph.GetEdgePropertyIndexFromInEdge(e);
+  };
+
+  while (!forward.queue.empty() && !backward.queue.empty()) {
+    if (std::get<0>(forward.queue.top()) + std::get<0>(backward.queue.top()) >=
+        best) {
+      break;
+    }
+    // grow the smaller frontier
+    if (forward.queue.size() <= backward.queue.size()) {
+      KATANA_CHECKED(Step(
+          &forward, backward, potential, out_edges, out_dst, out_row, weight,
+          &best, &meet, &result.settled_nodes));
+    } else {
+      KATANA_CHECKED(Step(
+          &backward, forward, potential, in_edges, in_src, in_row, weight,
+          &best, &meet, &result.settled_nodes));
+    }
+  }
+
+  if (!std::isfinite(best)) {
+    return result;
+  }
+  result.distance = best;
+  for (Node n = meet; n != source; n = forward.labels.at(n).parent) {
+    result.path.emplace_back(n);
+  }
+  result.path.emplace_back(source);
+  std::reverse(result.path.begin(), result.path.end());
+  for (Node n = meet; n != target;) {
+    n = backward.labels.at(n).parent;
+    result.path.emplace_back(n);
+  }
+  return result;
+}
+
+template <typename Weight>
+katana::Result<ShortestPathResult>
+SearchWithWeights(
+    katana::PropertyGraph* pg, const Graph& graph, Node source, Node target,
+    const std::string& edge_weight_property_name,
+    const LandmarkIndex* landmarks) {
+  auto weights = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+  return BidirectionalSearch(
+      graph, source, target, ColumnWeight<Weight>{weights->raw_values()},
+      landmarks);
+}
+
+/// Copy the distances of one landmark, marking unreachable nodes infinite
+template <typename Distance>
+katana::Result<void>
+LoadDistances(
+    katana::PropertyGraph* pg, const std::string& property_name, size_t index,
+    size_t num_landmarks, katana::NUMAArray<double>* distances) {
+  auto column =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<Distance>(property_name));
+  const Distance* values = column->raw_values();
+  constexpr Distance kUnreached = std::numeric_limits<Distance>::max() / 4;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->NumNodes()),
+      [&](uint64_t n) {
+        (*distances)[n * num_landmarks + index] =
+            values[n] >= kUnreached ? kInfinity : double(values[n]);
+      },
+      katana::no_stats(), katana::loopname("LandmarkIndex_Load"));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<LandmarkIndex>
+katana::analytics::LandmarkIndex::Build(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& landmarks,
+    const std::string& edge_weight_property_name,
+    const std::vector<std::string>& property_names,
+    katana::TxnContext* txn_ctx) {
+  for (uint32_t landmark : landmarks) {
+    if (landmark >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "landmark {} is not a node",
+          landmark);
+    }
+  }
+  KATANA_CHECKED(MultiSourceSssp(
+      pg, landmarks, edge_weight_property_name, property_names, txn_ctx));
+  return Load(pg, property_names);
+}
+
+katana::Result<LandmarkIndex>
+katana::analytics::LandmarkIndex::Load(
+    katana::PropertyGraph* pg, const std::vector<std::string>& property_names) {
+  const size_t num_landmarks = property_names.size();
+  katana::NUMAArray<double> distances;
+  distances.allocateBlocked(pg->NumNodes() * num_landmarks);
+
+  for (size_t i = 0; i < num_landmarks; ++i) {
+    const std::string& name = property_names[i];
+    KATANA_CHECKED(pg->EnsureNodePropertyLoaded(name));
+    auto type = KATANA_CHECKED(pg->GetNodeProperty(name))->type();
+    switch (type->id()) {
+    case arrow::UInt32Type::type_id:
+      KATANA_CHECKED(
+          LoadDistances<uint32_t>(pg, name, i, num_landmarks, &distances));
+      break;
+    case arrow::Int32Type::type_id:
+      KATANA_CHECKED(
+          LoadDistances<int32_t>(pg, name, i, num_landmarks, &distances));
+      break;
+    case arrow::UInt64Type::type_id:
+      KATANA_CHECKED(
+          LoadDistances<uint64_t>(pg, name, i, num_landmarks, &distances));
+      break;
+    case arrow::Int64Type::type_id:
+      KATANA_CHECKED(
+          LoadDistances<int64_t>(pg, name, i, num_landmarks, &distances));
+      break;
+    case arrow::FloatType::type_id:
+      KATANA_CHECKED(
+          LoadDistances<float>(pg, name, i, num_landmarks, &distances));
+      break;
+    case arrow::DoubleType::type_id:
+      KATANA_CHECKED(
+          LoadDistances<double>(pg, name, i, num_landmarks, &distances));
+      break;
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError,
+          "landmark distances {} have unsupported type {}", name,
+          type->ToString());
+    }
+  }
+  return LandmarkIndex(num_landmarks, std::move(distances));
+}
+
+std::vector<uint32_t>
+katana::analytics::LandmarkIndex::ChooseByDegree(
+    const katana::PropertyGraph* pg, size_t num_landmarks) {
+  const GraphTopology& topology = pg->topology();
+  katana::NUMAArray<uint32_t> nodes;
+  nodes.allocateBlocked(topology.NumNodes());
+  katana::ParallelSTL::iota(nodes.begin(), nodes.end(), uint32_t{0});
+  katana::ParallelSTL::sort(
+      nodes.begin(), nodes.end(), [&](uint32_t a, uint32_t b) {
+        auto degree_a = topology.OutDegree(a);
+        auto degree_b = topology.OutDegree(b);
+        return degree_a > degree_b || (degree_a == degree_b && a < b);
+      });
+  size_t count = std::min<size_t>(num_landmarks, nodes.size());
+  return std::vector<uint32_t>(nodes.begin(), nodes.begin() + count);
+}
+
+katana::Result<ShortestPathResult>
+katana::analytics::ShortestPath(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t target,
+    const std::string& edge_weight_property_name,
+    const LandmarkIndex* landmarks) {
+  if (source >= pg->NumNodes() || target >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} and target {} must be among the {} nodes of the graph",
+        source, target, pg->NumNodes());
+  }
+  if (landmarks != nullptr && landmarks->num_landmarks() > 0 &&
+      landmarks->num_nodes() != pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "landmark index of {} nodes for a graph of {} nodes",
+        landmarks->num_nodes(), pg->NumNodes());
+  }
+
+  Graph graph = pg->BuildView<Graph>();
+  if (edge_weight_property_name.empty()) {
+    return BidirectionalSearch(graph, source, target, UnitWeight{}, landmarks);
+  }
+
+  const std::string& name = edge_weight_property_name;
+  KATANA_CHECKED(pg->EnsureEdgePropertyLoaded(name));
+  auto type = KATANA_CHECKED(pg->GetEdgeProperty(name))->type();
+  switch (type->id()) {
+  case arrow::UInt32Type::type_id:
+    return SearchWithWeights<uint32_t>(
+        pg, graph, source, target, name, landmarks);
+  case arrow::Int32Type::type_id:
+    return SearchWithWeights<int32_t>(
+        pg, graph, source, target, name, landmarks);
+  case arrow::UInt64Type::type_id:
+    return SearchWithWeights<uint64_t>(
+        pg, graph, source, target, name, landmarks);
+  case arrow::Int64Type::type_id:
+    return SearchWithWeights<int64_t>(
+        pg, graph, source, target, name, landmarks);
+  case arrow::FloatType::type_id:
+    return SearchWithWeights<float>(pg, graph, source, target, name, landmarks);
+  case arrow::DoubleType::type_id:
+    return SearchWithWeights<double>(
+        pg, graph, source, target, name, landmarks);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        type->ToString());
+  }
+}
+
+void
+katana::analytics::ShortestPathResult::Print(std::ostream& os) const {
+  if (!reachable()) {
+    os << "Target is not reachable" << std::endl;
+  } else {
+    os << "Distance = " << distance << std::endl;
+    os << "Number of nodes on the path = " << path.size() << std::endl;
+  }
+  os << "Number of settled nodes = " << settled_nodes << std::endl;
+}
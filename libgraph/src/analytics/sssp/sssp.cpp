@@ -19,10 +19,18 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "katana/PriorityQueue.h"
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/IterationMetrics.h"
 #include "katana/gstl.h"
 
 using namespace katana::analytics;
@@ -136,8 +144,10 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     using Buckets = katana::gstl::Vector<Bucket>;
 
     katana::PerThreadStorage<Buckets> buckets;
+    katana::GAccumulator<size_t> edges_relaxed;
 
     auto relax = [&](Node n, Dist sdist, Buckets& b) {
+      edges_relaxed += graph->OutDegree(n);
       for (auto ii : graph->OutEdges(n)) {
         auto dest = graph->OutEdgeDst(ii);
         auto& ddist = (*node_data)[dest];
@@ -156,19 +166,26 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     };
 
     katana::GAccumulator<size_t> fused_rounds;
+    katana::GAccumulator<size_t> round_nodes;
 
     katana::InsertBag<Node> wl;
     wl.push_back(source);
 
     size_t cur_bucket = 0;
 
+    // the convergence is the distance of the bucket of the round
+    IterationReporter reporter("sssp_delta_step_fusion");
+
     for (size_t rounds = 1; true; ++rounds) {
       Dist cur_dist = cur_bucket * (1 << stepShift);
+      round_nodes.reset();
+      edges_relaxed.reset();
       katana::do_all(
           katana::iterate(wl),
           [&](const Node& n) {
             Dist sdist = (*node_data)[n];
             if (sdist >= cur_dist) {
+              round_nodes += 1;
               relax(n, sdist, *buckets.getLocal());
             }
           },
@@ -198,6 +215,8 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
           break;
         }
       });
+      reporter.Report(
+          rounds, cur_dist, round_nodes.reduce(), edges_relaxed.reduce());
 
       wl.clear();
 
@@ -225,6 +244,151 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     }
   }
 
+  /// Delta stepping with fused buckets, like DeltaStepFusionAlgo, but each
+  /// round relaxes a window of width consecutive buckets of 2^stepShift. The
+  /// width doubles after rounds with too few nodes to keep the threads busy
+  /// and halves after rounds where many improvements are to nodes that were
+  /// already reached, so the step size follows the occupancy of the buckets
+  /// and the work they redo.
+  static void DeltaStepAdaptiveAlgo(
+      katana::NUMAArray<std::atomic<Weight>>* node_data,
+      katana::NUMAArray<Weight>* edge_data, Graph* graph,
+      const typename Graph::Node& source, unsigned stepShift) {
+    constexpr size_t kMaxFusion = 1000;
+    constexpr size_t kMaxWidth = size_t{1} << 20;
+    // below this many nodes a round is mostly barrier
+    const size_t min_round_nodes = 64 * katana::getActiveThreads();
+
+    using Node = typename Graph::Node;
+    using Bucket = katana::gstl::Vector<Node>;
+    using Buckets = katana::gstl::Vector<Bucket>;
+
+    katana::PerThreadStorage<Buckets> buckets;
+    katana::GAccumulator<size_t> improved;
+    katana::GAccumulator<size_t> improved_reached;
+    katana::GAccumulator<size_t> edges_relaxed;
+
+    auto relax = [&](Node n, Dist sdist, Buckets& b) {
+      edges_relaxed += graph->OutDegree(n);
+      for (auto ii : graph->OutEdges(n)) {
+        auto dest = graph->OutEdgeDst(ii);
+        auto& ddist = (*node_data)[dest];
+        Dist ew = (*edge_data)[ii];
+        const Dist new_dist = sdist + ew;
+
+        Dist old_dist = katana::atomicMin(ddist, new_dist);
+        if (new_dist < old_dist) {
+          improved += 1;
+          if (old_dist != kDistanceInfinity) {
+            improved_reached += 1;
+          }
+          size_t idx = new_dist / (1 << stepShift);
+          if (idx >= b.size()) {
+            b.resize(idx + 1);
+          }
+          b[idx].push_back(dest);
+        }
+      }
+    };
+
+    katana::GAccumulator<size_t> fused_rounds;
+    katana::GAccumulator<size_t> round_nodes;
+
+    katana::InsertBag<Node> wl;
+    wl.push_back(source);
+
+    size_t cur_bucket = 0;
+    size_t width = 1;
+    size_t max_width = 1;
+
+    // the convergence is the distance of the first bucket of the round
+    IterationReporter reporter("sssp_delta_step_adaptive");
+
+    for (size_t rounds = 1; true; ++rounds) {
+      Dist cur_dist = cur_bucket * (1 << stepShift);
+      size_t window_end = cur_bucket + width;
+      improved.reset();
+      improved_reached.reset();
+      round_nodes.reset();
+      edges_relaxed.reset();
+
+      katana::do_all(
+          katana::iterate(wl),
+          [&](const Node& n) {
+            Dist sdist = (*node_data)[n];
+            if (sdist >= cur_dist) {
+              round_nodes += 1;
+              relax(n, sdist, *buckets.getLocal());
+            }
+          },
+          katana::wl<PSchunk>, katana::steal());
+
+      katana::GReduceMin<size_t> least_bucket;
+
+      katana::on_each([&](unsigned, unsigned) {
+        Buckets& b = *buckets.getLocal();
+
+        // relaxing a bucket only fills it or later ones
+        for (size_t idx = cur_bucket; idx < std::min(window_end, b.size());) {
+          if (b[idx].empty()) {
+            ++idx;
+            continue;
+          }
+          if (b[idx].size() >= kMaxFusion) {
+            break;
+          }
+          fused_rounds.update(1);
+          Bucket cur;
+          std::swap(b[idx], cur);
+          for (Node n : cur) {
+            Dist sdist = (*node_data)[n];
+            relax(n, sdist, b);
+          }
+        }
+
+        for (size_t idx = cur_bucket; idx < b.size(); ++idx) {
+          if (b[idx].empty()) {
+            continue;
+          }
+          least_bucket.update(idx);
+          break;
+        }
+      });
+
+      reporter.Report(
+          rounds, cur_dist, round_nodes.reduce(), edges_relaxed.reduce());
+
+      if (round_nodes.reduce() < min_round_nodes) {
+        width = std::min(width * 2, kMaxWidth);
+      } else if (improved_reached.reduce() * 4 > improved.reduce()) {
+        width = std::max<size_t>(width / 2, 1);
+      }
+      max_width = std::max(max_width, width);
+
+      wl.clear();
+
+      cur_bucket = least_bucket.reduce();
+      if (cur_bucket == std::numeric_limits<size_t>::max()) {
+        katana::ReportStatSingle("SSSP", "rounds", rounds);
+        katana::ReportStatSingle("SSSP", "fused rounds", fused_rounds.reduce());
+        katana::ReportStatSingle("SSSP", "max window width", max_width);
+        break;
+      }
+
+      katana::on_each([&](unsigned, unsigned) {
+        Buckets& b = *buckets.getLocal();
+        for (size_t idx = cur_bucket;
+             idx < std::min(cur_bucket + width, b.size()); ++idx) {
+          for (Node n : b[idx]) {
+            wl.push(n);
+          }
+          b[idx].clear();
+          b[idx].shrink_to_fit();
+        }
+      });
+    }
+  }
+
   template <typename T, typename P, typename R>
   static void SerDeltaAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
@@ -272,11 +436,25 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     katana::ReportStatSingle("SSSP-Serial-Delta", "Iterations", iter);
   }
 
+  /// The key of a request in a RadixHeap
+  struct DistKey {
+    template <typename T>
+    Dist operator()(const T& item) const { return item.dist; }
+  };
+
+  /// The priority queue of DijkstraAlgo. Unsigned distances never drop below
+  /// the last one popped, so a radix heap can order them with a few bit
+  /// operations; signed and floating point weights use a 4-ary heap.
+  template <typename T>
+  using DijkstraQueue = std::conditional_t<
+      std::is_unsigned_v<Weight>, katana::RadixHeap<T, DistKey>,
+      katana::DAryMinHeap<T, 4>>;
+
   template <typename T, typename P, typename R>
   static void DijkstraAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
       const R& edgeRange) {
-    using WL = katana::MinHeap<T>;
+    using WL = DijkstraQueue<T>;
 
     graph->template GetData<NodeDistance>(source) = 0;
 
@@ -323,12 +501,16 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
 
     graph->template GetData<NodeDistance>(source) = 0;
 
-    katana::GReduceLogicalOr changed;
+    katana::GAccumulator<size_t> changed;
+    katana::GAccumulator<size_t> edges_relaxed;
     size_t rounds = 0;
+    // the convergence is the number of nodes whose distance changed
+    IterationReporter reporter("sssp_topo");
 
     do {
       ++rounds;
       changed.reset();
+      edges_relaxed.reset();
 
       katana::do_all(
           katana::iterate(*graph),
@@ -337,7 +519,8 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
 
             if (old_dist[n] > sdata) {
               old_dist[n] = sdata;
-              changed.update(true);
+              changed += 1;
+              edges_relaxed += graph->OutDegree(n);
 
               for (auto e : graph->OutEdges(n)) {
                 const Weight new_dist =
@@ -350,6 +533,8 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
           },
           katana::steal(), katana::loopname("Update"));
 
+      reporter.Report(
+          rounds, changed.reduce(), graph->size(), edges_relaxed.reduce());
     } while (changed.reduce());
 
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
@@ -368,12 +553,16 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
         },
         katana::steal(), katana::loopname("MakeTiles"));
 
-    katana::GReduceLogicalOr changed;
+    katana::GAccumulator<size_t> changed;
+    katana::GAccumulator<size_t> edges_relaxed;
     size_t rounds = 0;
+    // the convergence is the number of tiles whose source changed
+    IterationReporter reporter("sssp_topo_tile");
 
     do {
       ++rounds;
       changed.reset();
+      edges_relaxed.reset();
 
       katana::do_all(
           katana::iterate(tiles),
@@ -382,7 +571,8 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
 
             if (t.dist > sdata) {
               t.dist = sdata;
-              changed.update(true);
+              changed += 1;
+              edges_relaxed += std::distance(t.beg, t.end);
 
               for (auto e = t.beg; e != t.end; ++e) {
                 const Weight new_dist =
@@ -395,11 +585,85 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
           },
           katana::steal(), katana::loopname("Update"));
 
+      reporter.Report(
+          rounds, changed.reduce(), graph->size(), edges_relaxed.reduce());
     } while (changed.reduce());
 
     katana::ReportStatSingle("SSSP-Topo", "rounds", rounds);
   }
 
+  /// \returns the exponent of a delta step size for the weights of graph:
+  /// about the largest weight over the average degree, so that a step
+  /// reaches on the order of one new node along light edges per node
+  static unsigned AutomaticDelta(
+      const Graph& graph, const katana::NUMAArray<Weight>& edge_data) {
+    if (graph.NumEdges() == 0) {
+      return 0;
+    }
+    katana::GReduceMax<Weight> max_weight;
+    katana::do_all(
+        katana::iterate(size_t{0}, edge_data.size()),
+        [&](size_t e) { max_weight.update(edge_data[e]); },
+        katana::no_stats());
+
+    double avg_degree = static_cast<double>(graph.NumEdges()) / graph.size();
+    double delta = static_cast<double>(max_weight.reduce()) /
+                   std::max(avg_degree, 1.0);
+    // Dist values are divided by 1 << delta, an int
+    unsigned shift = 0;
+    while (shift < 30 && std::ldexp(1.0, shift + 1) <= delta) {
+      ++shift;
+    }
+    return shift;
+  }
+
+  /// A delta stepping request on behalf of one source of a batch
+  struct MultiUpdateRequest {
+    typename Graph::Node src;
+    Dist dist;
+    uint32_t source_index;
+  };
+
+  /// Delta stepping from several sources sharing one ordered worklist.
+  /// (*node_data)[n * sources.size() + i] is the distance of n from
+  /// sources[i], so the distances of a node from the whole batch share cache
+  /// lines and requests from different sources relaxing the same node touch
+  /// the same memory.
+  static void MultiDeltaStepAlgo(
+      katana::NUMAArray<std::atomic<Weight>>* node_data,
+      katana::NUMAArray<Weight>* edge_data, Graph* graph,
+      const std::vector<typename Graph::Node>& sources, unsigned stepShift) {
+    size_t num_sources = sources.size();
+
+    katana::InsertBag<MultiUpdateRequest> init_bag;
+    for (size_t i = 0; i < num_sources; ++i) {
+      init_bag.push(
+          MultiUpdateRequest{sources[i], 0, static_cast<uint32_t>(i)});
+    }
+
+    katana::for_each(
+        katana::iterate(init_bag),
+        [&](const MultiUpdateRequest& item, auto& ctx) {
+          Dist sdist = (*node_data)[item.src * num_sources + item.source_index];
+          if (sdist < item.dist) {
+            return;
+          }
+
+          for (auto ii : graph->OutEdges(item.src)) {
+            auto dest = graph->OutEdgeDst(ii);
+            auto& ddist = (*node_data)[dest * num_sources + item.source_index];
+            Dist new_dist = sdist + (*edge_data)[ii];
+            Dist old_dist = katana::atomicMin(ddist, new_dist);
+            if (new_dist < old_dist) {
+              ctx.push(MultiUpdateRequest{dest, new_dist, item.source_index});
+            }
+          }
+        },
+        katana::wl<OBIM>(UpdateRequestIndexer{stepShift}),
+        katana::disable_conflict_detection(),
+        katana::loopname("MultiSourceSSSP"));
+  }
+
 public:
   katana::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
     if (start_node >= graph.size()) {
@@ -440,7 +704,14 @@ public:
     execTime.start();
 
     if (plan.algorithm() == SsspPlan::kAutomatic) {
-      plan = SsspPlan(&graph.GetPropertyGraph());
+      unsigned delta = AutomaticDelta(graph, edge_data);
+      katana::ReportStatSingle("SSSP", "AutomaticDelta", delta);
+      if (SsspPlan(&graph.GetPropertyGraph()).algorithm() ==
+          SsspPlan::kDeltaStep) {
+        plan = SsspPlan::DeltaStep(delta);
+      } else {
+        plan = SsspPlan::DeltaStepAdaptive(delta);
+      }
     }
 
     switch (plan.algorithm()) {
@@ -462,6 +733,10 @@ public:
     case SsspPlan::kDeltaStepFusion:
       DeltaStepFusionAlgo(&node_data, &edge_data, &graph, source, plan.delta());
       break;
+    case SsspPlan::kDeltaStepAdaptive:
+      DeltaStepAdaptiveAlgo(
+          &node_data, &edge_data, &graph, source, plan.delta());
+      break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
@@ -497,6 +772,66 @@ public:
 
     return katana::ResultSuccess();
   }
+
+  /// Shortest paths from each of sources; (*graphs)[i] receives the distances
+  /// from sources[i]. All graphs share the topology and edge weights.
+  katana::Result<void> MultiSSSP(
+      std::vector<Graph>* graphs, const std::vector<uint32_t>& sources,
+      SsspPlan plan) {
+    KATANA_LOG_DEBUG_ASSERT(!graphs->empty());
+    KATANA_LOG_DEBUG_ASSERT(graphs->size() == sources.size());
+    Graph& graph = graphs->front();
+    size_t num_sources = sources.size();
+
+    std::vector<typename Graph::Node> nodes;
+    for (auto source : sources) {
+      if (source >= graph.size()) {
+        return katana::ErrorCode::InvalidArgument;
+      }
+      auto it = graph.begin();
+      std::advance(it, source);
+      nodes.emplace_back(*it);
+    }
+
+    size_t approxNodeData = graph.size() * 64 * num_sources;
+    katana::EnsurePreallocated(1, approxNodeData);
+    katana::ReportPageAllocGuard page_alloc;
+
+    katana::NUMAArray<std::atomic<Weight>> node_data;
+    katana::NUMAArray<Weight> edge_data;
+    node_data.allocateInterleaved(graph.size() * num_sources);
+    edge_data.allocateInterleaved(graph.NumEdges());
+
+    katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
+      for (size_t i = 0; i < num_sources; ++i) {
+        node_data[n * num_sources + i] = kDistanceInfinity;
+      }
+      for (auto e : graph.OutEdges(n)) {
+        edge_data[e] = graph.template GetEdgeData<EdgeWeight>(e);
+      }
+    });
+    for (size_t i = 0; i < num_sources; ++i) {
+      node_data[nodes[i] * num_sources + i] = 0;
+    }
+
+    if (plan.algorithm() == SsspPlan::kAutomatic) {
+      plan = SsspPlan::DeltaStep(AutomaticDelta(graph, edge_data));
+    }
+
+    katana::StatTimer execTime("MultiSourceSSSP");
+    execTime.start();
+    MultiDeltaStepAlgo(&node_data, &edge_data, &graph, nodes, plan.delta());
+    execTime.stop();
+
+    katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
+      for (size_t i = 0; i < num_sources; ++i) {
+        (*graphs)[i].template GetData<NodeDistance>(n) =
+            node_data[n * num_sources + i].load();
+      }
+    });
+
+    return katana::ResultSuccess();
+  }
 };
 
 template <typename Weight>
@@ -524,6 +859,8 @@ SSSPWithWrap(
       !r) {
     return r.error();
   }
+  // Picks up the weights if Sssp() started prefetching them
+  KATANA_CHECKED(pg->EnsureEdgePropertyLoaded(edge_weight_property_name));
   auto graph = katana::TypedPropertyGraph<
       std::tuple<SsspNodeDistance<Weight>>,
       std::tuple<SsspEdgeWeight<Weight>>>::
@@ -541,6 +878,111 @@ SSSPWithWrap(
   return Sssp(graph.value(), start_node, plan);
 }
 
+template <typename Weight>
+static katana::Result<void>
+MultiSSSPWithWrap(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::vector<std::string>& output_property_names, SsspPlan plan,
+    katana::TxnContext* txn_ctx) {
+  using Graph = typename SsspImplementation<Weight>::Graph;
+  KATANA_CHECKED(pg->EnsureEdgePropertyLoaded(edge_weight_property_name));
+
+  SsspImplementation<Weight> impl{{plan.edge_tile_size()}};
+  for (size_t begin = 0; begin < sources.size();
+       begin += kMultiSourceSsspBatchSize) {
+    size_t end = std::min(sources.size(), begin + kMultiSourceSsspBatchSize);
+
+    std::vector<Graph> graphs;
+    for (size_t i = begin; i < end; ++i) {
+      KATANA_CHECKED(
+          pg->ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
+              txn_ctx, {output_property_names[i]}));
+      graphs.emplace_back(KATANA_CHECKED(Graph::Make(
+          pg, {output_property_names[i]}, {edge_weight_property_name})));
+    }
+    std::vector<uint32_t> batch(sources.begin() + begin, sources.begin() + end);
+    KATANA_CHECKED(impl.MultiSSSP(&graphs, batch, plan));
+  }
+  return katana::ResultSuccess();
+}
+
+/// Delta stepping over the out-edges of edge_types
+template <typename Weight, typename View>
+void
+DeltaStepByEdgeType(
+    View* view, const std::vector<katana::EntityTypeID>& edge_types,
+    typename View::Node source, unsigned step_shift) {
+  using Impl = SsspImplementation<Weight>;
+  using NodeDistance = typename Impl::NodeDistance;
+  using EdgeWeight = typename Impl::EdgeWeight;
+  using UpdateRequest = typename Impl::UpdateRequest;
+
+  katana::do_all(
+      katana::iterate(view->Nodes()),
+      [&](const typename View::Node& n) {
+        view->template GetData<NodeDistance>(n) = Impl::kDistanceInfinity;
+      },
+      katana::no_stats());
+  view->template GetData<NodeDistance>(source) = 0;
+
+  katana::InsertBag<UpdateRequest> init_bag;
+  init_bag.push(UpdateRequest{source, 0});
+  katana::for_each(
+      katana::iterate(init_bag),
+      [&](const UpdateRequest& item, auto& ctx) {
+        Weight sdist = view->template GetData<NodeDistance>(item.src);
+        if (sdist < item.dist) {
+          return;
+        }
+        for (const katana::EntityTypeID& type : edge_types) {
+          for (auto e : view->OutEdges(item.src, type)) {
+            auto dst = view->OutEdgeDst(e);
+            Weight new_dist =
+                sdist + view->template GetEdgeData<EdgeWeight>(e);
+            Weight old_dist = katana::atomicMin(
+                view->template GetData<NodeDistance>(dst), new_dist);
+            if (new_dist < old_dist) {
+              ctx.push(UpdateRequest{dst, new_dist});
+            }
+          }
+        }
+      },
+      katana::wl<typename Impl::OBIM>(
+          typename Impl::UpdateRequestIndexer{step_shift}),
+      katana::disable_conflict_detection(),
+      katana::loopname("SsspByEdgeType"));
+}
+
+template <typename Weight>
+static katana::Result<void>
+SsspByEdgeTypeWithWrap(
+    katana::PropertyGraph* pg, size_t start_node,
+    const std::vector<std::string>& edge_types,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan,
+    katana::TxnContext* txn_ctx) {
+  using View = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::EdgeTypeAwareBiDir,
+      std::tuple<SsspNodeDistance<Weight>>, std::tuple<SsspEdgeWeight<Weight>>>;
+
+  KATANA_CHECKED(
+      pg->ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
+          txn_ctx, {output_property_name}));
+  KATANA_CHECKED(pg->EnsureEdgePropertyLoaded(edge_weight_property_name));
+  auto view = KATANA_CHECKED(
+      View::Make(pg, {output_property_name}, {edge_weight_property_name}));
+  std::vector<katana::EntityTypeID> types =
+      KATANA_CHECKED(EdgeTypesToTraverse(*pg, view, edge_types));
+
+  unsigned delta = plan.delta() != 0 ? plan.delta() : SsspPlan::kDefaultDelta;
+  katana::StatTimer exec_time("SsspByEdgeType");
+  exec_time.start();
+  DeltaStepByEdgeType<Weight>(&view, types, start_node, delta);
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -551,9 +993,15 @@ katana::analytics::Sssp(
     SsspPlan plan) {
   if (!edge_weight_property_name.empty() &&
       !pg->HasEdgeProperty(edge_weight_property_name)) {
-    return KATANA_ERROR(
-        katana::ErrorCode::NotFound, "Edge Property: {} Not found",
-        edge_weight_property_name);
+    if (pg->full_edge_schema()->GetFieldIndex(edge_weight_property_name) ==
+        -1) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "Edge Property: {} Not found",
+          edge_weight_property_name);
+    }
+    // The weights are on storage but not in memory. Start reading them now so
+    // the read overlaps with setting up the output property.
+    KATANA_CHECKED(pg->PrefetchProperties({}, {edge_weight_property_name}));
   }
   // If edge property name empty, add int64_t property
   // add initialize it to 1.
@@ -568,9 +1016,10 @@ katana::analytics::Sssp(
         pg, start_node, temporary_edge_property.name(), output_property_name,
         plan, txn_ctx);
   }
-  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-              ->type()
-              ->id()) {
+  // Use the full schema, the weights may still be in flight
+  std::shared_ptr<arrow::DataType> edge_weight_type =
+      pg->full_edge_schema()->GetFieldByName(edge_weight_property_name)->type();
+  switch (edge_weight_type->id()) {
   case arrow::UInt32Type::type_id:
     return SSSPWithWrap<uint32_t>(
         pg, start_node, edge_weight_property_name, output_property_name, plan,
@@ -598,9 +1047,146 @@ katana::analytics::Sssp(
   default:
     return KATANA_ERROR(
         katana::ErrorCode::TypeError, "Unsupported type: {}",
-        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-            ->type()
-            ->ToString());
+        edge_weight_type->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::SsspByEdgeType(
+    PropertyGraph* pg, size_t start_node,
+    const std::vector<std::string>& edge_types,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    SsspPlan plan) {
+  if (start_node >= pg->NumNodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "start node {} is not a node",
+        start_node);
+  }
+  if (edge_weight_property_name.empty()) {
+    TemporaryPropertyGuard temporary_edge_property{
+        pg->EdgeMutablePropertyView()};
+    using EdgeWeightType = int64_t;
+    KATANA_CHECKED(katana::analytics::AddDefaultEdgeWeight<EdgeWeightType>(
+        pg, temporary_edge_property.name(), 1, txn_ctx));
+
+    return SsspByEdgeTypeWithWrap<EdgeWeightType>(
+        pg, start_node, edge_types, temporary_edge_property.name(),
+        output_property_name, plan, txn_ctx);
+  }
+  if (pg->full_edge_schema()->GetFieldIndex(edge_weight_property_name) == -1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Edge Property: {} Not found",
+        edge_weight_property_name);
+  }
+  std::shared_ptr<arrow::DataType> edge_weight_type =
+      pg->full_edge_schema()->GetFieldByName(edge_weight_property_name)->type();
+  switch (edge_weight_type->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspByEdgeTypeWithWrap<uint32_t>(
+        pg, start_node, edge_types, edge_weight_property_name,
+        output_property_name, plan, txn_ctx);
+  case arrow::Int32Type::type_id:
+    return SsspByEdgeTypeWithWrap<int32_t>(
+        pg, start_node, edge_types, edge_weight_property_name,
+        output_property_name, plan, txn_ctx);
+  case arrow::UInt64Type::type_id:
+    return SsspByEdgeTypeWithWrap<uint64_t>(
+        pg, start_node, edge_types, edge_weight_property_name,
+        output_property_name, plan, txn_ctx);
+  case arrow::Int64Type::type_id:
+    return SsspByEdgeTypeWithWrap<int64_t>(
+        pg, start_node, edge_types, edge_weight_property_name,
+        output_property_name, plan, txn_ctx);
+  case arrow::FloatType::type_id:
+    return SsspByEdgeTypeWithWrap<float>(
+        pg, start_node, edge_types, edge_weight_property_name,
+        output_property_name, plan, txn_ctx);
+  case arrow::DoubleType::type_id:
+    return SsspByEdgeTypeWithWrap<double>(
+        pg, start_node, edge_types, edge_weight_property_name,
+        output_property_name, plan, txn_ctx);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        edge_weight_type->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::vector<std::string>& output_property_names,
+    katana::TxnContext* txn_ctx, SsspPlan plan) {
+  if (sources.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} output properties", sources.size(),
+        output_property_names.size());
+  }
+  for (auto source : sources) {
+    if (source >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+  if (sources.empty()) {
+    return katana::ResultSuccess();
+  }
+  if (!edge_weight_property_name.empty() &&
+      !pg->HasEdgeProperty(edge_weight_property_name)) {
+    if (pg->full_edge_schema()->GetFieldIndex(edge_weight_property_name) ==
+        -1) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotFound, "Edge Property: {} Not found",
+          edge_weight_property_name);
+    }
+    KATANA_CHECKED(pg->PrefetchProperties({}, {edge_weight_property_name}));
+  }
+  if (edge_weight_property_name.empty()) {
+    TemporaryPropertyGuard temporary_edge_property{
+        pg->EdgeMutablePropertyView()};
+    using EdgeWeightType = int64_t;
+    KATANA_CHECKED(katana::analytics::AddDefaultEdgeWeight<EdgeWeightType>(
+        pg, temporary_edge_property.name(), 1, txn_ctx));
+
+    return MultiSSSPWithWrap<EdgeWeightType>(
+        pg, sources, temporary_edge_property.name(), output_property_names,
+        plan, txn_ctx);
+  }
+  std::shared_ptr<arrow::DataType> edge_weight_type =
+      pg->full_edge_schema()->GetFieldByName(edge_weight_property_name)->type();
+  switch (edge_weight_type->id()) {
+  case arrow::UInt32Type::type_id:
+    return MultiSSSPWithWrap<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_names, plan,
+        txn_ctx);
+  case arrow::Int32Type::type_id:
+    return MultiSSSPWithWrap<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_names, plan,
+        txn_ctx);
+  case arrow::UInt64Type::type_id:
+    return MultiSSSPWithWrap<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_names, plan,
+        txn_ctx);
+  case arrow::Int64Type::type_id:
+    return MultiSSSPWithWrap<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_names, plan,
+        txn_ctx);
+  case arrow::FloatType::type_id:
+    return MultiSSSPWithWrap<float>(
+        pg, sources, edge_weight_property_name, output_property_names, plan,
+        txn_ctx);
+  case arrow::DoubleType::type_id:
+    return MultiSSSPWithWrap<double>(
+        pg, sources, edge_weight_property_name, output_property_names, plan,
+        txn_ctx);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        edge_weight_type->ToString());
   }
 }
 
@@ -0,0 +1,569 @@
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "katana/ParallelSTL.h"
+#include "katana/TypedPropertyGraph.h"
+
+using katana::analytics::StronglyConnectedComponentsPlan;
+using katana::analytics::StronglyConnectedComponentsStatistics;
+
+namespace {
+
+struct SccComponent : public katana::PODProperty<uint64_t> {};
+
+using NodeData = std::tuple<SccComponent>;
+using EdgeData = std::tuple<>;
+
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::BiDirectional, NodeData, EdgeData>;
+using GNode = Graph::Node;
+
+constexpr GNode kUnassigned = std::numeric_limits<GNode>::max();
+
+/// Multistep strongly connected components. Each phase assigns components to
+/// some of the remaining nodes and drops them from remaining_. Until the ids
+/// are compacted, a component is labeled with one of its nodes, which is
+/// labeled with itself.
+struct MultistepAlgo {
+  const Graph& graph_;
+  const StronglyConnectedComponentsPlan& plan_;
+  katana::NUMAArray<std::atomic<GNode>> component_;
+  /// Scratch per node: the mark of the forward search, then the colors, then
+  /// the discovery order of Tarjan's algorithm
+  katana::NUMAArray<std::atomic<GNode>> color_;
+  /// In and out degrees among the remaining nodes, without self loops
+  katana::NUMAArray<std::atomic<uint32_t>> in_degree_;
+  katana::NUMAArray<std::atomic<uint32_t>> out_degree_;
+  std::vector<GNode> remaining_;
+
+  MultistepAlgo(
+      const Graph& graph, const StronglyConnectedComponentsPlan& plan)
+      : graph_(graph), plan_(plan) {
+    component_.allocateBlocked(graph_.NumNodes());
+    color_.allocateBlocked(graph_.NumNodes());
+    in_degree_.allocateBlocked(graph_.NumNodes());
+    out_degree_.allocateBlocked(graph_.NumNodes());
+  }
+
+  bool IsAssigned(GNode n) const {
+    return component_[n].load(std::memory_order_relaxed) != kUnassigned;
+  }
+
+  /// Put n in the component of root unless n is already in a component
+  /// \returns true if n was put in the component
+  bool Assign(GNode n, GNode root) {
+    GNode expected = kUnassigned;
+    return component_[n].compare_exchange_strong(
+        expected, root, std::memory_order_relaxed);
+  }
+
+  /// Drop the nodes that have a component from remaining_
+  void Shrink() {
+    const size_t size = remaining_.size();
+    if (size == 0) {
+      return;
+    }
+    std::vector<size_t> position(size);
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) { position[i] = !IsAssigned(remaining_[i]); },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        position.begin(), position.end(), position.begin());
+
+    std::vector<GNode> kept(position[size - 1]);
+    katana::do_all(
+        katana::iterate(size_t{0}, size),
+        [&](size_t i) {
+          if (!IsAssigned(remaining_[i])) {
+            kept[position[i] - 1] = remaining_[i];
+          }
+        },
+        katana::no_stats());
+    remaining_ = std::move(kept);
+  }
+
+  /// Peel the nodes that have no in-edges or no out-edges from the remaining
+  /// nodes, as each is a component by itself, until none is left
+  void Trim() {
+    katana::InsertBag<GNode> trimmed;
+    katana::do_all(
+        katana::iterate(remaining_),
+        [&](GNode n) {
+          uint32_t out = 0;
+          for (auto e : graph_.OutEdges(n)) {
+            GNode v = graph_.OutEdgeDst(e);
+            out += v != n && !IsAssigned(v);
+          }
+          uint32_t in = 0;
+          for (auto e : graph_.InEdges(n)) {
+            GNode u = graph_.InEdgeSrc(e);
+            in += u != n && !IsAssigned(u);
+          }
+          out_degree_[n].store(out, std::memory_order_relaxed);
+          in_degree_[n].store(in, std::memory_order_relaxed);
+          if (out == 0 || in == 0) {
+            trimmed.push(n);
+          }
+        },
+        katana::steal(), katana::loopname("SCC-Trim-Degrees"));
+
+    // a node may be pushed once for each degree that drops to 0, but only
+    // the push that assigns it updates its neighbors
+    katana::for_each(
+        katana::iterate(trimmed),
+        [&](GNode n, auto& ctx) {
+          if (!Assign(n, n)) {
+            return;
+          }
+          for (auto e : graph_.OutEdges(n)) {
+            GNode v = graph_.OutEdgeDst(e);
+            if (v != n && !IsAssigned(v) &&
+                in_degree_[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+              ctx.push(v);
+            }
+          }
+          for (auto e : graph_.InEdges(n)) {
+            GNode u = graph_.InEdgeSrc(e);
+            if (u != n && !IsAssigned(u) &&
+                out_degree_[u].fetch_sub(1, std::memory_order_relaxed) == 1) {
+              ctx.push(u);
+            }
+          }
+        },
+        katana::disable_conflict_detection(), katana::loopname("SCC-Trim"));
+    Shrink();
+  }
+
+  /// Find the component of the remaining node with the most paths through
+  /// it, which is likely the largest, as the nodes reached backward from it
+  /// among the nodes reached forward from it
+  void ForwardBackward() {
+    if (remaining_.empty()) {
+      return;
+    }
+    // after Trim, the degrees are among the remaining nodes
+    katana::GReduceMax<uint64_t> best;
+    katana::do_all(
+        katana::iterate(remaining_),
+        [&](GNode n) {
+          uint64_t paths =
+              uint64_t{in_degree_[n].load(std::memory_order_relaxed)} *
+              out_degree_[n].load(std::memory_order_relaxed);
+          best.update(
+              std::min<uint64_t>(paths, kUnassigned) << 32 | uint64_t{n});
+        },
+        katana::no_stats());
+    const GNode pivot = best.reduce() & kUnassigned;
+
+    katana::do_all(
+        katana::iterate(remaining_),
+        [&](GNode n) {
+          color_[n].store(kUnassigned, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    color_[pivot].store(pivot, std::memory_order_relaxed);
+    katana::for_each(
+        katana::iterate({pivot}),
+        [&](GNode n, auto& ctx) {
+          for (auto e : graph_.OutEdges(n)) {
+            GNode v = graph_.OutEdgeDst(e);
+            if (!IsAssigned(v) &&
+                color_[v].exchange(pivot, std::memory_order_relaxed) !=
+                    pivot) {
+              ctx.push(v);
+            }
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::loopname("SCC-Forward"));
+
+    // a path from the component to the pivot stays in the component, so the
+    // backward search only needs the nodes reached forward
+    Assign(pivot, pivot);
+    katana::for_each(
+        katana::iterate({pivot}),
+        [&](GNode n, auto& ctx) {
+          for (auto e : graph_.InEdges(n)) {
+            GNode u = graph_.InEdgeSrc(e);
+            if (color_[u].load(std::memory_order_relaxed) == pivot &&
+                Assign(u, pivot)) {
+              ctx.push(u);
+            }
+          }
+        },
+        katana::disable_conflict_detection(),
+        katana::loopname("SCC-Backward"));
+    Shrink();
+  }
+
+  /// Give every remaining node the largest node that reaches it as color.
+  /// The nodes that keep their own color are in separate components, each
+  /// made of the nodes of its color that reach it.
+  void Color() {
+    uint64_t rounds = 0;
+    while (remaining_.size() > plan_.serial_cutoff()) {
+      ++rounds;
+      katana::do_all(
+          katana::iterate(remaining_),
+          [&](GNode n) { color_[n].store(n, std::memory_order_relaxed); },
+          katana::no_stats());
+      katana::for_each(
+          katana::iterate(remaining_),
+          [&](GNode n, auto& ctx) {
+            GNode color = color_[n].load(std::memory_order_relaxed);
+            for (auto e : graph_.OutEdges(n)) {
+              GNode v = graph_.OutEdgeDst(e);
+              if (IsAssigned(v)) {
+                continue;
+              }
+              GNode old = color_[v].load(std::memory_order_relaxed);
+              while (old < color && !color_[v].compare_exchange_weak(
+                                        old, color, std::memory_order_relaxed))
+                ;
+              if (old < color) {
+                ctx.push(v);
+              }
+            }
+          },
+          katana::disable_conflict_detection(),
+          katana::loopname("SCC-Color"));
+
+      katana::InsertBag<GNode> roots;
+      katana::do_all(
+          katana::iterate(remaining_),
+          [&](GNode n) {
+            if (color_[n].load(std::memory_order_relaxed) == n) {
+              Assign(n, n);
+              roots.push(n);
+            }
+          },
+          katana::no_stats());
+      // nodes assigned in earlier rounds may have a stale color, and Assign
+      // skips them
+      katana::for_each(
+          katana::iterate(roots),
+          [&](GNode n, auto& ctx) {
+            GNode root = component_[n].load(std::memory_order_relaxed);
+            for (auto e : graph_.InEdges(n)) {
+              GNode u = graph_.InEdgeSrc(e);
+              if (color_[u].load(std::memory_order_relaxed) == root &&
+                  Assign(u, root)) {
+                ctx.push(u);
+              }
+            }
+          },
+          katana::disable_conflict_detection(),
+          katana::loopname("SCC-Color-Backward"));
+
+      Shrink();
+      Trim();
+    }
+    katana::ReportStatSingle(
+        "StronglyConnectedComponents", "ColoringRounds", rounds);
+  }
+
+  /// Find the components of the remaining nodes with Tarjan's algorithm
+  void Tarjan() {
+    katana::ReportStatSingle(
+        "StronglyConnectedComponents", "SerialNodes", remaining_.size());
+    if (remaining_.empty()) {
+      return;
+    }
+    using Edge = Graph::Edge;
+    struct Frame {
+      GNode node;
+      Edge next;
+      Edge end;
+    };
+
+    // color_ holds the discovery order of the visited nodes, and low the
+    // smallest order reachable through the nodes on the stack
+    for (GNode n : remaining_) {
+      color_[n].store(kUnassigned, std::memory_order_relaxed);
+    }
+    std::vector<uint32_t> low(remaining_.size());
+    std::vector<GNode> stack;
+    std::vector<Frame> frames;
+    uint32_t order = 0;
+    auto order_of = [&](GNode n) {
+      return color_[n].load(std::memory_order_relaxed);
+    };
+    auto visit = [&](GNode n) {
+      color_[n].store(order, std::memory_order_relaxed);
+      low[order] = order;
+      ++order;
+      stack.push_back(n);
+      Edge begin = *graph_.OutEdges(n).begin();
+      frames.push_back(Frame{n, begin, begin + graph_.OutDegree(n)});
+    };
+
+    for (GNode source : remaining_) {
+      if (order_of(source) != kUnassigned) {
+        continue;
+      }
+      visit(source);
+      while (!frames.empty()) {
+        Frame& frame = frames.back();
+        if (frame.next != frame.end) {
+          GNode v = graph_.OutEdgeDst(frame.next++);
+          if (IsAssigned(v)) {
+            continue;
+          }
+          if (order_of(v) == kUnassigned) {
+            visit(v);
+          } else {
+            // a visited node without a component is still on the stack
+            uint32_t& n_low = low[order_of(frame.node)];
+            n_low = std::min(n_low, order_of(v));
+          }
+          continue;
+        }
+
+        GNode n = frame.node;
+        frames.pop_back();
+        uint32_t n_order = order_of(n);
+        if (low[n_order] == n_order) {
+          GNode member = kUnassigned;
+          while (member != n) {
+            member = stack.back();
+            stack.pop_back();
+            Assign(member, n);
+          }
+        }
+        if (!frames.empty()) {
+          uint32_t& parent_low = low[order_of(frames.back().node)];
+          parent_low = std::min(parent_low, low[n_order]);
+        }
+      }
+    }
+    remaining_.clear();
+  }
+
+  void operator()() {
+    katana::do_all(
+        katana::iterate(graph_),
+        [&](GNode n) {
+          component_[n].store(kUnassigned, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    remaining_.resize(graph_.NumNodes());
+    katana::do_all(
+        katana::iterate(graph_), [&](GNode n) { remaining_[n] = n; },
+        katana::no_stats());
+
+    Trim();
+    katana::ReportStatSingle(
+        "StronglyConnectedComponents", "TrimmedNodes",
+        graph_.NumNodes() - remaining_.size());
+    ForwardBackward();
+    Trim();
+    Color();
+    Tarjan();
+  }
+
+  /// Write the components to graph with dense ids, in the order of the
+  /// nodes that label them
+  void Compact(Graph* graph) {
+    katana::NUMAArray<uint64_t> rank;
+    rank.allocateBlocked(graph->NumNodes());
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](GNode n) {
+          rank[n] = component_[n].load(std::memory_order_relaxed) == n;
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](GNode n) {
+          GNode root = component_[n].load(std::memory_order_relaxed);
+          KATANA_LOG_DEBUG_ASSERT(root != kUnassigned);
+          graph->GetData<SccComponent>(n) = rank[root] - 1;
+        },
+        katana::loopname("SCC-Compact"));
+  }
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponents(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::TxnContext* txn_ctx, StronglyConnectedComponentsPlan plan) {
+  if (plan.algorithm() != StronglyConnectedComponentsPlan::kMultistep) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown algorithm");
+  }
+  katana::EnsurePreallocated(
+      2, pg->topology().NumNodes() * (4 * sizeof(GNode) + sizeof(uint64_t)));
+  katana::ReportPageAllocGuard page_alloc;
+
+  KATANA_CHECKED(pg->ConstructNodeProperties<NodeData>(
+      txn_ctx, {output_property_name}));
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::StatTimer exec_time("StronglyConnectedComponents");
+  exec_time.start();
+  MultistepAlgo algo(graph, plan);
+  algo();
+  algo.Compact(&graph);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponentsAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+  const uint64_t num_nodes = graph.NumNodes();
+
+  // group the nodes by component
+  std::vector<uint64_t> begin(num_nodes + 1);
+  for (GNode n : graph) {
+    uint64_t c = graph.GetData<SccComponent>(n);
+    if (c >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "node {} has id {}, which is not dense", n, c);
+    }
+    ++begin[c + 1];
+  }
+  std::partial_sum(begin.begin(), begin.end(), begin.begin());
+  std::vector<GNode> members(num_nodes);
+  std::vector<uint64_t> next(begin.begin(), begin.end() - 1);
+  for (GNode n : graph) {
+    members[next[graph.GetData<SccComponent>(n)]++] = n;
+  }
+
+  // every member of a component is reached forward and backward from the
+  // first one without leaving the component
+  std::vector<uint8_t> reached(num_nodes);
+  std::vector<GNode> queue;
+  for (uint64_t c = 0; c < num_nodes; ++c) {
+    if (begin[c] == begin[c + 1]) {
+      continue;
+    }
+    for (bool forward : {true, false}) {
+      const uint8_t mark = forward ? 1 : 2;
+      GNode first = members[begin[c]];
+      reached[first] |= mark;
+      queue.assign(1, first);
+      while (!queue.empty()) {
+        GNode n = queue.back();
+        queue.pop_back();
+        auto step = [&](GNode m) {
+          if (graph.GetData<SccComponent>(m) == c && !(reached[m] & mark)) {
+            reached[m] |= mark;
+            queue.push_back(m);
+          }
+        };
+        if (forward) {
+          for (auto e : graph.OutEdges(n)) {
+            step(graph.OutEdgeDst(e));
+          }
+        } else {
+          for (auto e : graph.InEdges(n)) {
+            step(graph.InEdgeSrc(e));
+          }
+        }
+      }
+    }
+    for (uint64_t i = begin[c]; i < begin[c + 1]; ++i) {
+      if (reached[members[i]] != 3) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AssertionFailed,
+            "node {} is not strongly connected to node {} of component {}",
+            members[i], members[begin[c]], c);
+      }
+    }
+  }
+
+  // the components are ordered topologically unless two are on a cycle
+  std::vector<uint64_t> in_edges(num_nodes);
+  for (GNode n : graph) {
+    uint64_t c = graph.GetData<SccComponent>(n);
+    for (auto e : graph.OutEdges(n)) {
+      uint64_t d = graph.GetData<SccComponent>(graph.OutEdgeDst(e));
+      in_edges[d] += d != c;
+    }
+  }
+  std::vector<uint64_t> sorted;
+  for (uint64_t c = 0; c < num_nodes; ++c) {
+    if (begin[c] != begin[c + 1] && in_edges[c] == 0) {
+      sorted.push_back(c);
+    }
+  }
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    uint64_t c = sorted[i];
+    for (uint64_t j = begin[c]; j < begin[c + 1]; ++j) {
+      for (auto e : graph.OutEdges(members[j])) {
+        uint64_t d = graph.GetData<SccComponent>(graph.OutEdgeDst(e));
+        if (d != c && --in_edges[d] == 0) {
+          sorted.push_back(d);
+        }
+      }
+    }
+  }
+  uint64_t num_components = 0;
+  for (uint64_t c = 0; c < num_nodes; ++c) {
+    num_components += begin[c] != begin[c + 1];
+  }
+  if (sorted.size() != num_components) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} components are on cycles through other components",
+        num_components - sorted.size());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<StronglyConnectedComponentsStatistics>
+katana::analytics::StronglyConnectedComponentsStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  using ComponentGraph =
+      katana::TypedPropertyGraph<std::tuple<SccComponent>, std::tuple<>>;
+  ComponentGraph graph =
+      KATANA_CHECKED(ComponentGraph::Make(pg, {property_name}, {}));
+
+  std::vector<uint64_t> sizes(graph.NumNodes());
+  for (auto n : graph) {
+    uint64_t c = graph.GetData<SccComponent>(n);
+    if (c >= sizes.size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} has id {}, which is not dense", n, c);
+    }
+    ++sizes[c];
+  }
+
+  StronglyConnectedComponentsStatistics stats{0, 0, 0, 0};
+  for (uint64_t size : sizes) {
+    stats.total_components += size > 0;
+    stats.total_non_trivial_components += size > 1;
+    stats.largest_component_size = std::max(stats.largest_component_size, size);
+  }
+  if (!graph.empty()) {
+    stats.largest_component_ratio =
+        double(stats.largest_component_size) / graph.NumNodes();
+  }
+  return stats;
+}
+
+void
+katana::analytics::StronglyConnectedComponentsStatistics::Print(
+    std::ostream& os) const {
+  os << "Total number of components = " << total_components << std::endl;
+  os << "Total number of non trivial components = "
+     << total_non_trivial_components << std::endl;
+  os << "Number of nodes in the largest component = " << largest_component_size
+     << std::endl;
+  os << "Ratio of nodes in the largest component = " << largest_component_ratio
+     << std::endl;
+}
@@ -19,7 +19,13 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
+#include <utility>
+
+#include <arrow/api.h>
+#include <arrow/compute/api_vector.h>
 
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
@@ -28,78 +34,254 @@
 namespace {
 
 using namespace katana::analytics;
-using edge_iterator = boost::counting_iterator<uint64_t>;
 
 using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 using Node = SortedGraphView::Node;
 using Edge = SortedGraphView::Edge;
+using PropertyIndex = katana::GraphTopology::PropertyIndex;
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-SubGraphNodeSet(
-    const SortedGraphView& graph, const std::vector<Node>& node_set) {
-  uint64_t num_nodes = node_set.size();
-  // Subgraph topology : out indices
+/// The topology of a sub-graph along with the property indices of its nodes
+/// and edges in the original graph
+struct SubGraphTopology {
   katana::NUMAArray<Edge> out_indices;
-  out_indices.allocateInterleaved(num_nodes);
+  katana::NUMAArray<Node> out_dests;
+  katana::NUMAArray<PropertyIndex> node_property_indices;
+  katana::NUMAArray<PropertyIndex> edge_property_indices;
+};
 
-  katana::gstl::Vector<katana::gstl::Vector<Node>> subgraph_edges;
-  subgraph_edges.resize(num_nodes);
+/// Build the topology of the sub-graph whose node i is nodes[i] in graph.
+/// for_each_edge(src, fn) calls fn(edge, dest) for every out-edge of src that
+/// is kept, where dest is the sub-graph id of its destination. Edges are
+/// counted first and written after a prefix sum over the counts, so no
+/// per-node buffers are needed.
+template <typename Graph, typename ForEachEdge>
+SubGraphTopology
+BuildTopology(
+    const Graph& graph, const std::vector<Node>& nodes,
+    const ForEachEdge& for_each_edge) {
+  uint64_t num_nodes = nodes.size();
+  SubGraphTopology sub;
+  sub.out_indices.allocateInterleaved(num_nodes);
+  sub.node_property_indices.allocateInterleaved(num_nodes);
 
   katana::do_all(
-      katana::iterate(Node(0), Node(num_nodes)),
-      [&](const Node& n) {
-        Node src = node_set[n];
-
-        auto last = graph.OutEdges(src).end();
-        for (Node m = 0; m < num_nodes; ++m) {
-          auto dest = node_set[m];
-          // Binary search on the edges sorted by destination id
-          for (auto edge_it = graph.FindEdge(src, dest);
-               edge_it != last && graph.OutEdgeDst(*edge_it) == dest;
-               ++edge_it) {
-            subgraph_edges[n].push_back(m);
-          }
-        }
-        out_indices[n] = subgraph_edges[n].size();
+      katana::iterate(uint64_t(0), num_nodes),
+      [&](uint64_t n) {
+        Edge degree = 0;
+        for_each_edge(nodes[n], [&](Edge, Node) { ++degree; });
+        sub.out_indices[n] = degree;
+        sub.node_property_indices[n] = graph.GetNodePropertyIndex(nodes[n]);
       },
       katana::steal(), katana::loopname("SubgraphExtraction"));
 
   // Prefix sum
   katana::ParallelSTL::partial_sum(
-      out_indices.begin(), out_indices.end(), out_indices.begin());
-  uint64_t num_edges = out_indices[num_nodes - 1];
+      sub.out_indices.begin(), sub.out_indices.end(), sub.out_indices.begin());
+  uint64_t num_edges = num_nodes == 0 ? 0 : sub.out_indices[num_nodes - 1];
 
-  // Subgraph topology : out dests
-  katana::NUMAArray<Node> out_dests;
-  out_dests.allocateInterleaved(num_edges);
+  sub.out_dests.allocateInterleaved(num_edges);
+  sub.edge_property_indices.allocateInterleaved(num_edges);
 
   katana::do_all(
-      katana::iterate(Node(0), Node(num_nodes)),
-      [&](const Node& n) {
-        uint64_t offset = n == 0 ? 0 : out_indices[n - 1];
-        for (Node dest : subgraph_edges[n]) {
-          out_dests[offset] = dest;
+      katana::iterate(uint64_t(0), num_nodes),
+      [&](uint64_t n) {
+        uint64_t offset = n == 0 ? 0 : sub.out_indices[n - 1];
+        for_each_edge(nodes[n], [&](Edge e, Node dest) {
+          sub.out_dests[offset] = dest;
+          sub.edge_property_indices[offset] =
+              graph.GetEdgePropertyIndexFromOutEdge(e);
           offset++;
-        }
+        });
       },
       katana::steal(), katana::loopname("ConstructTopology"));
 
+  return sub;
+}
+
+/// Gather the rows at indices of every column, one arrow Take per column.
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeProperties(
+    const std::vector<std::string>& names,
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& columns,
+    const katana::NUMAArray<PropertyIndex>& indices) {
+  // The indices outlive every Take below, so they need not be copied
+  auto index_array = std::make_shared<arrow::UInt64Array>(
+      indices.size(), arrow::Buffer::Wrap(indices.data(), indices.size()));
+
+  std::vector<arrow::Result<arrow::Datum>> taken(columns.size());
+  katana::do_all(
+      katana::iterate(size_t(0), columns.size()),
+      [&](size_t i) {
+        taken[i] = arrow::compute::Take(columns[i], index_array);
+      },
+      katana::steal(), katana::loopname("CopyProperties"));
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> sub_columns;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    arrow::Datum datum = KATANA_CHECKED_CONTEXT(
+        std::move(taken[i]), "copying property {}", names[i]);
+    fields.emplace_back(arrow::field(names[i], columns[i]->type()));
+    sub_columns.emplace_back(datum.chunked_array());
+  }
+  return arrow::Table::Make(
+      arrow::schema(fields), sub_columns, indices.size());
+}
+
+/// Make an independent graph from sub, with the entity types of the nodes and
+/// edges of pg it was built from and copies of the named properties.
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeSubGraph(
+    katana::PropertyGraph* pg, SubGraphTopology&& sub,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> node_columns;
+  for (const auto& name : node_properties_to_copy) {
+    node_columns.emplace_back(KATANA_CHECKED(pg->GetNodeProperty(name)));
+  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> edge_columns;
+  for (const auto& name : edge_properties_to_copy) {
+    edge_columns.emplace_back(KATANA_CHECKED(pg->GetEdgeProperty(name)));
+  }
+
+  uint64_t num_nodes = sub.node_property_indices.size();
+  uint64_t num_edges = sub.edge_property_indices.size();
+
+  katana::PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t(0), num_nodes),
+      [&](uint64_t n) {
+        node_types[n] = pg->GetTypeOfNodeFromPropertyIndex(
+            sub.node_property_indices[n]);
+      },
+      katana::loopname("CopyNodeTypes"));
+
+  katana::PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t(0), num_edges),
+      [&](uint64_t e) {
+        edge_types[e] = pg->GetTypeOfEdgeFromPropertyIndex(
+            sub.edge_property_indices[e]);
+      },
+      katana::loopname("CopyEdgeTypes"));
+
+  auto node_table = KATANA_CHECKED(TakeProperties(
+      node_properties_to_copy, node_columns, sub.node_property_indices));
+  auto edge_table = KATANA_CHECKED(TakeProperties(
+      edge_properties_to_copy, edge_columns, sub.edge_property_indices));
+
   katana::GraphTopology sub_g_topo{
-      std::move(out_indices), std::move(out_dests)};
-  auto sub_g_res = katana::PropertyGraph::Make(std::move(sub_g_topo));
+      std::move(sub.out_indices), std::move(sub.out_dests)};
+  auto sub_g = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(sub_g_topo), std::move(node_types), std::move(edge_types),
+      katana::EntityTypeManager(pg->GetNodeTypeManager()),
+      katana::EntityTypeManager(pg->GetEdgeTypeManager())));
 
-  return sub_g_res;
+  katana::TxnContext txn_ctx;
+  if (node_table->num_columns() > 0) {
+    KATANA_CHECKED(sub_g->AddNodeProperties(node_table, &txn_ctx));
+  }
+  if (edge_table->num_columns() > 0) {
+    KATANA_CHECKED(sub_g->AddEdgeProperties(edge_table, &txn_ctx));
+  }
+  return sub_g;
 }
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphNodeSet(
+    katana::PropertyGraph* pg, const SortedGraphView& graph,
+    const std::vector<Node>& node_set,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy) {
+  // (node, sub-graph node) pairs sorted by node, to find the destinations of
+  // the sub-graph in either the edges or the node set with a binary search
+  std::vector<std::pair<Node, Node>> sorted_nodes(node_set.size());
+  for (Node m = 0; m < node_set.size(); ++m) {
+    sorted_nodes[m] = {node_set[m], m};
+  }
+  std::sort(sorted_nodes.begin(), sorted_nodes.end());
+
+  auto for_each_edge = [&](Node src, const auto& fn) {
+    auto edges = graph.OutEdges(src);
+    if (graph.OutDegree(src) <= sorted_nodes.size()) {
+      for (Edge e : edges) {
+        Node dest = graph.OutEdgeDst(e);
+        auto it = std::lower_bound(
+            sorted_nodes.begin(), sorted_nodes.end(),
+            std::make_pair(dest, Node(0)));
+        if (it != sorted_nodes.end() && it->first == dest) {
+          fn(e, it->second);
+        }
+      }
+      return;
+    }
+    auto last = edges.end();
+    for (const auto& [dest, m] : sorted_nodes) {
+      // Binary search on the edges sorted by destination id
+      for (auto edge_it = graph.FindEdge(src, dest);
+           edge_it != last && graph.OutEdgeDst(*edge_it) == dest; ++edge_it) {
+        fn(*edge_it, m);
+      }
+    }
+  };
+
+  return MakeSubGraph(
+      pg, BuildTopology(graph, node_set, for_each_edge),
+      node_properties_to_copy, edge_properties_to_copy);
+}
+
+/// \returns for every entity type of manager whether it has one of the atomic
+/// types named in names, or all true if names is empty
+katana::Result<std::vector<uint8_t>>
+MatchingEntityTypes(
+    const katana::EntityTypeManager& manager,
+    const std::vector<std::string>& names) {
+  size_t num_types = manager.GetNumEntityTypes();
+  std::vector<uint8_t> matches(num_types, names.empty());
+  if (names.empty()) {
+    return matches;
+  }
+
+  auto atomic_types = KATANA_CHECKED(manager.GetEntityTypeIDs(names));
+  for (size_t type = 0; type < num_types; ++type) {
+    for (size_t atomic = 0; atomic < num_types; ++atomic) {
+      if (atomic_types.test(atomic) &&
+          manager.IsSubtypeOf(
+              katana::EntityTypeID(atomic), katana::EntityTypeID(type))) {
+        matches[type] = true;
+        break;
+      }
+    }
+  }
+  return matches;
+}
+
 }  // namespace
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::analytics::SubGraphExtraction(
     katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
     SubGraphExtractionPlan plan) {
+  return SubGraphExtraction(pg, node_vec, {}, {}, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    SubGraphExtractionPlan plan) {
   // Remove duplicates from the node vector
   std::unordered_set<uint32_t> set;
   std::vector<uint32_t> dedup_node_vec;
   for (auto n : node_vec) {
+    if (n >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph",
+          n);
+    }
     if (set.insert(n).second) {  // If n wasn't already present.
       dedup_node_vec.push_back(n);
     }
@@ -115,12 +297,74 @@ katana::analytics::SubGraphExtraction(
   switch (plan.algorithm()) {
   case SubGraphExtractionPlan::kNodeSet: {
     execTime.start();
-    auto subgraph = SubGraphNodeSet(sg, dedup_node_vec);
+    auto subgraph = SubGraphNodeSet(
+        pg, sg, dedup_node_vec, node_properties_to_copy,
+        edge_properties_to_copy);
     execTime.stop();
-    KATANA_LOG_DEBUG_ASSERT(subgraph);
-    return std::move(subgraph.value());
+    return subgraph;
   }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtractionByType(
+    katana::PropertyGraph* pg, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy) {
+  auto node_matches =
+      KATANA_CHECKED(MatchingEntityTypes(pg->GetNodeTypeManager(), node_types));
+  auto edge_matches =
+      KATANA_CHECKED(MatchingEntityTypes(pg->GetEdgeTypeManager(), edge_types));
+
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.NumNodes();
+  if (num_nodes == 0) {
+    return std::make_unique<katana::PropertyGraph>();
+  }
+
+  katana::StatTimer execTime("SubGraph-Extraction");
+  execTime.start();
+
+  auto is_selected = [&](Node n) -> bool {
+    return node_matches[pg->GetTypeOfNode(n)];
+  };
+
+  // sub_ids[n] - 1 is the sub-graph id of a selected node n
+  katana::NUMAArray<Node> sub_ids;
+  sub_ids.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](Node n) { sub_ids[n] = is_selected(n); },
+      katana::loopname("SelectNodes"));
+  katana::ParallelSTL::partial_sum(
+      sub_ids.begin(), sub_ids.end(), sub_ids.begin());
+
+  std::vector<Node> nodes(sub_ids[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](Node n) {
+        if (is_selected(n)) {
+          nodes[sub_ids[n] - 1] = n;
+        }
+      },
+      katana::loopname("NumberNodes"));
+
+  auto for_each_edge = [&](Node src, const auto& fn) {
+    for (Edge e : topology.OutEdges(src)) {
+      Node dest = topology.OutEdgeDst(e);
+      if (is_selected(dest) &&
+          edge_matches[pg->GetTypeOfEdgeFromTopoIndex(e)]) {
+        fn(e, sub_ids[dest] - 1);
+      }
+    }
+  };
+
+  auto subgraph = MakeSubGraph(
+      pg, BuildTopology(topology, nodes, for_each_edge),
+      node_properties_to_copy, edge_properties_to_copy);
+  execTime.stop();
+  return subgraph;
+}
@@ -19,17 +19,29 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "katana/PerThreadStorage.h"
+#include "katana/analytics/HubBitmaps.h"
+#include "katana/analytics/SetIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
 
 using SortedGraphView =
     katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+using ReplicatedGraphView = katana::PropertyGraphViews::
+    ReplicatedNodesSortedByDegreeEdgesSortedByDestID;
 using Node = SortedGraphView::Node;
 using edge_iterator = SortedGraphView::edge_iterator;
 
 constexpr static const unsigned kChunkSize = 16U;
 
+/// Nodes with at least this many smaller neighbors are intersected with a
+/// bitmap of their neighbors rather than by merging
+constexpr static const size_t kDenseSetDegree = 1024;
+
 /**
  * Like std::lower_bound but doesn't dereference iterators. Returns the first
  * element for which comp is not true.
@@ -59,31 +71,6 @@ LowerBound(Iterator first, Iterator last, Compare comp) {
   return first;
 }
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = g.OutEdgeDst(*aa);
-    typename G::Node b = g.OutEdgeDst(*bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
 template <typename G>
 struct LessThan {
   const G& g;
@@ -116,8 +103,9 @@ struct GreaterThanOrEqual {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-NodeIteratingAlgo(const SortedGraphView* graph) {
+NodeIteratingAlgo(const Graph* graph, const HubBitmaps& hubs) {
   katana::GAccumulator<size_t> numTriangles;
 
   katana::do_all(
@@ -128,18 +116,22 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
         edge_iterator first = graph->OutEdges(n).begin();
         edge_iterator last = graph->OutEdges(n).end();
         edge_iterator ea =
-            LowerBound(first, last, LessThan<SortedGraphView>(*graph, n));
+            LowerBound(first, last, LessThan<Graph>(*graph, n));
         edge_iterator bb = LowerBound(
-            first, last, GreaterThanOrEqual<SortedGraphView>(*graph, n));
+            first, last, GreaterThanOrEqual<Graph>(*graph, n));
 
         for (; bb != last; ++bb) {
           Node B = graph->OutEdgeDst(*bb);
           for (auto aa = first; aa != ea; ++aa) {
             Node A = graph->OutEdgeDst(*aa);
+            if (const uint64_t* a_bits = hubs.Find(A)) {
+              numTriangles += HubBitmaps::Contains(a_bits, B);
+              continue;
+            }
             edge_iterator vv = graph->OutEdges(A).begin();
             edge_iterator ev = graph->OutEdges(A).end();
             edge_iterator it =
-                LowerBound(vv, ev, LessThan<SortedGraphView>(*graph, B));
+                LowerBound(vv, ev, LessThan<Graph>(*graph, B));
             if (it != ev && graph->OutEdgeDst(*it) == B) {
               numTriangles += 1;
             }
@@ -153,37 +145,63 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
 }
 
 /**
- * Lambda function to count triangles
+ * Count the triangles w < v < n closed by the edge (n, v), given the
+ * neighbors of n smaller than v, their bitmap if n is a hub and the set of
+ * them if dense is not null. When either end is a hub the other, shorter,
+ * list probes its bitmap.
  */
+template <typename Graph>
+size_t
+CountClosedBy(
+    const Graph* graph, const HubBitmaps& hubs, const Node* n_dsts,
+    size_t n_size, const uint64_t* n_bits, Node v, const DenseSet* dense) {
+  auto v_dsts = graph->OutEdgeDsts(v);
+  const Node* v_end = std::lower_bound(v_dsts.begin(), v_dsts.end(), v);
+  size_t v_size = v_end - v_dsts.begin();
+  const uint64_t* v_bits = hubs.Find(v);
+  if (v_bits && (!n_bits || n_size <= v_size)) {
+    return HubBitmaps::CountIntersection(v_bits, n_dsts, n_size);
+  }
+  if (n_bits) {
+    return HubBitmaps::CountIntersection(n_bits, v_dsts.begin(), v_size);
+  }
+  if (dense) {
+    return dense->CountIntersection(v_dsts.begin(), v_size);
+  }
+  return CountIntersection(n_dsts, n_size, v_dsts.begin(), v_size);
+}
+
+/**
+ * Count the triangles w < v < n of n: for each smaller neighbor v of n,
+ * intersect the neighbors of n smaller than v with those of v.
+ */
+template <typename Graph>
 void
 OrderedCountFunc(
-    const SortedGraphView* graph, Node n,
-    katana::GAccumulator<size_t>& numTriangles) {
+    const Graph* graph, const HubBitmaps& hubs, Node n,
+    DenseSet* dense, katana::GAccumulator<size_t>& numTriangles) {
   size_t numTriangles_local = 0;
-  for (auto edges_n : graph->OutEdges(n)) {
-    Node v = graph->OutEdgeDst(edges_n);
-    if (v >= n) {
-      break;
-    }
-    edge_iterator it_n = graph->OutEdges(n).begin();
-
-    for (auto edges_v : graph->OutEdges(v)) {
-      auto dst_v = graph->OutEdgeDst(edges_v);
-      if (dst_v >= v) {
-        break;
-      }
-      while (graph->OutEdgeDst(*it_n) < dst_v) {
-        it_n++;
-      }
-      if (dst_v == graph->OutEdgeDst(*it_n)) {
-        edge_iterator multi_it_n = it_n;
-        while (multi_it_n != graph->OutEdges(n).end() &&
-               graph->OutEdgeDst(*multi_it_n) == dst_v) {
-          numTriangles_local += 1;
-          multi_it_n++;
-        }
-      }
-    }
+  auto n_dsts = graph->OutEdgeDsts(n);
+  const Node* n_end = std::lower_bound(n_dsts.begin(), n_dsts.end(), n);
+
+  // every neighbor of v smaller than v is smaller than n, so with a bitmap
+  // of the smaller neighbors of n there is no need to cut it at v
+  const uint64_t* n_bits = hubs.Find(n);
+  bool use_dense =
+      !n_bits &&
+      static_cast<size_t>(n_end - n_dsts.begin()) >= kDenseSetDegree;
+  if (use_dense) {
+    dense->Assign(n_dsts.begin(), n_end - n_dsts.begin());
+  }
+
+  for (const Node* v_it = n_dsts.begin(); v_it != n_end; ++v_it) {
+    numTriangles_local += CountClosedBy(
+        graph, hubs, n_dsts.begin(), v_it - n_dsts.begin(), n_bits, *v_it,
+        use_dense ? dense : nullptr);
+  }
+
+  if (use_dense) {
+    dense->Clear();
   }
   numTriangles += numTriangles_local;
 }
@@ -191,18 +209,68 @@ OrderedCountFunc(
 /*
  * Simple counting loop, instead of binary searching.
  */
+template <typename Graph>
 size_t
-OrderedCountAlgo(const SortedGraphView* graph) {
+OrderedCountAlgo(const Graph* graph, const HubBitmaps& hubs) {
   katana::GAccumulator<size_t> numTriangles;
+  katana::PerThreadStorage<DenseSet> dense_sets;
   katana::do_all(
       katana::iterate(*graph),
-      [&](const Node& n) { OrderedCountFunc(graph, n, numTriangles); },
+      [&](const Node& n) {
+        OrderedCountFunc(graph, hubs, n, dense_sets.getLocal(), numTriangles);
+      },
       katana::chunk_size<kChunkSize>(), katana::steal(),
       katana::loopname("TriangleCount_OrderedCountAlgo"));
 
   return numTriangles.reduce();
 }
 
+/**
+ * Estimate the triangles from those closed by a sample of the edges (n, v)
+ * with v < n, each kept with probability rate. With c(e) the triangles an
+ * edge closes, the variance of the estimate sums c(e)^2 (1 - rate) / rate
+ * over all edges, which the same sum over the sample divided once more by
+ * rate estimates without bias.
+ */
+template <typename Graph>
+Estimate
+EdgeSamplingAlgo(
+    const Graph* graph, const HubBitmaps& hubs, double rate,
+    uint32_t seed) {
+  uint64_t key = SamplingKey(seed);
+  katana::GAccumulator<uint64_t> sampled_triangles;
+  katana::GAccumulator<double> sum_squares;
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const Node& n) {
+        auto n_dsts = graph->OutEdgeDsts(n);
+        const Node* n_end = std::lower_bound(n_dsts.begin(), n_dsts.end(), n);
+        const uint64_t* n_bits = hubs.Find(n);
+        uint64_t local_triangles = 0;
+        double local_squares = 0;
+        for (const Node* v_it = n_dsts.begin(); v_it != n_end; ++v_it) {
+          // draw by the ends of the edge rather than its position
+          if (SampleUnit(key, uint64_t{n} << 32 | *v_it) >= rate) {
+            continue;
+          }
+          uint64_t closed = CountClosedBy(
+              graph, hubs, n_dsts.begin(), v_it - n_dsts.begin(), n_bits,
+              *v_it, nullptr);
+          local_triangles += closed;
+          local_squares += static_cast<double>(closed) * closed;
+        }
+        sampled_triangles += local_triangles;
+        sum_squares += local_squares;
+      },
+      katana::chunk_size<kChunkSize>(), katana::steal(),
+      katana::loopname("TriangleCount_EdgeSamplingAlgo"));
+
+  Estimate ret;
+  ret.value = sampled_triangles.reduce() / rate;
+  ret.std_error = std::sqrt(sum_squares.reduce() * (1 - rate)) / rate;
+  return ret;
+}
+
 /**
  * Edge Iterator algorithm for counting triangles.
  * <code>
@@ -216,8 +284,9 @@ OrderedCountAlgo(const SortedGraphView* graph) {
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
+template <typename Graph>
 size_t
-EdgeIteratingAlgo(const SortedGraphView* graph) {
+EdgeIteratingAlgo(const Graph* graph, const HubBitmaps& hubs) {
   struct WorkItem {
     Node src;
     Node dst;
@@ -244,21 +313,25 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
-        edge_iterator abegin = graph->OutEdges(w.src).begin();
-        edge_iterator aend = graph->OutEdges(w.src).end();
-        edge_iterator bbegin = graph->OutEdges(w.dst).begin();
-        edge_iterator bend = graph->OutEdges(w.dst).end();
-
-        edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<SortedGraphView>(*graph, w.dst));
-        edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<SortedGraphView>(*graph, w.dst));
-
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        auto a = graph->OutEdgeDsts(w.src);
+        auto b = graph->OutEdgeDsts(w.dst);
+
+        const Node* aa = std::upper_bound(a.begin(), a.end(), w.src);
+        const Node* ea = std::lower_bound(aa, a.end(), w.dst);
+        const Node* bb = std::upper_bound(b.begin(), b.end(), w.src);
+        const Node* eb = std::lower_bound(bb, b.end(), w.dst);
+
+        size_t a_size = ea - aa;
+        size_t b_size = eb - bb;
+        const uint64_t* a_bits = hubs.Find(w.src);
+        const uint64_t* b_bits = hubs.Find(w.dst);
+        if (a_bits && (!b_bits || b_size <= a_size)) {
+          numTriangles += HubBitmaps::CountIntersection(a_bits, bb, b_size);
+        } else if (b_bits) {
+          numTriangles += HubBitmaps::CountIntersection(b_bits, aa, a_size);
+        } else {
+          numTriangles += CountIntersection(aa, a_size, bb, b_size);
+        }
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -266,9 +339,53 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
   return numTriangles.reduce();
 }
 
-katana::Result<uint64_t>
-katana::analytics::TriangleCount(
-    katana::PropertyGraph* pg, TriangleCountPlan plan) {
+namespace {
+
+template <typename Graph>
+katana::Result<Estimate>
+CountTrianglesOn(const Graph& view, const TriangleCountPlan& plan) {
+  katana::StatTimer timer_hubs("HubBitmapTimer", "TriangleCount");
+  timer_hubs.start();
+  HubBitmaps hubs = HubBitmaps::Make(view, plan.hub_bitmap_budget());
+  timer_hubs.stop();
+  katana::ReportStatSingle("TriangleCount", "HubBitmapHubs", hubs.num_hubs());
+  katana::ReportStatSingle(
+      "TriangleCount", "HubBitmapBytes", hubs.size_bytes());
+
+  Estimate total_count;
+  katana::StatTimer execTime("TriangleCount", "TriangleCount");
+  execTime.start();
+  switch (plan.algorithm()) {
+  case TriangleCountPlan::kNodeIteration:
+    total_count.value = NodeIteratingAlgo(&view, hubs);
+    break;
+  case TriangleCountPlan::kEdgeIteration:
+    total_count.value = EdgeIteratingAlgo(&view, hubs);
+    break;
+  case TriangleCountPlan::kOrderedCount:
+    total_count.value = OrderedCountAlgo(&view, hubs);
+    break;
+  case TriangleCountPlan::kEdgeSampling:
+    total_count = EdgeSamplingAlgo(
+        &view, hubs, plan.sample_rate(), plan.seed());
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  execTime.stop();
+
+  return total_count;
+}
+
+katana::Result<Estimate>
+CountTriangles(katana::PropertyGraph* pg, const TriangleCountPlan& plan) {
+  if (plan.algorithm() == TriangleCountPlan::kEdgeSampling &&
+      !(plan.sample_rate() > 0 && plan.sample_rate() <= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sample rate must be in (0, 1], got {}", plan.sample_rate());
+  }
+
   katana::StatTimer timer_graph_read("GraphReadingTime", "TriangleCount");
   katana::StatTimer timer_auto_algo("AutoRelabel", "TriangleCount");
 
@@ -335,23 +452,24 @@ katana::analytics::TriangleCount(
 
   KATANA_LOG_VERBOSE("Done relabeling. Starting TriangleCount");
 
-  size_t total_count;
-  katana::StatTimer execTime("TriangleCount", "TriangleCount");
-  execTime.start();
-  switch (plan.algorithm()) {
-  case TriangleCountPlan::kNodeIteration:
-    total_count = NodeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kEdgeIteration:
-    total_count = EdgeIteratingAlgo(&sorted_view);
-    break;
-  case TriangleCountPlan::kOrderedCount:
-    total_count = OrderedCountAlgo(&sorted_view);
-    break;
-  default:
-    return katana::ErrorCode::InvalidArgument;
+  if (plan.replicate_topology()) {
+    auto replicated_view = pg->BuildView<ReplicatedGraphView>();
+    return CountTrianglesOn(replicated_view, plan);
   }
-  execTime.stop();
+  return CountTrianglesOn(sorted_view, plan);
+}
 
-  return total_count;
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::TriangleCount(
+    katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  Estimate total_count = KATANA_CHECKED(CountTriangles(pg, plan));
+  return static_cast<uint64_t>(std::llround(total_count.value));
+}
+
+katana::Result<Estimate>
+katana::analytics::EstimateTriangleCount(
+    katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  return CountTriangles(pg, plan);
 }
@@ -0,0 +1,143 @@
+#include "katana/analytics/Checkpoint.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr size_t kSize = 1000;
+
+CheckpointOptions
+Options(const std::string& dir, bool resume) {
+  CheckpointOptions options;
+  options.location = dir;
+  options.interval = 1;
+  options.resume = resume;
+  return options;
+}
+
+void
+Save(Checkpointer* checkpointer, uint32_t iteration, uint32_t value) {
+  auto column = MakeCheckpointColumn<uint32_t>(
+      kSize, [&](size_t i) { return static_cast<uint32_t>(i) + value; });
+  KATANA_LOG_VASSERT(column, "{}", column.error());
+  auto res = checkpointer->Save(
+      MakeCheckpointState(iteration, {"value"}, {column.value()}));
+  KATANA_LOG_VASSERT(res, "saving: {}", res.error());
+}
+
+void
+TestResume(const std::string& dir) {
+  {
+    Checkpointer checkpointer(Options(dir, false), "test");
+    // nothing to resume from
+    auto state = checkpointer.Resume();
+    KATANA_LOG_VASSERT(state, "{}", state.error());
+    KATANA_LOG_ASSERT(!state.value());
+
+    Save(&checkpointer, 1, 100);
+    Save(&checkpointer, 2, 200);
+    Save(&checkpointer, 3, 300);
+    // the destructor finishes the last one
+  }
+
+  Checkpointer not_resuming(Options(dir, false), "test");
+  auto state_res = not_resuming.Resume();
+  KATANA_LOG_VASSERT(state_res, "{}", state_res.error());
+  KATANA_LOG_ASSERT(!state_res.value());
+
+  Checkpointer other(Options(dir, true), "other");
+  state_res = other.Resume();
+  KATANA_LOG_VASSERT(state_res, "{}", state_res.error());
+  KATANA_LOG_ASSERT(!state_res.value());
+
+  Checkpointer checkpointer(Options(dir, true), "test");
+  state_res = checkpointer.Resume();
+  KATANA_LOG_VASSERT(state_res, "{}", state_res.error());
+  KATANA_LOG_ASSERT(state_res.value());
+  CheckpointState state = state_res.value().value();
+  KATANA_LOG_VASSERT(state.iteration == 3, "iteration {}", state.iteration);
+
+  std::vector<uint64_t> values(kSize);
+  auto res = RestoreCheckpointColumn<uint64_t>(
+      state, "value", kSize, [&](size_t i, uint64_t v) { values[i] = v; });
+  KATANA_LOG_VASSERT(res, "restoring: {}", res.error());
+  for (size_t i = 0; i < kSize; ++i) {
+    KATANA_LOG_ASSERT(values[i] == i + 300);
+  }
+
+  KATANA_LOG_ASSERT(!RestoreCheckpointColumn<uint64_t>(
+      state, "missing", kSize, [](size_t, uint64_t) {}));
+  KATANA_LOG_ASSERT(!RestoreCheckpointColumn<uint64_t>(
+      state, "value", kSize + 1, [](size_t, uint64_t) {}));
+
+  // the next checkpoint leaves the one resumed from alone until it is
+  // complete
+  Save(&checkpointer, 4, 400);
+  res = checkpointer.Finish();
+  KATANA_LOG_VASSERT(res, "finishing: {}", res.error());
+  state_res = Checkpointer(Options(dir, true), "test").Resume();
+  KATANA_LOG_VASSERT(state_res, "{}", state_res.error());
+  KATANA_LOG_ASSERT(state_res.value());
+  KATANA_LOG_ASSERT(state_res.value()->iteration == 4);
+
+  res = checkpointer.Discard();
+  KATANA_LOG_VASSERT(res, "discarding: {}", res.error());
+  KATANA_LOG_ASSERT(fs::is_empty(dir));
+}
+
+void
+TestPagerank(const std::string& dir) {
+  auto pg = katana::MakeGrid(30, 30, false);
+  katana::TxnContext txn_ctx;
+  PagerankPlan plan = PagerankPlan::PullTopological();
+  auto res = Pagerank(pg.get(), "rank", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = Pagerank(
+      pg.get(), "checkpointed_rank", &txn_ctx,
+      plan.WithCheckpoint(Options(dir, true)));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(fs::is_empty(dir));
+
+  auto expected = pg->GetNodePropertyTyped<float>("rank");
+  auto found = pg->GetNodePropertyTyped<float>("checkpointed_rank");
+  KATANA_LOG_ASSERT(expected && found);
+  for (int64_t i = 0; i < expected.value()->length(); ++i) {
+    KATANA_LOG_ASSERT(
+        std::abs(expected.value()->Value(i) - found.value()->Value(i)) <=
+        1e-6);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/checkpoint");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());  // path() because local
+  fs::create_directories(dir);
+  TestResume(dir);
+  fs::remove_all(dir);
+
+  fs::create_directories(dir);
+  TestPagerank(dir);
+  fs::remove_all(dir);
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+using Edge = katana::PropertyGraph::Edge;
+using Node = katana::PropertyGraph::Node;
+using CompressedGraphView = katana::PropertyGraphViews::Compressed;
+using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
+
+constexpr size_t kEdgesPerNode = 16;
+constexpr size_t kNumLookups = 1 << 16;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(benchmark::State& state) {
+  auto res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(state.range(0), kEdgesPerNode));
+  if (!res) {
+    KATANA_LOG_FATAL("could not make property graph: {}", res.error());
+  }
+  return std::move(res.value());
+}
+
+std::vector<Edge>
+RandomEdges(size_t num_edges) {
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<Edge> dist(0, num_edges - 1);
+  std::vector<Edge> edges(kNumLookups);
+  for (Edge& e : edges) {
+    e = dist(gen);
+  }
+  return edges;
+}
+
+/// Random OutEdgeDst on the uncompressed view, as the baseline
+void
+RandomOutEdgeDstSorted(benchmark::State& state) {
+  auto g = MakeGraph(state);
+  SortedGraphView view = g->BuildView<SortedGraphView>();
+  std::vector<Edge> edges = RandomEdges(view.NumEdges());
+
+  for (auto _ : state) {
+    for (Edge e : edges) {
+      benchmark::DoNotOptimize(view.OutEdgeDst(e));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+/// Random OutEdgeDst on the compressed view; each lookup decodes from the
+/// start of its block
+void
+RandomOutEdgeDstCompressed(benchmark::State& state) {
+  auto g = MakeGraph(state);
+  CompressedGraphView view = g->BuildView<CompressedGraphView>();
+  std::vector<Edge> edges = RandomEdges(view.NumEdges());
+
+  for (auto _ : state) {
+    for (Edge e : edges) {
+      benchmark::DoNotOptimize(view.OutEdgeDst(e));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+/// Visiting all out-edges through OutEdgeDst on the compressed view
+void
+ScanOutEdgeDstCompressed(benchmark::State& state) {
+  auto g = MakeGraph(state);
+  CompressedGraphView view = g->BuildView<CompressedGraphView>();
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (Node n : view.Nodes()) {
+      for (Edge e : view.OutEdges(n)) {
+        sum += view.OutEdgeDst(e);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * view.NumEdges());
+}
+
+/// Visiting all out-edges through ForEachOutEdgeDst on the compressed view
+void
+ScanForEachOutEdgeDstCompressed(benchmark::State& state) {
+  auto g = MakeGraph(state);
+  CompressedGraphView view = g->BuildView<CompressedGraphView>();
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (Node n : view.Nodes()) {
+      view.ForEachOutEdgeDst(n, [&](Edge, Node dst) { sum += dst; });
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * view.NumEdges());
+}
+
+BENCHMARK(RandomOutEdgeDstSorted)->Arg(1 << 12)->Arg(1 << 18);
+BENCHMARK(RandomOutEdgeDstCompressed)->Arg(1 << 12)->Arg(1 << 18);
+BENCHMARK(ScanOutEdgeDstCompressed)->Arg(1 << 12)->Arg(1 << 18);
+BENCHMARK(ScanForEachOutEdgeDstCompressed)->Arg(1 << 12)->Arg(1 << 18);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
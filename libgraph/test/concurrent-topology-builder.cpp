@@ -0,0 +1,115 @@
+#include "katana/ConcurrentTopologyBuilder.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using AdjLists = std::vector<std::vector<Node>>;
+
+constexpr size_t kNumNodes = 1000;
+constexpr size_t kEdgesPerNode = 7;
+
+AdjLists
+ToAdjLists(const katana::GraphTopology& topo) {
+  AdjLists lists(topo.NumNodes());
+  for (Node n : topo.Nodes()) {
+    for (Edge e : topo.OutEdges(n)) {
+      lists[n].emplace_back(topo.OutEdgeDst(e));
+    }
+  }
+  return lists;
+}
+
+/// Every edge of input added twice from parallel threads gives the sorted,
+/// deduplicated edges of input
+void
+TestDedup(const katana::GraphTopology& input) {
+  katana::AsymmetricConcurrentTopologyBuilder builder(input.NumNodes());
+  katana::do_all(katana::iterate(input.Nodes()), [&](Node n) {
+    for (int i = 0; i < 2; ++i) {
+      for (Edge e : input.OutEdges(n)) {
+        builder.AddEdge(n, input.OutEdgeDst(e));
+      }
+    }
+  });
+  KATANA_LOG_ASSERT(builder.num_added_edges() == 2 * input.NumEdges());
+  katana::GraphTopology topo = builder.ConvertToCSR();
+  KATANA_LOG_ASSERT(builder.num_added_edges() == 0);
+
+  AdjLists expected = ToAdjLists(input);
+  for (auto& list : expected) {
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+  }
+  KATANA_LOG_ASSERT(topo.NumNodes() == input.NumNodes());
+  KATANA_LOG_ASSERT(ToAdjLists(topo) == expected);
+}
+
+/// With symmetric multi-edges, every edge of input shows up in both
+/// directions, duplicates included
+void
+TestSymmetricMultiEdges(const katana::GraphTopology& input) {
+  katana::ConcurrentTopologyBuilderImpl<true, true> builder(input.NumNodes());
+  katana::do_all(katana::iterate(input.Nodes()), [&](Node n) {
+    for (Edge e : input.OutEdges(n)) {
+      builder.AddEdge(n, input.OutEdgeDst(e));
+    }
+  });
+  katana::GraphTopology topo = builder.ConvertToCSR();
+
+  AdjLists expected(input.NumNodes());
+  for (Node n : input.Nodes()) {
+    for (Edge e : input.OutEdges(n)) {
+      expected[n].emplace_back(input.OutEdgeDst(e));
+      expected[input.OutEdgeDst(e)].emplace_back(n);
+    }
+  }
+  for (auto& list : expected) {
+    std::sort(list.begin(), list.end());
+  }
+  KATANA_LOG_ASSERT(topo.NumEdges() == 2 * input.NumEdges());
+  KATANA_LOG_ASSERT(ToAdjLists(topo) == expected);
+}
+
+/// The same edges added serially and in parallel give the same topology
+void
+TestSerialAgrees() {
+  katana::SymmetricConcurrentTopologyBuilder serial;
+  serial.AddNodes(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    serial.AddEdge(n, (n * 7 + 3) % kNumNodes);
+    serial.AddEdge(n, n);
+  }
+  katana::SymmetricConcurrentTopologyBuilder parallel(kNumNodes);
+  katana::do_all(katana::iterate(Node{0}, Node{kNumNodes}), [&](Node n) {
+    parallel.AddEdge(n, n);
+    parallel.AddEdge(n, (n * 7 + 3) % kNumNodes);
+  });
+  KATANA_LOG_ASSERT(
+      ToAdjLists(serial.ConvertToCSR()) == ToAdjLists(parallel.ConvertToCSR()));
+
+  katana::AsymmetricConcurrentTopologyBuilder empty(5);
+  katana::GraphTopology topo = empty.ConvertToCSR();
+  KATANA_LOG_ASSERT(topo.NumNodes() == 5 && topo.NumEdges() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  katana::GraphTopology input =
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode);
+  TestDedup(input);
+  TestSymmetricMultiEdges(input);
+  TestSerialAgrees();
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <vector>
+
+#include "katana/DynamicGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+using katana::DynamicGraph;
+using Edge = katana::PropertyGraph::Edge;
+using Node = katana::PropertyGraph::Node;
+
+namespace {
+
+/// The path 0 -> 1 -> 2 -> 3 whose edges know their ends
+std::unique_ptr<katana::PropertyGraph>
+MakePath() {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(4);
+  for (Node n = 0; n < 3; ++n) {
+    builder.AddEdge(n, n + 1);
+  }
+  auto pg_res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg_res, "{}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("ends", [&pg](Edge e) {
+        uint64_t src = pg->topology().GetEdgeSrc(e);
+        uint64_t dst = pg->topology().OutEdgeDst(e);
+        return src * 10 + dst;
+      }));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  return pg;
+}
+
+std::vector<Node>
+Neighbors(const DynamicGraph& graph, Node n) {
+  std::vector<Node> neighbors;
+  graph.ForEachOutNeighbor(n, [&](Node dst) { neighbors.emplace_back(dst); });
+  std::sort(neighbors.begin(), neighbors.end());
+  return neighbors;
+}
+
+void
+TestUpdates() {
+  // never merge on its own
+  DynamicGraph graph(MakePath(), 1000);
+
+  auto insert_res = graph.InsertEdges({{0, 2}, {3, 0}, {0, 2}});
+  KATANA_LOG_VASSERT(insert_res, "{}", insert_res.error());
+  KATANA_LOG_ASSERT(graph.NumEdges() == 6);
+  KATANA_LOG_ASSERT(graph.NumPendingUpdates() == 3);
+  KATANA_LOG_ASSERT(Neighbors(graph, 0) == std::vector<Node>({1, 2, 2}));
+  KATANA_LOG_ASSERT(graph.OutDegree(3) == 1);
+  // the graph itself does not change until a merge
+  KATANA_LOG_ASSERT(graph.graph()->NumEdges() == 3);
+
+  auto delete_res = graph.DeleteEdges({{0, 1}, {0, 2}, {2, 1}});
+  KATANA_LOG_VASSERT(delete_res, "{}", delete_res.error());
+  KATANA_LOG_ASSERT(delete_res.value() == 2);
+  KATANA_LOG_ASSERT(graph.NumEdges() == 4);
+  KATANA_LOG_ASSERT(Neighbors(graph, 0) == std::vector<Node>({2}));
+
+  KATANA_LOG_ASSERT(!graph.InsertEdges({{0, 4}}));
+  KATANA_LOG_ASSERT(!graph.DeleteEdges({{4, 0}}));
+  KATANA_LOG_ASSERT(graph.NumEdges() == 4);
+
+  auto merge_res = graph.Merge();
+  KATANA_LOG_VASSERT(merge_res, "{}", merge_res.error());
+  KATANA_LOG_ASSERT(graph.NumPendingUpdates() == 0);
+
+  katana::PropertyGraph* pg = graph.graph();
+  KATANA_LOG_ASSERT(pg->NumEdges() == 4);
+  auto ends_res = pg->GetEdgePropertyTyped<uint64_t>("ends");
+  KATANA_LOG_VASSERT(ends_res, "{}", ends_res.error());
+  auto ends = ends_res.value();
+  for (Edge e : pg->OutEdges()) {
+    uint64_t src = pg->topology().GetEdgeSrc(e);
+    uint64_t dst = pg->topology().OutEdgeDst(e);
+    bool inserted = (src == 0 && dst == 2) || (src == 3 && dst == 0);
+    KATANA_LOG_VASSERT(
+        ends->IsNull(e) == inserted, "edge {} -> {} is null: {}", src, dst,
+        ends->IsNull(e));
+    if (!inserted) {
+      KATANA_LOG_ASSERT(ends->Value(e) == src * 10 + dst);
+    }
+  }
+  for (Node n = 0; n < 4; ++n) {
+    KATANA_LOG_ASSERT(pg->topology().OutDegree(n) == graph.OutDegree(n));
+  }
+}
+
+void
+TestMergeFraction() {
+  DynamicGraph graph(MakePath(), 0.5);
+
+  KATANA_LOG_ASSERT(graph.InsertEdges({{1, 0}}));
+  KATANA_LOG_ASSERT(graph.NumPendingUpdates() == 1);
+  KATANA_LOG_ASSERT(graph.DeleteEdges({{1, 2}}));
+  // 2 updates reach half of the 3 edges
+  KATANA_LOG_ASSERT(graph.NumPendingUpdates() == 0);
+  KATANA_LOG_ASSERT(graph.graph()->NumEdges() == 3);
+  KATANA_LOG_ASSERT(graph.graph()->topology().OutDegree(1) == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestUpdates();
+  TestMergeFraction();
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <arrow/api.h>
+#include <benchmark/benchmark.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long num_nodes : {1 << 12, 1 << 18}) {
+    for (long num_types : {8, 300}) {
+      b->Args({num_nodes, num_types});
+    }
+  }
+}
+
+/// Every node has the type of column node % num_types, and every fourth node
+/// also has one of the first four types, which makes up to 4 * num_types
+/// distinct combinations of types.
+bool
+HasType(size_t node, size_t type, size_t num_types) {
+  return node % num_types == type ||
+         (node % 4 == 0 && (node / num_types) % 4 == type);
+}
+
+std::shared_ptr<arrow::Table>
+MakeTypeProperties(size_t num_nodes, size_t num_types) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (size_t type = 0; type < num_types; ++type) {
+    arrow::UInt8Builder builder;
+    KATANA_LOG_ASSERT(builder.Reserve(num_nodes).ok());
+    for (size_t node = 0; node < num_nodes; ++node) {
+      builder.UnsafeAppend(HasType(node, type, num_types));
+    }
+    std::shared_ptr<arrow::Array> array;
+    KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+    fields.emplace_back(
+        arrow::field(fmt::format("type-{}", type), arrow::uint8()));
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(array));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+void
+ConstructEntityTypeIDs(benchmark::State& state) {
+  auto [num_nodes, num_types] =
+      std::make_tuple(state.range(0), state.range(1));
+
+  std::shared_ptr<arrow::Table> types =
+      MakeTypeProperties(num_nodes, num_types);
+  LinePolicy policy{1};
+  katana::TxnContext txn_ctx;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<katana::PropertyGraph> g =
+        MakeFileGraph<uint32_t>(num_nodes, 0, &policy, &txn_ctx);
+    if (auto r = g->AddNodeProperties(types, &txn_ctx); !r) {
+      KATANA_LOG_FATAL("could not add node types: {}", r.error());
+    }
+    state.ResumeTiming();
+
+    if (auto r = g->ConstructEntityTypeIDs(&txn_ctx); !r) {
+      KATANA_LOG_FATAL("could not construct types: {}", r.error());
+    }
+
+    state.PauseTiming();
+    std::vector<katana::EntityTypeID> type_ids;
+    for (long type = 0; type < num_types; ++type) {
+      type_ids.emplace_back(
+          g->GetNodeEntityTypeID(fmt::format("type-{}", type)));
+    }
+    for (size_t node = 0; node < g->NumNodes(); node += 97) {
+      for (size_t type = 0; type < type_ids.size(); ++type) {
+        KATANA_LOG_VASSERT(
+            g->DoesNodeHaveType(node, type_ids[type]) ==
+                HasType(node, type, num_types),
+            "node {} type {}", node, type);
+      }
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes * num_types);
+}
+
+BENCHMARK(ConstructEntityTypeIDs)->Apply(MakeArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
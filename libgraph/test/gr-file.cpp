@@ -0,0 +1,148 @@
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/GrFile.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Node 0 has edges to 1 and 2, node 1 to 2, node 2 to 0 and node 3 none
+const std::vector<uint64_t> kEnds = {2, 3, 4, 4};
+const std::vector<uint64_t> kDests = {1, 2, 2, 0};
+const std::vector<uint32_t> kWeights = {10, 20, 30, 40};
+
+template <typename T>
+void
+Append(std::vector<char>* bytes, T value) {
+  const char* begin = reinterpret_cast<const char*>(&value);
+  bytes->insert(bytes->end(), begin, begin + sizeof(T));
+}
+
+/// The bytes of a .gr file of the given version, little endian as this
+/// test only runs on little endian hosts
+std::vector<char>
+GrBytes(
+    uint64_t version, const std::vector<uint64_t>& ends,
+    const std::vector<uint64_t>& dests, const std::vector<uint32_t>& data) {
+  std::vector<char> bytes;
+  Append<uint64_t>(&bytes, version);
+  Append<uint64_t>(&bytes, data.empty() ? 0 : sizeof(uint32_t));
+  Append<uint64_t>(&bytes, ends.size());
+  Append<uint64_t>(&bytes, dests.size());
+  for (uint64_t end : ends) {
+    Append<uint64_t>(&bytes, end);
+  }
+  for (size_t i = 0; i < dests.size() + dests.size() % 2; ++i) {
+    uint64_t dest = i < dests.size() ? dests[i] : 0;
+    if (version == 1) {
+      Append<uint32_t>(&bytes, dest);
+    } else {
+      Append<uint64_t>(&bytes, dest);
+    }
+  }
+  for (uint32_t value : data) {
+    Append<uint32_t>(&bytes, value);
+  }
+  return bytes;
+}
+
+std::string
+WriteGr(
+    const std::string& dir, const std::string& name,
+    const std::vector<char>& bytes) {
+  std::string path = dir + "/" + name;
+  std::ofstream out(path, std::ios::binary);
+  out.write(bytes.data(), bytes.size());
+  return path;
+}
+
+void
+CheckTopology(const katana::GraphTopology& topo) {
+  KATANA_LOG_ASSERT(topo.NumNodes() == kEnds.size());
+  KATANA_LOG_ASSERT(topo.NumEdges() == kDests.size());
+  for (size_t n = 0; n < kEnds.size(); ++n) {
+    KATANA_LOG_ASSERT(topo.AdjData()[n] == kEnds[n]);
+  }
+  for (size_t e = 0; e < kDests.size(); ++e) {
+    KATANA_LOG_ASSERT(topo.OutEdgeDst(e) == kDests[e]);
+  }
+}
+
+/// Both versions load the same topology, and the edge data becomes a
+/// property
+void
+TestLoad(const std::string& dir) {
+  for (uint64_t version : {1, 2}) {
+    std::string path = WriteGr(
+        dir, "v" + std::to_string(version) + ".gr",
+        GrBytes(version, kEnds, kDests, kWeights));
+
+    auto topo_res = katana::LoadGrTopology(path);
+    KATANA_LOG_VASSERT(topo_res, "loading {}: {}", path, topo_res.error());
+    CheckTopology(topo_res.value());
+
+    katana::TxnContext txn_ctx;
+    auto pg_res = katana::MakePropertyGraphFromGr(path, "weight", &txn_ctx);
+    KATANA_LOG_VASSERT(pg_res, "making {}: {}", path, pg_res.error());
+    std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+    CheckTopology(pg->topology());
+    auto weights = pg->GetEdgePropertyTyped<uint32_t>("weight").value();
+    for (size_t e = 0; e < kWeights.size(); ++e) {
+      KATANA_LOG_ASSERT(weights->Value(e) == kWeights[e]);
+    }
+
+    auto bare_res = katana::MakePropertyGraphFromGr(path, "", &txn_ctx);
+    KATANA_LOG_ASSERT(bare_res);
+    KATANA_LOG_ASSERT(bare_res.value()->GetNumEdgeProperties() == 0);
+  }
+}
+
+/// Files that do not hold a graph are errors
+void
+TestBadFiles(const std::string& dir) {
+  auto fails = [&](const std::string& name, std::vector<char> bytes) {
+    std::string path = WriteGr(dir, name, std::move(bytes));
+    KATANA_LOG_VASSERT(!katana::LoadGrTopology(path), "{} loaded", name);
+  };
+
+  fails("version.gr", GrBytes(3, kEnds, kDests, kWeights));
+  std::vector<char> truncated = GrBytes(1, kEnds, kDests, {});
+  truncated.resize(truncated.size() - 8);
+  fails("truncated.gr", truncated);
+  fails("dest.gr", GrBytes(1, kEnds, {1, 2, 7, 0}, {}));
+  fails("order.gr", GrBytes(1, {2, 1, 4, 4}, kDests, {}));
+  fails("end.gr", GrBytes(1, {2, 3, 4, 3}, kDests, {}));
+  KATANA_LOG_ASSERT(!katana::LoadGrTopology(dir + "/missing.gr"));
+
+  // the edge data is only needed for a property
+  std::string path = WriteGr(dir, "nodata.gr", GrBytes(1, kEnds, kDests, {}));
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(katana::MakePropertyGraphFromGr(path, "", &txn_ctx));
+  KATANA_LOG_ASSERT(!katana::MakePropertyGraphFromGr(path, "w", &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/grfile");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+
+  TestLoad(dir);
+  TestBadFiles(dir);
+
+  fs::remove_all(dir);
+  return 0;
+}
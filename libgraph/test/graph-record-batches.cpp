@@ -0,0 +1,236 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/GraphRecordBatches.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+
+std::shared_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::shared_ptr<katana::PropertyGraph> pg = katana::MakeGrid(5, 7, true);
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "age", [](Node id) { return static_cast<int32_t>(id * 2); }),
+      katana::PropertyGenerator(
+          "name", [](Node id) { return fmt::format("Node {}", id); }));
+  KATANA_LOG_VASSERT(res, "could not add properties: {}", res.error());
+  return pg;
+}
+
+std::vector<std::shared_ptr<arrow::RecordBatch>>
+ReadAll(arrow::RecordBatchReader* reader) {
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    KATANA_LOG_ASSERT(reader->ReadNext(&batch).ok());
+    if (!batch) {
+      return batches;
+    }
+    KATANA_LOG_ASSERT(batch->schema()->Equals(*reader->schema()));
+    batches.emplace_back(std::move(batch));
+  }
+}
+
+void
+TestNodeProperties() {
+  std::shared_ptr<katana::PropertyGraph> pg = MakeGraph();
+
+  auto reader_result = katana::MakeNodePropertyBatchReader(*pg, {"age"}, 4);
+  KATANA_LOG_VASSERT(reader_result, "{}", reader_result.error());
+  std::shared_ptr<arrow::RecordBatchReader> reader = reader_result.value();
+  KATANA_LOG_ASSERT(reader->schema()->num_fields() == 1);
+
+  // the batches are slices of the property column
+  auto ages = std::static_pointer_cast<arrow::Int32Array>(
+      pg->GetNodeProperty("age").value()->chunk(0));
+  auto batches = ReadAll(reader.get());
+  KATANA_LOG_ASSERT(batches.size() == (pg->NumNodes() + 3) / 4);
+  int64_t row = 0;
+  for (const auto& batch : batches) {
+    KATANA_LOG_ASSERT(batch->num_rows() <= 4);
+    auto column = std::static_pointer_cast<arrow::Int32Array>(batch->column(0));
+    KATANA_LOG_ASSERT(column->raw_values() == ages->raw_values() + row);
+    row += batch->num_rows();
+  }
+  KATANA_LOG_ASSERT(static_cast<uint64_t>(row) == pg->NumNodes());
+
+  // a reader keeps streaming the properties it was made with
+  reader_result = katana::MakeNodePropertyBatchReader(*pg);
+  KATANA_LOG_VASSERT(reader_result, "{}", reader_result.error());
+  reader = reader_result.value();
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("name", &txn_ctx));
+  batches = ReadAll(reader.get());
+  KATANA_LOG_ASSERT(batches.size() == 1);
+  KATANA_LOG_ASSERT(batches[0]->num_columns() == 2);
+  auto names = std::static_pointer_cast<arrow::StringArray>(
+      batches[0]->GetColumnByName("name"));
+  KATANA_LOG_ASSERT(names->GetString(3) == "Node 3");
+
+  KATANA_LOG_ASSERT(!katana::MakeNodePropertyBatchReader(*pg, {"name"}));
+  KATANA_LOG_ASSERT(!katana::MakeNodePropertyBatchReader(*pg, {}, 0));
+}
+
+void
+TestEdgeList() {
+  std::shared_ptr<katana::PropertyGraph> pg = MakeGraph();
+
+  auto reader_result = katana::MakeEdgeListBatchReader(pg, 7);
+  KATANA_LOG_VASSERT(reader_result, "{}", reader_result.error());
+  std::shared_ptr<arrow::RecordBatchReader> reader = reader_result.value();
+  const katana::GraphTopology& topo = pg->topology();
+
+  // the reader keeps the graph alive
+  pg.reset();
+
+  std::vector<Node> sources;
+  std::vector<Node> dests;
+  for (const auto& batch : ReadAll(reader.get())) {
+    KATANA_LOG_ASSERT(batch->num_rows() <= 7);
+    auto src = std::static_pointer_cast<arrow::UInt32Array>(batch->column(0));
+    auto dst = std::static_pointer_cast<arrow::UInt32Array>(batch->column(1));
+    KATANA_LOG_ASSERT(src->null_count() == 0 && dst->null_count() == 0);
+    for (int64_t i = 0; i < batch->num_rows(); ++i) {
+      sources.emplace_back(src->Value(i));
+      dests.emplace_back(dst->Value(i));
+    }
+  }
+
+  KATANA_LOG_ASSERT(sources.size() == topo.NumEdges());
+  for (Node n : topo.Nodes()) {
+    for (auto e : topo.OutEdges(n)) {
+      KATANA_LOG_VASSERT(sources[e] == n, "edge {}", e);
+      KATANA_LOG_VASSERT(dests[e] == topo.OutEdgeDst(e), "edge {}", e);
+    }
+  }
+}
+
+template <typename Builder, typename T>
+std::shared_ptr<arrow::Array>
+MakeArray(const std::vector<T>& values) {
+  Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(values).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::shared_ptr<arrow::RecordBatch>
+MakeNodeBatch(
+    const std::vector<int64_t>& ids, const std::vector<std::string>& names) {
+  auto schema = arrow::schema(
+      {arrow::field("id", arrow::int64()),
+       arrow::field("name", arrow::utf8())});
+  return arrow::RecordBatch::Make(
+      schema, ids.size(),
+      {MakeArray<arrow::Int64Builder>(ids),
+       MakeArray<arrow::StringBuilder>(names)});
+}
+
+std::shared_ptr<arrow::RecordBatch>
+MakeEdgeBatch(
+    const std::vector<int32_t>& sources, const std::vector<int32_t>& dests,
+    const std::vector<int32_t>& weights) {
+  auto schema = arrow::schema(
+      {arrow::field("src", arrow::int32()),
+       arrow::field("weight", arrow::int32()),
+       arrow::field("dst", arrow::int32())});
+  return arrow::RecordBatch::Make(
+      schema, sources.size(),
+      {MakeArray<arrow::Int32Builder>(sources),
+       MakeArray<arrow::Int32Builder>(weights),
+       MakeArray<arrow::Int32Builder>(dests)});
+}
+
+void
+TestBuilder() {
+  katana::RecordBatchGraphBuilder builder;
+  KATANA_LOG_ASSERT(builder.AddNodes(*MakeNodeBatch({30, 10}, {"c", "a"})));
+  KATANA_LOG_ASSERT(builder.AddEdges(
+      *MakeEdgeBatch({10, 30, 10}, {20, 10, 30}, {1, 2, 3})));
+
+  // a failed batch leaves the builder as it was
+  auto dup = builder.AddNodes(*MakeNodeBatch({20, 10}, {"b", "x"}));
+  KATANA_LOG_ASSERT(!dup && dup.error() == katana::ErrorCode::AlreadyExists);
+  auto other_schema = arrow::RecordBatch::Make(
+      arrow::schema({arrow::field("id", arrow::int64())}), 1,
+      {MakeArray<arrow::Int64Builder>(std::vector<int64_t>{40})});
+  KATANA_LOG_ASSERT(!builder.AddNodes(*other_schema));
+
+  KATANA_LOG_ASSERT(builder.AddNodes(*MakeNodeBatch({20}, {"b"})));
+  KATANA_LOG_ASSERT(
+      builder.AddEdges(*MakeEdgeBatch({20, 10}, {30, 10}, {4, 5})));
+  KATANA_LOG_ASSERT(builder.num_nodes() == 3);
+  KATANA_LOG_ASSERT(builder.num_edges() == 5);
+
+  katana::TxnContext txn_ctx;
+  auto pg_result = builder.Finish(&txn_ctx);
+  KATANA_LOG_VASSERT(pg_result, "{}", pg_result.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_result.value());
+  KATANA_LOG_ASSERT(builder.num_nodes() == 0 && builder.num_edges() == 0);
+
+  // nodes are numbered in the order they arrived, 30, 10, 20, and the
+  // edges of a node are in the order they arrived
+  using Edges = std::vector<std::pair<Node, int32_t>>;
+  std::vector<Edges> expected{
+      {{1, 2}}, {{2, 1}, {0, 3}, {1, 5}}, {{0, 4}}};
+  const katana::GraphTopology& topo = pg->topology();
+  KATANA_LOG_ASSERT(topo.NumNodes() == 3 && topo.NumEdges() == 5);
+  auto weights = std::static_pointer_cast<arrow::Int32Array>(
+      pg->GetEdgeProperty("weight").value()->chunk(0));
+  for (Node n : topo.Nodes()) {
+    Edges edges;
+    for (auto e : topo.OutEdges(n)) {
+      edges.emplace_back(topo.OutEdgeDst(e), weights->Value(e));
+    }
+    KATANA_LOG_VASSERT(edges == expected[n], "node {}", n);
+  }
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 1);
+
+  auto ids = std::static_pointer_cast<arrow::Int64Array>(
+      pg->GetNodeProperty("id").value()->chunk(0));
+  auto names = std::static_pointer_cast<arrow::StringArray>(
+      pg->GetNodeProperty("name").value()->chunk(0));
+  KATANA_LOG_ASSERT(ids->Value(0) == 30 && ids->Value(2) == 20);
+  KATANA_LOG_ASSERT(names->GetString(1) == "a" && names->GetString(2) == "b");
+
+  // edges must refer to nodes that arrived
+  KATANA_LOG_ASSERT(builder.AddNodes(*MakeNodeBatch({1}, {"a"})));
+  KATANA_LOG_ASSERT(builder.AddEdges(*MakeEdgeBatch({1}, {2}, {1})));
+  auto missing = builder.Finish(&txn_ctx);
+  KATANA_LOG_ASSERT(!missing && missing.error() == katana::ErrorCode::NotFound);
+
+  katana::RecordBatchGraphBuilder::Options options;
+  options.dense_node_ids = true;
+  katana::RecordBatchGraphBuilder dense(options);
+  KATANA_LOG_ASSERT(!dense.AddNodes(*MakeNodeBatch({1}, {"a"})));
+  KATANA_LOG_ASSERT(dense.AddNodes(*MakeNodeBatch({0, 1}, {"a", "b"})));
+  KATANA_LOG_ASSERT(dense.AddEdges(*MakeEdgeBatch({1, 0}, {0, 1}, {1, 2})));
+  pg_result = dense.Finish(&txn_ctx);
+  KATANA_LOG_VASSERT(pg_result, "{}", pg_result.error());
+  KATANA_LOG_ASSERT(pg_result.value()->topology().OutEdgeDst(0) == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestNodeProperties();
+  TestEdgeList();
+  TestBuilder();
+
+  return 0;
+}
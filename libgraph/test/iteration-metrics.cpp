@@ -0,0 +1,91 @@
+#include "katana/analytics/IterationMetrics.h"
+
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/cdlp/cdlp.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+std::vector<IterationMetrics> reported;
+
+/// Checks the iterations reported are those of analytic, numbered from 1
+void
+CheckReported(const std::string& analytic) {
+  KATANA_LOG_VASSERT(!reported.empty(), "{} reported nothing", analytic);
+  for (size_t i = 0; i < reported.size(); ++i) {
+    const IterationMetrics& metrics = reported[i];
+    KATANA_LOG_VASSERT(
+        metrics.analytic == analytic, "found {}, expected {}",
+        metrics.analytic, analytic);
+    KATANA_LOG_VASSERT(
+        metrics.iteration == i + 1, "iteration {}, expected {}",
+        metrics.iteration, i + 1);
+  }
+}
+
+void
+TestPagerank() {
+  auto pg = katana::MakeGrid(20, 20, false);
+  katana::TxnContext txn_ctx;
+  constexpr unsigned kMaxIterations = 5;
+  // a tolerance of 0 runs every iteration
+  auto res = Pagerank(
+      pg.get(), "rank", &txn_ctx,
+      PagerankPlan::PullTopological(0, kMaxIterations));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  CheckReported("pagerank_pull_topological");
+  KATANA_LOG_ASSERT(reported.size() == kMaxIterations);
+  for (const IterationMetrics& metrics : reported) {
+    KATANA_LOG_ASSERT(metrics.active_nodes == pg->NumNodes());
+    KATANA_LOG_ASSERT(metrics.work_items == pg->NumEdges());
+    KATANA_LOG_ASSERT(metrics.convergence > 0);
+  }
+  reported.clear();
+}
+
+void
+TestCdlp() {
+  auto pg = katana::MakeGrid(20, 20, false);
+  katana::TxnContext txn_ctx;
+  auto res = Cdlp(pg.get(), "label", 100, &txn_ctx, true);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  CheckReported("cdlp_synchronous");
+  // every node is gathered in the first iteration
+  KATANA_LOG_ASSERT(reported.front().active_nodes == pg->NumNodes());
+  KATANA_LOG_ASSERT(reported.front().work_items == pg->NumEdges());
+  if (reported.size() < 100) {
+    // it stopped because no label changed
+    KATANA_LOG_ASSERT(reported.back().convergence == 0);
+  }
+  reported.clear();
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  SetIterationObserver(
+      [](const IterationMetrics& metrics) { reported.emplace_back(metrics); });
+  TestPagerank();
+  TestCdlp();
+
+  SetIterationObserver({});
+  auto pg = katana::MakeGrid(20, 20, false);
+  katana::TxnContext txn_ctx;
+  auto res =
+      Pagerank(pg.get(), "rank", &txn_ctx, PagerankPlan::PullTopological());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(reported.empty());
+  return 0;
+}
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/MirrorSync.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr uint32_t kNumHosts = 3;
+constexpr uint32_t kNumNodes = 10;
+
+/// State shared by the hosts of a ThreadCommBackend
+struct Mailbox {
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t arrived{0};
+  uint64_t generation{0};
+  /// slots[to][from]
+  std::vector<std::vector<std::string>> slots =
+      std::vector<std::vector<std::string>>(
+          kNumHosts, std::vector<std::string>(kNumHosts));
+};
+
+/// A communication backend for hosts that are threads of one process
+class ThreadCommBackend : public katana::CommBackend {
+public:
+  ThreadCommBackend(Mailbox* mailbox, uint32_t rank) : mailbox_(mailbox) {
+    Initialize(kNumHosts, rank, rank);
+  }
+
+  void Barrier() override {
+    std::unique_lock<std::mutex> lock(mailbox_->mutex);
+    uint64_t generation = mailbox_->generation;
+    if (++mailbox_->arrived == Num) {
+      mailbox_->arrived = 0;
+      ++mailbox_->generation;
+      mailbox_->cv.notify_all();
+      return;
+    }
+    mailbox_->cv.wait(
+        lock, [&]() { return mailbox_->generation != generation; });
+  }
+
+  void NotifyFailure() override {}
+
+  bool Broadcast(uint32_t root, bool val) override {
+    return Broadcast(root, std::string(1, val ? '1' : '0'), 1) == "1";
+  }
+
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override {
+    std::vector<std::string> sends(Num);
+    if (Rank == root) {
+      sends.assign(Num, val.substr(0, max_size));
+    }
+    return AllToAll(std::move(sends)).value()[root];
+  }
+
+  katana::Result<std::vector<std::string>> AllToAll(
+      std::vector<std::string> sends) override {
+    KATANA_LOG_ASSERT(sends.size() == Num);
+    {
+      std::lock_guard<std::mutex> lock(mailbox_->mutex);
+      for (uint32_t to = 0; to < Num; ++to) {
+        mailbox_->slots[to][Rank] = std::move(sends[to]);
+      }
+    }
+    Barrier();
+    std::vector<std::string> recvs;
+    {
+      std::lock_guard<std::mutex> lock(mailbox_->mutex);
+      recvs = std::move(mailbox_->slots[Rank]);
+      mailbox_->slots[Rank].assign(Num, "");
+    }
+    // nobody may send again until everyone has collected their messages
+    Barrier();
+    return recvs;
+  }
+
+private:
+  Mailbox* mailbox_;
+};
+
+uint32_t
+Owner(uint32_t node) {
+  return node % kNumHosts;
+}
+
+/// Every host has a copy of every node; local ids are global ids
+void
+MakeNodeLists(
+    uint32_t rank, std::vector<std::vector<uint32_t>>* masters,
+    std::vector<std::vector<uint32_t>>* mirrors) {
+  masters->assign(kNumHosts, {});
+  mirrors->assign(kNumHosts, {});
+  for (uint32_t host = 0; host < kNumHosts; ++host) {
+    if (host == rank) {
+      continue;
+    }
+    for (uint32_t node = 0; node < kNumNodes; ++node) {
+      if (Owner(node) == rank) {
+        (*masters)[host].emplace_back(node);
+      } else if (Owner(node) == host) {
+        (*mirrors)[host].emplace_back(node);
+      }
+    }
+  }
+}
+
+katana::Result<void>
+RunHost(
+    katana::CommBackend* comm, std::vector<uint32_t>* values,
+    katana::DynamicBitset* dirty) {
+  std::vector<std::vector<uint32_t>> masters;
+  std::vector<std::vector<uint32_t>> mirrors;
+  MakeNodeLists(comm->rank(), &masters, &mirrors);
+  katana::MirrorSync sync(comm, std::move(masters), std::move(mirrors));
+
+  uint32_t num_owned = 0;
+  for (uint32_t node = 0; node < kNumNodes; ++node) {
+    num_owned += Owner(node) == comm->rank();
+  }
+  KATANA_LOG_ASSERT(sync.num_masters() == num_owned * (kNumHosts - 1));
+  KATANA_LOG_ASSERT(sync.num_mirrors() == kNumNodes - num_owned);
+
+  // every host proposes a different value for every node; the smallest,
+  // from host 0, wins
+  for (uint32_t node = 0; node < kNumNodes; ++node) {
+    (*values)[node] = 100 + 10 * comm->rank() + node;
+    dirty->set(node);
+  }
+  KATANA_CHECKED(sync.Reduce(
+      values->data(), dirty,
+      [](uint32_t a, uint32_t b) { return std::min(a, b); }));
+  for (uint32_t node = 0; node < kNumNodes; ++node) {
+    if (Owner(node) == comm->rank()) {
+      KATANA_LOG_ASSERT((*values)[node] == 100 + node);
+      KATANA_LOG_ASSERT(dirty->test(node));
+    } else {
+      KATANA_LOG_ASSERT(!dirty->test(node));
+    }
+  }
+
+  KATANA_CHECKED(sync.Broadcast(values->data(), dirty));
+  for (uint32_t node = 0; node < kNumNodes; ++node) {
+    KATANA_LOG_VASSERT(
+        (*values)[node] == 100 + node, "host {} node {}: {}", comm->rank(),
+        node, (*values)[node]);
+    KATANA_LOG_ASSERT(dirty->test(node));
+  }
+
+  // with nothing dirty, nothing changes
+  dirty->reset();
+  (*values)[1] = 0;
+  KATANA_CHECKED(sync.Broadcast(values->data(), dirty));
+  KATANA_CHECKED(sync.Reduce(
+      values->data(), dirty,
+      [](uint32_t a, uint32_t b) { return std::min(a, b); }));
+  KATANA_LOG_ASSERT((*values)[1] == 0);
+  KATANA_LOG_ASSERT(dirty->begin() == dirty->end());
+
+  auto sum = KATANA_CHECKED(sync.AllReduce<uint64_t>(
+      comm->rank() + 1, [](uint64_t a, uint64_t b) { return a + b; }));
+  KATANA_LOG_ASSERT(sum == kNumHosts * (kNumHosts + 1) / 2);
+
+  return katana::ResultSuccess();
+}
+
+void
+TestSync() {
+  Mailbox mailbox;
+  std::vector<std::unique_ptr<ThreadCommBackend>> comms;
+  std::vector<std::vector<uint32_t>> values(kNumHosts);
+  std::vector<katana::DynamicBitset> dirty(kNumHosts);
+  for (uint32_t rank = 0; rank < kNumHosts; ++rank) {
+    comms.emplace_back(std::make_unique<ThreadCommBackend>(&mailbox, rank));
+    values[rank].resize(kNumNodes);
+    dirty[rank].resize(kNumNodes);
+  }
+
+  std::vector<std::thread> hosts;
+  for (uint32_t rank = 0; rank < kNumHosts; ++rank) {
+    hosts.emplace_back([&, rank]() {
+      auto res = RunHost(comms[rank].get(), &values[rank], &dirty[rank]);
+      if (!res) {
+        KATANA_LOG_FATAL("host {}: {}", rank, res.error());
+      }
+    });
+  }
+  for (auto& host : hosts) {
+    host.join();
+  }
+}
+
+void
+TestMake() {
+  Mailbox mailbox;
+  ThreadCommBackend comm(&mailbox, 1);
+
+  std::vector<std::vector<uint32_t>> masters;
+  std::vector<std::vector<uint32_t>> mirrors;
+  MakeNodeLists(comm.rank(), &masters, &mirrors);
+  auto master_nodes = katana::MarshalVectorOfVectors(masters).value();
+  auto mirror_nodes = katana::MarshalVectorOfVectors(mirrors).value();
+
+  auto sync_res = katana::MirrorSync::Make(&comm, master_nodes, mirror_nodes);
+  KATANA_LOG_ASSERT(sync_res);
+  KATANA_LOG_ASSERT(sync_res.value().num_masters() == 6);
+  KATANA_LOG_ASSERT(sync_res.value().num_mirrors() == 7);
+
+  // more lists than hosts
+  master_nodes.resize(kNumHosts + 1, master_nodes[0]);
+  KATANA_LOG_ASSERT(
+      !katana::MirrorSync::Make(&comm, master_nodes, mirror_nodes));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestSync();
+  TestMake();
+
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+using katana::analytics::NeighborSample;
+using katana::analytics::NeighborSampler;
+using katana::analytics::SampledBlock;
+using Node = katana::PropertyGraph::Node;
+
+namespace {
+
+/// Check that every sampled edge of block goes from one of its source nodes
+/// to its destination node, that no edge is sampled twice and that each node
+/// keeps min(fanout, in-degree) edges
+void
+CheckBlock(
+    katana::PropertyGraph* pg, const SampledBlock& block, uint32_t fanout) {
+  auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+  const auto& topology = pg->topology();
+
+  KATANA_LOG_ASSERT(block.indptr.size() == block.num_dst_nodes + 1);
+  KATANA_LOG_ASSERT(block.edge_ids.size() == block.num_edges());
+  for (uint64_t i = 0; i < block.num_dst_nodes; ++i) {
+    Node dst = block.src_nodes[i];
+    uint64_t begin = block.indptr[i];
+    uint64_t end = block.indptr[i + 1];
+    KATANA_LOG_VASSERT(
+        end - begin == std::min<uint64_t>(fanout, view.InDegree(dst)),
+        "node {} kept {} of {} edges with fanout {}", dst, end - begin,
+        view.InDegree(dst), fanout);
+
+    std::vector<uint64_t> edges;
+    for (uint64_t k = begin; k < end; ++k) {
+      Node src = block.src_nodes[block.src_indices[k]];
+      uint64_t e = block.edge_ids[k];
+      auto out_edges = topology.OutEdges(src);
+      KATANA_LOG_VASSERT(
+          *out_edges.begin() <= e && e < *out_edges.end() &&
+              topology.OutEdgeDst(e) == dst,
+          "edge {} is not an edge from {} to {}", e, src, dst);
+      edges.emplace_back(e);
+    }
+    std::sort(edges.begin(), edges.end());
+    KATANA_LOG_VASSERT(
+        std::adjacent_find(edges.begin(), edges.end()) == edges.end(),
+        "node {} sampled an edge twice", dst);
+  }
+
+  std::vector<Node> sources(block.src_nodes.begin(), block.src_nodes.end());
+  std::sort(sources.begin(), sources.end());
+  KATANA_LOG_ASSERT(
+      std::adjacent_find(sources.begin(), sources.end()) == sources.end());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto res =
+      katana::PropertyGraph::Make(katana::CreateUniformRandomTopology(1000, 8));
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+
+  katana::TxnContext txn_ctx;
+  auto added = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "id", [](Node id) { return static_cast<uint64_t>(id); }));
+  KATANA_LOG_VASSERT(added, "AddNodeProperties failed: {}", added.error());
+
+  std::vector<uint32_t> fanouts{5, 3};
+  auto sampler_res = NeighborSampler::Make(pg.get(), fanouts, {"id"});
+  KATANA_LOG_VASSERT(
+      sampler_res, "NeighborSampler::Make failed: {}", sampler_res.error());
+  auto sampler = std::move(sampler_res.value());
+
+  std::vector<Node> seeds{3, 1, 4, 15, 9, 26};
+  auto sample_res = sampler->Sample(seeds, 7);
+  KATANA_LOG_VASSERT(sample_res, "Sample failed: {}", sample_res.error());
+  NeighborSample sample = std::move(sample_res.value());
+
+  // blocks run from the input layer to the seeds
+  KATANA_LOG_ASSERT(sample.blocks.size() == fanouts.size());
+  const SampledBlock& last = sample.blocks.back();
+  KATANA_LOG_ASSERT(last.num_dst_nodes == seeds.size());
+  for (size_t i = 0; i < seeds.size(); ++i) {
+    KATANA_LOG_ASSERT(last.src_nodes[i] == seeds[i]);
+  }
+  for (size_t b = 0; b < sample.blocks.size(); ++b) {
+    const SampledBlock& block = sample.blocks[b];
+    CheckBlock(pg.get(), block, fanouts[fanouts.size() - 1 - b]);
+    if (b + 1 < sample.blocks.size()) {
+      const SampledBlock& next = sample.blocks[b + 1];
+      KATANA_LOG_ASSERT(block.num_dst_nodes == next.num_src_nodes());
+      for (uint64_t j = 0; j < next.num_src_nodes(); ++j) {
+        KATANA_LOG_ASSERT(block.src_nodes[j] == next.src_nodes[j]);
+      }
+    }
+  }
+
+  // features are gathered for the input nodes
+  const auto& input_nodes = sample.input_nodes();
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(sample.node_features->num_rows()) ==
+      input_nodes.size());
+  auto ids = std::static_pointer_cast<arrow::UInt64Array>(
+      sample.node_features->column(0)->chunk(0));
+  for (uint64_t j = 0; j < input_nodes.size(); ++j) {
+    KATANA_LOG_ASSERT(ids->Value(j) == input_nodes[j]);
+  }
+
+  // the same random seed gives the same sample, also after a failed call
+  KATANA_LOG_ASSERT(!sampler->Sample({1, 2, 1}, 7));
+  auto again_res = sampler->Sample(seeds, 7);
+  KATANA_LOG_ASSERT(again_res);
+  const auto& again = again_res.value().input_nodes();
+  KATANA_LOG_ASSERT(again.size() == input_nodes.size());
+  KATANA_LOG_ASSERT(
+      std::equal(again.begin(), again.end(), input_nodes.begin()));
+
+  return 0;
+}
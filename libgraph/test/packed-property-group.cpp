@@ -0,0 +1,74 @@
+#include "katana/Logging.h"
+#include "katana/PackedPropertyGroup.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
+
+namespace {
+
+struct ClusterID : public katana::PODProperty<uint64_t> {};
+struct Weight : public katana::PODProperty<double> {};
+struct Flag : public katana::PODProperty<uint8_t> {};
+
+using NodeData = std::tuple<ClusterID, Weight, Flag>;
+using Graph = katana::TypedPropertyGraph<NodeData, std::tuple<>>;
+
+// rows are no bigger than they need to be and never straddle cache lines
+static_assert(
+    sizeof(katana::PackedPropertyGroup<ClusterID, Weight>::Row) == 16);
+static_assert(
+    alignof(katana::PackedPropertyGroup<ClusterID, Weight>::Row) == 16);
+static_assert(sizeof(katana::PackedPropertyGroup<Flag>::Row) == 1);
+
+void
+TestGatherScatter() {
+  std::unique_ptr<katana::PropertyGraph> pg = katana::MakeGrid(7, 9, false);
+  katana::TxnContext txn_ctx;
+  std::vector<std::string> names{"cluster", "weight", "flag"};
+  auto res = pg->ConstructNodeProperties<NodeData>(&txn_ctx, names);
+  KATANA_LOG_VASSERT(res, "could not construct properties: {}", res.error());
+  auto graph_result = Graph::Make(pg.get(), names, {});
+  KATANA_LOG_VASSERT(graph_result, "{}", graph_result.error());
+  Graph graph = graph_result.value();
+
+  for (auto n : graph) {
+    graph.GetData<ClusterID>(n) = n;
+    graph.GetData<Weight>(n) = n * 0.5;
+    graph.GetData<Flag>(n) = n % 2;
+  }
+
+  using Packed = katana::PackedPropertyGroup<ClusterID, Weight, Flag>;
+  Packed packed = Packed::Gather(graph);
+  KATANA_LOG_ASSERT(packed.size() == graph.NumNodes());
+  for (auto n : graph) {
+    KATANA_LOG_ASSERT(packed.Get<ClusterID>(n) == n);
+    KATANA_LOG_ASSERT(packed.Get<Weight>(n) == n * 0.5);
+    KATANA_LOG_ASSERT(packed.Get<Flag>(n) == static_cast<uint8_t>(n % 2));
+    packed.Get<ClusterID>(n) = n + 100;
+    packed.Get<Weight>(n) = n * 2.0;
+  }
+
+  // only the given properties are written back
+  packed.Scatter<ClusterID>(&graph);
+  for (auto n : graph) {
+    KATANA_LOG_ASSERT(graph.GetData<ClusterID>(n) == n + 100);
+    KATANA_LOG_ASSERT(graph.GetData<Weight>(n) == n * 0.5);
+  }
+
+  packed.Scatter(&graph);
+  for (auto n : graph) {
+    KATANA_LOG_ASSERT(graph.GetData<Weight>(n) == n * 2.0);
+    KATANA_LOG_ASSERT(graph.GetData<Flag>(n) == static_cast<uint8_t>(n % 2));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestGatherScatter();
+
+  return 0;
+}
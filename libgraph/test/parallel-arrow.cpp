@@ -0,0 +1,146 @@
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api_vector.h>
+
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelArrow.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// An int64 array of length values starting at first where every seventh
+/// value is null if with_nulls
+std::shared_ptr<arrow::Array>
+MakeInts(int64_t first, int64_t length, bool with_nulls) {
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < length; ++i) {
+    if (with_nulls && (first + i) % 7 == 0) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(first + i).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::shared_ptr<arrow::Array>
+MakeStrings(int64_t length) {
+  arrow::StringBuilder builder;
+  for (int64_t i = 0; i < length; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(std::to_string(i)).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+/// Chunks that span several copy blocks, including an empty and a sliced one
+arrow::ArrayVector
+MakeChunks(bool with_nulls) {
+  return {
+      MakeInts(0, 100000, with_nulls), MakeInts(100000, 17, with_nulls),
+      MakeInts(0, 0, with_nulls),
+      MakeInts(100017, 70013, with_nulls)->Slice(5, 70000)};
+}
+
+void
+TestConcatenate() {
+  for (bool with_nulls : {false, true}) {
+    arrow::ArrayVector chunks = MakeChunks(with_nulls);
+    auto expected = arrow::Concatenate(chunks);
+    KATANA_LOG_ASSERT(expected.ok());
+    auto concatenated = katana::ParallelConcatenate(chunks);
+    KATANA_LOG_VASSERT(
+        concatenated, "concatenating: {}", concatenated.error());
+    KATANA_LOG_ASSERT(concatenated.value()->Equals(*expected.ValueOrDie()));
+    KATANA_LOG_ASSERT(
+        concatenated.value()->null_count() ==
+        expected.ValueOrDie()->null_count());
+  }
+
+  arrow::ArrayVector strings{MakeStrings(10), MakeStrings(20)};
+  auto concatenated = katana::ParallelConcatenate(strings);
+  KATANA_LOG_ASSERT(concatenated);
+  KATANA_LOG_ASSERT(
+      concatenated.value()->Equals(*arrow::Concatenate(strings).ValueOrDie()));
+
+  KATANA_LOG_ASSERT(!katana::ParallelConcatenate({}));
+  // chunks of different types
+  KATANA_LOG_ASSERT(
+      !katana::ParallelConcatenate({MakeInts(0, 10, false), MakeStrings(10)}));
+}
+
+void
+TestUnchunk() {
+  auto single = std::make_shared<arrow::ChunkedArray>(MakeInts(0, 1000, true));
+  auto unchunked = katana::Unchunk(single);
+  KATANA_LOG_ASSERT(unchunked);
+  // a single chunk is not copied
+  KATANA_LOG_ASSERT(unchunked.value() == single->chunk(0));
+
+  auto empty = katana::Unchunk(std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{}, arrow::int64()));
+  KATANA_LOG_ASSERT(empty && empty.value()->length() == 0);
+
+  auto chunked = std::make_shared<arrow::ChunkedArray>(MakeChunks(true));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("chunked", arrow::int64()),
+                     arrow::field("single", arrow::int64())}),
+      {chunked, std::make_shared<arrow::ChunkedArray>(
+                    MakeInts(0, chunked->length(), false))});
+  auto unchunked_table = katana::UnchunkTable(table);
+  KATANA_LOG_ASSERT(unchunked_table);
+  for (const auto& column : unchunked_table.value()->columns()) {
+    KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  }
+  KATANA_LOG_ASSERT(unchunked_table.value()->Equals(*table));
+  KATANA_LOG_ASSERT(unchunked_table.value()->column(1) == table->column(1));
+
+  auto same = katana::UnchunkTable(unchunked_table.value());
+  KATANA_LOG_ASSERT(same && same.value() == unchunked_table.value());
+}
+
+void
+TestTake() {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns{
+      std::make_shared<arrow::ChunkedArray>(MakeChunks(false)),
+      std::make_shared<arrow::ChunkedArray>(MakeChunks(true)),
+      std::make_shared<arrow::ChunkedArray>(
+          arrow::ArrayVector{MakeStrings(100000), MakeStrings(70017)})};
+  for (const auto& column : columns) {
+    katana::NUMAArray<uint64_t> indices;
+    indices.allocateInterleaved(column->length() / 3);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices[i] = (i * 7919) % column->length();
+    }
+    auto index_array = std::make_shared<arrow::UInt64Array>(
+        indices.size(), arrow::Buffer::Wrap(indices.data(), indices.size()));
+    auto expected = arrow::compute::Take(column, index_array);
+    KATANA_LOG_ASSERT(expected.ok());
+
+    auto taken = katana::ParallelTake(column, indices);
+    KATANA_LOG_VASSERT(taken, "taking: {}", taken.error());
+    KATANA_LOG_ASSERT(taken.value()->num_chunks() == 1);
+    KATANA_LOG_ASSERT(
+        taken.value()->Equals(*expected.ValueOrDie().chunked_array()));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestConcatenate();
+  TestUnchunk();
+  TestTake();
+
+  return 0;
+}
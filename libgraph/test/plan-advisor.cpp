@@ -0,0 +1,129 @@
+#include "katana/analytics/PlanAdvisor.h"
+
+#include <string>
+
+#include <fmt/format.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edge = katana::PropertyGraph::Edge;
+
+void
+AddWeights(katana::PropertyGraph* pg) {
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      pg, &txn_ctx,
+      katana::PropertyGenerator(
+          "weight", [](Edge e) { return static_cast<uint32_t>(e % 100 + 1); }),
+      katana::PropertyGenerator(
+          "name", [](Edge e) { return fmt::format("edge {}", e); }));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+}
+
+SsspPlan
+Sssp(PlanAdvisor* advisor) {
+  auto plan = advisor->Sssp("weight");
+  KATANA_LOG_VASSERT(plan, "{}", plan.error());
+  return plan.value();
+}
+
+/// A mesh: a high diameter and no skew
+void
+TestGrid() {
+  auto pg = katana::MakeGrid(100, 100, false);
+  AddWeights(pg.get());
+  PlanAdvisor advisor(pg.get());
+
+  const GraphProfile& profile = advisor.Profile();
+  KATANA_LOG_ASSERT(profile.num_nodes == 10000);
+  KATANA_LOG_ASSERT(profile.max_degree == 4);
+  KATANA_LOG_ASSERT(!profile.is_power_law);
+  // corner to corner
+  KATANA_LOG_VASSERT(
+      profile.approximate_diameter == 198, "approximate diameter {}",
+      profile.approximate_diameter);
+  KATANA_LOG_ASSERT(profile.IsHighDiameter());
+  // computed once
+  KATANA_LOG_ASSERT(&advisor.Profile() == &profile);
+
+  KATANA_LOG_ASSERT(advisor.Bfs().algorithm() == BfsPlan::kAsynchronousTile);
+  KATANA_LOG_ASSERT(
+      advisor.ConnectedComponents().algorithm() ==
+      ConnectedComponentsPlan::kAfforest);
+  KATANA_LOG_ASSERT(
+      advisor.TriangleCount().relabeling() == TriangleCountPlan::kNoRelabel);
+  KATANA_LOG_ASSERT(
+      advisor.Pagerank().algorithm() == PagerankPlan::kPushAsynchronous);
+
+  // weights up to 100 over 4 edges per node: a step of 2^4
+  SsspPlan sssp = Sssp(&advisor);
+  KATANA_LOG_ASSERT(sssp.algorithm() == SsspPlan::kDeltaStepAdaptive);
+  KATANA_LOG_VASSERT(sssp.delta() == 4, "delta {}", sssp.delta());
+
+  KATANA_LOG_ASSERT(!advisor.Sssp("name"));
+  KATANA_LOG_ASSERT(!advisor.Sssp("missing"));
+}
+
+/// A power-law graph: a low diameter and a few hubs
+void
+TestRMAT() {
+  katana::RMATOptions options;
+  options.scale = 14;
+  auto topo = katana::MakeRMATTopology(options);
+  KATANA_LOG_VASSERT(topo, "{}", topo.error());
+  auto pg = katana::PropertyGraph::Make(std::move(topo.value()));
+  KATANA_LOG_VASSERT(pg, "{}", pg.error());
+  AddWeights(pg.value().get());
+  PlanAdvisor advisor(pg.value().get());
+
+  const GraphProfile& profile = advisor.Profile();
+  KATANA_LOG_ASSERT(profile.is_power_law);
+  KATANA_LOG_VASSERT(
+      !profile.IsHighDiameter(), "approximate diameter {}",
+      profile.approximate_diameter);
+  KATANA_LOG_ASSERT(profile.degree_skew > 1);
+
+  KATANA_LOG_ASSERT(
+      advisor.Bfs().algorithm() == BfsPlan::kSynchronousDirectOpt);
+  TriangleCountPlan tc = advisor.TriangleCount();
+  KATANA_LOG_ASSERT(tc.algorithm() == TriangleCountPlan::kOrderedCount);
+  KATANA_LOG_ASSERT(tc.relabeling() == TriangleCountPlan::kRelabel);
+  KATANA_LOG_ASSERT(tc.hub_bitmap_budget() > 0);
+  KATANA_LOG_ASSERT(
+      advisor.Pagerank().algorithm() == PagerankPlan::kPullTopological);
+  KATANA_LOG_ASSERT(Sssp(&advisor).algorithm() == SsspPlan::kDeltaStep);
+}
+
+void
+TestSmall() {
+  auto pg = katana::MakeGrid(10, 10, true);
+  PlanAdvisor advisor(pg.get());
+  KATANA_LOG_ASSERT(
+      advisor.ConnectedComponents().algorithm() ==
+      ConnectedComponentsPlan::kSerial);
+
+  auto empty = katana::PropertyGraph::Make(katana::GraphTopology());
+  KATANA_LOG_ASSERT(empty);
+  PlanAdvisor empty_advisor(empty.value().get());
+  KATANA_LOG_ASSERT(empty_advisor.Profile().num_nodes == 0);
+  KATANA_LOG_ASSERT(
+      empty_advisor.Bfs().algorithm() == BfsPlan::kSynchronousDirectOpt);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestGrid();
+  TestRMAT();
+  TestSmall();
+
+  return 0;
+}
@@ -55,6 +55,40 @@ SplitString(std::string& str, std::vector<std::string>* vec) {
   }
 }
 
+/// Checks that \p projected has the nodes and edges, in order, of \p pg_view,
+/// the projection of the same types made by MakeProjectedGraph
+template <typename Topo>
+void
+CheckProjectedTopology(
+    const Topo& projected, const katana::PropertyGraph& pg_view) {
+  const katana::GraphTopology& expected = pg_view.topology();
+  KATANA_LOG_VASSERT(
+      projected.NumNodes() == expected.NumNodes(),
+      "\n Projected Nodes: {} Num Nodes: {}", projected.NumNodes(),
+      expected.NumNodes());
+  KATANA_LOG_VASSERT(
+      projected.NumEdges() == expected.NumEdges(),
+      "\n Projected Edges: {} Num Edges: {}", projected.NumEdges(),
+      expected.NumEdges());
+
+  for (auto n : expected.Nodes()) {
+    KATANA_LOG_ASSERT(
+        projected.GetNodePropertyIndex(n) == expected.GetNodePropertyIndex(n));
+    KATANA_LOG_VASSERT(
+        projected.OutDegree(n) == expected.OutDegree(n), "\n Node: {}", n);
+    auto expected_edge = expected.OutEdges(n).begin();
+    for (auto e : projected.OutEdges(n)) {
+      KATANA_LOG_ASSERT(
+          projected.OutEdgeDst(e) == expected.OutEdgeDst(*expected_edge));
+      KATANA_LOG_ASSERT(
+          projected.GetEdgePropertyIndexFromOutEdge(e) ==
+          expected.GetEdgePropertyIndexFromOutEdge(*expected_edge));
+      ++expected_edge;
+    }
+    KATANA_LOG_ASSERT(expected_edge == expected.OutEdges(n).end());
+  }
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys sys;
@@ -77,6 +111,23 @@ main(int argc, char** argv) {
   }
   auto pg_view = std::move(pg_view_res.value());
 
+  auto projected_view =
+      full_graph.BuildView<katana::PropertyGraphViews::Projected>(
+          node_types, edge_types);
+  CheckProjectedTopology(projected_view, *pg_view);
+
+  // Whether or not the kept edges are compacted, the projection is the same
+  katana::PGViewCache view_cache{
+      katana::GraphTopology::Copy(full_graph.topology())};
+  for (double compact_below : {0.0, 2.0}) {
+    auto projected_topo = view_cache.BuildProjectedTopo(
+        &full_graph, node_types, edge_types, compact_below);
+    KATANA_LOG_ASSERT(
+        projected_topo->is_compacted() ==
+        (compact_below > 1 && projected_topo->NumEdges() > 0));
+    CheckProjectedTopology(*projected_topo, *pg_view);
+  }
+
   katana::analytics::TemporaryPropertyGuard temp_node_property{
       full_graph.NodeMutablePropertyView()};
 
@@ -2,8 +2,12 @@
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/SemiExternalDoAll.h"
+#include "katana/SharedGraph.h"
 #include "katana/SharedMemSys.h"
 #include "katana/URI.h"
 
@@ -292,6 +296,9 @@ TestRoundTrip() {
       g->RemoveEdgeProperty("edge-throw-away", &txn_ctx);
   KATANA_LOG_ASSERT(remove_edge_throw_away_res);
 
+  // a budget smaller than any file makes each write wait for the one before
+  g->set_max_outstanding_write_size(1);
+
   auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
 
   KATANA_LOG_WARN("creating temp file {}", rdg_dir);
@@ -349,6 +356,296 @@ TestRoundTrip() {
   }
 }
 
+void
+TestMappedLoad() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  auto add_node_result = g->AddNodeProperties(
+      MakeProps<int32_t>("node-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_node_result);
+  auto add_edge_result = g->AddEdgeProperties(
+      MakeProps<double>("edge-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_edge_result);
+  // properties can be read from their raw columns and mapped too
+  g->set_raw_column_format(katana::RawColumnFormat::kUncompressed);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.mmap_local_files = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  // the mapping outlives the files
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+  KATANA_LOG_ASSERT(g2->GetNodeProperty(0)->Equals(*g->GetNodeProperty(0)));
+  KATANA_LOG_ASSERT(g2->GetEdgeProperty(0)->Equals(*g->GetEdgeProperty(0)));
+}
+
+void
+TestSharedGraph() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+  auto add_node_result = g->AddNodeProperties(
+      MakeProps<int32_t>("node-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_node_result);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/sharedgraphs");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string shared_dir(uri_res.value().path());
+  katana::SetEnv("KATANA_SHARED_GRAPH_DIR", shared_dir, true);
+
+  auto publish_result =
+      katana::PublishSharedGraph(g.get(), "test", command_line, &txn_ctx);
+  if (!publish_result) {
+    fs::remove_all(shared_dir);
+    KATANA_LOG_FATAL("publishing: {}", publish_result.error());
+  }
+  auto again_result =
+      katana::PublishSharedGraph(g.get(), "test", command_line, &txn_ctx);
+  KATANA_LOG_ASSERT(!again_result);
+  KATANA_LOG_ASSERT(again_result.error() == katana::ErrorCode::AlreadyExists);
+
+  auto attach_result = katana::AttachSharedGraph("test", &txn_ctx);
+  KATANA_LOG_ASSERT(katana::UnpublishSharedGraph("test"));
+  fs::remove_all(shared_dir);
+  katana::UnsetEnv("KATANA_SHARED_GRAPH_DIR");
+  if (!attach_result) {
+    KATANA_LOG_FATAL("attaching: {}", attach_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(attach_result.value());
+
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+  KATANA_LOG_ASSERT(g2->GetNodeProperty(0)->Equals(*g->GetNodeProperty(0)));
+}
+
+void
+TestDeferredTopologyLoad() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  auto add_node_result = g->AddNodeProperties(
+      MakeProps<int32_t>("node-name", test_length), &txn_ctx);
+  KATANA_LOG_ASSERT(add_node_result);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.defer_topology = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // sizes and properties are available without the topology
+  KATANA_LOG_ASSERT(!g2->IsTopologyLoaded());
+  KATANA_LOG_ASSERT(g2->NumNodes() == g->NumNodes());
+  KATANA_LOG_ASSERT(g2->NumEdges() == g->NumEdges());
+  KATANA_LOG_ASSERT(g2->GetNodeProperty(0)->Equals(*g->GetNodeProperty(0)));
+  KATANA_LOG_ASSERT(!g2->IsTopologyLoaded());
+
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+  KATANA_LOG_ASSERT(g2->IsTopologyLoaded());
+  KATANA_LOG_ASSERT(g2->EnsureTopologyLoaded());
+  fs::remove_all(rdg_dir);
+}
+
+void
+TestCommitAsync() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // the graph can change while the previous commit is still writing
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int32_t>("first", test_length), &txn_ctx));
+  auto first = g->CommitAsync(command_line, &txn_ctx);
+  KATANA_LOG_VASSERT(first, "starting first commit: {}", first.error());
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<int64_t>("second", test_length), &txn_ctx));
+  auto second = g->CommitAsync(command_line, &txn_ctx);
+  KATANA_LOG_VASSERT(second, "starting second commit: {}", second.error());
+
+  auto commit_result = txn_ctx.Commit();
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing: {}", commit_result.error());
+  }
+  KATANA_LOG_ASSERT(first.value().get());
+  KATANA_LOG_ASSERT(second.value().get());
+
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+  for (const std::string& name : {"first", "second"}) {
+    auto expected = g->GetNodeProperty(name);
+    auto stored = g2->GetNodeProperty(name);
+    KATANA_LOG_VASSERT(stored, "missing property {}", name);
+    KATANA_LOG_ASSERT(stored.value()->Equals(*expected.value()));
+  }
+}
+
+/// Dictionary encoded properties are stored and loaded as such
+void
+TestDictionaryProperty() {
+  constexpr size_t test_length = 10;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  arrow::StringDictionary32Builder builder;
+  for (size_t i = 0; i < test_length; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i % 3 == 0 ? "phone" : "laptop").ok());
+  }
+  std::shared_ptr<arrow::Array> devices;
+  KATANA_LOG_ASSERT(builder.Finish(&devices).ok());
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field("device", devices->type())}), {devices}),
+      &txn_ctx));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  auto stored = g2->GetNodeProperty("device");
+  KATANA_LOG_ASSERT(stored);
+  KATANA_LOG_VASSERT(
+      stored.value()->type()->id() == arrow::Type::DICTIONARY,
+      "expected a dictionary found {}", stored.value()->type()->ToString());
+  KATANA_LOG_ASSERT(stored.value()->num_chunks() == 1);
+
+  auto view = katana::DictionaryPropertyReadOnlyView<int32_t>::Make(
+      static_cast<const arrow::DictionaryArray&>(*stored.value()->chunk(0)));
+  KATANA_LOG_VASSERT(view, "making view: {}", view.error());
+  for (size_t i = 0; i < test_length; ++i) {
+    KATANA_LOG_ASSERT(
+        view.value().Decode(view.value()[i]) ==
+        (i % 3 == 0 ? "phone" : "laptop"));
+  }
+}
+
+void
+TestSemiExternalTopology() {
+  constexpr size_t test_length = 100;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line, &txn_ctx);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.semi_external_topology = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  const katana::GraphTopology& topo = g2->topology();
+  KATANA_LOG_ASSERT(topo.IsSemiExternal());
+  KATANA_LOG_ASSERT(!g->topology().IsSemiExternal());
+  KATANA_LOG_ASSERT(topo.Equals(g->topology()));
+
+  // segments cover every node once
+  constexpr uint64_t kSegmentEdges = 7;
+  auto bounds = katana::SemiExternalSegments(topo, kSegmentEdges);
+  KATANA_LOG_ASSERT(bounds.front() == 0);
+  KATANA_LOG_ASSERT(bounds.back() == topo.NumNodes());
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    KATANA_LOG_ASSERT(bounds[i] < bounds[i + 1]);
+  }
+
+  std::vector<int> visits(topo.NumNodes());
+  katana::GAccumulator<uint64_t> num_edges;
+  katana::SemiExternalDoAll(
+      topo, kSegmentEdges,
+      [&](katana::GraphTopology::Node n) {
+        ++visits[n];
+        for (auto e : topo.OutEdges(n)) {
+          KATANA_LOG_ASSERT(topo.OutEdgeDst(e) < topo.NumNodes());
+          num_edges += 1;
+        }
+      },
+      katana::loopname("SemiExternal"));
+  KATANA_LOG_ASSERT(num_edges.reduce() == topo.NumEdges());
+  for (int count : visits) {
+    KATANA_LOG_ASSERT(count == 1);
+  }
+}
+
 void
 TestGarbageMetadata() {
   auto uri_res = katana::URI::MakeRand("/tmp/propertyfilegraph");
@@ -471,6 +768,12 @@ main(int argc, char** argv) {
   command_line = cmdout.str();
 
   TestRoundTrip();
+  TestMappedLoad();
+  TestSharedGraph();
+  TestDeferredTopologyLoad();
+  TestCommitAsync();
+  TestDictionaryProperty();
+  TestSemiExternalTopology();
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
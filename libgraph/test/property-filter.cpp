@@ -0,0 +1,202 @@
+#include "katana/PropertyFilter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace cp = arrow::compute;
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+
+constexpr size_t kWidth = 100;
+constexpr uint64_t kNumEdgeWeights = 7;
+
+struct Types {
+  katana::EntityTypeID red;
+  katana::EntityTypeID blue;
+  katana::EntityTypeID red_and_blue;
+};
+
+/// Make a grid whose nodes are red if even and blue if odd, except every
+/// fifth, which is both, with an int64 node property "id" holding the node
+/// and an edge property "weight" holding the edge modulo kNumEdgeWeights
+std::unique_ptr<katana::PropertyGraph>
+MakeTypedGrid(Types* types) {
+  auto grid = katana::MakeGrid(kWidth, kWidth, false);
+  katana::GraphTopology topo = katana::GraphTopology::Copy(grid->topology());
+
+  katana::EntityTypeManager node_types;
+  types->red = node_types.AddAtomicEntityType("red").value();
+  types->blue = node_types.AddAtomicEntityType("blue").value();
+  auto both = node_types.GetOrAddNonAtomicEntityTypeFromStrings(
+      std::vector<std::string>{"red", "blue"});
+  KATANA_LOG_VASSERT(both, "adding red and blue: {}", both.error());
+  types->red_and_blue = both.value();
+
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(topo.NumNodes());
+  for (Node n = 0; n < topo.NumNodes(); ++n) {
+    node_type_ids[n] = n % 5 == 0   ? types->red_and_blue
+                       : n % 2 == 0 ? types->red
+                                    : types->blue;
+  }
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateInterleaved(topo.NumEdges());
+  std::fill(
+      edge_type_ids.begin(), edge_type_ids.end(), katana::kUnknownEntityType);
+
+  auto make_res = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_type_ids), std::move(edge_type_ids),
+      std::move(node_types), katana::EntityTypeManager{});
+  KATANA_LOG_VASSERT(make_res, "making graph: {}", make_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(make_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("id", [](Node n) {
+        return static_cast<int64_t>(n);
+      }));
+  KATANA_LOG_VASSERT(res, "adding node properties: {}", res.error());
+  res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("weight", [](uint64_t e) {
+        return static_cast<int64_t>(e % kNumEdgeWeights);
+      }));
+  KATANA_LOG_VASSERT(res, "adding edge properties: {}", res.error());
+  return pg;
+}
+
+/// Filter the nodes of pg with expression, and check that exactly those
+/// for which expected is true are selected
+void
+CheckNodes(
+    katana::PropertyGraph* pg, const cp::Expression& expression,
+    const std::function<bool(Node)>& expected,
+    int64_t block_rows = katana::kDefaultFilterBlockRows) {
+  auto res = katana::FilterNodes(pg, expression, block_rows);
+  KATANA_LOG_VASSERT(
+      res, "filtering {}: {}", expression.ToString(), res.error());
+  const katana::DynamicBitset& selected = res.value();
+  KATANA_LOG_ASSERT(selected.size() == pg->NumNodes());
+
+  std::vector<uint32_t> nodes = selected.GetOffsets<uint32_t>();
+  std::vector<uint32_t> expected_nodes;
+  for (Node n = 0; n < pg->NumNodes(); ++n) {
+    if (expected(n)) {
+      expected_nodes.emplace_back(n);
+    }
+  }
+  KATANA_LOG_VASSERT(
+      nodes == expected_nodes, "{} selected {} nodes, expected {}",
+      expression.ToString(), nodes.size(), expected_nodes.size());
+}
+
+void
+TestComparisons(katana::PropertyGraph* pg) {
+  CheckNodes(
+      pg, cp::greater_equal(cp::field_ref("id"), cp::literal(int64_t{9000})),
+      [](Node n) { return n >= 9000; });
+  CheckNodes(
+      pg,
+      cp::or_(
+          cp::less(cp::field_ref("id"), cp::literal(int64_t{10})),
+          cp::equal(cp::field_ref("id"), cp::literal(int64_t{5000}))),
+      [](Node n) { return n < 10 || n == 5000; });
+  CheckNodes(pg, cp::literal(true), [](Node) { return true; });
+  CheckNodes(pg, cp::literal(false), [](Node) { return false; });
+  // null compares as not selected
+  CheckNodes(
+      pg,
+      cp::equal(
+          cp::field_ref("id"),
+          cp::literal(arrow::MakeNullScalar(arrow::int64()))),
+      [](Node) { return false; });
+}
+
+void
+TestTypes(katana::PropertyGraph* pg, const Types& types) {
+  auto red = katana::NodeHasType(*pg, types.red);
+  KATANA_LOG_VASSERT(red, "red: {}", red.error());
+  auto both = katana::NodeHasType(*pg, types.red_and_blue);
+  KATANA_LOG_VASSERT(both, "red and blue: {}", both.error());
+
+  CheckNodes(pg, red.value(), [](Node n) { return n % 5 == 0 || n % 2 == 0; });
+  CheckNodes(pg, both.value(), [](Node n) { return n % 5 == 0; });
+  CheckNodes(
+      pg,
+      cp::and_(
+          cp::not_(red.value()),
+          cp::less(cp::field_ref("id"), cp::literal(int64_t{1000}))),
+      [](Node n) { return n % 5 != 0 && n % 2 == 1 && n < 1000; });
+
+  KATANA_LOG_ASSERT(!katana::NodeHasType(*pg, 1000));
+}
+
+void
+TestBlocks(katana::PropertyGraph* pg, const Types& types) {
+  // blocks that do not divide the nodes evenly give the same result
+  auto red = katana::NodeHasType(*pg, types.red);
+  KATANA_LOG_VASSERT(red, "red: {}", red.error());
+  for (int64_t block_rows : {64, 640, 4096}) {
+    CheckNodes(
+        pg,
+        cp::and_(
+            red.value(),
+            cp::greater(cp::field_ref("id"), cp::literal(int64_t{100}))),
+        [](Node n) { return (n % 5 == 0 || n % 2 == 0) && n > 100; },
+        block_rows);
+  }
+  KATANA_LOG_ASSERT(!katana::FilterNodes(pg, cp::literal(true), 100));
+  KATANA_LOG_ASSERT(!katana::FilterNodes(pg, cp::literal(true), 0));
+}
+
+void
+TestEdges(katana::PropertyGraph* pg) {
+  auto res = katana::FilterEdges(
+      pg, cp::equal(cp::field_ref("weight"), cp::literal(int64_t{3})));
+  KATANA_LOG_VASSERT(res, "filtering edges: {}", res.error());
+  const katana::DynamicBitset& selected = res.value();
+  KATANA_LOG_ASSERT(selected.size() == pg->NumEdges());
+  for (uint64_t e = 0; e < pg->NumEdges(); ++e) {
+    uint64_t weight = pg->GetEdgePropertyIndexFromOutEdge(e) % kNumEdgeWeights;
+    bool expected = weight == 3;
+    KATANA_LOG_VASSERT(
+        selected.test(e) == expected, "edge {} selected {}", e,
+        selected.test(e));
+  }
+}
+
+void
+TestErrors(katana::PropertyGraph* pg) {
+  // not a property
+  KATANA_LOG_ASSERT(!katana::FilterNodes(
+      pg, cp::equal(cp::field_ref("missing"), cp::literal(int64_t{1}))));
+  // an edge property is not a node property
+  KATANA_LOG_ASSERT(!katana::FilterNodes(
+      pg, cp::equal(cp::field_ref("weight"), cp::literal(int64_t{1}))));
+  // not boolean
+  KATANA_LOG_ASSERT(!katana::FilterNodes(pg, cp::field_ref("id")));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  Types types;
+  std::unique_ptr<katana::PropertyGraph> pg = MakeTypedGrid(&types);
+  TestComparisons(pg.get());
+  TestTypes(pg.get(), types);
+  TestBlocks(pg.get(), types);
+  TestEdges(pg.get());
+  TestErrors(pg.get());
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/BuildGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+Edges
+Build(katana::PropertyGraphBuilder* pgb) {
+  auto components = pgb->Finish(false);
+  KATANA_LOG_VASSERT(components, "{}", components.error());
+  katana::TxnContext txn_ctx;
+  auto pg =
+      katana::ConvertToPropertyGraph(std::move(components.value()), &txn_ctx);
+  KATANA_LOG_VASSERT(pg, "{}", pg.error());
+
+  const auto& topo = pg.value()->topology();
+  Edges edges;
+  for (auto n : topo.Nodes()) {
+    for (auto e : topo.OutEdges(n)) {
+      edges.emplace_back(n, topo.OutEdgeDst(e));
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+void
+AddNodes(
+    katana::PropertyGraphBuilder* pgb, const std::vector<std::string>& ids) {
+  for (const std::string& id : ids) {
+    KATANA_LOG_ASSERT(pgb->StartNode(id));
+    pgb->FinishNode();
+  }
+}
+
+void
+AddEdges(
+    katana::PropertyGraphBuilder* pgb,
+    const std::vector<std::pair<std::string, std::string>>& edges) {
+  for (const auto& [src, dst] : edges) {
+    KATANA_LOG_ASSERT(pgb->AddEdge(src, dst));
+  }
+}
+
+void
+Check(const Edges& found, Edges expected) {
+  std::sort(expected.begin(), expected.end());
+  KATANA_LOG_VASSERT(
+      found == expected, "found {} edges, expected {}", found.size(),
+      expected.size());
+}
+
+/// Integer IDs 0, 1, ... are parsed rather than hashed
+void
+TestDenseIDs() {
+  katana::PropertyGraphBuilder pgb(100);
+  AddNodes(&pgb, {"0", "1", "2", "3"});
+  AddEdges(&pgb, {{"0", "1"}, {"1", "2"}, {"3", "0"}, {"2", "3"}});
+  Check(Build(&pgb), {{0, 1}, {1, 2}, {3, 0}, {2, 3}});
+}
+
+/// IDs that are not the index of their node, like "01", are strings
+void
+TestStringIDs() {
+  katana::PropertyGraphBuilder pgb(100);
+  AddNodes(&pgb, {"0", "1", "a", "01", "7"});
+  AddEdges(
+      &pgb, {{"a", "01"}, {"01", "7"}, {"7", "0"}, {"0", "1"}, {"1", "a"}});
+  Check(Build(&pgb), {{2, 3}, {3, 4}, {4, 0}, {0, 1}, {1, 2}});
+}
+
+/// Edges may come before their nodes, and unknown IDs become new nodes in
+/// the order of the edges that name them
+void
+TestEdgesFirst() {
+  katana::PropertyGraphBuilder pgb(100);
+  AddNodes(&pgb, {"0"});
+  AddEdges(&pgb, {{"0", "1"}, {"x", "y"}, {"y", "0"}, {"1", "x"}});
+  AddNodes(&pgb, {"1"});
+  // "x" and "y" are made after every node, destinations first
+  Check(Build(&pgb), {{0, 1}, {3, 2}, {2, 0}, {1, 3}});
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestDenseIDs();
+  TestStringIDs();
+  TestEdgesFirst();
+  return 0;
+}
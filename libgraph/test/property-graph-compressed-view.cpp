@@ -0,0 +1,72 @@
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+using namespace katana;
+using Edge = PropertyGraph::Edge;
+using Node = PropertyGraph::Node;
+using CompressedGraphView = PropertyGraphViews::Compressed;
+using SortedGraphView = PropertyGraphViews::EdgesSortedByDestID;
+
+Result<void>
+TestCompressedView() {
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 20;
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(
+      CreateUniformRandomTopology(kNumNodes, kEdgesPerNode)));
+
+  CompressedGraphView compressed = pg->BuildView<CompressedGraphView>();
+  SortedGraphView sorted = pg->BuildView<SortedGraphView>();
+
+  KATANA_LOG_ASSERT(compressed.NumNodes() == sorted.NumNodes());
+  KATANA_LOG_ASSERT(compressed.NumEdges() == sorted.NumEdges());
+
+  std::vector<Node> dsts(kEdgesPerNode);
+  for (Node n : compressed.Nodes()) {
+    KATANA_LOG_ASSERT(compressed.OutDegree(n) == sorted.OutDegree(n));
+
+    for (Edge e : compressed.OutEdges(n)) {
+      KATANA_LOG_VASSERT(
+          compressed.OutEdgeDst(e) == sorted.OutEdgeDst(e),
+          "Edge destinations do not match");
+      KATANA_LOG_VASSERT(
+          compressed.GetEdgePropertyIndexFromOutEdge(e) ==
+              sorted.GetEdgePropertyIndexFromOutEdge(e),
+          "Edge property indexes do not match");
+      KATANA_LOG_ASSERT(compressed.GetEdgeSrc(e) == n);
+    }
+
+    compressed.ForEachOutEdgeDst(n, [&](Edge e, Node dst) {
+      KATANA_LOG_ASSERT(dst == sorted.OutEdgeDst(e));
+    });
+
+    compressed.DecodeOutEdgeDsts(n, dsts.data());
+    size_t i = 0;
+    for (Edge e : sorted.OutEdges(n)) {
+      KATANA_LOG_ASSERT(dsts[i++] == sorted.OutEdgeDst(e));
+    }
+  }
+
+  KATANA_LOG_VASSERT(
+      compressed.CompressedSizeBytes() < sorted.NumEdges() * sizeof(Node),
+      "compressed size {} is not smaller than uncompressed size {}",
+      compressed.CompressedSizeBytes(), sorted.NumEdges() * sizeof(Node));
+  KATANA_LOG_VASSERT(
+      compressed.EdgePropertyIndexSizeBytes() <=
+          sorted.NumEdges() * sizeof(uint32_t),
+      "edge property indexes take {} bytes, expected at most {}",
+      compressed.EdgePropertyIndexSizeBytes(),
+      sorted.NumEdges() * sizeof(uint32_t));
+
+  return katana::ResultSuccess();
+}
+
+int
+main() {
+  SharedMemSys sys;
+
+  auto res = TestCompressedView();
+  KATANA_LOG_ASSERT(res);
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyStatistics.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+using katana::PropertyPredicate;
+
+// more nodes than the rows of one row group, so properties are written in two
+constexpr size_t kWidth = 1024;
+constexpr size_t kHeight = 1100;
+constexpr Node kNumNodes = kWidth * kHeight;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeStoredGraph(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> pg =
+      katana::MakeGrid(kWidth, kHeight, false);
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "id", [](Node id) { return static_cast<int64_t>(id); }),
+      katana::PropertyGenerator(
+          "half", [](Node id) { return static_cast<double>(id) / 2; }),
+      katana::PropertyGenerator("parity", [](Node id) {
+        return std::string(id % 2 == 1 ? "odd" : "even");
+      }));
+  KATANA_LOG_VASSERT(res, "could not add properties: {}", res.error());
+  auto write_res = pg->Write(rdg_dir, "filter-nodes", &txn_ctx);
+  KATANA_LOG_VASSERT(write_res, "writing: {}", write_res.error());
+
+  katana::RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>{};
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  KATANA_LOG_VASSERT(make_res, "making: {}", make_res.error());
+  return std::move(make_res.value());
+}
+
+std::vector<Node>
+Filter(katana::PropertyGraph* pg, const PropertyPredicate& predicate) {
+  auto res = pg->FilterNodes(predicate);
+  KATANA_LOG_VASSERT(res, "filtering: {}", res.error());
+  return std::move(res.value());
+}
+
+void
+CheckRange(const std::vector<Node>& nodes, Node begin, Node end) {
+  KATANA_LOG_VASSERT(
+      nodes.size() == end - begin, "{} nodes, expected {}", nodes.size(),
+      end - begin);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    KATANA_LOG_ASSERT(nodes[i] == begin + i);
+  }
+}
+
+void
+TestFilterNodes(katana::PropertyGraph* pg) {
+  // the first row group
+  CheckRange(Filter(pg, PropertyPredicate::Between("id", 10, 19)), 10, 20);
+  // the second row group
+  CheckRange(
+      Filter(pg, PropertyPredicate::AtLeast("id", kNumNodes - 100)),
+      kNumNodes - 100, kNumNodes);
+  // both
+  CheckRange(
+      Filter(pg, PropertyPredicate::Between("half", 450000, 550000)), 900000,
+      1100001);
+  // neither
+  KATANA_LOG_ASSERT(Filter(pg, PropertyPredicate::AtMost("id", -1)).empty());
+  CheckRange(Filter(pg, PropertyPredicate::Equal("id", 7)), 7, 8);
+  CheckRange(Filter(pg, PropertyPredicate{"id"}), 0, kNumNodes);
+
+  // none of it is loaded
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("id"));
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("half"));
+
+  KATANA_LOG_ASSERT(!pg->FilterNodes(PropertyPredicate::Equal("parity", 1)));
+  KATANA_LOG_ASSERT(!pg->FilterNodes(PropertyPredicate::Equal("missing", 1)));
+}
+
+void
+TestLoadNodeProperty(katana::PropertyGraph* pg) {
+  auto res = pg->LoadNodeProperty(
+      "half", PropertyPredicate::Between("id", kNumNodes - 10, kNumNodes));
+  KATANA_LOG_VASSERT(res, "loading: {}", res.error());
+  std::shared_ptr<arrow::Table> table = res.value();
+  KATANA_LOG_ASSERT(table->num_rows() == 10);
+  KATANA_LOG_ASSERT(table->num_columns() == 2);
+  KATANA_LOG_ASSERT(table->field(1)->name() == "half");
+  auto nodes =
+      std::static_pointer_cast<arrow::UInt32Array>(table->column(0)->chunk(0));
+  auto halves =
+      std::static_pointer_cast<arrow::DoubleArray>(table->column(1)->chunk(0));
+  for (int64_t i = 0; i < table->num_rows(); ++i) {
+    KATANA_LOG_ASSERT(nodes->Value(i) == kNumNodes - 10 + i);
+    KATANA_LOG_ASSERT(halves->Value(i) == nodes->Value(i) / 2.0);
+  }
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("half"));
+
+  // properties of any type can be loaded
+  res = pg->LoadNodeProperty("parity", PropertyPredicate::Between("id", 4, 5));
+  KATANA_LOG_VASSERT(res, "loading: {}", res.error());
+  std::shared_ptr<arrow::ChunkedArray> parity = res.value()->column(1);
+  KATANA_LOG_ASSERT(parity->length() == 2);
+  KATANA_LOG_ASSERT(parity->GetScalar(0).ValueOrDie()->ToString() == "even");
+  KATANA_LOG_ASSERT(parity->GetScalar(1).ValueOrDie()->ToString() == "odd");
+
+  res = pg->LoadNodeProperty("id", PropertyPredicate::AtMost("id", -1));
+  KATANA_LOG_VASSERT(res, "loading: {}", res.error());
+  KATANA_LOG_ASSERT(res.value()->num_rows() == 0);
+}
+
+void
+TestLoaded(katana::PropertyGraph* pg) {
+  auto load_res = pg->EnsureNodePropertyLoaded("id");
+  KATANA_LOG_VASSERT(load_res, "{}", load_res.error());
+  CheckRange(
+      Filter(pg, PropertyPredicate::Between("id", 999990, 1000009)), 999990,
+      1000010);
+
+  // modified properties have no statistics
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg, &txn_ctx,
+      katana::PropertyGenerator(
+          "new", [](Node id) { return static_cast<int32_t>(id % 100); }));
+  KATANA_LOG_VASSERT(res, "could not add properties: {}", res.error());
+  KATANA_LOG_ASSERT(
+      Filter(pg, PropertyPredicate::Equal("new", 99)).size() ==
+      kNumNodes / 100);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertygraphfilternodes");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  std::unique_ptr<katana::PropertyGraph> pg = MakeStoredGraph(rdg_dir);
+  TestFilterNodes(pg.get());
+  TestLoadNodeProperty(pg.get());
+  TestLoaded(pg.get());
+
+  fs::remove_all(rdg_dir);
+  return 0;
+}
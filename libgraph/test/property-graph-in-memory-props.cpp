@@ -1,4 +1,9 @@
+#include <arrow/api.h>
+
 #include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "katana/SharedMemSys.h"
 #include "katana/TopologyGeneration.h"
@@ -99,12 +104,208 @@ TestEdgeProps(std::unique_ptr<katana::PropertyGraph>&& pg) {
   }
 }
 
+void
+TestPatchProps(std::unique_ptr<katana::PropertyGraph>&& pg) {
+  katana::TxnContext txn_ctx;
+  katana::Result<void> result = AddNodeProperties(
+      pg.get(), &txn_ctx, PropertyGenerator("age", [](Node id) {
+        return static_cast<int32_t>(id * 2);
+      }));
+  KATANA_LOG_VASSERT(result, "AddNodeProperties returned an error.");
+
+  auto make_rows = [](const std::vector<uint64_t>& rows) {
+    arrow::UInt64Builder builder;
+    KATANA_LOG_ASSERT(builder.AppendValues(rows).ok());
+    return builder.Finish().ValueOrDie();
+  };
+  auto make_ages = [](const std::vector<std::optional<int32_t>>& ages) {
+    arrow::Int32Builder builder;
+    for (const auto& age : ages) {
+      KATANA_LOG_ASSERT(
+          (age ? builder.Append(age.value()) : builder.AppendNull()).ok());
+    }
+    return builder.Finish().ValueOrDie();
+  };
+  auto get_ages = [&pg]() {
+    return std::static_pointer_cast<arrow::Int32Array>(
+        pg->GetNodeProperty("age").value()->chunk(0));
+  };
+
+  // the column is shared with snapshot, so it is copied before the patch
+  auto snapshot = get_ages();
+  result = pg->PatchNodeProperty(
+      "age", make_rows({1, 5, 1}), make_ages({100, std::nullopt, 101}),
+      &txn_ctx);
+  KATANA_LOG_VASSERT(result, "PatchNodeProperty returned an error.");
+
+  auto ages = get_ages();
+  for (Node n : pg->Nodes()) {
+    KATANA_LOG_ASSERT(snapshot->Value(n) == static_cast<int32_t>(n) * 2);
+    KATANA_LOG_ASSERT(snapshot->IsValid(n));
+    if (n == 1) {
+      KATANA_LOG_ASSERT(ages->Value(n) == 101);
+    } else if (n == 5) {
+      KATANA_LOG_ASSERT(ages->IsNull(n));
+    } else {
+      KATANA_LOG_ASSERT(ages->Value(n) == static_cast<int32_t>(n) * 2);
+    }
+  }
+  KATANA_LOG_ASSERT(ages->null_count() == 1);
+
+  // once nothing else shares it, the column is patched in place
+  const int32_t* values = ages->raw_values();
+  snapshot.reset();
+  ages.reset();
+  result = pg->PatchNodeProperty(
+      "age", make_rows({5}), make_ages({7}), &txn_ctx);
+  KATANA_LOG_VASSERT(result, "PatchNodeProperty returned an error.");
+  ages = get_ages();
+  KATANA_LOG_ASSERT(ages->raw_values() == values);
+  KATANA_LOG_ASSERT(ages->Value(5) == 7);
+  KATANA_LOG_ASSERT(ages->null_count() == 0);
+
+  KATANA_LOG_ASSERT(!pg->PatchNodeProperty(
+      "age", make_rows({pg->NumNodes()}), make_ages({1}), &txn_ctx));
+  KATANA_LOG_ASSERT(!pg->PatchNodeProperty(
+      "age", make_rows({0}), make_rows({1}), &txn_ctx));
+  KATANA_LOG_ASSERT(!pg->PatchNodeProperty(
+      "height", make_rows({0}), make_ages({1}), &txn_ctx));
+}
+
+/// Transactions keep the version of a property they read, the later of two
+/// conflicting transactions fails, and the writes of a failed transaction
+/// are undone
+void
+TestTransactions(std::unique_ptr<katana::PropertyGraph>&& pg) {
+  for (const char* name : {"score", "level"}) {
+    katana::TxnContext txn_ctx;
+    katana::Result<void> result = AddNodeProperties(
+        pg.get(), &txn_ctx, PropertyGenerator(name, [](Node id) {
+          return static_cast<int32_t>(id);
+        }));
+    KATANA_LOG_VASSERT(result, "AddNodeProperties returned an error.");
+  }
+
+  auto set = [&pg](
+                 katana::TxnContext* txn_ctx, const std::string& name,
+                 int32_t value) {
+    arrow::UInt64Builder rows;
+    arrow::Int32Builder values;
+    KATANA_LOG_ASSERT(rows.Append(0).ok() && values.Append(value).ok());
+    return pg->PatchNodeProperty(
+        name, rows.Finish().ValueOrDie(), values.Finish().ValueOrDie(),
+        txn_ctx);
+  };
+  auto set_score = [&set](katana::TxnContext* txn_ctx, int32_t score) {
+    return set(txn_ctx, "score", score);
+  };
+  auto first_value = [](const std::shared_ptr<arrow::ChunkedArray>& column) {
+    return std::static_pointer_cast<arrow::Int32Array>(column->chunk(0))
+        ->Value(0);
+  };
+  auto get_score = [&pg, &first_value](katana::TxnContext* txn_ctx) {
+    return first_value(pg->GetNodeProperty("score", txn_ctx).value());
+  };
+  // what the graph holds, whoever wrote it
+  auto current = [&pg, &first_value](const std::string& name) {
+    return first_value(pg->GetNodeProperty(name).value());
+  };
+  auto is_conflict = [](const katana::Result<void>& result) {
+    return !result && result.error() == katana::ErrorCode::TransactionConflict;
+  };
+
+  // the reader keeps its snapshot while the writer sees its own write
+  katana::TxnContext reader(false);
+  katana::TxnContext writer(false);
+  KATANA_LOG_ASSERT(get_score(&reader) == 0);
+  KATANA_LOG_ASSERT(set_score(&writer, 10));
+  KATANA_LOG_ASSERT(get_score(&reader) == 0);
+  KATANA_LOG_ASSERT(get_score(&writer) == 10);
+  KATANA_LOG_ASSERT(pg->GetNodeProperty("score", &reader).value()->length() ==
+                    static_cast<int64_t>(pg->NumNodes()));
+  KATANA_LOG_ASSERT(writer.Commit());
+  KATANA_LOG_ASSERT(is_conflict(reader.Commit()));
+
+  // a retried reader sees the committed value
+  katana::TxnContext retry(false);
+  KATANA_LOG_ASSERT(get_score(&retry) == 10);
+  KATANA_LOG_ASSERT(retry.Commit());
+
+  // write-write conflicts: a property with an uncommitted write cannot be
+  // written by others, also not by transaction unaware writers
+  katana::TxnContext first(false);
+  katana::TxnContext second(false);
+  KATANA_LOG_ASSERT(set_score(&first, 20));
+  KATANA_LOG_ASSERT(is_conflict(set_score(&second, 30)));
+  {
+    katana::TxnContext auto_commit;
+    KATANA_LOG_ASSERT(is_conflict(set_score(&auto_commit, 25)));
+  }
+  KATANA_LOG_ASSERT(current("score") == 20);
+  KATANA_LOG_ASSERT(first.Commit());
+  KATANA_LOG_ASSERT(is_conflict(second.Commit()));
+  KATANA_LOG_ASSERT(current("score") == 20);
+
+  // the loser of a read-write conflict has its writes undone, and the
+  // winner's value survives
+  katana::TxnContext loser(false);
+  KATANA_LOG_ASSERT(get_score(&loser) == 20);
+  {
+    katana::TxnContext winner(false);
+    KATANA_LOG_ASSERT(set_score(&winner, 30));
+    KATANA_LOG_ASSERT(winner.Commit());
+  }
+  KATANA_LOG_ASSERT(set(&loser, "level", 99));
+  KATANA_LOG_ASSERT(AddNodeProperties(
+      pg.get(), &loser, PropertyGenerator("bonus", [](Node id) {
+        return static_cast<int32_t>(id);
+      })));
+  KATANA_LOG_ASSERT(current("level") == 99);
+  KATANA_LOG_ASSERT(is_conflict(loser.Commit()));
+  KATANA_LOG_ASSERT(current("score") == 30);
+  KATANA_LOG_ASSERT(current("level") == 0);
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("bonus"));
+
+  // the undone properties are free for others again
+  {
+    katana::TxnContext other(false);
+    KATANA_LOG_ASSERT(set(&other, "level", 1));
+    KATANA_LOG_ASSERT(other.Commit());
+  }
+
+  // so are the writes of a transaction that never commits
+  {
+    katana::TxnContext abandoned(false);
+    KATANA_LOG_ASSERT(set_score(&abandoned, 35));
+    KATANA_LOG_ASSERT(current("score") == 35);
+  }
+  KATANA_LOG_ASSERT(current("score") == 30);
+
+  katana::TxnContext stale(false);
+  KATANA_LOG_ASSERT(get_score(&stale) == 30);
+  {
+    katana::TxnContext auto_commit;
+    KATANA_LOG_ASSERT(set_score(&auto_commit, 40));
+  }
+  KATANA_LOG_ASSERT(is_conflict(stale.Commit()));
+
+  // committing starts a new transaction
+  katana::TxnContext txn_ctx(false);
+  KATANA_LOG_ASSERT(get_score(&txn_ctx) == 40);
+  KATANA_LOG_ASSERT(txn_ctx.Commit());
+  KATANA_LOG_ASSERT(set_score(&txn_ctx, 50));
+  KATANA_LOG_ASSERT(txn_ctx.Commit());
+  KATANA_LOG_ASSERT(current("score") == 50);
+}
+
 int
 main() {
   katana::SharedMemSys S;
 
   TestNodeProps(katana::MakeGrid(3, 4, true));
   TestEdgeProps(katana::MakeGrid(3, 4, true));
+  TestPatchProps(katana::MakeGrid(3, 4, true));
+  TestTransactions(katana::MakeGrid(3, 4, true));
 
   return 0;
 }
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+using namespace katana;
+using Node = PropertyGraph::Node;
+using BFSView = PropertyGraphViews::NodesSortedByBFSEdgesSortedByDestID;
+using RCMView = PropertyGraphViews::NodesSortedByRCMEdgesSortedByDestID;
+
+namespace {
+
+/// A path over scrambled node ids, both directions of every edge, plus a
+/// triangle and an isolated node
+constexpr std::array<Node, 8> kPath = {7, 2, 9, 0, 4, 8, 1, 5};
+constexpr std::array<Node, 3> kTriangle = {3, 6, 10};
+constexpr size_t kNumNodes = 12;
+
+std::unique_ptr<PropertyGraph>
+MakeGraph() {
+  AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  auto add_both = [&](Node a, Node b) {
+    builder.AddEdge(a, b);
+    builder.AddEdge(b, a);
+  };
+  for (size_t i = 0; i + 1 < kPath.size(); ++i) {
+    add_both(kPath[i], kPath[i + 1]);
+  }
+  add_both(kTriangle[0], kTriangle[1]);
+  add_both(kTriangle[1], kTriangle[2]);
+  add_both(kTriangle[2], kTriangle[0]);
+
+  auto res = PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  return std::move(res.value());
+}
+
+std::set<std::pair<Node, Node>>
+OriginalEdges(const PropertyGraph& pg) {
+  std::set<std::pair<Node, Node>> edges;
+  for (Node n : pg.topology().Nodes()) {
+    for (auto e : pg.topology().OutEdges(n)) {
+      edges.emplace(n, pg.topology().OutEdgeDst(e));
+    }
+  }
+  return edges;
+}
+
+/// The view is a relabeling of pg: every node appears once, every edge maps
+/// to an edge of pg and edges are sorted by destination
+template <typename View>
+void
+CheckRelabeling(const PropertyGraph& pg, const View& view) {
+  KATANA_LOG_ASSERT(view.NumNodes() == pg.NumNodes());
+  KATANA_LOG_ASSERT(view.NumEdges() == pg.NumEdges());
+
+  std::vector<int> seen(pg.NumNodes());
+  for (Node n : view.Nodes()) {
+    ++seen[view.GetNodePropertyIndex(n)];
+  }
+  for (int count : seen) {
+    KATANA_LOG_ASSERT(count == 1);
+  }
+
+  auto edges = OriginalEdges(pg);
+  for (Node n : view.Nodes()) {
+    Node prev = 0;
+    for (auto e : view.OutEdges(n)) {
+      Node dst = view.OutEdgeDst(e);
+      KATANA_LOG_ASSERT(dst >= prev);
+      prev = dst;
+      KATANA_LOG_ASSERT(edges.count(
+          {static_cast<Node>(view.GetNodePropertyIndex(n)),
+           static_cast<Node>(view.GetNodePropertyIndex(dst))}));
+    }
+  }
+}
+
+void
+TestBFSOrder() {
+  auto pg = MakeGraph();
+  auto view = pg->BuildView<BFSView>();
+  CheckRelabeling(*pg, view);
+
+  // the first search starts at node 0, in the middle of the path, so its
+  // neighbors 9 and 4 come next, by id
+  KATANA_LOG_ASSERT(view.GetNodePropertyIndex(0) == 0);
+  KATANA_LOG_ASSERT(view.GetNodePropertyIndex(1) == 4);
+  KATANA_LOG_ASSERT(view.GetNodePropertyIndex(2) == 9);
+
+  // cached like the other views
+  auto again = pg->BuildView<BFSView>();
+  KATANA_LOG_ASSERT(&again.topo() == &view.topo());
+}
+
+void
+TestRCMOrder() {
+  auto pg = MakeGraph();
+  auto view = pg->BuildView<RCMView>();
+  CheckRelabeling(*pg, view);
+
+  // the nonzeros of a path end up right next to the diagonal
+  for (Node n : view.Nodes()) {
+    for (auto e : view.OutEdges(n)) {
+      Node dst = view.OutEdgeDst(e);
+      bool in_triangle =
+          std::find(
+              kTriangle.begin(), kTriangle.end(),
+              view.GetNodePropertyIndex(n)) != kTriangle.end();
+      KATANA_LOG_VASSERT(
+          std::abs(static_cast<int>(n) - static_cast<int>(dst)) <=
+              (in_triangle ? 2 : 1),
+          "edge {} -> {}", n, dst);
+    }
+  }
+
+  // the isolated node is found first and so comes last
+  KATANA_LOG_ASSERT(view.GetNodePropertyIndex(kNumNodes - 1) == 11);
+}
+
+}  // namespace
+
+int
+main() {
+  SharedMemSys sys;
+
+  TestBFSOrder();
+  TestRCMOrder();
+
+  return 0;
+}
@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
@@ -6,6 +11,7 @@
 #include "katana/PropertyGraph.h"
 #include "katana/RDG.h"
 #include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
 #include "katana/analytics/Utils.h"
 #include "llvm/Support/CommandLine.h"
 #include "stdio.h"
@@ -58,7 +64,139 @@ TestOptionalTopologyGenerationEdgeTypeAwareTopology() {
   // Build a EdgeTypeAwareBiDir view, which uses GraphTopology EdgeTypeAwareTopology in the background
   using SortedGraphView = katana::PropertyGraphViews::EdgeTypeAwareBiDir;
 
-  pg.BuildView<SortedGraphView>();
+  auto view = pg.BuildView<SortedGraphView>();
+
+  // Whichever per-type index layout was picked, the typed ranges of a node
+  // must partition its out-edges by type
+  for (auto n : view.Nodes()) {
+    size_t num_typed_edges = 0;
+    for (const auto& edge_type : view.GetDistinctEdgeTypes()) {
+      for (auto e : view.OutEdges(n, edge_type)) {
+        KATANA_LOG_ASSERT(
+            pg.GetTypeOfEdgeFromPropertyIndex(
+                view.GetEdgePropertyIndexFromOutEdge(e)) == edge_type);
+        ++num_typed_edges;
+      }
+    }
+    KATANA_LOG_ASSERT(num_typed_edges == view.OutDegree(n));
+  }
+}
+
+/// Answer every query with HasEdge and HasEdges of view and its out topology
+template <typename View>
+void
+CheckHasEdge(
+    const View& view,
+    const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+    const std::vector<bool>& expected) {
+  KATANA_LOG_ASSERT(view.NumEdges() > 0);
+  auto found = view.HasEdges(queries);
+  for (size_t i = 0; i < queries.size(); ++i) {
+    const auto& [src, dst] = queries[i];
+    KATANA_LOG_VASSERT(
+        view.HasEdge(src, dst) == expected[i], "HasEdge({}, {})", src, dst);
+    KATANA_LOG_ASSERT(view.out().HasEdge(src, dst) == expected[i]);
+    KATANA_LOG_ASSERT(found.test(i) == expected[i]);
+  }
+}
+
+void
+TestEdgeTypeAwareHasEdge() {
+  KATANA_LOG_DEBUG("##### Testing EdgeTypeAware HasEdge ######");
+
+  katana::PropertyGraph pg = LoadGraph(ldbc_003InputFile);
+
+  // every edge, plus a likely non-edge per node, taken from the original
+  // topology so that the answers do not depend on the views under test
+  const auto& topo = pg.topology();
+  const uint32_t num_nodes = topo.NumNodes();
+  std::vector<std::pair<uint32_t, uint32_t>> queries;
+  std::vector<bool> expected;
+  size_t num_edges = 0;
+  for (auto n : topo.Nodes()) {
+    std::set<uint32_t> dests;
+    for (auto e : topo.OutEdges(n)) {
+      dests.insert(topo.OutEdgeDst(e));
+      ++num_edges;
+    }
+    for (auto dst : dests) {
+      queries.emplace_back(n, dst);
+      expected.emplace_back(true);
+    }
+    const uint32_t other = (n * 7919 + 1) % num_nodes;
+    queries.emplace_back(n, other);
+    expected.emplace_back(dests.count(other) > 0);
+  }
+  KATANA_LOG_ASSERT(num_edges > 0);
+
+  auto view = pg.BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>();
+  KATANA_LOG_ASSERT(!view.out().has_dest_index());
+  CheckHasEdge(view, queries, expected);
+
+  // The indexed view adds the index to the cached topologies of view, which
+  // must keep working
+  auto indexed_view =
+      pg.BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDirDestIndexed>();
+  KATANA_LOG_ASSERT(indexed_view.out().has_dest_index());
+  KATANA_LOG_ASSERT(indexed_view.in().has_dest_index());
+  KATANA_LOG_ASSERT(view.NumEdges() == num_edges);
+  CheckHasEdge(view, queries, expected);
+  CheckHasEdge(indexed_view, queries, expected);
+
+  // and views built afterwards share the indexed topologies
+  auto later_view =
+      pg.BuildView<katana::PropertyGraphViews::EdgeTypeAwareBiDir>();
+  KATANA_LOG_ASSERT(later_view.out().has_dest_index());
+  CheckHasEdge(later_view, queries, expected);
+}
+
+/// Check the searches of a view sorted by destination against its edges
+void
+CheckSortedFindEdge(katana::PropertyGraph* pg) {
+  auto view = pg->BuildView<katana::PropertyGraphViews::EdgesSortedByDestID>();
+  const uint32_t num_nodes = view.NumNodes();
+
+  for (auto n : view.Nodes()) {
+    auto edges = view.OutEdges(n);
+    std::set<uint32_t> dests;
+    for (auto e : edges) {
+      dests.insert(view.OutEdgeDst(e));
+    }
+    std::vector<uint32_t> queries;
+    for (uint32_t i = 0; i < 8; ++i) {
+      queries.emplace_back((n * 7919 + i * 104729) % num_nodes);
+    }
+    queries.insert(queries.end(), dests.begin(), dests.end());
+    std::sort(queries.begin(), queries.end());
+
+    auto found = view.FindEdges(n, queries);
+    auto hint = edges.begin();
+    for (size_t i = 0; i < queries.size(); ++i) {
+      const uint32_t dst = queries[i];
+      const bool expected = dests.count(dst) > 0;
+      auto e = view.FindEdge(n, dst);
+      KATANA_LOG_VASSERT(
+          (e != edges.end()) == expected, "FindEdge({}, {})", n, dst);
+      KATANA_LOG_ASSERT(found[i] == (expected ? e : edges.end()));
+      KATANA_LOG_ASSERT(!expected || view.OutEdgeDst(*e) == dst);
+
+      auto from_hint = view.FindEdge(n, dst, hint);
+      KATANA_LOG_ASSERT(from_hint == (expected ? e : edges.end()));
+      if (expected) {
+        hint = from_hint;
+      }
+    }
+  }
+}
+
+void
+TestSortedFindEdge() {
+  KATANA_LOG_DEBUG("##### Testing sorted FindEdge ######");
+
+  katana::PropertyGraph pg = LoadGraph(ldbc_003InputFile);
+  CheckSortedFindEdge(&pg);
+  // long enough adjacencies to gallop
+  CheckSortedFindEdge(katana::MakeClique(300).get());
 }
 
 int
@@ -69,5 +207,7 @@ main(int argc, char** argv) {
   TestOptionalTopologyGenerationEdgeShuffleTopology();
   TestOptionalTopologyGenerationShuffleTopology();
   TestOptionalTopologyGenerationEdgeTypeAwareTopology();
+  TestEdgeTypeAwareHasEdge();
+  TestSortedFindEdge();
   return 0;
 }
@@ -0,0 +1,120 @@
+#include <arrow/api.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+using Edge = katana::PropertyGraph::Edge;
+using Node = katana::PropertyGraph::Node;
+using katana::AddEdgeProperties;
+using katana::AddNodeProperties;
+using katana::PropertyGenerator;
+
+namespace {
+
+constexpr uint64_t kWidth = 30;
+
+/// A grid whose nodes know their ids and whose edges know their ends. The
+/// names are not fixed width, so they take the other path through
+/// CreatePermutedGraph.
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  auto pg = katana::MakeGrid(kWidth, kWidth, true);
+  katana::TxnContext txn_ctx;
+  auto node_res = AddNodeProperties(
+      pg.get(), &txn_ctx,
+      PropertyGenerator("id", [](Node n) { return static_cast<uint64_t>(n); }),
+      PropertyGenerator(
+          "name", [](Node n) { return fmt::format("Node {}", n); }));
+  KATANA_LOG_VASSERT(node_res, "{}", node_res.error());
+  auto edge_res = AddEdgeProperties(
+      pg.get(), &txn_ctx, PropertyGenerator("ends", [&pg](Edge e) {
+        uint64_t src = pg->topology().GetEdgeSrc(e);
+        uint64_t dst = pg->topology().OutEdgeDst(e);
+        return src * kWidth * kWidth + dst;
+      }));
+  KATANA_LOG_VASSERT(edge_res, "{}", edge_res.error());
+  return pg;
+}
+
+void
+CheckPermuted(
+    katana::PropertyGraph* pg,
+    const katana::GraphTopology::PropIndexVec& new_to_old) {
+  auto res = katana::CreatePermutedGraph(pg, new_to_old);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  auto permuted = std::move(res.value());
+
+  KATANA_LOG_ASSERT(permuted->NumNodes() == pg->NumNodes());
+  KATANA_LOG_ASSERT(permuted->NumEdges() == pg->NumEdges());
+
+  auto ids = permuted->GetNodePropertyTyped<uint64_t>("id");
+  KATANA_LOG_VASSERT(ids, "{}", ids.error());
+  auto names = permuted->GetNodePropertyTyped<std::string>("name");
+  KATANA_LOG_VASSERT(names, "{}", names.error());
+  auto ends = permuted->GetEdgePropertyTyped<uint64_t>("ends");
+  KATANA_LOG_VASSERT(ends, "{}", ends.error());
+
+  const auto& topo = permuted->topology();
+  for (Node n : topo.Nodes()) {
+    uint64_t old_n = new_to_old[n];
+    KATANA_LOG_VASSERT(
+        ids.value()->Value(n) == old_n, "node {} has id {}, want {}", n,
+        ids.value()->Value(n), old_n);
+    KATANA_LOG_ASSERT(
+        names.value()->GetString(n) == fmt::format("Node {}", old_n));
+    KATANA_LOG_ASSERT(topo.OutDegree(n) == pg->topology().OutDegree(old_n));
+
+    // edges keep their order, so they line up with those of the old node
+    auto old_e = *pg->topology().OutEdges(old_n).begin();
+    for (auto e : topo.OutEdges(n)) {
+      uint64_t old_dst = new_to_old[topo.OutEdgeDst(e)];
+      KATANA_LOG_ASSERT(old_dst == pg->topology().OutEdgeDst(old_e));
+      KATANA_LOG_ASSERT(
+          ends.value()->Value(e) == old_n * kWidth * kWidth + old_dst);
+      ++old_e;
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg = MakeGraph();
+  uint64_t num_nodes = pg->NumNodes();
+
+  katana::GraphTopology::PropIndexVec new_to_old;
+  new_to_old.allocateInterleaved(num_nodes);
+  std::iota(new_to_old.begin(), new_to_old.end(), 0);
+  CheckPermuted(pg.get(), new_to_old);
+
+  std::reverse(new_to_old.begin(), new_to_old.end());
+  CheckPermuted(pg.get(), new_to_old);
+
+  std::shuffle(new_to_old.begin(), new_to_old.end(), std::mt19937{0});
+  CheckPermuted(pg.get(), new_to_old);
+
+  // a repeated node is not a permutation
+  new_to_old[1] = new_to_old[0];
+  KATANA_LOG_ASSERT(!katana::CreatePermutedGraph(pg.get(), new_to_old));
+
+  new_to_old[1] = num_nodes;
+  KATANA_LOG_ASSERT(!katana::CreatePermutedGraph(pg.get(), new_to_old));
+
+  katana::GraphTopology::PropIndexVec too_short;
+  too_short.allocateInterleaved(num_nodes - 1);
+  std::iota(too_short.begin(), too_short.end(), 0);
+  KATANA_LOG_ASSERT(!katana::CreatePermutedGraph(pg.get(), too_short));
+
+  return 0;
+}
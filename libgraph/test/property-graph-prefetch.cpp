@@ -0,0 +1,201 @@
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+using Edge = katana::PropertyGraph::Edge;
+
+void
+WriteStoredGraph(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> pg = katana::MakeGrid(10, 10, false);
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "a", [](Node id) { return static_cast<int64_t>(id); }),
+      katana::PropertyGenerator(
+          "b", [](Node id) { return static_cast<int64_t>(id * 3); }),
+      katana::PropertyGenerator("c", [](Node id) { return id * 0.5; }));
+  KATANA_LOG_VASSERT(res, "could not add node properties: {}", res.error());
+  res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "w", [](Edge id) { return static_cast<int64_t>(id); }),
+      katana::PropertyGenerator(
+          "x", [](Edge id) { return static_cast<int32_t>(id * 2); }));
+  KATANA_LOG_VASSERT(res, "could not add edge properties: {}", res.error());
+  auto write_res = pg->Write(rdg_dir, "prefetch", &txn_ctx);
+  KATANA_LOG_VASSERT(write_res, "writing: {}", write_res.error());
+}
+
+std::unique_ptr<katana::PropertyGraph>
+Load(const std::string& rdg_dir, bool with_properties) {
+  katana::TxnContext txn_ctx;
+  katana::RDGLoadOptions opts;
+  if (!with_properties) {
+    opts.node_properties = std::vector<std::string>{};
+    opts.edge_properties = std::vector<std::string>{};
+  }
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  KATANA_LOG_VASSERT(make_res, "making: {}", make_res.error());
+  return std::move(make_res.value());
+}
+
+void
+CheckNodeColumn(
+    katana::PropertyGraph* pg, katana::PropertyGraph* eager,
+    const std::string& name) {
+  KATANA_LOG_VASSERT(pg->HasNodeProperty(name), "{} is not loaded", name);
+  auto column = pg->GetNodeProperty(name);
+  KATANA_LOG_VASSERT(column, "{}", column.error());
+  KATANA_LOG_VASSERT(
+      column.value()->Equals(*eager->GetNodeProperty(name).value()),
+      "node property {} differs from the eager load", name);
+}
+
+void
+CheckEdgeColumn(
+    katana::PropertyGraph* pg, katana::PropertyGraph* eager,
+    const std::string& name) {
+  KATANA_LOG_VASSERT(pg->HasEdgeProperty(name), "{} is not loaded", name);
+  auto column = pg->GetEdgeProperty(name);
+  KATANA_LOG_VASSERT(column, "{}", column.error());
+  KATANA_LOG_VASSERT(
+      column.value()->Equals(*eager->GetEdgeProperty(name).value()),
+      "edge property {} differs from the eager load", name);
+}
+
+/// Prefetched properties appear at FinishPrefetch; the rest still load on
+/// demand
+void
+TestPrefetchThenFinish(const std::string& rdg_dir) {
+  auto eager = Load(rdg_dir, true);
+  auto pg = Load(rdg_dir, false);
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 0);
+
+  auto res = pg->PrefetchProperties({"a", "c"}, {"w"});
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  // requesting them again while they are in flight does nothing
+  res = pg->PrefetchProperties({"c"}, {"w"});
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("a"));
+  KATANA_LOG_ASSERT(!pg->HasEdgeProperty("w"));
+
+  res = pg->FinishPrefetch();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 2);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 1);
+  CheckNodeColumn(pg.get(), eager.get(), "a");
+  CheckNodeColumn(pg.get(), eager.get(), "c");
+  CheckEdgeColumn(pg.get(), eager.get(), "w");
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("b"));
+  KATANA_LOG_ASSERT(!pg->HasEdgeProperty("x"));
+
+  // nothing is outstanding now
+  res = pg->FinishPrefetch();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  res = pg->EnsureNodePropertyLoaded("b");
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = pg->EnsureEdgePropertyLoaded("x");
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = pg->EnsureNodePropertyLoaded("a");
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 3);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 2);
+  CheckNodeColumn(pg.get(), eager.get(), "b");
+  CheckEdgeColumn(pg.get(), eager.get(), "x");
+}
+
+/// Ensure*PropertyLoaded picks up prefetched properties without an explicit
+/// FinishPrefetch
+void
+TestPrefetchThenEnsure(const std::string& rdg_dir) {
+  auto eager = Load(rdg_dir, true);
+  auto pg = Load(rdg_dir, false);
+
+  auto res = pg->PrefetchProperties({"b"}, {"x"});
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = pg->EnsureEdgePropertyLoaded("x");
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  CheckEdgeColumn(pg.get(), eager.get(), "x");
+  CheckNodeColumn(pg.get(), eager.get(), "b");
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 1);
+}
+
+/// A name that is not in storage fails the call and starts no reads
+void
+TestUnknownProperty(const std::string& rdg_dir) {
+  auto pg = Load(rdg_dir, false);
+
+  auto res = pg->PrefetchProperties({"b", "no-such-property"}, {});
+  KATANA_LOG_ASSERT(
+      !res && res.error() == katana::ErrorCode::PropertyNotFound);
+  res = pg->PrefetchProperties({}, {"no-such-property"});
+  KATANA_LOG_ASSERT(
+      !res && res.error() == katana::ErrorCode::PropertyNotFound);
+
+  res = pg->FinishPrefetch();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 0);
+
+  // the good name can still be prefetched
+  res = pg->PrefetchProperties({"b"}, {});
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  res = pg->FinishPrefetch();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(pg->HasNodeProperty("b"));
+}
+
+/// A bad edge name fails the call before the reads of the good node names
+/// are issued, so a retry loads each property once
+void
+TestRetryAfterBadEdgeName(const std::string& rdg_dir) {
+  auto eager = Load(rdg_dir, true);
+  auto pg = Load(rdg_dir, false);
+
+  auto res = pg->PrefetchProperties({"a"}, {"no-such-property"});
+  KATANA_LOG_ASSERT(
+      !res && res.error() == katana::ErrorCode::PropertyNotFound);
+  res = pg->PrefetchProperties({"a"}, {"w"});
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  res = pg->FinishPrefetch();
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(pg->GetNumEdgeProperties() == 1);
+  CheckNodeColumn(pg.get(), eager.get(), "a");
+  CheckEdgeColumn(pg.get(), eager.get(), "w");
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertygraphprefetch");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  WriteStoredGraph(rdg_dir);
+  TestPrefetchThenFinish(rdg_dir);
+  TestPrefetchThenEnsure(rdg_dir);
+  TestUnknownProperty(rdg_dir);
+  TestRetryAfterBadEdgeName(rdg_dir);
+
+  fs::remove_all(rdg_dir);
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <limits>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/MemoryPolicy.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyUnloadManager.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeStoredGraph(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> pg = katana::MakeGrid(10, 10, false);
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "hot", [](Node id) { return static_cast<int64_t>(id); }),
+      katana::PropertyGenerator(
+          "cold", [](Node id) { return static_cast<int64_t>(id * 2); }));
+  KATANA_LOG_VASSERT(res, "could not add properties: {}", res.error());
+  auto write_res = pg->Write(rdg_dir, "property-unloading", &txn_ctx);
+  KATANA_LOG_VASSERT(write_res, "writing: {}", write_res.error());
+
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, &txn_ctx);
+  KATANA_LOG_VASSERT(make_res, "making: {}", make_res.error());
+  return std::move(make_res.value());
+}
+
+void
+TestUnloadIdleProperties(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> pg = MakeStoredGraph(rdg_dir);
+  pg->EnablePropertyUnloading();
+
+  auto& pum = katana::PropertyUnloadManager::Get();
+  auto saved_idle_time = pum.idle_time();
+  pum.set_idle_time(std::chrono::hours(1));
+
+  // nothing has been idle long enough
+  pum.MoveIdleToStandby();
+  KATANA_LOG_ASSERT(pum.standby() == 0);
+
+  pum.set_idle_time(std::chrono::seconds(0));
+  pg->PinNodeProperty("hot");
+  pum.MoveIdleToStandby();
+  const katana::count_t standby = pum.standby();
+  KATANA_LOG_ASSERT(standby > 0);
+
+  // only the unpinned property goes
+  KATANA_LOG_ASSERT(pum.FreeStandbyMemory(standby) == standby);
+  KATANA_LOG_ASSERT(pum.standby() == 0);
+  KATANA_LOG_ASSERT(pg->HasNodeProperty("hot"));
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("cold"));
+
+  // and comes back on demand
+  auto load_res = pg->EnsureNodePropertyLoaded("cold");
+  KATANA_LOG_VASSERT(load_res, "{}", load_res.error());
+  auto cold = pg->GetNodePropertyTyped<int64_t>("cold");
+  KATANA_LOG_VASSERT(cold, "{}", cold.error());
+  KATANA_LOG_ASSERT(cold.value()->Value(7) == 14);
+
+  // properties held outside of the graph are not unloaded
+  pg->UnpinNodeProperty("hot");
+  {
+    std::shared_ptr<arrow::ChunkedArray> held =
+        pg->GetNodeProperty("cold").value();
+    pum.MoveIdleToStandby();
+    KATANA_LOG_ASSERT(pum.standby() > 0);
+    pum.FreeStandbyMemory(pum.standby());
+    KATANA_LOG_ASSERT(pg->HasNodeProperty("cold"));
+    KATANA_LOG_ASSERT(!pg->HasNodeProperty("hot"));
+  }
+
+  // the state of a graph goes with it
+  pum.MoveIdleToStandby();
+  KATANA_LOG_ASSERT(pum.standby() > 0);
+  pg.reset();
+  pum.MoveIdleToStandby();
+  KATANA_LOG_ASSERT(pum.standby() == 0);
+  pum.set_idle_time(saved_idle_time);
+}
+
+void
+TestRSSCap() {
+  katana::MemoryPolicyRSSCap unlimited(std::numeric_limits<int64_t>::max());
+  KATANA_LOG_ASSERT(unlimited.ReclaimForMemoryPressure(100) == 0);
+  KATANA_LOG_ASSERT(!unlimited.IsMemoryPressureHigh(100));
+
+  // any process is over a one byte cap, but only standby can be reclaimed
+  katana::MemoryPolicyRSSCap tiny(1);
+  KATANA_LOG_ASSERT(tiny.ReclaimForMemoryPressure(100) == 100);
+  KATANA_LOG_ASSERT(tiny.IsMemoryPressureHigh(100));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyunloading");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  TestUnloadIdleProperties(rdg_dir);
+  TestRSSCap();
+
+  fs::remove_all(rdg_dir);
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+using Edge = katana::PropertyGraph::Edge;
+using Node = katana::PropertyGraph::Node;
+using katana::AddEdgeProperties;
+using katana::AddNodeProperties;
+using katana::PropertyGenerator;
+
+namespace {
+
+constexpr uint64_t kWidth = 30;
+constexpr Node kRemoved = std::numeric_limits<Node>::max();
+
+/// A grid whose nodes know their ids and are red if even and blue if odd,
+/// and whose edges know their ends. The names are not fixed width, so they
+/// take the other path through the compaction of properties.
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  auto grid = katana::MakeGrid(kWidth, kWidth, true);
+  katana::GraphTopology topo = katana::GraphTopology::Copy(grid->topology());
+
+  katana::EntityTypeManager node_types;
+  katana::EntityTypeID red = node_types.AddAtomicEntityType("red").value();
+  katana::EntityTypeID blue = node_types.AddAtomicEntityType("blue").value();
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(topo.NumNodes());
+  for (Node n = 0; n < topo.NumNodes(); ++n) {
+    node_type_ids[n] = n % 2 == 0 ? red : blue;
+  }
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateInterleaved(topo.NumEdges());
+  std::fill(
+      edge_type_ids.begin(), edge_type_ids.end(), katana::kUnknownEntityType);
+
+  auto make_res = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_type_ids), std::move(edge_type_ids),
+      std::move(node_types), katana::EntityTypeManager{});
+  KATANA_LOG_VASSERT(make_res, "making graph: {}", make_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(make_res.value());
+
+  katana::TxnContext txn_ctx;
+  auto node_res = AddNodeProperties(
+      pg.get(), &txn_ctx,
+      PropertyGenerator("id", [](Node n) { return static_cast<uint64_t>(n); }),
+      PropertyGenerator(
+          "name", [](Node n) { return fmt::format("Node {}", n); }));
+  KATANA_LOG_VASSERT(node_res, "{}", node_res.error());
+  auto edge_res = AddEdgeProperties(
+      pg.get(), &txn_ctx, PropertyGenerator("ends", [&pg](Edge e) {
+        uint64_t src = pg->topology().GetEdgeSrc(e);
+        uint64_t dst = pg->topology().OutEdgeDst(e);
+        return src * kWidth * kWidth + dst;
+      }));
+  KATANA_LOG_VASSERT(edge_res, "{}", edge_res.error());
+  return pg;
+}
+
+/// Check that result is pg without the nodes not in new_to_old and without
+/// the edges removed_edges has set, with the properties and types of the
+/// nodes and edges it keeps
+void
+CheckResult(
+    katana::PropertyGraph* pg, katana::PropertyGraph* result,
+    const std::vector<Node>& new_to_old, const std::vector<Node>& old_to_new,
+    const katana::DynamicBitset& removed_edges) {
+  const auto& old_topo = pg->topology();
+  const auto& topo = result->topology();
+  KATANA_LOG_ASSERT(topo.NumNodes() == new_to_old.size());
+
+  auto ids = result->GetNodePropertyTyped<uint64_t>("id");
+  KATANA_LOG_VASSERT(ids, "{}", ids.error());
+  auto names = result->GetNodePropertyTyped<std::string>("name");
+  KATANA_LOG_VASSERT(names, "{}", names.error());
+  auto ends = result->GetEdgePropertyTyped<uint64_t>("ends");
+  KATANA_LOG_VASSERT(ends, "{}", ends.error());
+
+  for (Node n : topo.Nodes()) {
+    Node old_n = new_to_old[n];
+    KATANA_LOG_VASSERT(
+        ids.value()->Value(n) == old_n, "node {} has id {}, want {}", n,
+        ids.value()->Value(n), old_n);
+    KATANA_LOG_ASSERT(
+        names.value()->GetString(n) == fmt::format("Node {}", old_n));
+    KATANA_LOG_ASSERT(result->GetTypeOfNode(n) == pg->GetTypeOfNode(old_n));
+
+    // the edges that are kept keep their order
+    std::vector<Node> expected_dsts;
+    for (auto old_e : old_topo.OutEdges(old_n)) {
+      Node old_dst = old_topo.OutEdgeDst(old_e);
+      if (!removed_edges.test(old_e) && old_to_new[old_dst] != kRemoved) {
+        expected_dsts.emplace_back(old_dst);
+      }
+    }
+    std::vector<Node> dsts;
+    for (auto e : topo.OutEdges(n)) {
+      Node old_dst = new_to_old[topo.OutEdgeDst(e)];
+      dsts.emplace_back(old_dst);
+      KATANA_LOG_ASSERT(
+          ends.value()->Value(e) == old_n * kWidth * kWidth + old_dst);
+    }
+    KATANA_LOG_ASSERT(dsts == expected_dsts);
+  }
+}
+
+void
+TestRemoveNodes(katana::PropertyGraph* pg) {
+  katana::DynamicBitset removed;
+  removed.resize(pg->NumNodes());
+  std::vector<Node> new_to_old;
+  std::vector<Node> old_to_new(pg->NumNodes(), kRemoved);
+  for (Node n = 0; n < pg->NumNodes(); ++n) {
+    if (n % 3 == 0 || n < kWidth) {
+      removed.set(n);
+    } else {
+      old_to_new[n] = new_to_old.size();
+      new_to_old.emplace_back(n);
+    }
+  }
+
+  auto res = katana::RemoveNodes(pg, removed);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  katana::DynamicBitset no_edges;
+  no_edges.resize(pg->NumEdges());
+  CheckResult(pg, res.value().get(), new_to_old, old_to_new, no_edges);
+
+  // removing every node leaves an empty graph
+  for (Node n = 0; n < pg->NumNodes(); ++n) {
+    removed.set(n);
+  }
+  auto empty = katana::RemoveNodes(pg, removed);
+  KATANA_LOG_VASSERT(empty, "{}", empty.error());
+  KATANA_LOG_ASSERT(empty.value()->NumNodes() == 0);
+  KATANA_LOG_ASSERT(empty.value()->NumEdges() == 0);
+
+  katana::DynamicBitset too_short;
+  too_short.resize(pg->NumNodes() - 1);
+  KATANA_LOG_ASSERT(!katana::RemoveNodes(pg, too_short));
+}
+
+void
+TestRemoveEdges(katana::PropertyGraph* pg) {
+  katana::DynamicBitset removed;
+  removed.resize(pg->NumEdges());
+  for (Edge e = 0; e < pg->NumEdges(); e += 4) {
+    removed.set(e);
+  }
+  std::vector<Node> identity(pg->NumNodes());
+  for (Node n = 0; n < pg->NumNodes(); ++n) {
+    identity[n] = n;
+  }
+
+  auto res = katana::RemoveEdges(pg, removed);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(
+      res.value()->NumEdges() == pg->NumEdges() - (pg->NumEdges() + 3) / 4);
+  CheckResult(pg, res.value().get(), identity, identity, removed);
+
+  katana::DynamicBitset too_long;
+  too_long.resize(pg->NumEdges() + 1);
+  KATANA_LOG_ASSERT(!katana::RemoveEdges(pg, too_long));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg = MakeGraph();
+  TestRemoveNodes(pg.get());
+  TestRemoveEdges(pg.get());
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void
+WriteGraph(katana::PropertyGraph* pg, const std::string& rdg_dir) {
+  katana::TxnContext txn_ctx;
+  auto write_res = pg->Write(rdg_dir, "shared-topology", &txn_ctx);
+  KATANA_LOG_VASSERT(write_res, "writing: {}", write_res.error());
+}
+
+std::unique_ptr<katana::PropertyGraph>
+LoadGraph(
+    const std::string& rdg_dir,
+    const katana::RDGLoadOptions& opts = katana::RDGLoadOptions()) {
+  katana::TxnContext txn_ctx;
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  KATANA_LOG_VASSERT(make_res, "making: {}", make_res.error());
+  return std::move(make_res.value());
+}
+
+bool
+SameTopology(const katana::GraphTopology& a, const katana::GraphTopology& b) {
+  if (a.NumNodes() != b.NumNodes() || a.NumEdges() != b.NumEdges()) {
+    return false;
+  }
+  for (auto n : a.Nodes()) {
+    if (a.AdjData()[n] != b.AdjData()[n]) {
+      return false;
+    }
+  }
+  for (auto e : a.OutEdges()) {
+    if (a.OutEdgeDst(e) != b.OutEdgeDst(e)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Graphs loaded from the same topology file use one copy of it
+void
+TestShared(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> grid = katana::MakeGrid(10, 10, false);
+  WriteGraph(grid.get(), rdg_dir);
+
+  std::unique_ptr<katana::PropertyGraph> a = LoadGraph(rdg_dir);
+  std::unique_ptr<katana::PropertyGraph> b = LoadGraph(rdg_dir);
+  KATANA_LOG_ASSERT(SameTopology(a->topology(), grid->topology()));
+  KATANA_LOG_ASSERT(a->topology().AdjData() == b->topology().AdjData());
+
+  // the copy outlives the graph that loaded it
+  a.reset();
+  KATANA_LOG_ASSERT(SameTopology(b->topology(), grid->topology()));
+  std::unique_ptr<katana::PropertyGraph> c = LoadGraph(rdg_dir);
+  KATANA_LOG_ASSERT(c->topology().AdjData() == b->topology().AdjData());
+
+  // and is loaded again once no graph uses it
+  b.reset();
+  c.reset();
+  std::unique_ptr<katana::PropertyGraph> d = LoadGraph(rdg_dir);
+  KATANA_LOG_ASSERT(SameTopology(d->topology(), grid->topology()));
+}
+
+/// A semi-external topology stays in its file mapping
+void
+TestSemiExternalNotShared(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> shared = LoadGraph(rdg_dir);
+  katana::RDGLoadOptions opts;
+  opts.semi_external_topology = true;
+  std::unique_ptr<katana::PropertyGraph> semi_external =
+      LoadGraph(rdg_dir, opts);
+  KATANA_LOG_ASSERT(semi_external->topology().IsSemiExternal());
+  KATANA_LOG_ASSERT(
+      semi_external->topology().AdjData() != shared->topology().AdjData());
+  KATANA_LOG_ASSERT(
+      SameTopology(semi_external->topology(), shared->topology()));
+}
+
+/// Graphs with different topology files do not share them
+void
+TestDistinct(const std::string& rdg_dir, const std::string& other_dir) {
+  std::unique_ptr<katana::PropertyGraph> other_grid =
+      katana::MakeGrid(5, 20, true);
+  WriteGraph(other_grid.get(), other_dir);
+
+  std::unique_ptr<katana::PropertyGraph> a = LoadGraph(rdg_dir);
+  std::unique_ptr<katana::PropertyGraph> b = LoadGraph(other_dir);
+  KATANA_LOG_ASSERT(a->topology().AdjData() != b->topology().AdjData());
+  KATANA_LOG_ASSERT(SameTopology(b->topology(), other_grid->topology()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/sharedtopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto other_res = katana::URI::MakeRand("/tmp/sharedtopology");
+  KATANA_LOG_ASSERT(other_res);
+  std::string other_dir(other_res.value().path());
+
+  TestShared(rdg_dir);
+  TestSemiExternalNotShared(rdg_dir);
+  TestDistinct(rdg_dir, other_dir);
+
+  fs::remove_all(rdg_dir);
+  fs::remove_all(other_dir);
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TopologyManager.h"
+
+using namespace katana;
+using SortedGraphView = PropertyGraphViews::EdgesSortedByDestID;
+using TransposedGraphView = PropertyGraphViews::Transposed;
+
+Result<void>
+TestEvictUnusedTopologies() {
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 20;
+
+  auto pg = KATANA_CHECKED(PropertyGraph::Make(
+      CreateUniformRandomTopology(kNumNodes, kEdgesPerNode)));
+
+  auto& tm = TopologyManager::Get();
+  const count_t before = tm.standby();
+
+  SortedGraphView sorted = pg->BuildView<SortedGraphView>();
+  {
+    TransposedGraphView transposed = pg->BuildView<TransposedGraphView>();
+  }
+  const count_t cached = tm.standby();
+  KATANA_LOG_ASSERT(cached > before);
+
+  // Only the transposed topology is unreferenced, so only it goes
+  const count_t freed = tm.FreeStandbyMemory(cached);
+  KATANA_LOG_ASSERT(freed > 0);
+  KATANA_LOG_ASSERT(tm.standby() == cached - freed);
+  KATANA_LOG_ASSERT(tm.standby() > before);
+
+  // The evicted topology is rebuilt on demand
+  TransposedGraphView transposed = pg->BuildView<TransposedGraphView>();
+  KATANA_LOG_ASSERT(transposed.NumEdges() == sorted.NumEdges());
+  KATANA_LOG_ASSERT(tm.standby() == cached);
+
+  pg.reset();
+  KATANA_LOG_ASSERT(tm.standby() == before);
+
+  return katana::ResultSuccess();
+}
+
+int
+main() {
+  SharedMemSys sys;
+
+  auto res = TestEvictUnusedTopologies();
+  KATANA_LOG_ASSERT(res);
+
+  return 0;
+}
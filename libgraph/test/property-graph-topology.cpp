@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
@@ -12,6 +15,111 @@ TestEdgeSource(const katana::GraphTopology& topo) noexcept {
   }
 }
 
+/// A graph where node 0 has more edges than a sorting tile, some of them
+/// parallel, and every other node has a few edges in decreasing order
+katana::GraphTopology
+MakeSkewedTopology(size_t num_nodes, size_t hub_degree) {
+  std::vector<std::vector<katana::GraphTopology::Node>> adj(num_nodes);
+  for (size_t i = 0; i < hub_degree; ++i) {
+    adj[0].emplace_back((hub_degree - i) * 7919 % num_nodes);
+  }
+  for (size_t n = 1; n < num_nodes; ++n) {
+    for (size_t i = 3; i > 0; --i) {
+      adj[n].emplace_back((n * i * 31) % num_nodes);
+    }
+  }
+
+  katana::NUMAArray<katana::GraphTopology::Edge> adj_indices;
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+  adj_indices.allocateInterleaved(num_nodes);
+  size_t num_edges = 0;
+  for (const auto& a : adj) {
+    num_edges += a.size();
+  }
+  dests.allocateInterleaved(num_edges);
+  size_t next = 0;
+  for (size_t n = 0; n < num_nodes; ++n) {
+    for (auto dst : adj[n]) {
+      dests[next++] = dst;
+    }
+    adj_indices[n] = next;
+  }
+  return katana::GraphTopology{std::move(adj_indices), std::move(dests)};
+}
+
+/// Checks that \p view has the edges of \p orig, reversed if \p transposed,
+/// each edge once, with the edges of every node sorted by destination if
+/// \p sorted
+template <typename View>
+void
+TestSameEdges(
+    const katana::GraphTopology& orig, const View& view, bool transposed,
+    bool sorted) {
+  std::vector<uint8_t> seen(orig.NumEdges(), 0);
+  for (auto node : view.Nodes()) {
+    katana::GraphTopology::Node prev = 0;
+    for (auto e : view.OutEdges(node)) {
+      auto dst = view.OutEdgeDst(e);
+      auto orig_edge = view.GetEdgePropertyIndexFromOutEdge(e);
+      KATANA_LOG_ASSERT(orig_edge < orig.NumEdges());
+      KATANA_LOG_ASSERT(!seen[orig_edge]);
+      seen[orig_edge] = 1;
+      auto orig_src = orig.GetEdgeSrc(orig_edge);
+      auto orig_dst = orig.OutEdgeDst(orig_edge);
+      KATANA_LOG_ASSERT(transposed ? orig_src == dst : orig_dst == dst);
+      KATANA_LOG_ASSERT(transposed ? orig_dst == node : orig_src == node);
+      KATANA_LOG_ASSERT(!sorted || prev <= dst);
+      prev = dst;
+    }
+  }
+  KATANA_LOG_ASSERT(std::all_of(
+      seen.begin(), seen.end(), [](uint8_t s) { return s == 1; }));
+}
+
+void
+TestSortedViews() {
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kHubDegree = 5000;
+
+  auto pg_res =
+      katana::PropertyGraph::Make(MakeSkewedTopology(kNumNodes, kHubDegree));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  katana::GraphTopology orig = katana::GraphTopology::Copy(pg->topology());
+
+  // The copy in the original order needs no edge property index map, and
+  // the sorted copy needs one of 32-bit indexes
+  auto unsorted = katana::EdgeShuffleTopology::Make(
+      pg.get(), katana::RDGTopology::TransposeKind::kNo,
+      katana::RDGTopology::EdgeSortKind::kAny);
+  KATANA_LOG_ASSERT(unsorted->EdgePropertyIndexSizeBytes() == 0);
+  TestSameEdges(orig, *unsorted, false, false);
+  auto sorted_copy = katana::EdgeShuffleTopology::Make(
+      pg.get(), katana::RDGTopology::TransposeKind::kNo,
+      katana::RDGTopology::EdgeSortKind::kSortedByDestID);
+  KATANA_LOG_ASSERT(
+      sorted_copy->EdgePropertyIndexSizeBytes() ==
+      orig.NumEdges() * sizeof(uint32_t));
+  TestSameEdges(orig, *sorted_copy, false, true);
+
+  auto sorted =
+      pg->BuildView<katana::PropertyGraphViews::EdgesSortedByDestID>();
+  TestSameEdges(orig, sorted, false, true);
+
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  TestSameEdges(orig, transposed, true, false);
+
+  // With one socket the replicated view reads the topology itself
+  auto replicated =
+      pg->BuildView<katana::PropertyGraphViews::ReplicatedTransposed>();
+  TestSameEdges(orig, replicated, true, false);
+
+  auto edge_sources = pg->BuildView<katana::PropertyGraphViews::EdgeSources>();
+  for (auto e : edge_sources.OutEdges()) {
+    KATANA_LOG_ASSERT(edge_sources.GetEdgeSrc(e) == orig.GetEdgeSrc(e));
+  }
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -24,5 +132,7 @@ main() {
 
   TestEdgeSource(topo);
 
+  TestSortedViews();
+
   return 0;
 }
@@ -1,17 +1,24 @@
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
+#include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/EntityIndex.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
 #include "katana/SharedMemSys.h"
+#include "katana/URI.h"
 
 template <typename node_or_edge>
 struct NodeOrEdge {
   static katana::Result<katana::EntityIndex<node_or_edge>*> MakeIndex(
-      katana::PropertyGraph* pg, const std::string& property_name);
+      katana::PropertyGraph* pg, const std::string& property_name,
+      katana::EntityIndexKind kind = katana::EntityIndexKind::kOrdered);
   static katana::Result<void> AddProperties(
       katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
       katana::TxnContext* txn_ctx);
@@ -23,8 +30,10 @@ using Edge = NodeOrEdge<katana::GraphTopology::Edge>;
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Node>*>
-Node::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
-  auto result = pg->MakeNodeIndex(property_name);
+Node::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeNodeIndex(property_name, kind);
   if (!result) {
     return result.error();
   }
@@ -40,8 +49,10 @@ Node::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Edge>*>
-Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
-  auto result = pg->MakeEdgeIndex(property_name);
+Edge::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeEdgeIndex(property_name, kind);
   if (!result) {
     return result.error();
   }
@@ -203,6 +214,22 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound(44);
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->Value(*it) == 46);
+
+  // Every key probes the same position as in the sorted values.
+  size_t pos = 0;
+  for (it = nonuniform_index->begin(); it != nonuniform_index->end(); ++it) {
+    DataType value = typed_prop->Value(*it);
+    KATANA_LOG_VASSERT(
+        nonuniform_index->LowerBound(value) - nonuniform_index->begin() ==
+            static_cast<ptrdiff_t>(pos),
+        "Wrong lower bound of {}", value);
+    KATANA_LOG_VASSERT(
+        nonuniform_index->UpperBound(value) - nonuniform_index->begin() ==
+            static_cast<ptrdiff_t>(pos + 1),
+        "Wrong upper bound of {}", value);
+    ++pos;
+  }
+  KATANA_LOG_ASSERT(pos == num_entities);
 }
 
 template <typename node_or_edge>
@@ -271,6 +298,191 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound("aaak");
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
+
+  // Iteration yields the values in order.
+  for (it = nonuniform_index->begin(); it + 1 < nonuniform_index->end(); ++it) {
+    KATANA_LOG_ASSERT(
+        typed_prop->GetView(*it) < typed_prop->GetView(*(it + 1)));
+  }
+}
+
+// A hash index finds the same ranges as the ordered index over a property.
+template <typename c_type>
+void
+TestHashIndex(const std::shared_ptr<arrow::Table>& prop, size_t line_width) {
+  using node_or_edge = katana::GraphTopology::Node;
+  using OrderedIndexType = katana::OrderedEntityIndex<node_or_edge, c_type>;
+  using HashIndexType = katana::HashEntityIndex<node_or_edge, c_type>;
+
+  LinePolicy policy{line_width};
+  katana::TxnContext txn_ctx;
+  size_t num_rows = prop->num_rows();
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_rows, 0, &policy, &txn_ctx);
+  std::string name = prop->field(0)->name();
+  KATANA_LOG_ASSERT(g->AddNodeProperties(prop, &txn_ctx));
+
+  auto hash_result =
+      Node::MakeIndex(g.get(), name, katana::EntityIndexKind::kHash);
+  KATANA_LOG_VASSERT(
+      hash_result, "Could not create index: {}", hash_result.error());
+  auto* hash_index = dynamic_cast<HashIndexType*>(hash_result.value());
+  KATANA_LOG_ASSERT(hash_index != nullptr);
+
+  auto ordered_index = std::make_unique<OrderedIndexType>(
+      name, num_rows, prop->column(0)->chunk(0));
+  KATANA_LOG_ASSERT(
+      static_cast<katana::EntityIndex<node_or_edge>*>(ordered_index.get())
+          ->BuildFromProperty());
+
+  KATANA_LOG_ASSERT(std::equal(
+      hash_index->begin(), hash_index->end(), ordered_index->begin(),
+      ordered_index->end()));
+  auto value_of = [&prop](node_or_edge id) -> c_type {
+    if constexpr (std::is_same_v<c_type, std::string_view>) {
+      auto typed_prop = std::static_pointer_cast<arrow::LargeStringArray>(
+          prop->column(0)->chunk(0));
+      auto view = typed_prop->GetView(id);
+      return std::string_view(view.data(), view.size());
+    } else {
+      using ArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
+      return std::static_pointer_cast<ArrayType>(prop->column(0)->chunk(0))
+          ->Value(id);
+    }
+  };
+  for (auto it = ordered_index->begin(); it != ordered_index->end(); ++it) {
+    c_type value = value_of(*it);
+    auto [begin, end] = hash_index->EqualRange(value);
+    KATANA_LOG_ASSERT(
+        begin - hash_index->begin() ==
+        ordered_index->LowerBound(value) - ordered_index->begin());
+    KATANA_LOG_ASSERT(
+        end - hash_index->begin() ==
+        ordered_index->UpperBound(value) - ordered_index->begin());
+    KATANA_LOG_ASSERT(hash_index->Find(value) == begin);
+  }
+
+  // Neither property has odd numbers or strings ending in odd letters.
+  c_type missing;
+  if constexpr (std::is_same_v<c_type, std::string_view>) {
+    missing = "aaaj";
+  } else {
+    missing = 43;
+  }
+  KATANA_LOG_ASSERT(hash_index->Find(missing) == hash_index->end());
+  auto [begin, end] = hash_index->EqualRange(missing);
+  KATANA_LOG_ASSERT(begin == end);
+
+  // FindMany agrees with Find for every value, in descending order, and
+  // for missing and null keys.
+  std::shared_ptr<arrow::Array> keys;
+  if constexpr (std::is_same_v<c_type, std::string_view>) {
+    arrow::LargeStringBuilder builder;
+    for (node_or_edge id = num_rows; id-- > 0;) {
+      KATANA_LOG_ASSERT(builder.Append(std::string(value_of(id))).ok());
+    }
+    KATANA_LOG_ASSERT(builder.Append(std::string(missing)).ok());
+    KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    KATANA_LOG_ASSERT(builder.Finish(&keys).ok());
+  } else {
+    typename arrow::CTypeTraits<c_type>::BuilderType builder;
+    for (node_or_edge id = num_rows; id-- > 0;) {
+      KATANA_LOG_ASSERT(builder.Append(value_of(id)).ok());
+    }
+    KATANA_LOG_ASSERT(builder.Append(missing).ok());
+    KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    KATANA_LOG_ASSERT(builder.Finish(&keys).ok());
+  }
+  auto ordered_found = ordered_index->FindMany(*keys);
+  auto hash_found = hash_index->FindMany(*keys);
+  KATANA_LOG_ASSERT(ordered_found && hash_found);
+  KATANA_LOG_ASSERT(ordered_found.value().size() == num_rows + 2);
+  for (size_t i = 0; i < ordered_found.value().size(); ++i) {
+    node_or_edge expected = katana::EntityIndex<node_or_edge>::kNotFound;
+    if (i < num_rows) {
+      expected = *ordered_index->Find(value_of(num_rows - 1 - i));
+    }
+    KATANA_LOG_VASSERT(
+        ordered_found.value()[i] == expected, "ordered FindMany of key {}", i);
+    KATANA_LOG_VASSERT(
+        hash_found.value()[i] == expected, "hash FindMany of key {}", i);
+  }
+}
+
+// Indexes are stored with the graph, loaded instead of rebuilt, and dropped
+// when their property changes.
+void
+TestStoredIndex(size_t num_nodes, size_t line_width) {
+  using IndexType =
+      katana::PrimitiveEntityIndex<katana::GraphTopology::Node, int64_t>;
+  using HashIndexType =
+      katana::HashEntityIndex<katana::GraphTopology::Node, int64_t>;
+
+  LinePolicy policy{line_width};
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      CreatePrimitiveProperty<int64_t>("nonuniform", false, g->NumNodes()),
+      &txn_ctx));
+  KATANA_LOG_ASSERT(g->MakeNodeIndex("nonuniform"));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyindex");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, "property-index", &txn_ctx);
+  if (!write_result) {
+    boost::filesystem::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(make_result, "making result: {}", make_result.error());
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(make_result, "making result: {}", make_result.error());
+  std::unique_ptr<katana::PropertyGraph> g3 = std::move(make_result.value());
+
+  std::string stored_name =
+      katana::EntityIndexPrimitive::NodeIndexName("nonuniform");
+  KATANA_LOG_ASSERT(g2->rdg().HasEntityIndexPrimitive(stored_name));
+  KATANA_LOG_ASSERT(!g2->HasNodeIndex("nonuniform"));
+  KATANA_LOG_ASSERT(g2->MakeNodeIndex("nonuniform"));
+
+  auto index = g->GetNodeIndex("nonuniform");
+  auto loaded_index = g2->GetNodeIndex("nonuniform");
+  KATANA_LOG_ASSERT(index && loaded_index);
+  KATANA_LOG_ASSERT(std::equal(
+      index.value()->begin(), index.value()->end(),
+      loaded_index.value()->begin(), loaded_index.value()->end()));
+  auto* typed_index = static_cast<IndexType*>(loaded_index.value().get());
+  KATANA_LOG_ASSERT(typed_index->Find(44) != typed_index->end());
+  // An unusable stored copy would have been removed
+  KATANA_LOG_ASSERT(g2->rdg().HasEntityIndexPrimitive(stored_name));
+
+  // A hash index loads from the same stored copy
+  KATANA_LOG_ASSERT(
+      g3->MakeNodeIndex("nonuniform", katana::EntityIndexKind::kHash));
+  KATANA_LOG_ASSERT(g3->rdg().HasEntityIndexPrimitive(stored_name));
+  auto hash_index = g3->GetNodeIndex("nonuniform");
+  KATANA_LOG_ASSERT(hash_index);
+  KATANA_LOG_ASSERT(std::equal(
+      index.value()->begin(), index.value()->end(),
+      hash_index.value()->begin(), hash_index.value()->end()));
+  auto* typed_hash_index =
+      static_cast<HashIndexType*>(hash_index.value().get());
+  KATANA_LOG_ASSERT(typed_hash_index->Find(44) != typed_hash_index->end());
+  boost::filesystem::remove_all(rdg_dir);
+
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(
+      CreatePrimitiveProperty<int64_t>("nonuniform", true, g2->NumNodes()),
+      &txn_ctx));
+  KATANA_LOG_ASSERT(!g2->HasNodeIndex("nonuniform"));
+  KATANA_LOG_ASSERT(!g2->rdg().HasEntityIndexPrimitive(stored_name));
 }
 
 int
@@ -285,5 +497,22 @@ main() {
   TestStringIndex<katana::GraphTopology::Node>(10, 3);
   TestStringIndex<katana::GraphTopology::Edge>(10, 3);
 
+  // Large enough to search past the final linear scan
+  TestPrimitiveIndex<katana::GraphTopology::Node, int64_t>(1000, 3);
+  TestStringIndex<katana::GraphTopology::Edge>(1000, 3);
+
+  TestHashIndex<int64_t>(
+      CreatePrimitiveProperty<int64_t>("nonuniform", false, 1000), 3);
+  TestHashIndex<int64_t>(
+      CreatePrimitiveProperty<int64_t>("uniform", true, 1000), 3);
+  TestHashIndex<double_t>(
+      CreatePrimitiveProperty<double_t>("nonuniform", false, 1000), 3);
+  TestHashIndex<std::string_view>(
+      CreateStringProperty("nonuniform", false, 1000), 3);
+  TestHashIndex<std::string_view>(
+      CreateStringProperty("uniform", true, 1000), 3);
+
+  TestStoredIndex(1000, 3);
+
   return 0;
 }
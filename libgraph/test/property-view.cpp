@@ -111,10 +111,49 @@ TestFixedSizedBinaryArray() {
   return katana::ResultSuccess();
 }
 
+/// The view of a dictionary encoded string array exposes its codes
+katana::Result<void>
+TestDictionaryView() {
+  const std::vector<std::string> values{"us", "fr", "us", "", "de", "fr"};
+  arrow::StringDictionary32Builder builder;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i == 3) {
+      KATANA_CHECKED(builder.AppendNull());
+    } else {
+      KATANA_CHECKED(builder.Append(values[i]));
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  const auto& dict_array = static_cast<const arrow::DictionaryArray&>(*array);
+
+  auto view = KATANA_CHECKED(
+      katana::DictionaryPropertyReadOnlyView<int32_t>::Make(dict_array));
+  KATANA_LOG_ASSERT(view.size() == values.size());
+  KATANA_LOG_ASSERT(view.num_codes() == 3);
+  KATANA_LOG_ASSERT(!view.IsValid(3));
+  KATANA_LOG_ASSERT(view[0] == view[2] && view[1] == view[5]);
+  KATANA_LOG_ASSERT(view[0] != view[1] && view[0] != view[4]);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (view.IsValid(i)) {
+      KATANA_LOG_ASSERT(view.Decode(view[i]) == values[i]);
+    }
+  }
+  KATANA_LOG_ASSERT(view.Encode("fr") == view[1]);
+  KATANA_LOG_ASSERT(!view.Encode("it"));
+
+  // the codes must have the type of the view
+  KATANA_LOG_ASSERT(
+      !katana::DictionaryPropertyReadOnlyView<int8_t>::Make(dict_array));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll() {
   KATANA_CHECKED(TestNoBitmapValidity());
   KATANA_CHECKED(TestFixedSizedBinaryArray());
+  KATANA_CHECKED(TestDictionaryView());
   return katana::ResultSuccess();
 }
 
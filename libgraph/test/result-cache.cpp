@@ -0,0 +1,163 @@
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "katana/analytics/ResultCache.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace fs = boost::filesystem;
+
+using katana::analytics::ResultCache;
+using katana::analytics::ResultKey;
+
+namespace {
+
+/// A grid with edge weights of 1, stored at rdg_dir and loaded back
+std::unique_ptr<katana::PropertyGraph>
+MakeStoredGraph(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> grid = katana::MakeGrid(10, 10, false);
+  {
+    katana::TxnContext txn_ctx;
+    auto add_res = katana::AddEdgeProperties(
+        grid.get(), &txn_ctx,
+        katana::PropertyGenerator(
+            "weight", [](katana::PropertyGraph::Edge) { return int64_t{1}; }));
+    KATANA_LOG_VASSERT(add_res, "adding weights: {}", add_res.error());
+    auto write_res = grid->Write(rdg_dir, "result-cache", &txn_ctx);
+    KATANA_LOG_VASSERT(write_res, "writing: {}", write_res.error());
+  }
+  katana::TxnContext txn_ctx;
+  auto make_res = katana::PropertyGraph::Make(rdg_dir, &txn_ctx);
+  KATANA_LOG_VASSERT(make_res, "making: {}", make_res.error());
+  return std::move(make_res.value());
+}
+
+ResultKey
+SsspKey(size_t start) {
+  return ResultKey("sssp").Parameter("start", start).EdgeInput("weight");
+}
+
+/// Run SSSP from start through cache into output
+void
+RunSssp(
+    ResultCache* cache, katana::PropertyGraph* pg, size_t start,
+    const std::string& output, katana::TxnContext* txn_ctx) {
+  auto res = cache->Run(
+      pg, SsspKey(start), output, txn_ctx, [&](const std::string& out) {
+        return katana::analytics::Sssp(pg, start, "weight", out, txn_ctx);
+      });
+  KATANA_LOG_VASSERT(res, "running sssp: {}", res.error());
+}
+
+int64_t
+Distance(const katana::PropertyGraph& pg, const std::string& output, size_t n) {
+  return pg.GetNodePropertyTyped<int64_t>(output).value()->Value(n);
+}
+
+/// Set every weight to value in txn_ctx
+void
+SetWeights(
+    katana::PropertyGraph* pg, int64_t value, katana::TxnContext* txn_ctx) {
+  arrow::Int64Builder builder;
+  for (uint64_t e = 0; e < pg->NumEdges(); ++e) {
+    KATANA_LOG_ASSERT(builder.Append(value).ok());
+  }
+  std::shared_ptr<arrow::Array> weights = builder.Finish().ValueOrDie();
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::int64())}), {weights});
+  KATANA_LOG_ASSERT(pg->UpsertEdgeProperties(table, txn_ctx));
+}
+
+/// Repeated calls reuse the column; other parameters and committed writes
+/// to the inputs compute again
+void
+TestReuse(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> pg = MakeStoredGraph(rdg_dir);
+  ResultCache cache;
+  katana::TxnContext txn_ctx;
+
+  RunSssp(&cache, pg.get(), 0, "d0", &txn_ctx);
+  RunSssp(&cache, pg.get(), 0, "d1", &txn_ctx);
+  KATANA_LOG_ASSERT(cache.hits() == 1 && cache.misses() == 1);
+  KATANA_LOG_ASSERT(
+      pg->GetNodeProperty("d1").value()->chunk(0) ==
+      pg->GetNodeProperty("d0").value()->chunk(0));
+  KATANA_LOG_ASSERT(Distance(*pg, "d1", 99) == 18);
+
+  RunSssp(&cache, pg.get(), 99, "d2", &txn_ctx);
+  KATANA_LOG_ASSERT(cache.misses() == 2 && cache.size() == 2);
+  KATANA_LOG_ASSERT(Distance(*pg, "d2", 0) == 18);
+
+  {
+    katana::TxnContext writer(false);
+    SetWeights(pg.get(), 3, &writer);
+    KATANA_LOG_ASSERT(writer.Commit());
+  }
+  RunSssp(&cache, pg.get(), 0, "d3", &txn_ctx);
+  KATANA_LOG_ASSERT(cache.hits() == 1 && cache.misses() == 3);
+  KATANA_LOG_ASSERT(Distance(*pg, "d3", 99) == 54);
+  RunSssp(&cache, pg.get(), 0, "d4", &txn_ctx);
+  KATANA_LOG_ASSERT(cache.hits() == 2);
+}
+
+/// A transaction that wrote an input neither uses nor fills the cache
+void
+TestOwnWrites(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> pg = MakeStoredGraph(rdg_dir);
+  ResultCache cache;
+  {
+    katana::TxnContext txn_ctx;
+    RunSssp(&cache, pg.get(), 0, "d0", &txn_ctx);
+  }
+
+  katana::TxnContext txn_ctx(false);
+  SetWeights(pg.get(), 2, &txn_ctx);
+  RunSssp(&cache, pg.get(), 0, "d1", &txn_ctx);
+  KATANA_LOG_ASSERT(cache.hits() == 0 && cache.size() == 1);
+  KATANA_LOG_ASSERT(Distance(*pg, "d1", 99) == 36);
+  KATANA_LOG_ASSERT(txn_ctx.Commit());
+}
+
+/// Graphs without an RDG always compute, and old results are dropped
+void
+TestUncachedAndEviction(const std::string& rdg_dir) {
+  std::unique_ptr<katana::PropertyGraph> grid = katana::MakeGrid(10, 10, false);
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(katana::AddEdgeProperties(
+      grid.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "weight", [](katana::PropertyGraph::Edge) { return int64_t{1}; })));
+  ResultCache cache;
+  RunSssp(&cache, grid.get(), 0, "d0", &txn_ctx);
+  RunSssp(&cache, grid.get(), 0, "d1", &txn_ctx);
+  KATANA_LOG_ASSERT(cache.hits() == 0 && cache.size() == 0);
+
+  std::unique_ptr<katana::PropertyGraph> pg = MakeStoredGraph(rdg_dir);
+  ResultCache small(1);
+  RunSssp(&small, pg.get(), 0, "d0", &txn_ctx);
+  RunSssp(&small, pg.get(), 1, "d1", &txn_ctx);
+  RunSssp(&small, pg.get(), 0, "d2", &txn_ctx);
+  KATANA_LOG_ASSERT(small.hits() == 0 && small.size() == 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto uri_res = katana::URI::MakeRand("/tmp/resultcache");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  TestReuse(rdg_dir + "/reuse");
+  TestOwnWrites(rdg_dir + "/own-writes");
+  TestUncachedAndEviction(rdg_dir + "/eviction");
+
+  fs::remove_all(rdg_dir);
+  return 0;
+}
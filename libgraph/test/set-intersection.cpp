@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/analytics/SetIntersection.h"
+
+namespace {
+
+std::vector<uint32_t>
+RandomSet(std::mt19937* gen, size_t size, uint32_t max) {
+  std::uniform_int_distribution<uint32_t> dist(0, max);
+  std::set<uint32_t> set;
+  while (set.size() < size) {
+    set.insert(dist(*gen));
+  }
+  return {set.begin(), set.end()};
+}
+
+/// Every kernel agrees with std::set_intersection, from sets too small for
+/// SIMD blocks to ones skewed enough to gallop
+void
+TestAgainstSerial() {
+  std::mt19937 gen(3);
+  for (int trial = 0; trial < 5000; ++trial) {
+    size_t a_size = gen() % 200;
+    size_t b_size = gen() % (trial % 4 == 0 ? 20000 : 200);
+    uint32_t max = std::max(a_size, b_size) + gen() % 4000;
+    std::vector<uint32_t> a = RandomSet(&gen, a_size, max);
+    std::vector<uint32_t> b = RandomSet(&gen, b_size, max);
+
+    std::vector<uint32_t> expected;
+    std::set_intersection(
+        a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+    size_t count = katana::analytics::CountIntersection(
+        a.data(), a.size(), b.data(), b.size());
+    KATANA_LOG_VASSERT(
+        count == expected.size(), "sizes {} and {}: counted {}, expected {}",
+        a_size, b_size, count, expected.size());
+
+    std::vector<uint32_t> found;
+    katana::analytics::ForEachIntersection(
+        a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+          KATANA_LOG_ASSERT(a[i] == b[j]);
+          found.emplace_back(a[i]);
+        });
+    KATANA_LOG_ASSERT(found == expected);
+
+    size_t calls = 0;
+    katana::analytics::ForEachIntersection(
+        a.data(), a.size(), b.data(), b.size(),
+        [&](size_t, size_t) { return ++calls < 3; });
+    KATANA_LOG_ASSERT(calls == std::min<size_t>(3, expected.size()));
+
+    katana::analytics::DenseSet dense;
+    dense.Assign(a.data(), a.size());
+    KATANA_LOG_ASSERT(
+        dense.CountIntersection(b.data(), b.size()) == expected.size());
+    dense.Clear();
+    for (uint32_t x : a) {
+      KATANA_LOG_ASSERT(!dense.Contains(x));
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  TestAgainstSerial();
+  return 0;
+}
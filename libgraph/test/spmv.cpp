@@ -0,0 +1,157 @@
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/SpMV.h"
+
+namespace {
+
+using katana::analytics::MinPlus;
+using katana::analytics::PlusTimes;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr size_t kNumNodes = 1000;
+constexpr size_t kEdgesPerNode = 7;
+
+/// y = x A computed edge by edge
+template <typename Semiring, typename Weight>
+std::vector<typename Semiring::value_type>
+SerialVxM(
+    const katana::GraphTopology& topo, const Weight& weight,
+    const std::vector<typename Semiring::value_type>& x) {
+  std::vector<typename Semiring::value_type> y(
+      topo.NumNodes(), Semiring::Zero());
+  for (Node u : topo.Nodes()) {
+    for (Edge e : topo.OutEdges(u)) {
+      Node v = topo.OutEdgeDst(e);
+      y[v] = Semiring::Add(y[v], Semiring::Multiply(x[u], weight(e)));
+    }
+  }
+  return y;
+}
+
+/// Pushing over the graph and pulling over its transpose agree with the
+/// serial product, also when x is sparse
+void
+TestVxM(katana::PropertyGraph* pg) {
+  using S = PlusTimes<uint64_t>;
+  auto forward = pg->BuildView<katana::PropertyGraphViews::Default>();
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  // the weight of an edge is its index in the default view
+  auto weight = [](Edge e) { return e % 13 + 1; };
+  auto transposed_weight = [&](Edge e) {
+    return transposed.GetEdgePropertyIndexFromOutEdge(e) % 13 + 1;
+  };
+
+  for (size_t stride : {1, 50}) {
+    std::vector<uint64_t> x(kNumNodes, 0);
+    for (size_t i = 0; i < kNumNodes; i += stride) {
+      x[i] = i % 5 + 1;
+    }
+    std::vector<uint64_t> expected =
+        SerialVxM<S>(pg->topology(), weight, x);
+
+    std::vector<uint64_t> pushed(kNumNodes);
+    katana::analytics::PushVxM<S>(forward, weight, x.data(), pushed.data());
+    KATANA_LOG_ASSERT(pushed == expected);
+
+    std::vector<uint64_t> pulled(kNumNodes);
+    katana::analytics::PullMxV<S>(
+        transposed, transposed_weight, x.data(), pulled.data());
+    KATANA_LOG_ASSERT(pulled == expected);
+
+    std::vector<uint64_t> automatic(kNumNodes);
+    katana::analytics::VxM<S>(
+        forward, transposed, weight, transposed_weight, x.data(),
+        automatic.data());
+    KATANA_LOG_ASSERT(automatic == expected);
+  }
+}
+
+/// Masked out outputs are left as they were
+void
+TestMask(katana::PropertyGraph* pg) {
+  using S = MinPlus<uint32_t>;
+  auto forward = pg->BuildView<katana::PropertyGraphViews::Default>();
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  katana::analytics::UnitWeight<S> weight;
+
+  std::vector<uint32_t> x(kNumNodes, S::Zero());
+  x[0] = 0;
+  std::vector<uint32_t> expected = SerialVxM<S>(pg->topology(), weight, x);
+
+  katana::DynamicBitset bits;
+  bits.resize(kNumNodes);
+  for (size_t i = 0; i < kNumNodes; i += 3) {
+    bits.set(i);
+  }
+  for (bool complement : {false, true}) {
+    katana::analytics::BitsetMask mask{bits, complement};
+    for (auto direction :
+         {katana::analytics::SpMVDirection::kPull,
+          katana::analytics::SpMVDirection::kPush}) {
+      std::vector<uint32_t> y(kNumNodes, 7);
+      katana::analytics::VxM<S>(
+          forward, transposed, weight, weight, x.data(), y.data(), mask,
+          direction);
+      for (size_t i = 0; i < kNumNodes; ++i) {
+        KATANA_LOG_ASSERT(y[i] == (mask(i) ? expected[i] : 7));
+      }
+    }
+  }
+}
+
+/// Every column of a dense product is a vector product, with the width
+/// given at compile time or not
+void
+TestMxM(katana::PropertyGraph* pg) {
+  using S = PlusTimes<float>;
+  constexpr size_t kWidth = 8;
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  katana::analytics::UnitWeight<S> weight;
+
+  std::vector<float> x(kNumNodes * kWidth);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = i % 11;
+  }
+  std::vector<float> fixed(kNumNodes * kWidth);
+  katana::analytics::PullMxM<S, kWidth>(
+      transposed, weight, x.data(), fixed.data(), kWidth);
+  std::vector<float> dynamic(kNumNodes * kWidth);
+  katana::analytics::PullMxM<S>(
+      transposed, weight, x.data(), dynamic.data(), kWidth);
+  KATANA_LOG_ASSERT(fixed == dynamic);
+
+  for (size_t j = 0; j < kWidth; ++j) {
+    std::vector<float> column(kNumNodes);
+    for (size_t i = 0; i < kNumNodes; ++i) {
+      column[i] = x[i * kWidth + j];
+    }
+    std::vector<float> expected = SerialVxM<S>(pg->topology(), weight, column);
+    for (size_t i = 0; i < kNumNodes; ++i) {
+      // small integers add up exactly in any order
+      KATANA_LOG_ASSERT(fixed[i * kWidth + j] == expected[i]);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  TestVxM(pg.get());
+  TestMask(pg.get());
+  TestMxM(pg.get());
+
+  return 0;
+}
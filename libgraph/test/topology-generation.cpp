@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+bool
+SameTopology(const katana::GraphTopology& a, const katana::GraphTopology& b) {
+  return a.NumNodes() == b.NumNodes() && a.NumEdges() == b.NumEdges() &&
+         std::equal(a.AdjData(), a.AdjData() + a.NumNodes(), b.AdjData()) &&
+         std::equal(a.DestData(), a.DestData() + a.NumEdges(), b.DestData());
+}
+
+/// \returns the topology made by generate with one thread, after checking
+/// that many threads make the same one
+template <typename Generate>
+auto
+MakeDeterministic(Generate generate) {
+  auto many = generate();
+  KATANA_LOG_VASSERT(many, "{}", many.error());
+  int threads = katana::getActiveThreads();
+  katana::setActiveThreads(1);
+  auto one = generate();
+  katana::setActiveThreads(threads);
+  KATANA_LOG_VASSERT(one, "{}", one.error());
+  return std::move(one.value());
+}
+
+std::vector<uint64_t>
+InDegrees(const katana::GraphTopology& topo) {
+  std::vector<uint64_t> degrees(topo.NumNodes());
+  for (Node n : topo.Nodes()) {
+    for (auto e : topo.OutEdges(n)) {
+      degrees[topo.OutEdgeDst(e)] += 1;
+    }
+  }
+  return degrees;
+}
+
+void
+TestRMAT() {
+  katana::RMATOptions options;
+  options.scale = 10;
+  options.edge_factor = 8;
+  options.seed = 7;
+
+  auto generate = [&]() { return katana::MakeRMATTopology(options); };
+  katana::GraphTopology topo = MakeDeterministic(generate);
+  auto again = generate();
+  KATANA_LOG_ASSERT(again && SameTopology(topo, again.value()));
+
+  KATANA_LOG_ASSERT(topo.NumNodes() == 1024);
+  KATANA_LOG_ASSERT(topo.NumEdges() == 8 * 1024);
+  uint64_t max_degree = 0;
+  for (Node n : topo.Nodes()) {
+    auto edges = topo.OutEdges(n);
+    max_degree = std::max<uint64_t>(max_degree, edges.size());
+    KATANA_LOG_ASSERT(std::is_sorted(
+        topo.DestData() + *edges.begin(), topo.DestData() + *edges.end()));
+    for (auto e : edges) {
+      KATANA_LOG_ASSERT(topo.OutEdgeDst(e) < topo.NumNodes());
+    }
+  }
+  // R-MAT degrees are skewed
+  KATANA_LOG_VASSERT(max_degree > 8 * 8, "max degree {}", max_degree);
+
+  options.seed = 8;
+  auto other = katana::MakeRMATTopology(options);
+  KATANA_LOG_ASSERT(other && !SameTopology(topo, other.value()));
+
+  options.a = 0.9;
+  KATANA_LOG_ASSERT(!katana::MakeRMATTopology(options));
+}
+
+void
+TestBarabasiAlbert() {
+  katana::BarabasiAlbertOptions options;
+  options.num_nodes = 2000;
+  options.edges_per_node = 4;
+
+  katana::GraphTopology topo = MakeDeterministic(
+      [&]() { return katana::MakeBarabasiAlbertTopology(options); });
+  KATANA_LOG_ASSERT(topo.NumNodes() == 2000);
+  KATANA_LOG_ASSERT(topo.NumEdges() == 1999 * 4);
+  KATANA_LOG_ASSERT(topo.OutEdges(0).size() == 0);
+  for (Node n = 1; n < topo.NumNodes(); ++n) {
+    KATANA_LOG_ASSERT(topo.OutEdges(n).size() == 4);
+    for (auto e : topo.OutEdges(n)) {
+      KATANA_LOG_ASSERT(topo.OutEdgeDst(e) <= n);
+    }
+  }
+
+  // early nodes attract more edges than late ones
+  std::vector<uint64_t> degrees = InDegrees(topo);
+  uint64_t early = 0;
+  uint64_t late = 0;
+  for (Node n = 0; n < 100; ++n) {
+    early += degrees[n];
+    late += degrees[topo.NumNodes() - 1 - n];
+  }
+  KATANA_LOG_VASSERT(early > 10 * late, "{} vs {}", early, late);
+
+  options.num_nodes = 0;
+  auto empty = katana::MakeBarabasiAlbertTopology(options);
+  KATANA_LOG_ASSERT(empty && empty.value().NumNodes() == 0);
+}
+
+void
+TestLFR() {
+  katana::LFROptions options;
+  options.num_nodes = 5000;
+  options.mixing = 0.2;
+
+  katana::LFRTopology lfr =
+      MakeDeterministic([&]() { return katana::MakeLFRTopology(options); });
+  const katana::GraphTopology& topo = lfr.topology;
+  KATANA_LOG_ASSERT(topo.NumNodes() == 5000);
+  KATANA_LOG_ASSERT(lfr.communities.size() == 5000);
+
+  uint64_t internal = 0;
+  for (Node n : topo.Nodes()) {
+    auto degree = topo.OutEdges(n).size();
+    KATANA_LOG_ASSERT(
+        degree >= options.min_degree && degree <= options.max_degree);
+    if (n > 0) {
+      // communities are consecutive
+      KATANA_LOG_ASSERT(
+          lfr.communities[n] == lfr.communities[n - 1] ||
+          lfr.communities[n] == lfr.communities[n - 1] + 1);
+    }
+    for (auto e : topo.OutEdges(n)) {
+      if (lfr.communities[topo.OutEdgeDst(e)] == lfr.communities[n]) {
+        internal += 1;
+      }
+    }
+  }
+  double mixing = 1.0 - static_cast<double>(internal) / topo.NumEdges();
+  KATANA_LOG_VASSERT(std::abs(mixing - 0.2) < 0.05, "mixing {}", mixing);
+
+  options.mixing = 2;
+  KATANA_LOG_ASSERT(!katana::MakeLFRTopology(options));
+}
+
+void
+TestRandomProperties() {
+  katana::RMATOptions options;
+  options.scale = 8;
+  auto res =
+      katana::PropertyGraph::Make(katana::MakeRMATTopology(options).value());
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+
+  katana::TxnContext txn_ctx;
+  auto added = katana::AddNodeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "age", katana::RandomPropertyValues<int32_t>(1, -5, 5)));
+  KATANA_LOG_VASSERT(added, "{}", added.error());
+  added = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "weight", katana::RandomPropertyValues<double>(2, 0, 1)));
+  KATANA_LOG_VASSERT(added, "{}", added.error());
+
+  auto ages = std::static_pointer_cast<arrow::Int32Array>(
+      pg->GetNodeProperty("age").value()->chunk(0));
+  katana::RandomPropertyValues<int32_t> age_values(1, -5, 5);
+  for (Node n : pg->Nodes()) {
+    KATANA_LOG_ASSERT(ages->Value(n) >= -5 && ages->Value(n) <= 5);
+    KATANA_LOG_ASSERT(ages->Value(n) == age_values(n));
+  }
+  auto weights = std::static_pointer_cast<arrow::DoubleArray>(
+      pg->GetEdgeProperty("weight").value()->chunk(0));
+  KATANA_LOG_ASSERT(static_cast<uint64_t>(weights->length()) == pg->NumEdges());
+  for (int64_t e = 0; e < weights->length(); ++e) {
+    KATANA_LOG_ASSERT(weights->Value(e) >= 0 && weights->Value(e) < 1);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestRMAT();
+  TestBarabasiAlbert();
+  TestLFR();
+  TestRandomProperties();
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct Centrality : public katana::PODProperty<float> {};
+using Graph = katana::TypedPropertyGraph<std::tuple<Centrality>, std::tuple<>>;
+
+std::vector<float>
+ReadCentrality(katana::PropertyGraph* pg, const std::string& property_name) {
+  auto graph_result = Graph::Make(pg, {property_name}, {});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = graph_result.value();
+  std::vector<float> ret;
+  for (auto n : graph) {
+    ret.emplace_back(graph.GetData<Centrality>(n));
+  }
+  return ret;
+}
+
+void
+CheckEstimate(
+    const std::vector<float>& exact, const std::vector<float>& estimate,
+    double max_error) {
+  double n = exact.size();
+  for (size_t i = 0; i < exact.size(); ++i) {
+    double error = std::abs(estimate[i] - exact[i]) / ((n - 1) * (n - 2));
+    KATANA_LOG_VASSERT(
+        error <= max_error, "Node {}: estimated {}, exact {}", i, estimate[i],
+        exact[i]);
+  }
+}
+
+/// Check that the per-source plans agree with the outer plan on pg
+void
+CheckPlans(katana::PropertyGraph* pg, katana::TxnContext* txn_ctx) {
+  KATANA_LOG_ASSERT(BetweennessCentrality(
+      pg, "outer", txn_ctx, kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Outer()));
+  std::vector<float> outer = ReadCentrality(pg, "outer");
+
+  for (auto [name, plan] :
+       {std::make_pair("level", BetweennessCentralityPlan::Level()),
+        std::make_pair("async", BetweennessCentralityPlan::Asynchronous())}) {
+    auto res = BetweennessCentrality(
+        pg, name, txn_ctx, kBetweennessCentralityAllNodes, plan);
+    KATANA_LOG_VASSERT(res, "{} failed: {}", name, res.error());
+    std::vector<float> centrality = ReadCentrality(pg, name);
+    for (size_t i = 0; i < outer.size(); ++i) {
+      KATANA_LOG_VASSERT(
+          std::abs(centrality[i] - outer[i]) <= 1e-3 * std::max(outer[i], 1.f),
+          "{} node {}: {}, outer {}", name, i, centrality[i], outer[i]);
+    }
+  }
+
+  // a subset of sources
+  KATANA_LOG_ASSERT(BetweennessCentrality(
+      pg, "level-subset", txn_ctx, std::vector<uint32_t>{0, 3, 7},
+      BetweennessCentralityPlan::Level()));
+  KATANA_LOG_ASSERT(BetweennessCentrality(
+      pg, "async-subset", txn_ctx, std::vector<uint32_t>{0, 3, 7},
+      BetweennessCentralityPlan::Asynchronous()));
+  CheckEstimate(
+      ReadCentrality(pg, "level-subset"), ReadCentrality(pg, "async-subset"),
+      1e-5);
+  KATANA_LOG_ASSERT(!BetweennessCentrality(
+      pg, "async-bad", txn_ctx, std::vector<uint32_t>{0, 1u << 30},
+      BetweennessCentralityPlan::Asynchronous()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+  katana::TxnContext txn_ctx;
+
+  auto pg = katana::MakeGrid(5, 5, false);
+  KATANA_LOG_ASSERT(BetweennessCentrality(
+      pg.get(), "exact", &txn_ctx, kBetweennessCentralityAllNodes,
+      BetweennessCentralityPlan::Outer()));
+  std::vector<float> exact = ReadCentrality(pg.get(), "exact");
+
+  CheckPlans(katana::MakeGrid(5, 5, true).get(), &txn_ctx);
+  // long and thin, so the shortest path DAGs have many levels
+  CheckPlans(katana::MakeGrid(2, 100, false).get(), &txn_ctx);
+
+  BetweennessCentralitySampling sampling;
+  sampling.max_error = 0.02;
+  auto uniform =
+      ApproximateBetweennessCentrality(pg.get(), "uniform", &txn_ctx, sampling);
+  KATANA_LOG_VASSERT(uniform, "Uniform sampling failed: {}", uniform.error());
+  KATANA_LOG_ASSERT(uniform.value().num_sources > 0);
+  KATANA_LOG_ASSERT(uniform.value().max_error <= sampling.max_error);
+  std::vector<float> uniform_estimate = ReadCentrality(pg.get(), "uniform");
+  CheckEstimate(exact, uniform_estimate, sampling.max_error);
+
+  sampling.distribution = BetweennessCentralitySampling::kDegree;
+  auto degree =
+      ApproximateBetweennessCentrality(pg.get(), "degree", &txn_ctx, sampling);
+  KATANA_LOG_VASSERT(degree, "Degree sampling failed: {}", degree.error());
+  CheckEstimate(exact, ReadCentrality(pg.get(), "degree"), sampling.max_error);
+
+  // equal weights give the same paths, and the same draws, as no weights
+  sampling.distribution = BetweennessCentralitySampling::kUniform;
+  KATANA_LOG_ASSERT(
+      AddDefaultEdgeWeight<uint32_t>(pg.get(), "weight", 3, &txn_ctx));
+  auto weighted = ApproximateBetweennessCentrality(
+      pg.get(), "weighted", &txn_ctx, sampling, "weight");
+  KATANA_LOG_VASSERT(
+      weighted, "Weighted sampling failed: {}", weighted.error());
+  KATANA_LOG_ASSERT(
+      weighted.value().num_sources == uniform.value().num_sources);
+  CheckEstimate(uniform_estimate, ReadCentrality(pg.get(), "weighted"), 1e-5);
+
+  KATANA_LOG_ASSERT(
+      AddDefaultEdgeWeight<int32_t>(pg.get(), "zero", 0, &txn_ctx));
+  KATANA_LOG_ASSERT(!ApproximateBetweennessCentrality(
+      pg.get(), "bad", &txn_ctx, sampling, "zero"));
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+using namespace katana::analytics;
+
+enum Side { kLeft, kRight, kOther };
+
+/// Make a property graph from topology, with node types "left", "right" and
+/// "other" given by sides
+std::unique_ptr<katana::PropertyGraph>
+MakeTypedGraph(katana::GraphTopology&& topo, const std::vector<Side>& sides) {
+  katana::EntityTypeManager node_types;
+  katana::EntityTypeID type_ids[3];
+  const char* names[] = {"left", "right", "other"};
+  for (size_t i = 0; i < 3; ++i) {
+    auto r = node_types.AddAtomicEntityType(names[i]);
+    KATANA_LOG_VASSERT(r, "failed to add node type: {}", r.error());
+    type_ids[i] = r.value();
+  }
+
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(topo.NumNodes());
+  for (size_t n = 0; n < topo.NumNodes(); ++n) {
+    node_type_ids[n] = type_ids[sides[n]];
+  }
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateInterleaved(topo.NumEdges());
+  std::fill(
+      edge_type_ids.begin(), edge_type_ids.end(), katana::kUnknownEntityType);
+
+  auto r = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_type_ids), std::move(edge_type_ids),
+      std::move(node_types), katana::EntityTypeManager{});
+  KATANA_LOG_VASSERT(r, "failed to make graph: {}", r.error());
+  return std::move(r.value());
+}
+
+/// Every plan finds a matching of the given size
+void
+CheckAllPlans(
+    katana::PropertyGraph* pg, const std::string& name,
+    uint64_t expected_matched) {
+  for (const auto& plan :
+       {BipartiteMatchingPlan::PothenFan(),
+        BipartiteMatchingPlan::PushRelabel()}) {
+    std::string plan_name = name + "-" + std::to_string(plan.algorithm());
+
+    katana::TxnContext txn_ctx;
+    auto r = BipartiteMatching(pg, "left", "right", plan_name, &txn_ctx, plan);
+    KATANA_LOG_VASSERT(r, "BipartiteMatching failed: {}", r.error());
+
+    auto valid = BipartiteMatchingAssertValid(pg, "left", "right", plan_name);
+    KATANA_LOG_VASSERT(valid, "{} is not a maximum matching", plan_name);
+
+    auto stats_result =
+        BipartiteMatchingStatistics::Compute(pg, "left", "right", plan_name);
+    KATANA_LOG_VASSERT(
+        stats_result, "Failed to compute matching statistics: {}",
+        stats_result.error());
+    auto stats = stats_result.value();
+    KATANA_LOG_VASSERT(
+        stats.num_matched == expected_matched, "{} matches {}, want {}",
+        plan_name, stats.num_matched, expected_matched);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  // a grid colored like a checkerboard has a perfect matching
+  size_t width = 30;
+  auto grid = katana::MakeGrid(width, width, false);
+  std::vector<Side> grid_sides(grid->NumNodes());
+  for (size_t n = 0; n < grid_sides.size(); ++n) {
+    grid_sides[n] = (n % width + n / width) % 2 == 0 ? kLeft : kRight;
+  }
+  auto checkerboard = MakeTypedGraph(
+      katana::GraphTopology::Copy(grid->topology()), grid_sides);
+  CheckAllPlans(checkerboard.get(), "checkerboard", width * width / 2);
+
+  // left node i has edges from right nodes i and up, so the only perfect
+  // matching pairs left and right node i; the edges from the other nodes are
+  // ignored
+  size_t n = 200;
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(3 * n);
+  std::vector<Side> staircase_sides(3 * n);
+  for (size_t i = 0; i < n; ++i) {
+    staircase_sides[i] = kLeft;
+    staircase_sides[n + i] = kRight;
+    staircase_sides[2 * n + i] = kOther;
+    for (size_t j = i; j < n; ++j) {
+      builder.AddEdge(n + j, i);
+    }
+    builder.AddEdge(2 * n + i, i);
+  }
+  auto staircase = MakeTypedGraph(builder.ConvertToCSR(), staircase_sides);
+  CheckAllPlans(staircase.get(), "staircase", n);
+
+  // more left nodes than right ones
+  auto clique = katana::MakeClique(50);
+  std::vector<Side> clique_sides(50, kLeft);
+  for (size_t i = 0; i < 10; ++i) {
+    clique_sides[i * 5] = kRight;
+  }
+  auto unbalanced = MakeTypedGraph(
+      katana::GraphTopology::Copy(clique->topology()), clique_sides);
+  CheckAllPlans(unbalanced.get(), "unbalanced", 10);
+
+  katana::TxnContext txn_ctx;
+  auto same =
+      BipartiteMatching(unbalanced.get(), "left", "left", "same", &txn_ctx);
+  KATANA_LOG_ASSERT(!same);
+
+  return 0;
+}
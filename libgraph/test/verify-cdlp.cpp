@@ -1,5 +1,8 @@
+#include <numeric>
+
 #include "katana/SharedMemSys.h"
 #include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/cdlp/cdlp.h"
 
 using namespace katana::analytics;
@@ -50,6 +53,39 @@ RunCdlp(
       cdlp_expected_statistics.largest_community_ratio);
 }
 
+void
+RunSeededCdlp(std::unique_ptr<katana::PropertyGraph>&& pg) noexcept {
+  struct FullCommunity : public katana::PODProperty<uint64_t> {};
+  struct SeededCommunity : public katana::PODProperty<uint64_t> {};
+  using Graph = katana::TypedPropertyGraph<
+      std::tuple<FullCommunity, SeededCommunity>, std::tuple<>>;
+
+  katana::TxnContext txn_ctx;
+  auto full = Cdlp(pg.get(), "full", 10, &txn_ctx, true);
+  KATANA_LOG_VASSERT(full, "CDLP failed and returned error {}", full.error());
+
+  // Starting from converged labels, revisiting every node changes nothing
+  CommunitySeed seed{"full", std::vector<uint32_t>(pg->NumNodes())};
+  std::iota(seed.changed_nodes.begin(), seed.changed_nodes.end(), 0);
+  auto seeded = Cdlp(pg.get(), "seeded", seed, 10, &txn_ctx, true);
+  KATANA_LOG_VASSERT(
+      seeded, "seeded CDLP failed and returned error {}", seeded.error());
+
+  auto graph_result = Graph::Make(pg.get(), {"full", "seeded"}, {});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = graph_result.value();
+  for (auto n : graph) {
+    KATANA_LOG_VASSERT(
+        graph.GetData<FullCommunity>(n) == graph.GetData<SeededCommunity>(n),
+        "node {} has label {} when seeded and {} from scratch", n,
+        graph.GetData<SeededCommunity>(n), graph.GetData<FullCommunity>(n));
+  }
+
+  CommunitySeed missing{"no_such_property", {}};
+  auto missing_result = Cdlp(pg.get(), "missing", missing, 10, &txn_ctx, true);
+  KATANA_LOG_ASSERT(!missing_result);
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -64,5 +100,13 @@ main() {
   // Triangular array tests
   RunCdlp(katana::MakeTriangle(1), true, CdlpStatistics{1, 1, 3, 1});
 
+  // Every node of a clique first takes the smallest label of the others and
+  // then the label of the majority. The nodes of the larger clique have
+  // enough neighbors to count labels in a table rather than sorting them.
+  RunCdlp(katana::MakeClique(100), true, CdlpStatistics{1, 1, 100, 1});
+  RunCdlp(katana::MakeClique(1000), true, CdlpStatistics{1, 1, 1000, 1});
+
+  RunSeededCdlp(katana::MakeGrid(4, 4, true));
+
   return 0;
 }
@@ -0,0 +1,140 @@
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr size_t kNumNodes = 300;
+
+/// Nodes 0, 3, 6, ... and nodes 1, 4, 7, ... make two paths of 100 nodes;
+/// the other 100 nodes are alone
+std::unique_ptr<katana::PropertyGraph>
+MakeTwoPaths() {
+  katana::SymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  for (uint32_t n = 0; n + 3 < kNumNodes; ++n) {
+    if (n % 3 != 2) {
+      builder.AddEdge(n, n + 3);
+    }
+  }
+  auto res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_ASSERT(res);
+  return std::move(res.value());
+}
+
+void
+CheckPlan(const ConnectedComponentsPlan& plan, const std::string& name) {
+  struct Component : public katana::PODProperty<uint64_t> {};
+  using Graph = katana::TypedPropertyGraph<std::tuple<Component>, std::tuple<>>;
+
+  auto pg = MakeTwoPaths();
+  katana::TxnContext txn_ctx;
+  auto r = ConnectedComponents(pg.get(), "component", &txn_ctx, true, plan);
+  KATANA_LOG_VASSERT(r, "{}: ConnectedComponents failed: {}", name, r.error());
+  KATANA_LOG_ASSERT(ConnectedComponentsAssertValid(pg.get(), "component"));
+
+  auto graph_result = Graph::Make(pg.get(), {"component"}, {});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = graph_result.value();
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    uint64_t id = graph.GetData<Component>(n);
+    KATANA_LOG_VASSERT(
+        id < kNumNodes, "{}: node {} has id {}, which is not dense", name, n,
+        id);
+    bool same = graph.GetData<Component>(n % 3) == id;
+    KATANA_LOG_VASSERT(
+        same == (n < 3 || n % 3 != 2), "{}: node {} is misplaced", name, n);
+  }
+
+  auto sizes_result = ConnectedComponentSizes(pg.get(), "component");
+  KATANA_LOG_VASSERT(
+      sizes_result, "{}: ConnectedComponentSizes failed: {}", name,
+      sizes_result.error());
+  std::shared_ptr<arrow::Table> sizes = sizes_result.value();
+  KATANA_LOG_VASSERT(
+      sizes->num_rows() == 102, "{}: found {} components, expected 102",
+      name, sizes->num_rows());
+  auto counts =
+      std::static_pointer_cast<arrow::UInt64Array>(sizes->column(1)->chunk(0));
+  uint64_t total = 0;
+  uint64_t paths = 0;
+  for (int64_t i = 0; i < counts->length(); ++i) {
+    total += counts->Value(i);
+    paths += counts->Value(i) == 100;
+  }
+  KATANA_LOG_VASSERT(
+      total == kNumNodes && paths == 2, "{}: wrong component sizes", name);
+}
+
+void
+CheckIncremental() {
+  struct Component : public katana::PODProperty<uint64_t> {};
+  using Graph = katana::TypedPropertyGraph<std::tuple<Component>, std::tuple<>>;
+
+  auto pg = MakeTwoPaths();
+  katana::TxnContext txn_ctx;
+  auto r = ConnectedComponents(pg.get(), "component", &txn_ctx, true);
+  KATANA_LOG_VASSERT(r, "ConnectedComponents failed: {}", r.error());
+
+  // join the two paths and nodes 2 and 5 into one component; 0 and 3 are
+  // already in one
+  std::vector<std::pair<uint32_t, uint32_t>> added_edges = {
+      {0, 1}, {2, 5}, {2, 1}, {0, 3}};
+  r = ConnectedComponentsIncremental(
+      pg.get(), "component", added_edges, "updated", &txn_ctx);
+  KATANA_LOG_VASSERT(r, "ConnectedComponentsIncremental failed: {}", r.error());
+
+  auto graph_result = Graph::Make(pg.get(), {"updated"}, {});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = graph_result.value();
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    bool joined = n % 3 != 2 || n == 2 || n == 5;
+    bool same = graph.GetData<Component>(n) == graph.GetData<Component>(0);
+    KATANA_LOG_VASSERT(same == joined, "node {} is misplaced", n);
+  }
+
+  auto sizes_result = ConnectedComponentSizes(pg.get(), "updated");
+  KATANA_LOG_VASSERT(
+      sizes_result, "ConnectedComponentSizes failed: {}",
+      sizes_result.error());
+  KATANA_LOG_VASSERT(
+      sizes_result.value()->num_rows() == 99,
+      "found {} components, expected 99", sizes_result.value()->num_rows());
+
+  r = ConnectedComponentsIncremental(
+      pg.get(), "updated", {{0, static_cast<uint32_t>(kNumNodes)}}, "invalid",
+      &txn_ctx);
+  KATANA_LOG_ASSERT(!r);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  CheckPlan(ConnectedComponentsPlan::Serial(), "Serial");
+  CheckPlan(ConnectedComponentsPlan::LabelProp(), "LabelProp");
+  CheckPlan(ConnectedComponentsPlan::Synchronous(), "Synchronous");
+  CheckPlan(ConnectedComponentsPlan::Asynchronous(), "Asynchronous");
+  CheckPlan(ConnectedComponentsPlan::EdgeAsynchronous(), "EdgeAsynchronous");
+  CheckPlan(
+      ConnectedComponentsPlan::EdgeTiledAsynchronous(4),
+      "EdgeTiledAsynchronous");
+  CheckPlan(
+      ConnectedComponentsPlan::BlockedAsynchronous(), "BlockedAsynchronous");
+  CheckPlan(ConnectedComponentsPlan::Afforest(), "Afforest");
+  CheckPlan(ConnectedComponentsPlan::EdgeAfforest(), "EdgeAfforest");
+  CheckPlan(
+      ConnectedComponentsPlan::EdgeTiledAfforest(4), "EdgeTiledAfforest");
+  CheckIncremental();
+
+  return 0;
+}
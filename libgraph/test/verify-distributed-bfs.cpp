@@ -0,0 +1,220 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "katana/MirrorSync.h"
+#include "katana/SharedMemSys.h"
+#include "katana/SocketCommBackend.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+
+constexpr uint32_t kNumHosts = 3;
+
+uint32_t
+Owner(Node n) {
+  return n % kNumHosts;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  katana::RMATOptions options;
+  options.scale = 10;
+  options.edge_factor = 4;
+  auto topo = katana::MakeRMATTopology(options);
+  KATANA_LOG_VASSERT(topo, "{}", topo.error());
+  auto pg = katana::PropertyGraph::Make(std::move(topo.value()));
+  KATANA_LOG_VASSERT(pg, "{}", pg.error());
+  return std::move(pg.value());
+}
+
+/// The partition of host rank of a graph whose nodes are spread round robin:
+/// the nodes it owns, then mirrors of the other nodes its edges lead to
+struct Partition {
+  std::unique_ptr<katana::PropertyGraph> pg;
+  uint32_t num_owned{0};
+  /// global id of every local node
+  std::vector<Node> global_ids;
+  std::vector<std::vector<uint32_t>> masters;
+  std::vector<std::vector<uint32_t>> mirrors;
+};
+
+Partition
+MakePartition(const katana::PropertyGraph& global, uint32_t rank) {
+  const auto& topo = global.topology();
+
+  // mirrored_by[h] holds the nodes that host h has a mirror of
+  std::vector<std::vector<Node>> mirrored_by(kNumHosts);
+  for (Node src : topo.Nodes()) {
+    for (auto e : topo.OutEdges(src)) {
+      Node dst = topo.OutEdgeDst(e);
+      if (Owner(dst) != Owner(src)) {
+        mirrored_by[Owner(src)].emplace_back(dst);
+      }
+    }
+  }
+  for (auto& nodes : mirrored_by) {
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  }
+
+  Partition part;
+  std::vector<uint32_t> local_ids(
+      topo.NumNodes(), std::numeric_limits<uint32_t>::max());
+  for (Node n : topo.Nodes()) {
+    if (Owner(n) == rank) {
+      local_ids[n] = part.global_ids.size();
+      part.global_ids.emplace_back(n);
+    }
+  }
+  part.num_owned = part.global_ids.size();
+  for (Node n : mirrored_by[rank]) {
+    local_ids[n] = part.global_ids.size();
+    part.global_ids.emplace_back(n);
+  }
+
+  // Both sides list the nodes a pair of hosts shares by global id, so the
+  // lists of the two hosts are in the same order
+  part.masters.resize(kNumHosts);
+  part.mirrors.resize(kNumHosts);
+  for (uint32_t host = 0; host < kNumHosts; ++host) {
+    if (host == rank) {
+      continue;
+    }
+    for (Node n : mirrored_by[host]) {
+      if (Owner(n) == rank) {
+        part.masters[host].emplace_back(local_ids[n]);
+      }
+    }
+    for (Node n : mirrored_by[rank]) {
+      if (Owner(n) == host) {
+        part.mirrors[host].emplace_back(local_ids[n]);
+      }
+    }
+  }
+
+  katana::TopologyBuilderImpl<false, true> builder;
+  builder.AddNodes(part.global_ids.size());
+  for (uint32_t local = 0; local < part.num_owned; ++local) {
+    Node src = part.global_ids[local];
+    for (auto e : topo.OutEdges(src)) {
+      builder.AddEdge(local, local_ids[topo.OutEdgeDst(e)]);
+    }
+  }
+  auto pg = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_VASSERT(pg, "{}", pg.error());
+  part.pg = std::move(pg.value());
+  return part;
+}
+
+/// The node with the most out-edges, which reaches much of the graph
+Node
+PickSource(const katana::PropertyGraph& global) {
+  const auto& topo = global.topology();
+  Node source = 0;
+  for (Node n : topo.Nodes()) {
+    if (topo.OutDegree(n) > topo.OutDegree(source)) {
+      source = n;
+    }
+  }
+  return source;
+}
+
+void
+RunHost(
+    uint32_t rank, const std::vector<std::string>& addresses,
+    katana::SocketListener listener) {
+  katana::SharedMemSys sys;
+  katana::TxnContext txn_ctx;
+
+  auto global = MakeGraph();
+  Node source = PickSource(*global);
+  auto ref_res = MultiSourceBfs(global.get(), {source}, {"level"}, &txn_ctx);
+  KATANA_LOG_VASSERT(ref_res, "{}", ref_res.error());
+  auto expected_res = global->GetNodePropertyTyped<uint32_t>("level");
+  KATANA_LOG_VASSERT(expected_res, "{}", expected_res.error());
+  const auto& expected = *expected_res.value();
+
+  Partition part = MakePartition(*global, rank);
+  auto comm_res =
+      katana::SocketCommBackend::Make(addresses, rank, std::move(listener));
+  KATANA_LOG_VASSERT(comm_res, "host {}: {}", rank, comm_res.error());
+  auto comm = std::move(comm_res.value());
+  katana::MirrorSync sync(
+      comm.get(), std::move(part.masters), std::move(part.mirrors));
+
+  // owned nodes are numbered in order, so node n is the n / kNumHosts-th
+  uint32_t start =
+      Owner(source) == rank ? source / kNumHosts : kDistributedBfsNoSource;
+  auto res = DistributedBfs(
+      part.pg.get(), &sync, part.num_owned, start, "level", &txn_ctx);
+  KATANA_LOG_VASSERT(res, "host {}: {}", rank, res.error());
+
+  auto levels_res = part.pg->GetNodePropertyTyped<uint32_t>("level");
+  KATANA_LOG_VASSERT(levels_res, "{}", levels_res.error());
+  const auto& levels = *levels_res.value();
+  for (uint32_t local = 0; local < part.global_ids.size(); ++local) {
+    Node n = part.global_ids[local];
+    KATANA_LOG_VASSERT(
+        levels.Value(local) == expected.Value(n),
+        "host {}: node {} has level {}, expected {}", rank, n,
+        levels.Value(local), expected.Value(n));
+  }
+
+  // Every host claiming a source fails on all of them
+  KATANA_LOG_ASSERT(part.num_owned > 0);
+  KATANA_LOG_ASSERT(!DistributedBfs(
+      part.pg.get(), &sync, part.num_owned, 0, "level-2", &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  std::vector<katana::SocketListener> listeners;
+  std::vector<std::string> addresses;
+  for (uint32_t rank = 0; rank < kNumHosts; ++rank) {
+    auto listener_res = katana::SocketListener::Make("127.0.0.1:0");
+    KATANA_LOG_VASSERT(listener_res, "{}", listener_res.error());
+    addresses.emplace_back(
+        fmt::format("127.0.0.1:{}", listener_res.value().port()));
+    listeners.emplace_back(std::move(listener_res.value()));
+  }
+
+  // Hosts are processes, each with its own runtime, that talk over loopback
+  std::vector<pid_t> hosts;
+  for (uint32_t rank = 0; rank < kNumHosts; ++rank) {
+    pid_t pid = fork();
+    KATANA_LOG_ASSERT(pid >= 0);
+    if (pid == 0) {
+      katana::SocketListener listener = std::move(listeners[rank]);
+      listeners.clear();
+      RunHost(rank, addresses, std::move(listener));
+      _exit(0);
+    }
+    hosts.emplace_back(pid);
+  }
+  listeners.clear();
+
+  for (uint32_t rank = 0; rank < kNumHosts; ++rank) {
+    int status = 0;
+    KATANA_LOG_ASSERT(waitpid(hosts[rank], &status, 0) == hosts[rank]);
+    KATANA_LOG_VASSERT(
+        WIFEXITED(status) && WEXITSTATUS(status) == 0,
+        "host {} failed with status {}", rank, status);
+  }
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+using Edge = katana::PropertyGraph::Edge;
+using Node = katana::PropertyGraph::Node;
+
+namespace {
+
+constexpr size_t kWidth = 20;
+constexpr int64_t kUnreachable = -1;
+const char* kTypeNames[] = {"road", "rail", "ferry"};
+
+/// A grid whose edges are roads, rails and ferries in turn, with weights
+/// from 1 to 10
+std::unique_ptr<katana::PropertyGraph>
+MakeTypedGrid() {
+  auto grid = katana::MakeGrid(kWidth, kWidth, false);
+  katana::GraphTopology topo = katana::GraphTopology::Copy(grid->topology());
+
+  katana::EntityTypeManager edge_types;
+  katana::EntityTypeID type_ids[3];
+  for (size_t i = 0; i < 3; ++i) {
+    auto r = edge_types.AddAtomicEntityType(kTypeNames[i]);
+    KATANA_LOG_VASSERT(r, "failed to add edge type: {}", r.error());
+    type_ids[i] = r.value();
+  }
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(topo.NumNodes());
+  std::fill(
+      node_type_ids.begin(), node_type_ids.end(), katana::kUnknownEntityType);
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateInterleaved(topo.NumEdges());
+  for (size_t e = 0; e < topo.NumEdges(); ++e) {
+    edge_type_ids[e] = type_ids[e % 3];
+  }
+
+  auto r = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_type_ids), std::move(edge_type_ids),
+      katana::EntityTypeManager{}, std::move(edge_types));
+  KATANA_LOG_VASSERT(r, "failed to make graph: {}", r.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(r.value());
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("weight", [&pg](Edge e) {
+        int64_t src = pg->topology().GetEdgeSrc(e);
+        int64_t dst = pg->topology().OutEdgeDst(e);
+        return (src * 7 + dst * 13) % 10 + 1;
+      }));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  return pg;
+}
+
+/// Dijkstra over the edges of the named types, with unit weights if
+/// weighted is false
+std::vector<int64_t>
+Distances(
+    const katana::PropertyGraph& pg, Node source,
+    const std::vector<std::string>& names, bool weighted) {
+  auto weights = pg.GetEdgePropertyTyped<int64_t>("weight").value();
+  const katana::GraphTopology& topo = pg.topology();
+  auto follow = [&](Edge e) {
+    std::optional<std::string> name =
+        pg.GetEdgeAtomicTypeName(pg.GetTypeOfEdgeFromTopoIndex(e));
+    return names.empty() ||
+           std::find(names.begin(), names.end(), *name) != names.end();
+  };
+
+  std::vector<int64_t> dist(topo.NumNodes(), kUnreachable);
+  using Item = std::pair<int64_t, Node>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  dist[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty()) {
+    auto [d, n] = queue.top();
+    queue.pop();
+    if (d > dist[n]) {
+      continue;
+    }
+    for (Edge e : topo.OutEdges(n)) {
+      if (!follow(e)) {
+        continue;
+      }
+      Node dst = topo.OutEdgeDst(e);
+      int64_t w =
+          weighted ? weights->Value(topo.GetEdgePropertyIndexFromOutEdge(e))
+                   : 1;
+      if (dist[dst] == kUnreachable || d + w < dist[dst]) {
+        dist[dst] = d + w;
+        queue.emplace(d + w, dst);
+      }
+    }
+  }
+  return dist;
+}
+
+/// The parent of every reached node is one level closer to the source
+void
+CheckBfs(
+    katana::PropertyGraph* pg, Node source,
+    const std::vector<std::string>& names, const std::string& output) {
+  std::vector<int64_t> levels = Distances(*pg, source, names, false);
+
+  katana::TxnContext txn_ctx;
+  auto res = BfsByEdgeType(pg, source, names, output, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "BfsByEdgeType failed: {}", res.error());
+
+  auto parents = pg->GetNodePropertyTyped<uint32_t>(output).value();
+  for (Node n = 0; n < pg->NumNodes(); ++n) {
+    uint32_t parent = parents->Value(n);
+    if (levels[n] == kUnreachable) {
+      KATANA_LOG_VASSERT(
+          parent == std::numeric_limits<uint32_t>::max() / 4,
+          "{} is unreachable but has parent {}", n, parent);
+    } else if (n == source) {
+      KATANA_LOG_ASSERT(parent == source);
+    } else {
+      KATANA_LOG_VASSERT(
+          levels[parent] + 1 == levels[n], "node {} at level {}, parent {}",
+          n, levels[n], parent);
+    }
+  }
+}
+
+void
+CheckSssp(
+    katana::PropertyGraph* pg, Node source,
+    const std::vector<std::string>& names, const std::string& output) {
+  std::vector<int64_t> expected = Distances(*pg, source, names, true);
+
+  katana::TxnContext txn_ctx;
+  auto res = SsspByEdgeType(pg, source, names, "weight", output, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "SsspByEdgeType failed: {}", res.error());
+
+  auto dists = pg->GetNodePropertyTyped<int64_t>(output).value();
+  for (Node n = 0; n < pg->NumNodes(); ++n) {
+    int64_t dist = dists->Value(n);
+    if (expected[n] == kUnreachable) {
+      KATANA_LOG_VASSERT(
+          dist == std::numeric_limits<int64_t>::max() / 4,
+          "{} is unreachable but at {}", n, dist);
+    } else {
+      KATANA_LOG_VASSERT(
+          dist == expected[n], "node {} at {}, want {}", n, dist,
+          expected[n]);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto pg = MakeTypedGrid();
+  Node source = kWidth * kWidth / 2 + kWidth / 2;
+
+  using Names = std::vector<std::string>;
+  size_t i = 0;
+  for (const Names& names :
+       {Names{}, Names{"road"}, Names{"road", "rail"}, Names{"ferry"}}) {
+    CheckBfs(pg.get(), source, names, "bfs-" + std::to_string(i));
+    CheckSssp(pg.get(), source, names, "sssp-" + std::to_string(i));
+    ++i;
+  }
+
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!BfsByEdgeType(
+      pg.get(), source, {"canal"}, "bfs-unknown", &txn_ctx));
+  KATANA_LOG_ASSERT(
+      !BfsByEdgeType(pg.get(), pg->NumNodes(), {}, "bfs-bad", &txn_ctx));
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cmath>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/fast_rp/fast_rp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kDimension = 64;
+
+std::shared_ptr<arrow::ChunkedArray>
+RunFastRP(
+    katana::PropertyGraph* pg, const std::string& name,
+    katana::TxnContext* txn_ctx, const FastRPPlan& plan) {
+  auto r = FastRP(pg, name, txn_ctx, plan);
+  KATANA_LOG_VASSERT(r, "FastRP failed: {}", r.error());
+  auto valid = FastRPAssertValid(pg, name);
+  KATANA_LOG_VASSERT(valid, "FastRP is not valid: {}", valid.error());
+  auto property = pg->GetNodeProperty(name);
+  KATANA_LOG_ASSERT(property);
+  return property.value();
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+  katana::TxnContext txn_ctx;
+
+  auto pg = katana::MakeGrid(6, 6, true);
+  std::vector<double> weights{0.0, 1.0, 0.5};
+  auto plan = FastRPPlan::VerySparseProjection(kDimension, weights);
+
+  auto first = RunFastRP(pg.get(), "first", &txn_ctx, plan);
+  KATANA_LOG_ASSERT(first->type()->Equals(
+      arrow::fixed_size_binary(kDimension * sizeof(float))));
+
+  // the same seed gives the same embeddings
+  auto second = RunFastRP(pg.get(), "second", &txn_ctx, plan);
+  KATANA_LOG_ASSERT(first->Equals(*second));
+
+  auto stats_result = FastRPStatistics::Compute(pg.get(), "first");
+  KATANA_LOG_VASSERT(
+      stats_result, "Failed to compute FastRP statistics: {}",
+      stats_result.error());
+  FastRPStatistics stats = stats_result.value();
+  KATANA_LOG_ASSERT(stats.embedding_dimension == kDimension);
+  // every hop is normalized, so embeddings are no longer than the sum of
+  // the weights
+  KATANA_LOG_VASSERT(
+      stats.mean_norm > 0 && stats.mean_norm <= 1.5 + 1e-4,
+      "Mean norm {} out of range", stats.mean_norm);
+  KATANA_LOG_ASSERT(stats.zero_embeddings == 0);
+
+  // widths without a specialized loop
+  auto odd = RunFastRP(
+      pg.get(), "odd", &txn_ctx, FastRPPlan::VerySparseProjection(17));
+  KATANA_LOG_ASSERT(odd->type()->Equals(arrow::fixed_size_binary(17 * 4)));
+
+  KATANA_LOG_ASSERT(!FastRP(
+      pg.get(), "empty", &txn_ctx,
+      FastRPPlan::VerySparseProjection(kDimension, {})));
+  KATANA_LOG_ASSERT(!FastRPAssertValid(pg.get(), "missing"));
+
+  return 0;
+}
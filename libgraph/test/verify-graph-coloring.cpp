@@ -0,0 +1,67 @@
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+using namespace katana::analytics;
+
+void
+RunGraphColoring(
+    std::unique_ptr<katana::PropertyGraph>&& pg, uint32_t min_colors) noexcept {
+  struct NodeColor : public katana::PODProperty<uint32_t> {};
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<NodeColor>, std::tuple<>>;
+
+  katana::TxnContext txn_ctx;
+  for (const auto& plan : {
+           GraphColoringPlan::JonesPlassmann(),
+           GraphColoringPlan::Speculative()}) {
+    std::string name = plan.algorithm() == GraphColoringPlan::kSpeculative
+                           ? "color-speculative"
+                           : "color-jones-plassmann";
+    auto r = GraphColoring(pg.get(), name, &txn_ctx, plan);
+    KATANA_LOG_VASSERT(r, "GraphColoring failed: {}", r.error());
+
+    auto valid = GraphColoringAssertValid(pg.get(), name);
+    KATANA_LOG_VASSERT(valid, "{} is not a valid coloring", name);
+
+    auto stats_result = GraphColoringStatistics::Compute(pg.get(), name);
+    KATANA_LOG_VASSERT(
+        stats_result, "Failed to compute coloring statistics: {}",
+        stats_result.error());
+    GraphColoringStatistics stats = stats_result.value();
+    KATANA_LOG_VASSERT(
+        stats.num_colors >= min_colors, "{} uses {} colors, need at least {}",
+        name, stats.num_colors, min_colors);
+  }
+
+  // every node has a neighbor of color 0 unless it has color 0 itself, so
+  // color 0 is a maximal independent set
+  auto graph_result = Graph::Make(pg.get(), {"color-jones-plassmann"}, {});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = graph_result.value();
+  for (auto n : graph) {
+    if (graph.GetData<NodeColor>(n) == 0) {
+      continue;
+    }
+    bool covered = false;
+    for (auto e : graph.OutEdges(n)) {
+      covered |= graph.GetData<NodeColor>(graph.OutEdgeDst(e)) == 0;
+    }
+    KATANA_LOG_VASSERT(covered, "node {} has no neighbor of color 0", n);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  RunGraphColoring(katana::MakeClique(6), 6);
+  RunGraphColoring(katana::MakeGrid(5, 7, false), 2);
+  RunGraphColoring(katana::MakeGrid(5, 7, true), 4);
+  RunGraphColoring(katana::MakeFerrisWheel(9), 3);
+  RunGraphColoring(katana::MakeSawtooth(3), 2);
+  RunGraphColoring(katana::MakeClique(300), 300);
+
+  return 0;
+}
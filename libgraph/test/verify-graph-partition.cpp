@@ -0,0 +1,72 @@
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/graph_partition/graph_partition.h"
+
+using namespace katana::analytics;
+
+GraphPartitionStatistics
+RunGraphPartition(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& name, GraphPartitionPlan plan = {}) noexcept {
+  katana::TxnContext txn_ctx;
+  auto r = GraphPartition(pg, num_partitions, name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(r, "GraphPartition failed: {}", r.error());
+
+  auto valid = GraphPartitionAssertValid(pg, num_partitions, name);
+  KATANA_LOG_VASSERT(valid, "{} is not a valid partition", name);
+
+  auto stats_result = GraphPartitionStatistics::Compute(pg, name);
+  KATANA_LOG_VASSERT(
+      stats_result, "Failed to compute partition statistics: {}",
+      stats_result.error());
+  GraphPartitionStatistics stats = stats_result.value();
+
+  // every partition gets its share of the nodes if there are enough of them
+  uint64_t average = (pg->NumNodes() + num_partitions - 1) / num_partitions;
+  uint64_t max_size =
+      average + static_cast<uint64_t>(average * plan.imbalance());
+  uint64_t want_partitions =
+      std::min<uint64_t>(num_partitions, pg->NumNodes());
+  KATANA_LOG_VASSERT(
+      stats.num_partitions == want_partitions, "{} has {} partitions, want {}",
+      name, stats.num_partitions, want_partitions);
+  KATANA_LOG_VASSERT(
+      stats.largest_partition_size <= max_size,
+      "{} has a partition of {} nodes, want at most {}", name,
+      stats.largest_partition_size, max_size);
+  return stats;
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  // a 20 x 20 grid cuts into quarters along 40 edges
+  auto grid = katana::MakeGrid(20, 20, false);
+  auto stats = RunGraphPartition(grid.get(), 4, "grid-4");
+  KATANA_LOG_VASSERT(
+      stats.edge_cut <= 80, "grid-4 cuts {} edges", stats.edge_cut);
+  stats = RunGraphPartition(grid.get(), 1, "grid-1");
+  KATANA_LOG_ASSERT(stats.edge_cut == 0);
+  // the coarser levels have weighted nodes and edges
+  stats = RunGraphPartition(
+      grid.get(), 2, "grid-2-deep", GraphPartitionPlan::Multilevel(0.05, 2));
+  KATANA_LOG_VASSERT(
+      stats.edge_cut <= 60, "grid-2-deep cuts {} edges", stats.edge_cut);
+
+  auto wheel = katana::MakeFerrisWheel(101);
+  RunGraphPartition(wheel.get(), 5, "wheel-5");
+
+  auto clique = katana::MakeClique(300);
+  RunGraphPartition(clique.get(), 3, "clique-3");
+
+  // more partitions than nodes leaves some empty
+  auto small = katana::MakeClique(6);
+  stats = RunGraphPartition(small.get(), 10, "small-10");
+  KATANA_LOG_ASSERT(stats.largest_partition_size == 1);
+
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!GraphPartition(grid.get(), 0, "grid-0", &txn_ctx));
+
+  return 0;
+}
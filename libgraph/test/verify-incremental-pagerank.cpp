@@ -0,0 +1,171 @@
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "katana/Random.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+constexpr size_t kNumNodes = 1000;
+constexpr float kTolerance = 1e-4;
+
+/// Every node gets 1 to 8 pseudo random out-edges, so no node is dangling
+katana::AsymmetricGraphTopologyBuilder
+MakeBase() {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  katana::SplitMix64 random(1);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    uint64_t degree = 1 + random() % 8;
+    for (uint64_t i = 0; i < degree; ++i) {
+      builder.AddEdge(n, random() % kNumNodes);
+    }
+  }
+  return builder;
+}
+
+/// A batch of edges from random sources into the nodes [first, first + 10),
+/// which moves rank towards them
+EdgeList
+MakeBatch(uint64_t seed, uint32_t first) {
+  katana::SplitMix64 random(seed);
+  EdgeList edges;
+  for (size_t i = 0; i < 300; ++i) {
+    edges.emplace_back(random() % kNumNodes, first + random() % 10);
+  }
+  return edges;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(
+    katana::AsymmetricGraphTopologyBuilder* builder, const EdgeList& added) {
+  for (const auto& [src, dst] : added) {
+    builder->AddEdge(src, dst);
+  }
+  auto pg = katana::PropertyGraph::Make(builder->ConvertToCSR());
+  KATANA_LOG_VASSERT(pg, "{}", pg.error());
+  return std::move(pg.value());
+}
+
+std::vector<float>
+GetRanks(katana::PropertyGraph* pg, const std::string& name) {
+  auto ranks = pg->GetNodePropertyTyped<float>(name);
+  KATANA_LOG_VASSERT(ranks, "{}", ranks.error());
+  std::vector<float> values(pg->NumNodes());
+  for (Node n = 0; n < pg->NumNodes(); ++n) {
+    values[n] = ranks.value()->Value(n);
+  }
+  return values;
+}
+
+void
+SetRanks(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::vector<float>& ranks) {
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg, &txn_ctx,
+      katana::PropertyGenerator(name, [&](Node n) { return ranks[n]; }));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+}
+
+double
+L1Distance(const std::vector<float>& a, const std::vector<float>& b) {
+  double distance = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    distance += std::fabs(a[i] - b[i]);
+  }
+  return distance;
+}
+
+/// Apply one batch incrementally to ranks and compare the result with a full
+/// computation on pg, which already has the edges of the batch. After k
+/// updates the incremental ranks are within (k + 1) * tolerance * NumNodes /
+/// (1 - alpha) of the exact ones, and the full computation is within
+/// tolerance * NumNodes / (1 - alpha) of them.
+std::vector<float>
+CheckUpdate(
+    katana::PropertyGraph* pg, const std::vector<float>& previous,
+    const EdgeList& added, size_t k, const PagerankPlan& plan) {
+  katana::TxnContext txn_ctx;
+  SetRanks(pg, "previous", previous);
+  auto res =
+      PagerankIncremental(pg, "previous", added, "incremental", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "PagerankIncremental failed: {}", res.error());
+  res = Pagerank(pg, "full", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "Pagerank failed: {}", res.error());
+
+  std::vector<float> incremental = GetRanks(pg, "incremental");
+  std::vector<float> full = GetRanks(pg, "full");
+  double unit = plan.tolerance() * pg->NumNodes() / (1 - plan.alpha());
+  double bound = (k + 1) * unit + unit;
+  double distance = L1Distance(incremental, full);
+  KATANA_LOG_VASSERT(
+      distance <= bound,
+      "after {} updates the L1 distance to a full computation is {}, more "
+      "than {}",
+      k, distance, bound);
+
+  // the batch matters: the previous ranks are further off than the bound
+  double stale = L1Distance(previous, full);
+  KATANA_LOG_VASSERT(
+      stale > bound, "previous ranks are {} from the new ones", stale);
+  return incremental;
+}
+
+void
+TestIncremental(const PagerankPlan& plan) {
+  katana::AsymmetricGraphTopologyBuilder builder = MakeBase();
+  auto base = MakeGraph(&builder, {});
+  katana::TxnContext txn_ctx;
+  auto res = Pagerank(base.get(), "rank", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "Pagerank failed: {}", res.error());
+  std::vector<float> ranks = GetRanks(base.get(), "rank");
+
+  EdgeList first = MakeBatch(2, 0);
+  auto first_graph = MakeGraph(&builder, first);
+  ranks = CheckUpdate(first_graph.get(), ranks, first, 1, plan);
+
+  EdgeList second = MakeBatch(3, 500);
+  auto second_graph = MakeGraph(&builder, second);
+  CheckUpdate(second_graph.get(), ranks, second, 2, plan);
+}
+
+/// Edges that are not in the graph are refused
+void
+TestInvalid() {
+  katana::AsymmetricGraphTopologyBuilder builder = MakeBase();
+  auto pg = MakeGraph(&builder, {});
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(Pagerank(pg.get(), "rank", &txn_ctx));
+
+  auto res = PagerankIncremental(
+      pg.get(), "rank", {{0, kNumNodes}}, "out-of-range", &txn_ctx);
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::InvalidArgument);
+
+  // node 0 has at most 8 out-edges
+  EdgeList too_many(9, {0, 1});
+  res = PagerankIncremental(pg.get(), "rank", too_many, "missing", &txn_ctx);
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::InvalidArgument);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestIncremental(PagerankPlan::PushAsynchronous(kTolerance));
+  TestIncremental(PagerankPlan::PullResidual(kTolerance));
+  TestInvalid();
+
+  return 0;
+}
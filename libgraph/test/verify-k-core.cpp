@@ -0,0 +1,62 @@
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/k_core/k_core.h"
+
+using namespace katana::analytics;
+
+void
+RunKCoreDecomposition(
+    std::unique_ptr<katana::PropertyGraph>&& pg, uint32_t expected_degeneracy,
+    uint64_t expected_max_core_nodes) noexcept {
+  katana::TxnContext txn_ctx;
+  auto r = KCoreDecomposition(pg.get(), "coreness", &txn_ctx, true);
+  KATANA_LOG_VASSERT(r, "KCoreDecomposition failed: {}", r.error());
+
+  auto stats_result =
+      KCoreDecompositionStatistics::Compute(pg.get(), "coreness");
+  KATANA_LOG_VASSERT(
+      stats_result, "Failed to compute KCore statistics: {}",
+      stats_result.error());
+  KCoreDecompositionStatistics stats = stats_result.value();
+  KATANA_LOG_VASSERT(
+      stats.degeneracy == expected_degeneracy,
+      "Wrong degeneracy. Found: {}, Expected: {}", stats.degeneracy,
+      expected_degeneracy);
+  KATANA_LOG_VASSERT(
+      stats.number_of_nodes_in_max_core == expected_max_core_nodes,
+      "Wrong size of the max core. Found: {}, Expected: {}",
+      stats.number_of_nodes_in_max_core, expected_max_core_nodes);
+
+  // the bucketed plan agrees with the synchronous one on the max core
+  for (const auto& plan : {KCorePlan::Synchronous(), KCorePlan::Bucketed()}) {
+    std::string name = plan.algorithm() == KCorePlan::kBucketed
+                           ? "in-core-bucketed"
+                           : "in-core-synchronous";
+    auto k_core =
+        KCore(pg.get(), expected_degeneracy, name, &txn_ctx, true, plan);
+    KATANA_LOG_VASSERT(k_core, "KCore failed: {}", k_core.error());
+    auto k_core_stats =
+        KCoreStatistics::Compute(pg.get(), expected_degeneracy, name);
+    KATANA_LOG_ASSERT(k_core_stats);
+    KATANA_LOG_VASSERT(
+        k_core_stats.value().number_of_nodes_in_kcore ==
+            expected_max_core_nodes,
+        "Wrong size of the k-core. Found: {}, Expected: {}",
+        k_core_stats.value().number_of_nodes_in_kcore,
+        expected_max_core_nodes);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  RunKCoreDecomposition(katana::MakeClique(6), 5, 6);
+  RunKCoreDecomposition(katana::MakeGrid(5, 7, false), 2, 35);
+  RunKCoreDecomposition(katana::MakeFerrisWheel(9), 3, 9);
+  RunKCoreDecomposition(katana::MakeSawtooth(3), 1, 7);
+  // degrees past the first open buckets
+  RunKCoreDecomposition(katana::MakeClique(300), 299, 300);
+
+  return 0;
+}
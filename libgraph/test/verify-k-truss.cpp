@@ -0,0 +1,61 @@
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/k_truss/k_truss.h"
+
+using namespace katana::analytics;
+
+void
+RunKTrussDecomposition(
+    std::unique_ptr<katana::PropertyGraph>&& pg, uint32_t expected_trussness,
+    uint64_t expected_max_truss_edges) noexcept {
+  katana::TxnContext txn_ctx;
+  auto r = KTrussDecomposition(&txn_ctx, pg.get(), "trussness");
+  KATANA_LOG_VASSERT(r, "KTrussDecomposition failed: {}", r.error());
+
+  auto stats_result =
+      KTrussDecompositionStatistics::Compute(pg.get(), "trussness");
+  KATANA_LOG_VASSERT(
+      stats_result, "Failed to compute KTruss statistics: {}",
+      stats_result.error());
+  KTrussDecompositionStatistics stats = stats_result.value();
+  KATANA_LOG_VASSERT(
+      stats.max_trussness == expected_trussness,
+      "Wrong max trussness. Found: {}, Expected: {}", stats.max_trussness,
+      expected_trussness);
+  KATANA_LOG_VASSERT(
+      stats.number_of_edges_in_max_truss == expected_max_truss_edges,
+      "Wrong size of the max truss. Found: {}, Expected: {}",
+      stats.number_of_edges_in_max_truss, expected_max_truss_edges);
+
+  if (expected_trussness <= 2) {
+    return;
+  }
+  // the bucketed plan agrees with the bulk-synchronous one on the max truss
+  for (const auto& plan : {KTrussPlan::Bsp(), KTrussPlan::Bucketed()}) {
+    std::string name = plan.algorithm() == KTrussPlan::kBucketed
+                           ? "in-truss-bucketed"
+                           : "in-truss-bsp";
+    auto k_truss = KTruss(&txn_ctx, pg.get(), expected_trussness, name, plan);
+    KATANA_LOG_VASSERT(k_truss, "KTruss failed: {}", k_truss.error());
+    auto k_truss_stats =
+        KTrussStatistics::Compute(pg.get(), expected_trussness, name);
+    KATANA_LOG_ASSERT(k_truss_stats);
+    KATANA_LOG_VASSERT(
+        k_truss_stats.value().number_of_edges_left == expected_max_truss_edges,
+        "Wrong size of the k-truss. Found: {}, Expected: {}",
+        k_truss_stats.value().number_of_edges_left, expected_max_truss_edges);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  RunKTrussDecomposition(katana::MakeClique(6), 6, 15);
+  RunKTrussDecomposition(katana::MakeGrid(5, 7, false), 2, 58);
+  RunKTrussDecomposition(katana::MakeFerrisWheel(9), 3, 16);
+  // supports past the first open buckets
+  RunKTrussDecomposition(katana::MakeClique(300), 300, 44850);
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <string>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/max_flow/max_flow.h"
+
+using namespace katana::analytics;
+
+struct EdgeCapacity : public katana::PODProperty<uint32_t> {};
+
+/// Add a capacity property computed from the endpoints of each edge, so both
+/// directions of an edge have the same capacity
+template <typename CapacityFunc>
+void
+AddCapacities(katana::PropertyGraph* pg, CapacityFunc capacity) {
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeCapacity>>;
+
+  katana::TxnContext txn_ctx;
+  auto r = pg->ConstructEdgeProperties<std::tuple<EdgeCapacity>>(
+      &txn_ctx, {"capacity"});
+  KATANA_LOG_VASSERT(r, "failed to add capacities: {}", r.error());
+  auto graph_result = Graph::Make(pg, {}, {"capacity"});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = std::move(graph_result.value());
+  for (auto n : graph) {
+    for (auto e : graph.OutEdges(n)) {
+      auto dst = graph.OutEdgeDst(e);
+      graph.GetEdgeData<EdgeCapacity>(e) =
+          capacity(std::min<uint64_t>(n, dst), std::max<uint64_t>(n, dst));
+    }
+  }
+}
+
+/// Every plan finds a flow of the given value
+void
+CheckAllPlans(
+    katana::PropertyGraph* pg, const std::string& name, size_t source,
+    size_t sink, uint64_t expected_flow) {
+  // a large interval lets the gap heuristic trigger most global relabels
+  for (const auto& plan :
+       {MaxFlowPlan::PushRelabel(), MaxFlowPlan::PushRelabel(1000)}) {
+    std::string plan_name =
+        name + "-" + std::to_string(plan.global_relabel_interval());
+    std::string flow_name = plan_name + "-flow";
+    std::string cut_name = plan_name + "-cut";
+
+    katana::TxnContext txn_ctx;
+    auto r = MaxFlow(
+        pg, source, sink, "capacity", flow_name, cut_name, &txn_ctx, plan);
+    KATANA_LOG_VASSERT(r, "MaxFlow failed: {}", r.error());
+
+    auto valid =
+        MaxFlowAssertValid(pg, source, sink, "capacity", flow_name, cut_name);
+    KATANA_LOG_VASSERT(valid, "{} is not a maximum flow", plan_name);
+
+    auto stats_result =
+        MaxFlowStatistics::Compute(pg, source, flow_name, cut_name);
+    KATANA_LOG_VASSERT(
+        stats_result, "Failed to compute flow statistics: {}",
+        stats_result.error());
+    auto stats = stats_result.value();
+    KATANA_LOG_VASSERT(
+        stats.flow_value == expected_flow, "{} has flow {}, want {}",
+        plan_name, stats.flow_value, expected_flow);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  // the edges at either end of a clique weighted by id distance are a cut
+  auto clique = katana::MakeClique(50);
+  AddCapacities(clique.get(), [](uint64_t a, uint64_t b) { return b - a; });
+  CheckAllPlans(clique.get(), "clique", 0, 49, 50 * 49 / 2);
+
+  // two paths leave a corner of the grid
+  auto grid = katana::MakeGrid(20, 20, false);
+  AddCapacities(grid.get(), [](uint64_t, uint64_t) { return 1; });
+  CheckAllPlans(grid.get(), "grid", 0, 399, 2);
+
+  // the two rim neighbors of the source each reach the hub over a spoke
+  auto wheel = katana::MakeFerrisWheel(101);
+  AddCapacities(
+      wheel.get(), [](uint64_t a, uint64_t) { return a == 0 ? 5 : 1; });
+  CheckAllPlans(wheel.get(), "wheel", 1, 0, 7);
+
+  katana::TxnContext txn_ctx;
+  auto same = MaxFlow(
+      grid.get(), 0, 0, "capacity", "same-flow", "same-cut", &txn_ctx);
+  KATANA_LOG_ASSERT(!same);
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <string>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+using namespace katana::analytics;
+
+struct EdgeWeight : public katana::PODProperty<int64_t> {};
+
+/// Add a weight property computed from the endpoints of each edge, so both
+/// directions of an edge weigh the same
+template <typename WeightFunc>
+void
+AddWeights(katana::PropertyGraph* pg, WeightFunc weight) {
+  using Graph =
+      katana::TypedPropertyGraph<std::tuple<>, std::tuple<EdgeWeight>>;
+
+  katana::TxnContext txn_ctx;
+  auto r = pg->ConstructEdgeProperties<std::tuple<EdgeWeight>>(
+      &txn_ctx, {"weight"});
+  KATANA_LOG_VASSERT(r, "failed to add weights: {}", r.error());
+  auto graph_result = Graph::Make(pg, {}, {"weight"});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = std::move(graph_result.value());
+  for (auto n : graph) {
+    for (auto e : graph.OutEdges(n)) {
+      auto dst = graph.OutEdgeDst(e);
+      graph.GetEdgeData<EdgeWeight>(e) =
+          weight(std::min<uint64_t>(n, dst), std::max<uint64_t>(n, dst));
+    }
+  }
+}
+
+MinimumSpanningForestStatistics
+RunMinimumSpanningForest(
+    katana::PropertyGraph* pg, const std::string& name,
+    MinimumSpanningForestPlan plan) noexcept {
+  katana::TxnContext txn_ctx;
+  auto r = MinimumSpanningForest(pg, "weight", name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(r, "MinimumSpanningForest failed: {}", r.error());
+
+  auto valid = MinimumSpanningForestAssertValid(pg, "weight", name);
+  KATANA_LOG_VASSERT(valid, "{} is not the minimum spanning forest", name);
+
+  auto stats_result =
+      MinimumSpanningForestStatistics::Compute(pg, "weight", name);
+  KATANA_LOG_VASSERT(
+      stats_result, "Failed to compute forest statistics: {}",
+      stats_result.error());
+  return stats_result.value();
+}
+
+/// Every plan finds the same forest, with the given trees and weight
+void
+CheckAllPlans(
+    katana::PropertyGraph* pg, const std::string& name,
+    uint64_t expected_trees, double expected_weight) {
+  // a small base case makes FilterKruskal partition several times
+  for (const auto& plan :
+       {MinimumSpanningForestPlan::Boruvka(),
+        MinimumSpanningForestPlan::FilterKruskal(),
+        MinimumSpanningForestPlan::FilterKruskal(16)}) {
+    std::string plan_name = name + "-" + std::to_string(plan.algorithm()) +
+                            "-" + std::to_string(plan.base_case_size());
+    auto stats = RunMinimumSpanningForest(pg, plan_name, plan);
+    KATANA_LOG_VASSERT(
+        stats.num_trees == expected_trees, "{} has {} trees, want {}",
+        plan_name, stats.num_trees, expected_trees);
+    KATANA_LOG_VASSERT(
+        stats.num_forest_edges == pg->NumNodes() - expected_trees,
+        "{} has {} edges", plan_name, stats.num_forest_edges);
+    KATANA_LOG_VASSERT(
+        stats.total_weight == expected_weight, "{} weighs {}, want {}",
+        plan_name, stats.total_weight, expected_weight);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  // the lightest edges of a clique weighted by id distance form a path
+  auto clique = katana::MakeClique(300);
+  AddWeights(clique.get(), [](uint64_t a, uint64_t b) { return b - a; });
+  CheckAllPlans(clique.get(), "clique", 1, 299);
+
+  // all weights equal: ties are broken by edge id
+  auto grid = katana::MakeGrid(20, 20, false);
+  AddWeights(grid.get(), [](uint64_t, uint64_t) { return 1; });
+  CheckAllPlans(grid.get(), "grid", 1, 399);
+
+  // the rim of the wheel is free, so one spoke is enough
+  auto wheel = katana::MakeFerrisWheel(101);
+  AddWeights(wheel.get(), [](uint64_t a, uint64_t) { return a == 0 ? 5 : 0; });
+  CheckAllPlans(wheel.get(), "wheel", 1, 5);
+
+  return 0;
+}
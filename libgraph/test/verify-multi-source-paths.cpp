@@ -0,0 +1,157 @@
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edge = katana::PropertyGraph::Edge;
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max() / 4;
+
+/// A directed power-law graph, which leaves many nodes unreachable from any
+/// given source, with integer edge weights
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  katana::RMATOptions options;
+  options.scale = 10;
+  options.edge_factor = 4;
+  auto topo = katana::MakeRMATTopology(options);
+  KATANA_LOG_VASSERT(topo, "{}", topo.error());
+  auto pg = katana::PropertyGraph::Make(std::move(topo.value()));
+  KATANA_LOG_VASSERT(pg, "{}", pg.error());
+
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      pg.value().get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "weight", [](Edge e) { return static_cast<uint32_t>(e % 100 + 1); }));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  return std::move(pg.value());
+}
+
+std::vector<std::string>
+PropertyNames(const std::string& prefix, size_t num) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < num; ++i) {
+    names.emplace_back(fmt::format("{}-{}", prefix, i));
+  }
+  return names;
+}
+
+/// \returns the levels that the BFS parents in property name imply
+std::vector<uint32_t>
+LevelsFromParents(katana::PropertyGraph* pg, const std::string& name) {
+  auto parents = pg->GetNodePropertyTyped<uint32_t>(name);
+  KATANA_LOG_VASSERT(parents, "{}", parents.error());
+  const auto& parent = *parents.value();
+
+  std::vector<uint32_t> levels(pg->NumNodes(), kInfinity);
+  for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+    if (parent.Value(n) == kInfinity) {
+      continue;
+    }
+    uint32_t level = 0;
+    for (uint32_t v = n; parent.Value(v) != v; v = parent.Value(v)) {
+      ++level;
+      KATANA_LOG_VASSERT(level < pg->NumNodes(), "parents of {} cycle", n);
+    }
+    levels[n] = level;
+  }
+  return levels;
+}
+
+/// Check every MultiSourceBfs and MultiSourceSssp column against Bfs and Sssp
+/// from the same source. More sources than fit in one batch are used, so the
+/// last batch is a partial one.
+void
+TestMultiSource(katana::PropertyGraph* pg) {
+  std::vector<uint32_t> sources;
+  for (uint32_t n = 0; n < pg->NumNodes(); n += 7) {
+    sources.emplace_back(n);
+  }
+  KATANA_LOG_ASSERT(sources.size() > kMultiSourceBfsBatchSize);
+  KATANA_LOG_ASSERT(sources.size() > kMultiSourceSsspBatchSize);
+
+  katana::TxnContext txn_ctx;
+  auto level_names = PropertyNames("level", sources.size());
+  auto bfs = MultiSourceBfs(pg, sources, level_names, &txn_ctx);
+  KATANA_LOG_VASSERT(bfs, "{}", bfs.error());
+  auto distance_names = PropertyNames("distance", sources.size());
+  auto sssp = MultiSourceSssp(pg, sources, "weight", distance_names, &txn_ctx);
+  KATANA_LOG_VASSERT(sssp, "{}", sssp.error());
+
+  size_t unreachable = 0;
+  for (size_t i = 0; i < sources.size(); ++i) {
+    std::string parent_name = fmt::format("parent-{}", i);
+    KATANA_LOG_ASSERT(Bfs(pg, sources[i], parent_name, &txn_ctx));
+    std::vector<uint32_t> expected_levels = LevelsFromParents(pg, parent_name);
+    auto levels = pg->GetNodePropertyTyped<uint32_t>(level_names[i]);
+    KATANA_LOG_VASSERT(levels, "{}", levels.error());
+
+    std::string expected_name = fmt::format("expected-distance-{}", i);
+    KATANA_LOG_ASSERT(Sssp(pg, sources[i], "weight", expected_name, &txn_ctx));
+    auto expected_distances = pg->GetNodePropertyTyped<uint32_t>(expected_name);
+    KATANA_LOG_VASSERT(expected_distances, "{}", expected_distances.error());
+    auto distances = pg->GetNodePropertyTyped<uint32_t>(distance_names[i]);
+    KATANA_LOG_VASSERT(distances, "{}", distances.error());
+
+    for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+      KATANA_LOG_VASSERT(
+          levels.value()->Value(n) == expected_levels[n],
+          "level of {} from {} is {}, expected {}", n, sources[i],
+          levels.value()->Value(n), expected_levels[n]);
+      KATANA_LOG_VASSERT(
+          distances.value()->Value(n) == expected_distances.value()->Value(n),
+          "distance of {} from {} is {}, expected {}", n, sources[i],
+          distances.value()->Value(n), expected_distances.value()->Value(n));
+      if (expected_levels[n] == kInfinity) {
+        ++unreachable;
+      }
+    }
+
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(parent_name, &txn_ctx));
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(expected_name, &txn_ctx));
+  }
+  KATANA_LOG_ASSERT(unreachable > 0);
+}
+
+/// Bad arguments are refused before any property is created
+void
+TestInvalid(katana::PropertyGraph* pg) {
+  katana::TxnContext txn_ctx;
+  int32_t num_properties = pg->GetNumNodeProperties();
+
+  std::vector<uint32_t> sources{0, static_cast<uint32_t>(pg->NumNodes())};
+  auto bfs = MultiSourceBfs(pg, sources, {"a", "b"}, &txn_ctx);
+  KATANA_LOG_ASSERT(!bfs && bfs.error() == katana::ErrorCode::InvalidArgument);
+  auto sssp = MultiSourceSssp(pg, sources, "weight", {"a", "b"}, &txn_ctx);
+  KATANA_LOG_ASSERT(
+      !sssp && sssp.error() == katana::ErrorCode::InvalidArgument);
+
+  bfs = MultiSourceBfs(pg, {0}, {"a", "b"}, &txn_ctx);
+  KATANA_LOG_ASSERT(!bfs && bfs.error() == katana::ErrorCode::InvalidArgument);
+
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == num_properties);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg = MakeGraph();
+  TestMultiSource(pg.get());
+  TestInvalid(pg.get());
+
+  return 0;
+}
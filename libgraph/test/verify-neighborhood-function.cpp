@@ -0,0 +1,137 @@
+#include <cmath>
+#include <vector>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/neighborhood_function/neighborhood_function.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr double kMaxRelativeError = 0.1;
+
+/// \returns the number of nodes at each distance from source, found with a
+/// breadth-first search
+std::vector<uint64_t>
+CountByDistance(const katana::PropertyGraph* pg, uint32_t source) {
+  const katana::GraphTopology& topo = pg->topology();
+  std::vector<bool> reached(pg->NumNodes());
+  std::vector<uint32_t> frontier{source};
+  reached[source] = true;
+  std::vector<uint64_t> counts;
+  while (!frontier.empty()) {
+    counts.push_back(frontier.size());
+    std::vector<uint32_t> next;
+    for (uint32_t n : frontier) {
+      for (auto e : topo.OutEdges(n)) {
+        uint32_t dst = topo.OutEdgeDst(e);
+        if (!reached[dst]) {
+          reached[dst] = true;
+          next.push_back(dst);
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+  return counts;
+}
+
+/// \returns the exact neighborhood function of pg and the number of nodes
+/// every node reaches
+NeighborhoodFunctionResult
+Exact(const katana::PropertyGraph* pg, std::vector<uint64_t>* reach) {
+  NeighborhoodFunctionResult exact;
+  reach->assign(pg->NumNodes(), 0);
+  for (uint32_t source = 0; source < pg->NumNodes(); ++source) {
+    std::vector<uint64_t> counts = CountByDistance(pg, source);
+    if (exact.neighborhood_function.size() < counts.size()) {
+      exact.neighborhood_function.resize(counts.size());
+    }
+    uint64_t within = 0;
+    for (size_t t = 0; t < exact.neighborhood_function.size(); ++t) {
+      within += t < counts.size() ? counts[t] : 0;
+      exact.neighborhood_function[t] += within;
+    }
+    (*reach)[source] = within;
+  }
+  return exact;
+}
+
+bool
+Close(double found, double expected) {
+  return std::abs(found - expected) <= kMaxRelativeError * expected;
+}
+
+void
+Check(
+    katana::PropertyGraph* pg, const std::string& name,
+    const NeighborhoodFunctionPlan& plan) {
+  std::vector<uint64_t> exact_reach;
+  NeighborhoodFunctionResult exact = Exact(pg, &exact_reach);
+
+  katana::TxnContext txn_ctx;
+  auto res = NeighborhoodFunction(pg, name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  const NeighborhoodFunctionResult& found = res.value();
+
+  // counters may stop changing before the balls stop growing
+  KATANA_LOG_VASSERT(
+      found.diameter_lower_bound() <= exact.diameter_lower_bound(),
+      "diameter lower bound {} is above the diameter {}",
+      found.diameter_lower_bound(), exact.diameter_lower_bound());
+  for (size_t t = 0; t < found.neighborhood_function.size(); ++t) {
+    KATANA_LOG_VASSERT(
+        Close(found.neighborhood_function[t], exact.neighborhood_function[t]),
+        "{} pairs within distance {}, expected {}",
+        found.neighborhood_function[t], t, exact.neighborhood_function[t]);
+  }
+  KATANA_LOG_VASSERT(
+      std::abs(found.EffectiveDiameter() - exact.EffectiveDiameter()) < 1,
+      "effective diameter {}, expected {}", found.EffectiveDiameter(),
+      exact.EffectiveDiameter());
+  KATANA_LOG_VASSERT(
+      Close(found.AverageDistance(), exact.AverageDistance()),
+      "average distance {}, expected {}", found.AverageDistance(),
+      exact.AverageDistance());
+
+  auto reach = pg->GetNodePropertyTyped<double>(name);
+  KATANA_LOG_VASSERT(reach, "{}", reach.error());
+  for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        Close(reach.value()->Value(n), exact_reach[n]),
+        "node {} reaches {} nodes, estimated {}", n, exact_reach[n],
+        reach.value()->Value(n));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto grid = katana::MakeGrid(20, 20, false);
+  Check(grid.get(), "grid-reach", NeighborhoodFunctionPlan::HyperAnf(12));
+
+  // one out-edge per node, so many nodes reach few others
+  auto random = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(1000, 1));
+  KATANA_LOG_ASSERT(random);
+  Check(
+      random.value().get(), "random-reach",
+      NeighborhoodFunctionPlan::HyperAnf(12));
+
+  // without a reach property, and with too few or too many registers
+  katana::TxnContext txn_ctx;
+  auto res = NeighborhoodFunction(grid.get(), "", &txn_ctx);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(grid->GetNumNodeProperties() == 1);
+  for (uint32_t log2_registers : {3U, 13U}) {
+    KATANA_LOG_ASSERT(!NeighborhoodFunction(
+        grid.get(), "", &txn_ctx,
+        NeighborhoodFunctionPlan::HyperAnf(log2_registers)));
+  }
+
+  return 0;
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/pattern_matching/pattern_matching.h"
+
+using namespace katana::analytics;
+
+using Node = katana::GraphTopologyTypes::Node;
+
+constexpr int kNoEdge = -1;
+
+/// A random symmetric graph with node types "hub" and "other" and edge types
+/// "red" and "blue", both directions of an edge having the same type
+std::unique_ptr<katana::PropertyGraph>
+MakeTypedGraph(size_t num_nodes, double edge_probability, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::bernoulli_distribution has_edge(edge_probability);
+  katana::SymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(num_nodes);
+  for (size_t a = 0; a < num_nodes; ++a) {
+    for (size_t b = a + 1; b < num_nodes; ++b) {
+      if (has_edge(gen)) {
+        builder.AddEdge(a, b);
+      }
+    }
+  }
+  katana::GraphTopology topo = builder.ConvertToCSR();
+
+  katana::EntityTypeManager node_types;
+  katana::EntityTypeManager edge_types;
+  auto hub = node_types.AddAtomicEntityType("hub");
+  auto other = node_types.AddAtomicEntityType("other");
+  auto red = edge_types.AddAtomicEntityType("red");
+  auto blue = edge_types.AddAtomicEntityType("blue");
+  KATANA_LOG_ASSERT(hub && other && red && blue);
+
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(topo.NumNodes());
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateInterleaved(topo.NumEdges());
+  for (Node n = 0; n < topo.NumNodes(); ++n) {
+    node_type_ids[n] = n % 3 == 0 ? hub.value() : other.value();
+    for (auto e : topo.OutEdges(n)) {
+      edge_type_ids[e] =
+          (n + topo.OutEdgeDst(e)) % 2 == 0 ? red.value() : blue.value();
+    }
+  }
+
+  auto r = katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_type_ids), std::move(edge_type_ids),
+      std::move(node_types), std::move(edge_types));
+  KATANA_LOG_VASSERT(r, "failed to make graph: {}", r.error());
+  return std::move(r.value());
+}
+
+/// The edge types of pg as a matrix, kNoEdge where there is no edge
+std::vector<std::vector<int>>
+EdgeTypeMatrix(const katana::PropertyGraph& pg) {
+  std::vector<std::vector<int>> types(
+      pg.NumNodes(), std::vector<int>(pg.NumNodes(), kNoEdge));
+  for (Node n = 0; n < pg.NumNodes(); ++n) {
+    for (auto e : pg.topology().OutEdges(n)) {
+      types[n][pg.topology().OutEdgeDst(e)] = pg.GetTypeOfEdgeFromTopoIndex(e);
+    }
+  }
+  return types;
+}
+
+/// Whether match satisfies the pattern, in the pattern node order
+bool
+IsMatch(
+    const katana::PropertyGraph& pg, const std::vector<std::vector<int>>& types,
+    const Pattern& pattern, const std::vector<Node>& match) {
+  const size_t size = pattern.num_nodes();
+  std::vector<std::vector<bool>> adjacent(size, std::vector<bool>(size));
+  for (const auto& edge : pattern.edges()) {
+    int type = types[match[edge.src]][match[edge.dst]];
+    if (type == kNoEdge || (edge.edge_type && type != *edge.edge_type)) {
+      return false;
+    }
+    adjacent[edge.src][edge.dst] = adjacent[edge.dst][edge.src] = true;
+  }
+  for (size_t a = 0; a < size; ++a) {
+    const auto& node_type = pattern.node_type(a);
+    if (node_type && !pg.DoesNodeHaveType(match[a], *node_type)) {
+      return false;
+    }
+    if (pattern.node_filter(a) && !pattern.node_filter(a)(match[a])) {
+      return false;
+    }
+    for (size_t b = 0; b < size; ++b) {
+      if (match[a] == match[b] && a != b) {
+        return false;
+      }
+      if (pattern.induced() && a != b && !adjacent[a][b] &&
+          types[match[a]][match[b]] != kNoEdge) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// The number of one-to-one maps of the pattern nodes that satisfy the
+/// pattern, by trying all of them
+uint64_t
+CountEmbeddings(
+    const katana::PropertyGraph& pg, const std::vector<std::vector<int>>& types,
+    const Pattern& pattern, std::vector<Node>* match) {
+  if (match->size() == pattern.num_nodes()) {
+    return IsMatch(pg, types, pattern, *match);
+  }
+  uint64_t count = 0;
+  for (Node n = 0; n < pg.NumNodes(); ++n) {
+    match->emplace_back(n);
+    count += CountEmbeddings(pg, types, pattern, match);
+    match->pop_back();
+  }
+  return count;
+}
+
+/// The pattern is found once per subgraph, i.e., once per automorphisms
+/// embeddings, by both counting and enumerating
+void
+CheckPattern(
+    katana::PropertyGraph* pg, const std::string& name, const Pattern& pattern,
+    uint64_t automorphisms) {
+  auto types = EdgeTypeMatrix(*pg);
+  std::vector<Node> match;
+  uint64_t embeddings = CountEmbeddings(*pg, types, pattern, &match);
+
+  auto count = CountPatternMatches(pg, pattern);
+  KATANA_LOG_VASSERT(count, "CountPatternMatches failed: {}", count.error());
+  KATANA_LOG_VASSERT(
+      count.value() * automorphisms == embeddings,
+      "{} found {} times, want {}", name, count.value(),
+      embeddings / automorphisms);
+
+  std::atomic<uint64_t> num_matches{0};
+  std::atomic<bool> all_valid{true};
+  auto r = ForEachPatternMatch(
+      pg, pattern, [&](const std::vector<Node>& found) {
+        ++num_matches;
+        if (!IsMatch(*pg, types, pattern, found)) {
+          all_valid = false;
+        }
+      });
+  KATANA_LOG_VASSERT(r, "ForEachPatternMatch failed: {}", r.error());
+  KATANA_LOG_VASSERT(all_valid, "{} has an invalid match", name);
+  KATANA_LOG_ASSERT(num_matches == count.value());
+}
+
+/// The number of connected induced subgraphs with size nodes, counted by
+/// trying all sets of nodes from first on
+uint64_t
+CountConnectedSets(
+    const std::vector<std::vector<int>>& types, size_t size, Node first,
+    std::vector<Node>* set) {
+  if (set->size() == size) {
+    std::vector<bool> reached(size, false);
+    reached[0] = true;
+    for (size_t round = 1; round < size; ++round) {
+      for (size_t a = 0; a < size; ++a) {
+        for (size_t b = 0; b < size; ++b) {
+          if (reached[a] && types[(*set)[a]][(*set)[b]] != kNoEdge) {
+            reached[b] = true;
+          }
+        }
+      }
+    }
+    return std::all_of(reached.begin(), reached.end(), [](bool r) {
+      return r;
+    });
+  }
+  uint64_t count = 0;
+  for (Node n = first; n < types.size(); ++n) {
+    set->emplace_back(n);
+    count += CountConnectedSets(types, size, n + 1, set);
+    set->pop_back();
+  }
+  return count;
+}
+
+void
+TestTypedGraph() {
+  auto pg = MakeTypedGraph(24, 0.3, 7);
+  katana::EntityTypeID hub = pg->GetNodeEntityTypeID("hub");
+  katana::EntityTypeID red = pg->GetEdgeEntityTypeID("red");
+
+  for (bool induced : {false, true}) {
+    std::string kind = induced ? "induced " : "";
+    CheckPattern(pg.get(), kind + "triangle", Pattern::Clique(3, induced), 6);
+    CheckPattern(pg.get(), kind + "4-clique", Pattern::Clique(4, induced), 24);
+    CheckPattern(pg.get(), kind + "4-cycle", Pattern::Cycle(4, induced), 8);
+    CheckPattern(pg.get(), kind + "wedge", Pattern::Path(3, induced), 2);
+    CheckPattern(pg.get(), kind + "4-path", Pattern::Path(4, induced), 2);
+    CheckPattern(pg.get(), kind + "3-star", Pattern::Star(4, induced), 6);
+
+    // a triangle with one directed red edge has no automorphism
+    Pattern red_triangle = Pattern::Path(3, induced);
+    red_triangle.AddEdge(2, 0, red);
+    CheckPattern(pg.get(), kind + "red triangle", red_triangle, 1);
+
+    Pattern hub_wedge(induced);
+    hub_wedge.AddNode(hub);
+    hub_wedge.AddNode();
+    hub_wedge.AddNode();
+    hub_wedge.AddEdge(0, 1);
+    hub_wedge.AddEdge(0, 2);
+    CheckPattern(pg.get(), kind + "hub wedge", hub_wedge, 2);
+
+    Pattern even_star(induced);
+    even_star.AddNode(std::nullopt, [](Node n) { return n % 2 == 0; });
+    for (size_t leaf = 1; leaf < 4; ++leaf) {
+      even_star.AddNode();
+      even_star.AddEdge(0, leaf);
+    }
+    CheckPattern(pg.get(), kind + "even star", even_star, 6);
+  }
+
+  auto types = EdgeTypeMatrix(*pg);
+  for (size_t size : {3, 4}) {
+    auto motifs = CountMotifs(pg.get(), size);
+    KATANA_LOG_VASSERT(motifs, "CountMotifs failed: {}", motifs.error());
+    // 2 shapes on 3 nodes, 6 on 4
+    KATANA_LOG_ASSERT(motifs.value().size() == (size == 3 ? 2 : 6));
+    uint64_t total = 0;
+    for (const auto& motif : motifs.value()) {
+      total += motif.count;
+    }
+    std::vector<Node> set;
+    KATANA_LOG_ASSERT(total == CountConnectedSets(types, size, 0, &set));
+    // the clique has the most edges, so it comes last
+    KATANA_LOG_ASSERT(
+        motifs.value().back().count ==
+        CountPatternMatches(pg.get(), Pattern::Clique(size)).value());
+  }
+}
+
+void
+TestGeneratedGraphs() {
+  auto clique = katana::MakeClique(50);
+  auto triangles = CountPatternMatches(clique.get(), Pattern::Clique(3));
+  KATANA_LOG_ASSERT(triangles && triangles.value() == 50 * 49 * 48 / 6);
+  auto motifs = CountMotifs(clique.get(), 4);
+  KATANA_LOG_ASSERT(motifs);
+  for (const auto& motif : motifs.value()) {
+    bool is_clique = motif.pattern.edges().size() == 6;
+    KATANA_LOG_ASSERT(
+        motif.count == (is_clique ? 50 * 49 * 48 * 47 / 24 : 0));
+  }
+
+  // every cell of the grid is a 4-cycle, and there are no triangles
+  auto grid = katana::MakeGrid(20, 20, false);
+  auto squares = CountPatternMatches(grid.get(), Pattern::Cycle(4));
+  KATANA_LOG_ASSERT(squares && squares.value() == 19 * 19);
+  auto grid_triangles = CountPatternMatches(grid.get(), Pattern::Clique(3));
+  KATANA_LOG_ASSERT(grid_triangles && grid_triangles.value() == 0);
+}
+
+void
+TestInvalidPatterns() {
+  auto grid = katana::MakeGrid(5, 5, false);
+
+  Pattern disconnected;
+  disconnected.AddNode();
+  disconnected.AddNode();
+  KATANA_LOG_ASSERT(!CountPatternMatches(grid.get(), disconnected));
+
+  Pattern doubled = Pattern::Path(2);
+  doubled.AddEdge(1, 0);
+  KATANA_LOG_ASSERT(!CountPatternMatches(grid.get(), doubled));
+
+  KATANA_LOG_ASSERT(!CountPatternMatches(grid.get(), Pattern::Path(9)));
+  KATANA_LOG_ASSERT(!CountPatternMatches(grid.get(), Pattern{}));
+  KATANA_LOG_ASSERT(!CountMotifs(grid.get(), 6));
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestTypedGraph();
+  TestGeneratedGraphs();
+  TestInvalidPatterns();
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <cmath>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// Personalized PageRank of the source of a walk on an n-clique; every other
+/// node gets an equal share of the rest
+double
+CliqueSourceScore(size_t n, double alpha) {
+  return (1 - alpha) *
+         (1.0 / n / (1 - alpha) + (n - 1.0) / n / (1 + alpha / (n - 1)));
+}
+
+void
+CheckCliqueTopK(const PersonalizedPagerankPlan& plan, double max_error) {
+  constexpr size_t kNumNodes = 10;
+  auto pg = katana::MakeClique(kNumNodes);
+  double source_score = CliqueSourceScore(kNumNodes, plan.alpha());
+  double other_score = (1 - source_score) / (kNumNodes - 1);
+
+  auto top_result = PersonalizedPagerankTopK(pg.get(), {3}, kNumNodes, plan);
+  KATANA_LOG_VASSERT(
+      top_result, "PersonalizedPagerankTopK failed: {}", top_result.error());
+  auto top = top_result.value();
+  KATANA_LOG_VASSERT(
+      top.size() == kNumNodes, "Found {} scores, expected {}", top.size(),
+      kNumNodes);
+  KATANA_LOG_VASSERT(
+      top[0].first == 3, "Found node {} on top, expected 3", top[0].first);
+  KATANA_LOG_VASSERT(
+      std::abs(top[0].second - source_score) <= max_error,
+      "Wrong source score. Found: {}, Expected: {}", top[0].second,
+      source_score);
+  for (size_t i = 1; i < top.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        std::abs(top[i].second - other_score) <= max_error,
+        "Wrong score of node {}. Found: {}, Expected: {}", top[i].first,
+        top[i].second, other_score);
+    KATANA_LOG_ASSERT(top[i].second <= top[i - 1].second);
+  }
+}
+
+void
+CheckColumn() {
+  struct Score : public katana::PODProperty<float> {};
+  using Graph = katana::TypedPropertyGraph<std::tuple<Score>, std::tuple<>>;
+
+  auto pg = katana::MakeGrid(5, 5, false);
+  katana::TxnContext txn_ctx;
+  auto r = PersonalizedPagerank(pg.get(), {0, 24}, "ppr", &txn_ctx);
+  KATANA_LOG_VASSERT(r, "PersonalizedPagerank failed: {}", r.error());
+
+  auto graph_result = Graph::Make(pg.get(), {"ppr"}, {});
+  KATANA_LOG_ASSERT(graph_result);
+  Graph graph = graph_result.value();
+  double total = 0;
+  for (auto n : graph) {
+    total += graph.GetData<Score>(n);
+  }
+  // forward push leaves at most tolerance per edge unpushed
+  KATANA_LOG_VASSERT(
+      std::abs(total - 1) <= 1e-3, "Scores sum to {}, expected 1", total);
+  // a half turn maps the grid onto itself and swaps the sources
+  KATANA_LOG_VASSERT(
+      std::abs(graph.GetData<Score>(0) - graph.GetData<Score>(24)) <= 1e-4,
+      "Sources scored {} and {}", graph.GetData<Score>(0),
+      graph.GetData<Score>(24));
+
+  auto bad_source = PersonalizedPagerank(pg.get(), {25}, "bad", &txn_ctx);
+  KATANA_LOG_ASSERT(!bad_source);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  CheckCliqueTopK(PersonalizedPagerankPlan::ForwardPush(), 1e-4);
+  CheckCliqueTopK(PersonalizedPagerankPlan::MonteCarlo(200000), 1e-2);
+  CheckColumn();
+
+  // walks only depend on the seed
+  auto pg = katana::MakeGrid(4, 4, true);
+  auto plan = PersonalizedPagerankPlan::MonteCarlo(1000, 0.85, 7);
+  auto first = PersonalizedPagerankTopK(pg.get(), {5}, 16, plan);
+  auto second = PersonalizedPagerankTopK(pg.get(), {5}, 16, plan);
+  KATANA_LOG_ASSERT(first && second);
+  KATANA_LOG_ASSERT(first.value() == second.value());
+
+  return 0;
+}
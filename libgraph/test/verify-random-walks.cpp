@@ -0,0 +1,84 @@
+#include <algorithm>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+void
+CheckWalks(katana::PropertyGraph* pg, const RandomWalksBatch& walks) {
+  const auto& topo = pg->topology();
+  for (uint64_t i = 0; i < walks.num_walks; ++i) {
+    uint32_t length = walks.lengths[i];
+    KATANA_LOG_VASSERT(
+        length == walks.stride, "Walk {} has {} nodes, expected {}", i, length,
+        walks.stride);
+    const uint32_t* walk = walks.walk_begin(i);
+    KATANA_LOG_ASSERT(walk[0] == (walks.first_walk + i) % topo.NumNodes());
+    for (uint32_t step = 1; step < length; ++step) {
+      bool found = false;
+      for (auto e : topo.OutEdges(walk[step - 1])) {
+        found = found || topo.OutEdgeDst(e) == walk[step];
+      }
+      KATANA_LOG_VASSERT(
+          found, "Walk {} steps from {} to {} without an edge", i,
+          walk[step - 1], walk[step]);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto pg = katana::MakeGrid(4, 4, true);
+  auto plan = RandomWalksPlan::Node2Vec(8, 3, 2.0, 0.5);
+
+  auto flat_result = RandomWalksFlat(pg.get(), "", plan);
+  KATANA_LOG_VASSERT(
+      flat_result, "RandomWalksFlat failed: {}", flat_result.error());
+  RandomWalksBatch flat = std::move(flat_result.value());
+  KATANA_LOG_ASSERT(flat.num_walks == 16 * 3);
+  CheckWalks(pg.get(), flat);
+
+  // batches hold the same walks whatever their size
+  uint64_t next_walk = 0;
+  auto stream_result = StreamRandomWalks(
+      pg.get(), 5,
+      [&](const RandomWalksBatch& batch) -> katana::Result<void> {
+        KATANA_LOG_ASSERT(batch.first_walk == next_walk);
+        for (uint64_t i = 0; i < batch.num_walks; ++i) {
+          KATANA_LOG_ASSERT(std::equal(
+              batch.walk_begin(i), batch.walk_end(i),
+              flat.walk_begin(next_walk + i), flat.walk_end(next_walk + i)));
+        }
+        next_walk += batch.num_walks;
+        return katana::ResultSuccess();
+      },
+      "", plan);
+  KATANA_LOG_VASSERT(
+      stream_result, "StreamRandomWalks failed: {}", stream_result.error());
+  KATANA_LOG_ASSERT(next_walk == flat.num_walks);
+
+  // equal weights draw the same edges as no weights
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      AddDefaultEdgeWeight<uint32_t>(pg.get(), "weight", 7, &txn_ctx));
+  auto weighted_result = RandomWalksFlat(pg.get(), "weight", plan);
+  KATANA_LOG_VASSERT(
+      weighted_result, "Weighted RandomWalksFlat failed: {}",
+      weighted_result.error());
+  const RandomWalksBatch& weighted = weighted_result.value();
+  KATANA_LOG_ASSERT(std::equal(
+      weighted.nodes.begin(), weighted.nodes.end(), flat.nodes.begin(),
+      flat.nodes.end()));
+
+  KATANA_LOG_ASSERT(!RandomWalksFlat(pg.get(), "missing", plan));
+
+  return 0;
+}
@@ -0,0 +1,198 @@
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "katana/analytics/reachability/reachability.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// A cycle of nodes 0 to 4 with a tail 5 -> 0 and an exit 4 -> 6 into the
+/// cycle 6 <-> 7; node 8 is alone and node 9 only has a self loop
+std::unique_ptr<katana::PropertyGraph>
+MakeCycles() {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(10);
+  for (uint32_t n = 0; n < 5; ++n) {
+    builder.AddEdge(n, (n + 1) % 5);
+  }
+  builder.AddEdge(5, 0);
+  builder.AddEdge(4, 6);
+  builder.AddEdge(6, 7);
+  builder.AddEdge(7, 6);
+  builder.AddEdge(9, 9);
+  auto res = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_ASSERT(res);
+  return std::move(res.value());
+}
+
+/// \returns the nodes reachable from source, found with a search of pg
+std::vector<bool>
+Reachable(const katana::PropertyGraph* pg, uint32_t source) {
+  const katana::GraphTopology& topo = pg->topology();
+  std::vector<bool> reached(pg->NumNodes());
+  std::vector<uint32_t> stack{source};
+  reached[source] = true;
+  while (!stack.empty()) {
+    uint32_t n = stack.back();
+    stack.pop_back();
+    for (auto e : topo.OutEdges(n)) {
+      uint32_t dst = topo.OutEdgeDst(e);
+      if (!reached[dst]) {
+        reached[dst] = true;
+        stack.push_back(dst);
+      }
+    }
+  }
+  return reached;
+}
+
+/// Check the answers of index for every target of every stride-th source,
+/// one by one and batched
+void
+CheckIndex(
+    const katana::PropertyGraph* pg, const ReachabilityIndex& index,
+    uint32_t stride) {
+  KATANA_LOG_ASSERT(index.num_nodes() == pg->NumNodes());
+  ReachabilityIndex::QueryList queries;
+  std::vector<bool> expected;
+  for (uint32_t source = 0; source < pg->NumNodes(); source += stride) {
+    std::vector<bool> reached = Reachable(pg, source);
+    for (uint32_t target = 0; target < pg->NumNodes(); ++target) {
+      KATANA_LOG_VASSERT(
+          index.CanReach(source, target) == reached[target],
+          "{} reaches {}: {}, the index says otherwise", source, target,
+          bool(reached[target]));
+      queries.emplace_back(source, target);
+      expected.push_back(reached[target]);
+    }
+  }
+
+  auto batch = index.CanReach(queries);
+  KATANA_LOG_VASSERT(batch, "{}", batch.error());
+  KATANA_LOG_ASSERT(batch.value().size() == queries.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        batch.value().test(i) == expected[i], "query {} from {} to {}", i,
+        queries[i].first, queries[i].second);
+  }
+
+  uint32_t invalid = static_cast<uint32_t>(pg->NumNodes());
+  KATANA_LOG_ASSERT(!index.CanReach({{0, invalid}}));
+}
+
+ReachabilityIndex
+Build(katana::PropertyGraph* pg, const ReachabilityIndexPlan& plan) {
+  auto index = ReachabilityIndex::Build(pg, plan);
+  KATANA_LOG_VASSERT(index, "{}", index.error());
+  return std::move(index.value());
+}
+
+void
+TestCycles() {
+  auto pg = MakeCycles();
+  ReachabilityIndex index = Build(pg.get(), ReachabilityIndexPlan());
+  // the five-cycle, the two-cycle and the three single nodes
+  KATANA_LOG_ASSERT(index.num_components() == 5);
+  CheckIndex(pg.get(), index, 1);
+  // building the index leaves no property behind
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 0);
+
+  KATANA_LOG_ASSERT(
+      !ReachabilityIndex::Build(pg.get(), ReachabilityIndexPlan::Grail(0)));
+}
+
+void
+TestRandom() {
+  // one out-edge per node makes many components joined by long paths, which
+  // the labels alone cannot always answer
+  auto pg = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(2000, 1));
+  KATANA_LOG_ASSERT(pg);
+  for (uint32_t num_traversals : {1U, 5U}) {
+    ReachabilityIndex index = Build(
+        pg.value().get(), ReachabilityIndexPlan::Grail(num_traversals));
+    CheckIndex(pg.value().get(), index, 37);
+  }
+
+  auto dense = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(1000, 3));
+  KATANA_LOG_ASSERT(dense);
+  CheckIndex(
+      dense.value().get(), Build(dense.value().get(), ReachabilityIndexPlan()),
+      29);
+}
+
+/// The index is written with the graph and stays with it when the graph is
+/// stored elsewhere
+void
+TestStoredIndex() {
+  auto pg = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(500, 2));
+  KATANA_LOG_ASSERT(pg);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/reachability");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  katana::TxnContext txn_ctx;
+  auto write_result = pg.value()->Write(rdg_dir, "reachability", &txn_ctx);
+  if (!write_result) {
+    boost::filesystem::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto loaded =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(loaded, "making result: {}", loaded.error());
+  katana::PropertyGraph* g = loaded.value().get();
+  auto missing = ReachabilityIndex::Load(g);
+  KATANA_LOG_VASSERT(missing, "{}", missing.error());
+  KATANA_LOG_ASSERT(!missing.value());
+
+  ReachabilityIndex index = Build(g, ReachabilityIndexPlan());
+  auto index_written = index.Write(g);
+  KATANA_LOG_VASSERT(index_written, "{}", index_written.error());
+  auto reloaded = ReachabilityIndex::Load(g);
+  KATANA_LOG_VASSERT(reloaded, "{}", reloaded.error());
+  KATANA_LOG_ASSERT(reloaded.value());
+  CheckIndex(g, reloaded.value().value(), 7);
+
+  auto copy_uri_res = katana::URI::MakeRand("/tmp/reachability");
+  KATANA_LOG_ASSERT(copy_uri_res);
+  std::string copy_dir(copy_uri_res.value().path());
+  write_result = g->Write(copy_dir, "reachability", &txn_ctx);
+  if (!write_result) {
+    boost::filesystem::remove_all(rdg_dir);
+    boost::filesystem::remove_all(copy_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  auto copy =
+      katana::PropertyGraph::Make(copy_dir, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(copy, "making result: {}", copy.error());
+  auto copied = ReachabilityIndex::Load(copy.value().get());
+  KATANA_LOG_VASSERT(copied, "{}", copied.error());
+  KATANA_LOG_ASSERT(copied.value());
+  CheckIndex(copy.value().get(), copied.value().value(), 7);
+
+  boost::filesystem::remove_all(rdg_dir);
+  boost::filesystem::remove_all(copy_dir);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestCycles();
+  TestRandom();
+  TestStoredIndex();
+
+  return 0;
+}
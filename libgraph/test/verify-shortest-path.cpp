@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/shortest_path/shortest_path.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+using Edge = katana::PropertyGraph::Edge;
+using Node = katana::PropertyGraph::Node;
+
+namespace {
+
+constexpr size_t kWidth = 20;
+
+/// A grid whose edges have weights from 1 to 10
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedGrid() {
+  auto pg = katana::MakeGrid(kWidth, kWidth, false);
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("weight", [&pg](Edge e) {
+        int64_t src = pg->topology().GetEdgeSrc(e);
+        int64_t dst = pg->topology().OutEdgeDst(e);
+        return (src * 7 + dst * 13) % 10 + 1;
+      }));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  return pg;
+}
+
+/// Check that path is a path of pg from source to target of length distance
+void
+CheckPath(
+    katana::PropertyGraph* pg, const ShortestPathResult& result, Node source,
+    Node target) {
+  auto weights = pg->GetEdgePropertyTyped<int64_t>("weight").value();
+  KATANA_LOG_ASSERT(result.path.front() == source);
+  KATANA_LOG_ASSERT(result.path.back() == target);
+  double length = 0;
+  for (size_t i = 0; i + 1 < result.path.size(); ++i) {
+    int64_t lightest = std::numeric_limits<int64_t>::max();
+    for (Edge e : pg->OutEdges(result.path[i])) {
+      if (pg->topology().OutEdgeDst(e) == result.path[i + 1]) {
+        lightest = std::min(lightest, weights->Value(e));
+      }
+    }
+    KATANA_LOG_VASSERT(
+        lightest != std::numeric_limits<int64_t>::max(),
+        "no edge from {} to {}", result.path[i], result.path[i + 1]);
+    length += lightest;
+  }
+  KATANA_LOG_VASSERT(
+      length == result.distance, "path of length {} for distance {}", length,
+      result.distance);
+}
+
+void
+CheckAgainstSssp(bool use_landmarks, const std::string& name) {
+  auto pg = MakeWeightedGrid();
+  katana::TxnContext txn_ctx;
+  const Node source = 3 * kWidth + 5;
+  auto res = Sssp(pg.get(), source, "weight", "distance", &txn_ctx);
+  KATANA_LOG_VASSERT(res, "{}: Sssp failed: {}", name, res.error());
+  auto distances = pg->GetNodePropertyTyped<int64_t>("distance").value();
+
+  std::optional<LandmarkIndex> index;
+  if (use_landmarks) {
+    // the corners of the grid
+    auto index_res = LandmarkIndex::Build(
+        pg.get(), {0, kWidth - 1, kWidth * (kWidth - 1), kWidth * kWidth - 1},
+        "weight", {"l0", "l1", "l2", "l3"}, &txn_ctx);
+    KATANA_LOG_VASSERT(
+        index_res, "{}: LandmarkIndex::Build failed: {}", name,
+        index_res.error());
+    index.emplace(std::move(index_res.value()));
+  }
+
+  for (Node target = 0; target < pg->NumNodes(); target += 7) {
+    auto result_res = ShortestPath(
+        pg.get(), source, target, "weight", index ? &index.value() : nullptr);
+    KATANA_LOG_VASSERT(
+        result_res, "{}: ShortestPath failed: {}", name, result_res.error());
+    const ShortestPathResult& result = result_res.value();
+    KATANA_LOG_VASSERT(
+        result.distance == distances->Value(target),
+        "{}: distance to {} is {}, expected {}", name, target, result.distance,
+        distances->Value(target));
+    CheckPath(pg.get(), result, source, target);
+  }
+}
+
+void
+CheckUnreachable() {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(3);
+  builder.AddEdge(0, 1);
+  builder.AddEdge(1, 2);
+  auto pg = katana::PropertyGraph::Make(builder.ConvertToCSR()).value();
+
+  auto forward = ShortestPath(pg.get(), 0, 2, "").value();
+  KATANA_LOG_ASSERT(forward.distance == 2);
+  KATANA_LOG_ASSERT(forward.path == std::vector<uint32_t>({0, 1, 2}));
+
+  auto backward = ShortestPath(pg.get(), 2, 0, "").value();
+  KATANA_LOG_ASSERT(!backward.reachable());
+
+  KATANA_LOG_ASSERT(!ShortestPath(pg.get(), 0, 3, ""));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  CheckAgainstSssp(false, "Bidirectional");
+  CheckAgainstSssp(true, "ALT");
+  CheckUnreachable();
+
+  return 0;
+}
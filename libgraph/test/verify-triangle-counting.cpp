@@ -1,15 +1,45 @@
+#include <utility>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
 #include "katana/TopologyGeneration.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> rmat15InputFile(
+    cll::Positional, cll::desc("<rmat15 cleaned symmetric input file>"),
+    cll::Required);
+
+using Plan = katana::analytics::TriangleCountPlan;
+
+constexpr size_t kHubBitmapBudget = 1 << 20;
+
 void
 RunTriCount(
     std::unique_ptr<katana::PropertyGraph>&& pg,
     const size_t num_expected_triangles) noexcept {
-  using Plan = katana::analytics::TriangleCountPlan;
   std::vector<Plan> plans{
-      Plan::NodeIteration(Plan::kRelabel), Plan::EdgeIteration(Plan::kRelabel),
-      Plan::OrderedCount(Plan::kRelabel)};
+      Plan::NodeIteration(Plan::kRelabel),
+      Plan::EdgeIteration(Plan::kRelabel),
+      Plan::OrderedCount(Plan::kRelabel),
+      Plan::EdgeSampling(1.0),
+      Plan::NodeIteration(
+          Plan::kDefaultEdgeSorted, Plan::kDefaultRelabeling,
+          kHubBitmapBudget),
+      Plan::EdgeIteration(
+          Plan::kDefaultEdgeSorted, Plan::kDefaultRelabeling,
+          kHubBitmapBudget),
+      Plan::OrderedCount(
+          Plan::kDefaultEdgeSorted, Plan::kDefaultRelabeling,
+          kHubBitmapBudget),
+      Plan::EdgeSampling(
+          1.0, Plan::kDefaultSeed, Plan::kDefaultEdgeSorted,
+          Plan::kDefaultRelabeling, kHubBitmapBudget)};
 
   for (const auto& p : plans) {
     katana::Result<size_t> num_tri =
@@ -20,11 +50,79 @@ RunTriCount(
         "Wrong number of triangles. Found: {}, Expected: {}", num_tri.value(),
         num_expected_triangles);
   }
+
+  // sampling every edge is exact
+  auto estimate = katana::analytics::EstimateTriangleCount(
+      pg.get(), Plan::EdgeSampling(1.0));
+  KATANA_LOG_VASSERT(estimate, "EstimateTriangleCount failed");
+  KATANA_LOG_ASSERT(estimate.value().value == num_expected_triangles);
+  KATANA_LOG_ASSERT(estimate.value().std_error == 0);
+
+  // same seed, same sample
+  auto first = katana::analytics::EstimateTriangleCount(
+      pg.get(), Plan::EdgeSampling(0.5, 7));
+  auto second = katana::analytics::EstimateTriangleCount(
+      pg.get(), Plan::EdgeSampling(0.5, 7));
+  KATANA_LOG_ASSERT(first && second);
+  KATANA_LOG_ASSERT(first.value().value == second.value().value);
+}
+
+/// Every algorithm counts as many triangles with hub bitmaps as without them
+/// on a power-law graph, whose hubs have degree above
+/// HubBitmaps::kMinHubDegree
+void
+RunHubBitmaps(katana::PropertyGraph* pg) noexcept {
+  std::vector<std::pair<Plan, Plan>> plans{
+      {Plan::NodeIteration(),
+       Plan::NodeIteration(
+           Plan::kDefaultEdgeSorted, Plan::kDefaultRelabeling,
+           kHubBitmapBudget)},
+      {Plan::EdgeIteration(),
+       Plan::EdgeIteration(
+           Plan::kDefaultEdgeSorted, Plan::kDefaultRelabeling,
+           kHubBitmapBudget)},
+      {Plan::OrderedCount(),
+       Plan::OrderedCount(
+           Plan::kDefaultEdgeSorted, Plan::kDefaultRelabeling,
+           kHubBitmapBudget)},
+      {Plan::OrderedCount(Plan::kRelabel),
+       Plan::OrderedCount(
+           Plan::kDefaultEdgeSorted, Plan::kRelabel, kHubBitmapBudget)},
+      {Plan::EdgeSampling(1.0),
+       Plan::EdgeSampling(
+           1.0, Plan::kDefaultSeed, Plan::kDefaultEdgeSorted,
+           Plan::kDefaultRelabeling, kHubBitmapBudget)}};
+
+  for (const auto& [without, with] : plans) {
+    katana::Result<size_t> expected =
+        katana::analytics::TriangleCount(pg, without);
+    KATANA_LOG_VASSERT(expected, "TriangleCount failed: {}", expected.error());
+    KATANA_LOG_ASSERT(expected.value() > 0);
+    katana::Result<size_t> num_tri = katana::analytics::TriangleCount(pg, with);
+    KATANA_LOG_VASSERT(num_tri, "TriangleCount failed: {}", num_tri.error());
+    KATANA_LOG_VASSERT(
+        num_tri.value() == expected.value(),
+        "Wrong number of triangles with hub bitmaps. Found: {}, Expected: {}",
+        num_tri.value(), expected.value());
+  }
+}
+
+void
+RunClusteringCoefficient(
+    std::unique_ptr<katana::PropertyGraph>&& pg, double expected) noexcept {
+  auto estimate =
+      katana::analytics::EstimateGlobalClusteringCoefficient(pg.get(), 0.05);
+  KATANA_LOG_VASSERT(estimate, "EstimateGlobalClusteringCoefficient failed");
+  KATANA_LOG_VASSERT(
+      estimate.value().value == expected,
+      "Wrong clustering coefficient. Found: {}, Expected: {}",
+      estimate.value().value, expected);
 }
 
 int
-main() {
+main(int argc, char** argv) {
   katana::SharedMemSys S;
+  cll::ParseCommandLineOptions(argc, argv);
 
   // Grid tests
   RunTriCount(katana::MakeGrid(2, 2, true), 4);
@@ -46,11 +144,25 @@ main() {
   RunTriCount(katana::MakeClique(3), 1);
   RunTriCount(katana::MakeClique(4), 4);
   RunTriCount(katana::MakeClique(5), 10);
+  // large enough for hub bitmaps
+  RunTriCount(katana::MakeClique(300), 4455100);
 
   // Triangular array tests
   RunTriCount(katana::MakeTriangle(1), 1);
   RunTriCount(katana::MakeTriangle(3), 9);
   RunTriCount(katana::MakeTriangle(4), 16);
 
+  {
+    katana::TxnContext txn_ctx;
+    auto pg = katana::PropertyGraph::Make(
+        rmat15InputFile, &txn_ctx, katana::RDGLoadOptions());
+    KATANA_LOG_VASSERT(pg, "{}", pg.error());
+    RunHubBitmaps(pg.value().get());
+  }
+
+  // every wedge of a clique is closed and no wedge of a plain grid is
+  RunClusteringCoefficient(katana::MakeClique(6), 1.0);
+  RunClusteringCoefficient(katana::MakeGrid(5, 7, false), 0.0);
+
   return 0;
 }
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <limits>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/VertexProgram.h"
+
+namespace {
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+/// Hop distances from node 0 by flooding the smallest distance
+struct HopDistance : public katana::VertexProgram<uint32_t, uint32_t> {
+  static Message Combine(Message a, Message b) { return std::min(a, b); }
+  static Message MessageIdentity() { return kInfinity; }
+
+  void Compute(
+      katana::VertexContext<HopDistance>& ctx, Node n, Value& value,
+      const Message* message) {
+    Value candidate = ctx.superstep() == 0 && n == 0 ? 0 : kInfinity;
+    if (message != nullptr) {
+      candidate = std::min(candidate, *message);
+    }
+    if (candidate < value) {
+      value = candidate;
+      ctx.SendToNeighbors(n, value + 1);
+      ctx.AddToAggregate(1);
+    }
+    ctx.VoteToHalt(n);
+  }
+};
+
+/// Every node sends its id to node 0, which sums them
+struct SumToFirst : public katana::VertexProgram<uint64_t, uint64_t> {
+  static Message Combine(Message a, Message b) { return a + b; }
+  static Message MessageIdentity() { return 0; }
+
+  void Compute(
+      katana::VertexContext<SumToFirst>& ctx, Node n, Value& value,
+      const Message* message) {
+    if (ctx.superstep() == 0) {
+      ctx.SendTo(0, n);
+    } else if (message != nullptr) {
+      value += *message;
+    }
+    ctx.VoteToHalt(n);
+  }
+};
+
+void
+TestHopDistance(katana::PropertyGraph* pg, katana::MessageDelivery delivery) {
+  constexpr size_t kWidth = 8;
+  katana::NUMAArray<uint32_t> distance;
+  distance.allocateBlocked(pg->NumNodes());
+  std::fill(distance.begin(), distance.end(), kInfinity);
+
+  HopDistance program;
+  katana::VertexProgramOptions options;
+  options.delivery = delivery;
+  auto stats_result =
+      katana::RunVertexProgram(pg, &program, &distance, options);
+  KATANA_LOG_VASSERT(
+      stats_result, "RunVertexProgram failed: {}", stats_result.error());
+  auto stats = stats_result.value();
+  KATANA_LOG_ASSERT(stats.converged);
+  // the first superstep, one per hop to the far corner and one in which
+  // the messages of the far corner arrive
+  KATANA_LOG_VASSERT(
+      stats.supersteps == 2 * (kWidth - 1) + 2, "{} supersteps",
+      stats.supersteps);
+
+  for (uint64_t n = 0; n < pg->NumNodes(); ++n) {
+    uint32_t expected = n % kWidth + n / kWidth;
+    KATANA_LOG_VASSERT(
+        distance[n] == expected, "node {} at distance {}, expected {}", n,
+        distance[n], expected);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto grid = katana::MakeGrid(8, 8, false);
+  TestHopDistance(grid.get(), katana::MessageDelivery::kPush);
+  TestHopDistance(grid.get(), katana::MessageDelivery::kPull);
+  TestHopDistance(grid.get(), katana::MessageDelivery::kAuto);
+
+  auto clique = katana::MakeClique(100);
+  katana::NUMAArray<uint64_t> sums;
+  sums.allocateBlocked(clique->NumNodes());
+  std::fill(sums.begin(), sums.end(), 0);
+  SumToFirst program;
+  auto stats_result = katana::RunVertexProgram(clique.get(), &program, &sums);
+  KATANA_LOG_VASSERT(
+      stats_result, "RunVertexProgram failed: {}", stats_result.error());
+  KATANA_LOG_ASSERT(stats_result.value().supersteps == 2);
+  KATANA_LOG_ASSERT(stats_result.value().messages == 100);
+  KATANA_LOG_ASSERT(sums[0] == 100 * 99 / 2);
+  KATANA_LOG_ASSERT(std::all_of(
+      sums.begin() + 1, sums.end(), [](uint64_t v) { return v == 0; }));
+
+  katana::NUMAArray<uint64_t> too_few;
+  too_few.allocateBlocked(3);
+  KATANA_LOG_ASSERT(
+      !katana::RunVertexProgram(clique.get(), &program, &too_few));
+
+  return 0;
+}
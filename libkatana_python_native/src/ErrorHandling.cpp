@@ -39,6 +39,7 @@ GetPythonExceptionType(std::error_code code) {
     case katana::ErrorCode::BadVersion:
     case katana::ErrorCode::MpiError:
     case katana::ErrorCode::GSError:
+    case katana::ErrorCode::TransactionConflict:
       break;
     }
   }
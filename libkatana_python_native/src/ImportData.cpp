@@ -1,3 +1,6 @@
+#include <memory>
+#include <utility>
+
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
@@ -12,13 +15,27 @@ namespace py = pybind11;
 
 namespace {
 
+/// Contiguous arrays of T. Arrays of other element types or layouts are
+/// converted, which copies them; others are used as they are.
+template <typename T>
+using CSRArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+/// A topology that uses the arrays in place. It keeps references to them,
+/// which it drops with the GIL held, so they live as long as it does. Call
+/// with the GIL held.
 katana::GraphTopology
 TopologyFromCSR(
-    const py::array_t<katana::PropertyGraph::Edge>& edge_indices,
-    const py::array_t<katana::PropertyGraph::Node>& edge_destinations) {
+    const CSRArray<katana::PropertyGraph::Edge>& edge_indices,
+    const CSRArray<katana::PropertyGraph::Node>& edge_destinations) {
+  using Arrays = std::pair<py::array, py::array>;
+  std::shared_ptr<const void> storage(
+      new Arrays(edge_indices, edge_destinations), [](const Arrays* arrays) {
+        py::gil_scoped_acquire acquire;
+        delete arrays;
+      });
   return katana::GraphTopology(
       edge_indices.data(), edge_indices.size(), edge_destinations.data(),
-      edge_destinations.size());
+      edge_destinations.size(), std::move(storage));
 }
 
 }  // namespace
@@ -36,15 +53,21 @@ katana::python::InitImportData(py::module& m) {
 
   m.def(
       "from_csr",
-      [](py::array_t<PropertyGraph::Edge> edge_indices,
-         py::array_t<PropertyGraph::Node> edge_destinations)
+      [](CSRArray<PropertyGraph::Edge> edge_indices,
+         CSRArray<PropertyGraph::Node> edge_destinations)
           -> Result<std::shared_ptr<PropertyGraph>> {
-        return KATANA_CHECKED(katana::PropertyGraph::Make(
-            TopologyFromCSR(edge_indices, edge_destinations)));
+        GraphTopology topology =
+            TopologyFromCSR(edge_indices, edge_destinations);
+        py::gil_scoped_release release;
+        return KATANA_CHECKED(katana::PropertyGraph::Make(std::move(topology)));
       },
       R"""(
       Create a new `Graph` from a raw Compressed Sparse Row representation.
 
+      Contiguous arrays of uint64 indices and uint32 destinations become the
+      topology of the graph without a copy, so they must not change while the
+      graph lives. Other arrays are converted first.
+
       :param edge_indices: The indicies of the first edge for each node in the destinations vector.
       :type edge_indices: `numpy.ndarray` or another type supporting the buffer protocol. Element type must be an
           integer.
@@ -56,13 +79,16 @@ katana::python::InitImportData(py::module& m) {
 
   m.def(
       "_from_csr_and_raw_types",
-      [](const py::array_t<PropertyGraph::Edge> edge_indices,
-         const py::array_t<PropertyGraph::Node> edge_destinations,
+      [](const CSRArray<PropertyGraph::Edge> edge_indices,
+         const CSRArray<PropertyGraph::Node> edge_destinations,
          const py::array_t<EntityTypeID> node_types,
          const py::array_t<EntityTypeID> edge_types,
          const EntityTypeManager& node_type_manager,
          const EntityTypeManager& edge_type_manager)
           -> Result<std::shared_ptr<PropertyGraph>> {
+        GraphTopology topology =
+            TopologyFromCSR(edge_indices, edge_destinations);
+        py::gil_scoped_release release;
         NUMAArray<EntityTypeID> node_types_owned;
         node_types_owned.allocateBlocked(node_types.size());
         katana::ParallelSTL::copy(
@@ -76,9 +102,8 @@ katana::python::InitImportData(py::module& m) {
         EntityTypeManager node_type_manager_owned = node_type_manager;
         EntityTypeManager edge_type_manager_owned = edge_type_manager;
         return KATANA_CHECKED(katana::PropertyGraph::Make(
-            TopologyFromCSR(edge_indices, edge_destinations),
-            std::move(node_types_owned), std::move(edge_types_owned),
-            std::move(node_type_manager_owned),
+            std::move(topology), std::move(node_types_owned),
+            std::move(edge_types_owned), std::move(node_type_manager_owned),
             std::move(edge_type_manager_owned)));
       });
 }
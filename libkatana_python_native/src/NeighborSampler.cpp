@@ -0,0 +1,152 @@
+#include "katana/analytics/neighbor_sampling/neighbor_sampling.h"
+
+#include <arrow/python/pyarrow.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "katana/python/Conventions.h"
+#include "katana/python/ErrorHandling.h"
+#include "katana/python/PythonModuleInitializers.h"
+
+namespace py = pybind11;
+
+using katana::analytics::NeighborSample;
+using katana::analytics::NeighborSampler;
+using katana::analytics::SampledBlock;
+
+namespace {
+
+/// A numpy array over the memory of array, which owner keeps alive
+template <typename T>
+py::array_t<T>
+WrapArray(const katana::NUMAArray<T>& array, const py::object& owner) {
+  return py::array_t<T>(
+      {static_cast<ssize_t>(array.size())}, {sizeof(T)}, array.data(), owner);
+}
+
+/// Fanouts are either a list of ints, one per hop, or a list of dicts from
+/// edge type name to fanout
+katana::Result<std::unique_ptr<NeighborSampler>>
+MakeSampler(
+    katana::PropertyGraph* pg, const py::list& fanouts,
+    const std::vector<std::string>& feature_properties,
+    const std::string& direction) {
+  NeighborSampler::Direction dir;
+  if (direction == "in") {
+    dir = NeighborSampler::kInEdges;
+  } else if (direction == "out") {
+    dir = NeighborSampler::kOutEdges;
+  } else {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "direction must be \"in\" or \"out\", not {}", direction);
+  }
+
+  bool typed = false;
+  for (const auto& hop : fanouts) {
+    typed |= py::isinstance<py::dict>(hop);
+  }
+  if (!typed) {
+    return NeighborSampler::Make(
+        pg, py::cast<std::vector<uint32_t>>(fanouts), feature_properties, dir);
+  }
+
+  const katana::EntityTypeManager& types = pg->GetEdgeTypeManager();
+  std::vector<std::vector<NeighborSampler::TypedFanout>> typed_fanouts;
+  for (const auto& hop : fanouts) {
+    if (!py::isinstance<py::dict>(hop)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "fanouts must all be ints or all be dicts from edge type to fanout");
+    }
+    auto& hop_fanouts = typed_fanouts.emplace_back();
+    for (const auto& [name, fanout] : py::cast<py::dict>(hop)) {
+      auto type_name = py::cast<std::string>(name);
+      if (!types.HasAtomicType(type_name)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::NotFound, "edge type {} does not exist",
+            type_name);
+      }
+      hop_fanouts.push_back(
+          {types.GetEntityTypeID(type_name), py::cast<uint32_t>(fanout)});
+    }
+  }
+  return NeighborSampler::Make(pg, typed_fanouts, feature_properties, dir);
+}
+
+}  // namespace
+
+void
+katana::python::InitNeighborSampler(py::module& m) {
+  py::class_<NeighborSample, std::shared_ptr<NeighborSample>> sample_cls(
+      m, "NeighborSample",
+      "The sampled computation graph of a batch of seed nodes, with one block "
+      "per hop ordered from the input layer to the seeds.");
+  sample_cls.def_property_readonly(
+      "blocks",
+      [](const py::object& self) {
+        const auto& sample = py::cast<const NeighborSample&>(self);
+        py::list blocks;
+        for (const SampledBlock& block : sample.blocks) {
+          py::dict b;
+          b["num_dst_nodes"] = block.num_dst_nodes;
+          b["src_nodes"] = WrapArray(block.src_nodes, self);
+          b["indptr"] = WrapArray(block.indptr, self);
+          b["src_indices"] = WrapArray(block.src_indices, self);
+          b["edge_ids"] = WrapArray(block.edge_ids, self);
+          blocks.append(b);
+        }
+        return blocks;
+      },
+      "The blocks as dicts of numpy arrays in CSR form. The arrays share the "
+      "memory of the sample. The destination nodes of a block are the first "
+      "``num_dst_nodes`` of its ``src_nodes``.");
+  sample_cls.def_property_readonly(
+      "input_nodes",
+      [](const py::object& self) {
+        const auto& sample = py::cast<const NeighborSample&>(self);
+        return WrapArray(sample.input_nodes(), self);
+      },
+      "The source nodes of the first block, which the features belong to.");
+  sample_cls.def_property_readonly(
+      "node_features",
+      [](const NeighborSample& self) {
+        return py::reinterpret_steal<py::object>(
+            arrow::py::wrap_table(self.node_features));
+      },
+      "The feature properties of the input nodes as a pyarrow Table.");
+
+  py::class_<NeighborSampler> cls(
+      m, "NeighborSampler",
+      "Samples the k-hop neighborhoods of seed nodes for mini-batch GNN "
+      "training. ``fanouts`` is a list with the number of edges to keep per "
+      "node at each hop from the seeds, or a list of dicts from edge type "
+      "name to that number. ``feature_properties`` are fixed width node "
+      "properties gathered for the input nodes. ``direction`` is \"in\" to "
+      "sample in-edges or \"out\" to sample out-edges.");
+  katana::DefConventions(cls);
+  cls.def(
+      py::init([](katana::PropertyGraph* pg, const py::list& fanouts,
+                  const std::vector<std::string>& feature_properties,
+                  const std::string& direction) {
+        return PythonChecked(
+            MakeSampler(pg, fanouts, feature_properties, direction));
+      }),
+      py::arg("graph"), py::arg("fanouts"),
+      py::arg("feature_properties") = std::vector<std::string>(),
+      py::arg("direction") = "in", py::keep_alive<1, 2>());
+  cls.def_property_readonly("num_hops", &NeighborSampler::num_hops);
+  cls.def(
+      "sample",
+      [](NeighborSampler& self, const std::vector<NeighborSampler::Node>& seeds,
+         uint32_t random_seed)
+          -> katana::Result<std::shared_ptr<NeighborSample>> {
+        return std::make_shared<NeighborSample>(
+            KATANA_CHECKED(self.Sample(seeds, random_seed)));
+      },
+      py::arg("seeds"), py::arg("random_seed") = 0,
+      py::call_guard<py::gil_scoped_release>(),
+      "Sample the neighborhoods of the distinct nodes ``seeds``. The same "
+      "``random_seed`` gives the same sample.");
+}
@@ -4,13 +4,18 @@
 
 // Must come after numpy/ndarrayobject.h since that is required, but
 // not included by arrow/python headers.
+#include <arrow/c/bridge.h>
 #include <arrow/python/numpy_convert.h>
 #include <arrow/python/numpy_to_arrow.h>
+#include <arrow/python/pyarrow.h>
 #include <arrow/python/python_to_arrow.h>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "katana/Galois.h"
+#include "katana/GraphRecordBatches.h"
+#include "katana/PropertyFilter.h"
 #include "katana/python/Conventions.h"
 #include "katana/python/CythonIntegration.h"
 #include "katana/python/EntityTypeManagerPython.h"
@@ -122,13 +127,14 @@ GraphBaseEdgeDestAccessor::~GraphBaseEdgeDestAccessor() = default;
 
 class GraphBaseEdgeSourceAccessor final
     : public LazyDataAccessorTyped<katana::PropertyGraph::Node> {
-  const katana::PropertyGraphViews::BiDirectional view_;
+  // reads the source of each edge instead of searching for it
+  const katana::PropertyGraphViews::EdgeSources view_;
 
 public:
   virtual ~GraphBaseEdgeSourceAccessor();
 
   GraphBaseEdgeSourceAccessor(katana::PropertyGraph* pg)
-      : view_(pg->BuildView<katana::PropertyGraphViews::BiDirectional>()) {}
+      : view_(pg->BuildView<katana::PropertyGraphViews::EdgeSources>()) {}
 
   katana::PropertyGraph::Node at_typed(ssize_t i) const final {
     return view_.GetEdgeSrc(i);
@@ -145,6 +151,67 @@ out_edge_dst(katana::PropertyGraph* pg, katana::GraphTopologyTypes::Edge e) {
   return *pg->OutEdgeDst(e);
 }
 
+/// A read-only numpy array over the size values at data, which owner keeps
+/// alive
+template <typename T>
+py::array_t<T>
+WrapReadOnlyArray(const T* data, size_t size, const py::object& owner) {
+  py::array_t<T> array(
+      {static_cast<ssize_t>(size)}, {sizeof(T)}, data, owner);
+  array.attr("setflags")(py::arg("write") = false);
+  return array;
+}
+
+/// \returns reader as a pyarrow.RecordBatchReader, passed through the Arrow
+/// C stream interface so that batches are not copied
+katana::Result<py::object>
+WrapBatchReader(std::shared_ptr<arrow::RecordBatchReader> reader) {
+  ArrowArrayStream stream;
+  KATANA_CHECKED(arrow::ExportRecordBatchReader(std::move(reader), &stream));
+  return py::module::import("pyarrow")
+      .attr("RecordBatchReader")
+      .attr("_import_from_c")(reinterpret_cast<uintptr_t>(&stream));
+}
+
+/// \returns expression, a pyarrow.compute.Expression, as a C++ expression.
+/// Expressions cross over in the serialized form that pickle uses.
+katana::Result<arrow::compute::Expression>
+UnwrapExpression(const py::object& expression) {
+  py::tuple reduced = expression.attr("__reduce__")();
+  py::object serialized = py::tuple(reduced[1])[0];
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::py::unwrap_buffer(serialized.ptr()));
+  return KATANA_CHECKED(arrow::compute::Deserialize(buffer));
+}
+
+/// \returns expression as a pyarrow.compute.Expression
+katana::Result<py::object>
+WrapExpression(const arrow::compute::Expression& expression) {
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::compute::Serialize(expression));
+  return py::module::import("pyarrow.dataset")
+      .attr("Expression")
+      .attr("_deserialize")(py::reinterpret_steal<py::object>(
+          arrow::py::wrap_buffer(buffer)));
+}
+
+/// The ids of the entities selected in bitset as a numpy array that owns
+/// them
+template <typename T>
+py::array_t<T>
+SelectedIds(const katana::DynamicBitset& bitset) {
+  auto ids = std::make_unique<std::vector<T>>();
+  {
+    py::gil_scoped_release release;
+    *ids = bitset.GetOffsets<T>();
+  }
+  const T* data = ids->data();
+  size_t size = ids->size();
+  py::capsule owner(
+      ids.release(), [](void* p) { delete static_cast<std::vector<T>*>(p); });
+  return py::array_t<T>({static_cast<ssize_t>(size)}, {sizeof(T)}, data, owner);
+}
+
 auto
 PropertyGraphTopologyOutEdges(katana::PropertyGraph* pg) {
   return pg->topology().OutEdges();
@@ -163,7 +230,7 @@ class PropertyGraphNumbaReplacement {
   const std::shared_ptr<katana::PropertyGraph> graph_;
   std::optional<katana::PropertyGraphViews::Transposed> transposed_;
   std::optional<katana::PropertyGraphViews::Undirected> undirected_;
-  std::optional<katana::PropertyGraphViews::BiDirectional> bi_directional_;
+  std::optional<katana::PropertyGraphViews::EdgeSources> edge_sources_;
   std::optional<katana::PropertyGraphViews::EdgeTypeAwareBiDir>
       type_aware_bi_dir_;
 
@@ -181,9 +248,9 @@ class PropertyGraphNumbaReplacement {
     return undirected_.value();
   }
 
-  auto& bi_directional() {
-    KATANA_LOG_ASSERT(bi_directional_.has_value());
-    return bi_directional_.value();
+  auto& edge_sources() {
+    KATANA_LOG_ASSERT(edge_sources_.has_value());
+    return edge_sources_.value();
   }
 
   auto& type_aware_bi_dir() {
@@ -197,11 +264,11 @@ public:
       : graph_(std::move(graph)) {}
 
   void WithTransposed() {
-    // Put these together since bi_directional is just a combination of the
-    // default (free) topology and transposed.
+    // Put these together since edge sources are cheap next to the
+    // transpose, and in-edge users usually want the sources of out-edges too.
     transposed_ = graph_->BuildView<katana::PropertyGraphViews::Transposed>();
-    bi_directional_ =
-        graph_->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    edge_sources_ =
+        graph_->BuildView<katana::PropertyGraphViews::EdgeSources>();
   }
 
   void WithUndirected() {
@@ -217,7 +284,7 @@ public:
   auto NumEdges() { return graph().NumEdges(); }
 
   auto OutEdgeDst(Edge e) { return *graph().OutEdgeDst(e); }
-  auto GetEdgeSrc(Edge e) { return bi_directional().GetEdgeSrc(e); }
+  auto GetEdgeSrc(Edge e) { return edge_sources().GetEdgeSrc(e); }
 
   auto OutEdges() { return graph().OutEdges(); }
   auto OutEdgesForNode(Node n) { return graph().OutEdges(n); }
@@ -363,14 +430,19 @@ DefPropertyGraph(py::module& m) {
              std::optional<std::vector<std::string>> edge_properties,
              TxnContext* txn_ctx) -> std::shared_ptr<PropertyGraph> {
             auto path_str = py::str(path).cast<std::string>();
-            py::gil_scoped_release guard;
-            katana::RDGLoadOptions options = katana::RDGLoadOptions::Defaults();
-            options.node_properties = node_properties;
-            options.edge_properties = edge_properties;
-            TxnContextArgumentHandler txn_context_handler(txn_ctx);
-            KATANA_LOG_DEBUG("{}", reinterpret_cast<uintptr_t>(path.ptr()));
-            return PythonChecked(PropertyGraph::Make(
-                path_str, txn_context_handler.get(), options));
+            auto pg = [&]() {
+              py::gil_scoped_release guard;
+              katana::RDGLoadOptions options =
+                  katana::RDGLoadOptions::Defaults();
+              options.node_properties = node_properties;
+              options.edge_properties = edge_properties;
+              TxnContextArgumentHandler txn_context_handler(txn_ctx);
+              KATANA_LOG_DEBUG("{}", reinterpret_cast<uintptr_t>(path.ptr()));
+              return PropertyGraph::Make(
+                  path_str, txn_context_handler.get(), options);
+            }();
+            // raising the error needs the GIL
+            return PythonChecked(std::move(pg));
           }),
       py::arg("path"), py::kw_only(), py::arg("node_properties") = std::nullopt,
       py::arg("edge_properties") = std::nullopt,
@@ -402,7 +474,7 @@ DefPropertyGraph(py::module& m) {
   cls.def(
       "project",
       [](PropertyGraph& self, py::object node_types,
-         py::object edge_types) -> std::shared_ptr<PropertyGraph> {
+         py::object edge_types) -> Result<std::shared_ptr<PropertyGraph>> {
         std::optional<katana::SetOfEntityTypeIDs> node_type_ids;
         if (!node_types.is_none()) {
           node_type_ids = katana::SetOfEntityTypeIDs();
@@ -423,8 +495,9 @@ DefPropertyGraph(py::module& m) {
         py::gil_scoped_release
             guard;  // graph projection may copy or load data.
         // is_none is safe without the GIL because it is just a pointer compare.
-        return PythonChecked(PropertyGraph::MakeProjectedGraph(
-            self, node_type_ids, edge_type_ids));
+        return std::shared_ptr<PropertyGraph>(
+            KATANA_CHECKED(PropertyGraph::MakeProjectedGraph(
+                self, node_type_ids, edge_type_ids)));
       },
       py::arg("node_types") = py::none(), py::arg("edge_types") = py::none(),
       py::return_value_policy::reference_internal,
@@ -849,8 +922,7 @@ DefPropertyGraph(py::module& m) {
   cls.def(
       "get_edge_src",
       [](PropertyGraph& self, GraphTopologyTypes::Edge e) {
-        return self.BuildView<PropertyGraphViews::BiDirectional>().GetEdgeSrc(
-            e);
+        return self.BuildView<PropertyGraphViews::EdgeSources>().GetEdgeSrc(e);
       },
       py::call_guard<py::gil_scoped_release>());
   katana::DefWithNumba<&PropertyGraphNumbaReplacement::GetEdgeSrc>(
@@ -863,6 +935,62 @@ DefPropertyGraph(py::module& m) {
   katana::DefWithNumba<&PropertyGraphNumbaReplacement::OutEdgeDst>(
       cls_numba_replacement, "get_edge_dst");
 
+  cls.def(
+      "adj_indices",
+      [](const py::object& self) {
+        const auto& topo = py::cast<const PropertyGraph&>(self).topology();
+        return WrapReadOnlyArray(topo.AdjData(), topo.NumNodes(), self);
+      },
+      R"""(
+      Get the end of the out-edges of each node as a read-only numpy array
+      over the memory of the graph, without copying. The out-edges of node n
+      are the edge ids from adj_indices()[n - 1] (0 for node 0) up to
+      adj_indices()[n]. The array stays valid while the graph is alive.
+      To pass it to PyTorch without copying, use ``torch.from_numpy`` or
+      ``torch.from_dlpack``.
+      )""");
+  cls.def(
+      "edge_dests",
+      [](const py::object& self) {
+        const auto& topo = py::cast<const PropertyGraph&>(self).topology();
+        return WrapReadOnlyArray(topo.DestData(), topo.NumEdges(), self);
+      },
+      R"""(
+      Get the destination of each edge as a read-only numpy array over the
+      memory of the graph, without copying. The array stays valid while the
+      graph is alive.
+      )""");
+  cls.def(
+      "edge_sources",
+      [](const PropertyGraph& self) {
+        auto sources = std::make_unique<NUMAArray<GraphTopologyTypes::Node>>();
+        {
+          py::gil_scoped_release release;
+          const GraphTopology& topo = self.topology();
+          sources->allocateInterleaved(topo.NumEdges());
+          katana::do_all(
+              katana::iterate(topo.Nodes()),
+              [&](GraphTopologyTypes::Node n) {
+                for (auto e : topo.OutEdges(n)) {
+                  (*sources)[e] = n;
+                }
+              },
+              katana::steal(), katana::no_stats());
+        }
+        const GraphTopologyTypes::Node* data = sources->data();
+        size_t size = sources->size();
+        py::capsule owner(sources.release(), [](void* p) {
+          delete static_cast<NUMAArray<GraphTopologyTypes::Node>*>(p);
+        });
+        return WrapReadOnlyArray(data, size, owner);
+      },
+      R"""(
+      Get the source of each edge as a read-only numpy array. Sources are not
+      stored, so this computes them in parallel into a new array. Together
+      with `edge_dests`, this gives the ``edge_index`` of PyTorch Geometric:
+      ``numpy.stack([graph.edge_sources(), graph.edge_dests()])``.
+      )""");
+
   // In addition, all access views will support property and type queries:
 
   // GetNodeProperty(string) -> PropertyArray - property array for all nodes
@@ -870,21 +998,142 @@ DefPropertyGraph(py::module& m) {
       "get_node_property",
       [](PropertyGraph& self,
          const std::string& name) -> katana::Result<py::object> {
-        KATANA_CHECKED(self.EnsureNodePropertyLoaded(name));
-        return py::reinterpret_steal<py::object>(arrow::py::wrap_chunked_array(
-            KATANA_CHECKED(self.GetNodeProperty(name))));
-      },
-      py::call_guard<py::gil_scoped_release>());
+        std::shared_ptr<arrow::ChunkedArray> property;
+        {
+          py::gil_scoped_release release;
+          KATANA_CHECKED(self.EnsureNodePropertyLoaded(name));
+          property = KATANA_CHECKED(self.GetNodeProperty(name));
+        }
+        return py::reinterpret_steal<py::object>(
+            arrow::py::wrap_chunked_array(property));
+      });
   // GetEdgeProperty(string) -> PropertyArray - property array for all edges
   cls.def(
       "get_edge_property",
       [](PropertyGraph& self,
          const std::string& name) -> katana::Result<py::object> {
-        KATANA_CHECKED(self.EnsureEdgePropertyLoaded(name));
-        return py::reinterpret_steal<py::object>(arrow::py::wrap_chunked_array(
-            KATANA_CHECKED(self.GetEdgeProperty(name))));
+        std::shared_ptr<arrow::ChunkedArray> property;
+        {
+          py::gil_scoped_release release;
+          KATANA_CHECKED(self.EnsureEdgePropertyLoaded(name));
+          property = KATANA_CHECKED(self.GetEdgeProperty(name));
+        }
+        return py::reinterpret_steal<py::object>(
+            arrow::py::wrap_chunked_array(property));
+      });
+
+  cls.def(
+      "node_property_batches",
+      [](PropertyGraph& self, const std::vector<std::string>& properties,
+         int64_t max_batch_rows) -> katana::Result<py::object> {
+        return WrapBatchReader(KATANA_CHECKED(
+            MakeNodePropertyBatchReader(self, properties, max_batch_rows)));
       },
-      py::call_guard<py::gil_scoped_release>());
+      py::arg("properties") = std::vector<std::string>(),
+      py::arg("max_batch_rows") = kDefaultMaxBatchRows,
+      R"""(
+      Stream the loaded node properties, or only those named in properties, as
+      a pyarrow.RecordBatchReader of at most max_batch_rows rows per batch.
+      Batches share the memory of the graph, and the reader is not affected by
+      later changes to the properties, so it can be served as is, e.g., with
+      ``pyarrow.flight.RecordBatchStream``.
+      )""");
+  cls.def(
+      "edge_property_batches",
+      [](PropertyGraph& self, const std::vector<std::string>& properties,
+         int64_t max_batch_rows) -> katana::Result<py::object> {
+        return WrapBatchReader(KATANA_CHECKED(
+            MakeEdgePropertyBatchReader(self, properties, max_batch_rows)));
+      },
+      py::arg("properties") = std::vector<std::string>(),
+      py::arg("max_batch_rows") = kDefaultMaxBatchRows,
+      R"""(
+      Stream the loaded edge properties, or only those named in properties, as
+      a pyarrow.RecordBatchReader. See `node_property_batches`.
+      )""");
+  cls.def(
+      "edge_list_batches",
+      [](std::shared_ptr<PropertyGraph> self,
+         int64_t max_batch_rows) -> katana::Result<py::object> {
+        return WrapBatchReader(KATANA_CHECKED(
+            MakeEdgeListBatchReader(std::move(self), max_batch_rows)));
+      },
+      py::arg("max_batch_rows") = kDefaultMaxBatchRows,
+      R"""(
+      Stream the edges of the graph in edge id order as a
+      pyarrow.RecordBatchReader with columns ``source`` and ``dest``. The
+      reader keeps the graph alive.
+      )""");
+
+  cls.def(
+      "filter_nodes",
+      [](PropertyGraph& self,
+         const py::object& expression) -> katana::Result<py::object> {
+        arrow::compute::Expression filter =
+            KATANA_CHECKED(UnwrapExpression(expression));
+        katana::DynamicBitset selected;
+        {
+          py::gil_scoped_release release;
+          selected = KATANA_CHECKED(katana::FilterNodes(&self, filter));
+        }
+        return SelectedIds<uint32_t>(selected);
+      },
+      py::arg("expression"),
+      R"""(
+      Get the nodes that satisfy expression as a numpy array of node ids in
+      ascending order. The expression is a boolean
+      ``pyarrow.compute.Expression`` over node properties, referred to with
+      ``pyarrow.dataset.field``, and `node_has_type`; nodes for which it is
+      null are not selected. It is evaluated in parallel, in C++, without
+      copying properties to Python::
+
+          import pyarrow.dataset as ds
+          adults = (ds.field("age") >= 18) & graph.node_has_type(person)
+          nodes = graph.filter_nodes(adults)
+      )""");
+  cls.def(
+      "filter_edges",
+      [](PropertyGraph& self,
+         const py::object& expression) -> katana::Result<py::object> {
+        arrow::compute::Expression filter =
+            KATANA_CHECKED(UnwrapExpression(expression));
+        katana::DynamicBitset selected;
+        {
+          py::gil_scoped_release release;
+          selected = KATANA_CHECKED(katana::FilterEdges(&self, filter));
+        }
+        return SelectedIds<uint64_t>(selected);
+      },
+      py::arg("expression"),
+      R"""(
+      Get the edges that satisfy expression, a boolean expression over edge
+      properties and `edge_has_type`, as a numpy array of edge ids in
+      ascending order. See `filter_nodes`.
+      )""");
+  cls.def(
+      "node_has_type",
+      [](PropertyGraph& self,
+         const EntityType& type) -> katana::Result<py::object> {
+        return WrapExpression(
+            KATANA_CHECKED(katana::NodeHasType(self, type.type_id)));
+      },
+      py::arg("type"),
+      R"""(
+      Get a ``pyarrow.compute.Expression`` for `filter_nodes` that selects the
+      nodes that have type, i.e., whose type is type or one of its subtypes.
+      )""");
+  cls.def(
+      "edge_has_type",
+      [](PropertyGraph& self,
+         const EntityType& type) -> katana::Result<py::object> {
+        return WrapExpression(
+            KATANA_CHECKED(katana::EdgeHasType(self, type.type_id)));
+      },
+      py::arg("type"),
+      R"""(
+      Get a ``pyarrow.compute.Expression`` for `filter_edges` that selects the
+      edges that have type. See `node_has_type`.
+      )""");
 
   cls.def(
       "unload_node_property", &PropertyGraph::UnloadNodeProperty,
@@ -1006,27 +1255,49 @@ DefPropertyGraph(py::module& m) {
   cls.def("has_node_index", &PropertyGraph::HasNodeIndex, py::arg("name"));
   cls.def(
       "get_node_index",
-      [](PropertyGraph& self, const std::string& name)
-          -> std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Node>> {
+      [](PropertyGraph& self, const std::string& name, bool hash)
+          -> Result<std::shared_ptr<
+              katana::EntityIndex<katana::GraphTopology::Node>>> {
         if (!self.HasNodeIndex(name)) {
-          PythonChecked(self.MakeNodeIndex(name));
+          KATANA_CHECKED(self.MakeNodeIndex(
+              name, hash ? katana::EntityIndexKind::kHash
+                         : katana::EntityIndexKind::kOrdered));
         }
-        return PythonChecked(self.GetNodeIndex(name));
+        return KATANA_CHECKED(self.GetNodeIndex(name));
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::arg("hash") = false,
+      py::return_value_policy::reference_internal,
+      py::call_guard<py::gil_scoped_release>(),
+      R"""(
+      Return the index over the named node property, creating it if there is
+      none. A created index is a hash index if hash is true, which is faster
+      for lookups of single values, and an ordered index otherwise.
+      )""");
   cls.def("has_edge_index", &PropertyGraph::HasEdgeIndex, py::arg("name"));
   cls.def(
       "get_edge_index",
-      [](PropertyGraph& self, const std::string& name)
-          -> std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> {
+      [](PropertyGraph& self, const std::string& name, bool hash)
+          -> Result<std::shared_ptr<
+              katana::EntityIndex<katana::GraphTopology::Edge>>> {
         if (!self.HasEdgeIndex(name)) {
-          PythonChecked(self.MakeEdgeIndex(name));
+          KATANA_CHECKED(self.MakeEdgeIndex(
+              name, hash ? katana::EntityIndexKind::kHash
+                         : katana::EntityIndexKind::kOrdered));
         }
-        return PythonChecked(self.GetEdgeIndex(name));
+        return KATANA_CHECKED(self.GetEdgeIndex(name));
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::arg("hash") = false,
+      py::return_value_policy::reference_internal,
+      py::call_guard<py::gil_scoped_release>(),
+      R"""(
+      Return the index over the named edge property, creating it if there is
+      none. A created index is a hash index if hash is true, which is faster
+      for lookups of single values, and an ordered index otherwise.
+      )""");
 
-  cls.def("unload_topologies", &PropertyGraph::DropAllTopologies);
+  cls.def(
+      "unload_topologies", &PropertyGraph::DropAllTopologies,
+      py::call_guard<py::gil_scoped_release>());
 
   cls.def(
       "write",
@@ -1054,6 +1325,50 @@ DefPropertyGraph(py::module& m) {
   cls.def_property_readonly("path", &PropertyGraph::rdg_dir);
 }
 
+/// An Arrow buffer over the memory of a NUMAArray, which it owns
+template <typename T>
+class NUMAArrayBuffer : public arrow::Buffer {
+public:
+  explicit NUMAArrayBuffer(katana::NUMAArray<T>&& array)
+      : arrow::Buffer(
+            reinterpret_cast<const uint8_t*>(array.data()),
+            array.size() * sizeof(T)),
+        array_(std::move(array)) {}
+
+private:
+  katana::NUMAArray<T> array_;
+};
+
+/// \returns the ids index finds for keys as an Arrow array that is null where
+/// a key was not found, without copying the ids
+template <typename node_or_edge>
+katana::Result<std::shared_ptr<arrow::Array>>
+FindManyToArrow(
+    katana::EntityIndex<node_or_edge>* index, const arrow::Array& keys) {
+  katana::NUMAArray<node_or_edge> found = KATANA_CHECKED(index->FindMany(keys));
+  size_t size = found.size();
+
+  std::shared_ptr<arrow::Buffer> validity =
+      KATANA_CHECKED(arrow::AllocateBitmap(size));
+  uint8_t* bits = validity->mutable_data();
+  katana::do_all(
+      katana::iterate(size_t{0}, (size + 7) / 8),
+      [&](size_t byte) {
+        uint8_t valid = 0;
+        for (size_t i = byte * 8; i < std::min(size, byte * 8 + 8); ++i) {
+          valid |= uint8_t{found[i] != index->kNotFound} << (i % 8);
+        }
+        bits[byte] = valid;
+      },
+      katana::no_stats());
+
+  auto values = std::make_shared<NUMAArrayBuffer<node_or_edge>>(
+      std::move(found));
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      arrow::CTypeTraits<node_or_edge>::type_singleton(), size,
+      {std::move(validity), std::move(values)}));
+}
+
 template <typename node_or_edge>
 struct WrapPrimitiveEntityIndex {
   py::class_<
@@ -1102,6 +1417,34 @@ struct WrapStringEntityIndex {
   }
 };
 
+template <typename node_or_edge>
+struct WrapHashEntityIndex {
+  py::class_<
+      katana::EntityIndex<node_or_edge>,
+      std::shared_ptr<katana::EntityIndex<node_or_edge>>>
+      base_cls;
+
+  template <typename T, typename KeyType = T>
+  py::object instantiate(py::module& m, const char* name) {
+    using Cls = katana::HashEntityIndex<node_or_edge, KeyType>;
+    py::class_<Cls, std::shared_ptr<Cls>> cls(m, name, base_cls);
+
+    cls.template def("__getitem__", [](Cls& self, const T& v) {
+      auto it = self.Find(v);
+      if (it == self.end()) {
+        throw py::key_error("value not in index");
+      }
+      return *it;
+    });
+    cls.template def("find_all", [](Cls& self, const T& v) {
+      auto [begin, end] = self.EqualRange(v);
+      return py::make_iterator(begin, end);
+    });
+
+    return std::move(cls);
+  }
+};
+
 template <typename node_or_edge>
 void
 DefEntityIndex(py::module& m) {
@@ -1113,6 +1456,32 @@ DefEntityIndex(py::module& m) {
       m, cls_name.c_str());
 
   cls.template def("property_name", &EntityIndex::property_name);
+  cls.template def(
+      "find_many",
+      [](EntityIndex& self, py::object keys) -> katana::Result<py::object> {
+        if (!arrow::py::is_array(keys.ptr())) {
+          keys = py::module::import("pyarrow").attr("array")(keys);
+        }
+        std::shared_ptr<arrow::Array> key_array =
+            KATANA_CHECKED(arrow::py::unwrap_array(keys.ptr()));
+        std::shared_ptr<arrow::Array> ids;
+        {
+          py::gil_scoped_release release;
+          ids = KATANA_CHECKED(FindManyToArrow(&self, *key_array));
+        }
+        return py::reinterpret_steal<py::object>(arrow::py::wrap_array(ids));
+      },
+      py::arg("keys"),
+      R"""(
+      Look up many keys at once, which is much faster than looking them up one
+      at a time.
+
+      :param keys: The values to look up, cast to the type of the property.
+      :type keys: pyarrow.Array or a sequence
+      :returns: For each key, the first id with that value, or null if there is
+          none.
+      :rtype: pyarrow.Array
+      )""");
   katana::DefContainer(cls);
 
   katana::InstantiateForTypes<bool, uint8_t, int64_t, uint64_t, double_t>(
@@ -1120,6 +1489,12 @@ DefEntityIndex(py::module& m) {
       WrapPrimitiveEntityIndex<node_or_edge>{cls});
   WrapStringEntityIndex<node_or_edge>{cls}.instantiate(
       m, ("String" + cls_name).c_str());
+  katana::InstantiateForTypes<bool, uint8_t, int64_t, uint64_t, double_t>(
+      m, ("PrimitiveHash" + cls_name).c_str(),
+      WrapHashEntityIndex<node_or_edge>{cls});
+  WrapHashEntityIndex<node_or_edge>{cls}
+      .template instantiate<std::string, std::string_view>(
+          m, ("StringHash" + cls_name).c_str());
 }
 
 void
@@ -3,6 +3,7 @@
 #include <katana/python/NumbaSupport.h>
 #include <katana/python/PythonModuleInitializers.h>
 #include <katana/python/TemplateSupport.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
 namespace py = pybind11;
@@ -82,6 +83,70 @@ struct ReducibleFunctor {
   }
 };
 
+/// \returns a numpy array with a copy of values
+template <typename T>
+py::array_t<T>
+ToNumpy(const std::vector<T>& values) {
+  return py::array_t<T>(values.size(), values.data());
+}
+
+struct TopKFunctor {
+  template <typename T>
+  py::object instantiate(py::module& m, const char* name) {
+    using Cls = katana::GReduceTopK<T>;
+    py::class_<Cls> cls(
+        m, name,
+        "A reducer that keeps the ``k`` largest values it is updated with.\n"
+        "\n"
+        "This class can be passed into numba compiled code and it's methods "
+        "can be used from there.\n");
+    cls.def(py::init<size_t>(), py::arg("k"));
+    katana::RegisterNumbaClass(cls);
+    katana::DefWithNumba<py::overload_cast<const T&>(&Cls::update)>(
+        cls, "update", "Offer ``v`` as one of the largest values.");
+    cls.def(
+        "reduce", [](Cls& self) { return ToNumpy(self.reduce()); },
+        "Get the (at most) ``k`` largest values, largest first, as a numpy "
+        "array. This must only be called from single threaded code.");
+    cls.def_property_readonly("k", &Cls::k);
+    katana::DefWithNumba<&Cls::reset>(
+        cls, "reset",
+        "Forget all values. This must only be called from single threaded "
+        "code.");
+    katana::DefConventions(cls);
+    return std::move(cls);
+  }
+};
+
+void
+DefHistogram(py::module& m) {
+  using Cls = katana::GHistogram<uint64_t>;
+  py::class_<Cls> cls(
+      m, "ReduceHistogram",
+      "A reducer that counts values in ``num_bins`` bins. Each thread counts "
+      "into bins of its own, so updates do not contend.\n"
+      "\n"
+      "This class can be passed into numba compiled code and it's methods "
+      "can be used from there.\n");
+  cls.def(py::init<size_t>(), py::arg("num_bins"));
+  katana::RegisterNumbaClass(cls);
+  katana::DefWithNumba<py::overload_cast<size_t>(&Cls::update)>(
+      cls, "update", "Count one more value in ``bin``.");
+  katana::DefWithNumba<py::overload_cast<size_t, const uint64_t&>(
+      &Cls::update)>(
+      cls, "update_weighted", "Add ``weight`` to the count of ``bin``.");
+  cls.def(
+      "reduce", [](Cls& self) { return ToNumpy(self.reduce()); },
+      "Get the count of every bin as a numpy array. This must only be called "
+      "from single threaded code.");
+  cls.def_property_readonly("num_bins", &Cls::num_bins);
+  katana::DefWithNumba<&Cls::reset>(
+      cls, "reset",
+      "Reset all counts to 0. This must only be called from single threaded "
+      "code.");
+  katana::DefConventions(cls);
+}
+
 }  // namespace
 
 /// Add reduction classes to the module @p m.
@@ -98,4 +163,6 @@ katana::python::InitReductions(py::module& m) {
   // ReducibleFunctor.
   ReducibleFunctor<ForReduceLogicalOr>().instantiate<bool>(m, "ReduceOr");
   ReducibleFunctor<ForReduceLogicalAnd>().instantiate<bool>(m, "ReduceAnd");
+  katana::InstantiateForStandardTypes(m, "ReduceTopK", TopKFunctor());
+  DefHistogram(m);
 }
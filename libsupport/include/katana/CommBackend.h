@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -28,6 +29,12 @@ public:
       uint32_t root, const std::string& val, uint64_t max_size) = 0;
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
+  /// Send sends[i] to task i and receive what every task sent to this one;
+  /// entry i of the result is from task i. All tasks must call this together
+  /// with one entry per task. Backends that cannot exchange data support
+  /// only a single task.
+  virtual katana::Result<std::vector<std::string>> AllToAll(
+      std::vector<std::string> sends);
 
   /// The number of tasks involved
   uint32_t num() const { return Num; }
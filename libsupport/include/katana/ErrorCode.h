@@ -77,6 +77,7 @@ enum class ErrorCode {
   MpiError,
   BadVersion,
   GSError,
+  TransactionConflict,
 };
 
 KATANA_EXPORT ErrorCode ArrowToKatana(arrow::StatusCode);
@@ -136,6 +137,8 @@ public:
       return "some MPI process reported an error";
     case ErrorCode::GSError:
       return "Google storage error";
+    case ErrorCode::TransactionConflict:
+      return "transaction conflicts with a committed transaction";
     default:
       return "unknown error";
     }
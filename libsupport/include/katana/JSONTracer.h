@@ -7,18 +7,24 @@
 #include <vector>
 
 #include "katana/ProgressTracer.h"
+#include "katana/TraceSink.h"
 #include "katana/config.h"
 
 namespace katana {
 
-using OutputCB = std::function<void(const std::string&)>;
-
 class KATANA_EXPORT JSONTracer : public ProgressTracer {
 public:
+  ~JSONTracer() override { sink_->Close(); }
+
+  /// Make a tracer that writes to stdout from a background thread
   static std::unique_ptr<JSONTracer> Make(
       uint32_t host_id = 0, uint32_t num_hosts = 1);
+  /// Make a tracer that passes its lines to out_callback. With
+  /// buffer_lines > 0, they are buffered and passed from a background
+  /// thread; see TraceSink.
   static std::unique_ptr<JSONTracer> Make(
-      uint32_t host_id, uint32_t num_hosts, OutputCB out_callback);
+      uint32_t host_id, uint32_t num_hosts, OutputCB out_callback,
+      size_t buffer_lines = 0);
 
   std::shared_ptr<ProgressSpan> StartSpan(
       const std::string& span_name, const ProgressContext& child_of) override;
@@ -27,16 +33,17 @@ public:
   std::unique_ptr<ProgressContext> Extract(const std::string& carrier) override;
 
 private:
-  JSONTracer(uint32_t host_id, uint32_t num_hosts, OutputCB out_callback)
-      : ProgressTracer(host_id, num_hosts), out_callback_(out_callback) {}
+  JSONTracer(
+      uint32_t host_id, uint32_t num_hosts, std::shared_ptr<TraceSink> sink)
+      : ProgressTracer(host_id, num_hosts), sink_(std::move(sink)) {}
 
   std::shared_ptr<ProgressSpan> StartSpan(
       const std::string& span_name,
       std::shared_ptr<ProgressSpan> child_of) override;
 
-  void Close() override {}
+  void Close() override { sink_->Close(); }
 
-  OutputCB out_callback_;
+  std::shared_ptr<TraceSink> sink_;
 };
 
 class KATANA_EXPORT JSONContext : public ProgressContext {
@@ -73,21 +80,24 @@ private:
 
   JSONSpan(
       const std::string& span_name, std::shared_ptr<ProgressSpan> parent,
-      OutputCB out_callback);
+      std::shared_ptr<TraceSink> sink);
   JSONSpan(
       const std::string& span_name, const ProgressContext& parent,
-      OutputCB out_callback);
+      std::shared_ptr<TraceSink> sink);
   static std::shared_ptr<ProgressSpan> Make(
       const std::string& span_name, std::shared_ptr<ProgressSpan> parent,
-      OutputCB out_callback);
+      std::shared_ptr<TraceSink> sink);
   static std::shared_ptr<ProgressSpan> Make(
       const std::string& span_name, const ProgressContext& parent,
-      OutputCB out_callback);
+      std::shared_ptr<TraceSink> sink);
 
+  void Start(
+      const std::string& span_name, const std::string& parent_span_id,
+      bool with_host_data);
   void Close() override;
 
   JSONContext context_;
-  OutputCB out_callback_;
+  std::shared_ptr<TraceSink> sink_;
 };
 
 }  // namespace katana
@@ -49,6 +49,7 @@ namespace katana {
  *
  * If the allocation can be concurrent, check katana::gstl::Vector.
  * If the allocation is large and of known size, then check katana::NUMAArray.
+ * If the allocation is large and grows, then check katana::ReservedVector.
  * Read CONTRIBUTING.md for a more detailed comparison between these types.
  */
 template <typename _Tp>
@@ -2,6 +2,9 @@
 #define KATANA_LIBSUPPORT_KATANA_RANDOM_H_
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <random>
 #include <string>
@@ -59,6 +62,205 @@ GenerateUniformRandomSequence(
   });
 }
 
+/// SplitMix64, a small and fast generator whose whole state is one counter.
+///
+/// ForIndex(seed, i) starts an independent sequence for every index i, so a
+/// parallel generator that draws the values of item i from it is
+/// deterministic, whatever the number of threads and however the items are
+/// split among them. Use the helpers below rather than the std
+/// distributions to stay deterministic across standard libraries too.
+class SplitMix64 {
+public:
+  using result_type = uint64_t;
+
+  explicit constexpr SplitMix64(uint64_t seed) : state_(seed) {}
+
+  static constexpr SplitMix64 ForIndex(uint64_t seed, uint64_t index) {
+    return SplitMix64(SplitMix64(seed)() + index);
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() {
+    uint64_t z = (state_ += UINT64_C(0x9e3779b97f4a7c15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return z ^ (z >> 31);
+  }
+
+  /// \returns a uniform double in [0, 1)
+  constexpr double NextDouble() {
+    return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+  }
+
+  /// \returns an integer in [0, bound); bound must not be 0. The modulo
+  /// bias is below bound / 2^64, which does not matter for generators.
+  constexpr uint64_t NextBelow(uint64_t bound) { return (*this)() % bound; }
+
+private:
+  uint64_t state_;
+};
+
+class PhiloxStream;
+
+/// Philox4x32-10, the counter-based generator of Salmon et al., "Parallel
+/// Random Numbers: As Easy as 1, 2, 3" (SC 2011).
+///
+/// A value is a function of the seed and a (node, step) counter alone, so an
+/// analytic that draws step s of node n as Philox(seed)(n, s) gets the same
+/// values whatever the number of threads, the schedule or the machine, and
+/// values that are statistically independent for any choice of counters.
+class Philox {
+public:
+  using Block = std::array<uint32_t, 4>;
+
+  explicit constexpr Philox(uint64_t seed)
+      : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} {}
+
+  /// \returns the 128 bits of counter (node, step)
+  constexpr Block Bits(uint64_t node, uint64_t step) const {
+    Block ctr{
+        static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32),
+        static_cast<uint32_t>(node), static_cast<uint32_t>(node >> 32)};
+    uint32_t k0 = key_[0];
+    uint32_t k1 = key_[1];
+    for (int round = 0; round < kRounds; ++round) {
+      ctr = Round(ctr, k0, k1);
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    return ctr;
+  }
+
+  /// \returns 64 uniform bits for counter (node, step)
+  constexpr uint64_t operator()(uint64_t node, uint64_t step) const {
+    Block bits = Bits(node, step);
+    return uint64_t{bits[1]} << 32 | bits[0];
+  }
+
+  /// \returns a uniform double in [0, 1) for counter (node, step)
+  constexpr double Double(uint64_t node, uint64_t step) const {
+    return static_cast<double>((*this)(node, step) >> 11) * 0x1.0p-53;
+  }
+
+  /// \returns an integer in [0, bound) for counter (node, step); bound must
+  /// not be 0
+  constexpr uint64_t Below(uint64_t node, uint64_t step, uint64_t bound) const {
+    return (*this)(node, step) % bound;
+  }
+
+  /// Write (*this)(node, first_step + i) to out[i] for i in [0, count). The
+  /// rounds run on several counters at once so that they vectorize.
+  void Fill(
+      uint64_t node, uint64_t first_step, uint64_t* out, size_t count) const {
+    constexpr size_t kLanes = 8;
+    size_t i = 0;
+    for (; i + kLanes <= count; i += kLanes) {
+      uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+      for (size_t l = 0; l < kLanes; ++l) {
+        uint64_t step = first_step + i + l;
+        c0[l] = static_cast<uint32_t>(step);
+        c1[l] = static_cast<uint32_t>(step >> 32);
+        c2[l] = static_cast<uint32_t>(node);
+        c3[l] = static_cast<uint32_t>(node >> 32);
+      }
+      uint32_t k0 = key_[0];
+      uint32_t k1 = key_[1];
+      for (int round = 0; round < kRounds; ++round) {
+        for (size_t l = 0; l < kLanes; ++l) {
+          uint64_t p0 = uint64_t{kMul0} * c0[l];
+          uint64_t p1 = uint64_t{kMul1} * c2[l];
+          uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+          uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+          c1[l] = static_cast<uint32_t>(p1);
+          c3[l] = static_cast<uint32_t>(p0);
+          c0[l] = n0;
+          c2[l] = n2;
+        }
+        k0 += kWeyl0;
+        k1 += kWeyl1;
+      }
+      for (size_t l = 0; l < kLanes; ++l) {
+        out[i + l] = uint64_t{c1[l]} << 32 | c0[l];
+      }
+    }
+    for (; i < count; ++i) {
+      out[i] = (*this)(node, first_step + i);
+    }
+  }
+
+  /// \returns the values of node from counter (node, first_step) on
+  constexpr PhiloxStream ForNode(uint64_t node, uint64_t first_step = 0) const;
+
+private:
+  static constexpr int kRounds = 10;
+  static constexpr uint32_t kMul0 = 0xD2511F53;
+  static constexpr uint32_t kMul1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+  static constexpr Block Round(const Block& ctr, uint32_t k0, uint32_t k1) {
+    uint64_t p0 = uint64_t{kMul0} * ctr[0];
+    uint64_t p1 = uint64_t{kMul1} * ctr[2];
+    return {
+        static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ k0,
+        static_cast<uint32_t>(p1),
+        static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ k1,
+        static_cast<uint32_t>(p0)};
+  }
+
+  std::array<uint32_t, 2> key_;
+};
+
+/// The values of one node of a Philox, step after step, as a generator that
+/// can stand in for SplitMix64. Every block of 128 bits makes two values.
+class PhiloxStream {
+public:
+  using result_type = uint64_t;
+
+  constexpr PhiloxStream(const Philox& philox, uint64_t node, uint64_t step)
+      : philox_(philox), node_(node), step_(step) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() {
+    if (!has_next_) {
+      Philox::Block bits = philox_.Bits(node_, step_++);
+      next_ = uint64_t{bits[3]} << 32 | bits[2];
+      has_next_ = true;
+      return uint64_t{bits[1]} << 32 | bits[0];
+    }
+    has_next_ = false;
+    return next_;
+  }
+
+  /// \returns a uniform double in [0, 1)
+  constexpr double NextDouble() {
+    return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+  }
+
+  /// \returns an integer in [0, bound); bound must not be 0
+  constexpr uint64_t NextBelow(uint64_t bound) { return (*this)() % bound; }
+
+private:
+  Philox philox_;
+  uint64_t node_;
+  uint64_t step_;
+  uint64_t next_{0};
+  bool has_next_{false};
+};
+
+constexpr PhiloxStream
+Philox::ForNode(uint64_t node, uint64_t first_step) const {
+  return PhiloxStream(*this, node, first_step);
+}
+
 }  // namespace katana
 
 #endif
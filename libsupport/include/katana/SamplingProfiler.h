@@ -0,0 +1,56 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_SAMPLINGPROFILER_H_
+#define KATANA_LIBSUPPORT_KATANA_SAMPLINGPROFILER_H_
+
+#include <cstdint>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+/// The sampling profiler interrupts the process hz times per second of the
+/// CPU time that it uses (SIGPROF), records the stack of the thread that was
+/// running and charges the sample to the span that was active in the global
+/// ProgressTracer. When a span finishes, its samples are logged on the span
+/// as folded stacks, one log per stack, e.g.,
+///
+///     {..."log":{"msg":"sampled stack",...},"tags":[
+///       {"name":"folded_stack","value":"main;RunQuery;katana::do_all..."},
+///       {"name":"samples","value":12}]...}
+///
+/// so the slow phase of a job can be diagnosed from its trace. Samples of a
+/// child span are not charged to the parent. Frames are named with the
+/// dynamic symbol table; frames without a dynamic symbol are named by
+/// their module and offset, which addr2line resolves.
+///
+/// SharedMemSys starts the profiler when SharedMemSysOptions or the
+/// environment variable KATANA_SAMPLING_PROFILER_HZ ask for it. Blocking
+/// system calls may return EINTR more often while it runs.
+///
+/// \file
+
+namespace katana {
+
+class ProgressSpan;
+
+/// Start sampling hz times per second of CPU time
+KATANA_EXPORT Result<void> StartSamplingProfiler(uint32_t hz);
+
+/// Stop sampling. Samples taken so far are still logged when their spans
+/// finish.
+KATANA_EXPORT void StopSamplingProfiler();
+
+KATANA_EXPORT bool IsSamplingProfilerRunning();
+
+namespace internal {
+
+/// Charge the following samples to span, which may be null; called by
+/// ProgressTracer whenever its active span changes
+KATANA_EXPORT void SetProfiledSpan(const ProgressSpan* span);
+
+/// Log the samples of span on span; called by ProgressSpan::Finish
+KATANA_EXPORT void LogProfiledSamples(ProgressSpan* span);
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
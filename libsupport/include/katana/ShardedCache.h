@@ -0,0 +1,224 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_SHARDEDCACHE_H_
+#define KATANA_LIBSUPPORT_KATANA_SHARDEDCACHE_H_
+
+// A thread safe variant of katana::Cache.  Keys are partitioned by hash into
+// shards; each shard is a single threaded Cache guarded by its own lock, so
+// the hash map / LRU list lock ordering problem described in Cache.h never
+// comes up: both structures of a shard are only touched with that shard's lock
+// held.  Threads working on different keys mostly take different locks.
+//
+// Replacement is LRU within a shard, which approximates global LRU when keys
+// hash evenly.
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "katana/Cache.h"
+#include "katana/Logging.h"
+#include "katana/URI.h"
+
+namespace katana {
+
+template <typename Value>
+class KATANA_EXPORT ShardedCache {
+  using Key = katana::URI;
+  using ValueToBytes = std::function<int64_t(const Value& value)>;
+
+public:
+  static constexpr size_t kDefaultNumShards = 16;
+
+  /// Construct a sharded LRU cache that has a fixed number of entries. The
+  /// entries are split evenly among the shards.
+  ShardedCache(int64_t capacity, size_t num_shards = kDefaultNumShards) {
+    KATANA_LOG_VASSERT(capacity > 0, "cache requires positive capacity");
+    auto per_shard = ShardCapacity(capacity, num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>(per_shard));
+    }
+  }
+  /// Construct a sharded LRU cache that holds a fixed number of bytes. The
+  /// bytes are split evenly among the shards, so an object larger than a
+  /// shard's share is not cached.
+  ShardedCache(
+      int64_t capacity, ValueToBytes value_to_bytes,
+      size_t num_shards = kDefaultNumShards) {
+    KATANA_LOG_VASSERT(capacity > 0, "cache requires positive capacity");
+    auto per_shard = ShardCapacity(capacity, num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>(per_shard, value_to_bytes));
+    }
+  }
+  /// Construct a sharded LRU cache that holds whatever we put in it and only
+  /// evicts when we explicitly tell it to do so.
+  ShardedCache(
+      ValueToBytes value_to_bytes, size_t num_shards = kDefaultNumShards) {
+    KATANA_LOG_VASSERT(num_shards > 0, "cache requires at least one shard");
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>(value_to_bytes));
+    }
+  }
+
+  size_t num_shards() const { return shards_.size(); }
+
+  /// Returns the size of the cache (in number of elements or size of
+  /// elements, depending on the replacement policy).  Shards are visited one
+  /// at a time, so under concurrent modification this is only a snapshot.
+  int64_t size() const {
+    int64_t ret{};
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      ret += shard->cache.size();
+    }
+    return ret;
+  }
+
+  /// Returns the capacity (in number of elements or size of elements,
+  /// depending on the replacement policy).
+  int64_t capacity() const {
+    int64_t ret{};
+    for (const auto& shard : shards_) {
+      auto shard_capacity = shard->cache.capacity();
+      if (shard_capacity == std::numeric_limits<int64_t>::max()) {
+        return shard_capacity;
+      }
+      ret += shard_capacity;
+    }
+    return ret;
+  }
+
+  /// Clear cache
+  void clear() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->cache.clear();
+    }
+  }
+
+  /// Returns true if the cache is empty
+  bool empty() const {
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      if (!shard->cache.empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Try to reclaim \p goal bytes (#entries), evicting least recently used
+  /// entries of each shard to do it.  Returns the number of bytes actually
+  /// evicted.
+  ///
+  /// Each pass asks every shard for an even share of what is still missing,
+  /// starting from a different shard each call, so no single shard is
+  /// drained while the others keep older entries.
+  int64_t Reclaim(int64_t goal) {
+    int64_t reclaimed{};
+    size_t num = shards_.size();
+    while (reclaimed < goal) {
+      int64_t share =
+          (goal - reclaimed + static_cast<int64_t>(num) - 1) /
+          static_cast<int64_t>(num);
+      int64_t pass{};
+      size_t start = next_reclaim_.fetch_add(1, std::memory_order_relaxed);
+      for (size_t i = 0; i < num && reclaimed + pass < goal; ++i) {
+        auto& shard = shards_[(start + i) % num];
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        pass += shard->cache.Reclaim(share);
+      }
+      if (pass == 0) {
+        break;
+      }
+      reclaimed += pass;
+    }
+    return reclaimed;
+  }
+
+  bool Contains(const Key& key) const {
+    const auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Contains(key);
+  }
+
+  void Insert(const Key& key, const Value& value) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.cache.Insert(key, value);
+  }
+
+  std::optional<Value> Get(const Key& key) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Get(key);
+  }
+
+  std::optional<Value> GetAndEvict(const Key& key) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.GetAndEvict(key);
+  }
+
+  /// Returns the hit statistics summed over all shards
+  CacheStats GetStats() const {
+    CacheStats ret;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      auto stats = shard->cache.GetStats();
+      ret.get_count += stats.get_count;
+      ret.get_hit_count += stats.get_hit_count;
+      ret.insert_count += stats.insert_count;
+      ret.insert_hit_count += stats.insert_hit_count;
+    }
+    return ret;
+  }
+
+  // Debugging function, position of key in the LRU list of its shard
+  int64_t LRUPosition(const Key& key) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.LRUPosition(key);
+  }
+
+private:
+  struct Shard {
+    template <typename... Args>
+    explicit Shard(Args&&... args) : cache(std::forward<Args>(args)...) {}
+
+    mutable std::mutex mutex;
+    Cache<Value> cache;
+  };
+
+  static int64_t ShardCapacity(int64_t capacity, size_t num_shards) {
+    KATANA_LOG_VASSERT(num_shards > 0, "cache requires at least one shard");
+    auto num = static_cast<int64_t>(num_shards);
+    return (capacity + num - 1) / num;
+  }
+
+  // Mix the hash before taking the modulus; std::hash may be weak in its low
+  // bits
+  Shard& ShardFor(const Key& key) const {
+    uint64_t h = Key::Hash{}(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return *shards_[h % shards_.size()];
+  }
+
+  // Shards are allocated separately to keep their locks on different cache
+  // lines
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<size_t> next_reclaim_{0};
+};
+
+// Thread safe version of PropertyCache
+using ShardedPropertyCache = ShardedCache<std::shared_ptr<arrow::Table>>;
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,368 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_SMALLDYNAMICBITSET_H_
+#define KATANA_LIBSUPPORT_KATANA_SMALLDYNAMICBITSET_H_
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A dynamically sized bitset that keeps up to kInlineBits bits in the object
+/// itself. Sets that fit are copied, compared and combined without touching
+/// the heap, and the word loops over them have a fixed trip count, so the
+/// compiler turns them into a few vector instructions.
+///
+/// Unlike DynamicBitsetSlow, modifications are not atomic: a bitset may be
+/// read concurrently but must not be modified concurrently.
+///
+/// The bits past size() are always 0, which lets the word-wise operations
+/// ignore size() altogether.
+class KATANA_EXPORT SmallDynamicBitset {
+public:
+  static constexpr size_t kNumBitsInUint64 = sizeof(uint64_t) * CHAR_BIT;
+  static constexpr size_t kInlineBits = 256;
+  static constexpr size_t kInlineWords = kInlineBits / kNumBitsInUint64;
+
+  /// A forward iterator over the indices of the set bits. Increment skips
+  /// zero words and finds the next set bit with a single instruction, so
+  /// iteration is O(number of words + number of set bits).
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = int64_t;
+    using pointer = const uint64_t*;
+    using reference = uint64_t;
+
+    iterator(const uint64_t* words, size_t num_words, size_t word_index)
+        : words_(words), num_words_(num_words), word_index_(word_index) {
+      if (word_index_ < num_words_) {
+        current_ = words_[word_index_];
+        SkipZeroWords();
+      }
+    }
+
+    reference operator*() const {
+      return word_index_ * kNumBitsInUint64 + __builtin_ctzll(current_);
+    }
+
+    iterator& operator++() {
+      // clear the lowest set bit
+      current_ &= current_ - 1;
+      SkipZeroWords();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      auto r = *this;
+      ++(*this);
+      return r;
+    }
+
+    bool operator==(const iterator& other) const {
+      return word_index_ == other.word_index_ && current_ == other.current_;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+  private:
+    void SkipZeroWords() {
+      while (current_ == 0 && ++word_index_ < num_words_) {
+        current_ = words_[word_index_];
+      }
+    }
+
+    const uint64_t* words_;
+    size_t num_words_;
+    size_t word_index_;
+    uint64_t current_{0};
+  };
+
+  SmallDynamicBitset() = default;
+
+  SmallDynamicBitset(const SmallDynamicBitset& other) = default;
+  SmallDynamicBitset& operator=(const SmallDynamicBitset& other) = default;
+
+  SmallDynamicBitset(SmallDynamicBitset&& other) noexcept
+      : inline_words_(other.inline_words_),
+        heap_words_(std::move(other.heap_words_)),
+        num_bits_(std::exchange(other.num_bits_, 0)) {
+    other.heap_words_.clear();
+    other.inline_words_.fill(0);
+  }
+
+  SmallDynamicBitset& operator=(SmallDynamicBitset&& other) noexcept {
+    if (this != &other) {
+      inline_words_ = other.inline_words_;
+      heap_words_ = std::move(other.heap_words_);
+      num_bits_ = std::exchange(other.num_bits_, 0);
+      other.heap_words_.clear();
+      other.inline_words_.fill(0);
+    }
+    return *this;
+  }
+
+  /// \returns the number of bits held by the bitset
+  size_t size() const { return num_bits_; }
+
+  /// \returns the number of 64-bit words that hold the bits
+  size_t num_words() const { return WordsFor(num_bits_); }
+
+  /// \returns the words that hold the bits; the unused bits of the last word
+  /// are 0
+  const uint64_t* words() const {
+    return IsInline() ? inline_words_.data() : heap_words_.data();
+  }
+
+  iterator begin() const { return {words(), num_words(), 0}; }
+
+  iterator end() const { return {words(), num_words(), num_words()}; }
+
+  /// Resize the bitset to \p n bits. New bits are 0.
+  void resize(size_t n) {
+    if (n <= kInlineBits) {
+      if (!IsInline()) {
+        std::copy_n(heap_words_.begin(), kInlineWords, inline_words_.begin());
+        heap_words_.clear();
+        heap_words_.shrink_to_fit();
+      }
+    } else {
+      if (IsInline()) {
+        heap_words_.assign(inline_words_.begin(), inline_words_.end());
+        inline_words_.fill(0);
+      }
+      heap_words_.resize(WordsFor(n), 0);
+    }
+    num_bits_ = n;
+    ClearTrailingBits();
+  }
+
+  /// Clear the bitset and set its size to 0.
+  void clear() { resize(0); }
+
+  /// \returns true iff bit \p index is set
+  bool test(size_t index) const {
+    KATANA_LOG_DEBUG_ASSERT(index < num_bits_);
+    return (words()[index / kNumBitsInUint64] >> (index % kNumBitsInUint64)) &
+           1;
+  }
+
+  /// Set bit \p index.
+  ///
+  /// \returns the old value
+  bool set(size_t index) {
+    KATANA_LOG_DEBUG_ASSERT(index < num_bits_);
+    uint64_t& word = mutable_words()[index / kNumBitsInUint64];
+    uint64_t mask = uint64_t{1} << (index % kNumBitsInUint64);
+    bool old = (word & mask) != 0;
+    word |= mask;
+    return old;
+  }
+
+  /// Set every bit.
+  void set() {
+    std::fill_n(mutable_words(), num_words(), ~uint64_t{0});
+    ClearTrailingBits();
+  }
+
+  /// Unset bit \p index.
+  ///
+  /// \returns the old value
+  bool reset(size_t index) {
+    KATANA_LOG_DEBUG_ASSERT(index < num_bits_);
+    uint64_t& word = mutable_words()[index / kNumBitsInUint64];
+    uint64_t mask = uint64_t{1} << (index % kNumBitsInUint64);
+    bool old = (word & mask) != 0;
+    word &= ~mask;
+    return old;
+  }
+
+  /// Unset every bit.
+  void reset() {
+    inline_words_.fill(0);
+    std::fill(heap_words_.begin(), heap_words_.end(), 0);
+  }
+
+  /// \returns the number of set bits
+  size_t count() const {
+    const uint64_t* w = words();
+    size_t n = StorageWords();
+    size_t ret = 0;
+    for (size_t i = 0; i < n; ++i) {
+      ret += __builtin_popcountll(w[i]);
+    }
+    return ret;
+  }
+
+  /// \returns true iff every bit is set
+  bool all() const { return count() == size(); }
+
+  /// \returns true iff no bit is set
+  bool none() const {
+    return Reduce(*this, *this, [](uint64_t a, uint64_t) { return a; }) == 0;
+  }
+
+  /// \returns true iff every bit set in this bitset is also set in \p other.
+  /// The bitsets must be the same size.
+  bool IsSubsetOf(const SmallDynamicBitset& other) const {
+    return Reduce(*this, other, [](uint64_t a, uint64_t b) {
+             return a & ~b;
+           }) == 0;
+  }
+
+  /// \returns true iff some bit is set in both this bitset and \p other.
+  /// The bitsets must be the same size.
+  bool Intersects(const SmallDynamicBitset& other) const {
+    return Reduce(*this, other, [](uint64_t a, uint64_t b) {
+             return a & b;
+           }) != 0;
+  }
+
+  void bitwise_or(const SmallDynamicBitset& other) {
+    Combine(*this, other, [](uint64_t a, uint64_t b) { return a | b; });
+  }
+
+  /// Set this bitset to the bitwise or of \p other1 and \p other2, which are
+  /// the same size as this bitset.
+  void bitwise_or(
+      const SmallDynamicBitset& other1, const SmallDynamicBitset& other2) {
+    Combine(other1, other2, [](uint64_t a, uint64_t b) { return a | b; });
+  }
+
+  void bitwise_and(const SmallDynamicBitset& other) {
+    Combine(*this, other, [](uint64_t a, uint64_t b) { return a & b; });
+  }
+
+  /// Set this bitset to the bitwise and of \p other1 and \p other2, which are
+  /// the same size as this bitset.
+  void bitwise_and(
+      const SmallDynamicBitset& other1, const SmallDynamicBitset& other2) {
+    Combine(other1, other2, [](uint64_t a, uint64_t b) { return a & b; });
+  }
+
+  void bitwise_xor(const SmallDynamicBitset& other) {
+    Combine(*this, other, [](uint64_t a, uint64_t b) { return a ^ b; });
+  }
+
+  /// Set this bitset to the bitwise xor of \p other1 and \p other2, which are
+  /// the same size as this bitset.
+  void bitwise_xor(
+      const SmallDynamicBitset& other1, const SmallDynamicBitset& other2) {
+    Combine(other1, other2, [](uint64_t a, uint64_t b) { return a ^ b; });
+  }
+
+  void bitwise_not() {
+    Combine(*this, *this, [](uint64_t a, uint64_t) { return ~a; });
+    ClearTrailingBits();
+  }
+
+  SmallDynamicBitset& operator|=(const SmallDynamicBitset& other) {
+    KATANA_LOG_ASSERT(size() == other.size());
+    bitwise_or(other);
+    return *this;
+  }
+
+  SmallDynamicBitset& operator&=(const SmallDynamicBitset& other) {
+    KATANA_LOG_ASSERT(size() == other.size());
+    bitwise_and(other);
+    return *this;
+  }
+
+  bool operator==(const SmallDynamicBitset& other) const {
+    return Equals(other);
+  }
+
+  bool operator!=(const SmallDynamicBitset& other) const {
+    return !Equals(other);
+  }
+
+  /// \returns true iff the bitsets are the same size and have the same bits
+  /// set
+  bool Equals(const SmallDynamicBitset& other) const {
+    if (size() != other.size()) {
+      return false;
+    }
+    return Reduce(*this, other, [](uint64_t a, uint64_t b) {
+             return a ^ b;
+           }) == 0;
+  }
+
+private:
+  static constexpr size_t WordsFor(size_t num_bits) {
+    return (num_bits + kNumBitsInUint64 - 1) / kNumBitsInUint64;
+  }
+
+  bool IsInline() const { return num_bits_ <= kInlineBits; }
+
+  uint64_t* mutable_words() {
+    return IsInline() ? inline_words_.data() : heap_words_.data();
+  }
+
+  /// The number of words the word-wise operations loop over: all of the
+  /// inline words, which keeps the trip count fixed, or all of the heap words
+  size_t StorageWords() const {
+    return IsInline() ? kInlineWords : heap_words_.size();
+  }
+
+  /// Restore the invariant that the bits past size() are 0
+  void ClearTrailingBits() {
+    uint64_t* w = mutable_words();
+    size_t used = num_words();
+    std::fill(w + used, w + StorageWords(), 0);
+    size_t last_bits = num_bits_ % kNumBitsInUint64;
+    if (last_bits != 0) {
+      w[used - 1] &= (uint64_t{1} << last_bits) - 1;
+    }
+  }
+
+  /// Set every word of this bitset to op of the words of \p a and \p b
+  template <typename Op>
+  void Combine(
+      const SmallDynamicBitset& a, const SmallDynamicBitset& b, Op op) {
+    KATANA_LOG_DEBUG_ASSERT(size() == a.size() && size() == b.size());
+    if (IsInline()) {
+      for (size_t i = 0; i < kInlineWords; ++i) {
+        inline_words_[i] = op(a.inline_words_[i], b.inline_words_[i]);
+      }
+      return;
+    }
+    for (size_t i = 0, n = heap_words_.size(); i < n; ++i) {
+      heap_words_[i] = op(a.heap_words_[i], b.heap_words_[i]);
+    }
+  }
+
+  /// \returns the or of op of the words of \p a and \p b; there is no early
+  /// exit, so for inline bitsets this is branch free
+  template <typename Op>
+  static uint64_t Reduce(
+      const SmallDynamicBitset& a, const SmallDynamicBitset& b, Op op) {
+    KATANA_LOG_DEBUG_ASSERT(a.size() == b.size());
+    uint64_t acc = 0;
+    if (a.IsInline()) {
+      for (size_t i = 0; i < kInlineWords; ++i) {
+        acc |= op(a.inline_words_[i], b.inline_words_[i]);
+      }
+      return acc;
+    }
+    for (size_t i = 0, n = a.heap_words_.size(); i < n; ++i) {
+      acc |= op(a.heap_words_[i], b.heap_words_[i]);
+    }
+    return acc;
+  }
+
+  std::array<uint64_t, kInlineWords> inline_words_{};
+  std::vector<uint64_t> heap_words_;
+  size_t num_bits_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_SOCKETCOMMBACKEND_H_
+#define KATANA_LIBSUPPORT_KATANA_SOCKETCOMMBACKEND_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/CommBackend.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A socket on which a task accepts the connections of the other tasks of a
+/// SocketCommBackend
+class KATANA_EXPORT SocketListener {
+public:
+  /// Listen on address, which is "host:port"; port 0 picks a free port
+  static katana::Result<SocketListener> Make(const std::string& address);
+
+  SocketListener(SocketListener&& other) noexcept;
+  SocketListener& operator=(SocketListener&& other) noexcept;
+  SocketListener(const SocketListener&) = delete;
+  SocketListener& operator=(const SocketListener&) = delete;
+  ~SocketListener();
+
+  /// The port this listener is bound to
+  uint16_t port() const { return port_; }
+
+private:
+  friend class SocketCommBackend;
+
+  SocketListener(int fd, uint16_t port) : fd_(fd), port_(port) {}
+
+  int fd_{-1};
+  uint16_t port_{0};
+};
+
+/// A CommBackend whose tasks exchange messages over TCP. Every pair of tasks
+/// shares one connection, so it suits the tens of hosts a partitioned graph
+/// is spread over rather than large clusters.
+///
+/// Collectives are built on AllToAll, which sends and receives the messages
+/// of all peers at once so that no pair of tasks can block each other.
+/// Barrier is an AllToAll of empty messages. Failures of the connections in
+/// calls that cannot return an error abort the task, as they would with MPI.
+class KATANA_EXPORT SocketCommBackend : public CommBackend {
+public:
+  /// Connect task rank to the other tasks. addresses holds the "host:port"
+  /// of every task and is the same for all of them; this task listens on
+  /// addresses[rank]. Tasks may start in any order: connecting waits up to
+  /// timeout_seconds for the others to listen.
+  static katana::Result<std::unique_ptr<SocketCommBackend>> Make(
+      const std::vector<std::string>& addresses, uint32_t rank,
+      uint32_t timeout_seconds = kDefaultTimeoutSeconds);
+
+  /// Like Make but accepts connections on listener, which must already
+  /// listen on addresses[rank]. This lets tasks listen on free ports and
+  /// tell each other about them before connecting.
+  static katana::Result<std::unique_ptr<SocketCommBackend>> Make(
+      const std::vector<std::string>& addresses, uint32_t rank,
+      SocketListener listener,
+      uint32_t timeout_seconds = kDefaultTimeoutSeconds);
+
+  ~SocketCommBackend() override;
+
+  void Barrier() override;
+  bool Broadcast(uint32_t root, bool val) override;
+  std::string Broadcast(
+      uint32_t root, const std::string& val, uint64_t max_size) override;
+  /// Close all connections so that the other tasks fail rather than wait
+  void NotifyFailure() override;
+  katana::Result<std::vector<std::string>> AllToAll(
+      std::vector<std::string> sends) override;
+
+  static constexpr uint32_t kDefaultTimeoutSeconds = 60;
+
+private:
+  explicit SocketCommBackend(std::vector<int> fds) : fds_(std::move(fds)) {}
+
+  void CloseAll();
+
+  /// fds_[i] is the connection to task i; -1 for this task
+  std::vector<int> fds_;
+};
+
+}  // namespace katana
+
+#endif
@@ -6,14 +6,20 @@
 #include <vector>
 
 #include "katana/ProgressTracer.h"
+#include "katana/TraceSink.h"
 #include "katana/config.h"
 
 namespace katana {
 
 class KATANA_EXPORT TextTracer : public ProgressTracer {
 public:
+  ~TextTracer() override { sink_->Close(); }
+
+  /// Make a tracer that writes to stderr. With buffer_lines > 0, lines are
+  /// buffered and written from a background thread; see TraceSink.
   static std::unique_ptr<TextTracer> Make(
-      uint32_t host_id = 0, uint32_t num_hosts = 1);
+      uint32_t host_id = 0, uint32_t num_hosts = 1,
+      size_t buffer_lines = kDefaultTraceBufferLines);
 
   std::shared_ptr<ProgressSpan> StartSpan(
       const std::string& span_name, const ProgressContext& child_of) override;
@@ -22,14 +28,17 @@ public:
   std::unique_ptr<ProgressContext> Extract(const std::string& carrier) override;
 
 private:
-  TextTracer(uint32_t host_id, uint32_t num_hosts)
-      : ProgressTracer(host_id, num_hosts) {}
+  TextTracer(
+      uint32_t host_id, uint32_t num_hosts, std::shared_ptr<TraceSink> sink)
+      : ProgressTracer(host_id, num_hosts), sink_(std::move(sink)) {}
 
   std::shared_ptr<ProgressSpan> StartSpan(
       const std::string& span_name,
       std::shared_ptr<ProgressSpan> child_of) override;
 
-  void Close() override {}
+  void Close() override { sink_->Close(); }
+
+  std::shared_ptr<TraceSink> sink_;
 };
 
 class KATANA_EXPORT TextContext : public ProgressContext {
@@ -64,17 +73,24 @@ public:
 private:
   friend TextTracer;
 
-  TextSpan(const std::string& span_name, std::shared_ptr<ProgressSpan> parent);
-  TextSpan(const std::string& span_name, const ProgressContext& parent);
+  TextSpan(
+      const std::string& span_name, std::shared_ptr<ProgressSpan> parent,
+      std::shared_ptr<TraceSink> sink);
+  TextSpan(
+      const std::string& span_name, const ProgressContext& parent,
+      std::shared_ptr<TraceSink> sink);
   static std::shared_ptr<ProgressSpan> Make(
-      const std::string& span_name, std::shared_ptr<ProgressSpan> parent);
+      const std::string& span_name, std::shared_ptr<ProgressSpan> parent,
+      std::shared_ptr<TraceSink> sink);
   static std::shared_ptr<ProgressSpan> Make(
-      const std::string& span_name, const ProgressContext& parent);
+      const std::string& span_name, const ProgressContext& parent,
+      std::shared_ptr<TraceSink> sink);
 
   void Close() override;
 
   TextContext context_;
   std::string span_name_;
+  std::shared_ptr<TraceSink> sink_;
 };
 
 }  // namespace katana
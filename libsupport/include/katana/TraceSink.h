@@ -0,0 +1,101 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_TRACESINK_H_
+#define KATANA_LIBSUPPORT_KATANA_TRACESINK_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+using OutputCB = std::function<void(const std::string&)>;
+
+/// A line of a trace, formatted only when it is written
+using TraceLine = std::function<std::string()>;
+
+/// The lines a TraceSink buffers for each thread by default
+constexpr size_t kDefaultTraceBufferLines = 4096;
+
+/// What a trace line reports about the moment it was logged. It is taken in
+/// the logging thread, so the line reports it however late it is written.
+struct KATANA_EXPORT TraceStamp {
+  uint32_t host_id{0};
+  /// Microseconds since the epoch
+  int64_t timestamp_us{0};
+  /// Milliseconds since the first stamp
+  uint64_t offset_ms{0};
+  /// The maximum resident set size so far, in kilobytes
+  long max_mem_kb{0};
+  /// The bytes allocated from the default arrow pool
+  int64_t arrow_bytes{0};
+
+  static TraceStamp Take();
+};
+
+/// TraceSink writes the lines of a tracer to an output callback.
+///
+/// With buffer_lines > 0, Push only queues the line in a lock-free ring of
+/// the calling thread. A writer thread, started by the first Push, formats
+/// and writes the lines of all threads in the background. Lines pushed while
+/// the ring of their thread is full are dropped and counted. Lines of one
+/// thread are written in order; lines of different threads may interleave.
+///
+/// With buffer_lines == 0, Push formats and writes the line in the calling
+/// thread, like the tracers did before they were buffered.
+class KATANA_EXPORT TraceSink {
+public:
+  TraceSink(OutputCB out_callback, size_t buffer_lines);
+  ~TraceSink();
+  TraceSink(const TraceSink&) = delete;
+  TraceSink(TraceSink&&) = delete;
+  TraceSink& operator=(const TraceSink&) = delete;
+  TraceSink& operator=(TraceSink&&) = delete;
+
+  /// Push queues line to be written, and returns false if it was dropped
+  bool Push(TraceLine line);
+
+  /// Close writes every line pushed before it and stops the writer thread.
+  /// A later Push starts it again.
+  void Close();
+
+  /// The lines dropped because the ring of their thread was full
+  uint64_t dropped() const;
+
+private:
+  struct Ring;
+
+  Ring* LocalRing();
+  void Write(const TraceLine& line);
+  /// Writes the lines queued in every ring, and returns how many there were
+  size_t Drain();
+  void RunWriter();
+
+  OutputCB out_callback_;
+  size_t buffer_lines_;
+  uint64_t id_;
+
+  /// Guards the rings and the state of the writer thread
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::unordered_map<std::thread::id, Ring*> ring_of_thread_;
+  std::thread writer_;
+  std::atomic<bool> running_{false};
+  bool stopping_{false};
+
+  /// Serializes calls of out_callback_
+  std::mutex output_mutex_;
+  uint64_t dropped_reported_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -1,8 +1,24 @@
 #include "katana/CommBackend.h"
 
+#include "katana/ErrorCode.h"
+
 // Anchor vtables
 
 katana::CommBackend::~CommBackend() = default;
 
 void
 katana::NullCommBackend::NotifyFailure() {}
+
+katana::Result<std::vector<std::string>>
+katana::CommBackend::AllToAll(std::vector<std::string> sends) {
+  if (sends.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "expected one message per task ({}), got {}", Num, sends.size());
+  }
+  if (Num != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "this backend cannot exchange data");
+  }
+  return sends;
+}
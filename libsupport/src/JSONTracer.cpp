@@ -5,17 +5,11 @@
 #include <cstring>
 #include <iostream>
 #include <limits>
-#include <mutex>
-
-#include <arrow/memory_pool.h>
 
 #include "katana/Random.h"
-#include "katana/Time.h"
 
 namespace {
 
-std::mutex output_mutex;
-
 std::string
 GenerateID() {
   std::uniform_int_distribution<uint64_t> dist(
@@ -55,16 +49,15 @@ GetSpanJSON(const std::string& span_id, bool finish) {
 }
 
 std::string
-GetHostStatsJSON() {
+GetHostStatsJSON(uint32_t num_hosts) {
   fmt::memory_buffer buf;
   katana::HostStats host_stats = katana::ProgressTracer::GetHostStats();
-  auto& tracer = katana::ProgressTracer::Get();
 
   fmt::format_to(
       std::back_inserter(buf),
       R"("host_data":{{"hosts":{},"hostname":"{}","hardware_threads":{},"pid":{},"ram_gb":{}}})",
-      tracer.GetNumHosts(), host_stats.hostname, host_stats.nprocs,
-      host_stats.pid, host_stats.ram_gb);
+      num_hosts, host_stats.hostname, host_stats.nprocs, host_stats.pid,
+      host_stats.ram_gb);
 
   return fmt::to_string(buf);
 }
@@ -92,20 +85,16 @@ GetTagsJSON(const katana::Tags& tags) {
 }
 
 std::string
-GetLogJSON(const std::string& message) {
+GetLogJSON(const std::string& message, const katana::TraceStamp& stamp) {
   fmt::memory_buffer buf;
 
-  auto usec_ts = std::chrono::duration_cast<std::chrono::microseconds>(
-                     katana::Now().time_since_epoch())
-                     .count();
   fmt::format_to(
       std::back_inserter(buf),
       R"("log":{{"msg":"{}","timestamp_us":{},"max_mem_gb":{:.3f},"mem_gb":{:.3f},"arrow_mem_gb":{:.3f}}})",
-      message, usec_ts, katana::ProgressTracer::GetMaxMem() / 1024.0 / 1024.0,
+      message, stamp.timestamp_us, stamp.max_mem_kb / 1024.0 / 1024.0,
       katana::ProgressTracer::ParseProcSelfRssBytes() / 1024.0 / 1024.0 /
           1024.0,
-      arrow::default_memory_pool()->bytes_allocated() / 1024.0 / 1024.0 /
-          1024.0);
+      stamp.arrow_bytes / 1024.0 / 1024.0 / 1024.0);
 
   return fmt::to_string(buf);
 }
@@ -114,15 +103,12 @@ std::string
 BuildJSON(
     const std::string& trace_id, const std::string& span_data,
     const std::string& log_data, const std::string& tag_data,
-    const std::string& host_data) {
+    const std::string& host_data, const katana::TraceStamp& stamp) {
   fmt::memory_buffer buf;
-  uint32_t host_id = katana::ProgressTracer::Get().GetHostID();
-  static auto begin = katana::Now();
-  auto msec_since_begin = katana::UsSince(begin) / 1000;
 
   fmt::format_to(
-      std::back_inserter(buf), R"({{"host":{},"offset_ms":{})", host_id,
-      msec_since_begin);
+      std::back_inserter(buf), R"({{"host":{},"offset_ms":{})", stamp.host_id,
+      stamp.offset_ms);
   if (!log_data.empty()) {
     fmt::format_to(std::back_inserter(buf), ",{}", log_data);
   }
@@ -140,32 +126,29 @@ BuildJSON(
   return fmt::to_string(buf);
 }
 
-void
-OutputJSON(const katana::OutputCB& out_callback, const std::string& output) {
-  std::lock_guard<std::mutex> lock(output_mutex);
-  out_callback(output);
-}
-
 }  // namespace
 
 std::unique_ptr<katana::JSONTracer>
 katana::JSONTracer::Make(uint32_t host_id, uint32_t num_hosts) {
-  return std::unique_ptr<JSONTracer>(new JSONTracer(
+  return Make(
       host_id, num_hosts,
-      [](const std::string& output) { std::cout << output; }));
+      [](const std::string& output) { std::cout << output; },
+      kDefaultTraceBufferLines);
 }
 
 std::unique_ptr<katana::JSONTracer>
 katana::JSONTracer::Make(
-    uint32_t host_id, uint32_t num_hosts, katana::OutputCB out_callback) {
-  return std::unique_ptr<JSONTracer>(
-      new JSONTracer(host_id, num_hosts, std::move(out_callback)));
+    uint32_t host_id, uint32_t num_hosts, katana::OutputCB out_callback,
+    size_t buffer_lines) {
+  return std::unique_ptr<JSONTracer>(new JSONTracer(
+      host_id, num_hosts,
+      std::make_shared<TraceSink>(std::move(out_callback), buffer_lines)));
 }
 
 std::shared_ptr<katana::ProgressSpan>
 katana::JSONTracer::StartSpan(
     const std::string& span_name, const katana::ProgressContext& child_of) {
-  return JSONSpan::Make(span_name, child_of, out_callback_);
+  return JSONSpan::Make(span_name, child_of, sink_);
 }
 
 std::string
@@ -188,7 +171,7 @@ std::shared_ptr<katana::ProgressSpan>
 katana::JSONTracer::StartSpan(
     const std::string& span_name,
     std::shared_ptr<katana::ProgressSpan> child_of) {
-  return JSONSpan::Make(span_name, std::move(child_of), out_callback_);
+  return JSONSpan::Make(span_name, std::move(child_of), sink_);
 }
 
 std::unique_ptr<katana::ProgressContext>
@@ -198,107 +181,98 @@ katana::JSONContext::Clone() const noexcept {
 
 void
 katana::JSONSpan::SetTags(const katana::Tags& tags) {
-  std::string span_data = GetSpanJSON(GetContext().GetSpanID());
-  std::string log_data;
-  std::string tag_data = GetTagsJSON(tags);
-  std::string host_data;
-
-  std::string output_json = BuildJSON(
-      GetContext().GetTraceID(), span_data, log_data, tag_data, host_data);
-  OutputJSON(out_callback_, output_json);
+  TraceStamp stamp = TraceStamp::Take();
+  sink_->Push([stamp, trace_id = GetContext().GetTraceID(),
+               span_id = GetContext().GetSpanID(), tags] {
+    return BuildJSON(
+        trace_id, GetSpanJSON(span_id), "", GetTagsJSON(tags), "", stamp);
+  });
 }
 
 void
 katana::JSONSpan::Log(const std::string& message, const katana::Tags& tags) {
-  std::string span_data = GetSpanJSON(GetContext().GetSpanID());
-  std::string log_data = GetLogJSON(message);
-  std::string tag_data = GetTagsJSON(tags);
-  std::string host_data;
-
-  std::string output_json = BuildJSON(
-      GetContext().GetTraceID(), span_data, log_data, tag_data, host_data);
-  OutputJSON(out_callback_, output_json);
+  TraceStamp stamp = TraceStamp::Take();
+  sink_->Push([stamp, trace_id = GetContext().GetTraceID(),
+               span_id = GetContext().GetSpanID(), message, tags] {
+    return BuildJSON(
+        trace_id, GetSpanJSON(span_id), GetLogJSON(message, stamp),
+        GetTagsJSON(tags), "", stamp);
+  });
 }
 
 katana::JSONSpan::JSONSpan(
     const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent,
-    OutputCB out_callback)
+    std::shared_ptr<TraceSink> sink)
     : ProgressSpan(std::move(parent)),
       context_(JSONContext{"", ""}),
-      out_callback_(std::move(out_callback)) {
+      sink_(std::move(sink)) {
   std::string parent_span_id{"null"};
   std::string trace_id;
-  std::string host_data;
-  if (GetParentSpan() != nullptr) {
+  bool root = GetParentSpan() == nullptr;
+  if (!root) {
     auto parent_span = std::static_pointer_cast<JSONSpan>(GetParentSpan());
     parent_span_id = parent_span->GetContext().GetSpanID();
     trace_id = parent_span->GetContext().GetTraceID();
   } else {
     trace_id = GenerateID();
-    host_data = GetHostStatsJSON();
   }
   std::string span_id = GenerateID();
   context_ = JSONContext(trace_id, span_id);
-
-  const std::string& message = span_name;
-
-  std::string span_data = GetSpanJSON(span_id, span_name, parent_span_id);
-  std::string log_data = GetLogJSON(message);
-  std::string tag_data;
-
-  std::string output_json =
-      BuildJSON(trace_id, span_data, log_data, tag_data, host_data);
-  OutputJSON(out_callback_, output_json);
+  Start(span_name, parent_span_id, root);
 }
 
 katana::JSONSpan::JSONSpan(
     const std::string& span_name, const katana::ProgressContext& parent,
-    OutputCB out_callback)
+    std::shared_ptr<TraceSink> sink)
     : ProgressSpan(nullptr),
       context_(JSONContext{"", ""}),
-      out_callback_(std::move(out_callback)) {
-  std::string parent_span_id = parent.GetSpanID();
-  std::string trace_id = parent.GetTraceID();
-  std::string span_id = GenerateID();
-  context_ = JSONContext(trace_id, span_id);
-
-  const std::string& message = span_name;
-
-  std::string host_data = GetHostStatsJSON();
-  std::string span_data = GetSpanJSON(span_id, span_name, parent_span_id);
-  std::string log_data = GetLogJSON(message);
-  std::string tag_data;
+      sink_(std::move(sink)) {
+  context_ = JSONContext(parent.GetTraceID(), GenerateID());
+  Start(span_name, parent.GetSpanID(), true);
+}
 
-  std::string output_json =
-      BuildJSON(trace_id, span_data, log_data, tag_data, host_data);
-  OutputJSON(out_callback_, output_json);
+void
+katana::JSONSpan::Start(
+    const std::string& span_name, const std::string& parent_span_id,
+    bool with_host_data) {
+  TraceStamp stamp = TraceStamp::Take();
+  uint32_t num_hosts =
+      with_host_data ? ProgressTracer::Get().GetNumHosts() : 0;
+  sink_->Push([stamp, trace_id = GetContext().GetTraceID(),
+               span_id = GetContext().GetSpanID(), span_name, parent_span_id,
+               with_host_data, num_hosts] {
+    std::string host_data;
+    if (with_host_data) {
+      host_data = GetHostStatsJSON(num_hosts);
+    }
+    return BuildJSON(
+        trace_id, GetSpanJSON(span_id, span_name, parent_span_id),
+        GetLogJSON(span_name, stamp), "", host_data, stamp);
+  });
 }
 
 std::shared_ptr<katana::ProgressSpan>
 katana::JSONSpan::Make(
     const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent,
-    OutputCB out_callback) {
+    std::shared_ptr<TraceSink> sink) {
   return std::shared_ptr<JSONSpan>(
-      new JSONSpan(span_name, std::move(parent), std::move(out_callback)));
+      new JSONSpan(span_name, std::move(parent), std::move(sink)));
 }
 std::shared_ptr<katana::ProgressSpan>
 katana::JSONSpan::Make(
     const std::string& span_name, const katana::ProgressContext& parent,
-    OutputCB out_callback) {
+    std::shared_ptr<TraceSink> sink) {
   return std::shared_ptr<JSONSpan>(
-      new JSONSpan(span_name, parent, std::move(out_callback)));
+      new JSONSpan(span_name, parent, std::move(sink)));
 }
 
 void
 katana::JSONSpan::Close() {
-  std::string message{"finished"};
-
-  std::string span_data = GetSpanJSON(GetContext().GetSpanID(), true);
-  std::string log_data = GetLogJSON(message);
-  std::string tag_data;
-  std::string host_data;
-
-  std::string output_json = BuildJSON(
-      GetContext().GetTraceID(), span_data, log_data, tag_data, host_data);
-  OutputJSON(out_callback_, output_json);
+  TraceStamp stamp = TraceStamp::Take();
+  sink_->Push([stamp, trace_id = GetContext().GetTraceID(),
+               span_id = GetContext().GetSpanID()] {
+    return BuildJSON(
+        trace_id, GetSpanJSON(span_id, true), GetLogJSON("finished", stamp),
+        "", "", stamp);
+  });
 }
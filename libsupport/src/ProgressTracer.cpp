@@ -7,6 +7,7 @@
 #include <regex>
 
 #include "katana/Logging.h"
+#include "katana/SamplingProfiler.h"
 #include "katana/config.h"
 
 #if __linux__
@@ -135,6 +136,7 @@ katana::ProgressTracer::FinishActiveSpan() {
   if (active_span_ != nullptr) {
     auto old_active_span = active_span_;
     active_span_ = old_active_span->GetParentSpan();
+    internal::SetProfiledSpan(active_span_.get());
     if (!old_active_span->IsFinished()) {
       old_active_span->Finish();
     }
@@ -162,6 +164,7 @@ katana::ProgressScope
 katana::ProgressTracer::SetActiveSpan(
     std::shared_ptr<katana::ProgressSpan> span) {
   active_span_ = span;
+  internal::SetProfiledSpan(active_span_.get());
   return ProgressScope(std::move(span));
 }
 
@@ -176,6 +179,7 @@ katana::ProgressTracer::Finish() {
 
   active_span_ = nullptr;
   default_active_span_ = nullptr;
+  internal::SetProfiledSpan(nullptr);
 
   Close();
 }
@@ -244,6 +248,7 @@ katana::ProgressSpan::ScopeClosed() {
 void
 katana::ProgressSpan::Finish() {
   if (!finished_) {
+    internal::LogProfiledSamples(this);
     finished_ = true;
     Close();
   }
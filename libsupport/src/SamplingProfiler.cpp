@@ -0,0 +1,288 @@
+#include "katana/SamplingProfiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+
+namespace {
+
+/// deepest stack recorded; deeper stacks lose their outermost frames
+constexpr int kMaxDepth = 64;
+/// frames of the signal handler and of the signal trampoline
+constexpr int kSkipFrames = 2;
+/// samples taken but not yet charged to their spans; a sample that finds its
+/// slot still full is dropped
+constexpr size_t kNumSlots = 4096;
+/// stacks logged per span, most sampled first; the rest are only counted
+constexpr size_t kMaxStacksPerSpan = 64;
+
+enum SlotState : int { kEmpty, kWriting, kFull };
+
+struct Sample {
+  std::atomic<int> state;
+  const katana::ProgressSpan* span;
+  int depth;
+  void* pcs[kMaxDepth];
+};
+
+// The signal handler only touches these, with lock-free atomics.
+Sample samples[kNumSlots];
+std::atomic<uint64_t> next_slot;
+std::atomic<uint64_t> num_dropped;
+std::atomic<const katana::ProgressSpan*> profiled_span;
+std::atomic<bool> running;
+
+using Stack = std::vector<void*>;
+
+/// Everything below is only touched outside of the signal handler
+struct Profile {
+  std::mutex mutex;
+  uint32_t hz{0};
+  std::unordered_map<const katana::ProgressSpan*, std::map<Stack, uint64_t>>
+      stacks_by_span;
+  std::unordered_map<void*, std::string> names;
+};
+
+Profile&
+GetProfile() {
+  static Profile profile;
+  return profile;
+}
+
+void
+OnSigprof(int, siginfo_t*, void*) {
+  if (!running.load(std::memory_order_relaxed)) {
+    return;
+  }
+  int saved_errno = errno;
+
+  Sample& sample =
+      samples[next_slot.fetch_add(1, std::memory_order_relaxed) % kNumSlots];
+  int expected = kEmpty;
+  if (!sample.state.compare_exchange_strong(
+          expected, kWriting, std::memory_order_acquire)) {
+    num_dropped.fetch_add(1, std::memory_order_relaxed);
+    errno = saved_errno;
+    return;
+  }
+
+  void* pcs[kMaxDepth + kSkipFrames];
+  int depth =
+      std::max(0, backtrace(pcs, kMaxDepth + kSkipFrames) - kSkipFrames);
+  std::memcpy(sample.pcs, pcs + kSkipFrames, depth * sizeof(void*));
+  sample.depth = depth;
+  sample.span = profiled_span.load(std::memory_order_relaxed);
+  sample.state.store(kFull, std::memory_order_release);
+
+  errno = saved_errno;
+}
+
+/// Move the samples taken so far to the stacks of their spans. Requires the
+/// mutex of the profile.
+void
+Collect(Profile* profile) {
+  for (Sample& sample : samples) {
+    if (sample.state.load(std::memory_order_acquire) != kFull) {
+      continue;
+    }
+    if (sample.span) {
+      Stack stack(sample.pcs, sample.pcs + sample.depth);
+      profile->stacks_by_span[sample.span][stack] += 1;
+    }
+    sample.state.store(kEmpty, std::memory_order_release);
+  }
+}
+
+/// Name a frame for a folded stack, which must not have the separator ';' and
+/// the characters that the tracers would have to escape
+std::string
+FrameName(Profile* profile, void* pc) {
+  auto it = profile->names.find(pc);
+  if (it != profile->names.end()) {
+    return it->second;
+  }
+
+  std::string name;
+  Dl_info info;
+  if (dladdr(pc, &info) && info.dli_sname) {
+    int status = 0;
+    char* demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    name = status == 0 ? demangled : info.dli_sname;
+    std::free(demangled);
+  } else if (info.dli_fname) {
+    const char* module = std::strrchr(info.dli_fname, '/');
+    name = fmt::format(
+        "{}+0x{:x}", module ? module + 1 : info.dli_fname,
+        reinterpret_cast<uintptr_t>(pc) -
+            reinterpret_cast<uintptr_t>(info.dli_fbase));
+  } else {
+    name = fmt::format("0x{:x}", reinterpret_cast<uintptr_t>(pc));
+  }
+  std::replace_if(
+      name.begin(), name.end(),
+      [](char c) { return c == ';' || c == '"' || c == '\\' || c < ' '; },
+      '_');
+
+  return profile->names.emplace(pc, std::move(name)).first->second;
+}
+
+bool
+SetTimer(uint32_t hz) {
+  struct itimerval timer;
+  std::memset(&timer, 0, sizeof(timer));
+  if (hz > 0) {
+    uint32_t period_us = 1000000 / hz;
+    timer.it_interval.tv_sec = period_us / 1000000;
+    timer.it_interval.tv_usec = period_us % 1000000;
+    timer.it_value = timer.it_interval;
+  }
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::StartSamplingProfiler(uint32_t hz) {
+  if (hz == 0 || hz > 10000) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "sampling rate of {} Hz is not between 1 and 10000", hz);
+  }
+
+  Profile& profile = GetProfile();
+  std::lock_guard<std::mutex> lock(profile.mutex);
+  if (running) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "sampling profiler is already running");
+  }
+
+  // The first call of backtrace loads the unwinder, which must not happen in
+  // the signal handler
+  void* pcs[kMaxDepth];
+  backtrace(pcs, kMaxDepth);
+
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_sigaction = OnSigprof;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, nullptr) != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "installing SIGPROF handler: {}",
+        ResultErrno().message());
+  }
+
+  profile.hz = hz;
+  running = true;
+  if (!SetTimer(hz)) {
+    running = false;
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "starting profiling timer: {}",
+        ResultErrno().message());
+  }
+  return ResultSuccess();
+}
+
+void
+katana::StopSamplingProfiler() {
+  Profile& profile = GetProfile();
+  std::lock_guard<std::mutex> lock(profile.mutex);
+  if (!running) {
+    return;
+  }
+  if (!SetTimer(0)) {
+    KATANA_LOG_WARN("stopping profiling timer: {}", ResultErrno().message());
+  }
+  running = false;
+  // a signal still pending must not take the default action, which is to
+  // terminate the process
+  std::signal(SIGPROF, SIG_IGN);
+  Collect(&profile);
+}
+
+bool
+katana::IsSamplingProfilerRunning() {
+  return running;
+}
+
+void
+katana::internal::SetProfiledSpan(const ProgressSpan* span) {
+  profiled_span.store(span, std::memory_order_relaxed);
+}
+
+void
+katana::internal::LogProfiledSamples(ProgressSpan* span) {
+  Profile& profile = GetProfile();
+  std::lock_guard<std::mutex> lock(profile.mutex);
+  if (running) {
+    Collect(&profile);
+  }
+
+  auto it = profile.stacks_by_span.find(span);
+  if (it == profile.stacks_by_span.end()) {
+    return;
+  }
+
+  // stacks that differ only in the return addresses within a function fold
+  // into the same frames
+  std::unordered_map<std::string, uint64_t> folded_counts;
+  uint64_t total = 0;
+  for (const auto& [stack, count] : it->second) {
+    // folded stacks start at the outermost frame
+    std::string folded;
+    for (auto pc = stack.rbegin(); pc != stack.rend(); ++pc) {
+      if (!folded.empty()) {
+        folded += ';';
+      }
+      folded += FrameName(&profile, *pc);
+    }
+    folded_counts[folded] += count;
+    total += count;
+  }
+
+  std::vector<std::pair<uint64_t, const std::string*>> by_count;
+  for (const auto& [folded, count] : folded_counts) {
+    by_count.emplace_back(count, &folded);
+  }
+  std::sort(
+      by_count.begin(), by_count.end(),
+      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  size_t num_logged = std::min(by_count.size(), kMaxStacksPerSpan);
+  uint64_t other = 0;
+  for (size_t i = num_logged; i < by_count.size(); ++i) {
+    other += by_count[i].first;
+  }
+  span->Log(
+      "sampling profile",
+      {{"samples", total},
+       {"hz", profile.hz},
+       {"unlogged_samples", other},
+       {"dropped_samples", num_dropped.exchange(0)}});
+  for (size_t i = 0; i < num_logged; ++i) {
+    span->Log(
+        "sampled stack",
+        {{"folded_stack", *by_count[i].second},
+         {"samples", by_count[i].first}});
+  }
+
+  profile.stacks_by_span.erase(it);
+}
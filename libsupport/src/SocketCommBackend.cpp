@@ -0,0 +1,485 @@
+#include "katana/SocketCommBackend.h"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kConnectRetryInterval = std::chrono::milliseconds(50);
+
+/// Split "host:port" at its last colon
+katana::Result<std::pair<std::string, std::string>>
+SplitAddress(const std::string& address) {
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos || colon + 1 == address.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "address {} is not of the form host:port", address);
+  }
+  return std::make_pair(address.substr(0, colon), address.substr(colon + 1));
+}
+
+struct AddrInfoDeleter {
+  void operator()(addrinfo* info) const { freeaddrinfo(info); }
+};
+
+using AddrInfoPtr = std::unique_ptr<addrinfo, AddrInfoDeleter>;
+
+katana::Result<AddrInfoPtr>
+Resolve(const std::string& address, bool passive) {
+  auto [host, port] = KATANA_CHECKED(SplitAddress(address));
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = passive ? AI_PASSIVE : 0;
+  addrinfo* info = nullptr;
+  if (int err = getaddrinfo(host.c_str(), port.c_str(), &hints, &info);
+      err != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "resolving {}: {}", address,
+        gai_strerror(err));
+  }
+  return AddrInfoPtr(info);
+}
+
+katana::Result<void>
+WriteAll(int fd, const void* data, size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "send");
+    }
+    bytes += n;
+    size -= n;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+ReadAll(int fd, void* data, size_t size) {
+  char* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t n = recv(fd, bytes, size, 0);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "recv");
+    }
+    if (n == 0) {
+      return KATANA_ERROR(
+          std::make_error_code(std::errc::connection_reset),
+          "connection closed");
+    }
+    bytes += n;
+    size -= n;
+  }
+  return katana::ResultSuccess();
+}
+
+/// Connect to address, retrying until deadline while nobody listens there
+katana::Result<int>
+Connect(const std::string& address, Clock::time_point deadline) {
+  auto info = KATANA_CHECKED(Resolve(address, false));
+
+  for (;;) {
+    int last_errno = 0;
+    for (addrinfo* ai = info.get(); ai != nullptr; ai = ai->ai_next) {
+      int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd < 0) {
+        last_errno = errno;
+        continue;
+      }
+      if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+        return fd;
+      }
+      last_errno = errno;
+      close(fd);
+    }
+    if (Clock::now() >= deadline) {
+      return KATANA_ERROR(
+          std::error_code(last_errno, std::system_category()),
+          "connecting to {}", address);
+    }
+    std::this_thread::sleep_for(kConnectRetryInterval);
+  }
+}
+
+/// Accept a connection on listen_fd, waiting until deadline
+katana::Result<int>
+Accept(int listen_fd, Clock::time_point deadline) {
+  for (;;) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - Clock::now());
+    if (remaining.count() <= 0) {
+      return KATANA_ERROR(
+          std::make_error_code(std::errc::timed_out),
+          "waiting for other tasks to connect");
+    }
+    pollfd pfd{listen_fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, static_cast<int>(remaining.count()));
+    if (ready < 0 && errno != EINTR) {
+      return KATANA_ERROR(katana::ResultErrno(), "poll");
+    }
+    if (ready <= 0) {
+      continue;
+    }
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd >= 0) {
+      return fd;
+    }
+    if (errno != EINTR && errno != ECONNABORTED) {
+      return KATANA_ERROR(katana::ResultErrno(), "accept");
+    }
+  }
+}
+
+katana::Result<void>
+SetStreamOptions(int fd) {
+  int one = 1;
+  if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "setting TCP_NODELAY");
+  }
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "setting O_NONBLOCK");
+  }
+  return katana::ResultSuccess();
+}
+
+/// One peer's side of an AllToAll: a message framed by its 64-bit length
+/// going out and one coming in
+struct Transfer {
+  int fd{-1};
+
+  uint64_t out_size{0};
+  const std::string* out{nullptr};
+  size_t sent{0};
+
+  uint64_t in_size{0};
+  std::string in;
+  size_t received{0};
+
+  static constexpr size_t kHeaderSize = sizeof(uint64_t);
+
+  bool sending() const { return sent < kHeaderSize + out_size; }
+  bool receiving() const {
+    return received < kHeaderSize || received < kHeaderSize + in_size;
+  }
+
+  /// @returns false if the socket would block
+  katana::Result<bool> Send() {
+    const char* data;
+    size_t size;
+    if (sent < kHeaderSize) {
+      data = reinterpret_cast<const char*>(&out_size) + sent;
+      size = kHeaderSize - sent;
+    } else {
+      data = out->data() + (sent - kHeaderSize);
+      size = out_size - (sent - kHeaderSize);
+    }
+    ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return false;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "send");
+    }
+    sent += n;
+    return true;
+  }
+
+  /// @returns false if the socket would block
+  katana::Result<bool> Receive() {
+    char* data;
+    size_t size;
+    if (received < kHeaderSize) {
+      data = reinterpret_cast<char*>(&in_size) + received;
+      size = kHeaderSize - received;
+    } else {
+      data = in.data() + (received - kHeaderSize);
+      size = in_size - (received - kHeaderSize);
+    }
+    ssize_t n = recv(fd, data, size, 0);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return false;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "recv");
+    }
+    if (n == 0) {
+      return KATANA_ERROR(
+          std::make_error_code(std::errc::connection_reset),
+          "connection closed");
+    }
+    received += n;
+    if (received == kHeaderSize) {
+      in.resize(in_size);
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+katana::Result<katana::SocketListener>
+katana::SocketListener::Make(const std::string& address) {
+  auto info = KATANA_CHECKED(Resolve(address, true));
+
+  int last_errno = 0;
+  for (addrinfo* ai = info.get(); ai != nullptr; ai = ai->ai_next) {
+    int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) {
+      last_errno = errno;
+      continue;
+    }
+    int one = 1;
+    sockaddr_storage bound{};
+    socklen_t bound_len = sizeof(bound);
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 ||
+        listen(fd, SOMAXCONN) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &bound_len) !=
+            0) {
+      last_errno = errno;
+      close(fd);
+      continue;
+    }
+
+    uint16_t port = 0;
+    if (bound.ss_family == AF_INET) {
+      port = ntohs(reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+    } else if (bound.ss_family == AF_INET6) {
+      port = ntohs(reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port);
+    }
+    return SocketListener(fd, port);
+  }
+  return KATANA_ERROR(
+      std::error_code(last_errno, std::system_category()), "listening on {}",
+      address);
+}
+
+katana::SocketListener::SocketListener(SocketListener&& other) noexcept {
+  std::swap(fd_, other.fd_);
+  std::swap(port_, other.port_);
+}
+
+katana::SocketListener&
+katana::SocketListener::operator=(SocketListener&& other) noexcept {
+  std::swap(fd_, other.fd_);
+  std::swap(port_, other.port_);
+  return *this;
+}
+
+katana::SocketListener::~SocketListener() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+katana::Result<std::unique_ptr<katana::SocketCommBackend>>
+katana::SocketCommBackend::Make(
+    const std::vector<std::string>& addresses, uint32_t rank,
+    uint32_t timeout_seconds) {
+  if (rank >= addresses.size()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "rank {} but only {} tasks", rank,
+        addresses.size());
+  }
+  auto listener = KATANA_CHECKED(SocketListener::Make(addresses[rank]));
+  return Make(addresses, rank, std::move(listener), timeout_seconds);
+}
+
+katana::Result<std::unique_ptr<katana::SocketCommBackend>>
+katana::SocketCommBackend::Make(
+    const std::vector<std::string>& addresses, uint32_t rank,
+    SocketListener listener, uint32_t timeout_seconds) {
+  uint32_t num = addresses.size();
+  if (rank >= num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "rank {} but only {} tasks", rank, num);
+  }
+
+  // Own the connections as soon as they exist so that errors close them
+  std::unique_ptr<SocketCommBackend> comm(
+      new SocketCommBackend(std::vector<int>(num, -1)));
+  auto deadline = Clock::now() + std::chrono::seconds(timeout_seconds);
+
+  // Every task connects to the tasks before it and accepts the ones after
+  // it; it introduces itself with its rank since accept order is arbitrary.
+  for (uint32_t peer = 0; peer < rank; ++peer) {
+    comm->fds_[peer] = KATANA_CHECKED_CONTEXT(
+        Connect(addresses[peer], deadline), "task {}", rank);
+    KATANA_CHECKED_CONTEXT(
+        WriteAll(comm->fds_[peer], &rank, sizeof(rank)),
+        "introducing task {} to task {}", rank, peer);
+  }
+  for (uint32_t i = rank + 1; i < num; ++i) {
+    int fd = KATANA_CHECKED_CONTEXT(
+        Accept(listener.fd_, deadline), "task {}", rank);
+    uint32_t peer = 0;
+    auto res = ReadAll(fd, &peer, sizeof(peer));
+    if (!res || peer <= rank || peer >= num || comm->fds_[peer] >= 0) {
+      close(fd);
+      if (!res) {
+        return res.error().WithContext("task {} introduction", rank);
+      }
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "task {} got an unexpected connection from task {}", rank, peer);
+    }
+    comm->fds_[peer] = fd;
+  }
+
+  uint32_t local_rank = 0;
+  auto host = KATANA_CHECKED(SplitAddress(addresses[rank])).first;
+  for (uint32_t peer = 0; peer < num; ++peer) {
+    if (peer != rank) {
+      KATANA_CHECKED(SetStreamOptions(comm->fds_[peer]));
+    }
+    if (peer < rank && KATANA_CHECKED(SplitAddress(addresses[peer])).first ==
+                           host) {
+      ++local_rank;
+    }
+  }
+
+  comm->Initialize(num, rank, local_rank);
+  return std::unique_ptr<SocketCommBackend>(std::move(comm));
+}
+
+katana::SocketCommBackend::~SocketCommBackend() { CloseAll(); }
+
+void
+katana::SocketCommBackend::CloseAll() {
+  for (int& fd : fds_) {
+    if (fd >= 0) {
+      shutdown(fd, SHUT_RDWR);
+      close(fd);
+      fd = -1;
+    }
+  }
+}
+
+void
+katana::SocketCommBackend::Barrier() {
+  auto res = AllToAll(std::vector<std::string>(Num));
+  if (!res) {
+    KATANA_LOG_FATAL("barrier failed: {}", res.error());
+  }
+}
+
+bool
+katana::SocketCommBackend::Broadcast(uint32_t root, bool val) {
+  return Broadcast(root, std::string(1, val ? '1' : '0'), 1) == "1";
+}
+
+std::string
+katana::SocketCommBackend::Broadcast(
+    uint32_t root, const std::string& val, uint64_t max_size) {
+  std::vector<std::string> sends(Num);
+  if (Rank == root) {
+    sends.assign(Num, val.substr(0, max_size));
+  }
+  auto res = AllToAll(std::move(sends));
+  if (!res) {
+    KATANA_LOG_FATAL("broadcast from task {} failed: {}", root, res.error());
+  }
+  return std::move(res.value()[root]);
+}
+
+void
+katana::SocketCommBackend::NotifyFailure() {
+  CloseAll();
+}
+
+katana::Result<std::vector<std::string>>
+katana::SocketCommBackend::AllToAll(std::vector<std::string> sends) {
+  if (sends.size() != Num) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "expected one message per task ({}), got {}", Num, sends.size());
+  }
+
+  std::vector<Transfer> transfers(Num);
+  for (uint32_t peer = 0; peer < Num; ++peer) {
+    if (peer == Rank) {
+      continue;
+    }
+    if (fds_[peer] < 0) {
+      return KATANA_ERROR(
+          std::make_error_code(std::errc::not_connected),
+          "connection to task {} was closed", peer);
+    }
+    Transfer& t = transfers[peer];
+    t.fd = fds_[peer];
+    t.out = &sends[peer];
+    t.out_size = sends[peer].size();
+  }
+
+  std::vector<pollfd> pfds;
+  std::vector<uint32_t> peers;
+  for (;;) {
+    pfds.clear();
+    peers.clear();
+    for (uint32_t peer = 0; peer < Num; ++peer) {
+      const Transfer& t = transfers[peer];
+      if (peer == Rank || (!t.sending() && !t.receiving())) {
+        continue;
+      }
+      short events = (t.sending() ? POLLOUT : 0) | (t.receiving() ? POLLIN : 0);
+      pfds.emplace_back(pollfd{t.fd, events, 0});
+      peers.emplace_back(peer);
+    }
+    if (pfds.empty()) {
+      break;
+    }
+
+    if (poll(pfds.data(), pfds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "poll");
+    }
+
+    for (size_t i = 0; i < pfds.size(); ++i) {
+      Transfer& t = transfers[peers[i]];
+      short revents = pfds[i].revents;
+      if ((revents & POLLOUT) != 0 || (revents & (POLLERR | POLLHUP)) != 0) {
+        while (t.sending() &&
+               KATANA_CHECKED_CONTEXT(t.Send(), "to task {}", peers[i])) {
+        }
+      }
+      if ((revents & (POLLIN | POLLERR | POLLHUP)) != 0) {
+        while (t.receiving() &&
+               KATANA_CHECKED_CONTEXT(t.Receive(), "from task {}", peers[i])) {
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> recvs(Num);
+  for (uint32_t peer = 0; peer < Num; ++peer) {
+    recvs[peer] =
+        peer == Rank ? std::move(sends[peer]) : std::move(transfers[peer].in);
+  }
+  return recvs;
+}
@@ -4,26 +4,17 @@
 
 #include <cstring>
 #include <iostream>
-#include <mutex>
 #include <string>
 
-#include <arrow/memory_pool.h>
-
-#include "katana/Random.h"
-#include "katana/Time.h"
-
 namespace {
 
-std::mutex output_mutex;
-
 std::string
-GetHostStatsText() {
+GetHostStatsText(uint32_t num_hosts) {
   katana::HostStats host_stats = katana::ProgressTracer::GetHostStats();
-  auto& tracer = katana::ProgressTracer::Get();
   return fmt::format(
-      "hosts={} hostname={} hardware_threads={} pid={} ram_gb={}",
-      tracer.GetNumHosts(), host_stats.hostname, host_stats.nprocs,
-      host_stats.pid, host_stats.ram_gb);
+      "hosts={} hostname={} hardware_threads={} pid={} ram_gb={}", num_hosts,
+      host_stats.hostname, host_stats.nprocs, host_stats.pid,
+      host_stats.ram_gb);
 }
 
 std::string
@@ -49,22 +40,17 @@ GetTagsText(const katana::Tags& tags) {
 std::string
 BuildText(
     const std::string& message, const std::string& tag_data,
-    const std::string& host_data) {
+    const std::string& host_data, const katana::TraceStamp& stamp) {
   fmt::memory_buffer buf;
-  uint32_t host_id = katana::ProgressTracer::Get().GetHostID();
-  static auto begin = katana::Now();
-  auto msec_since_begin = katana::UsSince(begin) / 1000;
 
   fmt::format_to(
       std::back_inserter(buf),
       "TRACE: host={} ms={} max_mem_gb={:.3f} mem_gb={:.3f} "
       "arrow_mem_gb={:.3f}",
-      host_id, msec_since_begin,
-      katana::ProgressTracer::GetMaxMem() / 1024.0 / 1024.0,
+      stamp.host_id, stamp.offset_ms, stamp.max_mem_kb / 1024.0 / 1024.0,
       katana::ProgressTracer::ParseProcSelfRssBytes() / 1024.0 / 1024.0 /
           1024.0,
-      arrow::default_memory_pool()->bytes_allocated() / 1024.0 / 1024.0 /
-          1024.0);
+      stamp.arrow_bytes / 1024.0 / 1024.0 / 1024.0);
   if (!tag_data.empty()) {
     fmt::format_to(std::back_inserter(buf), " {}", tag_data);
   }
@@ -75,23 +61,39 @@ BuildText(
   return fmt::to_string(buf);
 }
 
+/// Push a line of message and tags, stamped now
 void
-OutputText(const std::string& output) {
-  std::lock_guard<std::mutex> lock(output_mutex);
-  std::cerr << output;
+PushText(
+    katana::TraceSink* sink, std::string message, katana::Tags tags,
+    bool with_host_data) {
+  katana::TraceStamp stamp = katana::TraceStamp::Take();
+  uint32_t num_hosts =
+      with_host_data ? katana::ProgressTracer::Get().GetNumHosts() : 0;
+  sink->Push([stamp, message = std::move(message), tags = std::move(tags),
+              with_host_data, num_hosts] {
+    std::string host_data;
+    if (with_host_data) {
+      host_data = GetHostStatsText(num_hosts);
+    }
+    return BuildText(message, GetTagsText(tags), host_data, stamp);
+  });
 }
 
 }  // namespace
 
 std::unique_ptr<katana::TextTracer>
-katana::TextTracer::Make(uint32_t host_id, uint32_t num_hosts) {
-  return std::unique_ptr<TextTracer>(new TextTracer(host_id, num_hosts));
+katana::TextTracer::Make(
+    uint32_t host_id, uint32_t num_hosts, size_t buffer_lines) {
+  auto sink = std::make_shared<TraceSink>(
+      [](const std::string& output) { std::cerr << output; }, buffer_lines);
+  return std::unique_ptr<TextTracer>(
+      new TextTracer(host_id, num_hosts, std::move(sink)));
 }
 
 std::shared_ptr<katana::ProgressSpan>
 katana::TextTracer::StartSpan(
     const std::string& span_name, const katana::ProgressContext& child_of) {
-  return TextSpan::Make(span_name, child_of);
+  return TextSpan::Make(span_name, child_of, sink_);
 }
 
 std::string
@@ -114,7 +116,7 @@ std::shared_ptr<katana::ProgressSpan>
 katana::TextTracer::StartSpan(
     const std::string& span_name,
     std::shared_ptr<katana::ProgressSpan> child_of) {
-  return TextSpan::Make(span_name, std::move(child_of));
+  return TextSpan::Make(span_name, std::move(child_of), sink_);
 }
 
 std::unique_ptr<katana::ProgressContext>
@@ -124,72 +126,53 @@ katana::TextContext::Clone() const noexcept {
 
 void
 katana::TextSpan::SetTags(const katana::Tags& tags) {
-  std::string message = "tags for " + span_name_;
-  std::string tags_data = GetTagsText(tags);
-  std::string host_data;
-
-  std::string output_Text = BuildText(message, tags_data, host_data);
-  OutputText(output_Text);
+  PushText(sink_.get(), "tags for " + span_name_, tags, false);
 }
 
 void
 katana::TextSpan::Log(const std::string& message, const katana::Tags& tags) {
-  std::string tags_data = GetTagsText(tags);
-  std::string host_data;
-
-  std::string output_Text = BuildText(message, tags_data, host_data);
-  OutputText(output_Text);
+  PushText(sink_.get(), message, tags, false);
 }
 
 katana::TextSpan::TextSpan(
-    const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent)
+    const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent,
+    std::shared_ptr<TraceSink> sink)
     : ProgressSpan(std::move(parent)),
       context_(TextContext{"0", "0"}),
-      span_name_(span_name) {
-  std::string message = "starting " + span_name;
-  std::string tags_data;
-  std::string host_data;
-  if (GetParentSpan() == nullptr) {
-    host_data = GetHostStatsText();
-  }
-
-  std::string output_Text = BuildText(message, tags_data, host_data);
-  OutputText(output_Text);
+      span_name_(span_name),
+      sink_(std::move(sink)) {
+  PushText(
+      sink_.get(), "starting " + span_name, {}, GetParentSpan() == nullptr);
 }
 
 katana::TextSpan::TextSpan(
     const std::string& span_name,
-    [[maybe_unused]] const katana::ProgressContext& parent)
+    [[maybe_unused]] const katana::ProgressContext& parent,
+    std::shared_ptr<TraceSink> sink)
     : ProgressSpan(nullptr),
       context_(TextContext{"0", "0"}),
-      span_name_(span_name) {
-  std::string message = "starting " + span_name;
-  std::string tags_data;
-  std::string host_data = GetHostStatsText();
-
-  std::string output_Text = BuildText(message, tags_data, host_data);
-  OutputText(output_Text);
+      span_name_(span_name),
+      sink_(std::move(sink)) {
+  PushText(sink_.get(), "starting " + span_name, {}, true);
 }
 
 std::shared_ptr<katana::ProgressSpan>
 katana::TextSpan::Make(
-    const std::string& span_name,
-    std::shared_ptr<katana::ProgressSpan> parent) {
-  return std::shared_ptr<TextSpan>(new TextSpan(span_name, std::move(parent)));
+    const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent,
+    std::shared_ptr<TraceSink> sink) {
+  return std::shared_ptr<TextSpan>(
+      new TextSpan(span_name, std::move(parent), std::move(sink)));
 }
 
 std::shared_ptr<katana::ProgressSpan>
 katana::TextSpan::Make(
-    const std::string& span_name, const katana::ProgressContext& parent) {
-  return std::shared_ptr<TextSpan>(new TextSpan(span_name, parent));
+    const std::string& span_name, const katana::ProgressContext& parent,
+    std::shared_ptr<TraceSink> sink) {
+  return std::shared_ptr<TextSpan>(
+      new TextSpan(span_name, parent, std::move(sink)));
 }
 
 void
 katana::TextSpan::Close() {
-  std::string message = "finished " + span_name_;
-  std::string tags_data;
-  std::string host_data;
-
-  std::string output_Text = BuildText(message, tags_data, host_data);
-  OutputText(output_Text);
+  PushText(sink_.get(), "finished " + span_name_, {}, false);
 }
@@ -0,0 +1,185 @@
+#include "katana/TraceSink.h"
+
+#include <chrono>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Time.h"
+
+namespace {
+
+/// How long the writer sleeps when it found nothing to write
+constexpr std::chrono::milliseconds kWriterInterval{10};
+
+std::atomic<uint64_t> next_sink_id{1};
+
+/// The ring of the calling thread in the sink it last pushed to
+struct LocalRingCache {
+  uint64_t sink_id{0};
+  void* ring{nullptr};
+};
+
+thread_local LocalRingCache local_ring;
+
+}  // namespace
+
+/// A single producer, single consumer ring of lines. The thread that owns
+/// the ring only advances tail and whoever drains the sink only advances
+/// head.
+struct katana::TraceSink::Ring {
+  explicit Ring(size_t capacity) : lines(capacity) {}
+
+  std::vector<TraceLine> lines;
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+};
+
+katana::TraceStamp
+katana::TraceStamp::Take() {
+  static auto begin = Now();
+  TraceStamp stamp;
+  stamp.host_id = ProgressTracer::Get().GetHostID();
+  stamp.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           Now().time_since_epoch())
+                           .count();
+  stamp.offset_ms = UsSince(begin) / 1000;
+  stamp.max_mem_kb = ProgressTracer::GetMaxMem();
+  stamp.arrow_bytes = arrow::default_memory_pool()->bytes_allocated();
+  return stamp;
+}
+
+katana::TraceSink::TraceSink(OutputCB out_callback, size_t buffer_lines)
+    : out_callback_(std::move(out_callback)),
+      buffer_lines_(buffer_lines),
+      id_(next_sink_id.fetch_add(1)) {}
+
+katana::TraceSink::~TraceSink() { Close(); }
+
+bool
+katana::TraceSink::Push(TraceLine line) {
+  if (buffer_lines_ == 0) {
+    std::lock_guard<std::mutex> lock(output_mutex_);
+    Write(line);
+    return true;
+  }
+
+  Ring* ring = LocalRing();
+  uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+  if (tail - ring->head.load(std::memory_order_acquire) == buffer_lines_) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  ring->lines[tail % buffer_lines_] = std::move(line);
+  ring->tail.store(tail + 1, std::memory_order_release);
+
+  if (!running_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_ && !stopping_) {
+      writer_ = std::thread(&TraceSink::RunWriter, this);
+      running_ = true;
+    }
+  }
+  return true;
+}
+
+void
+katana::TraceSink::Close() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (running_ && !stopping_) {
+    stopping_ = true;
+    std::thread writer = std::move(writer_);
+    lock.unlock();
+    wake_.notify_all();
+    writer.join();
+    lock.lock();
+    running_ = false;
+    stopping_ = false;
+  }
+  lock.unlock();
+
+  // the writer is gone, so write whatever it left behind here
+  Drain();
+
+  uint64_t num_dropped = dropped();
+  std::lock_guard<std::mutex> output_lock(output_mutex_);
+  if (num_dropped > dropped_reported_) {
+    KATANA_LOG_WARN(
+        "trace dropped {} lines because a buffer of {} lines was full",
+        num_dropped - dropped_reported_, buffer_lines_);
+    dropped_reported_ = num_dropped;
+  }
+}
+
+uint64_t
+katana::TraceSink::dropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t total = 0;
+  for (const auto& ring : rings_) {
+    total += ring->dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+katana::TraceSink::Ring*
+katana::TraceSink::LocalRing() {
+  if (local_ring.sink_id == id_) {
+    return static_cast<Ring*>(local_ring.ring);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] =
+      ring_of_thread_.emplace(std::this_thread::get_id(), nullptr);
+  if (inserted) {
+    rings_.emplace_back(std::make_unique<Ring>(buffer_lines_));
+    it->second = rings_.back().get();
+  }
+  local_ring = LocalRingCache{id_, it->second};
+  return it->second;
+}
+
+void
+katana::TraceSink::Write(const TraceLine& line) {
+  out_callback_(line());
+}
+
+size_t
+katana::TraceSink::Drain() {
+  std::vector<Ring*> rings;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& ring : rings_) {
+      rings.emplace_back(ring.get());
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(output_mutex_);
+  size_t written = 0;
+  for (Ring* ring : rings) {
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      TraceLine& line = ring->lines[head % buffer_lines_];
+      Write(line);
+      line = nullptr;
+      ring->head.store(head + 1, std::memory_order_release);
+      ++written;
+    }
+  }
+  return written;
+}
+
+void
+katana::TraceSink::RunWriter() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    lock.unlock();
+    size_t written = Drain();
+    lock.lock();
+    if (written == 0) {
+      wake_.wait_for(lock, kWriterInterval, [this] { return stopping_; });
+    }
+  }
+}
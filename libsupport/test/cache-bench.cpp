@@ -0,0 +1,124 @@
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Cache.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/ShardedCache.h"
+
+namespace {
+
+constexpr size_t kNumKeys = 4096;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long num_threads : {1, 2, 4, 8, 16, 32, 64}) {
+    for (long ops : {1024, 16 * 1024}) {
+      b->Args({num_threads, ops});
+    }
+  }
+}
+
+const std::vector<katana::URI>&
+Keys() {
+  static std::vector<katana::URI> keys = []() {
+    std::vector<katana::URI> ret(kNumKeys);
+    for (auto& key : ret) {
+      auto uri_res = katana::URI::Make(katana::RandomAlphanumericString(16));
+      KATANA_LOG_ASSERT(uri_res);
+      key = uri_res.value();
+    }
+    return ret;
+  }();
+  return keys;
+}
+
+int64_t
+ValueToBytes(const int64_t& value) {
+  return value;
+}
+
+/// The single threaded cache behind one lock, which is what callers had to do
+/// before ShardedCache
+class LockedCache {
+public:
+  LockedCache() : cache_(ValueToBytes) {}
+
+  void Insert(const katana::URI& key, int64_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.Insert(key, value);
+  }
+
+  std::optional<int64_t> GetAndEvict(const katana::URI& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.GetAndEvict(key);
+  }
+
+private:
+  std::mutex mutex_;
+  katana::Cache<int64_t> cache_;
+};
+
+/// Each thread does \p ops random property manager style operations: take a
+/// value out of the cache if it is there and put it back when done with it
+template <typename CacheType>
+void
+Launch(int num_threads, int ops, CacheType& cache) {
+  const auto& keys = Keys();
+
+  auto work = [&](uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<size_t> dist(0, keys.size() - 1);
+    for (int i = 0; i < ops; ++i) {
+      const auto& key = keys[dist(gen)];
+      auto val = cache.GetAndEvict(key);
+      cache.Insert(key, val.value_or(1));
+    }
+  };
+
+  if (num_threads == 1) {
+    work(0);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(work, i);
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+}
+
+void
+SingleLockCache(benchmark::State& state) {
+  LockedCache cache;
+
+  for (auto _ : state) {
+    Launch(state.range(0), state.range(1), cache);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+void
+ShardedCache(benchmark::State& state) {
+  katana::ShardedCache<int64_t> cache(ValueToBytes);
+
+  for (auto _ : state) {
+    Launch(state.range(0), state.range(1), cache);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+BENCHMARK(SingleLockCache)->Apply(MakeArguments)->UseRealTime();
+BENCHMARK(ShardedCache)->Apply(MakeArguments)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
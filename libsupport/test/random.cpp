@@ -5,8 +5,48 @@
 
 #include "katana/Logging.h"
 
+namespace {
+
+void
+TestPhilox() {
+  // known answers of the reference implementation, Random123; the counter
+  // words are the low and high words of the step and then of the node
+  using Block = katana::Philox::Block;
+  KATANA_LOG_ASSERT(
+      katana::Philox(0).Bits(0, 0) ==
+      (Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  KATANA_LOG_ASSERT(
+      katana::Philox(~uint64_t{0}).Bits(~uint64_t{0}, ~uint64_t{0}) ==
+      (Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  KATANA_LOG_ASSERT(
+      katana::Philox(0x299f31d0a4093822)
+          .Bits(0x0370734413198a2e, 0x85a308d3243f6a88) ==
+      (Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+  katana::Philox philox(8675309);
+  std::vector<uint64_t> values(100);
+  philox.Fill(42, 1000, values.data(), values.size());
+  katana::PhiloxStream stream = philox.ForNode(42, 1000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    KATANA_LOG_ASSERT(values[i] == philox(42, 1000 + i));
+    KATANA_LOG_ASSERT(philox.Double(42, 1000 + i) < 1);
+    KATANA_LOG_ASSERT(philox.Below(42, 1000 + i, 7) < 7);
+    // the stream uses all 128 bits of a step
+    katana::Philox::Block bits = philox.Bits(42, 1000 + i / 2);
+    uint64_t expected = i % 2 == 0 ? uint64_t{bits[1]} << 32 | bits[0]
+                                   : uint64_t{bits[3]} << 32 | bits[2];
+    KATANA_LOG_ASSERT(stream() == expected);
+  }
+  KATANA_LOG_ASSERT(philox(42, 1000) != philox(43, 1000));
+  KATANA_LOG_ASSERT(philox(42, 1000) != katana::Philox(1)(42, 1000));
+}
+
+}  // namespace
+
 int
 main() {
+  TestPhilox();
+
   // test to make sure we have enough randomness
   std::vector<std::thread> threads;
   for (int i = 0; i < 128; ++i) {
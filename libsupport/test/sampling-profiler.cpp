@@ -0,0 +1,72 @@
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "katana/JSONTracer.h"
+#include "katana/Logging.h"
+#include "katana/SamplingProfiler.h"
+
+namespace {
+
+volatile uint64_t sink;
+
+void
+BurnCPU(double seconds) {
+  std::clock_t begin = std::clock();
+  uint64_t x = 1;
+  while (std::clock() - begin < seconds * CLOCKS_PER_SEC) {
+    for (int i = 0; i < 1000; ++i) {
+      x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    sink = x;
+  }
+}
+
+size_t
+Count(const std::vector<std::string>& lines, const std::string& needle) {
+  size_t count = 0;
+  for (const auto& line : lines) {
+    if (line.find(needle) != std::string::npos) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+int
+main() {
+  std::vector<std::string> lines;
+  katana::ProgressTracer::Set(katana::JSONTracer::Make(
+      0, 1, [&](const std::string& line) { lines.emplace_back(line); }));
+  auto& tracer = katana::GetTracer();
+
+  KATANA_LOG_ASSERT(!katana::StartSamplingProfiler(0));
+  KATANA_LOG_ASSERT(katana::StartSamplingProfiler(1000));
+  KATANA_LOG_ASSERT(katana::IsSamplingProfilerRunning());
+  KATANA_LOG_ASSERT(!katana::StartSamplingProfiler(1000));
+
+  {
+    auto scope = tracer.StartActiveSpan("busy");
+    BurnCPU(0.2);
+  }
+  KATANA_LOG_VASSERT(
+      Count(lines, "sampling profile") == 1, "{} profiles",
+      Count(lines, "sampling profile"));
+  KATANA_LOG_ASSERT(Count(lines, "folded_stack") > 0);
+
+  katana::StopSamplingProfiler();
+  KATANA_LOG_ASSERT(!katana::IsSamplingProfilerRunning());
+
+  // no samples after the profiler stops
+  lines.clear();
+  {
+    auto scope = tracer.StartActiveSpan("busy without profiler");
+    BurnCPU(0.05);
+  }
+  KATANA_LOG_ASSERT(Count(lines, "sampling profile") == 0);
+
+  tracer.Finish();
+  return 0;
+}
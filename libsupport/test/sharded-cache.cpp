@@ -0,0 +1,133 @@
+#include "katana/ShardedCache.h"
+
+#include <thread>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Random.h"
+
+namespace {
+
+struct CacheValue {
+  int64_t a;
+};
+
+int64_t
+BytesInValue(const CacheValue& value) {
+  return value.a;
+}
+
+std::vector<katana::URI>
+MakeKeys(size_t size) {
+  std::vector<katana::URI> keys(size);
+  for (size_t i = 0; i < size; ++i) {
+    auto uri_res = katana::URI::Make(katana::RandomAlphanumericString(16));
+    KATANA_LOG_ASSERT(uri_res);
+    keys[i] = uri_res.value();
+  }
+  return keys;
+}
+
+void
+TestSize(const std::vector<katana::URI>& keys) {
+  constexpr int64_t kCapacity = 64;
+  katana::ShardedCache<CacheValue> cache(kCapacity, 4);
+  KATANA_LOG_ASSERT(cache.num_shards() == 4);
+  KATANA_LOG_VASSERT(
+      cache.capacity() == kCapacity, "capacity {}", cache.capacity());
+
+  for (const auto& key : keys) {
+    cache.Insert(key, CacheValue{1});
+    KATANA_LOG_ASSERT(cache.Contains(key));
+    KATANA_LOG_ASSERT(cache.LRUPosition(key) == 0);
+  }
+  KATANA_LOG_VASSERT(cache.size() <= kCapacity, "size {}", cache.size());
+  // The most recently inserted key is always present
+  KATANA_LOG_ASSERT(cache.Get(keys.back()).has_value());
+
+  cache.clear();
+  KATANA_LOG_ASSERT(cache.empty());
+  KATANA_LOG_ASSERT(cache.size() == 0);
+  KATANA_LOG_ASSERT(cache.capacity() == kCapacity);
+}
+
+void
+TestExplicit(const std::vector<katana::URI>& keys) {
+  katana::ShardedCache<CacheValue> cache(
+      [](const CacheValue& value) { return BytesInValue(value); });
+
+  int64_t total{};
+  for (const auto& key : keys) {
+    cache.Insert(key, CacheValue{2});
+    total += 2;
+  }
+  KATANA_LOG_VASSERT(cache.size() == total, "size {}", cache.size());
+
+  auto val = cache.GetAndEvict(keys.front());
+  KATANA_LOG_ASSERT(val.has_value());
+  KATANA_LOG_ASSERT(!cache.Contains(keys.front()));
+  total -= 2;
+
+  // Reclaim spreads over the shards but gets what was asked for
+  auto reclaimed = cache.Reclaim(10);
+  KATANA_LOG_VASSERT(reclaimed >= 10, "reclaimed {}", reclaimed);
+  total -= reclaimed;
+  KATANA_LOG_ASSERT(cache.size() == total);
+
+  // Asking for more than there is empties the cache
+  reclaimed = cache.Reclaim(total + 100);
+  KATANA_LOG_VASSERT(reclaimed == total, "reclaimed {}", reclaimed);
+  KATANA_LOG_ASSERT(cache.empty());
+
+  auto stats = cache.GetStats();
+  KATANA_LOG_ASSERT(stats.get_count == 1);
+  KATANA_LOG_ASSERT(stats.get_hit_count == 1);
+  KATANA_LOG_ASSERT(stats.insert_count == static_cast<int64_t>(keys.size()));
+}
+
+void
+TestConcurrent(const std::vector<katana::URI>& keys) {
+  katana::ShardedCache<CacheValue> cache(
+      [](const CacheValue& value) { return BytesInValue(value); });
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      // Each thread owns the keys congruent to t; it puts them in, takes them
+      // out and puts them back while everybody else does the same
+      for (size_t i = t; i < keys.size(); i += kNumThreads) {
+        cache.Insert(keys[i], CacheValue{1});
+        auto val = cache.GetAndEvict(keys[i]);
+        KATANA_LOG_ASSERT(val.has_value());
+        cache.Insert(keys[i], val.value());
+        KATANA_LOG_ASSERT(cache.Get(keys[i]).has_value());
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  KATANA_LOG_VASSERT(
+      cache.size() == static_cast<int64_t>(keys.size()), "size {}",
+      cache.size());
+  auto stats = cache.GetStats();
+  KATANA_LOG_ASSERT(stats.get_count == static_cast<int64_t>(2 * keys.size()));
+  KATANA_LOG_ASSERT(stats.get_hit_count == stats.get_count);
+}
+
+}  // namespace
+
+int
+main() {
+  auto keys = MakeKeys(1000);
+
+  TestSize(keys);
+
+  TestExplicit(keys);
+
+  TestConcurrent(keys);
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SmallDynamicBitset.h"
+
+namespace {
+
+std::vector<uint64_t>
+SetBits(const katana::SmallDynamicBitset& bs) {
+  return std::vector<uint64_t>(bs.begin(), bs.end());
+}
+
+void
+TestSize(size_t size) {
+  katana::SmallDynamicBitset a;
+  a.resize(size);
+  KATANA_LOG_ASSERT(a.size() == size);
+  KATANA_LOG_ASSERT(a.none());
+  KATANA_LOG_ASSERT(a.begin() == a.end());
+
+  std::vector<uint64_t> expected;
+  for (size_t i = 0; i < size; i += 37) {
+    expected.emplace_back(i);
+  }
+  if (expected.back() != size - 1) {
+    expected.emplace_back(size - 1);
+  }
+  for (auto i : expected) {
+    KATANA_LOG_ASSERT(!a.set(i));
+  }
+  KATANA_LOG_ASSERT(a.set(size - 1));
+  KATANA_LOG_VASSERT(SetBits(a) == expected, "size {}", size);
+  KATANA_LOG_ASSERT(a.count() == expected.size());
+
+  katana::SmallDynamicBitset b;
+  b.resize(size);
+  KATANA_LOG_ASSERT(b.IsSubsetOf(a));
+  KATANA_LOG_ASSERT(!a.IsSubsetOf(b));
+  KATANA_LOG_ASSERT(!a.Intersects(b));
+  b.set(size - 1);
+  KATANA_LOG_ASSERT(b.IsSubsetOf(a));
+  KATANA_LOG_ASSERT(a.Intersects(b));
+  KATANA_LOG_ASSERT((a == b) == (expected.size() == 1));
+
+  katana::SmallDynamicBitset c;
+  c.resize(size);
+  c.bitwise_and(a, b);
+  KATANA_LOG_ASSERT(c == b);
+  c.bitwise_or(a, b);
+  KATANA_LOG_ASSERT(c == a);
+  c.bitwise_xor(b);
+  KATANA_LOG_ASSERT(c.count() == a.count() - 1);
+
+  // the bits past size() stay clear
+  c.bitwise_not();
+  KATANA_LOG_ASSERT(c.count() == size - a.count() + 1);
+  c.set();
+  KATANA_LOG_ASSERT(c.all());
+  KATANA_LOG_ASSERT(c.count() == size);
+
+  // copies and moves keep the bits
+  katana::SmallDynamicBitset d = a;
+  KATANA_LOG_ASSERT(d == a);
+  katana::SmallDynamicBitset e = std::move(d);
+  KATANA_LOG_ASSERT(e == a);
+  KATANA_LOG_ASSERT(d.size() == 0);
+
+  // growing keeps the bits and shrinking drops the bits past the new size
+  e.resize(size * 3);
+  KATANA_LOG_ASSERT(SetBits(e) == expected);
+  e.resize(size - 1);
+  expected.pop_back();
+  KATANA_LOG_ASSERT(SetBits(e) == expected);
+  e.resize(size);
+  KATANA_LOG_ASSERT(!e.test(size - 1));
+
+  e.reset();
+  KATANA_LOG_ASSERT(e.none());
+  KATANA_LOG_ASSERT(e.size() == size);
+}
+
+}  // namespace
+
+int
+main() {
+  for (size_t size : {1, 63, 64, 65, 200, 256, 257, 1000}) {
+    TestSize(size);
+  }
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include "katana/SocketCommBackend.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kNumTasks = 4;
+
+std::vector<std::unique_ptr<katana::SocketCommBackend>>
+ConnectTasks() {
+  // Listen on free ports first so that the addresses are known to everyone
+  std::vector<katana::SocketListener> listeners;
+  std::vector<std::string> addresses;
+  for (uint32_t rank = 0; rank < kNumTasks; ++rank) {
+    auto listener_res = katana::SocketListener::Make("127.0.0.1:0");
+    KATANA_LOG_VASSERT(listener_res, "{}", listener_res.error());
+    addresses.emplace_back(
+        fmt::format("127.0.0.1:{}", listener_res.value().port()));
+    listeners.emplace_back(std::move(listener_res.value()));
+  }
+
+  std::vector<std::unique_ptr<katana::SocketCommBackend>> comms(kNumTasks);
+  std::vector<std::thread> tasks;
+  for (uint32_t rank = 0; rank < kNumTasks; ++rank) {
+    tasks.emplace_back([&, rank]() {
+      auto comm_res = katana::SocketCommBackend::Make(
+          addresses, rank, std::move(listeners[rank]));
+      KATANA_LOG_VASSERT(comm_res, "task {}: {}", rank, comm_res.error());
+      comms[rank] = std::move(comm_res.value());
+    });
+  }
+  for (auto& task : tasks) {
+    task.join();
+  }
+  return comms;
+}
+
+void
+RunTask(katana::SocketCommBackend* comm) {
+  uint32_t rank = comm->rank();
+  KATANA_LOG_ASSERT(comm->num() == kNumTasks);
+  KATANA_LOG_ASSERT(comm->local_rank() == rank);
+
+  // every task sends a different message to every other, including large
+  // ones that do not fit in the socket buffers and empty ones
+  std::vector<std::string> sends(kNumTasks);
+  for (uint32_t to = 0; to < kNumTasks; ++to) {
+    size_t size = to == rank ? 0 : (rank + 1) * (to + 1) * 100000;
+    sends[to] = std::string(size, static_cast<char>('a' + rank));
+  }
+  auto recvs_res = comm->AllToAll(std::move(sends));
+  KATANA_LOG_VASSERT(recvs_res, "task {}: {}", rank, recvs_res.error());
+  const auto& recvs = recvs_res.value();
+  KATANA_LOG_ASSERT(recvs.size() == kNumTasks);
+  for (uint32_t from = 0; from < kNumTasks; ++from) {
+    size_t size = from == rank ? 0 : (from + 1) * (rank + 1) * 100000;
+    KATANA_LOG_VASSERT(
+        recvs[from] == std::string(size, static_cast<char>('a' + from)),
+        "task {} got {} bytes from task {}", rank, recvs[from].size(), from);
+  }
+
+  comm->Barrier();
+
+  KATANA_LOG_ASSERT(comm->Broadcast(2, rank == 2));
+  KATANA_LOG_ASSERT(
+      comm->Broadcast(1, fmt::format("from {}", rank), 4) == "from");
+
+  KATANA_LOG_ASSERT(!comm->AllToAll(std::vector<std::string>(1)));
+}
+
+void
+TestExchange() {
+  auto comms = ConnectTasks();
+
+  std::vector<std::thread> tasks;
+  for (auto& comm : comms) {
+    tasks.emplace_back([&comm]() { RunTask(comm.get()); });
+  }
+  for (auto& task : tasks) {
+    task.join();
+  }
+}
+
+void
+TestFailure() {
+  auto comms = ConnectTasks();
+
+  // a task that gives up makes the others fail instead of wait for it
+  comms[0]->NotifyFailure();
+  KATANA_LOG_ASSERT(!comms[0]->AllToAll(std::vector<std::string>(kNumTasks)));
+
+  std::vector<std::thread> tasks;
+  for (uint32_t rank = 1; rank < kNumTasks; ++rank) {
+    tasks.emplace_back([&comms, rank]() {
+      KATANA_LOG_ASSERT(
+          !comms[rank]->AllToAll(std::vector<std::string>(kNumTasks)));
+    });
+  }
+  for (auto& task : tasks) {
+    task.join();
+  }
+}
+
+void
+TestSingleTask() {
+  auto comm_res = katana::SocketCommBackend::Make({"127.0.0.1:0"}, 0);
+  KATANA_LOG_VASSERT(comm_res, "{}", comm_res.error());
+  auto comm = std::move(comm_res.value());
+
+  auto recvs_res = comm->AllToAll({"self"});
+  KATANA_LOG_ASSERT(recvs_res);
+  KATANA_LOG_ASSERT(recvs_res.value() == std::vector<std::string>{"self"});
+  comm->Barrier();
+}
+
+void
+TestBadArguments() {
+  KATANA_LOG_ASSERT(!katana::SocketCommBackend::Make({"127.0.0.1:0"}, 1));
+  KATANA_LOG_ASSERT(!katana::SocketListener::Make("127.0.0.1"));
+}
+
+}  // namespace
+
+int
+main() {
+  TestExchange();
+  TestFailure();
+  TestSingleTask();
+  TestBadArguments();
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include "katana/TraceSink.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/JSONTracer.h"
+#include "katana/Logging.h"
+#include "katana/NoopTracer.h"
+
+namespace {
+
+constexpr int kThreads = 4;
+constexpr int kLinesPerThread = 1000;
+
+bool
+Contains(const std::string& line, const std::string& needle) {
+  return line.find(needle) != std::string::npos;
+}
+
+void
+TestOrder() {
+  std::vector<std::string> lines;
+  katana::TraceSink sink(
+      [&](const std::string& line) { lines.emplace_back(line); }, 64);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&sink, t] {
+      for (int i = 0; i < kLinesPerThread; ++i) {
+        while (!sink.Push([t, i] { return fmt::format("{} {}", t, i); })) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  sink.Close();
+
+  // every line is written once and the lines of a thread stay in order
+  KATANA_LOG_ASSERT(lines.size() == kThreads * kLinesPerThread);
+  std::vector<int> next(kThreads, 0);
+  for (const std::string& line : lines) {
+    size_t split = line.find(' ');
+    int t = std::stoi(line.substr(0, split));
+    int i = std::stoi(line.substr(split + 1));
+    KATANA_LOG_VASSERT(
+        next[t] == i, "thread {}: {}, expected {}", t, i, next[t]);
+    next[t] += 1;
+  }
+
+  // the writer starts again after Close
+  sink.Push([] { return std::string("after close"); });
+  sink.Close();
+  KATANA_LOG_ASSERT(lines.back() == "after close");
+}
+
+void
+TestDrops() {
+  std::vector<std::string> lines;
+  katana::TraceSink sink(
+      [&](const std::string& line) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        lines.emplace_back(line);
+      },
+      4);
+  uint64_t pushed = 0;
+  for (int i = 0; i < 100; ++i) {
+    pushed += sink.Push([] { return std::string("line"); });
+  }
+  sink.Close();
+  KATANA_LOG_ASSERT(sink.dropped() > 0);
+  KATANA_LOG_ASSERT(pushed + sink.dropped() == 100);
+  KATANA_LOG_ASSERT(lines.size() == pushed);
+}
+
+void
+TestTracer() {
+  std::vector<std::string> lines;
+  katana::ProgressTracer::Set(katana::JSONTracer::Make(
+      0, 1, [&](const std::string& line) { lines.emplace_back(line); },
+      katana::kDefaultTraceBufferLines));
+  auto& tracer = katana::GetTracer();
+  {
+    auto scope = tracer.StartActiveSpan("buffered");
+    scope.span().Log("logged", {{"value", 42}});
+  }
+  tracer.Finish();
+
+  // start, log and finish
+  KATANA_LOG_VASSERT(lines.size() == 3, "{} lines", lines.size());
+  KATANA_LOG_ASSERT(Contains(lines[0], R"("span_name":"buffered")"));
+  KATANA_LOG_ASSERT(Contains(lines[1], R"("msg":"logged")"));
+  KATANA_LOG_ASSERT(Contains(lines[1], R"({"name":"value","value":42})"));
+  KATANA_LOG_ASSERT(Contains(lines[2], R"("finished":true)"));
+
+  // lines must not reach the vector after it is gone
+  katana::ProgressTracer::Set(katana::NoopTracer::Make());
+}
+
+}  // namespace
+
+int
+main() {
+  TestOrder();
+  TestDrops();
+  TestTracer();
+  return 0;
+}
@@ -0,0 +1,177 @@
+#ifndef KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+#define KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/RDGOptionalDatastructure.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "katana/tsuba.h"
+
+namespace katana {
+
+const std::string kOptionalDatastructureEntityIndexPrimitive =
+    "kg.v1.entity_index";
+const std::string kOptionalDatastructureEntityIndexPrimitiveFilename =
+    "entity_index_manifest";
+const std::string kOptionalDatastructureEntityIndexPrimitiveIdsFilename =
+    "entity_index_ids";
+
+/// The stored form of an index over a node or edge property: the ids of the
+/// entities with a valid value, sorted by value. The values themselves are
+/// read back from the property, so loading an index costs one pass over the
+/// property instead of a sort.
+class KATANA_EXPORT EntityIndexPrimitive
+    : private katana::RDGOptionalDatastructure {
+public:
+  /// The optional datastructure name of the index over a node property
+  static std::string NodeIndexName(const std::string& property_name) {
+    return kOptionalDatastructureEntityIndexPrimitive + ".node." +
+           property_name;
+  }
+
+  /// The optional datastructure name of the index over an edge property
+  static std::string EdgeIndexName(const std::string& property_name) {
+    return kOptionalDatastructureEntityIndexPrimitive + ".edge." +
+           property_name;
+  }
+
+  static katana::Result<EntityIndexPrimitive> Load(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    EntityIndexPrimitive index =
+        KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+
+    auto ids_path = index.paths_.find(kIdsKey);
+    if (ids_path == index.paths_.end()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "entity index {} has no ids file", path);
+    }
+    if (index.num_ids_ == 0) {
+      return index;
+    }
+    katana::URI uri = rdg_dir_path.Join(ids_path->second);
+    index.ids_file_ = std::make_shared<katana::FileView>();
+    if (uri.scheme() == katana::URI::kFileScheme) {
+      KATANA_CHECKED(index.ids_file_->BindMapped(uri.path()));
+    } else {
+      KATANA_CHECKED(index.ids_file_->Bind(uri.string(), true));
+    }
+    if (index.ids_file_->size() != index.num_ids_ * sizeof(uint64_t)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "entity index {} should hold {} ids but its file has {} bytes", path,
+          index.num_ids_, index.ids_file_->size());
+    }
+    return index;
+  }
+
+  katana::Result<std::string> Write(katana::URI rdg_dir_path) {
+    katana::URI ids_path = rdg_dir_path.RandFile(
+        kOptionalDatastructureEntityIndexPrimitiveIdsFilename);
+    KATANA_CHECKED(WriteIds(ids_path.string()));
+    paths_[kIdsKey] = ids_path.BaseName();
+
+    // Write out our json manifest
+    katana::URI manifest_path = rdg_dir_path.RandFile(
+        kOptionalDatastructureEntityIndexPrimitiveFilename);
+    KATANA_CHECKED(WriteManifest(manifest_path.string()));
+    return manifest_path.BaseName();
+  }
+
+  /// The Arrow type of the indexed property, to detect a property that was
+  /// replaced with one of another type
+  const std::string& property_type() const { return property_type_; }
+  void set_property_type(std::string type) { property_type_ = std::move(type); }
+
+  /// The number of nodes or edges of the graph the index was built for
+  uint64_t num_entities() const { return num_entities_; }
+  void set_num_entities(uint64_t num) { num_entities_ = num; }
+
+  uint64_t num_ids() const { return num_ids_; }
+
+  /// The sorted ids, either loaded from storage or set with set_ids
+  const uint64_t* ids() const {
+    return ids_file_ ? ids_file_->ptr<uint64_t>() : ids_.data();
+  }
+  void set_ids(std::vector<uint64_t> ids) {
+    ids_ = std::move(ids);
+    num_ids_ = ids_.size();
+    ids_file_.reset();
+  }
+
+  friend void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+  friend void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
+private:
+  static constexpr const char* kIdsKey = "ids";
+
+  std::string property_type_;
+  uint64_t num_entities_{0};
+  uint64_t num_ids_{0};
+
+  /// data structures dumped to their own files
+
+  std::vector<uint64_t> ids_;
+  std::shared_ptr<katana::FileView> ids_file_;
+
+  static katana::Result<EntityIndexPrimitive> LoadJson(
+      const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(path, true));
+
+    if (fv.size() == 0) {
+      return EntityIndexPrimitive();
+    }
+
+    EntityIndexPrimitive index;
+    KATANA_CHECKED(katana::JsonParse<EntityIndexPrimitive>(fv, &index));
+
+    return index;
+  }
+
+  katana::Result<void> WriteIds(const std::string& path) const {
+    size_t size = num_ids_ * sizeof(uint64_t);
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(std::max<size_t>(size, 1)));
+    if (auto res = ff->Write(ids(), size); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path);
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> WriteManifest(const std::string& path) const {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(serialized.size()));
+    if (auto res = ff->Write(serialized.data(), serialized.size()); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path);
+    // persist now
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::ResultSuccess();
+  }
+};
+
+}  // namespace katana
+
+#endif
@@ -11,9 +11,9 @@
 #include <arrow/array/array_primitive.h>
 #include <arrow/table.h>
 
-#include "katana/DynamicBitsetSlow.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/SmallDynamicBitset.h"
 
 namespace katana {
 
@@ -48,9 +48,13 @@ static constexpr size_t kDefaultSetOfEntityTypeIDsSize = 256;
 /// The maximum size of the dynamically sized SetOfEntityTypeIDs
 static constexpr size_t kMaxSetOfEntityTypeIDsSize = kInvalidEntityType + 1;
 
-/// A dynamically sized set of EntityTypeIDs
-using SetOfEntityTypeIDs = DynamicBitsetSlow;
-//TODO(emcginnis): use DynamicBitset when it is available to libsupport
+/// A dynamically sized set of EntityTypeIDs. Sets of up to
+/// kDefaultSetOfEntityTypeIDsSize ids are stored inline, so type checks do
+/// not touch the heap.
+using SetOfEntityTypeIDs = SmallDynamicBitset;
+static_assert(
+    kDefaultSetOfEntityTypeIDsSize <= SetOfEntityTypeIDs::kInlineBits,
+    "sets of the default size should be stored inline");
 /// A map from EntityTypeID to a set of EntityTypeIDs
 using EntityTypeIDToSetOfEntityTypeIDsMap = std::vector<SetOfEntityTypeIDs>;
 /// A map from the atomic type name to its EntityTypeID
@@ -110,10 +114,8 @@ public:
     }
 
     for (size_t i = 0, ni = num_entity_types; i < ni; ++i) {
-      for (size_t j = 0, nj = num_entity_types; j < nj; ++j) {
-        if (entity_type_id_to_atomic_entity_type_ids_.at(i).test(j)) {
-          atomic_entity_type_id_to_entity_type_ids_.at(j).set(i);
-        }
+      for (auto j : entity_type_id_to_atomic_entity_type_ids_.at(i)) {
+        atomic_entity_type_id_to_entity_type_ids_.at(j).set(i);
       }
     }
 
@@ -268,9 +270,9 @@ public:
   /// This function can be used to convert "old style" graphs (storage format 1,
   /// where types are represented by uint8 properties) and "new style"
   /// graphs (version > 2, where types are represented in our native type
-  /// represenation). This function is serial but it likely iterates over
-  /// O(nodes) and O(edges) vectors, so it is very slow. It should only be used
-  /// for updating old graphs.
+  /// represenation). The rows are converted in parallel, but this still reads
+  /// every uint8 property of every node or edge, so it should only be used for
+  /// updating old graphs.
   ///
   /// The length of entity_type_ids should be equal to topo_size.
   /// properties->num_rows() should be equal to the length of entity_type_ids or
@@ -312,39 +314,8 @@ public:
           num_rows, entity_type_ids->size());
     }
 
-    // We cannot use KATANA_CHECKED here because nvcc cannot handle it.
-    auto res =
-        DoAssignEntityTypeIDsFromProperties(properties, entity_type_manager);
-    if (!res) {
-      return katana::Result<std::vector<std::string>>(std::move(res.error()));
-    }
-    TypeProperties type_properties = std::move(res.value());
-
-    // assign the type ID for each row
-    for (int64_t row = 0; row < num_rows; ++row) {
-      TypeProperties::FieldEntity field_indices;
-      for (auto& uint8_property : type_properties.uint8_properties) {
-        if (uint8_property.array->IsValid(row) &&
-            uint8_property.array->Value(row)) {
-          field_indices.emplace_back(uint8_property.field_index);
-        }
-      }
-      if (field_indices.empty()) {
-        entity_type_ids->at(row) = katana::kUnknownEntityType;
-      } else {
-        katana::EntityTypeID entity_type_id =
-            type_properties.type_field_indices_to_id.at(field_indices);
-        entity_type_ids->at(row) = entity_type_id;
-      }
-    }
-
-    std::vector<std::string> properties_used;
-    for (const auto& prop_col : type_properties.uint8_properties) {
-      properties_used.emplace_back(
-          properties->field(prop_col.field_index)->name());
-    }
-
-    return properties_used;
+    return DoAssignEntityTypeIDsFromProperties(
+        properties, entity_type_manager, entity_type_ids->data());
   }
 
   /// adds a new entity type for the atomic type with name \p name
@@ -573,13 +544,10 @@ public:
   /// sub-type of the type \p super_type
   /// (assumes that the sub_type and super_type EntityTypeIDs exists)
   bool IsSubtypeOf(EntityTypeID sub_type, EntityTypeID super_type) const {
+    // true if the atomic types of sub_type are a subset of the atomic types
+    // of super_type
     const auto& super_atomic_types = GetAtomicSubtypes(super_type);
-    const auto& sub_atomic_types = GetAtomicSubtypes(sub_type);
-    // return true if sub_atomic_types is a subset of super_atomic_types
-    SetOfEntityTypeIDs res;
-    res.resize(SetOfEntityTypeIDsSize_);
-    res.bitwise_and(sub_atomic_types, super_atomic_types);
-    return (res == sub_atomic_types);
+    return GetAtomicSubtypes(sub_type).IsSubsetOf(super_atomic_types);
   }
 
   const EntityTypeIDToSetOfEntityTypeIDsMap&
@@ -640,23 +608,6 @@ private:
     return ResultSuccess();
   }
 
-  // Used by AssignEntityTypeIDsFromProperties()
-  template <typename ArrowType>
-  struct PropertyColumn {
-    int field_index;
-    std::shared_ptr<ArrowType> array;
-
-    PropertyColumn(int i, std::shared_ptr<ArrowType>& a)
-        : field_index(i), array(a) {}
-  };
-
-  // Used by AssignEntityTypeIDsFromProperties()
-  struct TypeProperties {
-    std::vector<PropertyColumn<arrow::UInt8Array>> uint8_properties;
-    using FieldEntity = std::vector<int>;
-    std::map<FieldEntity, katana::EntityTypeID> type_field_indices_to_id;
-  };
-
   /// Get the intersection of the types passed in.
   ///
   /// this function is required to be deterministic because it adds new entity
@@ -670,9 +621,14 @@ private:
   Result<EntityTypeID> AddNonAtomicEntityType(
       const SetOfEntityTypeIDs& type_id_set);
 
-  static Result<TypeProperties> DoAssignEntityTypeIDsFromProperties(
+  /// Adds the types of the uint8 properties to \p entity_type_manager and
+  /// writes the EntityTypeID of every row of \p properties to
+  /// \p entity_type_ids. The rows are scanned in parallel.
+  ///
+  /// \returns the names of the properties used for types
+  static Result<std::vector<std::string>> DoAssignEntityTypeIDsFromProperties(
       const std::shared_ptr<arrow::Table>& properties,
-      EntityTypeManager* entity_type_manager);
+      EntityTypeManager* entity_type_manager, EntityTypeID* entity_type_ids);
 
   void Init() {
     // assume kUnknownEntityType is 0
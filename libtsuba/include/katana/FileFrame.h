@@ -63,6 +63,19 @@ public:
 
   katana::Result<void> Init(uint64_t reserve_size);
   katana::Result<void> Init() { return Init(1); }
+
+  /// Map exactly size bytes, whose final size is known up front, and set the
+  /// cursor to the end. The mapping is not grown again, so threads can fill
+  /// disjoint regions of it with WriteAt or through ptr(). Pages are not
+  /// populated here; each is faulted in by the thread that first writes it.
+  /// Bytes that are not written are zero.
+  katana::Result<void> InitForParallelFill(uint64_t size);
+
+  /// Copy nbytes of data to offset. Unlike Write, it does not grow the buffer
+  /// or move the cursor, so it may be called concurrently for disjoint
+  /// regions.
+  katana::Result<void> WriteAt(
+      uint64_t offset, const void* data, uint64_t nbytes);
   void Bind(std::string_view filename);
 
   katana::Result<void> Destroy();
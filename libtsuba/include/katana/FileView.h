@@ -5,6 +5,7 @@
 #include <future>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <parquet/arrow/reader.h>
 
@@ -16,6 +17,18 @@ namespace katana {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
 public:
+  /// How a range of the file is going to be read; see Advise
+  enum class AccessPattern {
+    /// Read ahead as sequential runs of reads are detected
+    kNormal,
+    /// Read front to back; read ahead as far as possible from the start
+    kSequential,
+    /// Read in no particular order; do not read ahead
+    kRandom,
+    /// Read soon; start fetching the whole range now
+    kWillNeed,
+  };
+
   FileView() = default;
   FileView(const FileView&) = delete;
   FileView& operator=(const FileView&) = delete;
@@ -28,8 +41,12 @@ public:
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         bound_(other.bound_),
+        file_backed_(other.file_backed_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        fetches_(std::move(other.fetches_)),
+        last_read_end_(other.last_read_end_),
+        read_ahead_(other.read_ahead_),
+        advice_(std::move(other.advice_)) {
     other.bound_ = false;
   }
 
@@ -45,9 +62,13 @@ public:
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       bound_ = other.bound_;
+      file_backed_ = other.file_backed_;
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      last_read_end_ = other.last_read_end_;
+      read_ahead_ = other.read_ahead_;
+      advice_ = std::move(other.advice_);
       other.bound_ = false;
     }
     return *this;
@@ -75,10 +96,33 @@ public:
     return Bind(filename, 0, std::numeric_limits<uint64_t>::max(), resolve);
   }
 
+  /// Map a local file directly instead of reading it into anonymous memory.
+  /// The whole file is immediately accessible through ptr() and its pages are
+  /// shared with the page cache (and so with other processes mapping the same
+  /// file) until they are written to; writes are private to this view and
+  /// never reach the file.
+  ///
+  /// \param filename path to a file on a local file system
+  katana::Result<void> BindMapped(std::string_view filename);
+
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Wait for every read started by a Fill with resolve=false. Issuing
+  /// several such Fills and then waiting lets their reads run concurrently
+  katana::Result<void> WaitForFills();
+
+  /// Declare how [begin, end) is going to be read, e.g., before sweeping
+  /// over a topology array. Read uses it to decide how far to read ahead;
+  /// views bound with BindMapped pass it on to the kernel. Later advice for
+  /// a range replaces earlier advice.
+  katana::Result<void> Advise(
+      uint64_t begin, uint64_t end, AccessPattern pattern);
+
   bool Valid() const { return bound_; }
 
+  /// True if this view was bound with BindMapped
+  bool file_backed() const { return file_backed_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -129,6 +173,9 @@ public:
   ///// End arrow::io::RandomAccessFile methods ///////
 
 private:
+  // The furthest a read reads ahead of itself
+  static constexpr int64_t kMaxReadAhead = int64_t{1} << 26;
+
   // Given the size of some region, how many pages does it take up?
   uint64_t page_number(uint64_t size);
 
@@ -156,12 +203,21 @@ private:
   // @start and @size give the location and range of the previous read
   katana::Result<void> PreFetch(int64_t start, int64_t size);
 
+  // The pattern of the most recent advice that covers offset
+  AccessPattern AdvisedPattern(uint64_t offset) const;
+
   struct FillingRange {
     uint64_t first_page;
     uint64_t last_page;
     std::future<katana::CopyableResult<void>> work;
   };
 
+  struct AdvisedRange {
+    uint64_t begin;
+    uint64_t end;
+    AccessPattern pattern;
+  };
+
   uint8_t* map_start_{nullptr};
   int64_t file_size_{0};
   uint8_t page_shift_{0};
@@ -169,8 +225,14 @@ private:
   int64_t mem_start_{0};
   std::string filename_;
   bool bound_{false};
+  bool file_backed_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  // Where the previous read ended and how far the reads of the current
+  // sequential run read ahead
+  int64_t last_read_end_{-1};
+  int64_t read_ahead_{0};
+  std::vector<AdvisedRange> advice_;
 };
 }  // namespace katana
 
@@ -39,19 +39,33 @@ public:
       ReadOpts opts = ReadOpts::Defaults());
 
   /// read table from storage
+  ///
+  /// Row groups are fetched and decoded concurrently; with a slice, only the
+  /// row groups that overlap it are fetched.
   ///   \param uri an identifier for a parquet file
   katana::Result<std::shared_ptr<arrow::Table>> ReadTable(
       const katana::URI& uri, std::optional<Slice> slice = std::nullopt);
 
   /// read part of a table from storage
   ///   \param uri an identifier for a parquet file
-  ///   \param column_bitmap must have the same length as the number of columns
-  ///      in the table in the parquet file. The loaded table will only contain
-  ///      columns at indexes that are true in the bitmap
+  ///   \param column_bitmap indexes of columns in the table in the parquet
+  ///      file. The loaded table will contain these columns in this order.
+  ///      Only the bytes of these columns in the row groups that overlap
+  ///      slice are fetched
   katana::Result<std::shared_ptr<arrow::Table>> ReadTable(
       const katana::URI& uri, const std::vector<int32_t>& column_bitmap,
       std::optional<Slice> slice = std::nullopt);
 
+  /// read several ranges of rows of a table from storage as one table
+  ///
+  /// Only the row groups that overlap a range are fetched, so reading the
+  /// row groups whose statistics match a predicate skips the others.
+  ///   \param uri an identifier for a parquet file
+  ///   \param slices the ranges of rows, in order and disjoint; the loaded
+  ///      table holds their rows one after the other
+  katana::Result<std::shared_ptr<arrow::Table>> ReadTableRanges(
+      const katana::URI& uri, const std::vector<Slice>& slices);
+
   /// read only the schema from a parquet file in storage
   katana::Result<std::shared_ptr<arrow::Schema>> GetSchema(
       const katana::URI& uri);
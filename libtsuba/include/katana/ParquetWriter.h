@@ -2,11 +2,14 @@
 #define KATANA_LIBTSUBA_KATANA_PARQUETWRITER_H_
 
 #include <limits>
+#include <optional>
 #include <vector>
 
 #include <arrow/api.h>
+#include <arrow/util/compression.h>
 #include <parquet/properties.h>
 
+#include "katana/PropertyStatistics.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/WriteGroup.h"
@@ -31,6 +34,31 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// upper bound on the number of rows in a row group. Readers fetch and
+    /// decode row groups independently, so smaller row groups let a read of
+    /// part of a table skip more of the file and spread decoding over more
+    /// threads
+    int64_t rows_per_row_group{int64_t{1} << 20};
+
+    /// if true, the encoding of every top level column is chosen from its
+    /// type and a sample of its values: dictionary encoding for columns with
+    /// few distinct values, BYTE_STREAM_SPLIT for other floating point
+    /// columns when they are compressed, DELTA_BINARY_PACKED for sorted
+    /// integer columns where the Parquet library can write it, and PLAIN
+    /// without a dictionary otherwise. The encodings are recorded in the
+    /// metadata of every column chunk, from which readers decode them. If
+    /// false, every column is dictionary encoded until its dictionary grows
+    /// too large.
+    bool adaptive_encoding{true};
+
+    /// the codec of column data, e.g., ZSTD for the smallest files or LZ4
+    /// for the fastest decoding
+    arrow::Compression::type compression{arrow::Compression::UNCOMPRESSED};
+
+    /// the level of the codec, if not its default
+    std::optional<int> compression_level{std::nullopt};
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -57,12 +85,18 @@ public:
   katana::Result<void> WriteToUri(
       const katana::URI& uri, WriteGroup* group = nullptr);
 
+  /// \returns the statistics of the row groups that WriteToUri writes for
+  /// the column of a single column table, in order, or none if the column
+  /// has no statistics (see HasRowGroupStatistics)
+  std::vector<RowGroupStatistics> Statistics() const;
+
 private:
   ParquetWriter(
       std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts)
       : tables_(std::move(tables)), opts_(opts) {}
 
-  std::shared_ptr<parquet::WriterProperties> StandardWriterProperties();
+  std::shared_ptr<parquet::WriterProperties> StandardWriterProperties(
+      const arrow::Table& table);
 
   std::shared_ptr<parquet::ArrowWriterProperties> StandardArrowProperties();
 
@@ -0,0 +1,84 @@
+#ifndef KATANA_LIBTSUBA_KATANA_PROPERTYSTATISTICS_H_
+#define KATANA_LIBTSUBA_KATANA_PROPERTYSTATISTICS_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// A range predicate on a numeric property: the values v with
+/// lower <= v <= upper, where a missing bound does not constrain v. Nulls
+/// never satisfy it.
+struct KATANA_EXPORT PropertyPredicate {
+  std::string property_name;
+  std::optional<double> lower;
+  std::optional<double> upper;
+
+  static PropertyPredicate Between(
+      std::string property_name, double lower, double upper) {
+    return {std::move(property_name), lower, upper};
+  }
+
+  static PropertyPredicate AtLeast(std::string property_name, double lower) {
+    return {std::move(property_name), lower, std::nullopt};
+  }
+
+  static PropertyPredicate AtMost(std::string property_name, double upper) {
+    return {std::move(property_name), std::nullopt, upper};
+  }
+
+  static PropertyPredicate Equal(std::string property_name, double value) {
+    return {std::move(property_name), value, value};
+  }
+};
+
+/// Statistics of a range of rows of a numeric property, one row group of
+/// its Parquet file, recorded when the property is written so that readers
+/// can skip row groups without opening the file.
+struct KATANA_EXPORT RowGroupStatistics {
+  /// The first row of the row group in the property
+  int64_t offset{0};
+  int64_t num_rows{0};
+  int64_t null_count{0};
+  /// Bounds of the valid values as doubles, rounded outwards where a value
+  /// is not exactly a double; infinite if unknown
+  double min{-std::numeric_limits<double>::infinity()};
+  double max{std::numeric_limits<double>::infinity()};
+  /// Estimate of the number of distinct valid values, with a relative error
+  /// of about 7%
+  int64_t distinct_count{0};
+
+  /// \returns false if no row of the row group satisfies \p predicate
+  bool MayContain(const PropertyPredicate& predicate) const {
+    if (null_count == num_rows) {
+      return false;
+    }
+    if (predicate.lower && max < *predicate.lower) {
+      return false;
+    }
+    if (predicate.upper && min > *predicate.upper) {
+      return false;
+    }
+    return true;
+  }
+};
+
+/// \returns true if statistics are recorded for columns of \p type: integers
+/// and floating point numbers
+KATANA_EXPORT bool HasRowGroupStatistics(const arrow::DataType& type);
+
+/// Compute the statistics of rows [offset, offset + length) of \p array,
+/// whose type must have statistics
+KATANA_EXPORT RowGroupStatistics ComputeRowGroupStatistics(
+    const arrow::ChunkedArray& array, int64_t offset, int64_t length);
+
+}  // namespace katana
+
+#endif
@@ -2,8 +2,10 @@
 #define KATANA_LIBTSUBA_KATANA_RDG_H_
 
 #include <cstdint>
+#include <future>
 #include <memory>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
@@ -12,17 +14,21 @@
 #include <nlohmann/json.hpp>
 
 #include "katana/Cache.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileFrame.h"
 #include "katana/FileView.h"
 #include "katana/NUMAArray.h"
 #include "katana/PartitionMetadata.h"
+#include "katana/PropertyStatistics.h"
 #include "katana/RDGLineage.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
 #include "katana/RDKLSHIndexPrimitive.h"
 #include "katana/RDKSubstructureIndexPrimitive.h"
+#include "katana/ReachabilityIndexPrimitive.h"
+#include "katana/RawColumn.h"
 #include "katana/ReadGroup.h"
 #include "katana/Result.h"
 #include "katana/TxnContext.h"
@@ -48,12 +54,32 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   std::optional<std::vector<std::string>> edge_properties{std::nullopt};
+  /// If true and the RDG is on a local file system, topology files and
+  /// uncompressed raw property columns (see RawColumnFormat) are memory mapped
+  /// rather than read into private memory. Mapped data is not copied when it
+  /// is loaded and its pages are shared with other processes mapping the same
+  /// files.
+  bool mmap_local_files{false};
+  /// If true, the topology is not loaded until it is first used, so that
+  /// workloads that only read properties never read the topology files. Only
+  /// the numbers of nodes and edges recorded in the metadata are loaded
+  /// up front.
+  bool defer_topology{false};
+  /// If true and the RDG is on a local file system, the topology file is
+  /// memory mapped even without mmap_local_files and only the node array of
+  /// the topology is read into memory. Edge destinations are paged in from
+  /// the file as they are used, so graphs whose edges do not fit in memory
+  /// can still be processed; see SemiExternalDoAll.
+  bool semi_external_topology{false};
 
   /// Build a default options struct the default behavior is:
   ///  * load the partition associated with this host
   ///  * load all node properties
   ///  * load all edge properties
   ///  * do not use a property cache
+  ///  * read topology files into private memory
+  ///  * load the topology right away
+  ///  * load all of the topology into memory
   static RDGLoadOptions Defaults() { return RDGLoadOptions{}; }
 };
 
@@ -107,6 +133,25 @@ public:
       const katana::EntityTypeManager& edge_entity_type_manager,
       katana::TxnContext* txn_ctx);
 
+  /// @brief Like Store, but only starts writing the data files and returns.
+  /// Encoding and uploading continue in the background; the returned future
+  /// is ready when they are done. The manifest of the new version is handed
+  /// to txn_ctx as by Store, and txn_ctx->Commit() waits for the writes before
+  /// it writes the manifest. The in-memory state of the RDG is updated before
+  /// this returns, so the RDG may be changed and stored again right away.
+  /// Stored properties are immutable arrow columns that the writes keep alive;
+  /// when handle is at another location than the RDG, file backed arrays that
+  /// did not change are copied from their mappings, which must stay bound
+  /// until the future is ready.
+  katana::Result<std::shared_future<katana::CopyableResult<void>>> StoreAsync(
+      RDGHandle handle, const std::string& command_line,
+      RDGVersioningPolicy versioning_action,
+      std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
+      std::unique_ptr<FileFrame> edge_entity_type_id_array_ff,
+      const katana::EntityTypeManager& node_entity_type_manager,
+      const katana::EntityTypeManager& edge_entity_type_manager,
+      katana::TxnContext* txn_ctx);
+
   /// @brief Store new version of the RDG with lineage based on command line.
   /// @param handle :: handle indicating where to store RDG
   /// @param command_line :: added to metadata to track lineage of RDG
@@ -181,6 +226,21 @@ public:
   katana::Result<URI> GetNodePropertyStorageLocation(
       const std::string& name) const;
 
+  /// \returns the statistics of the row groups of the stored node property
+  /// \p name, recorded when it was written. There are none if the property
+  /// is not numeric, was written before statistics were recorded, or was
+  /// modified since it was last written.
+  katana::Result<std::vector<RowGroupStatistics>> GetNodePropertyStatistics(
+      const std::string& name) const;
+
+  /// Read the rows in \p ranges of the stored node property \p name without
+  /// loading it; the property may not have been modified since it was last
+  /// written. The ranges must be in order and disjoint, and the table holds
+  /// their rows one after the other.
+  katana::Result<std::shared_ptr<arrow::Table>> ReadNodePropertyRanges(
+      const std::string& name,
+      const std::vector<ParquetReader::Slice>& ranges) const;
+
   /// Ensure the edge property at index `i` was written back to storage
   /// then free its memory
   katana::Result<void> UnloadEdgeProperty(int i);
@@ -202,6 +262,17 @@ public:
   /// cannot be loaded more than once
   katana::Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
+  /// Start reading the named node properties from storage without waiting
+  /// for them. The reads are tracked by \p grp and each property is appended
+  /// to the property table, in order, when \p grp is finished. Properties
+  /// that are already loaded are skipped. This RDG must outlive \p grp.
+  katana::Result<void> PrefetchNodeProperties(
+      const std::vector<std::string>& names, ReadGroup* grp);
+
+  /// Edge property version of PrefetchNodeProperties
+  katana::Result<void> PrefetchEdgeProperties(
+      const std::vector<std::string>& names, ReadGroup* grp);
+
   std::vector<std::string> ListFullNodeProperties() const;
   std::vector<std::string> ListLoadedNodeProperties() const;
   std::vector<std::string> ListFullEdgeProperties() const;
@@ -233,6 +304,16 @@ public:
   /// If it does, the RDG returns the topology
   katana::Result<katana::RDGTopology*> GetTopology(const RDGTopology& shadow);
 
+  /// Like GetTopology but does not load the topology, only its metadata,
+  /// e.g., num_nodes() and num_edges(), is available
+  katana::Result<katana::RDGTopology*> FindTopology(const RDGTopology& shadow);
+
+  /// Whether this RDG was loaded with RDGLoadOptions::defer_topology
+  bool defer_topology() const;
+
+  /// Whether this RDG was loaded with RDGLoadOptions::semi_external_topology
+  bool semi_external_topology() const;
+
   katana::Result<void> UnbindNodeEntityTypeIDArrayFileStorage();
 
   /// Inform this RDG that its Node Entity Type ID Array is in storage at this
@@ -266,6 +347,10 @@ public:
   /// The edge properties
   const std::shared_ptr<arrow::Table>& edge_properties() const;
 
+  /// Serializes replacing the property tables with reading them. The RDG
+  /// itself does not take it; its owners and the PropertyUnloadManager do.
+  std::shared_mutex& property_mutex() const { return *property_mutex_; }
+
   /// Remove all node properties
   void DropNodeProperties();
 
@@ -319,6 +404,20 @@ public:
 
   void set_view_name(const std::string& v) { view_type_ = v; }
 
+  /// When this RDG is stored, also write the fixed-width properties that are
+  /// written out as raw columns in \p format; loaders prefer a property's raw
+  /// column over its Parquet file
+  void set_raw_column_format(RawColumnFormat format) {
+    raw_column_format_ = format;
+  }
+
+  /// Bound the bytes of encoded property and topology files that storing
+  /// this RDG holds in memory at once; encoding waits for earlier files to
+  /// be written out when it would exceed \p size
+  void set_max_outstanding_write_size(uint64_t size) {
+    max_outstanding_write_size_ = size;
+  }
+
   // Returns katana::ResultErrno if the RDKLSHIndexPrimitive is not found on disk
   katana::Result<std::optional<katana::RDKLSHIndexPrimitive>>
   LoadRDKLSHIndexPrimitive();
@@ -333,8 +432,39 @@ public:
   katana::Result<void> WriteRDKSubstructureIndexPrimitive(
       katana::RDKSubstructureIndexPrimitive& index);
 
+  /// Returns std::nullopt if no reachability index was written
+  katana::Result<std::optional<katana::ReachabilityIndexPrimitive>>
+  LoadReachabilityIndexPrimitive();
+
+  /// Write \p index now, replacing any reachability index written before
+  katana::Result<void> WriteReachabilityIndexPrimitive(
+      katana::ReachabilityIndexPrimitive& index);
+
+  /// Returns std::nullopt if no index was stored under \p name, see
+  /// EntityIndexPrimitive::NodeIndexName and EdgeIndexName
+  katana::Result<std::optional<katana::EntityIndexPrimitive>>
+  LoadEntityIndexPrimitive(const std::string& name);
+
+  /// Write \p index under \p name the next time this RDG is stored,
+  /// replacing any index stored under that name before
+  void UpsertEntityIndexPrimitive(
+      const std::string& name, katana::EntityIndexPrimitive&& index);
+
+  /// Stop recording the index stored under \p name, if any
+  void RemoveEntityIndexPrimitive(const std::string& name);
+
+  /// True if an index is stored or waiting to be stored under \p name
+  bool HasEntityIndexPrimitive(const std::string& name) const;
+
 private:
+  katana::Result<void> DoStoreEntityIndexPrimitives(
+      const katana::URI& rdg_dir);
+
   std::string view_type_;
+  RawColumnFormat raw_column_format_{RawColumnFormat::kNone};
+  uint64_t max_outstanding_write_size_{WriteGroup::kMaxOutstandingSize};
+  std::unordered_map<std::string, katana::EntityIndexPrimitive>
+      pending_entity_indexes_;
   RDG(std::unique_ptr<RDGCore>&& core);
 
   void InitEmptyTables();
@@ -350,10 +480,23 @@ private:
   katana::Result<std::vector<katana::PropStorageInfo>> WritePartArrays(
       const katana::URI& dir, katana::WriteGroup* desc);
 
+  /// If \p pending is not null, the writes finish in the background and
+  /// *pending is ready when they are done; see StoreAsync
   katana::Result<void> DoStore(
       RDGHandle handle, const std::string& command_line,
       RDGVersioningPolicy versioning_action,
-      std::unique_ptr<WriteGroup> write_group, katana::TxnContext* txn_ctx);
+      std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
+      std::unique_ptr<FileFrame> edge_entity_type_id_array_ff,
+      const katana::EntityTypeManager& node_entity_type_manager,
+      const katana::EntityTypeManager& edge_entity_type_manager,
+      katana::TxnContext* txn_ctx,
+      std::shared_future<katana::CopyableResult<void>>* pending);
+
+  katana::Result<void> DoStoreProperties(
+      RDGHandle handle, const std::string& command_line,
+      RDGVersioningPolicy versioning_action,
+      std::unique_ptr<WriteGroup> write_group, katana::TxnContext* txn_ctx,
+      std::shared_future<katana::CopyableResult<void>>* pending);
 
   katana::Result<void> DoStoreNodeEntityTypeIDArray(
       RDGHandle handle, std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
@@ -368,6 +511,10 @@ private:
   //
 
   std::unique_ptr<RDGCore> core_;
+
+  /// Boxed to keep the RDG movable
+  std::unique_ptr<std::shared_mutex> property_mutex_{
+      std::make_unique<std::shared_mutex>()};
 };
 
 }  // namespace katana
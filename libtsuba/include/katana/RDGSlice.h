@@ -39,9 +39,15 @@ public:
   RDGSlice(RDGSlice&& other) noexcept;
   RDGSlice& operator=(RDGSlice&& other) noexcept;
 
+  /// Only the parts of the CSR topology file that hold the adjacency indices
+  /// of node_range and the destinations of edge_range are read, along with
+  /// the matching rows of properties and type ids. edge_range should be the
+  /// edges of node_range.
   struct SliceArg {
     std::pair<uint64_t, uint64_t> node_range;
     std::pair<uint64_t, uint64_t> edge_range;
+    /// Any other byte range of the topology file to read; may be empty. For
+    /// topologies that are not plain CSR, this is the only range read.
     uint64_t topo_off;
     uint64_t topo_size;
   };
@@ -65,6 +71,17 @@ public:
   static katana::Result<std::pair<std::vector<size_t>, std::vector<size_t>>>
   GetPerPartitionCounts(RDGHandle handle);
 
+  /// Split a partition into \p num_slices contiguous slices that each carry
+  /// about the same weight, where a slice weighs node_weight per node plus
+  /// edge_weight per edge. Splitting by node count alone leaves the hosts
+  /// that get the high degree nodes of a power-law graph with most of the
+  /// edges. Only the adjacency indices of the topology are read.
+  ///
+  /// \returns one SliceArg per slice, in node order, to pass to Make
+  static katana::Result<std::vector<SliceArg>> PlanSlices(
+      RDGHandle handle, uint32_t num_slices, uint32_t partition_id = 0,
+      uint64_t node_weight = 1, uint64_t edge_weight = 1);
+
   // metadata sorts of things
   const katana::URI& rdg_dir() const;
   uint32_t partition_id() const;
@@ -14,6 +14,9 @@ static const uint32_t kPartitionStorageFormatVersion3 = 3;
 static const uint32_t kPartitionStorageFormatVersion4 = 4;
 static const uint32_t kPartitionStorageFormatVersion5 = 5;
 static const uint32_t kPartitionStorageFormatVersion6 = 6;
+/// binary RDGPartHeaders; until this is the latest version they are only
+/// stored with the unstable_storage_format flag
+static const uint32_t kPartitionStorageFormatVersion7 = 7;
 
 /// kLatestPartitionStorageFormatVersion to be bumped any time
 /// the on disk format of RDGPartHeader changes
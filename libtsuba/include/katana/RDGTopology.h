@@ -2,6 +2,7 @@
 #define KATANA_LIBTSUBA_KATANA_RDGTOPOLOGY_H_
 
 #include <array>
+#include <memory>
 
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
@@ -24,6 +25,14 @@ public:
   RDGTopology();
   RDGTopology(PartitionTopologyMetadataEntry* metadata_entry);
 
+  /// Type of edge destinations (node indexes) in memory, 64 bits only if
+  /// built with KATANA_USE_64BIT_NODE_IDS
+#if defined(KATANA_USE_64BIT_NODE_IDS)
+  using Node = uint64_t;
+#else
+  using Node = uint32_t;
+#endif
+
   //
   // Enums
   // *** Important ***
@@ -44,7 +53,11 @@ public:
     kInvalid = -1,
     kAny = 0,
     kSortedByDegree,
-    kSortedByNodeType
+    kSortedByNodeType,
+    // breadth-first order, starting from the lowest unvisited node id
+    kSortedByBFS,
+    // reverse Cuthill-McKee order
+    kSortedByRCM
   };
 
   enum class TopologyKind : int {
@@ -52,7 +65,8 @@ public:
     kCSR = 0,
     kEdgeShuffleTopology,
     kShuffleTopology,
-    kEdgeTypeAwareTopology
+    kEdgeTypeAwareTopology,
+    kCompressedTopology
   };
 
   //
@@ -70,14 +84,24 @@ public:
     file_storage_ = std::move(file_storage);
   }
 
+  /// Keep \p storage alive as long as this RDGTopology, for in memory
+  /// structures made only to be stored, e.g., a widened copy of a compacted
+  /// property index map
+  void set_in_memory_storage(std::shared_ptr<const void> storage) {
+    in_memory_storage_ = std::move(storage);
+  }
+
   /// Invalidate the in memory RDGTopology structures
   void unmap_file_storage() {
     adj_indices_ = nullptr;
     dests_ = nullptr;
+    converted_dests_.reset();
     edge_index_to_property_index_map_ = nullptr;
     node_index_to_property_index_map_ = nullptr;
     edge_condensed_type_id_map_ = nullptr;
     node_condensed_type_id_map_ = nullptr;
+    compressed_block_offsets_ = nullptr;
+    compressed_dests_ = nullptr;
     file_store_mapped_ = false;
   }
 
@@ -112,13 +136,17 @@ public:
   }
 
   /// Requires backing FileView to be mapped & bound, or the RDGTopology to be filled from memory
-  const uint32_t* dests() const {
+  const Node* dests() const {
     KATANA_LOG_VASSERT(
         dests_ != nullptr,
         "RDGTopology must be either bound & mapped, or filled from memory");
     return dests_;
   }
 
+  /// Whether dests() were converted from the width of the topology file into
+  /// memory owned by this RDGTopology, rather than pointing into the mapping
+  bool dests_converted() const { return converted_dests_ != nullptr; }
+
   /// Optional field, may not be present depending on the kind of topology this is
   /// Requires backing FileView to be mapped & bound, or the RDGTopology to be filled from memory
   const uint64_t* node_index_to_property_index_map() const {
@@ -165,6 +193,30 @@ public:
     return node_condensed_type_id_map_;
   }
 
+  /// Only present for kCompressedTopology
+  /// Requires backing FileView to be mapped & bound, or the RDGTopology to be filled from memory
+  const uint64_t* compressed_block_offsets() const {
+    KATANA_LOG_VASSERT(
+        compressed_block_offsets_ != nullptr || num_compressed_blocks_ == 0,
+        "Either this topology is not compressed, or the RDGTopology must be "
+        "either bound & mapped, or filled from memory.");
+    return compressed_block_offsets_;
+  }
+
+  /// Only present for kCompressedTopology
+  /// Requires backing FileView to be mapped & bound, or the RDGTopology to be filled from memory
+  const uint8_t* compressed_dests() const {
+    KATANA_LOG_VASSERT(
+        compressed_dests_ != nullptr || num_compressed_bytes_ == 0,
+        "Either this topology is not compressed, or the RDGTopology must be "
+        "either bound & mapped, or filled from memory.");
+    return compressed_dests_;
+  }
+
+  uint64_t num_compressed_blocks() const { return num_compressed_blocks_; }
+
+  uint64_t num_compressed_bytes() const { return num_compressed_bytes_; }
+
   uint64_t edge_condensed_type_id_map_size() const {
     return edge_condensed_type_id_map_size_;
   }
@@ -200,6 +252,10 @@ public:
   katana::Result<void> Bind(
       const katana::URI& metadata_dir, bool resolve = true);
 
+  /// Bind a topology file on a local file system to the file_storage object
+  /// by memory mapping it; see FileView::BindMapped
+  katana::Result<void> BindMapped(const katana::URI& metadata_dir);
+
   /// Bind a topology file to the file_storage object, bind specific offset
   katana::Result<void> Bind(
       const katana::URI& metadata_dir, uint64_t begin, uint64_t end,
@@ -214,7 +270,7 @@ public:
   /// may or may not be present in the topology file.
   /// A magic_number is placed before each of these optional data structures as a sanity check.
   ///
-  ///   uint64_t version: expected to be 1
+  ///   uint64_t version: 1 for 32-bit out_dests, 2 for 64-bit out_dests
   ///   uint64_t sizeof_edge_data: size of edge data element
   ///   uint64_t num_nodes: number of nodes
   ///   uint64_t num_edges: number of edges
@@ -222,6 +278,17 @@ public:
   ///   uint32_t[num_edges] out_dests: destinations (node indexes) of each edge
   ///   uint32_t padding if num_edges is odd
   ///
+  /// Version 2 has uint64_t out_dests and no padding. Store writes version 2
+  /// only when num_nodes does not fit in 32 bits, so graphs that fit remain
+  /// readable by builds without KATANA_USE_64BIT_NODE_IDS.
+  ///
+  /// For kCompressedTopology, out_dests is replaced by
+  ///
+  ///   uint64_t num_blocks: number of compressed destination blocks
+  ///   uint64_t num_bytes: size of the compressed destination stream
+  ///   uint64_t[num_blocks] block_offsets: byte offset of each block
+  ///   uint8_t[num_bytes] compressed_dests: padded to a multiple of 8 bytes
+  ///
   ///   <optional topology data structures follow>
   ///
   ///   uint64_t magic_number: sum of num_edges + num_nodes
@@ -264,21 +331,21 @@ public:
 
   /// Make a new basic RDGTopology from in memory structures
   static katana::Result<katana::RDGTopology> Make(
-      const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+      const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
       uint64_t num_edges, TopologyKind topology_state,
       TransposeKind transpose_state, EdgeSortKind edge_sort_state,
       NodeSortKind node_sort_state);
 
   /// Make an RDGTopology for an EdgeShuffle related Topology from in memory structures
   static katana::Result<katana::RDGTopology> Make(
-      const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+      const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
       uint64_t num_edges, TopologyKind topology_state,
       TransposeKind transpose_state, EdgeSortKind edge_sort_state,
       const uint64_t* edge_index_to_property_index_map);
 
   /// Make an RDGTopology for an EdgeTypeAware related Topology from in memory structures
   static katana::Result<katana::RDGTopology> Make(
-      const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+      const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
       uint64_t num_edges, TopologyKind topology_state,
       TransposeKind transpose_state, EdgeSortKind edge_sort_state,
       const uint64_t* edge_index_to_property_index_map,
@@ -287,7 +354,7 @@ public:
 
   /// Make an RDGTopology for a Shuffle related Topology from in memory structures
   static katana::Result<katana::RDGTopology> Make(
-      const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+      const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
       uint64_t num_edges, TopologyKind topology_state,
       TransposeKind transpose_state, EdgeSortKind edge_sort_state,
       NodeSortKind node_sort_state,
@@ -296,7 +363,7 @@ public:
 
   /// Make and fully populate an RDGTopology from in memory structures
   static katana::Result<katana::RDGTopology> Make(
-      const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+      const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
       uint64_t num_edges, TopologyKind topology_state,
       TransposeKind transpose_state, EdgeSortKind edge_sort_state,
       NodeSortKind node_sort_state,
@@ -307,6 +374,16 @@ public:
       uint64_t node_condensed_type_id_map_size,
       const katana::EntityTypeID* node_condensed_type_id_map_);
 
+  /// Make an RDGTopology for a compressed Topology from in memory structures.
+  /// The encoding of compressed_dests is owned by the caller; the RDGTopology
+  /// only stores it.
+  static katana::Result<katana::RDGTopology> Make(
+      const uint64_t* adj_indices, uint64_t num_nodes, uint64_t num_edges,
+      TransposeKind transpose_state, EdgeSortKind edge_sort_state,
+      const uint64_t* edge_index_to_property_index_map,
+      uint64_t num_compressed_blocks, const uint64_t* compressed_block_offsets,
+      uint64_t num_compressed_bytes, const uint8_t* compressed_dests);
+
   // Make an RDGTopology from on storage metadata
   static katana::Result<katana::RDGTopology> Make(
       PartitionTopologyMetadataEntry* entry);
@@ -322,6 +399,9 @@ private:
   NodeSortKind node_sort_state_{-1};
   uint64_t edge_condensed_type_id_map_size_{0};
   uint64_t node_condensed_type_id_map_size_{0};
+  // only used by kCompressedTopology, stored in the topology file
+  uint64_t num_compressed_blocks_{0};
+  uint64_t num_compressed_bytes_{0};
 
   // File store state
   /// Flag to show if we have mapped the file store to memory
@@ -339,21 +419,27 @@ private:
 
   // must be loaded from file store or set
   const uint64_t* adj_indices_{nullptr};
-  const uint32_t* dests_{nullptr};
+  const Node* dests_{nullptr};
   const uint64_t* edge_index_to_property_index_map_{nullptr};
   const uint64_t* node_index_to_property_index_map_{nullptr};
   const katana::EntityTypeID* edge_condensed_type_id_map_{nullptr};
   const katana::EntityTypeID* node_condensed_type_id_map_{nullptr};
+  const uint64_t* compressed_block_offsets_{nullptr};
+  const uint8_t* compressed_dests_{nullptr};
 
   FileView file_storage_;
+  std::shared_ptr<const void> in_memory_storage_;
+  /// dests_ when the topology file stores them in a width other than Node
+  std::shared_ptr<const void> converted_dests_;
 
   static katana::Result<katana::RDGTopology> DoMake(
       katana::RDGTopology topo, const uint64_t* adj_indices, uint64_t num_nodes,
-      const uint32_t* dests, uint64_t num_edges, TopologyKind topology_state,
+      const Node* dests, uint64_t num_edges, TopologyKind topology_state,
       TransposeKind transpose_state, EdgeSortKind edge_sort_state,
       NodeSortKind node_sort_state);
 
-  size_t GetGraphSize() const;
+  /// \p dest_size is the size of a destination in the topology file
+  size_t GetGraphSize(size_t dest_size) const;
 
   // Topology File Offset Definitions
   static constexpr size_t version_num_offset = 0;
@@ -0,0 +1,63 @@
+#ifndef KATANA_LIBTSUBA_KATANA_RAWCOLUMN_H_
+#define KATANA_LIBTSUBA_KATANA_RAWCOLUMN_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/ParquetReader.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/WriteGroup.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A raw column file holds one fixed-width column (integers, floating point
+/// numbers and fixed size binary values) the way Arrow lays it out in memory:
+/// a header followed by the validity bitmap, if there are nulls, and the
+/// values, each starting on a 64 byte boundary. Reading an uncompressed raw
+/// column is just I/O; there is nothing to decode.
+///
+/// RDGs can keep a raw column next to the Parquet file of a property, and
+/// loaders use it instead of the Parquet file when it is there.
+enum class RawColumnFormat : uint32_t {
+  /// do not write raw columns
+  kNone = 0,
+  kUncompressed,
+  /// validity and values are each compressed as an LZ4 frame
+  kLZ4Frame,
+};
+
+/// \returns true if columns of \p type can be stored as raw columns
+KATANA_EXPORT bool IsRawColumnType(const arrow::DataType& type);
+
+/// Store \p array as a raw column at \p uri. If \p group is null the
+/// write is synchronous, otherwise it is added to \p group
+KATANA_EXPORT katana::Result<void> WriteRawColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const katana::URI& uri,
+    RawColumnFormat format, katana::WriteGroup* group = nullptr);
+
+/// \returns the type of the column stored in the raw column file at \p uri
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::DataType>>
+ReadRawColumnType(const katana::URI& uri);
+
+/// Read a raw column file as a table with one column named \p name
+///
+/// The returned buffers point into the FileView that read the file and keep
+/// it alive, so only the bytes that were asked for are ever copied.
+///
+/// \param slice if present, only these rows are read
+/// \param map_local_file if true, local uncompressed files are memory mapped
+///     rather than read; see FileView::BindMapped
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> ReadRawColumn(
+    const std::string& name, const katana::URI& uri,
+    std::optional<ParquetReader::Slice> slice = std::nullopt,
+    bool map_local_file = false);
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef KATANA_LIBTSUBA_KATANA_REACHABILITYINDEXPRIMITIVE_H_
+#define KATANA_LIBTSUBA_KATANA_REACHABILITYINDEXPRIMITIVE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/RDGOptionalDatastructure.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "katana/tsuba.h"
+
+namespace katana {
+
+const std::string kOptionalDatastructureReachabilityIndexPrimitive =
+    "kg.v1.reachability_index";
+const std::string kOptionalDatastructureReachabilityIndexPrimitiveFilename =
+    "reachability_index_manifest";
+const std::string kOptionalDatastructureReachabilityIndexArrayFilename =
+    "reachability_index_array";
+
+/// The stored form of a reachability index: the strongly connected component
+/// of every node, the DAG of the components as a CSR, and labels of the
+/// components that prove most pairs of components unreachable or reachable
+/// without a search. The arrays are written to their own files and mapped
+/// back into memory on load; what the labels mean is up to the index that
+/// writes them.
+class KATANA_EXPORT ReachabilityIndexPrimitive
+    : private katana::RDGOptionalDatastructure {
+public:
+  static katana::Result<ReachabilityIndexPrimitive> Load(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    ReachabilityIndexPrimitive index =
+        KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+
+    KATANA_CHECKED(index.LoadArray(
+        rdg_dir_path, kComponentsKey, index.num_nodes_, &index.components_));
+    KATANA_CHECKED(index.LoadArray(
+        rdg_dir_path, kDagIndicesKey, index.num_components_,
+        &index.dag_indices_));
+    uint64_t num_dag_edges =
+        index.num_components_ == 0
+            ? 0
+            : index.dag_indices()[index.num_components_ - 1];
+    KATANA_CHECKED(index.LoadArray(
+        rdg_dir_path, kDagDestsKey, num_dag_edges, &index.dag_dests_));
+    KATANA_CHECKED(index.LoadArray(
+        rdg_dir_path, kLabelsKey, index.num_components_ * index.label_width_,
+        &index.labels_));
+    return index;
+  }
+
+  katana::Result<std::string> Write(katana::URI rdg_dir_path) {
+    KATANA_CHECKED(WriteArray(rdg_dir_path, kComponentsKey, components_));
+    KATANA_CHECKED(WriteArray(rdg_dir_path, kDagIndicesKey, dag_indices_));
+    KATANA_CHECKED(WriteArray(rdg_dir_path, kDagDestsKey, dag_dests_));
+    KATANA_CHECKED(WriteArray(rdg_dir_path, kLabelsKey, labels_));
+
+    // Write out our json manifest
+    katana::URI manifest_path = rdg_dir_path.RandFile(
+        kOptionalDatastructureReachabilityIndexPrimitiveFilename);
+    KATANA_CHECKED(WriteManifest(manifest_path.string()));
+    return manifest_path.BaseName();
+  }
+
+  /// The number of nodes and edges of the graph the index was built for
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+  void set_num_edges(uint64_t num) { num_edges_ = num; }
+
+  uint64_t num_components() const { return num_components_; }
+
+  /// The number of labels of each component
+  uint32_t label_width() const { return label_width_; }
+
+  /// The component of every node
+  const uint32_t* components() const { return components_.data(); }
+  void set_components(std::vector<uint32_t> components) {
+    num_nodes_ = components.size();
+    components_.Set(std::move(components));
+  }
+
+  /// The end of the out-edges of every component in dag_dests
+  const uint64_t* dag_indices() const { return dag_indices_.data(); }
+  const uint32_t* dag_dests() const { return dag_dests_.data(); }
+  void set_dag(std::vector<uint64_t> indices, std::vector<uint32_t> dests) {
+    num_components_ = indices.size();
+    dag_indices_.Set(std::move(indices));
+    dag_dests_.Set(std::move(dests));
+  }
+
+  /// label_width labels for every component, next to each other
+  const uint32_t* labels() const { return labels_.data(); }
+  void set_labels(std::vector<uint32_t> labels, uint32_t label_width) {
+    label_width_ = label_width;
+    labels_.Set(std::move(labels));
+  }
+
+  friend void to_json(
+      nlohmann::json& j, const ReachabilityIndexPrimitive& index);
+  friend void from_json(
+      const nlohmann::json& j, ReachabilityIndexPrimitive& index);
+
+private:
+  static constexpr const char* kComponentsKey = "components";
+  static constexpr const char* kDagIndicesKey = "dag_indices";
+  static constexpr const char* kDagDestsKey = "dag_dests";
+  static constexpr const char* kLabelsKey = "labels";
+
+  /// An array either built in memory or mapped from its file
+  template <typename T>
+  struct StoredArray {
+    std::vector<T> values;
+    std::shared_ptr<katana::FileView> file;
+
+    const T* data() const { return file ? file->ptr<T>() : values.data(); }
+    void Set(std::vector<T> v) {
+      values = std::move(v);
+      file.reset();
+    }
+  };
+
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+  uint64_t num_components_{0};
+  uint32_t label_width_{0};
+
+  /// data structures dumped to their own files
+
+  StoredArray<uint32_t> components_;
+  StoredArray<uint64_t> dag_indices_;
+  StoredArray<uint32_t> dag_dests_;
+  StoredArray<uint32_t> labels_;
+
+  template <typename T>
+  katana::Result<void> LoadArray(
+      const katana::URI& rdg_dir_path, const std::string& key, uint64_t size,
+      StoredArray<T>* array) {
+    auto path = paths_.find(key);
+    if (path == paths_.end()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "reachability index has no {} file",
+          key);
+    }
+    if (size == 0) {
+      return katana::ResultSuccess();
+    }
+    katana::URI uri = rdg_dir_path.Join(path->second);
+    array->file = std::make_shared<katana::FileView>();
+    if (uri.scheme() == katana::URI::kFileScheme) {
+      KATANA_CHECKED(array->file->BindMapped(uri.path()));
+    } else {
+      KATANA_CHECKED(array->file->Bind(uri.string(), true));
+    }
+    if (array->file->size() != size * sizeof(T)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "reachability index {} should hold {} entries but its file has {} "
+          "bytes",
+          key, size, array->file->size());
+    }
+    return katana::ResultSuccess();
+  }
+
+  template <typename T>
+  katana::Result<void> WriteArray(
+      const katana::URI& rdg_dir_path, const std::string& key,
+      const StoredArray<T>& array) {
+    // mapped arrays are written again, they may live in another directory
+    size_t size =
+        array.file ? array.file->size() : array.values.size() * sizeof(T);
+    katana::URI path = rdg_dir_path.RandFile(
+        kOptionalDatastructureReachabilityIndexArrayFilename);
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(std::max<size_t>(size, 1)));
+    if (auto res = ff->Write(array.data(), size); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path.string());
+    KATANA_CHECKED(ff->Persist());
+    paths_[key] = path.BaseName();
+
+    return katana::ResultSuccess();
+  }
+
+  static katana::Result<ReachabilityIndexPrimitive> LoadJson(
+      const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(path, true));
+
+    if (fv.size() == 0) {
+      return ReachabilityIndexPrimitive();
+    }
+
+    ReachabilityIndexPrimitive index;
+    KATANA_CHECKED(katana::JsonParse<ReachabilityIndexPrimitive>(fv, &index));
+
+    return index;
+  }
+
+  katana::Result<void> WriteManifest(const std::string& path) const {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(serialized.size()));
+    if (auto res = ff->Write(serialized.data(), serialized.size()); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path);
+    // persist now
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::ResultSuccess();
+  }
+};
+
+}  // namespace katana
+
+#endif
@@ -1,12 +1,25 @@
 #ifndef KATANA_LIBTSUBA_KATANA_TXNCONTEXT_H_
 #define KATANA_LIBTSUBA_KATANA_TXNCONTEXT_H_
 
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "katana/RDGManifest.h"
+#include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/config.h"
 
+namespace arrow {
+class ChunkedArray;
+}  // namespace arrow
+
 namespace katana {
 
 struct RDGManifestInfo {
@@ -14,76 +27,175 @@ struct RDGManifestInfo {
   RDGManifest rdg_manifest;
 };
 
+/// A transaction over the properties of loaded graphs.
+///
+/// Transactions are optimistic: the first time a transaction reads or writes
+/// a property, it records the committed version of that property, and
+/// Commit() fails with ErrorCode::TransactionConflict if another transaction
+/// committed a write to any of them since (first committer wins). Reads
+/// through PropertyGraph::GetNodeProperty(name, txn_ctx) also keep the column
+/// they returned, so a transaction sees the same version of a property until
+/// it writes the property itself or commits, even while other threads upsert
+/// it.
+///
+/// Writes take effect on the graph immediately. An explicit transaction
+/// holds each property it writes until it commits, and a write of a held
+/// property by another transaction fails with ErrorCode::TransactionConflict
+/// before it changes anything. A failed Commit(), or destroying an explicit
+/// context without committing, undoes the property writes of the
+/// transaction, so the writes of the transaction that won are what remains.
+///
+/// Auto-commit contexts are meant for transaction unaware code: their writes
+/// are published at commit so that explicit transactions see them, and they
+/// only fail with a conflict when they write a property an explicit
+/// transaction holds.
+///
+/// Properties are identified by the directory of their RDG and their name,
+/// so in-memory graphs that were never stored share one namespace.
 class KATANA_EXPORT TxnContext {
 public:
   /// Create a transaction context. By default it commits changes when the context is destroyed. This is useful when calling from transaction unaware code like tests.
-  TxnContext() {}
+  TxnContext();
 
   /// @brief Create a transaction context.
   /// @param auto_commit :: if false, changes are only committed when Commit is called; if true, changes are committed also when the context is destroyed.
-  explicit TxnContext(bool auto_commit) : auto_commit_(auto_commit) {}
+  explicit TxnContext(bool auto_commit);
+
+  /// Commits an auto-commit context, and undoes the uncommitted writes of an
+  /// explicit one
+  ~TxnContext();
+
+  /// Restores a property as it was before a transaction first wrote it
+  using UndoFn = std::function<katana::Result<void>()>;
+
+  /// Claim node property \p name of \p rdg_dir of \p graph before writing
+  /// it. Fails with ErrorCode::TransactionConflict while another explicit
+  /// transaction holds the property, which also makes Commit() of an explicit
+  /// transaction fail. An explicit transaction then holds the property and
+  /// runs \p undo if it does not commit; only the undo of its first write of
+  /// a property is kept, and auto-commit contexts ignore \p undo.
+  katana::Result<void> BeginNodePropertyWrite(
+      const void* graph, const std::string& rdg_dir, const std::string& name,
+      UndoFn undo) {
+    return BeginWrite(
+        graph, VersionKey(PropertyKind::kNode, URI::JoinPath(rdg_dir, name)),
+        std::move(undo));
+  }
 
-  ~TxnContext() {
-    if (auto_commit_) {
-      KATANA_LOG_ASSERT(Commit());
-    }
+  /// Claim edge property \p name of \p rdg_dir of \p graph before writing
+  /// it; see BeginNodePropertyWrite
+  katana::Result<void> BeginEdgePropertyWrite(
+      const void* graph, const std::string& rdg_dir, const std::string& name,
+      UndoFn undo) {
+    return BeginWrite(
+        graph, VersionKey(PropertyKind::kEdge, URI::JoinPath(rdg_dir, name)),
+        std::move(undo));
   }
 
+  bool auto_commit() const { return auto_commit_; }
+
   void InsertNodePropertyRead(
       const std::string& rdg_dir, const std::string& name) {
-    node_properties_read_.insert(URI::JoinPath(rdg_dir, name));
+    std::string uri = URI::JoinPath(rdg_dir, name);
+    ObserveRead(PropertyKind::kNode, uri);
+    node_properties_read_.insert(std::move(uri));
   }
 
   template <typename Container>
   void InsertNodePropertyRead(
       const std::string& rdg_dir, const Container& names) {
     for (const auto& name : names) {
-      node_properties_read_.insert(URI::JoinPath(rdg_dir, name));
+      InsertNodePropertyRead(rdg_dir, name);
     }
   }
 
   void InsertNodePropertyWrite(
       const std::string& rdg_dir, const std::string& name) {
-    node_properties_write_.insert(URI::JoinPath(rdg_dir, name));
+    std::string uri = URI::JoinPath(rdg_dir, name);
+    ObserveWrite(PropertyKind::kNode, uri);
+    node_properties_write_.insert(std::move(uri));
   }
 
   template <typename Container>
   void InsertNodePropertyWrite(
       const std::string& rdg_dir, const Container& names) {
     for (const auto& name : names) {
-      node_properties_write_.insert(URI::JoinPath(rdg_dir, name));
+      InsertNodePropertyWrite(rdg_dir, name);
     }
   }
 
+  /// \returns the column of node property \p name of \p rdg_dir that this
+  /// transaction read before, or nullptr if it has not read it since it last
+  /// wrote it or committed
+  std::shared_ptr<arrow::ChunkedArray> NodePropertySnapshot(
+      const std::string& rdg_dir, const std::string& name) const {
+    return FindSnapshot(PropertyKind::kNode, URI::JoinPath(rdg_dir, name));
+  }
+
+  /// Record that this transaction read \p column as node property \p name of
+  /// \p rdg_dir; later NodePropertySnapshot calls return it
+  void InsertNodePropertySnapshot(
+      const std::string& rdg_dir, const std::string& name,
+      std::shared_ptr<arrow::ChunkedArray> column) {
+    InsertNodePropertyRead(rdg_dir, name);
+    snapshots_[VersionKey(PropertyKind::kNode, URI::JoinPath(rdg_dir, name))] =
+        std::move(column);
+  }
+
   void InsertEdgePropertyRead(
       const std::string& rdg_dir, const std::string& name) {
-    edge_properties_read_.insert(URI::JoinPath(rdg_dir, name));
+    std::string uri = URI::JoinPath(rdg_dir, name);
+    ObserveRead(PropertyKind::kEdge, uri);
+    edge_properties_read_.insert(std::move(uri));
   }
 
   template <typename Container>
   void InsertEdgePropertyRead(
       const std::string& rdg_dir, const Container& names) {
     for (const auto& name : names) {
-      edge_properties_read_.insert(URI::JoinPath(rdg_dir, name));
+      InsertEdgePropertyRead(rdg_dir, name);
     }
   }
 
   void InsertEdgePropertyWrite(
       const std::string& rdg_dir, const std::string& name) {
-    edge_properties_write_.insert(URI::JoinPath(rdg_dir, name));
+    std::string uri = URI::JoinPath(rdg_dir, name);
+    ObserveWrite(PropertyKind::kEdge, uri);
+    edge_properties_write_.insert(std::move(uri));
   }
 
   template <typename Container>
   void InsertEdgePropertyWrite(
       const std::string& rdg_dir, const Container& names) {
     for (const auto& name : names) {
-      edge_properties_write_.insert(URI::JoinPath(rdg_dir, name));
+      InsertEdgePropertyWrite(rdg_dir, name);
     }
   }
 
+  /// \returns the column of edge property \p name of \p rdg_dir that this
+  /// transaction read before, or nullptr if it has not read it since it last
+  /// wrote it or committed
+  std::shared_ptr<arrow::ChunkedArray> EdgePropertySnapshot(
+      const std::string& rdg_dir, const std::string& name) const {
+    return FindSnapshot(PropertyKind::kEdge, URI::JoinPath(rdg_dir, name));
+  }
+
+  /// Record that this transaction read \p column as edge property \p name of
+  /// \p rdg_dir; later EdgePropertySnapshot calls return it
+  void InsertEdgePropertySnapshot(
+      const std::string& rdg_dir, const std::string& name,
+      std::shared_ptr<arrow::ChunkedArray> column) {
+    InsertEdgePropertyRead(rdg_dir, name);
+    snapshots_[VersionKey(PropertyKind::kEdge, URI::JoinPath(rdg_dir, name))] =
+        std::move(column);
+  }
+
   void SetAllPropertiesRead() { all_properties_read_ = true; }
 
-  void SetAllPropertiesWrite() { all_properties_write_ = true; }
+  void SetAllPropertiesWrite() {
+    all_properties_write_ = true;
+    snapshots_.clear();
+  }
 
   void SetTopologyRead() { topology_read_ = true; }
 
@@ -113,6 +225,22 @@ public:
     return edge_properties_write_;
   }
 
+  /// \returns the committed version of node property \p name of
+  /// \p rdg_dir, a number that changes whenever a transaction commits a write
+  /// to the property or to all properties. Uncommitted writes, including
+  /// those of this transaction, do not change it.
+  static uint64_t CommittedNodePropertyVersion(
+      const std::string& rdg_dir, const std::string& name) {
+    return CommittedVersion(PropertyKind::kNode, URI::JoinPath(rdg_dir, name));
+  }
+
+  /// \returns the committed version of edge property \p name of
+  /// \p rdg_dir; see CommittedNodePropertyVersion
+  static uint64_t CommittedEdgePropertyVersion(
+      const std::string& rdg_dir, const std::string& name) {
+    return CommittedVersion(PropertyKind::kEdge, URI::JoinPath(rdg_dir, name));
+  }
+
   bool AllPropertiesRead() const { return all_properties_read_; }
 
   bool AllPropertiesWrite() const { return all_properties_write_; }
@@ -129,9 +257,43 @@ public:
     return manifest_info_.at(rdg_dir);
   }
 
+  /// Make Commit() wait for \p writes, the data files of an asynchronous
+  /// store, before it writes the manifests that refer to them
+  void AddPendingStore(std::shared_future<CopyableResult<void>> writes) {
+    pending_stores_.emplace_back(std::move(writes));
+  }
+
+  /// Check the read and write sets against the transactions that committed
+  /// since they were recorded, publish the writes and write the cached
+  /// manifests once the pending writes of asynchronous stores are done.
+  /// After a successful commit, the context starts a new transaction; after
+  /// a conflict, the writes of the transaction are undone, and it is retried
+  /// with a new context.
   katana::Result<void> Commit();
 
 private:
+  enum class PropertyKind { kNode, kEdge };
+
+  static std::string VersionKey(PropertyKind kind, const std::string& uri);
+  static uint64_t CommittedVersion(PropertyKind kind, const std::string& uri);
+
+  void ObserveRead(PropertyKind kind, const std::string& uri);
+  void ObserveWrite(PropertyKind kind, const std::string& uri);
+  katana::Result<void> BeginWrite(
+      const void* graph, const std::string& key, UndoFn undo);
+  /// Undo the writes of this transaction, release the properties it holds
+  /// and start the next transaction
+  void Rollback();
+  /// Forget the state of the current transaction, given the commit counts
+  /// of PropertyVersions
+  void StartNextTransaction(uint64_t writes, uint64_t all_writes);
+  std::shared_ptr<arrow::ChunkedArray> FindSnapshot(
+      PropertyKind kind, const std::string& uri) const;
+
+  /// Fails if a property this transaction touched was committed by another
+  /// transaction after it was first touched, otherwise publishes the writes
+  katana::Result<void> ValidateAndPublish();
+
   std::set<std::string> node_properties_read_;
   std::set<std::string> node_properties_write_;
   std::set<std::string> edge_properties_read_;
@@ -142,8 +304,28 @@ private:
   bool topology_write_{false};
 
   bool auto_commit_{true};
+
+  /// committed version of each property in the read and write sets when this
+  /// transaction first touched it, by VersionKey
+  std::unordered_map<std::string, uint64_t> observed_versions_;
+  /// writes not yet published by Commit(), by VersionKey
+  std::set<std::string> pending_writes_;
+  /// properties this transaction holds, by graph and VersionKey, and how to
+  /// undo its writes of them, in the order of the writes
+  std::vector<std::pair<const void*, std::string>> held_writes_;
+  std::vector<UndoFn> undos_;
+  /// whether a write of this transaction hit a property another one held
+  bool conflicted_{false};
+  /// columns returned to this transaction, by VersionKey
+  std::unordered_map<std::string, std::shared_ptr<arrow::ChunkedArray>>
+      snapshots_;
+  /// number of commits with writes, and with writes to all properties, when
+  /// this transaction started
+  uint64_t observed_writes_{0};
+  uint64_t observed_all_writes_{0};
   std::unordered_map<URI, RDGManifestInfo, URI::Hash> manifest_info_;
   std::unordered_map<URI, bool, URI::Hash> manifest_uptodate_;
+  std::vector<std::shared_future<CopyableResult<void>>> pending_stores_;
 };
 
 }  // namespace katana
@@ -22,17 +22,22 @@ class KATANA_EXPORT WriteGroup {
   };
 
   std::string tag_;
+  uint64_t max_outstanding_size_;
   std::atomic<uint64_t> outstanding_size_{0};
   AsyncOpGroup async_op_group_;
 
-  WriteGroup(std::string tag) : tag_(std::move(tag)){};
+  WriteGroup(std::string tag, uint64_t max_outstanding_size)
+      : tag_(std::move(tag)), max_outstanding_size_(max_outstanding_size){};
 
 public:
   static constexpr uint64_t kMaxOutstandingSize = 10ULL << 30;  // 10 GB
 
   /// Build a descriptor with a tag. If running with multiple hosts, Make should
   /// be Called BSP style and all hosts will have the same tag
-  static katana::Result<std::unique_ptr<WriteGroup>> Make();
+  /// \param max_outstanding_size bound on the bytes held by operations that
+  ///     have been added but not yet finished; see WaitForRoom
+  static katana::Result<std::unique_ptr<WriteGroup>> Make(
+      uint64_t max_outstanding_size = kMaxOutstandingSize);
 
   /// Return a random tag that uniquely identifies this op
   const std::string& tag() const { return tag_; }
@@ -48,11 +53,16 @@ public:
     AddOp(FileStoreAsync(file, buf, size), file);
   }
 
-  void AddToOutstanding(uint64_t size) { outstanding_size_ += size; }
+  /// Wait for earlier operations to finish until an operation holding
+  /// \p size bytes fits in the outstanding size budget. Callers that build
+  /// their buffers asynchronously should call this before they start so that
+  /// buffers are not built faster than they can be written out
+  void WaitForRoom(uint64_t size);
 
   /// Add future to the list of futures this descriptor will wait for, note
   /// the file name for debugging. If the operation is associated with a file
-  /// frame that we are responsible for, note the size
+  /// frame that we are responsible for, note the size; it counts against the
+  /// outstanding size budget until the operation finishes
   void AddOp(
       std::future<katana::CopyableResult<void>> future, std::string file,
       uint64_t accounted_size = 0);
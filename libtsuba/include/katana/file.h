@@ -30,6 +30,10 @@ RoundUpToBlock(T val) {
 
 struct StatBuf {
   uint64_t size{UINT64_C(0)};
+  /// An opaque identifier of the current contents of the file, e.g., its ETag
+  /// or modification time, that changes whenever they do. Empty if the
+  /// backend cannot provide one; such files are never cached locally.
+  std::string version;
 };
 
 // Returns an error file uri does not exist
@@ -120,11 +120,27 @@ CreateSrcDestFromViewsForCopy(
 /// E.g. SRC_DIR/part_vers0003_rdg_node00000 -> DST_DIR/part_vers0001_rdg_node_00000
 /// The argument is a list of source and destination pairs as an RDG consists of many files.
 /// See CreateSrcDestFromViewsForCopy for how to generate this list from an RDG prefix and version
+/// Property files are named after their contents, so those that already exist
+/// at the destination with the same size are not copied again.
 /// \param src_dst_files is a vector of src-dest pairs for individual RDG files
 /// \returns a Result to indicate whether the method succeeded or failed
 KATANA_EXPORT katana::Result<void> CopyRDG(
     std::vector<std::pair<katana::URI, katana::URI>> src_dst_files);
 
+/// UprevRDG stores the latest version of the RDG at src_dir as version 1 of
+/// an RDG at dst_dir in the latest storage_format_version without loading its
+/// properties or topologies. Only part headers and manifests are rewritten;
+/// every other file is copied as is, on the storage side when both
+/// directories are on the same back-end. It can be called concurrently for
+/// different RDGs.
+/// \param max_outstanding_size bound on the bytes being copied at once
+/// \returns ErrorCode::NotImplemented if some files of the RDG are in formats
+///     that older storage_format_versions used; such RDGs must be loaded and
+///     stored to be converted
+KATANA_EXPORT katana::Result<void> UprevRDG(
+    const std::string& src_dir, const std::string& dst_dir,
+    uint64_t max_outstanding_size);
+
 // Setup and tear down
 KATANA_EXPORT katana::Result<void> InitTsuba(katana::CommBackend* comm);
 KATANA_EXPORT katana::Result<void> InitTsuba();
@@ -14,6 +14,7 @@
 #include "katana/ParquetReader.h"
 #include "katana/ProgressTracer.h"
 #include "katana/PropertyManager.h"
+#include "katana/RawColumn.h"
 #include "katana/Result.h"
 #include "katana/Time.h"
 
@@ -44,6 +45,30 @@ DoLoadProperties(
   return out;
 }
 
+/// Load \p prop from its raw column if it has one and from its Parquet file
+/// otherwise, or if the raw column cannot be read
+katana::Result<std::shared_ptr<arrow::Table>>
+LoadPropertyFromStorage(
+    const katana::PropStorageInfo& prop, const katana::URI& dir,
+    std::optional<katana::ParquetReader::Slice> slice, bool map_local_files) {
+  if (!prop.raw_path().empty()) {
+    auto raw_res = katana::ReadRawColumn(
+        prop.name(), dir.Join(prop.raw_path()), slice, map_local_files);
+    if (raw_res) {
+      return raw_res.value();
+    }
+    KATANA_LOG_WARN(
+        "reading Parquet file of {} instead of its raw column: {}",
+        std::quoted(prop.name()), raw_res.error());
+  }
+  const katana::URI& path = dir.Join(prop.path());
+  if (slice) {
+    return katana::LoadPropertySlice(
+        prop.name(), path, slice->offset, slice->length);
+  }
+  return katana::LoadProperties(prop.name(), path);
+}
+
 }  // namespace
 
 katana::Result<std::shared_ptr<arrow::Table>>
@@ -71,12 +96,55 @@ katana::LoadPropertySlice(
   }
 }
 
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::LoadPropertyRanges(
+    const katana::PropStorageInfo& prop, const katana::URI& dir,
+    const std::vector<katana::ParquetReader::Slice>& ranges) {
+  if (!prop.raw_path().empty() && !ranges.empty()) {
+    std::vector<std::shared_ptr<arrow::Table>> tables;
+    katana::Result<void> raw_res = katana::ResultSuccess();
+    for (const auto& range : ranges) {
+      auto table_res = katana::ReadRawColumn(
+          prop.name(), dir.Join(prop.raw_path()), range, false);
+      if (!table_res) {
+        raw_res = table_res.error();
+        break;
+      }
+      tables.emplace_back(std::move(table_res.value()));
+    }
+    if (raw_res) {
+      return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+    }
+    KATANA_LOG_WARN(
+        "reading Parquet file of {} instead of its raw column: {}",
+        std::quoted(prop.name()), raw_res.error());
+  }
+
+  try {
+    std::unique_ptr<katana::ParquetReader> reader =
+        KATANA_CHECKED(katana::ParquetReader::Make());
+    std::shared_ptr<arrow::Table> out = KATANA_CHECKED(
+        reader->ReadTableRanges(dir.Join(prop.path()), ranges));
+    if (out->num_columns() != 1 || out->field(0)->name() != prop.name()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "expected the single column {} in {}", std::quoted(prop.name()),
+          prop.path());
+    }
+    return out;
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+  }
+}
+
 katana::Result<void>
 katana::AddProperties(
     const katana::URI& uri, bool is_property,
     const std::vector<katana::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    bool map_local_files) {
   for (katana::PropStorageInfo* prop : properties) {
     if (!prop->IsAbsent()) {
       return KATANA_ERROR(
@@ -121,10 +189,12 @@ katana::AddProperties(
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
         std::async(
             std::launch::async,
-            [prop,
-             path]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+            [prop, uri, path, map_local_files]()
+                -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
               return KATANA_CHECKED_CONTEXT(
-                  LoadProperties(prop->name(), path), "error loading {}", path);
+                  LoadPropertyFromStorage(
+                      *prop, uri, std::nullopt, map_local_files),
+                  "error loading {}", path);
             });
     auto on_complete = [add_fn, is_property,
                         prop](const std::shared_ptr<arrow::Table>& props)
@@ -179,11 +249,16 @@ katana::AddPropertySlice(
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
         std::async(
             std::launch::async,
-            [path, prop, begin,
+            [dir, path, prop, begin,
              size]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
               std::shared_ptr<arrow::Table> load_result =
                   KATANA_CHECKED_CONTEXT(
-                      LoadPropertySlice(prop->name(), path, begin, size),
+                      LoadPropertyFromStorage(
+                          *prop, dir,
+                          katana::ParquetReader::Slice{
+                              .offset = static_cast<int64_t>(begin),
+                              .length = static_cast<int64_t>(size)},
+                          false),
                       "error loading {}", path);
               return load_result;
             });
@@ -4,6 +4,7 @@
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
+#include "katana/ParquetReader.h"
 #include "katana/ReadGroup.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
@@ -17,12 +18,23 @@ KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::URI& file_path,
     int64_t offset, int64_t length);
 
-// is_property is true for properties and false for RDG metadata
+/// Read the rows in \p ranges of \p prop from storage, from its raw column
+/// if it has one, without changing its state. The ranges must be in order
+/// and disjoint; the table holds their rows one after the other.
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>>
+LoadPropertyRanges(
+    const katana::PropStorageInfo& prop, const katana::URI& dir,
+    const std::vector<katana::ParquetReader::Slice>& ranges);
+
+// is_property is true for properties and false for RDG metadata.
+// Properties with a raw column are read from it; local raw columns are
+// memory mapped if map_local_files is true.
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::URI& uri, bool is_property,
     const std::vector<katana::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    bool map_local_files = false);
 
 KATANA_EXPORT katana::Result<void> AddPropertySlice(
     const katana::URI& dir,
@@ -0,0 +1,365 @@
+#include "CachingStorage.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <thread>
+#include <tuple>
+
+#include <arrow/util/hashing.h>
+#include <boost/filesystem.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Blocks being written are given this infix until they are complete
+constexpr std::string_view kTempMarker = ".tmp.";
+
+/// Read exactly \p size bytes at \p offset of \p fd
+bool
+ReadFully(int fd, uint64_t offset, uint64_t size, uint8_t* buf) {
+  while (size > 0) {
+    ssize_t got = pread(fd, buf, size, offset);
+    if (got <= 0) {
+      if (got < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    buf += got;
+    offset += got;
+    size -= got;
+  }
+  return true;
+}
+
+katana::Result<void>
+WriteFully(int fd, const uint8_t* data, uint64_t size) {
+  while (size > 0) {
+    ssize_t put = write(fd, data, size);
+    if (put < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return katana::ResultErrno();
+    }
+    data += put;
+    size -= put;
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::CachingStorage::Init() {
+  if (boost::system::error_code err;
+      !fs::create_directories(cache_dir_, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating cache directory {}: {}", std::quoted(cache_dir_),
+          err.message());
+    }
+  }
+
+  // pick up the blocks left by earlier runs, oldest use last
+  std::vector<std::tuple<std::time_t, std::string, uint64_t>> found;
+  boost::system::error_code err;
+  for (fs::directory_iterator it(cache_dir_, err), end; !err && it != end;
+       it.increment(err)) {
+    std::string path = it->path().string();
+    if (path.find(kTempMarker) != std::string::npos) {
+      // left by a process that died while writing it
+      boost::system::error_code remove_err;
+      fs::remove(it->path(), remove_err);
+      continue;
+    }
+    boost::system::error_code stat_err;
+    uint64_t size = fs::file_size(it->path(), stat_err);
+    std::time_t used = fs::last_write_time(it->path(), stat_err);
+    if (!stat_err) {
+      found.emplace_back(used, std::move(path), size);
+    }
+  }
+  if (err) {
+    KATANA_LOG_WARN(
+        "scanning cache directory {}: {}", std::quoted(cache_dir_),
+        err.message());
+  }
+  std::sort(found.begin(), found.end(), std::greater<>());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [used, path, size] : found) {
+      lru_.emplace_back(path);
+      entries_.emplace(std::move(path), Entry{std::prev(lru_.end()), size});
+      cached_size_ += size;
+    }
+    Evict();
+  }
+
+  return inner_->Init();
+}
+
+katana::Result<void>
+katana::CachingStorage::Stat(const std::string& uri, StatBuf* s_buf) {
+  KATANA_CHECKED(inner_->Stat(uri, s_buf));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_[uri] = RecentStat{*s_buf, std::chrono::steady_clock::now()};
+  return katana::ResultSuccess();
+}
+
+katana::Result<katana::StatBuf>
+katana::CachingStorage::CurrentStat(const std::string& uri) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stats_.find(uri);
+    auto now = std::chrono::steady_clock::now();
+    if (it != stats_.end() && now - it->second.when < kStatLifetime) {
+      return it->second.stat;
+    }
+  }
+  StatBuf stat;
+  KATANA_CHECKED(Stat(uri, &stat));
+  return stat;
+}
+
+void
+katana::CachingStorage::ForgetStat(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.erase(uri);
+}
+
+uint64_t
+katana::CachingStorage::cached_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cached_size_;
+}
+
+std::string
+katana::CachingStorage::BlockPath(
+    const std::string& uri, const std::string& version, uint64_t block) const {
+  std::string key = uri;
+  key.push_back('\0');
+  key += version;
+  return katana::URI::JoinPath(
+      cache_dir_,
+      fmt::format(
+          "{:016x}{:016x}-{}",
+          arrow::internal::ComputeStringHash<0>(key.data(), key.size()),
+          arrow::internal::ComputeStringHash<1>(key.data(), key.size()),
+          block));
+}
+
+std::optional<uint64_t>
+katana::CachingStorage::ReadCached(
+    const std::string& path, uint64_t offset, uint64_t size,
+    uint8_t* result_buf) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  std::optional<uint64_t> ret;
+  struct stat s_buf;
+  if (fstat(fd, &s_buf) == 0 &&
+      static_cast<uint64_t>(s_buf.st_size) >= offset + size &&
+      ReadFully(fd, offset, size, result_buf)) {
+    ret = s_buf.st_size;
+    // other processes sharing the directory order eviction by last use
+    futimens(fd, nullptr);
+  }
+  close(fd);
+  return ret;
+}
+
+katana::Result<void>
+katana::CachingStorage::StoreCached(
+    const std::string& path, const uint8_t* data, uint64_t size) {
+  std::string temp_path = fmt::format(
+      "{}{}{}.{}", path, kTempMarker, getpid(),
+      std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "creating {}: {}",
+        std::quoted(temp_path), katana::ResultErrno().message());
+  }
+  auto res = WriteFully(fd, data, size);
+  if (close(fd) != 0 && res) {
+    res = katana::ResultErrno();
+  }
+  if (res && rename(temp_path.c_str(), path.c_str()) != 0) {
+    res = katana::ResultErrno();
+  }
+  if (!res) {
+    unlink(temp_path.c_str());
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "writing {}: {}", std::quoted(path),
+        res.error());
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::CachingStorage::Touch(const std::string& path, uint64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = entries_.find(path); it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    cached_size_ = cached_size_ - it->second.size + size;
+    it->second.size = size;
+  } else {
+    lru_.emplace_front(path);
+    entries_.emplace(path, Entry{lru_.begin(), size});
+    cached_size_ += size;
+  }
+  Evict();
+}
+
+void
+katana::CachingStorage::Evict() {
+  while (cached_size_ > max_size_ && !lru_.empty()) {
+    const std::string& path = lru_.back();
+    auto it = entries_.find(path);
+    KATANA_LOG_DEBUG_ASSERT(it != entries_.end());
+    if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+      KATANA_LOG_WARN(
+          "evicting {}: {}", std::quoted(path),
+          katana::ResultErrno().message());
+    }
+    cached_size_ -= it->second.size;
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+}
+
+katana::Result<void>
+katana::CachingStorage::ReadBlock(
+    const std::string& uri, const StatBuf& stat, uint64_t block,
+    uint64_t offset, uint64_t size, uint8_t* result_buf) {
+  std::string path = BlockPath(uri, stat.version, block);
+  if (auto cached = ReadCached(path, offset, size, result_buf); cached) {
+    ++hits_;
+    Touch(path, cached.value());
+    return katana::ResultSuccess();
+  }
+  ++misses_;
+
+  uint64_t block_start = block * kCacheBlockSize;
+  uint64_t block_size = std::min(kCacheBlockSize, stat.size - block_start);
+  const uint8_t* block_data = result_buf;
+  std::vector<uint8_t> buf;
+  if (offset != 0 || size != block_size) {
+    buf.resize(block_size);
+    KATANA_CHECKED(
+        inner_->GetMultiSync(uri, block_start, block_size, buf.data()));
+    std::memcpy(result_buf, buf.data() + offset, size);
+    block_data = buf.data();
+  } else {
+    KATANA_CHECKED(
+        inner_->GetMultiSync(uri, block_start, block_size, result_buf));
+  }
+
+  if (auto res = StoreCached(path, block_data, block_size); !res) {
+    KATANA_LOG_WARN("caching {}: {}", uri, res.error());
+    return katana::ResultSuccess();
+  }
+  Touch(path, block_size);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::CachingStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  auto stat_res = CurrentStat(uri);
+  if (!stat_res || stat_res.value().version.empty() ||
+      start + size > stat_res.value().size) {
+    // nothing to name cached blocks after, or a read the backend must judge
+    return inner_->GetMultiSync(uri, start, size, result_buf);
+  }
+  const StatBuf& stat = stat_res.value();
+
+  uint64_t end = start + size;
+  for (uint64_t pos = start; pos < end;) {
+    uint64_t block = pos / kCacheBlockSize;
+    uint64_t offset = pos - block * kCacheBlockSize;
+    uint64_t len = std::min(end, (block + 1) * kCacheBlockSize) - pos;
+    KATANA_CHECKED_CONTEXT(
+        ReadBlock(uri, stat, block, offset, len, result_buf + (pos - start)),
+        "reading {} at {}", uri, pos);
+    pos += len;
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::CachingStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  return std::async(
+      std::launch::async, [=]() -> katana::CopyableResult<void> {
+        if (auto res = GetMultiSync(uri, start, size, result_buf); !res) {
+          return katana::CopyableErrorInfo{res.error()};
+        }
+        return katana::CopyableResultSuccess();
+      });
+}
+
+katana::Result<void>
+katana::CachingStorage::PutMultiSync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  ForgetStat(uri);
+  auto res = inner_->PutMultiSync(uri, data, size);
+  // a Stat that raced with the write may have seen the old version
+  ForgetStat(uri);
+  return res;
+}
+
+std::future<katana::CopyableResult<void>>
+katana::CachingStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  ForgetStat(uri);
+  return inner_->PutAsync(uri, data, size);
+}
+
+katana::Result<void>
+katana::CachingStorage::RemoteCopy(
+    const std::string& source_uri, const std::string& dest_uri, uint64_t begin,
+    uint64_t size) {
+  ForgetStat(dest_uri);
+  auto res = inner_->RemoteCopy(source_uri, dest_uri, begin, size);
+  ForgetStat(dest_uri);
+  return res;
+}
+
+katana::Result<void>
+katana::CachingStorage::Delete(
+    const std::string& directory,
+    const std::unordered_set<std::string>& files) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (files.empty()) {
+      stats_.clear();
+    }
+    for (const auto& file : files) {
+      stats_.erase(katana::URI::JoinPath(directory, file));
+    }
+  }
+  return inner_->Delete(directory, files);
+}
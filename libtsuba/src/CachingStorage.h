@@ -0,0 +1,141 @@
+#ifndef KATANA_LIBTSUBA_CACHINGSTORAGE_H_
+#define KATANA_LIBTSUBA_CACHINGSTORAGE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "katana/FileStorage.h"
+#include "katana/Result.h"
+#include "katana/file.h"
+
+namespace katana {
+
+/// Keep the bytes read from another FileStorage in a directory on local disk
+/// so that reading them again does not go back to the backend.
+///
+/// Files are cached in aligned blocks of kCacheBlockSize bytes, one local
+/// file per block, and are named after the URI and the version reported by
+/// Stat: when the remote file changes, its old blocks are never read again
+/// and age out. Files whose backend does not report a version are not
+/// cached. When the cache grows beyond its size limit, the least recently
+/// used blocks are removed.
+///
+/// Everything but reads goes straight to the wrapped storage. A failure to
+/// use the cache is never an error; the read is served from the backend.
+class KATANA_EXPORT CachingStorage : public FileStorage {
+public:
+  static constexpr uint64_t kCacheBlockSize = UINT64_C(8) << 20;
+
+  /// How long the result of a Stat is trusted when deciding whether cached
+  /// blocks are current. Loading a file takes one Stat and many reads.
+  static constexpr std::chrono::seconds kStatLifetime{5};
+
+  /// \param inner the storage to cache; it must outlive this object
+  /// \param cache_dir local directory to keep cached blocks in
+  /// \param max_size bound on the bytes of cached blocks
+  CachingStorage(FileStorage* inner, std::string cache_dir, uint64_t max_size)
+      : FileStorage(inner->uri_scheme()),
+        inner_(inner),
+        cache_dir_(std::move(cache_dir)),
+        max_size_(max_size) {}
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override { return inner_->Fini(); }
+  katana::Result<void> Stat(const std::string& uri, StatBuf* s_buf) override;
+
+  uint32_t Priority() const override { return inner_->Priority(); }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+
+  katana::Result<void> RemoteCopy(
+      const std::string& source_uri, const std::string& dest_uri,
+      uint64_t begin, uint64_t size) override;
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string& directory, std::vector<std::string>* list,
+      std::vector<uint64_t>* size) override {
+    return inner_->ListAsync(directory, list, size);
+  }
+  katana::Result<void> Delete(
+      const std::string& directory,
+      const std::unordered_set<std::string>& files) override;
+
+  /// number of blocks read from the cache
+  uint64_t hits() const { return hits_; }
+  /// number of blocks read from the wrapped storage
+  uint64_t misses() const { return misses_; }
+  /// bytes of cached blocks
+  uint64_t cached_size() const;
+
+private:
+  struct Entry {
+    std::list<std::string>::iterator lru_position;
+    uint64_t size;
+  };
+
+  struct RecentStat {
+    StatBuf stat;
+    std::chrono::steady_clock::time_point when;
+  };
+
+  katana::Result<StatBuf> CurrentStat(const std::string& uri);
+  void ForgetStat(const std::string& uri);
+
+  katana::Result<void> ReadBlock(
+      const std::string& uri, const StatBuf& stat, uint64_t block,
+      uint64_t offset, uint64_t size, uint8_t* result_buf);
+
+  std::string BlockPath(
+      const std::string& uri, const std::string& version,
+      uint64_t block) const;
+
+  /// \returns the size of the cached block at \p path if it could be read
+  std::optional<uint64_t> ReadCached(
+      const std::string& path, uint64_t offset, uint64_t size,
+      uint8_t* result_buf);
+  katana::Result<void> StoreCached(
+      const std::string& path, const uint8_t* data, uint64_t size);
+
+  /// Record that the block at \p path, of \p size bytes, was just used
+  void Touch(const std::string& path, uint64_t size);
+  /// Remove least recently used blocks until the cache fits; call with
+  /// mutex_ held
+  void Evict();
+
+  FileStorage* inner_;
+  std::string cache_dir_;
+  uint64_t max_size_;
+
+  mutable std::mutex mutex_;
+  /// most recently used first
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t cached_size_{0};
+  std::unordered_map<std::string, RecentStat> stats_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,107 @@
+#include "ContentAddress.h"
+
+#include <cctype>
+#include <vector>
+
+#include <arrow/util/hashing.h>
+
+#include "katana/file.h"
+
+namespace {
+
+constexpr std::string_view kContentMarker = "-content-";
+constexpr size_t kDigestChars = 32;
+
+/// Append 128 bits of digest of \p size bytes at \p data to \p digests
+void
+AppendDigest(const void* data, int64_t size, std::vector<uint64_t>* digests) {
+  digests->emplace_back(arrow::internal::ComputeStringHash<0>(data, size));
+  digests->emplace_back(arrow::internal::ComputeStringHash<1>(data, size));
+}
+
+/// Digest everything that makes up \p data: its type, shape, buffers,
+/// children and dictionary. Equal digests mean equal contents; equal
+/// contents laid out differently (e.g., one array a slice of a larger one)
+/// may have different digests, which only costs a missed deduplication.
+void
+AppendArrayDigests(
+    const arrow::ArrayData& data, std::vector<uint64_t>* digests) {
+  std::string shape = fmt::format(
+      "{}/{}/{}/{}/{}", data.type->ToString(), data.length, data.offset,
+      data.buffers.size(), data.child_data.size());
+  AppendDigest(shape.data(), shape.size(), digests);
+
+  for (const auto& buffer : data.buffers) {
+    if (!buffer) {
+      digests->emplace_back(0);
+      continue;
+    }
+    digests->emplace_back(buffer->size());
+    AppendDigest(buffer->data(), buffer->size(), digests);
+  }
+  for (const auto& child : data.child_data) {
+    AppendArrayDigests(*child, digests);
+  }
+  if (data.dictionary) {
+    AppendArrayDigests(*data.dictionary, digests);
+  }
+}
+
+}  // namespace
+
+std::string
+katana::ContentAddressedFileName(
+    const std::string& name, std::string_view salt,
+    const arrow::ChunkedArray& array) {
+  std::vector<uint64_t> digests;
+  AppendDigest(name.data(), name.size(), &digests);
+  AppendDigest(salt.data(), salt.size(), &digests);
+  digests.emplace_back(array.length());
+  for (const auto& chunk : array.chunks()) {
+    AppendArrayDigests(*chunk->data(), &digests);
+  }
+
+  int64_t digests_size = digests.size() * sizeof(uint64_t);
+  return fmt::format(
+      "{}{}{:016x}{:016x}", name, kContentMarker,
+      arrow::internal::ComputeStringHash<0>(digests.data(), digests_size),
+      arrow::internal::ComputeStringHash<1>(digests.data(), digests_size));
+}
+
+bool
+katana::IsContentAddressed(std::string_view path) {
+  size_t marker = path.rfind(kContentMarker);
+  if (marker == std::string_view::npos) {
+    return false;
+  }
+  std::string_view digest = path.substr(marker + kContentMarker.size());
+  // files derived from a content addressed file (e.g., its raw column or the
+  // parts of a blocked table) add a suffix after a dot
+  size_t end = digest.find('.');
+  if (end != std::string_view::npos) {
+    digest = digest.substr(0, end);
+  }
+  if (digest.size() != kDigestChars) {
+    return false;
+  }
+  for (char c : digest) {
+    if (!std::isxdigit(static_cast<unsigned char>(c)) ||
+        std::isupper(static_cast<unsigned char>(c))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+katana::Result<bool>
+katana::SameSizeFileExists(const katana::URI& src, const katana::URI& dst) {
+  katana::StatBuf dst_stat;
+  if (auto res = katana::FileStat(dst.string(), &dst_stat); !res) {
+    // whatever the reason, the caller should write dst
+    return false;
+  }
+  katana::StatBuf src_stat;
+  KATANA_CHECKED_CONTEXT(
+      katana::FileStat(src.string(), &src_stat), "stat {}", src);
+  return src_stat.size == dst_stat.size;
+}
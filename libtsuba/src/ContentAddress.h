@@ -0,0 +1,38 @@
+#ifndef KATANA_LIBTSUBA_CONTENTADDRESS_H_
+#define KATANA_LIBTSUBA_CONTENTADDRESS_H_
+
+#include <string>
+#include <string_view>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/URI.h"
+
+namespace katana {
+
+/// Property files are named after what they hold: two stores of the same
+/// values under the same property name, in the same RDG directory, produce
+/// the same file name. A store that finds the file already present skips
+/// encoding and uploading it, and copies of an RDG skip files that the
+/// destination already has.
+///
+/// \param name the property name; it is also the prefix of the file name
+/// \param salt distinguishes files that must never be shared, e.g. node and
+///     edge properties with the same name and contents
+/// \returns a file name (no directory) for \p array
+KATANA_EXPORT std::string ContentAddressedFileName(
+    const std::string& name, std::string_view salt,
+    const arrow::ChunkedArray& array);
+
+/// \returns true if \p path names a content addressed file
+KATANA_EXPORT bool IsContentAddressed(std::string_view path);
+
+/// \returns true if \p dst exists and is the same size as \p src. For
+/// content addressed files this means \p dst already holds \p src
+KATANA_EXPORT katana::Result<bool> SameSizeFileExists(
+    const katana::URI& src, const katana::URI& dst);
+
+}  // namespace katana
+
+#endif
@@ -1,5 +1,10 @@
 #include "katana/EntityTypeManager.h"
 
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 
@@ -39,10 +44,45 @@ katana::EntityTypeManager::CalculateSetOfEntityTypeIDsSize(
   return new_size;
 }
 
-katana::Result<katana::EntityTypeManager::TypeProperties>
+namespace {
+
+/// A uint8 property that is a type
+struct TypeColumn {
+  int field_index;
+  std::shared_ptr<arrow::UInt8Array> array;
+};
+
+/// Rows are scanned this many at a time: every type column is read for a
+/// chunk of rows before the next chunk, so the sets of the chunk stay in cache
+/// while the columns are read sequentially
+constexpr int64_t kTypeSetChunkSize = 1024;
+
+struct TypeSetHash {
+  size_t operator()(const katana::SmallDynamicBitset& set) const {
+    const uint64_t* words = set.words();
+    uint64_t hash = set.size();
+    for (size_t i = 0, n = set.num_words(); i < n; ++i) {
+      hash = (hash ^ words[i]) * 0x9e3779b97f4a7c15;
+      hash ^= hash >> 29;
+    }
+    return hash;
+  }
+};
+
+/// The distinct sets of type columns of the rows of one thread, and the
+/// EntityTypeID of each set once the types are added
+struct ThreadTypeSets {
+  std::unordered_map<katana::SmallDynamicBitset, uint32_t, TypeSetHash> index;
+  std::vector<katana::SmallDynamicBitset> sets;
+  std::vector<katana::EntityTypeID> ids;
+};
+
+}  // namespace
+
+katana::Result<std::vector<std::string>>
 katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
     const std::shared_ptr<arrow::Table>& properties,
-    EntityTypeManager* entity_type_manager) {
+    EntityTypeManager* entity_type_manager, EntityTypeID* entity_type_ids) {
   // throw an error if each column/property has more than 1 chunk
   for (int i = 0, n = properties->num_columns(); i < n; i++) {
     std::shared_ptr<arrow::ChunkedArray> property = properties->column(i);
@@ -55,70 +95,102 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
   }
 
   // collect the list of types
-  TypeProperties type_properties;
-  TypeProperties::FieldEntity type_field_indices;
+  std::vector<TypeColumn> type_columns;
   const std::shared_ptr<arrow::Schema>& schema = properties->schema();
 
   KATANA_LOG_DEBUG_ASSERT(schema->num_fields() == properties->num_columns());
   for (int i = 0, n = schema->num_fields(); i < n; i++) {
-    const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
-
     // a uint8 property is (always) considered a type
-    if (current_field->type()->Equals(arrow::uint8())) {
-      type_field_indices.push_back(i);
-      KATANA_LOG_DEBUG_ASSERT(properties->column(i)->num_chunks() == 1);
-      std::shared_ptr<arrow::Array> property = properties->column(i)->chunk(0);
-      auto uint8_property =
-          std::static_pointer_cast<arrow::UInt8Array>(property);
-      type_properties.uint8_properties.emplace_back(i, uint8_property);
+    if (schema->field(i)->type()->Equals(arrow::uint8())) {
+      type_columns.emplace_back(TypeColumn{
+          i, std::static_pointer_cast<arrow::UInt8Array>(
+                 properties->column(i)->chunk(0))});
     }
   }
 
   // assign a new ID to each type
+  std::vector<std::string> properties_used;
+  std::vector<katana::EntityTypeID> column_type_ids;
+  for (const auto& column : type_columns) {
+    const std::string& field_name = schema->field(column.field_index)->name();
+    column_type_ids.emplace_back(
+        KATANA_CHECKED(entity_type_manager->AddAtomicEntityType(field_name)));
+    properties_used.emplace_back(field_name);
+  }
+
+  // Each thread collects the distinct sets of types of its block of rows and
+  // writes the index of the set of each row in place of its EntityTypeID
+  int64_t num_rows = properties->num_rows();
+  size_t num_type_columns = type_columns.size();
+  katana::PerThreadStorage<ThreadTypeSets> thread_sets;
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(int64_t{0}, num_rows, tid, total);
+    ThreadTypeSets& local = *thread_sets.getLocal();
+    std::vector<katana::SmallDynamicBitset> chunk(kTypeSetChunkSize);
+    for (auto& set : chunk) {
+      set.resize(num_type_columns);
+    }
+
+    for (int64_t chunk_begin = begin; chunk_begin < end;
+         chunk_begin += kTypeSetChunkSize) {
+      int64_t chunk_end = std::min(chunk_begin + kTypeSetChunkSize, end);
+      for (size_t c = 0; c < num_type_columns; ++c) {
+        const arrow::UInt8Array& array = *type_columns[c].array;
+        for (int64_t row = chunk_begin; row < chunk_end; ++row) {
+          if (array.IsValid(row) && array.Value(row)) {
+            chunk[row - chunk_begin].set(c);
+          }
+        }
+      }
+      for (int64_t row = chunk_begin; row < chunk_end; ++row) {
+        katana::SmallDynamicBitset& set = chunk[row - chunk_begin];
+        auto [it, inserted] = local.index.try_emplace(set, local.sets.size());
+        if (inserted) {
+          local.sets.emplace_back(set);
+        }
+        // an index that does not fit is caught when the sets are merged
+        entity_type_ids[row] = static_cast<katana::EntityTypeID>(it->second);
+        set.reset();
+      }
+    }
+  });
+
+  auto field_indices_of = [&type_columns](const SmallDynamicBitset& set) {
+    std::vector<int> field_indices;
+    for (auto c : set) {
+      field_indices.emplace_back(type_columns[c].field_index);
+    }
+    return field_indices;
+  };
+
+  // Combinations of types are ordered by their field indices, so their ids
+  // do not depend on how the rows were split between threads.
   // NB: cannot use unordered_map without defining a hash function for vectors;
   // performance is not affected here because the map is very small (<=256)
-  for (int i : type_field_indices) {
-    const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
-    const std::string& field_name = current_field->name();
-    katana::EntityTypeID new_entity_type_id =
-        KATANA_CHECKED(entity_type_manager->AddAtomicEntityType(field_name));
-
-    std::vector<int> field_indices = {i};
-    type_properties.type_field_indices_to_id.emplace(
-        field_indices, new_entity_type_id);
-  }
-
-  // NB: cannot use unordered_set without defining a hash function for vectors;
-  // performance is not affected here because the set is very small (<=256)
-  using FieldEntityTypeSet = std::set<TypeProperties::FieldEntity>;
-  FieldEntityTypeSet type_combinations;
-  for (int64_t row = 0, num_rows = properties->num_rows(); row < num_rows;
-       ++row) {
-    TypeProperties::FieldEntity field_indices;
-    for (auto uint8_property : type_properties.uint8_properties) {
-      if (uint8_property.array->IsValid(row) &&
-          uint8_property.array->Value(row)) {
-        field_indices.emplace_back(uint8_property.field_index);
-      }
+  std::map<std::vector<int>, katana::EntityTypeID> combination_ids;
+  for (const ThreadTypeSets& local : thread_sets) {
+    if (local.sets.size() > kInvalidEntityType) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented,
+          "found more than {} unique combinations of types",
+          kInvalidEntityType);
     }
-    if (field_indices.size() > 1) {
-      type_combinations.emplace(field_indices);
+    for (const auto& set : local.sets) {
+      if (set.count() > 1) {
+        combination_ids.emplace(field_indices_of(set), kUnknownEntityType);
+      }
     }
   }
 
   // assign a new ID to each unique combination of types
-  for (const TypeProperties::FieldEntity& field_indices : type_combinations) {
+  for (auto& [field_indices, new_entity_type_id] : combination_ids) {
     std::vector<std::string> field_names;
     for (int i : field_indices) {
-      const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
-      const std::string& field_name = current_field->name();
-      field_names.emplace_back(field_name);
+      field_names.emplace_back(schema->field(i)->name());
     }
-    katana::EntityTypeID new_entity_type_id = KATANA_CHECKED(
+    new_entity_type_id = KATANA_CHECKED(
         entity_type_manager->AddNonAtomicEntityType(KATANA_CHECKED(
             entity_type_manager->template GetOrAddEntityTypeIDs(field_names))));
-    type_properties.type_field_indices_to_id.emplace(
-        field_indices, new_entity_type_id);
   }
 
   // assert that all type IDs (including kUnknownEntityType) and
@@ -136,7 +208,32 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
         std::numeric_limits<katana::EntityTypeID>::max() - 2);
   }
 
-  return type_properties;
+  for (ThreadTypeSets& local : thread_sets) {
+    local.ids.reserve(local.sets.size());
+    for (const auto& set : local.sets) {
+      switch (set.count()) {
+      case 0:
+        local.ids.emplace_back(katana::kUnknownEntityType);
+        break;
+      case 1:
+        local.ids.emplace_back(column_type_ids[*set.begin()]);
+        break;
+      default:
+        local.ids.emplace_back(combination_ids.at(field_indices_of(set)));
+      }
+    }
+  }
+
+  // the same split of the rows maps each index to the EntityTypeID of its set
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(int64_t{0}, num_rows, tid, total);
+    const std::vector<katana::EntityTypeID>& ids = thread_sets.getLocal()->ids;
+    for (int64_t row = begin; row < end; ++row) {
+      entity_type_ids[row] = ids[entity_type_ids[row]];
+    }
+  });
+
+  return properties_used;
 }
 
 katana::Result<katana::EntityTypeID>
@@ -163,12 +260,9 @@ katana::EntityTypeManager::AddNonAtomicEntityType(
         std::move(empty_set));
   }
 
-  for (size_t atomic_entity_type_id = 0;
-       atomic_entity_type_id < type_id_set.size(); ++atomic_entity_type_id) {
-    if (type_id_set.test(atomic_entity_type_id)) {
-      atomic_entity_type_id_to_entity_type_ids_.at(atomic_entity_type_id)
-          .set(new_entity_type_id);
-    }
+  for (auto atomic_entity_type_id : type_id_set) {
+    atomic_entity_type_id_to_entity_type_ids_.at(atomic_entity_type_id)
+        .set(new_entity_type_id);
   }
 
   // Ideally this would return an error instead of failing. But checking is
@@ -47,6 +47,41 @@ katana::FileFrame::Init(uint64_t reserved_size) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileFrame::InitForParallelFill(uint64_t size) {
+  uint64_t map_size = katana::RoundUpToBlock(size == 0 ? 1 : size);
+  void* ptr = mmap(
+      nullptr, map_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
+      -1, 0);
+  if (ptr == MAP_FAILED) {
+    return KATANA_ERROR(katana::ResultErrno(), "mapping buffer");
+  }
+  KATANA_CHECKED(Destroy());
+
+  path_ = "";
+  map_size_ = map_size;
+  map_start_ = static_cast<uint8_t*>(ptr);
+  synced_ = false;
+  valid_ = true;
+  cursor_ = size;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FileFrame::WriteAt(uint64_t offset, const void* data, uint64_t nbytes) {
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "invalid FileFrame");
+  }
+  if (offset > map_size_ || nbytes > map_size_ - offset) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "write of {} bytes at {} is past the end of the {} byte buffer",
+        nbytes, offset, map_size_);
+  }
+  memcpy(map_start_ + offset, data, nbytes);
+  return katana::ResultSuccess();
+}
+
 void
 katana::FileFrame::Bind(std::string_view filename) {
   path_ = filename;
@@ -1,8 +1,11 @@
 #include "katana/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <string>
@@ -56,8 +59,12 @@ katana::FileView::Unbind() {
     filename_ = "";
     filling_ = std::vector<uint64_t>();
     KATANA_LOG_DEBUG_ASSERT(fetches_->empty());
+    last_read_end_ = -1;
+    read_ahead_ = 0;
+    advice_.clear();
 
     bound_ = false;
+    file_backed_ = false;
   }
   return katana::ResultSuccess();
 }
@@ -113,6 +120,64 @@ katana::FileView::Bind(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileView::BindMapped(std::string_view filename) {
+  std::string path(filename);
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    auto err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "stat {}", path);
+  }
+  uint64_t size = st.st_size;
+
+  // PROT_WRITE with MAP_PRIVATE lets callers update the data in place (e.g.,
+  // sorting edges) by copying on write while untouched pages stay shared
+  void* tmp = nullptr;
+  if (size > 0) {
+    tmp = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (tmp == MAP_FAILED) {
+      auto err = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(err, "mapping {} ({} bytes)", path, size);
+    }
+#ifdef MADV_HUGEPAGE
+    // files on a tmpfs mounted with huge=advise, e.g., shared graphs in
+    // /dev/shm, are then backed by huge pages; not fatal elsewhere
+    madvise(tmp, size, MADV_HUGEPAGE);
+#endif
+  }
+  // the mapping keeps its own reference to the file
+  close(fd);
+
+  if (auto res = Unbind(); !res) {
+    if (tmp != nullptr) {
+      munmap(tmp, size);
+    }
+    return res.error();
+  }
+
+  page_shift_ = 20; /* 1M */
+  map_start_ = static_cast<uint8_t*>(tmp);
+  mem_start_ = 0;
+  file_size_ = size;
+  filename_ = path;
+  // every page is already present so Fill never has anything to do
+  filling_.clear();
+  filling_.resize(page_number(size) / 64 + 1, ~UINT64_C(0));
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+
+  cursor_ = 0;
+  bound_ = true;
+  file_backed_ = true;
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   uint64_t in_end = std::min<uint64_t>(end, file_size_);
@@ -166,6 +231,62 @@ katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileView::Advise(uint64_t begin, uint64_t end, AccessPattern pattern) {
+  if (!bound_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  uint64_t in_end = std::min<uint64_t>(end, file_size_);
+  uint64_t in_begin = std::min<uint64_t>(begin, in_end);
+  if (in_begin == in_end) {
+    return katana::ResultSuccess();
+  }
+  advice_.emplace_back(AdvisedRange{in_begin, in_end, pattern});
+
+  if (file_backed_) {
+    int advice = MADV_NORMAL;
+    switch (pattern) {
+    case AccessPattern::kSequential:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case AccessPattern::kRandom:
+      advice = MADV_RANDOM;
+      break;
+    case AccessPattern::kWillNeed:
+      advice = MADV_WILLNEED;
+      break;
+    default:
+      break;
+    }
+    // madvise wants a page aligned start
+    uint64_t page = sysconf(_SC_PAGESIZE);
+    uint64_t aligned_begin = in_begin / page * page;
+    if (madvise(map_start_ + aligned_begin, in_end - aligned_begin, advice)) {
+      return KATANA_ERROR(katana::ResultErrno(), "advising mapping");
+    }
+    return katana::ResultSuccess();
+  }
+
+  switch (pattern) {
+  case AccessPattern::kSequential:
+    return Fill(in_begin, std::min(in_end, in_begin + kMaxReadAhead), false);
+  case AccessPattern::kWillNeed:
+    return Fill(in_begin, in_end, false);
+  default:
+    return katana::ResultSuccess();
+  }
+}
+
+katana::FileView::AccessPattern
+katana::FileView::AdvisedPattern(uint64_t offset) const {
+  for (auto it = advice_.rbegin(); it != advice_.rend(); ++it) {
+    if (it->begin <= offset && offset < it->end) {
+      return it->pattern;
+    }
+  }
+  return AccessPattern::kNormal;
+}
+
 bool
 katana::FileView::Equals(const FileView& other) const {
   if (!bound_ || !other.bound_) {
@@ -480,13 +601,53 @@ katana::FileView::Resolve(int64_t start, int64_t size) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileView::WaitForFills() {
+  if (!fetches_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
+  }
+  katana::Result<void> res = katana::ResultSuccess();
+  for (auto& fetch : *fetches_) {
+    if (!fetch.work.valid()) {
+      continue;
+    }
+    // wait for all of them even after an error; their buffers are ours
+    if (auto fetch_res = fetch.work.get(); !fetch_res && res) {
+      res = fetch_res.error();
+    }
+  }
+  fetches_->clear();
+  return res;
+}
+
 katana::Result<void>
 katana::FileView::PreFetch(int64_t start, int64_t size) {
-  // Our highly sophisticated prefetching algorithm is to crudely approximate
-  // the size of the last read plus 10%. This is largely motivated by parquet
-  // files, which consecutively read row groups that are (in theory)
-  // approximately the same size.
+  bool sequential = start == last_read_end_;
+  last_read_end_ = start + size;
+
+  AccessPattern pattern = AdvisedPattern(start);
+  if (pattern == AccessPattern::kRandom) {
+    read_ahead_ = 0;
+    return katana::ResultSuccess();
+  }
+
+  // Without a run of reads, our highly sophisticated prefetching algorithm
+  // is to crudely approximate the size of the last read plus 10%. This is
+  // largely motivated by parquet files, which consecutively read row groups
+  // that are (in theory) approximately the same size.
   int64_t fetch_size = (size / 10) * 11;
+  // Reads that continue where the previous one ended, e.g., a scan over a
+  // topology array, read ahead twice as far each time, and advised
+  // sequential ranges read ahead as far as possible right away
+  if (pattern == AccessPattern::kSequential) {
+    read_ahead_ = kMaxReadAhead;
+  } else if (sequential) {
+    read_ahead_ = std::min<int64_t>(
+        std::max(read_ahead_ * 2, fetch_size), kMaxReadAhead);
+  } else {
+    read_ahead_ = 0;
+  }
+  fetch_size = std::max(fetch_size, read_ahead_);
   // Make sure we haven't overflown
   KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
   uint64_t begin = static_cast<uint64_t>(start + size);
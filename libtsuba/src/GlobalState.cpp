@@ -2,11 +2,20 @@
 
 #include <algorithm>
 #include <cassert>
+#include <string>
 
 #include "FileStorage_internal.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
+
+namespace {
+
+constexpr int kDefaultCacheSizeMB = 64 << 10;
+
+}  // namespace
 
 std::unique_ptr<katana::GlobalState> katana::GlobalState::ref_ = nullptr;
 
@@ -32,6 +41,30 @@ katana::GlobalState::FS(std::string_view uri) const {
   return GetDefaultFS();
 }
 
+void
+katana::GlobalState::AddCaches() {
+  std::string cache_dir;
+  if (!katana::GetEnv("KATANA_STORAGE_CACHE_DIR", &cache_dir) ||
+      cache_dir.empty()) {
+    return;
+  }
+  int size_mb = kDefaultCacheSizeMB;
+  katana::GetEnv("KATANA_STORAGE_CACHE_SIZE_MB", &size_mb);
+  uint64_t max_size = static_cast<uint64_t>(std::max(size_mb, 0)) << 20;
+
+  for (FileStorage*& fs : file_stores_) {
+    if (fs == &local_storage_) {
+      continue;
+    }
+    // each backend has its own directory, limited separately
+    std::string_view scheme = fs->uri_scheme();
+    scheme = scheme.substr(0, scheme.find(':'));
+    caches_.emplace_back(std::make_unique<CachingStorage>(
+        fs, katana::URI::JoinPath(cache_dir, std::string(scheme)), max_size));
+    fs = caches_.back().get();
+  }
+}
+
 katana::Result<void>
 katana::GlobalState::Init(katana::CommBackend* comm) {
   KATANA_LOG_DEBUG_ASSERT(ref_ == nullptr);
@@ -40,10 +73,18 @@ katana::GlobalState::Init(katana::CommBackend* comm) {
   std::unique_ptr<GlobalState> global_state(new GlobalState(comm));
 
   std::vector<FileStorage*>& registered = GetRegisteredFileStorages();
+  bool has_s3 = false;
   for (FileStorage* fs : registered) {
     global_state->file_stores_.emplace_back(fs);
+    has_s3 =
+        has_s3 || fs->uri_scheme() == global_state->s3_storage_.uri_scheme();
   }
   registered.clear();
+  if (!has_s3) {
+    global_state->file_stores_.emplace_back(&global_state->s3_storage_);
+  }
+
+  global_state->AddCaches();
 
   std::sort(
       global_state->file_stores_.begin(), global_state->file_stores_.end(),
@@ -4,7 +4,9 @@
 #include <memory>
 #include <vector>
 
+#include "CachingStorage.h"
 #include "LocalStorage.h"
+#include "S3Storage.h"
 #include "katana/CommBackend.h"
 #include "katana/FileStorage.h"
 #include "katana/Logging.h"
@@ -19,6 +21,9 @@ class GlobalState {
   katana::CommBackend* comm_;
 
   katana::LocalStorage local_storage_;
+  /// Used for s3:// URIs unless a plugin registered a backend for them
+  katana::S3Storage s3_storage_;
+  std::vector<std::unique_ptr<CachingStorage>> caches_;
 
   GlobalState(katana::CommBackend* comm) : comm_(comm) {
     file_stores_.emplace_back(&local_storage_);
@@ -26,6 +31,11 @@ class GlobalState {
 
   FileStorage* GetDefaultFS() const;
 
+  /// If KATANA_STORAGE_CACHE_DIR is set, keep what is read from remote
+  /// backends in that local directory, up to KATANA_STORAGE_CACHE_SIZE_MB
+  /// megabytes per backend
+  void AddCaches();
+
 public:
   GlobalState(const GlobalState& no_copy) = delete;
   GlobalState(const GlobalState&& no_move) = delete;
@@ -0,0 +1,49 @@
+#include "IOQueue.h"
+
+#include <algorithm>
+
+katana::IOQueue::IOQueue(uint32_t depth) {
+  for (uint32_t i = 0; i < std::max<uint32_t>(depth, 1); ++i) {
+    workers_.emplace_back([this]() { Work(); });
+  }
+}
+
+katana::IOQueue::~IOQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<katana::CopyableResult<void>>
+katana::IOQueue::Submit(std::function<katana::CopyableResult<void>()> op) {
+  std::packaged_task<katana::CopyableResult<void>()> task(std::move(op));
+  auto future = task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ops_.emplace_back(std::move(task));
+  }
+  cv_.notify_one();
+  return future;
+}
+
+void
+katana::IOQueue::Work() {
+  for (;;) {
+    std::packaged_task<katana::CopyableResult<void>()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !ops_.empty(); });
+      if (ops_.empty()) {
+        return;
+      }
+      task = std::move(ops_.front());
+      ops_.pop_front();
+    }
+    task();
+  }
+}
@@ -0,0 +1,45 @@
+#ifndef KATANA_LIBTSUBA_IOQUEUE_H_
+#define KATANA_LIBTSUBA_IOQUEUE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "katana/Result.h"
+
+namespace katana {
+
+/// Run blocking I/O operations on a fixed set of threads so that up to
+/// depth of them are in flight at once, whoever submits them. Operations
+/// must not wait on other operations of the same queue.
+class IOQueue {
+public:
+  explicit IOQueue(uint32_t depth);
+  IOQueue(const IOQueue& no_copy) = delete;
+  IOQueue& operator=(const IOQueue& no_copy) = delete;
+  /// Waits for the operations already submitted
+  ~IOQueue();
+
+  uint32_t depth() const { return static_cast<uint32_t>(workers_.size()); }
+
+  std::future<katana::CopyableResult<void>> Submit(
+      std::function<katana::CopyableResult<void>()> op);
+
+private:
+  void Work();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::packaged_task<katana::CopyableResult<void>()>> ops_;
+  bool stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace katana
+
+#endif
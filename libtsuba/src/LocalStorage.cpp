@@ -7,7 +7,9 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <iterator>
 #include <system_error>
 
@@ -15,6 +17,7 @@
 #include <boost/system/error_code.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -47,24 +50,170 @@ GetPath(const std::string& uri) {
   return u.path();
 }
 
+/// Closes its file when the last piece of an operation is done with it
+struct OpenFile {
+  explicit OpenFile(int fd_) : fd(fd_) {}
+  OpenFile(const OpenFile& no_copy) = delete;
+  OpenFile& operator=(const OpenFile& no_copy) = delete;
+  ~OpenFile() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  int fd;
+};
+
+std::future<katana::CopyableResult<void>>
+MakeReady(katana::CopyableResult<void> res) {
+  std::promise<katana::CopyableResult<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
+bool
+IsAligned(uint64_t val) {
+  return (val & katana::kBlockOffsetMask) == 0;
+}
+
+/// Read up to \p size bytes, stopping early only at the end of the file
+katana::CopyableResult<void>
+ReadPiece(int fd, uint64_t offset, uint64_t size, uint8_t* data) {
+  while (size > 0) {
+    ssize_t got = pread(fd, data, size, offset);
+    if (got == 0) {
+      break;
+    }
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "failed to read: {}",
+          katana::ResultErrno().message());
+    }
+    data += got;
+    offset += got;
+    size -= got;
+  }
+  return katana::CopyableResultSuccess();
+}
+
+katana::CopyableResult<void>
+WritePiece(int fd, uint64_t offset, uint64_t size, const uint8_t* data) {
+  while (size > 0) {
+    ssize_t put = pwrite(fd, data, size, offset);
+    if (put < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "writing file: {}",
+          katana::ResultErrno().message());
+    }
+    data += put;
+    offset += put;
+    size -= put;
+  }
+  return katana::CopyableResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
+katana::LocalStorage::Init() {
+  int depth = kDefaultQueueDepth;
+  katana::GetEnv("KATANA_LOCAL_STORAGE_QUEUE_DEPTH", &depth);
+  katana::GetEnv("KATANA_LOCAL_STORAGE_DIRECT_IO", &direct_io_);
+  queue_ = std::make_unique<IOQueue>(std::max(depth, 1));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::LocalStorage::Fini() {
+  queue_.reset();
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalStorage::RunPieces(
+    std::vector<std::function<katana::CopyableResult<void>()>> pieces) {
+  if (!queue_ || pieces.size() <= 1) {
+    // not initialized, or nothing to overlap with: do the work when asked
+    return std::async(
+        std::launch::deferred,
+        [pieces = std::move(pieces)]() -> katana::CopyableResult<void> {
+          for (const auto& piece : pieces) {
+            if (auto res = piece(); !res) {
+              return res;
+            }
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  futures.reserve(pieces.size());
+  for (auto& piece : pieces) {
+    futures.emplace_back(queue_->Submit(std::move(piece)));
+  }
+  return std::async(
+      std::launch::deferred,
+      [futures = std::move(futures)]() mutable -> katana::CopyableResult<void> {
+        katana::CopyableResult<void> res = katana::CopyableResultSuccess();
+        for (auto& future : futures) {
+          if (auto piece_res = future.get(); !piece_res && res) {
+            res = std::move(piece_res);
+          }
+        }
+        return res;
+      });
+}
+
+std::future<katana::CopyableResult<void>>
 katana::LocalStorage::WriteFile(
     const std::string& uri, const uint8_t* data, uint64_t size) {
-  std::string path = KATANA_CHECKED(GetPath(uri));
-  KATANA_CHECKED(EnsureDirectories(path));
+  auto path_res = GetPath(uri);
+  if (!path_res) {
+    return MakeReady(katana::CopyableErrorInfo{path_res.error()});
+  }
+  std::string path = std::move(path_res.value());
+  if (auto res = EnsureDirectories(path); !res) {
+    return MakeReady(katana::CopyableErrorInfo{res.error()});
+  }
 
-  std::ofstream ofile(path);
-  if (!ofile.good()) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "opening file: {}", strerror(errno));
+  auto file = std::make_shared<OpenFile>(
+      open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666));
+  if (file->fd < 0) {
+    return MakeReady(KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening file: {}",
+        katana::ResultErrno().message()));
   }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+
+  // the whole blocks at the front go around the page cache, the rest
+  // through it
+  uint64_t direct_size = 0;
+  std::shared_ptr<OpenFile> direct_file;
+  if (direct_io_ && IsAligned(reinterpret_cast<uintptr_t>(data))) {
+    direct_file =
+        std::make_shared<OpenFile>(open(path.c_str(), O_WRONLY | O_DIRECT));
+    if (direct_file->fd >= 0) {
+      direct_size = size & kBlockMask;
+    }
   }
-  return katana::ResultSuccess();
+
+  std::vector<std::function<katana::CopyableResult<void>()>> pieces;
+  auto add_pieces = [&](const std::shared_ptr<OpenFile>& piece_file,
+                        uint64_t begin, uint64_t end) {
+    for (uint64_t off = begin; off < end; off += kIOChunkSize) {
+      uint64_t len = std::min(kIOChunkSize, end - off);
+      pieces.emplace_back([piece_file, off, len, data]() {
+        return WritePiece(piece_file->fd, off, len, data + off);
+      });
+    }
+  };
+  add_pieces(direct_file, 0, direct_size);
+  add_pieces(file, direct_size, size);
+  return RunPieces(std::move(pieces));
 }
 
 katana::Result<void>
@@ -95,33 +244,68 @@ katana::LocalStorage::RemoteCopyFile(
   return katana::ResultSuccess();
 }
 
-katana::Result<void>
+std::future<katana::CopyableResult<void>>
 katana::LocalStorage::ReadFile(
     const std::string& uri, uint64_t start, uint64_t size, uint8_t* data) {
-  std::string path = KATANA_CHECKED(GetPath(uri));
-  std::ifstream ifile(path, std::ios_base::binary);
-  if (!ifile) {
-    return KATANA_ERROR(
+  auto path_res = GetPath(uri);
+  if (!path_res) {
+    return MakeReady(katana::CopyableErrorInfo{path_res.error()});
+  }
+  std::string path = std::move(path_res.value());
+
+  bool direct = direct_io_ && IsAligned(start) && IsAligned(size) &&
+                IsAligned(reinterpret_cast<uintptr_t>(data));
+  int fd = direct ? open(path.c_str(), O_RDONLY | O_DIRECT) : -1;
+  if (fd < 0) {
+    // not all file systems support O_DIRECT
+    fd = open(path.c_str(), O_RDONLY);
+  }
+  auto file = std::make_shared<OpenFile>(fd);
+  if (file->fd < 0) {
+    return MakeReady(KATANA_ERROR(
         ErrorCode::LocalStorageError, "failed to open source file {}",
-        std::quoted(path));
+        std::quoted(path)));
   }
 
-  ifile.seekg(start);
-  if (!ifile) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to seek to offset {}", start);
+  // if the difference in what is there from what we wanted is less than a
+  // block it's because the file size isn't well aligned so don't complain.
+  struct stat local_s_buf;
+  if (fstat(file->fd, &local_s_buf) != 0) {
+    return MakeReady(KATANA_ERROR(
+        ErrorCode::LocalStorageError, "stat {}: {}", std::quoted(path),
+        katana::ResultErrno().message()));
   }
-
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
+  uint64_t file_size = local_s_buf.st_size;
+  uint64_t available = start < file_size ? file_size - start : 0;
+  if (size > available && size - available > kBlockSize) {
+    return MakeReady(KATANA_ERROR(
+        ErrorCode::LocalStorageError,
+        "failed to read {} bytes at offset {} of {} ({} bytes)", size, start,
+        std::quoted(path), file_size));
   }
 
-  // if the difference in what was read from what we wanted is less  than a
-  // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
-    return ErrorCode::LocalStorageError;
+  std::vector<std::function<katana::CopyableResult<void>()>> pieces;
+  for (uint64_t off = 0; off < size || pieces.empty(); off += kIOChunkSize) {
+    uint64_t len = std::min(kIOChunkSize, size - off);
+    pieces.emplace_back([file, start, off, len, data]() {
+      return ReadPiece(file->fd, start + off, len, data + off);
+    });
   }
+  return RunPieces(std::move(pieces));
+}
+
+katana::Result<void>
+katana::LocalStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  KATANA_CHECKED(ReadFile(uri, start, size, result_buf).get());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::LocalStorage::PutMultiSync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  KATANA_CHECKED(WriteFile(uri, data, size).get());
   return katana::ResultSuccess();
 }
 
@@ -134,6 +318,8 @@ katana::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
     return katana::ResultErrno();
   }
   s_buf->size = local_s_buf.st_size;
+  s_buf->version = fmt::format(
+      "{}.{:09}", local_s_buf.st_mtim.tv_sec, local_s_buf.st_mtim.tv_nsec);
   return katana::ResultSuccess();
 }
 
@@ -4,45 +4,63 @@
 #include <sys/mman.h>
 
 #include <cstdint>
+#include <functional>
 #include <future>
+#include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "IOQueue.h"
 #include "katana/FileStorage.h"
 #include "katana/Result.h"
 
 namespace katana {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system
+///
+/// Reads and writes are split into pieces of at most kIOChunkSize bytes that
+/// are issued from a pool of threads, so that a device with many queues
+/// (e.g., NVMe) sees up to queue depth requests at once.
+/// KATANA_LOCAL_STORAGE_QUEUE_DEPTH sets the depth. With
+/// KATANA_LOCAL_STORAGE_DIRECT_IO set, operations whose buffer, offset and
+/// size are multiples of kBlockSize bypass the page cache.
 class LocalStorage : public FileStorage {
-  katana::Result<void> WriteFile(
+  std::future<katana::CopyableResult<void>> WriteFile(
       const std::string&, const uint8_t* data, uint64_t size);
-  katana::Result<void> ReadFile(
+  std::future<katana::CopyableResult<void>> ReadFile(
       const std::string& uri, uint64_t start, uint64_t size, uint8_t* data);
   katana::Result<void> RemoteCopyFile(
       const std::string& source_uri, const std::string& dest_uri,
       uint64_t begin, uint64_t size);
 
+  /// Run \p pieces on the queue; the returned future is ready when they all
+  /// are and holds the first error
+  std::future<katana::CopyableResult<void>> RunPieces(
+      std::vector<std::function<katana::CopyableResult<void>()>> pieces);
+
+  std::unique_ptr<IOQueue> queue_;
+  bool direct_io_{false};
+
 public:
+  /// bytes handed to a single read or write call
+  static constexpr uint64_t kIOChunkSize = UINT64_C(4) << 20;
+  static constexpr uint32_t kDefaultQueueDepth = 16;
+
   LocalStorage() : FileStorage("file://") {}
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
   katana::Result<void> Stat(const std::string& uri, StatBuf* s_buf) override;
 
   uint32_t Priority() const override { return 1; }
 
   katana::Result<void> GetMultiSync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    return ReadFile(uri, start, size, result_buf);
-  }
+      uint8_t* result_buf) override;
 
   katana::Result<void> PutMultiSync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    return WriteFile(uri, data, size);
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
 
   katana::Result<void> RemoteCopy(
       const std::string& source_uri, const std::string& dest_uri,
@@ -53,32 +71,12 @@ public:
   // get on future can potentially block (bulk synchronous parallel)
   std::future<katana::CopyableResult<void>> PutAsync(
       const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      katana::CopyableErrorInfo cei{write_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
+    return WriteFile(uri, data, size);
   }
   std::future<katana::CopyableResult<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
       uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      katana::CopyableErrorInfo cei{read_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
+    return ReadFile(uri, start, size, result_buf);
   }
   std::future<katana::CopyableResult<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
@@ -1,15 +1,21 @@
 #include "katana/ParquetReader.h"
 
+#include <algorithm>
+#include <future>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <numeric>
+#include <thread>
 
+#include <arrow/array/array_dict.h>
 #include <arrow/array/util.h>
 #include <arrow/chunked_array.h>
 #include <arrow/compute/cast.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <parquet/arrow/reader.h>
 #include <parquet/arrow/schema.h>
+#include <parquet/metadata.h>
 
 #include "katana/ErrorCode.h"
 #include "katana/FileView.h"
@@ -39,6 +45,12 @@ HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
         KATANA_CHECKED(arrow::compute::Cast(old_array, opts));
     return cast_res.chunked_array();
   }
+  case arrow::Type::type::DICTIONARY: {
+    // Row groups may have different dictionaries; give every chunk the same
+    // one so that codes mean the same thing throughout the column
+    return KATANA_CHECKED(arrow::DictionaryUnifier::UnifyChunkedArray(
+        old_array, arrow::default_memory_pool()));
+  }
   default:
     return old_array;
   }
@@ -74,38 +86,149 @@ BuildReader(
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
+/// Append the indexes of the leaf columns under \p field to \p leaves
+void
+CollectLeaves(
+    const parquet::arrow::SchemaField& field, std::vector<int>* leaves) {
+  if (field.is_leaf()) {
+    leaves->emplace_back(field.column_index);
+    return;
+  }
+  for (const auto& child : field.children) {
+    CollectLeaves(child, leaves);
+  }
+}
+
+/// \returns the byte range of the file that holds the column chunk of
+/// \p column in \p row_group
+std::pair<uint64_t, uint64_t>
+ColumnChunkRange(const parquet::RowGroupMetaData& row_group, int column) {
+  auto chunk = row_group.ColumnChunk(column);
+  int64_t begin = chunk->data_page_offset();
+  // some writers record a dictionary offset of 0 when there is no dictionary
+  if (chunk->has_dictionary_page() && chunk->dictionary_page_offset() > 0 &&
+      chunk->dictionary_page_offset() < begin) {
+    begin = chunk->dictionary_page_offset();
+  }
+  return {begin, begin + chunk->total_compressed_size()};
+}
+
+/// Read \p row_groups of the file behind \p reader as one table.
+///
+/// Only the column chunks that are needed are fetched: every byte range is
+/// requested before any is waited on so the fetches overlap, and the row
+/// groups are then decoded concurrently.
+///
+/// \param fields the top level fields to read, sorted and without
+///     duplicates; if empty, every field is read
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroups(
+    parquet::arrow::FileReader* reader, katana::FileView* fv,
+    const std::vector<int>& row_groups, const std::vector<int>& fields) {
+  std::vector<int> leaves;
+  for (int field : fields) {
+    CollectLeaves(reader->manifest().schema_fields[field], &leaves);
+  }
+
+  if (row_groups.empty()) {
+    std::shared_ptr<arrow::Schema> schema;
+    KATANA_CHECKED(reader->GetSchema(&schema));
+    if (!fields.empty()) {
+      std::vector<std::shared_ptr<arrow::Field>> selected;
+      for (int field : fields) {
+        selected.emplace_back(schema->field(field));
+      }
+      schema = arrow::schema(selected);
+    }
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
+    for (const auto& field : schema->fields()) {
+      cols.emplace_back(std::make_shared<arrow::ChunkedArray>(
+          KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), 0))));
+    }
+    return arrow::Table::Make(schema, cols);
+  }
+
+  auto metadata = reader->parquet_reader()->metadata();
+  for (int row_group : row_groups) {
+    auto rg_md = metadata->RowGroup(row_group);
+    if (fields.empty()) {
+      for (int i = 0, num_columns = rg_md->num_columns(); i < num_columns;
+           ++i) {
+        auto [begin, end] = ColumnChunkRange(*rg_md, i);
+        KATANA_CHECKED(fv->Fill(begin, end, false));
+      }
+    } else {
+      for (int leaf : leaves) {
+        auto [begin, end] = ColumnChunkRange(*rg_md, leaf);
+        KATANA_CHECKED(fv->Fill(begin, end, false));
+      }
+    }
+  }
+
+  auto read_row_group =
+      [&](int row_group,
+          std::shared_ptr<arrow::Table>* out) -> katana::CopyableResult<void> {
+    if (fields.empty()) {
+      KATANA_CHECKED(reader->ReadRowGroup(row_group, out));
+    } else {
+      KATANA_CHECKED(reader->ReadRowGroup(row_group, leaves, out));
+    }
+    return katana::CopyableResultSuccess();
+  };
+
+  // Reads of property files already run on std::async threads (see
+  // AddProperties), so decoding uses more of them rather than the katana
+  // thread pool, which may only be entered from the thread that owns it.
+  std::vector<std::shared_ptr<arrow::Table>> tables(row_groups.size());
+  size_t width = std::max(1U, std::thread::hardware_concurrency());
+  for (size_t begin = 0; begin < row_groups.size(); begin += width) {
+    size_t end = std::min(begin + width, row_groups.size());
+    std::vector<std::future<katana::CopyableResult<void>>> futures;
+    for (size_t i = begin + 1; i < end; ++i) {
+      futures.emplace_back(std::async(
+          std::launch::async, read_row_group, row_groups[i], &tables[i]));
+    }
+    auto res = read_row_group(row_groups[begin], &tables[begin]);
+    // wait for every task, even after an error, since they refer to tables
+    for (auto& future : futures) {
+      if (auto task_res = future.get(); !task_res && res) {
+        res = std::move(task_res);
+      }
+    }
+    KATANA_CHECKED(res);
+  }
+
+  if (tables.size() == 1) {
+    return tables[0];
+  }
+  return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+}
+
+/// Read rows [first_row, last_row) of the file behind \p reader, fetching
+/// and decoding only the row groups that overlap them
 Result<std::shared_ptr<arrow::Table>>
 ReadTableSlice(
     parquet::arrow::FileReader* reader, katana::FileView* fv, int64_t first_row,
-    int64_t last_row) {
+    int64_t last_row, const std::vector<int>& fields) {
   std::vector<int> row_groups;
   int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
   int64_t cumulative_rows = 0;
-  int64_t file_offset = 0;
-  int64_t cumulative_bytes = 0;
 
+  auto metadata = reader->parquet_reader()->metadata();
   for (int i = 0; cumulative_rows < last_row && i < rg_count; ++i) {
-    auto rg_md = reader->parquet_reader()->metadata()->RowGroup(i);
-    int64_t new_rows = rg_md->num_rows();
-    int64_t new_bytes = rg_md->total_byte_size();
+    int64_t new_rows = metadata->RowGroup(i)->num_rows();
     if (first_row < cumulative_rows + new_rows) {
       if (row_groups.empty()) {
         row_offset = first_row - cumulative_rows;
-        file_offset = cumulative_bytes;
       }
       row_groups.push_back(i);
     }
     cumulative_rows += new_rows;
-    cumulative_bytes += new_bytes;
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
-    return res.error();
-  }
-
-  std::shared_ptr<arrow::Table> out;
-  KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  std::shared_ptr<arrow::Table> out =
+      KATANA_CHECKED(ReadRowGroups(reader, fv, row_groups, fields));
   return out->Slice(row_offset, last_row - first_row);
 }
 
@@ -194,21 +317,116 @@ public:
 
   Result<std::shared_ptr<arrow::Schema>> ReadSchema() {
     KATANA_CHECKED(EnsureReader(0));
+    // unlike FromParquetSchema, this takes the stored arrow schema into
+    // account, as reading does
     std::shared_ptr<arrow::Schema> schema;
-    KATANA_CHECKED(parquet::arrow::FromParquetSchema(
-        readers_[0]->parquet_reader()->metadata()->schema(), &schema));
+    KATANA_CHECKED(readers_[0]->GetSchema(&schema));
     return schema;
   }
 
   Result<std::shared_ptr<arrow::Table>> ReadTable(
       std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
+    return ReadRows({}, slice);
+  }
+
+  Result<std::shared_ptr<arrow::Table>> ReadTable(
+      std::vector<int32_t> col_indexes,
+      std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
+    int32_t num_columns = KATANA_CHECKED(NumColumns());
+    for (int32_t idx : col_indexes) {
+      if (idx < 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "column indexes must be positive");
+      }
+      if (idx >= num_columns) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "column index {} should be less than the number of columns {}",
+            idx, num_columns);
+      }
+    }
+
+    // each column is read once, no matter how many times it is asked for
+    std::vector<int> fields(col_indexes.begin(), col_indexes.end());
+    std::sort(fields.begin(), fields.end());
+    fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+    if (fields.empty()) {
+      return arrow::Table::Make(
+          arrow::schema({}), std::vector<std::shared_ptr<arrow::Array>>{});
+    }
+
+    auto read = KATANA_CHECKED(ReadRows(fields, slice));
+
+    std::vector<std::shared_ptr<arrow::Field>> out_fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (int32_t idx : col_indexes) {
+      int pos = std::lower_bound(fields.begin(), fields.end(), idx) -
+                fields.begin();
+      out_fields.emplace_back(read->field(pos));
+      columns.emplace_back(read->column(pos));
+    }
+    return arrow::Table::Make(arrow::schema(out_fields), columns);
+  }
+
+  Result<std::shared_ptr<arrow::Table>> ReadRanges(
+      const std::vector<katana::ParquetReader::Slice>& slices) {
+    if (slices.empty()) {
+      return ReadRows({}, katana::ParquetReader::Slice{0, 0});
+    }
+    std::vector<std::shared_ptr<arrow::Table>> tables;
+    for (const auto& slice : slices) {
+      tables.emplace_back(KATANA_CHECKED(ReadRows({}, slice)));
+    }
+    if (tables.size() == 1) {
+      return tables[0];
+    }
+    return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+  }
+
+  Result<std::vector<std::string>> GetFiles() {
+    std::vector<std::string> sub_files;
+    sub_files.reserve(fvs_.size());
+    // Bind some the file views so we can get the filenames
+    for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
+      KATANA_CHECKED(EnsureReader(i, false));
+    }
+    for (const auto& fv : fvs_) {
+      sub_files.emplace_back(fv->filename());
+    }
+    return sub_files;
+  }
+
+private:
+  BlockedParquetReader(
+      std::string prefix, std::vector<std::shared_ptr<katana::FileView>>&& fvs,
+      std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
+      std::vector<int64_t>&& row_offsets)
+      : prefix_(std::move(prefix)),
+        fvs_(std::move(fvs)),
+        readers_(std::move(readers)),
+        row_offsets_(std::move(row_offsets)) {}
+
+  std::vector<int> AllRowGroups(size_t idx) const {
+    std::vector<int> row_groups(readers_[idx]->num_row_groups());
+    std::iota(row_groups.begin(), row_groups.end(), 0);
+    return row_groups;
+  }
+
+  /// Read the rows in \p slice, or every row, of the top level \p fields,
+  /// or of every field if \p fields is empty. Only the files and, within
+  /// them, the row groups that overlap \p slice are read.
+  Result<std::shared_ptr<arrow::Table>> ReadRows(
+      const std::vector<int>& fields,
+      std::optional<katana::ParquetReader::Slice> slice) {
+    // a file is fetched in one piece only if all of it will be decoded
+    bool whole_files = fields.empty();
+
     if (!slice) {
       std::vector<std::shared_ptr<arrow::Table>> tables;
       for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-        KATANA_CHECKED(EnsureReader(i, true));
-        std::shared_ptr<arrow::Table> table;
-        KATANA_CHECKED(readers_[i]->ReadTable(&table));
-        tables.emplace_back(std::move(table));
+        KATANA_CHECKED(EnsureReader(i, whole_files));
+        tables.emplace_back(KATANA_CHECKED(ReadRowGroups(
+            readers_[i].get(), fvs_[i].get(), AllRowGroups(i), fields)));
       }
       return KATANA_CHECKED(arrow::ConcatenateTables(tables));
     }
@@ -240,8 +458,9 @@ public:
       std::shared_ptr<arrow::Table> table;
       if (curr_global_row == table_offset &&
           last_global_row >= next_table_offset) {
-        KATANA_CHECKED(EnsureReader(idx, true));
-        KATANA_CHECKED(readers_[idx]->ReadTable(&table));
+        KATANA_CHECKED(EnsureReader(idx, whole_files));
+        table = KATANA_CHECKED(ReadRowGroups(
+            readers_[idx].get(), fvs_[idx].get(), AllRowGroups(idx), fields));
       } else {
         KATANA_CHECKED(EnsureReader(idx, false));
         table = KATANA_CHECKED(ReadTableSlice(
@@ -249,7 +468,8 @@ public:
             curr_global_row - table_offset,
             std::min(
                 next_table_offset - table_offset,
-                last_global_row - table_offset)));
+                last_global_row - table_offset),
+            fields));
       }
       tables.emplace_back(std::move(table));
       curr_global_row = next_table_offset;
@@ -257,89 +477,12 @@ public:
 
     if (tables.empty()) {
       KATANA_CHECKED(EnsureReader(0, false));
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(readers_[idx]->GetSchema(&schema));
-
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
-      for (const auto& field : schema->fields()) {
-        cols.emplace_back(std::make_shared<arrow::ChunkedArray>(
-            KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), 0))));
-      }
-      return arrow::Table::Make(schema, cols);
+      return ReadRowGroups(readers_[0].get(), fvs_[0].get(), {}, fields);
     }
 
     return KATANA_CHECKED(arrow::ConcatenateTables(tables));
   }
 
-  Result<std::shared_ptr<arrow::Table>> ReadTable(
-      std::vector<int32_t> col_indexes,
-      std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
-    std::vector<std::shared_ptr<arrow::Table>> tables;
-
-    for (auto& reader : readers_) {
-      std::vector<std::shared_ptr<arrow::Field>> fields;
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-      std::unordered_map<int32_t, std::shared_ptr<arrow::ChunkedArray>>
-          read_arrays;
-
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(reader->GetSchema(&schema));
-      for (int32_t idx : col_indexes) {
-        if (idx < 0) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument, "column indexes must be positive");
-        }
-        if (idx >= schema->num_fields()) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument,
-              "column index {} should be less than the number of columns {}",
-              idx, schema->num_fields());
-        }
-        std::shared_ptr<arrow::ChunkedArray> column;
-        if (auto arr_it = read_arrays.find(idx); arr_it != read_arrays.end()) {
-          column = arr_it->second;
-        } else {
-          KATANA_CHECKED(reader->ReadColumn(idx, &column));
-          read_arrays.emplace(idx, column);
-        }
-        fields.emplace_back(schema->field(idx));
-        columns.emplace_back(std::move(column));
-      }
-      tables.emplace_back(arrow::Table::Make(arrow::schema(fields), columns));
-    }
-
-    std::shared_ptr<arrow::Table> concatenated_table =
-        KATANA_CHECKED(arrow::ConcatenateTables(tables));
-    if (slice) {
-      concatenated_table =
-          concatenated_table->Slice(slice->offset, slice->length);
-    }
-    return concatenated_table;
-  }
-
-  Result<std::vector<std::string>> GetFiles() {
-    std::vector<std::string> sub_files;
-    sub_files.reserve(fvs_.size());
-    // Bind some the file views so we can get the filenames
-    for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-      KATANA_CHECKED(EnsureReader(i, false));
-    }
-    for (const auto& fv : fvs_) {
-      sub_files.emplace_back(fv->filename());
-    }
-    return sub_files;
-  }
-
-private:
-  BlockedParquetReader(
-      std::string prefix, std::vector<std::shared_ptr<katana::FileView>>&& fvs,
-      std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
-      std::vector<int64_t>&& row_offsets)
-      : prefix_(std::move(prefix)),
-        fvs_(std::move(fvs)),
-        readers_(std::move(readers)),
-        row_offsets_(std::move(row_offsets)) {}
-
   Result<void> EnsureReader(size_t idx, bool preload = false) {
     if (readers_[idx]) {
       KATANA_LOG_ASSERT(fvs_[idx]);
@@ -381,6 +524,23 @@ katana::ParquetReader::ReadTable(
   return FixTable(KATANA_CHECKED(bpr->ReadTable(slice)));
 }
 
+Result<std::shared_ptr<arrow::Table>>
+katana::ParquetReader::ReadTableRanges(
+    const katana::URI& uri, const std::vector<Slice>& slices) {
+  int64_t end = 0;
+  for (const Slice& slice : slices) {
+    if (slice.offset < end || slice.length < 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "slices must be in order, disjoint and of non-negative length");
+    }
+    end = slice.offset + slice.length;
+  }
+
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  return FixTable(KATANA_CHECKED(bpr->ReadRanges(slices)));
+}
+
 katana::Result<std::shared_ptr<arrow::Schema>>
 katana::ParquetReader::GetSchema(const katana::URI& uri) {
   auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
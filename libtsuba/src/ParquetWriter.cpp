@@ -1,5 +1,12 @@
 #include "katana/ParquetWriter.h"
 
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <arrow/util/config.h>
+
 #include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/FaultTest.h"
@@ -58,33 +65,167 @@ BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   return blocks;
 }
 
+// DELTA_BINARY_PACKED can be read by every Parquet library we support, but
+// only written from Arrow 8 on
+#if ARROW_VERSION_MAJOR >= 8
+constexpr bool kCanWriteDeltaBinaryPacked = true;
+#else
+constexpr bool kCanWriteDeltaBinaryPacked = false;
+#endif
+
+/// The number of values of a column the choice of its encoding is based on
+constexpr int64_t kEncodingSampleSize = 4096;
+
+/// A sample whose distinct values are at most this fraction of it is from a
+/// column worth dictionary encoding
+constexpr size_t kDictionaryMaxDistinctFraction = 16;
+
+struct ColumnEncoding {
+  bool dictionary;
+  /// the encoding of the column, or its fallback if dictionary encoded
+  parquet::Encoding::type encoding;
+};
+
+/// \returns up to kEncodingSampleSize valid values of \p column, evenly
+/// spaced and in order
+template <typename ArrayType>
+auto
+SampleValues(const arrow::ChunkedArray& column) {
+  using Value = decltype(std::declval<const ArrayType&>().GetView(0));
+  std::vector<Value> sample;
+  int64_t stride = std::max<int64_t>(column.length() / kEncodingSampleSize, 1);
+  int64_t chunk_begin = 0;
+  int64_t next = 0;
+  for (const auto& chunk : column.chunks()) {
+    const auto& array = static_cast<const ArrayType&>(*chunk);
+    for (; next < chunk_begin + array.length(); next += stride) {
+      if (array.IsValid(next - chunk_begin)) {
+        sample.emplace_back(array.GetView(next - chunk_begin));
+      }
+    }
+    chunk_begin += array.length();
+  }
+  return sample;
+}
+
+template <typename Value>
+bool
+HasFewDistinctValues(std::vector<Value> sample) {
+  std::sort(sample.begin(), sample.end());
+  size_t num_distinct =
+      std::unique(sample.begin(), sample.end()) - sample.begin();
+  return num_distinct * kDictionaryMaxDistinctFraction <= sample.size();
+}
+
+template <typename ArrayType>
+std::optional<ColumnEncoding>
+ChooseFloatingPointEncoding(
+    const arrow::ChunkedArray& column, bool compressed) {
+  auto sample = SampleValues<ArrayType>(column);
+  if (sample.empty()) {
+    return std::nullopt;
+  }
+  if (HasFewDistinctValues(std::move(sample))) {
+    return ColumnEncoding{true, parquet::Encoding::PLAIN};
+  }
+  // splitting the bytes of values into streams only pays off when the
+  // streams are compressed
+  return ColumnEncoding{
+      false, compressed ? parquet::Encoding::BYTE_STREAM_SPLIT
+                        : parquet::Encoding::PLAIN};
+}
+
+template <typename ArrayType>
+std::optional<ColumnEncoding>
+ChooseIntegerEncoding(const arrow::ChunkedArray& column) {
+  auto sample = SampleValues<ArrayType>(column);
+  if (sample.empty()) {
+    return std::nullopt;
+  }
+  bool sorted = std::is_sorted(sample.begin(), sample.end());
+  if (HasFewDistinctValues(std::move(sample))) {
+    return ColumnEncoding{true, parquet::Encoding::PLAIN};
+  }
+  return ColumnEncoding{
+      false, sorted && kCanWriteDeltaBinaryPacked
+                 ? parquet::Encoding::DELTA_BINARY_PACKED
+                 : parquet::Encoding::PLAIN};
+}
+
+template <typename ArrayType>
+std::optional<ColumnEncoding>
+ChooseBinaryEncoding(const arrow::ChunkedArray& column) {
+  auto sample = SampleValues<ArrayType>(column);
+  if (sample.empty()) {
+    return std::nullopt;
+  }
+  return ColumnEncoding{
+      HasFewDistinctValues(std::move(sample)), parquet::Encoding::PLAIN};
+}
+
+/// \returns the encoding of \p column, or nullopt to leave it to the
+/// Parquet library, e.g., for nested columns
+std::optional<ColumnEncoding>
+ChooseEncoding(const arrow::ChunkedArray& column, bool compressed) {
+  switch (column.type()->id()) {
+  case arrow::Type::FLOAT:
+    return ChooseFloatingPointEncoding<arrow::FloatArray>(column, compressed);
+  case arrow::Type::DOUBLE:
+    return ChooseFloatingPointEncoding<arrow::DoubleArray>(column, compressed);
+  case arrow::Type::INT32:
+    return ChooseIntegerEncoding<arrow::Int32Array>(column);
+  case arrow::Type::UINT32:
+    return ChooseIntegerEncoding<arrow::UInt32Array>(column);
+  case arrow::Type::INT64:
+    return ChooseIntegerEncoding<arrow::Int64Array>(column);
+  case arrow::Type::UINT64:
+    return ChooseIntegerEncoding<arrow::UInt64Array>(column);
+  case arrow::Type::TIMESTAMP:
+    return ChooseIntegerEncoding<arrow::TimestampArray>(column);
+  case arrow::Type::STRING:
+    return ChooseBinaryEncoding<arrow::StringArray>(column);
+  case arrow::Type::LARGE_STRING:
+    return ChooseBinaryEncoding<arrow::LargeStringArray>(column);
+  case arrow::Type::BINARY:
+    return ChooseBinaryEncoding<arrow::BinaryArray>(column);
+  case arrow::Type::LARGE_BINARY:
+    return ChooseBinaryEncoding<arrow::LargeBinaryArray>(column);
+  default:
+    return std::nullopt;
+  }
+}
+
 Result<void>
 DoStoreParquet(
     const std::string& path, std::shared_ptr<arrow::Table> table,
     const std::shared_ptr<parquet::WriterProperties>& writer_props,
     const std::shared_ptr<parquet::ArrowWriterProperties>& arrow_props,
-    katana::WriteGroup* desc) {
+    int64_t rows_per_row_group, katana::WriteGroup* desc) {
+  // the encoded file is about as large as the table, hold off encoding it
+  // until that much fits in the write budget
+  uint64_t accounted_size = 0;
+  if (desc) {
+    accounted_size = katana::ApproxTableMemUse(table);
+    desc->WaitForRoom(accounted_size);
+  }
+
   auto ff = std::make_shared<katana::FileFrame>();
   KATANA_CHECKED(ff->Init());
   ff->Bind(path);
 
   auto future = std::async(
       std::launch::async,
-      [table = std::move(table), ff = std::move(ff), desc, writer_props,
-       arrow_props]() mutable -> katana::CopyableResult<void> {
+      [table = std::move(table), ff = std::move(ff), writer_props, arrow_props,
+       rows_per_row_group]() mutable -> katana::CopyableResult<void> {
         auto write_result = parquet::arrow::WriteTable(
-            *table, arrow::default_memory_pool(), ff,
-            std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
+            *table, arrow::default_memory_pool(), ff, rows_per_row_group,
+            writer_props, arrow_props);
         table.reset();
 
         if (!write_result.ok()) {
           return KATANA_ERROR(
               katana::ErrorCode::ArrowError, "arrow error: {}", write_result);
         }
-        if (desc) {
-          desc->AddToOutstanding(ff->map_size());
-        }
-
         TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
         KATANA_CHECKED(ff->Persist());
 
@@ -96,7 +237,7 @@ DoStoreParquet(
     return katana::ResultSuccess();
   }
 
-  desc->AddOp(std::move(future), path);
+  desc->AddOp(std::move(future), path, accounted_size);
   return katana::ResultSuccess();
 }
 
@@ -133,17 +274,72 @@ katana::ParquetWriter::WriteToUri(const katana::URI& uri, WriteGroup* group) {
   }
 }
 
+std::vector<katana::RowGroupStatistics>
+katana::ParquetWriter::Statistics() const {
+  std::vector<RowGroupStatistics> stats;
+  if (tables_.empty() || tables_[0]->num_columns() != 1 ||
+      !HasRowGroupStatistics(*tables_[0]->column(0)->type())) {
+    return stats;
+  }
+  // the same row groups as StoreParquet writes: blocks, files of at most
+  // kMaxRowsPerFile rows, and row groups of at most rows_per_row_group rows
+  int64_t block_offset = 0;
+  for (const auto& table : tables_) {
+    const arrow::ChunkedArray& column = *table->column(0);
+    int64_t num_rows = table->num_rows();
+    for (int64_t file = 0; file < num_rows; file += kMaxRowsPerFile) {
+      int64_t file_end = std::min(num_rows, file + kMaxRowsPerFile);
+      for (int64_t row = file; row < file_end;
+           row += opts_.rows_per_row_group) {
+        int64_t length = std::min(file_end - row, opts_.rows_per_row_group);
+        RowGroupStatistics row_group =
+            ComputeRowGroupStatistics(column, row, length);
+        row_group.offset += block_offset;
+        stats.emplace_back(row_group);
+      }
+    }
+    block_offset += num_rows;
+  }
+  return stats;
+}
+
 std::shared_ptr<parquet::WriterProperties>
-katana::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
+katana::ParquetWriter::StandardWriterProperties(const arrow::Table& table) {
+  parquet::WriterProperties::Builder builder;
+  builder.version(opts_.parquet_version)
       ->data_page_version(opts_.data_page_version)
-      ->build();
+      ->compression(opts_.compression);
+  if (opts_.compression_level) {
+    builder.compression_level(opts_.compression_level.value());
+  }
+  if (!opts_.adaptive_encoding) {
+    return builder.build();
+  }
+
+  bool compressed = opts_.compression != arrow::Compression::UNCOMPRESSED;
+  for (int i = 0, num_columns = table.num_columns(); i < num_columns; ++i) {
+    std::optional<ColumnEncoding> encoding =
+        ChooseEncoding(*table.column(i), compressed);
+    if (!encoding) {
+      continue;
+    }
+    // the Parquet column of a top level primitive field has its name
+    const std::string& path = table.field(i)->name();
+    if (encoding->dictionary) {
+      builder.enable_dictionary(path);
+    } else {
+      builder.disable_dictionary(path);
+    }
+    builder.encoding(path, encoding->encoding);
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
 katana::ParquetWriter::StandardArrowProperties() {
-  return parquet::ArrowWriterProperties::Builder().build();
+  // The stored arrow schema keeps types that parquet cannot express, e.g.,
+  // dictionary encoded columns are read back as dictionaries
+  return parquet::ArrowWriterProperties::Builder().store_schema()->build();
 }
 
 /// Store the arrow table in a file
@@ -151,12 +347,14 @@ katana::Result<void>
 katana::ParquetWriter::StoreParquet(
     std::shared_ptr<arrow::Table> table, const katana::URI& uri,
     katana::WriteGroup* desc) {
-  auto writer_props = StandardWriterProperties();
+  auto writer_props = StandardWriterProperties(*table);
   auto arrow_props = StandardArrowProperties();
   std::string prefix = uri.string();
 
   if (table->num_rows() <= kMaxRowsPerFile) {
-    return DoStoreParquet(prefix, table, writer_props, arrow_props, desc);
+    return DoStoreParquet(
+        prefix, table, writer_props, arrow_props, opts_.rows_per_row_group,
+        desc);
   }
 
   std::vector<std::shared_ptr<arrow::Table>> tables;
@@ -179,7 +377,7 @@ katana::ParquetWriter::StoreParquet(
   for (const auto& t : tables) {
     KATANA_CHECKED(DoStoreParquet(
         fmt::format("{}.part_{:09}", prefix, table_count++), t, writer_props,
-        arrow_props, desc));
+        arrow_props, opts_.rows_per_row_group, desc));
   }
   return FileStore(
       uri.string(), KATANA_CHECKED(katana::JsonDump(table_offsets)));
@@ -0,0 +1,176 @@
+#include "katana/PropertyStatistics.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "katana/Logging.h"
+#include "katana/Random.h"
+
+namespace {
+
+/// A HyperLogLog counter of 2^kIndexBits one-byte registers
+class DistinctCounter {
+public:
+  void Add(uint64_t bits) {
+    uint64_t hash = katana::SplitMix64(bits)();
+    uint64_t rest = hash >> kIndexBits;
+    int rank = rest == 0 ? 64 - kIndexBits + 1 : __builtin_ctzll(rest) + 1;
+    uint8_t& reg = registers_[hash & (kRegisters - 1)];
+    reg = std::max(reg, static_cast<uint8_t>(rank));
+  }
+
+  /// The HyperLogLog estimate, with linear counting for small numbers
+  int64_t Estimate() const {
+    constexpr double m = kRegisters;
+    constexpr double alpha = 0.7213 / (1 + 1.079 / m);
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t reg : registers_) {
+      sum += std::ldexp(1.0, -reg);
+      zeros += reg == 0;
+    }
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros != 0) {
+      estimate = m * std::log(m / zeros);
+    }
+    return std::llround(estimate);
+  }
+
+private:
+  static constexpr int kIndexBits = 8;
+  static constexpr size_t kRegisters = size_t{1} << kIndexBits;
+
+  std::array<uint8_t, kRegisters> registers_{};
+};
+
+/// \returns value as a double no larger than it, if lower, and no smaller
+/// than it otherwise
+template <typename T>
+double
+Widen(T value, bool lower) {
+  double widened = static_cast<double>(value);
+  // doubles hold every integer of up to 53 bits exactly
+  if constexpr (std::is_integral_v<T> && sizeof(T) == 8) {
+    if (widened <= -0x1p53 || widened >= 0x1p53) {
+      widened = std::nextafter(
+          widened, lower ? -std::numeric_limits<double>::infinity()
+                         : std::numeric_limits<double>::infinity());
+    }
+  }
+  return widened;
+}
+
+template <typename ArrowType>
+void
+AddRows(
+    const arrow::Array& chunk, int64_t begin, int64_t end,
+    katana::RowGroupStatistics* stats, DistinctCounter* distinct) {
+  using CType = typename ArrowType::c_type;
+  const auto& values =
+      static_cast<const arrow::NumericArray<ArrowType>&>(chunk);
+  std::optional<CType> min;
+  std::optional<CType> max;
+  for (int64_t i = begin; i < end; ++i) {
+    if (values.IsNull(i)) {
+      stats->null_count += 1;
+      continue;
+    }
+    CType value = values.Value(i);
+    if constexpr (std::is_floating_point_v<CType>) {
+      // NaNs never satisfy a range predicate
+      if (std::isnan(value)) {
+        continue;
+      }
+      // -0.0 and 0.0 are the same value
+      value += CType{0};
+    }
+    if (!min || value < *min) {
+      min = value;
+    }
+    if (!max || value > *max) {
+      max = value;
+    }
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(value));
+    distinct->Add(bits);
+  }
+  if (min) {
+    stats->min = std::min(stats->min, Widen(*min, true));
+    stats->max = std::max(stats->max, Widen(*max, false));
+  }
+}
+
+void
+AddRowsOfType(
+    const arrow::Array& chunk, int64_t begin, int64_t end,
+    katana::RowGroupStatistics* stats, DistinctCounter* distinct) {
+  switch (chunk.type_id()) {
+  case arrow::Type::INT8:
+    return AddRows<arrow::Int8Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::UINT8:
+    return AddRows<arrow::UInt8Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::INT16:
+    return AddRows<arrow::Int16Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::UINT16:
+    return AddRows<arrow::UInt16Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::INT32:
+    return AddRows<arrow::Int32Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::UINT32:
+    return AddRows<arrow::UInt32Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::INT64:
+    return AddRows<arrow::Int64Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::UINT64:
+    return AddRows<arrow::UInt64Type>(chunk, begin, end, stats, distinct);
+  case arrow::Type::FLOAT:
+    return AddRows<arrow::FloatType>(chunk, begin, end, stats, distinct);
+  case arrow::Type::DOUBLE:
+    return AddRows<arrow::DoubleType>(chunk, begin, end, stats, distinct);
+  default:
+    KATANA_LOG_FATAL("no statistics for type {}", chunk.type()->ToString());
+  }
+}
+
+}  // namespace
+
+bool
+katana::HasRowGroupStatistics(const arrow::DataType& type) {
+  return arrow::is_integer(type.id()) || arrow::is_floating(type.id());
+}
+
+katana::RowGroupStatistics
+katana::ComputeRowGroupStatistics(
+    const arrow::ChunkedArray& array, int64_t offset, int64_t length) {
+  RowGroupStatistics stats;
+  stats.offset = offset;
+  stats.num_rows = length;
+  // empty bounds that the values of the chunks widen
+  stats.min = std::numeric_limits<double>::infinity();
+  stats.max = -std::numeric_limits<double>::infinity();
+  DistinctCounter distinct;
+
+  int64_t chunk_start = 0;
+  int64_t end = offset + length;
+  for (const auto& chunk : array.chunks()) {
+    int64_t chunk_end = chunk_start + chunk->length();
+    if (chunk_end > offset && chunk_start < end) {
+      AddRowsOfType(
+          *chunk, std::max(offset, chunk_start) - chunk_start,
+          std::min(end, chunk_end) - chunk_start, &stats, &distinct);
+    }
+    chunk_start = chunk_end;
+  }
+  if (stats.min > stats.max) {
+    // no values, or only NaNs
+    stats.min = -std::numeric_limits<double>::infinity();
+    stats.max = std::numeric_limits<double>::infinity();
+  }
+  if (stats.null_count < stats.num_rows) {
+    stats.distinct_count = distinct.Estimate();
+  }
+  return stats;
+}
@@ -3,6 +3,7 @@
 #include <cassert>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -24,6 +25,7 @@
 #include <parquet/properties.h>
 
 #include "AddProperties.h"
+#include "ContentAddress.h"
 #include "GlobalState.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
@@ -32,6 +34,7 @@
 #include "katana/FaultTest.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
+#include "katana/ParquetReader.h"
 #include "katana/ParquetWriter.h"
 #include "katana/RDGTopology.h"
 #include "katana/ReadGroup.h"
@@ -45,23 +48,62 @@ using json = nlohmann::json;
 
 namespace {
 
+// node, edge and partition arrays with the same name and contents are still
+// kept in separate files
+constexpr std::string_view kNodeSalt = "node";
+constexpr std::string_view kEdgeSalt = "edge";
+constexpr std::string_view kPartSalt = "part";
+
+/// \returns true if \p uri holds a complete table of \p num_rows rows, i.e.,
+/// an earlier store finished writing it
+bool
+IsStoredTable(const katana::URI& uri, int64_t num_rows) {
+  katana::StatBuf stat;
+  if (!katana::FileStat(uri.string(), &stat)) {
+    return false;
+  }
+  auto reader_res = katana::ParquetReader::Make();
+  if (!reader_res) {
+    return false;
+  }
+  // opening every file of the table reads its footer, which is written last
+  if (!reader_res.value()->GetFiles(uri)) {
+    return false;
+  }
+  auto rows_res = reader_res.value()->NumRows(uri);
+  return rows_res && rows_res.value() == num_rows;
+}
+
+/// Store \p array in a content addressed file (see ContentAddressedFileName)
+/// unless \p dir already has it. If \p statistics is not null, it gets the
+/// statistics of the row groups of the file.
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::URI& dir,
-    const std::string& name, katana::WriteGroup* desc) {
+    const std::string& name, std::string_view salt, katana::WriteGroup* desc,
+    std::vector<katana::RowGroupStatistics>* statistics = nullptr) {
+  std::string file_name = katana::ContentAddressedFileName(name, salt, *array);
+  katana::URI new_path = dir.Join(file_name);
   std::unique_ptr<katana::ParquetWriter> writer =
       KATANA_CHECKED(katana::ParquetWriter::Make(array, name));
+  if (statistics) {
+    *statistics = writer->Statistics();
+  }
+  if (IsStoredTable(new_path, array->length())) {
+    KATANA_LOG_DEBUG("{} is already stored at {}", name, new_path);
+    return file_name;
+  }
 
-  katana::URI new_path = dir.RandFile(name);
   KATANA_CHECKED_CONTEXT(
       writer->WriteToUri(new_path, desc), "writing to: {}", new_path);
-  return new_path.BaseName();
+  return file_name;
 }
 
 katana::Result<void>
 WriteProperties(
     const arrow::Table& props, std::vector<katana::PropStorageInfo*> prop_info,
-    const katana::URI& dir, katana::WriteGroup* desc) {
+    const katana::URI& dir, std::string_view salt,
+    katana::RawColumnFormat raw_format, katana::WriteGroup* desc) {
   const auto& schema = props.schema();
 
   std::vector<std::string> next_paths;
@@ -71,10 +113,27 @@ WriteProperties(
     }
     std::string name = prop_info[i]->name().empty() ? schema->field(i)->name()
                                                     : prop_info[i]->name();
-    std::string path =
-        KATANA_CHECKED(StoreArrowArrayAtName(props.column(i), dir, name, desc));
+    std::vector<katana::RowGroupStatistics> statistics;
+    std::string path = KATANA_CHECKED(StoreArrowArrayAtName(
+        props.column(i), dir, name, salt, desc, &statistics));
+
+    std::string raw_path;
+    if (raw_format != katana::RawColumnFormat::kNone &&
+        katana::IsRawColumnType(*props.column(i)->type())) {
+      raw_path = path + ".raw";
+      // the raw column is named after the Parquet file, so one that an
+      // earlier store left behind holds the same values
+      auto stored_type = katana::ReadRawColumnType(dir.Join(raw_path));
+      if (!stored_type ||
+          !stored_type.value()->Equals(props.column(i)->type())) {
+        KATANA_CHECKED_CONTEXT(
+            katana::WriteRawColumn(
+                props.column(i), dir.Join(raw_path), raw_format, desc),
+            "writing raw column of {}", std::quoted(name));
+      }
+    }
 
-    prop_info[i]->WasWritten(path);
+    prop_info[i]->WasWritten(path, raw_path, std::move(statistics));
   }
   TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
 
@@ -86,7 +145,8 @@ SetTnxContextManifest(
     katana::RDGHandle handle, uint32_t policy_id, bool transposed,
     katana::RDG::RDGVersioningPolicy versioning_action,
     const katana::RDGLineage& lineage, std::unique_ptr<katana::WriteGroup> desc,
-    katana::TxnContext* txn_ctx) {
+    katana::TxnContext* txn_ctx,
+    std::shared_future<katana::CopyableResult<void>>* pending) {
   katana::CommBackend* comm = katana::Comm();
   katana::RDGManifest new_manifest =
       (versioning_action == katana::RDG::RetainVersion)
@@ -97,8 +157,21 @@ SetTnxContextManifest(
   new_manifest.set_viewtype(handle.impl_->rdg_manifest().viewtype());
   new_manifest.set_viewargs(handle.impl_->rdg_manifest().viewargs());
 
-  // wait for all the work we queued to finish
-  KATANA_CHECKED_CONTEXT(desc->Finish(), "at least one async write failed");
+  if (pending != nullptr) {
+    // txn_ctx waits for the writes before it writes the manifest
+    *pending = std::async(
+                   std::launch::async,
+                   [desc = std::move(desc)]() -> katana::CopyableResult<void> {
+                     KATANA_CHECKED_CONTEXT(
+                         desc->Finish(), "at least one async write failed");
+                     return katana::CopyableResultSuccess();
+                   })
+                   .share();
+    txn_ctx->AddPendingStore(*pending);
+  } else {
+    // wait for all the work we queued to finish
+    KATANA_CHECKED_CONTEXT(desc->Finish(), "at least one async write failed");
+  }
 
   // TODO(witchel): the file names generated by RDGManifest::FileName are not
   //                correct because they do not include the partitioning policy
@@ -149,23 +222,24 @@ katana::RDG::WritePartArrays(const katana::URI& dir, katana::WriteGroup* desc) {
   for (size_t i = 0; i < mirror_nodes().size(); ++i) {
     std::string name = RDGCore::MirrorPropName(i);
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(mirror_nodes()[i], dir, name, desc), "storing {}",
-        name);
+        StoreArrowArrayAtName(mirror_nodes()[i], dir, name, kPartSalt, desc),
+        "storing {}", name);
     next_properties.emplace_back(katana::PropStorageInfo(name, path));
   }
 
   for (size_t i = 0; i < master_nodes().size(); ++i) {
     std::string name = RDGCore::MasterPropName(i);
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(master_nodes()[i], dir, name, desc), "storing {}",
-        name);
+        StoreArrowArrayAtName(master_nodes()[i], dir, name, kPartSalt, desc),
+        "storing {}", name);
     next_properties.emplace_back(katana::PropStorageInfo(name, path));
   }
 
   if (host_to_owned_global_node_ids() != nullptr) {
     std::string name = RDGCore::kHostToOwnedGlobalNodeIDsPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(host_to_owned_global_node_ids(), dir, name, desc),
+        StoreArrowArrayAtName(
+            host_to_owned_global_node_ids(), dir, name, kPartSalt, desc),
         "storing {}", name);
     next_properties.emplace_back(katana::PropStorageInfo(name, path));
   }
@@ -173,7 +247,8 @@ katana::RDG::WritePartArrays(const katana::URI& dir, katana::WriteGroup* desc) {
   if (host_to_owned_global_edge_ids() != nullptr) {
     std::string name = RDGCore::kHostToOwnedGlobalEdgeIDsPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(host_to_owned_global_edge_ids(), dir, name, desc),
+        StoreArrowArrayAtName(
+            host_to_owned_global_edge_ids(), dir, name, kPartSalt, desc),
         "storing {}", name);
     next_properties.emplace_back(katana::PropStorageInfo(name, path));
   }
@@ -181,7 +256,7 @@ katana::RDG::WritePartArrays(const katana::URI& dir, katana::WriteGroup* desc) {
   if (local_to_user_id() != nullptr) {
     std::string name = RDGCore::kLocalToUserIDPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(local_to_user_id(), dir, name, desc),
+        StoreArrowArrayAtName(local_to_user_id(), dir, name, kPartSalt, desc),
         "storing {}", name);
     next_properties.emplace_back(katana::PropStorageInfo(name, path));
   }
@@ -189,7 +264,7 @@ katana::RDG::WritePartArrays(const katana::URI& dir, katana::WriteGroup* desc) {
   if (local_to_global_id() != nullptr) {
     std::string name = RDGCore::kLocalToGlobalIDPropName;
     std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(local_to_global_id(), dir, name, desc),
+        StoreArrowArrayAtName(local_to_global_id(), dir, name, kPartSalt, desc),
         "storing {}", name);
     next_properties.emplace_back(katana::PropStorageInfo(name, path));
   }
@@ -294,10 +369,11 @@ katana::RDG::DoStoreEdgeEntityTypeIDArray(
 }
 
 katana::Result<void>
-katana::RDG::DoStore(
+katana::RDG::DoStoreProperties(
     RDGHandle handle, const std::string& command_line,
     RDGVersioningPolicy versioning_action,
-    std::unique_ptr<WriteGroup> write_group, katana::TxnContext* txn_ctx) {
+    std::unique_ptr<WriteGroup> write_group, katana::TxnContext* txn_ctx,
+    std::shared_future<katana::CopyableResult<void>>* pending) {
   KATANA_LOG_DEBUG_ASSERT(txn_ctx != nullptr);
 
   // bump the storage format version to the latest
@@ -320,7 +396,8 @@ katana::RDG::DoStore(
   // writing node properties
   KATANA_CHECKED(WriteProperties(
       *core_->node_properties(), node_props_to_store,
-      handle.impl_->rdg_manifest().dir(), write_group.get()));
+      handle.impl_->rdg_manifest().dir(), kNodeSalt, raw_column_format_,
+      write_group.get()));
 
   std::vector<std::string> edge_prop_names;
   for (const auto& field : core_->edge_properties()->fields()) {
@@ -333,7 +410,8 @@ katana::RDG::DoStore(
   // writing edge properties
   KATANA_CHECKED(WriteProperties(
       *core_->edge_properties(), edge_props_to_store,
-      handle.impl_->rdg_manifest().dir(), write_group.get()));
+      handle.impl_->rdg_manifest().dir(), kEdgeSalt, raw_column_format_,
+      write_group.get()));
 
   // writing partition metadata
   core_->part_header().set_part_prop_info_list(KATANA_CHECKED(
@@ -356,7 +434,7 @@ katana::RDG::DoStore(
   KATANA_CHECKED(SetTnxContextManifest(
       handle, core_->part_header().metadata().policy_id_,
       core_->part_header().metadata().transposed_, versioning_action,
-      core_->lineage(), std::move(write_group), txn_ctx));
+      core_->lineage(), std::move(write_group), txn_ctx, pending));
   return katana::ResultSuccess();
 }
 
@@ -385,7 +463,8 @@ katana::RDG::DoMake(
         }
         rdg->core_->set_node_properties(std::move(prop_table));
         return katana::ResultSuccess();
-      }));
+      },
+      core_->mmap_local_files()));
 
   // populating edge properties
   KATANA_CHECKED(AddProperties(
@@ -405,7 +484,8 @@ katana::RDG::DoMake(
         }
         rdg->core_->set_edge_properties(std::move(prop_table));
         return katana::ResultSuccess();
-      }));
+      },
+      core_->mmap_local_files()));
 
   // populating topologies
   KATANA_CHECKED(core_->MakeTopologyManager(metadata_dir));
@@ -499,15 +579,25 @@ katana::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
 
   katana::URI partition_path = manifest.PartitionFileName(partition_id_to_load);
 
-  RDGPartHeader part_header = KATANA_CHECKED_CONTEXT(
-      RDGPartHeader::Make(partition_path), "failed to read path {}",
-      partition_path);
+  RDGPartHeader part_header;
+  if (auto contents = manifest.PrefetchedPartitionHeader(partition_path)) {
+    std::string data = KATANA_CHECKED_CONTEXT(
+        std::move(contents.value()), "failed to read path {}", partition_path);
+    part_header = KATANA_CHECKED(RDGPartHeader::Make(partition_path, data));
+  } else {
+    part_header = KATANA_CHECKED_CONTEXT(
+        RDGPartHeader::Make(partition_path), "failed to read path {}",
+        partition_path);
+  }
 
   RDG rdg(std::make_unique<RDGCore>(std::move(part_header)));
   // rdg.DoMake will try to lookup in the property cache, and it
   // needs a valid rdg_dir
   rdg.set_rdg_dir(manifest.dir());
   KATANA_LOG_ASSERT(!manifest.dir().empty());
+  rdg.core_->set_mmap_local_files(opts.mmap_local_files);
+  rdg.core_->set_defer_topology(opts.defer_topology);
+  rdg.core_->set_semi_external_topology(opts.semi_external_topology);
 
   std::vector<PropStorageInfo*> node_props = KATANA_CHECKED(
       rdg.core_->part_header().SelectNodeProperties(opts.node_properties));
@@ -576,6 +666,41 @@ katana::RDG::Store(
     const katana::EntityTypeManager& node_entity_type_manager,
     const katana::EntityTypeManager& edge_entity_type_manager,
     katana::TxnContext* txn_ctx) {
+  return DoStore(
+      handle, command_line, versioning_action,
+      std::move(node_entity_type_id_array_ff),
+      std::move(edge_entity_type_id_array_ff), node_entity_type_manager,
+      edge_entity_type_manager, txn_ctx, nullptr);
+}
+
+katana::Result<std::shared_future<katana::CopyableResult<void>>>
+katana::RDG::StoreAsync(
+    RDGHandle handle, const std::string& command_line,
+    RDGVersioningPolicy versioning_action,
+    std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
+    std::unique_ptr<FileFrame> edge_entity_type_id_array_ff,
+    const katana::EntityTypeManager& node_entity_type_manager,
+    const katana::EntityTypeManager& edge_entity_type_manager,
+    katana::TxnContext* txn_ctx) {
+  std::shared_future<katana::CopyableResult<void>> pending;
+  KATANA_CHECKED(DoStore(
+      handle, command_line, versioning_action,
+      std::move(node_entity_type_id_array_ff),
+      std::move(edge_entity_type_id_array_ff), node_entity_type_manager,
+      edge_entity_type_manager, txn_ctx, &pending));
+  return pending;
+}
+
+katana::Result<void>
+katana::RDG::DoStore(
+    RDGHandle handle, const std::string& command_line,
+    RDGVersioningPolicy versioning_action,
+    std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
+    std::unique_ptr<FileFrame> edge_entity_type_id_array_ff,
+    const katana::EntityTypeManager& node_entity_type_manager,
+    const katana::EntityTypeManager& edge_entity_type_manager,
+    katana::TxnContext* txn_ctx,
+    std::shared_future<katana::CopyableResult<void>>* pending) {
   if (!handle.impl_->AllowsWrite()) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "handle does not allow write");
@@ -592,9 +717,13 @@ katana::RDG::Store(
     KATANA_CHECKED(core_->part_header().ChangeStorageLocation(
         rdg_dir(), handle.impl_->rdg_manifest().dir()));
   }
+  // Written after moving the stored datastructures, which these replace
+  KATANA_CHECKED(
+      DoStoreEntityIndexPrimitives(handle.impl_->rdg_manifest().dir()));
 
   // All write buffers must outlive desc
-  std::unique_ptr<WriteGroup> desc = KATANA_CHECKED(WriteGroup::Make());
+  std::unique_ptr<WriteGroup> desc =
+      KATANA_CHECKED(WriteGroup::Make(max_outstanding_write_size_));
 
   KATANA_CHECKED(core_->topology_manager().DoStore(handle, rdg_dir(), desc));
 
@@ -609,8 +738,9 @@ katana::RDG::Store(
   KATANA_CHECKED(core_->part_header().StoreEdgeEntityTypeManager(
       edge_entity_type_manager));
 
-  return DoStore(
-      handle, command_line, versioning_action, std::move(desc), txn_ctx);
+  return DoStoreProperties(
+      handle, command_line, versioning_action, std::move(desc), txn_ctx,
+      pending);
 }
 
 katana::Result<void>
@@ -663,7 +793,7 @@ katana::Result<std::shared_ptr<arrow::Table>>
 UnloadProperty(
     const std::shared_ptr<arrow::Table>& props, int i,
     std::vector<katana::PropStorageInfo>* prop_info_list,
-    const katana::URI& dir) {
+    const katana::URI& dir, std::string_view salt) {
   if (i < 0 || i > props->num_columns()) {
     return KATANA_ERROR(
         katana::ErrorCode::InvalidArgument, "property index out of bounds");
@@ -681,9 +811,10 @@ UnloadProperty(
   KATANA_LOG_ASSERT(!prop_info.IsAbsent());
 
   if (prop_info.IsDirty()) {
-    std::string path = KATANA_CHECKED(
-        StoreArrowArrayAtName(props->column(i), dir, name, nullptr));
-    prop_info.WasWritten(path);
+    std::vector<katana::RowGroupStatistics> statistics;
+    std::string path = KATANA_CHECKED(StoreArrowArrayAtName(
+        props->column(i), dir, name, salt, nullptr, &statistics));
+    prop_info.WasWritten(path, {}, std::move(statistics));
   }
 
   prop_info.WasUnloaded();
@@ -760,13 +891,56 @@ LoadProperty(
   return new_table;
 }
 
+/// Issue reads for the absent properties among \p names; \p set_props is
+/// called with the grown table each time a read is folded in by \p grp
+katana::Result<void>
+PrefetchProperties(
+    const std::vector<std::string>& names,
+    std::vector<katana::PropStorageInfo>* prop_info_list,
+    const katana::URI& dir, katana::ReadGroup* grp,
+    const std::function<std::shared_ptr<arrow::Table>()>& get_props,
+    const std::function<void(std::shared_ptr<arrow::Table>)>& set_props) {
+  KATANA_LOG_DEBUG_ASSERT(grp);
+
+  std::vector<katana::PropStorageInfo*> to_load;
+  for (const auto& name : names) {
+    auto psi_it = std::find_if(
+        prop_info_list->begin(), prop_info_list->end(),
+        [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+    if (psi_it == prop_info_list->end()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "no property named {}",
+          std::quoted(name));
+    }
+    if (psi_it->IsAbsent() &&
+        std::find(to_load.begin(), to_load.end(), &(*psi_it)) ==
+            to_load.end()) {
+      to_load.emplace_back(&(*psi_it));
+    }
+  }
+
+  return katana::AddProperties(
+      dir, true /*is_property*/, to_load, grp,
+      [get_props, set_props](const std::shared_ptr<arrow::Table>& col)
+          -> katana::Result<void> {
+        std::shared_ptr<arrow::Table> props = get_props();
+        if (props->num_columns() == 0) {
+          set_props(col);
+          return katana::ResultSuccess();
+        }
+        set_props(KATANA_CHECKED(props->AddColumn(
+            props->num_columns(), col->field(0), col->column(0))));
+        return katana::ResultSuccess();
+      });
+}
+
 }  // namespace
 
 katana::Result<void>
 katana::RDG::UnloadNodeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       node_properties(), i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), kNodeSalt));
   core_->set_node_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -789,11 +963,47 @@ katana::RDG::GetNodePropertyStorageLocation(const std::string& name) const {
       name, core_->part_header().node_prop_info_list());
 }
 
+katana::Result<std::vector<katana::RowGroupStatistics>>
+katana::RDG::GetNodePropertyStatistics(const std::string& name) const {
+  const katana::PropStorageInfo* prop_info =
+      core_->part_header().find_node_prop_info(name);
+  if (!prop_info) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+  if (prop_info->IsDirty()) {
+    return std::vector<katana::RowGroupStatistics>();
+  }
+  return prop_info->statistics();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::RDG::ReadNodePropertyRanges(
+    const std::string& name,
+    const std::vector<ParquetReader::Slice>& ranges) const {
+  const katana::PropStorageInfo* prop_info =
+      core_->part_header().find_node_prop_info(name);
+  if (!prop_info) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+  if (prop_info->IsDirty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "property {} was modified since it was written", std::quoted(name));
+  }
+  return KATANA_CHECKED_CONTEXT(
+      katana::LoadPropertyRanges(*prop_info, rdg_dir(), ranges),
+      "reading ranges of {}", std::quoted(name));
+}
+
 katana::Result<void>
 katana::RDG::UnloadEdgeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       edge_properties(), i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
+      rdg_dir(), kEdgeSalt));
   core_->set_edge_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -834,6 +1044,28 @@ katana::RDG::LoadEdgeProperty(const std::string& name, int i) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDG::PrefetchNodeProperties(
+    const std::vector<std::string>& names, ReadGroup* grp) {
+  return PrefetchProperties(
+      names, &core_->part_header().node_prop_info_list(), rdg_dir(), grp,
+      [this]() { return node_properties(); },
+      [this](std::shared_ptr<arrow::Table> props) {
+        core_->set_node_properties(std::move(props));
+      });
+}
+
+katana::Result<void>
+katana::RDG::PrefetchEdgeProperties(
+    const std::vector<std::string>& names, ReadGroup* grp) {
+  return PrefetchProperties(
+      names, &core_->part_header().edge_prop_info_list(), rdg_dir(), grp,
+      [this]() { return edge_properties(); },
+      [this](std::shared_ptr<arrow::Table> props) {
+        core_->set_edge_properties(std::move(props));
+      });
+}
+
 std::vector<std::string>
 katana::RDG::ListFullNodeProperties() const {
   std::vector<std::string> result;
@@ -1008,11 +1240,31 @@ katana::Result<katana::RDGTopology*>
 katana::RDG::GetTopology(const katana::RDGTopology& shadow) {
   RDGTopology* topology =
       KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
-  KATANA_CHECKED(topology->Bind(rdg_dir()));
+  if ((core_->mmap_local_files() || core_->semi_external_topology()) &&
+      rdg_dir().scheme() == katana::URI::kFileScheme) {
+    KATANA_CHECKED(topology->BindMapped(rdg_dir()));
+  } else {
+    KATANA_CHECKED(topology->Bind(rdg_dir()));
+  }
   KATANA_CHECKED(topology->Map());
   return topology;
 }
 
+katana::Result<katana::RDGTopology*>
+katana::RDG::FindTopology(const katana::RDGTopology& shadow) {
+  return core_->topology_manager().GetTopology(shadow);
+}
+
+bool
+katana::RDG::defer_topology() const {
+  return core_->defer_topology();
+}
+
+bool
+katana::RDG::semi_external_topology() const {
+  return core_->semi_external_topology();
+}
+
 const katana::FileView&
 katana::RDG::node_entity_type_id_array_file_storage() const {
   return core_->node_entity_type_id_array_file_storage();
@@ -1129,6 +1381,78 @@ katana::RDG::WriteRDKSubstructureIndexPrimitive(
   return katana::ResultSuccess();
 }
 
+katana::Result<std::optional<katana::ReachabilityIndexPrimitive>>
+katana::RDG::LoadReachabilityIndexPrimitive() {
+  if (!core_->part_header().HasOptionalDatastructureManifest(
+          kOptionalDatastructureReachabilityIndexPrimitive)) {
+    return std::nullopt;
+  }
+  std::optional<std::string> res =
+      KATANA_CHECKED(core_->part_header().OptionalDatastructureManifest(
+          kOptionalDatastructureReachabilityIndexPrimitive));
+
+  katana::ReachabilityIndexPrimitive index = KATANA_CHECKED_CONTEXT(
+      katana::ReachabilityIndexPrimitive::Load(rdg_dir(), res.value()),
+      "Failed to load ReachabilityIndexPrimitive located at {}", res.value());
+  return index;
+}
+
+katana::Result<void>
+katana::RDG::WriteReachabilityIndexPrimitive(
+    katana::ReachabilityIndexPrimitive& index) {
+  std::string path = KATANA_CHECKED(index.Write(rdg_dir()));
+  core_->part_header().RemoveOptionalDatastructureManifest(
+      kOptionalDatastructureReachabilityIndexPrimitive);
+  core_->part_header().AppendOptionalDatastructureManifest(
+      kOptionalDatastructureReachabilityIndexPrimitive, path);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::optional<katana::EntityIndexPrimitive>>
+katana::RDG::LoadEntityIndexPrimitive(const std::string& name) {
+  if (!core_->part_header().HasOptionalDatastructureManifest(name)) {
+    return std::nullopt;
+  }
+  std::optional<std::string> res =
+      KATANA_CHECKED(core_->part_header().OptionalDatastructureManifest(name));
+
+  katana::EntityIndexPrimitive index = KATANA_CHECKED_CONTEXT(
+      katana::EntityIndexPrimitive::Load(rdg_dir(), res.value()),
+      "Failed to load EntityIndexPrimitive located at {}", res.value());
+  return index;
+}
+
+void
+katana::RDG::UpsertEntityIndexPrimitive(
+    const std::string& name, katana::EntityIndexPrimitive&& index) {
+  pending_entity_indexes_.insert_or_assign(name, std::move(index));
+}
+
+void
+katana::RDG::RemoveEntityIndexPrimitive(const std::string& name) {
+  pending_entity_indexes_.erase(name);
+  core_->part_header().RemoveOptionalDatastructureManifest(name);
+}
+
+bool
+katana::RDG::HasEntityIndexPrimitive(const std::string& name) const {
+  return pending_entity_indexes_.count(name) != 0 ||
+         core_->part_header().HasOptionalDatastructureManifest(name);
+}
+
+katana::Result<void>
+katana::RDG::DoStoreEntityIndexPrimitives(const katana::URI& rdg_dir) {
+  for (auto& [name, index] : pending_entity_indexes_) {
+    std::string path = KATANA_CHECKED(index.Write(rdg_dir));
+    core_->part_header().RemoveOptionalDatastructureManifest(name);
+    core_->part_header().AppendOptionalDatastructureManifest(name, path);
+  }
+  pending_entity_indexes_.clear();
+
+  return katana::ResultSuccess();
+}
+
 katana::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {}
 
 katana::RDG::RDG() : core_(std::make_unique<RDGCore>()) {}
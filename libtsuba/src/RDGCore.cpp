@@ -6,6 +6,7 @@
 #include "katana/ErrorCode.h"
 #include "katana/ParquetReader.h"
 #include "katana/RDGPrefix.h"
+#include "katana/RawColumn.h"
 #include "katana/Result.h"
 
 namespace {
@@ -110,6 +111,13 @@ AddProperties(
 
 katana::Result<void>
 EnsureTypeLoaded(const katana::URI& rdg_dir, katana::PropStorageInfo* psi) {
+  if (!psi->type() && !psi->raw_path().empty()) {
+    // the raw column header is much cheaper to read than a Parquet footer
+    auto type_res = katana::ReadRawColumnType(rdg_dir.Join(psi->raw_path()));
+    if (type_res) {
+      psi->set_type(std::move(type_res.value()));
+    }
+  }
   if (!psi->type()) {
     auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
     KATANA_LOG_ASSERT(psi->IsAbsent());
@@ -85,6 +85,21 @@ public:
   uint32_t partition_id() const { return partition_id_; }
   void set_partition_id(uint32_t partition_id) { partition_id_ = partition_id; }
 
+  bool mmap_local_files() const { return mmap_local_files_; }
+  void set_mmap_local_files(bool mmap_local_files) {
+    mmap_local_files_ = mmap_local_files;
+  }
+
+  bool defer_topology() const { return defer_topology_; }
+  void set_defer_topology(bool defer_topology) {
+    defer_topology_ = defer_topology;
+  }
+
+  bool semi_external_topology() const { return semi_external_topology_; }
+  void set_semi_external_topology(bool semi_external_topology) {
+    semi_external_topology_ = semi_external_topology;
+  }
+
   std::shared_ptr<arrow::Schema> full_node_schema() const;
 
   const std::shared_ptr<arrow::Table>& node_properties() const {
@@ -312,6 +327,12 @@ private:
   katana::URI rdg_dir_;
   /// which partition of the graph was loaded
   uint32_t partition_id_{std::numeric_limits<uint32_t>::max()};
+  /// whether local topology files are memory mapped instead of read
+  bool mmap_local_files_{false};
+  /// whether the topology is loaded on first use
+  bool defer_topology_{false};
+  /// whether edge destinations are paged in from a mapped topology file
+  bool semi_external_topology_{false};
   // How this graph was derived from the previous version
   RDGLineage lineage_;
 };
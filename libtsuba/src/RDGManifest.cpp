@@ -1,6 +1,8 @@
 #include "katana/RDGManifest.h"
 
+#include <future>
 #include <sstream>
+#include <vector>
 
 #include "Constants.h"
 #include "GlobalState.h"
@@ -48,18 +50,14 @@ ToNodeString(uint32_t node_id) {
 const std::regex katana::RDGManifest::kManifestVersion(
     "katana_vers(?:([0-9]+))_(?:([0-9A-Za-z-]+))\\.manifest$");
 
+struct katana::RDGManifest::PartitionHeaderPrefetch {
+  katana::URI path;
+  std::shared_future<katana::CopyableResult<std::string>> contents;
+};
+
 katana::Result<katana::RDGManifest>
 katana::RDGManifest::MakeFromStorage(const katana::URI& uri) {
-  katana::FileView fv;
-
-  KATANA_CHECKED(fv.Bind(uri.string(), true));
-
   katana::RDGManifest manifest(uri.DirName());
-  auto manifest_res = katana::JsonParse<katana::RDGManifest>(fv, &manifest);
-
-  if (!manifest_res) {
-    return manifest_res.error().WithContext("cannot parse {}", uri.string());
-  }
 
   auto manifest_name = uri.BaseName();
   auto view_name = ParseViewNameFromName(manifest_name);
@@ -74,9 +72,48 @@ katana::RDGManifest::MakeFromStorage(const katana::URI& uri) {
   } else {
     manifest.set_viewargs(std::vector<std::string>());
   }
+
+  // The version in the name is the persisted one, so the partition header
+  // of this host can be read at the same time as the manifest
+  std::shared_ptr<PartitionHeaderPrefetch> prefetch;
+  if (auto version = ParseVersionFromName(manifest_name); version) {
+    manifest.set_version(version.value());
+    katana::URI partition_path = manifest.PartitionFileName(Comm()->Rank);
+    auto contents = std::async(
+        std::launch::async,
+        [partition_path]() -> katana::CopyableResult<std::string> {
+          return KATANA_CHECKED(RDGPartHeader::Read(partition_path));
+        });
+    prefetch = std::make_shared<PartitionHeaderPrefetch>(
+        PartitionHeaderPrefetch{partition_path, contents.share()});
+  }
+
+  katana::FileView fv;
+
+  KATANA_CHECKED(fv.Bind(uri.string(), true));
+
+  auto manifest_res = katana::JsonParse<katana::RDGManifest>(fv, &manifest);
+
+  if (!manifest_res) {
+    return manifest_res.error().WithContext("cannot parse {}", uri.string());
+  }
+
+  if (prefetch && manifest.num_hosts() > Comm()->Rank) {
+    manifest.partition_header_prefetch_ = std::move(prefetch);
+  }
   return manifest;
 }
 
+std::optional<katana::CopyableResult<std::string>>
+katana::RDGManifest::PrefetchedPartitionHeader(
+    const katana::URI& partition_path) const {
+  if (!partition_header_prefetch_ ||
+      partition_header_prefetch_->path != partition_path) {
+    return std::nullopt;
+  }
+  return partition_header_prefetch_->contents.get();
+}
+
 katana::Result<katana::RDGManifest>
 katana::RDGManifest::Make(
     const katana::URI& uri, const std::string& view_type, uint64_t version) {
@@ -243,14 +280,31 @@ katana::Result<std::set<std::string>>
 katana::RDGManifest::FileNames() {
   std::set<std::string> fnames{};
   fnames.emplace(FileName().BaseName());
+
+  // read the partition headers concurrently rather than one round trip to
+  // storage after another
+  std::vector<katana::URI> header_uris;
+  std::vector<std::future<katana::CopyableResult<std::string>>> contents;
+  for (auto i = 0U; i < num_hosts(); ++i) {
+    header_uris.emplace_back(KATANA_CHECKED(katana::URI::Make(fmt::format(
+        "{}/{}", dir(), PartitionFileName(view_specifier(), i, version())))));
+    contents.emplace_back(std::async(
+        std::launch::async,
+        [uri = header_uris.back()]() -> katana::CopyableResult<std::string> {
+          return KATANA_CHECKED(RDGPartHeader::Read(uri));
+        }));
+  }
+
   for (auto i = 0U; i < num_hosts(); ++i) {
     // All other file names are directory-local, so we pass an empty
     // directory instead of handle.impl_->rdg_manifest.path for the partition files
     fnames.emplace(PartitionFileName(view_specifier(), i, version()));
 
-    auto header_uri = KATANA_CHECKED(katana::URI::Make(fmt::format(
-        "{}/{}", dir(), PartitionFileName(view_specifier(), i, version()))));
-    auto header_res = RDGPartHeader::Make(header_uri);
+    const katana::URI& header_uri = header_uris[i];
+    auto header_res = [&]() -> katana::Result<RDGPartHeader> {
+      std::string data = KATANA_CHECKED(contents[i].get());
+      return RDGPartHeader::Make(header_uri, data);
+    }();
 
     if (!header_res) {
       KATANA_LOG_WARN(
@@ -261,11 +315,17 @@ katana::RDGManifest::FileNames() {
 
       for (const auto& node_prop : header.node_prop_info_list()) {
         fnames.emplace(node_prop.path());
+        if (!node_prop.raw_path().empty()) {
+          fnames.emplace(node_prop.raw_path());
+        }
         KATANA_CHECKED(AddPropertySubFiles(
             fnames, katana::URI::JoinPath(dir().string(), node_prop.path())));
       }
       for (const auto& edge_prop : header.edge_prop_info_list()) {
         fnames.emplace(edge_prop.path());
+        if (!edge_prop.raw_path().empty()) {
+          fnames.emplace(edge_prop.raw_path());
+        }
         KATANA_CHECKED(AddPropertySubFiles(
             fnames, katana::URI::JoinPath(dir().string(), edge_prop.path())));
       }
@@ -1,14 +1,19 @@
 #include "RDGPartHeader.h"
 
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 
 #include "Constants.h"
+#include "ContentAddress.h"
 #include "GlobalState.h"
 #include "PartitionTopologyMetadata.h"
 #include "RDGHandleImpl.h"
 #include "katana/CompilerSpecific.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Experimental.h"
 #include "katana/FaultTest.h"
@@ -61,17 +66,32 @@ const char* kOptionalDatastructuresKey = "kg.v1.optional_datastructures";
 // special partition property names
 
 katana::Result<void>
-CopyProperty(
-    katana::PropStorageInfo* prop, const katana::URI& old_location,
-    const katana::URI& new_location) {
-  katana::URI old_path = old_location.Join(prop->path());
-  katana::URI new_path = new_location.Join(prop->path());
+CopyFile(const katana::URI& old_path, const katana::URI& new_path) {
+  // a content addressed file already at the new location holds the same data
+  if (katana::IsContentAddressed(old_path.BaseName()) &&
+      KATANA_CHECKED(katana::SameSizeFileExists(old_path, new_path))) {
+    return katana::ResultSuccess();
+  }
   katana::FileView fv;
 
   KATANA_CHECKED(fv.Bind(old_path.string(), true));
   return katana::FileStore(new_path.string(), fv.ptr<uint8_t>(), fv.size());
 }
 
+katana::Result<void>
+CopyProperty(
+    katana::PropStorageInfo* prop, const katana::URI& old_location,
+    const katana::URI& new_location) {
+  KATANA_CHECKED(CopyFile(
+      old_location.Join(prop->path()), new_location.Join(prop->path())));
+  if (!prop->raw_path().empty()) {
+    KATANA_CHECKED(CopyFile(
+        old_location.Join(prop->raw_path()),
+        new_location.Join(prop->raw_path())));
+  }
+  return katana::ResultSuccess();
+}
+
 katana::PropStorageInfo*
 find_prop_info(
     const std::string& name, std::vector<katana::PropStorageInfo>* prop_infos) {
@@ -96,6 +116,10 @@ Parse(const std::string& str) {
   return val;
 }
 
+// Binary headers are this magic followed by the MessagePack encoding of the
+// JSON document. A JSON header starts with '{', so the two never collide.
+constexpr std::string_view kBinaryHeaderMagic("KTNPHDR\x01", 8);
+
 // Regex for partition files
 const std::regex kPartitionFile(
     "part_vers([0-9]+)_(rdg[0-9A-Za-z-]*)_node([0-9]+)$");
@@ -104,32 +128,84 @@ const int kPartitionMatchHostIndex = 3;
 }  // namespace
 
 katana::Result<katana::RDGPartHeader>
-katana::RDGPartHeader::MakeJson(const katana::URI& partition_path) {
+katana::RDGPartHeader::Make(const katana::URI& partition_path) {
   katana::FileView fv;
   KATANA_CHECKED(fv.Bind(partition_path.string(), true));
 
   if (fv.size() == 0) {
     return katana::RDGPartHeader();
   }
+  return Make(partition_path, std::string_view(fv.begin(), fv.size()));
+}
+
+katana::Result<katana::RDGPartHeader>
+katana::RDGPartHeader::Make(
+    const katana::URI& partition_path, std::string_view contents) {
+  if (contents.empty()) {
+    return katana::RDGPartHeader();
+  }
 
-  katana::RDGPartHeader header;
-  KATANA_CHECKED(katana::JsonParse<katana::RDGPartHeader>(fv, &header));
+  return KATANA_CHECKED_CONTEXT(
+      Deserialize(contents), "partition header {}", partition_path);
+}
 
-  return header;
+katana::Result<std::string>
+katana::RDGPartHeader::Read(const katana::URI& partition_path) {
+  katana::FileView fv;
+  KATANA_CHECKED(fv.Bind(partition_path.string(), true));
+
+  if (fv.size() == 0) {
+    return std::string();
+  }
+  return std::string(fv.begin(), fv.size());
 }
 
 katana::Result<katana::RDGPartHeader>
-katana::RDGPartHeader::Make(const katana::URI& partition_path) {
-  return KATANA_CHECKED(MakeJson(partition_path));
+katana::RDGPartHeader::Deserialize(std::string_view data) {
+  if (data.size() < kBinaryHeaderMagic.size() ||
+      data.compare(0, kBinaryHeaderMagic.size(), kBinaryHeaderMagic) != 0) {
+    return KATANA_CHECKED(katana::JsonParse<katana::RDGPartHeader>(data));
+  }
+
+  data.remove_prefix(kBinaryHeaderMagic.size());
+  try {
+    return json::from_msgpack(data.begin(), data.end())
+        .get<katana::RDGPartHeader>();
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        katana::ErrorCode::JSONParseFailed, "parsing binary header: {}",
+        exp.what());
+  }
+}
+
+katana::Result<std::string>
+katana::RDGPartHeader::Serialize(bool as_json) const {
+  bool env_json = false;
+  katana::GetEnv("KATANA_RDG_PART_HEADER_JSON", &env_json);
+  bool binary = storage_format_version_ >= kPartitionStorageFormatVersion7 ||
+                unstable_storage_format_;
+  if (as_json || env_json || !binary) {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    return serialized + "\n";
+  }
+
+  std::string serialized(kBinaryHeaderMagic);
+  try {
+    json::to_msgpack(json(*this), serialized);
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        katana::ErrorCode::JSONDumpFailed, "dumping binary header: {}",
+        exp.what());
+  }
+  return serialized;
 }
 
 katana::Result<std::unique_ptr<katana::FileFrame>>
 katana::RDGPartHeader::FillFileFrame(
     katana::RDGHandle handle,
     katana::RDG::RDGVersioningPolicy retain_version) const {
-  std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
-  // POSIX files end with newlines
-  serialized = serialized + "\n";
+  std::string serialized = KATANA_CHECKED(Serialize());
   TSUBA_PTP(internal::FaultSensitivity::Normal);
 
   auto ff = std::make_unique<katana::FileFrame>();
@@ -202,6 +278,12 @@ katana::RDGPartHeader::IsHeaderlessEntityTypeIDArray() const {
   return (storage_format_version_ >= kPartitionStorageFormatVersion4);
 }
 
+bool
+katana::RDGPartHeader::IsDataFormatLatest() const {
+  return IsEntityTypeIDsOutsideProperties() && IsUint16tEntityTypeIDs() &&
+         IsMetadataOutsideTopologyFile() && IsHeaderlessEntityTypeIDArray();
+}
+
 katana::Result<void>
 katana::RDGPartHeader::ValidateEntityTypeIDStructures() const {
   if (node_entity_type_id_array_path_.empty()) {
@@ -528,12 +610,60 @@ void
 katana::from_json(const nlohmann::json& j, katana::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name_);
   j.at(1).get_to(propmd.path_);
+  // the raw column path and the statistics were added later and are
+  // optional
+  if (j.size() > 2) {
+    j.at(2).get_to(propmd.raw_path_);
+  }
+  if (j.size() > 3) {
+    j.at(3).get_to(propmd.statistics_);
+  }
   propmd.state_ = PropStorageInfo::State::kAbsent;
 }
 
 void
 katana::to_json(json& j, const katana::PropStorageInfo& propmd) {
-  j = json{propmd.name(), propmd.path()};
+  if (!propmd.statistics().empty()) {
+    j = json{
+        propmd.name(), propmd.path(), propmd.raw_path(), propmd.statistics()};
+  } else if (!propmd.raw_path().empty()) {
+    j = json{propmd.name(), propmd.path(), propmd.raw_path()};
+  } else {
+    j = json{propmd.name(), propmd.path()};
+  }
+}
+
+void
+katana::to_json(json& j, const katana::RowGroupStatistics& stats) {
+  j = json{
+      {"offset", stats.offset},
+      {"num_rows", stats.num_rows},
+      {"null_count", stats.null_count},
+      {"distinct_count", stats.distinct_count},
+  };
+  // JSON has no infinities; a missing bound is unknown
+  if (std::isfinite(stats.min)) {
+    j["min"] = stats.min;
+  }
+  if (std::isfinite(stats.max)) {
+    j["max"] = stats.max;
+  }
+}
+
+void
+katana::from_json(const json& j, katana::RowGroupStatistics& stats) {
+  j.at("offset").get_to(stats.offset);
+  j.at("num_rows").get_to(stats.num_rows);
+  j.at("null_count").get_to(stats.null_count);
+  j.at("distinct_count").get_to(stats.distinct_count);
+  stats.min = -std::numeric_limits<double>::infinity();
+  stats.max = std::numeric_limits<double>::infinity();
+  if (auto it = j.find("min"); it != j.end()) {
+    it->get_to(stats.min);
+  }
+  if (auto it = j.find("max"); it != j.end()) {
+    it->get_to(stats.max);
+  }
 }
 
 void
@@ -731,6 +861,45 @@ katana::to_json(
       {"paths", index.paths_}};
 }
 
+void
+katana::from_json(
+    const nlohmann::json& j, katana::EntityIndexPrimitive& index) {
+  j.at("property_type").get_to(index.property_type_);
+  j.at("num_entities").get_to(index.num_entities_);
+  j.at("num_ids").get_to(index.num_ids_);
+  j.at("paths").get_to(index.paths_);
+}
+
+void
+katana::to_json(nlohmann::json& j, const katana::EntityIndexPrimitive& index) {
+  j = nlohmann::json{
+      {"property_type", index.property_type_},
+      {"num_entities", index.num_entities_},
+      {"num_ids", index.num_ids_},
+      {"paths", index.paths_}};
+}
+
+void
+katana::from_json(
+    const nlohmann::json& j, katana::ReachabilityIndexPrimitive& index) {
+  j.at("num_nodes").get_to(index.num_nodes_);
+  j.at("num_edges").get_to(index.num_edges_);
+  j.at("num_components").get_to(index.num_components_);
+  j.at("label_width").get_to(index.label_width_);
+  j.at("paths").get_to(index.paths_);
+}
+
+void
+katana::to_json(
+    nlohmann::json& j, const katana::ReachabilityIndexPrimitive& index) {
+  j = nlohmann::json{
+      {"num_nodes", index.num_nodes_},
+      {"num_edges", index.num_edges_},
+      {"num_components", index.num_components_},
+      {"label_width", index.label_width_},
+      {"paths", index.paths_}};
+}
+
 void
 katana::from_json(
     const nlohmann::json& j, katana::RDGOptionalDatastructure& data) {
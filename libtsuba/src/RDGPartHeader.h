@@ -7,6 +7,7 @@
 #include <optional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -18,11 +19,14 @@
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/PartitionMetadata.h"
+#include "katana/PropertyStatistics.h"
 #include "katana/RDG.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/RDKLSHIndexPrimitive.h"
 #include "katana/RDKSubstructureIndexPrimitive.h"
+#include "katana/ReachabilityIndexPrimitive.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/WriteGroup.h"
@@ -82,13 +86,19 @@ public:
 
   void WasModified(const std::shared_ptr<arrow::DataType>& type) {
     path_.clear();
+    raw_path_.clear();
+    statistics_.clear();
     state_ = State::kDirty;
     type_ = type;
   }
 
-  void WasWritten(std::string_view new_path) {
+  void WasWritten(
+      std::string_view new_path, std::string_view raw_path = {},
+      std::vector<RowGroupStatistics> statistics = {}) {
     KATANA_LOG_ASSERT(state_ == State::kDirty);
     path_ = new_path;
+    raw_path_ = raw_path;
+    statistics_ = std::move(statistics);
     state_ = State::kClean;
   }
 
@@ -105,6 +115,13 @@ public:
 
   const std::string& name() const { return name_; }
   const std::string& path() const { return path_; }
+  /// The raw column copy of this property, if any; see katana::RawColumnFormat
+  const std::string& raw_path() const { return raw_path_; }
+  /// Statistics of the row groups of the Parquet file at path(), if they
+  /// were recorded when it was written; see ParquetWriter::Statistics
+  const std::vector<RowGroupStatistics>& statistics() const {
+    return statistics_;
+  }
   const std::shared_ptr<arrow::DataType>& type() const { return type_; }
 
   // since we don't have type info in the header don't know the
@@ -125,6 +142,8 @@ public:
 private:
   std::string name_;
   std::string path_;
+  std::string raw_path_;
+  std::vector<RowGroupStatistics> statistics_;
   std::shared_ptr<arrow::DataType> type_;
   State state_;
 };
@@ -135,6 +154,24 @@ public:
 
   static katana::Result<RDGPartHeader> Make(const katana::URI& partition_path);
 
+  /// Decode the header that Read returned for \p partition_path
+  static katana::Result<RDGPartHeader> Make(
+      const katana::URI& partition_path, std::string_view contents);
+
+  /// \returns the contents of the header file at \p partition_path, which
+  /// Make decodes; reads may run on any thread
+  static katana::Result<std::string> Read(const katana::URI& partition_path);
+
+  /// Decode a header in either of the encodings of Serialize
+  static katana::Result<RDGPartHeader> Deserialize(std::string_view data);
+
+  /// Encode the header as it is stored. Headers at
+  /// kPartitionStorageFormatVersion7 and later, and unstable_storage_format
+  /// headers, are stored in a binary encoding unless as_json is set or the
+  /// environment variable KATANA_RDG_PART_HEADER_JSON is true; the JSON
+  /// encoding is the same document and is meant for debugging.
+  katana::Result<std::string> Serialize(bool as_json = false) const;
+
   katana::Result<void> Validate() const;
 
   katana::Result<void> Write(
@@ -157,6 +194,11 @@ public:
   bool IsUint16tEntityTypeIDs() const;
   bool IsMetadataOutsideTopologyFile() const;
   bool IsHeaderlessEntityTypeIDArray() const;
+  /// True if the files of the RDG are in the formats that the latest
+  /// storage_format_version stores, i.e., if all of the above are true, so
+  /// that only the part header changes when it is stored at the latest
+  /// version. Predicates for later format changes belong here too.
+  bool IsDataFormatLatest() const;
 
   //
   // Property manipulation
@@ -434,6 +476,12 @@ public:
     return std::nullopt;
   }
 
+  bool HasOptionalDatastructureManifest(
+      const std::string& optional_datastructure_name) const {
+    return optional_datastructure_manifests_.count(
+               optional_datastructure_name) != 0;
+  }
+
   void AppendOptionalDatastructureManifest(
       const std::string& optional_datastructure_name,
       const std::string& optional_datastructure_path) {
@@ -446,6 +494,17 @@ public:
         optional_datastructure_manifests_.size());
   }
 
+  /// Forget an optional datastructure, e.g., because the data it was built
+  /// from changed. Its files are left for garbage collection.
+  void RemoveOptionalDatastructureManifest(
+      const std::string& optional_datastructure_name) {
+    if (optional_datastructure_manifests_.erase(optional_datastructure_name)) {
+      KATANA_LOG_DEBUG(
+          "Removed optional datastructure manifest {}",
+          optional_datastructure_name);
+    }
+  }
+
   const std::unordered_map<std::string, std::string>&
   optional_datastructure_manifests() const {
     return optional_datastructure_manifests_;
@@ -506,9 +565,6 @@ private:
     return DoSelectProperties(storage_info);
   }
 
-  static katana::Result<RDGPartHeader> MakeJson(
-      const katana::URI& partition_path);
-
   katana::Result<std::unique_ptr<katana::FileFrame>> FillFileFrame(
       katana::RDGHandle handle,
       katana::RDG::RDGVersioningPolicy retain_version) const;
@@ -584,6 +640,9 @@ void from_json(const nlohmann::json& j, RDGPartHeader& header);
 void to_json(nlohmann::json& j, const PropStorageInfo& propmd);
 void from_json(const nlohmann::json& j, PropStorageInfo& propmd);
 
+void to_json(nlohmann::json& j, const RowGroupStatistics& stats);
+void from_json(const nlohmann::json& j, RowGroupStatistics& stats);
+
 void to_json(nlohmann::json& j, const PartitionMetadata& propmd);
 void from_json(const nlohmann::json& j, PartitionMetadata& propmd);
 
@@ -605,6 +664,12 @@ void from_json(const nlohmann::json& j, RDKLSHIndexPrimitive& index);
 void to_json(nlohmann::json& j, const RDKSubstructureIndexPrimitive& index);
 void from_json(const nlohmann::json& j, RDKSubstructureIndexPrimitive& index);
 
+void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
+void to_json(nlohmann::json& j, const ReachabilityIndexPrimitive& index);
+void from_json(const nlohmann::json& j, ReachabilityIndexPrimitive& index);
+
 void to_json(nlohmann::json& j, const RDGOptionalDatastructure& data);
 void from_json(const nlohmann::json& j, RDGOptionalDatastructure& data);
 
@@ -631,7 +696,9 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
     {{RDGTopology::NodeSortKind::kInvalid, "kInvalid"},
      {RDGTopology::NodeSortKind::kAny, "kAny"},
      {RDGTopology::NodeSortKind::kSortedByDegree, "kSortedByDegree"},
-     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"}})
+     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"},
+     {RDGTopology::NodeSortKind::kSortedByBFS, "kSortedByBFS"},
+     {RDGTopology::NodeSortKind::kSortedByRCM, "kSortedByRCM"}})
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
     RDGTopology::TopologyKind,
@@ -640,7 +707,8 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
      {RDGTopology::TopologyKind::kEdgeShuffleTopology, "kEdgeShuffleTopology"},
      {RDGTopology::TopologyKind::kShuffleTopology, "kShuffleTopology"},
      {RDGTopology::TopologyKind::kEdgeTypeAwareTopology,
-      "kEdgeTypeAwareTopology"}})
+      "kEdgeTypeAwareTopology"},
+     {RDGTopology::TopologyKind::kCompressedTopology, "kCompressedTopology"}})
 
 }  // namespace katana
 
@@ -153,6 +153,49 @@ unload_property(
   return katana::ResultSuccess();
 }
 
+/// Read only the parts of a CSR topology file that \p slice needs: the
+/// header, the adjacency indices of its nodes and the destinations of its
+/// edges. The file is laid out as
+/// [header (4 x uint64_t), adj_indices (num_nodes x uint64_t),
+///  dests (num_edges x uint32_t), ...]
+katana::Result<void>
+BindTopologySlice(
+    katana::RDGTopology* topo, const katana::URI& metadata_dir,
+    const katana::RDGSlice::SliceArg& slice) {
+  constexpr uint64_t kHeaderSize = 4 * sizeof(uint64_t);
+
+  if (topo->topology_state() != katana::RDGTopology::TopologyKind::kCSR) {
+    // the arrays of other layouts are not at fixed offsets
+    return topo->Bind(
+        metadata_dir, slice.topo_off, slice.topo_off + slice.topo_size, true);
+  }
+
+  KATANA_CHECKED(topo->Bind(metadata_dir, 0, kHeaderSize, false));
+
+  katana::FileView& file = topo->file_storage();
+  uint64_t adj_indices_begin = kHeaderSize;
+  uint64_t dests_begin =
+      adj_indices_begin + topo->num_nodes() * sizeof(uint64_t);
+  if (slice.node_range.first < slice.node_range.second) {
+    KATANA_CHECKED(file.Fill(
+        adj_indices_begin + slice.node_range.first * sizeof(uint64_t),
+        adj_indices_begin + slice.node_range.second * sizeof(uint64_t),
+        false));
+  }
+  if (slice.edge_range.first < slice.edge_range.second) {
+    KATANA_CHECKED(file.Fill(
+        dests_begin + slice.edge_range.first * sizeof(uint32_t),
+        dests_begin + slice.edge_range.second * sizeof(uint32_t), false));
+  }
+  // anything else the caller asked for, e.g., data past the dests
+  if (slice.topo_size > 0) {
+    KATANA_CHECKED(
+        file.Fill(slice.topo_off, slice.topo_off + slice.topo_size, false));
+  }
+
+  return file.WaitForFills();
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -172,10 +215,10 @@ katana::RDGSlice::DoMake(
       KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
 
   KATANA_CHECKED_CONTEXT(
-      topo->Bind(
-          metadata_dir, slice.topo_off, slice.topo_off + slice.topo_size, true),
-      "loading topology array; begin: {}, end: {}", slice.topo_off,
-      slice.topo_off + slice.topo_size);
+      BindTopologySlice(topo, metadata_dir, slice),
+      "loading topology of nodes [{}, {}) and edges [{}, {})",
+      slice.node_range.first, slice.node_range.second, slice.edge_range.first,
+      slice.edge_range.second);
 
   if (core_->part_header().IsEntityTypeIDsOutsideProperties()) {
     katana::URI node_types_path = metadata_dir.Join(
@@ -388,6 +431,71 @@ katana::RDGSlice::GetPerPartitionCounts(RDGHandle handle) {
   return {num_nodes_per_host, num_edges_per_host};
 }
 
+katana::Result<std::vector<katana::RDGSlice::SliceArg>>
+katana::RDGSlice::PlanSlices(
+    RDGHandle handle, uint32_t num_slices, uint32_t partition_id,
+    uint64_t node_weight, uint64_t edge_weight) {
+  if (num_slices == 0 || (node_weight == 0 && edge_weight == 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "need at least one slice and a nonzero weight");
+  }
+  const RDGManifest& manifest = handle.impl_->rdg_manifest();
+  auto part_header = KATANA_CHECKED(
+      RDGPartHeader::Make(manifest.PartitionFileName(partition_id)));
+  RDGCore core(std::move(part_header));
+  KATANA_CHECKED(core.MakeTopologyManager(manifest.dir()));
+
+  katana::RDGTopology shadow = katana::RDGTopology::MakeShadowCSR();
+  katana::RDGTopology* topo =
+      KATANA_CHECKED(core.topology_manager().GetTopology(shadow));
+  uint64_t num_nodes = topo->num_nodes();
+  uint64_t num_edges = topo->num_edges();
+
+  // the header and adj_indices, which hold the prefix sum of degrees
+  constexpr uint64_t kHeaderSize = 4 * sizeof(uint64_t);
+  KATANA_CHECKED_CONTEXT(
+      topo->Bind(
+          manifest.dir(), 0, kHeaderSize + num_nodes * sizeof(uint64_t), true),
+      "loading adjacency indices");
+  const uint64_t* adj_indices =
+      topo->file_storage().ptr<uint64_t>(kHeaderSize);
+  auto edges_before = [&](uint64_t node) -> uint64_t {
+    return node == 0 ? 0 : adj_indices[node - 1];
+  };
+  auto weight_before = [&](uint64_t node) -> uint64_t {
+    return node * node_weight + edges_before(node) * edge_weight;
+  };
+
+  uint64_t total_weight = weight_before(num_nodes);
+  std::vector<SliceArg> slices;
+  uint64_t begin = 0;
+  for (uint32_t i = 1; i <= num_slices; ++i) {
+    // first node whose weight before reaches the i-th share
+    uint64_t target = total_weight / num_slices * i +
+                      total_weight % num_slices * i / num_slices;
+    uint64_t lb = begin;
+    uint64_t ub = num_nodes;
+    while (lb < ub) {
+      uint64_t mid = lb + (ub - lb) / 2;
+      if (weight_before(mid) < target) {
+        lb = mid + 1;
+      } else {
+        ub = mid;
+      }
+    }
+    uint64_t end = i == num_slices ? num_nodes : lb;
+    slices.emplace_back(SliceArg{
+        std::make_pair(begin, end),
+        std::make_pair(edges_before(begin), edges_before(end)), 0, 0});
+    begin = end;
+  }
+  KATANA_LOG_DEBUG_ASSERT(edges_before(num_nodes) == num_edges);
+
+  KATANA_CHECKED(topo->unbind_file_storage());
+  return slices;
+}
+
 const katana::URI&
 katana::RDGSlice::rdg_dir() const {
   return core_->rdg_dir();
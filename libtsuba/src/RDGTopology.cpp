@@ -1,9 +1,15 @@
 #include "katana/RDGTopology.h"
 
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/outcome/detail/value_storage.hpp>
 #include <unicode/utypes.h>
@@ -15,6 +21,7 @@
 #include "katana/FaultTest.h"
 #include "katana/FileFrame.h"
 #include "katana/FileView.h"
+#include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/RDG.h"
 #include "katana/Result.h"
@@ -22,6 +29,94 @@
 #include "katana/config.h"
 #include "katana/tsuba.h"
 
+namespace {
+
+/// The contents of a topology file: header words and the arrays that follow
+/// them, at the offsets they have in the file
+class TopologyFileLayout {
+public:
+  void AddWords(std::initializer_list<uint64_t> words) {
+    for (uint64_t word : words) {
+      words_.emplace_back(size_, word);
+      size_ += sizeof(word);
+    }
+  }
+
+  void AddArray(const void* data, uint64_t nbytes) {
+    arrays_.push_back(
+        Region{size_, static_cast<const uint8_t*>(data), nbytes});
+    size_ += nbytes;
+  }
+
+  /// Like FileFrame::PaddedWrite, follow the array with zeros up to a
+  /// multiple of byte_boundary
+  void AddPaddedArray(
+      const void* data, uint64_t nbytes, size_t byte_boundary) {
+    AddArray(data, nbytes);
+    size_ += katana::FileFrame::calculate_padding_bytes(nbytes, byte_boundary);
+  }
+
+  /// Map the whole file once and copy the arrays into it in parallel
+  katana::Result<std::unique_ptr<katana::FileFrame>> Fill() const {
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->InitForParallelFill(size_));
+    for (const auto& [offset, word] : words_) {
+      KATANA_CHECKED(ff->WriteAt(offset, &word, sizeof(word)));
+    }
+
+    // Split large arrays so that threads share their copies
+    std::vector<Region> chunks;
+    for (const Region& array : arrays_) {
+      for (uint64_t begin = 0; begin < array.nbytes; begin += kChunkSize) {
+        chunks.push_back(Region{
+            array.offset + begin, array.data + begin,
+            std::min(kChunkSize, array.nbytes - begin)});
+      }
+    }
+
+    uint8_t* dest = KATANA_CHECKED(ff->ptr<uint8_t>());
+    katana::do_all(
+        katana::iterate(chunks.begin(), chunks.end()),
+        [&](const Region& chunk) {
+          std::memcpy(dest + chunk.offset, chunk.data, chunk.nbytes);
+        },
+        katana::no_stats());
+    return MakeResult(std::move(ff));
+  }
+
+private:
+  static constexpr uint64_t kChunkSize = uint64_t{1} << 22;
+
+  struct Region {
+    uint64_t offset;
+    const uint8_t* data;
+    uint64_t nbytes;
+  };
+
+  uint64_t size_{0};
+  std::vector<std::pair<uint64_t, uint64_t>> words_;
+  std::vector<Region> arrays_;
+};
+
+/// Topology file versions, which differ in the width of edge destinations
+constexpr uint64_t kNarrowDestsVersion = 1;
+constexpr uint64_t kWideDestsVersion = 2;
+
+/// Copy \p dests into an array of another width; the caller checks that the
+/// values fit
+template <typename To, typename From>
+std::shared_ptr<std::vector<To>>
+ConvertDests(const From* dests, uint64_t num_edges) {
+  auto converted = std::make_shared<std::vector<To>>(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { (*converted)[e] = static_cast<To>(dests[e]); },
+      katana::no_stats());
+  return converted;
+}
+
+}  // namespace
+
 std::string
 katana::RDGTopology::path() const {
   if (metadata_entry_valid()) {
@@ -85,6 +180,32 @@ katana::RDGTopology::Bind(const katana::URI& metadata_dir, bool resolve) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDGTopology::BindMapped(const katana::URI& metadata_dir) {
+  if (file_store_bound_) {
+    KATANA_LOG_WARN("topology already bound, nothing to do");
+    return katana::ResultSuccess();
+  }
+  if (path().empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Cannot bind topology with empty path");
+  }
+
+  katana::URI t_path = metadata_dir.Join(path());
+  if (t_path.scheme() != katana::URI::kFileScheme) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "only local topology files can be mapped: {}", t_path);
+  }
+  KATANA_LOG_DEBUG("mapping topology file at path {}", t_path.string());
+  KATANA_CHECKED(file_storage_.BindMapped(t_path.path()));
+
+  file_store_bound_ = true;
+  storage_valid_ = true;
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::RDGTopology::Bind(
     const katana::URI& metadata_dir, uint64_t begin, uint64_t end,
@@ -127,10 +248,21 @@ katana::RDGTopology::Map() {
         file_storage_.size(), min_size);
   }
 
-  if (data[0] != 1) {
+  const uint64_t version = data[0];
+  if (version != kNarrowDestsVersion && version != kWideDestsVersion) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument,
-        "first entry in the topology data array must be 1, is {}", data[0]);
+        "first entry in the topology data array must be 1 or 2, is {}",
+        version);
+  }
+  if constexpr (!std::is_same_v<Node, uint64_t>) {
+    if (data[2] > std::numeric_limits<Node>::max()) {
+      return KATANA_ERROR(
+          ErrorCode::NotImplemented,
+          "topology has {} nodes, which needs a build with "
+          "KATANA_USE_64BIT_NODE_IDS",
+          data[2]);
+    }
   }
 
   // ensure the data file matches the metadata
@@ -163,9 +295,33 @@ katana::RDGTopology::Map() {
 
   cursor += adj_indices_size;
 
-  dests_ = reinterpret_cast<const uint32_t*>(cursor);
-
-  cursor += (num_edges_ / 2 + num_edges_ % 2);
+  if (topology_state_ ==
+      katana::RDGTopology::TopologyKind::kCompressedTopology) {
+    num_compressed_blocks_ = cursor[0];
+    num_compressed_bytes_ = cursor[1];
+    cursor += 2;
+    compressed_block_offsets_ = cursor;
+    cursor += num_compressed_blocks_;
+    compressed_dests_ = reinterpret_cast<const uint8_t*>(cursor);
+    // the byte stream is padded to a uint64_t boundary
+    cursor += (num_compressed_bytes_ + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  } else {
+    const bool wide_dests = version == kWideDestsVersion;
+    if (wide_dests == std::is_same_v<Node, uint64_t>) {
+      dests_ = reinterpret_cast<const Node*>(cursor);
+    } else {
+      // the file is in the other width, so convert
+      auto converted =
+          wide_dests
+              ? ConvertDests<Node>(
+                    reinterpret_cast<const uint64_t*>(cursor), num_edges_)
+              : ConvertDests<Node>(
+                    reinterpret_cast<const uint32_t*>(cursor), num_edges_);
+      dests_ = converted->data();
+      converted_dests_ = std::move(converted);
+    }
+    cursor += wide_dests ? num_edges_ : (num_edges_ / 2 + num_edges_ % 2);
+  }
 
   if (metadata_entry_->edge_index_to_property_index_map_present_) {
     KATANA_LOG_VASSERT(
@@ -211,7 +367,8 @@ katana::RDGTopology::Map() {
          FileFrame::calculate_padding_bytes(num_nodes_, sizeof(uint64_t)));
   }
 
-  size_t expected_size = GetGraphSize();
+  size_t expected_size = GetGraphSize(
+      version == kWideDestsVersion ? sizeof(uint64_t) : sizeof(uint32_t));
   if (file_storage_.size() < expected_size) {
     return KATANA_ERROR(
         katana::ErrorCode::InvalidArgument,
@@ -305,14 +462,25 @@ katana::RDGTopology::DoStore(
         "EdgeSortKind={}, NodeSortKind={}",
         topology_state_, transpose_state_, edge_sort_state_, node_sort_state_);
 
-    auto ff = std::make_unique<katana::FileFrame>();
-    KATANA_CHECKED(ff->Init());
-
-    uint64_t data[4] = {1, 0, num_nodes_, num_edges_};
-    arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
-    if (!aro_sts.ok()) {
-      return katana::ArrowToKatana(aro_sts.code());
+    // The size of the file is known up front, so lay it out first and then
+    // fill it in parallel
+    // Destinations are 32 bits in the file whenever the node indexes fit,
+    // whatever the width of Node
+    const bool wide_dests =
+        num_nodes_ > std::numeric_limits<uint32_t>::max();
+    if (wide_dests && !std::is_same_v<Node, uint64_t>) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "cannot store {} nodes without KATANA_USE_64BIT_NODE_IDS",
+          num_nodes_);
     }
+    TopologyFileLayout layout;
+    layout.AddWords(
+        {wide_dests ? kWideDestsVersion : kNarrowDestsVersion, 0, num_nodes_,
+         num_edges_});
+    // dests_ in the width of the file if it differs from Node; must outlive
+    // layout.Fill()
+    std::shared_ptr<const void> stored_dests;
 
     if (num_nodes_) {
       if (edge_condensed_type_id_map_size_ > 0) {
@@ -335,27 +503,48 @@ katana::RDGTopology::DoStore(
           adj_indices_size);
 
       if (adj_indices_size > 0) {
-        auto buf = arrow::Buffer::Wrap(raw, adj_indices_size);
-        aro_sts = ff->Write(buf);
-        if (!aro_sts.ok()) {
-          return katana::ArrowToKatana(aro_sts.code());
-        }
+        layout.AddArray(raw, adj_indices_size * sizeof(*raw));
       }
     }
 
-    if (num_edges_) {
+    if (topology_state_ ==
+        katana::RDGTopology::TopologyKind::kCompressedTopology) {
+      KATANA_LOG_DEBUG(
+          "Storing RDGTopology to file. Writing compressed dests, blocks = {}, "
+          "bytes = {}",
+          num_compressed_blocks_, num_compressed_bytes_);
+
+      layout.AddWords({num_compressed_blocks_, num_compressed_bytes_});
+
+      if (num_compressed_blocks_) {
+        layout.AddArray(
+            compressed_block_offsets_,
+            num_compressed_blocks_ * sizeof(*compressed_block_offsets_));
+      }
+
+      if (num_compressed_bytes_) {
+        layout.AddPaddedArray(
+            compressed_dests_,
+            num_compressed_bytes_ * sizeof(*compressed_dests_),
+            sizeof(uint64_t));
+      }
+    } else if (num_edges_) {
       KATANA_LOG_VASSERT(
           dests_ != nullptr, "Cannot store an RDGTopology with null dests_");
-      const auto* raw = dests_;
-      static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint32_t>);
-
       KATANA_LOG_DEBUG(
           "Storing RDGTopology to file. Writing dests, size = {}", num_edges_);
 
-      auto buf = arrow::Buffer::Wrap(raw, num_edges_);
-      KATANA_CHECKED_CONTEXT(
-          ff->PaddedWrite(buf, sizeof(uint64_t)),
-          "Failed to write dests to file frame");
+      if constexpr (std::is_same_v<Node, uint32_t>) {
+        layout.AddPaddedArray(
+            dests_, num_edges_ * sizeof(*dests_), sizeof(uint64_t));
+      } else if (wide_dests) {
+        layout.AddArray(dests_, num_edges_ * sizeof(*dests_));
+      } else {
+        auto narrow = ConvertDests<uint32_t>(dests_, num_edges_);
+        layout.AddPaddedArray(
+            narrow->data(), num_edges_ * sizeof(uint32_t), sizeof(uint64_t));
+        stored_dests = std::move(narrow);
+      }
     }
 
     if (edge_index_to_property_index_map_ != nullptr && num_edges_) {
@@ -365,20 +554,12 @@ katana::RDGTopology::DoStore(
           num_edges_);
 
       // first write the magic number
-      uint64_t data[1] = {num_nodes_ + num_edges_};
-      arrow::Status aro_sts = ff->Write(&data, 1 * sizeof(uint64_t));
-      if (!aro_sts.ok()) {
-        return katana::ArrowToKatana(aro_sts.code());
-      }
+      layout.AddWords({num_nodes_ + num_edges_});
 
       // edge property index map is uint64_t map[num_edges]
       const auto* raw = edge_index_to_property_index_map_;
       static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint64_t>);
-      auto buf = arrow::Buffer::Wrap(raw, num_edges_);
-      aro_sts = ff->Write(buf);
-      if (!aro_sts.ok()) {
-        return katana::ArrowToKatana(aro_sts.code());
-      }
+      layout.AddArray(raw, num_edges_ * sizeof(*raw));
     }
 
     if (node_index_to_property_index_map_ != nullptr && num_nodes_) {
@@ -388,20 +569,12 @@ katana::RDGTopology::DoStore(
           num_nodes_);
 
       // first write the magic number
-      uint64_t data[1] = {num_nodes_ + num_edges_};
-      arrow::Status aro_sts = ff->Write(&data, 1 * sizeof(uint64_t));
-      if (!aro_sts.ok()) {
-        return katana::ArrowToKatana(aro_sts.code());
-      }
+      layout.AddWords({num_nodes_ + num_edges_});
 
       // node property index map is uint64_t map[num_nodes]
       const auto* raw = node_index_to_property_index_map_;
       static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint64_t>);
-      auto buf = arrow::Buffer::Wrap(raw, num_nodes_);
-      aro_sts = ff->Write(buf);
-      if (!aro_sts.ok()) {
-        return katana::ArrowToKatana(aro_sts.code());
-      }
+      layout.AddArray(raw, num_nodes_ * sizeof(*raw));
     }
 
     if (edge_condensed_type_id_map_ != nullptr && num_edges_) {
@@ -411,21 +584,15 @@ katana::RDGTopology::DoStore(
           edge_condensed_type_id_map_size_);
 
       // first write the magic number
-      uint64_t data[1] = {num_nodes_ + num_edges_};
-      arrow::Status aro_sts = ff->Write(&data, 1 * sizeof(uint64_t));
-      if (!aro_sts.ok()) {
-        return katana::ArrowToKatana(aro_sts.code());
-      }
+      layout.AddWords({num_nodes_ + num_edges_});
 
-      // node property index map is uint64_t map[num_nodes]
       const auto* raw = edge_condensed_type_id_map_;
       static_assert(
           std::is_same_v<std::decay_t<decltype(*raw)>, katana::EntityTypeID>);
-      auto buf = arrow::Buffer::Wrap(raw, edge_condensed_type_id_map_size_);
       // pad to nearest uint64_t aka 8 byte boundry
-      KATANA_CHECKED_CONTEXT(
-          ff->PaddedWrite(buf, sizeof(uint64_t)),
-          "Failed to write edge_condensed_type_id_map to file frame");
+      layout.AddPaddedArray(
+          raw, edge_condensed_type_id_map_size_ * sizeof(*raw),
+          sizeof(uint64_t));
     }
 
     if (node_condensed_type_id_map_ != nullptr && num_nodes_) {
@@ -435,23 +602,20 @@ katana::RDGTopology::DoStore(
           node_condensed_type_id_map_size_);
 
       // first write the magic number
-      uint64_t data[1] = {num_nodes_ + num_edges_};
-      arrow::Status aro_sts = ff->Write(&data, 1 * sizeof(uint64_t));
-      if (!aro_sts.ok()) {
-        return katana::ArrowToKatana(aro_sts.code());
-      }
+      layout.AddWords({num_nodes_ + num_edges_});
 
-      // node property index map is uint64_t map[num_nodes]
       const auto* raw = node_condensed_type_id_map_;
       static_assert(
           std::is_same_v<std::decay_t<decltype(*raw)>, katana::EntityTypeID>);
-      auto buf = arrow::Buffer::Wrap(raw, node_condensed_type_id_map_size_);
       // pad to nearest uint64_t aka 8 byte boundry
-      KATANA_CHECKED_CONTEXT(
-          ff->PaddedWrite(buf, sizeof(uint64_t)),
-          "Failed to write node_condensed_type_id_map to file frame");
+      layout.AddPaddedArray(
+          raw, node_condensed_type_id_map_size_ * sizeof(*raw),
+          sizeof(uint64_t));
     }
 
+    std::unique_ptr<katana::FileFrame> ff = KATANA_CHECKED_CONTEXT(
+        layout.Fill(), "Failed to write topology to file frame");
+
     //TODO: emcginnis need different naming schemes for the optional topologies?
     // add "epi_npi_eti_nti" to name?
     katana::URI path_uri = MakeTopologyFileName(handle);
@@ -570,7 +734,7 @@ katana::RDGTopology::MakeShadowCSR() {
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::DoMake(
     katana::RDGTopology topo, const uint64_t* adj_indices, uint64_t num_nodes,
-    const uint32_t* dests, uint64_t num_edges,
+    const Node* dests, uint64_t num_edges,
     katana::RDGTopology::TopologyKind topology_state,
     katana::RDGTopology::TransposeKind transpose_state,
     katana::RDGTopology::EdgeSortKind edge_sort_state,
@@ -589,7 +753,7 @@ katana::RDGTopology::DoMake(
 
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::Make(
-    const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+    const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
     uint64_t num_edges, katana::RDGTopology::TopologyKind topology_state,
     katana::RDGTopology::TransposeKind transpose_state,
     katana::RDGTopology::EdgeSortKind edge_sort_state,
@@ -605,7 +769,7 @@ katana::RDGTopology::Make(
 
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::Make(
-    const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+    const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
     uint64_t num_edges, katana::RDGTopology::TopologyKind topology_state,
     katana::RDGTopology::TransposeKind transpose_state,
     katana::RDGTopology::EdgeSortKind edge_sort_state,
@@ -623,7 +787,7 @@ katana::RDGTopology::Make(
 
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::Make(
-    const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+    const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
     uint64_t num_edges, katana::RDGTopology::TopologyKind topology_state,
     katana::RDGTopology::TransposeKind transpose_state,
     katana::RDGTopology::EdgeSortKind edge_sort_state,
@@ -646,7 +810,7 @@ katana::RDGTopology::Make(
 
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::Make(
-    const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+    const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
     uint64_t num_edges, katana::RDGTopology::TopologyKind topology_state,
     katana::RDGTopology::TransposeKind transpose_state,
     katana::RDGTopology::EdgeSortKind edge_sort_state,
@@ -668,7 +832,7 @@ katana::RDGTopology::Make(
 
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::Make(
-    const uint64_t* adj_indices, uint64_t num_nodes, const uint32_t* dests,
+    const uint64_t* adj_indices, uint64_t num_nodes, const Node* dests,
     uint64_t num_edges, katana::RDGTopology::TopologyKind topology_state,
     katana::RDGTopology::TransposeKind transpose_state,
     katana::RDGTopology::EdgeSortKind edge_sort_state,
@@ -696,6 +860,29 @@ katana::RDGTopology::Make(
       transpose_state, edge_sort_state, node_sort_state);
 }
 
+katana::Result<katana::RDGTopology>
+katana::RDGTopology::Make(
+    const uint64_t* adj_indices, uint64_t num_nodes, uint64_t num_edges,
+    katana::RDGTopology::TransposeKind transpose_state,
+    katana::RDGTopology::EdgeSortKind edge_sort_state,
+    const uint64_t* edge_index_to_property_index_map,
+    uint64_t num_compressed_blocks, const uint64_t* compressed_block_offsets,
+    uint64_t num_compressed_bytes, const uint8_t* compressed_dests) {
+  RDGTopology topo = RDGTopology();
+  topo.edge_index_to_property_index_map_ = edge_index_to_property_index_map;
+  topo.num_compressed_blocks_ = num_compressed_blocks;
+  topo.compressed_block_offsets_ = compressed_block_offsets;
+  topo.num_compressed_bytes_ = num_compressed_bytes;
+  topo.compressed_dests_ = compressed_dests;
+
+  // when we make from in memory objects, mark storage as invalid
+  topo.storage_valid_ = false;
+  return DoMake(
+      std::move(topo), adj_indices, num_nodes, nullptr, num_edges,
+      TopologyKind::kCompressedTopology, transpose_state, edge_sort_state,
+      NodeSortKind::kAny);
+}
+
 katana::Result<katana::RDGTopology>
 katana::RDGTopology::Make(katana::PartitionTopologyMetadataEntry* entry) {
   RDGTopology topo = RDGTopology(entry);
@@ -718,11 +905,18 @@ katana::RDGTopology::Make(katana::PartitionTopologyMetadataEntry* entry) {
 }
 
 size_t
-katana::RDGTopology::GetGraphSize() const {
+katana::RDGTopology::GetGraphSize(size_t dest_size) const {
   /// version, sizeof_edge_data, num_nodes, num_edges
   constexpr int mandatory_fields = 4;
-  size_t graphsize = (mandatory_fields + num_nodes_) * sizeof(uint64_t) +
-                     (num_edges_ * sizeof(uint32_t));
+  size_t graphsize = (mandatory_fields + num_nodes_) * sizeof(uint64_t);
+  if (topology_state_ ==
+      katana::RDGTopology::TopologyKind::kCompressedTopology) {
+    // num_blocks, num_bytes, block offsets and the padded byte stream
+    graphsize += (2 + num_compressed_blocks_) * sizeof(uint64_t) +
+                 num_compressed_bytes_;
+  } else {
+    graphsize += num_edges_ * dest_size;
+  }
 
   KATANA_LOG_DEBUG("Base graph size = {}", graphsize);
 
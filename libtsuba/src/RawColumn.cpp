@@ -0,0 +1,462 @@
+#include "katana/RawColumn.h"
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <type_traits>
+
+#include <arrow/array/concatenate.h>
+#include <arrow/array/util.h>
+#include <arrow/util/compression.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/FaultTest.h"
+#include "katana/FileFrame.h"
+#include "katana/FileView.h"
+#include "katana/Logging.h"
+
+namespace {
+
+// "KRAWCOL1" read as a little endian integer
+constexpr uint64_t kRawColumnMagic = UINT64_C(0x314c4f435741524b);
+constexpr uint32_t kRawColumnVersion = 1;
+constexpr uint64_t kRawColumnAlignment = 64;
+
+/// On storage layout of a raw column. Offsets are from the start of the file
+/// and sizes are what is stored, i.e., after compression
+struct RawColumnHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t format;
+  int32_t type_id;
+  int32_t byte_width;
+  int64_t length;
+  int64_t null_count;
+  uint64_t validity_offset;
+  uint64_t validity_size;
+  uint64_t values_offset;
+  uint64_t values_size;
+};
+static_assert(std::is_trivially_copyable_v<RawColumnHeader>);
+
+constexpr uint64_t
+AlignUp(uint64_t n) {
+  return (n + kRawColumnAlignment - 1) & ~(kRawColumnAlignment - 1);
+}
+
+constexpr uint64_t kHeaderBytes = AlignUp(sizeof(RawColumnHeader));
+
+int32_t
+ByteWidth(const arrow::DataType& type) {
+  return static_cast<const arrow::FixedWidthType&>(type).bit_width() / 8;
+}
+
+uint64_t
+ValidityBytes(int64_t length) {
+  return (length + 7) / 8;
+}
+
+katana::Result<std::shared_ptr<arrow::DataType>>
+MakeType(int32_t type_id, int32_t byte_width) {
+  std::shared_ptr<arrow::DataType> type;
+  switch (type_id) {
+  case arrow::Type::INT8:
+    type = arrow::int8();
+    break;
+  case arrow::Type::UINT8:
+    type = arrow::uint8();
+    break;
+  case arrow::Type::INT16:
+    type = arrow::int16();
+    break;
+  case arrow::Type::UINT16:
+    type = arrow::uint16();
+    break;
+  case arrow::Type::INT32:
+    type = arrow::int32();
+    break;
+  case arrow::Type::UINT32:
+    type = arrow::uint32();
+    break;
+  case arrow::Type::INT64:
+    type = arrow::int64();
+    break;
+  case arrow::Type::UINT64:
+    type = arrow::uint64();
+    break;
+  case arrow::Type::FLOAT:
+    type = arrow::float32();
+    break;
+  case arrow::Type::DOUBLE:
+    type = arrow::float64();
+    break;
+  case arrow::Type::FIXED_SIZE_BINARY:
+    if (byte_width <= 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "fixed size binary column with width {}", byte_width);
+    }
+    type = arrow::fixed_size_binary(byte_width);
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unsupported raw column type {}",
+        type_id);
+  }
+  if (ByteWidth(*type) != byte_width) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "raw column of {} has width {} instead of {}", type->ToString(),
+        byte_width, ByteWidth(*type));
+  }
+  return type;
+}
+
+katana::Result<std::unique_ptr<arrow::util::Codec>>
+MakeCodec() {
+  return KATANA_CHECKED(
+      arrow::util::Codec::Create(arrow::Compression::LZ4_FRAME));
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Compress(
+    arrow::util::Codec* codec, const std::shared_ptr<arrow::Buffer>& input) {
+  int64_t max_size = codec->MaxCompressedLen(input->size(), input->data());
+  std::shared_ptr<arrow::ResizableBuffer> output =
+      KATANA_CHECKED(arrow::AllocateResizableBuffer(max_size));
+  int64_t size = KATANA_CHECKED(codec->Compress(
+      input->size(), input->data(), max_size, output->mutable_data()));
+  KATANA_CHECKED(output->Resize(size));
+  return std::shared_ptr<arrow::Buffer>(std::move(output));
+}
+
+katana::Result<void>
+PaddedWrite(katana::FileFrame* ff, const arrow::Buffer& buffer) {
+  static const uint8_t kZeroes[kRawColumnAlignment] = {};
+  KATANA_CHECKED(ff->Write(buffer.data(), buffer.size()));
+  uint64_t size = buffer.size();
+  KATANA_CHECKED(ff->Write(kZeroes, AlignUp(size) - size));
+  return katana::ResultSuccess();
+}
+
+/// Serialize \p array, which must have no offset, into \p ff
+katana::Result<void>
+FillRawColumn(
+    const arrow::Array& array, katana::RawColumnFormat format,
+    katana::FileFrame* ff) {
+  const arrow::ArrayData& data = *array.data();
+  KATANA_LOG_DEBUG_ASSERT(data.offset == 0);
+
+  RawColumnHeader header{};
+  header.magic = kRawColumnMagic;
+  header.version = kRawColumnVersion;
+  header.format = static_cast<uint32_t>(format);
+  header.type_id = array.type_id();
+  header.byte_width = ByteWidth(*array.type());
+  header.length = array.length();
+  header.null_count = array.null_count();
+
+  std::shared_ptr<arrow::Buffer> validity =
+      KATANA_CHECKED(arrow::AllocateBuffer(0));
+  std::shared_ptr<arrow::Buffer> values = validity;
+  if (header.null_count > 0) {
+    validity =
+        arrow::SliceBuffer(data.buffers[0], 0, ValidityBytes(header.length));
+  }
+  if (header.length > 0) {
+    values = arrow::SliceBuffer(
+        data.buffers[1], 0, header.length * header.byte_width);
+  }
+
+  if (format == katana::RawColumnFormat::kLZ4Frame) {
+    auto codec = KATANA_CHECKED(MakeCodec());
+    if (validity->size() > 0) {
+      validity = KATANA_CHECKED(Compress(codec.get(), validity));
+    }
+    if (values->size() > 0) {
+      values = KATANA_CHECKED(Compress(codec.get(), values));
+    }
+  }
+
+  header.validity_offset = kHeaderBytes;
+  header.validity_size = validity->size();
+  header.values_offset = header.validity_offset + AlignUp(validity->size());
+  header.values_size = values->size();
+
+  KATANA_CHECKED(PaddedWrite(
+      ff, arrow::Buffer(
+              reinterpret_cast<const uint8_t*>(&header), sizeof(header))));
+  KATANA_CHECKED(PaddedWrite(ff, *validity));
+  KATANA_CHECKED(PaddedWrite(ff, *values));
+  return katana::ResultSuccess();
+}
+
+/// An Arrow buffer that points into a FileView and keeps it alive
+class FileViewBuffer : public arrow::Buffer {
+public:
+  FileViewBuffer(
+      std::shared_ptr<katana::FileView> view, uint64_t offset, int64_t size)
+      : arrow::Buffer(view->ptr<uint8_t>(offset), size),
+        view_(std::move(view)) {}
+
+private:
+  std::shared_ptr<katana::FileView> view_;
+};
+
+/// \returns the \p size bytes of \p view starting at \p offset, reading them
+/// from storage if they are not there yet
+katana::Result<std::shared_ptr<arrow::Buffer>>
+ViewRange(
+    const std::shared_ptr<katana::FileView>& view, uint64_t offset,
+    uint64_t size) {
+  if (size == 0) {
+    std::shared_ptr<arrow::Buffer> empty =
+        KATANA_CHECKED(arrow::AllocateBuffer(0));
+    return empty;
+  }
+  if (!view->file_backed()) {
+    KATANA_CHECKED(view->Fill(offset, offset + size, true));
+  }
+  return std::shared_ptr<arrow::Buffer>(
+      std::make_shared<FileViewBuffer>(view, offset, size));
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+Decompress(
+    arrow::util::Codec* codec, const std::shared_ptr<katana::FileView>& view,
+    uint64_t offset, uint64_t size, uint64_t decompressed_size) {
+  if (decompressed_size == 0) {
+    std::shared_ptr<arrow::Buffer> empty =
+        KATANA_CHECKED(arrow::AllocateBuffer(0));
+    return empty;
+  }
+  auto input = KATANA_CHECKED(ViewRange(view, offset, size));
+  std::shared_ptr<arrow::Buffer> output =
+      KATANA_CHECKED(arrow::AllocateBuffer(decompressed_size));
+  int64_t out_size = KATANA_CHECKED(codec->Decompress(
+      input->size(), input->data(), output->size(), output->mutable_data()));
+  if (static_cast<uint64_t>(out_size) != decompressed_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "decompressed {} bytes but expected {}", out_size, decompressed_size);
+  }
+  return output;
+}
+
+katana::Result<RawColumnHeader>
+ReadHeader(const katana::FileView& view) {
+  if (view.size() < sizeof(RawColumnHeader)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "file of {} bytes is too small to be a raw column", view.size());
+  }
+  RawColumnHeader header;
+  std::memcpy(&header, view.ptr<uint8_t>(), sizeof(header));
+
+  if (header.magic != kRawColumnMagic) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "not a raw column file");
+  }
+  if (header.version != kRawColumnVersion) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "unsupported raw column version {}", header.version);
+  }
+  auto format = static_cast<katana::RawColumnFormat>(header.format);
+  if (format != katana::RawColumnFormat::kUncompressed &&
+      format != katana::RawColumnFormat::kLZ4Frame) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown raw column format {}",
+        header.format);
+  }
+  if (header.length < 0 || header.null_count < 0 ||
+      header.null_count > header.length) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "bad raw column length {} or null count {}", header.length,
+        header.null_count);
+  }
+  if (header.validity_offset + header.validity_size > view.size() ||
+      header.values_offset + header.values_size > view.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "raw column data extends past the end of the file");
+  }
+  if (format == katana::RawColumnFormat::kUncompressed &&
+      (header.validity_size !=
+           (header.null_count > 0 ? ValidityBytes(header.length) : 0) ||
+       header.values_size !=
+           static_cast<uint64_t>(header.length) * header.byte_width)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "raw column sizes do not match its length");
+  }
+  return header;
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+DoReadRawColumn(
+    const katana::URI& uri, std::optional<katana::ParquetReader::Slice> slice,
+    bool map_local_file) {
+  auto view = std::make_shared<katana::FileView>();
+  if (map_local_file && uri.scheme() == katana::URI::kFileScheme) {
+    KATANA_CHECKED(view->BindMapped(uri.path()));
+  } else {
+    KATANA_CHECKED(view->Bind(uri.string(), 0, sizeof(RawColumnHeader), true));
+  }
+
+  RawColumnHeader header = KATANA_CHECKED(ReadHeader(*view));
+  auto type = KATANA_CHECKED(MakeType(header.type_id, header.byte_width));
+
+  int64_t offset = 0;
+  int64_t length = header.length;
+  if (slice) {
+    offset = std::clamp<int64_t>(slice->offset, 0, header.length);
+    length = std::clamp<int64_t>(slice->length, 0, header.length - offset);
+  }
+
+  if (static_cast<katana::RawColumnFormat>(header.format) ==
+      katana::RawColumnFormat::kUncompressed) {
+    // Only read the rows that were asked for. Start on a byte of the validity
+    // bitmap and let the array offset skip the leading rows in that byte
+    int64_t first = offset & ~INT64_C(7);
+    int64_t array_offset = offset - first;
+    int64_t num_rows = array_offset + length;
+
+    std::shared_ptr<arrow::Buffer> validity;
+    if (header.null_count > 0) {
+      validity = KATANA_CHECKED(ViewRange(
+          view, header.validity_offset + first / 8, ValidityBytes(num_rows)));
+    }
+    auto values = KATANA_CHECKED(ViewRange(
+        view, header.values_offset + first * header.byte_width,
+        num_rows * header.byte_width));
+
+    int64_t null_count = header.null_count;
+    if (null_count > 0 && length != header.length) {
+      null_count = arrow::kUnknownNullCount;
+    }
+    return arrow::MakeArray(arrow::ArrayData::Make(
+        type, length, {validity, values}, null_count, array_offset));
+  }
+
+  auto codec = KATANA_CHECKED(MakeCodec());
+  std::shared_ptr<arrow::Buffer> validity;
+  if (header.null_count > 0) {
+    validity = KATANA_CHECKED(Decompress(
+        codec.get(), view, header.validity_offset, header.validity_size,
+        ValidityBytes(header.length)));
+  }
+  auto values = KATANA_CHECKED(Decompress(
+      codec.get(), view, header.values_offset, header.values_size,
+      header.length * header.byte_width));
+
+  std::shared_ptr<arrow::Array> array = arrow::MakeArray(arrow::ArrayData::Make(
+      type, header.length, {validity, values}, header.null_count));
+  if (length == header.length) {
+    return array;
+  }
+  // copy the slice so the rest of the column can be freed
+  return KATANA_CHECKED(arrow::Concatenate({array->Slice(offset, length)}));
+}
+
+}  // namespace
+
+bool
+katana::IsRawColumnType(const arrow::DataType& type) {
+  switch (type.id()) {
+  case arrow::Type::INT8:
+  case arrow::Type::UINT8:
+  case arrow::Type::INT16:
+  case arrow::Type::UINT16:
+  case arrow::Type::INT32:
+  case arrow::Type::UINT32:
+  case arrow::Type::INT64:
+  case arrow::Type::UINT64:
+  case arrow::Type::FLOAT:
+  case arrow::Type::DOUBLE:
+  case arrow::Type::FIXED_SIZE_BINARY:
+    return true;
+  default:
+    return false;
+  }
+}
+
+katana::Result<void>
+katana::WriteRawColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const katana::URI& uri,
+    RawColumnFormat format, katana::WriteGroup* group) {
+  if (format == RawColumnFormat::kNone) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "no raw column format was given");
+  }
+  if (!IsRawColumnType(*array->type())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "{} cannot be stored as a raw column",
+        array->type()->ToString());
+  }
+
+  uint64_t accounted_size = 0;
+  if (group) {
+    for (const auto& chunk : array->chunks()) {
+      accounted_size += katana::ApproxArrayMemUse(chunk);
+    }
+    group->WaitForRoom(accounted_size);
+  }
+
+  std::shared_ptr<arrow::Array> flat;
+  if (array->num_chunks() == 0) {
+    flat = KATANA_CHECKED(arrow::MakeArrayOfNull(array->type(), 0));
+  } else if (array->num_chunks() == 1 && array->chunk(0)->offset() == 0) {
+    flat = array->chunk(0);
+  } else {
+    flat = KATANA_CHECKED(arrow::Concatenate(array->chunks()));
+  }
+
+  auto ff = std::make_shared<katana::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+  ff->Bind(uri.string());
+
+  auto future = std::async(
+      std::launch::async,
+      [flat = std::move(flat), ff = std::move(ff),
+       format]() mutable -> katana::CopyableResult<void> {
+        KATANA_CHECKED(FillRawColumn(*flat, format, ff.get()));
+        flat.reset();
+
+        TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
+        KATANA_CHECKED(ff->Persist());
+
+        return katana::CopyableResultSuccess();
+      });
+
+  if (!group) {
+    KATANA_CHECKED(future.get());
+    return katana::ResultSuccess();
+  }
+
+  group->AddOp(std::move(future), uri.string(), accounted_size);
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::DataType>>
+katana::ReadRawColumnType(const katana::URI& uri) {
+  katana::FileView view;
+  KATANA_CHECKED_CONTEXT(
+      view.Bind(uri.string(), 0, sizeof(RawColumnHeader), true), "binding {}",
+      uri);
+  RawColumnHeader header = KATANA_CHECKED_CONTEXT(ReadHeader(view), "{}", uri);
+  return MakeType(header.type_id, header.byte_width);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::ReadRawColumn(
+    const std::string& name, const katana::URI& uri,
+    std::optional<ParquetReader::Slice> slice, bool map_local_file) {
+  std::shared_ptr<arrow::Array> array = KATANA_CHECKED_CONTEXT(
+      DoReadRawColumn(uri, slice, map_local_file), "reading {}", uri);
+  KATANA_CHECKED_CONTEXT(array->Validate(), "validating {}", uri);
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, array->type())}), {array});
+}
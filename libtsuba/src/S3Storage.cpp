@@ -0,0 +1,964 @@
+#include "S3Storage.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/HTTP.h"
+#include "katana/Logging.h"
+#include "katana/Time.h"
+
+namespace {
+
+constexpr std::string_view kS3Scheme = "s3://";
+constexpr std::chrono::milliseconds kRetryBackoff{50};
+/// bound on the error response bodies kept for error messages
+constexpr size_t kMaxErrorBody = 4096;
+
+std::future<katana::CopyableResult<void>>
+MakeReady(katana::CopyableResult<void> res) {
+  std::promise<katana::CopyableResult<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
+std::string
+DecodeXmlEntities(std::string_view str) {
+  static const std::pair<std::string_view, char> kEntities[] = {
+      {"&amp;", '&'}, {"&lt;", '<'},   {"&gt;", '>'},
+      {"&quot;", '"'}, {"&apos;", '\''},
+  };
+  std::string decoded;
+  decoded.reserve(str.size());
+  for (size_t i = 0; i < str.size();) {
+    bool replaced = false;
+    if (str[i] == '&') {
+      for (const auto& [entity, c] : kEntities) {
+        if (str.substr(i, entity.size()) == entity) {
+          decoded += c;
+          i += entity.size();
+          replaced = true;
+          break;
+        }
+      }
+    }
+    if (!replaced) {
+      decoded += str[i++];
+    }
+  }
+  return decoded;
+}
+
+std::string
+EscapeXml(std::string_view str) {
+  std::string escaped;
+  for (char c : str) {
+    switch (c) {
+    case '&':
+      escaped += "&amp;";
+      break;
+    case '<':
+      escaped += "&lt;";
+      break;
+    case '>':
+      escaped += "&gt;";
+      break;
+    case '"':
+      escaped += "&quot;";
+      break;
+    default:
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+bool
+StartsWithNoCase(std::string_view str, std::string_view prefix) {
+  if (str.size() < prefix.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < prefix.size(); ++i) {
+    if (std::tolower(static_cast<unsigned char>(str[i])) !=
+        std::tolower(static_cast<unsigned char>(prefix[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string_view
+Trim(std::string_view str) {
+  while (!str.empty() && std::isspace(static_cast<unsigned char>(str[0]))) {
+    str.remove_prefix(1);
+  }
+  while (!str.empty() &&
+         std::isspace(static_cast<unsigned char>(str.back()))) {
+    str.remove_suffix(1);
+  }
+  return str;
+}
+
+katana::CopyableResult<void>
+ToCopyable(katana::Result<void> res) {
+  if (!res) {
+    return katana::CopyableErrorInfo{res.error()};
+  }
+  return katana::CopyableResultSuccess();
+}
+
+/// The directory prefix of a key for listing: empty or ending in '/'
+std::string
+DirectoryPrefix(const std::string& key) {
+  if (key.empty() || key.back() == '/') {
+    return key;
+  }
+  return key + '/';
+}
+
+}  // namespace
+
+katana::Result<katana::S3Object>
+katana::ParseS3URI(const std::string& uri) {
+  if (uri.compare(0, kS3Scheme.size(), kS3Scheme) != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "not an s3 URI: {}", uri);
+  }
+  std::string rest = uri.substr(kS3Scheme.size());
+  size_t slash = rest.find('/');
+  S3Object object;
+  object.bucket = rest.substr(0, slash);
+  if (slash != std::string::npos) {
+    object.key = rest.substr(slash + 1);
+  }
+  if (object.bucket.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "s3 URI has no bucket: {}", uri);
+  }
+  return object;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>>
+katana::SplitIntoParts(uint64_t start, uint64_t size, uint64_t part_size) {
+  std::vector<std::pair<uint64_t, uint64_t>> parts;
+  part_size = std::max<uint64_t>(part_size, 1);
+  for (uint64_t offset = 0; offset < size; offset += part_size) {
+    parts.emplace_back(start + offset, std::min(part_size, size - offset));
+  }
+  return parts;
+}
+
+std::vector<std::string>
+katana::XmlElements(std::string_view xml, std::string_view tag) {
+  std::string open = "<" + std::string(tag) + ">";
+  std::string close = "</" + std::string(tag) + ">";
+  std::vector<std::string> elements;
+  size_t pos = 0;
+  while ((pos = xml.find(open, pos)) != std::string_view::npos) {
+    size_t begin = pos + open.size();
+    size_t end = xml.find(close, begin);
+    if (end == std::string_view::npos) {
+      break;
+    }
+    elements.emplace_back(DecodeXmlEntities(xml.substr(begin, end - begin)));
+    pos = end + close.size();
+  }
+  return elements;
+}
+
+std::string
+katana::UrlEncode(std::string_view str, bool keep_slash) {
+  static constexpr char kHex[] = "0123456789ABCDEF";
+  std::string encoded;
+  for (char c : str) {
+    auto u = static_cast<unsigned char>(c);
+    if (std::isalnum(u) || c == '-' || c == '_' || c == '.' || c == '~' ||
+        (keep_slash && c == '/')) {
+      encoded += c;
+    } else {
+      encoded += '%';
+      encoded += kHex[u >> 4];
+      encoded += kHex[u & 0xf];
+    }
+  }
+  return encoded;
+}
+
+std::string
+katana::MakeS3URL(
+    const std::string& endpoint, bool virtual_host, const std::string& bucket,
+    const std::string& key, const std::string& query) {
+  std::string url;
+  std::string key_path = "/" + UrlEncode(key, true);
+  if (virtual_host) {
+    size_t scheme_end = endpoint.find("://");
+    size_t host_begin = scheme_end == std::string::npos ? 0 : scheme_end + 3;
+    url = endpoint.substr(0, host_begin) + bucket + "." +
+          endpoint.substr(host_begin) + key_path;
+  } else {
+    url = endpoint + "/" + bucket + key_path;
+  }
+  if (!query.empty()) {
+    url += "?" + query;
+  }
+  return url;
+}
+
+/// A curl handle borrowed from the pool for one request; idle handles keep
+/// their connections open
+class katana::S3Storage::HandleLease {
+public:
+  explicit HandleLease(S3Storage* storage) : storage_(storage) {
+    {
+      std::lock_guard<std::mutex> lock(storage_->handles_mutex_);
+      if (!storage_->idle_handles_.empty()) {
+        handle_ = storage_->idle_handles_.back();
+        storage_->idle_handles_.pop_back();
+      }
+    }
+    if (handle_ == nullptr) {
+      handle_ = curl_easy_init();
+    } else {
+      curl_easy_reset(handle_);
+    }
+  }
+  HandleLease(const HandleLease& no_copy) = delete;
+  HandleLease& operator=(const HandleLease& no_copy) = delete;
+  ~HandleLease() {
+    if (handle_ != nullptr) {
+      std::lock_guard<std::mutex> lock(storage_->handles_mutex_);
+      storage_->idle_handles_.emplace_back(handle_);
+    }
+  }
+
+  CURL* get() const { return handle_; }
+
+private:
+  S3Storage* storage_;
+  CURL* handle_{nullptr};
+};
+
+namespace {
+
+struct Transfer {
+  CURL* handle;
+  const uint8_t* upload;
+  uint64_t upload_size;
+  uint64_t upload_pos{0};
+  uint8_t* download;
+  uint64_t download_size;
+  std::string* response_body;
+  int64_t* status;
+  std::string* etag;
+  uint64_t* content_length;
+  uint64_t* bytes;
+  std::string* error_body;
+  bool overflow{false};
+};
+
+size_t
+WriteCB(char* ptr, size_t size, size_t nmemb, void* user_data) {
+  auto* transfer = static_cast<Transfer*>(user_data);
+  size_t real_size = size * nmemb;
+  long status = 0;
+  curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &status);
+  if (status >= 300) {
+    size_t keep = std::min(
+        real_size, kMaxErrorBody - std::min(
+                                       kMaxErrorBody,
+                                       transfer->error_body->size()));
+    transfer->error_body->append(ptr, keep);
+    return real_size;
+  }
+  if (transfer->download != nullptr) {
+    if (*transfer->bytes + real_size > transfer->download_size) {
+      // the server ignored the range
+      transfer->overflow = true;
+      return 0;
+    }
+    std::memcpy(transfer->download + *transfer->bytes, ptr, real_size);
+  } else if (transfer->response_body != nullptr) {
+    transfer->response_body->append(ptr, real_size);
+  }
+  *transfer->bytes += real_size;
+  return real_size;
+}
+
+size_t
+ReadCB(char* buffer, size_t size, size_t nitems, void* user_data) {
+  auto* transfer = static_cast<Transfer*>(user_data);
+  size_t len = std::min<uint64_t>(
+      size * nitems, transfer->upload_size - transfer->upload_pos);
+  std::memcpy(buffer, transfer->upload + transfer->upload_pos, len);
+  transfer->upload_pos += len;
+  return len;
+}
+
+size_t
+HeaderCB(char* buffer, size_t size, size_t nitems, void* user_data) {
+  auto* transfer = static_cast<Transfer*>(user_data);
+  size_t real_size = size * nitems;
+  std::string_view line(buffer, real_size);
+  if (StartsWithNoCase(line, "HTTP/")) {
+    // a new response, e.g., after 100 Continue
+    transfer->etag->clear();
+    *transfer->content_length = 0;
+  } else if (StartsWithNoCase(line, "etag:")) {
+    *transfer->etag = std::string(Trim(line.substr(5)));
+  } else if (StartsWithNoCase(line, "content-length:")) {
+    std::string value(Trim(line.substr(15)));
+    *transfer->content_length = std::strtoull(value.c_str(), nullptr, 10);
+  }
+  return real_size;
+}
+
+}  // namespace
+
+katana::S3Storage::~S3Storage() {
+  for (void* handle : idle_handles_) {
+    curl_easy_cleanup(handle);
+  }
+}
+
+katana::Result<void>
+katana::S3Storage::Init() {
+  KATANA_CHECKED(katana::HttpInit());
+
+  int connections = kDefaultConnections;
+  katana::GetEnv("KATANA_S3_CONNECTIONS", &connections);
+  int part_size_mb = static_cast<int>(kDefaultPartSize >> 20);
+  katana::GetEnv("KATANA_S3_PART_SIZE_MB", &part_size_mb);
+  part_size_ = std::max<uint64_t>(
+      static_cast<uint64_t>(std::max(part_size_mb, 0)) << 20, kMinPartSize);
+
+  if (!katana::GetEnv("AWS_REGION", &region_) &&
+      !katana::GetEnv("AWS_DEFAULT_REGION", &region_)) {
+    region_ = "us-east-1";
+  }
+  if (katana::GetEnv("KATANA_S3_ENDPOINT", &endpoint_) && !endpoint_.empty()) {
+    while (!endpoint_.empty() && endpoint_.back() == '/') {
+      endpoint_.pop_back();
+    }
+    virtual_host_ = false;
+  } else {
+    endpoint_ = "https://s3." + region_ + ".amazonaws.com";
+    virtual_host_ = true;
+  }
+  katana::GetEnv("AWS_ACCESS_KEY_ID", &access_key_);
+  katana::GetEnv("AWS_SECRET_ACCESS_KEY", &secret_key_);
+  katana::GetEnv("AWS_SESSION_TOKEN", &session_token_);
+
+  queue_ = std::make_unique<IOQueue>(std::max(connections, 1));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::S3Storage::Fini() {
+  queue_.reset();
+  std::lock_guard<std::mutex> lock(handles_mutex_);
+  for (void* handle : idle_handles_) {
+    curl_easy_cleanup(handle);
+  }
+  idle_handles_.clear();
+  return katana::ResultSuccess();
+}
+
+std::string
+katana::S3Storage::URL(const S3Object& object, const std::string& query) const {
+  return MakeS3URL(endpoint_, virtual_host_, object.bucket, object.key, query);
+}
+
+katana::S3Storage::Span
+katana::S3Storage::StartSpan(
+    const std::string& name, const std::string& uri) const {
+  auto& tracer = katana::GetTracer();
+  Span span = tracer.StartSpan(name, tracer.GetActiveSpan().GetContext());
+  span->SetTags({{"uri", uri}});
+  return span;
+}
+
+katana::Result<void>
+katana::S3Storage::PerformOnce(
+    const Request& request, Response* response, bool* retryable) {
+  *response = Response{};
+  *retryable = false;
+
+  HandleLease lease(this);
+  CURL* handle = lease.get();
+  if (handle == nullptr) {
+    return KATANA_ERROR(ErrorCode::HTTPError, "curl_easy_init failed");
+  }
+
+  Transfer transfer{
+      handle,
+      request.upload,
+      request.upload_size,
+      0,
+      request.download,
+      request.download_size,
+      request.response_body,
+      &response->status,
+      &response->etag,
+      &response->content_length,
+      &response->bytes,
+      &response->error_body};
+  if (request.response_body != nullptr) {
+    request.response_body->clear();
+  }
+
+  auto set = [&](CURLoption option, auto param) -> katana::Result<void> {
+    if (auto err = curl_easy_setopt(handle, option, param); err != CURLE_OK) {
+      return KATANA_ERROR(
+          ErrorCode::HTTPError, "CURL error: {}", curl_easy_strerror(err));
+    }
+    return katana::ResultSuccess();
+  };
+
+  KATANA_CHECKED(set(CURLOPT_URL, request.url.c_str()));
+  KATANA_CHECKED(set(CURLOPT_NOSIGNAL, 1L));
+  KATANA_CHECKED(set(CURLOPT_TCP_KEEPALIVE, 1L));
+  KATANA_CHECKED(set(CURLOPT_WRITEFUNCTION, WriteCB));
+  KATANA_CHECKED(set(CURLOPT_WRITEDATA, &transfer));
+  KATANA_CHECKED(set(CURLOPT_HEADERFUNCTION, HeaderCB));
+  KATANA_CHECKED(set(CURLOPT_HEADERDATA, &transfer));
+
+  if (request.method == "HEAD") {
+    KATANA_CHECKED(set(CURLOPT_NOBODY, 1L));
+  } else if (request.method == "PUT") {
+    KATANA_CHECKED(set(CURLOPT_UPLOAD, 1L));
+    KATANA_CHECKED(set(CURLOPT_READFUNCTION, ReadCB));
+    KATANA_CHECKED(set(CURLOPT_READDATA, &transfer));
+    KATANA_CHECKED(set(
+        CURLOPT_INFILESIZE_LARGE,
+        static_cast<curl_off_t>(request.upload_size)));
+  } else if (request.method == "POST") {
+    KATANA_CHECKED(set(CURLOPT_POST, 1L));
+    KATANA_CHECKED(set(CURLOPT_POSTFIELDS, request.upload));
+    KATANA_CHECKED(set(
+        CURLOPT_POSTFIELDSIZE_LARGE,
+        static_cast<curl_off_t>(request.upload_size)));
+  } else if (request.method != "GET") {
+    KATANA_CHECKED(set(CURLOPT_CUSTOMREQUEST, request.method.c_str()));
+  }
+
+  struct curl_slist* headers = nullptr;
+  for (const auto& header : request.headers) {
+    headers = curl_slist_append(headers, header.c_str());
+  }
+  // curl waits for 100 Continue on large uploads, a round trip S3 does not
+  // need
+  headers = curl_slist_append(headers, "Expect:");
+  if (!access_key_.empty() && !secret_key_.empty()) {
+#if LIBCURL_VERSION_NUM >= 0x074b00
+    std::string sigv4 = "aws:amz:" + region_ + ":s3";
+    std::string userpwd = access_key_ + ":" + secret_key_;
+    headers =
+        curl_slist_append(headers, "x-amz-content-sha256: UNSIGNED-PAYLOAD");
+    if (!session_token_.empty()) {
+      headers = curl_slist_append(
+          headers, ("x-amz-security-token: " + session_token_).c_str());
+    }
+    KATANA_CHECKED(set(CURLOPT_AWS_SIGV4, sigv4.c_str()));
+    KATANA_CHECKED(set(CURLOPT_USERPWD, userpwd.c_str()));
+#else
+    curl_slist_free_all(headers);
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "signing S3 requests needs libcurl 7.75 or newer");
+#endif
+  }
+  auto set_headers = set(CURLOPT_HTTPHEADER, headers);
+  CURLcode code =
+      set_headers ? curl_easy_perform(handle) : CURLE_FAILED_INIT;
+  curl_slist_free_all(headers);
+  KATANA_CHECKED(set_headers);
+
+  if (code != CURLE_OK) {
+    if (transfer.overflow) {
+      return KATANA_ERROR(
+          ErrorCode::S3Error, "{} {}: response longer than requested",
+          request.method, request.url);
+    }
+    *retryable = true;
+    return KATANA_ERROR(
+        ErrorCode::S3Error, "{} {}: {}", request.method, request.url,
+        curl_easy_strerror(code));
+  }
+
+  long status = 0;
+  curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+  response->status = status;
+  if (status >= 200 && status < 300) {
+    return katana::ResultSuccess();
+  }
+  // like reads of local files, ranged reads may stop at the end of the
+  // object; S3 answers 416 when the range starts past it
+  if (status == 416 && request.download != nullptr) {
+    return katana::ResultSuccess();
+  }
+
+  std::vector<std::string> codes = XmlElements(response->error_body, "Code");
+  std::string s3_code = codes.empty() ? "" : codes.front();
+  if (status == 404) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "{} {}: not found", request.method, request.url);
+  }
+  if (s3_code == "PermanentRedirect" ||
+      s3_code == "AuthorizationHeaderMalformed") {
+    return KATANA_ERROR(
+        ErrorCode::AWSWrongRegion, "{} {}: {}; region is {}", request.method,
+        request.url, s3_code, region_);
+  }
+  *retryable = status >= 500 || status == 429;
+  return KATANA_ERROR(
+      ErrorCode::S3Error, "{} {}: HTTP {} {}", request.method, request.url,
+      status, s3_code);
+}
+
+katana::Result<katana::S3Storage::Response>
+katana::S3Storage::Perform(const Request& request, const Span& span) {
+  Response response;
+  for (uint32_t attempt = 1;; ++attempt) {
+    auto start = katana::Now();
+    bool retryable = false;
+    auto res = PerformOnce(request, &response, &retryable);
+    if (span) {
+      span->Log(
+          "s3 request", {
+                            {"method", request.method},
+                            {"url", request.url},
+                            {"status", response.status},
+                            {"bytes", response.bytes + request.upload_size},
+                            {"latency_us", katana::UsSince(start)},
+                            {"attempt", attempt},
+                        });
+    }
+    if (res) {
+      return response;
+    }
+    if (!retryable || attempt == kMaxAttempts) {
+      if (span) {
+        span->SetError();
+      }
+      return res.error();
+    }
+    std::this_thread::sleep_for(kRetryBackoff * (1 << (attempt - 1)));
+  }
+}
+
+std::future<katana::CopyableResult<void>>
+katana::S3Storage::RunPieces(std::vector<Piece> pieces) {
+  if (!queue_ || pieces.size() <= 1) {
+    return std::async(
+        std::launch::deferred,
+        [pieces = std::move(pieces)]() -> katana::CopyableResult<void> {
+          for (const auto& piece : pieces) {
+            if (auto res = piece(); !res) {
+              return res;
+            }
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  futures.reserve(pieces.size());
+  for (auto& piece : pieces) {
+    futures.emplace_back(queue_->Submit(std::move(piece)));
+  }
+  return std::async(
+      std::launch::deferred,
+      [futures = std::move(futures)]() mutable -> katana::CopyableResult<void> {
+        katana::CopyableResult<void> res = katana::CopyableResultSuccess();
+        for (auto& future : futures) {
+          if (auto piece_res = future.get(); !piece_res && res) {
+            res = std::move(piece_res);
+          }
+        }
+        return res;
+      });
+}
+
+katana::Result<void>
+katana::S3Storage::Stat(const std::string& uri, StatBuf* s_buf) {
+  S3Object object = KATANA_CHECKED(ParseS3URI(uri));
+  Request request;
+  request.method = "HEAD";
+  request.url = URL(object, "");
+  Response response = KATANA_CHECKED(Perform(request, nullptr));
+  s_buf->size = response.content_length;
+  s_buf->version = response.etag;
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::S3Storage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  auto object_res = ParseS3URI(uri);
+  if (!object_res) {
+    return MakeReady(katana::CopyableErrorInfo{object_res.error()});
+  }
+  if (size == 0) {
+    return MakeReady(katana::CopyableResultSuccess());
+  }
+  S3Object object = std::move(object_res.value());
+  Span span = StartSpan("s3 get", uri);
+  span->SetTags({{"start", start}, {"size", size}});
+
+  std::vector<Piece> pieces;
+  for (const auto& [offset, length] : SplitIntoParts(start, size, part_size_)) {
+    uint64_t part_offset = offset;
+    uint64_t part_length = length;
+    pieces.emplace_back([this, object, span, start, result_buf, part_offset,
+                         part_length]() -> katana::CopyableResult<void> {
+      Request request;
+      request.url = URL(object, "");
+      request.headers.emplace_back(fmt::format(
+          "Range: bytes={}-{}", part_offset, part_offset + part_length - 1));
+      request.download = result_buf + (part_offset - start);
+      request.download_size = part_length;
+      auto res = Perform(request, span);
+      if (!res) {
+        return katana::CopyableErrorInfo{res.error()};
+      }
+      return katana::CopyableResultSuccess();
+    });
+  }
+  return RunPieces(std::move(pieces));
+}
+
+katana::Result<void>
+katana::S3Storage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  KATANA_CHECKED(GetAsync(uri, start, size, result_buf).get());
+  return katana::ResultSuccess();
+}
+
+uint64_t
+katana::S3Storage::UploadPartSize(uint64_t size) const {
+  return std::max(part_size_, (size + kMaxParts - 1) / kMaxParts);
+}
+
+std::future<katana::CopyableResult<void>>
+katana::S3Storage::MultipartUpload(
+    const S3Object& object, uint64_t size, const Span& span,
+    std::function<katana::Result<void>(
+        const std::string&, uint64_t, uint64_t, uint64_t, std::string*)>
+        upload_part) {
+  std::string upload_id;
+  {
+    std::string body;
+    Request request;
+    request.method = "POST";
+    request.url = URL(object, "uploads");
+    request.response_body = &body;
+    auto res = Perform(request, span);
+    if (!res) {
+      return MakeReady(katana::CopyableErrorInfo{res.error()});
+    }
+    std::vector<std::string> ids = XmlElements(body, "UploadId");
+    if (ids.empty()) {
+      return MakeReady(KATANA_ERROR(
+          ErrorCode::S3Error, "no UploadId in response to {}", request.url));
+    }
+    upload_id = ids.front();
+  }
+
+  auto parts = SplitIntoParts(0, size, UploadPartSize(size));
+  auto etags = std::make_shared<std::vector<std::string>>(parts.size());
+  std::vector<Piece> pieces;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    uint64_t offset = parts[i].first;
+    uint64_t length = parts[i].second;
+    pieces.emplace_back([upload_part, upload_id, etags, i, offset,
+                         length]() -> katana::CopyableResult<void> {
+      return ToCopyable(
+          upload_part(upload_id, i + 1, offset, length, &(*etags)[i]));
+    });
+  }
+  auto uploaded = RunPieces(std::move(pieces));
+
+  // completing waits for the parts, so it happens in the caller when it
+  // waits for the upload, never on the queue
+  return std::async(
+      std::launch::deferred,
+      [this, object, span, upload_id, etags,
+       uploaded = std::move(uploaded)]() mutable
+      -> katana::CopyableResult<void> {
+        auto res = uploaded.get();
+        if (!res) {
+          Request abort;
+          abort.method = "DELETE";
+          abort.url = URL(object, "uploadId=" + UrlEncode(upload_id, false));
+          if (auto abort_res = Perform(abort, span); !abort_res) {
+            KATANA_LOG_WARN(
+                "could not abort upload to {}: {}", abort.url,
+                abort_res.error());
+          }
+          return res;
+        }
+
+        std::string body = "<CompleteMultipartUpload>";
+        for (size_t i = 0; i < etags->size(); ++i) {
+          body += fmt::format(
+              "<Part><PartNumber>{}</PartNumber><ETag>{}</ETag></Part>", i + 1,
+              EscapeXml((*etags)[i]));
+        }
+        body += "</CompleteMultipartUpload>";
+
+        std::string response_body;
+        Request complete;
+        complete.method = "POST";
+        complete.url =
+            URL(object, "uploadId=" + UrlEncode(upload_id, false));
+        complete.headers.emplace_back("Content-Type: application/xml");
+        complete.upload = reinterpret_cast<const uint8_t*>(body.data());
+        complete.upload_size = body.size();
+        complete.response_body = &response_body;
+        auto complete_res = Perform(complete, span);
+        if (!complete_res) {
+          return katana::CopyableErrorInfo{complete_res.error()};
+        }
+        // S3 may report a failure to complete with status 200
+        if (!XmlElements(response_body, "Error").empty()) {
+          return KATANA_ERROR(
+              ErrorCode::S3Error, "completing upload to {} failed: {}",
+              complete.url, response_body);
+        }
+        return katana::CopyableResultSuccess();
+      });
+}
+
+std::future<katana::CopyableResult<void>>
+katana::S3Storage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  auto object_res = ParseS3URI(uri);
+  if (!object_res) {
+    return MakeReady(katana::CopyableErrorInfo{object_res.error()});
+  }
+  S3Object object = std::move(object_res.value());
+  Span span = StartSpan("s3 put", uri);
+  span->SetTags({{"size", size}});
+
+  if (size <= part_size_) {
+    std::vector<Piece> pieces;
+    pieces.emplace_back(
+        [this, object, span, data, size]() -> katana::CopyableResult<void> {
+          Request request;
+          request.method = "PUT";
+          request.url = URL(object, "");
+          request.upload = data;
+          request.upload_size = size;
+          auto res = Perform(request, span);
+          if (!res) {
+            return katana::CopyableErrorInfo{res.error()};
+          }
+          return katana::CopyableResultSuccess();
+        });
+    return RunPieces(std::move(pieces));
+  }
+
+  return MultipartUpload(
+      object, size, span,
+      [this, object, span, data](
+          const std::string& upload_id, uint64_t part_number, uint64_t offset,
+          uint64_t length, std::string* etag) -> katana::Result<void> {
+        Request request;
+        request.method = "PUT";
+        request.url = URL(
+            object, fmt::format(
+                        "partNumber={}&uploadId={}", part_number,
+                        UrlEncode(upload_id, false)));
+        request.upload = data + offset;
+        request.upload_size = length;
+        Response response = KATANA_CHECKED(Perform(request, span));
+        *etag = response.etag;
+        return katana::ResultSuccess();
+      });
+}
+
+katana::Result<void>
+katana::S3Storage::PutMultiSync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  KATANA_CHECKED(PutAsync(uri, data, size).get());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::S3Storage::RemoteCopy(
+    const std::string& source_uri, const std::string& dest_uri,
+    uint64_t begin, uint64_t size) {
+  S3Object source = KATANA_CHECKED(ParseS3URI(source_uri));
+  S3Object dest = KATANA_CHECKED(ParseS3URI(dest_uri));
+  Span span = StartSpan("s3 copy", dest_uri);
+  span->SetTags({{"source", source_uri}, {"begin", begin}, {"size", size}});
+  std::string copy_source = "x-amz-copy-source: /" + source.bucket + "/" +
+                            UrlEncode(source.key, true);
+
+  StatBuf source_stat;
+  KATANA_CHECKED(Stat(source_uri, &source_stat));
+  if (begin + size > source_stat.size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "copying [{}, {}) of {} bytes of {}",
+        begin, begin + size, source_stat.size, source_uri);
+  }
+
+  if (size == 0) {
+    return PutMultiSync(dest_uri, nullptr, 0);
+  }
+  if (begin == 0 && size == source_stat.size && size <= kMaxSinglePutSize) {
+    // server side copy of the whole object
+    std::string body;
+    Request request;
+    request.method = "PUT";
+    request.url = URL(dest, "");
+    request.headers.emplace_back(copy_source);
+    request.response_body = &body;
+    KATANA_CHECKED(Perform(request, span));
+    if (!XmlElements(body, "Error").empty()) {
+      return KATANA_ERROR(
+          ErrorCode::S3Error, "copying {} to {} failed: {}", source_uri,
+          dest_uri, body);
+    }
+    return katana::ResultSuccess();
+  }
+
+  // copy ranges server side as the parts of a multipart upload
+  auto copy_part = [this, dest, span, copy_source, begin](
+                       const std::string& upload_id, uint64_t part_number,
+                       uint64_t offset, uint64_t length,
+                       std::string* etag) -> katana::Result<void> {
+    std::string body;
+    Request request;
+    request.method = "PUT";
+    request.url = URL(
+        dest, fmt::format(
+                  "partNumber={}&uploadId={}", part_number,
+                  UrlEncode(upload_id, false)));
+    request.headers.emplace_back(copy_source);
+    request.headers.emplace_back(fmt::format(
+        "x-amz-copy-source-range: bytes={}-{}", begin + offset,
+        begin + offset + length - 1));
+    request.response_body = &body;
+    KATANA_CHECKED(Perform(request, span));
+    std::vector<std::string> etags = XmlElements(body, "ETag");
+    if (etags.empty()) {
+      return KATANA_ERROR(
+          ErrorCode::S3Error, "no ETag in response to {}: {}", request.url,
+          body);
+    }
+    *etag = etags.front();
+    return katana::ResultSuccess();
+  };
+  KATANA_CHECKED(MultipartUpload(dest, size, span, copy_part).get());
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::S3Storage::ListAsync(
+    const std::string& directory, std::vector<std::string>* list,
+    std::vector<uint64_t>* size) {
+  auto object_res = ParseS3URI(directory);
+  if (!object_res) {
+    return MakeReady(katana::CopyableErrorInfo{object_res.error()});
+  }
+  S3Object object = std::move(object_res.value());
+  std::string prefix = DirectoryPrefix(object.key);
+  Span span = StartSpan("s3 list", directory);
+
+  std::vector<Piece> pieces;
+  pieces.emplace_back([this, object, prefix, span, list,
+                       size]() -> katana::CopyableResult<void> {
+    std::string token;
+    S3Object bucket{object.bucket, ""};
+    do {
+      std::string query = "list-type=2&delimiter=%2F&prefix=" +
+                          UrlEncode(prefix, false);
+      if (!token.empty()) {
+        query += "&continuation-token=" + UrlEncode(token, false);
+      }
+      std::string body;
+      Request request;
+      request.url = URL(bucket, query);
+      request.response_body = &body;
+      auto res = Perform(request, span);
+      if (!res) {
+        return katana::CopyableErrorInfo{res.error()};
+      }
+
+      // names relative to the directory, like the entries of a local one
+      for (const auto& contents : XmlElements(body, "Contents")) {
+        std::vector<std::string> keys = XmlElements(contents, "Key");
+        std::vector<std::string> sizes = XmlElements(contents, "Size");
+        if (keys.empty() || keys.front().size() <= prefix.size()) {
+          continue;
+        }
+        list->emplace_back(keys.front().substr(prefix.size()));
+        if (size != nullptr) {
+          size->emplace_back(
+              sizes.empty() ? 0 : std::strtoull(sizes[0].c_str(), nullptr, 10));
+        }
+      }
+      for (const auto& common : XmlElements(body, "CommonPrefixes")) {
+        std::vector<std::string> prefixes = XmlElements(common, "Prefix");
+        if (prefixes.empty() || prefixes.front().size() <= prefix.size()) {
+          continue;
+        }
+        std::string name = prefixes.front().substr(prefix.size());
+        if (!name.empty() && name.back() == '/') {
+          name.pop_back();
+        }
+        list->emplace_back(std::move(name));
+        if (size != nullptr) {
+          size->emplace_back(0);
+        }
+      }
+
+      std::vector<std::string> truncated = XmlElements(body, "IsTruncated");
+      std::vector<std::string> next =
+          XmlElements(body, "NextContinuationToken");
+      token = !truncated.empty() && truncated.front() == "true" && !next.empty()
+                  ? next.front()
+                  : "";
+    } while (!token.empty());
+    return katana::CopyableResultSuccess();
+  });
+  return RunPieces(std::move(pieces));
+}
+
+katana::Result<void>
+katana::S3Storage::Delete(
+    const std::string& directory,
+    const std::unordered_set<std::string>& files) {
+  S3Object object = KATANA_CHECKED(ParseS3URI(directory));
+  std::string prefix = DirectoryPrefix(object.key);
+  Span span = StartSpan("s3 delete", directory);
+  span->SetTags({{"files", static_cast<uint64_t>(files.size())}});
+
+  std::vector<Piece> pieces;
+  for (const auto& file : files) {
+    S3Object target{object.bucket, prefix + file};
+    pieces.emplace_back(
+        [this, target, span]() -> katana::CopyableResult<void> {
+          Request request;
+          request.method = "DELETE";
+          request.url = URL(target, "");
+          auto res = Perform(request, span);
+          // deleting what is not there is not an error
+          if (!res && res.error() != ErrorCode::NotFound) {
+            return katana::CopyableErrorInfo{res.error()};
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+  KATANA_CHECKED(RunPieces(std::move(pieces)).get());
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,184 @@
+#ifndef KATANA_LIBTSUBA_S3STORAGE_H_
+#define KATANA_LIBTSUBA_S3STORAGE_H_
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "IOQueue.h"
+#include "katana/FileStorage.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Result.h"
+
+namespace katana {
+
+/// The bucket and key named by an s3:// URI
+struct S3Object {
+  std::string bucket;
+  std::string key;
+};
+
+/// Split s3://bucket/key into its bucket and key; the key may be empty
+KATANA_EXPORT katana::Result<S3Object> ParseS3URI(const std::string& uri);
+
+/// Split [start, start + size) into consecutive (offset, length) pieces of
+/// part_size bytes, the last one possibly shorter
+KATANA_EXPORT std::vector<std::pair<uint64_t, uint64_t>> SplitIntoParts(
+    uint64_t start, uint64_t size, uint64_t part_size);
+
+/// The contents of every <tag> element of xml in document order, with the
+/// predefined XML entities decoded. Elements of the same name must not nest.
+KATANA_EXPORT std::vector<std::string> XmlElements(
+    std::string_view xml, std::string_view tag);
+
+/// Percent-encode everything but the RFC 3986 unreserved characters, and
+/// '/' if keep_slash
+KATANA_EXPORT std::string UrlEncode(std::string_view str, bool keep_slash);
+
+/// The URL of key in bucket at endpoint, virtual host style
+/// (https://bucket.endpoint/key) or path style (https://endpoint/bucket/key)
+KATANA_EXPORT std::string MakeS3URL(
+    const std::string& endpoint, bool virtual_host, const std::string& bucket,
+    const std::string& key, const std::string& query);
+
+/// Store byte arrays in S3 or an S3 compatible object store, talking to it
+/// directly over HTTP with libcurl.
+///
+/// Large reads are split into ranged GETs of part size bytes and large
+/// writes into multipart uploads with parts of that size; the pieces go
+/// out on a pool of threads so that up to KATANA_S3_CONNECTIONS requests
+/// are in flight at once. Every thread takes a curl handle from a shared
+/// pool, so connections (and their TLS sessions) are reused across
+/// requests. Failed requests are retried with exponential backoff when S3
+/// asks for it (5xx, 429) or the connection broke.
+///
+/// Every operation gets a span of the tracer with one log entry per HTTP
+/// request: method, url, status, bytes, latency and attempt.
+///
+/// Configuration comes from the environment:
+///  - AWS_ACCESS_KEY_ID, AWS_SECRET_ACCESS_KEY, AWS_SESSION_TOKEN: requests
+///    are signed (SigV4) if the first two are set and anonymous otherwise
+///  - AWS_REGION or AWS_DEFAULT_REGION (default us-east-1)
+///  - KATANA_S3_ENDPOINT: an S3 compatible endpoint, e.g.,
+///    http://localhost:9000, addressed path style; by default AWS in the
+///    region, addressed virtual host style
+///  - KATANA_S3_CONNECTIONS: requests in flight (default 64)
+///  - KATANA_S3_PART_SIZE_MB: bytes per ranged GET and upload part
+///    (default 16, at least 5)
+class KATANA_EXPORT S3Storage : public FileStorage {
+public:
+  static constexpr uint32_t kDefaultConnections = 64;
+  static constexpr uint64_t kDefaultPartSize = UINT64_C(16) << 20;
+  /// S3 rejects smaller parts of multipart uploads but for the last one
+  static constexpr uint64_t kMinPartSize = UINT64_C(5) << 20;
+  /// S3 limit on the parts of a multipart upload
+  static constexpr uint64_t kMaxParts = 10000;
+  /// S3 limit on the size of a single PUT or copy
+  static constexpr uint64_t kMaxSinglePutSize = UINT64_C(5) << 30;
+  static constexpr uint32_t kMaxAttempts = 5;
+
+  S3Storage() : FileStorage("s3://") {}
+  ~S3Storage() override;
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
+  katana::Result<void> Stat(const std::string& uri, StatBuf* s_buf) override;
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+
+  katana::Result<void> RemoteCopy(
+      const std::string& source_uri, const std::string& dest_uri,
+      uint64_t begin, uint64_t size) override;
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string& directory, std::vector<std::string>* list,
+      std::vector<uint64_t>* size) override;
+  katana::Result<void> Delete(
+      const std::string& directory,
+      const std::unordered_set<std::string>& files) override;
+
+private:
+  struct Request {
+    std::string method{"GET"};
+    std::string url;
+    std::vector<std::string> headers;
+    /// request body
+    const uint8_t* upload{nullptr};
+    uint64_t upload_size{0};
+    /// response body of a GET goes here, up to download_size bytes...
+    uint8_t* download{nullptr};
+    uint64_t download_size{0};
+    /// ...or, if download is null, here
+    std::string* response_body{nullptr};
+  };
+
+  struct Response {
+    int64_t status{0};
+    std::string etag;
+    uint64_t content_length{0};
+    /// body bytes received
+    uint64_t bytes{0};
+    std::string error_body;
+  };
+
+  using Span = std::shared_ptr<ProgressSpan>;
+  using Piece = std::function<katana::CopyableResult<void>()>;
+
+  class HandleLease;
+
+  katana::Result<Response> Perform(const Request& request, const Span& span);
+  katana::Result<void> PerformOnce(
+      const Request& request, Response* response, bool* retryable);
+
+  std::string URL(const S3Object& object, const std::string& query) const;
+  Span StartSpan(const std::string& name, const std::string& uri) const;
+
+  /// Run pieces on the queue; the returned future is ready when they all
+  /// are and holds the first error
+  std::future<katana::CopyableResult<void>> RunPieces(
+      std::vector<Piece> pieces);
+
+  /// Upload [0, size) as the parts of a multipart upload, each part made by
+  /// upload_part(upload_id, part_number, offset, length, &etag)
+  std::future<katana::CopyableResult<void>> MultipartUpload(
+      const S3Object& object, uint64_t size, const Span& span,
+      std::function<katana::Result<void>(
+          const std::string&, uint64_t, uint64_t, uint64_t, std::string*)>
+          upload_part);
+
+  /// Part size for an upload of size bytes, so that it has at most kMaxParts
+  uint64_t UploadPartSize(uint64_t size) const;
+
+  std::unique_ptr<IOQueue> queue_;
+  uint64_t part_size_{kDefaultPartSize};
+  std::string endpoint_;
+  bool virtual_host_{true};
+  std::string region_;
+  std::string access_key_;
+  std::string secret_key_;
+  std::string session_token_;
+
+  std::mutex handles_mutex_;
+  std::vector<void*> idle_handles_;
+};
+
+}  // namespace katana
+
+#endif
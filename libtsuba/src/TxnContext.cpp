@@ -1,10 +1,254 @@
 #include "katana/TxnContext.h"
 
+#include <map>
+#include <mutex>
+
 #include "GlobalState.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
 #include "katana/file.h"
 
+namespace {
+
+/// The committed version of every property written by a transaction in this
+/// process. Properties that were never written are at version 0.
+class PropertyVersions {
+public:
+  static PropertyVersions& Get() {
+    static PropertyVersions versions;
+    return versions;
+  }
+
+  std::mutex& mutex() { return mutex_; }
+
+  /// Must hold mutex()
+  uint64_t Version(const std::string& key) const {
+    auto it = versions_.find(key);
+    return it == versions_.end() ? 0 : it->second;
+  }
+
+  /// Must hold mutex()
+  void Bump(const std::string& key) { ++versions_[key]; }
+
+  /// The number of commits that published writes. Must hold mutex()
+  uint64_t writes() const { return writes_; }
+
+  /// The number of commits that wrote all properties. Must hold mutex()
+  uint64_t all_writes() const { return all_writes_; }
+
+  /// Must hold mutex()
+  void CountCommit(bool wrote_all) {
+    ++writes_;
+    if (wrote_all) {
+      ++all_writes_;
+    }
+  }
+
+  using WriteKey = std::pair<const void*, std::string>;
+
+  /// The transaction holding an uncommitted write of a property of a graph,
+  /// or nullptr. Must hold mutex()
+  const katana::TxnContext* Writer(const WriteKey& key) const {
+    auto it = writers_.find(key);
+    return it == writers_.end() ? nullptr : it->second;
+  }
+
+  /// Must hold mutex()
+  void Hold(WriteKey key, const katana::TxnContext* writer) {
+    writers_.emplace(std::move(key), writer);
+  }
+
+  /// Must hold mutex()
+  void Release(const std::vector<WriteKey>& keys) {
+    for (const auto& key : keys) {
+      writers_.erase(key);
+    }
+  }
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, uint64_t> versions_;
+  std::map<WriteKey, const katana::TxnContext*> writers_;
+  uint64_t writes_{0};
+  uint64_t all_writes_{0};
+};
+
+}  // namespace
+
+katana::TxnContext::TxnContext() : TxnContext(true) {}
+
+katana::TxnContext::TxnContext(bool auto_commit) : auto_commit_(auto_commit) {
+  auto& versions = PropertyVersions::Get();
+  std::lock_guard<std::mutex> lock(versions.mutex());
+  observed_writes_ = versions.writes();
+  observed_all_writes_ = versions.all_writes();
+}
+
+katana::TxnContext::~TxnContext() {
+  if (auto_commit_) {
+    KATANA_LOG_ASSERT(Commit());
+  } else if (!held_writes_.empty()) {
+    Rollback();
+  }
+}
+
+std::string
+katana::TxnContext::VersionKey(PropertyKind kind, const std::string& uri) {
+  // node and edge properties of an RDG may share a name
+  return (kind == PropertyKind::kNode ? "node:" : "edge:") + uri;
+}
+
+uint64_t
+katana::TxnContext::CommittedVersion(
+    PropertyKind kind, const std::string& uri) {
+  auto& versions = PropertyVersions::Get();
+  std::lock_guard<std::mutex> lock(versions.mutex());
+  // both only grow, so their sum changes whenever either does
+  return versions.Version(VersionKey(kind, uri)) + versions.all_writes();
+}
+
+void
+katana::TxnContext::ObserveRead(PropertyKind kind, const std::string& uri) {
+  std::string key = VersionKey(kind, uri);
+  if (observed_versions_.count(key) > 0) {
+    return;
+  }
+  auto& versions = PropertyVersions::Get();
+  std::lock_guard<std::mutex> lock(versions.mutex());
+  observed_versions_.emplace(key, versions.Version(key));
+}
+
+void
+katana::TxnContext::ObserveWrite(PropertyKind kind, const std::string& uri) {
+  ObserveRead(kind, uri);
+  std::string key = VersionKey(kind, uri);
+  // later reads must see this write rather than the version read before
+  snapshots_.erase(key);
+  pending_writes_.emplace(std::move(key));
+}
+
+katana::Result<void>
+katana::TxnContext::BeginWrite(
+    const void* graph, const std::string& key, UndoFn undo) {
+  auto& versions = PropertyVersions::Get();
+  std::lock_guard<std::mutex> lock(versions.mutex());
+  PropertyVersions::WriteKey write_key{graph, key};
+  const TxnContext* writer = versions.Writer(write_key);
+  if (writer == this) {
+    return katana::ResultSuccess();
+  }
+  if (writer != nullptr) {
+    conflicted_ = !auto_commit_;
+    return KATANA_ERROR(
+        ErrorCode::TransactionConflict,
+        "property {} has an uncommitted write of another transaction", key);
+  }
+  if (auto_commit_) {
+    return katana::ResultSuccess();
+  }
+  versions.Hold(write_key, this);
+  held_writes_.emplace_back(std::move(write_key));
+  undos_.emplace_back(std::move(undo));
+  return katana::ResultSuccess();
+}
+
+void
+katana::TxnContext::Rollback() {
+  // the properties stay held until they are restored, so that no other
+  // transaction writes them in between
+  for (auto it = undos_.rbegin(); it != undos_.rend(); ++it) {
+    if (!*it) {
+      continue;
+    }
+    if (auto res = (*it)(); !res) {
+      KATANA_LOG_WARN("undoing a transaction: {}", res.error());
+    }
+  }
+
+  auto& versions = PropertyVersions::Get();
+  std::lock_guard<std::mutex> lock(versions.mutex());
+  versions.Release(held_writes_);
+  StartNextTransaction(versions.writes(), versions.all_writes());
+}
+
+void
+katana::TxnContext::StartNextTransaction(
+    uint64_t writes, uint64_t all_writes) {
+  held_writes_.clear();
+  undos_.clear();
+  conflicted_ = false;
+  pending_writes_.clear();
+  observed_versions_.clear();
+  snapshots_.clear();
+  all_properties_read_ = false;
+  all_properties_write_ = false;
+  observed_writes_ = writes;
+  observed_all_writes_ = all_writes;
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::TxnContext::FindSnapshot(
+    PropertyKind kind, const std::string& uri) const {
+  auto it = snapshots_.find(VersionKey(kind, uri));
+  return it == snapshots_.end() ? nullptr : it->second;
+}
+
+katana::Result<void>
+katana::TxnContext::ValidateAndPublish() {
+  auto& versions = PropertyVersions::Get();
+  std::lock_guard<std::mutex> lock(versions.mutex());
+
+  if (!auto_commit_) {
+    if (conflicted_) {
+      return KATANA_ERROR(
+          ErrorCode::TransactionConflict,
+          "a write hit a property held by another transaction");
+    }
+    for (const auto& [key, version] : observed_versions_) {
+      if (versions.Version(key) != version) {
+        return KATANA_ERROR(
+            ErrorCode::TransactionConflict,
+            "property {} was committed by another transaction", key);
+      }
+    }
+    // a transaction that touched every property conflicts with any write,
+    // one that touched some with a write to every property
+    const bool touched_all = all_properties_read_ || all_properties_write_;
+    if ((touched_all && versions.writes() != observed_writes_) ||
+        (!observed_versions_.empty() &&
+         versions.all_writes() != observed_all_writes_)) {
+      return KATANA_ERROR(
+          ErrorCode::TransactionConflict,
+          "properties were committed by another transaction");
+    }
+  }
+
+  for (const auto& key : pending_writes_) {
+    versions.Bump(key);
+  }
+  if (!pending_writes_.empty() || all_properties_write_) {
+    versions.CountCommit(all_properties_write_);
+  }
+
+  versions.Release(held_writes_);
+  StartNextTransaction(versions.writes(), versions.all_writes());
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::TxnContext::Commit() {
+  // the manifests refer to the files of asynchronous stores
+  auto pending = std::move(pending_stores_);
+  pending_stores_.clear();
+  for (const auto& writes : pending) {
+    KATANA_CHECKED_CONTEXT(writes.get(), "asynchronous store failed");
+  }
+
+  if (auto res = ValidateAndPublish(); !res) {
+    Rollback();
+    return res.error();
+  }
+
   for (auto info : manifest_info_) {
     URI rdg_dir = info.first;
     if (!manifest_uptodate_.at(rdg_dir)) {
@@ -1,5 +1,7 @@
 #include "katana/WriteGroup.h"
 
+#include <algorithm>
+
 #include "GlobalState.h"
 #include "katana/Random.h"
 #include "katana/Result.h"
@@ -14,14 +16,15 @@ constexpr uint32_t kTagLen = 12;
 }  // namespace
 
 Result<std::unique_ptr<katana::WriteGroup>>
-katana::WriteGroup::Make() {
+katana::WriteGroup::Make(uint64_t max_outstanding_size) {
   // Don't use `OneHostOnly` because we can skip its broadcast
   std::string tag;
   if (Comm()->Rank == 0) {
     tag = katana::RandomAlphanumericString(kTagLen);
   }
   tag = Comm()->Broadcast(0, tag, kTagLen);
-  return std::unique_ptr<WriteGroup>(new WriteGroup(tag));
+  return std::unique_ptr<WriteGroup>(
+      new WriteGroup(tag, max_outstanding_size));
 }
 
 Result<void>
@@ -30,21 +33,27 @@ katana::WriteGroup::Finish() {
 }
 
 void
-katana::WriteGroup::AddOp(
-    std::future<katana::CopyableResult<void>> future, std::string file,
-    uint64_t accounted_size) {
-  if (accounted_size > kMaxOutstandingSize) {
-    accounted_size = kMaxOutstandingSize;
+katana::WriteGroup::WaitForRoom(uint64_t size) {
+  // a single operation larger than the budget runs by itself
+  size = std::min(size, max_outstanding_size_);
+  if (size == 0) {
+    return;
   }
-  if (accounted_size > 0) {
-    while (outstanding_size_ + accounted_size > kMaxOutstandingSize) {
-      if (!async_op_group_.FinishOne()) {
-        KATANA_LOG_ERROR(
-            "outstanding_size should be zero if we couldn't drain");
-        break;
-      }
+  while (outstanding_size_ + size > max_outstanding_size_) {
+    if (!async_op_group_.FinishOne()) {
+      KATANA_LOG_ERROR("outstanding_size should be zero if we couldn't drain");
+      break;
     }
   }
+}
+
+void
+katana::WriteGroup::AddOp(
+    std::future<katana::CopyableResult<void>> future, std::string file,
+    uint64_t accounted_size) {
+  accounted_size = std::min(accounted_size, max_outstanding_size_);
+  WaitForRoom(accounted_size);
+  outstanding_size_ += accounted_size;
   async_op_group_.AddOp(
       std::move(future), std::move(file),
       [wg = this, accounted_size]() -> katana::CopyableResult<void> {
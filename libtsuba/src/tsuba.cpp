@@ -1,16 +1,19 @@
 #include "katana/tsuba.h"
 
+#include "ContentAddress.h"
 #include "GlobalState.h"
 #include "RDGHandleImpl.h"
 #include "RDGPartHeader.h"
 #include "katana/CommBackend.h"
 #include "katana/Env.h"
 #include "katana/ErrorCode.h"
+#include "katana/Experimental.h"
 #include "katana/FileView.h"
 #include "katana/Plugin.h"
 #include "katana/ProgressTracer.h"
 #include "katana/Signals.h"
 #include "katana/URI.h"
+#include "katana/WriteGroup.h"
 #include "katana/file.h"
 
 namespace {
@@ -51,6 +54,18 @@ FindAnyManifestForLatestVersion(const katana::URI& name) {
   return name.Join(found_manifest);
 }
 
+/// Copy a whole file, on the storage side when both ends are on the same
+/// back-end
+katana::Result<void>
+CopyFile(const katana::URI& src, const katana::URI& dst, uint64_t size) {
+  if (katana::FS(src.string()) == katana::FS(dst.string())) {
+    return katana::FileRemoteCopy(src.string(), dst.string(), 0, size);
+  }
+  katana::FileView fv;
+  KATANA_CHECKED(fv.Bind(src.string(), true));
+  return katana::FileStore(dst.string(), fv.ptr<char>(), fv.size());
+}
+
 }  // namespace
 
 katana::Result<katana::RDGManifest>
@@ -299,6 +314,16 @@ katana::CopyRDG(
 
     auto scope = tracer.StartActiveSpan("copying file");
 
+    // content addressed files the destination already has are not copied,
+    // so copying an RDG next to an earlier copy only moves what changed
+    if (katana::IsContentAddressed(src_file_uri.BaseName()) &&
+        KATANA_CHECKED(
+            katana::SameSizeFileExists(src_file_uri, dst_file_uri))) {
+      scope.span().SetTags(
+          {{"uri", src_file_uri.string()}, {"already_present", true}});
+      continue;
+    }
+
     katana::FileView fv;
     KATANA_CHECKED(fv.Bind(src_file_uri.string(), true));
     KATANA_CHECKED(
@@ -333,6 +358,87 @@ katana::CopyRDG(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::UprevRDG(
+    const std::string& src_dir, const std::string& dst_dir,
+    uint64_t max_outstanding_size) {
+  uint64_t version = KATANA_CHECKED(ListViewsOfVersion(src_dir)).first;
+  auto src_dst_files =
+      KATANA_CHECKED(CreateSrcDestFromViewsForCopy(src_dir, dst_dir, version));
+
+  // Part headers are checked before anything is copied so that an RDG that
+  // must be converted leaves nothing behind at dst_dir
+  std::vector<std::pair<katana::URI, std::string>> headers;
+  std::vector<std::pair<katana::URI, katana::URI>> files;
+  std::vector<std::pair<katana::URI, katana::URI>> manifests;
+  for (const auto& [src_file_uri, dst_file_uri] : src_dst_files) {
+    if (katana::RDGManifest::IsManifestUri(src_file_uri)) {
+      manifests.emplace_back(src_file_uri, dst_file_uri);
+      continue;
+    }
+    if (!katana::RDGPartHeader::IsPartitionFileUri(src_file_uri)) {
+      files.emplace_back(src_file_uri, dst_file_uri);
+      continue;
+    }
+
+    auto header = KATANA_CHECKED(katana::RDGPartHeader::Make(src_file_uri));
+    if (!header.IsDataFormatLatest()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented,
+          "{} is at storage_format_version {}, its files must be converted",
+          src_file_uri, header.storage_format_version());
+    }
+    header.update_storage_format_version();
+    if (KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat)) {
+      header.set_unstable_storage_format();
+    }
+    headers.emplace_back(dst_file_uri, KATANA_CHECKED(header.Serialize()));
+  }
+
+  auto writes = KATANA_CHECKED(katana::WriteGroup::Make(max_outstanding_size));
+  for (const auto& [src_file_uri, dst_file_uri] : files) {
+    if (katana::IsContentAddressed(src_file_uri.BaseName()) &&
+        KATANA_CHECKED(
+            katana::SameSizeFileExists(src_file_uri, dst_file_uri))) {
+      continue;
+    }
+    katana::StatBuf stat;
+    KATANA_CHECKED(katana::FileStat(src_file_uri.string(), &stat));
+
+    // the copy must not start before there is room for it
+    writes->WaitForRoom(stat.size);
+    auto future = std::async(
+        std::launch::async,
+        [src = src_file_uri, dst = dst_file_uri,
+         size = stat.size]() -> katana::CopyableResult<void> {
+          KATANA_CHECKED(CopyFile(src, dst, size));
+          return katana::CopyableResultSuccess();
+        });
+    writes->AddOp(std::move(future), dst_file_uri.string(), stat.size);
+  }
+  for (const auto& [dst_file_uri, serialized] : headers) {
+    writes->StartStore(
+        dst_file_uri.string(),
+        reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size());
+  }
+  KATANA_CHECKED(writes->Finish());
+
+  // manifests go last so that a partially upgraded RDG cannot be opened
+  for (const auto& [src_file_uri, dst_file_uri] : manifests) {
+    auto rdg_manifest = KATANA_CHECKED(katana::RDGManifest::Make(src_file_uri));
+    rdg_manifest.set_version(1);
+    rdg_manifest.set_prev_version(1);
+
+    auto rdg_manifest_json = rdg_manifest.ToJsonString();
+    KATANA_CHECKED(katana::FileStore(
+        dst_file_uri.string(),
+        reinterpret_cast<const uint8_t*>(rdg_manifest_json.data()),
+        rdg_manifest_json.size()));
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::WriteRDGPartHeader(
     std::vector<katana::RDGPropInfo> node_properties,
@@ -0,0 +1,257 @@
+#include <cstring>
+#include <map>
+
+#include <boost/filesystem.hpp>
+
+#include "CachingStorage.h"
+#include "katana/ErrorCode.h"
+#include "katana/Result.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kBlock = katana::CachingStorage::kCacheBlockSize;
+
+/// A remote backend kept in memory that counts the reads that reach it
+class MemoryStorage : public katana::FileStorage {
+public:
+  MemoryStorage() : FileStorage("mem://") {}
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(
+      const std::string& uri, katana::StatBuf* s_buf) override {
+    auto it = files_.find(uri);
+    if (it == files_.end()) {
+      return katana::ErrorCode::NotFound;
+    }
+    s_buf->size = it->second.size();
+    s_buf->version = with_versions ? std::to_string(versions_[uri]) : "";
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    ++reads;
+    const std::string& data = files_.at(uri);
+    if (start + size > data.size()) {
+      return katana::ErrorCode::InvalidArgument;
+    }
+    std::memcpy(result_buf, data.data() + start, size);
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    files_[uri].assign(reinterpret_cast<const char*>(data), size);
+    ++versions_[uri];
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string&, const std::string&, uint64_t, uint64_t) override {
+    return katana::ErrorCode::NotImplemented;
+  }
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    katana::CopyableResult<void> res = katana::CopyableResultSuccess();
+    if (auto sync_res = PutMultiSync(uri, data, size); !sync_res) {
+      res = katana::CopyableErrorInfo{sync_res.error()};
+    }
+    return std::async(std::launch::deferred, [res]() { return res; });
+  }
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    katana::CopyableResult<void> res = katana::CopyableResultSuccess();
+    if (auto sync_res = GetMultiSync(uri, start, size, result_buf);
+        !sync_res) {
+      res = katana::CopyableErrorInfo{sync_res.error()};
+    }
+    return std::async(std::launch::deferred, [res]() { return res; });
+  }
+
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string&, std::vector<std::string>*,
+      std::vector<uint64_t>*) override {
+    return std::async(std::launch::deferred, []() {
+      return katana::CopyableResult<void>(katana::CopyableResultSuccess());
+    });
+  }
+
+  katana::Result<void> Delete(
+      const std::string&, const std::unordered_set<std::string>&) override {
+    return katana::ResultSuccess();
+  }
+
+  uint64_t reads{0};
+  bool with_versions{true};
+
+private:
+  std::map<std::string, std::string> files_;
+  std::map<std::string, uint64_t> versions_;
+};
+
+std::string
+MakeContents(uint64_t size, char seed) {
+  std::string contents(size, '\0');
+  for (uint64_t i = 0; i < size; ++i) {
+    contents[i] = static_cast<char>(seed + i * 7);
+  }
+  return contents;
+}
+
+katana::Result<void>
+Put(katana::FileStorage* storage, const std::string& uri,
+    const std::string& contents) {
+  return storage->PutMultiSync(
+      uri, reinterpret_cast<const uint8_t*>(contents.data()), contents.size());
+}
+
+katana::Result<std::string>
+Get(katana::FileStorage* storage, const std::string& uri, uint64_t start,
+    uint64_t size) {
+  std::string buf(size, '\0');
+  KATANA_CHECKED(storage->GetMultiSync(
+      uri, start, size, reinterpret_cast<uint8_t*>(buf.data())));
+  return buf;
+}
+
+katana::Result<void>
+TestHitsAndInvalidation(const std::string& dir) {
+  MemoryStorage remote;
+  katana::CachingStorage cache(&remote, dir, 16 * kBlock);
+  KATANA_CHECKED(cache.Init());
+
+  std::string uri = "mem://bucket/file";
+  std::string contents = MakeContents(2 * kBlock + 100, 'a');
+  KATANA_CHECKED(Put(&cache, uri, contents));
+
+  // a read that straddles the first two blocks
+  uint64_t start = kBlock - 10;
+  auto got = KATANA_CHECKED(Get(&cache, uri, start, 20));
+  KATANA_LOG_ASSERT(got == contents.substr(start, 20));
+  KATANA_LOG_ASSERT(cache.misses() == 2 && cache.hits() == 0);
+  KATANA_LOG_ASSERT(remote.reads == 2);
+
+  // reads within those blocks, including the short last one, stay local
+  got = KATANA_CHECKED(Get(&cache, uri, 5, kBlock));
+  KATANA_LOG_ASSERT(got == contents.substr(5, kBlock));
+  KATANA_LOG_ASSERT(remote.reads == 2);
+  got = KATANA_CHECKED(Get(&cache, uri, 0, contents.size()));
+  KATANA_LOG_ASSERT(got == contents);
+  KATANA_LOG_ASSERT(remote.reads == 3);
+  KATANA_LOG_ASSERT(cache.cached_size() == contents.size());
+
+  // a new version is never served from the old blocks
+  std::string replaced = MakeContents(contents.size(), 'q');
+  KATANA_CHECKED(Put(&cache, uri, replaced));
+  got = KATANA_CHECKED(Get(&cache, uri, 0, replaced.size()));
+  KATANA_LOG_ASSERT(got == replaced);
+  KATANA_LOG_ASSERT(remote.reads == 6);
+
+  // another cache over the same directory finds the blocks
+  katana::CachingStorage reopened(&remote, dir, 16 * kBlock);
+  KATANA_CHECKED(reopened.Init());
+  got = KATANA_CHECKED(Get(&reopened, uri, 0, replaced.size()));
+  KATANA_LOG_ASSERT(got == replaced);
+  KATANA_LOG_ASSERT(remote.reads == 6);
+  KATANA_LOG_ASSERT(reopened.hits() == 3);
+
+  // reading past the end is left to the backend
+  KATANA_LOG_ASSERT(!Get(&cache, uri, replaced.size() - 1, 2));
+
+  // without a version nothing is cached
+  remote.with_versions = false;
+  std::string unversioned_uri = "mem://bucket/unversioned";
+  KATANA_CHECKED(Put(&cache, unversioned_uri, contents));
+  uint64_t reads = remote.reads;
+  KATANA_CHECKED(Get(&cache, unversioned_uri, 0, 10));
+  KATANA_CHECKED(Get(&cache, unversioned_uri, 0, 10));
+  KATANA_LOG_ASSERT(remote.reads == reads + 2);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestEviction(const std::string& dir) {
+  MemoryStorage remote;
+  katana::CachingStorage cache(&remote, dir, 2 * kBlock);
+  KATANA_CHECKED(cache.Init());
+
+  std::string uri = "mem://bucket/large";
+  std::string contents = MakeContents(4 * kBlock, 'z');
+  KATANA_CHECKED(Put(&cache, uri, contents));
+
+  // read blocks 0, 1, then 0 again, then 2: block 1 is least recently used
+  KATANA_CHECKED(Get(&cache, uri, 0, 1));
+  KATANA_CHECKED(Get(&cache, uri, kBlock, 1));
+  KATANA_CHECKED(Get(&cache, uri, 0, 1));
+  KATANA_CHECKED(Get(&cache, uri, 2 * kBlock, 1));
+  KATANA_LOG_ASSERT(cache.cached_size() <= 2 * kBlock);
+  KATANA_LOG_ASSERT(remote.reads == 3);
+
+  KATANA_CHECKED(Get(&cache, uri, 0, 1));
+  KATANA_LOG_ASSERT(remote.reads == 3);
+  KATANA_CHECKED(Get(&cache, uri, kBlock, 1));
+  KATANA_LOG_ASSERT(remote.reads == 4);
+
+  uint64_t files = 0;
+  for (fs::directory_iterator it(dir), end; it != end; ++it) {
+    ++files;
+  }
+  KATANA_LOG_VASSERT(files == 2, "{} files in the cache", files);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  if (boost::system::error_code err; !fs::create_directories(path, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating parent directories: {}", err.message());
+    }
+  }
+
+  KATANA_CHECKED_CONTEXT(
+      TestHitsAndInvalidation((fs::path(path) / "hits").string()),
+      "TestHitsAndInvalidation");
+
+  KATANA_CHECKED_CONTEXT(
+      TestEviction((fs::path(path) / "eviction").string()), "TestEviction");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
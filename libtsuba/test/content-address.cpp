@@ -0,0 +1,115 @@
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "ContentAddress.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+MakeArray(int64_t first) {
+  arrow::Int64Builder builder;
+  for (int64_t i = first; i < first + 100; ++i) {
+    KATANA_CHECKED(builder.Append(i));
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+katana::Result<void>
+TestFileNames() {
+  auto array = KATANA_CHECKED(MakeArray(0));
+  auto same = KATANA_CHECKED(MakeArray(0));
+  auto different = KATANA_CHECKED(MakeArray(1));
+
+  std::string name = katana::ContentAddressedFileName("prop", "node", *array);
+  KATANA_LOG_VASSERT(katana::IsContentAddressed(name), "{}", name);
+  KATANA_LOG_ASSERT(katana::IsContentAddressed(name + ".raw"));
+  KATANA_LOG_ASSERT(katana::IsContentAddressed(name + ".part_000000001"));
+  KATANA_LOG_ASSERT(name.rfind("prop-", 0) == 0);
+
+  KATANA_LOG_ASSERT(
+      name == katana::ContentAddressedFileName("prop", "node", *same));
+  KATANA_LOG_ASSERT(
+      name != katana::ContentAddressedFileName("prop", "node", *different));
+  KATANA_LOG_ASSERT(
+      name != katana::ContentAddressedFileName("prop", "edge", *array));
+  KATANA_LOG_ASSERT(
+      name != katana::ContentAddressedFileName("other", "node", *array));
+  KATANA_LOG_ASSERT(
+      name != katana::ContentAddressedFileName(
+                  "prop", "node", *array->Slice(0, array->length() - 1)));
+
+  KATANA_LOG_ASSERT(!katana::IsContentAddressed("prop-AbCdEfGhIjKl"));
+  KATANA_LOG_ASSERT(!katana::IsContentAddressed("prop-content-1234"));
+  KATANA_LOG_ASSERT(!katana::IsContentAddressed(
+      "prop-content-0123456789ABCDEF0123456789abcdef"));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestSameSizeFileExists(const katana::URI& dir) {
+  auto src = dir.Join("src");
+  auto same = dir.Join("same");
+  auto shorter = dir.Join("shorter");
+  KATANA_CHECKED(katana::FileStore(src.string(), std::string(100, 'a')));
+  KATANA_CHECKED(katana::FileStore(same.string(), std::string(100, 'a')));
+  KATANA_CHECKED(katana::FileStore(shorter.string(), std::string(10, 'a')));
+
+  KATANA_LOG_ASSERT(KATANA_CHECKED(katana::SameSizeFileExists(src, same)));
+  KATANA_LOG_ASSERT(!KATANA_CHECKED(katana::SameSizeFileExists(src, shorter)));
+  KATANA_LOG_ASSERT(
+      !KATANA_CHECKED(katana::SameSizeFileExists(src, dir.Join("missing"))));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  if (boost::system::error_code err; !fs::create_directories(path, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating parent directories: {}", err.message());
+    }
+  }
+  auto dir = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+
+  KATANA_CHECKED_CONTEXT(TestFileNames(), "TestFileNames");
+
+  KATANA_CHECKED_CONTEXT(
+      TestSameSizeFileExists(dir), "TestSameSizeFileExists");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -1,5 +1,8 @@
+#include <thread>
+
 #include <boost/filesystem.hpp>
 
+#include "katana/FileFrame.h"
 #include "katana/FileView.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
@@ -31,10 +34,151 @@ TestEmpty(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestMapped(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto file_uri = uri.Join("mapped_file");
+
+  // span a few FileView pages
+  std::string contents((3 << 20) + 17, 'a');
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  KATANA_CHECKED(katana::FileStore(file_uri.string(), contents));
+
+  katana::FileView mapped;
+  KATANA_CHECKED(mapped.BindMapped(file_uri.path()));
+  KATANA_LOG_ASSERT(mapped.file_backed());
+  KATANA_LOG_ASSERT(mapped.size() == contents.size());
+  KATANA_LOG_ASSERT(
+      std::string(mapped.begin(), mapped.end()) == contents);
+
+  katana::FileView read;
+  KATANA_CHECKED(read.Bind(file_uri.string(), true));
+  KATANA_LOG_ASSERT(!read.file_backed());
+
+  // reads through the arrow interface see the same bytes
+  KATANA_LOG_ASSERT(mapped.Seek(1 << 20).ok());
+  auto buf_res = mapped.Read(100);
+  KATANA_LOG_ASSERT(buf_res.ok());
+  KATANA_LOG_ASSERT(
+      buf_res.ValueOrDie()->ToString() == contents.substr(1 << 20, 100));
+
+  // writes stay private to the view
+  const_cast<char*>(mapped.ptr<char>())[0] = 'z';  // NOLINT
+  katana::FileView remapped;
+  KATANA_CHECKED(remapped.BindMapped(file_uri.path()));
+  KATANA_LOG_ASSERT(*remapped.ptr<char>() == 'a');
+
+  katana::FileView moved(std::move(mapped));
+  KATANA_LOG_ASSERT(moved.file_backed());
+  KATANA_LOG_ASSERT(*moved.ptr<char>() == 'z');
+  KATANA_CHECKED(moved.Unbind());
+  KATANA_LOG_ASSERT(!moved.file_backed());
+
+  KATANA_LOG_ASSERT(!remapped.BindMapped(uri.Join("missing").path()));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAdvise(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto file_uri = uri.Join("advised_file");
+
+  std::string contents((5 << 20) + 17, 'a');
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  KATANA_CHECKED(katana::FileStore(file_uri.string(), contents));
+
+  // nothing is fetched up front; a sequential scan reads ahead as it goes
+  katana::FileView scanned;
+  KATANA_CHECKED(scanned.Bind(file_uri.string(), 0, false));
+  std::string scan;
+  char buf[4096];
+  for (;;) {
+    auto read_res = scanned.Read(sizeof(buf), buf);
+    KATANA_LOG_ASSERT(read_res.ok());
+    if (read_res.ValueOrDie() == 0) {
+      break;
+    }
+    scan.append(buf, read_res.ValueOrDie());
+  }
+  KATANA_LOG_ASSERT(scan == contents);
+
+  katana::FileView advised;
+  KATANA_CHECKED(advised.Bind(file_uri.string(), 0, false));
+  KATANA_CHECKED(advised.Advise(
+      0, 1 << 20, katana::FileView::AccessPattern::kRandom));
+  KATANA_CHECKED(advised.Advise(
+      1 << 20, 3 << 20, katana::FileView::AccessPattern::kSequential));
+  KATANA_CHECKED(advised.Advise(
+      3 << 20, contents.size(), katana::FileView::AccessPattern::kWillNeed));
+  KATANA_CHECKED(advised.WaitForFills());
+  for (uint64_t offset : {uint64_t{17}, uint64_t{2 << 20}, uint64_t{4 << 20}}) {
+    KATANA_LOG_ASSERT(advised.Seek(offset).ok());
+    auto buf_res = advised.Read(100);
+    KATANA_LOG_ASSERT(buf_res.ok());
+    KATANA_LOG_ASSERT(
+        buf_res.ValueOrDie()->ToString() == contents.substr(offset, 100));
+  }
+
+  katana::FileView mapped;
+  KATANA_CHECKED(mapped.BindMapped(file_uri.path()));
+  KATANA_CHECKED(mapped.Advise(
+      17, contents.size(), katana::FileView::AccessPattern::kSequential));
+  KATANA_LOG_ASSERT(std::string(mapped.begin(), mapped.end()) == contents);
+
+  katana::FileView unbound;
+  KATANA_LOG_ASSERT(
+      !unbound.Advise(0, 1, katana::FileView::AccessPattern::kNormal));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestParallelFill(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto file_uri = uri.Join("filled_file");
+
+  std::string contents((3 << 20) + 17, 'a');
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+
+  katana::FileFrame ff;
+  KATANA_CHECKED(ff.InitForParallelFill(contents.size()));
+  size_t half = contents.size() / 2;
+  katana::Result<void> first = katana::ResultSuccess();
+  std::thread writer([&]() { first = ff.WriteAt(0, contents.data(), half); });
+  KATANA_CHECKED(
+      ff.WriteAt(half, contents.data() + half, contents.size() - half));
+  writer.join();
+  KATANA_CHECKED(std::move(first));
+  KATANA_LOG_ASSERT(!ff.WriteAt(ff.map_size(), contents.data(), 1));
+
+  ff.Bind(file_uri.string());
+  KATANA_CHECKED(ff.Persist());
+
+  katana::FileView fv;
+  KATANA_CHECKED(fv.Bind(file_uri.string(), true));
+  KATANA_LOG_ASSERT(fv.size() == contents.size());
+  KATANA_LOG_ASSERT(std::string(fv.begin(), fv.end()) == contents);
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestEmpty(path), "TestEmpty");
 
+  KATANA_CHECKED_CONTEXT(TestMapped(path), "TestMapped");
+
+  KATANA_CHECKED_CONTEXT(TestAdvise(path), "TestAdvise");
+
+  KATANA_CHECKED_CONTEXT(TestParallelFill(path), "TestParallelFill");
+
   return katana::ResultSuccess();
 }
 
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// larger than the pieces local storage splits reads and writes into
+constexpr uint64_t kFileSize = (UINT64_C(9) << 20) + 123;
+
+struct FreeDeleter {
+  void operator()(void* ptr) const { std::free(ptr); }
+};
+
+using AlignedBuffer = std::unique_ptr<uint8_t, FreeDeleter>;
+
+AlignedBuffer
+MakeAlignedBuffer(uint64_t size) {
+  void* ptr = std::aligned_alloc(
+      katana::kBlockSize, katana::RoundUpToBlock(std::max<uint64_t>(size, 1)));
+  KATANA_LOG_ASSERT(ptr != nullptr);
+  return AlignedBuffer(static_cast<uint8_t*>(ptr));
+}
+
+katana::Result<void>
+CheckRead(
+    const std::string& uri, const AlignedBuffer& expected, uint64_t start,
+    uint64_t size) {
+  AlignedBuffer buf = MakeAlignedBuffer(size);
+  KATANA_CHECKED(katana::FileGet(uri, buf.get(), start, size));
+  KATANA_LOG_VASSERT(
+      std::memcmp(buf.get(), expected.get() + start, size) == 0,
+      "read of {} bytes at {}", size, start);
+
+  std::memset(buf.get(), 0, size);
+  KATANA_CHECKED(katana::FileGetAsync(uri, buf.get(), start, size).get());
+  KATANA_LOG_VASSERT(
+      std::memcmp(buf.get(), expected.get() + start, size) == 0,
+      "async read of {} bytes at {}", size, start);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestReadWrite(const katana::URI& dir) {
+  AlignedBuffer contents = MakeAlignedBuffer(kFileSize);
+  for (uint64_t i = 0; i < kFileSize; ++i) {
+    contents.get()[i] = static_cast<uint8_t>(i * 31 + (i >> 12));
+  }
+
+  // one file written with a synchronous put, one with an async put of an
+  // unaligned buffer
+  auto sync_uri = dir.Join("sync").string();
+  KATANA_CHECKED(katana::FileStore(sync_uri, contents.get(), kFileSize));
+  auto async_uri = dir.Join("async").string();
+  KATANA_CHECKED(
+      katana::FileStoreAsync(async_uri, contents.get() + 1, kFileSize - 1)
+          .get());
+
+  katana::StatBuf stat;
+  KATANA_CHECKED(katana::FileStat(sync_uri, &stat));
+  KATANA_LOG_ASSERT(stat.size == kFileSize);
+  KATANA_CHECKED(katana::FileStat(async_uri, &stat));
+  KATANA_LOG_ASSERT(stat.size == kFileSize - 1);
+
+  for (auto [start, size] : std::vector<std::pair<uint64_t, uint64_t>>{
+           {0, kFileSize},
+           {0, katana::kBlockSize},
+           {katana::kBlockSize, UINT64_C(8) << 20},
+           {17, 5 << 20},
+           {kFileSize - 10, 10},
+           {5, 0}}) {
+    KATANA_CHECKED(CheckRead(sync_uri, contents, start, size));
+  }
+
+  AlignedBuffer shifted = MakeAlignedBuffer(kFileSize);
+  std::memcpy(shifted.get(), contents.get() + 1, kFileSize - 1);
+  KATANA_CHECKED(CheckRead(async_uri, shifted, 0, kFileSize - 1));
+
+  // reads that round the end of the file up to a block are allowed, longer
+  // ones are not
+  AlignedBuffer buf = MakeAlignedBuffer(kFileSize + 2 * katana::kBlockSize);
+  uint64_t rounded = katana::RoundUpToBlock(kFileSize);
+  KATANA_CHECKED(katana::FileGet(sync_uri, buf.get(), 0, rounded));
+  KATANA_LOG_ASSERT(std::memcmp(buf.get(), contents.get(), kFileSize) == 0);
+  KATANA_LOG_ASSERT(!katana::FileGet(
+      sync_uri, buf.get(), 0, kFileSize + katana::kBlockSize + 1));
+  KATANA_LOG_ASSERT(
+      !katana::FileGet(dir.Join("missing").string(), buf.get(), 0, 1));
+
+  // rewriting a file with fewer bytes truncates it
+  KATANA_CHECKED(katana::FileStore(sync_uri, contents.get(), 100));
+  KATANA_CHECKED(katana::FileStat(sync_uri, &stat));
+  KATANA_LOG_ASSERT(stat.size == 100);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  if (boost::system::error_code err; !fs::create_directories(path, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating parent directories: {}", err.message());
+    }
+  }
+  auto dir = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+
+  KATANA_CHECKED_CONTEXT(TestReadWrite(dir), "TestReadWrite");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include <boost/filesystem.hpp>
 
+#include "RDGPartHeader.h"
 #include "katana/RDG.h"
 #include "katana/RDGManifest.h"
 #include "katana/Result.h"
@@ -30,10 +31,42 @@ TestFileNames(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestPrefetchedPartitionHeader(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto manifest = KATANA_CHECKED(katana::RDGManifest::Make(uri));
+
+  // the header of this host is read along with the manifest
+  katana::URI partition_path = manifest.PartitionFileName(0);
+  auto prefetched = manifest.PrefetchedPartitionHeader(partition_path);
+  KATANA_LOG_ASSERT(prefetched.has_value());
+  std::string contents = KATANA_CHECKED(std::move(prefetched.value()));
+  KATANA_LOG_ASSERT(
+      contents == KATANA_CHECKED(katana::RDGPartHeader::Read(partition_path)));
+  KATANA_CHECKED(katana::RDGPartHeader::Make(partition_path, contents));
+
+  // copies share the read, and other partitions are not read
+  katana::RDGManifest copy = manifest;
+  KATANA_LOG_ASSERT(copy.PrefetchedPartitionHeader(partition_path));
+  KATANA_LOG_ASSERT(!manifest.PrefetchedPartitionHeader(
+      katana::RDGManifest::PartitionFileName(
+          manifest.view_specifier(), manifest.dir(), 1, manifest.version())));
+
+  // a manifest with a different version than its name does not use it
+  manifest.set_version(manifest.version() + 1);
+  KATANA_LOG_ASSERT(!manifest.PrefetchedPartitionHeader(
+      manifest.PartitionFileName(0)));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestFileNames(path), "TestFileNames");
 
+  KATANA_CHECKED_CONTEXT(
+      TestPrefetchedPartitionHeader(path), "TestPrefetchedPartitionHeader");
+
   return katana::ResultSuccess();
 }
 
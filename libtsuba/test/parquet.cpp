@@ -1,5 +1,10 @@
+#include <algorithm>
+
 #include <arrow/chunked_array.h>
 #include <arrow/type_fwd.h>
+#include <arrow/util/compression.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
 
 #include "katana/ParquetReader.h"
 #include "katana/ParquetWriter.h"
@@ -38,11 +43,160 @@ TestLargeStringRoundTrip(const std::string& dir) {
   return katana::ResultSuccess();
 }
 
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeTwoColumnTable(int64_t num_rows) {
+  arrow::Int64Builder ints;
+  arrow::DoubleBuilder doubles;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_CHECKED(ints.Append(i * 3));
+    if (i % 4 == 1) {
+      KATANA_CHECKED(doubles.AppendNull());
+    } else {
+      KATANA_CHECKED(doubles.Append(static_cast<double>(i) / 2));
+    }
+  }
+  std::shared_ptr<arrow::Array> int_array;
+  KATANA_CHECKED(ints.Finish(&int_array));
+  std::shared_ptr<arrow::Array> double_array;
+  KATANA_CHECKED(doubles.Finish(&double_array));
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("ints", arrow::int64()),
+                     arrow::field("doubles", arrow::float64())}),
+      {int_array, double_array});
+}
+
+katana::Result<void>
+TestRowGroups(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::URI::Make(dir)).Join("row_groups.parquet");
+
+  constexpr int64_t kRows = 95;
+  auto expected = KATANA_CHECKED(MakeTwoColumnTable(kRows));
+  auto opts = katana::ParquetWriter::WriteOpts::Defaults();
+  opts.rows_per_row_group = 10;
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(expected, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(table->Equals(*expected));
+
+  // slices inside one row group, across several and past the end
+  for (auto [offset, length] : std::vector<std::pair<int64_t, int64_t>>{
+           {0, 0}, {3, 4}, {13, 40}, {90, 20}, {95, 5}}) {
+    auto slice = KATANA_CHECKED(
+        reader->ReadTable(uri, katana::ParquetReader::Slice{offset, length}));
+    KATANA_LOG_VASSERT(
+        slice->Equals(*expected->Slice(offset, length)),
+        "slice {} {} found {}", offset, length, slice->ToString());
+  }
+
+  // projected columns come back in the order, and as often as, requested
+  auto projected = KATANA_CHECKED(
+      reader->ReadTable(uri, {1, 0, 1}, katana::ParquetReader::Slice{27, 30}));
+  auto expected_slice = expected->Slice(27, 30);
+  KATANA_LOG_ASSERT(projected->num_columns() == 3);
+  KATANA_LOG_ASSERT(projected->num_rows() == 30);
+  KATANA_LOG_ASSERT(projected->field(0)->name() == "doubles");
+  KATANA_LOG_ASSERT(projected->column(0)->Equals(*expected_slice->column(1)));
+  KATANA_LOG_ASSERT(projected->column(1)->Equals(*expected_slice->column(0)));
+  KATANA_LOG_ASSERT(projected->column(2)->Equals(*expected_slice->column(1)));
+
+  KATANA_LOG_ASSERT(!reader->ReadTable(uri, {2}));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeEncodingTable(int64_t num_rows) {
+  arrow::Int64Builder ids;
+  arrow::LargeStringBuilder kinds;
+  arrow::DoubleBuilder weights;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_CHECKED(ids.Append(i * 2 + 1));
+    KATANA_CHECKED(kinds.Append(i % 3 == 0 ? "person" : "place"));
+    KATANA_CHECKED(weights.Append(static_cast<double>(i * 7919 % 1009) / 3));
+  }
+  std::shared_ptr<arrow::Array> id_array;
+  KATANA_CHECKED(ids.Finish(&id_array));
+  std::shared_ptr<arrow::Array> kind_array;
+  KATANA_CHECKED(kinds.Finish(&kind_array));
+  std::shared_ptr<arrow::Array> weight_array;
+  KATANA_CHECKED(weights.Finish(&weight_array));
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("ids", arrow::int64()),
+                     arrow::field("kinds", arrow::large_utf8()),
+                     arrow::field("weights", arrow::float64())}),
+      {id_array, kind_array, weight_array});
+}
+
+/// \returns the metadata of the chunk of column \p column in the first row
+/// group of the parquet file at \p path
+std::unique_ptr<parquet::ColumnChunkMetaData>
+ColumnChunk(const std::string& path, int column) {
+  auto file_reader = parquet::ParquetFileReader::OpenFile(path);
+  return file_reader->metadata()->RowGroup(0)->ColumnChunk(column);
+}
+
+bool
+HasEncoding(
+    const parquet::ColumnChunkMetaData& chunk,
+    parquet::Encoding::type encoding) {
+  const auto& encodings = chunk.encodings();
+  return std::find(encodings.begin(), encodings.end(), encoding) !=
+         encodings.end();
+}
+
+katana::Result<void>
+TestAdaptiveEncoding(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::URI::Make(dir)).Join("encoding.parquet");
+
+  auto expected = KATANA_CHECKED(MakeEncodingTable(1000));
+  auto opts = katana::ParquetWriter::WriteOpts::Defaults();
+  bool compressed = arrow::util::Codec::IsAvailable(arrow::Compression::ZSTD);
+  if (compressed) {
+    opts.compression = arrow::Compression::ZSTD;
+    opts.compression_level = 3;
+  }
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(expected, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(table->Equals(*expected));
+
+  // distinct sorted ids are not worth a dictionary, the few kinds are
+  auto ids = ColumnChunk(uri.path(), 0);
+  KATANA_LOG_ASSERT(!ids->has_dictionary_page());
+  auto kinds = ColumnChunk(uri.path(), 1);
+  KATANA_LOG_ASSERT(kinds->has_dictionary_page());
+  auto weights = ColumnChunk(uri.path(), 2);
+  KATANA_LOG_ASSERT(!weights->has_dictionary_page());
+  KATANA_LOG_ASSERT(
+      HasEncoding(*weights, parquet::Encoding::BYTE_STREAM_SPLIT) ==
+      compressed);
+
+  // without adaptive encoding, every column starts out with a dictionary
+  opts.adaptive_encoding = false;
+  auto plain_uri =
+      KATANA_CHECKED(katana::URI::Make(dir)).Join("no_encoding.parquet");
+  writer = KATANA_CHECKED(katana::ParquetWriter::Make(expected, opts));
+  KATANA_CHECKED(writer->WriteToUri(plain_uri));
+  KATANA_LOG_ASSERT(ColumnChunk(plain_uri.path(), 0)->has_dictionary_page());
+  table = KATANA_CHECKED(reader->ReadTable(plain_uri));
+  KATANA_LOG_ASSERT(table->Equals(*expected));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& dir) {
   KATANA_CHECKED_CONTEXT(
       TestLargeStringRoundTrip(dir), "TestLargeStringRoundTrip");
 
+  KATANA_CHECKED_CONTEXT(TestRowGroups(dir), "TestRowGroups");
+
+  KATANA_CHECKED_CONTEXT(TestAdaptiveEncoding(dir), "TestAdaptiveEncoding");
+
   return katana::ResultSuccess();
 }
 
@@ -0,0 +1,184 @@
+#include <arrow/chunked_array.h>
+#include <arrow/type_fwd.h>
+#include <arrow/util/compression.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/RawColumn.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/file.h"
+#include "katana/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr int64_t kRows = 1000;
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+MakeInt64WithNulls() {
+  // two chunks so the writer has to flatten them
+  arrow::ArrayVector chunks;
+  for (int64_t chunk = 0; chunk < 2; ++chunk) {
+    arrow::Int64Builder builder;
+    for (int64_t i = 0; i < kRows / 2; ++i) {
+      int64_t row = chunk * kRows / 2 + i;
+      if (row % 7 == 3) {
+        KATANA_CHECKED(builder.AppendNull());
+      } else {
+        KATANA_CHECKED(builder.Append(row * row - 500));
+      }
+    }
+    std::shared_ptr<arrow::Array> array;
+    KATANA_CHECKED(builder.Finish(&array));
+    chunks.emplace_back(std::move(array));
+  }
+  return std::make_shared<arrow::ChunkedArray>(chunks);
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+MakeFixedSizeBinary() {
+  arrow::FixedSizeBinaryBuilder builder(arrow::fixed_size_binary(12));
+  for (int64_t i = 0; i < kRows; ++i) {
+    std::string value = fmt::format("{:012}", i);
+    KATANA_CHECKED(builder.Append(value));
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+katana::Result<void>
+CheckRoundTrip(
+    const std::shared_ptr<arrow::ChunkedArray>& expected,
+    const katana::URI& uri, bool map) {
+  auto table =
+      KATANA_CHECKED(katana::ReadRawColumn("col", uri, std::nullopt, map));
+  KATANA_LOG_ASSERT(table->num_columns() == 1);
+  KATANA_LOG_ASSERT(table->field(0)->name() == "col");
+  KATANA_LOG_VASSERT(
+      table->column(0)->Equals(*expected), "expected {} found {}",
+      expected->ToString(), table->column(0)->ToString());
+
+  // slices that start inside a byte of the validity bitmap, cover the end of
+  // the column and run past it
+  for (auto [offset, length] : std::vector<std::pair<int64_t, int64_t>>{
+           {0, 1}, {13, 50}, {499, 3}, {kRows - 5, 5}, {kRows - 5, 100}}) {
+    auto slice = KATANA_CHECKED(katana::ReadRawColumn(
+        "col", uri, katana::ParquetReader::Slice{offset, length}, map));
+    auto expected_slice = expected->Slice(offset, length);
+    KATANA_LOG_VASSERT(
+        slice->column(0)->Equals(*expected_slice), "slice {} {} found {}",
+        offset, length, slice->column(0)->ToString());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestRoundTrip(const katana::URI& dir) {
+  std::vector<katana::RawColumnFormat> formats{
+      katana::RawColumnFormat::kUncompressed};
+  if (arrow::util::Codec::IsAvailable(arrow::Compression::LZ4_FRAME)) {
+    formats.emplace_back(katana::RawColumnFormat::kLZ4Frame);
+  }
+
+  auto int_array = KATANA_CHECKED(MakeInt64WithNulls());
+  auto binary_array = KATANA_CHECKED(MakeFixedSizeBinary());
+  for (auto format : formats) {
+    auto suffix = static_cast<uint32_t>(format);
+
+    auto int_uri = dir.Join(fmt::format("int64.raw.{}", suffix));
+    KATANA_CHECKED(katana::WriteRawColumn(int_array, int_uri, format));
+    auto type = KATANA_CHECKED(katana::ReadRawColumnType(int_uri));
+    KATANA_LOG_ASSERT(type->Equals(arrow::int64()));
+    KATANA_CHECKED(CheckRoundTrip(int_array, int_uri, false));
+    KATANA_CHECKED(CheckRoundTrip(int_array, int_uri, true));
+
+    auto binary_uri = dir.Join(fmt::format("binary.raw.{}", suffix));
+    KATANA_CHECKED(katana::WriteRawColumn(binary_array, binary_uri, format));
+    KATANA_CHECKED(CheckRoundTrip(binary_array, binary_uri, false));
+    KATANA_CHECKED(CheckRoundTrip(binary_array, binary_uri, true));
+
+    auto empty = std::make_shared<arrow::ChunkedArray>(
+        arrow::ArrayVector{}, arrow::float64());
+    auto empty_uri = dir.Join(fmt::format("empty.raw.{}", suffix));
+    KATANA_CHECKED(katana::WriteRawColumn(empty, empty_uri, format));
+    auto table = KATANA_CHECKED(katana::ReadRawColumn("col", empty_uri));
+    KATANA_LOG_ASSERT(table->num_rows() == 0);
+    KATANA_LOG_ASSERT(table->field(0)->type()->Equals(arrow::float64()));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestBadInput(const katana::URI& dir) {
+  arrow::StringBuilder builder;
+  KATANA_CHECKED(builder.Append("not fixed width"));
+  std::shared_ptr<arrow::Array> strings;
+  KATANA_CHECKED(builder.Finish(&strings));
+  KATANA_LOG_ASSERT(!katana::WriteRawColumn(
+      std::make_shared<arrow::ChunkedArray>(strings), dir.Join("strings.raw"),
+      katana::RawColumnFormat::kUncompressed));
+
+  auto garbage_uri = dir.Join("garbage.raw");
+  KATANA_CHECKED(
+      katana::FileStore(garbage_uri.string(), std::string(256, 'x')));
+  KATANA_LOG_ASSERT(!katana::ReadRawColumn("col", garbage_uri));
+  KATANA_LOG_ASSERT(!katana::ReadRawColumnType(garbage_uri));
+
+  // a truncated file is caught before reading past its end
+  auto int_array = KATANA_CHECKED(MakeInt64WithNulls());
+  auto full_uri = dir.Join("full.raw");
+  KATANA_CHECKED(katana::WriteRawColumn(
+      int_array, full_uri, katana::RawColumnFormat::kUncompressed));
+  std::string contents(1024, '\0');
+  KATANA_CHECKED(katana::FileGet(
+      full_uri.string(), contents.data(), 0, contents.size()));
+  auto truncated_uri = dir.Join("truncated.raw");
+  KATANA_CHECKED(katana::FileStore(truncated_uri.string(), contents));
+  KATANA_LOG_ASSERT(!katana::ReadRawColumn("col", truncated_uri));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  if (boost::system::error_code err; !fs::create_directories(path, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating parent directories: {}", err.message());
+    }
+  }
+  auto dir = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+
+  KATANA_CHECKED_CONTEXT(TestRoundTrip(dir), "TestRoundTrip");
+
+  KATANA_CHECKED_CONTEXT(TestBadInput(dir), "TestBadInput");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -1,4 +1,6 @@
 #include "RDGPartHeader.h"
+#include "katana/Experimental.h"
+#include "katana/JSON.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/tsuba.h"
@@ -75,9 +77,56 @@ TestPropInfoLists(const std::string& path_to_header) {
   return katana::ResultSuccess();
 }
 
+// Both encodings of a header must decode to the header that was encoded. The
+// binary encoding is only stored for unstable_storage_format headers until
+// kPartitionStorageFormatVersion7 is the latest version, so it is only tested
+// when the UnstableRDGStorageFormat flag is set.
+katana::Result<void>
+TestSerialize(const std::string& path_to_header) {
+  katana::URI path_to_header_uri =
+      KATANA_CHECKED(katana::URI::Make(path_to_header));
+  katana::RDGPartHeader header =
+      KATANA_CHECKED(katana::RDGPartHeader::Make(path_to_header_uri));
+  header.update_storage_format_version();
+  bool unstable = KATANA_EXPERIMENTAL_ENABLED(UnstableRDGStorageFormat);
+  if (unstable) {
+    header.set_unstable_storage_format();
+  }
+  std::string expected = KATANA_CHECKED(katana::JsonDump(header));
+
+  std::string as_json = KATANA_CHECKED(header.Serialize(true));
+  KATANA_LOG_ASSERT(as_json.front() == '{');
+  katana::RDGPartHeader from_json =
+      KATANA_CHECKED(katana::RDGPartHeader::Deserialize(as_json));
+  std::string json_dumped = KATANA_CHECKED(katana::JsonDump(from_json));
+  KATANA_LOG_ASSERT(json_dumped == expected);
+
+  std::string binary = KATANA_CHECKED(header.Serialize());
+  if (!unstable) {
+    KATANA_LOG_ASSERT(binary == as_json);
+    return katana::ResultSuccess();
+  }
+  KATANA_LOG_ASSERT(binary.front() != '{');
+  KATANA_LOG_VASSERT(
+      binary.size() < as_json.size(), "binary header {} bytes, json {} bytes",
+      binary.size(), as_json.size());
+  katana::RDGPartHeader from_binary =
+      KATANA_CHECKED(katana::RDGPartHeader::Deserialize(binary));
+  std::string binary_dumped = KATANA_CHECKED(katana::JsonDump(from_binary));
+  KATANA_LOG_ASSERT(binary_dumped == expected);
+  KATANA_LOG_ASSERT(from_binary.unstable_storage_format());
+
+  // a truncated binary header is an error, not a crash
+  KATANA_LOG_ASSERT(!katana::RDGPartHeader::Deserialize(
+      std::string_view(binary).substr(0, binary.size() / 2)));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path_to_header) {
   KATANA_CHECKED(TestPropInfoLists(path_to_header));
+  KATANA_CHECKED(TestSerialize(path_to_header));
   return katana::ResultSuccess();
 }
 
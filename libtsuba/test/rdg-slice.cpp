@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "katana/ProgressTracer.h"
 #include "katana/RDGManifest.h"
 #include "katana/RDGSlice.h"
@@ -100,9 +102,130 @@ TestPropertyLoading(const std::string& path_to_manifest) {
   return katana::ResultSuccess();
 }
 
+// A slice reads the part of the topology that covers its nodes and edges,
+// and it matches the corresponding part of the whole topology
+katana::Result<void>
+TestTopologySlicing(const std::string& path_to_manifest) {
+  katana::RDGManifest manifest =
+      KATANA_CHECKED(katana::FindManifest(path_to_manifest));
+  katana::RDGHandle rdg_handle =
+      KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadOnly));
+  katana::RDGFile handle(rdg_handle);
+
+  std::vector<std::string> no_props;
+  katana::RDGSlice::SliceArg header_arg{
+      .node_range = std::make_pair(0, 0),
+      .edge_range = std::make_pair(0, 0),
+      .topo_off = 0,
+      .topo_size = 0};
+  auto header_slice = KATANA_CHECKED(
+      katana::RDGSlice::Make(rdg_handle, header_arg, 0, no_props, no_props));
+  const auto* header = header_slice.topology_file_storage().ptr<uint64_t>();
+  uint64_t num_nodes = header[2];
+  uint64_t num_edges = header[3];
+  KATANA_LOG_ASSERT(num_nodes > 4);
+
+  katana::RDGSlice::SliceArg full_arg{
+      .node_range = std::make_pair(0, num_nodes),
+      .edge_range = std::make_pair(0, num_edges),
+      .topo_off = 0,
+      .topo_size = 0};
+  auto full = KATANA_CHECKED(
+      katana::RDGSlice::Make(rdg_handle, full_arg, 0, no_props, no_props));
+  const auto* adj_indices = full.topology_file_storage().ptr<uint64_t>() + 4;
+  const auto* dests =
+      reinterpret_cast<const uint32_t*>(adj_indices + num_nodes);
+
+  uint64_t first_node = num_nodes / 4;
+  uint64_t last_node = num_nodes / 2;
+  uint64_t first_edge = adj_indices[first_node - 1];
+  uint64_t last_edge = adj_indices[last_node - 1];
+  katana::RDGSlice::SliceArg part_arg{
+      .node_range = std::make_pair(first_node, last_node),
+      .edge_range = std::make_pair(first_edge, last_edge),
+      .topo_off = 0,
+      .topo_size = 0};
+  auto part = KATANA_CHECKED(
+      katana::RDGSlice::Make(rdg_handle, part_arg, 0, no_props, no_props));
+  const auto* part_adj_indices =
+      part.topology_file_storage().ptr<uint64_t>() + 4;
+  const auto* part_dests =
+      reinterpret_cast<const uint32_t*>(part_adj_indices + num_nodes);
+  for (uint64_t n = first_node; n < last_node; ++n) {
+    KATANA_LOG_ASSERT(part_adj_indices[n] == adj_indices[n]);
+  }
+  for (uint64_t e = first_edge; e < last_edge; ++e) {
+    KATANA_LOG_ASSERT(part_dests[e] == dests[e]);
+  }
+
+  return katana::ResultSuccess();
+}
+
+// Planned slices cover the partition in order, each with the edges of its
+// nodes, and none weighs much more than an even share
+katana::Result<void>
+TestPlanSlices(const std::string& path_to_manifest) {
+  katana::RDGManifest manifest =
+      KATANA_CHECKED(katana::FindManifest(path_to_manifest));
+  katana::RDGHandle rdg_handle =
+      KATANA_CHECKED(katana::Open(std::move(manifest), katana::kReadOnly));
+  katana::RDGFile handle(rdg_handle);
+
+  constexpr uint32_t kNumSlices = 7;
+  auto slices =
+      KATANA_CHECKED(katana::RDGSlice::PlanSlices(rdg_handle, kNumSlices));
+  KATANA_LOG_ASSERT(slices.size() == kNumSlices);
+
+  std::vector<std::string> no_props;
+  auto last = KATANA_CHECKED(katana::RDGSlice::Make(
+      rdg_handle, slices.back(), 0, no_props, no_props));
+  const auto* header = last.topology_file_storage().ptr<uint64_t>();
+  uint64_t num_nodes = header[2];
+  uint64_t num_edges = header[3];
+
+  uint64_t max_degree = 0;
+  uint64_t next_node = 0;
+  uint64_t next_edge = 0;
+  for (const auto& slice : slices) {
+    KATANA_LOG_ASSERT(slice.node_range.first == next_node);
+    KATANA_LOG_ASSERT(slice.edge_range.first == next_edge);
+    KATANA_LOG_ASSERT(slice.node_range.first <= slice.node_range.second);
+    next_node = slice.node_range.second;
+    next_edge = slice.edge_range.second;
+
+    auto loaded = KATANA_CHECKED(
+        katana::RDGSlice::Make(rdg_handle, slice, 0, no_props, no_props));
+    const auto* adj_indices =
+        loaded.topology_file_storage().ptr<uint64_t>() + 4;
+    for (uint64_t n = slice.node_range.first; n < slice.node_range.second;
+         ++n) {
+      uint64_t prev = n == 0 ? 0 : adj_indices[n - 1];
+      max_degree = std::max(max_degree, adj_indices[n] - prev);
+    }
+  }
+  KATANA_LOG_ASSERT(next_node == num_nodes);
+  KATANA_LOG_ASSERT(next_edge == num_edges);
+
+  // a slice can go over its share by at most the node that crosses it
+  uint64_t share = (num_nodes + num_edges) / kNumSlices + 1;
+  for (const auto& slice : slices) {
+    uint64_t weight = slice.node_range.second - slice.node_range.first +
+                      slice.edge_range.second - slice.edge_range.first;
+    KATANA_LOG_VASSERT(
+        weight <= share + max_degree + 1, "slice weight {} share {}", weight,
+        share);
+  }
+
+  KATANA_LOG_ASSERT(!katana::RDGSlice::PlanSlices(rdg_handle, 0));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path_to_manifest) {
   KATANA_CHECKED(TestPropertyLoading(path_to_manifest));
+  KATANA_CHECKED(TestTopologySlicing(path_to_manifest));
+  KATANA_CHECKED(TestPlanSlices(path_to_manifest));
   return katana::ResultSuccess();
 }
 }  // namespace
@@ -0,0 +1,117 @@
+#include <string>
+#include <vector>
+
+#include "S3Storage.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+
+namespace {
+
+void
+TestParseS3URI() {
+  auto object = katana::ParseS3URI("s3://bucket/dir/file.parquet");
+  KATANA_LOG_ASSERT(object);
+  KATANA_LOG_ASSERT(object.value().bucket == "bucket");
+  KATANA_LOG_ASSERT(object.value().key == "dir/file.parquet");
+
+  auto bucket = katana::ParseS3URI("s3://bucket");
+  KATANA_LOG_ASSERT(bucket);
+  KATANA_LOG_ASSERT(bucket.value().bucket == "bucket");
+  KATANA_LOG_ASSERT(bucket.value().key.empty());
+
+  auto no_bucket = katana::ParseS3URI("s3:///key");
+  KATANA_LOG_ASSERT(!no_bucket);
+  KATANA_LOG_ASSERT(no_bucket.error() == katana::ErrorCode::InvalidArgument);
+
+  KATANA_LOG_ASSERT(!katana::ParseS3URI("file:///tmp/key"));
+}
+
+void
+TestSplitIntoParts() {
+  using Parts = std::vector<std::pair<uint64_t, uint64_t>>;
+  KATANA_LOG_ASSERT(katana::SplitIntoParts(100, 0, 10).empty());
+  KATANA_LOG_ASSERT(
+      katana::SplitIntoParts(100, 25, 10) ==
+      (Parts{{100, 10}, {110, 10}, {120, 5}}));
+  KATANA_LOG_ASSERT(
+      katana::SplitIntoParts(0, 20, 10) == (Parts{{0, 10}, {10, 10}}));
+  KATANA_LOG_ASSERT(katana::SplitIntoParts(7, 3, 10) == (Parts{{7, 3}}));
+}
+
+void
+TestXmlElements() {
+  std::string list = R"(<?xml version="1.0" encoding="UTF-8"?>
+<ListBucketResult>
+  <Name>bucket</Name>
+  <Prefix>dir/</Prefix>
+  <IsTruncated>true</IsTruncated>
+  <Contents><Key>dir/a</Key><Size>10</Size></Contents>
+  <Contents><Key>dir/b&amp;c</Key><Size>20</Size></Contents>
+  <CommonPrefixes><Prefix>dir/sub/</Prefix></CommonPrefixes>
+  <NextContinuationToken>token&lt;1&gt;</NextContinuationToken>
+</ListBucketResult>)";
+
+  std::vector<std::string> contents = katana::XmlElements(list, "Contents");
+  KATANA_LOG_ASSERT(contents.size() == 2);
+  KATANA_LOG_ASSERT(
+      katana::XmlElements(contents[0], "Key") ==
+      std::vector<std::string>{"dir/a"});
+  KATANA_LOG_ASSERT(
+      katana::XmlElements(contents[1], "Key") ==
+      std::vector<std::string>{"dir/b&c"});
+  KATANA_LOG_ASSERT(
+      katana::XmlElements(contents[1], "Size") ==
+      std::vector<std::string>{"20"});
+  KATANA_LOG_ASSERT(
+      katana::XmlElements(list, "NextContinuationToken") ==
+      std::vector<std::string>{"token<1>"});
+  KATANA_LOG_ASSERT(katana::XmlElements(list, "Missing").empty());
+
+  std::string upload = R"(<InitiateMultipartUploadResult>
+<Bucket>bucket</Bucket><Key>key</Key><UploadId>abc.def-1</UploadId>
+</InitiateMultipartUploadResult>)";
+  KATANA_LOG_ASSERT(
+      katana::XmlElements(upload, "UploadId") ==
+      std::vector<std::string>{"abc.def-1"});
+
+  // unterminated elements are dropped
+  KATANA_LOG_ASSERT(katana::XmlElements("<Key>a", "Key").empty());
+}
+
+void
+TestUrlEncode() {
+  KATANA_LOG_ASSERT(katana::UrlEncode("a-b_c.d~e", false) == "a-b_c.d~e");
+  KATANA_LOG_ASSERT(katana::UrlEncode("a b/c", false) == "a%20b%2Fc");
+  KATANA_LOG_ASSERT(katana::UrlEncode("a b/c", true) == "a%20b/c");
+  KATANA_LOG_ASSERT(katana::UrlEncode("x=1&y", false) == "x%3D1%26y");
+}
+
+void
+TestMakeS3URL() {
+  KATANA_LOG_ASSERT(
+      katana::MakeS3URL(
+          "https://s3.us-east-1.amazonaws.com", true, "bucket", "dir/a b",
+          "") == "https://bucket.s3.us-east-1.amazonaws.com/dir/a%20b");
+  KATANA_LOG_ASSERT(
+      katana::MakeS3URL(
+          "http://localhost:9000", false, "bucket", "key", "uploads") ==
+      "http://localhost:9000/bucket/key?uploads");
+  KATANA_LOG_ASSERT(
+      katana::MakeS3URL(
+          "http://localhost:9000", false, "bucket", "", "list-type=2") ==
+      "http://localhost:9000/bucket/?list-type=2");
+}
+
+}  // namespace
+
+int
+main() {
+  TestParseS3URI();
+  TestSplitIntoParts();
+  TestXmlElements();
+  TestUrlEncode();
+  TestMakeS3URL();
+
+  return 0;
+}
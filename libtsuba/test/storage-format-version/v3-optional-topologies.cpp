@@ -116,7 +116,7 @@ TestGraphComplexOptionalTopologyRoundTrip(const std::string& rdg_name) {
     adj_indices_copy[i] = csr->adj_indices()[i];
   }
 
-  uint32_t dests_copy[csr_num_edges];
+  katana::RDGTopology::Node dests_copy[csr_num_edges];
   for (size_t i = 0; i < csr_num_nodes; i++) {
     dests_copy[i] = csr->dests()[i];
   }
@@ -203,7 +203,7 @@ TestGraphOptionalTopologyRoundTrip(const std::string& rdg_name) {
     adj_indices_copy[i] = csr->adj_indices()[i];
   }
 
-  uint32_t dests_copy[csr_num_edges];
+  katana::RDGTopology::Node dests_copy[csr_num_edges];
   for (size_t i = 0; i < csr_num_nodes; i++) {
     dests_copy[i] = csr->dests()[i];
   }
@@ -0,0 +1,78 @@
+#include <filesystem>
+#include <string>
+
+#include "test-rdg.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/RDG.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/tsuba.h"
+
+namespace {
+
+// small enough that copies of the test inputs wait for each other
+constexpr uint64_t kMaxOutstandingSize = 1 << 20;
+
+std::string
+TempDir() {
+  auto uri_res = katana::URI::MakeRand("/tmp/uprev-rdg");
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value().path();  // path() because local
+}
+
+/// An RDG in the latest formats is upgraded by copying its files, and the copy
+/// loads as the same RDG; upgrading it again over the copy skips the files
+/// that are already there
+katana::Result<void>
+TestPassThrough(const std::string& rdg_dir) {
+  std::string dst_dir = TempDir();
+  KATANA_CHECKED(katana::UprevRDG(rdg_dir, dst_dir, kMaxOutstandingSize));
+
+  katana::RDG expected = KATANA_CHECKED(LoadRDG(rdg_dir));
+  katana::RDG upgraded = KATANA_CHECKED(LoadRDG(dst_dir));
+  KATANA_LOG_ASSERT(expected.Equals(upgraded));
+
+  KATANA_CHECKED(katana::UprevRDG(rdg_dir, dst_dir, kMaxOutstandingSize));
+  katana::RDG upgraded_again = KATANA_CHECKED(LoadRDG(dst_dir));
+  KATANA_LOG_ASSERT(expected.Equals(upgraded_again));
+
+  std::filesystem::remove_all(dst_dir);
+  return katana::ResultSuccess();
+}
+
+/// An RDG with files in older formats is refused before anything is copied
+katana::Result<void>
+TestMustConvert(const std::string& old_rdg_dir) {
+  std::string dst_dir = TempDir();
+  auto res = katana::UprevRDG(old_rdg_dir, dst_dir, kMaxOutstandingSize);
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::NotImplemented);
+  KATANA_LOG_ASSERT(!std::filesystem::exists(dst_dir));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  if (argc <= 2) {
+    KATANA_LOG_FATAL(
+        "uprev-rdg <latest rdg> <rdg before storage_format_version 4>");
+  }
+
+  if (auto res = TestPassThrough(argv[1]); !res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+  if (auto res = TestMustConvert(argv[2]); !res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+  return 0;
+}
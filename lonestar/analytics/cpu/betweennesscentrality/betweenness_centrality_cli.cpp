@@ -61,7 +61,9 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         clEnumValN(
             BetweennessCentralityPlan::kLevel, "Level",
             "Level parallel algorithm"),
-        // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAsynchronous, "Async",
+            "Asynchronous algorithm"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
             "Outer parallel algorithm")
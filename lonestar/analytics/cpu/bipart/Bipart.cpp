@@ -277,16 +277,41 @@ ConstructNewGraph(
     const std::vector<uint32_t>& num_hedges_per_partition,
     const uint32_t num_hedges, HyperGraph* graph,
     const std::vector<HyperGraph*>& gr) {
-  std::vector<katana::gstl::Vector<katana::PODVector<uint32_t>>> edges_ids(
-      num_partitions);
-  std::vector<NUMAArrayUint64Ty> edges_prefixsum(num_partitions);
+  // A kept hyperedge keeps all of its pins, so the pins of each subgraph are
+  // counted first and then written straight into its CSR arrays.
+  std::vector<NUMAArrayUint64Ty> pins_prefixsum(num_partitions);
 
   for (uint32_t i : current_level_indices) {
     uint32_t index = pgraph_index[i];
     uint32_t total_nodes =
         num_hedges_per_partition[index] + num_hnodes_per_partition[index];
-    edges_ids[index].resize(total_nodes);
-    edges_prefixsum[index].allocateInterleaved(total_nodes);
+    pins_prefixsum[index].allocateInterleaved(total_nodes);
+    katana::ParallelSTL::fill(
+        pins_prefixsum[index].begin(), pins_prefixsum[index].end(),
+        uint64_t{0});
+  }
+
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_hedges),
+      [&](GNode src) {
+        MetisNode& src_node = graph->getData(src);
+        uint32_t partition = src_node.partition;
+        if (partition == kInfPartition) {
+          return;
+        }
+        uint32_t index = pgraph_index[partition];
+        pins_prefixsum[index][src_node.child_id] = graph->getDegree(src);
+      },
+      katana::loopname("Count-Pins"));
+
+  std::vector<katana::NUMAArray<uint32_t>> pins(num_partitions);
+  for (uint32_t i : current_level_indices) {
+    uint32_t index = pgraph_index[i];
+    katana::ParallelSTL::partial_sum(
+        pins_prefixsum[index].begin(), pins_prefixsum[index].end(),
+        pins_prefixsum[index].begin());
+    pins[index].allocateInterleaved(
+        pins_prefixsum[index].empty() ? 0 : pins_prefixsum[index].back());
   }
 
   katana::do_all(
@@ -299,41 +324,21 @@ ConstructNewGraph(
         }
         uint32_t index = pgraph_index[partition];
         GNode slot_id = src_node.child_id;
+        uint64_t pin = slot_id == 0 ? 0 : pins_prefixsum[index][slot_id - 1];
 
         for (auto& e : graph->edges(src)) {
           GNode dst = graph->getEdgeDst(e);
-          GNode dst_slot_id = graph->getData(dst).child_id;
-          edges_ids[index][slot_id].push_back(dst_slot_id);
+          pins[index][pin++] = graph->getData(dst).child_id;
         }
       },
       katana::steal(), katana::chunk_size<kChunkSize>(),
-      katana::loopname("Build-EdgeIds"));
-
-  std::vector<katana::GAccumulator<uint64_t>> num_edges_acc(num_partitions);
-
-  for (uint32_t i : current_level_indices) {
-    uint32_t index = pgraph_index[i];
-    for (uint32_t c = 0; c < num_hedges_per_partition[index]; c++) {
-      edges_prefixsum[index][c] = edges_ids[index][c].size();
-      num_edges_acc[index] += edges_prefixsum[index][c];
-    }
-  }
+      katana::loopname("Build-Pins"));
 
   for (uint32_t i : current_level_indices) {
     uint32_t index = pgraph_index[i];
-    uint64_t edges = num_edges_acc[index].reduce();
-    uint32_t ipart_num_nodes =
-        num_hedges_per_partition[index] + num_hnodes_per_partition[index];
-    HyperGraph* cur_graph = gr[index];
-    for (uint32_t c = 1; c < ipart_num_nodes; ++c) {
-      edges_prefixsum[index][c] += edges_prefixsum[index][c - 1];
-    }
-
-    cur_graph->constructFrom(
-        ipart_num_nodes, edges, std::move(edges_prefixsum[index]),
-        edges_ids[index]);
-    cur_graph->SetHedges(num_hedges_per_partition[index]);
-    cur_graph->SetHnodes(num_hnodes_per_partition[index]);
+    gr[index]->ConstructFrom(
+        num_hedges_per_partition[index], num_hnodes_per_partition[index],
+        std::move(pins_prefixsum[index]), std::move(pins[index]));
   }
 
   for (uint32_t i : current_level_indices) {
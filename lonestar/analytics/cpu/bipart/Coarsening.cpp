@@ -24,9 +24,13 @@
  *  partitioning algorithm
  */
 
+#include <algorithm>
+#include <vector>
+
 #include "Helper.h"
 #include "katana/AtomicHelpers.h"
 #include "katana/DynamicBitset.h"
+#include "katana/PerThreadStorage.h"
 
 // maximum weight limit for a coarsened node
 WeightTy kLimitWeights[100];
@@ -752,8 +756,6 @@ ParallelCreateEdges(
       },
       katana::loopname("Coarsening-Update-Parents"));
 
-  std::vector<katana::gstl::Vector<katana::PODVector<uint32_t>>> edges_id(
-      num_partitions);
   std::vector<std::vector<NetnumTy>> old_id(num_partitions);
   std::vector<uint32_t> num_nodes_next(num_partitions);
 
@@ -765,10 +767,8 @@ ParallelCreateEdges(
         }
         uint32_t i_num_hedge = hnum[i];
         uint32_t i_num_fedge = nodes[i];
-        uint32_t num_iedges = i_num_fedge + i_num_hedge;
         num_nodes_next[i] = i_num_hedge + i_num_fedge;
 
-        edges_id[i].resize(num_iedges);
         old_id[i].resize(i_num_hedge);
 
         GNode h_id{0};
@@ -783,6 +783,34 @@ ParallelCreateEdges(
       },
       katana::steal(), katana::loopname("Coarsening-Set-NodeIds"));
 
+  // The pins of a coarsened hyperedge are the distinct parents of the pins of
+  // its finer hyperedge. They are found once to count them and once more to
+  // write them, so that the coarsened graph is built straight into its CSR
+  // arrays instead of through a list of pins per hyperedge.
+  katana::PerThreadStorage<std::vector<GNode>> parents_scratch;
+  auto find_parents = [&](HyperGraph* f_graph,
+                          GNode hedge) -> const std::vector<GNode>& {
+    std::vector<GNode>& parents = *parents_scratch.getLocal();
+    parents.clear();
+    for (auto& fedge : f_graph->edges(hedge)) {
+      parents.emplace_back(f_graph->getData(f_graph->getEdgeDst(fedge)).parent);
+    }
+    std::sort(parents.begin(), parents.end());
+    parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+    return parents;
+  };
+
+  std::vector<katana::NUMAArray<uint64_t>> pins_prefixsum(num_partitions);
+  for (uint32_t i = 0; i < num_partitions; ++i) {
+    if (fine_graphs[i] == nullptr) {
+      continue;
+    }
+    pins_prefixsum[i].allocateInterleaved(num_nodes_next[i]);
+    // Coarsened nodes have no pins
+    katana::ParallelSTL::fill(
+        pins_prefixsum[i].begin(), pins_prefixsum[i].end(), uint64_t{0});
+  }
+
   katana::do_all(
       katana::iterate(uint32_t{0}, total_hedges),
       [&](uint32_t v) {
@@ -795,62 +823,53 @@ ParallelCreateEdges(
         }
 
         HyperGraph* f_graph = fine_graphs[index];
-
         GNode id = f_graph->getData(n).node_id;
-
-        for (auto& fedge : f_graph->edges(n)) {
-          GNode dst = f_graph->getEdgeDst(fedge);
-          MetisNode& dst_data = f_graph->getData(dst);
-          GNode pid = dst_data.parent;
-          auto parent_iter = std::find(
-              edges_id[index][id].begin(), edges_id[index][id].end(), pid);
-          // If a parent does not exist in the edge id array,
-          // then add it.
-          if (parent_iter == edges_id[index][id].end()) {
-            edges_id[index][id].push_back(pid);
-          }
-        }
+        pins_prefixsum[index][id] = find_parents(f_graph, n).size();
       },
       katana::steal(), katana::chunk_size<kChunkSize>(),
-      katana::loopname("Coarsening-Build-EdgeIds"));
-
-  std::vector<katana::NUMAArray<uint64_t>> edges_prefixsum(num_partitions);
-  std::vector<katana::GAccumulator<uint64_t>> num_edges_acc(num_partitions);
+      katana::loopname("Coarsening-Count-Pins"));
 
+  std::vector<katana::NUMAArray<uint32_t>> pins(num_partitions);
   for (uint32_t i = 0; i < num_partitions; ++i) {
     if (fine_graphs[i] == nullptr) {
       continue;
     }
+    katana::ParallelSTL::partial_sum(
+        pins_prefixsum[i].begin(), pins_prefixsum[i].end(),
+        pins_prefixsum[i].begin());
     uint32_t num_ith_nodes = num_nodes_next[i];
-    edges_prefixsum[i].allocateInterleaved(num_ith_nodes);
-
-    katana::do_all(
-        katana::iterate(uint32_t{0}, num_ith_nodes),
-        [&](uint32_t c) {
-          edges_prefixsum[i][c] = edges_id[i][c].size();
-          num_edges_acc[i] += edges_prefixsum[i][c];
-        },
-        katana::loopname("Coarsening-PrefixSum"));
+    pins[i].allocateInterleaved(
+        num_ith_nodes == 0 ? 0 : pins_prefixsum[i][num_ith_nodes - 1]);
   }
 
+  katana::do_all(
+      katana::iterate(uint32_t{0}, total_hedges),
+      [&](uint32_t v) {
+        auto hedge_index_pair = combined_edge_list[v];
+        uint32_t index = hedge_index_pair.second;
+        GNode n = hedge_index_pair.first;
+
+        if (!hedges[index].test(n)) {
+          return;
+        }
+
+        HyperGraph* f_graph = fine_graphs[index];
+        GNode id = f_graph->getData(n).node_id;
+        uint64_t begin = id == 0 ? 0 : pins_prefixsum[index][id - 1];
+        const std::vector<GNode>& parents = find_parents(f_graph, n);
+        std::copy(parents.begin(), parents.end(), pins[index].begin() + begin);
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(),
+      katana::loopname("Coarsening-Build-Pins"));
+
   for (uint32_t i = 0; i < num_partitions; ++i) {
     if (fine_graphs[i] == nullptr) {
       continue;
     }
 
-    uint32_t num_ith_nodes = num_nodes_next[i];
-    uint64_t num_edges_next = num_edges_acc[i].reduce();
-
-    katana::ParallelSTL::partial_sum(
-        edges_prefixsum[i].begin(), edges_prefixsum[i].end(),
-        edges_prefixsum[i].begin());
-
     HyperGraph* c_graph = coarse_graphs[i];
-    c_graph->constructFrom(
-        num_ith_nodes, num_edges_next, std::move(edges_prefixsum[i]),
-        edges_id[i]);
-    c_graph->SetHedges(hnum[i]);
-    c_graph->SetHnodes(nodes[i]);
+    c_graph->ConstructFrom(
+        hnum[i], nodes[i], std::move(pins_prefixsum[i]), std::move(pins[i]));
     katana::do_all(
         katana::iterate(*c_graph),
         [&](GNode n) {
@@ -49,10 +49,14 @@ ConstructGraph(
 
   katana::StatTimer timer_graph_construt("MetisGraphConstruct");
   timer_graph_construt.start();
-  // Inspection phase: count the number of hyper edges.
+  // Inspection phase: count the hyper edges and their pins.
+  auto keep_hedge = [&](uint32_t num_nodes_in_hedge) {
+    return !skip_isolated_hedges || num_nodes_in_hedge > 1;
+  };
   uint32_t num_read_hedges{0};
+  uint32_t num_lines{0};
   while (std::getline(f, line)) {
-    if (num_read_hedges >= num_hedges) {
+    if (num_lines++ >= num_hedges) {
       KATANA_LOG_FATAL("ERROR: too many lines in input file");
     }
     std::stringstream ss(line);
@@ -65,8 +69,9 @@ ConstructGraph(
       num_nodes_in_hedge++;
     }
 
-    if (num_nodes_in_hedge > 1) {
+    if (keep_hedge(num_nodes_in_hedge)) {
       num_read_hedges++;
+      num_fedges += num_nodes_in_hedge;
     }
   }
   num_hedges = num_read_hedges;
@@ -77,62 +82,42 @@ ConstructGraph(
   f.seekg(0);
   std::getline(f, line);
 
-  // Execution phase: construct hyper graph.
-  EdgeDstVecTy edges_id(total_num_nodes);
+  // Execution phase: write the pins straight into the CSR arrays.
+  // # nodes = (# of hyper edges + # of nodes), which means each hyper edge
+  // is considered as a node.
+  // # edges = (# of normal edges).
   NUMAArrayUint64Ty prefix_edges;
   prefix_edges.allocateInterleaved(total_num_nodes);
+  katana::NUMAArray<uint32_t> pins;
+  pins.allocateInterleaved(num_fedges);
+  std::vector<GNode> hedge_pins;
   num_read_hedges = 0;
+  uint64_t num_written_pins{0};
   while (std::getline(f, line)) {
-    if (num_read_hedges > num_hedges) {
-      KATANA_LOG_FATAL("ERROR: too many lines in input file");
-    }
     std::stringstream ss(line);
     GNode node_id;
-    GNode first_new_node_id{0};
-    uint32_t num_nodes_in_hedge{0};
+    hedge_pins.clear();
     while (ss >> node_id) {
-      if (node_id < 1 || node_id > num_hnodes) {
-        KATANA_LOG_FATAL("ERROR: node id {} out of bounds", node_id);
-      }
       // Node is relocated to the next slots of the hyper edge.
-      GNode new_node_id = num_hedges + (node_id - 1);
-      if (!skip_isolated_hedges) {
-        edges_id[num_read_hedges].push_back(new_node_id);
-      } else {
-        if (num_nodes_in_hedge > 0) {
-          if (num_nodes_in_hedge == 1) {
-            edges_id[num_read_hedges].push_back(first_new_node_id);
-          }
-          edges_id[num_read_hedges].push_back(new_node_id);
-        } else {
-          // If user passes the option to ignore hyperedges with only one node,
-          // then do not push the first node now.
-          // Just postpone pushing this and push it if the current hyperedge
-          // has at least 2 nodes.
-          first_new_node_id = new_node_id;
-        }
-        num_nodes_in_hedge++;
-      }
+      hedge_pins.emplace_back(num_hedges + (node_id - 1));
     }
 
-    if (skip_isolated_hedges && num_nodes_in_hedge < 2) {
+    if (!keep_hedge(hedge_pins.size())) {
       continue;
     }
-    prefix_edges[num_read_hedges] = num_nodes_in_hedge;
-    num_fedges += prefix_edges[num_read_hedges++];
+    std::copy(
+        hedge_pins.begin(), hedge_pins.end(),
+        pins.begin() + num_written_pins);
+    num_written_pins += hedge_pins.size();
+    prefix_edges[num_read_hedges++] = num_written_pins;
   }
   f.close();
-  graph->SetHedges(num_hedges);
-  graph->SetHnodes(num_hnodes);
-
-  katana::ParallelSTL::partial_sum(
-      prefix_edges.begin(), prefix_edges.end(), prefix_edges.begin());
+  KATANA_LOG_ASSERT(num_written_pins == num_fedges);
+  std::fill(
+      prefix_edges.begin() + num_hedges, prefix_edges.end(), num_written_pins);
 
-  // # nodes = (# of hyper edges + # of nodes), which means each hyper edge
-  // is considered as a node.
-  // # edges = (# of normal edges).
-  graph->constructFrom(
-      total_num_nodes, num_fedges, std::move(prefix_edges), edges_id);
+  graph->ConstructFrom(
+      num_hedges, num_hnodes, std::move(prefix_edges), std::move(pins));
   InitNodes(graph, num_hedges);
 
   timer_graph_construt.stop();
@@ -0,0 +1,99 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Bipartite Matching";
+const char* desc =
+    "Computes a maximum cardinality matching between two types of nodes";
+const char* url = "bipartite_matching";
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<std::string> leftNodeType(
+    "leftNodeType", cll::desc("Node type of the left side"), cll::Required);
+cll::opt<std::string> rightNodeType(
+    "rightNodeType", cll::desc("Node type of the right side"), cll::Required);
+
+cll::opt<BipartiteMatchingPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(
+        clEnumValN(
+            BipartiteMatchingPlan::kPothenFan, "PothenFan",
+            "Parallel Pothen-Fan with lookahead (default)"),
+        clEnumValN(
+            BipartiteMatchingPlan::kPushRelabel, "PushRelabel",
+            "Parallel push-relabel with global relabeling")),
+    cll::init(BipartiteMatchingPlan::kPothenFan));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  BipartiteMatchingPlan plan = BipartiteMatchingPlan::PothenFan();
+  if (algo == BipartiteMatchingPlan::kPushRelabel) {
+    plan = BipartiteMatchingPlan::PushRelabel();
+  }
+
+  katana::TxnContext txn_ctx;
+  if (auto r = BipartiteMatching(
+          pg.get(), leftNodeType, rightNodeType, "matched", &txn_ctx, plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+
+  auto stats_result = BipartiteMatchingStatistics::Compute(
+      pg.get(), leftNodeType, rightNodeType, "matched");
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (BipartiteMatchingAssertValid(
+            pg.get(), leftNodeType, rightNodeType, "matched")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetEdgePropertyTyped<uint8_t>("matched");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get edge property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(uint64_t(results->length()) == pg->NumEdges());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -205,7 +205,7 @@ main(int argc, char** argv) {
         " component sample frequency: ", componentSampleFrequency);
     katana::gInfo("WARNING: Performance may vary due to the parameters");
     plan = ConnectedComponentsPlan::EdgeTiledAfforest(
-        neighborSampleSize, componentSampleFrequency);
+        edgeTileSize, neighborSampleSize, componentSampleFrequency);
     break;
   default:
     std::cerr << "Invalid algorithm\n";
@@ -0,0 +1,117 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/fast_rp/fast_rp.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "FastRP";
+static const char* desc =
+    "Computes node embeddings by very sparse random projection";
+static const char* url = "fast_rp";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<uint32_t> embeddingDimension(
+    "embeddingDimension",
+    cll::desc("Number of floats in the embedding of a node (default value "
+              "128)"),
+    cll::init(FastRPPlan::kDefaultEmbeddingDimension));
+
+static cll::list<double> iterationWeights(
+    "iterationWeights",
+    cll::desc("Comma separated weights of the averages over 1, 2, ... hops "
+              "(default value 0,1,1)"),
+    cll::CommaSeparated);
+
+static cll::opt<uint32_t> sparsity(
+    "sparsity",
+    cll::desc("One in sparsity entries of the random projection is nonzero; "
+              "0 for the square root of the number of nodes (default value "
+              "0)"),
+    cll::init(FastRPPlan::kDefaultSparsity));
+
+static cll::opt<double> normalizationStrength(
+    "normalizationStrength",
+    cll::desc("Exponent of the degree scaling of the random projection "
+              "(default value 0)"),
+    cll::init(FastRPPlan::kDefaultNormalizationStrength));
+
+static cll::opt<uint32_t> seed(
+    "seed", cll::desc("Seed of the random projection (default value 0)"),
+    cll::init(FastRPPlan::kDefaultSeed));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_LOG_WARN(
+        "This application is meant for symmetric graphs; embeddings of a "
+        "directed graph only summarize the out-neighborhoods of the nodes");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
+            << pg->topology().NumEdges() << " edges\n";
+
+  std::vector<double> weights(iterationWeights.begin(), iterationWeights.end());
+  if (weights.empty()) {
+    weights = FastRPPlan::DefaultIterationWeights();
+  }
+  FastRPPlan plan = FastRPPlan::VerySparseProjection(
+      embeddingDimension, weights, sparsity, normalizationStrength, seed);
+
+  katana::TxnContext txn_ctx;
+  if (auto r = FastRP(pg.get(), "embedding", &txn_ctx, plan); !r) {
+    KATANA_LOG_FATAL("Failed to run FastRP: {}", r.error());
+  }
+
+  auto stats_result = FastRPStatistics::Compute(pg.get(), "embedding");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute FastRP statistics: {}", stats_result.error());
+  }
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (FastRPAssertValid(pg.get(), "embedding")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Graph Coloring";
+const char* desc =
+    "Colors the nodes of a graph so that no edge joins two nodes of the same "
+    "color";
+const char* url = "graph_coloring";
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<GraphColoringPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(
+        clEnumValN(
+            GraphColoringPlan::kJonesPlassmann, "JonesPlassmann",
+            "Jones-Plassmann with largest-degree-first priorities (default)"),
+        clEnumValN(
+            GraphColoringPlan::kSpeculative, "Speculative",
+            "Speculative coloring with conflict repair")),
+    cll::init(GraphColoringPlan::kJonesPlassmann));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_DIE(
+        "graph coloring requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  GraphColoringPlan plan = GraphColoringPlan::FromAlgorithm(algo);
+
+  katana::TxnContext txn_ctx;
+  if (auto r = GraphColoring(pg.get(), "color", &txn_ctx, plan); !r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+
+  auto stats_result = GraphColoringStatistics::Compute(pg.get(), "color");
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (GraphColoringAssertValid(pg.get(), "color")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint32_t>("color");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(uint64_t(results->length()) == pg->size());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
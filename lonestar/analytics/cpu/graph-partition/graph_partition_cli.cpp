@@ -0,0 +1,96 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/graph_partition/graph_partition.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Graph Partition";
+const char* desc =
+    "Partitions the nodes of a graph into parts of about the same size with "
+    "few edges between them";
+const char* url = "graph_partition";
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<uint32_t> numPartitions(
+    "numPartitions", cll::desc("Number of partitions (default value 2)"),
+    cll::init(2));
+
+cll::opt<double> imbalance(
+    "imbalance",
+    cll::desc("Fraction by which a partition may be larger than the average "
+              "(default value 0.05)"),
+    cll::init(GraphPartitionPlan::kDefaultImbalance));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_DIE(
+        "graph partition requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  GraphPartitionPlan plan = GraphPartitionPlan::Multilevel(imbalance);
+
+  katana::TxnContext txn_ctx;
+  if (auto r = GraphPartition(
+          pg.get(), numPartitions, "partition", &txn_ctx, plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+
+  auto stats_result = GraphPartitionStatistics::Compute(pg.get(), "partition");
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (GraphPartitionAssertValid(pg.get(), numPartitions, "partition")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint32_t>("partition");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(uint64_t(results->length()) == pg->size());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -48,7 +48,10 @@ static cll::opt<KCorePlan::Algorithm> algo(
             KCorePlan::kSynchronous, "Synchronous", "Synchronous algorithm"),
         clEnumValN(
             KCorePlan::kAsynchronous, "Asynchronous",
-            "Asynchronous algorithm")),
+            "Asynchronous algorithm"),
+        clEnumValN(
+            KCorePlan::kBucketed, "Bucketed",
+            "Bucketed peeling algorithm")),
     cll::init(KCorePlan::kSynchronous));
 
 //! Required k specification for k-core.
@@ -58,6 +61,12 @@ static cll::opt<uint32_t> kCoreNumber(
               "kCoreNumber value (default value 10)"),
     cll::init(10));
 
+static cll::opt<bool> coreness(
+    "coreness",
+    cll::desc("Compute the coreness of every node instead of the k-core "
+              "(default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(KCorePlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -65,6 +74,8 @@ AlgorithmName(KCorePlan::Algorithm algorithm) {
     return "Synchronous";
   case KCorePlan::kAsynchronous:
     return "Asynchronous";
+  case KCorePlan::kBucketed:
+    return "Bucketed";
   default:
     return "Unknown";
   }
@@ -110,11 +121,44 @@ main(int argc, char** argv) {
   case KCorePlan::kAsynchronous:
     plan = KCorePlan::Asynchronous();
     break;
+  case KCorePlan::kBucketed:
+    plan = KCorePlan::Bucketed();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
   katana::TxnContext txn_ctx;
+  if (coreness) {
+    if (auto r = KCoreDecomposition(
+            pg_projected_view.get(), "node-coreness", &txn_ctx,
+            symmetricGraph);
+        !r) {
+      KATANA_LOG_FATAL("Failed to compute coreness: {}", r.error());
+    }
+
+    auto stats_result = KCoreDecompositionStatistics::Compute(
+        pg_projected_view.get(), "node-coreness");
+    if (!stats_result) {
+      KATANA_LOG_FATAL(
+          "Failed to compute KCore statistics: {}", stats_result.error());
+    }
+    stats_result.value().Print();
+
+    if (output) {
+      auto r =
+          pg_projected_view->GetNodePropertyTyped<uint32_t>("node-coreness");
+      if (!r) {
+        KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+      }
+      auto results = r.value();
+      writeOutput(outputLocation, results->raw_values(), results->length());
+    }
+
+    total_timer.stop();
+    return 0;
+  }
+
   if (auto r = KCore(
           pg_projected_view.get(), kCoreNumber, "node-in-core", &txn_ctx,
           symmetricGraph, plan);
@@ -58,7 +58,10 @@ static cll::opt<KssspPlan::Algorithm> algo(
         clEnumValN(KssspPlan::kDeltaStep, "DeltaStep", "Delta stepping"),
         clEnumValN(
             KssspPlan::kDeltaStepBarrier, "DeltaStepBarrier",
-            "Delta stepping with barrier")),
+            "Delta stepping with barrier"),
+        clEnumValN(
+            KssspPlan::kYen, "Yen",
+            "Yen's loopless paths with parallel spur paths")),
     cll::init(KssspPlan::kDeltaTile));
 
 static cll::opt<KssspPlan::Reachability> reachability(
@@ -84,6 +87,8 @@ AlgorithmName(KssspPlan::Algorithm algorithm) {
     return "DeltaStep";
   case KssspPlan::kDeltaStepBarrier:
     return "DeltaStepBarrier";
+  case KssspPlan::kYen:
+    return "Yen";
   default:
     return "Unknown";
   }
@@ -154,6 +159,9 @@ main(int argc, char** argv) {
   case KssspPlan::kDeltaStepBarrier:
     plan = KssspPlan::DeltaStepBarrier(reachability, stepShift);
     break;
+  case KssspPlan::kYen:
+    plan = KssspPlan::Yen(reachability);
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm selected");
   }
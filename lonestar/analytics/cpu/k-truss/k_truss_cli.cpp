@@ -50,9 +50,18 @@ static cll::opt<KTrussPlan::Algorithm> algo(
             KTrussPlan::kBsp, "Bsp", "Bulk-synchronous parallel (default)"),
         clEnumValN(
             KTrussPlan::kBspCoreThenTruss, "BspCoreThenTruss",
-            "Compute k-1 core and then k-truss")),
+            "Compute k-1 core and then k-truss"),
+        clEnumValN(
+            KTrussPlan::kBucketed, "Bucketed",
+            "Peel edges by support with incremental updates")),
     cll::init(KTrussPlan::kBsp));
 
+static cll::opt<bool> trussness(
+    "trussness",
+    cll::desc("Compute the trussness of every edge instead of the k-truss "
+              "(default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(KTrussPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -62,6 +71,8 @@ AlgorithmName(KTrussPlan::Algorithm algorithm) {
     return "BspJacobi";
   case KTrussPlan::kBspCoreThenTruss:
     return "BspCoreThenTruss";
+  case KTrussPlan::kBucketed:
+    return "Bucketed";
   default:
     return "Unknown";
   }
@@ -113,11 +124,33 @@ main(int argc, char** argv) {
   case KTrussPlan::kBspCoreThenTruss:
     plan = KTrussPlan::BspCoreThenTruss();
     break;
+  case KTrussPlan::kBucketed:
+    plan = KTrussPlan::Bucketed();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
   katana::TxnContext txn_ctx;
+  if (trussness) {
+    if (auto r = KTrussDecomposition(
+            &txn_ctx, pg_projected_view.get(), "edge-trussness");
+        !r) {
+      KATANA_LOG_FATAL("Failed to compute trussness: {}", r.error());
+    }
+
+    auto stats_result = KTrussDecompositionStatistics::Compute(
+        pg_projected_view.get(), "edge-trussness");
+    if (!stats_result) {
+      KATANA_LOG_FATAL(
+          "Failed to compute KTruss statistics: {}", stats_result.error());
+    }
+    stats_result.value().Print();
+
+    total_timer.stop();
+    return 0;
+  }
+
   if (auto r = KTruss(
           &txn_ctx, pg_projected_view.get(), kTrussNumber, "edge-alive", plan);
       !r) {
@@ -79,6 +79,11 @@ static cll::opt<double> randomness(
     cll::desc("Randomness factor for refining clusters in Leiden."),
     cll::init(0.01));
 
+static cll::opt<uint64_t> random_seed(
+    "randomSeed",
+    cll::desc("Seed for the random choices of refining clusters in Leiden."),
+    cll::init(LeidenClusteringPlan::kDefaultRandomSeed));
+
 std::string
 AlgorithmName(LeidenClusteringPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -128,12 +133,12 @@ main(int argc, char** argv) {
   case LeidenClusteringPlan::kDoAll:
     plan = LeidenClusteringPlan::DoAll(
         enable_vf, modularity_threshold_per_round, modularity_threshold_total,
-        max_iterations, min_graph_size, resolution, randomness);
+        max_iterations, min_graph_size, resolution, randomness, random_seed);
     break;
   case LeidenClusteringPlan::kDeterministic:
     plan = LeidenClusteringPlan::Deterministic(
         enable_vf, modularity_threshold_per_round, modularity_threshold_total,
-        max_iterations, min_graph_size, resolution, randomness);
+        max_iterations, min_graph_size, resolution, randomness, random_seed);
     break;
   default:
     KATANA_LOG_FATAL("invalid algorithm");
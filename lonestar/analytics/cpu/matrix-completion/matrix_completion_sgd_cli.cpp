@@ -102,10 +102,22 @@ static cll::opt<bool> useDetInit(
 
 static cll::opt<MatrixCompletionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
-    cll::values(clEnumValN(
-        MatrixCompletionPlan::kSGDByItems, "sgdByItems",
-        "Simple SGD on Items")),
+    cll::values(
+        clEnumValN(
+            MatrixCompletionPlan::kSGDByItems, "sgdByItems",
+            "Simple SGD on Items"),
+        clEnumValN(
+            MatrixCompletionPlan::kSGDBlocked, "sgdBlocked",
+            "SGD on strata of 2D blocks of the rating matrix"),
+        clEnumValN(
+            MatrixCompletionPlan::kALS, "als", "Alternating least squares")),
     cll::init(MatrixCompletionPlan::kSGDByItems));
+
+static cll::opt<uint32_t> numBlocks(
+    "numBlocks",
+    cll::desc("Number of item and of user blocks for sgdBlocked "
+              "(default value 0 for one per thread)"),
+    cll::init(MatrixCompletionPlan::kDefaultNumBlocks));
 /*
  * Commandline options for different learning functions
  */
@@ -120,7 +132,7 @@ static cll::opt<MatrixCompletionPlan::Step> learningRateFunction(
     cll::init(MatrixCompletionPlan::kDefaultLearningRateFunction));
 
 const char* name = "Matrix Completion";
-const char* desc = "Matrix Completion by SGD";
+const char* desc = "Matrix Completion by SGD or ALS";
 const char* url = "matrix_completion";
 
 #define LATENT_VECTOR_SIZE 20
@@ -149,6 +161,17 @@ main(int argc, char** argv) {
         maxUpdates, updatesPerEdge, fixedRounds, useExactError, useDetInit,
         learningRateFunction);
     break;
+  case MatrixCompletionPlan::kSGDBlocked:
+    plan = MatrixCompletionPlan::SGDBlocked(
+        learningRate, decayRate, lambda, tolerance, useSameLatentVector,
+        maxUpdates, updatesPerEdge, fixedRounds, useExactError, useDetInit,
+        learningRateFunction, numBlocks);
+    break;
+  case MatrixCompletionPlan::kALS:
+    plan = MatrixCompletionPlan::ALS(
+        lambda, tolerance, useSameLatentVector, maxUpdates, fixedRounds,
+        useExactError, useDetInit);
+    break;
   default:
     KATANA_LOG_FATAL("invalid algorithm");
   }
@@ -0,0 +1,106 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Minimum Spanning Forest";
+const char* desc = "Computes the minimum spanning forest of a graph";
+const char* url = "minimum_spanning_forest";
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<MinimumSpanningForestPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(
+        clEnumValN(
+            MinimumSpanningForestPlan::kBoruvka, "Boruvka",
+            "Parallel Boruvka with edge contraction (default)"),
+        clEnumValN(
+            MinimumSpanningForestPlan::kFilterKruskal, "FilterKruskal",
+            "Filter-Kruskal with parallel partitioning and sorting")),
+    cll::init(MinimumSpanningForestPlan::kBoruvka));
+
+cll::opt<uint64_t> baseCaseSize(
+    "baseCaseSize",
+    cll::desc("Number of edges FilterKruskal sorts without partitioning "
+              "(default value 65536)"),
+    cll::init(MinimumSpanningForestPlan::kDefaultBaseCaseSize));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_DIE(
+        "minimum spanning forest requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  MinimumSpanningForestPlan plan = MinimumSpanningForestPlan::Boruvka();
+  if (algo == MinimumSpanningForestPlan::kFilterKruskal) {
+    plan = MinimumSpanningForestPlan::FilterKruskal(baseCaseSize);
+  }
+
+  katana::TxnContext txn_ctx;
+  if (auto r = MinimumSpanningForest(
+          pg.get(), edge_property_name, "in_forest", &txn_ctx, plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+
+  auto stats_result = MinimumSpanningForestStatistics::Compute(
+      pg.get(), edge_property_name, "in_forest");
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (MinimumSpanningForestAssertValid(
+            pg.get(), edge_property_name, "in_forest")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetEdgePropertyTyped<uint8_t>("in_forest");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get edge property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(uint64_t(results->length()) == pg->NumEdges());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -45,11 +45,18 @@ static cll::opt<PagerankPlan::Algorithm> algo(
         clEnumValN(
             PagerankPlan::kPullTopological, "PullTopological",
             "PullTopological"),
+        clEnumValN(PagerankPlan::kPullBlocked, "PullBlocked", "PullBlocked"),
         clEnumValN(PagerankPlan::kPullResidual, "PullResidual", "PullResidual"),
         clEnumValN(PagerankPlan::kPushSynchronous, "PushSync", "PushSync"),
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
+static cll::opt<bool> replicateTopology(
+    "replicateTopology",
+    cll::desc("Copy the topology to the memory of every socket "
+              "(PullTopological and PullResidual only)"),
+    cll::init(false));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -77,7 +84,8 @@ main(int argc, char** argv) {
             << pg_projected_view->topology().NumNodes() << " nodes, "
             << pg_projected_view->topology().NumEdges() << " edges\n";
 
-  PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
+  PagerankPlan plan{
+      kCPU, algo, tolerance, maxIterations, kAlpha, replicateTopology};
 
   katana::TxnContext txn_ctx;
   if (auto r = Pagerank(pg_projected_view.get(), "rank", &txn_ctx, plan); !r) {
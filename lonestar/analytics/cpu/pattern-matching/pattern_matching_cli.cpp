@@ -0,0 +1,109 @@
+#include <iostream>
+
+#include <llvm/Support/CommandLine.h>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/Galois.h"
+#include "katana/Timer.h"
+#include "katana/analytics/pattern_matching/pattern_matching.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+const char* name = "Pattern Matching";
+const char* desc =
+    "Counts the subgraphs matching a pattern, or the motifs of a size";
+const char* url = "pattern_matching";
+
+enum PatternKind { kClique, kCycle, kPath, kStar, kMotifs };
+
+namespace cll = llvm::cl;
+cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+cll::opt<PatternKind> patternKind(
+    "pattern", cll::desc("Choose a pattern:"),
+    cll::values(
+        clEnumValN(kClique, "clique", "Clique (default)"),
+        clEnumValN(kCycle, "cycle", "Cycle"), clEnumValN(kPath, "path", "Path"),
+        clEnumValN(kStar, "star", "Star"),
+        clEnumValN(kMotifs, "motifs", "Every connected shape")),
+    cll::init(kClique));
+
+cll::opt<uint32_t> patternSize(
+    "patternSize", cll::desc("Number of nodes of the pattern (default 3)"),
+    cll::init(3));
+
+cll::opt<bool> induced(
+    "induced",
+    cll::desc("Count induced subgraphs only (default value false); motifs "
+              "are always induced"),
+    cll::init(false));
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_DIE(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->NumNodes() << " nodes, " << pg->NumEdges()
+            << " edges\n";
+
+  if (patternKind == kMotifs) {
+    auto motifs = CountMotifs(pg.get(), patternSize);
+    if (!motifs) {
+      KATANA_LOG_FATAL("Failed to run algorithm: {}", motifs.error());
+    }
+    for (const auto& motif : motifs.value()) {
+      std::cout << "Motif with edges";
+      for (const auto& edge : motif.pattern.edges()) {
+        std::cout << " (" << edge.src << ", " << edge.dst << ")";
+      }
+      std::cout << ": " << motif.count << "\n";
+    }
+  } else {
+    Pattern pattern;
+    switch (patternKind) {
+    case kClique:
+      pattern = Pattern::Clique(patternSize, induced);
+      break;
+    case kCycle:
+      pattern = Pattern::Cycle(patternSize, induced);
+      break;
+    case kPath:
+      pattern = Pattern::Path(patternSize, induced);
+      break;
+    case kStar:
+      pattern = Pattern::Star(patternSize, induced);
+      break;
+    default:
+      KATANA_LOG_FATAL("unknown pattern: {}", static_cast<int>(patternKind));
+    }
+
+    auto num_matches = CountPatternMatches(pg.get(), pattern);
+    if (!num_matches) {
+      KATANA_LOG_FATAL("Failed to run algorithm: {}", num_matches.error());
+    }
+    std::cout << "NumMatches: " << num_matches.value() << "\n";
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
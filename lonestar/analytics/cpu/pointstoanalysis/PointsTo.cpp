@@ -17,9 +17,11 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <deque>
 #include <fstream>
 #include <iostream>
+#include <unordered_set>
 
 #include "Lonestar/BoilerPlate.h"
 #include "SparseBitVector.h"
@@ -59,6 +61,14 @@ static cll::opt<bool> useCycleDetection(
               "(default false)"),
     cll::init(false));
 
+static cll::opt<bool> useLazyCycleDetection(
+    "lcd",
+    cll::desc("If set, lazy cycle detection is used in algorithm: a cycle "
+              "search starts from the ends of an edge whose points-to sets "
+              "are equal after propagation (serial only) "
+              "(default false)"),
+    cll::init(false));
+
 static cll::opt<unsigned> THRESHOLD_LS(
     "lsThreshold",
     cll::desc("Determines how many constraints to "
@@ -161,24 +171,29 @@ protected:
     PTABase<IsConcurrent>&
         outerPTA;  // reference to outer PTA instance to get runtime info
 
-    katana::gstl::Vector<unsigned>
-        ancestors;                       // TODO find better representation
-    katana::gstl::Vector<bool> visited;  // TODO use better representation
+    katana::gstl::Vector<unsigned> ancestors;  // current depth first path
+    katana::gstl::Vector<bool> onPath;         // true if node is in ancestors
+    // a node is visited in the current search if its stamp is visitStamp,
+    // so starting a search does not clear anything
+    katana::gstl::Vector<unsigned> visited;
+    unsigned visitStamp = 0;
     katana::gstl::Vector<unsigned> representative;
 
     unsigned NoRepresentative;  // "constant" that represents no representative
 
     /**
      * @returns true of the nodeid is an ancestor node
-     * FIXME find better way to do this instead of linear scan
      */
-    bool isAncestor(unsigned nodeid) {
-      for (unsigned ii : ancestors) {
-        if (ii == nodeid) {
-          return true;
-        }
+    bool isAncestor(unsigned nodeid) { return onPath[nodeid]; }
+
+    /**
+     * Start a new search: forget which nodes have been visited.
+     */
+    void newSearch() {
+      if (++visitStamp == 0) {
+        std::fill(visited.begin(), visited.end(), 0);
+        visitStamp = 1;
       }
-      return false;
     }
 
     /**
@@ -206,14 +221,15 @@ protected:
         return true;
       }
 
-      if (visited[nodeRep]) {
+      if (visited[nodeRep] == visitStamp) {
         return false;
       }
 
-      visited[nodeRep] = true;
+      visited[nodeRep] = visitStamp;
 
       // keep track of the current depth first search path
       ancestors.push_back(nodeRep);
+      onPath[nodeRep] = true;
 
       // don't use an iterator here because outgoing edges might get updated
       // during this loop
@@ -228,6 +244,7 @@ protected:
         }
       }
       ancestors.pop_back();
+      onPath[nodeRep] = false;
 
       return false;
     }
@@ -294,6 +311,7 @@ protected:
      */
     void init() {
       NoRepresentative = outerPTA.numNodes;
+      onPath.resize(outerPTA.numNodes);
       visited.resize(outerPTA.numNodes);
       representative.resize(outerPTA.numNodes);
 
@@ -342,10 +360,7 @@ protected:
         return;
       }
 
-      // TODO this can probably be made more efficient (fill?)
-      for (unsigned ii = 0; ii < outerPTA.numNodes; ++ii) {
-        visited[ii] = false;
-      }
+      newSearch();
 
       unsigned cycleNode = NoRepresentative;  // set to invalid id.
 
@@ -357,11 +372,53 @@ protected:
         }
       }
     }
+
+    /**
+     * Search for cycles reachable from node and collapse them, regardless
+     * of whether online cycle detection is on. Used by lazy cycle detection.
+     *
+     * @param node node to start the search at
+     */
+    void processFrom(unsigned node) {
+      newSearch();
+
+      unsigned cycleNode = NoRepresentative;  // set to invalid id.
+      if (cycleDetect(node, cycleNode)) {
+        cycleCollapse(cycleNode);
+      }
+    }
   };  // end struct OnlineCycleDetection
   ////////////////////////////////////////////////////////////////////////////////
 
   OnlineCycleDetection ocd;  // cycle detector/squasher; only works with serial
 
+  // edges that have already started a lazy cycle search
+  std::unordered_set<uint64_t> lazyCheckedEdges;
+
+  /**
+   * Lazy cycle detection (Hardekopf and Lin, PLDI 2007): nodes in a cycle
+   * end up with the same points-to set, so an edge whose ends have equal,
+   * nonempty sets after propagation is a hint that it is in a cycle. Each
+   * edge is only a hint once.
+   *
+   * @returns true if a cycle search should start at dst
+   */
+  bool isLazyCycleCandidate(unsigned src, unsigned dst) {
+    unsigned srcRepr = ocd.getFinalRepresentative(src);
+    unsigned dstRepr = ocd.getFinalRepresentative(dst);
+
+    if (srcRepr == dstRepr ||
+        pointsToResult[srcRepr].begin() == pointsToResult[srcRepr].end()) {
+      return false;
+    }
+    // after propagation dst has everything src has
+    if (!pointsToResult[dstRepr].isSubsetEq(pointsToResult[srcRepr])) {
+      return false;
+    }
+    return lazyCheckedEdges.insert((uint64_t(srcRepr) << 32) | dstRepr)
+        .second;
+  }
+
   /**
    * Adds edges to the graph based on load/store constraints.
    *
@@ -689,6 +746,7 @@ public:
     processLoadStore<katana::StdForEach>(loadStoreConstraints, updates);
 
     unsigned numUps = 0;
+    std::vector<unsigned> lazyCycleStarts;
 
     // FIFO
     while (!updates.empty()) {
@@ -703,9 +761,19 @@ public:
           updates.push_back(ocd.getFinalRepresentative(*dst));
         }
 
+        if (useLazyCycleDetection && isLazyCycleCandidate(src, *dst)) {
+          lazyCycleStarts.push_back(*dst);
+        }
+
         numUps++;
       }
 
+      // collapsing cycles changes edges, so wait until src's are done
+      for (unsigned start : lazyCycleStarts) {
+        ocd.processFrom(start);
+      }
+      lazyCycleStarts.clear();
+
       if (updates.empty() || numUps >= THRESHOLD_LS) {
         katana::gDebug(
             "No of points-to facts computed = ", countPointsToFacts());
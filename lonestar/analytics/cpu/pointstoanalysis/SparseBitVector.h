@@ -20,6 +20,7 @@
 #ifndef _KATANA_SPARSEBITVECTOR_
 #define _KATANA_SPARSEBITVECTOR_
 
+#include <cstdint>
 #include <utility>
 
 #include <boost/iterator/iterator_facade.hpp>
@@ -29,27 +30,33 @@
 namespace katana {
 
 /**
- * Sparse bit vector using a linked list. Also thread safe; however, only
+ * Sparse bit vector using a sorted linked list of fixed size chunks of
+ * bits. Also thread safe; however, only
  * guarantee is that functions return values based on the state of the
  * vector AT THE TIME THE FUNCTION IS CALLED. (i.e. if concurrent update
  * happens in a function call, the update may or may not be visible).
  */
 template <bool IsConcurrent>
 struct SparseBitVector {
-  using WORD = unsigned int;
+  using WORD = uint64_t;
   static const unsigned wordSize = sizeof(WORD) * 8;
+  static const unsigned wordsPerNode = 4;
+  static const unsigned bitsPerNode = wordSize * wordsPerNode;
 
   //////////////////////////////////////////////////////////////////////////////
 
   /**
-   * Node in sparse bit vector linked list
+   * Node in sparse bit vector linked list. Each node holds a chunk of
+   * wordsPerNode words so that dense regions of a set take few list nodes
+   * and allocations, and whole chunks are merged with a few word-wide
+   * operations the compiler can vectorize.
    */
   struct Node {
     unsigned _base;  // base to multiply by/used to sort linked list
     // If concurrent, then wrap these in a copyable atomic
     using WordType = typename std::conditional<
         IsConcurrent, katana::CopyableAtomic<WORD>, WORD>::type;
-    WordType _bitVector;  // stores set bits for a base
+    WordType _bitVector[wordsPerNode];  // stores set bits for a base
 
     using NodeType = typename std::conditional<
         IsConcurrent, katana::CopyableAtomic<Node*>, Node*>::type;
@@ -62,7 +69,9 @@ struct SparseBitVector {
      */
     Node(unsigned base) {
       _base = base;
-      _bitVector = 0;
+      for (unsigned w = 0; w < wordsPerNode; ++w) {
+        _bitVector[w] = 0;
+      }
       _next = nullptr;
     }
 
@@ -71,20 +80,13 @@ struct SparseBitVector {
      *
      * @param base
      */
-    Node(unsigned base, unsigned offset) {
-      _base = base;
-
+    Node(unsigned base, unsigned offset) : Node(base) {
       // set bit at offset
-      unsigned toStore = 0;
-      toStore |= ((WORD)1 << offset);
-      _bitVector = toStore;
-
-      _next = nullptr;
+      _bitVector[offset / wordSize] = ((WORD)1 << (offset % wordSize));
     }
 
     /**
-     * Thread safe set. Uses compare and swap to atomically update the
-     * bitvector.
+     * Thread safe set. Uses an atomic or to update the word holding the bit.
      *
      * @param offset Offset to set the bit at
      * @returns true if the set bit wasn't set previously
@@ -92,18 +94,13 @@ struct SparseBitVector {
     template <
         bool A = IsConcurrent, typename std::enable_if<A>::type* = nullptr>
     bool set(unsigned offset) {
-      unsigned expected = _bitVector;
-      unsigned newValue = expected | ((WORD)1 << offset);
-      bool changed = (expected != newValue);
-
-      while (changed && !std::atomic_compare_exchange_weak(
-                            &_bitVector, &expected, newValue)) {
-        // if cas fails, then update new value
-        newValue = expected | ((WORD)1 << offset);
-        changed = (expected != newValue);
+      WORD mask = (WORD)1 << (offset % wordSize);
+      WordType& word = _bitVector[offset / wordSize];
+      // avoid taking the cache line exclusive if the bit is already set
+      if (word.load(std::memory_order_relaxed) & mask) {
+        return false;
       }
-
-      return changed;
+      return !(word.fetch_or(mask) & mask);
     }
 
     /**
@@ -116,9 +113,10 @@ struct SparseBitVector {
     template <
         bool A = IsConcurrent, typename std::enable_if<!A>::type* = nullptr>
     bool set(unsigned offset) {
-      WORD beforeBits = _bitVector;
-      _bitVector |= ((WORD)1 << offset);
-      return _bitVector != beforeBits;
+      WORD& word = _bitVector[offset / wordSize];
+      WORD beforeBits = word;
+      word |= ((WORD)1 << (offset % wordSize));
+      return word != beforeBits;
     }
 
     /**
@@ -126,8 +124,8 @@ struct SparseBitVector {
      * @returns true if bit at offset is set, false otherwise
      */
     bool test(unsigned offset) const {
-      WORD mask = (WORD)1 << offset;
-      return ((_bitVector & mask) == mask);
+      WORD mask = (WORD)1 << (offset % wordSize);
+      return ((_bitVector[offset / wordSize] & mask) == mask);
     }
 
     /**
@@ -138,8 +136,12 @@ struct SparseBitVector {
      * word's bits have
      */
     bool isSubsetEq(Node* second) const {
-      WORD current = _bitVector;
-      return (current & (second->_bitVector)) == current;
+      WORD missing = 0;
+      for (unsigned w = 0; w < wordsPerNode; ++w) {
+        WORD current = _bitVector[w];
+        missing |= current & ~WORD(second->_bitVector[w]);
+      }
+      return missing == 0;
     }
 
     /**
@@ -152,15 +154,14 @@ struct SparseBitVector {
         bool A = IsConcurrent, typename std::enable_if<A>::type* = nullptr>
     unsigned unify(Node* second) {
       if (second) {
-        WORD oldVector = _bitVector;
-        WORD newVector = oldVector | (second->_bitVector);
-        bool changed = (oldVector != newVector);
-
-        while (changed && !std::atomic_compare_exchange_weak(
-                              &_bitVector, &oldVector, newVector)) {
-          // if cas fails, update again
-          newVector = oldVector | (second->_bitVector);
-          changed = (oldVector != newVector);
+        bool changed = false;
+        for (unsigned w = 0; w < wordsPerNode; ++w) {
+          WORD other = second->_bitVector[w];
+          // only words that gain bits need an atomic update
+          if ((other & ~_bitVector[w].load(std::memory_order_relaxed)) != 0) {
+            WORD oldBits = _bitVector[w].fetch_or(other);
+            changed |= (other & ~oldBits) != 0;
+          }
         }
 
         return changed;
@@ -180,9 +181,12 @@ struct SparseBitVector {
         bool A = IsConcurrent, typename std::enable_if<!A>::type* = nullptr>
     unsigned unify(Node* second) {
       if (second) {
-        WORD oldBits = _bitVector;
-        _bitVector |= second->_bitVector;
-        return (_bitVector != oldBits);
+        WORD added = 0;
+        for (unsigned w = 0; w < wordsPerNode; ++w) {
+          added |= second->_bitVector[w] & ~_bitVector[w];
+          _bitVector[w] |= second->_bitVector[w];
+        }
+        return added != 0;
       }
 
       return 0;
@@ -195,34 +199,43 @@ struct SparseBitVector {
      */
     Node* clone(katana::FixedSizeAllocator<Node>* nodeAllocator) const {
       Node* newWord = nodeAllocator->allocate(1);
-      nodeAllocator->construct(newWord, 0);
+      nodeAllocator->construct(newWord, _base);
 
-      newWord->_base = _base;
-      newWord->_bitVector = _bitVector;
-      newWord->_next = nullptr;
+      for (unsigned w = 0; w < wordsPerNode; ++w) {
+        newWord->_bitVector[w] = WORD(_bitVector[w]);
+      }
 
       return newWord;
     }
 
     /**
-     * TODO can probably use bit twiddling to get count more efficiently
-     *
      * @returns The number of set bits in this word
      */
     unsigned count() const {
       unsigned numElements = 0;
+      for (unsigned w = 0; w < wordsPerNode; ++w) {
+        numElements += __builtin_popcountll(_bitVector[w]);
+      }
+      return numElements;
+    }
 
-      WORD bitMask = 1;
-      WORD bits = _bitVector;
-
-      for (unsigned ii = 0; ii < wordSize; ++ii) {
-        if (bits & bitMask) {
-          ++numElements;
+    /**
+     * @param offset Offset into bits to start searching at
+     * @returns offset of the first set bit at or after offset, or
+     * bitsPerNode if there is none
+     */
+    unsigned nextSetBit(unsigned offset) const {
+      for (unsigned w = offset / wordSize; w < wordsPerNode; ++w) {
+        WORD bits = _bitVector[w];
+        if (w == offset / wordSize) {
+          // drop the bits before offset
+          bits &= ~WORD(0) << (offset % wordSize);
+        }
+        if (bits) {
+          return w * wordSize + __builtin_ctzll(bits);
         }
-
-        bitMask <<= 1;
       }
-      return numElements;
+      return bitsPerNode;
     }
 
     /**
@@ -235,18 +248,17 @@ struct SparseBitVector {
      */
     template <typename VectorTy>
     unsigned getAllSetBits(VectorTy& setbits) const {
-      // or mask used to mask set bits
-      WORD orMask = 1;
       unsigned numSet = 0;
-      WORD bits = _bitVector;
 
-      for (unsigned curBit = 0; curBit < wordSize; ++curBit) {
-        if (bits & orMask) {
-          setbits.push_back(_base * wordSize + curBit);
+      for (unsigned w = 0; w < wordsPerNode; ++w) {
+        WORD bits = _bitVector[w];
+        while (bits) {
+          unsigned curBit = w * wordSize + __builtin_ctzll(bits);
+          setbits.push_back(_base * bitsPerNode + curBit);
           numSet++;
+          // clear the lowest set bit
+          bits &= bits - 1;
         }
-
-        orMask <<= 1;
       }
 
       return numSet;
@@ -273,25 +285,19 @@ struct SparseBitVector {
         currentBit++;  // current bit doesn't count for checking
       }
 
-      bool found = false;
-      while (!found && currentHead != nullptr) {
-        while (currentBit < wordSize) {
-          if (currentHead->test(currentBit)) {
-            found = true;
-            break;
-          } else {
-            currentBit++;
-          }
+      while (currentHead != nullptr) {
+        if (currentBit < bitsPerNode) {
+          currentBit = currentHead->nextSetBit(currentBit);
         }
-
-        if (!found) {
-          currentHead = (currentHead->_next);
-          currentBit = 0;
+        if (currentBit < bitsPerNode) {
+          break;
         }
+        currentHead = (currentHead->_next);
+        currentBit = 0;
       }
 
       if (currentHead != nullptr) {
-        currentValue = (currentHead->_base * wordSize) + currentBit;
+        currentValue = (currentHead->_base * bitsPerNode) + currentBit;
       } else {
         currentValue = -1;
       }
@@ -848,8 +854,8 @@ private:
    * baseword that corresponds to num
    */
   std::pair<unsigned, unsigned> getOffsets(unsigned num) const {
-    unsigned baseWord = num / wordSize;
-    unsigned offsetIntoWord = num % wordSize;
+    unsigned baseWord = num / bitsPerNode;
+    unsigned offsetIntoWord = num % bitsPerNode;
 
     return std::pair<unsigned, unsigned>(baseWord, offsetIntoWord);
   }
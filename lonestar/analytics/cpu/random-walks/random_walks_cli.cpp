@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <fstream>
 #include <iostream>
 
 #include "Lonestar/BoilerPlate.h"
@@ -69,6 +70,13 @@ static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
 
+static cll::opt<uint64_t> batchSize(
+    "batchSize",
+    cll::desc(
+        "Number of walks generated and written at a time (only for Node2Vec, "
+        "Default: 1000000)"),
+    cll::init(1000000));
+
 std::string
 AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -134,6 +142,40 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
+  if (algo == RandomWalksPlan::kNode2Vec) {
+    // write each batch before generating the next one so that the walks
+    // never have to fit in memory
+    std::ofstream f;
+    if (output) {
+      std::string output_file = outputLocation + "/" + outputFile;
+      katana::gInfo("Writing random walks to a file: ", output_file);
+      f.open(output_file);
+    }
+    auto write_batch =
+        [&](const RandomWalksBatch& batch) -> katana::Result<void> {
+      if (!output) {
+        return katana::ResultSuccess();
+      }
+      for (uint64_t i = 0; i < batch.num_walks; ++i) {
+        if (batch.lengths[i] == 0) {
+          continue;
+        }
+        for (const uint32_t* n = batch.walk_begin(i); n != batch.walk_end(i);
+             ++n) {
+          f << *n << " ";
+        }
+        f << "\n";
+      }
+      return katana::ResultSuccess();
+    };
+    auto stream_result = StreamRandomWalks(
+        pg.get(), batchSize, write_batch, edge_property_name, plan);
+    if (!stream_result) {
+      KATANA_LOG_FATAL("Failed to run RandomWalks: {}", stream_result.error());
+    }
+    return 0;
+  }
+
   auto walks_result = RandomWalks(pg.get(), plan);
   if (!walks_result) {
     KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
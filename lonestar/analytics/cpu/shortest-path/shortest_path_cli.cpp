@@ -0,0 +1,103 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+#include <optional>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/shortest_path/shortest_path.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Shortest Path";
+static const char* desc =
+    "Finds a shortest path between two nodes with bidirectional search, "
+    "optionally guided by landmarks";
+static const char* url = "shortest_path";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<uint32_t> source(
+    "source", cll::desc("Node to start the path at (default value 0)"),
+    cll::init(0));
+
+static cll::opt<uint32_t> target(
+    "target", cll::desc("Node to end the path at (default value 1)"),
+    cll::init(1));
+
+static cll::opt<uint32_t> numLandmarks(
+    "numLandmarks",
+    cll::desc("Number of landmarks, the nodes of highest degree, to guide "
+              "the search with; 0 for none (default value 0)"),
+    cll::init(0));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
+            << pg->topology().NumEdges() << " edges\n";
+
+  std::optional<LandmarkIndex> landmarks;
+  if (numLandmarks > 0) {
+    std::vector<uint32_t> nodes =
+        LandmarkIndex::ChooseByDegree(pg.get(), numLandmarks);
+    std::vector<std::string> property_names;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      property_names.emplace_back("landmark-" + std::to_string(i));
+    }
+    katana::TxnContext txn_ctx;
+    katana::StatTimer index_time("LandmarkIndex");
+    index_time.start();
+    auto index_result = LandmarkIndex::Build(
+        pg.get(), nodes, edge_property_name, property_names, &txn_ctx);
+    index_time.stop();
+    if (!index_result) {
+      KATANA_LOG_FATAL(
+          "Failed to build the landmark index: {}", index_result.error());
+    }
+    landmarks.emplace(std::move(index_result.value()));
+  }
+
+  katana::StatTimer query_time("ShortestPath");
+  query_time.start();
+  auto result = ShortestPath(
+      pg.get(), source, target, edge_property_name,
+      landmarks ? &landmarks.value() : nullptr);
+  query_time.stop();
+  if (!result) {
+    KATANA_LOG_FATAL("Failed to run ShortestPath: {}", result.error());
+  }
+  result.value().Print();
+
+  totalTime.stop();
+
+  return 0;
+}
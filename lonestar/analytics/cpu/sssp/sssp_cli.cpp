@@ -75,6 +75,9 @@ static cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(
             SsspPlan::kDeltaStepFusion, "DeltaStepFusion",
             "Delta stepping with barrier and fused buckets"),
+        clEnumValN(
+            SsspPlan::kDeltaStepAdaptive, "DeltaStepAdaptive",
+            "Delta stepping with fused buckets and adaptive step size"),
         clEnumValN(
             SsspPlan::kSerialDelta, "SerialDelta", "Serial delta stepping"),
         clEnumValN(
@@ -109,6 +112,8 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "DeltaStepBarrier";
   case SsspPlan::kDeltaStepFusion:
     return "DeltaStepFusion";
+  case SsspPlan::kDeltaStepAdaptive:
+    return "DeltaStepAdaptive";
   case SsspPlan::kSerialDeltaTile:
     return "SerialDeltaTile";
   case SsspPlan::kSerialDelta:
@@ -220,6 +225,9 @@ main(int argc, char** argv) {
   case SsspPlan::kDeltaStepFusion:
     plan = SsspPlan::DeltaStepFusion(stepShift);
     break;
+  case SsspPlan::kDeltaStepAdaptive:
+    plan = SsspPlan::DeltaStepAdaptive(stepShift);
+    break;
   case SsspPlan::kSerialDeltaTile:
     plan = SsspPlan::SerialDeltaTile(stepShift);
     break;
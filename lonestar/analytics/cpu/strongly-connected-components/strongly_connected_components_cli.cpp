@@ -0,0 +1,92 @@
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+const char* name = "Strongly Connected Components";
+const char* desc = "Computes the strongly connected components of a graph";
+static const char* url = "strongly_connected_components";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<uint32_t> serialCutoff(
+    "serialCutoff",
+    cll::desc("Number of nodes left at which the coloring rounds stop and "
+              "the rest are found serially (default 100000)"),
+    cll::init(StronglyConnectedComponentsPlan::kDefaultSerialCutoff));
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
+            << pg->topology().NumEdges() << " edges\n";
+
+  std::unique_ptr<katana::PropertyGraph> pg_projected_view =
+      ProjectPropertyGraphForArguments(pg);
+
+  std::cout << "Projected graph has: "
+            << pg_projected_view->topology().NumNodes() << " nodes, "
+            << pg_projected_view->topology().NumEdges() << " edges\n";
+
+  std::cout << "Running Multistep algorithm with serial cutoff "
+            << serialCutoff << "\n";
+  auto plan = StronglyConnectedComponentsPlan::Multistep(serialCutoff);
+
+  katana::TxnContext txn_ctx;
+  if (auto r = StronglyConnectedComponents(
+          pg_projected_view.get(), "component", &txn_ctx, plan);
+      !r) {
+    KATANA_LOG_FATAL(
+        "Failed to run StronglyConnectedComponents: {}", r.error());
+  }
+
+  auto stats_result = StronglyConnectedComponentsStatistics::Compute(
+      pg_projected_view.get(), "component");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute StronglyConnectedComponents statistics: {}",
+        stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (StronglyConnectedComponentsAssertValid(
+            pg_projected_view.get(), "component")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg_projected_view->GetNodePropertyTyped<uint64_t>("component");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) ==
+        pg_projected_view->topology().NumNodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
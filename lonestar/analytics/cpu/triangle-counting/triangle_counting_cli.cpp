@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <cmath>
 #include <iostream>
 
 #include "Lonestar/BoilerPlate.h"
@@ -40,7 +41,10 @@ static cll::opt<TriangleCountPlan::Algorithm> algo(
             TriangleCountPlan::kEdgeIteration, "edgeiterator", "Edge Iterator"),
         clEnumValN(
             TriangleCountPlan::kOrderedCount, "orderedCount",
-            "Ordered Simple Count (default)")),
+            "Ordered Simple Count (default)"),
+        clEnumValN(
+            TriangleCountPlan::kEdgeSampling, "edgeSampling",
+            "Estimate from a sample of the edges")),
     cll::init(TriangleCountPlan::kOrderedCount));
 
 static cll::opt<bool> relabel(
@@ -48,6 +52,27 @@ static cll::opt<bool> relabel(
     cll::desc("Relabel nodes of the graph (default value of false => "
               "choose automatically)"),
     cll::init(false));
+
+static cll::opt<size_t> hubBitmapBudgetMB(
+    "hubBitmapBudgetMB",
+    cll::desc("Memory in MB for neighbor bitmaps of high-degree nodes "
+              "(default value of 0 => no bitmaps)"),
+    cll::init(0));
+
+static cll::opt<bool> replicateTopology(
+    "replicateTopology",
+    cll::desc("Copy the topology to the memory of every socket"),
+    cll::init(false));
+
+static cll::opt<double> sampleRate(
+    "sampleRate",
+    cll::desc("Fraction of the edges to sample with edgeSampling"),
+    cll::init(TriangleCountPlan::kDefaultSampleRate));
+
+static cll::opt<uint32_t> seed(
+    "seed", cll::desc("Seed of the edge sample"),
+    cll::init(TriangleCountPlan::kDefaultSeed));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -81,32 +106,50 @@ main(int argc, char** argv) {
 
   TriangleCountPlan::Relabeling relabeling_flag =
       relabel ? TriangleCountPlan::kRelabel : TriangleCountPlan::kAutoRelabel;
+  size_t hub_bitmap_budget = hubBitmapBudgetMB * 1024 * 1024;
 
   switch (algo) {
   case TriangleCountPlan::kNodeIteration:
-    plan = TriangleCountPlan::NodeIteration(relabeling_flag);
+    plan = TriangleCountPlan::NodeIteration(
+        TriangleCountPlan::kDefaultEdgeSorted, relabeling_flag,
+        hub_bitmap_budget, replicateTopology);
     break;
 
   case TriangleCountPlan::kEdgeIteration:
-    plan = TriangleCountPlan::EdgeIteration(relabeling_flag);
+    plan = TriangleCountPlan::EdgeIteration(
+        TriangleCountPlan::kDefaultEdgeSorted, relabeling_flag,
+        hub_bitmap_budget, replicateTopology);
     break;
 
   case TriangleCountPlan::kOrderedCount:
-    plan = TriangleCountPlan::OrderedCount(relabeling_flag);
+    plan = TriangleCountPlan::OrderedCount(
+        TriangleCountPlan::kDefaultEdgeSorted, relabeling_flag,
+        hub_bitmap_budget, replicateTopology);
+    break;
+
+  case TriangleCountPlan::kEdgeSampling:
+    plan = TriangleCountPlan::EdgeSampling(
+        sampleRate, seed, TriangleCountPlan::kDefaultEdgeSorted,
+        relabeling_flag, hub_bitmap_budget, replicateTopology);
     break;
 
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
 
-  auto num_triangles_result = TriangleCount(pg_projected_view.get(), plan);
+  auto num_triangles_result =
+      EstimateTriangleCount(pg_projected_view.get(), plan);
   if (!num_triangles_result) {
     KATANA_LOG_FATAL(
         "failed to run algorithm: {}", num_triangles_result.error());
   }
   auto num_triangles = num_triangles_result.value();
 
-  std::cout << "NumTriangles: " << num_triangles << "\n";
+  std::cout << "NumTriangles: " << std::llround(num_triangles.value) << "\n";
+  if (num_triangles.std_error > 0) {
+    std::cout << "NumTriangles95%Interval: [" << num_triangles.Lower() << ", "
+              << num_triangles.Upper() << "]\n";
+  }
 
   totalTime.stop();
 
@@ -1,79 +1,116 @@
-from collections import OrderedDict
-
 import metagraph as mg
 import networkx as nx
 import numpy as np
 import pyarrow
 from metagraph import translator
 from metagraph.plugins.networkx.types import NetworkXGraph
+from metagraph.plugins.scipy.types import ScipyGraph
 from scipy.sparse import csr_matrix
 
 from katana.local.import_data import from_csr
 
 from .types import KatanaGraph
 
+# The edge property that holds the weights of translated graphs
+TRANSLATED_WEIGHT = "value_from_translator"
 
-@translator
-def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
-    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
-    is_weighted = aprops["edge_type"] == "map"
-    # get the edge list directly from the NetworkX Graph
-    elist_raw = list(x.value.edges(data=True))
-    # sort the eddge list and node list
-    if aprops["is_directed"]:
-        elist = sorted(elist_raw, key=lambda each: (each[0], each[1]))
-    else:
-        inv_elist = [(each[1], each[0], each[2]) for each in elist_raw]
-        elist = sorted(elist_raw + inv_elist, key=lambda each: (each[0], each[1]))
-    nlist = sorted(list(x.value.nodes(data=True)), key=lambda each: each[0])
-    # build the CSR format from the edge list (weight, (src, dst))
-    row = np.array([each_edge[0] for each_edge in elist])
-    col = np.array([each_edge[1] for each_edge in elist])
-    data = np.array([each_edge[2]["weight"] for each_edge in elist])
-    csr = csr_matrix((data, (row, col)), shape=(len(nlist), len(nlist)))
-    # call the katana api to build a Graph (unweighted) from the CSR format
-    # noting that the first 0 in csr.indptr is excluded
-    pg = from_csr(csr.indptr[1:], csr.indices)
-    # add the edge weight as a new property
-    t = pyarrow.table(dict(value_from_translator=data))
-    pg.add_edge_property(t)
-    # use the metagraph's Graph warpper to wrap the katana.local.Graph
+
+def _as_uint(array, dtype):
+    """
+    Return the non-negative integer array as dtype, without copying it if it only needs a new view, e.g., from the
+    int32 indices of scipy to the uint32 destinations of katana.
+    """
+    if array.dtype.itemsize == np.dtype(dtype).itemsize and array.dtype.kind in "iu" and array.flags.c_contiguous:
+        return array.view(dtype)
+    return array.astype(dtype)
+
+
+def _column_to_numpy(column):
+    """
+    Return the property column as a numpy array, without copying it if it is a single chunk of fixed width values
+    without nulls.
+    """
+    if column.num_chunks == 1:
+        return column.chunk(0).to_numpy(zero_copy_only=False)
+    return column.to_numpy()
+
+
+def _csr_to_katanagraph(matrix: csr_matrix, is_weighted: bool, is_directed: bool) -> KatanaGraph:
+    # katana stores the end of the edges of each node, i.e., indptr without the leading 0. The graph may share the
+    # destinations and weights with matrix instead of copying them, so matrix must not be changed afterwards.
+    pg = from_csr(_as_uint(matrix.indptr[1:], np.uint64), _as_uint(matrix.indices, np.uint32))
+    # pyarrow wraps the weights without copying them
+    pg.add_edge_property(pyarrow.table({TRANSLATED_WEIGHT: matrix.data}))
     return KatanaGraph(
         pg_graph=pg,
         is_weighted=is_weighted,
-        edge_weight_prop_name="value_from_translator",
-        is_directed=aprops["is_directed"],
+        edge_weight_prop_name=TRANSLATED_WEIGHT,
+        is_directed=is_directed,
         node_weight_index=0,
     )
 
 
+def _katanagraph_to_csr(x: KatanaGraph) -> csr_matrix:
+    pg = x.value
+    num_nodes = pg.num_nodes()
+    # adj_indices and edge_dests are views of the topology, so the only copies are of indptr, which needs a leading
+    # 0, and the conversion of the destinations to the signed index type of scipy
+    indptr = np.empty(num_nodes + 1, dtype=np.int64)
+    indptr[0] = 0
+    indptr[1:] = pg.adj_indices()
+    indices = pg.edge_dests()
+    if x.is_weighted:
+        data = _column_to_numpy(pg.get_edge_property(x.edge_weight_prop_name))
+    else:
+        data = np.ones(pg.num_edges(), dtype=bool)
+    return csr_matrix((data, indices, indptr), shape=(num_nodes, num_nodes), copy=False)
+
+
+@translator
+def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
+    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
+    is_weighted = aprops["edge_type"] == "map"
+    # an undirected graph becomes a symmetric matrix, i.e., a directed graph with both directions of every edge
+    matrix = nx.to_scipy_sparse_matrix(x.value, nodelist=sorted(x.value.nodes()), weight="weight", format="csr")
+    matrix.sort_indices()
+    return _csr_to_katanagraph(matrix, is_weighted, aprops["is_directed"])
+
+
 @translator
 def katanagraph_to_networkx(x: KatanaGraph, **props) -> NetworkXGraph:
     pg = x.value
-    dest_list = [dest for src in pg.nodes() for dest in [pg.get_edge_dst(e) for e in pg.out_edge_ids(src)]]
-    for src in pg.nodes():
-        if len(pg.out_edge_ids(src)) == 0:
-            if src not in dest_list:
-                raise ValueError("NetworkX does not support graph with isolated nodes")
-    edge_dict_count = {
-        (src, dest): 0 for src in pg.nodes() for dest in [pg.get_edge_dst(e) for e in pg.out_edge_ids(src)]
-    }
-    for src in pg.nodes():
-        for dest in [pg.get_edge_dst(e) for e in pg.out_edge_ids(src)]:
-            edge_dict_count[(src, dest)] += 1
-            if edge_dict_count[(src, dest)] > 1:
-                raise ValueError("NetworkX does not support graph with duplicated edges")
-    elist = []
-    edge_weights = pg.get_edge_property(x.edge_weight_prop_name).to_pandas()
-    if isinstance(edge_weights[0], np.int64):
-        elist = [(nid, pg.get_edge_dst(j), int(edge_weights[j])) for nid in pg.nodes() for j in pg.out_edge_ids(nid)]
-    elif isinstance(edge_weights[0], pyarrow.lib.Int64Scalar):
-        elist = [(nid, pg.get_edge_dst(j), edge_weights[j].as_py()) for nid in pg.nodes() for j in pg.out_edge_ids(nid)]
-        # TODO(pengfei): add more type conversion support: like np.float64 -> float??
-    elist = list(OrderedDict.fromkeys(elist))
+    num_nodes = pg.num_nodes()
+    dests = pg.edge_dests().astype(np.int64)
+    degrees = np.diff(pg.adj_indices().astype(np.int64), prepend=0)
+    sources = np.repeat(np.arange(num_nodes, dtype=np.int64), degrees)
+    has_edges = np.zeros(num_nodes, dtype=bool)
+    has_edges[sources] = True
+    has_edges[dests] = True
+    if not has_edges.all():
+        raise ValueError("NetworkX does not support graph with isolated nodes")
+    pairs = sources * num_nodes + dests
+    if len(np.unique(pairs)) != len(pairs):
+        raise ValueError("NetworkX does not support graph with duplicated edges")
+    weights = _column_to_numpy(pg.get_edge_property(x.edge_weight_prop_name))
     if x.is_directed:
         graph = nx.DiGraph()
     else:
         graph = nx.Graph()
-    graph.add_weighted_edges_from(elist)
+    graph.add_weighted_edges_from(zip(sources.tolist(), dests.tolist(), weights.tolist()))
     return mg.wrappers.Graph.NetworkXGraph(graph)
+
+
+@translator
+def scipy_to_katanagraph(x: ScipyGraph, **props) -> KatanaGraph:
+    aprops = ScipyGraph.Type.compute_abstract_properties(x, {"edge_type", "is_directed"})
+    num_nodes = x.value.shape[0]
+    if x.node_list is not None and not np.array_equal(x.node_list, np.arange(num_nodes)):
+        raise ValueError("Katana Graph nodes must be 0, 1, 2, ... in order")
+    matrix = x.value.tocsr()
+    return _csr_to_katanagraph(matrix, aprops["edge_type"] == "map", aprops["is_directed"])
+
+
+@translator
+def katanagraph_to_scipy(x: KatanaGraph, **props) -> ScipyGraph:
+    # scipy would otherwise find out whether the graph is directed by comparing the matrix to its transpose
+    return ScipyGraph(_katanagraph_to_csr(x), aprops={"is_directed": x.is_directed})
@@ -85,3 +85,26 @@ def test_compare_edge_count(nx_from_kg_di_8_12, katanagraph_cleaned_8_12_di):
                 edge_dict_count[(src, dest)] += 1
     assert sum([edge_dict_count[i] for i in edge_dict_count]) == katanagraph_cleaned_8_12_di.value.num_edges()
     assert len(list(nx_from_kg_di_8_12.value.edges(data=True))) == katanagraph_cleaned_8_12_di.value.num_edges()
+
+
+def test_scipy_from_kg(katanagraph_cleaned_8_12_di):
+    pg = katanagraph_cleaned_8_12_di.value
+    scipy_graph = mg.translate(katanagraph_cleaned_8_12_di, mg.wrappers.Graph.ScipyGraph)
+    matrix = scipy_graph.value
+    assert matrix.shape == (8, 8)
+    assert matrix.nnz == pg.num_edges()
+    assert matrix.indptr[1:].tolist() == pg.adj_indices().tolist()
+    assert matrix.indices.tolist() == pg.edge_dests().tolist()
+    assert matrix.data.tolist() == [v.as_py() for v in pg.get_edge_property("value")]
+
+
+def test_kg_from_scipy_round_trip(katanagraph_cleaned_8_12_di):
+    scipy_graph = mg.translate(katanagraph_cleaned_8_12_di, mg.wrappers.Graph.ScipyGraph)
+    kg = mg.translate(scipy_graph, mg.wrappers.Graph.KatanaGraph)
+    pg = katanagraph_cleaned_8_12_di.value
+    assert kg.value.num_nodes() == pg.num_nodes()
+    assert kg.value.adj_indices().tolist() == pg.adj_indices().tolist()
+    assert kg.value.edge_dests().tolist() == pg.edge_dests().tolist()
+    assert [v.as_py() for v in kg.value.get_edge_property("value_from_translator")] == [
+        v.as_py() for v in pg.get_edge_property("value")
+    ]
@@ -17,11 +17,15 @@ from katana.local_native import (
     EntityType,
     EntityTypeManager,
     Graph,
+    NeighborSample,
+    NeighborSampler,
     ReduceAnd,
+    ReduceHistogram,
     ReduceMax,
     ReduceMin,
     ReduceOr,
     ReduceSum,
+    ReduceTopK,
     TxnContext,
 )
 from katana.native_interfacing.numpy_atomic import atomic_add, atomic_max, atomic_min, atomic_sub
@@ -34,6 +38,8 @@ __all__ = [
     "ReduceOr",
     "ReduceMax",
     "ReduceMin",
+    "ReduceHistogram",
+    "ReduceTopK",
     "InsertBag",
     "NUMAArray",
     "Graph",
@@ -50,6 +56,8 @@ __all__ = [
     "AtomicEntityType",
     "EntityTypeManager",
     "EntityTypeArray",
+    "NeighborSample",
+    "NeighborSampler",
 ]
 
 Graph.out_edges = graph_adds.out_edges
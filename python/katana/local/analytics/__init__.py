@@ -25,14 +25,24 @@ Algorithms
 
 .. automodule:: katana.local.analytics._bfs
 
+.. automodule:: katana.local.analytics._bipartite_matching
+
 .. automodule:: katana.local.analytics._cdlp
 
 .. automodule:: katana.local.analytics._connected_components
 
+.. automodule:: katana.local.analytics._graph_coloring
+
+.. automodule:: katana.local.analytics._graph_partition
+
 .. automodule:: katana.local.analytics._independent_set
 
 .. automodule:: katana.local.analytics._louvain_clustering
 
+.. automodule:: katana.local.analytics._max_flow
+
+.. automodule:: katana.local.analytics._minimum_spanning_forest
+
 .. automodule:: katana.local.analytics._local_clustering_coefficient
 
 .. automodule:: katana.local.analytics._subgraph_extraction
@@ -49,6 +59,8 @@ Algorithms
 
 .. automodule:: katana.local.analytics._sssp
 
+.. automodule:: katana.local.analytics._strongly_connected_components
+
 .. automodule:: katana.local.analytics._triangle_count
 
 .. automodule:: katana.local.analytics._wrappers
@@ -62,20 +74,46 @@ from katana.local.analytics._betweenness_centrality import (
     betweenness_centrality,
 )
 from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid
+from katana.local.analytics._bipartite_matching import (
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
+)
 from katana.local.analytics._cdlp import CdlpPlan, CdlpStatistics, cdlp
 from katana.local.analytics._connected_components import (
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
+    connected_component_sizes,
     connected_components,
     connected_components_assert_valid,
 )
+from katana.local.analytics._graph_coloring import (
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    graph_coloring,
+    graph_coloring_assert_valid,
+)
+from katana.local.analytics._graph_partition import (
+    GraphPartitionPlan,
+    GraphPartitionStatistics,
+    graph_partition,
+    graph_partition_assert_valid,
+)
 from katana.local.analytics._independent_set import (
     IndependentSetPlan,
     IndependentSetStatistics,
     independent_set,
     independent_set_assert_valid,
 )
-from katana.local.analytics._jaccard import JaccardPlan, JaccardStatistics, jaccard, jaccard_assert_valid
+from katana.local.analytics._jaccard import (
+    JaccardPlan,
+    JaccardStatistics,
+    JaccardTopKPlan,
+    jaccard,
+    jaccard_assert_valid,
+    jaccard_top_k,
+)
 from katana.local.analytics._k_core import KCorePlan, KCoreStatistics, k_core, k_core_assert_valid
 from katana.local.analytics._k_truss import KTrussPlan, KTrussStatistics, k_truss, k_truss_assert_valid
 from katana.local.analytics._ksssp import KssspPlan, ksssp
@@ -95,9 +133,26 @@ from katana.local.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
+from katana.local.analytics._max_flow import MaxFlowPlan, MaxFlowStatistics, max_flow, max_flow_assert_valid
+from katana.local.analytics._minimum_spanning_forest import (
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+)
 from katana.local.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
 from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
-from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
+from katana.local.analytics._strongly_connected_components import (
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
+)
+from katana.local.analytics._subgraph_extraction import (
+    SubGraphExtractionPlan,
+    subgraph_extraction,
+    subgraph_extraction_by_type,
+)
 from katana.local.analytics._triangle_count import TriangleCountPlan, triangle_count
 from katana.local.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
 from katana.local.analytics.plan import Architecture, Plan, Statistics
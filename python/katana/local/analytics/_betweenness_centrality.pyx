@@ -39,6 +39,7 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kAsynchronous "katana::analytics::BetweennessCentralityPlan::kAsynchronous"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
 
@@ -49,6 +50,8 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Asynchronous()
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
@@ -87,6 +90,7 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Asynchronous = _BetweennessCentralityPlan.Algorithm.kAsynchronous
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -127,6 +131,13 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def asynchronous():
+        """
+        Process one source at a time without a barrier per level, which suits high-diameter graphs.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Asynchronous())
+
 
 def betweenness_centrality(pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan(),
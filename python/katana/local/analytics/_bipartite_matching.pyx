@@ -0,0 +1,224 @@
+"""
+Bipartite Matching
+------------------
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingPlan
+
+
+.. autoclass:: katana.local.analytics._bipartite_matching._BipartiteMatchingPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.bipartite_matching
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingStatistics
+
+
+.. autofunction:: katana.local.analytics.bipartite_matching_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/bipartite_matching/bipartite_matching.h" namespace "katana::analytics" nogil:
+    cppclass _BipartiteMatchingPlan "katana::analytics::BipartiteMatchingPlan" (_Plan):
+        enum Algorithm:
+            kPothenFan "katana::analytics::BipartiteMatchingPlan::kPothenFan"
+            kPushRelabel "katana::analytics::BipartiteMatchingPlan::kPushRelabel"
+
+        _BipartiteMatchingPlan.Algorithm algorithm() const
+
+        BipartiteMatchingPlan()
+
+        @staticmethod
+        _BipartiteMatchingPlan PothenFan()
+
+        @staticmethod
+        _BipartiteMatchingPlan PushRelabel()
+
+    Result[void] BipartiteMatching(_PropertyGraph* pg, string left_node_type, string right_node_type, string output_property_name, CTxnContext* txn_ctx, _BipartiteMatchingPlan plan)
+
+    Result[void] BipartiteMatchingAssertValid(_PropertyGraph* pg, string left_node_type, string right_node_type, string output_property_name)
+
+    cppclass _BipartiteMatchingStatistics "katana::analytics::BipartiteMatchingStatistics":
+        uint64_t num_left_nodes
+        uint64_t num_right_nodes
+        uint64_t num_matched
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_BipartiteMatchingStatistics] Compute(_PropertyGraph* pg, string left_node_type, string right_node_type, string output_property_name)
+
+
+class _BipartiteMatchingPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.BipartiteMatchingPlan` constructors for algorithm documentation.
+    """
+    PothenFan = _BipartiteMatchingPlan.Algorithm.kPothenFan
+    PushRelabel = _BipartiteMatchingPlan.Algorithm.kPushRelabel
+
+
+cdef class BipartiteMatchingPlan(Plan):
+    """
+    A computational :ref:`Plan` for Bipartite Matching.
+
+    Static methods construct BipartiteMatchingPlans.
+    """
+    cdef:
+        _BipartiteMatchingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _BipartiteMatchingPlanAlgorithm
+
+    @staticmethod
+    cdef BipartiteMatchingPlan make(_BipartiteMatchingPlan u):
+        f = <BipartiteMatchingPlan>BipartiteMatchingPlan.__new__(BipartiteMatchingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _BipartiteMatchingPlanAlgorithm:
+        return _BipartiteMatchingPlanAlgorithm(self.underlying_.algorithm())
+
+    @staticmethod
+    def pothen_fan():
+        """
+        Parallel Pothen-Fan with lookahead. Each phase searches depth first for disjoint augmenting paths from all
+        unmatched left nodes in parallel, alternating the direction in which adjacency lists are scanned.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PothenFan())
+
+    @staticmethod
+    def push_relabel():
+        """
+        Parallel push-relabel. Every unmatched left node matches itself to its right neighbor with the smallest label,
+        unmatching that neighbor's previous mate. Labels are recomputed by a breadth-first search now and then.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PushRelabel())
+
+
+def bipartite_matching(pg, str left_node_type, str right_node_type, str output_property_name,
+                       BipartiteMatchingPlan plan = BipartiteMatchingPlan(), *, txn_ctx = None):
+    """
+    Compute a maximum cardinality matching of the bipartite graph between the nodes of type left_node_type and the
+    nodes of type right_node_type. Edges in either direction between a left and a right node are candidates; all
+    other edges are ignored. No node may have both types. The property named output_property_name is created by this
+    function and may not exist before the call. The created property has type uint8_t and is 1 on exactly one edge
+    between the nodes of each matched pair.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type left_node_type: str
+    :param left_node_type: The node type of the left side.
+    :type right_node_type: str
+    :param right_node_type: The node type of the right side.
+    :type output_property_name: str
+    :param output_property_name: The output edge property. This property must not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The tranaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("ldbc_003"))
+        from katana.analytics import bipartite_matching, BipartiteMatchingStatistics
+        bipartite_matching(graph, "Forum", "Person", "output")
+        stats = BipartiteMatchingStatistics(graph, "Forum", "Person", "output")
+        print(stats)
+
+    """
+    left_node_type_bytes = bytes(left_node_type, "utf-8")
+    left_node_type_cstr = <string>left_node_type_bytes
+    right_node_type_bytes = bytes(right_node_type, "utf-8")
+    right_node_type_cstr = <string>right_node_type_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(BipartiteMatching(underlying_property_graph(pg), left_node_type_cstr, right_node_type_cstr, output_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
+
+
+def bipartite_matching_assert_valid(pg, str left_node_type, str right_node_type, str output_property_name):
+    """
+    Raise an exception if the edges marked in `pg` are not a maximum matching.
+
+    :raises: AssertionError
+    """
+    left_node_type_bytes = bytes(left_node_type, "utf-8")
+    left_node_type_cstr = <string>left_node_type_bytes
+    right_node_type_bytes = bytes(right_node_type, "utf-8")
+    right_node_type_cstr = <string>right_node_type_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_assert(BipartiteMatchingAssertValid(underlying_property_graph(pg), left_node_type_cstr, right_node_type_cstr, output_property_name_cstr))
+
+
+cdef _BipartiteMatchingStatistics handle_result_BipartiteMatchingStatistics(Result[_BipartiteMatchingStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class BipartiteMatchingStatistics:
+    """
+    Compute the :ref:`statistics` of a Bipartite Matching.
+    """
+    cdef _BipartiteMatchingStatistics underlying
+
+    def __init__(self, pg, str left_node_type, str right_node_type, str output_property_name):
+        left_node_type_bytes = bytes(left_node_type, "utf-8")
+        left_node_type_cstr = <string> left_node_type_bytes
+        right_node_type_bytes = bytes(right_node_type, "utf-8")
+        right_node_type_cstr = <string> right_node_type_bytes
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_BipartiteMatchingStatistics(_BipartiteMatchingStatistics.Compute(
+                underlying_property_graph(pg), left_node_type_cstr, right_node_type_cstr, output_property_name_cstr))
+
+    @property
+    def num_left_nodes(self) -> int:
+        """
+        The number of left nodes.
+        """
+        return self.underlying.num_left_nodes
+
+    @property
+    def num_right_nodes(self) -> int:
+        """
+        The number of right nodes.
+        """
+        return self.underlying.num_right_nodes
+
+    @property
+    def num_matched(self) -> int:
+        """
+        The number of matched pairs.
+        """
+        return self.underlying.num_matched
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -16,13 +16,17 @@ Connected Components
 
 .. autofunction:: katana.local.analytics.connected_components
 
+.. autofunction:: katana.local.analytics.connected_component_sizes
+
 .. autoclass:: katana.local.analytics.ConnectedComponentsStatistics
 
 """
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp cimport bool
+from libcpp.memory cimport shared_ptr
 from libcpp.string cimport string
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
 
 from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -98,6 +102,8 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
 
     Result[void] ConnectedComponentsAssertValid(_PropertyGraph*pg, string output_property_name)
 
+    Result[shared_ptr[CTable]] ConnectedComponentSizes(_PropertyGraph*pg, string property_name)
+
     cppclass _ConnectedComponentsStatistics "katana::analytics::ConnectedComponentsStatistics":
         uint64_t total_components
         uint64_t total_non_trivial_components
@@ -295,6 +301,29 @@ def connected_components_assert_valid(pg, str output_property_name):
     with nogil:
         handle_result_assert(ConnectedComponentsAssertValid(underlying_property_graph(pg), output_property_name_str))
 
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+def connected_component_sizes(pg, str property_name):
+    """
+    Count the nodes of each component found by :py:func:`connected_components`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph that was analyzed.
+    :type property_name: str
+    :param property_name: The property the component ids were written into.
+    :return: A ``pyarrow.Table`` of a ``component`` and a ``size`` column, with one row per component in the order of
+        the ids.
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    cdef shared_ptr[CTable] table
+    with nogil:
+        table = handle_result_table(ConnectedComponentSizes(underlying_property_graph(pg), property_name_str))
+    return pyarrow_wrap_table(table)
+
 cdef _ConnectedComponentsStatistics handle_result_ConnectedComponentsStatistics(
         Result[_ConnectedComponentsStatistics] res) nogil except *:
     if not res.has_value():
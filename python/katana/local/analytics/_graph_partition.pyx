@@ -0,0 +1,232 @@
+"""
+Graph Partition
+---------------
+
+.. autoclass:: katana.local.analytics.GraphPartitionPlan
+
+
+.. autoclass:: katana.local.analytics._graph_partition._GraphPartitionPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.graph_partition
+
+.. autoclass:: katana.local.analytics.GraphPartitionStatistics
+
+
+.. autofunction:: katana.local.analytics.graph_partition_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/graph_partition/graph_partition.h" namespace "katana::analytics" nogil:
+    cppclass _GraphPartitionPlan "katana::analytics::GraphPartitionPlan" (_Plan):
+        enum Algorithm:
+            kMultilevel "katana::analytics::GraphPartitionPlan::kMultilevel"
+
+        _GraphPartitionPlan.Algorithm algorithm() const
+        double imbalance() const
+        uint32_t coarsen_to_per_partition() const
+        uint32_t max_refinement_iterations() const
+
+        GraphPartitionPlan()
+
+        @staticmethod
+        _GraphPartitionPlan Multilevel(double imbalance, uint32_t coarsen_to_per_partition, uint32_t max_refinement_iterations)
+
+    double kDefaultImbalance "katana::analytics::GraphPartitionPlan::kDefaultImbalance"
+    uint32_t kDefaultCoarsenToPerPartition "katana::analytics::GraphPartitionPlan::kDefaultCoarsenToPerPartition"
+    uint32_t kDefaultMaxRefinementIterations "katana::analytics::GraphPartitionPlan::kDefaultMaxRefinementIterations"
+
+    Result[void] GraphPartition(_PropertyGraph* pg, uint32_t num_partitions, string output_property_name, CTxnContext* txn_ctx, _GraphPartitionPlan plan)
+
+    Result[void] GraphPartitionAssertValid(_PropertyGraph* pg, uint32_t num_partitions, string output_property_name)
+
+    cppclass _GraphPartitionStatistics "katana::analytics::GraphPartitionStatistics":
+        uint32_t num_partitions
+        uint64_t edge_cut
+        uint64_t largest_partition_size
+        uint64_t smallest_partition_size
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_GraphPartitionStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _GraphPartitionPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.GraphPartitionPlan` constructors for algorithm documentation.
+    """
+    Multilevel = _GraphPartitionPlan.Algorithm.kMultilevel
+
+
+cdef class GraphPartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for Graph Partition.
+
+    Static methods construct GraphPartitionPlans.
+    """
+    cdef:
+        _GraphPartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _GraphPartitionPlanAlgorithm
+
+    @staticmethod
+    cdef GraphPartitionPlan make(_GraphPartitionPlan u):
+        f = <GraphPartitionPlan>GraphPartitionPlan.__new__(GraphPartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _GraphPartitionPlanAlgorithm:
+        return _GraphPartitionPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def imbalance(self) -> float:
+        return self.underlying_.imbalance()
+
+    @property
+    def coarsen_to_per_partition(self) -> int:
+        return self.underlying_.coarsen_to_per_partition()
+
+    @property
+    def max_refinement_iterations(self) -> int:
+        return self.underlying_.max_refinement_iterations()
+
+    @staticmethod
+    def multilevel(
+        double imbalance = kDefaultImbalance,
+        uint32_t coarsen_to_per_partition = kDefaultCoarsenToPerPartition,
+        uint32_t max_refinement_iterations = kDefaultMaxRefinementIterations,
+    ):
+        """
+        Multilevel k-way partitioning in the style of METIS: coarsen the graph by heavy-edge matching, partition the
+        coarsest graph by greedy graph growing and refine the partition at each level on the way back.
+
+        :param imbalance: How much heavier than the average a partition may be, e.g., 0.05 for 105%.
+        :param coarsen_to_per_partition: Coarsening stops at this many nodes per partition.
+        :param max_refinement_iterations: The most refinement passes to run at each level.
+        """
+        return GraphPartitionPlan.make(
+            _GraphPartitionPlan.Multilevel(imbalance, coarsen_to_per_partition, max_refinement_iterations)
+        )
+
+
+def graph_partition(pg, uint32_t num_partitions, str output_property_name,
+             GraphPartitionPlan plan = GraphPartitionPlan(), *, txn_ctx = None):
+    """
+    Partition the nodes of the graph into num_partitions parts of about the same number of nodes with few edges
+    between parts. The graph must be symmetric. Self loops are ignored. The property named output_property_name is
+    created by this function and may not exist before the call. The created property has type uint32_t.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type num_partitions: int
+    :param num_partitions: The number of partitions to make.
+    :type output_property_name: str
+    :param output_property_name: The output property to write partition ids into. This property must not already exist.
+    :type plan: GraphPartitionPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The tranaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+        from katana.analytics import graph_partition, GraphPartitionStatistics
+        graph_partition(graph, 4, "output")
+        stats = GraphPartitionStatistics(graph, "output")
+        print(stats)
+
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(GraphPartition(underlying_property_graph(pg), num_partitions, output_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
+
+
+def graph_partition_assert_valid(pg, uint32_t num_partitions, str output_property_name):
+    """
+    Raise an exception if the partition in `pg` puts a node in a partition id of num_partitions or more.
+
+    :raises: AssertionError
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_assert(GraphPartitionAssertValid(underlying_property_graph(pg), num_partitions, output_property_name_cstr))
+
+
+cdef _GraphPartitionStatistics handle_result_GraphPartitionStatistics(Result[_GraphPartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class GraphPartitionStatistics:
+    """
+    Compute the :ref:`statistics` of a Graph Partition.
+    """
+    cdef _GraphPartitionStatistics underlying
+
+    def __init__(self, pg, str output_property_name):
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_GraphPartitionStatistics(_GraphPartitionStatistics.Compute(
+                underlying_property_graph(pg), output_property_name_cstr))
+
+    @property
+    def num_partitions(self) -> int:
+        """
+        The number of partitions that hold at least one node.
+        """
+        return self.underlying.num_partitions
+
+    @property
+    def edge_cut(self) -> int:
+        """
+        The number of edges between nodes of different partitions.
+        """
+        return self.underlying.edge_cut
+
+    @property
+    def largest_partition_size(self) -> int:
+        """
+        The number of nodes of the largest partition.
+        """
+        return self.underlying.largest_partition_size
+
+    @property
+    def smallest_partition_size(self) -> int:
+        """
+        The number of nodes of the smallest partition that holds any.
+        """
+        return self.underlying.smallest_partition_size
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
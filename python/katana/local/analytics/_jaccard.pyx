@@ -14,9 +14,24 @@ Jaccard Similarity
 
 
 .. autofunction:: katana.local.analytics.jaccard_assert_valid
+
+
+.. autoclass:: katana.local.analytics.JaccardTopKPlan
+
+
+.. autoclass:: katana.local.analytics._jaccard._JaccardTopKAlgorithm
+
+
+.. autoclass:: katana.local.analytics._jaccard._JaccardTopKMeasure
+
+
+.. autofunction:: katana.local.analytics.jaccard_top_k
 """
 
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr
 from libcpp.string cimport string
+from pyarrow.lib cimport CTable, pyarrow_wrap_table
 
 from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -64,6 +79,37 @@ cdef extern from "katana/analytics/jaccard/jaccard.h" namespace "katana::analyti
         Result[_JaccardStatistics] Compute(_PropertyGraph* pg, size_t compare_node,
             string output_property_name)
 
+    cppclass _JaccardTopKPlan "katana::analytics::JaccardTopKPlan" (_Plan):
+        enum Algorithm:
+            kMinHash "katana::analytics::JaccardTopKPlan::kMinHash"
+            kExact "katana::analytics::JaccardTopKPlan::kExact"
+
+        enum Measure:
+            kJaccard "katana::analytics::JaccardTopKPlan::kJaccard"
+            kOverlap "katana::analytics::JaccardTopKPlan::kOverlap"
+            kCosine "katana::analytics::JaccardTopKPlan::kCosine"
+
+        _JaccardTopKPlan.Algorithm algorithm() const
+        uint32_t num_bands() const
+        uint32_t rows_per_band() const
+        uint32_t max_bucket_size() const
+        uint32_t seed() const
+
+        _JaccardTopKPlan()
+
+        @staticmethod
+        _JaccardTopKPlan MinHash(uint32_t num_bands, uint32_t rows_per_band, uint32_t max_bucket_size, uint32_t seed)
+
+        @staticmethod
+        _JaccardTopKPlan Exact()
+
+    uint32_t kDefaultNumBands "katana::analytics::JaccardTopKPlan::kDefaultNumBands"
+    uint32_t kDefaultRowsPerBand "katana::analytics::JaccardTopKPlan::kDefaultRowsPerBand"
+    uint32_t kDefaultMaxBucketSize "katana::analytics::JaccardTopKPlan::kDefaultMaxBucketSize"
+
+    Result[shared_ptr[CTable]] JaccardTopK(_PropertyGraph* pg, uint32_t k, _JaccardTopKPlan.Measure measure,
+        _JaccardTopKPlan plan)
+
 
 class _JaccardEdgeSorting(Enum):
     """
@@ -225,3 +271,124 @@ cdef class JaccardStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+class _JaccardTopKAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.JaccardTopKPlan` constructors for algorithm documentation.
+    """
+    MinHash = _JaccardTopKPlan.Algorithm.kMinHash
+    Exact = _JaccardTopKPlan.Algorithm.kExact
+
+
+class _JaccardTopKMeasure(Enum):
+    """
+    The similarity of the out-neighbor sets A and B of two nodes.
+    """
+    Jaccard = _JaccardTopKPlan.Measure.kJaccard
+    """|A ∩ B| / |A ∪ B|"""
+    Overlap = _JaccardTopKPlan.Measure.kOverlap
+    """|A ∩ B| / min(|A|, |B|)"""
+    Cosine = _JaccardTopKPlan.Measure.kCosine
+    """|A ∩ B| / sqrt(|A| |B|)"""
+
+
+cdef class JaccardTopKPlan(Plan):
+    """
+    A computational :ref:`Plan` for :py:func:`jaccard_top_k`, which chooses the pairs of nodes to score.
+
+    Static methods construct JaccardTopKPlans. The constructor uses MinHash with the default parameters.
+    """
+    cdef:
+        _JaccardTopKPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _JaccardTopKAlgorithm
+    Measure = _JaccardTopKMeasure
+
+    @staticmethod
+    cdef JaccardTopKPlan make(_JaccardTopKPlan u):
+        f = <JaccardTopKPlan>JaccardTopKPlan.__new__(JaccardTopKPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _JaccardTopKAlgorithm:
+        return _JaccardTopKAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def num_bands(self) -> int:
+        """
+        The number of bands of a MinHash signature.
+        """
+        return self.underlying_.num_bands()
+
+    @property
+    def rows_per_band(self) -> int:
+        """
+        The number of hashes in each band.
+        """
+        return self.underlying_.rows_per_band()
+
+    @property
+    def max_bucket_size(self) -> int:
+        """
+        Buckets of more nodes than this that share a band are not scored.
+        """
+        return self.underlying_.max_bucket_size()
+
+    @property
+    def seed(self) -> int:
+        """
+        The seed of the MinHash functions.
+        """
+        return self.underlying_.seed()
+
+    @staticmethod
+    def min_hash(uint32_t num_bands = kDefaultNumBands, uint32_t rows_per_band = kDefaultRowsPerBand,
+                 uint32_t max_bucket_size = kDefaultMaxBucketSize, uint32_t seed = 0) -> JaccardTopKPlan:
+        """
+        Score the pairs that agree on a band of their MinHash signatures. A pair of similarity `s` shares a band with
+        probability ``1 - (1 - s ** rows_per_band) ** num_bands``.
+        """
+        return JaccardTopKPlan.make(_JaccardTopKPlan.MinHash(num_bands, rows_per_band, max_bucket_size, seed))
+
+    @staticmethod
+    def exact() -> JaccardTopKPlan:
+        """
+        Score every pair that shares a neighbor.
+        """
+        return JaccardTopKPlan.make(_JaccardTopKPlan.Exact())
+
+
+cdef shared_ptr[CTable] handle_result_table(Result[shared_ptr[CTable]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def jaccard_top_k(pg, uint32_t k, measure = _JaccardTopKMeasure.Jaccard,
+                  JaccardTopKPlan plan = JaccardTopKPlan()):
+    """
+    Find for every node the `k` other nodes whose out-neighbor sets are the most similar to its own, e.g., to predict
+    links. Pairs that share no neighbor are never reported, so a node may get fewer than `k`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type k: int
+    :param k: The number of similar nodes to find for each node.
+    :type measure: JaccardTopKPlan.Measure
+    :param measure: The similarity measure.
+    :type plan: JaccardTopKPlan
+    :param plan: The execution plan to use.
+    :return: A ``pyarrow.Table`` of a ``src``, a ``dst`` and a ``similarity`` column, sorted by ``src`` and then by
+        decreasing similarity.
+    """
+    cdef _JaccardTopKPlan.Measure c_measure = _JaccardTopKMeasure(measure).value
+    cdef shared_ptr[CTable] table
+    with nogil:
+        table = handle_result_table(JaccardTopK(underlying_property_graph(pg), k, c_measure, plan.underlying_))
+    return pyarrow_wrap_table(table)
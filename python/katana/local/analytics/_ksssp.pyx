@@ -29,6 +29,7 @@ cdef extern from "katana/analytics/k_shortest_paths/ksssp.h" namespace "katana::
             kDeltaTile "katana::analytics::KssspPlan::kDeltaTile"
             kDeltaStep "katana::analytics::KssspPlan::kDeltaStep"
             kDeltaStepBarrier "katana::analytics::KssspPlan::kDeltaStepBarrier"
+            kYen "katana::analytics::KssspPlan::kYen"
 
         enum Reachability:
             asyncLevel "katana::analytics::KssspPlan::asyncLevel"
@@ -48,6 +49,8 @@ cdef extern from "katana/analytics/k_shortest_paths/ksssp.h" namespace "katana::
         _KssspPlan DeltaStep(_KssspPlan.Reachability reachability, unsigned delta)
         @staticmethod
         _KssspPlan DeltaStepBarrier(_KssspPlan.Reachability reachability, unsigned delta)
+        @staticmethod
+        _KssspPlan Yen(_KssspPlan.Reachability reachability)
 
     _KssspPlan.Reachability kDefaultReach "katana::analytics::KssspPlan::kDefaultReach"
     unsigned kDefaultDelta "katana::analytics::KssspPlan::kDefaultDelta"
@@ -66,6 +69,7 @@ class _KssspAlgorithm(Enum):
     DeltaTile = _KssspPlan.Algorithm.kDeltaTile
     DeltaStep = _KssspPlan.Algorithm.kDeltaStep
     DeltaStepBarrier = _KssspPlan.Algorithm.kDeltaStepBarrier
+    Yen = _KssspPlan.Algorithm.kYen
 
 class _KssspReachability(Enum):
     """
@@ -161,6 +165,14 @@ cdef class KssspPlan(Plan):
         """
         return KssspPlan.make(_KssspPlan.DeltaStepBarrier(reachability, delta))
 
+    @staticmethod
+    def yen(_KssspPlan.Reachability reachability = kDefaultReach) -> KssspPlan:
+        """
+        Yen's algorithm, which finds loopless paths. The spur paths of each iteration are searched in parallel and
+        stop early once they cannot produce one of the remaining paths.
+        """
+        return KssspPlan.make(_KssspPlan.Yen(reachability))
+
 
 def ksssp(pg, str edge_weight_property_name, size_t start_node,
           size_t report_node, size_t num_paths, bool is_symmetric=False,
@@ -48,6 +48,7 @@ cdef extern from "katana/analytics/leiden_clustering/leiden_clustering.h" namesp
         uint32_t min_graph_size() const
         double resolution() const
         double randomness() const
+        uint64_t random_seed() const
         # LeidenClusteringPlan()
 
         @staticmethod
@@ -58,7 +59,8 @@ cdef extern from "katana/analytics/leiden_clustering/leiden_clustering.h" namesp
                 uint32_t max_iterations,
                 uint32_t min_graph_size,
                 double resolution,
-                double randomness
+                double randomness,
+                uint64_t random_seed
             )
 
         @staticmethod
@@ -69,7 +71,8 @@ cdef extern from "katana/analytics/leiden_clustering/leiden_clustering.h" namesp
                 uint32_t max_iterations,
                 uint32_t min_graph_size,
                 double resolution,
-                double randomness
+                double randomness,
+                uint64_t random_seed
             )
 
 
@@ -80,6 +83,7 @@ cdef extern from "katana/analytics/leiden_clustering/leiden_clustering.h" namesp
     double kDefaultRandomness "katana::analytics::LeidenClusteringPlan::kDefaultModularityThresholdTotal"
     uint32_t kDefaultMaxIterations "katana::analytics::LeidenClusteringPlan::kDefaultMaxIterations"
     uint32_t kDefaultMinGraphSize "katana::analytics::LeidenClusteringPlan::kDefaultMinGraphSize"
+    uint64_t kDefaultRandomSeed "katana::analytics::LeidenClusteringPlan::kDefaultRandomSeed"
 
     Result[void] LeidenClustering(_PropertyGraph* pfg, const string& edge_weight_property_name,const string& output_property_name, CTxnContext* txn_ctx, bool is_symmetric, _LeidenClusteringPlan plan)
 
@@ -152,6 +156,10 @@ cdef class LeidenClusteringPlan(Plan):
     def min_graph_size(self) -> uint32_t:
         return self.underlying_.min_graph_size()
 
+    @property
+    def random_seed(self) -> uint64_t:
+        return self.underlying_.random_seed()
+
 
     @staticmethod
     def do_all(
@@ -162,13 +170,14 @@ cdef class LeidenClusteringPlan(Plan):
                 uint32_t min_graph_size = kDefaultMinGraphSize,
                 double resolution = kDefaultResolution,
                 double randomness = kDefaultRandomness,
+                uint64_t random_seed = kDefaultRandomSeed,
     ) -> LeidenClusteringPlan:
         """
         Nondeterministic algorithm.
         """
         return LeidenClusteringPlan.make(_LeidenClusteringPlan.DoAll(
             enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations,
-            min_graph_size, resolution, randomness))
+            min_graph_size, resolution, randomness, random_seed))
 
     @staticmethod
     def deterministic(
@@ -179,13 +188,14 @@ cdef class LeidenClusteringPlan(Plan):
             uint32_t min_graph_size = kDefaultMinGraphSize,
             double resolution = kDefaultResolution,
             double randomness = kDefaultRandomness,
+            uint64_t random_seed = kDefaultRandomSeed,
     ) -> LeidenClusteringPlan:
         """
          Deterministic algorithm using delayed updates
         """
         return LeidenClusteringPlan.make(_LeidenClusteringPlan.Deterministic(
             enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations,
-            min_graph_size, resolution, randomness))
+            min_graph_size, resolution, randomness, random_seed))
 
 
 def leiden_clustering(pg, str edge_weight_property_name, str output_property_name, bool is_symmetric = False, LeidenClusteringPlan plan = LeidenClusteringPlan(), *, txn_ctx = None):
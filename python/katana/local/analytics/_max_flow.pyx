@@ -0,0 +1,223 @@
+"""
+Max Flow
+--------
+
+.. autoclass:: katana.local.analytics.MaxFlowPlan
+
+
+.. autoclass:: katana.local.analytics._max_flow._MaxFlowPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.max_flow
+
+.. autoclass:: katana.local.analytics.MaxFlowStatistics
+
+
+.. autofunction:: katana.local.analytics.max_flow_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/max_flow/max_flow.h" namespace "katana::analytics" nogil:
+    cppclass _MaxFlowPlan "katana::analytics::MaxFlowPlan" (_Plan):
+        enum Algorithm:
+            kPushRelabel "katana::analytics::MaxFlowPlan::kPushRelabel"
+
+        _MaxFlowPlan.Algorithm algorithm() const
+        uint32_t global_relabel_interval() const
+
+        MaxFlowPlan()
+
+        @staticmethod
+        _MaxFlowPlan PushRelabel(uint32_t global_relabel_interval)
+
+    uint32_t kDefaultGlobalRelabelInterval "katana::analytics::MaxFlowPlan::kDefaultGlobalRelabelInterval"
+
+    Result[void] MaxFlow(_PropertyGraph* pg, size_t source, size_t sink, string capacity_property_name, string output_flow_property_name, string output_cut_property_name, CTxnContext* txn_ctx, _MaxFlowPlan plan)
+
+    Result[void] MaxFlowAssertValid(_PropertyGraph* pg, size_t source, size_t sink, string capacity_property_name, string flow_property_name, string cut_property_name)
+
+    cppclass _MaxFlowStatistics "katana::analytics::MaxFlowStatistics":
+        uint64_t flow_value
+        uint64_t source_side_size
+        uint64_t cut_edges
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MaxFlowStatistics] Compute(_PropertyGraph* pg, size_t source, string flow_property_name, string cut_property_name)
+
+
+class _MaxFlowPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MaxFlowPlan` constructors for algorithm documentation.
+    """
+    PushRelabel = _MaxFlowPlan.Algorithm.kPushRelabel
+
+
+cdef class MaxFlowPlan(Plan):
+    """
+    A computational :ref:`Plan` for Max Flow.
+
+    Static methods construct MaxFlowPlans.
+    """
+    cdef:
+        _MaxFlowPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MaxFlowPlanAlgorithm
+
+    @staticmethod
+    cdef MaxFlowPlan make(_MaxFlowPlan u):
+        f = <MaxFlowPlan>MaxFlowPlan.__new__(MaxFlowPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MaxFlowPlanAlgorithm:
+        return _MaxFlowPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def global_relabel_interval(self) -> int:
+        return self.underlying_.global_relabel_interval()
+
+    @staticmethod
+    def push_relabel(uint32_t global_relabel_interval = kDefaultGlobalRelabelInterval):
+        """
+        Lock-free parallel push-relabel. Every active node pushes its excess to its lowest residual neighbor or
+        relabels itself above it. Heights are recomputed by a parallel breadth-first search from the sink after a
+        number of relabels and whenever a height empties.
+
+        :param global_relabel_interval: Heights are recomputed after this many relabels per node.
+        """
+        return MaxFlowPlan.make(_MaxFlowPlan.PushRelabel(global_relabel_interval))
+
+
+def max_flow(pg, size_t source, size_t sink, str capacity_property_name, str output_flow_property_name,
+             str output_cut_property_name, MaxFlowPlan plan = MaxFlowPlan(), *, txn_ctx = None):
+    """
+    Compute a maximum flow from source to sink. The capacities must be non-negative integers. The properties named
+    output_flow_property_name and output_cut_property_name are created by this function and may not exist before the
+    call. The flow property is an edge property of the same type as the capacities. The cut property is a uint8_t
+    node property that is 1 on the source side of a minimum cut and 0 elsewhere.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type source: int
+    :param source: The source node.
+    :type sink: int
+    :param sink: The sink node.
+    :type capacity_property_name: str
+    :param capacity_property_name: The edge property holding the capacities.
+    :type output_flow_property_name: str
+    :param output_flow_property_name: The output edge property. This property must not already exist.
+    :type output_cut_property_name: str
+    :param output_cut_property_name: The output node property. This property must not already exist.
+    :type plan: MaxFlowPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The tranaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("rmat10"))
+        from katana.analytics import max_flow, MaxFlowStatistics
+        max_flow(graph, 0, 10, "value", "flow", "cut")
+        stats = MaxFlowStatistics(graph, 0, "flow", "cut")
+        print(stats)
+
+    """
+    capacity_property_name_bytes = bytes(capacity_property_name, "utf-8")
+    capacity_property_name_cstr = <string>capacity_property_name_bytes
+    output_flow_property_name_bytes = bytes(output_flow_property_name, "utf-8")
+    output_flow_property_name_cstr = <string>output_flow_property_name_bytes
+    output_cut_property_name_bytes = bytes(output_cut_property_name, "utf-8")
+    output_cut_property_name_cstr = <string>output_cut_property_name_bytes
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(MaxFlow(underlying_property_graph(pg), source, sink, capacity_property_name_cstr, output_flow_property_name_cstr, output_cut_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
+
+
+def max_flow_assert_valid(pg, size_t source, size_t sink, str capacity_property_name, str flow_property_name,
+                          str cut_property_name):
+    """
+    Raise an exception if the flow in `pg` is not a maximum flow or the cut is not a minimum cut.
+
+    :raises: AssertionError
+    """
+    capacity_property_name_bytes = bytes(capacity_property_name, "utf-8")
+    capacity_property_name_cstr = <string>capacity_property_name_bytes
+    flow_property_name_bytes = bytes(flow_property_name, "utf-8")
+    flow_property_name_cstr = <string>flow_property_name_bytes
+    cut_property_name_bytes = bytes(cut_property_name, "utf-8")
+    cut_property_name_cstr = <string>cut_property_name_bytes
+    with nogil:
+        handle_result_assert(MaxFlowAssertValid(underlying_property_graph(pg), source, sink, capacity_property_name_cstr, flow_property_name_cstr, cut_property_name_cstr))
+
+
+cdef _MaxFlowStatistics handle_result_MaxFlowStatistics(Result[_MaxFlowStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MaxFlowStatistics:
+    """
+    Compute the :ref:`statistics` of a Max Flow.
+    """
+    cdef _MaxFlowStatistics underlying
+
+    def __init__(self, pg, size_t source, str flow_property_name, str cut_property_name):
+        flow_property_name_bytes = bytes(flow_property_name, "utf-8")
+        flow_property_name_cstr = <string> flow_property_name_bytes
+        cut_property_name_bytes = bytes(cut_property_name, "utf-8")
+        cut_property_name_cstr = <string> cut_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_MaxFlowStatistics(_MaxFlowStatistics.Compute(
+                underlying_property_graph(pg), source, flow_property_name_cstr, cut_property_name_cstr))
+
+    @property
+    def flow_value(self) -> int:
+        """
+        The value of the flow, i.e., the net flow out of the source.
+        """
+        return self.underlying.flow_value
+
+    @property
+    def source_side_size(self) -> int:
+        """
+        The number of nodes on the source side of the cut.
+        """
+        return self.underlying.source_side_size
+
+    @property
+    def cut_edges(self) -> int:
+        """
+        The number of edges from the source side to the sink side of the cut.
+        """
+        return self.underlying.cut_edges
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
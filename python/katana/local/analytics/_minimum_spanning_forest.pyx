@@ -0,0 +1,225 @@
+"""
+Minimum Spanning Forest
+-----------------------
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestPlan
+
+
+.. autoclass:: katana.local.analytics._minimum_spanning_forest._MinimumSpanningForestPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestStatistics
+
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h" namespace "katana::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "katana::analytics::MinimumSpanningForestPlan" (_Plan):
+        enum Algorithm:
+            kBoruvka "katana::analytics::MinimumSpanningForestPlan::kBoruvka"
+            kFilterKruskal "katana::analytics::MinimumSpanningForestPlan::kFilterKruskal"
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+        uint64_t base_case_size() const
+
+        MinimumSpanningForestPlan()
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+
+        @staticmethod
+        _MinimumSpanningForestPlan FilterKruskal(uint64_t base_case_size)
+
+    uint64_t kDefaultBaseCaseSize "katana::analytics::MinimumSpanningForestPlan::kDefaultBaseCaseSize"
+
+    Result[void] MinimumSpanningForest(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name, CTxnContext* txn_ctx, _MinimumSpanningForestPlan plan)
+
+    Result[void] MinimumSpanningForestAssertValid(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+    cppclass _MinimumSpanningForestStatistics "katana::analytics::MinimumSpanningForestStatistics":
+        uint64_t num_trees
+        uint64_t num_forest_edges
+        double total_weight
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MinimumSpanningForestStatistics] Compute(_PropertyGraph* pg, string edge_weight_property_name, string output_property_name)
+
+
+class _MinimumSpanningForestPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MinimumSpanningForestPlan` constructors for algorithm documentation.
+    """
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+    FilterKruskal = _MinimumSpanningForestPlan.Algorithm.kFilterKruskal
+
+
+cdef class MinimumSpanningForestPlan(Plan):
+    """
+    A computational :ref:`Plan` for Minimum Spanning Forest.
+
+    Static methods construct MinimumSpanningForestPlans.
+    """
+    cdef:
+        _MinimumSpanningForestPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MinimumSpanningForestPlanAlgorithm
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MinimumSpanningForestPlanAlgorithm:
+        return _MinimumSpanningForestPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def base_case_size(self) -> int:
+        return self.underlying_.base_case_size()
+
+    @staticmethod
+    def boruvka():
+        """
+        Parallel Boruvka. In each round every tree picks its lightest edge to another tree, the trees are merged along
+        the picked edges, and the edges within a tree are dropped.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+    @staticmethod
+    def filter_kruskal(uint64_t base_case_size = kDefaultBaseCaseSize):
+        """
+        Filter-Kruskal. The edges are split around a pivot weight; the light half is done first, then the heavy edges
+        within a tree are filtered out before the heavy half is done. This does well on dense graphs.
+
+        :param base_case_size: Edge lists of up to this many edges are sorted and added by Kruskal's algorithm.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.FilterKruskal(base_case_size))
+
+
+def minimum_spanning_forest(pg, str edge_weight_property_name, str output_property_name,
+             MinimumSpanningForestPlan plan = MinimumSpanningForestPlan(), *, txn_ctx = None):
+    """
+    Compute a minimum spanning forest of the graph, i.e., a minimum spanning tree of each connected component. The
+    graph must be symmetric. Self loops are ignored. Ties between equal weights are broken by edge id, so every plan
+    computes the same forest. The property named output_property_name is created by this function and may not exist
+    before the call. The created property has type uint8_t and is 1 on the edges of the forest; of the two directions
+    of a forest edge only the one from the smaller to the larger node id is marked.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The edge property holding the weights.
+    :type output_property_name: str
+    :param output_property_name: The output edge property. This property must not already exist.
+    :type plan: MinimumSpanningForestPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The tranaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+        from katana.analytics import minimum_spanning_forest, MinimumSpanningForestStatistics
+        minimum_spanning_forest(graph, "value", "output")
+        stats = MinimumSpanningForestStatistics(graph, "value", "output")
+        print(stats)
+
+    """
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(MinimumSpanningForest(underlying_property_graph(pg), edge_weight_property_name_cstr, output_property_name_cstr, underlying_txn_context(txn_ctx), plan.underlying_))
+
+
+def minimum_spanning_forest_assert_valid(pg, str edge_weight_property_name, str output_property_name):
+    """
+    Raise an exception if the edges marked in `pg` are not the minimum spanning forest.
+
+    :raises: AssertionError
+    """
+    edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+    edge_weight_property_name_cstr = <string>edge_weight_property_name_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_assert(MinimumSpanningForestAssertValid(underlying_property_graph(pg), edge_weight_property_name_cstr, output_property_name_cstr))
+
+
+cdef _MinimumSpanningForestStatistics handle_result_MinimumSpanningForestStatistics(Result[_MinimumSpanningForestStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MinimumSpanningForestStatistics:
+    """
+    Compute the :ref:`statistics` of a Minimum Spanning Forest.
+    """
+    cdef _MinimumSpanningForestStatistics underlying
+
+    def __init__(self, pg, str edge_weight_property_name, str output_property_name):
+        edge_weight_property_name_bytes = bytes(edge_weight_property_name, "utf-8")
+        edge_weight_property_name_cstr = <string> edge_weight_property_name_bytes
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_MinimumSpanningForestStatistics(_MinimumSpanningForestStatistics.Compute(
+                underlying_property_graph(pg), edge_weight_property_name_cstr, output_property_name_cstr))
+
+    @property
+    def num_trees(self) -> int:
+        """
+        The number of trees of the forest, counting isolated nodes.
+        """
+        return self.underlying.num_trees
+
+    @property
+    def num_forest_edges(self) -> int:
+        """
+        The number of edges of the forest.
+        """
+        return self.underlying.num_forest_edges
+
+    @property
+    def total_weight(self) -> float:
+        """
+        The total weight of the edges of the forest.
+        """
+        return self.underlying.total_weight
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
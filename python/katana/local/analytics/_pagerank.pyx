@@ -41,6 +41,7 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
+            kPullBlocked "katana::analytics::PagerankPlan::kPullBlocked"
 
         # unsigned int kChunkSize
 
@@ -55,6 +56,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         @staticmethod
         _PagerankPlan PullTopological(float tolerance, unsigned int max_iterations, float alpha)
         @staticmethod
+        _PagerankPlan PullBlocked(float tolerance, unsigned int max_iterations, float alpha)
+        @staticmethod
         _PagerankPlan PullResidual(float tolerance, unsigned int max_iterations, float alpha)
         @staticmethod
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
@@ -85,6 +88,7 @@ class _PagerankPlanAlgorithm(Enum):
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PullBlocked = _PagerankPlan.Algorithm.kPullBlocked
 
 
 cdef class PagerankPlan(Plan):
@@ -136,6 +140,16 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PullTopological(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def pull_blocked(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
+        """
+        Topological algorithm with propagation blocking
+
+        Contributions are binned by destination block so that ranks are
+        summed in cache. The graph is used as is, not transposed.
+        """
+        return PagerankPlan.make(_PagerankPlan.PullBlocked(tolerance, max_iterations, alpha))
+
     @staticmethod
     def pull_residual(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
         """
@@ -46,6 +46,7 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kTopological "katana::analytics::SsspPlan::kTopological"
             kTopologicalTile "katana::analytics::SsspPlan::kTopologicalTile"
             kAutomatic "katana::analytics::SsspPlan::kAutomatic"
+            kDeltaStepAdaptive "katana::analytics::SsspPlan::kDeltaStepAdaptive"
 
         _SsspPlan()
         _SsspPlan(const _PropertyGraph * pg)
@@ -63,6 +64,8 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         @staticmethod
         _SsspPlan DeltaStepFusion(unsigned delta)
         @staticmethod
+        _SsspPlan DeltaStepAdaptive(unsigned delta)
+        @staticmethod
         _SsspPlan SerialDeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
         @staticmethod
         _SsspPlan SerialDelta(unsigned delta)
@@ -112,6 +115,7 @@ class _SsspAlgorithm(Enum):
     Topological = _SsspPlan.Algorithm.kTopological
     TopologicalTile = _SsspPlan.Algorithm.kTopologicalTile
     Automatic = _SsspPlan.Algorithm.kAutomatic
+    DeltaStepAdaptive = _SsspPlan.Algorithm.kDeltaStepAdaptive
 
 
 cdef class SsspPlan(Plan):
@@ -198,6 +202,13 @@ cdef class SsspPlan(Plan):
         """
         return SsspPlan.make(_SsspPlan.DeltaStepFusion(delta))
 
+    @staticmethod
+    def delta_step_adaptive(unsigned delta = kDefaultDelta) -> SsspPlan:
+        """
+        Delta stepping with fused buckets and a step size that adapts at runtime
+        """
+        return SsspPlan.make(_SsspPlan.DeltaStepAdaptive(delta))
+
     @staticmethod
     def serial_delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         """
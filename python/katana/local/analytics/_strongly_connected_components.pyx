@@ -0,0 +1,209 @@
+"""
+Strongly Connected Components
+-----------------------------
+
+.. autoclass:: katana.local.analytics.StronglyConnectedComponentsPlan
+
+
+.. [Slota] George M. Slota, Sivasankaran Rajamanickam, Kamesh Madduri. BFS and
+    Coloring-based Parallel Algorithms for Strongly Connected Components and
+    Related Problems. IPDPS 2014.
+
+.. autoclass:: katana.local.analytics._strongly_connected_components._StronglyConnectedComponentsPlanAlgorithm
+
+
+.. autofunction:: katana.local.analytics.strongly_connected_components
+
+.. autoclass:: katana.local.analytics.StronglyConnectedComponentsStatistics
+
+
+.. autofunction:: katana.local.analytics.strongly_connected_components_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport TxnContext as CTxnContext
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+
+from katana.local import Graph, TxnContext
+
+from katana.local._graph cimport underlying_property_graph, underlying_txn_context
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/strongly_connected_components/strongly_connected_components.h" namespace "katana::analytics" nogil:
+    cppclass _StronglyConnectedComponentsPlan "katana::analytics::StronglyConnectedComponentsPlan"(_Plan):
+        enum Algorithm:
+            kMultistep "katana::analytics::StronglyConnectedComponentsPlan::kMultistep"
+
+        _StronglyConnectedComponentsPlan.Algorithm algorithm() const
+        uint32_t serial_cutoff() const
+
+        StronglyConnectedComponentsPlan()
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan Multistep(uint32_t serial_cutoff)
+
+    uint32_t kDefaultSerialCutoff "katana::analytics::StronglyConnectedComponentsPlan::kDefaultSerialCutoff"
+
+    Result[void] StronglyConnectedComponents(_PropertyGraph*pg, string output_property_name,
+                                             CTxnContext* txn_ctx, _StronglyConnectedComponentsPlan plan)
+
+    Result[void] StronglyConnectedComponentsAssertValid(_PropertyGraph*pg, string output_property_name)
+
+    cppclass _StronglyConnectedComponentsStatistics "katana::analytics::StronglyConnectedComponentsStatistics":
+        uint64_t total_components
+        uint64_t total_non_trivial_components
+        uint64_t largest_component_size
+        double largest_component_ratio
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_StronglyConnectedComponentsStatistics] Compute(_PropertyGraph*pg, string output_property_name)
+
+
+class _StronglyConnectedComponentsPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.StronglyConnectedComponentsPlan` constructors for algorithm documentation.
+    """
+    Multistep = _StronglyConnectedComponentsPlan.Algorithm.kMultistep
+
+
+cdef class StronglyConnectedComponentsPlan(Plan):
+    """
+    A computational :ref:`Plan` for Strongly Connected Components.
+
+    Static methods construct StronglyConnectedComponentsPlans. All parameters are optional and have reasonable
+    defaults.
+    """
+    cdef:
+        _StronglyConnectedComponentsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _StronglyConnectedComponentsPlanAlgorithm
+
+    @staticmethod
+    cdef StronglyConnectedComponentsPlan make(_StronglyConnectedComponentsPlan u):
+        f = <StronglyConnectedComponentsPlan> StronglyConnectedComponentsPlan.__new__(StronglyConnectedComponentsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _StronglyConnectedComponentsPlanAlgorithm:
+        return self.underlying_.algorithm()
+
+    @property
+    def serial_cutoff(self) -> uint32_t:
+        """
+        The number of nodes left at which the coloring rounds stop and Tarjan's algorithm finds the rest serially.
+        """
+        return self.underlying_.serial_cutoff()
+
+    @staticmethod
+    def multistep(uint32_t serial_cutoff = kDefaultSerialCutoff) -> StronglyConnectedComponentsPlan:
+        """
+        Trim nodes without in-edges or out-edges, find the largest component with a forward and a backward search,
+        then alternate trimming and coloring until `serial_cutoff` nodes are left [Slota]_.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Multistep(serial_cutoff))
+
+
+def strongly_connected_components(pg, str output_property_name,
+                                  StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan(), *,
+                                  txn_ctx = None) -> int:
+    """
+    Compute the strongly connected components of `pg`, following the direction of its edges.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to write dense component ids into. This property must not
+        already exist.
+    :type plan: StronglyConnectedComponentsPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The tranaction context for passing read write sets.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_rdg_dataset
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_rdg_dataset("ldbc_003"))
+        from katana.analytics import strongly_connected_components, StronglyConnectedComponentsStatistics
+        strongly_connected_components(graph, "output")
+
+        stats = StronglyConnectedComponentsStatistics(graph, "output")
+
+        print("Total Components:", stats.total_components)
+        print("Largest Component Size:", stats.largest_component_size)
+
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        v = handle_result_void(StronglyConnectedComponents(underlying_property_graph(pg), output_property_name_str,
+                                                           underlying_txn_context(txn_ctx), plan.underlying_))
+    return v
+
+def strongly_connected_components_assert_valid(pg, str output_property_name):
+    """
+    Raise an exception if the components in `pg` are not strongly connected or if a cycle goes through two of them.
+
+    :raises: AssertionError
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(StronglyConnectedComponentsAssertValid(underlying_property_graph(pg),
+                                                                    output_property_name_str))
+
+cdef _StronglyConnectedComponentsStatistics handle_result_StronglyConnectedComponentsStatistics(
+        Result[_StronglyConnectedComponentsStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+cdef class StronglyConnectedComponentsStatistics:
+    """
+    Compute the :ref:`statistics` of a Strongly Connected Components computation on a graph.
+    """
+    cdef _StronglyConnectedComponentsStatistics underlying
+
+    def __init__(self, pg, str output_property_name):
+        cdef string output_property_name_str = output_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_StronglyConnectedComponentsStatistics(
+                _StronglyConnectedComponentsStatistics.Compute(underlying_property_graph(pg), output_property_name_str))
+
+    @property
+    def total_components(self) -> uint64_t:
+        return self.underlying.total_components
+
+    @property
+    def total_non_trivial_components(self) -> uint64_t:
+        return self.underlying.total_non_trivial_components
+
+    @property
+    def largest_component_size(self) -> uint64_t:
+        return self.underlying.largest_component_size
+
+    @property
+    def largest_component_ratio(self) -> double:
+        """
+        The fraction of the entire graph that is part of the largest component.
+        """
+        return self.underlying.largest_component_ratio
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
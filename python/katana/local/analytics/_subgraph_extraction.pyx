@@ -6,9 +6,12 @@ Subgraph Extraction
 
 
 .. autofunction:: katana.local.analytics.subgraph_extraction
+
+.. autofunction:: katana.local.analytics.subgraph_extraction_by_type
 """
 from libc.stdint cimport uint32_t, uintptr_t
 from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from pyarrow.lib cimport to_shared
 
@@ -34,7 +37,15 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
         _SubGraphExtractionPlan NodeSet(
             )
 
-    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan)
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec,
+                                                           const vector[string]& node_properties_to_copy,
+                                                           const vector[string]& edge_properties_to_copy,
+                                                           _SubGraphExtractionPlan plan)
+
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtractionByType(_PropertyGraph* pfg, const vector[string]& node_types,
+                                                                 const vector[string]& edge_types,
+                                                                 const vector[string]& node_properties_to_copy,
+                                                                 const vector[string]& edge_properties_to_copy)
 
 
 class _SubGraphExtractionPlanAlgorithm(Enum):
@@ -80,12 +91,45 @@ cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_
     return to_shared(res.value())
 
 
-def subgraph_extraction(pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan()) -> Graph:
+cdef vector[string] encode_names(names):
+    return [<string>name.encode("utf-8") for name in names]
+
+
+def subgraph_extraction(pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan(), *,
+                        node_properties = (), edge_properties = ()) -> Graph:
     """
     Given a set of node ids, this algorithm constructs a new sub-graph which contains all nodes in the set and edges
-    between them.
+    between them. Node `i` of the sub-graph is the `i`-th distinct node of `node_vec`.
+
+    :param node_properties: The names of the node properties to copy into the sub-graph.
+    :param edge_properties: The names of the edge properties to copy into the sub-graph.
     """
     cdef vector[uint32_t] vec = [<uint32_t>n for n in node_vec]
+    cdef vector[string] node_properties_vec = encode_names(node_properties)
+    cdef vector[string] edge_properties_vec = encode_names(edge_properties)
+    with nogil:
+        v = handle_result_property_graph(SubGraphExtraction(underlying_property_graph(pg), vec, node_properties_vec,
+                                                            edge_properties_vec, plan.underlying_))
+    return Graph._make_from_address_shared(<uintptr_t>&v)
+
+
+def subgraph_extraction_by_type(pg, node_types = (), edge_types = (), *, node_properties = (),
+                                edge_properties = ()) -> Graph:
+    """
+    Construct a new sub-graph from the nodes and edges that have one of the given atomic types, keeping only edges
+    between selected nodes. An empty list of types selects all nodes or all edges.
+
+    :param node_types: The names of the node types to select.
+    :param edge_types: The names of the edge types to select.
+    :param node_properties: The names of the node properties to copy into the sub-graph.
+    :param edge_properties: The names of the edge properties to copy into the sub-graph.
+    """
+    cdef vector[string] node_types_vec = encode_names(node_types)
+    cdef vector[string] edge_types_vec = encode_names(edge_types)
+    cdef vector[string] node_properties_vec = encode_names(node_properties)
+    cdef vector[string] edge_properties_vec = encode_names(edge_properties)
     with nogil:
-        v = handle_result_property_graph(SubGraphExtraction(underlying_property_graph(pg), vec, plan.underlying_))
+        v = handle_result_property_graph(SubGraphExtractionByType(underlying_property_graph(pg), node_types_vec,
+                                                                  edge_types_vec, node_properties_vec,
+                                                                  edge_properties_vec))
     return Graph._make_from_address_shared(<uintptr_t>&v)
@@ -90,14 +90,14 @@ def _build_edge_views(self):
 
 
 def _build_edge_arrays(self, nodes, output_len):
-    ids = numpy.empty(output_len, dtype=numpy.uint64)
-    sources = numpy.empty(output_len, dtype=numpy.uint32)
-    dests = numpy.empty(output_len, dtype=numpy.uint32)
-    i = 0
-    for n in nodes:
-        for e in self.out_edge_ids(n):
-            ids[i] = e
-            sources[i] = n
-            dests[i] = self.get_edge_dst(e)
-            i += 1
+    adj_indices = self.adj_indices()
+    nodes = numpy.asarray(nodes, dtype=numpy.int64)
+    stops = adj_indices[nodes].astype(numpy.int64)
+    starts = numpy.where(nodes > 0, adj_indices[numpy.maximum(nodes - 1, 0)], 0).astype(numpy.int64)
+    counts = stops - starts
+    # the offset of each output edge from the first out-edge of its node
+    offsets = numpy.arange(output_len) - numpy.repeat(numpy.cumsum(counts) - counts, counts)
+    ids = (numpy.repeat(starts, counts) + offsets).astype(numpy.uint64)
+    sources = numpy.repeat(nodes, counts).astype(numpy.uint32)
+    dests = self.edge_dests()[ids]
     return dict(id=ids, source=sources, dest=dests)
@@ -6,5 +6,6 @@ PYBIND11_MODULE(local_native, m) {
   katana::python::InitEntityTypeManager(m);
   katana::python::InitImportData(m);
   katana::python::InitPropertyGraph(m);
+  katana::python::InitNeighborSampler(m);
   katana::python::InitRDGInterface(m);
 }
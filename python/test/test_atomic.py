@@ -7,10 +7,12 @@ from katana import do_all, do_all_operator
 from katana.local import (
     NUMAArray,
     ReduceAnd,
+    ReduceHistogram,
     ReduceMax,
     ReduceMin,
     ReduceOr,
     ReduceSum,
+    ReduceTopK,
     atomic_add,
     atomic_max,
     atomic_min,
@@ -87,6 +89,36 @@ def test_ReduceMin_parallel(threads_many):
     assert acc.reduce() == -50.0
 
 
+def test_ReduceMax_negative_float():
+    acc = ReduceMax[float]()
+    acc.update(-3.5)
+    assert acc.reduce() == -3.5
+
+
+def test_ReduceHistogram_parallel(threads_many):
+    acc = ReduceHistogram(10)
+
+    @do_all_operator()
+    def f(acc, i):
+        acc.update(i % 10)
+        acc.update_weighted(0, 2)
+
+    do_all(range(1000), f(acc), steal=False)
+    assert acc.num_bins == 10
+    assert list(acc.reduce()) == [2100] + [100] * 9
+
+
+def test_ReduceTopK_parallel(threads_many):
+    acc = ReduceTopK[int](3)
+
+    @do_all_operator()
+    def f(acc, i):
+        acc.update((i * 7) % 1000)
+
+    do_all(range(1000), f(acc), steal=False)
+    assert list(acc.reduce()) == [999, 998, 997]
+
+
 def test_ReduceOr_parallel(threads_many):
     T = ReduceOr
     acc = T()
@@ -1,3 +1,4 @@
+import gc
 import os
 from pathlib import Path
 from tempfile import TemporaryDirectory
@@ -200,6 +201,25 @@ def test_from_csr():
     assert pg.get_edge_dst(0) == 1
 
 
+def test_from_csr_without_copy():
+    indices = np.array([2, 3, 3], dtype=np.uint64)
+    destinations = np.array([1, 2, 0], dtype=np.uint32)
+    pg = from_csr(indices, destinations)
+    # the graph uses the arrays in place and keeps them alive
+    del indices, destinations
+    gc.collect()
+    assert pg.num_nodes() == 3
+    assert pg.num_edges() == 3
+    assert [pg.get_edge_dst(i) for i in range(pg.num_edges())] == [1, 2, 0]
+
+
+def test_from_csr_strided():
+    indices = np.array([[1, 0], [1, 0]], dtype=np.uint64)[:, 0]
+    pg = from_csr(indices, np.array([1], dtype=np.uint32))
+    assert pg.num_nodes() == 2
+    assert pg.get_edge_dst(0) == 1
+
+
 def test_from_csr_int16():
     pg = from_csr(np.array([1, 1], dtype=np.int16), np.array([1], dtype=np.int16))
     assert pg.num_nodes() == 2
@@ -1,3 +1,4 @@
+from collections import Counter
 from test.lonestar.bfs import verify_bfs
 from test.lonestar.sssp import verify_sssp
 
@@ -7,35 +8,56 @@ from pytest import approx, raises
 
 from katana import GaloisError, set_busy_wait
 from katana.example_data import get_rdg_dataset
-from katana.local import Graph
+from katana.local import Graph, NeighborSampler
 from katana.local.analytics import (
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
     BfsStatistics,
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
     CdlpStatistics,
     ConnectedComponentsStatistics,
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    GraphPartitionPlan,
+    GraphPartitionStatistics,
     IndependentSetPlan,
     IndependentSetStatistics,
     JaccardPlan,
     JaccardStatistics,
+    JaccardTopKPlan,
     KCoreStatistics,
     KTrussStatistics,
     LeidenClusteringStatistics,
     LouvainClusteringStatistics,
+    MaxFlowPlan,
+    MaxFlowStatistics,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
     PagerankStatistics,
     SsspStatistics,
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
     TriangleCountPlan,
     betweenness_centrality,
     bfs,
     bfs_assert_valid,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
     cdlp,
+    connected_component_sizes,
     connected_components,
     connected_components_assert_valid,
     find_edge_sorted_by_dest,
+    graph_coloring,
+    graph_coloring_assert_valid,
+    graph_partition,
+    graph_partition_assert_valid,
     independent_set,
     independent_set_assert_valid,
     jaccard,
     jaccard_assert_valid,
+    jaccard_top_k,
     k_core,
     k_core_assert_valid,
     k_truss,
@@ -45,13 +67,20 @@ from katana.local.analytics import (
     local_clustering_coefficient,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    max_flow,
+    max_flow_assert_valid,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
     pagerank,
     pagerank_assert_valid,
     sort_all_edges_by_dest,
     sort_nodes_by_degree,
     sssp,
     sssp_assert_valid,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
     subgraph_extraction,
+    subgraph_extraction_by_type,
     triangle_count,
 )
 
@@ -128,6 +157,21 @@ def test_bfs(graph: Graph):
     verify_bfs(graph, start_node, property_name)
 
 
+def test_bipartite_matching(graph: Graph):
+    bipartite_matching(graph, "Forum", "Person", "matched")
+    bipartite_matching_assert_valid(graph, "Forum", "Person", "matched")
+    stats = BipartiteMatchingStatistics(graph, "Forum", "Person", "matched")
+    assert stats.num_matched <= min(stats.num_left_nodes, stats.num_right_nodes)
+
+    plan = BipartiteMatchingPlan.push_relabel()
+    assert plan.algorithm == BipartiteMatchingPlan.Algorithm.PushRelabel
+    bipartite_matching(graph, "Forum", "Person", "matched2", plan)
+    bipartite_matching_assert_valid(graph, "Forum", "Person", "matched2")
+    stats2 = BipartiteMatchingStatistics(graph, "Forum", "Person", "matched2")
+    # maximum matchings all have the same size
+    assert stats2.num_matched == stats.num_matched
+
+
 def test_sssp(graph: Graph):
     property_name = "NewProp"
     weight_name = "workFrom"
@@ -178,6 +222,31 @@ def test_jaccard(graph: Graph):
     assert similarities[2812] == approx(0.0)
 
 
+def test_jaccard_top_k(graph: Graph):
+    k = 3
+    exact = jaccard_top_k(graph, k, plan=JaccardTopKPlan.exact()).to_pydict()
+    min_hash = jaccard_top_k(graph, k).to_pydict()
+
+    for result in (exact, min_hash):
+        pairs = list(zip(result["src"], result["similarity"]))
+        assert all(0 < similarity <= 1 for _, similarity in pairs)
+        assert pairs == sorted(pairs, key=lambda p: (p[0], -p[1]))
+        assert all(src != dst for src, dst in zip(result["src"], result["dst"]))
+        assert max(Counter(result["src"]).values()) <= k
+
+    # The exact pairs of a node are its most similar nodes
+    compare_node = exact["src"][0]
+    jaccard(graph, compare_node, "NewProp")
+    similarities: np.ndarray = graph.get_node_property("NewProp").to_numpy()
+    similarities[compare_node] = 0
+    assert exact["similarity"][0] == approx(similarities.max())
+
+    # MinHash only finds some of the pairs, with exact similarities
+    best = dict(zip(exact["src"][::-1], exact["similarity"][::-1]))
+    for src, similarity in zip(min_hash["src"], min_hash["similarity"]):
+        assert similarity <= best[src] + 1e-9
+
+
 def test_jaccard_sorted(graph: Graph):
     sort_all_edges_by_dest(graph)
 
@@ -247,6 +316,17 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_asynchronous(graph: Graph):
+    property_name = "NewProp"
+
+    betweenness_centrality(graph, property_name, 16, BetweennessCentralityPlan.asynchronous())
+
+    stats = BetweennessCentralityStatistics(graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(7.0)
+    assert stats.average_centrality == approx(0.000534295046236366)
+
 def test_triangle_count():
     graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dst(e) for e in graph.out_edge_ids(0)]
@@ -290,6 +370,75 @@ def test_independent_set():
     independent_set_assert_valid(graph, "output2")
 
 
+def test_graph_coloring():
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+
+    graph_coloring(graph, "output")
+    graph_coloring_assert_valid(graph, "output")
+    stats = GraphColoringStatistics(graph, "output")
+    assert stats.num_colors > 1
+    assert stats.largest_color_size <= graph.num_nodes()
+
+    graph_coloring(graph, "output2", GraphColoringPlan.speculative())
+    graph_coloring_assert_valid(graph, "output2")
+    GraphColoringStatistics(graph, "output2")
+
+
+def test_graph_partition():
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+
+    graph_partition(graph, 4, "output")
+    graph_partition_assert_valid(graph, 4, "output")
+    stats = GraphPartitionStatistics(graph, "output")
+    assert stats.num_partitions == 4
+    assert stats.largest_partition_size <= 1.05 * graph.num_nodes() / 4 + 1
+    # a random partition would cut 3/4 of the edges
+    assert stats.edge_cut < 0.75 * graph.num_edges() / 2
+
+    plan = GraphPartitionPlan.multilevel(imbalance=0.2, coarsen_to_per_partition=4)
+    assert plan.imbalance == 0.2
+    graph_partition(graph, 8, "output2", plan)
+    graph_partition_assert_valid(graph, 8, "output2")
+    GraphPartitionStatistics(graph, "output2")
+
+
+def test_minimum_spanning_forest():
+    graph = Graph(get_rdg_dataset("rmat10_symmetric"))
+
+    minimum_spanning_forest(graph, "value", "output")
+    minimum_spanning_forest_assert_valid(graph, "value", "output")
+    stats = MinimumSpanningForestStatistics(graph, "value", "output")
+    # one tree per connected component
+    assert stats.num_trees == 69
+    assert stats.num_forest_edges == graph.num_nodes() - 69
+
+    plan = MinimumSpanningForestPlan.filter_kruskal(base_case_size=256)
+    assert plan.base_case_size == 256
+    minimum_spanning_forest(graph, "value", "output2", plan)
+    minimum_spanning_forest_assert_valid(graph, "value", "output2")
+    stats2 = MinimumSpanningForestStatistics(graph, "value", "output2")
+    assert stats2.num_forest_edges == stats.num_forest_edges
+    assert stats2.total_weight == approx(stats.total_weight)
+
+
+def test_max_flow():
+    graph = Graph(get_rdg_dataset("rmat10"))
+    sink = graph.num_nodes() - 1
+
+    max_flow(graph, 0, sink, "value", "flow", "cut")
+    max_flow_assert_valid(graph, 0, sink, "value", "flow", "cut")
+    stats = MaxFlowStatistics(graph, 0, "flow", "cut")
+    assert 1 <= stats.source_side_size < graph.num_nodes()
+
+    plan = MaxFlowPlan.push_relabel(global_relabel_interval=4)
+    assert plan.global_relabel_interval == 4
+    max_flow(graph, 0, sink, "value", "flow2", "cut2", plan)
+    max_flow_assert_valid(graph, 0, sink, "value", "flow2", "cut2")
+    stats2 = MaxFlowStatistics(graph, 0, "flow2", "cut2")
+    # the flow is unique in value only
+    assert stats2.flow_value == stats.flow_value
+
+
 def test_cdlp():
     graph = Graph(get_rdg_dataset("rmat10"))
     cdlp(graph, "output", 10, False)
@@ -324,6 +473,10 @@ def test_connected_components():
 
     connected_components_assert_valid(graph, "output_sym")
 
+    sizes = connected_component_sizes(graph, "output_sym")
+    assert sizes.num_rows == stats_sym.total_components
+    assert max(sizes.column("size").to_pylist()) == stats_sym.largest_component_size
+
     # Graph is not symmetric. Last bool argument (False)
     # indicates that. Connected components routine will create
     # undirected view for computation.
@@ -339,6 +492,29 @@ def test_connected_components():
     assert stats.largest_component_ratio == stats_sym.largest_component_ratio
 
 
+def test_strongly_connected_components():
+    graph = Graph(get_rdg_dataset("rmat10"))
+
+    strongly_connected_components(graph, "output")
+    strongly_connected_components_assert_valid(graph, "output")
+
+    stats = StronglyConnectedComponentsStatistics(graph, "output")
+
+    assert 1 <= stats.total_components <= graph.num_nodes()
+    assert stats.largest_component_size <= graph.num_nodes()
+
+    # Coloring until no node is left must find the same components as the
+    # serial search that takes over below the default cutoff.
+    strongly_connected_components(graph, "output_colored", StronglyConnectedComponentsPlan.multistep(0))
+    strongly_connected_components_assert_valid(graph, "output_colored")
+
+    stats_colored = StronglyConnectedComponentsStatistics(graph, "output_colored")
+
+    assert stats_colored.total_components == stats.total_components
+    assert stats_colored.total_non_trivial_components == stats.total_non_trivial_components
+    assert stats_colored.largest_component_size == stats.largest_component_size
+
+
 def test_k_core():
     graph = Graph(get_rdg_dataset("rmat10_symmetric"))
 
@@ -468,6 +644,66 @@ def test_subgraph_extraction():
         assert [pg.get_edge_dst(e) for e in pg.out_edge_ids(i)] == expected_edges[i]
 
 
+def test_subgraph_extraction_properties():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    graph.add_node_property(table({"original_id": np.arange(graph.num_nodes(), dtype=np.uint64)}))
+    nodes = [120, 11, 3, 1, 11]
+
+    pg = subgraph_extraction(graph, nodes, node_properties=["original_id"])
+
+    assert pg.num_nodes() == 4
+    assert pg.num_edges() == 6
+    assert pg.get_node_property("original_id").to_pylist() == [120, 11, 3, 1]
+
+    with raises(GaloisError):
+        subgraph_extraction(graph, nodes, node_properties=["not_a_property"])
+
+
+def test_subgraph_extraction_by_type():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    graph.add_node_property(table({"original_id": np.arange(graph.num_nodes(), dtype=np.uint64)}))
+
+    # No types selects the whole graph
+    pg = subgraph_extraction_by_type(graph, node_properties=["original_id"])
+
+    assert pg.num_nodes() == graph.num_nodes()
+    assert pg.num_edges() == graph.num_edges()
+    assert np.array_equal(pg.get_node_property("original_id").to_numpy(), np.arange(graph.num_nodes()))
+
+    with raises(GaloisError):
+        subgraph_extraction_by_type(graph, node_types=["not_a_type"])
+
+
+def test_neighbor_sampler():
+    graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
+    graph.add_node_property(table({"original_id": np.arange(graph.num_nodes(), dtype=np.uint64)}))
+
+    sampler = NeighborSampler(graph, [3, 2], feature_properties=["original_id"])
+    assert sampler.num_hops == 2
+    seeds = [0, 5, 42]
+    sample = sampler.sample(seeds, random_seed=1)
+
+    blocks = sample.blocks
+    assert len(blocks) == 2
+    assert blocks[-1]["num_dst_nodes"] == len(seeds)
+    assert np.array_equal(blocks[-1]["src_nodes"][: len(seeds)], seeds)
+    assert blocks[0]["num_dst_nodes"] == len(blocks[1]["src_nodes"])
+    for block, fanout in zip(blocks, [2, 3]):
+        assert len(block["indptr"]) == block["num_dst_nodes"] + 1
+        assert np.all(np.diff(block["indptr"]) <= fanout)
+        assert len(block["src_indices"]) == block["indptr"][-1]
+        assert np.all(block["src_indices"] < len(block["src_nodes"]))
+
+    features = sample.node_features.column("original_id").to_numpy()
+    assert np.array_equal(features, sample.input_nodes)
+
+    again = sampler.sample(seeds, random_seed=1)
+    assert np.array_equal(again.input_nodes, sample.input_nodes)
+
+    with raises(GaloisError):
+        sampler.sample([1, 1])
+
+
 def test_busy_wait(graph: Graph):
     set_busy_wait()
     property_name = "NewProp"
@@ -3,6 +3,8 @@ from tempfile import NamedTemporaryFile, TemporaryDirectory
 import numpy as np
 import pandas
 import pyarrow
+import pyarrow.compute
+import pyarrow.dataset
 import pytest
 
 from katana import do_all, do_all_operator
@@ -46,6 +48,60 @@ def test_get_edge_dst(graph):
     assert graph.get_edge_dst(1) == 8014
 
 
+def test_topology_arrays(graph):
+    adj_indices = graph.adj_indices()
+    dests = graph.edge_dests()
+    sources = graph.edge_sources()
+    assert len(adj_indices) == graph.num_nodes()
+    assert len(dests) == len(sources) == graph.num_edges()
+    assert not dests.flags.writeable
+    assert adj_indices[-1] == graph.num_edges()
+    assert dests[0] == 8014
+    assert sources[19993] == 20000
+    for n in (0, 5000, 20000):
+        edges = graph.out_edge_ids(n)
+        assert adj_indices[n] == edges.stop
+        assert list(dests[edges.start : edges.stop]) == [graph.get_edge_dst(e) for e in edges]
+        assert all(sources[edges.start : edges.stop] == n)
+
+
+def test_property_batches(graph):
+    name = graph.loaded_node_schema()[0].name
+    table = graph.node_property_batches([name], max_batch_rows=1000).read_all()
+    assert table.num_rows == graph.num_nodes()
+    assert table.column(0).equals(graph.get_node_property(name))
+
+    edges = graph.edge_list_batches(max_batch_rows=1000).read_all()
+    assert edges.num_rows == graph.num_edges()
+    assert edges["dest"].to_numpy().tolist() == graph.edge_dests().tolist()
+    assert edges["source"][19993].as_py() == 20000
+
+
+def test_filter_nodes(graph):
+    length = graph.get_node_property("length")
+    selected = pyarrow.compute.fill_null(pyarrow.compute.greater(length, 100), False)
+    expected = np.flatnonzero(selected.to_numpy())
+    nodes = graph.filter_nodes(pyarrow.dataset.field("length") > 100)
+    assert nodes.dtype == np.uint32
+    assert nodes.tolist() == expected.tolist()
+
+    person = graph.node_types.atomic_types["Person"]
+    is_person = graph.node_has_type(person)
+    nodes = graph.filter_nodes(is_person | (pyarrow.dataset.field("length") > 100))
+    expected = [n for n in range(graph.num_nodes()) if graph.does_node_have_type(n, person) or selected[n].as_py()]
+    assert nodes.tolist() == expected
+
+    with pytest.raises(Exception):
+        graph.filter_nodes(pyarrow.dataset.field("_mispelled") > 1)
+
+
+def test_filter_edges(graph):
+    edge_type = graph.edge_types.type_from_id(8)
+    edges = graph.filter_edges(graph.edge_has_type(edge_type))
+    assert edges.dtype == np.uint64
+    assert edges.tolist() == [e for e in range(graph.num_edges()) if graph.does_edge_have_type(e, edge_type)]
+
+
 def test_edge_data_frame(graph):
     edges = graph.out_edges()
     assert len(edges.columns) == 6
@@ -172,6 +228,15 @@ def test_upsert_node_property(graph):
     assert graph.get_node_property(prop).combine_chunks() == pyarrow.array(range(graph.num_nodes()))
 
 
+@pytest.mark.parametrize("hash_index", [False, True])
+def test_node_index_find_many(graph, hash_index):
+    num_nodes = graph.num_nodes()
+    graph.add_node_property(new_prop=[2 * i for i in range(num_nodes)])
+    index = graph.get_node_index("new_prop", hash=hash_index)
+    ids = index.find_many([4, 1, 0, 2 * (num_nodes - 1), None])
+    assert ids.to_pylist() == [2, None, 0, num_nodes - 1, None]
+
+
 def test_get_edge_property(graph):
     prop1 = graph.get_edge_property("creationDate")
     assert not prop1[10].as_py()
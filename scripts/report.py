@@ -1,6 +1,7 @@
 #!/usr/bin/env python
 
 import collections
+import json
 import sys
 
 
@@ -30,6 +31,19 @@ def main():
             if param_token == []:
                 continue
 
+            # a result of katana-bench, one JSON object per run
+            if line.lstrip().startswith("{"):
+                if row.r:
+                    rows.append(row.r)
+                    row.reset()
+                for key, val in json.loads(line).items():
+                    cols.add(key)
+                    # keep the CSV flat; error messages may hold commas
+                    row.r[key] = str(val).replace(",", ";")
+                rows.append(row.r)
+                row.reset()
+                continue
+
             # parameter setting by run.py
             if param_token[0] == "RUN:":
                 if param_token[1] == "Start":
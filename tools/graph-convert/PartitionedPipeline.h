@@ -0,0 +1,122 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_PARTITIONEDPIPELINE_H_
+#define KATANA_TOOLS_GRAPH_CONVERT_PARTITIONEDPIPELINE_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace katana {
+
+/// How a database collection or table is read: as partitions ranges of its
+/// key at once, each on its own connection, buffering at most max_batches
+/// batches of batch_size rows ahead of the conversion
+struct PartitionOptions {
+  size_t partitions{8};
+  size_t batch_size{1024};
+  size_t max_batches{8};
+};
+
+/// A queue of batches between the reader of one partition and the consumer
+template <typename Item>
+class PartitionQueue {
+public:
+  explicit PartitionQueue(size_t max_batches)
+      : max_batches_(std::max<size_t>(max_batches, 1)) {}
+
+  /// Blocks while the queue is full
+  void Push(std::vector<Item>&& batch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return batches_.size() < max_batches_; });
+    batches_.emplace_back(std::move(batch));
+    not_empty_.notify_one();
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_one();
+  }
+
+  /// Blocks while the queue is empty but open. \returns false once it is
+  /// closed and empty.
+  bool Pop(std::vector<Item>* batch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !batches_.empty() || closed_; });
+    if (batches_.empty()) {
+      return false;
+    }
+    *batch = std::move(batches_.front());
+    batches_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+private:
+  size_t max_batches_;
+  bool closed_{false};
+  std::deque<std::vector<Item>> batches_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+/// Call produce(p, emit) for every partition p < num_partitions, each on its
+/// own thread, and consume(item) on the calling thread for every item a
+/// producer emits. Items reach consume in partition order and, within a
+/// partition, in the order they were emitted, so the result is the same as
+/// reading the partitions one after the other. Readers of later partitions
+/// stop once their queue is full, which bounds memory to num_partitions *
+/// max_batches * batch_size items.
+template <typename Item, typename Produce, typename Consume>
+void
+RunPartitioned(
+    size_t num_partitions, const PartitionOptions& options, Produce produce,
+    Consume consume) {
+  size_t batch_size = std::max<size_t>(options.batch_size, 1);
+  std::vector<std::unique_ptr<PartitionQueue<Item>>> queues;
+  for (size_t p = 0; p < num_partitions; ++p) {
+    queues.emplace_back(
+        std::make_unique<PartitionQueue<Item>>(options.max_batches));
+  }
+
+  std::vector<std::thread> readers;
+  for (size_t p = 0; p < num_partitions; ++p) {
+    readers.emplace_back([&produce, &queues, batch_size, p]() {
+      PartitionQueue<Item>* queue = queues[p].get();
+      std::vector<Item> batch;
+      produce(p, [queue, batch_size, &batch](Item&& item) {
+        batch.emplace_back(std::move(item));
+        if (batch.size() >= batch_size) {
+          queue->Push(std::move(batch));
+          batch.clear();
+        }
+      });
+      if (!batch.empty()) {
+        queue->Push(std::move(batch));
+      }
+      queue->Close();
+    });
+  }
+
+  std::vector<Item> batch;
+  for (auto& queue : queues) {
+    while (queue->Pop(&batch)) {
+      for (auto& item : batch) {
+        consume(std::move(item));
+      }
+    }
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace katana
+
+#endif
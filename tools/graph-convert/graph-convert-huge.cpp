@@ -18,27 +18,44 @@
  */
 
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <ios>
 #include <iostream>
 #include <limits>
+#include <queue>
 #include <random>
 #include <regex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/mpl/if.hpp>
 
+#include "katana/CSRTopology.h"
+#include "katana/ErrorCode.h"
 #include "katana/FileGraph.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
 #include "katana/NUMAArray.h"
 #include "katana/OfflineGraph.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -54,6 +71,27 @@ static cll::opt<bool> edgesSorted(
     cll::init(false));
 static cll::opt<unsigned long long> numNodes(
     "numNodes", cll::desc("Total number of nodes given."), cll::init(0));
+static cll::opt<bool> externalSort(
+    "externalSort",
+    cll::desc("Sort the edges on disk in runs that fit in -memoryLimitMB "
+              "and merge them into the output; edge data is dropped"),
+    cll::init(false));
+static cll::opt<unsigned long long> memoryLimitMB(
+    "memoryLimitMB",
+    cll::desc("With -externalSort, the memory for one sorted run "
+              "(default 4096)"),
+    cll::init(4096));
+static cll::opt<std::string> tmpDir(
+    "tmpDir",
+    cll::desc("With -externalSort, the directory for sorted runs "
+              "(default .)"),
+    cll::init("."));
+static cll::opt<std::string> transposeFilename(
+    "transposeOutput",
+    cll::desc("With -externalSort, also write the transposed graph here"));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads for -externalSort (default all)"),
+    cll::init(0));
 
 union dataTy {
   int64_t ival;
@@ -236,10 +274,686 @@ go_edgesSorted(std::istream& input, uint64_t numNodes) {
   }
 }
 
+/* External sort
+ *
+ * The edge list is parsed a block at a time. Edges accumulate in a run
+ * buffer of -memoryLimitMB; when it is full the run is sorted in parallel
+ * and written to -tmpDir twice, once sorted by source and once by
+ * destination for the transpose. Degrees are counted while parsing, so the
+ * out index array of each output is known before any destination is
+ * written. Each output is then produced by a parallel k-way merge of its
+ * runs: the nodes are split into ranges of about the same number of edges,
+ * every range finds its slice of each run by binary search and merges the
+ * slices into its region of the output file.
+ *
+ * The outputs are version 1 .gr files, which is also the CSR topology file
+ * format of RDGs, so graph-convert -gr2kg turns them into an RDG without
+ * reading them into memory.
+ */
+
+/// Edges are packed as (src << 32) | dst so that sorting the keys sorts by
+/// source and then by destination
+using EdgeKey = uint64_t;
+
+constexpr EdgeKey
+MakeEdgeKey(uint64_t src, uint64_t dst) {
+  return (src << 32) | dst;
+}
+
+constexpr uint64_t
+EdgeKeySrc(EdgeKey key) {
+  return key >> 32;
+}
+
+constexpr uint32_t
+EdgeKeyDst(EdgeKey key) {
+  return static_cast<uint32_t>(key);
+}
+
+constexpr EdgeKey
+TransposeEdgeKey(EdgeKey key) {
+  return (key << 32) | (key >> 32);
+}
+
+/// Version 1 .gr files have 32 bit destinations
+constexpr uint64_t kMaxExternalNodes = uint64_t{1} << 32;
+/// Input is parsed in blocks of this size
+constexpr size_t kParseBlockBytes = size_t{64} << 20;
+/// Files are read and written in pieces of this size
+constexpr size_t kIOPieceBytes = size_t{64} << 20;
+/// Each merge reads ahead this many keys of every run
+constexpr size_t kMergeBufferKeys = size_t{1} << 16;
+/// Each merge buffers this many destinations before writing them
+constexpr size_t kMergeOutputDests = size_t{1} << 18;
+
+struct FileDescriptor {
+  int fd{-1};
+
+  FileDescriptor() = default;
+  explicit FileDescriptor(int fd_) : fd(fd_) {}
+  FileDescriptor(FileDescriptor&& other) noexcept
+      : fd(std::exchange(other.fd, -1)) {}
+  FileDescriptor& operator=(FileDescriptor&&) = delete;
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+  ~FileDescriptor() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+};
+
+katana::Result<FileDescriptor>
+OpenFile(const std::string& path, int flags) {
+  FileDescriptor file(open(path.c_str(), flags, 0666));
+  if (file.fd < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "opening {}: {}", path,
+        katana::ResultErrno().message());
+  }
+  return katana::Result<FileDescriptor>(std::move(file));
+}
+
+katana::Result<void>
+ReadPiece(int fd, uint64_t offset, uint64_t size, void* data) {
+  auto* bytes = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    ssize_t got = pread(fd, bytes, size, offset);
+    if (got == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "unexpected end of file");
+    }
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "failed to read: {}",
+          katana::ResultErrno().message());
+    }
+    bytes += got;
+    offset += got;
+    size -= got;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+WritePiece(int fd, uint64_t offset, uint64_t size, const void* data) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    ssize_t put = pwrite(fd, bytes, size, offset);
+    if (put < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError, "failed to write: {}",
+          katana::ResultErrno().message());
+    }
+    bytes += put;
+    offset += put;
+    size -= put;
+  }
+  return katana::ResultSuccess();
+}
+
+/// Write size bytes at offset in pieces that go out in parallel
+katana::Result<void>
+ParallelWrite(int fd, uint64_t offset, uint64_t size, const void* data) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t num_pieces = (size + kIOPieceBytes - 1) / kIOPieceBytes;
+  std::vector<katana::Result<void>> results(
+      num_pieces, katana::ResultSuccess());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_pieces),
+      [&](uint64_t piece) {
+        uint64_t begin = piece * kIOPieceBytes;
+        uint64_t len = std::min<uint64_t>(kIOPieceBytes, size - begin);
+        results[piece] = WritePiece(fd, offset + begin, len, bytes + begin);
+      },
+      katana::chunk_size<1>(), katana::no_stats());
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Per-node edge counts whose size follows the largest node id seen
+class DegreeCounts {
+  katana::NUMAArray<std::atomic<uint64_t>> counts_;
+
+public:
+  uint64_t size() const { return counts_.size(); }
+
+  void Grow(uint64_t num_nodes) {
+    if (num_nodes <= counts_.size()) {
+      return;
+    }
+    num_nodes = std::max<uint64_t>(num_nodes, 2 * counts_.size());
+    katana::NUMAArray<std::atomic<uint64_t>> grown;
+    grown.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t c = n < counts_.size()
+                           ? counts_[n].load(std::memory_order_relaxed)
+                           : 0;
+          grown[n].store(c, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    counts_ = std::move(grown);
+  }
+
+  void Increment(uint64_t n) {
+    counts_[n].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Fill out_indexes with the out index array of a .gr file, the end of
+  /// the edges of every node
+  void OutIndexes(
+      uint64_t num_nodes, katana::NUMAArray<uint64_t>* out_indexes) const {
+    out_indexes->allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          (*out_indexes)[n] = n < counts_.size()
+                                  ? counts_[n].load(std::memory_order_relaxed)
+                                  : 0;
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        out_indexes->begin(), out_indexes->end(), out_indexes->begin());
+  }
+};
+
+/// Parse the edges in [begin, end), which holds whole lines. Lines that do
+/// not start with a node id, like comments, are skipped. Anything after the
+/// destination, like edge data, is ignored.
+katana::Result<void>
+ParseEdges(
+    const char* begin, const char* end, std::vector<EdgeKey>* edges,
+    uint64_t* max_id) {
+  auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+  auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+  auto parse_id = [&](const char** pos, uint64_t* id) {
+    if (*pos == end || !is_digit(**pos)) {
+      return false;
+    }
+    uint64_t value = 0;
+    while (*pos != end && is_digit(**pos)) {
+      value = value * 10 + (**pos - '0');
+      if (value >= kMaxExternalNodes) {
+        return false;
+      }
+      ++*pos;
+    }
+    *id = value;
+    return true;
+  };
+
+  const char* pos = begin;
+  while (pos != end) {
+    const char* line_end = std::find(pos, end, '\n');
+    while (pos != line_end && is_space(*pos)) {
+      ++pos;
+    }
+    if (pos != line_end && *pos == 'p') {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented,
+          "-externalSort does not read DIMACS problem lines");
+    }
+    if (pos != line_end && *pos == 'a') {
+      ++pos;
+      while (pos != line_end && is_space(*pos)) {
+        ++pos;
+      }
+    }
+    if (pos != line_end && is_digit(*pos)) {
+      uint64_t src = 0;
+      uint64_t dst = 0;
+      bool ok = parse_id(&pos, &src);
+      ok = ok && pos != line_end && is_space(*pos);
+      while (ok && pos != line_end && is_space(*pos)) {
+        ++pos;
+      }
+      ok = ok && parse_id(&pos, &dst);
+      if (!ok) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "malformed edge or node id of {} or more: {}", kMaxExternalNodes,
+            std::string(begin, line_end).substr(0, 80));
+      }
+      edges->emplace_back(MakeEdgeKey(src, dst));
+      *max_id = std::max(*max_id, std::max(src, dst));
+    }
+    pos = line_end == end ? end : line_end + 1;
+  }
+  return katana::ResultSuccess();
+}
+
+/// The sorted runs of one output. The run files are removed with this.
+struct SortedRuns {
+  std::vector<std::string> paths;
+  std::vector<uint64_t> sizes;
+
+  SortedRuns() = default;
+  SortedRuns(SortedRuns&&) = default;
+  ~SortedRuns() {
+    for (const auto& path : paths) {
+      unlink(path.c_str());
+    }
+  }
+};
+
+class ExternalSorter {
+  katana::NUMAArray<EdgeKey> run_;
+  uint64_t run_size_{0};
+  DegreeCounts out_degrees_;
+  DegreeCounts in_degrees_;
+  uint64_t max_id_{0};
+  uint64_t num_edges_{0};
+  bool any_edge_{false};
+  SortedRuns out_runs_;
+  SortedRuns in_runs_;
+
+  katana::Result<void> WriteRun(SortedRuns* runs, const std::string& suffix) {
+    katana::ParallelSTL::sort(run_.begin(), run_.begin() + run_size_);
+    std::string path = tmpDir + "/graph-convert-huge." +
+                       std::to_string(getpid()) + ".run" +
+                       std::to_string(runs->paths.size()) + "." + suffix;
+    auto file =
+        KATANA_CHECKED(OpenFile(path, O_WRONLY | O_CREAT | O_TRUNC));
+    runs->paths.emplace_back(path);
+    runs->sizes.emplace_back(run_size_);
+    return ParallelWrite(
+        file.fd, 0, run_size_ * sizeof(EdgeKey), run_.data());
+  }
+
+public:
+  explicit ExternalSorter(uint64_t run_capacity) {
+    run_.allocateInterleaved(run_capacity);
+  }
+
+  uint64_t capacity() const { return run_.size(); }
+  uint64_t num_edges() const { return num_edges_; }
+
+  uint64_t num_nodes() const {
+    return std::max<uint64_t>(numNodes, any_edge_ ? max_id_ + 1 : 0);
+  }
+
+  /// Sort the buffered edges and write them out as a run of each output
+  katana::Result<void> Flush() {
+    if (run_size_ == 0) {
+      return katana::ResultSuccess();
+    }
+    KATANA_CHECKED(WriteRun(&out_runs_, "out"));
+    katana::do_all(
+        katana::iterate(uint64_t{0}, run_size_),
+        [&](uint64_t i) { run_[i] = TransposeEdgeKey(run_[i]); },
+        katana::no_stats());
+    KATANA_CHECKED(WriteRun(&in_runs_, "in"));
+    std::cout << "Wrote run " << out_runs_.paths.size() << " of " << run_size_
+              << " edges\n";
+    run_size_ = 0;
+    return katana::ResultSuccess();
+  }
+
+  /// Add the edges parsed from one block of input; they fit in the run
+  /// buffer if it is empty
+  katana::Result<void> Add(
+      const katana::PerThreadStorage<std::vector<EdgeKey>>& parsed,
+      uint64_t max_id) {
+    uint64_t total = 0;
+    for (unsigned i = 0; i < parsed.size(); ++i) {
+      total += parsed.getRemote(i)->size();
+    }
+    if (total == 0) {
+      return katana::ResultSuccess();
+    }
+    if (run_size_ + total > run_.size()) {
+      KATANA_CHECKED(Flush());
+    }
+    KATANA_LOG_ASSERT(run_size_ + total <= run_.size());
+
+    max_id_ = std::max(max_id_, max_id);
+    any_edge_ = true;
+    out_degrees_.Grow(max_id_ + 1);
+    in_degrees_.Grow(max_id_ + 1);
+
+    std::vector<uint64_t> offsets(parsed.size() + 1, run_size_);
+    for (unsigned i = 0; i < parsed.size(); ++i) {
+      offsets[i + 1] = offsets[i] + parsed.getRemote(i)->size();
+    }
+    katana::on_each([&](unsigned tid, unsigned) {
+      const std::vector<EdgeKey>& local = *parsed.getRemote(tid);
+      for (size_t i = 0; i < local.size(); ++i) {
+        run_[offsets[tid] + i] = local[i];
+        out_degrees_.Increment(EdgeKeySrc(local[i]));
+        in_degrees_.Increment(EdgeKeyDst(local[i]));
+      }
+    });
+    run_size_ += total;
+    num_edges_ += total;
+    return katana::ResultSuccess();
+  }
+
+  SortedRuns& out_runs() { return out_runs_; }
+  SortedRuns& in_runs() { return in_runs_; }
+  const DegreeCounts& out_degrees() const { return out_degrees_; }
+  const DegreeCounts& in_degrees() const { return in_degrees_; }
+};
+
+/// Parse the whole input into sorted runs
+katana::Result<void>
+ParseIntoRuns(std::istream& input, ExternalSorter* sorter) {
+  // a block never has more edges than an empty run buffer holds since every
+  // edge but the last one takes at least 4 bytes of input ("0 1\n")
+  size_t block_bytes =
+      std::min<uint64_t>(kParseBlockBytes, (sorter->capacity() - 1) * 4);
+  std::vector<char> block(block_bytes);
+  size_t carried = 0;
+  katana::PerThreadStorage<std::vector<EdgeKey>> parsed;
+
+  while (true) {
+    input.read(block.data() + carried, block.size() - carried);
+    size_t filled = carried + input.gcount();
+    bool at_end = input.eof() || input.gcount() == 0;
+    if (filled == 0) {
+      break;
+    }
+    // only whole lines are parsed, the rest is carried into the next block
+    size_t parse_end = filled;
+    if (!at_end) {
+      auto last_newline =
+          std::find(block.rbegin() + (block.size() - filled), block.rend(),
+                    '\n');
+      if (last_newline == block.rend()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "line of more than {} bytes in input", block.size());
+      }
+      parse_end = block.rend() - last_newline;
+    }
+
+    // each thread parses the lines that start in its share of the block
+    const char* data = block.data();
+    std::vector<katana::Result<void>> results(
+        katana::getActiveThreads(), katana::ResultSuccess());
+    katana::GReduceMax<uint64_t> max_id;
+    katana::on_each([&](unsigned tid, unsigned total) {
+      auto line_start = [&](size_t at) -> size_t {
+        if (at == 0 || at >= parse_end) {
+          return std::min(at, parse_end);
+        }
+        const char* nl = std::find(data + at - 1, data + parse_end, '\n');
+        return nl == data + parse_end ? parse_end : nl - data + 1;
+      };
+      size_t begin = line_start(parse_end * tid / total);
+      size_t end = line_start(parse_end * (tid + 1) / total);
+      std::vector<EdgeKey>& local = *parsed.getLocal();
+      local.clear();
+      uint64_t local_max = 0;
+      results[tid] =
+          ParseEdges(data + begin, data + end, &local, &local_max);
+      max_id.update(local_max);
+    });
+    for (auto& res : results) {
+      if (!res) {
+        return res.error();
+      }
+    }
+    KATANA_CHECKED(sorter->Add(parsed, max_id.reduce()));
+
+    carried = filled - parse_end;
+    std::copy(
+        block.begin() + parse_end, block.begin() + filled, block.begin());
+    if (at_end) {
+      break;
+    }
+  }
+  return sorter->Flush();
+}
+
+/// Reads one slice of a sorted run in order
+class RunCursor {
+  int fd_;
+  uint64_t next_;
+  uint64_t end_;
+  std::vector<EdgeKey> buffer_;
+  size_t buffer_pos_{0};
+
+public:
+  RunCursor(int fd, uint64_t begin, uint64_t end)
+      : fd_(fd), next_(begin), end_(end) {}
+
+  bool empty() const {
+    return buffer_pos_ == buffer_.size() && next_ == end_;
+  }
+
+  /// Make sure that the next key is buffered; the cursor must not be empty
+  katana::Result<void> Fill() {
+    if (buffer_pos_ < buffer_.size()) {
+      return katana::ResultSuccess();
+    }
+    uint64_t count = std::min<uint64_t>(kMergeBufferKeys, end_ - next_);
+    buffer_.resize(count);
+    buffer_pos_ = 0;
+    KATANA_CHECKED(ReadPiece(
+        fd_, next_ * sizeof(EdgeKey), count * sizeof(EdgeKey),
+        buffer_.data()));
+    next_ += count;
+    return katana::ResultSuccess();
+  }
+
+  EdgeKey peek() const { return buffer_[buffer_pos_]; }
+  void pop() { ++buffer_pos_; }
+};
+
+/// The position of the first key of a sorted run that is not less than key
+katana::Result<uint64_t>
+RunLowerBound(int fd, uint64_t run_size, EdgeKey key) {
+  uint64_t lo = 0;
+  uint64_t hi = run_size;
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    EdgeKey value = 0;
+    KATANA_CHECKED(
+        ReadPiece(fd, mid * sizeof(EdgeKey), sizeof(EdgeKey), &value));
+    if (value < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/// Merge the edges of the nodes in [node_begin, node_end) from every run and
+/// write their destinations to the output at the edge offset of node_begin
+katana::Result<void>
+MergeRange(
+    const SortedRuns& runs, const std::vector<FileDescriptor>& run_files,
+    uint64_t num_nodes, uint64_t node_begin, uint64_t node_end,
+    uint64_t edge_begin, uint64_t edge_end, int out_fd, uint64_t dests_start) {
+  std::vector<RunCursor> cursors;
+  for (size_t r = 0; r < runs.paths.size(); ++r) {
+    int fd = run_files[r].fd;
+    uint64_t begin = KATANA_CHECKED(
+        RunLowerBound(fd, runs.sizes[r], MakeEdgeKey(node_begin, 0)));
+    uint64_t end = runs.sizes[r];
+    if (node_end != num_nodes) {
+      end = KATANA_CHECKED(
+          RunLowerBound(fd, runs.sizes[r], MakeEdgeKey(node_end, 0)));
+    }
+    cursors.emplace_back(fd, begin, end);
+  }
+
+  using HeapEntry = std::pair<EdgeKey, size_t>;
+  std::priority_queue<
+      HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>>
+      heap;
+  for (size_t r = 0; r < cursors.size(); ++r) {
+    if (!cursors[r].empty()) {
+      KATANA_CHECKED(cursors[r].Fill());
+      heap.emplace(cursors[r].peek(), r);
+    }
+  }
+
+  std::vector<uint32_t> dests;
+  dests.reserve(kMergeOutputDests);
+  uint64_t written = edge_begin;
+  auto flush = [&]() -> katana::Result<void> {
+    if (written + dests.size() > edge_end) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "runs have more edges than were counted");
+    }
+    KATANA_CHECKED(WritePiece(
+        out_fd, dests_start + written * sizeof(uint32_t),
+        dests.size() * sizeof(uint32_t), dests.data()));
+    written += dests.size();
+    dests.clear();
+    return katana::ResultSuccess();
+  };
+
+  while (!heap.empty()) {
+    auto [key, r] = heap.top();
+    heap.pop();
+    dests.emplace_back(EdgeKeyDst(key));
+    if (dests.size() == kMergeOutputDests) {
+      KATANA_CHECKED(flush());
+    }
+    cursors[r].pop();
+    if (!cursors[r].empty()) {
+      KATANA_CHECKED(cursors[r].Fill());
+      heap.emplace(cursors[r].peek(), r);
+    }
+  }
+  KATANA_CHECKED(flush());
+  if (written != edge_end) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "runs have fewer edges than were counted");
+  }
+  return katana::ResultSuccess();
+}
+
+/// Write the .gr file for one output by merging its sorted runs
+katana::Result<void>
+MergeRuns(
+    const SortedRuns& runs, const DegreeCounts& degrees, uint64_t num_nodes,
+    uint64_t num_edges, const std::string& path) {
+  katana::NUMAArray<uint64_t> out_indexes;
+  degrees.OutIndexes(num_nodes, &out_indexes);
+
+  katana::CSRTopologyHeader header;
+  header.version = 1;
+  header.edge_type_size = 0;
+  header.num_nodes = num_nodes;
+  header.num_edges = num_edges;
+
+  auto out = KATANA_CHECKED(OpenFile(path, O_RDWR | O_CREAT | O_TRUNC));
+  if (ftruncate(out.fd, katana::CSRTopologyFileSize(header)) != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::LocalStorageError, "resizing {}: {}", path,
+        katana::ResultErrno().message());
+  }
+  KATANA_CHECKED(WritePiece(out.fd, 0, sizeof(header), &header));
+  KATANA_CHECKED(ParallelWrite(
+      out.fd, sizeof(header), num_nodes * sizeof(uint64_t),
+      out_indexes.data()));
+  uint64_t dests_start = sizeof(header) + num_nodes * sizeof(uint64_t);
+
+  std::vector<FileDescriptor> run_files;
+  for (const auto& run_path : runs.paths) {
+    run_files.emplace_back(KATANA_CHECKED(OpenFile(run_path, O_RDONLY)));
+  }
+
+  // split the nodes into ranges of about the same number of edges
+  uint64_t num_ranges = uint64_t{4} * katana::getActiveThreads();
+  std::vector<uint64_t> range_nodes(num_ranges + 1, num_nodes);
+  range_nodes[0] = 0;
+  for (uint64_t i = 1; i < num_ranges; ++i) {
+    uint64_t target = num_edges / num_ranges * i;
+    uint64_t n =
+        std::lower_bound(out_indexes.begin(), out_indexes.end(), target) -
+        out_indexes.begin() + 1;
+    range_nodes[i] = std::max(range_nodes[i - 1], std::min(n, num_nodes));
+  }
+  auto edge_offset = [&](uint64_t n) {
+    return n == 0 ? uint64_t{0} : out_indexes[n - 1];
+  };
+
+  std::vector<katana::Result<void>> results(
+      num_ranges, katana::ResultSuccess());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_ranges),
+      [&](uint64_t i) {
+        uint64_t begin = range_nodes[i];
+        uint64_t end = range_nodes[i + 1];
+        if (begin == end) {
+          return;
+        }
+        results[i] = MergeRange(
+            runs, run_files, num_nodes, begin, end, edge_offset(begin),
+            edge_offset(end), out.fd, dests_start);
+      },
+      katana::chunk_size<1>(), katana::steal(), katana::no_stats());
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+ConvertExternal(std::istream& input) {
+  uint64_t run_capacity = memoryLimitMB * (uint64_t{1} << 20) / sizeof(EdgeKey);
+  if (run_capacity == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "-memoryLimitMB must be positive");
+  }
+  if (numNodes > kMaxExternalNodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "-externalSort supports at most {} nodes", kMaxExternalNodes);
+  }
+
+  ExternalSorter sorter(run_capacity);
+  auto start = std::chrono::steady_clock::now();
+  KATANA_CHECKED(ParseIntoRuns(input, &sorter));
+  auto parsed = std::chrono::steady_clock::now();
+  std::cout << "Sorted " << sorter.num_edges() << " edges into "
+            << sorter.out_runs().paths.size() << " runs in "
+            << std::chrono::duration_cast<std::chrono::seconds>(parsed - start)
+                   .count()
+            << " s\n";
+
+  uint64_t num_nodes = sorter.num_nodes();
+  KATANA_CHECKED(MergeRuns(
+      sorter.out_runs(), sorter.out_degrees(), num_nodes, sorter.num_edges(),
+      outputFilename));
+  if (!transposeFilename.empty()) {
+    KATANA_CHECKED(MergeRuns(
+        sorter.in_runs(), sorter.in_degrees(), num_nodes, sorter.num_edges(),
+        transposeFilename));
+  }
+  auto merged = std::chrono::steady_clock::now();
+  std::cout << "Merged runs in "
+            << std::chrono::duration_cast<std::chrono::seconds>(
+                   merged - parsed)
+                   .count()
+            << " s\n";
+  return katana::ResultSuccess();
+}
+
 int
 main(int argc, char** argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
-  std::cout << "Data will be " << (useSmallData ? 4 : 8) << " Bytes\n";
 
   std::ifstream infile(inputFilename, std::ios_base::in);
   if (!infile) {
@@ -247,6 +961,18 @@ main(int argc, char** argv) {
     return 1;
   }
 
+  if (externalSort) {
+    katana::SharedMemSys sys;
+    unsigned threads = numThreads;
+    katana::setActiveThreads(
+        threads ? threads : std::numeric_limits<unsigned>::max());
+    if (auto res = ConvertExternal(infile); !res) {
+      KATANA_LOG_FATAL("external sort failed: {}", res.error());
+    }
+    return 0;
+  }
+
+  std::cout << "Data will be " << (useSmallData ? 4 : 8) << " Bytes\n";
   if (numNodes > 0 && edgesSorted) {
     go_edgesSorted(infile, numNodes);
   } else {
@@ -0,0 +1,565 @@
+#include "graph-properties-convert-csv.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/ErrorCode.h"
+#include "katana/FileView.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Result.h"
+
+using katana::CSVImportOptions;
+using katana::GraphComponents;
+
+namespace {
+
+/*********************************/
+/* Functions for parsing numbers */
+/*********************************/
+
+/// Converts the 8 ASCII digits at \p p with a few multiplies on a 64 bit word
+/// rather than a loop over the characters; returns false if any of them is not
+/// a digit
+bool
+ParseEightDigits(const char* p, uint64_t* out) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t val;
+  std::memcpy(&val, p, sizeof(val));
+  // every byte is in ['0', '9'] iff neither adding 0x46 nor subtracting 0x30
+  // sets its high bit
+  if ((((val + 0x4646464646464646ULL) | (val - 0x3030303030303030ULL)) &
+       0x8080808080808080ULL) != 0) {
+    return false;
+  }
+  // combine adjacent digits, then pairs, then quads; the first character is
+  // the lowest byte
+  val -= 0x3030303030303030ULL;
+  val = (val * 10 + (val >> 8)) & 0x00FF00FF00FF00FFULL;
+  val = (val * 100 + (val >> 16)) & 0x0000FFFF0000FFFFULL;
+  val = (val * 10000 + (val >> 32)) & 0x00000000FFFFFFFFULL;
+  *out = val;
+  return true;
+#else
+  uint64_t val = 0;
+  for (int i = 0; i < 8; ++i) {
+    if (p[i] < '0' || p[i] > '9') {
+      return false;
+    }
+    val = val * 10 + (p[i] - '0');
+  }
+  *out = val;
+  return true;
+#endif
+}
+
+/// Parses the whole of [begin, end) as a decimal integer
+bool
+ParseInteger(const char* begin, const char* end, int64_t* out) {
+  bool negative = false;
+  if (begin < end && (*begin == '-' || *begin == '+')) {
+    negative = *begin == '-';
+    ++begin;
+  }
+  size_t len = end - begin;
+  // 19 digits always fit in a uint64_t
+  if (len == 0 || len > 19) {
+    return false;
+  }
+
+  uint64_t val = 0;
+  const char* p = begin;
+  for (uint64_t eight; end - p >= 8 && ParseEightDigits(p, &eight); p += 8) {
+    val = val * 100000000 + eight;
+  }
+  for (; p < end; ++p) {
+    if (*p < '0' || *p > '9') {
+      return false;
+    }
+    val = val * 10 + (*p - '0');
+  }
+
+  constexpr auto kMax =
+      static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+  if (val > kMax + (negative ? 1 : 0)) {
+    return false;
+  }
+  *out = negative ? static_cast<int64_t>(0 - val) : static_cast<int64_t>(val);
+  return true;
+}
+
+bool
+ParseDouble(const char* begin, const char* end, double* out) {
+  // strtod needs a terminated string; the field is followed by more of the
+  // file, or nothing at all
+  char buf[64];
+  size_t len = end - begin;
+  if (len == 0 || len >= sizeof(buf)) {
+    return false;
+  }
+  std::memcpy(buf, begin, len);
+  buf[len] = '\0';
+  char* parsed_end = nullptr;
+  *out = std::strtod(buf, &parsed_end);
+  return parsed_end == buf + len;
+}
+
+/****************************************/
+/* Functions for parsing delimited text */
+/****************************************/
+
+/// The values of one property column. Doubles are stored as their bit
+/// pattern so that a column can switch from integers to doubles in place the
+/// first time a value is not integral.
+struct Column {
+  std::vector<int64_t> values;
+  std::vector<uint8_t> valid;
+  bool is_double{false};
+
+  static int64_t DoubleBits(double d) {
+    int64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+  }
+
+  static double BitsDouble(int64_t bits) {
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+  }
+
+  void MakeDouble() {
+    if (is_double) {
+      return;
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = DoubleBits(static_cast<double>(values[i]));
+    }
+    is_double = true;
+  }
+
+  void AppendNull() {
+    values.emplace_back(0);
+    valid.emplace_back(0);
+  }
+
+  void Append(int64_t value) {
+    values.emplace_back(
+        is_double ? DoubleBits(static_cast<double>(value)) : value);
+    valid.emplace_back(1);
+  }
+
+  void Append(double value) {
+    MakeDouble();
+    values.emplace_back(DoubleBits(value));
+    valid.emplace_back(1);
+  }
+};
+
+/// The rows of one byte range of a file
+struct ParsedChunk {
+  /// node id for a node file, edge source for an edge file
+  std::vector<uint32_t> ids;
+  /// only used for edge files
+  std::vector<uint32_t> dests;
+  std::vector<Column> columns;
+  /// one more than the largest node id seen
+  uint64_t num_nodes{0};
+  std::string error;
+};
+
+struct ParsedFile {
+  std::vector<std::string> column_names;
+  std::vector<ParsedChunk> chunks;
+};
+
+std::string_view
+StripQuotes(std::string_view field) {
+  if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+    return field.substr(1, field.size() - 2);
+  }
+  return field;
+}
+
+std::vector<std::string_view>
+SplitLine(std::string_view line, char delimiter) {
+  std::vector<std::string_view> fields;
+  size_t start = 0;
+  for (size_t pos = line.find(delimiter); pos != std::string_view::npos;
+       pos = line.find(delimiter, start)) {
+    fields.emplace_back(line.substr(start, pos - start));
+    start = pos + 1;
+  }
+  fields.emplace_back(line.substr(start));
+  return fields;
+}
+
+/// Returns the line starting at \p pos without its line terminator and moves
+/// \p pos past it
+std::string_view
+NextLine(std::string_view text, size_t* pos) {
+  size_t eol = text.find('\n', *pos);
+  if (eol == std::string_view::npos) {
+    eol = text.size();
+  }
+  std::string_view line = text.substr(*pos, eol - *pos);
+  *pos = std::min(eol + 1, text.size());
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+bool
+IsSkipped(std::string_view line) {
+  return line.empty() || line.front() == '#';
+}
+
+/// Parses the lines of one byte range. Each line has \p num_id_columns node
+/// ids followed by \p num_columns properties.
+void
+ParseChunk(
+    std::string_view text, size_t begin, size_t end, size_t num_id_columns,
+    size_t num_columns, char delimiter, ParsedChunk* chunk) {
+  chunk->columns.resize(num_columns);
+
+  for (size_t pos = begin; pos < end;) {
+    size_t line_start = pos;
+    std::string_view line = NextLine(text, &pos);
+    if (IsSkipped(line)) {
+      continue;
+    }
+
+    std::vector<std::string_view> fields = SplitLine(line, delimiter);
+    if (fields.size() != num_id_columns + num_columns) {
+      chunk->error = fmt::format(
+          "byte {}: expected {} fields but found {}", line_start,
+          num_id_columns + num_columns, fields.size());
+      return;
+    }
+
+    for (size_t i = 0; i < num_id_columns; ++i) {
+      std::string_view field = StripQuotes(fields[i]);
+      int64_t id;
+      if (!ParseInteger(field.data(), field.data() + field.size(), &id) ||
+          id < 0 || id > std::numeric_limits<uint32_t>::max()) {
+        chunk->error = fmt::format(
+            "byte {}: {} is not a valid node id", line_start, field);
+        return;
+      }
+      auto node = static_cast<uint32_t>(id);
+      if (i == 0) {
+        chunk->ids.emplace_back(node);
+      } else {
+        chunk->dests.emplace_back(node);
+      }
+      chunk->num_nodes =
+          std::max(chunk->num_nodes, static_cast<uint64_t>(node) + 1);
+    }
+
+    for (size_t i = 0; i < num_columns; ++i) {
+      std::string_view field = StripQuotes(fields[num_id_columns + i]);
+      Column& column = chunk->columns[i];
+      const char* field_end = field.data() + field.size();
+      int64_t int_value;
+      double double_value;
+      if (field.empty()) {
+        column.AppendNull();
+      } else if (ParseInteger(field.data(), field_end, &int_value)) {
+        column.Append(int_value);
+      } else if (ParseDouble(field.data(), field_end, &double_value)) {
+        column.Append(double_value);
+      } else {
+        chunk->error =
+            fmt::format("byte {}: {} is not a number", line_start, field);
+        return;
+      }
+    }
+  }
+}
+
+/// Maps \p path, reads the header and parses the rest of the file in
+/// parallel, one task per byte range of about options.chunk_bytes ending at a
+/// line boundary
+katana::Result<ParsedFile>
+ParseFile(
+    const std::string& path, size_t num_id_columns, const char* default_name,
+    const CSVImportOptions& options) {
+  katana::FileView fv;
+  KATANA_CHECKED_CONTEXT(fv.Bind(path, true), "mapping {}", path);
+  std::string_view text(fv.ptr<char>(), fv.size());
+
+  ParsedFile parsed;
+
+  // the first line that is not skipped gives the number of columns and,
+  // with a header, their names
+  size_t body_begin = 0;
+  std::string_view first_line;
+  for (size_t pos = 0; pos < text.size();) {
+    size_t line_start = pos;
+    first_line = NextLine(text, &pos);
+    if (!IsSkipped(first_line)) {
+      body_begin = options.has_header ? pos : line_start;
+      break;
+    }
+    body_begin = pos;
+  }
+  std::vector<std::string_view> first_fields =
+      SplitLine(first_line, options.delimiter);
+  if (IsSkipped(first_line)) {
+    first_fields.clear();
+  } else if (first_fields.size() < num_id_columns) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{}: expected at least {} columns but found {}", path, num_id_columns,
+        first_fields.size());
+  }
+  for (size_t i = num_id_columns; i < first_fields.size(); ++i) {
+    parsed.column_names.emplace_back(
+        options.has_header ? std::string(StripQuotes(first_fields[i]))
+                           : fmt::format("{}{}", default_name, i));
+  }
+
+  std::vector<size_t> boundaries{body_begin};
+  size_t chunk_bytes = std::max<size_t>(options.chunk_bytes, 1);
+  while (boundaries.back() < text.size()) {
+    size_t next = boundaries.back() + chunk_bytes;
+    if (next < text.size()) {
+      next = text.find('\n', next - 1);
+      next = next == std::string_view::npos ? text.size() : next + 1;
+    }
+    boundaries.emplace_back(std::min(next, text.size()));
+  }
+
+  size_t num_columns = parsed.column_names.size();
+  parsed.chunks.resize(boundaries.size() - 1);
+  katana::do_all(
+      katana::iterate(size_t{0}, parsed.chunks.size()),
+      [&](size_t c) {
+        ParseChunk(
+            text, boundaries[c], boundaries[c + 1], num_id_columns,
+            num_columns, options.delimiter, &parsed.chunks[c]);
+      },
+      katana::steal(), katana::no_stats());
+
+  for (const auto& chunk : parsed.chunks) {
+    if (!chunk.error.empty()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "{}: {}", path, chunk.error);
+    }
+  }
+
+  return parsed;
+}
+
+/// Returns the index of the first row of each chunk, and the total number of
+/// rows at the end
+std::vector<size_t>
+RowOffsets(const ParsedFile& parsed) {
+  std::vector<size_t> offsets(parsed.chunks.size() + 1);
+  for (size_t c = 0; c < parsed.chunks.size(); ++c) {
+    offsets[c + 1] = offsets[c] + parsed.chunks[c].ids.size();
+  }
+  return offsets;
+}
+
+/// Builds a table with one array per column whose row \p row_of(i) is row i
+/// of the file
+template <typename RowFn>
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildTable(const ParsedFile& parsed, size_t num_rows, RowFn row_of) {
+  std::vector<size_t> offsets = RowOffsets(parsed);
+  arrow::FieldVector fields;
+  arrow::ArrayVector arrays;
+
+  for (size_t col = 0; col < parsed.column_names.size(); ++col) {
+    bool is_double = std::any_of(
+        parsed.chunks.begin(), parsed.chunks.end(),
+        [col](const ParsedChunk& chunk) {
+          return chunk.columns[col].is_double;
+        });
+
+    auto fill = [&](auto& builder, auto convert) {
+      katana::do_all(
+          katana::iterate(size_t{0}, parsed.chunks.size()),
+          [&](size_t c) {
+            const Column& column = parsed.chunks[c].columns[col];
+            for (size_t i = 0; i < column.values.size(); ++i) {
+              if (column.valid[i]) {
+                builder[row_of(offsets[c] + i)] =
+                    convert(column, column.values[i]);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+      return builder.Finalize();
+    };
+
+    std::shared_ptr<arrow::Array> array;
+    if (is_double) {
+      katana::ArrowRandomAccessBuilder<arrow::DoubleType> builder(num_rows);
+      array = KATANA_CHECKED(
+          fill(builder, [](const Column& column, int64_t value) {
+            return column.is_double ? Column::BitsDouble(value)
+                                    : static_cast<double>(value);
+          }));
+      fields.emplace_back(
+          arrow::field(parsed.column_names[col], arrow::float64()));
+    } else {
+      katana::ArrowRandomAccessBuilder<arrow::Int64Type> builder(num_rows);
+      array = KATANA_CHECKED(
+          fill(builder, [](const Column&, int64_t value) { return value; }));
+      fields.emplace_back(
+          arrow::field(parsed.column_names[col], arrow::int64()));
+    }
+    arrays.emplace_back(std::move(array));
+  }
+
+  return arrow::Table::Make(arrow::schema(fields), arrays, num_rows);
+}
+
+std::shared_ptr<arrow::Table>
+EmptyTable(size_t num_rows) {
+  return arrow::Table::Make(
+      arrow::schema(arrow::FieldVector{}), arrow::ArrayVector{}, num_rows);
+}
+
+}  // end of unnamed namespace
+
+katana::Result<GraphComponents>
+katana::ConvertCSV(
+    const std::string& edge_file, const std::string& node_file,
+    const CSVImportOptions& options) {
+  ParsedFile edges =
+      KATANA_CHECKED(ParseFile(edge_file, 2, "edge_column", options));
+  ParsedFile nodes;
+  if (!node_file.empty()) {
+    nodes = KATANA_CHECKED(ParseFile(node_file, 1, "node_column", options));
+  }
+
+  uint64_t num_nodes = 0;
+  for (const ParsedFile* parsed : {&edges, &nodes}) {
+    for (const auto& chunk : parsed->chunks) {
+      num_nodes = std::max(num_nodes, chunk.num_nodes);
+    }
+  }
+  std::vector<size_t> edge_offsets = RowOffsets(edges);
+  size_t num_edges = edge_offsets.back();
+
+  // gather sources and destinations
+  katana::NUMAArray<uint32_t> sources;
+  katana::NUMAArray<uint32_t> dests_in_file_order;
+  sources.allocateInterleaved(num_edges);
+  dests_in_file_order.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, edges.chunks.size()),
+      [&](size_t c) {
+        const ParsedChunk& chunk = edges.chunks[c];
+        std::copy(
+            chunk.ids.begin(), chunk.ids.end(), &sources[edge_offsets[c]]);
+        std::copy(
+            chunk.dests.begin(), chunk.dests.end(),
+            &dests_in_file_order[edge_offsets[c]]);
+      },
+      katana::steal(), katana::no_stats());
+
+  // count degrees and turn them into CSR offsets
+  std::vector<std::atomic<uint64_t>> degrees(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        degrees[sources[e]].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        adj_indices[n] = degrees[n].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  // place edges; degrees becomes the insertion cursor of each node
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        degrees[n].store(
+            n == 0 ? 0 : adj_indices[n - 1], std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::NUMAArray<uint64_t> file_order;
+  file_order.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        uint64_t pos =
+            degrees[sources[e]].fetch_add(1, std::memory_order_relaxed);
+        file_order[pos] = e;
+      },
+      katana::no_stats());
+
+  // placement order is racy; keep each node's edges in file order so the
+  // result does not depend on scheduling
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        uint64_t begin = n == 0 ? 0 : adj_indices[n - 1];
+        uint64_t end = adj_indices[n];
+        std::sort(file_order.begin() + begin, file_order.begin() + end);
+        for (uint64_t pos = begin; pos < end; ++pos) {
+          dests[pos] = dests_in_file_order[file_order[pos]];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // file_order maps a CSR position to its row in the file; edge properties
+  // need the other direction
+  std::vector<uint64_t> csr_position(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t pos) { csr_position[file_order[pos]] = pos; },
+      katana::no_stats());
+
+  auto edge_properties = KATANA_CHECKED(BuildTable(
+      edges, num_edges, [&](size_t row) { return csr_position[row]; }));
+
+  // node properties go to the row of their node id
+  std::vector<size_t> node_offsets = RowOffsets(nodes);
+  std::vector<uint32_t> node_ids(node_offsets.back());
+  katana::do_all(
+      katana::iterate(size_t{0}, nodes.chunks.size()),
+      [&](size_t c) {
+        const ParsedChunk& chunk = nodes.chunks[c];
+        std::copy(
+            chunk.ids.begin(), chunk.ids.end(),
+            node_ids.begin() + node_offsets[c]);
+      },
+      katana::no_stats());
+
+  auto node_properties = KATANA_CHECKED(BuildTable(
+      nodes, num_nodes, [&](size_t row) { return node_ids[row]; }));
+
+  return GraphComponents(
+      katana::GraphComponent(node_properties, EmptyTable(num_nodes)),
+      katana::GraphComponent(edge_properties, EmptyTable(num_edges)),
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+}
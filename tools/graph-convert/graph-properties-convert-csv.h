@@ -0,0 +1,46 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_CSV_H_
+#define KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_CSV_H_
+
+#include <string>
+
+#include "katana/BuildGraph.h"
+#include "katana/Result.h"
+
+namespace katana {
+
+struct CSVImportOptions {
+  static constexpr size_t kDefaultChunkBytes = 8 << 20;
+
+  /// Field separator, ',' for CSV and '\t' for TSV
+  char delimiter{','};
+  /// If true, the first line of each file names its columns
+  bool has_header{true};
+  /// Approximate number of bytes of input parsed by one task
+  size_t chunk_bytes{kDefaultChunkBytes};
+};
+
+/// ConvertCSV builds graph components from delimited text files.
+///
+/// Each line of the edge file is "source,destination[,property...]" and each
+/// line of the optional node file is "id[,property...]". Node ids are
+/// integers in [0, 2^32) and the graph has one more node than the largest id
+/// in either file; node ids must be unique within the node file. Property
+/// columns hold integers or floating point numbers and become int64 or double
+/// properties; empty fields are null. Blank lines and lines starting with '#'
+/// are skipped. Quoted fields may not contain newlines.
+///
+/// Files are memory mapped and split into byte ranges at line boundaries that
+/// are parsed in parallel.
+///
+/// \param edge_file path to the edge file
+/// \param node_file path to the node file, or empty if there is none
+/// \param options how the files are formatted and split
+/// \returns A collection of Arrow tables of node properties/labels, edge
+///     properties/types, and CSR topology
+Result<GraphComponents> ConvertCSV(
+    const std::string& edge_file, const std::string& node_file,
+    const CSVImportOptions& options = CSVImportOptions());
+
+}  // end namespace katana
+
+#endif
@@ -1,8 +1,11 @@
+#include <algorithm>
 #include <iostream>
 
 #include <llvm/Support/CommandLine.h>
 
+#include "PartitionedPipeline.h"
 #include "Transforms.h"
+#include "graph-properties-convert-csv.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphML.h"
@@ -37,7 +40,10 @@ cll::opt<katana::SourceType> type(
             "source file is of type GraphML"),
         clEnumValN(
             katana::SourceType::kKatana, "katana",
-            "source file is of type Katana")),
+            "source file is of type Katana"),
+        clEnumValN(
+            katana::SourceType::kCsv, "csv",
+            "source file is a delimited text edge list")),
     cll::init(katana::SourceType::kGraphml));
 cll::opt<katana::SourceDatabase> database(
     cll::desc("Database the data is from:"),
@@ -68,6 +74,20 @@ cll::opt<bool> generate_mapping(
               "The file is created at the output destination specified"),
     cll::init(false));
 
+cll::opt<std::string> csv_nodes(
+    "csv-nodes",
+    cll::desc("Delimited text file of node ids and properties to go with a "
+              "csv edge list"),
+    cll::init(""));
+cll::opt<std::string> csv_delimiter(
+    "csv-delimiter",
+    cll::desc("Field separator of csv input, a single character or \"tab\""),
+    cll::init(","));
+cll::opt<bool> csv_no_header(
+    "csv-no-header",
+    cll::desc("csv input has no header line naming its columns"),
+    cll::init(false));
+
 cll::list<std::string> timestamp_properties(
     "timestamp", cll::desc("Timestamp properties"));
 cll::list<std::string> date32_properties(
@@ -85,6 +105,17 @@ cll::opt<std::string> user(
     cll::desc("Username for the target database if needed, default is root"),
     cll::init("root"));
 
+cll::opt<int> partitions(
+    "partitions",
+    cll::desc("Number of ranges of each MongoDB collection or MySQL table "
+              "that are read at once, each over its own connection"),
+    cll::init(8));
+cll::opt<int> read_ahead_batches(
+    "read-ahead-batches",
+    cll::desc("Batches of 1024 documents or rows each range may read ahead "
+              "of the conversion"),
+    cll::init(8));
+
 cll::opt<bool> export_graphml(
     "export",
     cll::desc("Exports a Katana graph to graphml format\n"
@@ -136,6 +167,26 @@ ConvertKatana(const std::string& rdg_file, katana::TxnContext* txn_ctx) {
   return graph;
 }
 
+katana::GraphComponents
+ConvertCSV() {
+  katana::CSVImportOptions options;
+  if (csv_delimiter == "tab" || csv_delimiter == "\\t") {
+    options.delimiter = '\t';
+  } else if (csv_delimiter.size() == 1) {
+    options.delimiter = csv_delimiter[0];
+  } else {
+    KATANA_LOG_FATAL("csv delimiter must be a single character");
+  }
+  options.has_header = !csv_no_header;
+
+  auto components_result =
+      katana::ConvertCSV(input_filename, csv_nodes, options);
+  if (!components_result) {
+    KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
+  }
+  return std::move(components_result.value());
+}
+
 void
 ParseWild(katana::TxnContext* txn_ctx) {
   switch (type) {
@@ -159,6 +210,13 @@ ParseWild(katana::TxnContext* txn_ctx) {
       KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
     }
     return;
+  case katana::SourceType::kCsv:
+    if (auto r = katana::WritePropertyGraph(
+            ConvertCSV(), output_directory, txn_ctx);
+        !r) {
+      KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
+    }
+    return;
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
@@ -185,6 +243,14 @@ ParseNeo4j(katana::TxnContext* txn_ctx) {
   }
 }
 
+[[maybe_unused]] katana::PartitionOptions
+GetPartitionOptions() {
+  katana::PartitionOptions options;
+  options.partitions = std::max(partitions.getValue(), 1);
+  options.max_batches = std::max(read_ahead_batches.getValue(), 1);
+  return options;
+}
+
 void
 ParseMongoDB([[maybe_unused]] katana::TxnContext* txn_ctx) {
 #if defined(KATANA_MONGOC_FOUND)
@@ -192,7 +258,8 @@ ParseMongoDB([[maybe_unused]] katana::TxnContext* txn_ctx) {
     katana::GenerateMappingMongoDB(input_filename, output_directory);
   } else {
     if (auto r = katana::WritePropertyGraph(
-            katana::ConvertMongoDB(input_filename, mapping, chunk_size),
+            katana::ConvertMongoDB(
+                input_filename, mapping, chunk_size, GetPartitionOptions()),
             output_directory, txn_ctx);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
@@ -211,7 +278,8 @@ ParseMysql([[maybe_unused]] katana::TxnContext* txn_ctx) {
   } else {
     if (auto r = katana::WritePropertyGraph(
             katana::ConvertMysql(
-                input_filename, mapping, chunk_size, host, user),
+                input_filename, mapping, chunk_size, host, user,
+                GetPartitionOptions()),
             output_directory, txn_ctx);
         !r) {
       KATANA_LOG_FATAL("Failed to write property graph: {}", r.error());
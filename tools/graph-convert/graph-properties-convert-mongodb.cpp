@@ -8,6 +8,7 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -18,6 +19,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "PartitionedPipeline.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
@@ -544,29 +546,199 @@ GetCollectionNames(mongoc_database_t* database) {
   return coll_names;
 }
 
+// mongoc_init() should be called before this function
+mongoc_client_pool_t*
+GetMongoClientPool(const char* uri_string, size_t max_clients) {
+  bson_error_t error;
+  mongoc_uri_t* uri = mongoc_uri_new_with_error(uri_string, &error);
+  if (!uri) {
+    KATANA_LOG_FATAL(
+        "Failed to parse URI: {}\n"
+        "Error message: {}\n",
+        uri_string, error.message);
+  }
+  mongoc_client_pool_t* pool = mongoc_client_pool_new(uri);
+  if (!pool) {
+    KATANA_LOG_FATAL("Could not create a client pool for URI: {}", uri_string);
+  }
+  mongoc_client_pool_set_error_api(pool, MONGOC_ERROR_API_VERSION_2);
+  mongoc_client_pool_set_appname(pool, "graph-properties-convert");
+  mongoc_client_pool_max_size(
+      pool, static_cast<uint32_t>(std::max<size_t>(max_clients, 100)));
+  mongoc_uri_destroy(uri);
+
+  return pool;
+}
+
+struct BsonDeleter {
+  void operator()(bson_t* doc) const { bson_destroy(doc); }
+};
+
+using BsonPtr = std::unique_ptr<bson_t, BsonDeleter>;
+
+/// A client of a pool for the lifetime of this object
+class PooledClient {
+public:
+  explicit PooledClient(mongoc_client_pool_t* pool)
+      : pool_(pool), client_(mongoc_client_pool_pop(pool)) {}
+  ~PooledClient() { mongoc_client_pool_push(pool_, client_); }
+  PooledClient(const PooledClient&) = delete;
+  PooledClient& operator=(const PooledClient&) = delete;
+
+  mongoc_client_t* get() const { return client_; }
+
+private:
+  mongoc_client_pool_t* pool_;
+  mongoc_client_t* client_;
+};
+
+/// Documents sampled per partition to find the boundaries of partitions
+constexpr int64_t kSamplesPerPartition = 64;
+
+/// MongoDB compares values of different types by type; all numbers are of
+/// one kind
+bool
+IsNumber(bson_type_t type) {
+  return type == BSON_TYPE_INT32 || type == BSON_TYPE_INT64 ||
+         type == BSON_TYPE_DOUBLE || type == BSON_TYPE_DECIMAL128;
+}
+
+bool
+SameKind(bson_type_t a, bson_type_t b) {
+  return a == b || (IsNumber(a) && IsNumber(b));
+}
+
+/// Filters that split coll into about partitions ranges of _id, which
+/// together match every document once. The boundaries of the ranges come
+/// from a random sample of the collection. As a range only matches _ids
+/// of the kind of its boundaries, one more filter matches all the others.
+std::vector<BsonPtr>
+MakePartitionFilters(mongoc_collection_t* coll, size_t partitions) {
+  std::vector<bson_value_t> bounds;
+  if (partitions > 1) {
+    bson_t* pipeline = BCON_NEW(
+        "pipeline", "[", "{", "$sample", "{", "size",
+        BCON_INT64(static_cast<int64_t>(partitions) * kSamplesPerPartition),
+        "}", "}", "{", "$bucketAuto", "{", "groupBy", BCON_UTF8("$_id"),
+        "buckets", BCON_INT64(static_cast<int64_t>(partitions)), "}", "}",
+        "]");
+    auto cursor = mongoc_collection_aggregate(
+        coll, MONGOC_QUERY_NONE, pipeline, nullptr, nullptr);
+    bson_destroy(pipeline);
+
+    // every bucket is {_id: {min: ..., max: ...}, count: ...}; the minimum
+    // of every bucket but the first is a boundary
+    const bson_t* bucket;
+    bool first = true;
+    while (mongoc_cursor_next(cursor, &bucket)) {
+      bson_iter_t iter;
+      bson_iter_t min;
+      if (!bson_iter_init(&iter, bucket) ||
+          !bson_iter_find_descendant(&iter, "_id.min", &min)) {
+        continue;
+      }
+      if (!first) {
+        bounds.emplace_back();
+        bson_value_copy(bson_iter_value(&min), &bounds.back());
+      }
+      first = false;
+    }
+    bson_error_t error;
+    bool failed = mongoc_cursor_error(cursor, &error);
+    if (failed) {
+      KATANA_LOG_WARN(
+          "could not sample _ids, reading with one cursor: {}",
+          error.message);
+    }
+    mongoc_cursor_destroy(cursor);
+
+    bool mixed = std::any_of(bounds.begin(), bounds.end(), [&](auto& b) {
+      return !SameKind(b.value_type, bounds.front().value_type);
+    });
+    if (failed || mixed) {
+      for (auto& b : bounds) {
+        bson_value_destroy(&b);
+      }
+      bounds.clear();
+    }
+  }
+
+  std::vector<BsonPtr> filters;
+  if (bounds.empty()) {
+    filters.emplace_back(bson_new());
+    return filters;
+  }
+  for (size_t i = 0; i <= bounds.size(); ++i) {
+    BsonPtr filter{bson_new()};
+    bson_t range;
+    BSON_APPEND_DOCUMENT_BEGIN(filter.get(), "_id", &range);
+    if (i > 0) {
+      BSON_APPEND_VALUE(&range, "$gte", &bounds[i - 1]);
+    }
+    if (i < bounds.size()) {
+      BSON_APPEND_VALUE(&range, "$lt", &bounds[i]);
+    }
+    bson_append_document_end(filter.get(), &range);
+    filters.emplace_back(std::move(filter));
+  }
+
+  bson_type_t kind = bounds.front().value_type;
+  BsonPtr others{
+      IsNumber(kind)
+          ? BCON_NEW("_id", "{", "$not", "{", "$type", "number", "}", "}")
+          : BCON_NEW(
+                "_id", "{", "$not", "{", "$type",
+                BCON_INT32(static_cast<int32_t>(kind)), "}", "}")};
+  filters.emplace_back(std::move(others));
+
+  for (auto& b : bounds) {
+    bson_value_destroy(&b);
+  }
+  return filters;
+}
+
+/// Call document_op on every document of coll_name. Ranges of the
+/// collection are read in parallel, each with its own client of pool, but
+/// document_op sees the documents one at a time in the order of the ranges.
 template <typename T>
 void
 QueryEntireCollection(
-    mongoc_database_t* database, const bson_t** document,
-    const std::string& coll_name, T document_op) {
-  bson_error_t error;
-  auto collection = mongoc_database_get_collection(database, coll_name.c_str());
-  bson_t filter;
-  bson_init(&filter);
-  auto cursor =
-      mongoc_collection_find_with_opts(collection, &filter, nullptr, nullptr);
-
-  while (mongoc_cursor_next(cursor, document)) {
-    document_op();
-  }
-  if (mongoc_cursor_error(cursor, &error)) {
-    KATANA_LOG_ERROR(
-        "An error occurred with a mongodb cursor: {}", error.message);
+    mongoc_client_pool_t* pool, const std::string& db_name,
+    const std::string& coll_name, const katana::PartitionOptions& options,
+    T document_op) {
+  std::vector<BsonPtr> filters;
+  {
+    PooledClient client{pool};
+    auto collection = mongoc_client_get_collection(
+        client.get(), db_name.c_str(), coll_name.c_str());
+    filters = MakePartitionFilters(collection, options.partitions);
+    mongoc_collection_destroy(collection);
   }
 
-  bson_destroy(&filter);
-  mongoc_cursor_destroy(cursor);
-  mongoc_collection_destroy(collection);
+  katana::RunPartitioned<BsonPtr>(
+      filters.size(), options,
+      [&](size_t p, auto emit) {
+        PooledClient client{pool};
+        auto collection = mongoc_client_get_collection(
+            client.get(), db_name.c_str(), coll_name.c_str());
+        auto cursor = mongoc_collection_find_with_opts(
+            collection, filters[p].get(), nullptr, nullptr);
+
+        // documents of a cursor only live until it moves on
+        const bson_t* document;
+        while (mongoc_cursor_next(cursor, &document)) {
+          emit(BsonPtr{bson_copy(document)});
+        }
+        bson_error_t error;
+        if (mongoc_cursor_error(cursor, &error)) {
+          KATANA_LOG_ERROR(
+              "An error occurred with a mongodb cursor: {}", error.message);
+        }
+
+        mongoc_cursor_destroy(cursor);
+        mongoc_collection_destroy(collection);
+      },
+      [&](BsonPtr&& document) { document_op(document.get()); });
 }
 
 /***************************************/
@@ -1111,9 +1283,9 @@ katana::GenerateMappingMongoDB(
 
 katana::GraphComponents
 katana::ConvertMongoDB(
-    const std::string& db_name, const std::string& mapping, size_t chunk_size) {
+    const std::string& db_name, const std::string& mapping, size_t chunk_size,
+    const PartitionOptions& partition_options) {
   const char* uri_string = "mongodb://localhost:27017";
-  const bson_t* document = nullptr;
 
   katana::PropertyGraphBuilder builder{chunk_size};
   katana::setActiveThreads(1000);
@@ -1139,19 +1311,28 @@ katana::ConvertMongoDB(
     edges = res.second;
   }
 
+  // every range of a collection and the client above need a client
+  mongoc_client_pool_t* pool =
+      GetMongoClientPool(uri_string, partition_options.partitions + 2);
+
   // add all edges first
-  for (auto coll_name : edges) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
-    });
+  for (const auto& coll_name : edges) {
+    QueryEntireCollection(
+        pool, db_name, coll_name, partition_options,
+        [&](const bson_t* document) {
+          katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
   // then add all nodes
-  for (auto coll_name : nodes) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
-    });
+  for (const auto& coll_name : nodes) {
+    QueryEntireCollection(
+        pool, db_name, coll_name, partition_options,
+        [&](const bson_t* document) {
+          katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
 
+  mongoc_client_pool_destroy(pool);
   mongoc_cleanup();
   if (auto r = builder.Finish(); !r) {
     KATANA_LOG_FATAL("Failed to construct graph: {}", r.error());
@@ -4,6 +4,7 @@
 #include <bson/bson.h>
 #include <mongoc/mongoc.h>
 
+#include "PartitionedPipeline.h"
 #include "katana/BuildGraph.h"
 
 namespace katana {
@@ -15,9 +16,12 @@ void HandleEdgeDocumentMongoDB(
     PropertyGraphBuilder*, const bson_t* doc,
     const std::string& collection_name);
 
+/// Collections are read in partition_options.partitions ranges of _id at
+/// once
 GraphComponents ConvertMongoDB(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size);
+    const size_t chunk_size,
+    const PartitionOptions& partition_options = PartitionOptions{});
 void GenerateMappingMongoDB(
     const std::string& db_name, const std::string& outfile);
 
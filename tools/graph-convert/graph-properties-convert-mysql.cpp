@@ -21,6 +21,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "PartitionedPipeline.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
@@ -67,6 +68,10 @@ struct TableData {
   std::string name;
   bool is_node;
   int64_t primary_key_index;
+  std::string primary_key_name;
+  /// the table has a single primary key and it is an integer, so it can be
+  /// read in ranges of it
+  bool integer_primary_key;
   std::vector<Relationship> out_references;
   std::vector<Relationship> in_references;
   std::vector<std::string> field_names;
@@ -77,6 +82,7 @@ struct TableData {
       : name(std::move(name_)),
         is_node(true),
         primary_key_index(-1),
+        integer_primary_key(false),
         out_references(std::vector<Relationship>{}),
         in_references(std::vector<Relationship>{}),
         field_names(std::vector<std::string>{}),
@@ -91,6 +97,17 @@ struct TableData {
     }
   }
 
+  void SetPrimaryKey(const MYSQL_FIELD* field, size_t index) {
+    bool integer = field->type == MYSQL_TYPE_TINY ||
+                   field->type == MYSQL_TYPE_SHORT ||
+                   field->type == MYSQL_TYPE_INT24 ||
+                   field->type == MYSQL_TYPE_LONG ||
+                   field->type == MYSQL_TYPE_LONGLONG;
+    integer_primary_key = primary_key_index < 0 && integer;
+    primary_key_index = static_cast<int64_t>(index);
+    primary_key_name = std::string{field->name, field->name_length};
+  }
+
   bool IsValidEdge() {
     if (this->out_references.size() != 2) {
       return false;
@@ -216,8 +233,8 @@ GenerateFetchRowQuery(const std::string& table) {
 }
 
 std::string
-GenerateFetchTableQuery(const std::string& table) {
-  return std::string{"SELECT * FROM " + table + ";"};
+GenerateFetchTableQuery(const std::string& table, const std::string& where) {
+  return std::string{"SELECT * FROM " + table + where + ";"};
 }
 
 std::vector<std::string>
@@ -256,106 +273,207 @@ RunQuery(MYSQL* con, const std::string& query) {
   return MysqlRes(mysql_use_result(con));
 }
 
-void
-AddNodeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
-  MYSQL_ROW row;
+struct ConnectionParams {
+  std::string host;
+  std::string user;
+  std::string password;
+  std::string db_name;
+};
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
+MYSQL*
+Connect(const ConnectionParams& params) {
+  MYSQL* con = mysql_init(NULL);
+  if (con == nullptr) {
+    KATANA_LOG_FATAL("mysql_init() failed");
+  }
+  if (mysql_real_connect(
+          con, params.host.c_str(), params.user.c_str(),
+          params.password.c_str(), params.db_name.c_str(), 0, NULL,
+          0) == NULL) {
+    KATANA_LOG_FATAL(
+        "Could not establish mysql connection: {}", mysql_error(con));
+  }
+  return con;
+}
 
-    builder->StartNode();
-    builder->AddLabel(table_data.name);
+/// A row copied out of a result set, which only keeps it until the next one
+/// is fetched; null fields are empty
+using Row = std::vector<std::optional<std::string>>;
 
-    // if table has a primary key, add it as node's ID
-    auto primary_index = table_data.primary_key_index;
-    if (primary_index >= 0) {
-      std::string primary_key{row[primary_index], lengths[primary_index]};
-      builder->AddNodeID(table_data.name + primary_key);
+/// \returns the WHERE clauses that split table_data into about partitions
+/// ranges of its primary key, which together match every row once, or a
+/// single empty clause if it cannot be split
+std::vector<std::string>
+MakePartitionConditions(
+    MYSQL* con, const TableData& table_data, size_t partitions) {
+  if (partitions <= 1 || !table_data.integer_primary_key) {
+    return {""};
+  }
+  const std::string& key = table_data.primary_key_name;
+  MysqlRes res = RunQuery(
+      con, "SELECT MIN(" + key + "), MAX(" + key + ") FROM " +
+               table_data.name + ";");
+  MYSQL_ROW row = mysql_fetch_row(res.res);
+  std::optional<int64_t> min;
+  std::optional<int64_t> max;
+  if (row && row[0] && row[1]) {
+    try {
+      min = std::stoll(row[0]);
+      max = std::stoll(row[1]);
+    } catch (const std::exception&) {
+      // keys beyond int64_t are read in one range
     }
+  }
+  if (!min || !max || *max <= *min) {
+    return {""};
+  }
 
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
-      }
+  uint64_t span = static_cast<uint64_t>(*max) - static_cast<uint64_t>(*min);
+  uint64_t step = span / partitions + 1;
+  std::vector<int64_t> bounds;
+  for (size_t i = 1; i < partitions; ++i) {
+    uint64_t offset = i * step;
+    if (offset > span) {
+      break;
     }
+    bounds.emplace_back(static_cast<int64_t>(*min + offset));
+  }
+  if (bounds.empty()) {
+    return {""};
+  }
 
-    // if table has outgoing edges, add them
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      // if the target is null then do not add an edge
-      if (row[foreign_index] != NULL) {
-        std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-        std::string edge_id = relation.target_table + foreign_key;
-        builder->AddOutgoingEdge(edge_id, relation.label);
-      }
+  // the first and last ranges are open, so rows added since MIN and MAX
+  // were read are not lost
+  std::vector<std::string> conditions;
+  for (size_t i = 0; i <= bounds.size(); ++i) {
+    std::vector<std::string> parts;
+    if (i > 0) {
+      parts.emplace_back(fmt::format("{} >= {}", key, bounds[i - 1]));
     }
-    builder->FinishNode();
+    if (i < bounds.size()) {
+      parts.emplace_back(fmt::format("{} < {}", key, bounds[i]));
+    }
+    conditions.emplace_back(" WHERE " + boost::algorithm::join(parts, " AND "));
   }
+  return conditions;
 }
 
+/// Call row_op on every row of table_data. Ranges of the table are read in
+/// parallel, each on its own connection, but row_op sees the rows one at a
+/// time in the order of the ranges.
+template <typename T>
 void
-AddEdgeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
-  MYSQL_ROW row;
+QueryEntireTable(
+    MYSQL* con, const ConnectionParams& params, const TableData& table_data,
+    const katana::PartitionOptions& options, T row_op) {
+  std::vector<std::string> conditions =
+      MakePartitionConditions(con, table_data, options.partitions);
+
+  katana::RunPartitioned<Row>(
+      conditions.size(), options,
+      [&](size_t p, auto emit) {
+        mysql_thread_init();
+        MYSQL* range_con = Connect(params);
+        {
+          MysqlRes table = RunQuery(
+              range_con,
+              GenerateFetchTableQuery(table_data.name, conditions[p]));
+          auto num_fields = mysql_num_fields(table.res);
+          MYSQL_ROW row;
+          while ((row = mysql_fetch_row(table.res))) {
+            auto lengths = mysql_fetch_lengths(table.res);
+            Row copy(num_fields);
+            for (size_t i = 0; i < num_fields; i++) {
+              if (row[i] != NULL) {
+                copy[i].emplace(row[i], lengths[i]);
+              }
+            }
+            emit(std::move(copy));
+          }
+        }
+        mysql_close(range_con);
+        mysql_thread_end();
+      },
+      [&](Row&& row) { row_op(row); });
+}
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
-
-    builder->StartEdge();
-    builder->AddLabel(table_data.name);
-
-    bool adding_source = true;
-    // if the source or target is null then add a placeholder node
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-      std::string edge_id = relation.target_table + foreign_key;
-      if (adding_source) {
-        builder->AddEdgeSource(edge_id);
-        adding_source = false;
-      } else {
-        builder->AddEdgeTarget(edge_id);
-      }
+void
+AddNodeRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const Row& row) {
+  builder->StartNode();
+  builder->AddLabel(table_data.name);
+
+  // if table has a primary key, add it as node's ID
+  auto primary_index = table_data.primary_key_index;
+  if (primary_index >= 0) {
+    builder->AddNodeID(table_data.name + row[primary_index].value_or(""));
+  }
+
+  // add data fields
+  for (size_t i = 0; i < table_data.field_names.size(); i++) {
+    const auto& value = row[table_data.field_indexes[i]];
+    // if the data is null then do not add it
+    if (value) {
+      builder->AddValue(
+          table_data.field_names[i],
+          []() {
+            return PropertyKey{"invalid", ImportDataType::kUnsupported, false};
+          },
+          [&value](ImportDataType type, bool is_list) {
+            return ResolveValue(*value, type, is_list);
+          });
     }
+  }
 
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
-      }
+  // if table has outgoing edges, add them
+  for (const auto& relation : table_data.out_references) {
+    const auto& foreign_key = row[relation.source_index];
+    // if the target is null then do not add an edge
+    if (foreign_key) {
+      std::string edge_id = relation.target_table + *foreign_key;
+      builder->AddOutgoingEdge(edge_id, relation.label);
     }
-    builder->FinishEdge();
   }
+  builder->FinishNode();
+}
+
+void
+AddEdgeRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const Row& row) {
+  builder->StartEdge();
+  builder->AddLabel(table_data.name);
+
+  bool adding_source = true;
+  // if the source or target is null then add a placeholder node
+  for (const auto& relation : table_data.out_references) {
+    std::string edge_id =
+        relation.target_table + row[relation.source_index].value_or("");
+    if (adding_source) {
+      builder->AddEdgeSource(edge_id);
+      adding_source = false;
+    } else {
+      builder->AddEdgeTarget(edge_id);
+    }
+  }
+
+  // add data fields
+  for (size_t i = 0; i < table_data.field_names.size(); i++) {
+    const auto& value = row[table_data.field_indexes[i]];
+    // if the data is null then do not add it
+    if (value) {
+      builder->AddValue(
+          table_data.field_names[i],
+          []() {
+            return PropertyKey{"invalid", ImportDataType::kUnsupported, false};
+          },
+          [&value](ImportDataType type, bool is_list) {
+            return ResolveValue(*value, type, is_list);
+          });
+    }
+  }
+  builder->FinishEdge();
 }
 
 /************************************/
@@ -641,7 +759,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) ==
         table_iter->second.ignore_list.end()) {
@@ -674,7 +792,7 @@ PreprocessFields(
 
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
-      table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.SetPrimaryKey(field, index);
     } else if (
         table_iter->second.ignore_list.find(key.id) !=
         table_iter->second.ignore_list.end()) {
@@ -859,20 +977,12 @@ GetMappingInput(
 GraphComponents
 katana::ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user) {
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    const PartitionOptions& partition_options) {
   katana::PropertyGraphBuilder builder{chunk_size};
-  std::string password{getpass("MySQL Password: ")};
+  ConnectionParams params{host, user, getpass("MySQL Password: "), db_name};
 
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  MYSQL* con = Connect(params);
   std::vector<std::string> table_names = FetchTableNames(con);
   std::unordered_map<std::string, TableData> table_data;
   if (!mapping.empty()) {
@@ -884,12 +994,15 @@ katana::ConvertMysql(
     table_data = PreprocessTables(con, &builder, table_names);
   }
 
-  for (auto table : table_data) {
-    if (table.second.is_node) {
-      AddNodeTable(&builder, con, table.second);
-    } else {
-      AddEdgeTable(&builder, con, table.second);
-    }
+  for (const auto& table : table_data) {
+    const TableData& data = table.second;
+    QueryEntireTable(con, params, data, partition_options, [&](const Row& row) {
+      if (data.is_node) {
+        AddNodeRow(&builder, data, row);
+      } else {
+        AddEdgeRow(&builder, data, row);
+      }
+    });
   }
   mysql_close(con);
   auto out_result = builder.Finish();
@@ -905,18 +1018,8 @@ void
 katana::GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user) {
-  std::string password{getpass("MySQL Password: ")};
-
-  MYSQL* con = mysql_init(NULL);
-  if (con == nullptr) {
-    KATANA_LOG_FATAL("mysql_init() failed");
-  }
-  if (mysql_real_connect(
-          con, host.c_str(), user.c_str(), password.c_str(), db_name.c_str(), 0,
-          NULL, 0) == NULL) {
-    KATANA_LOG_FATAL(
-        "Could not establish mysql connection: {}", mysql_error(con));
-  }
+  ConnectionParams params{host, user, getpass("MySQL Password: "), db_name};
+  MYSQL* con = Connect(params);
   std::vector<std::string> table_names = FetchTableNames(con);
 
   // get user input on node/edge mappings, label names, property names and
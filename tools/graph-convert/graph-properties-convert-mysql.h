@@ -1,13 +1,17 @@
 #ifndef KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_MYSQL_H_
 #define KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_MYSQL_H_
 
+#include "PartitionedPipeline.h"
 #include "katana/BuildGraph.h"
 
 namespace katana {
 
+/// Tables with a single integer primary key are read in
+/// partition_options.partitions ranges of it at once
 GraphComponents ConvertMysql(
     const std::string& db_name, const std::string& mapping,
-    const size_t chunk_size, const std::string& host, const std::string& user);
+    const size_t chunk_size, const std::string& host, const std::string& user,
+    const PartitionOptions& partition_options = PartitionOptions{});
 void GenerateMappingMysql(
     const std::string& db_name, const std::string& outfile,
     const std::string& host, const std::string& user);
@@ -0,0 +1,33 @@
+# Writes an edge list that graph-convert-huge -externalSort --memoryLimitMB=1
+# sorts in several runs and reads in several blocks:
+#
+#   cmake -DOUTPUT=<file> -P make-test-edgelist.cmake
+#
+# The file is num_copies copies of a block of pseudo random sources. Each copy
+# appends its own two digits to the sources, so every copy has sources all
+# over the graph and every run of the sort has edges of every part of it. The
+# destinations of a copy grow along the file. The edges of a source are thus
+# sorted, as the external sort writes them, and graph-convert -edgelist2gr
+# gives the same graph.
+
+if(NOT OUTPUT)
+  message(FATAL_ERROR "usage: cmake -DOUTPUT=<file> -P make-test-edgelist.cmake")
+endif()
+
+set(num_copies 25)
+set(edges_per_copy 20000)
+
+set(block "")
+set(x 1)
+foreach(i RANGE 1 ${edges_per_copy})
+  math(EXPR x "(${x} * 1103515245 + 12345) % 2147483648")
+  math(EXPR src "${x} / 65536 % 5000")
+  string(APPEND block "${src}@COPY@ ${i}\n")
+endforeach()
+
+file(WRITE ${OUTPUT} "")
+math(EXPR last_copy "10 + ${num_copies} - 1")
+foreach(copy RANGE 10 ${last_copy})
+  string(REPLACE "@COPY@" "${copy}" lines "${block}")
+  file(APPEND ${OUTPUT} "${lines}")
+endforeach()
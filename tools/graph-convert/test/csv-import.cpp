@@ -0,0 +1,140 @@
+#include <fstream>
+#include <string>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "graph-properties-convert-csv.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::string
+WriteFile(
+    const std::string& dir, const std::string& name,
+    const std::string& contents) {
+  std::string path = dir + "/" + name;
+  std::ofstream out(path);
+  out << contents;
+  return path;
+}
+
+std::string
+MakeDir() {
+  auto uri_res = katana::URI::MakeRand("/tmp/csv-import");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir = uri_res.value().path();
+  fs::create_directories(dir);
+  return dir;
+}
+
+void
+TestEdgesAndNodes(const std::string& dir) {
+  std::string edges = WriteFile(
+      dir, "edges.csv",
+      "src,dst,weight,cost\n"
+      "# a comment\n"
+      "0,2,1,0.5\n"
+      "3,1,2,\n"
+      "\n"
+      "0,1,3,4\r\n"
+      "2,0,,1.5");
+  std::string nodes = WriteFile(
+      dir, "nodes.csv",
+      "id,age\n"
+      "1,10\n"
+      "0,20\n");
+
+  // a tiny chunk size puts nearly every line in its own task
+  katana::CSVImportOptions options;
+  options.chunk_bytes = 4;
+  auto res = katana::ConvertCSV(edges, nodes, options);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  katana::GraphComponents graph = std::move(res.value());
+
+  KATANA_LOG_ASSERT(graph.topology.NumNodes() == 4);
+  KATANA_LOG_ASSERT(graph.topology.NumEdges() == 4);
+  auto indices = katana::ProjectAsArrowArray(
+      graph.topology.AdjData(), graph.topology.NumNodes());
+  KATANA_LOG_VASSERT(
+      indices->ToString() == "[\n  2,\n  2,\n  3,\n  4\n]", "{}",
+      indices->ToString());
+  // edges of a node keep their order in the file
+  auto dests = katana::ProjectAsArrowArray(
+      graph.topology.DestData(), graph.topology.NumEdges());
+  KATANA_LOG_VASSERT(
+      dests->ToString() == "[\n  2,\n  1,\n  0,\n  1\n]", "{}",
+      dests->ToString());
+
+  auto edge_props = graph.edges.properties;
+  KATANA_LOG_ASSERT(edge_props->num_columns() == 2);
+  KATANA_LOG_ASSERT(edge_props->field(0)->name() == "weight");
+  KATANA_LOG_ASSERT(edge_props->field(0)->type()->Equals(arrow::int64()));
+  KATANA_LOG_ASSERT(edge_props->field(1)->type()->Equals(arrow::float64()));
+  auto weight = edge_props->column(0)->ToString();
+  KATANA_LOG_VASSERT(
+      weight == "[\n  [\n    1,\n    3,\n    null,\n    2\n  ]\n]", "{}",
+      weight);
+  auto cost = edge_props->column(1)->ToString();
+  KATANA_LOG_VASSERT(
+      cost == "[\n  [\n    0.5,\n    4,\n    1.5,\n    null\n  ]\n]", "{}",
+      cost);
+
+  auto node_props = graph.nodes.properties;
+  KATANA_LOG_ASSERT(node_props->num_columns() == 1);
+  KATANA_LOG_ASSERT(node_props->num_rows() == 4);
+  auto age = node_props->column(0)->ToString();
+  KATANA_LOG_VASSERT(
+      age == "[\n  [\n    20,\n    10,\n    null,\n    null\n  ]\n]", "{}",
+      age);
+}
+
+void
+TestNoHeaderTsv(const std::string& dir) {
+  std::string edges = WriteFile(dir, "edges.tsv", "0\t1\n1\t2\n2\t0\n");
+
+  katana::CSVImportOptions options;
+  options.delimiter = '\t';
+  options.has_header = false;
+  auto res = katana::ConvertCSV(edges, "", options);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(res.value().topology.NumNodes() == 3);
+  KATANA_LOG_ASSERT(res.value().topology.NumEdges() == 3);
+  KATANA_LOG_ASSERT(res.value().edges.properties->num_columns() == 0);
+}
+
+void
+TestBadInput(const std::string& dir) {
+  std::string bad_id = WriteFile(dir, "bad-id.csv", "src,dst\n0,1\n-1,2\n");
+  KATANA_LOG_ASSERT(!katana::ConvertCSV(bad_id, ""));
+
+  std::string bad_value = WriteFile(dir, "bad-value.csv", "src,dst,w\n0,1,x\n");
+  KATANA_LOG_ASSERT(!katana::ConvertCSV(bad_value, ""));
+
+  std::string short_line =
+      WriteFile(dir, "short-line.csv", "src,dst,w\n0,1,1\n1,2\n");
+  KATANA_LOG_ASSERT(!katana::ConvertCSV(short_line, ""));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::string dir = MakeDir();
+
+  TestEdgesAndNodes(dir);
+
+  TestNoHeaderTsv(dir);
+
+  TestBadInput(dir);
+
+  fs::remove_all(dir);
+
+  return 0;
+}
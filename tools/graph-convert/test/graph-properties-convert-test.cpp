@@ -43,6 +43,10 @@ static cll::opt<ConvertTest> test_type(
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<size_t> parse_chunk_bytes(
+    "parseChunkBytes",
+    cll::desc("Size of the pieces GraphML input is split into for parsing"),
+    cll::init(katana::kDefaultGraphMLParseChunkBytes));
 
 namespace {
 
@@ -1272,7 +1276,9 @@ main(int argc, char** argv) {
 
   switch (fileType) {
   case katana::SourceDatabase::kNeo4j:
-    if (auto r = katana::ConvertGraphML(input_filename, chunk_size, true); !r) {
+    if (auto r = katana::ConvertGraphML(
+            input_filename, chunk_size, true, parse_chunk_bytes);
+        !r) {
       KATANA_LOG_FATAL(": {}", r.error());
     } else {
       graph = std::move(r.value());
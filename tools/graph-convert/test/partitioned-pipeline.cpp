@@ -0,0 +1,50 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "PartitionedPipeline.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Partition p emits p * 1000, ..., p * 1000 + sizes[p] - 1
+std::vector<uint64_t>
+Run(const std::vector<uint64_t>& sizes, const katana::PartitionOptions& opts) {
+  std::vector<uint64_t> consumed;
+  katana::RunPartitioned<std::unique_ptr<uint64_t>>(
+      sizes.size(), opts,
+      [&sizes](size_t p, auto emit) {
+        for (uint64_t i = 0; i < sizes[p]; ++i) {
+          emit(std::make_unique<uint64_t>(p * 1000 + i));
+        }
+      },
+      [&consumed](std::unique_ptr<uint64_t>&& item) {
+        consumed.emplace_back(*item);
+      });
+  return consumed;
+}
+
+void
+TestOrder(const katana::PartitionOptions& opts) {
+  std::vector<uint64_t> sizes{0, 7, 300, 1, 0, 45};
+  std::vector<uint64_t> expected;
+  for (uint64_t p = 0; p < sizes.size(); ++p) {
+    for (uint64_t i = 0; i < sizes[p]; ++i) {
+      expected.emplace_back(p * 1000 + i);
+    }
+  }
+  KATANA_LOG_ASSERT(Run(sizes, opts) == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  TestOrder(katana::PartitionOptions{});
+  // readers block on full queues
+  TestOrder(katana::PartitionOptions{4, 1, 1});
+  TestOrder(katana::PartitionOptions{4, 0, 0});
+  KATANA_LOG_ASSERT(Run({}, katana::PartitionOptions{}).empty());
+
+  return 0;
+}
@@ -17,60 +17,135 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include "katana/BufferedGraph.h"
-#include "katana/FileGraph.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/Timer.h"
 #include "llvm/Support/CommandLine.h"
 
+/* usage: ./graph-remap <input rdg> <output rdg> [-ordering=...]
+ *
+ * Renumbers the nodes of an RDG and writes the result, with the topology,
+ * the entity types and every node and edge property permuted, as a new RDG.
+ * The permutation comes from a mapping file or from a locality ordering
+ * computed on the graph.
+ */
+
 namespace cll = llvm::cl;
 
+enum Ordering { kFile, kDegree, kBFS, kRCM };
+
 static cll::opt<std::string> inputFilename(
-    cll::Positional, cll::desc("<input file>"), cll::Required);
-static cll::opt<std::string> mappingFilename(
-    cll::Positional, cll::desc("<mapping file>"), cll::Required);
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
 static cll::opt<std::string> outputFilename(
-    cll::Positional, cll::desc("<output file>"), cll::Required);
-
-using Writer = katana::FileGraphWriter;
-
-/**
- * Create node map from file
- */
-std::map<uint32_t, uint32_t>
-createNodeMap() {
-  katana::gInfo("Creating node map");
-  // read new mapping
-  std::ifstream mapFile(mappingFilename);
-  mapFile.seekg(0, std::ios_base::end);
-
-  int64_t endOfFile = mapFile.tellg();
-  if (!mapFile) {
-    KATANA_DIE("failed to read file");
-  }
-
-  mapFile.seekg(0, std::ios_base::beg);
-  if (!mapFile) {
-    KATANA_DIE("failed to read file");
+    cll::Positional, cll::desc("<output rdg>"), cll::Required);
+static cll::opt<Ordering> ordering(
+    "ordering", cll::desc("Where the new node order comes from:"),
+    cll::values(
+        clEnumValN(
+            kFile, "file",
+            "The mapping file; the node listed on line n becomes node n "
+            "(default)"),
+        clEnumValN(kDegree, "degree", "Nodes sorted by degree"),
+        clEnumValN(kBFS, "bfs", "Breadth-first order"),
+        clEnumValN(kRCM, "rcm", "Reverse Cuthill-McKee order")),
+    cll::init(kFile));
+static cll::opt<std::string> mappingFilename(
+    "mapping", cll::desc("Mapping file for -ordering=file"));
+
+/// Read the old node ids listed in the mapping file, one per line; the node
+/// listed on line n becomes node n.
+katana::Result<katana::GraphTopology::PropIndexVec>
+ReadMapping(const std::string& filename, uint64_t num_nodes) {
+  std::ifstream map_file(filename);
+  if (!map_file) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "failed to open mapping file {}",
+        filename);
   }
-
-  // remap node listed on line n in the mapping to node n
-  std::map<uint32_t, uint32_t> remapper;
-  uint64_t counter = 0;
-  while (((int64_t)mapFile.tellg() + 1) != endOfFile) {
-    uint64_t nodeID;
-    mapFile >> nodeID;
-    if (!mapFile) {
-      KATANA_DIE("failed to read file");
+  std::string contents{
+      std::istreambuf_iterator<char>(map_file),
+      std::istreambuf_iterator<char>()};
+
+  katana::GraphTopology::PropIndexVec new_to_old;
+  new_to_old.allocateInterleaved(num_nodes);
+
+  const char* pos = contents.c_str();
+  uint64_t count = 0;
+  while (true) {
+    char* end = nullptr;
+    errno = 0;
+    uint64_t old_id = std::strtoull(pos, &end, 10);
+    if (end == pos) {
+      break;
+    }
+    if (errno != 0 || count == num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "mapping file {} has more than {} entries or an invalid one",
+          filename, num_nodes);
     }
-    remapper[nodeID] = counter++;
+    new_to_old[count++] = old_id;
+    pos = end;
   }
+  // strtoull stops at the first thing that is not a number
+  while (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t') {
+    ++pos;
+  }
+  if (*pos != '\0' || count != num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "mapping file {} must list each of the {} nodes once, found {} "
+        "entries",
+        filename, num_nodes, count);
+  }
+  return new_to_old;
+}
 
-  KATANA_LOG_ASSERT(remapper.size() == counter);
-  katana::gInfo("Remapping ", counter, " nodes");
-
-  katana::gInfo("Node map created");
+/// The nodes in the order of view, which renumbers the nodes of pg
+template <typename View>
+katana::GraphTopology::PropIndexVec
+OrderOf(katana::PropertyGraph* pg) {
+  auto view = pg->BuildView<View>();
+  katana::GraphTopology::PropIndexVec new_to_old;
+  new_to_old.allocateInterleaved(view.NumNodes());
+  katana::do_all(
+      katana::iterate(view.Nodes()),
+      [&](auto n) { new_to_old[n] = view.GetNodePropertyIndex(n); },
+      katana::no_stats());
+  return new_to_old;
+}
 
-  return remapper;
+katana::Result<katana::GraphTopology::PropIndexVec>
+MakeOrdering(katana::PropertyGraph* pg) {
+  using Views = katana::PropertyGraphViews;
+  switch (ordering) {
+  case kFile:
+    if (mappingFilename.empty()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "-ordering=file needs a -mapping file");
+    }
+    return ReadMapping(mappingFilename, pg->NumNodes());
+  case kDegree:
+    return OrderOf<Views::NodesSortedByDegreeEdgesSortedByDestID>(pg);
+  case kBFS:
+    return OrderOf<Views::NodesSortedByBFSEdgesSortedByDestID>(pg);
+  case kRCM:
+    return OrderOf<Views::NodesSortedByRCMEdgesSortedByDestID>(pg);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown ordering");
+  }
 }
 
 int
@@ -78,62 +153,46 @@ main(int argc, char** argv) {
   katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
-  std::map<uint32_t, uint32_t> remapper = createNodeMap();
-
   katana::gInfo("Loading graph to remap");
-  katana::BufferedGraph<void> graphToRemap;
-  graphToRemap.loadGraph(inputFilename);
-  katana::gInfo("Graph loaded");
-
-  Writer graphWriter;
-  graphWriter.setNumNodes(remapper.size());
-  graphWriter.setNumEdges(graphToRemap.sizeEdges());
-
-  // phase 1: count degrees
-  graphWriter.phase1();
-  katana::gInfo("Starting degree counting");
-  size_t prevNumNodes = graphToRemap.size();
-  size_t nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        graphWriter.incrementDegree(nodeIDCounter);
-      }
-      nodeIDCounter++;
-    }
+  katana::TxnContext txn_ctx;
+  auto pg_res = katana::PropertyGraph::Make(
+      inputFilename, &txn_ctx, katana::RDGLoadOptions());
+  if (!pg_res) {
+    KATANA_LOG_FATAL("failed to load {}: {}", inputFilename, pg_res.error());
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
-
-  // phase 2: edge construction
-  graphWriter.phase2();
-  katana::gInfo("Starting edge construction");
-  nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        uint32_t dst = graphToRemap.edgeDestination(*e);
-        KATANA_LOG_ASSERT(remapper.find(dst) != remapper.end());
-        graphWriter.addNeighbor(nodeIDCounter, remapper[dst]);
-      }
-      nodeIDCounter++;
-    }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  katana::gInfo(
+      "Graph loaded: ", pg->NumNodes(), " nodes, ", pg->NumEdges(), " edges");
+
+  katana::StatTimer order_timer("Ordering");
+  order_timer.start();
+  auto new_to_old = MakeOrdering(pg.get());
+  order_timer.stop();
+  if (!new_to_old) {
+    KATANA_LOG_FATAL("failed to make node ordering: {}", new_to_old.error());
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
 
-  katana::gInfo("Finishing up: outputting graph shortly");
+  katana::StatTimer permute_timer("Permute");
+  permute_timer.start();
+  auto permuted = katana::CreatePermutedGraph(pg.get(), new_to_old.value());
+  permute_timer.stop();
+  if (!permuted) {
+    KATANA_LOG_FATAL("failed to permute graph: {}", permuted.error());
+  }
 
-  graphWriter.finish<void>();
-  graphWriter.toFile(outputFilename);
+  katana::gInfo("Writing remapped graph to ", outputFilename);
+  std::string command_line;
+  for (int i = 0; i < argc; ++i) {
+    command_line += (i ? " " : "") + std::string(argv[i]);
+  }
+  if (auto r = permuted.value()->Write(outputFilename, command_line, &txn_ctx);
+      !r) {
+    KATANA_LOG_FATAL("failed to write {}: {}", outputFilename, r.error());
+  }
 
   katana::gInfo(
-      "new size is ", graphWriter.size(), " num edges ",
-      graphWriter.sizeEdges());
+      "new size is ", permuted.value()->NumNodes(), " num edges ",
+      permuted.value()->NumEdges());
 
   return 0;
 }
@@ -0,0 +1,81 @@
+#include <signal.h>
+
+#include <string>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedGraph.h"
+#include "katana/SharedMemSys.h"
+#include "llvm/Support/CommandLine.h"
+
+/* usage: ./graph-server <input rdg> -name=<name> [-replace]
+ *
+ * Loads an RDG once and publishes it as a shared graph (see SharedGraph.h)
+ * so that other processes on this host can attach to it with
+ * katana::AttachSharedGraph instead of loading copies of their own. The
+ * graph stays published until the server gets SIGINT or SIGTERM.
+ */
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> inputFilename(
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
+static cll::opt<std::string> sharedName(
+    "name", cll::desc("Name to publish the graph under"), cll::Required);
+static cll::opt<bool> replace(
+    "replace",
+    cll::desc("Replace a shared graph of the same name left by a server "
+              "that did not shut down"),
+    cll::init(false));
+
+int
+main(int argc, char** argv) {
+  // block the signals before the thread pool starts so that only sigwait
+  // sees them
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  katana::gInfo("Loading graph to share");
+  katana::TxnContext txn_ctx;
+  auto pg_res = katana::PropertyGraph::Make(
+      inputFilename, &txn_ctx, katana::RDGLoadOptions());
+  if (!pg_res) {
+    KATANA_LOG_FATAL("failed to load {}: {}", inputFilename, pg_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  katana::gInfo(
+      "Graph loaded: ", pg->NumNodes(), " nodes, ", pg->NumEdges(), " edges");
+
+  if (replace) {
+    // nothing to replace is fine
+    (void)katana::UnpublishSharedGraph(sharedName);
+  }
+
+  std::string command_line;
+  for (int i = 0; i < argc; ++i) {
+    command_line += (i ? " " : "") + std::string(argv[i]);
+  }
+  auto location =
+      katana::PublishSharedGraph(pg.get(), sharedName, command_line, &txn_ctx);
+  if (!location) {
+    KATANA_LOG_FATAL("failed to publish {}: {}", sharedName, location.error());
+  }
+  // the published files hold the graph now
+  pg.reset();
+  katana::gInfo("Published ", sharedName, " at ", location.value());
+
+  int sig = 0;
+  sigwait(&stop_signals, &sig);
+
+  katana::gInfo("Unpublishing ", sharedName);
+  if (auto r = katana::UnpublishSharedGraph(sharedName); !r) {
+    KATANA_LOG_FATAL("failed to unpublish {}: {}", sharedName, r.error());
+  }
+  return 0;
+}
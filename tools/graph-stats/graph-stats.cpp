@@ -17,15 +17,43 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include "katana/Galois.h"
-#include "katana/LCGraph.h"
-#include "katana/OfflineGraph.h"
+#include <nlohmann/json.hpp>
+
+#include "katana/Bag.h"
+#include "katana/GraphTopology.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Timer.h"
+#include "katana/analytics/neighborhood_function/neighborhood_function.h"
 #include "llvm/Support/CommandLine.h"
 
+/* usage: ./graph-stats <input rdg> -degreehist -summary ... [-json]
+ *
+ * Loads only the topology and the entity types of an RDG and computes the
+ * requested statistics. The per-node statistics are gathered together in a
+ * single parallel pass over the graph with per-thread histograms, which are
+ * merged in a fixed order so that the output does not depend on the number
+ * of threads.
+ */
+
 namespace cll = llvm::cl;
 
 enum StatMode {
@@ -36,11 +64,14 @@ enum StatMode {
   indegreehist,
   sortedlogoffsethist,
   sparsityPattern,
-  summary
+  summary,
+  typedegreehist,
+  diameter,
+  neighborhood
 };
 
 static cll::opt<std::string> inputfilename(
-    cll::Positional, cll::desc("<graph file>"), cll::Required);
+    cll::Positional, cll::desc("<input rdg>"), cll::Required);
 static cll::list<StatMode> statModeList(
     cll::desc("Available stats:"),
     cll::values(
@@ -56,58 +87,239 @@ static cll::list<StatMode> statModeList(
             sparsityPattern,
             "Pattern of non-zeros when graph is "
             "interpreted as a sparse matrix"),
-        clEnumVal(summary, "Graph summary")));
+        clEnumVal(summary, "Graph summary"),
+        clEnumVal(typedegreehist, "Histogram of degrees per node type"),
+        clEnumVal(
+            diameter, "Lower bound on the diameter by a double sweep BFS"),
+        clEnumVal(
+            neighborhood,
+            "Effective diameter, average distance and neighborhood function "
+            "estimated with HyperANF")));
 static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<bool> jsonOutput(
+    "json",
+    cll::desc("Print the requested stats as a single JSON object (default "
+              "false)"),
+    cll::init(false));
 
-typedef katana::OfflineGraph Graph;
-typedef Graph::GraphNode GNode;
+using Node = katana::GraphTopology::Node;
+using Histogram = std::map<uint64_t, uint64_t>;
+using LogHistogram = std::map<int64_t, uint64_t>;
 
-void
-doSummary(Graph& graph) {
-  std::cout << "NumNodes: " << graph.size() << "\n";
-  std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
-  std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
+/// The statistics gathered by one thread in the parallel pass
+struct ThreadStats {
+  std::unordered_map<uint64_t, uint64_t> degree_hist;
+  /// Indexed by the entity type of the node
+  std::vector<std::unordered_map<uint64_t, uint64_t>> type_degree_hist;
+  std::unordered_map<int64_t, uint64_t> log_offset_hist;
+  uint64_t max_degree{0};
+  Node max_degree_node{0};
+  bool any_node{false};
+};
+
+struct GraphStats {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  uint64_t max_degree{0};
+  Node max_degree_node{0};
+  Histogram degree_hist;
+  std::map<std::string, Histogram> type_degree_hist;
+  LogHistogram log_offset_hist;
+  katana::NUMAArray<std::atomic<uint64_t>> in_degrees;
+};
+
+int
+getLogIndex(ptrdiff_t x) {
+  int logvalue = 0;
+  int sign = x < 0 ? -1 : 1;
+
+  if (x < 0) {
+    x = -x;
+  }
+
+  while ((x >>= 1) != 0) {
+    ++logvalue;
+  }
+  return sign * logvalue;
 }
 
+template <typename K, typename Map>
 void
-doDegrees(Graph& graph) {
-  for (auto n : graph) {
-    std::cout << graph.edges(n).size() << "\n";
+MergeInto(std::map<K, uint64_t>* dst, const Map& src) {
+  for (const auto& [key, count] : src) {
+    (*dst)[key] += count;
   }
 }
 
-void
-findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeID = 0;
-  size_t MaxDegree = 0;
-  uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = graph.edges(n).size();
-    if (MaxDegree < degree) {
-      MaxDegree = degree;
-      MaxDegreeNode = nodeID;
+/// The name of a node entity type, the names of its atomic types joined by
+/// '&', which is how the type is written when a graph is imported
+std::string
+NodeTypeName(const katana::PropertyGraph& pg, katana::EntityTypeID type_id) {
+  auto names = pg.GetNodeTypeManager().EntityTypeToTypeNameSet(type_id);
+  if (!names || names.value().empty()) {
+    return "unknown";
+  }
+  std::string name;
+  for (const auto& atomic_name : names.value()) {
+    name += (name.empty() ? "" : "&") + atomic_name;
+  }
+  return name;
+}
+
+/// Gather the per-node statistics in one parallel pass over view. Offsets
+/// between neighbors are only meaningful when the edges of view are sorted
+/// by destination.
+template <typename View>
+GraphStats
+ComputeStats(
+    const katana::PropertyGraph& pg, const View& view, bool log_offsets) {
+  GraphStats stats;
+  stats.num_nodes = view.NumNodes();
+  stats.num_edges = view.NumEdges();
+  stats.in_degrees.allocateInterleaved(stats.num_nodes);
+  katana::do_all(
+      katana::iterate(view.Nodes()),
+      [&](auto n) { stats.in_degrees[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  size_t num_types = pg.GetNodeTypeManager().GetNumEntityTypes();
+  katana::PerThreadStorage<ThreadStats> per_thread;
+  katana::on_each([&](unsigned, unsigned) {
+    per_thread.getLocal()->type_degree_hist.resize(num_types);
+  });
+
+  katana::do_all(
+      katana::iterate(view.Nodes()),
+      [&](auto n) {
+        ThreadStats* local = per_thread.getLocal();
+        uint64_t degree = view.OutDegree(n);
+        ++local->degree_hist[degree];
+        ++local->type_degree_hist[pg.GetTypeOfNode(n)][degree];
+        // ties go to the lowest node id
+        if (!local->any_node || degree > local->max_degree ||
+            (degree == local->max_degree && n < local->max_degree_node)) {
+          local->max_degree = degree;
+          local->max_degree_node = n;
+          local->any_node = true;
+        }
+
+        bool first = true;
+        Node last = 0;
+        for (auto e : view.OutEdges(n)) {
+          Node dst = view.OutEdgeDst(e);
+          stats.in_degrees[dst].fetch_add(1, std::memory_order_relaxed);
+          if (log_offsets) {
+            if (!first) {
+              ++local->log_offset_hist[getLogIndex(
+                  static_cast<ptrdiff_t>(dst) - static_cast<ptrdiff_t>(last))];
+            }
+            first = false;
+            last = dst;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("GraphStats"));
+
+  // merge in thread order; histograms are sums so the order of the threads
+  // does not change them, only the tie break for the max degree needs care
+  std::vector<Histogram> type_hists(num_types);
+  bool any_node = false;
+  for (unsigned i = 0; i < per_thread.size(); ++i) {
+    const ThreadStats& local = *per_thread.getRemote(i);
+    MergeInto(&stats.degree_hist, local.degree_hist);
+    MergeInto(&stats.log_offset_hist, local.log_offset_hist);
+    for (size_t t = 0; t < local.type_degree_hist.size(); ++t) {
+      MergeInto(&type_hists[t], local.type_degree_hist[t]);
+    }
+    if (local.any_node &&
+        (!any_node || local.max_degree > stats.max_degree ||
+         (local.max_degree == stats.max_degree &&
+          local.max_degree_node < stats.max_degree_node))) {
+      stats.max_degree = local.max_degree;
+      stats.max_degree_node = local.max_degree_node;
+      any_node = true;
+    }
+  }
+  for (size_t t = 0; t < num_types; ++t) {
+    if (!type_hists[t].empty()) {
+      stats.type_degree_hist[NodeTypeName(pg, t)] = std::move(type_hists[t]);
     }
-    ++nodeID;
   }
-  std::cout << "MaxDegreeNode : " << MaxDegreeNode
-            << " , MaxDegree : " << MaxDegree << "\n";
+  return stats;
+}
+
+/// Level synchronous BFS along out-edges from source. Returns the farthest
+/// node, the lowest id among the farthest ones, and its distance.
+std::pair<Node, uint64_t>
+FarthestNode(const katana::GraphTopology& topo, Node source) {
+  constexpr uint64_t kUnvisited = std::numeric_limits<uint64_t>::max();
+  katana::NUMAArray<std::atomic<uint64_t>> dist;
+  dist.allocateInterleaved(topo.NumNodes());
+  katana::ParallelSTL::fill(dist.begin(), dist.end(), kUnvisited);
+  dist[source] = 0;
+
+  katana::InsertBag<Node> frontier;
+  frontier.push(source);
+  uint64_t level = 0;
+  Node farthest = source;
+  katana::InsertBag<Node> next;
+  katana::GReduceMin<Node> lowest_next;
+  while (true) {
+    next.clear();
+    lowest_next.reset();
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](Node n) {
+          for (auto e : topo.OutEdges(n)) {
+            Node dst = topo.OutEdgeDst(e);
+            uint64_t expected = kUnvisited;
+            if (dist[dst].compare_exchange_strong(expected, level + 1)) {
+              next.push(dst);
+              lowest_next.update(dst);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (next.empty()) {
+      break;
+    }
+    ++level;
+    farthest = lowest_next.reduce();
+    frontier.swap(next);
+  }
+  return {farthest, level};
+}
+
+/// A lower bound on the diameter of the graph by a double sweep, BFS from
+/// the node of maximum degree and then BFS from the node farthest from it.
+/// On undirected graphs this is often the exact diameter; on directed graphs
+/// it is the larger of two eccentricities.
+uint64_t
+ApproximateDiameter(const katana::GraphTopology& topo, Node start) {
+  if (topo.NumNodes() == 0) {
+    return 0;
+  }
+  auto [first_far, first_dist] = FarthestNode(topo, start);
+  auto second = FarthestNode(topo, first_far);
+  return std::max(first_dist, second.second);
 }
 
 void
-printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
+printHistogram(const std::string& name, const Histogram& hists) {
+  if (hists.empty()) {
+    std::cout << name << "Bin,Start,End,Count\n";
+    return;
+  }
   auto max = hists.rbegin()->first;
   if (numBins <= 0) {
     std::cout << name << "Bin,Start,End,Count\n";
-    for (unsigned x = 0; x <= max; ++x) {
+    for (uint64_t x = 0; x <= max; ++x) {
       std::cout << x << ',' << x << ',' << x + 1 << ',';
-      if (hists.count(x)) {
-        std::cout << hists[x] << '\n';
-      } else {
-        std::cout << "0\n";
-      }
+      auto it = hists.find(x);
+      std::cout << (it == hists.end() ? 0 : it->second) << '\n';
     }
   } else {
     std::vector<uint64_t> bins(numBins);
@@ -115,7 +327,6 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
     if ((max + 1) % numBins) {
       ++bwidth;
     }
-    // std::cerr << "* " << max << " " << numBins << " " << bwidth << "\n";
     for (auto p : hists) {
       bins.at(p.first / bwidth) += p.second;
     }
@@ -128,177 +339,242 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
 }
 
 void
-doSparsityPattern(
-    Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
-  unsigned blockSize = (graph.size() + columns - 1) / columns;
-
-  for (int i = 0; i < columns; ++i) {
-    std::vector<bool> row(columns);
-    auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
-    for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
-      for (auto jj : graph.edges(*ii)) {
-        row[graph.getEdgeDst(jj) / blockSize] = true;
-      }
-    }
-    for (int x = 0; x < columns; ++x) {
-      printFn(x, i, row[x]);
-    }
+printLogHistogram(const std::string& name, const LogHistogram& hists) {
+  std::cout << name << "Bin,Count\n";
+  for (const auto& [bin, count] : hists) {
+    std::cout << bin << ',' << count << '\n';
   }
 }
 
-void
-doDegreeHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[graph.edges(ii).size()];
+std::vector<std::vector<bool>>
+SparsityPattern(const katana::GraphTopology& topo) {
+  std::vector<std::vector<bool>> rows(columns, std::vector<bool>(columns));
+  uint64_t block_size = (topo.NumNodes() + columns - 1) / columns;
+  if (block_size == 0) {
+    return rows;
   }
-  printHistogram("Degree", hist);
-}
-
-void
-doInDegreeHistogram(Graph& graph) {
-  std::vector<uint64_t> inv(graph.size());
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
-    }
-  }
-  for (uint64_t n : inv) {
-    ++hist[n];
-  }
-  printHistogram("InDegree", hist);
+  // one row per task so that no two threads write the same vector<bool>
+  katana::do_all(
+      katana::iterate(0, static_cast<int>(columns)),
+      [&](int i) {
+        Node begin = std::min<uint64_t>(i * block_size, topo.NumNodes());
+        Node end = std::min<uint64_t>(begin + block_size, topo.NumNodes());
+        for (Node n = begin; n < end; ++n) {
+          for (auto e : topo.OutEdges(n)) {
+            rows[i][topo.OutEdgeDst(e) / block_size] = true;
+          }
+        }
+      },
+      katana::chunk_size<1>(), katana::no_stats());
+  return rows;
 }
 
-struct EdgeComp {
-  typedef katana::EdgeSortValue<GNode, void> Edge;
-
-  bool operator()(const Edge& a, const Edge& b) const { return a.dst < b.dst; }
-};
-
-int
-getLogIndex(ptrdiff_t x) {
-  int logvalue = 0;
-  int sign = x < 0 ? -1 : 1;
-
-  if (x < 0) {
-    x = -x;
+Histogram
+InDegreeHistogram(const GraphStats& stats) {
+  katana::PerThreadStorage<std::unordered_map<uint64_t, uint64_t>> per_thread;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, stats.num_nodes),
+      [&](uint64_t n) {
+        ++(*per_thread.getLocal())[stats.in_degrees[n].load(
+            std::memory_order_relaxed)];
+      },
+      katana::no_stats());
+  Histogram hist;
+  for (unsigned i = 0; i < per_thread.size(); ++i) {
+    MergeInto(&hist, *per_thread.getRemote(i));
   }
-
-  while ((x >>= 1) != 0) {
-    ++logvalue;
-  }
-  return sign * logvalue;
-}
-
-void
-doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
-  // Graph copy;
-  // {
-  //   // Original FileGraph is immutable because it is backed by a file
-  //   copy = graph;
-  // }
-
-  // std::vector<std::map<int, size_t> > hists;
-  // hists.emplace_back();
-  // auto hist = &hists.back();
-  // int curHist = 0;
-  // auto p = katana::block_range(
-  //     boost::counting_iterator<size_t>(0),
-  //     boost::counting_iterator<size_t>(graph.sizeEdges()),
-  //     curHist,
-  //     numHist);
-  // for (auto ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-  //   copy.sortEdges<void>(*ii, EdgeComp());
-
-  //   GNode last = 0;
-  //   bool first = true;
-  //   for (auto jj = copy.edge_begin(*ii), ej = copy.edge_end(*ii); jj != ej;
-  //   ++jj) {
-  //     GNode dst = copy.getEdgeDst(jj);
-  //     ptrdiff_t diff = dst - (ptrdiff_t) last;
-
-  //     if (!first) {
-  //       int index = getLogIndex(diff);
-  //       ++(*hist)[index];
-  //     }
-  //     first = false;
-  //     last = dst;
-  //     if (++p.first == p.second) {
-  //       hists.emplace_back();
-  //       hist = &hists.back();
-  //       curHist += 1;
-  //       p = katana::block_range(
-  //           boost::counting_iterator<size_t>(0),
-  //           boost::counting_iterator<size_t>(graph.sizeEdges()),
-  //           curHist,
-  //           numHist);
-  //     }
-  //   }
-  // }
-
-  // printHistogram("LogOffset", hists);
+  return hist;
 }
 
-void
-doDestinationHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
+Histogram
+DestinationHistogram(const GraphStats& stats) {
+  Histogram hist;
+  for (uint64_t n = 0; n < stats.num_nodes; ++n) {
+    uint64_t count = stats.in_degrees[n].load(std::memory_order_relaxed);
+    if (count != 0) {
+      hist[n] = count;
     }
   }
-  printHistogram("DestinationBin", hist);
+  return hist;
 }
 
 int
 main(int argc, char** argv) {
+  katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
-  try {
-    Graph graph(inputfilename);
-    for (unsigned i = 0; i != statModeList.size(); ++i) {
-      switch (statModeList[i]) {
-      case degreehist:
-        doDegreeHistogram(graph);
-        break;
-      case degrees:
-        doDegrees(graph);
-        break;
-      case maxDegreeNode:
-        findMaxDegreeNode(graph);
-        break;
-      case dsthist:
-        doDestinationHistogram(graph);
-        break;
-      case indegreehist:
-        doInDegreeHistogram(graph);
-        break;
-      case sortedlogoffsethist:
-        doSortedLogOffsetHistogram(graph);
-        break;
-      case sparsityPattern: {
-        unsigned lastrow = ~0;
-        doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
-          if (y != lastrow) {
-            lastrow = y;
-            std::cout << '\n';
+
+  bool log_offsets =
+      std::find(
+          statModeList.begin(), statModeList.end(), sortedlogoffsethist) !=
+      statModeList.end();
+
+  // statistics only need the topology and the entity types
+  katana::RDGLoadOptions load_options;
+  load_options.node_properties = std::vector<std::string>{};
+  load_options.edge_properties = std::vector<std::string>{};
+  katana::TxnContext txn_ctx;
+  auto pg_res =
+      katana::PropertyGraph::Make(inputfilename, &txn_ctx, load_options);
+  if (!pg_res) {
+    KATANA_LOG_FATAL("failed to load {}: {}", inputfilename, pg_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  const katana::GraphTopology& topo = pg->topology();
+
+  katana::StatTimer pass_timer("GraphStatsPass");
+  pass_timer.start();
+  GraphStats stats =
+      log_offsets
+          ? ComputeStats(
+                *pg,
+                pg->BuildView<
+                    katana::PropertyGraphViews::EdgesSortedByDestID>(),
+                true)
+          : ComputeStats(*pg, topo, false);
+  pass_timer.stop();
+
+  nlohmann::json json_stats = nlohmann::json::object();
+  for (unsigned i = 0; i != statModeList.size(); ++i) {
+    switch (statModeList[i]) {
+    case degreehist:
+      if (jsonOutput) {
+        json_stats["degree_histogram"] = stats.degree_hist;
+      } else {
+        printHistogram("Degree", stats.degree_hist);
+      }
+      break;
+    case degrees:
+      if (jsonOutput) {
+        std::vector<uint64_t> node_degrees(stats.num_nodes);
+        for (Node n = 0; n < stats.num_nodes; ++n) {
+          node_degrees[n] = topo.OutDegree(n);
+        }
+        json_stats["degrees"] = std::move(node_degrees);
+      } else {
+        for (Node n = 0; n < stats.num_nodes; ++n) {
+          std::cout << topo.OutDegree(n) << "\n";
+        }
+      }
+      break;
+    case maxDegreeNode:
+      if (jsonOutput) {
+        json_stats["max_degree_node"] = stats.max_degree_node;
+        json_stats["max_degree"] = stats.max_degree;
+      } else {
+        std::cout << "MaxDegreeNode : " << stats.max_degree_node
+                  << " , MaxDegree : " << stats.max_degree << "\n";
+      }
+      break;
+    case dsthist:
+      if (jsonOutput) {
+        json_stats["destination_histogram"] = DestinationHistogram(stats);
+      } else {
+        printHistogram("DestinationBin", DestinationHistogram(stats));
+      }
+      break;
+    case indegreehist:
+      if (jsonOutput) {
+        json_stats["in_degree_histogram"] = InDegreeHistogram(stats);
+      } else {
+        printHistogram("InDegree", InDegreeHistogram(stats));
+      }
+      break;
+    case sortedlogoffsethist:
+      if (jsonOutput) {
+        json_stats["log_offset_histogram"] = stats.log_offset_hist;
+      } else {
+        printLogHistogram("LogOffset", stats.log_offset_hist);
+      }
+      break;
+    case sparsityPattern: {
+      auto rows = SparsityPattern(topo);
+      if (jsonOutput) {
+        std::vector<std::string> pattern;
+        for (const auto& row : rows) {
+          std::string line;
+          for (bool val : row) {
+            line += val ? 'x' : '.';
           }
-          std::cout << (val ? 'x' : '.');
-        });
+          pattern.emplace_back(std::move(line));
+        }
+        json_stats["sparsity_pattern"] = std::move(pattern);
+      } else {
+        for (const auto& row : rows) {
+          std::cout << '\n';
+          for (bool val : row) {
+            std::cout << (val ? 'x' : '.');
+          }
+        }
         std::cout << '\n';
-        break;
       }
-      case summary:
-        doSummary(graph);
-        break;
-      default:
-        std::cerr << "Unknown stat requested\n";
-        break;
+      break;
+    }
+    case summary:
+      if (jsonOutput) {
+        json_stats["num_nodes"] = stats.num_nodes;
+        json_stats["num_edges"] = stats.num_edges;
+        json_stats["num_node_types"] = stats.type_degree_hist.size();
+      } else {
+        std::cout << "NumNodes: " << stats.num_nodes << "\n";
+        std::cout << "NumEdges: " << stats.num_edges << "\n";
+        std::cout << "NumNodeTypes: " << stats.type_degree_hist.size()
+                  << "\n";
+      }
+      break;
+    case typedegreehist:
+      if (jsonOutput) {
+        json_stats["type_degree_histogram"] = stats.type_degree_hist;
+      } else {
+        for (const auto& [type_name, hist] : stats.type_degree_hist) {
+          std::cout << "NodeType: " << type_name << "\n";
+          printHistogram("Degree", hist);
+        }
       }
+      break;
+    case diameter: {
+      katana::StatTimer diameter_timer("Diameter");
+      diameter_timer.start();
+      uint64_t approx = ApproximateDiameter(topo, stats.max_degree_node);
+      diameter_timer.stop();
+      if (jsonOutput) {
+        json_stats["approximate_diameter"] = approx;
+      } else {
+        std::cout << "ApproximateDiameter: " << approx << "\n";
+      }
+      break;
     }
-    return 0;
-  } catch (...) {
-    std::cerr << "failed\n";
-    return 1;
+    case neighborhood: {
+      katana::StatTimer neighborhood_timer("NeighborhoodFunction");
+      neighborhood_timer.start();
+      auto nf_res =
+          katana::analytics::NeighborhoodFunction(pg.get(), "", &txn_ctx);
+      neighborhood_timer.stop();
+      if (!nf_res) {
+        KATANA_LOG_FATAL(
+            "failed to compute the neighborhood function: {}", nf_res.error());
+      }
+      const auto& nf = nf_res.value();
+      if (jsonOutput) {
+        json_stats["effective_diameter"] = nf.EffectiveDiameter();
+        json_stats["average_distance"] = nf.AverageDistance();
+        json_stats["neighborhood_function"] = nf.neighborhood_function;
+      } else {
+        nf.Print(std::cout);
+      }
+      break;
+    }
+    default:
+      std::cerr << "Unknown stat requested\n";
+      break;
+    }
+  }
+
+  if (jsonOutput) {
+    auto dump = katana::JsonDump(json_stats);
+    if (!dump) {
+      KATANA_LOG_FATAL("failed to print stats: {}", dump.error());
+    }
+    std::cout << dump.value() << "\n";
   }
+  return 0;
 }
@@ -0,0 +1,656 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/Timer.h"
+#include "katana/TxnContext.h"
+#include "katana/Version.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/cdlp/cdlp.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/independent_set/independent_set.h"
+#include "katana/analytics/jaccard/jaccard.h"
+#include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+#include "llvm/Support/CommandLine.h"
+
+/* usage: ./katana-bench <input rdg>... [-datasets=<json>] [-threads=1,4,16]
+ *            [-runs=3] [-analytics=sssp,bfs] [-output=results.json]
+ *
+ * Runs every analytic with each of its plans on every dataset, at every
+ * thread count, and writes one JSON object per line for each graph load and
+ * each run: dataset, analytic, plan, threads, run, time_us and status. The
+ * first load of a dataset is reported as "cold" (after dropping its files
+ * from the page cache with -dropCaches) and the next -loadRuns loads as
+ * "warm". scripts/report.py turns the output into CSV like the stats of the
+ * lonestar apps.
+ *
+ * The datasets are the positional RDGs, described by -symmetricGraph,
+ * -transposedGraph, -edgePropertyName and -startNode, and those of the
+ * -datasets file, a JSON array of objects with the fields name, uri,
+ * symmetric, transposed, edge_property and source. Plans that need a
+ * symmetric or transposed graph or edge weights are skipped on datasets
+ * without them.
+ */
+
+namespace cll = llvm::cl;
+
+static cll::list<std::string> inputs(
+    cll::Positional, cll::desc("<input rdg>..."), cll::ZeroOrMore);
+static cll::opt<std::string> datasetsFile(
+    "datasets", cll::desc("JSON file listing the datasets to run on"),
+    cll::init(""));
+static cll::opt<bool> symmetricGraph(
+    "symmetricGraph", cll::desc("Positional inputs are symmetric"),
+    cll::init(false));
+static cll::opt<bool> transposedGraph(
+    "transposedGraph", cll::desc("Positional inputs are transposed"),
+    cll::init(false));
+static cll::opt<std::string> edgePropertyName(
+    "edgePropertyName", cll::desc("Edge weights of the positional inputs"),
+    cll::init(""));
+static cll::opt<uint32_t> startNode(
+    "startNode", cll::desc("Source node of the positional inputs"),
+    cll::init(0));
+
+static cll::list<unsigned> threadList(
+    "threads",
+    cll::desc("Comma separated thread counts to sweep (default: all)"),
+    cll::CommaSeparated);
+static cll::opt<unsigned> runs(
+    "runs", cll::desc("Timed runs of every plan"), cll::init(3));
+static cll::opt<unsigned> warmupRuns(
+    "warmupRuns", cll::desc("Untimed runs of every plan before the timed"),
+    cll::init(1));
+static cll::opt<unsigned> loadRuns(
+    "loadRuns", cll::desc("Warm loads timed after the cold one"),
+    cll::init(2));
+static cll::opt<bool> dropCaches(
+    "dropCaches",
+    cll::desc("Evict the files of local datasets from the page cache before "
+              "the cold load"),
+    cll::init(false));
+
+static cll::list<std::string> analyticsList(
+    "analytics",
+    cll::desc("Comma separated analytics to run (default: all)"),
+    cll::CommaSeparated);
+static cll::list<std::string> plansList(
+    "plans",
+    cll::desc("Comma separated plans, as <analytic>/<plan>, to run "
+              "(default: all)"),
+    cll::CommaSeparated);
+static cll::opt<bool> listBenchmarks(
+    "list", cll::desc("Print the analytics and their plans and exit"),
+    cll::init(false));
+static cll::opt<std::string> outputFile(
+    "output", cll::desc("Write the results here instead of stdout"),
+    cll::init(""));
+
+static cll::opt<uint32_t> kCoreNumber(
+    "kcore", cll::desc("k of k-core"), cll::init(10));
+static cll::opt<size_t> cdlpIterations(
+    "cdlpIterations", cll::desc("Iterations of cdlp"), cll::init(10));
+static cll::opt<uint32_t> bcSources(
+    "bcSources", cll::desc("Sources of betweenness centrality"),
+    cll::init(64));
+
+namespace {
+
+using namespace katana::analytics;
+
+struct Dataset {
+  std::string name;
+  std::string uri;
+  bool symmetric{false};
+  bool transposed{false};
+  std::string edge_property;
+  uint32_t source{0};
+};
+
+enum Requirement : uint32_t {
+  kNone = 0,
+  kSymmetric = 1 << 0,
+  kTransposed = 1 << 1,
+  kWeights = 1 << 2,
+};
+
+/// One plan of one analytic. run computes the property named output, if
+/// any, which is removed again after every run.
+struct Benchmark {
+  std::string analytic;
+  std::string plan;
+  uint32_t requirements{kNone};
+  std::function<katana::Result<void>(
+      katana::PropertyGraph*, const Dataset&, const std::string& output,
+      katana::TxnContext*)>
+      run;
+};
+
+const char* const kOutput = "katana-bench-output";
+
+std::vector<Benchmark>
+AllBenchmarks() {
+  std::vector<Benchmark> benchmarks;
+
+  auto bfs = [&](const char* name, BfsPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "bfs", name, kNone,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset& dataset,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return Bfs(pg, dataset.source, output, txn_ctx, plan);
+        }});
+  };
+  bfs("AsynchronousTile", BfsPlan::AsynchronousTile());
+  bfs("Asynchronous", BfsPlan::Asynchronous());
+  bfs("SynchronousTile", BfsPlan::SynchronousTile());
+  bfs("Synchronous", BfsPlan::Synchronous());
+  bfs("SynchronousDirectOpt", BfsPlan::SynchronousDirectOpt());
+
+  auto sssp = [&](const char* name, SsspPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "sssp", name, kWeights,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset& dataset,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return Sssp(
+              pg, dataset.source, dataset.edge_property, output, txn_ctx,
+              plan);
+        }});
+  };
+  sssp("DeltaTile", SsspPlan::DeltaTile());
+  sssp("DeltaStep", SsspPlan::DeltaStep());
+  sssp("DeltaStepBarrier", SsspPlan::DeltaStepBarrier());
+  sssp("DeltaStepFusion", SsspPlan::DeltaStepFusion());
+  sssp("DeltaStepAdaptive", SsspPlan::DeltaStepAdaptive());
+  sssp("SerialDeltaTile", SsspPlan::SerialDeltaTile());
+  sssp("SerialDelta", SsspPlan::SerialDelta());
+  sssp("DijkstraTile", SsspPlan::DijkstraTile());
+  sssp("Dijkstra", SsspPlan::Dijkstra());
+  sssp("Topological", SsspPlan::Topological());
+  sssp("TopologicalTile", SsspPlan::TopologicalTile());
+
+  auto cc = [&](const char* name, ConnectedComponentsPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "connected-components", name, kSymmetric,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return ConnectedComponents(pg, output, txn_ctx, true, plan);
+        }});
+  };
+  cc("Serial", ConnectedComponentsPlan::Serial());
+  cc("LabelProp", ConnectedComponentsPlan::LabelProp());
+  cc("Synchronous", ConnectedComponentsPlan::Synchronous());
+  cc("Asynchronous", ConnectedComponentsPlan::Asynchronous());
+  cc("EdgeAsynchronous", ConnectedComponentsPlan::EdgeAsynchronous());
+  cc(
+      "EdgeTiledAsynchronous",
+      ConnectedComponentsPlan::EdgeTiledAsynchronous());
+  cc("BlockedAsynchronous", ConnectedComponentsPlan::BlockedAsynchronous());
+  cc("Afforest", ConnectedComponentsPlan::Afforest());
+  cc("EdgeAfforest", ConnectedComponentsPlan::EdgeAfforest());
+  cc("EdgeTiledAfforest", ConnectedComponentsPlan::EdgeTiledAfforest());
+
+  auto pagerank = [&](const char* name, uint32_t requirements,
+                      PagerankPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "pagerank", name, requirements,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return Pagerank(pg, output, txn_ctx, plan);
+        }});
+  };
+  pagerank("PullTopological", kTransposed, PagerankPlan::PullTopological());
+  pagerank("PullBlocked", kNone, PagerankPlan::PullBlocked());
+  pagerank("PullResidual", kTransposed, PagerankPlan::PullResidual());
+  pagerank("PushAsynchronous", kNone, PagerankPlan::PushAsynchronous());
+  pagerank("PushSynchronous", kNone, PagerankPlan::PushSynchronous());
+
+  auto triangles = [&](const char* name, TriangleCountPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "triangle-count", name, kSymmetric,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&, const std::string&,
+            katana::TxnContext*) -> katana::Result<void> {
+          KATANA_CHECKED(TriangleCount(pg, plan));
+          return katana::ResultSuccess();
+        }});
+  };
+  triangles("NodeIteration", TriangleCountPlan::NodeIteration());
+  triangles("EdgeIteration", TriangleCountPlan::EdgeIteration());
+  triangles("OrderedCount", TriangleCountPlan::OrderedCount());
+  triangles("EdgeSampling", TriangleCountPlan::EdgeSampling());
+
+  auto k_core = [&](const char* name, KCorePlan plan) {
+    benchmarks.push_back(Benchmark{
+        "k-core", name, kSymmetric,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return KCore(pg, kCoreNumber, output, txn_ctx, true, plan);
+        }});
+  };
+  k_core("Synchronous", KCorePlan::Synchronous());
+  k_core("Asynchronous", KCorePlan::Asynchronous());
+  k_core("Bucketed", KCorePlan::Bucketed());
+
+  auto cdlp = [&](const char* name, CdlpPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "cdlp", name, kSymmetric,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return Cdlp(pg, output, cdlpIterations, txn_ctx, true, plan);
+        }});
+  };
+  cdlp("Synchronous", CdlpPlan::Synchronous());
+  cdlp("Asynchronous", CdlpPlan::Asynchronous());
+
+  auto jaccard = [&](const char* name, JaccardPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "jaccard", name, kNone,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset& dataset,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return Jaccard(pg, dataset.source, output, txn_ctx, plan);
+        }});
+  };
+  jaccard("Unsorted", JaccardPlan::Unsorted());
+  jaccard("Sorted", JaccardPlan::Sorted());
+
+  auto lcc = [&](const char* name, LocalClusteringCoefficientPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "local-clustering-coefficient", name, kSymmetric,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return LocalClusteringCoefficient(pg, output, txn_ctx, plan);
+        }});
+  };
+  lcc(
+      "OrderedCountAtomics",
+      LocalClusteringCoefficientPlan::OrderedCountAtomics());
+  lcc(
+      "OrderedCountPerThread",
+      LocalClusteringCoefficientPlan::OrderedCountPerThread());
+
+  auto independent_set = [&](const char* name, IndependentSetPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "independent-set", name, kSymmetric,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          return IndependentSet(pg, output, txn_ctx, plan);
+        }});
+  };
+  independent_set("Serial", IndependentSetPlan::Serial());
+  independent_set("Pull", IndependentSetPlan::Pull());
+  independent_set("Priority", IndependentSetPlan::Priority());
+  independent_set("EdgeTiledPriority", IndependentSetPlan::EdgeTiledPriority());
+
+  benchmarks.push_back(Benchmark{
+      "strongly-connected-components", "Multistep", kNone,
+      [](katana::PropertyGraph* pg, const Dataset&, const std::string& output,
+         katana::TxnContext* txn_ctx) {
+        return StronglyConnectedComponents(
+            pg, output, txn_ctx, StronglyConnectedComponentsPlan::Multistep());
+      }});
+
+  auto bc = [&](const char* name, BetweennessCentralityPlan plan) {
+    benchmarks.push_back(Benchmark{
+        "betweenness-centrality", name, kNone,
+        [plan](
+            katana::PropertyGraph* pg, const Dataset&,
+            const std::string& output, katana::TxnContext* txn_ctx) {
+          BetweennessCentralitySources sources = bcSources.getValue();
+          return BetweennessCentrality(pg, output, txn_ctx, sources, plan);
+        }});
+  };
+  bc("Level", BetweennessCentralityPlan::Level());
+  bc("Outer", BetweennessCentralityPlan::Outer());
+  bc("Asynchronous", BetweennessCentralityPlan::Asynchronous());
+
+  return benchmarks;
+}
+
+bool
+Selected(const Benchmark& benchmark) {
+  auto contains = [](const cll::list<std::string>& list,
+                     const std::string& name) {
+    return std::find(list.begin(), list.end(), name) != list.end();
+  };
+  if (!analyticsList.empty() && !contains(analyticsList, benchmark.analytic)) {
+    return false;
+  }
+  return plansList.empty() ||
+         contains(plansList, benchmark.analytic + "/" + benchmark.plan);
+}
+
+/// The requirements of benchmark that dataset does not meet, or "" if none
+std::string
+Unmet(const Benchmark& benchmark, const Dataset& dataset) {
+  if ((benchmark.requirements & kSymmetric) && !dataset.symmetric) {
+    return "a symmetric graph";
+  }
+  if ((benchmark.requirements & kTransposed) && !dataset.transposed) {
+    return "a transposed graph";
+  }
+  if ((benchmark.requirements & kWeights) && dataset.edge_property.empty()) {
+    return "edge weights";
+  }
+  return "";
+}
+
+katana::Result<std::vector<Dataset>>
+ReadDatasets() {
+  std::vector<Dataset> datasets;
+  for (const std::string& uri : inputs) {
+    Dataset dataset;
+    dataset.uri = uri;
+    dataset.name = boost::filesystem::path(uri).filename().string();
+    if (dataset.name.empty() || dataset.name == ".") {
+      dataset.name = uri;
+    }
+    dataset.symmetric = symmetricGraph;
+    dataset.transposed = transposedGraph;
+    dataset.edge_property = edgePropertyName;
+    dataset.source = startNode;
+    datasets.emplace_back(std::move(dataset));
+  }
+
+  if (datasetsFile.empty()) {
+    return datasets;
+  }
+  std::ifstream file(datasetsFile);
+  if (!file) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "cannot open {}",
+        std::string(datasetsFile));
+  }
+  nlohmann::json json;
+  try {
+    file >> json;
+    for (const auto& entry : json) {
+      Dataset dataset;
+      dataset.uri = entry.at("uri").get<std::string>();
+      dataset.name = entry.value("name", dataset.uri);
+      dataset.symmetric = entry.value("symmetric", false);
+      dataset.transposed = entry.value("transposed", false);
+      dataset.edge_property = entry.value("edge_property", std::string());
+      dataset.source = entry.value("source", uint32_t{0});
+      datasets.emplace_back(std::move(dataset));
+    }
+  } catch (const nlohmann::json::exception& e) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "reading {}: {}",
+        std::string(datasetsFile), e.what());
+  }
+  return datasets;
+}
+
+/// Ask the kernel to drop the cached pages of the files of a local RDG, so
+/// that the next load reads them from storage. Only clean pages are dropped
+/// and other URIs are left alone.
+void
+EvictFromPageCache(const std::string& uri) {
+  std::string path = uri;
+  const std::string file_scheme = "file://";
+  if (path.compare(0, file_scheme.size(), file_scheme) == 0) {
+    path = path.substr(file_scheme.size());
+  } else if (path.find("://") != std::string::npos) {
+    KATANA_LOG_WARN("cannot drop {} from the page cache", uri);
+    return;
+  }
+
+  namespace fs = boost::filesystem;
+  boost::system::error_code ec;
+  for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    if (!fs::is_regular_file(it->path())) {
+      continue;
+    }
+    int fd = open(it->path().c_str(), O_RDONLY);
+    if (fd < 0) {
+      continue;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+  if (ec) {
+    KATANA_LOG_WARN(
+        "cannot drop {} from the page cache: {}", uri, ec.message());
+  }
+}
+
+class Reporter {
+public:
+  explicit Reporter(std::ostream* out) : out_(out) {
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    host_ = host;
+  }
+
+  void Report(
+      const Dataset& dataset, const katana::PropertyGraph* pg,
+      const std::string& analytic, const std::string& plan, unsigned threads,
+      unsigned run, uint64_t time_us, const katana::Result<void>& result) {
+    nlohmann::json record{
+        {"benchmark", "katana-bench"},
+        {"version", katana::getVersion()},
+        {"revision", katana::getRevision()},
+        {"host", host_},
+        {"dataset", dataset.name},
+        {"uri", dataset.uri},
+        {"analytic", analytic},
+        {"plan", plan},
+        {"threads", threads},
+        {"run", run},
+        {"time_us", time_us},
+        {"status", result ? "ok" : fmt::format("{}", result.error())},
+    };
+    if (pg != nullptr) {
+      record["num_nodes"] = pg->topology().NumNodes();
+      record["num_edges"] = pg->topology().NumEdges();
+    }
+    *out_ << record.dump() << std::endl;
+    if (!result) {
+      ++failures_;
+    }
+  }
+
+  unsigned failures() const { return failures_; }
+
+private:
+  std::ostream* out_;
+  std::string host_;
+  unsigned failures_{0};
+};
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Load(const Dataset& dataset, uint64_t* time_us) {
+  katana::RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>{};
+  opts.edge_properties = std::vector<std::string>{};
+  if (!dataset.edge_property.empty()) {
+    opts.edge_properties->emplace_back(dataset.edge_property);
+  }
+  katana::TxnContext txn_ctx;
+  katana::Timer timer;
+  timer.start();
+  auto pg = KATANA_CHECKED_CONTEXT(
+      katana::PropertyGraph::Make(dataset.uri, &txn_ctx, opts), "loading {}",
+      dataset.uri);
+  timer.stop();
+  *time_us = timer.get_usec();
+  return std::move(pg);
+}
+
+katana::Result<void>
+RunOnce(
+    const Benchmark& benchmark, katana::PropertyGraph* pg,
+    const Dataset& dataset, uint64_t* time_us) {
+  katana::TxnContext txn_ctx;
+  katana::Timer timer;
+  timer.start();
+  auto result = benchmark.run(pg, dataset, kOutput, &txn_ctx);
+  timer.stop();
+  *time_us = timer.get_usec();
+  if (pg->HasNodeProperty(kOutput)) {
+    KATANA_CHECKED(pg->RemoveNodeProperty(kOutput, &txn_ctx));
+  }
+  return result;
+}
+
+/// Benchmark the loads of dataset and then every selected benchmark on it
+void
+RunDataset(
+    const Dataset& dataset, const std::vector<Benchmark>& benchmarks,
+    const std::vector<unsigned>& threads, Reporter* reporter) {
+  // loads run with the most threads of the sweep
+  unsigned load_threads = *std::max_element(threads.begin(), threads.end());
+  katana::setActiveThreads(load_threads);
+  if (dropCaches) {
+    EvictFromPageCache(dataset.uri);
+  }
+
+  std::unique_ptr<katana::PropertyGraph> pg;
+  for (unsigned run = 0; run <= loadRuns; ++run) {
+    uint64_t time_us = 0;
+    auto pg_res = Load(dataset, &time_us);
+    const char* plan = run == 0 ? "cold" : "warm";
+    if (!pg_res) {
+      reporter->Report(
+          dataset, nullptr, "load", plan, load_threads, run, time_us,
+          pg_res.error());
+      return;
+    }
+    // free the previous copy before the next load
+    pg.reset();
+    pg = std::move(pg_res.value());
+    reporter->Report(
+        dataset, pg.get(), "load", plan, load_threads, run, time_us,
+        katana::ResultSuccess());
+  }
+
+  Dataset checked = dataset;
+  if (checked.source >= pg->topology().NumNodes()) {
+    KATANA_LOG_WARN(
+        "{}: source {} is not a node; using 0", dataset.name, dataset.source);
+    checked.source = 0;
+  }
+
+  for (const Benchmark& benchmark : benchmarks) {
+    if (std::string unmet = Unmet(benchmark, checked); !unmet.empty()) {
+      KATANA_LOG_VERBOSE(
+          "{}: skipping {}/{}, which needs {}", checked.name,
+          benchmark.analytic, benchmark.plan, unmet);
+      continue;
+    }
+    for (unsigned num_threads : threads) {
+      unsigned active = katana::setActiveThreads(num_threads);
+      KATANA_LOG_VERBOSE(
+          "{}: {}/{} on {} threads", checked.name, benchmark.analytic,
+          benchmark.plan, active);
+      uint64_t time_us = 0;
+      bool failed = false;
+      for (unsigned run = 0; run < warmupRuns && !failed; ++run) {
+        failed = !RunOnce(benchmark, pg.get(), checked, &time_us);
+      }
+      // a failing warmup is reported by the first timed run
+      for (unsigned run = 0; run < runs; ++run) {
+        auto result = RunOnce(benchmark, pg.get(), checked, &time_us);
+        reporter->Report(
+            checked, pg.get(), benchmark.analytic, benchmark.plan, active, run,
+            time_us, result);
+        if (!result) {
+          break;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  std::vector<Benchmark> benchmarks;
+  for (Benchmark& benchmark : AllBenchmarks()) {
+    if (Selected(benchmark)) {
+      benchmarks.emplace_back(std::move(benchmark));
+    }
+  }
+
+  if (listBenchmarks) {
+    for (const Benchmark& benchmark : benchmarks) {
+      std::cout << benchmark.analytic << "/" << benchmark.plan << "\n";
+    }
+    return 0;
+  }
+
+  auto datasets_res = ReadDatasets();
+  if (!datasets_res) {
+    KATANA_LOG_FATAL("{}", datasets_res.error());
+  }
+  std::vector<Dataset> datasets = std::move(datasets_res.value());
+  if (datasets.empty()) {
+    KATANA_LOG_FATAL("no datasets; give RDGs or -datasets");
+  }
+
+  std::vector<unsigned> threads(threadList.begin(), threadList.end());
+  if (threads.empty()) {
+    threads.emplace_back(katana::GetThreadPool().getMaxUsableThreads());
+  }
+
+  std::ofstream file;
+  std::ostream* out = &std::cout;
+  if (!outputFile.empty()) {
+    file.open(outputFile);
+    if (!file) {
+      KATANA_LOG_FATAL("cannot open {}", std::string(outputFile));
+    }
+    out = &file;
+  }
+
+  Reporter reporter(out);
+  for (const Dataset& dataset : datasets) {
+    RunDataset(dataset, benchmarks, threads, &reporter);
+  }
+
+  if (reporter.failures() != 0) {
+    KATANA_LOG_ERROR("{} runs failed", reporter.failures());
+    return 1;
+  }
+  return 0;
+}
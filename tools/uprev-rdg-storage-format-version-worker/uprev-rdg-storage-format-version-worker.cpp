@@ -1,12 +1,19 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
+#include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/RDG.h"
 #include "katana/SharedMemSys.h"
 #include "katana/analytics/Utils.h"
+#include "katana/tsuba.h"
 #include "llvm/Support/CommandLine.h"
 #include "stdio.h"
 
@@ -14,17 +21,74 @@ namespace cll = llvm::cl;
 namespace fs = boost::filesystem;
 
 /* usage: ./rdg-uprev-storage-format-version.cpp <input-rdg> <output-path>
+ *        ./rdg-uprev-storage-format-version.cpp -input-list=<file>
  *
- * loads the given input rdg and stores it in the output-path
- * validates that the input rdg and the output rdg match
- * used to uprev the testing inputs
+ * stores each input rdg in its output-path at the latest storage format
+ * version and validates that the input rdg and the output rdg match
+ *
+ * RDGs whose data files are already in the latest formats are upgraded by
+ * copying those files as is and rewriting only their metadata, many RDGs at
+ * a time; the others are loaded and stored one at a time
+ * used to uprev the testing inputs and to migrate stored RDGs
  */
 
 static cll::opt<std::string> InputFile(
-    cll::Positional, cll::desc("<input rdg file>"), cll::Required);
+    cll::Positional, cll::desc("<input rdg file>"), cll::Optional);
 
 static cll::opt<std::string> OutputFile(
-    cll::Positional, cll::desc("<output rdg file>"), cll::Required);
+    cll::Positional, cll::desc("<output rdg file>"), cll::Optional);
+
+static cll::opt<std::string> InputList(
+    "input-list",
+    cll::desc("file with one \"<input rdg> <output rdg>\" pair per line"),
+    cll::init(""));
+
+static cll::opt<unsigned> NumJobs(
+    "jobs", cll::desc("number of RDGs whose files are copied at once"),
+    cll::init(4));
+
+static cll::opt<unsigned> IOBudgetMB(
+    "io-budget-mb",
+    cll::desc("megabytes being copied at once, shared by all jobs"),
+    cll::init(1024));
+
+static cll::opt<bool> PassThrough(
+    "pass-through",
+    cll::desc("copy data files that need no conversion instead of loading "
+              "and storing the RDG"),
+    cll::init(true));
+
+static cll::opt<bool> Validate(
+    "validate",
+    cll::desc("load the input and the output rdg and check that they match"),
+    cll::init(true));
+
+struct Job {
+  std::string input_rdg;
+  std::string output_path;
+};
+
+std::vector<Job>
+ReadJobs() {
+  std::vector<Job> jobs;
+  if (!InputFile.empty()) {
+    KATANA_LOG_ASSERT(!OutputFile.empty());
+    jobs.emplace_back(Job{InputFile, OutputFile});
+  }
+  if (InputList.empty()) {
+    return jobs;
+  }
+
+  std::ifstream list(InputList);
+  if (!list) {
+    KATANA_LOG_FATAL("opening input list {}", InputList);
+  }
+  Job job;
+  while (list >> job.input_rdg >> job.output_path) {
+    jobs.emplace_back(job);
+  }
+  return jobs;
+}
 
 katana::PropertyGraph
 LoadGraph(const std::string& rdg_file) {
@@ -41,7 +105,7 @@ LoadGraph(const std::string& rdg_file) {
 }
 
 std::string
-StoreGraph(katana::PropertyGraph* g, std::string& output_path) {
+StoreGraph(katana::PropertyGraph* g, const std::string& output_path) {
   std::string command_line;
   katana::TxnContext txn_ctx;
   // Store graph. If there is a new storage format then storing it is enough to bump the version up.
@@ -54,20 +118,74 @@ StoreGraph(katana::PropertyGraph* g, std::string& output_path) {
 }
 
 void
-UprevGraph(std::string& input_rdg, std::string& output_path) {
-  katana::PropertyGraph g = LoadGraph(input_rdg);
-  std::string g2_rdg_file = StoreGraph(&g, output_path);
+ValidateGraph(katana::PropertyGraph* g, const std::string& g2_rdg_file) {
   katana::PropertyGraph g2 = LoadGraph(g2_rdg_file);
 
-  if (!g.Equals(&g2)) {
-    KATANA_LOG_WARN("{}", g.ReportDiff(&g2));
+  if (!g->Equals(&g2)) {
+    KATANA_LOG_WARN("{}", g->ReportDiff(&g2));
     KATANA_LOG_VASSERT(
         false,
         "in memory graph from load previous storage_format_version does not "
         "match in memory graph loaded from new storage_format_version");
   }
+}
+
+void
+UprevGraph(const Job& job) {
+  katana::PropertyGraph g = LoadGraph(job.input_rdg);
+  std::string g2_rdg_file = StoreGraph(&g, job.output_path);
+  if (Validate) {
+    ValidateGraph(&g, g2_rdg_file);
+  }
 
-  KATANA_LOG_WARN("uprev of {} stored at {}", input_rdg, g2_rdg_file);
+  KATANA_LOG_WARN("uprev of {} stored at {}", job.input_rdg, g2_rdg_file);
+}
+
+/// Upgrade the RDGs whose files can be copied as is, NumJobs at a time.
+/// \returns the jobs whose RDGs must be loaded and stored instead
+std::vector<Job>
+PassThroughGraphs(const std::vector<Job>& jobs) {
+  unsigned num_threads =
+      std::max(1U, std::min<unsigned>(NumJobs, jobs.size()));
+  uint64_t budget = (static_cast<uint64_t>(IOBudgetMB) << 20) / num_threads;
+
+  std::atomic<size_t> next{0};
+  // char rather than bool so that threads set their own elements
+  std::vector<char> must_convert(jobs.size(), false);
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t j = next++; j < jobs.size(); j = next++) {
+        const Job& job = jobs[j];
+        auto res = katana::UprevRDG(job.input_rdg, job.output_path, budget);
+        if (res) {
+          KATANA_LOG_WARN(
+              "uprev of {} stored at {} by copying its files", job.input_rdg,
+              job.output_path);
+          continue;
+        }
+        if (res.error() != katana::ErrorCode::NotImplemented) {
+          KATANA_LOG_FATAL("upgrading {}: {}", job.input_rdg, res.error());
+        }
+        KATANA_LOG_WARN("{}; loading and storing it", res.error());
+        must_convert[j] = true;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<Job> to_convert;
+  for (size_t j = 0; j < jobs.size(); ++j) {
+    if (must_convert[j]) {
+      to_convert.emplace_back(jobs[j]);
+    } else if (Validate) {
+      katana::PropertyGraph g = LoadGraph(jobs[j].input_rdg);
+      ValidateGraph(&g, jobs[j].output_path);
+    }
+  }
+  return to_convert;
 }
 
 int
@@ -76,8 +194,14 @@ main(int argc, char** argv) {
   katana::SharedMemSys sys;
   cll::ParseCommandLineOptions(argc, argv);
 
-  KATANA_LOG_ASSERT(!InputFile.empty());
-  UprevGraph(InputFile, OutputFile);
+  std::vector<Job> jobs = ReadJobs();
+  KATANA_LOG_ASSERT(!jobs.empty());
+
+  // loading and storing uses every thread, so those jobs run one at a time
+  std::vector<Job> to_convert = PassThrough ? PassThroughGraphs(jobs) : jobs;
+  for (const Job& job : to_convert) {
+    UprevGraph(job);
+  }
 
   return 0;
 }